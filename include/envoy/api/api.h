@@ -7,6 +7,7 @@
 #include "envoy/common/time.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/scaled_range_timer_manager.h"
+#include "envoy/event/slow_callback_log.h"
 #include "envoy/filesystem/filesystem.h"
 #include "envoy/server/process_context.h"
 #include "envoy/stats/store.h"
@@ -83,6 +84,11 @@ public:
    * @return an optional reference to the ProcessContext
    */
   virtual ProcessContextOptRef processContext() PURE;
+
+  /**
+   * @return a reference to the log of the slow callbacks of the dispatchers allocated by the Api.
+   */
+  virtual Event::SlowCallbackLog& slowCallbackLog() PURE;
 };
 
 using ApiPtr = std::unique_ptr<Api>;
@@ -9,6 +9,7 @@
 #include "envoy/common/exception.h"
 #include "envoy/common/platform.h"
 #include "envoy/common/pure.h"
+#include "envoy/http/stream_reset_handler.h"
 
 #include "common/common/assert.h"
 #include "common/common/byte_order.h"
@@ -76,6 +77,41 @@ using SliceDataPtr = std::unique_ptr<SliceData>;
 class Reservation;
 class ReservationSingleSlice;
 
+/**
+ * An account the memory of buffers is charged to, e.g. the memory of all the buffers of a stream.
+ * The slices of a buffer are charged to the account of the buffer they were created in, or to the
+ * account of the first buffer with an account they were moved into, until they are freed.
+ */
+class BufferMemoryAccount {
+public:
+  virtual ~BufferMemoryAccount() = default;
+
+  /**
+   * Charges the account for memory allocated to it.
+   * @param amount supplies the number of bytes.
+   */
+  virtual void charge(uint64_t amount) PURE;
+
+  /**
+   * Credits the account for memory charged to it that was freed.
+   * @param amount supplies the number of bytes.
+   */
+  virtual void credit(uint64_t amount) PURE;
+
+  /**
+   * @return the number of bytes charged to the account and not credited yet.
+   */
+  virtual uint64_t balance() const PURE;
+
+  /**
+   * Called when the downstream stream the account belongs to is done, after which the account
+   * won't reset it anymore. The account lives on as long as memory is charged to it.
+   */
+  virtual void clearDownstream() PURE;
+};
+
+using BufferMemoryAccountSharedPtr = std::shared_ptr<BufferMemoryAccount>;
+
 // Base class for an object to manage the ownership for slices in a `Reservation` or
 // `ReservationSingleSlice`.
 class ReservationSlicesOwner {
@@ -101,6 +137,14 @@ public:
    */
   virtual void addDrainTracker(std::function<void()> drain_tracker) PURE;
 
+  /**
+   * Binds the account the memory of the slices of the buffer is charged to. The slices created in
+   * the buffer, and the ones moved into it that aren't charged to an account yet, are charged to
+   * the account until they are freed.
+   * @param account supplies the account, which may be nullptr.
+   */
+  virtual void bindAccount(BufferMemoryAccountSharedPtr account) PURE;
+
   /**
    * Copy data into the buffer (deprecated, use absl::string_view variant
    * instead).
@@ -459,6 +503,22 @@ public:
   virtual InstancePtr create(std::function<void()> below_low_watermark,
                              std::function<void()> above_high_watermark,
                              std::function<void()> above_overflow_watermark) PURE;
+
+  /**
+   * Creates an account for the memory of the buffers of a downstream stream. The factory tracks
+   * the accounts holding the most memory, to reset their stream under memory pressure.
+   * @param reset_handler supplies the handler to reset the stream with, until the account is
+   *        cleared.
+   * @return the account, or nullptr if the factory doesn't track the memory of the streams.
+   */
+  virtual BufferMemoryAccountSharedPtr createAccount(Http::StreamResetHandler& reset_handler) PURE;
+
+  /**
+   * Resets the streams of the accounts holding the most memory, in proportion to the pressure.
+   * @param pressure supplies the memory pressure, between 0 and 1.
+   * @return the number of streams reset.
+   */
+  virtual uint64_t resetAccountsGivenPressure(float pressure) PURE;
 };
 
 using WatermarkFactoryPtr = std::unique_ptr<WatermarkFactory>;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+
+/**
+ * A region of memory that objects can be allocated from and that is released all at once when the
+ * arena is destroyed. Individual allocations are never freed.
+ */
+class Arena {
+public:
+  virtual ~Arena() = default;
+
+  /**
+   * Allocates memory that stays valid for the lifetime of the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two no larger than
+   *        alignof(std::max_align_t).
+   * @return void* the allocated memory.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+};
+
+/**
+ * STL allocator that allocates from an Arena. Deallocation is a no-op as the memory is released
+ * with the arena, so objects allocated this way, e.g. with std::allocate_shared(), must never be
+ * referenced after the arena is destroyed, including through a std::weak_ptr.
+ */
+template <class T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& other) : arena_(&other.arena()) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  Arena& arena() const { return *arena_; }
+
+  template <class U> bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == &other.arena();
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& other) const {
+    return !(*this == other);
+  }
+
+private:
+  Arena* arena_;
+};
+
+/**
+ * Creates a shared object in the arena if there is one, or on the heap otherwise. The lifetime
+ * restrictions of ArenaAllocator apply when an arena is supplied.
+ * @param arena supplies the arena to allocate from, or nullptr.
+ * @param args supplies the constructor arguments.
+ */
+template <class T, class... Args> std::shared_ptr<T> makeArenaShared(Arena* arena, Args&&... args) {
+  if (arena != nullptr) {
+    return std::allocate_shared<T>(ArenaAllocator<T>(*arena), std::forward<Args>(args)...);
+  }
+  return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+} // namespace Envoy
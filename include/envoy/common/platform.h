@@ -289,6 +289,14 @@ struct mmsghdr {
 };
 #endif
 
+// Whether the writes of TCP sockets can be sent with MSG_ZEROCOPY, see
+// https://www.kernel.org/doc/html/latest/networking/msg_zerocopy.html.
+#if defined(__linux__) && defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+#define ENVOY_ZERO_COPY_SEND 1
+#else
+#define ENVOY_ZERO_COPY_SEND 0
+#endif
+
 #define SUPPORTS_GETIFADDRS
 #ifdef WIN32
 #undef SUPPORTS_GETIFADDRS
@@ -59,6 +59,14 @@ public:
    * @return bool does the xDS discovery response have a set resource payload?
    */
   virtual bool hasResource() const PURE;
+
+  /**
+   * @return uint64_t a hash of the resource computed once, when it was decoded, e.g. from its
+   *         wire encoding. Resources with the same hash are the same, so that the subsystems
+   *         applying them can skip unchanged resources without hashing their messages again. The
+   *         same resource may have another hash if the management server encodes it differently.
+   */
+  virtual uint64_t hash() const PURE;
 };
 
 using DecodedResourcePtr = std::unique_ptr<DecodedResource>;
@@ -75,6 +83,30 @@ public:
    */
   virtual ProtobufTypes::MessagePtr decodeResource(const ProtobufWkt::Any& resource) PURE;
 
+  /**
+   * Decode the part of an opaque resource that doesn't need the main thread: unpack it and check
+   * its protoc-gen-validate constraints. Unlike decodeResource(), this may be called on any thread
+   * and doesn't throw. The message must be passed to checkResource() on the main thread.
+   * @param resource some opaque resource (ProtobufWkt::Any).
+   * @param error set to the constraint violation of the message, if any.
+   * @return ProtobufTypes::MessagePtr the unpacked message, or nullptr if the resource can only be
+   *         decoded by decodeResource(), e.g. because it needs an API version upgrade.
+   */
+  virtual ProtobufTypes::MessagePtr parseResource(const ProtobufWkt::Any& resource,
+                                                  std::string& error) PURE;
+
+  /**
+   * Finish decoding a message returned by parseResource() the way decodeResource() would: check
+   * the message for unknown and deprecated fields, then report the constraint violation found by
+   * parseResource().
+   * @param resource the opaque resource passed to parseResource().
+   * @param message the message returned by parseResource().
+   * @param error the constraint violation found by parseResource().
+   * @throw EnvoyException if the resource is rejected.
+   */
+  virtual void checkResource(const ProtobufWkt::Any& resource, const Protobuf::Message& message,
+                             const std::string& error) PURE;
+
   /**
    * @param resource some opaque resource (Protobuf::Message).
    * @return std::String the resource name in a Protobuf::Message returned by decodeResource(), e.g.
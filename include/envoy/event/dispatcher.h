@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <list>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,7 +35,9 @@ namespace Event {
 /**
  * All dispatcher stats. @see stats_macros.h
  */
-#define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+#define ALL_DISPATCHER_STATS(COUNTER, GAUGE, HISTOGRAM)                                            \
+  COUNTER(slow_callbacks)                                                                          \
+  GAUGE(deferred_delete_backlog, NeverImport)                                                      \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
   HISTOGRAM(poll_delay_us, Microseconds)
 
@@ -42,7 +45,7 @@ namespace Event {
  * Struct definition for all dispatcher stats. @see stats_macros.h
  */
 struct DispatcherStats {
-  ALL_DISPATCHER_STATS(GENERATE_HISTOGRAM_STRUCT)
+  ALL_DISPATCHER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
 };
 
 using DispatcherStatsPtr = std::unique_ptr<DispatcherStats>;
@@ -80,6 +83,14 @@ public:
    */
   virtual Event::TimerPtr createTimer(TimerCb cb) PURE;
 
+  /**
+   * Allocates a timer of the timer wheel of the dispatcher. The timers of the wheel fire like the
+   * other timers, but take constant time to enable and disable, which suits the timeouts that are
+   * armed for each stream and rarely fire. @see Timer for docs on how to use the timer.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  virtual Event::TimerPtr createWheelTimer(TimerCb cb) PURE;
+
   /**
    * Allocates a scaled timer. @see Timer for docs on how to use the timer.
    * @param timer_type the type of timer to create.
@@ -164,6 +175,13 @@ public:
   virtual void initializeStats(Stats::Scope& scope,
                                const absl::optional<std::string>& prefix = absl::nullopt) PURE;
 
+  /**
+   * @return the fraction of recent wall time the event loop spent running events rather than
+   *         polling for them, between 0 and 1, or absl::nullopt if stats haven't been initialized.
+   *         Unlike most dispatcher methods this may be called from any thread.
+   */
+  virtual absl::optional<double> loopUtilization() const PURE;
+
   /**
    * Clears any items in the deferred deletion queue.
    */
@@ -264,6 +282,13 @@ public:
    */
   virtual void post(PostCb callback) PURE;
 
+  /**
+   * Posts functors to the dispatcher, which run in order as if they were posted one by one with
+   * post(). This is safe cross thread, and wakes up the dispatcher at most once for all of them.
+   * @param callbacks supplies the functors to run.
+   */
+  virtual void postBatch(std::list<PostCb> callbacks) PURE;
+
   /**
    * Post the deletable to this dispatcher. The deletable objects are guaranteed to be destroyed on
    * the dispatcher's thread before dispatcher destroy. This is safe cross thread.
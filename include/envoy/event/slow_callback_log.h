@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A dispatcher callback that ran for longer than the threshold of the slow callback log.
+ */
+struct SlowCallback {
+  enum class Type { Timer, FileEvent, SchedulableCallback, Post };
+
+  // The name of the dispatcher that ran the callback.
+  std::string dispatcher_name_;
+  Type type_;
+  // When the callback completed.
+  SystemTime time_;
+  std::chrono::microseconds duration_;
+  // The state of the innermost object tracked by the dispatcher once the callback became slow, or
+  // empty if no object was tracked.
+  std::string tracked_object_;
+};
+
+/**
+ * The recent slow callbacks of all the dispatchers of the process. All the methods may be called
+ * from any thread.
+ */
+class SlowCallbackLog {
+public:
+  virtual ~SlowCallbackLog() = default;
+
+  /**
+   * @return the duration above which the dispatcher callbacks are recorded, zero if they aren't.
+   */
+  virtual std::chrono::microseconds threshold() const PURE;
+
+  /**
+   * @param threshold supplies the duration above which the dispatcher callbacks are recorded, or
+   *        zero to stop recording them.
+   */
+  virtual void setThreshold(std::chrono::microseconds threshold) PURE;
+
+  /**
+   * Records a slow callback, dropping the oldest one if the log is full.
+   * @param callback supplies the slow callback.
+   */
+  virtual void record(SlowCallback&& callback) PURE;
+
+  /**
+   * @return the recent slow callbacks, the oldest first.
+   */
+  virtual std::vector<SlowCallback> recentCallbacks() const PURE;
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -11,6 +11,7 @@
 #include "envoy/http/header_map.h"
 #include "envoy/http/metadata_interface.h"
 #include "envoy/http/protocol.h"
+#include "envoy/http/stream_reset_handler.h"
 #include "envoy/network/address.h"
 #include "envoy/stream_info/stream_info.h"
 
@@ -137,8 +138,8 @@ public:
 class ResponseEncoder : public virtual StreamEncoder {
 public:
   /**
-   * Encode 100-Continue headers.
-   * @param headers supplies the 100-Continue header map to encode.
+   * Encode 100-Continue or 103 Early Hints headers.
+   * @param headers supplies the 100-Continue or 103 Early Hints header map to encode.
    */
   virtual void encode100ContinueHeaders(const ResponseHeaderMap& headers) PURE;
 
@@ -262,30 +263,6 @@ public:
   virtual void dumpState(std::ostream& os, int indent_level = 0) const PURE;
 };
 
-/**
- * Stream reset reasons.
- */
-enum class StreamResetReason {
-  // If a local codec level reset was sent on the stream.
-  LocalReset,
-  // If a local codec level refused stream reset was sent on the stream (allowing for retry).
-  LocalRefusedStreamReset,
-  // If a remote codec level reset was received on the stream.
-  RemoteReset,
-  // If a remote codec level refused stream reset was received on the stream (allowing for retry).
-  RemoteRefusedStreamReset,
-  // If the stream was locally reset by a connection pool due to an initial connection failure.
-  ConnectionFailure,
-  // If the stream was locally reset due to connection termination.
-  ConnectionTermination,
-  // The stream was reset because of a resource overflow.
-  Overflow,
-  // Either there was an early TCP error for a CONNECT request or the peer reset with CONNECT_ERROR
-  ConnectError,
-  // Received payload did not conform to HTTP protocol.
-  ProtocolError
-};
-
 /**
  * Callbacks that fire against a stream.
  */
@@ -316,9 +293,9 @@ public:
 /**
  * An HTTP stream (request, response, and push).
  */
-class Stream {
+class Stream : public StreamResetHandler {
 public:
-  virtual ~Stream() = default;
+  ~Stream() override = default;
 
   /**
    * Add stream callbacks.
@@ -332,12 +309,6 @@ public:
    */
   virtual void removeCallbacks(StreamCallbacks& callbacks) PURE;
 
-  /**
-   * Reset the stream. No events will fire beyond this point.
-   * @param reason supplies the reset reason.
-   */
-  virtual void resetStream(StreamResetReason reason) PURE;
-
   /**
    * Enable/disable further data from this stream.
    * Cessation of data may not be immediate. For example, for HTTP/2 this may stop further flow
@@ -380,6 +351,13 @@ public:
    * small window updates as satisfying the idle timeout as this is a potential DoS vector.
    */
   virtual void setFlushTimeout(std::chrono::milliseconds timeout) PURE;
+
+  /**
+   * Sets the account the memory of the buffers of the stream is charged to. Must be called before
+   * the stream buffers any data.
+   * @param account supplies the account, which may be nullptr.
+   */
+  virtual void setAccount(Buffer::BufferMemoryAccountSharedPtr account) PURE;
 };
 
 /**
@@ -436,6 +414,9 @@ struct Http1Settings {
   // headers set. By default such messages are rejected, but if option is enabled - Envoy will
   // remove Content-Length header and process message.
   bool allow_chunked_length_{false};
+  // Coalesces the writes of a message into the connection within each dispatcher iteration, rather
+  // than writing its headers and each of its body chunks separately.
+  bool coalesce_writes_{false};
 
   enum class HeaderKeyFormat {
     // By default no formatting is performed, presenting all headers in lowercase (as Envoy
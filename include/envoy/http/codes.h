@@ -16,6 +16,7 @@ enum class Code {
   // clang-format off
   Continue                      = 100,
   SwitchingProtocols            = 101,
+  EarlyHints                    = 103,
 
   OK                            = 200,
   Created                       = 201,
@@ -6,6 +6,7 @@
 #include <string>
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/common/arena.h"
 #include "envoy/common/scope_tracker.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/grpc/status.h"
@@ -283,6 +284,11 @@ public:
    * @return the ScopeTrackedObject for this stream.
    */
   virtual const ScopeTrackedObject& scope() PURE;
+
+  /**
+   * @return the account the memory of the buffers of this stream is charged to, or nullptr.
+   */
+  virtual Buffer::BufferMemoryAccountSharedPtr account() const PURE;
 };
 
 /**
@@ -447,6 +453,18 @@ public:
    */
   virtual ResponseHeaderMapOptRef continueHeaders() const PURE;
 
+  /**
+   * Called with 103 Early Hints headers to be encoded, so that the client can start fetching the
+   * resources of the response before the response itself.
+   *
+   * The headers are sent directly to the codec, bypassing the encoder filters. They are dropped if
+   * the response has already started, or if the downstream protocol is HTTP/1.0, which doesn't
+   * support informational responses.
+   *
+   * @param headers supplies the headers to be encoded.
+   */
+  virtual void encodeEarlyHintsHeaders(ResponseHeaderMapPtr&& headers) PURE;
+
   /**
    * Called with headers to be encoded, optionally indicating end of stream.
    *
@@ -627,6 +645,15 @@ public:
    */
   virtual void onMatchCallback(const Matcher::Action&) {}
 
+  /**
+   * Called once the stream has become a tunnel, that is once the response headers accepting its
+   * upgrade, such as to WebSocket, or its CONNECT request have been encoded.
+   * @return whether the filter needs the data and trailers of the tunnel. If not, the filter is
+   *         skipped for them, which saves its callbacks on each frame of long-lived tunnels. Its
+   *         decodeComplete() and encodeComplete() are then not called either.
+   */
+  virtual bool needsTunnelData() const { return true; }
+
   struct LocalReplyData {
     // The error code which (barring reset) will be sent to the client.
     Http::Code code_;
@@ -1020,6 +1047,22 @@ public:
    * @param handler supplies the handler to add.
    */
   virtual void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) PURE;
+
+  /**
+   * @return Arena* the arena of the stream the filter chain is being created for, or nullptr if
+   *         the stream doesn't have one. The arena is released when the stream is destroyed, so
+   *         filters may be allocated from it with makeArenaShared() as long as nothing retains a
+   *         reference to them beyond the stream.
+   */
+  virtual Arena* streamArena() PURE;
+
+  /**
+   * Sets the name of the filter config the filters added next are created from, until it is set
+   * again. When the filters of the stream are timed, the time spent in their callbacks is
+   * attributed to the config they are created from.
+   * @param name supplies the name of the filter config.
+   */
+  virtual void setFilterConfigName(absl::string_view name) PURE;
 };
 
 /**
@@ -98,18 +98,25 @@ using LowerCaseStrPairVector =
  */
 using InlineHeaderVector = absl::InlinedVector<char, 128>;
 
+/**
+ * Convenient type for refcounted immutable storage shared by copies of a HeaderString.
+ */
+using SharedHeaderVector = std::shared_ptr<const InlineHeaderVector>;
+
 /**
  * Convenient type for the underlying type of HeaderString that allows a variant
- * between string_view and the InlinedVector.
+ * between string_view, the InlinedVector and the shared InlinedVector.
  */
-using VariantHeader = absl::variant<absl::string_view, InlineHeaderVector>;
+using VariantHeader = absl::variant<absl::string_view, InlineHeaderVector, SharedHeaderVector>;
 
 /**
  * This is a string implementation for use in header processing. It is heavily optimized for
- * performance. It supports 2 different types of storage and can switch between them:
+ * performance. It supports 3 different types of storage and can switch between them:
  * 1) A reference.
  * 2) An InlinedVector (an optimized interned string for small strings, but allows heap
  * allocation if needed).
+ * 3) A refcounted immutable InlinedVector, shared with the copies made by copy(). Any change to
+ * the string switches it back to the InlinedVector.
  */
 class HeaderString {
 public:
@@ -206,6 +213,19 @@ public:
    */
   bool isReference() const { return type() == Type::Reference; }
 
+  /**
+   * @return whether the string shares its storage with copies of it.
+   */
+  bool isShared() const { return type() == Type::Shared; }
+
+  /**
+   * Copy the string. Strings too large for the inline storage of the InlinedVector are moved into
+   * refcounted immutable storage shared with the copy, so the bytes are only copied again if
+   * either string is changed. Reference strings are copied, as the copy may outlive the data.
+   * @return the copy.
+   */
+  HeaderString copy() const;
+
   /**
    * @return the size of the string, not including the null terminator.
    */
@@ -221,9 +241,11 @@ public:
   bool operator!=(absl::string_view rhs) const { return getStringView() != rhs; }
 
 private:
-  enum class Type { Reference, Inline };
+  enum class Type { Reference, Inline, Shared };
 
-  VariantHeader buffer_;
+  // Mutable so that copy() can move the storage of the string into shared storage, which doesn't
+  // change its value.
+  mutable VariantHeader buffer_;
 
   bool valid() const;
 
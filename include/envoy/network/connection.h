@@ -323,6 +323,16 @@ public:
    *  returned.
    */
   virtual absl::optional<std::chrono::milliseconds> lastRoundTripTime() const PURE;
+
+  /**
+   * Duplicates the socket of the connection so that another process can continue the connection,
+   * e.g. the child of a hot restart. Only open connections without buffered data nor transport
+   * security state, whose read filters all agree, can be handed over.
+   * @see ReadFilter::canHandOverConnection(). The connection must be closed without flushing
+   * right after, as the peer keeps talking to the duplicated socket.
+   * @return the duplicated socket, or nullptr if the connection can't be handed over.
+   */
+  virtual ConnectionSocketPtr handOver() PURE;
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
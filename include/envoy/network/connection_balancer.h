@@ -27,6 +27,12 @@ public:
    */
   virtual void incNumConnections() PURE;
 
+  /**
+   * @return the recent utilization of the event loop the handler runs on, between 0 and 1, or
+   *         absl::nullopt if it isn't measured. This may be called from any thread.
+   */
+  virtual absl::optional<double> loopUtilization() const PURE;
+
   /**
    * Post a connected socket to this connection handler. This is used for cross-thread connection
    * transfer during the balancing process.
@@ -66,6 +72,20 @@ public:
    */
   virtual BalancedConnectionHandler&
   pickTargetHandler(BalancedConnectionHandler& current_handler) PURE;
+
+  /**
+   * Give the balancer the chance to move a connection that was posted to a handler by
+   * pickTargetHandler() again, to another handler that is less loaded by the time the connection is
+   * dequeued. This is called on the worker of current_handler before the connection becomes
+   * active.
+   * @param current_handler supplies the handler the connection was posted to.
+   * @return current_handler to keep the connection, or a different handler to post it to.
+   *
+   * NOTE: Unlike pickTargetHandler(), the caller moves the connection count to the returned
+   *       handler.
+   */
+  virtual BalancedConnectionHandler&
+  pickQueuedTargetHandler(BalancedConnectionHandler& current_handler) PURE;
 };
 
 using ConnectionBalancerSharedPtr = std::shared_ptr<ConnectionBalancer>;
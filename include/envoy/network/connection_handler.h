@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "envoy/network/connection.h"
 #include "envoy/network/connection_balancer.h"
@@ -101,6 +102,21 @@ public:
    */
   virtual const std::string& statPrefix() const PURE;
 
+  /**
+   * Hands over the connections of the TCP listeners that another process can continue, e.g. the
+   * child of a hot restart, and closes them. @see Connection::handOver().
+   * @return the duplicated sockets of the handed over connections.
+   */
+  virtual std::vector<ConnectionSocketPtr> handOverConnections() PURE;
+
+  /**
+   * Adopts a connection handed over by another process. The connection is added to the TCP
+   * listener of its local address without running the listener filters again, as they already
+   * ran in the other process. The socket is closed if there is no such listener.
+   * @param socket supplies the socket of the connection.
+   */
+  virtual void adoptConnection(ConnectionSocketPtr&& socket) PURE;
+
   /**
    * Used by ConnectionHandler to manage listeners.
    */
@@ -198,6 +198,13 @@ public:
    * @param callbacks supplies the callbacks.
    */
   virtual void initializeReadFilterCallbacks(ReadFilterCallbacks& callbacks) PURE;
+
+  /**
+   * @return whether the filter keeps no state of the connection that another process would need
+   *         to continue it, e.g. an HTTP/1 connection between requests. Filters are assumed to
+   *         keep such state by default. @see Connection::handOver().
+   */
+  virtual bool canHandOverConnection() const { return false; }
 };
 
 using ReadFilterSharedPtr = std::shared_ptr<ReadFilter>;
@@ -31,6 +31,17 @@ public:
   virtual bool onRdsUpdate(const envoy::config::route::v3::RouteConfiguration& rc,
                            const std::string& version_info) PURE;
 
+  /**
+   * Same as onRdsUpdate() above, with the hash of the RouteConfiguration already known, e.g. the
+   * one of the decoded xDS resource. @see Config::DecodedResource::hash().
+   * @param rc supplies the RouteConfiguration.
+   * @param version_info supplies RouteConfiguration version.
+   * @param config_hash supplies the hash identifying the RouteConfiguration.
+   * @return bool whether RouteConfiguration has been updated.
+   */
+  virtual bool onRdsUpdate(const envoy::config::route::v3::RouteConfiguration& rc,
+                           const std::string& version_info, uint64_t config_hash) PURE;
+
   using VirtualHostRefVector =
       std::vector<std::reference_wrapper<const envoy::config::route::v3::VirtualHost>>;
 
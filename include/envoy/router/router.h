@@ -505,7 +505,7 @@ public:
 };
 
 class RateLimitPolicy;
-class Config;
+class CommonConfig;
 
 /**
  * All route specific config returned by the method at
@@ -541,9 +541,10 @@ public:
   virtual const RateLimitPolicy& rateLimitPolicy() const PURE;
 
   /**
-   * @return const Config& the RouteConfiguration that owns this virtual host.
+   * @return const CommonConfig& the common part of the RouteConfiguration that owns this virtual
+   *         host.
    */
-  virtual const Config& routeConfig() const PURE;
+  virtual const CommonConfig& routeConfig() const PURE;
 
   /**
    * @return const RouteSpecificFilterConfig* the per-filter config pre-processed object for
@@ -584,6 +585,33 @@ public:
 /**
  * Route level hedging policy.
  */
+/**
+ * Tracks the latencies of the upstream requests of a route, to hedge the requests that take longer
+ * than a percentile of them. It's shared by all the workers.
+ */
+class LatencyHedging {
+public:
+  virtual ~LatencyHedging() = default;
+
+  /**
+   * Counts a request of the route.
+   * @return the time after which the request should be hedged, or absl::nullopt if not enough
+   * latencies have been recorded yet.
+   */
+  virtual absl::optional<std::chrono::milliseconds> hedgeDelay() PURE;
+
+  /**
+   * Counts a hedged request of the route if there is budget left for it.
+   * @return bool whether the request should be hedged.
+   */
+  virtual bool tryHedge() PURE;
+
+  /**
+   * Records the latency of the response headers of an upstream request of the route.
+   */
+  virtual void recordLatency(std::chrono::milliseconds latency) PURE;
+};
+
 class HedgePolicy {
 public:
   virtual ~HedgePolicy() = default;
@@ -605,6 +633,12 @@ public:
    * will be canceled immediately.
    */
   virtual bool hedgeOnPerTryTimeout() const PURE;
+
+  /**
+   * @return the latency tracker to hedge the requests taking longer than a percentile of the
+   * latencies of the route with, or nullptr if they are not hedged on latency.
+   */
+  virtual LatencyHedging* latencyHedging() const PURE;
 };
 
 class MetadataMatchCriterion {
@@ -1116,12 +1150,49 @@ enum class RouteEvalStatus {
 using RouteCallback = std::function<RouteMatchStatus(RouteConstSharedPtr, RouteEvalStatus)>;
 
 /**
- * The router configuration.
+ * The part of the router configuration that its virtual hosts refer to. Virtual hosts that didn't
+ * change may be shared by the successive configurations of a route, along with this part.
  */
-class Config {
+class CommonConfig {
 public:
-  virtual ~Config() = default;
+  virtual ~CommonConfig() = default;
 
+  /**
+   * Return a list of headers that will be cleaned from any requests that are not from an internal
+   * (RFC1918) source.
+   */
+  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
+
+  /**
+   * @return const std::string the RouteConfiguration name.
+   */
+  virtual const std::string& name() const PURE;
+
+  /**
+   * @return whether router configuration uses VHDS.
+   */
+  virtual bool usesVhds() const PURE;
+
+  /**
+   * @return bool whether most specific header mutations should take precedence. The default
+   * evaluation order is route level, then virtual host level and finally global connection
+   * manager level.
+   */
+  virtual bool mostSpecificHeaderMutationsWins() const PURE;
+
+  /**
+   * @return uint32_t The maximum bytes of the response direct response body size. The default value
+   * is 4096.
+   * TODO(dio): To allow overrides at different levels (e.g. per-route, virtual host, etc).
+   */
+  virtual uint32_t maxDirectResponseBodySizeBytes() const PURE;
+};
+
+/**
+ * The router configuration.
+ */
+class Config : public CommonConfig {
+public:
   /**
    * Based on the incoming HTTP request headers, determine the target route (containing either a
    * route entry or a direct response entry) for the request.
@@ -1152,36 +1223,6 @@ public:
   virtual RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                                     const StreamInfo::StreamInfo& stream_info,
                                     uint64_t random_value) const PURE;
-
-  /**
-   * Return a list of headers that will be cleaned from any requests that are not from an internal
-   * (RFC1918) source.
-   */
-  virtual const std::list<Http::LowerCaseString>& internalOnlyHeaders() const PURE;
-
-  /**
-   * @return const std::string the RouteConfiguration name.
-   */
-  virtual const std::string& name() const PURE;
-
-  /**
-   * @return whether router configuration uses VHDS.
-   */
-  virtual bool usesVhds() const PURE;
-
-  /**
-   * @return bool whether most specific header mutations should take precedence. The default
-   * evaluation order is route level, then virtual host level and finally global connection
-   * manager level.
-   */
-  virtual bool mostSpecificHeaderMutationsWins() const PURE;
-
-  /**
-   * @return uint32_t The maximum bytes of the response direct response body size. The default value
-   * is 4096.
-   * TODO(dio): To allow overrides at different levels (e.g. per-route, virtual host, etc).
-   */
-  virtual uint32_t maxDirectResponseBodySizeBytes() const PURE;
 };
 
 using ConfigConstSharedPtr = std::shared_ptr<const Config>;
@@ -1327,6 +1368,11 @@ public:
    * @param reason supplies the reset reason.
    */
   virtual void resetStream() PURE;
+  /**
+   * Sets the account charged with the memory buffered by the upstream stream.
+   * @param account supplies the account.
+   */
+  virtual void setAccount(Buffer::BufferMemoryAccountSharedPtr account) PURE;
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
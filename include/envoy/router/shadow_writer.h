@@ -11,9 +11,34 @@ namespace Envoy {
 namespace Router {
 
 /**
- * Interface used to shadow complete requests to an alternate upstream cluster in a "fire and
- * forget" fashion. Right now this interface takes a fully buffered request and cannot be used for
- * streaming. This is sufficient for current use cases.
+ * A request shadowed while it is decoded, whose body and trailers are sent to the shadow as they
+ * arrive. Destroying it before the end of the request resets the shadow, otherwise the shadow goes
+ * on in a "fire and forget" fashion.
+ */
+class ShadowStream {
+public:
+  virtual ~ShadowStream() = default;
+
+  /**
+   * Send a chunk of the body of the request to the shadow. The shadow is reset instead if it is
+   * above its write buffer high watermark, so that it never slows down the request.
+   * @param data supplies the chunk, which is left untouched.
+   * @param end_stream supplies whether this is the end of the request.
+   */
+  virtual void sendData(const Buffer::Instance& data, bool end_stream) PURE;
+
+  /**
+   * Send the trailers of the request to the shadow, which ends it.
+   * @param trailers supplies the trailers, which are copied.
+   */
+  virtual void sendTrailers(const Http::RequestTrailerMap& trailers) PURE;
+};
+
+using ShadowStreamPtr = std::unique_ptr<ShadowStream>;
+
+/**
+ * Interface used to shadow requests to an alternate upstream cluster in a "fire and forget"
+ * fashion, either once they are fully buffered or while they are decoded.
  */
 class ShadowWriter {
 public:
@@ -27,6 +52,20 @@ public:
    */
   virtual void shadow(const std::string& cluster, Http::RequestMessagePtr&& request,
                       const Http::AsyncClient::RequestOptions& options) PURE;
+
+  /**
+   * Start shadowing a request while it is decoded.
+   * @param cluster supplies the cluster name to shadow to.
+   * @param headers supplies the headers of the request to shadow.
+   * @param options supplies the options of the shadowed request.
+   * @param end_stream supplies whether the request has no body and no trailers.
+   * @return the stream to send the rest of the request to, or nullptr if the shadow couldn't be
+   *         started.
+   */
+  virtual ShadowStreamPtr streamingShadow(const std::string& cluster,
+                                          Http::RequestHeaderMapPtr&& headers,
+                                          const Http::AsyncClient::RequestOptions& options,
+                                          bool end_stream) PURE;
 };
 
 using ShadowWriterPtr = std::unique_ptr<ShadowWriter>;
@@ -83,6 +83,13 @@ public:
   // deprecated as the feature is defaulted true, and removed with the following Envoy release.
   virtual bool runtimeFeatureEnabled(absl::string_view key) const PURE;
 
+  /**
+   * Returns true if a runtime feature is enabled, as runtimeFeatureEnabled(key) does, without
+   * looking the feature up by name.
+   * @param feature_index supplies the index of the feature in the runtime features.
+   */
+  virtual bool runtimeFeatureEnabled(uint32_t feature_index) const PURE;
+
   /**
    * Test if a feature is enabled using the built in random generator. This is done by generating
    * a random number in the range 0-99 and seeing if this number is < the value stored in the
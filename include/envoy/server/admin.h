@@ -39,6 +39,13 @@ public:
    */
   virtual Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const PURE;
 
+  /**
+   * @return bool whether the handler can continue the response after returning, by encoding more
+   * data with getDecoderFilterCallbacks(). This isn't possible for requests made with
+   * Admin::request().
+   */
+  virtual bool canStreamResponse() const PURE;
+
   /**
    * @return const Buffer::Instance* the fully buffered admin request if applicable.
    */
@@ -84,6 +84,11 @@ public:
    * @return bool indicator to flush stats on-demand via the admin interface instead of on a timer.
    */
   virtual bool flushOnAdmin() const PURE;
+
+  /**
+   * @return bool whether to only flush the metrics that changed since the previous flush.
+   */
+  virtual bool flushChangedOnly() const PURE;
 };
 
 /**
@@ -44,6 +44,14 @@ public:
    */
   virtual int duplicateParentListenSocket(const std::string& address) PURE;
 
+  /**
+   * Retrieve one of the established connections the parent process can hand over, i.e. the idle
+   * plaintext connections whose filters keep no state. The socket will be duplicated across
+   * process boundaries and the parent closes its own copy.
+   * @return int the fd or -1 if the parent has no more connections to hand over.
+   */
+  virtual int duplicateParentConnection() PURE;
+
   /**
    * Initialize the parent logic of our restarter. Meant to be called after initialization of a
    * new child has begun. The hot restart implementation needs to be created early to deal with
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 
 #include "envoy/admin/v3/config_dump.pb.h"
@@ -164,6 +165,20 @@ public:
   virtual bool addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
                                    const std::string& version_info, bool modifiable) PURE;
 
+  /**
+   * Same as addOrUpdateListener() above, with the hash of the config already known, e.g. the one
+   * of the decoded xDS resource. @see Config::DecodedResource::hash().
+   * @param config supplies the configuration proto.
+   * @param version_info supplies the xDS version of the listener.
+   * @param modifiable supplies whether the added listener can be updated or removed.
+   * @param config_hash supplies the hash identifying the listener configuration.
+   * @return TRUE if a listener was added or FALSE if the listener was not updated because it is
+   *         a duplicate of the existing listener.
+   */
+  virtual bool addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
+                                   const std::string& version_info, bool modifiable,
+                                   uint64_t config_hash) PURE;
+
   /**
    * Instruct the listener manager to create an LDS API provider. This is a separate operation
    * during server initialization because the listener manager is created prior to several core
@@ -220,6 +235,27 @@ public:
    */
   virtual void stopWorkers() PURE;
 
+  /**
+   * Callback called with the duplicated sockets of the connections the workers handed over.
+   */
+  using HandOverConnectionsCallback =
+      std::function<void(std::vector<Network::ConnectionSocketPtr>&& sockets)>;
+
+  /**
+   * Hand over the connections of all workers that another process can continue, e.g. the child
+   * of a hot restart, and close them. @see Network::Connection::handOver().
+   * @param callback supplies the callback called on the main thread once all workers handed over
+   *        their connections.
+   */
+  virtual void handOverConnections(HandOverConnectionsCallback callback) PURE;
+
+  /**
+   * Adopt a connection handed over by another process on one of the workers. The socket is closed
+   * if the workers aren't started.
+   * @param socket supplies the socket of the connection.
+   */
+  virtual void adoptConnection(Network::ConnectionSocketPtr&& socket) PURE;
+
   /*
    * Warn the listener manager of an impending update. This allows the listener to clear per-update
    * state.
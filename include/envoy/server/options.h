@@ -244,6 +244,12 @@ public:
    */
   virtual bool cpusetThreadsEnabled() const PURE;
 
+  /**
+   * @return bool indicating whether each worker thread should be pinned to one of the CPUs the
+   *         process may run on.
+   */
+  virtual bool workerCpuAffinityEnabled() const PURE;
+
   /**
    * @return the names of extensions to disable.
    */
@@ -34,10 +34,29 @@ public:
 
   // Overload action to reduce some subset of configured timeouts.
   const std::string ReduceTimeouts = "envoy.overload_actions.reduce_timeouts";
+
+  // Overload action to reject the TLS handshakes that would be offloaded to a handshake thread
+  // pool.
+  const std::string RejectTlsHandshakes = "envoy.overload_actions.reject_tls_handshakes";
+
+  // Overload action to reset the streams buffering the most memory.
+  const std::string ResetStreams = "envoy.overload_actions.reset_high_memory_stream";
 };
 
 using OverloadActionNames = ConstSingleton<OverloadActionNameValues>;
 
+/**
+ * Well-known names of the resources each worker evaluates on its own, which the triggers of the
+ * overload actions can refer to without configuring a resource monitor.
+ */
+class OverloadWorkerResourceNameValues {
+public:
+  // The fraction of the recent wall time the event loop of the worker spent outside of polling.
+  const std::string LoopUtilization = "envoy.worker_resources.loop_utilization";
+};
+
+using OverloadWorkerResourceNames = ConstSingleton<OverloadWorkerResourceNameValues>;
+
 /**
  * The OverloadManager protects the Envoy instance from being overwhelmed by client
  * requests. It monitors a set of resources and notifies registered listeners if
@@ -10,6 +10,7 @@
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/factory_context.h"
+#include "envoy/server/overload/overload_manager.h"
 #include "envoy/singleton/manager.h"
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/scope.h"
@@ -99,6 +100,12 @@ public:
    * @return reference to the Api object
    */
   virtual Api::Api& api() PURE;
+
+  /**
+   * @return the overload manager of the server, or nullptr if the transport socket factory isn't
+   *         created for a listener.
+   */
+  virtual OverloadManager* overloadManager() PURE;
 };
 
 class TransportSocketConfigFactory : public Config::TypedFactory {
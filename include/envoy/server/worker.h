@@ -1,7 +1,9 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
+#include "envoy/network/listen_socket.h"
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload/overload_manager.h"
 
@@ -88,6 +90,27 @@ public:
    */
   virtual void stopListener(Network::ListenerConfig& listener,
                             std::function<void()> completion) PURE;
+
+  /**
+   * Completion called with the duplicated sockets of the connections a worker handed over.
+   */
+  using HandOverConnectionsCompletion =
+      std::function<void(std::vector<Network::ConnectionSocketPtr>&& sockets)>;
+
+  /**
+   * Hand over the connections of the worker that another process can continue, e.g. the child of
+   * a hot restart. @see Network::ConnectionHandler::handOverConnections().
+   * @param completion supplies the completion to be called with the duplicated sockets. This
+   * completion is called on the worker thread. No locking is performed by the worker.
+   */
+  virtual void handOverConnections(HandOverConnectionsCompletion completion) PURE;
+
+  /**
+   * Adopt a connection handed over by another process.
+   * @see Network::ConnectionHandler::adoptConnection().
+   * @param socket supplies the socket of the connection.
+   */
+  virtual void adoptConnection(Network::ConnectionSocketPtr&& socket) PURE;
 };
 
 using WorkerPtr = std::unique_ptr<Worker>;
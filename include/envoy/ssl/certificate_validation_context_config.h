@@ -79,6 +79,12 @@ public:
   virtual const absl::optional<envoy::config::core::v3::TypedExtensionConfig>&
   customValidatorConfig() const PURE;
 
+  /**
+   * @return the maximum number of successful peer certificate chain verifications to cache, or 0
+   *         if verifications aren't cached.
+   */
+  virtual uint32_t verificationCacheSize() const PURE;
+
   /**
    * @return a reference to the api object.
    */
@@ -4,11 +4,16 @@
 #include <chrono>
 #include <functional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "envoy/common/pure.h"
+#include "envoy/common/time.h"
 #include "envoy/ssl/certificate_validation_context_config.h"
+#include "envoy/ssl/handshake_offload.h"
 #include "envoy/ssl/handshaker.h"
+#include "envoy/ssl/ocsp_fetcher.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/ssl/tls_certificate_config.h"
 
 #include "absl/types/optional.h"
@@ -16,6 +21,21 @@
 namespace Envoy {
 namespace Ssl {
 
+/**
+ * How much plaintext the TLS records written to the connections of a context hold. The records of
+ * a connection start at initial_record_size_ and grow by as much each, up to the maximum record
+ * size.
+ */
+struct RecordSizing {
+  // The amount of plaintext in the first record written to a connection.
+  uint32_t initial_record_size_{1208};
+  // The amount of plaintext written to a connection after which all its records are full sized.
+  uint64_t boost_threshold_{128 * 1024};
+  // How long a connection must not write anything for its records to start from
+  // initial_record_size_ again, or zero if they never do.
+  std::chrono::milliseconds idle_timeout_{};
+};
+
 /**
  * Supplies the configuration for an SSL context.
  */
@@ -89,6 +109,11 @@ public:
    * @return a callback for configuring an SSL_CTX before use.
    */
   virtual SslCtxCb sslctxCb() const PURE;
+
+  /**
+   * @return how much plaintext the TLS records written to the connections hold.
+   */
+  virtual RecordSizing recordSizing() const PURE;
 };
 
 class ClientContextConfig : public virtual ContextConfig {
@@ -128,6 +153,31 @@ public:
     std::array<uint8_t, 256 / 8> aes_key_; // AES256 key size, in bytes
   };
 
+  /**
+   * Holds the session ticket keys of server contexts. The keys are rotated in place, so that the
+   * contexts using them pick up new keys without being recreated.
+   */
+  class SessionTicketKeyRing {
+  public:
+    struct Keys {
+      // New session tickets are encrypted with the first key, and session tickets encrypted with
+      // any of the keys are accepted.
+      std::vector<SessionTicketKey> keys_;
+      // Keys that have been rotated out, which are accepted for decrypting session tickets until
+      // the time paired with them.
+      std::vector<std::pair<SessionTicketKey, MonotonicTime>> retired_keys_;
+    };
+
+    virtual ~SessionTicketKeyRing() = default;
+
+    /**
+     * @return the current keys, which don't change when the keys are rotated. Thread safe.
+     */
+    virtual std::shared_ptr<const Keys> keys() const PURE;
+  };
+
+  using SessionTicketKeyRingSharedPtr = std::shared_ptr<const SessionTicketKeyRing>;
+
   enum class OcspStaplePolicy {
     LenientStapling,
     StrictStapling,
@@ -152,6 +202,12 @@ public:
    */
   virtual const std::vector<SessionTicketKey>& sessionTicketKeys() const PURE;
 
+  /**
+   * @return the key ring holding sessionTicketKeys(), which is updated in place when the keys are
+   * rotated, or nullptr if no session ticket keys are configured.
+   */
+  virtual SessionTicketKeyRingSharedPtr sessionTicketKeyRing() const PURE;
+
   /**
    * @return timeout in seconds for the session.
    * Session timeout is used to specify lifetime hint of tls tickets.
@@ -162,6 +218,30 @@ public:
    * @return True if stateless TLS session resumption is disabled, false otherwise.
    */
   virtual bool disableStatelessSessionResumption() const PURE;
+
+  /**
+   * @return the external cache to store sessions in and look them up from, or nullptr if sessions
+   * are only cached in memory.
+   */
+  virtual SessionCacheSharedPtr sessionCache() const PURE;
+
+  /**
+   * @return the pool of threads to run the handshakes on, or nullptr if they run on the worker
+   * threads of their connections.
+   */
+  virtual HandshakeOffloadPoolSharedPtr handshakeOffloadPool() const PURE;
+
+  /**
+   * @return true if the encryption of the data written to the connections is offloaded to the
+   * kernel once their handshakes complete, when the kernel supports it.
+   */
+  virtual bool enableKernelTlsTx() const PURE;
+
+  /**
+   * @return the fetcher of the OCSP responses of the certificates that have no OCSP staple, or
+   * nullptr if they aren't fetched.
+   */
+  virtual OcspFetcherSharedPtr ocspFetcher() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
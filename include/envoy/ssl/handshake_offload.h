@@ -0,0 +1,32 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * A pool of threads that the handshakes of server contexts are offloaded to, so that they don't
+ * run on the worker threads of their connections.
+ */
+class HandshakeOffloadPool {
+public:
+  virtual ~HandshakeOffloadPool() = default;
+
+  /**
+   * Queues a step of a handshake for a thread of the pool. Called on the worker thread of the
+   * connection.
+   * @param step supplies the step, which is run on a thread of the pool.
+   * @return whether the step was queued. It isn't if too many steps are already pending, or if
+   *         the overload manager rejects TLS handshakes, in which case the connection is closed.
+   */
+  virtual bool tryPost(std::function<void()> step) PURE;
+};
+
+using HandshakeOffloadPoolSharedPtr = std::shared_ptr<HandshakeOffloadPool>;
+
+} // namespace Ssl
+} // namespace Envoy
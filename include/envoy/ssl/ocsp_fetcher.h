@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/common/time.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Ssl {
+
+/**
+ * An OCSP response fetched from the OCSP responder of a certificate.
+ */
+struct FetchedOcspResponse {
+  // The DER encoded response.
+  std::vector<uint8_t> der_;
+  // The time after which the response is expired.
+  SystemTime next_update_;
+};
+
+using FetchedOcspResponseConstSharedPtr = std::shared_ptr<const FetchedOcspResponse>;
+
+/**
+ * The latest OCSP response fetched for a certificate, which is replaced as it is refreshed. Used
+ * from the worker threads, so it must be thread safe.
+ */
+class OcspResponseSlot {
+public:
+  virtual ~OcspResponseSlot() = default;
+
+  /**
+   * @return the latest response, or nullptr if none has been fetched yet.
+   */
+  virtual FetchedOcspResponseConstSharedPtr response() const PURE;
+};
+
+using OcspResponseSlotSharedPtr = std::shared_ptr<OcspResponseSlot>;
+
+/**
+ * Fetches the OCSP responses of the certificates of server contexts in the background, and keeps
+ * refreshing them for as long as a context uses them.
+ */
+class OcspFetcher {
+public:
+  virtual ~OcspFetcher() = default;
+
+  /**
+   * Starts fetching the OCSP response of a certificate, unless it is already fetched. Called on
+   * the main thread.
+   * @param certificate supplies the certificate.
+   * @param issuer supplies the issuer of the certificate, or nullptr if it is unknown.
+   * @return the slot of the fetched responses of the certificate, or nullptr if they can't be
+   *         fetched because the issuer is unknown or the certificate has no OCSP responder URL.
+   */
+  virtual OcspResponseSlotSharedPtr fetch(X509& certificate, X509* issuer) PURE;
+};
+
+using OcspFetcherSharedPtr = std::shared_ptr<OcspFetcher>;
+
+} // namespace Ssl
+} // namespace Envoy
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+#include "envoy/config/typed_config.h"
+#include "envoy/event/dispatcher.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Server {
+namespace Configuration {
+// Prevent a dependency loop with the forward declaration.
+class TransportSocketFactoryContext;
+} // namespace Configuration
+} // namespace Server
+
+namespace Ssl {
+
+/**
+ * A lookup in a SessionCache that is still pending.
+ */
+class SessionCacheLookup {
+public:
+  virtual ~SessionCacheLookup() = default;
+
+  /**
+   * Cancels the lookup, so that its callback isn't called.
+   */
+  virtual void cancel() PURE;
+};
+
+using SessionCacheLookupPtr = std::unique_ptr<SessionCacheLookup>;
+
+/**
+ * Called with the session found by a lookup, serialized with SSL_SESSION_to_bytes(), or with
+ * absl::nullopt if the cache has no session with the session ID.
+ */
+using SessionCacheLookupCb = std::function<void(absl::optional<std::string>&& session)>;
+
+/**
+ * An external cache of the TLS sessions of server contexts, keyed by session ID. Sharing a cache
+ * between Envoys lets clients resume their sessions on any of them. Caches are used from the
+ * worker threads and must be thread safe.
+ */
+class SessionCache {
+public:
+  virtual ~SessionCache() = default;
+
+  /**
+   * Stores the session established by a full handshake.
+   * @param session_id supplies the ID of the session.
+   * @param session supplies the session, serialized with SSL_SESSION_to_bytes().
+   * @param timeout supplies how long the session can be resumed for.
+   */
+  virtual void insert(absl::string_view session_id, std::string&& session,
+                      std::chrono::seconds timeout) PURE;
+
+  /**
+   * Looks up the session that a client offered to resume.
+   * @param session_id supplies the ID of the session.
+   * @param dispatcher supplies the dispatcher of the worker thread of the connection.
+   * @param callback supplies the callback to call with the session, on the thread of dispatcher.
+   *        It may be called before lookup() returns. The lookup may be destroyed by the callback.
+   * @return SessionCacheLookupPtr the lookup if it is still pending when lookup() returns, or
+   *         nullptr if the callback has been called.
+   */
+  virtual SessionCacheLookupPtr lookup(absl::string_view session_id, Event::Dispatcher& dispatcher,
+                                       SessionCacheLookupCb callback) PURE;
+};
+
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+class SessionCacheFactory : public Config::TypedFactory {
+public:
+  /**
+   * Creates a session cache. Throws an EnvoyException if the cache can't be created with the
+   * config.
+   * @param config supplies the config of the cache.
+   * @param factory_context supplies the factory context of the transport socket.
+   * @return SessionCacheSharedPtr the cache.
+   */
+  virtual SessionCacheSharedPtr
+  createSessionCache(const Protobuf::Message& config,
+                     Server::Configuration::TransportSocketFactoryContext& factory_context) PURE;
+
+  std::string category() const override { return "envoy.tls.session_caches"; }
+};
+
+} // namespace Ssl
+} // namespace Envoy
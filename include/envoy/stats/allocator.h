@@ -37,6 +37,18 @@ public:
   virtual CounterSharedPtr makeCounter(StatName name, StatName tag_extracted_name,
                                        const StatNameTagVector& stat_name_tags) PURE;
 
+  /**
+   * Makes a counter for stats incremented by many threads at high rates. Increments are recorded
+   * per thread rather than in a single location shared by all threads, at the cost of more memory
+   * and slower reads.
+   * @param name the full name of the stat.
+   * @param tag_extracted_name the name of the stat with tag-values stripped out.
+   * @param stat_name_tags the tag values.
+   * @return CounterSharedPtr a counter.
+   */
+  virtual CounterSharedPtr makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                              const StatNameTagVector& stat_name_tags) PURE;
+
   /**
    * @param name the full name of the stat.
    * @param tag_extracted_name the name of the stat with tag-values stripped out.
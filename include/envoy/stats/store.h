@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 
+#include "envoy/common/matchers.h"
 #include "envoy/common/pure.h"
 #include "envoy/stats/histogram.h"
 #include "envoy/stats/scope.h"
@@ -85,6 +86,20 @@ public:
    */
   virtual void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) PURE;
 
+  /**
+   * Set the matchers selecting the counters to create as sharded counters.
+   * @see Allocator::makeShardedCounter
+   * @param matchers counters whose full names match any of these are sharded.
+   */
+  virtual void setShardedCounters(std::vector<Matchers::StringMatcherPtr>&& matchers) PURE;
+
+  /**
+   * Set the matchers selecting the histograms that count the values recorded on each thread in
+   * per-thread buckets until they are merged.
+   * @param matchers histograms whose full names match any of these are bucketed.
+   */
+  virtual void setBucketedHistograms(std::vector<Matchers::StringMatcherPtr>&& matchers) PURE;
+
   /**
    * Initialize the store for threading. This will be called once after all worker threads have
    * been initialized. At this point the store can initialize itself for multi-threaded operation.
@@ -503,6 +503,16 @@ public:
    */
   virtual void setDynamicMetadata(const std::string& name, const ProtobufWkt::Struct& value) PURE;
 
+  /**
+   * Same as above, but the values of the struct may be moved into the metadata instead of being
+   * copied. The struct is left in a valid but unspecified state.
+   * @param name the namespace used in the metadata in reverse DNS format.
+   * @param value the struct to set on the namespace.
+   */
+  virtual void setDynamicMetadata(const std::string& name, ProtobufWkt::Struct&& value) {
+    setDynamicMetadata(name, value);
+  }
+
   /**
    * Object on which filters can share data on a per-request basis. For singleton data objects, only
    * one filter can produce a named data object. List data objects can be updated by multiple
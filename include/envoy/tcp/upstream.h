@@ -102,6 +102,14 @@ public:
    */
   virtual Tcp::ConnectionPool::ConnectionData*
   onDownstreamEvent(Network::ConnectionEvent event) PURE;
+
+  /**
+   * Releases the upstream at the end of a session, without closing it, for its connection to be
+   * reused by the next session.
+   * @return whether the upstream was released. If not, it's still to be closed by
+   *         onDownstreamEvent().
+   */
+  virtual bool releaseForReuse() PURE;
 };
 
 using GenericConnPoolPtr = std::unique_ptr<GenericConnPool>;
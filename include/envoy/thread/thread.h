@@ -56,6 +56,9 @@ using ThreadPtr = std::unique_ptr<Thread>;
 // Options specified during thread creation.
 struct Options {
   std::string name_; // A name supplied for the thread. On Linux this is limited to 15 chars.
+  // If set, the thread is pinned to the CPU of this index, modulo their number, among the CPUs the
+  // creating thread may run on. Only supported on Linux, ignored elsewhere.
+  absl::optional<uint32_t> cpu_index_{};
 };
 
 using OptionsOptConstRef = const absl::optional<Options>&;
@@ -38,14 +38,22 @@ public:
   virtual ThreadLocalObjectSharedPtr get() PURE;
 
   /**
-   * This is a helper on top of get() that casts the object stored in the slot to the specified
+   * @return ThreadLocalObject* the thread local object stored in the slot, or nullptr if there is
+   *         none. Unlike get(), this does not copy the shared_ptr, whose reference count is shared
+   *         by all the threads when they store the same object.
+   */
+  virtual ThreadLocalObject* getPtr() PURE;
+
+  /**
+   * This is a helper on top of getPtr() that casts the object stored in the slot to the specified
    * type. Since the slot only stores pointers to the base interface, the static_cast operates
    * in production for performance, and the dynamic_cast validates correctness in tests and debug
    * builds.
    */
   template <class T> T& getTyped() {
-    ASSERT(std::dynamic_pointer_cast<T>(get()) != nullptr);
-    return *static_cast<T*>(get().get());
+    ThreadLocalObject* obj = getPtr();
+    ASSERT(dynamic_cast<T*>(obj) != nullptr);
+    return *static_cast<T*>(obj);
   }
 
   /**
@@ -141,8 +149,8 @@ public:
   /**
    * @return an optional reference to the thread local object.
    */
-  OptRef<T> get() { return getOpt(slot_->get()); }
-  const OptRef<T> get() const { return getOpt(slot_->get()); }
+  OptRef<T> get() { return getOpt(slot_->getPtr()); }
+  const OptRef<T> get() const { return getOpt(slot_->getPtr()); }
 
   /**
    * Helper function to call methods on T. The caller is responsible
@@ -178,15 +186,15 @@ public:
   }
 
 private:
-  static OptRef<T> getOpt(ThreadLocalObjectSharedPtr obj) {
-    if (obj) {
+  static OptRef<T> getOpt(ThreadLocalObject* obj) {
+    if (obj != nullptr) {
       return OptRef<T>(obj->asType<T>());
     }
     return OptRef<T>();
   }
 
   Slot::UpdateCb makeSlotUpdateCb(UpdateCb cb) {
-    return [cb](ThreadLocalObjectSharedPtr obj) { cb(getOpt(obj)); };
+    return [cb](ThreadLocalObjectSharedPtr obj) { cb(getOpt(obj.get())); };
   }
 
   const SlotPtr slot_;
@@ -17,6 +17,7 @@
 #include "envoy/grpc/async_client_manager.h"
 #include "envoy/http/conn_pool.h"
 #include "envoy/local_info/local_info.h"
+#include "envoy/protobuf/message_validator.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/secret/secret_manager.h"
 #include "envoy/server/admin.h"
@@ -32,6 +33,8 @@
 #include "envoy/upstream/thread_local_cluster.h"
 #include "envoy/upstream/upstream.h"
 
+#include "common/common/cleanup.h"
+
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
 
@@ -119,6 +122,70 @@ struct ClusterConnectivityState {
   int64_t connecting_and_connected_stream_capacity_{};
 };
 
+/**
+ * Posts the thread local cluster updates batched since its creation when destroyed.
+ * @see ClusterManager::batchClusterUpdates().
+ */
+using ClusterUpdateBatch = std::unique_ptr<Cleanup>;
+
+/**
+ * The outcome of an on-demand cluster discovery. @see OdCdsApiHandle.
+ */
+enum class ClusterDiscoveryStatus {
+  // The cluster wasn't discovered before the discovery timed out.
+  Timeout,
+  // The discovery service doesn't know the cluster.
+  Missing,
+  // The cluster is available on the thread that requested it.
+  Available,
+};
+
+/**
+ * The callback of an on-demand cluster discovery, invoked on the thread that requested it.
+ */
+using ClusterDiscoveryCallback = std::function<void(ClusterDiscoveryStatus)>;
+using ClusterDiscoveryCallbackPtr = std::unique_ptr<ClusterDiscoveryCallback>;
+
+/**
+ * ClusterDiscoveryCallbackHandle is a RAII wrapper for a ClusterDiscoveryCallback. Deleting the
+ * handle cancels the callback, if it wasn't invoked yet.
+ */
+class ClusterDiscoveryCallbackHandle {
+public:
+  virtual ~ClusterDiscoveryCallbackHandle() = default;
+};
+
+using ClusterDiscoveryCallbackHandlePtr = std::unique_ptr<ClusterDiscoveryCallbackHandle>;
+
+/**
+ * A handle to an on-demand CDS (ODCDS) provider, which discovers the clusters by name when the
+ * requests need them, rather than having all the clusters pushed to every worker up front.
+ * @see ClusterManager::allocateOdCdsApi().
+ */
+class OdCdsApiHandle {
+public:
+  virtual ~OdCdsApiHandle() = default;
+
+  /**
+   * Requests the discovery of a cluster which is missing on the calling worker thread. The
+   * requests of all the workers for the same cluster are coalesced into a single discovery, and
+   * the request isn't blocked while the cluster is being discovered.
+   *
+   * @param name supplies the name of the cluster.
+   * @param callback supplies the callback invoked on the calling thread once the cluster is
+   *        available there, is missing, or wasn't discovered in time.
+   * @param timeout supplies the time to wait for the cluster, if this request starts discovering
+   *        it. The requests joining a discovery in progress share its timeout.
+   * @return ClusterDiscoveryCallbackHandlePtr a RAII that needs to be deleted to cancel the
+   *         callback.
+   */
+  virtual ClusterDiscoveryCallbackHandlePtr
+  requestOnDemandClusterDiscovery(const std::string& name, ClusterDiscoveryCallbackPtr callback,
+                                  std::chrono::milliseconds timeout) PURE;
+};
+
+using OdCdsApiHandleSharedPtr = std::shared_ptr<OdCdsApiHandle>;
+
 /**
  * Manages connection pools and load balancing for upstream clusters. The cluster manager is
  * persistent and shared among multiple ongoing requests/connections.
@@ -153,6 +220,17 @@ public:
   virtual bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                   const std::string& version_info) PURE;
 
+  /**
+   * Same as addOrUpdateCluster() above, with the hash of the config already known, e.g. the one
+   * of the decoded xDS resource. @see Config::DecodedResource::hash().
+   * @param cluster supplies the cluster configuration.
+   * @param version_info supplies the xDS version of the cluster.
+   * @param config_hash supplies the hash identifying the cluster configuration.
+   * @return true if the action results in an add/update of a cluster.
+   */
+  virtual bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                  const std::string& version_info, uint64_t config_hash) PURE;
+
   /**
    * Set a callback that will be invoked when all primary clusters have been initialized.
    */
@@ -309,6 +387,35 @@ public:
   virtual const ClusterRequestResponseSizeStatNames&
   clusterRequestResponseSizeStatNames() const PURE;
   virtual const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const PURE;
+
+  /**
+   * @return whether clusters should only create their stats when first written.
+   */
+  virtual bool deferredClusterStats() const PURE;
+
+  /**
+   * Batch the updates of the thread local clusters that follow, such as the clusters added by a
+   * CDS update, so that they are posted to the workers at once rather than one at a time. The
+   * updates are posted in order when the last returned object is destroyed. Batches may nest.
+   *
+   * @return a ClusterUpdateBatch object, which when destructed, posts the batched updates.
+   */
+  ABSL_MUST_USE_RESULT virtual ClusterUpdateBatch batchClusterUpdates() PURE;
+
+  /**
+   * Allocates an on-demand CDS (ODCDS) provider, which fetches the clusters requested through
+   * the returned handle from the given config source. Must be called on the main thread.
+   *
+   * @param odcds_config supplies the config source of the clusters discovered on demand.
+   * @param idle_timeout supplies the time after which a cluster discovered on demand is removed
+   *        if no request used it meanwhile, or zero if the clusters are never removed.
+   * @param validation_visitor supplies the validation visitor of the discovered clusters.
+   * @return OdCdsApiHandleSharedPtr the handle of the provider, which may be used on any worker.
+   */
+  virtual OdCdsApiHandleSharedPtr
+  allocateOdCdsApi(const envoy::config::core::v3::ConfigSource& odcds_config,
+                   std::chrono::milliseconds idle_timeout,
+                   ProtobufMessage::ValidationVisitor& validation_visitor) PURE;
 };
 
 using ClusterManagerPtr = std::unique_ptr<ClusterManager>;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
@@ -52,10 +54,36 @@ struct HostStats {
   std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>> gauges() const {
     return {ALL_HOST_STATS(IGNORE_PRIMITIVE_COUNTER, PRIMITIVE_GAUGE_NAME_AND_REFERENCE)};
   }
+
+  // Whether the host is in the LoadReportHosts of its cluster, set from the workers once the host
+  // receives load and cleared by LoadStatsReporter when it collects the load of the host.
+  std::atomic<bool> load_report_pending_{};
 };
 
 class ClusterInfo;
 
+/**
+ * Peak EWMA estimate of the response latency of a host, used by latency aware load balancing. The
+ * estimate jumps to any sample above it and decays towards lower ones, so that a host that slows
+ * down is avoided right away but only regains its share of traffic gradually.
+ */
+class LatencyEstimate {
+public:
+  virtual ~LatencyEstimate() = default;
+
+  /**
+   * Records a latency sample. Safe to call from any thread.
+   * @param latency supplies the time between sending a request and receiving its response.
+   * @param now supplies the time at which the response was received.
+   */
+  virtual void observe(std::chrono::microseconds latency, MonotonicTime now) PURE;
+
+  /**
+   * @return double the current estimate in microseconds.
+   */
+  virtual double value() const PURE;
+};
+
 /**
  * A description of an upstream host.
  */
@@ -154,6 +182,12 @@ public:
    * @return timestamp in milliseconds of when host was created.
    */
   virtual MonotonicTime creationTime() const PURE;
+
+  /**
+   * @return the latency estimate of the host, which is only fed for clusters using the peak EWMA
+   *         load balancer.
+   */
+  virtual LatencyEstimate& latencyEstimate() const PURE;
 };
 
 using HostDescriptionConstSharedPtr = std::shared_ptr<const HostDescription>;
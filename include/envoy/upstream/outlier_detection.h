@@ -110,6 +110,13 @@ public:
    * and LocalOrigin type returns success rate for local origin errors.
    */
   virtual double successRate(SuccessRateMonitorType type) const PURE;
+
+  /**
+   * @return the 99th percentile response time of the host in the last calculated interval, in
+   *         milliseconds. -1 means that latency based outlier detection is disabled, or that the
+   *         host did not have enough responses or the cluster enough hosts to run through it.
+   */
+  virtual double latencyMs() const PURE;
 };
 
 using DetectorHostMonitorPtr = std::unique_ptr<DetectorHostMonitor>;
@@ -150,6 +157,14 @@ public:
    */
   virtual double
       successRateEjectionThreshold(DetectorHostMonitor::SuccessRateMonitorType) const PURE;
+
+  /**
+   * Returns the median of the 99th percentile response times of the hosts in the Detector for the
+   * last aggregation interval, in milliseconds.
+   * @return the median, or -1 if there were not enough hosts with enough responses to proceed with
+   *         latency based outlier ejection.
+   */
+  virtual double latencyMedianMs() const PURE;
 };
 
 using DetectorSharedPtr = std::shared_ptr<Detector>;
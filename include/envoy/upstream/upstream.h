@@ -585,6 +585,7 @@ public:
   GAUGE(upstream_cx_rx_bytes_buffered, Accumulate)                                                 \
   GAUGE(upstream_cx_tx_bytes_buffered, Accumulate)                                                 \
   GAUGE(upstream_rq_active, Accumulate)                                                            \
+  GAUGE(upstream_rq_buffered_bytes, Accumulate)                                                    \
   GAUGE(upstream_rq_pending_active, Accumulate)                                                    \
   GAUGE(version, NeverImport)                                                                      \
   HISTOGRAM(upstream_cx_connect_ms, Milliseconds)                                                  \
@@ -688,6 +689,42 @@ public:
 };
 using ProtocolOptionsConfigConstSharedPtr = std::shared_ptr<const ProtocolOptionsConfig>;
 
+/**
+ * The hosts of a cluster which received load since the load reporter last collected them, so that
+ * it only visits these rather than all the hosts of the cluster. The hosts are added from any
+ * thread, and only once per collection: the workers only check an atomic flag of the host as long
+ * as it's already added, so the overhead per request is negligible.
+ */
+class LoadReportHosts {
+public:
+  virtual ~LoadReportHosts() = default;
+
+  /**
+   * Adds a host which received load, i.e. a request was issued to it or failed on it, if it isn't
+   * already added. This is a no-op unless the load of the cluster is reported.
+   * @param host supplies the host.
+   */
+  virtual void add(const HostDescriptionConstSharedPtr& host) PURE;
+
+  /**
+   * Takes the hosts added since the last call, so that they're added again once they receive
+   * load. Must be called before reading their load stats, so that no load is missed.
+   * @return the hosts which received load since the last call.
+   */
+  virtual std::vector<HostDescriptionConstSharedPtr> take() PURE;
+
+  /**
+   * @return whether the load of the cluster is reported.
+   */
+  virtual bool enabled() const PURE;
+
+  /**
+   * @param enabled supplies whether the load of the cluster is reported, in which case the hosts
+   *        which receive load are added. Disabling it drops the hosts already added.
+   */
+  virtual void setEnabled(bool enabled) PURE;
+};
+
 /**
  *  Base class for all cluster typed metadata factory.
  */
@@ -741,6 +778,17 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the window over which connection pools count stream arrivals to decide how many
+   *         connections to keep warm, if rate based preconnecting is enabled.
+   */
+  virtual absl::optional<std::chrono::milliseconds> rateBasedPreconnectWindow() const PURE;
+
+  /**
+   * @return whether workers should connect to each healthy host as soon as it is known.
+   */
+  virtual bool prewarmHosts() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -827,6 +875,12 @@ public:
   virtual const absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig>&
   lbMaglevConfig() const PURE;
 
+  /**
+   * @return configuration for peak EWMA load balancing, only used if type is set to peak_ewma.
+   */
+  virtual const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const PURE;
+
   /**
    * @return const absl::optional<envoy::config::cluster::v3::Cluster::OriginalDstLbConfig>& the
    * configuration for the Original Destination load balancing policy, only used if type is set to
@@ -904,6 +958,12 @@ public:
    */
   virtual ClusterLoadReportStats& loadReportStats() const PURE;
 
+  /**
+   * @return LoadReportHosts& the hosts of this cluster which received load since the load
+   *         reporter last collected them.
+   */
+  virtual LoadReportHosts& loadReportHosts() const PURE;
+
   /**
    * @return absl::optional<std::reference_wrapper<ClusterRequestResponseSizeStats>> stats to track
    * headers/body sizes of request/response for this cluster.
@@ -957,6 +1017,12 @@ public:
    */
   virtual bool connectionPoolPerDownstreamConnection() const PURE;
 
+  /**
+   * @return the number of partitions the workers are split into, each of which only uses its own
+   *         share of the hosts of the cluster. 1 if the hosts aren't partitioned.
+   */
+  virtual uint32_t workerPartitions() const PURE;
+
   /**
    * @return true if this cluster is configured to ignore hosts for the purpose of load balancing
    * computations until they have been health checked for the first time.
@@ -15,6 +15,7 @@
 #include "common/common/utility.h"
 #include "common/config/metadata.h"
 #include "common/config/utility.h"
+#include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
@@ -79,6 +80,8 @@ FilterPtr FilterFactory::fromProto(const envoy::config::accesslog::v3::AccessLog
     return FilterPtr{new GrpcStatusFilter(config.grpc_status_filter())};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kMetadataFilter:
     return FilterPtr{new MetadataFilter(config.metadata_filter())};
+  case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kTailSamplingFilter:
+    return FilterPtr{new TailSamplingFilter(config.tail_sampling_filter(), random)};
   case envoy::config::accesslog::v3::AccessLogFilter::FilterSpecifierCase::kExtensionFilter:
     MessageUtil::validate(config, validation_visitor);
     {
@@ -150,6 +153,36 @@ bool RuntimeFilter::evaluate(const StreamInfo::StreamInfo& stream_info,
       ProtobufPercentHelper::fractionalPercentDenominatorToInt(percent_.denominator()));
 }
 
+TailSamplingFilter::TailSamplingFilter(
+    const envoy::config::accesslog::v3::TailSamplingFilter& config, Random::RandomGenerator& random)
+    : random_(random), keep_errors_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, keep_errors, true)),
+      slow_request_threshold_(
+          config.has_slow_request_threshold()
+              ? absl::make_optional(std::chrono::milliseconds(
+                    DurationUtil::durationToMilliseconds(config.slow_request_threshold())))
+              : absl::nullopt),
+      sample_numerator_(config.sample_rate().numerator()),
+      sample_denominator_(ProtobufPercentHelper::fractionalPercentDenominatorToInt(
+          config.sample_rate().denominator())) {}
+
+bool TailSamplingFilter::evaluate(const StreamInfo::StreamInfo& info,
+                                  const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                  const Http::ResponseTrailerMap&) const {
+  if (keep_errors_ &&
+      (info.hasAnyResponseFlag() ||
+       (info.responseCode() && Http::CodeUtility::is5xx(info.responseCode().value())))) {
+    return true;
+  }
+  if (slow_request_threshold_.has_value()) {
+    const absl::optional<std::chrono::nanoseconds> duration = info.requestComplete();
+    if (duration && duration.value() >= slow_request_threshold_.value()) {
+      return true;
+    }
+  }
+  // The random value is only drawn for the requests that aren't already kept.
+  return sample_numerator_ > 0 && random_.random() % sample_denominator_ < sample_numerator_;
+}
+
 OperatorFilter::OperatorFilter(
     const Protobuf::RepeatedPtrField<envoy::config::accesslog::v3::AccessLogFilter>& configs,
     Runtime::Loader& runtime, Random::RandomGenerator& random,
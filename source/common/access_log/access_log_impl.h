@@ -168,6 +168,27 @@ private:
   const bool use_independent_randomness_;
 };
 
+/**
+ * Filter keeping the failed requests, the slow ones and a sample of the rest.
+ */
+class TailSamplingFilter : public Filter {
+public:
+  TailSamplingFilter(const envoy::config::accesslog::v3::TailSamplingFilter& config,
+                     Random::RandomGenerator& random);
+
+  // AccessLog::Filter
+  bool evaluate(const StreamInfo::StreamInfo& info, const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers) const override;
+
+private:
+  Random::RandomGenerator& random_;
+  const bool keep_errors_;
+  const absl::optional<std::chrono::milliseconds> slow_request_threshold_;
+  const uint64_t sample_numerator_;
+  const uint64_t sample_denominator_;
+};
+
 /**
  * Filter based on headers.
  */
@@ -1,5 +1,6 @@
 #include "common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -34,23 +35,89 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   if (access_logs_.count(file_name)) {
     return access_logs_[file_name];
   }
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  if (flush_thread_ == nullptr) {
+    flush_thread_ = std::make_shared<AccessLogFlushThread>(api_.threadFactory());
+  }
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_, flush_thread_);
   return access_logs_[file_name];
 }
 
+AccessLogFlushThread::~AccessLogFlushThread() {
+  Thread::ThreadPtr thread;
+  {
+    Thread::LockGuard lock(lock_);
+    ASSERT(pending_.empty());
+    exit_ = true;
+    thread = std::move(thread_);
+  }
+  pending_event_.notifyOne();
+  if (thread != nullptr) {
+    thread->join();
+  }
+}
+
+void AccessLogFlushThread::schedule(AccessLogFileImpl& file) {
+  {
+    Thread::LockGuard lock(lock_);
+    if (!pending_files_.insert(&file).second) {
+      return;
+    }
+    pending_.push_back(&file);
+    if (thread_ == nullptr) {
+      thread_ = thread_factory_.createThread([this]() -> void { threadRoutine(); },
+                                             Thread::Options{"AccessLogFlush"});
+    }
+  }
+  pending_event_.notifyOne();
+}
+
+void AccessLogFlushThread::remove(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(lock_);
+  if (pending_files_.erase(&file) > 0) {
+    pending_.erase(std::find(pending_.begin(), pending_.end(), &file));
+  }
+  while (flushing_ == &file) {
+    // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+    flush_done_event_.wait(lock_);
+  }
+}
+
+void AccessLogFlushThread::threadRoutine() {
+  while (true) {
+    AccessLogFileImpl* file;
+    {
+      Thread::LockGuard lock(lock_);
+      flushing_ = nullptr;
+      flush_done_event_.notifyAll();
+      while (pending_.empty() && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        pending_event_.wait(lock_);
+      }
+      if (exit_) {
+        return;
+      }
+      file = pending_.front();
+      pending_.pop_front();
+      pending_files_.erase(file);
+      flushing_ = file;
+    }
+    // remove() keeps the file alive until flushing_ is reset.
+    file->flushFromFlushThread();
+  }
+}
+
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
+                                     AccessLogFlushThreadSharedPtr flush_thread)
+    : file_(std::move(file)), file_lock_(lock), flush_thread_(std::move(flush_thread)),
       flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        flush_thread_->schedule(*this);
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      flush_interval_msec_(flush_interval_msec), stats_(stats) {
   flush_timer_->enableTimer(flush_interval_msec_);
   auto open_result = open();
   if (!open_result.rc_) {
@@ -75,15 +142,7 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  flush_thread_->remove(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
@@ -125,45 +184,37 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
+void AccessLogFileImpl::flushFromFlushThread() {
+  std::unique_lock<Thread::BasicLockable> flush_lock;
 
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
+  {
+    Thread::LockGuard write_lock(write_lock_);
 
-    {
-      Thread::LockGuard write_lock(write_lock_);
+    // The file can be scheduled either by a large enough flush_buffer_ or by the timer. In case it
+    // was the timer, flush_buffer_ can be empty.
+    if (flush_buffer_.length() == 0 && !reopen_file_) {
+      return;
+    }
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
+    flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+    about_to_write_buffer_.move(flush_buffer_);
+    ASSERT(flush_buffer_.length() == 0);
+  }
 
-      if (flush_thread_exit_) {
+  // if we failed to open file before, then simply ignore
+  if (file_->isOpen()) {
+    if (reopen_file_) {
+      reopen_file_ = false;
+      const Api::IoCallBoolResult result = file_->close();
+      ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                     result.err_->getErrorDetails()));
+      const Api::IoCallBoolResult open_result = open();
+      if (!open_result.rc_) {
+        stats_.reopen_failed_.inc();
         return;
       }
-
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-    }
-
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      if (reopen_file_) {
-        reopen_file_ = false;
-        const Api::IoCallBoolResult result = file_->close();
-        ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                       result.err_->getErrorDetails()));
-        const Api::IoCallBoolResult open_result = open();
-        if (!open_result.rc_) {
-          stats_.reopen_failed_.inc();
-          return;
-        }
-      }
-      doWrite(about_to_write_buffer_);
     }
+    doWrite(about_to_write_buffer_);
   }
 }
 
@@ -194,22 +245,15 @@ void AccessLogFileImpl::flush() {
 void AccessLogFileImpl::write(absl::string_view data) {
   Thread::LockGuard lock(write_lock_);
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
-  }
-
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
   flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
+  // The first write is flushed right away rather than waiting for the timer.
+  if (!written_ || flush_buffer_.length() > MIN_FLUSH_SIZE) {
+    written_ = true;
+    flush_thread_->schedule(*this);
   }
 }
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
-                                               Thread::Options{"AccessLogFlush"});
-}
-
 } // namespace AccessLog
 } // namespace Envoy
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <string>
 
 #include "envoy/access_log/access_log.h"
@@ -13,6 +15,7 @@
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
@@ -31,6 +34,47 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * A single thread that flushes all the access log files of an AccessLogManagerImpl, so that the
+ * number of threads doesn't grow with the number of files. Files are flushed in the order they were
+ * scheduled. The thread is started the first time a file is scheduled.
+ */
+class AccessLogFlushThread {
+public:
+  explicit AccessLogFlushThread(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+  ~AccessLogFlushThread();
+
+  /**
+   * Schedules a flush of file, unless one is already pending.
+   */
+  void schedule(AccessLogFileImpl& file);
+
+  /**
+   * Cancels any pending flush of file, and waits for a flush of it in progress to finish. Must be
+   * called before file is destroyed.
+   */
+  void remove(AccessLogFileImpl& file);
+
+private:
+  void threadRoutine();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar pending_event_;
+  Thread::CondVar flush_done_event_;
+  Thread::ThreadPtr thread_ ABSL_GUARDED_BY(lock_);
+  std::deque<AccessLogFileImpl*> pending_ ABSL_GUARDED_BY(lock_);
+  // The files in pending_, to avoid queueing a file twice.
+  absl::flat_hash_set<AccessLogFileImpl*> pending_files_ ABSL_GUARDED_BY(lock_);
+  AccessLogFileImpl* flushing_ ABSL_GUARDED_BY(lock_){};
+  bool exit_ ABSL_GUARDED_BY(lock_){};
+};
+
+using AccessLogFlushThreadSharedPtr = std::shared_ptr<AccessLogFlushThread>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
@@ -52,22 +96,23 @@ private:
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Shared by all files, and created with the first one. Files hold a reference to it, since they
+  // may outlive the manager.
+  AccessLogFlushThreadSharedPtr flush_thread_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * This implementation hands disk writes to an AccessLogFlushThread shared with the other files.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    AccessLogFlushThreadSharedPtr flush_thread);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -82,10 +127,12 @@ public:
   void flush() override;
 
 private:
+  friend class AccessLogFlushThread;
+
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  // Called by the flush thread when this file has been scheduled.
+  void flushFromFlushThread();
   Api::IoCallBoolResult open();
-  void createFlushStructures();
 
   // return default flags set which used by open
   static Filesystem::FlagSet defaultFlags();
@@ -99,6 +146,7 @@ private:
   //    1) write_lock_
   //    2) flush_lock_
   //    3) file_lock_
+  // The flush thread's lock may be acquired while holding any of them.
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -112,10 +160,9 @@ private:
       write_lock_; // The lock is used when filling the flush buffer. It allows
                    // multiple threads to write to the same file at relatively
                    // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  const AccessLogFlushThreadSharedPtr flush_thread_;
   std::atomic<bool> reopen_file_{};
+  bool written_ ABSL_GUARDED_BY(write_lock_){}; // Whether anything has been written to the file.
   Buffer::OwnedImpl
       flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
                                                   // gets filled and then flushed either when max
@@ -129,7 +176,6 @@ private:
                                             // continue to fill. This buffer is then used for the
                                             // final write to disk.
   Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
   const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
@@ -9,6 +9,8 @@
 #include "envoy/network/socket.h"
 #include "envoy/thread/thread.h"
 
+#include "common/event/slow_callback_log_impl.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -35,6 +37,7 @@ public:
   Stats::Scope& rootScope() override { return store_; }
   Random::RandomGenerator& randomGenerator() override { return random_generator_; }
   ProcessContextOptRef processContext() override { return process_context_; }
+  Event::SlowCallbackLog& slowCallbackLog() override { return slow_callback_log_; }
 
 private:
   Thread::ThreadFactory& thread_factory_;
@@ -44,6 +47,7 @@ private:
   Random::RandomGenerator& random_generator_;
   ProcessContextOptRef process_context_;
   const Buffer::WatermarkFactorySharedPtr watermark_factory_;
+  Event::SlowCallbackLogImpl slow_callback_log_;
 };
 
 } // namespace Api
@@ -18,14 +18,12 @@ namespace {
 constexpr uint64_t CopyThreshold = 512;
 } // namespace
 
-thread_local absl::InlinedVector<Slice::StoragePtr, Slice::free_list_max_> Slice::free_list_;
-
 void OwnedImpl::addImpl(const void* data, uint64_t size) {
   const char* src = static_cast<const char*>(data);
   bool new_slice_needed = slices_.empty();
   while (size != 0) {
     if (new_slice_needed) {
-      slices_.emplace_back(size);
+      slices_.emplace_back(Slice(size, account_));
     }
     uint64_t copy_size = slices_.back().append(src, size);
     src += copy_size;
@@ -40,6 +38,11 @@ void OwnedImpl::addDrainTracker(std::function<void()> drain_tracker) {
   slices_.back().addDrainTracker(std::move(drain_tracker));
 }
 
+void OwnedImpl::bindAccount(BufferMemoryAccountSharedPtr account) {
+  ASSERT(slices_.empty());
+  account_ = std::move(account);
+}
+
 void OwnedImpl::add(const void* data, uint64_t size) { addImpl(data, size); }
 
 void OwnedImpl::addBufferFragment(BufferFragment& fragment) {
@@ -61,7 +64,7 @@ void OwnedImpl::prepend(absl::string_view data) {
   bool new_slice_needed = slices_.empty();
   while (size != 0) {
     if (new_slice_needed) {
-      slices_.emplace_front(size);
+      slices_.emplace_front(Slice(size, account_));
     }
     uint64_t copy_size = slices_.front().prepend(data.data(), size);
     size -= copy_size;
@@ -77,6 +80,7 @@ void OwnedImpl::prepend(Instance& data) {
     uint64_t slice_size = other.slices_.back().dataSize();
     length_ += slice_size;
     slices_.emplace_front(std::move(other.slices_.back()));
+    slices_.front().maybeChargeAccount(account_);
     other.slices_.pop_back();
     other.length_ -= slice_size;
   }
@@ -222,7 +226,7 @@ void* OwnedImpl::linearize(uint32_t size) {
     return nullptr;
   }
   if (slices_[0].dataSize() < size) {
-    Slice new_slice{size};
+    Slice new_slice{size, account_};
     Slice::Reservation reservation = new_slice.reserve(size);
     ASSERT(reservation.mem_ != nullptr);
     ASSERT(reservation.len_ == size);
@@ -256,6 +260,7 @@ void OwnedImpl::coalesceOrAddSlice(Slice&& other_slice) {
   } else {
     // Take ownership of the slice.
     slices_.emplace_back(std::move(other_slice));
+    slices_.back().maybeChargeAccount(account_);
     length_ += slice_size;
   }
 }
@@ -300,8 +305,33 @@ void OwnedImpl::move(Instance& rhs, uint64_t length) {
   other.postProcess();
 }
 
+void OwnedImpl::retainDrained(Instance& rhs, uint64_t length) {
+  ASSERT(&rhs != this);
+  // See move() above for why we do the static cast.
+  OwnedImpl& other = static_cast<OwnedImpl&>(rhs);
+  while (length != 0 && !other.slices_.empty()) {
+    Slice slice = std::move(other.slices_.front());
+    other.slices_.pop_front();
+    const uint64_t slice_size = slice.dataSize();
+    other.length_ -= slice_size;
+    if (slice_size > length) {
+      // The drain trackers go with the rest of the data.
+      other.prepend(absl::string_view(reinterpret_cast<const char*>(slice.data()) + length,
+                                      slice_size - length));
+      slice.transferDrainTrackersTo(other.slices_.front());
+      length = 0;
+    } else {
+      slice.callAndClearDrainTrackers();
+      length -= slice_size;
+    }
+    length_ += slice_size;
+    slices_.emplace_back(std::move(slice));
+  }
+  other.postProcess();
+}
+
 Reservation OwnedImpl::reserveForRead() {
-  return reserveWithMaxLength(default_read_reservation_size_);
+  return reserveWithMaxLength(readReservationSize());
 }
 
 Reservation OwnedImpl::reserveWithMaxLength(uint64_t max_length) {
@@ -333,7 +363,7 @@ Reservation OwnedImpl::reserveWithMaxLength(uint64_t max_length) {
   }
 
   while (bytes_remaining != 0 && reservation_slices.size() < reservation.MAX_SLICES_) {
-    const uint64_t size = Slice::default_slice_size_;
+    const uint64_t size = readSliceSize();
 
     // If the next slice would go over the desired size, and the amount already reserved is already
     // at least one full slice in size, stop allocating slices. This prevents returning a
@@ -343,7 +373,7 @@ Reservation OwnedImpl::reserveWithMaxLength(uint64_t max_length) {
       break;
     }
 
-    Slice slice(size, slices_owner->free_list_);
+    Slice slice(size);
     const auto raw_slice = slice.reserve(size);
     reservation_slices.push_back(raw_slice);
     slices_owner->owned_slices_.emplace_back(std::move(slice));
@@ -352,6 +382,7 @@ Reservation OwnedImpl::reserveWithMaxLength(uint64_t max_length) {
   }
 
   ASSERT(reservation_slices.size() == slices_owner->owned_slices_.size());
+  slices_owner->read_reservation_length_ = reserved;
   reservation.bufferImplUseOnlySlicesOwner() = std::move(slices_owner);
   reservation.bufferImplUseOnlySetLength(reserved);
 
@@ -405,7 +436,9 @@ void OwnedImpl::commit(uint64_t length, absl::Span<RawSlice> slices,
   for (uint32_t i = 0; i < slices.size() && bytes_remaining > 0; i++) {
     Slice& owned_slice = owned_slices[i];
     if (owned_slice.data() != nullptr) {
+      // The slices of the reservation are only charged once committed.
       slices_.emplace_back(std::move(owned_slice));
+      slices_.back().maybeChargeAccount(account_);
     }
     slices[i].len_ = std::min<uint64_t>(slices[i].len_, bytes_remaining);
     bool success = slices_.back().commit(slices[i]);
@@ -413,6 +446,22 @@ void OwnedImpl::commit(uint64_t length, absl::Span<RawSlice> slices,
     length_ += slices[i].len_;
     bytes_remaining -= slices[i].len_;
   }
+
+  if (slices_owner->read_reservation_length_ != 0) {
+    updateReadSliceSize(length, slices_owner->read_reservation_length_);
+  }
+}
+
+void OwnedImpl::updateReadSliceSize(uint64_t length, uint64_t reserved) {
+  if (!SlicePool::hugePageSlabs()) {
+    return;
+  }
+  if (length == reserved && reserved >= default_read_reservation_size_) {
+    // The peer sends faster than the buffer is read, e.g. a bulk transfer.
+    large_read_slices_ = true;
+  } else if (length < SlicePool::SlabSliceSize) {
+    large_read_slices_ = false;
+  }
 }
 
 ssize_t OwnedImpl::search(const void* data, uint64_t size, size_t start, size_t length) const {
@@ -556,7 +605,7 @@ std::string OwnedImpl::toString() const {
 void OwnedImpl::postProcess() {}
 
 void OwnedImpl::appendSliceForTest(const void* data, uint64_t size) {
-  slices_.emplace_back(size);
+  slices_.emplace_back(Slice(size, account_));
   slices_.back().append(data, size);
   length_ += size;
 }
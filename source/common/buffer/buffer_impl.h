@@ -7,6 +7,7 @@
 
 #include "envoy/buffer/buffer.h"
 
+#include "common/buffer/slice_pool.h"
 #include "common/common/assert.h"
 #include "common/common/non_copyable.h"
 #include "common/common/utility.h"
@@ -33,16 +34,7 @@ namespace Buffer {
 class Slice {
 public:
   using Reservation = RawSlice;
-  using StoragePtr = std::unique_ptr<uint8_t[]>;
-
-  static constexpr uint32_t free_list_max_ = Buffer::Reservation::MAX_SLICES_;
-  using FreeListType = absl::InlinedVector<StoragePtr, free_list_max_>;
-  class FreeListReference {
-  private:
-    FreeListReference(FreeListType& free_list) : free_list_(free_list) {}
-    FreeListType& free_list_;
-    friend class Slice;
-  };
+  using StoragePtr = SlicePool::StoragePtr;
 
   /**
    * Create an empty Slice with 0 capacity.
@@ -52,11 +44,14 @@ public:
   /**
    * Create an empty mutable Slice that owns its storage.
    * @param min_capacity number of bytes of space the slice should have. Actual capacity is rounded
-   * up to the next multiple of 4kb.
+   * up to the next multiple of 4kb. The storage of the common sizes comes from the SlicePool.
+   * @param account the account to charge the storage to, if any.
    */
-  Slice(uint64_t min_capacity, absl::optional<FreeListReference> free_list = absl::nullopt)
-      : capacity_(sliceSize(min_capacity)), storage_(newStorage(capacity_, free_list)),
-        base_(storage_.get()), data_(0), reservable_(0) {}
+  Slice(uint64_t min_capacity, const BufferMemoryAccountSharedPtr& account = nullptr)
+      : capacity_(sliceSize(min_capacity)), storage_(newStorage(capacity_)),
+        base_(storage_.get()), data_(0), reservable_(0) {
+    maybeChargeAccount(account);
+  }
 
   /**
    * Create an immutable Slice that refers to an external buffer fragment.
@@ -72,6 +67,7 @@ public:
   Slice(Slice&& rhs) noexcept {
     storage_ = std::move(rhs.storage_);
     drain_trackers_ = std::move(rhs.drain_trackers_);
+    account_ = std::move(rhs.account_);
     base_ = rhs.base_;
     data_ = rhs.data_;
     reservable_ = rhs.reservable_;
@@ -87,9 +83,11 @@ public:
     if (this != &rhs) {
       callAndClearDrainTrackers();
 
+      creditAccount();
       freeStorage(std::move(storage_), capacity_);
       storage_ = std::move(rhs.storage_);
       drain_trackers_ = std::move(rhs.drain_trackers_);
+      account_ = std::move(rhs.account_);
       base_ = rhs.base_;
       data_ = rhs.data_;
       reservable_ = rhs.reservable_;
@@ -106,12 +104,21 @@ public:
 
   ~Slice() {
     callAndClearDrainTrackers();
+    creditAccount();
     freeStorage(std::move(storage_), capacity_);
   }
 
-  void freeStorage(FreeListReference free_list) {
-    callAndClearDrainTrackers();
-    freeStorage(std::move(storage_), capacity_, free_list);
+  /**
+   * Charges the storage of the slice to the account, unless the slice doesn't own its storage or
+   * is already charged to an account.
+   * @param account the account to charge, if any.
+   */
+  void maybeChargeAccount(const BufferMemoryAccountSharedPtr& account) {
+    if (account == nullptr || account_ != nullptr || storage_ == nullptr) {
+      return;
+    }
+    account->charge(capacity_);
+    account_ = account;
   }
 
   /**
@@ -306,8 +313,6 @@ public:
 
   static constexpr uint32_t default_slice_size_ = 16384;
 
-  static FreeListReference freeList() { return FreeListReference(free_list_); }
-
 protected:
   /**
    * Compute a slice size big enough to hold a specified amount of data.
@@ -320,49 +325,28 @@ protected:
     return num_pages * PageSize;
   }
 
-  static StoragePtr newStorage(uint64_t capacity, absl::optional<FreeListReference> free_list_opt) {
+  static StoragePtr newStorage(uint64_t capacity) {
     ASSERT(sliceSize(default_slice_size_) == default_slice_size_,
            "default_slice_size_ incompatible with sliceSize()");
     ASSERT(sliceSize(capacity) == capacity,
            "newStorage should only be called on values returned from sliceSize()");
-    ASSERT(!free_list_opt.has_value() || &free_list_opt->free_list_ == &free_list_);
-
-    StoragePtr storage;
-    if (capacity == default_slice_size_ && free_list_opt.has_value()) {
-      FreeListType& free_list = free_list_opt->free_list_;
-      if (!free_list.empty()) {
-        storage = std::move(free_list.back());
-        ASSERT(storage != nullptr);
-        ASSERT(free_list.back() == nullptr);
-        free_list.pop_back();
-        return storage;
-      }
-    }
+    return SlicePool::allocate(capacity);
+  }
 
-    storage.reset(new uint8_t[capacity]);
-    return storage;
+  void creditAccount() {
+    if (account_ != nullptr) {
+      account_->credit(capacity_);
+      account_.reset();
+    }
   }
 
-  static void freeStorage(StoragePtr storage, uint64_t capacity,
-                          absl::optional<FreeListReference> free_list_opt = absl::nullopt) {
+  static void freeStorage(StoragePtr storage, uint64_t capacity) {
     if (storage == nullptr) {
       return;
     }
-
-    if (capacity == default_slice_size_ && free_list_opt.has_value()) {
-      FreeListType& free_list = free_list_opt->free_list_;
-      if (free_list.size() < free_list_max_) {
-        free_list.emplace_back(std::move(storage));
-        ASSERT(storage == nullptr);
-        return;
-      }
-    }
-
-    storage.reset();
+    SlicePool::free(std::move(storage), capacity);
   }
 
-  static thread_local FreeListType free_list_;
-
   /** Length of the byte array that base_ points to. This is also the offset in bytes from the start
    * of the slice to the end of the Reservable section. */
   uint64_t capacity_;
@@ -383,6 +367,9 @@ protected:
 
   /** Hooks to execute when the slice is destroyed. */
   std::list<std::function<void()>> drain_trackers_;
+
+  /** The account the storage of the slice is charged to, if any. */
+  BufferMemoryAccountSharedPtr account_;
 };
 
 class OwnedImpl;
@@ -476,6 +463,7 @@ public:
     if (start_ == capacity_) {
       start_ = 0;
     }
+    releaseExternalRing();
   }
 
   void pop_back() { // NOLINT(readability-identifier-naming)
@@ -484,8 +472,14 @@ public:
     }
     back() = Slice();
     size_--;
+    releaseExternalRing();
   }
 
+  /**
+   * @return whether the slices are stored in the inline ring of the deque.
+   */
+  bool inlineRing() const { return external_ring_ == nullptr; }
+
   /**
    * Forward const iterator for SliceDeque.
    * @note this implementation currently supports the minimum functionality needed to support
@@ -528,6 +522,17 @@ private:
     return internal_index;
   }
 
+  // Once the deque is empty, goes back to the inline ring, so that the buffers of the idle
+  // connections don't keep the external ring grown by a burst. It is reallocated on the next one.
+  void releaseExternalRing() {
+    if (size_ == 0 && external_ring_ != nullptr) {
+      external_ring_.reset();
+      ring_ = inline_ring_;
+      start_ = 0;
+      capacity_ = InlineRingCapacity;
+    }
+  }
+
   void growRing() {
     if (size_ < capacity_) {
       return;
@@ -636,6 +641,7 @@ public:
 
   // Buffer::Instance
   void addDrainTracker(std::function<void()> drain_tracker) override;
+  void bindAccount(BufferMemoryAccountSharedPtr account) override;
   void add(const void* data, uint64_t size) override;
   void addBufferFragment(BufferFragment& fragment) override;
   void add(absl::string_view data) override;
@@ -660,6 +666,16 @@ public:
   // LibEventInstance
   void postProcess() override;
 
+  /**
+   * Drains the first bytes of another buffer like drain(), but moves the storage they are in to
+   * this buffer instead of freeing it, e.g. for the data of the sends the kernel keeps referencing
+   * after they return. The slices aren't coalesced: the storage of a slice partially drained is
+   * moved whole, and the rest of its data is copied back to the other buffer.
+   * @param rhs supplies the buffer to drain.
+   * @param length supplies the number of bytes to drain.
+   */
+  void retainDrained(Instance& rhs, uint64_t length);
+
   /**
    * Create a new slice at the end of the buffer, and copy the supplied content into it.
    * @param data start of the content to copy.
@@ -698,6 +714,19 @@ protected:
   static constexpr uint64_t default_read_reservation_size_ =
       Reservation::MAX_SLICES_ * Slice::default_slice_size_;
 
+  /**
+   * @return the size of the slices of the read reservations. With huge page slabs, the buffers
+   *         whose reads fill their reservations reserve slab slices, until a read fits in one.
+   */
+  uint64_t readSliceSize() const {
+    return large_read_slices_ ? SlicePool::SlabSliceSize : Slice::default_slice_size_;
+  }
+
+  /**
+   * @return the preferred length of the read reservations.
+   */
+  uint64_t readReservationSize() const { return Reservation::MAX_SLICES_ * readSliceSize(); }
+
   /**
    * Create a reservation with a maximum length.
    */
@@ -724,29 +753,35 @@ private:
    */
   void coalesceOrAddSlice(Slice&& other_slice);
 
+  /**
+   * Tunes the size of the slices of the next read reservations from a committed read.
+   * @param length the length of the read.
+   * @param reserved the length of its reservation.
+   */
+  void updateReadSliceSize(uint64_t length, uint64_t reserved);
+
   /** Ring buffer of slices. */
   SliceDeque slices_;
 
+  /** The account the slices of the buffer are charged to, if any. */
+  BufferMemoryAccountSharedPtr account_;
+
   /** Sum of the dataSize of all slices. */
   OverflowDetectingUInt64 length_;
 
+  /** Whether the read reservations use slab slices, see readSliceSize(). */
+  bool large_read_slices_{};
+
   struct OwnedImplReservationSlicesOwner : public ReservationSlicesOwner {
     virtual absl::Span<Slice> ownedSlices() PURE;
+
+    // The length of the reservation if it's a read reservation, or 0.
+    uint64_t read_reservation_length_{};
   };
 
   struct OwnedImplReservationSlicesOwnerMultiple : public OwnedImplReservationSlicesOwner {
-    // Optimization: get the thread_local freeList() once per Reservation, outside the loop.
-    OwnedImplReservationSlicesOwnerMultiple() : free_list_(Slice::freeList()) {}
-
-    ~OwnedImplReservationSlicesOwnerMultiple() override {
-      while (!owned_slices_.empty()) {
-        owned_slices_.back().freeStorage(free_list_);
-        owned_slices_.pop_back();
-      }
-    }
     absl::Span<Slice> ownedSlices() override { return absl::MakeSpan(owned_slices_); }
 
-    Slice::FreeListReference free_list_;
     absl::InlinedVector<Slice, Buffer::Reservation::MAX_SLICES_> owned_slices_;
   };
 
@@ -0,0 +1,282 @@
+#include "common/buffer/slice_pool.h"
+
+#include <atomic>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#include "common/common/assert.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * A huge page slab, which is freed once the thread carving it and all its slices released it.
+ */
+class SlicePool::Slab : NonCopyable {
+public:
+  static constexpr uint32_t NumSlices = SlabSize / SlabSliceSize;
+
+  Slab() : base_(static_cast<uint8_t*>(::operator new(SlabSize, std::align_val_t(SlabSize)))) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // Best effort: the slab is backed by regular pages if transparent huge pages are disabled.
+    ::madvise(base_, SlabSize, MADV_HUGEPAGE);
+#endif
+  }
+
+  ~Slab() { ::operator delete(base_, std::align_val_t(SlabSize)); }
+
+  uint8_t* slice(uint32_t index) { return base_ + index * SlabSliceSize; }
+  void ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void unref() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+private:
+  uint8_t* const base_;
+  // Held by the carving thread, and by each slice carved out of the slab.
+  std::atomic<uint32_t> refs_{1};
+};
+
+void SlicePool::StorageDeleter::operator()(uint8_t* storage) const {
+  if (slab_ == nullptr) {
+    delete[] storage;
+  } else {
+    slab_->unref();
+  }
+}
+
+namespace {
+
+// The number of pool operations of a thread reported to the stats at once, so that the workers
+// don't all update the shared stats for each slice.
+constexpr uint32_t StatsFlushInterval = 64;
+
+std::atomic<SlicePoolStats*> pool_stats{nullptr};
+std::atomic<bool> huge_page_slabs{false};
+
+int sizeClassIndex(uint64_t capacity) {
+  for (uint32_t i = 0; i < SlicePool::NumSizeClasses; ++i) {
+    if (SlicePool::SizeClasses[i].capacity_ == capacity) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+class ThreadPool {
+public:
+  ThreadPool() {
+    for (uint32_t i = 0; i < SlicePool::NumSizeClasses; ++i) {
+      free_lists_[i].reserve(SlicePool::SizeClasses[i].high_watermark_);
+    }
+  }
+
+  ~ThreadPool();
+
+  SlicePool::StoragePtr allocate(uint32_t index) {
+    auto& free_list = free_lists_[index];
+    const uint64_t capacity = SlicePool::SizeClasses[index].capacity_;
+    if (free_list.empty()) {
+      ++allocated_;
+      recordOperation();
+      if (capacity == SlicePool::SlabSliceSize &&
+          huge_page_slabs.load(std::memory_order_relaxed)) {
+        return carve();
+      }
+      return SlicePool::StoragePtr(new uint8_t[capacity]);
+    }
+    SlicePool::StoragePtr storage = std::move(free_list.back());
+    free_list.pop_back();
+    ++reused_;
+    cached_bytes_delta_ -= capacity;
+    recordOperation();
+    return storage;
+  }
+
+  void free(uint32_t index, SlicePool::StoragePtr storage) {
+    auto& free_list = free_lists_[index];
+    const SlicePool::SizeClass& size_class = SlicePool::SizeClasses[index];
+    if (free_list.size() <
+        (memory_pressure_ ? size_class.low_watermark_ : size_class.high_watermark_)) {
+      free_list.push_back(std::move(storage));
+      cached_bytes_delta_ += size_class.capacity_;
+    } else {
+      storage.reset();
+      ++released_;
+    }
+    recordOperation();
+  }
+
+  void setMemoryPressure(bool memory_pressure) {
+    memory_pressure_ = memory_pressure;
+    if (memory_pressure) {
+      for (uint32_t i = 0; i < SlicePool::NumSizeClasses; ++i) {
+        trim(i, SlicePool::SizeClasses[i].low_watermark_);
+      }
+    }
+    flushStats();
+  }
+
+  uint64_t cachedSlices() const {
+    uint64_t cached_slices = 0;
+    for (const auto& free_list : free_lists_) {
+      cached_slices += free_list.size();
+    }
+    return cached_slices;
+  }
+
+  void flushStats() {
+    pending_operations_ = 0;
+    SlicePoolStats* stats = pool_stats.load(std::memory_order_acquire);
+    if (stats == nullptr) {
+      // Kept until there are stats to report to, so that the gauge stays consistent.
+      return;
+    }
+    stats->slices_allocated_.add(allocated_);
+    stats->slices_released_.add(released_);
+    stats->slices_reused_.add(reused_);
+    stats->slabs_allocated_.add(slabs_allocated_);
+    if (cached_bytes_delta_ > 0) {
+      stats->cached_bytes_.add(cached_bytes_delta_);
+    } else if (cached_bytes_delta_ < 0) {
+      stats->cached_bytes_.sub(-cached_bytes_delta_);
+    }
+    allocated_ = 0;
+    released_ = 0;
+    reused_ = 0;
+    slabs_allocated_ = 0;
+    cached_bytes_delta_ = 0;
+  }
+
+private:
+  SlicePool::StoragePtr carve() {
+    if (slab_ == nullptr) {
+      slab_ = new SlicePool::Slab();
+      next_slab_slice_ = 0;
+      ++slabs_allocated_;
+    }
+    SlicePool::Slab* slab = slab_;
+    slab->ref();
+    SlicePool::StoragePtr storage(slab->slice(next_slab_slice_++), SlicePool::StorageDeleter{slab});
+    if (next_slab_slice_ == SlicePool::Slab::NumSlices) {
+      // The slab is freed with its last slice.
+      slab_->unref();
+      slab_ = nullptr;
+    }
+    return storage;
+  }
+
+  void trim(uint32_t index, uint32_t size) {
+    auto& free_list = free_lists_[index];
+    while (free_list.size() > size) {
+      free_list.pop_back();
+      cached_bytes_delta_ -= SlicePool::SizeClasses[index].capacity_;
+      ++released_;
+    }
+  }
+
+  void recordOperation() {
+    if (++pending_operations_ >= StatsFlushInterval) {
+      flushStats();
+    }
+  }
+
+  std::array<std::vector<SlicePool::StoragePtr>, SlicePool::NumSizeClasses> free_lists_;
+  bool memory_pressure_{};
+  uint32_t pending_operations_{};
+  uint64_t allocated_{};
+  uint64_t released_{};
+  uint64_t reused_{};
+  uint64_t slabs_allocated_{};
+  int64_t cached_bytes_delta_{};
+  // The slab the slices are carved out of, and the index of its next slice.
+  SlicePool::Slab* slab_{};
+  uint32_t next_slab_slice_{};
+};
+
+// Trivially destructible, so that the slices freed by the thread after its pool is destroyed, by
+// the destructors of the other thread locals or statics, can check it.
+thread_local bool thread_pool_destroyed = false;
+
+ThreadPool::~ThreadPool() {
+  thread_pool_destroyed = true;
+  for (uint32_t i = 0; i < SlicePool::NumSizeClasses; ++i) {
+    trim(i, 0);
+  }
+  if (slab_ != nullptr) {
+    slab_->unref();
+  }
+  flushStats();
+}
+
+ThreadPool* threadPool() {
+  if (thread_pool_destroyed) {
+    return nullptr;
+  }
+  static thread_local ThreadPool thread_pool;
+  return &thread_pool;
+}
+
+} // namespace
+
+SlicePool::StoragePtr SlicePool::allocate(uint64_t capacity) {
+  const int index = sizeClassIndex(capacity);
+  ThreadPool* thread_pool = index >= 0 ? threadPool() : nullptr;
+  if (thread_pool == nullptr) {
+    return StoragePtr(new uint8_t[capacity]);
+  }
+  return thread_pool->allocate(index);
+}
+
+void SlicePool::free(StoragePtr storage, uint64_t capacity) {
+  ASSERT(storage != nullptr);
+  const int index = sizeClassIndex(capacity);
+  ThreadPool* thread_pool = index >= 0 ? threadPool() : nullptr;
+  if (thread_pool == nullptr) {
+    return;
+  }
+  thread_pool->free(index, std::move(storage));
+}
+
+void SlicePool::setMemoryPressure(bool memory_pressure) {
+  if (ThreadPool* thread_pool = threadPool(); thread_pool != nullptr) {
+    thread_pool->setMemoryPressure(memory_pressure);
+  }
+}
+
+uint64_t SlicePool::cachedSlices() {
+  ThreadPool* thread_pool = threadPool();
+  return thread_pool != nullptr ? thread_pool->cachedSlices() : 0;
+}
+
+void SlicePool::setStats(SlicePoolStats* stats) {
+  pool_stats.store(stats, std::memory_order_release);
+}
+
+void SlicePool::setHugePageSlabs(bool enabled) {
+  huge_page_slabs.store(enabled, std::memory_order_relaxed);
+}
+
+bool SlicePool::hugePageSlabs() { return huge_page_slabs.load(std::memory_order_relaxed); }
+
+void SlicePool::flushStats() {
+  if (ThreadPool* thread_pool = threadPool(); thread_pool != nullptr) {
+    thread_pool->flushStats();
+  }
+}
+
+SlicePoolStats SlicePool::generateStats(Stats::Scope& scope) {
+  const std::string prefix = "buffer.slice_pool.";
+  return {ALL_SLICE_POOL_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                               POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+} // namespace Buffer
+} // namespace Envoy
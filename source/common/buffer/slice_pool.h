@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Buffer {
+
+/**
+ * All the stats of the slice pools. @see stats_macros.h
+ */
+#define ALL_SLICE_POOL_STATS(COUNTER, GAUGE)                                                       \
+  COUNTER(slices_allocated)                                                                        \
+  COUNTER(slices_released)                                                                         \
+  COUNTER(slices_reused)                                                                           \
+  COUNTER(slabs_allocated)                                                                         \
+  GAUGE(cached_bytes, NeverImport)
+
+/**
+ * Struct definition for the stats of the slice pools. @see stats_macros.h
+ */
+struct SlicePoolStats {
+  ALL_SLICE_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Per-thread free lists of the storage of the slices, for each of the common slice sizes. The
+ * storage of the slices of these sizes is taken from the free list of the thread allocating the
+ * slice, and given back to the free list of the thread freeing it, up to the high watermark of
+ * the size. The free lists only keep up to the low watermark of each size under memory pressure.
+ *
+ * With huge page slabs, the storage of the slices of SlabSliceSize is carved out of SlabSize slabs
+ * when their free list is empty, instead of being allocated on the heap. Each thread carves the
+ * slices out of its current slab, which is freed once all its slices are.
+ *
+ * All the methods apply to the pool of the calling thread, except setStats() and
+ * setHugePageSlabs().
+ */
+class SlicePool {
+public:
+  class Slab;
+
+  /**
+   * Frees the storage of a slice to the heap, or to the slab it was carved out of.
+   */
+  struct StorageDeleter {
+    void operator()(uint8_t* storage) const;
+
+    // The slab the storage was carved out of, or nullptr if it was allocated on the heap.
+    Slab* slab_{};
+  };
+
+  using StoragePtr = std::unique_ptr<uint8_t[], StorageDeleter>;
+
+  struct SizeClass {
+    uint64_t capacity_;
+    uint32_t high_watermark_;
+    uint32_t low_watermark_;
+  };
+  static constexpr uint32_t NumSizeClasses = 3;
+  static constexpr std::array<SizeClass, NumSizeClasses> SizeClasses{
+      {{4096, 64, 16}, {16384, 32, 8}, {65536, 8, 2}}};
+
+  // The size of the huge page slabs, and of the slices carved out of them.
+  static constexpr uint64_t SlabSize = 2 * 1024 * 1024;
+  static constexpr uint64_t SlabSliceSize = 65536;
+
+  /**
+   * @param capacity supplies the size of the storage, a multiple of the page size.
+   * @return storage of the given size, from the free list of the size if any.
+   */
+  static StoragePtr allocate(uint64_t capacity);
+
+  /**
+   * Frees storage allocated by allocate(), which is kept in the free list of its size if it isn't
+   * full.
+   * @param storage supplies the storage to free.
+   * @param capacity supplies the size the storage was allocated with.
+   */
+  static void free(StoragePtr storage, uint64_t capacity);
+
+  /**
+   * Under memory pressure, the free lists are trimmed down to their low watermark, so that the
+   * storage they release can be returned to the system.
+   * @param memory_pressure supplies whether the process is under memory pressure.
+   */
+  static void setMemoryPressure(bool memory_pressure);
+
+  /**
+   * @return the number of slices in the free lists of the calling thread.
+   */
+  static uint64_t cachedSlices();
+
+  /**
+   * Sets the stats all the threads report their pool activity to. The threads report it in
+   * batches, so the stats lag a bit behind.
+   * @param stats supplies the stats, or nullptr to stop reporting.
+   */
+  static void setStats(SlicePoolStats* stats);
+
+  /**
+   * Sets whether the slices of SlabSliceSize are carved out of huge page slabs. It's meant to be
+   * set once at startup; the storage allocated before keeps coming from the heap.
+   * @param enabled supplies whether to use huge page slabs.
+   */
+  static void setHugePageSlabs(bool enabled);
+
+  /**
+   * @return whether the slices of SlabSliceSize are carved out of huge page slabs.
+   */
+  static bool hugePageSlabs();
+
+  /**
+   * Reports the pending activity of the pool of the calling thread to the stats.
+   */
+  static void flushStats();
+
+  static SlicePoolStats generateStats(Stats::Scope& scope);
+};
+
+} // namespace Buffer
+} // namespace Envoy
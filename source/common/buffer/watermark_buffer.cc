@@ -1,5 +1,8 @@
 #include "common/buffer/watermark_buffer.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "common/common/assert.h"
 #include "common/runtime/runtime_features.h"
 
@@ -62,7 +65,7 @@ SliceDataPtr WatermarkBuffer::extractMutableFrontSlice() {
 // the high watermark to avoid overshooting by a lot and thus violating the limits
 // the watermark is imposing.
 Reservation WatermarkBuffer::reserveForRead() {
-  constexpr auto preferred_length = default_read_reservation_size_;
+  const uint64_t preferred_length = readReservationSize();
   uint64_t adjusted_length = preferred_length;
 
   if (high_watermark_ > 0 && preferred_length > 0) {
@@ -73,7 +76,7 @@ Reservation WatermarkBuffer::reserveForRead() {
       adjusted_length = Slice::default_slice_size_;
     } else {
       const uint64_t available_length = high_watermark_ - current_length;
-      adjusted_length = IntUtil::roundUpToMultiple(available_length, Slice::default_slice_size_);
+      adjusted_length = IntUtil::roundUpToMultiple(available_length, readSliceSize());
       adjusted_length = std::min(adjusted_length, preferred_length);
     }
   }
@@ -137,5 +140,130 @@ void WatermarkBuffer::checkHighAndOverflowWatermarks() {
   }
 }
 
+BufferMemoryAccountImpl::~BufferMemoryAccountImpl() {
+  // The slices charged to the account hold it, so they were all freed.
+  ASSERT(balance_ == 0);
+  clearDownstream();
+}
+
+void BufferMemoryAccountImpl::charge(uint64_t amount) {
+  balance_ += amount;
+  updateBucket();
+}
+
+void BufferMemoryAccountImpl::credit(uint64_t amount) {
+  ASSERT(balance_ >= amount);
+  balance_ -= amount;
+  updateBucket();
+}
+
+void BufferMemoryAccountImpl::clearDownstream() {
+  if (factory_ != nullptr) {
+    factory_->updateAccountBucket(*this, NoBucket);
+  }
+  factory_ = nullptr;
+  reset_handler_ = nullptr;
+}
+
+bool BufferMemoryAccountImpl::resetDownstream() {
+  Http::StreamResetHandler* reset_handler = reset_handler_;
+  clearDownstream();
+  if (reset_handler == nullptr) {
+    return false;
+  }
+  reset_handler->resetStream(Http::StreamResetReason::LocalReset);
+  return true;
+}
+
+void BufferMemoryAccountImpl::updateBucket() {
+  if (factory_ == nullptr) {
+    return;
+  }
+  uint32_t bucket = NoBucket;
+  if (balance_ >= (uint64_t(1) << WatermarkBufferFactory::MinTrackedBalancePowerOfTwo)) {
+    const uint32_t power_of_two = 63 - __builtin_clzll(balance_);
+    bucket = std::min(power_of_two - WatermarkBufferFactory::MinTrackedBalancePowerOfTwo,
+                      WatermarkBufferFactory::NumBuckets - 1);
+  }
+  if (bucket != bucket_) {
+    factory_->updateAccountBucket(*this, bucket);
+  }
+}
+
+void AggregatingMemoryAccount::charge(uint64_t amount) {
+  balance_ += amount;
+  gauge_.add(amount);
+  if (parent_ != nullptr) {
+    parent_->charge(amount);
+  }
+}
+
+void AggregatingMemoryAccount::credit(uint64_t amount) {
+  ASSERT(balance_ >= amount);
+  balance_ -= amount;
+  gauge_.sub(amount);
+  if (parent_ != nullptr) {
+    parent_->credit(amount);
+  }
+}
+
+void AggregatingMemoryAccount::clearDownstream() {
+  if (parent_ != nullptr) {
+    parent_->clearDownstream();
+  }
+}
+
+WatermarkBufferFactory::~WatermarkBufferFactory() {
+  // The accounts may outlive the factory, which they don't reach anymore.
+  for (auto& bucket : buckets_) {
+    for (BufferMemoryAccountImpl* account : bucket) {
+      account->factory_ = nullptr;
+      account->reset_handler_ = nullptr;
+      account->bucket_ = BufferMemoryAccountImpl::NoBucket;
+    }
+  }
+}
+
+BufferMemoryAccountSharedPtr
+WatermarkBufferFactory::createAccount(Http::StreamResetHandler& reset_handler) {
+  return std::make_shared<BufferMemoryAccountImpl>(*this, reset_handler);
+}
+
+uint64_t WatermarkBufferFactory::resetAccountsGivenPressure(float pressure) {
+  // The higher the pressure, the more buckets are reset, from the one of the largest accounts
+  // down. The accounts are held while resetting, as the resets free the memory charged to them.
+  const uint32_t buckets_to_reset =
+      static_cast<uint32_t>(std::clamp(pressure, 0.0f, 1.0f) * NumBuckets);
+  std::vector<std::shared_ptr<BufferMemoryAccountImpl>> accounts;
+  for (uint32_t i = 0; i < buckets_to_reset && accounts.size() < MaxResetsPerCall; ++i) {
+    for (BufferMemoryAccountImpl* account : buckets_[NumBuckets - 1 - i]) {
+      if (accounts.size() == MaxResetsPerCall) {
+        break;
+      }
+      accounts.push_back(account->shared_from_this());
+    }
+  }
+
+  uint64_t num_reset = 0;
+  for (const auto& account : accounts) {
+    // An earlier reset may have ended the stream already, e.g. by closing its connection.
+    if (account->resetDownstream()) {
+      ++num_reset;
+    }
+  }
+  return num_reset;
+}
+
+void WatermarkBufferFactory::updateAccountBucket(BufferMemoryAccountImpl& account,
+                                                 uint32_t bucket) {
+  if (account.bucket_ != BufferMemoryAccountImpl::NoBucket) {
+    buckets_[account.bucket_].erase(&account);
+  }
+  if (bucket != BufferMemoryAccountImpl::NoBucket) {
+    buckets_[bucket].insert(&account);
+  }
+  account.bucket_ = bucket;
+}
+
 } // namespace Buffer
 } // namespace Envoy
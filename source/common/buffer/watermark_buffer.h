@@ -1,10 +1,17 @@
 #pragma once
 
+#include <array>
 #include <functional>
+#include <memory>
 #include <string>
 
+#include "envoy/http/stream_reset_handler.h"
+#include "envoy/stats/stats.h"
+
 #include "common/buffer/buffer_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Buffer {
 
@@ -73,8 +80,71 @@ private:
 
 using WatermarkBufferPtr = std::unique_ptr<WatermarkBuffer>;
 
+class WatermarkBufferFactory;
+
+/**
+ * The account of the memory of the buffers of a downstream stream. Once it holds enough memory,
+ * the account is tracked by the factory that created it, in the bucket of the power of two of its
+ * balance, until the downstream is cleared.
+ */
+class BufferMemoryAccountImpl : public BufferMemoryAccount,
+                                public std::enable_shared_from_this<BufferMemoryAccountImpl> {
+public:
+  BufferMemoryAccountImpl(WatermarkBufferFactory& factory, Http::StreamResetHandler& reset_handler)
+      : factory_(&factory), reset_handler_(&reset_handler) {}
+  ~BufferMemoryAccountImpl() override;
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  uint64_t balance() const override { return balance_; }
+  void clearDownstream() override;
+
+  /**
+   * Clears the downstream, and resets its stream.
+   * @return whether there was a downstream to reset.
+   */
+  bool resetDownstream();
+
+private:
+  friend class WatermarkBufferFactory;
+
+  void updateBucket();
+
+  // Cleared with the downstream.
+  WatermarkBufferFactory* factory_;
+  Http::StreamResetHandler* reset_handler_;
+  uint64_t balance_{};
+  // The bucket of the account in the factory, or NoBucket while it isn't tracked.
+  static constexpr uint32_t NoBucket = UINT32_MAX;
+  uint32_t bucket_{NoBucket};
+};
+
+/**
+ * Forwards the charges of the account to a parent account, if any, and keeps their aggregate in a
+ * gauge, e.g. the bytes buffered by all the streams of a listener or of a cluster.
+ */
+class AggregatingMemoryAccount : public BufferMemoryAccount {
+public:
+  AggregatingMemoryAccount(BufferMemoryAccountSharedPtr parent, Stats::Gauge& gauge)
+      : parent_(std::move(parent)), gauge_(gauge) {}
+
+  // Buffer::BufferMemoryAccount
+  void charge(uint64_t amount) override;
+  void credit(uint64_t amount) override;
+  uint64_t balance() const override { return balance_; }
+  void clearDownstream() override;
+
+private:
+  const BufferMemoryAccountSharedPtr parent_;
+  Stats::Gauge& gauge_;
+  uint64_t balance_{};
+};
+
 class WatermarkBufferFactory : public WatermarkFactory {
 public:
+  ~WatermarkBufferFactory() override;
+
   // Buffer::WatermarkFactory
   InstancePtr create(std::function<void()> below_low_watermark,
                      std::function<void()> above_high_watermark,
@@ -82,6 +152,28 @@ public:
     return std::make_unique<WatermarkBuffer>(below_low_watermark, above_high_watermark,
                                              above_overflow_watermark);
   }
+  BufferMemoryAccountSharedPtr createAccount(Http::StreamResetHandler& reset_handler) override;
+  uint64_t resetAccountsGivenPressure(float pressure) override;
+
+  // The accounts holding at least 2^MinTrackedBalancePowerOfTwo bytes are tracked, in NumBuckets
+  // buckets of the power of two of their balance. The last bucket holds all the larger ones.
+  static constexpr uint32_t MinTrackedBalancePowerOfTwo = 20;
+  static constexpr uint32_t NumBuckets = 8;
+  // The maximum number of streams reset at once, so that a reset doesn't stall the worker.
+  static constexpr uint32_t MaxResetsPerCall = 50;
+
+  /**
+   * @return the number of accounts tracked in the bucket.
+   */
+  uint64_t trackedAccounts(uint32_t bucket) const { return buckets_[bucket].size(); }
+
+private:
+  friend class BufferMemoryAccountImpl;
+
+  // Moves the account from its bucket to the new bucket, either of which may be NoBucket.
+  void updateAccountBucket(BufferMemoryAccountImpl& account, uint32_t bucket);
+
+  std::array<absl::flat_hash_set<BufferMemoryAccountImpl*>, NumBuckets> buckets_;
 };
 
 } // namespace Buffer
@@ -0,0 +1,49 @@
+#include "common/common/arena_impl.h"
+
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+void* ArenaImpl::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  ASSERT(alignment <= alignof(std::max_align_t));
+  bytes_allocated_ += size;
+
+  // Blocks come from operator new[], which aligns them for any fundamental type.
+  if (size > block_size_ / 4) {
+    blocks_.emplace_back(new char[size]);
+    return blocks_.back().get();
+  }
+
+  const uintptr_t aligned =
+      (reinterpret_cast<uintptr_t>(next_) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+  if (next_ == nullptr || aligned + size > reinterpret_cast<uintptr_t>(end_)) {
+    blocks_.emplace_back(new char[block_size_]);
+    next_ = blocks_.back().get() + size;
+    end_ = blocks_.back().get() + block_size_;
+    return blocks_.back().get();
+  }
+  next_ = reinterpret_cast<char*>(aligned + size);
+  return reinterpret_cast<char*>(aligned);
+}
+
+void* ArenaAllocatable::allocate(size_t size, Arena* arena) {
+  const size_t total = sizeof(Header) + size;
+  void* memory = arena != nullptr ? arena->allocate(total, alignof(Header)) : ::operator new(total);
+  Header* header = new (memory) Header{arena == nullptr};
+  return header + 1;
+}
+
+void ArenaAllocatable::operator delete(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header* header = static_cast<Header*>(ptr) - 1;
+  if (header->heap_) {
+    ::operator delete(header);
+  }
+}
+
+} // namespace Envoy
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/arena.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Bump allocator that carves allocations out of fixed size blocks. Allocations larger than a
+ * quarter of the block size get a block of their own so that they don't waste the remainder of
+ * the current one.
+ */
+class ArenaImpl : public Arena, NonCopyable {
+public:
+  static constexpr size_t DefaultBlockSize = 4096;
+
+  explicit ArenaImpl(size_t block_size = DefaultBlockSize) : block_size_(block_size) {}
+
+  // Arena
+  void* allocate(size_t size, size_t alignment) override;
+
+  /**
+   * @return the number of blocks allocated from the heap so far.
+   */
+  size_t blockCount() const { return blocks_.size(); }
+
+  /**
+   * @return the number of bytes handed out so far, excluding alignment padding.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+private:
+  const size_t block_size_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // Free space in the current block.
+  char* next_{};
+  char* end_{};
+  uint64_t bytes_allocated_{};
+};
+
+/**
+ * Mixin for classes that are owned by std::unique_ptr but may be placed in an Arena with
+ * `new (arena) T(...)`. The class specific operator delete only releases heap allocations, so the
+ * owner doesn't need to know where the object came from. Objects placed in an arena must be
+ * destroyed before the arena.
+ */
+class ArenaAllocatable {
+public:
+  static void* operator new(size_t size) { return allocate(size, nullptr); }
+  static void* operator new(size_t size, Arena& arena) { return allocate(size, &arena); }
+  static void operator delete(void* ptr);
+  // Only used if a constructor throws.
+  static void operator delete(void* ptr, Arena&) { operator delete(ptr); }
+
+private:
+  // Precedes each allocation to record where it came from.
+  struct alignas(std::max_align_t) Header {
+    bool heap_;
+  };
+
+  static void* allocate(size_t size, Arena* arena);
+};
+
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "common/common/matchers.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/type/matcher/v3/metadata.pb.h"
 #include "envoy/type/matcher/v3/number.pb.h"
@@ -11,6 +13,7 @@
 #include "common/config/metadata.h"
 #include "common/http/path_utility.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
 
 namespace Envoy {
@@ -119,6 +122,88 @@ bool StringMatcherImpl::match(const absl::string_view value) const {
   }
 }
 
+StringMatcherSetImpl::StringMatcherSetImpl(
+    const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& matchers) {
+  for (const auto& matcher : matchers) {
+    Patterns& patterns = matcher.ignore_case() ? lowercase_patterns_ : patterns_;
+    auto normalize = [&matcher](const std::string& pattern) {
+      return matcher.ignore_case() ? absl::AsciiStrToLower(pattern) : pattern;
+    };
+    switch (matcher.match_pattern_case()) {
+    case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kExact:
+      patterns.exact_.insert(normalize(matcher.exact()));
+      break;
+    case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kPrefix:
+      patterns.prefixes_.add(normalize(matcher.prefix()));
+      break;
+    case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kSuffix:
+      patterns.suffixes_.add(normalize(matcher.suffix()));
+      break;
+    case envoy::type::matcher::v3::StringMatcher::MatchPatternCase::kContains:
+      patterns.contains_.push_back(normalize(matcher.contains()));
+      break;
+    default:
+      // Validates the regexes, and ignore_case for them.
+      regexes_.emplace_back(matcher);
+      break;
+    }
+  }
+}
+
+bool StringMatcherSetImpl::match(const absl::string_view value) const {
+  if (patterns_.match(value)) {
+    return true;
+  }
+  if (!lowercase_patterns_.empty() && lowercase_patterns_.match(absl::AsciiStrToLower(value))) {
+    return true;
+  }
+  return std::any_of(regexes_.begin(), regexes_.end(),
+                     [value](const StringMatcherImpl& regex) { return regex.match(value); });
+}
+
+void StringMatcherSetImpl::AffixSet::add(const std::string& pattern) {
+  patterns_.insert(pattern);
+  const auto length = std::lower_bound(lengths_.begin(), lengths_.end(), pattern.size());
+  if (length == lengths_.end() || *length != pattern.size()) {
+    lengths_.insert(length, pattern.size());
+  }
+}
+
+bool StringMatcherSetImpl::AffixSet::matchPrefix(absl::string_view value) const {
+  for (const size_t length : lengths_) {
+    if (length > value.size()) {
+      return false;
+    }
+    if (patterns_.contains(value.substr(0, length))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StringMatcherSetImpl::AffixSet::matchSuffix(absl::string_view value) const {
+  for (const size_t length : lengths_) {
+    if (length > value.size()) {
+      return false;
+    }
+    if (patterns_.contains(value.substr(value.size() - length))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool StringMatcherSetImpl::Patterns::match(absl::string_view value) const {
+  return exact_.contains(value) || prefixes_.matchPrefix(value) || suffixes_.matchSuffix(value) ||
+         std::any_of(contains_.begin(), contains_.end(), [value](const std::string& contains) {
+           return absl::StrContains(value, contains);
+         });
+}
+
+bool StringMatcherSetImpl::Patterns::empty() const {
+  return exact_.empty() && prefixes_.empty() && suffixes_.empty() && contains_.empty();
+}
+
 ListMatcher::ListMatcher(const envoy::type::matcher::v3::ListMatcher& matcher) : matcher_(matcher) {
   ASSERT(matcher_.match_pattern_case() ==
          envoy::type::matcher::v3::ListMatcher::MatchPatternCase::kOneOf);
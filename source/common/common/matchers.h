@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "envoy/common/matchers.h"
 #include "envoy/common/regex.h"
@@ -14,6 +15,8 @@
 #include "common/common/utility.h"
 #include "common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Matchers {
 
@@ -91,6 +94,51 @@ private:
   std::string lowercase_contains_match_;
 };
 
+/**
+ * Matches a value if any of a list of string matchers does. The exact matchers are looked up in a
+ * hash set, and the prefix and suffix matchers by the distinct lengths of their patterns, rather
+ * than evaluating each matcher of the list. The value is lowercased once for all the case
+ * insensitive matchers. The other matchers are evaluated one by one.
+ */
+class StringMatcherSetImpl : public StringMatcher {
+public:
+  explicit StringMatcherSetImpl(
+      const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& matchers);
+
+  bool match(const absl::string_view value) const override;
+
+private:
+  // Patterns looked up by the affix of the value of each of their distinct lengths.
+  class AffixSet {
+  public:
+    void add(const std::string& pattern);
+    bool matchPrefix(absl::string_view value) const;
+    bool matchSuffix(absl::string_view value) const;
+    bool empty() const { return patterns_.empty(); }
+
+  private:
+    absl::flat_hash_set<std::string> patterns_;
+    // In ascending order.
+    std::vector<size_t> lengths_;
+  };
+
+  // A matcher set for the case sensitive matchers, and one for the lowercased patterns of the
+  // case insensitive matchers.
+  struct Patterns {
+    bool match(absl::string_view value) const;
+    bool empty() const;
+
+    absl::flat_hash_set<std::string> exact_;
+    AffixSet prefixes_;
+    AffixSet suffixes_;
+    std::vector<std::string> contains_;
+  };
+
+  Patterns patterns_;
+  Patterns lowercase_patterns_;
+  std::vector<StringMatcherImpl> regexes_;
+};
+
 class ListMatcher : public ValueMatcher {
 public:
   ListMatcher(const envoy::type::matcher::v3::ListMatcher& matcher);
@@ -4,6 +4,8 @@
 #include "absl/strings/str_cat.h"
 
 #if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
 #include <sys/syscall.h>
 #endif
 
@@ -24,6 +26,33 @@ int64_t getCurrentThreadId() {
 #endif
 }
 
+#if defined(__linux__)
+// Pins the threads created with the attributes to the CPU of the given index, modulo their number,
+// among the CPUs the calling thread may run on.
+void setCpuAffinity(pthread_attr_t& attr, uint32_t cpu_index) {
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed) != 0 ||
+      CPU_COUNT(&allowed) == 0) {
+    return;
+  }
+  uint32_t remaining = cpu_index % CPU_COUNT(&allowed);
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &allowed) || remaining-- != 0) {
+      continue;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    const int rc = pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus);
+    if (rc != 0) {
+      ENVOY_LOG_MISC(warn, "Error {} setting the affinity of a thread to CPU {}", rc, cpu);
+    }
+    return;
+  }
+}
+#endif
+
 } // namespace
 
 // See https://www.man7.org/linux/man-pages/man3/pthread_setname_np.3.html.
@@ -43,13 +72,23 @@ public:
       name_ = options->name_.substr(0, PTHREAD_MAX_THREADNAME_LEN_INCLUDING_NULL_BYTE - 1);
     }
     RELEASE_ASSERT(Logger::Registry::initialized(), "");
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+#if defined(__linux__)
+    // The thread is pinned from its start, so that the memory it first touches is allocated on the
+    // NUMA node of its CPU.
+    if (options && options->cpu_index_.has_value()) {
+      setCpuAffinity(attr, options->cpu_index_.value());
+    }
+#endif
     const int rc = pthread_create(
-        &thread_handle_, nullptr,
+        &thread_handle_, &attr,
         [](void* arg) -> void* {
           static_cast<ThreadImplPosix*>(arg)->thread_routine_();
           return nullptr;
         },
         this);
+    pthread_attr_destroy(&attr);
     RELEASE_ASSERT(rc == 0, "");
 
 #if SUPPORTS_PTHREAD_NAMING
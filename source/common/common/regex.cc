@@ -1,15 +1,24 @@
 #include "common/common/regex.h"
 
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "envoy/common/exception.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 #include "common/protobuf/utility.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Regex {
@@ -41,15 +50,56 @@ private:
   const std::regex regex_;
 };
 
+// The compiled RE2 programs by pattern, so that the identical regexes of the configs share their
+// program instead of each compiling its own copy. Only weak references are held: a program lives
+// as long as a matcher uses it.
+class Re2ProgramCache {
+public:
+  static Re2ProgramCache& get() { MUTABLE_CONSTRUCT_ON_FIRST_USE(Re2ProgramCache); }
+
+  std::shared_ptr<const re2::RE2> program(const std::string& pattern) {
+    absl::MutexLock lock(&mutex_);
+    auto it = programs_.find(pattern);
+    if (it != programs_.end()) {
+      std::shared_ptr<const re2::RE2> program = it->second.lock();
+      if (program != nullptr) {
+        return program;
+      }
+    }
+    // The expired programs are swept once the programs doubled since the last sweep, so that
+    // sweeping stays linear in the number of compilations.
+    if (programs_.size() >= sweep_size_) {
+      for (auto program_it = programs_.begin(); program_it != programs_.end();) {
+        if (program_it->second.expired()) {
+          programs_.erase(program_it++);
+        } else {
+          ++program_it;
+        }
+      }
+      sweep_size_ = std::max<size_t>(MinSweepSize, programs_.size() * 2);
+    }
+    auto program = std::make_shared<const re2::RE2>(pattern, re2::RE2::Quiet);
+    programs_[pattern] = program;
+    return program;
+  }
+
+private:
+  static constexpr size_t MinSweepSize = 64;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::weak_ptr<const re2::RE2>> programs_ ABSL_GUARDED_BY(mutex_);
+  size_t sweep_size_ ABSL_GUARDED_BY(mutex_){MinSweepSize};
+};
+
 class CompiledGoogleReMatcher : public CompiledMatcher {
 public:
   CompiledGoogleReMatcher(const envoy::type::matcher::v3::RegexMatcher& config)
-      : regex_(config.regex(), re2::RE2::Quiet) {
-    if (!regex_.ok()) {
-      throw EnvoyException(regex_.error());
+      : regex_(Re2ProgramCache::get().program(config.regex())) {
+    if (!regex_->ok()) {
+      throw EnvoyException(regex_->error());
     }
 
-    const uint32_t regex_program_size = static_cast<uint32_t>(regex_.ProgramSize());
+    const uint32_t regex_program_size = static_cast<uint32_t>(regex_->ProgramSize());
 
     // Check if the deprecated field max_program_size is set first, and follow the old logic if so.
     if (config.google_re2().has_max_program_size()) {
@@ -104,19 +154,49 @@ public:
 
   // CompiledMatcher
   bool match(absl::string_view value) const override {
-    return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), regex_);
+    return re2::RE2::FullMatch(re2::StringPiece(value.data(), value.size()), *regex_);
   }
 
   // CompiledMatcher
   std::string replaceAll(absl::string_view value, absl::string_view substitution) const override {
     std::string result = std::string(value);
-    re2::RE2::GlobalReplace(&result, regex_,
+    re2::RE2::GlobalReplace(&result, *regex_,
                             re2::StringPiece(substitution.data(), substitution.size()));
     return result;
   }
 
 private:
-  const re2::RE2 regex_;
+  const std::shared_ptr<const re2::RE2> regex_;
+};
+
+class CompiledGoogleReSetMatcher : public CompiledSetMatcher {
+public:
+  CompiledGoogleReSetMatcher(const std::vector<std::string>& regexes)
+      : set_(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH) {
+    for (const std::string& regex : regexes) {
+      std::string error;
+      if (set_.Add(regex, &error) < 0) {
+        throw EnvoyException(fmt::format("Invalid regex '{}': {}", regex, error));
+      }
+    }
+    if (!set_.Compile()) {
+      throw EnvoyException("unable to compile the regex set");
+    }
+  }
+
+  // CompiledSetMatcher
+  bool match(absl::string_view value, std::vector<int>& matches) const override {
+    re2::RE2::Set::ErrorInfo error_info;
+    if (!set_.Match(re2::StringPiece(value.data(), value.size()), &matches, &error_info)) {
+      matches.clear();
+      return error_info.kind == re2::RE2::Set::kNoError;
+    }
+    std::sort(matches.begin(), matches.end());
+    return true;
+  }
+
+private:
+  re2::RE2::Set set_;
 };
 
 } // namespace
@@ -127,6 +207,10 @@ CompiledMatcherPtr Utility::parseRegex(const envoy::type::matcher::v3::RegexMatc
   return std::make_unique<CompiledGoogleReMatcher>(matcher);
 }
 
+CompiledSetMatcherPtr Utility::parseRegexSet(const std::vector<std::string>& regexes) {
+  return std::make_unique<CompiledGoogleReSetMatcher>(regexes);
+}
+
 CompiledMatcherPtr Utility::parseStdRegexAsCompiledMatcher(const std::string& regex,
                                                            std::regex::flag_type flags) {
   return std::make_unique<CompiledStdMatcher>(parseStdRegex(regex, flags));
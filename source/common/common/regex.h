@@ -2,15 +2,41 @@
 
 #include <memory>
 #include <regex>
+#include <string>
+#include <vector>
 
+#include "envoy/common/pure.h"
 #include "envoy/common/regex.h"
 #include "envoy/type/matcher/v3/regex.pb.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Regex {
 
 enum class Type { Re2, StdRegex };
 
+/**
+ * A set of RE2 regexes matched at once, which finds all the regexes fully matching a value in a
+ * single pass over it.
+ */
+class CompiledSetMatcher {
+public:
+  virtual ~CompiledSetMatcher() = default;
+
+  /**
+   * Finds the regexes of the set matching a value.
+   * @param value supplies the value to match.
+   * @param matches supplies the vector to fill with the positions of the matching regexes in the
+   *        set, in ascending order.
+   * @return false if the matching failed, e.g. because the set ran out of memory, in which case
+   *         the caller must match the regexes one by one.
+   */
+  virtual bool match(absl::string_view value, std::vector<int>& matches) const PURE;
+};
+
+using CompiledSetMatcherPtr = std::unique_ptr<const CompiledSetMatcher>;
+
 /**
  * Utilities for constructing regular expressions.
  */
@@ -40,6 +66,14 @@ public:
    * Construct a compiled regex matcher from a match config.
    */
   static CompiledMatcherPtr parseRegex(const envoy::type::matcher::v3::RegexMatcher& matcher);
+
+  /**
+   * Construct a set matcher from RE2 regexes. The regexes are expected to be validated already,
+   * e.g. by parseRegex().
+   * @param regexes supplies the regexes of the set.
+   * @throw EnvoyException if a regex is invalid or the set can not be compiled.
+   */
+  static CompiledSetMatcherPtr parseRegexSet(const std::vector<std::string>& regexes);
 };
 
 } // namespace Regex
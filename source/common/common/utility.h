@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <ios>
@@ -658,10 +659,10 @@ template <class Value> struct TrieLookupTable {
    * @param key the key used to find.
    * @return the value matching the longest prefix based on the key.
    */
-  Value findLongestPrefix(const char* key) const {
+  Value findLongestPrefix(absl::string_view key) const {
     const TrieEntry<Value>* current = &root_;
     const TrieEntry<Value>* result = nullptr;
-    while (uint8_t c = *key) {
+    for (uint8_t c : key) {
       if (current->value_) {
         result = current;
       }
@@ -671,15 +672,150 @@ template <class Value> struct TrieLookupTable {
       if (current == nullptr) {
         return result ? result->value_ : nullptr;
       }
-
-      key++;
     }
-    return current ? current->value_ : result->value_;
+    if (current->value_) {
+      return current->value_;
+    }
+    return result ? result->value_ : nullptr;
   }
 
   TrieEntry<Value> root_;
 };
 
+/**
+ * A lookup table for a set of keys that is fixed before the first lookup. build() computes a
+ * minimal perfect hash of the keys (hash and displace), so that a lookup costs at most two hashes
+ * of the key and one key comparison, however many keys there are.
+ */
+template <class Value> class PerfectHashLookupTable {
+public:
+  /**
+   * Adds an entry to the table. May only be called before build().
+   * @param key the key used to add the entry.
+   * @param value the value to be associated with the key.
+   * @return false when a value already exists for the given key.
+   */
+  bool add(absl::string_view key, Value value) {
+    ASSERT(!built_);
+    for (const auto& entry : entries_) {
+      if (entry.first == key) {
+        return false;
+      }
+    }
+    entries_.emplace_back(std::string(key), std::move(value));
+    return true;
+  }
+
+  /**
+   * Computes the hash of the keys added so far. No entries can be added afterwards.
+   */
+  void build() {
+    ASSERT(!built_);
+    built_ = true;
+    const size_t size = entries_.size();
+    displacements_.assign(size, 0);
+
+    // Group the keys into buckets by their first hash, and place the keys of the largest buckets
+    // first, while most of the slots are free.
+    std::vector<std::vector<size_t>> buckets(size);
+    for (size_t i = 0; i < size; ++i) {
+      buckets[slot(entries_[i].first, 0)].push_back(i);
+    }
+    std::vector<size_t> order(size);
+    for (size_t i = 0; i < size; ++i) {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t lhs, size_t rhs) {
+      return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<bool> used(size);
+    std::vector<size_t> entry_slots(size);
+    std::vector<size_t> bucket_slots;
+    for (const size_t bucket : order) {
+      if (buckets[bucket].size() <= 1) {
+        break;
+      }
+      // Find a seed that hashes all the keys of the bucket to distinct free slots.
+      for (int64_t seed = 1;; ++seed) {
+        bucket_slots.clear();
+        for (const size_t i : buckets[bucket]) {
+          const size_t candidate = slot(entries_[i].first, seed);
+          if (used[candidate] ||
+              std::find(bucket_slots.begin(), bucket_slots.end(), candidate) !=
+                  bucket_slots.end()) {
+            break;
+          }
+          bucket_slots.push_back(candidate);
+        }
+        if (bucket_slots.size() == buckets[bucket].size()) {
+          for (size_t j = 0; j < bucket_slots.size(); ++j) {
+            used[bucket_slots[j]] = true;
+            entry_slots[buckets[bucket][j]] = bucket_slots[j];
+          }
+          displacements_[bucket] = seed;
+          break;
+        }
+      }
+    }
+    // Keys alone in their bucket don't need a hash: their displacement is the free slot they take.
+    size_t free_slot = 0;
+    for (const size_t bucket : order) {
+      if (buckets[bucket].size() != 1) {
+        continue;
+      }
+      while (used[free_slot]) {
+        ++free_slot;
+      }
+      used[free_slot] = true;
+      entry_slots[buckets[bucket][0]] = free_slot;
+      displacements_[bucket] = -static_cast<int64_t>(free_slot) - 1;
+    }
+
+    std::vector<std::pair<std::string, Value>> entries(size);
+    for (size_t i = 0; i < size; ++i) {
+      entries[entry_slots[i]] = std::move(entries_[i]);
+    }
+    entries_ = std::move(entries);
+  }
+
+  /**
+   * Finds the entry associated with the key. May only be called after build().
+   * @param key the key used to find.
+   * @return the value associated with the key, or nullptr if there is none.
+   */
+  const Value* find(absl::string_view key) const {
+    ASSERT(built_);
+    if (entries_.empty()) {
+      return nullptr;
+    }
+    const int64_t displacement = displacements_[slot(key, 0)];
+    if (displacement == 0) {
+      return nullptr;
+    }
+    const auto& entry =
+        entries_[displacement < 0 ? -displacement - 1 : slot(key, displacement)];
+    return entry.first == key ? &entry.second : nullptr;
+  }
+
+  /**
+   * @return the number of entries in the table.
+   */
+  size_t size() const { return entries_.size(); }
+
+private:
+  size_t slot(absl::string_view key, int64_t seed) const {
+    return HashUtil::xxHash64(key, seed) % entries_.size();
+  }
+
+  // Entries in slot order once built.
+  std::vector<std::pair<std::string, Value>> entries_;
+  // For each bucket: 0 if it is empty, the seed of the second hash if it holds several keys, or
+  // the negated slot (minus one) of its only key.
+  std::vector<int64_t> displacements_;
+  bool built_{};
+};
+
 /**
  * A global utility class to take care of all the exception throwing behaviors in header files.
  * Its functions simply forward the throwing into .cc file.
@@ -3,6 +3,7 @@
 #include "envoy/config/subscription.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
+#include "common/common/hash.h"
 #include "common/protobuf/utility.h"
 
 #include "xds/core/v3/collection_entry.pb.h"
@@ -19,11 +20,30 @@ repeatedPtrFieldToVector(const Protobuf::RepeatedPtrField<std::string>& xs) {
   return ys;
 }
 
+// The hash of a resource is the one of its wire encoding, which is much cheaper than
+// MessageUtil::hash() of the decoded message.
+uint64_t anyHash(const ProtobufWkt::Any& resource) {
+  return HashUtil::xxHash64(resource.value(), HashUtil::xxHash64(resource.type_url()));
+}
+
 } // namespace
 
 class DecodedResourceImpl;
 using DecodedResourceImplPtr = std::unique_ptr<DecodedResourceImpl>;
 
+/**
+ * A resource of a discovery response parsed off the main thread. @see
+ * OpaqueResourceDecoder::parseResource().
+ */
+struct ParsedResource {
+  // The Resource wrapper of the resource, if any.
+  std::unique_ptr<envoy::service::discovery::v3::Resource> wrapper_;
+  // The parsed message, or nullptr if the resource must be decoded on the main thread.
+  ProtobufTypes::MessagePtr message_;
+  // The constraint violation of the message, if any.
+  std::string error_;
+};
+
 class DecodedResourceImpl : public DecodedResource {
 public:
   static DecodedResourceImplPtr fromResource(OpaqueResourceDecoder& resource_decoder,
@@ -43,6 +63,90 @@ public:
         version, absl::nullopt));
   }
 
+  /**
+   * Parse a resource without the checks that need the main thread. This may be called on any
+   * thread. @see fromParsedResource().
+   */
+  static ParsedResource parseResource(OpaqueResourceDecoder& resource_decoder,
+                                      const ProtobufWkt::Any& resource) {
+    ParsedResource parsed;
+    if (resource.Is<envoy::service::discovery::v3::Resource>()) {
+      parsed.wrapper_ = std::make_unique<envoy::service::discovery::v3::Resource>();
+      if (!resource.UnpackTo(parsed.wrapper_.get())) {
+        parsed.wrapper_.reset();
+        return parsed;
+      }
+      parsed.message_ = resource_decoder.parseResource(parsed.wrapper_->resource(), parsed.error_);
+      return parsed;
+    }
+    parsed.message_ = resource_decoder.parseResource(resource, parsed.error_);
+    return parsed;
+  }
+
+  /**
+   * Finish decoding a resource returned by parseResource() on the main thread. The result is the
+   * same as the one of fromResource().
+   */
+  static DecodedResourceImplPtr fromParsedResource(OpaqueResourceDecoder& resource_decoder,
+                                                   const ProtobufWkt::Any& resource,
+                                                   ParsedResource&& parsed,
+                                                   const std::string& version) {
+    if (parsed.message_ == nullptr) {
+      return fromResource(resource_decoder, resource, version);
+    }
+
+    if (parsed.wrapper_ != nullptr) {
+      const envoy::service::discovery::v3::Resource& r = *parsed.wrapper_;
+      resource_decoder.checkResource(r.resource(), *parsed.message_, parsed.error_);
+      return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
+          std::move(parsed.message_), r.has_resource(), r.name(),
+          repeatedPtrFieldToVector(r.aliases()), version,
+          r.has_ttl() ? absl::make_optional(std::chrono::milliseconds(
+                            DurationUtil::durationToMilliseconds(r.ttl())))
+                      : absl::nullopt,
+          anyHash(r.resource())));
+    }
+
+    resource_decoder.checkResource(resource, *parsed.message_, parsed.error_);
+    const std::string name = resource_decoder.resourceName(*parsed.message_);
+    return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
+        std::move(parsed.message_), true, name, {}, version, absl::nullopt, anyHash(resource)));
+  }
+
+  /**
+   * Decode a resource that was already accepted by this build, e.g. one loaded from an xDS
+   * snapshot, without the checks for unknown and deprecated fields of fromParsedResource().
+   */
+  static DecodedResourceImplPtr fromTrustedResource(OpaqueResourceDecoder& resource_decoder,
+                                                    const ProtobufWkt::Any& resource,
+                                                    const std::string& version) {
+    ParsedResource parsed = parseResource(resource_decoder, resource);
+    if (parsed.message_ == nullptr) {
+      return fromResource(resource_decoder, resource, version);
+    }
+    if (!parsed.error_.empty()) {
+      // The resource is only trusted as long as it is valid.
+      resource_decoder.checkResource(parsed.wrapper_ != nullptr ? parsed.wrapper_->resource()
+                                                                : resource,
+                                     *parsed.message_, parsed.error_);
+    }
+
+    if (parsed.wrapper_ != nullptr) {
+      const envoy::service::discovery::v3::Resource& r = *parsed.wrapper_;
+      return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
+          std::move(parsed.message_), r.has_resource(), r.name(),
+          repeatedPtrFieldToVector(r.aliases()), version,
+          r.has_ttl() ? absl::make_optional(std::chrono::milliseconds(
+                            DurationUtil::durationToMilliseconds(r.ttl())))
+                      : absl::nullopt,
+          anyHash(r.resource())));
+    }
+
+    const std::string name = resource_decoder.resourceName(*parsed.message_);
+    return std::unique_ptr<DecodedResourceImpl>(new DecodedResourceImpl(
+        std::move(parsed.message_), true, name, {}, version, absl::nullopt, anyHash(resource)));
+  }
+
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder,
                       const envoy::service::discovery::v3::Resource& resource)
       : DecodedResourceImpl(resource_decoder, resource.name(), resource.aliases(),
@@ -59,7 +163,7 @@ public:
   DecodedResourceImpl(ProtobufTypes::MessagePtr resource, const std::string& name,
                       const std::vector<std::string>& aliases, const std::string& version)
       : resource_(std::move(resource)), has_resource_(true), name_(name), aliases_(aliases),
-        version_(version), ttl_(absl::nullopt) {}
+        version_(version), ttl_(absl::nullopt), hash_(MessageUtil::hash(*resource_)) {}
 
   // Config::DecodedResource
   const std::string& name() const override { return name_; }
@@ -68,6 +172,7 @@ public:
   const Protobuf::Message& resource() const override { return *resource_; };
   bool hasResource() const override { return has_resource_; }
   absl::optional<std::chrono::milliseconds> ttl() const override { return ttl_; }
+  uint64_t hash() const override { return hash_; }
 
 private:
   DecodedResourceImpl(OpaqueResourceDecoder& resource_decoder, absl::optional<std::string> name,
@@ -76,7 +181,14 @@ private:
                       const std::string& version, absl::optional<std::chrono::milliseconds> ttl)
       : resource_(resource_decoder.decodeResource(resource)), has_resource_(has_resource),
         name_(name ? *name : resource_decoder.resourceName(*resource_)),
-        aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl) {}
+        aliases_(repeatedPtrFieldToVector(aliases)), version_(version), ttl_(ttl),
+        hash_(anyHash(resource)) {}
+  DecodedResourceImpl(ProtobufTypes::MessagePtr resource, bool has_resource,
+                      const std::string& name, std::vector<std::string> aliases,
+                      const std::string& version, absl::optional<std::chrono::milliseconds> ttl,
+                      uint64_t hash)
+      : resource_(std::move(resource)), has_resource_(has_resource), name_(name),
+        aliases_(std::move(aliases)), version_(version), ttl_(ttl), hash_(hash) {}
 
   const ProtobufTypes::MessagePtr resource_;
   const bool has_resource_;
@@ -85,6 +197,7 @@ private:
   const std::string version_;
   // Per resource TTL.
   const absl::optional<std::chrono::milliseconds> ttl_;
+  const uint64_t hash_;
 };
 
 struct DecodedResourcesWrapper {
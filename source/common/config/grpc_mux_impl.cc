@@ -1,5 +1,7 @@
 #include "common/config/grpc_mux_impl.h"
 
+#include <thread>
+
 #include "envoy/service/discovery/v3/discovery.pb.h"
 
 #include "common/config/decoded_resource_impl.h"
@@ -16,6 +18,7 @@ namespace Config {
 
 GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
                          Grpc::RawAsyncClientPtr async_client, Event::Dispatcher& dispatcher,
+                         Thread::ThreadFactory& thread_factory,
                          const Protobuf::MethodDescriptor& service_method,
                          envoy::config::core::v3::ApiVersion transport_api_version,
                          Random::RandomGenerator& random, Stats::Scope& scope,
@@ -25,6 +28,7 @@ GrpcMuxImpl::GrpcMuxImpl(const LocalInfo::LocalInfo& local_info,
       local_info_(local_info), skip_subsequent_node_(skip_subsequent_node),
       first_stream_request_(true), transport_api_version_(transport_api_version),
       dispatcher_(dispatcher),
+      resource_parser_(thread_factory, std::thread::hardware_concurrency()),
       enable_type_url_downgrade_and_upgrade_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.enable_type_url_downgrade_and_upgrade")),
       dynamic_update_callback_handle_(local_info.contextProvider().addDynamicContextUpdateCallback(
@@ -45,6 +49,37 @@ void GrpcMuxImpl::onDynamicContextUpdate(absl::string_view resource_type_url) {
 
 void GrpcMuxImpl::start() { grpc_stream_.establishNewStream(); }
 
+void GrpcMuxImpl::setSnapshot(XdsSnapshotPtr&& snapshot) {
+  ASSERT(subscriptions_.empty());
+  snapshot_ = std::move(snapshot);
+  snapshot_timer_ = dispatcher_.createTimer([this]() -> void { applySnapshot(); });
+}
+
+void GrpcMuxImpl::applySnapshot() {
+  std::vector<std::string> type_urls;
+  type_urls.swap(snapshot_type_urls_);
+  for (const std::string& type_url : type_urls) {
+    auto response = snapshot_->takeResponse(type_url);
+    ApiState& api_state = apiStateFor(type_url);
+    // The management server may have answered first.
+    if (response == nullptr || api_state.watches_.empty() ||
+        !api_state.request_.response_nonce().empty()) {
+      continue;
+    }
+
+    // The version of the request isn't updated, so that the management server sends the current
+    // state of the resources rather than acknowledging the ones of the snapshot.
+    ENVOY_LOG(info, "Applying the xDS snapshot for {} at version {}", type_url,
+              response->version_info());
+    ScopedResume same_type_resume = pause(type_url);
+    TRY_ASSERT_MAIN_THREAD { deliverResponse(type_url, *response, snapshot_->trusted()); }
+    END_TRY
+    catch (const EnvoyException& e) {
+      ENVOY_LOG(warn, "Ignoring the xDS snapshot for {}: {}", type_url, e.what());
+    }
+  }
+}
+
 void GrpcMuxImpl::sendDiscoveryRequest(const std::string& type_url) {
   ApiState& api_state = apiStateFor(type_url);
   auto& request = api_state.request_;
@@ -100,6 +135,11 @@ GrpcMuxWatchPtr GrpcMuxImpl::addWatch(const std::string& type_url,
     if (enable_type_url_downgrade_and_upgrade_) {
       registerVersionedTypeUrl(type_url);
     }
+    if (snapshot_ != nullptr) {
+      // The snapshot is applied once the subscription that added the watch is started.
+      snapshot_type_urls_.push_back(type_url);
+      snapshot_timer_->enableTimer(std::chrono::milliseconds(0));
+    }
   }
 
   // This will send an updated request on each subscription.
@@ -200,69 +240,13 @@ void GrpcMuxImpl::onDiscoveryResponse(
   // see https://github.com/envoyproxy/envoy/issues/11477.
   same_type_resume = pause(type_url);
   TRY_ASSERT_MAIN_THREAD {
-    // To avoid O(n^2) explosion (e.g. when we have 1000s of EDS watches), we
-    // build a map here from resource name to resource and then walk watches_.
-    // We have to walk all watches (and need an efficient map as a result) to
-    // ensure we deliver empty config updates when a resource is dropped. We make the map ordered
-    // for test determinism.
-    std::vector<DecodedResourceImplPtr> resources;
-    absl::btree_map<std::string, DecodedResourceRef> resource_ref_map;
-    std::vector<DecodedResourceRef> all_resource_refs;
-    OpaqueResourceDecoder& resource_decoder =
-        apiStateFor(type_url).watches_.front()->resource_decoder_;
-
-    const auto scoped_ttl_update = apiStateFor(type_url).ttl_.scopedTtlUpdate();
-
-    for (const auto& resource : message->resources()) {
-      // TODO(snowp): Check the underlying type when the resource is a Resource.
-      if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
-          message->type_url() != resource.type_url()) {
-        throw EnvoyException(
-            fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
-                        resource.type_url(), message->type_url(), message->DebugString()));
-      }
-
-      auto decoded_resource =
-          DecodedResourceImpl::fromResource(resource_decoder, resource, message->version_info());
-
-      if (decoded_resource->ttl()) {
-        apiStateFor(type_url).ttl_.add(*decoded_resource->ttl(), decoded_resource->name());
-      } else {
-        apiStateFor(type_url).ttl_.clear(decoded_resource->name());
-      }
-
-      if (!isHeartbeatResource(type_url, *decoded_resource)) {
-        resources.emplace_back(std::move(decoded_resource));
-        all_resource_refs.emplace_back(*resources.back());
-        resource_ref_map.emplace(resources.back()->name(), *resources.back());
-      }
-    }
-
-    for (auto watch : apiStateFor(type_url).watches_) {
-      // onConfigUpdate should be called in all cases for single watch xDS (Cluster and
-      // Listener) even if the message does not have resources so that update_empty stat
-      // is properly incremented and state-of-the-world semantics are maintained.
-      if (watch->resources_.empty()) {
-        watch->callbacks_.onConfigUpdate(all_resource_refs, message->version_info());
-        continue;
-      }
-      std::vector<DecodedResourceRef> found_resources;
-      for (const auto& watched_resource_name : watch->resources_) {
-        auto it = resource_ref_map.find(watched_resource_name);
-        if (it != resource_ref_map.end()) {
-          found_resources.emplace_back(it->second);
-        }
-      }
-
-      // onConfigUpdate should be called only on watches(clusters/routes) that have
-      // updates in the message for EDS/RDS.
-      if (!found_resources.empty()) {
-        watch->callbacks_.onConfigUpdate(found_resources, message->version_info());
-      }
-    }
+    deliverResponse(type_url, *message, false);
     // TODO(mattklein123): In the future if we start tracking per-resource versions, we
     // would do that tracking here.
     apiStateFor(type_url).request_.set_version_info(message->version_info());
+    if (snapshot_ != nullptr) {
+      snapshot_->recordResponse(type_url, *message);
+    }
     Memory::Utils::tryShrinkHeap();
   }
   END_TRY
@@ -280,6 +264,88 @@ void GrpcMuxImpl::onDiscoveryResponse(
   queueDiscoveryRequest(type_url);
 }
 
+void GrpcMuxImpl::deliverResponse(const std::string& type_url,
+                                  const envoy::service::discovery::v3::DiscoveryResponse& message,
+                                  bool trusted) {
+  // To avoid O(n^2) explosion (e.g. when we have 1000s of EDS watches), we
+  // build a map here from resource name to resource and then walk watches_.
+  // We have to walk all watches (and need an efficient map as a result) to
+  // ensure we deliver empty config updates when a resource is dropped. We make the map ordered
+  // for test determinism.
+  std::vector<DecodedResourceImplPtr> resources;
+  absl::btree_map<std::string, DecodedResourceRef> resource_ref_map;
+  std::vector<DecodedResourceRef> all_resource_refs;
+  OpaqueResourceDecoder& resource_decoder =
+      apiStateFor(type_url).watches_.front()->resource_decoder_;
+
+  const auto scoped_ttl_update = apiStateFor(type_url).ttl_.scopedTtlUpdate();
+
+  // Large responses are parsed in parallel first, and applied below in order. The resources of a
+  // trusted snapshot skip most of the checks, so they aren't worth the threads.
+  std::vector<ParsedResource> parsed_resources;
+  if (!trusted) {
+    parsed_resources = resource_parser_.parse(resource_decoder, message.resources());
+  }
+
+  for (int i = 0; i < message.resources().size(); i++) {
+    const auto& resource = message.resources(i);
+    // TODO(snowp): Check the underlying type when the resource is a Resource.
+    if (!resource.Is<envoy::service::discovery::v3::Resource>() &&
+        message.type_url() != resource.type_url()) {
+      throw EnvoyException(
+          fmt::format("{} does not match the message-wide type URL {} in DiscoveryResponse {}",
+                      resource.type_url(), message.type_url(), message.DebugString()));
+    }
+
+    DecodedResourceImplPtr decoded_resource;
+    if (trusted) {
+      decoded_resource = DecodedResourceImpl::fromTrustedResource(resource_decoder, resource,
+                                                                  message.version_info());
+    } else if (parsed_resources.empty()) {
+      decoded_resource =
+          DecodedResourceImpl::fromResource(resource_decoder, resource, message.version_info());
+    } else {
+      decoded_resource = DecodedResourceImpl::fromParsedResource(
+          resource_decoder, resource, std::move(parsed_resources[i]), message.version_info());
+    }
+
+    if (decoded_resource->ttl()) {
+      apiStateFor(type_url).ttl_.add(*decoded_resource->ttl(), decoded_resource->name());
+    } else {
+      apiStateFor(type_url).ttl_.clear(decoded_resource->name());
+    }
+
+    if (!isHeartbeatResource(type_url, *decoded_resource)) {
+      resources.emplace_back(std::move(decoded_resource));
+      all_resource_refs.emplace_back(*resources.back());
+      resource_ref_map.emplace(resources.back()->name(), *resources.back());
+    }
+  }
+
+  for (auto watch : apiStateFor(type_url).watches_) {
+    // onConfigUpdate should be called in all cases for single watch xDS (Cluster and
+    // Listener) even if the message does not have resources so that update_empty stat
+    // is properly incremented and state-of-the-world semantics are maintained.
+    if (watch->resources_.empty()) {
+      watch->callbacks_.onConfigUpdate(all_resource_refs, message.version_info());
+      continue;
+    }
+    std::vector<DecodedResourceRef> found_resources;
+    for (const auto& watched_resource_name : watch->resources_) {
+      auto it = resource_ref_map.find(watched_resource_name);
+      if (it != resource_ref_map.end()) {
+        found_resources.emplace_back(it->second);
+      }
+    }
+
+    // onConfigUpdate should be called only on watches(clusters/routes) that have
+    // updates in the message for EDS/RDS.
+    if (!found_resources.empty()) {
+      watch->callbacks_.onConfigUpdate(found_resources, message.version_info());
+    }
+  }
+}
+
 void GrpcMuxImpl::onWriteable() { drainRequests(); }
 
 void GrpcMuxImpl::onStreamEstablished() {
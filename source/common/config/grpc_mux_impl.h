@@ -12,6 +12,7 @@
 #include "envoy/event/dispatcher.h"
 #include "envoy/grpc/status.h"
 #include "envoy/service/discovery/v3/discovery.pb.h"
+#include "envoy/thread/thread.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/cleanup.h"
@@ -19,8 +20,10 @@
 #include "common/common/utility.h"
 #include "common/config/api_version.h"
 #include "common/config/grpc_stream.h"
+#include "common/config/parallel_resource_parser.h"
 #include "common/config/ttl.h"
 #include "common/config/utility.h"
+#include "common/config/xds_snapshot.h"
 #include "common/runtime/runtime_features.h"
 
 #include "absl/container/node_hash_map.h"
@@ -35,13 +38,20 @@ class GrpcMuxImpl : public GrpcMux,
                     public Logger::Loggable<Logger::Id::config> {
 public:
   GrpcMuxImpl(const LocalInfo::LocalInfo& local_info, Grpc::RawAsyncClientPtr async_client,
-              Event::Dispatcher& dispatcher, const Protobuf::MethodDescriptor& service_method,
+              Event::Dispatcher& dispatcher, Thread::ThreadFactory& thread_factory,
+              const Protobuf::MethodDescriptor& service_method,
               envoy::config::core::v3::ApiVersion transport_api_version,
               Random::RandomGenerator& random, Stats::Scope& scope,
               const RateLimitSettings& rate_limit_settings, bool skip_subsequent_node);
 
   void start() override;
 
+  /**
+   * Sets the snapshot the watched resource types are first loaded from, and the accepted
+   * responses are saved to. Must be called before the first watch is added.
+   */
+  void setSnapshot(XdsSnapshotPtr&& snapshot);
+
   // GrpcMux
   ScopedResume pause(const std::string& type_url) override;
   ScopedResume pause(const std::vector<std::string> type_urls) override;
@@ -78,6 +88,13 @@ private:
   void drainRequests();
   void setRetryTimer();
   void sendDiscoveryRequest(const std::string& type_url);
+  // Decodes the resources of a response and passes them to the watches of the type URL.
+  // @throw EnvoyException if the response is rejected.
+  void deliverResponse(const std::string& type_url,
+                       const envoy::service::discovery::v3::DiscoveryResponse& message,
+                       bool trusted);
+  // Applies the snapshot responses of the type URLs that were watched since the last call.
+  void applySnapshot();
 
   struct GrpcMuxWatchImpl : public GrpcMuxWatch {
     GrpcMuxWatchImpl(const absl::flat_hash_set<std::string>& resources,
@@ -177,8 +194,13 @@ private:
   const envoy::config::core::v3::ApiVersion transport_api_version_;
 
   Event::Dispatcher& dispatcher_;
+  ParallelResourceParser resource_parser_;
   bool enable_type_url_downgrade_and_upgrade_;
   Common::CallbackHandlePtr dynamic_update_callback_handle_;
+  XdsSnapshotPtr snapshot_;
+  Event::TimerPtr snapshot_timer_;
+  // The type URLs whose snapshot response wasn't applied yet.
+  std::vector<std::string> snapshot_type_urls_;
 };
 
 using GrpcMuxImplPtr = std::unique_ptr<GrpcMuxImpl>;
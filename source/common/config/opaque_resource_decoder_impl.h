@@ -24,6 +24,38 @@ public:
     return typed_message;
   }
 
+  ProtobufTypes::MessagePtr parseResource(const ProtobufWkt::Any& resource,
+                                          std::string& error) override {
+    auto typed_message = std::make_unique<Current>();
+    if (resource.type_url().empty()) {
+      return typed_message;
+    }
+    // Earlier API versions are upgraded by MessageUtil::anyConvert(), which needs the main thread.
+    if (TypeUtil::typeUrlToDescriptorFullName(resource.type_url()) !=
+            typed_message->GetDescriptor()->full_name() ||
+        !resource.UnpackTo(typed_message.get())) {
+      return nullptr;
+    }
+    Validate(*typed_message, &error);
+    return typed_message;
+  }
+
+  void checkResource(const ProtobufWkt::Any& resource, const Protobuf::Message& message,
+                     const std::string& error) override {
+    if (resource.type_url().empty()) {
+      return;
+    }
+    const auto& typed_message = dynamic_cast<const Current&>(message);
+    // As in MessageUtil::validate(), unexpected fields are reported before constraint violations.
+    if (!validation_visitor_.skipValidation()) {
+      MessageUtil::checkForUnexpectedFields(typed_message, validation_visitor_);
+    }
+    if (!error.empty()) {
+      ProtoExceptionUtil::throwProtoValidationException(error,
+                                                        API_RECOVER_ORIGINAL(typed_message));
+    }
+  }
+
   std::string resourceName(const Protobuf::Message& resource) override {
     return MessageUtil::getStringField(resource, name_field_);
   }
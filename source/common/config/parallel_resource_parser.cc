@@ -0,0 +1,45 @@
+#include "common/config/parallel_resource_parser.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Config {
+
+ParallelResourceParser::ParallelResourceParser(Thread::ThreadFactory& thread_factory,
+                                               uint32_t max_threads)
+    : thread_factory_(thread_factory), max_threads_(std::max(1U, max_threads)) {}
+
+std::vector<ParsedResource>
+ParallelResourceParser::parse(OpaqueResourceDecoder& resource_decoder,
+                              const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources) {
+  const uint32_t size = resources.size();
+  const uint32_t thread_count = std::min(max_threads_, size / MinResourcesPerThread);
+  if (thread_count < 2) {
+    return {};
+  }
+
+  std::vector<ParsedResource> parsed(size);
+  auto parse_range = [&resource_decoder, &resources, &parsed](uint32_t begin, uint32_t end) {
+    for (uint32_t i = begin; i < end; i++) {
+      parsed[i] = DecodedResourceImpl::parseResource(resource_decoder, resources[i]);
+    }
+  };
+
+  // The calling thread parses the first range while the other threads parse the others.
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(thread_count - 1);
+  for (uint32_t t = 1; t < thread_count; t++) {
+    const uint32_t begin = static_cast<uint64_t>(size) * t / thread_count;
+    const uint32_t end = static_cast<uint64_t>(size) * (t + 1) / thread_count;
+    threads.push_back(thread_factory_.createThread(
+        [&parse_range, begin, end]() { parse_range(begin, end); }, Thread::Options{"xds-parse"}));
+  }
+  parse_range(0, size / thread_count);
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  return parsed;
+}
+
+} // namespace Config
+} // namespace Envoy
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/config/subscription.h"
+#include "envoy/thread/thread.h"
+
+#include "common/config/decoded_resource_impl.h"
+#include "common/protobuf/protobuf.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * Parses the resources of large discovery responses on several threads, so that the ingestion of
+ * configurations with many resources scales with the cores. Only the work that doesn't need the
+ * main thread is done in parallel: the resources are still finished with
+ * DecodedResourceImpl::fromParsedResource() on the main thread, in order.
+ */
+class ParallelResourceParser {
+public:
+  /**
+   * @param thread_factory supplies the factory of the parsing threads.
+   * @param max_threads supplies the maximum number of threads parsing a response, including the
+   *        calling thread.
+   */
+  ParallelResourceParser(Thread::ThreadFactory& thread_factory, uint32_t max_threads);
+
+  /**
+   * @param resource_decoder supplies the decoder of the resources.
+   * @param resources supplies the resources of a discovery response.
+   * @return std::vector<ParsedResource> the parsed resources, in the order of the resources, or an
+   *         empty vector if there are too few resources for parsing them in parallel to pay off.
+   */
+  std::vector<ParsedResource> parse(OpaqueResourceDecoder& resource_decoder,
+                                    const Protobuf::RepeatedPtrField<ProtobufWkt::Any>& resources);
+
+  // The fewest resources parsed by a thread.
+  static constexpr uint32_t MinResourcesPerThread = 256;
+
+private:
+  Thread::ThreadFactory& thread_factory_;
+  const uint32_t max_threads_;
+};
+
+} // namespace Config
+} // namespace Envoy
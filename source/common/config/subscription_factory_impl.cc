@@ -63,8 +63,9 @@ SubscriptionPtr SubscriptionFactoryImpl::subscriptionFromConfigSource(
               Utility::factoryForGrpcApiConfigSource(cm_.grpcAsyncClientManager(),
                                                      api_config_source, scope, true)
                   ->create(),
-              dispatcher_, sotwGrpcMethod(type_url, transport_api_version), transport_api_version,
-              api_.randomGenerator(), scope, Utility::parseRateLimitSettings(api_config_source),
+              dispatcher_, api_.threadFactory(), sotwGrpcMethod(type_url, transport_api_version),
+              transport_api_version, api_.randomGenerator(), scope,
+              Utility::parseRateLimitSettings(api_config_source),
               api_config_source.set_node_on_first_message_only()),
           callbacks, resource_decoder, stats, type_url, dispatcher_,
           Utility::configSourceInitialFetchTimeout(config),
@@ -0,0 +1,185 @@
+#include "common/config/xds_snapshot.h"
+
+#include <cstdio>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/hash.h"
+#include "common/common/thread.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+constexpr absl::string_view Magic = "XDSSNAP1";
+
+// Consumes a big-endian length and the bytes that follow it from the input.
+bool consumeLengthPrefixed(absl::string_view& input, absl::string_view& value) {
+  if (input.size() < sizeof(uint32_t)) {
+    return false;
+  }
+  uint32_t length = 0;
+  for (size_t i = 0; i < sizeof(uint32_t); i++) {
+    length = (length << 8) | static_cast<uint8_t>(input[i]);
+  }
+  input.remove_prefix(sizeof(uint32_t));
+  if (input.size() < length) {
+    return false;
+  }
+  value = input.substr(0, length);
+  input.remove_prefix(length);
+  return true;
+}
+
+void addLengthPrefixed(Buffer::Instance& output, absl::string_view value) {
+  output.writeBEInt<uint32_t>(value.size());
+  output.add(value);
+}
+
+} // namespace
+
+XdsSnapshot::XdsSnapshot(const std::string& path, const std::string& build_version,
+                         Event::Dispatcher& dispatcher, Filesystem::Instance& file_system)
+    : path_(path), build_version_(build_version), file_system_(file_system),
+      write_timer_(dispatcher.createTimer([this]() -> void { write(); })) {
+  load();
+}
+
+std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+XdsSnapshot::takeResponse(const std::string& type_url) {
+  auto it = loaded_responses_.find(type_url);
+  if (it == loaded_responses_.end()) {
+    return nullptr;
+  }
+  auto response = std::move(it->second);
+  loaded_responses_.erase(it);
+  return response;
+}
+
+void XdsSnapshot::recordResponse(const std::string& type_url,
+                                 const envoy::service::discovery::v3::DiscoveryResponse& response) {
+  // The nonce and the control plane are specific to the stream that sent the response.
+  envoy::service::discovery::v3::DiscoveryResponse recorded;
+  recorded.set_version_info(response.version_info());
+  *recorded.mutable_resources() = response.resources();
+  recorded.set_type_url(type_url);
+  serialized_responses_[type_url] = recorded.SerializeAsString();
+  if (!write_timer_->enabled()) {
+    write_timer_->enableTimer(WriteDelay);
+  }
+}
+
+std::string
+XdsSnapshot::serialize(const std::string& build_version,
+                       const absl::btree_map<std::string, std::string>& serialized_responses) {
+  Buffer::OwnedImpl body;
+  addLengthPrefixed(body, build_version);
+  for (const auto& serialized_response : serialized_responses) {
+    addLengthPrefixed(body, serialized_response.second);
+  }
+  const std::string body_string = body.toString();
+
+  Buffer::OwnedImpl content;
+  content.add(Magic);
+  content.writeBEInt<uint64_t>(HashUtil::xxHash64(body_string));
+  content.add(body_string);
+  return content.toString();
+}
+
+bool XdsSnapshot::parse(absl::string_view content, std::string& build_version,
+                        absl::btree_map<std::string, std::string>& serialized_responses) {
+  if (content.size() < Magic.size() + sizeof(uint64_t) || !absl::StartsWith(content, Magic)) {
+    return false;
+  }
+  content.remove_prefix(Magic.size());
+  uint64_t hash = 0;
+  for (size_t i = 0; i < sizeof(uint64_t); i++) {
+    hash = (hash << 8) | static_cast<uint8_t>(content[i]);
+  }
+  content.remove_prefix(sizeof(uint64_t));
+  if (HashUtil::xxHash64(content) != hash) {
+    return false;
+  }
+
+  absl::string_view value;
+  if (!consumeLengthPrefixed(content, value)) {
+    return false;
+  }
+  build_version = std::string(value);
+  while (!content.empty()) {
+    if (!consumeLengthPrefixed(content, value)) {
+      return false;
+    }
+    envoy::service::discovery::v3::DiscoveryResponse response;
+    if (!response.ParseFromArray(value.data(), value.size())) {
+      return false;
+    }
+    serialized_responses[response.type_url()] = std::string(value);
+  }
+  return true;
+}
+
+void XdsSnapshot::load() {
+  if (!file_system_.fileExists(path_)) {
+    ENVOY_LOG(info, "xDS snapshot {} not found, waiting for the management server", path_);
+    return;
+  }
+
+  std::string content;
+  TRY_ASSERT_MAIN_THREAD { content = file_system_.fileReadToEnd(path_); }
+  END_TRY
+  catch (const EnvoyException& e) {
+    ENVOY_LOG(warn, "Ignoring the xDS snapshot {}: {}", path_, e.what());
+    return;
+  }
+
+  std::string build_version;
+  absl::btree_map<std::string, std::string> serialized_responses;
+  if (!parse(content, build_version, serialized_responses)) {
+    ENVOY_LOG(warn, "Ignoring the xDS snapshot {}: the file is corrupted", path_);
+    return;
+  }
+
+  for (const auto& serialized_response : serialized_responses) {
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->ParseFromString(serialized_response.second);
+    loaded_responses_.emplace(serialized_response.first, std::move(response));
+  }
+  serialized_responses_ = std::move(serialized_responses);
+  trusted_ = build_version == build_version_;
+  ENVOY_LOG(info, "Loaded the xDS snapshot {} with {} resource types{}", path_,
+            loaded_responses_.size(), trusted_ ? "" : ", written by another build");
+}
+
+void XdsSnapshot::write() {
+  const std::string content = serialize(build_version_, serialized_responses_);
+  // The snapshot is replaced at once, so that a crash while writing doesn't corrupt it.
+  const std::string temporary_path = path_ + ".tmp";
+  std::remove(temporary_path.c_str());
+  Filesystem::FilePtr file =
+      file_system_.createFile(Filesystem::FilePathAndType{Filesystem::DestinationType::File,
+                                                          temporary_path});
+  static constexpr Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                            1 << Filesystem::File::Operation::Create};
+  const Api::IoCallBoolResult open_result = file->open(flags);
+  if (!open_result.rc_) {
+    ENVOY_LOG(warn, "Unable to write the xDS snapshot {}: {}", temporary_path,
+              open_result.err_->getErrorDetails());
+    return;
+  }
+  const Api::IoCallSizeResult write_result = file->write(content);
+  const bool written =
+      write_result.rc_ == static_cast<ssize_t>(content.size()) && file->close().rc_;
+  if (!written || std::rename(temporary_path.c_str(), path_.c_str()) != 0) {
+    ENVOY_LOG(warn, "Unable to write the xDS snapshot {}", path_);
+    std::remove(temporary_path.c_str());
+    return;
+  }
+  ENVOY_LOG(debug, "Wrote the xDS snapshot {} with {} resource types", path_,
+            serialized_responses_.size());
+}
+
+} // namespace Config
+} // namespace Envoy
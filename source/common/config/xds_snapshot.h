@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "common/common/logger.h"
+
+#include "absl/container/btree_map.h"
+
+namespace Envoy {
+namespace Config {
+
+/**
+ * The last state-of-the-world responses accepted for each type URL of an ADS stream, saved to a
+ * file so that a restarted Envoy can apply them before the management server answers.
+ *
+ * The file starts with a magic string and the xxHash64 of the rest of the file, followed by the
+ * build version of the Envoy that wrote it and the serialized responses, each prefixed by its
+ * length in big-endian. A file whose hash doesn't match is ignored. The hash only detects a
+ * truncated or corrupted file: the snapshot must be kept where only Envoy can write it.
+ */
+class XdsSnapshot : Logger::Loggable<Logger::Id::config> {
+public:
+  /**
+   * Loads the snapshot at the given path, if any.
+   * @param path supplies the path of the snapshot file.
+   * @param build_version supplies the build version of this Envoy.
+   * @param dispatcher supplies the main thread dispatcher, which writes the snapshot.
+   * @param file_system supplies the file system the snapshot is read from and written to.
+   */
+  XdsSnapshot(const std::string& path, const std::string& build_version,
+              Event::Dispatcher& dispatcher, Filesystem::Instance& file_system);
+
+  /**
+   * @param type_url supplies the type URL of a resource type.
+   * @return the response loaded from the snapshot for the type URL, or nullptr if there is none.
+   *         The response is only returned once, as later responses come from the management
+   *         server.
+   */
+  std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>
+  takeResponse(const std::string& type_url);
+
+  /**
+   * @return whether the snapshot was written by this build, so that its resources don't need the
+   *         checks for unknown and deprecated fields.
+   */
+  bool trusted() const { return trusted_; }
+
+  /**
+   * Records an accepted response for the watched type URL. The snapshot file is rewritten shortly
+   * after, once for all the responses recorded in the meantime.
+   */
+  void recordResponse(const std::string& type_url,
+                      const envoy::service::discovery::v3::DiscoveryResponse& response);
+
+  /**
+   * @return the content of a snapshot file for the given responses.
+   */
+  static std::string
+  serialize(const std::string& build_version,
+            const absl::btree_map<std::string, std::string>& serialized_responses);
+
+  /**
+   * Parses the content of a snapshot file.
+   * @param content supplies the content of the file.
+   * @param build_version set to the build version of the Envoy that wrote the file.
+   * @param serialized_responses set to the serialized responses by type URL.
+   * @return whether the content is a valid snapshot.
+   */
+  static bool parse(absl::string_view content, std::string& build_version,
+                    absl::btree_map<std::string, std::string>& serialized_responses);
+
+  // The delay between the first response recorded since the last write and the next write.
+  static constexpr std::chrono::milliseconds WriteDelay{1000};
+
+private:
+  void load();
+  void write();
+
+  const std::string path_;
+  const std::string build_version_;
+  Filesystem::Instance& file_system_;
+  const Event::TimerPtr write_timer_;
+  bool trusted_{};
+  // The responses loaded from the file that weren't applied yet.
+  absl::btree_map<std::string, std::unique_ptr<envoy::service::discovery::v3::DiscoveryResponse>>
+      loaded_responses_;
+  // The responses written to the file, serialized, by type URL.
+  absl::btree_map<std::string, std::string> serialized_responses_;
+};
+
+using XdsSnapshotPtr = std::unique_ptr<XdsSnapshot>;
+
+} // namespace Config
+} // namespace Envoy
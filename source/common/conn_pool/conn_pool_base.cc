@@ -129,7 +129,10 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
     ENVOY_LOG(trace, "not creating a new connection, shouldCreateNewConnection returned false.");
     return ConnectionResult::ShouldNotConnect;
   }
+  return createNewConnection();
+}
 
+ConnPoolImplBase::ConnectionResult ConnPoolImplBase::createNewConnection() {
   const bool can_create_connection =
       host_->cluster().resourceManager(priority_).connections().canCreate();
   if (!can_create_connection) {
@@ -149,6 +152,7 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
     // Increase the connecting capacity to reflect the streams this connection can serve.
     state_.incrConnectingAndConnectedStreamCapacity(client->effectiveConcurrentStreamLimit());
     connecting_stream_capacity_ += client->effectiveConcurrentStreamLimit();
+    predicted_stream_limit_ = std::max<uint32_t>(client->effectiveConcurrentStreamLimit(), 1);
     LinkedList::moveIntoList(std::move(client), owningList(client->state()));
     return can_create_connection ? ConnectionResult::CreatedNewConnection
                                  : ConnectionResult::CreatedButRateLimited;
@@ -187,6 +191,7 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
     num_active_streams_++;
     host_->stats().rq_total_.inc();
     host_->stats().rq_active_.inc();
+    host_->cluster().loadReportHosts().add(host_);
     host_->cluster().stats().upstream_rq_total_.inc();
     host_->cluster().stats().upstream_rq_active_.inc();
     host_->cluster().resourceManager(priority_).requests().inc();
@@ -233,6 +238,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
     attachStreamToClient(client, context);
     // Even if there's a ready client, we may want to preconnect to handle the next incoming stream.
     tryCreateNewConnections();
+    preconnectForPredictedArrivals();
     return nullptr;
   }
 
@@ -251,6 +257,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(AttachContext& context)
                   connecting_stream_capacity_ > old_capacity ||
                   result == ConnectionResult::NoConnectionRateLimited,
               fmt::format("Failed to create expected connection: {}", *this));
+    preconnectForPredictedArrivals();
     return pending;
   } else {
     ENVOY_LOG(debug, "max pending streams overflow");
@@ -265,6 +272,48 @@ bool ConnPoolImplBase::maybePreconnect(float global_preconnect_ratio) {
   return tryCreateNewConnection(global_preconnect_ratio) == ConnectionResult::CreatedNewConnection;
 }
 
+void ConnPoolImplBase::preconnectForPredictedArrivals() {
+  const absl::optional<std::chrono::milliseconds> window =
+      host_->cluster().rateBasedPreconnectWindow();
+  if (!window.has_value()) {
+    return;
+  }
+
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  const auto elapsed = now - arrival_window_start_;
+  if (elapsed >= window.value()) {
+    // Arrivals from before the previous window don't say anything about the next one.
+    arrivals_in_previous_window_ = elapsed >= 2 * window.value() ? 0 : arrivals_in_window_;
+    arrivals_in_window_ = 0;
+    arrival_window_start_ = now;
+  }
+  ++arrivals_in_window_;
+
+  // As with local preconnect, don't make unhealthy hosts do extra work.
+  if (host_->health() != Upstream::Host::Health::Healthy) {
+    return;
+  }
+
+  // Expect as many streams in the next window as arrived in the busier of the current and the
+  // previous one, and keep enough spare capacity to serve them without waiting for a handshake.
+  // Like tryCreateNewConnections(), cap the connections created per stream.
+  const uint64_t predicted_arrivals = std::max(arrivals_in_window_, arrivals_in_previous_window_);
+  for (int i = 0; i < 3 && spareStreamCapacity() < predicted_arrivals; ++i) {
+    if (createNewConnection() != ConnectionResult::CreatedNewConnection) {
+      break;
+    }
+  }
+}
+
+uint64_t ConnPoolImplBase::spareStreamCapacity() const {
+  // The connecting capacity which isn't claimed by pending streams, plus an estimate for the ready
+  // clients based on the stream limit of the most recent connection.
+  const uint64_t connecting_spare = connecting_stream_capacity_ > pending_streams_.size()
+                                        ? connecting_stream_capacity_ - pending_streams_.size()
+                                        : 0;
+  return connecting_spare + ready_clients_.size() * predicted_stream_limit_;
+}
+
 void ConnPoolImplBase::scheduleOnUpstreamReady() {
   upstream_ready_cb_->scheduleCallbackCurrentIteration();
 }
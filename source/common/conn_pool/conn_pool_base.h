@@ -264,6 +264,9 @@ protected:
   // if this is called by maybePreconnect()
   ConnectionResult tryCreateNewConnection(float global_preconnect_ratio = 0);
 
+  // Creates a new connection if it is allowed by resourceManager, or to avoid starving this pool.
+  ConnectionResult createNewConnection();
+
   // A helper function which determines if a canceled pending connection should
   // be closed as excess or not.
   bool connectingConnectionIsExcess() const;
@@ -324,7 +327,20 @@ private:
   uint32_t num_active_streams_{0};
 
   void onUpstreamReady();
+  // Counts an incoming stream and, if rate based preconnect is configured, creates up to 3
+  // connections so that the streams predicted to arrive next don't have to wait for a connection.
+  void preconnectForPredictedArrivals();
+  // The number of additional streams the connecting and ready clients are expected to serve.
+  uint64_t spareStreamCapacity() const;
+
   Event::SchedulableCallbackPtr upstream_ready_cb_;
+
+  // Streams arrived in the current and the previous rate based preconnect window.
+  MonotonicTime arrival_window_start_;
+  uint32_t arrivals_in_window_{0};
+  uint32_t arrivals_in_previous_window_{0};
+  // The stream limit of the most recent connection, used to estimate the capacity of ready clients.
+  uint32_t predicted_stream_limit_{1};
 };
 
 } // namespace ConnectionPool
@@ -1,8 +1,11 @@
 #include "common/event/dispatcher_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -20,6 +23,7 @@
 #include "common/event/scaled_range_timer_manager_impl.h"
 #include "common/event/signal_impl.h"
 #include "common/event/timer_impl.h"
+#include "common/event/timer_wheel_impl.h"
 #include "common/filesystem/watcher_impl.h"
 #include "common/network/connection_impl.h"
 #include "common/network/dns_impl.h"
@@ -58,7 +62,7 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
                                Event::TimeSystem& time_system,
                                const ScaledRangeTimerManagerFactory& scaled_timer_factory,
                                const Buffer::WatermarkFactorySharedPtr& watermark_factory)
-    : name_(name), api_(api),
+    : name_(name), api_(api), slow_callback_log_(api.slowCallbackLog()),
       buffer_factory_(watermark_factory != nullptr
                           ? watermark_factory
                           : std::make_shared<Buffer::WatermarkBufferFactory>()),
@@ -66,7 +70,7 @@ DispatcherImpl::DispatcherImpl(const std::string& name, Api::Api& api,
       thread_local_delete_cb_(
           base_scheduler_.createSchedulableCallback([this]() -> void { runThreadLocalDelete(); })),
       deferred_delete_cb_(base_scheduler_.createSchedulableCallback(
-          [this]() -> void { clearDeferredDeleteList(); })),
+          [this]() -> void { runDeferredDelete(); })),
       post_cb_(base_scheduler_.createSchedulableCallback([this]() -> void { runPostCallbacks(); })),
       current_to_delete_(&to_delete_1_), scaled_timer_manager_(scaled_timer_factory(*this)) {
   ASSERT(!name_.empty());
@@ -97,29 +101,48 @@ void DispatcherImpl::initializeStats(Stats::Scope& scope,
   post([this, &scope, effective_prefix] {
     stats_prefix_ = effective_prefix + "dispatcher";
     stats_ = std::make_unique<DispatcherStats>(
-        DispatcherStats{ALL_DISPATCHER_STATS(POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
+        DispatcherStats{ALL_DISPATCHER_STATS(POOL_COUNTER_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_GAUGE_PREFIX(scope, stats_prefix_ + "."),
+                                             POOL_HISTOGRAM_PREFIX(scope, stats_prefix_ + "."))});
     base_scheduler_.initializeStats(stats_.get());
     ENVOY_LOG(debug, "running {} on thread {}", stats_prefix_, run_tid_.debugString());
   });
 }
 
 void DispatcherImpl::clearDeferredDeleteList() {
-  ASSERT(isThreadSafe());
-  std::vector<DeferredDeletablePtr>* to_delete = current_to_delete_;
+  // Finish the backlog left by a budgeted run first, to keep the FIFO order.
+  if (backlog_to_delete_ != nullptr) {
+    deleteDeferred(std::numeric_limits<uint64_t>::max());
+  }
+  deleteDeferred(std::numeric_limits<uint64_t>::max());
+}
 
-  size_t num_to_delete = to_delete->size();
-  if (deferred_deleting_ || !num_to_delete) {
+void DispatcherImpl::runDeferredDelete() {
+  const uint64_t budget =
+      Runtime::getInteger("envoy.dispatcher.max_deferred_deletes_per_iteration", 0);
+  deleteDeferred(budget > 0 ? budget : std::numeric_limits<uint64_t>::max());
+}
+
+void DispatcherImpl::deleteDeferred(uint64_t budget) {
+  ASSERT(isThreadSafe());
+  if (deferred_deleting_) {
     return;
   }
 
-  ENVOY_LOG(trace, "clearing deferred deletion list (size={})", num_to_delete);
-
-  // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
-  // use the other vector. We will get another callback to delete that vector.
-  if (current_to_delete_ == &to_delete_1_) {
-    current_to_delete_ = &to_delete_2_;
-  } else {
-    current_to_delete_ = &to_delete_1_;
+  if (backlog_to_delete_ == nullptr) {
+    if (current_to_delete_->empty()) {
+      return;
+    }
+    ENVOY_LOG(trace, "clearing deferred deletion list (size={})", current_to_delete_->size());
+
+    // Swap the current deletion vector so that if we do deferred delete while we are deleting, we
+    // use the other vector. We will get another callback to delete that vector.
+    backlog_to_delete_ = current_to_delete_;
+    if (current_to_delete_ == &to_delete_1_) {
+      current_to_delete_ = &to_delete_2_;
+    } else {
+      current_to_delete_ = &to_delete_1_;
+    }
   }
 
   touchWatchdog();
@@ -128,11 +151,30 @@ void DispatcherImpl::clearDeferredDeleteList() {
   // Calling clear() on the vector does not specify which order destructors run in. We want to
   // destroy in FIFO order so just do it manually. This required 2 passes over the vector which is
   // not optimal but can be cleaned up later if needed.
+  std::vector<DeferredDeletablePtr>& to_delete = *backlog_to_delete_;
+  const size_t num_to_delete = std::min<uint64_t>(to_delete.size() - deleted_from_backlog_, budget);
   for (size_t i = 0; i < num_to_delete; i++) {
-    (*to_delete)[i].reset();
+    to_delete[deleted_from_backlog_++].reset();
   }
 
-  to_delete->clear();
+  size_t backlog = to_delete.size() - deleted_from_backlog_;
+  if (backlog == 0) {
+    to_delete.clear();
+    backlog_to_delete_ = nullptr;
+    deleted_from_backlog_ = 0;
+    // The objects deferred while the backlog was deleted by the previous budgeted runs didn't
+    // schedule the callback.
+    if (!current_to_delete_->empty()) {
+      deferred_delete_cb_->scheduleCallbackCurrentIteration();
+    }
+  } else {
+    // The budget ran out, the rest of the backlog is deleted in the next iterations.
+    ENVOY_LOG(trace, "deferred deletion backlog (size={})", backlog);
+    deferred_delete_cb_->scheduleCallbackNextIteration();
+  }
+  if (stats_ != nullptr) {
+    stats_->deferred_delete_backlog_.set(backlog);
+  }
   deferred_deleting_ = false;
 }
 
@@ -187,6 +229,7 @@ FileEventPtr DispatcherImpl::createFileEvent(os_fd_t fd, FileReadyCb cb, FileTri
       *this, fd,
       [this, cb](uint32_t events) {
         touchWatchdog();
+        CallbackTimer timer(*this, SlowCallback::Type::FileEvent);
         cb(events);
       },
       trigger, events)};
@@ -219,6 +262,14 @@ TimerPtr DispatcherImpl::createTimer(TimerCb cb) {
   return createTimerInternal(cb);
 }
 
+TimerPtr DispatcherImpl::createWheelTimer(TimerCb cb) {
+  ASSERT(isThreadSafe());
+  if (timer_wheel_ == nullptr) {
+    timer_wheel_ = std::make_unique<TimerWheel>(*this, std::chrono::milliseconds(1));
+  }
+  return timer_wheel_->createTimer(std::move(cb));
+}
+
 TimerPtr DispatcherImpl::createScaledTimer(ScaledTimerType timer_type, TimerCb cb) {
   ASSERT(isThreadSafe());
   return scaled_timer_manager_->createTimer(timer_type, std::move(cb));
@@ -233,6 +284,7 @@ Event::SchedulableCallbackPtr DispatcherImpl::createSchedulableCallback(std::fun
   ASSERT(isThreadSafe());
   return base_scheduler_.createSchedulableCallback([this, cb]() {
     touchWatchdog();
+    CallbackTimer timer(*this, SlowCallback::Type::SchedulableCallback);
     cb();
   });
 }
@@ -241,6 +293,7 @@ TimerPtr DispatcherImpl::createTimerInternal(TimerCb cb) {
   return scheduler_->createTimer(
       [this, cb]() {
         touchWatchdog();
+        CallbackTimer timer(*this, SlowCallback::Type::Timer);
         cb();
       },
       *this);
@@ -263,11 +316,23 @@ SignalEventPtr DispatcherImpl::listenForSignal(signal_t signal_num, SignalCb cb)
 }
 
 void DispatcherImpl::post(std::function<void()> callback) {
+  std::list<std::function<void()>> callbacks;
+  callbacks.push_back(std::move(callback));
+  postBatch(std::move(callbacks));
+}
+
+void DispatcherImpl::postBatch(std::list<std::function<void()>> callbacks) {
+  if (callbacks.empty()) {
+    return;
+  }
+
+  // The nodes of the list are allocated by the caller, so that the post_lock_ is only held to
+  // splice them, which the workers posting to the same dispatcher contend on.
   bool do_post;
   {
     Thread::LockGuard lock(post_lock_);
     do_post = post_callbacks_.empty();
-    post_callbacks_.push_back(callback);
+    post_callbacks_.splice(post_callbacks_.end(), callbacks);
   }
 
   if (do_post) {
@@ -358,7 +423,7 @@ void DispatcherImpl::runPostCallbacks() {
   // Clear the deferred delete list before running post callbacks to reduce non-determinism in
   // callback processing, and more easily detect if a scheduled post callback refers to one of the
   // objects that is being deferred deleted.
-  clearDeferredDeleteList();
+  runDeferredDelete();
 
   std::list<std::function<void()>> callbacks;
   {
@@ -377,7 +442,10 @@ void DispatcherImpl::runPostCallbacks() {
     // executing a long list of callbacks.
     touchWatchdog();
     // Run the callback.
-    callbacks.front()();
+    {
+      CallbackTimer timer(*this, SlowCallback::Type::Post);
+      callbacks.front()();
+    }
     // Pop the front so that the destructor of the callback that just executed runs before the next
     // callback executes.
     callbacks.pop_front();
@@ -413,6 +481,51 @@ void DispatcherImpl::touchWatchdog() {
   }
 }
 
+DispatcherImpl::CallbackTimer::CallbackTimer(DispatcherImpl& dispatcher, SlowCallback::Type type)
+    : dispatcher_(dispatcher), type_(type) {
+  if (dispatcher_.callback_start_.has_value()) {
+    return;
+  }
+  const std::chrono::microseconds threshold = dispatcher_.slow_callback_log_.threshold();
+  if (threshold.count() == 0) {
+    return;
+  }
+  timed_ = true;
+  dispatcher_.callback_threshold_ = threshold;
+  dispatcher_.callback_start_ = dispatcher_.timeSource().monotonicTime();
+}
+
+DispatcherImpl::CallbackTimer::~CallbackTimer() {
+  if (!timed_) {
+    return;
+  }
+  const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+      dispatcher_.timeSource().monotonicTime() - *dispatcher_.callback_start_);
+  if (duration >= dispatcher_.callback_threshold_) {
+    // The objects tracked by the callback itself are dumped as they are popped, the ones tracked
+    // around it, e.g. the object of a timer, are still tracked.
+    if (!dispatcher_.slow_callback_object_.has_value() &&
+        !dispatcher_.tracked_object_stack_.empty()) {
+      dispatcher_.dumpSlowCallbackObject(*dispatcher_.tracked_object_stack_.back());
+    }
+    if (dispatcher_.stats_ != nullptr) {
+      dispatcher_.stats_->slow_callbacks_.inc();
+    }
+    ENVOY_LOG(debug, "{} ran a slow callback for {}us", dispatcher_.name_, duration.count());
+    dispatcher_.slow_callback_log_.record({dispatcher_.name_, type_,
+                                           dispatcher_.timeSource().systemTime(), duration,
+                                           dispatcher_.slow_callback_object_.value_or("")});
+  }
+  dispatcher_.callback_start_.reset();
+  dispatcher_.slow_callback_object_.reset();
+}
+
+void DispatcherImpl::dumpSlowCallbackObject(const ScopeTrackedObject& object) {
+  std::stringstream state;
+  object.dumpState(state);
+  slow_callback_object_ = state.str().substr(0, MaxSlowCallbackObjectSize);
+}
+
 void DispatcherImpl::pushTrackedObject(const ScopeTrackedObject* object) {
   ASSERT(isThreadSafe());
   ASSERT(object != nullptr);
@@ -426,6 +539,10 @@ void DispatcherImpl::popTrackedObject(const ScopeTrackedObject* expected_object)
   RELEASE_ASSERT(!tracked_object_stack_.empty(), "Tracked Object Stack is empty, nothing to pop!");
 
   const ScopeTrackedObject* top = tracked_object_stack_.back();
+  if (callback_start_.has_value() && !slow_callback_object_.has_value() &&
+      timeSource().monotonicTime() - *callback_start_ >= callback_threshold_) {
+    dumpSlowCallbackObject(*top);
+  }
   tracked_object_stack_.pop_back();
   ASSERT(top == expected_object,
          "Popped the top of the tracked object stack, but it wasn't the expected object!");
@@ -4,6 +4,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "envoy/api/api.h"
@@ -11,6 +12,7 @@
 #include "envoy/common/time.h"
 #include "envoy/event/deferred_deletable.h"
 #include "envoy/event/dispatcher.h"
+#include "envoy/event/slow_callback_log.h"
 #include "envoy/network/connection_handler.h"
 #include "envoy/stats/scope.h"
 
@@ -30,6 +32,11 @@ namespace Event {
 // shouldn't have to grow larger.
 inline constexpr size_t ExpectedMaxTrackedObjectStackDepth = 10;
 
+// The state of the object a slow callback is attributed to is truncated to this size.
+inline constexpr size_t MaxSlowCallbackObjectSize = 4096;
+
+class TimerWheel;
+
 /**
  * libevent implementation of Event::Dispatcher.
  */
@@ -56,6 +63,9 @@ public:
                         std::chrono::milliseconds min_touch_interval) override;
   TimeSource& timeSource() override { return api_.timeSource(); }
   void initializeStats(Stats::Scope& scope, const absl::optional<std::string>& prefix) override;
+  absl::optional<double> loopUtilization() const override {
+    return base_scheduler_.loopUtilization();
+  }
   void clearDeferredDeleteList() override;
   Network::ServerConnectionPtr
   createServerConnection(Network::ConnectionSocketPtr&& socket,
@@ -79,6 +89,7 @@ public:
   createUdpListener(Network::SocketSharedPtr socket, Network::UdpListenerCallbacks& cb,
                     const envoy::config::core::v3::UdpSocketConfig& config) override;
   TimerPtr createTimer(TimerCb cb) override;
+  TimerPtr createWheelTimer(TimerCb cb) override;
   TimerPtr createScaledTimer(ScaledTimerType timer_type, TimerCb cb) override;
   TimerPtr createScaledTimer(ScaledTimerMinimum minimum, TimerCb cb) override;
 
@@ -87,6 +98,7 @@ public:
   void exit() override;
   SignalEventPtr listenForSignal(signal_t signal_num, SignalCb cb) override;
   void post(std::function<void()> callback) override;
+  void postBatch(std::list<std::function<void()>> callbacks) override;
   void deleteInDispatcherThread(DispatcherThreadDeletableConstPtr deletable) override;
   void run(RunType type) override;
   Buffer::WatermarkFactory& getWatermarkFactory() override { return *buffer_factory_; }
@@ -127,10 +139,30 @@ private:
   };
   using WatchdogRegistrationPtr = std::unique_ptr<WatchdogRegistration>;
 
+  // Times a callback of the dispatcher for the slow callback log, while the log has a threshold.
+  // Only the outermost callback is timed.
+  class CallbackTimer {
+  public:
+    CallbackTimer(DispatcherImpl& dispatcher, SlowCallback::Type type);
+    ~CallbackTimer();
+
+  private:
+    DispatcherImpl& dispatcher_;
+    const SlowCallback::Type type_;
+    bool timed_{};
+  };
+
+  // Keeps the state of the object the slow callback being timed is attributed to.
+  void dumpSlowCallbackObject(const ScopeTrackedObject& object);
+
   TimerPtr createTimerInternal(TimerCb cb);
   void updateApproximateMonotonicTimeInternal();
   void runPostCallbacks();
   void runThreadLocalDelete();
+  // Deletes the deferred deletes, up to the per iteration budget of the runtime if any.
+  void runDeferredDelete();
+  // Deletes up to budget deferred deletes, starting with the backlog of the previous runs.
+  void deleteDeferred(uint64_t budget);
 
   // Helper used to touch the watchdog after most schedulable, fd, and timer callbacks.
   void touchWatchdog();
@@ -144,12 +176,16 @@ private:
 
   const std::string name_;
   Api::Api& api_;
+  SlowCallbackLog& slow_callback_log_;
   std::string stats_prefix_;
   DispatcherStatsPtr stats_;
   Thread::ThreadId run_tid_;
   Buffer::WatermarkFactorySharedPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
   SchedulerPtr scheduler_;
+  // Created with the first wheel timer, on the thread of the dispatcher. Declared before the
+  // members that may hold its timers, the deferred deletes and the scaled timer manager.
+  std::unique_ptr<TimerWheel> timer_wheel_;
 
   SchedulableCallbackPtr thread_local_delete_cb_;
   Thread::MutexBasicLockable thread_local_deletable_lock_;
@@ -167,6 +203,10 @@ private:
   std::vector<DeferredDeletablePtr> to_delete_1_;
   std::vector<DeferredDeletablePtr> to_delete_2_;
   std::vector<DeferredDeletablePtr>* current_to_delete_;
+  // The vector being deleted, while a budgeted run left some of its objects, and the number of its
+  // objects already deleted.
+  std::vector<DeferredDeletablePtr>* backlog_to_delete_{};
+  size_t deleted_from_backlog_{};
 
   absl::InlinedVector<const ScopeTrackedObject*, ExpectedMaxTrackedObjectStackDepth>
       tracked_object_stack_;
@@ -174,6 +214,11 @@ private:
   MonotonicTime approximate_monotonic_time_;
   WatchdogRegistrationPtr watchdog_registration_;
   const ScaledRangeTimerManagerPtr scaled_timer_manager_;
+  // The start and threshold of the callback being timed, if any, and the state of the innermost
+  // object tracked once it became slow.
+  absl::optional<MonotonicTime> callback_start_;
+  std::chrono::microseconds callback_threshold_{};
+  absl::optional<std::string> slow_callback_object_;
 };
 
 } // namespace Event
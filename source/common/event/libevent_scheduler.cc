@@ -72,6 +72,7 @@ void LibeventScheduler::registerOnPrepareCallback(OnPrepareCallback&& callback)
 
 void LibeventScheduler::initializeStats(DispatcherStats* stats) {
   stats_ = stats;
+  utilization_ppm_.store(0, std::memory_order_relaxed);
   // These are thread safe.
   evwatch_prepare_new(libevent_.get(), &onPrepareForStats, this);
   evwatch_check_new(libevent_.get(), &onCheckForStats, this);
@@ -101,6 +102,7 @@ void LibeventScheduler::onPrepareForStats(evwatch*, const evwatch_prepare_cb_inf
     timeval delta;
     evutil_timersub(&self->prepare_time_, &self->check_time_, &delta);
     recordTimeval(self->stats_->loop_duration_us_, delta);
+    self->recordLoopTime(delta, true);
   }
 }
 
@@ -112,9 +114,11 @@ void LibeventScheduler::onCheckForStats(evwatch*, const evwatch_check_cb_info*,
   // from above to compute the actual polling duration, and store it for the next iteration of the
   // event loop to compute the loop duration.
   evutil_gettimeofday(&self->check_time_, nullptr);
+  timeval delta;
+  evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+  self->recordLoopTime(delta, false);
   if (self->timeout_set_) {
-    timeval delta, delay;
-    evutil_timersub(&self->check_time_, &self->prepare_time_, &delta);
+    timeval delay;
     evutil_timersub(&delta, &self->timeout_, &delay);
 
     // Delay can be negative, meaning polling completed early. This happens in normal operation,
@@ -127,5 +131,36 @@ void LibeventScheduler::onCheckForStats(evwatch*, const evwatch_check_cb_info*,
   }
 }
 
+void LibeventScheduler::recordLoopTime(const timeval& duration, bool busy) {
+  if (duration.tv_sec < 0) {
+    // The wall clock went backwards.
+    return;
+  }
+  const uint64_t duration_us = duration.tv_sec * 1000000 + duration.tv_usec;
+  window_us_ += duration_us;
+  if (busy) {
+    busy_us_ += duration_us;
+  }
+  if (window_us_ < UtilizationWindowUs) {
+    return;
+  }
+
+  // Average the new window with the previous estimate so that a single quiet or busy window
+  // doesn't swing it all the way.
+  const uint64_t window_ppm = busy_us_ * 1000000 / window_us_;
+  const uint32_t previous_ppm = utilization_ppm_.load(std::memory_order_relaxed);
+  utilization_ppm_.store((previous_ppm + window_ppm) / 2, std::memory_order_relaxed);
+  busy_us_ = 0;
+  window_us_ = 0;
+}
+
+absl::optional<double> LibeventScheduler::loopUtilization() const {
+  const uint32_t utilization_ppm = utilization_ppm_.load(std::memory_order_relaxed);
+  if (utilization_ppm == UnknownUtilization) {
+    return absl::nullopt;
+  }
+  return utilization_ppm / 1000000.0;
+}
+
 } // namespace Event
 } // namespace Envoy
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 
 #include "envoy/event/dispatcher.h"
@@ -101,10 +103,22 @@ public:
    */
   void initializeStats(DispatcherStats* stats);
 
+  /**
+   * @return the fraction of recent wall time spent outside of polling, or absl::nullopt if stats
+   *         haven't been initialized. This may be called from any thread.
+   */
+  absl::optional<double> loopUtilization() const;
+
 private:
   static void onPrepareForCallback(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onPrepareForStats(evwatch*, const evwatch_prepare_cb_info* info, void* arg);
   static void onCheckForStats(evwatch*, const evwatch_check_cb_info*, void* arg);
+  // Accounts for time spent running (busy) or polling (!busy) towards the utilization estimate.
+  void recordLoopTime(const timeval& duration, bool busy);
+
+  static constexpr uint32_t UnknownUtilization = UINT32_MAX;
+  // The utilization estimate is updated once this much wall time has been accounted for.
+  static constexpr uint64_t UtilizationWindowUs = 50000;
 
   static constexpr int flagsBasedOnEventType() {
     if constexpr (Event::PlatformDefaultTriggerType == FileTriggerType::Level) {
@@ -122,6 +136,10 @@ private:
   timeval timeout_{};        // the poll timeout for the current event loop iteration, if available
   timeval prepare_time_{};   // timestamp immediately before polling
   timeval check_time_{};     // timestamp immediately after polling
+  uint64_t busy_us_{};       // time spent outside polling in the current utilization window
+  uint64_t window_us_{};     // length of the current utilization window so far
+  // Smoothed utilization in parts per million, or UnknownUtilization before stats are initialized.
+  std::atomic<uint32_t> utilization_ppm_{UnknownUtilization};
   OnPrepareCallback callback_; // callback to be called from onPrepareForCallback()
 };
 
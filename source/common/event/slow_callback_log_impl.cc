@@ -0,0 +1,22 @@
+#include "common/event/slow_callback_log_impl.h"
+
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Event {
+
+void SlowCallbackLogImpl::record(SlowCallback&& callback) {
+  Thread::LockGuard lock(lock_);
+  if (callbacks_.size() == MaxCallbacks) {
+    callbacks_.pop_front();
+  }
+  callbacks_.push_back(std::move(callback));
+}
+
+std::vector<SlowCallback> SlowCallbackLogImpl::recentCallbacks() const {
+  Thread::LockGuard lock(lock_);
+  return {callbacks_.begin(), callbacks_.end()};
+}
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "envoy/event/slow_callback_log.h"
+
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * Keeps the last MaxCallbacks slow callbacks of the dispatchers sharing the log.
+ */
+class SlowCallbackLogImpl : public SlowCallbackLog {
+public:
+  static constexpr uint32_t MaxCallbacks = 64;
+
+  // Event::SlowCallbackLog
+  std::chrono::microseconds threshold() const override {
+    return std::chrono::microseconds(threshold_us_.load(std::memory_order_relaxed));
+  }
+  void setThreshold(std::chrono::microseconds threshold) override {
+    threshold_us_.store(threshold.count(), std::memory_order_relaxed);
+  }
+  void record(SlowCallback&& callback) override;
+  std::vector<SlowCallback> recentCallbacks() const override;
+
+private:
+  std::atomic<int64_t> threshold_us_{0};
+  mutable Thread::MutexBasicLockable lock_;
+  std::deque<SlowCallback> callbacks_ ABSL_GUARDED_BY(lock_);
+};
+
+} // namespace Event
+} // namespace Envoy
@@ -0,0 +1,284 @@
+#include "common/event/timer_wheel_impl.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "common/common/assert.h"
+#include "common/common/scope_tracker.h"
+
+namespace Envoy {
+namespace Event {
+
+class TimerWheel::TimerImpl final : public Timer {
+public:
+  TimerImpl(TimerWheel& wheel, TimerCb cb) : wheel_(wheel), cb_(std::move(cb)) { ASSERT(cb_); }
+
+  ~TimerImpl() override { disableTimer(); }
+
+  // Timer
+  void disableTimer() override {
+    if (level_ != NoLevel) {
+      wheel_.remove(*this);
+    }
+    scope_ = nullptr;
+  }
+
+  void enableTimer(std::chrono::milliseconds ms, const ScopeTrackedObject* scope) override {
+    enableHRTimer(ms, scope);
+  }
+
+  void enableHRTimer(std::chrono::microseconds us, const ScopeTrackedObject* scope) override {
+    disableTimer();
+    scope_ = scope;
+    wheel_.enable(*this, us);
+  }
+
+  bool enabled() override { return level_ != NoLevel; }
+
+  void fire() {
+    if (scope_ == nullptr) {
+      cb_();
+      return;
+    }
+    ScopeTrackerScopeState scope(scope_, wheel_.dispatcher_);
+    scope_ = nullptr;
+    cb_();
+  }
+
+  TimerWheel& wheel_;
+  const TimerCb cb_;
+  const ScopeTrackedObject* scope_{};
+  MonotonicTime deadline_;
+  // The slot holding the timer, while it is enabled.
+  uint32_t level_{NoLevel};
+  uint32_t index_{};
+  TimerImpl* prev_{};
+  TimerImpl* next_{};
+};
+
+TimerWheel::TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds tick)
+    : dispatcher_(dispatcher), tick_(tick), start_(dispatcher.timeSource().monotonicTime()),
+      timer_(dispatcher.createTimer([this]() { onTimer(); })) {
+  ASSERT(tick.count() > 0);
+}
+
+TimerWheel::~TimerWheel() {
+  // The timers of the wheel shouldn't outlive it. This is necessary but not sufficient to
+  // guarantee that.
+  ASSERT(num_timers_ == 0);
+}
+
+TimerPtr TimerWheel::createTimer(TimerCb cb) {
+  return std::make_unique<TimerImpl>(*this, std::move(cb));
+}
+
+uint64_t TimerWheel::ticksAt(MonotonicTime time) const {
+  const MonotonicTime::duration elapsed = time - start_;
+  return elapsed > MonotonicTime::duration::zero() ? elapsed / tick_ : 0;
+}
+
+void TimerWheel::enable(TimerImpl& timer, std::chrono::microseconds duration) {
+  ASSERT(dispatcher_.isThreadSafe());
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  if (num_timers_ == 0) {
+    // The wheel doesn't advance while it is empty.
+    current_tick_ = std::max(current_tick_, ticksAt(now));
+  }
+  timer.deadline_ = now + std::max(duration, std::chrono::microseconds::zero());
+  insert(timer);
+  ++num_timers_;
+
+  if (timer.level_ == 0) {
+    armAt(timer.deadline_);
+  } else {
+    const uint32_t shift = BitsPerLevel * timer.level_;
+    const uint32_t offset = (timer.index_ - (current_tick_ >> shift)) & (SlotsPerLevel - 1);
+    armAt(tickTime(slotTick(timer.level_, offset == 0 ? SlotsPerLevel : offset)));
+  }
+}
+
+TimerWheel::Slot& TimerWheel::slotOf(const TimerImpl& timer) {
+  return timer.level_ == ExpiringLevel ? expiring_ : levels_[timer.level_].slots_[timer.index_];
+}
+
+void TimerWheel::link(TimerImpl& timer, uint32_t level, uint32_t index) {
+  timer.level_ = level;
+  timer.index_ = index;
+  Slot& slot = slotOf(timer);
+  // The timers are appended, so that the cascades keep them in the order they were enabled.
+  timer.prev_ = slot.tail_;
+  timer.next_ = nullptr;
+  if (slot.tail_ != nullptr) {
+    slot.tail_->next_ = &timer;
+  } else {
+    slot.head_ = &timer;
+  }
+  slot.tail_ = &timer;
+  if (level < Levels) {
+    levels_[level].occupied_[index / 64] |= uint64_t(1) << (index % 64);
+  }
+}
+
+void TimerWheel::unlink(TimerImpl& timer) {
+  Slot& slot = slotOf(timer);
+  if (timer.prev_ != nullptr) {
+    timer.prev_->next_ = timer.next_;
+  } else {
+    slot.head_ = timer.next_;
+  }
+  if (timer.next_ != nullptr) {
+    timer.next_->prev_ = timer.prev_;
+  } else {
+    slot.tail_ = timer.prev_;
+  }
+  if (slot.head_ == nullptr && timer.level_ < Levels) {
+    levels_[timer.level_].occupied_[timer.index_ / 64] &= ~(uint64_t(1) << (timer.index_ % 64));
+  }
+  timer.level_ = NoLevel;
+  timer.prev_ = nullptr;
+  timer.next_ = nullptr;
+}
+
+void TimerWheel::insert(TimerImpl& timer) {
+  const uint64_t expiry_tick = std::max(ticksAt(timer.deadline_), current_tick_);
+  const uint64_t delta = expiry_tick - current_tick_;
+  uint32_t level = 0;
+  while (level < Levels - 1 && (delta >> (BitsPerLevel * (level + 1))) != 0) {
+    ++level;
+  }
+  uint64_t placement_tick = expiry_tick;
+  if ((delta >> (BitsPerLevel * Levels)) != 0) {
+    // Beyond the range of the top level, the timer is cascaded from its last slot again.
+    placement_tick = current_tick_ + (uint64_t(1) << (BitsPerLevel * Levels)) - 1;
+  }
+  link(timer, level, (placement_tick >> (BitsPerLevel * level)) & (SlotsPerLevel - 1));
+}
+
+void TimerWheel::remove(TimerImpl& timer) {
+  ASSERT(dispatcher_.isThreadSafe());
+  ASSERT(timer.level_ != NoLevel);
+  unlink(timer);
+  --num_timers_;
+}
+
+void TimerWheel::cascade(uint32_t level) {
+  const uint32_t index = (current_tick_ >> (BitsPerLevel * level)) & (SlotsPerLevel - 1);
+  Slot& slot = levels_[level].slots_[index];
+  while (slot.head_ != nullptr) {
+    TimerImpl& timer = *slot.head_;
+    unlink(timer);
+    insert(timer);
+  }
+}
+
+void TimerWheel::expire(MonotonicTime limit) {
+  // Move the expired timers out of the slot first, as the callbacks may enable timers that expire
+  // in the current tick again. Like libevent, the timers fire in the order of their deadlines, and
+  // in the order they were enabled for the same deadline.
+  Slot& slot = levels_[0].slots_[current_tick_ & (SlotsPerLevel - 1)];
+  for (TimerImpl* timer = slot.head_; timer != nullptr; timer = timer->next_) {
+    if (timer->deadline_ <= limit) {
+      expired_.push_back(timer);
+    }
+  }
+  std::stable_sort(expired_.begin(), expired_.end(),
+                   [](const TimerImpl* lhs, const TimerImpl* rhs) {
+                     return lhs->deadline_ < rhs->deadline_;
+                   });
+  for (TimerImpl* timer : expired_) {
+    unlink(*timer);
+    link(*timer, ExpiringLevel, 0);
+  }
+  expired_.clear();
+  while (expiring_.head_ != nullptr) {
+    TimerImpl& expired = *expiring_.head_;
+    remove(expired);
+    expired.fire();
+  }
+}
+
+void TimerWheel::onTimer() {
+  armed_time_ = MonotonicTime::max();
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  const uint64_t now_tick = ticksAt(now);
+  while (true) {
+    // All the timers of the previous ticks expired by now, only some of the current one did.
+    expire(current_tick_ < now_tick ? MonotonicTime::max() : now);
+    if (current_tick_ >= now_tick) {
+      break;
+    }
+    // Nothing fires or cascades before the next wakeup tick, so skip over the ticks in between.
+    current_tick_ = std::min(now_tick, nextWakeupTick());
+    for (uint32_t level = 1;
+         level < Levels && (current_tick_ & ((uint64_t(1) << (BitsPerLevel * level)) - 1)) == 0;
+         ++level) {
+      cascade(level);
+    }
+  }
+  armNext();
+}
+
+uint64_t TimerWheel::slotTick(uint32_t level, uint32_t offset) const {
+  const uint32_t shift = BitsPerLevel * level;
+  return ((current_tick_ >> shift) + offset) << shift;
+}
+
+uint64_t TimerWheel::nextWakeupTick() const {
+  uint64_t tick = UINT64_MAX;
+  for (uint32_t level = 0; level < Levels; ++level) {
+    if (const auto offset = nextOccupiedOffset(level, 1); offset.has_value()) {
+      tick = std::min(tick, slotTick(level, offset.value()));
+    }
+  }
+  return tick;
+}
+
+absl::optional<uint32_t> TimerWheel::nextOccupiedOffset(uint32_t level, uint32_t first) const {
+  const auto& occupied = levels_[level].occupied_;
+  const uint32_t index = (current_tick_ >> (BitsPerLevel * level)) & (SlotsPerLevel - 1);
+  uint32_t offset = first;
+  while (offset < first + SlotsPerLevel) {
+    const uint32_t slot = (index + offset) & (SlotsPerLevel - 1);
+    const uint64_t word = occupied[slot / 64] >> (slot % 64);
+    if (word != 0) {
+      // When wrapping around to the first word, its bits after the first slot were already
+      // scanned, so the offset stays in range.
+      return offset + __builtin_ctzll(word);
+    }
+    offset += 64 - slot % 64;
+  }
+  return absl::nullopt;
+}
+
+void TimerWheel::armNext() {
+  if (num_timers_ == 0) {
+    return;
+  }
+  MonotonicTime wakeup = MonotonicTime::max();
+  // The first non-empty slot of level 0 holds the next deadline of the level.
+  if (const auto offset = nextOccupiedOffset(0, 0); offset.has_value()) {
+    const Slot& slot = levels_[0].slots_[(current_tick_ + offset.value()) & (SlotsPerLevel - 1)];
+    for (const TimerImpl* timer = slot.head_; timer != nullptr; timer = timer->next_) {
+      wakeup = std::min(wakeup, timer->deadline_);
+    }
+  }
+  for (uint32_t level = 1; level < Levels; ++level) {
+    if (const auto offset = nextOccupiedOffset(level, 1); offset.has_value()) {
+      wakeup = std::min(wakeup, tickTime(slotTick(level, offset.value())));
+    }
+  }
+  armAt(wakeup);
+}
+
+void TimerWheel::armAt(MonotonicTime time) {
+  if (time >= armed_time_) {
+    return;
+  }
+  armed_time_ = time;
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  timer_->enableHRTimer(time > now ? std::chrono::ceil<std::chrono::microseconds>(time - now)
+                                   : std::chrono::microseconds::zero());
+}
+
+} // namespace Event
+} // namespace Envoy
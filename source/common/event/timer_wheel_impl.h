@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+#include "common/common/non_copyable.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A hierarchical timing wheel, which runs any number of timers with a single timer of the
+ * dispatcher. Arming and disarming a timer of the wheel take constant time, where libevent keeps
+ * its timers in a heap.
+ *
+ * The slots of level 0 hold the timers expiring in each of the next SlotsPerLevel ticks. Each slot
+ * of level L holds the timers expiring in a range of SlotsPerLevel^L ticks, which are moved to the
+ * lower levels ("cascaded") when the wheel reaches the start of the range. The deadlines beyond the
+ * top level (49 days with a tick of 1ms) are cascaded again until they are in range. The timers
+ * keep their exact deadline: the tick only bounds the number of timers the wheel looks at to find
+ * the next deadline, and the number of wakeups to cascade the timers of the higher levels.
+ */
+class TimerWheel : NonCopyable {
+public:
+  /**
+   * @param dispatcher supplies the dispatcher the timers run on.
+   * @param tick supplies the granularity of the wheel.
+   */
+  TimerWheel(Dispatcher& dispatcher, std::chrono::milliseconds tick);
+  ~TimerWheel();
+
+  /**
+   * Allocates a timer of the wheel. The timer must not outlive the wheel.
+   * @param cb supplies the callback to invoke when the timer fires.
+   */
+  TimerPtr createTimer(TimerCb cb);
+
+  /**
+   * @return the number of enabled timers.
+   */
+  uint64_t size() const { return num_timers_; }
+
+private:
+  class TimerImpl;
+
+  static constexpr uint32_t BitsPerLevel = 8;
+  static constexpr uint32_t SlotsPerLevel = 1 << BitsPerLevel;
+  static constexpr uint32_t Levels = 4;
+  static constexpr uint32_t WordsPerLevel = SlotsPerLevel / 64;
+  // The level of the timers about to fire, which may disable each other as they do.
+  static constexpr uint32_t ExpiringLevel = Levels;
+  // The level of the disabled timers.
+  static constexpr uint32_t NoLevel = Levels + 1;
+
+  // The timers of a slot, in an intrusive doubly linked list.
+  struct Slot {
+    TimerImpl* head_{};
+    TimerImpl* tail_{};
+  };
+
+  struct Level {
+    std::array<Slot, SlotsPerLevel> slots_;
+    // The bit of each non-empty slot.
+    std::array<uint64_t, WordsPerLevel> occupied_{};
+  };
+
+  uint64_t ticksAt(MonotonicTime time) const;
+  MonotonicTime tickTime(uint64_t tick) const { return start_ + tick_ * tick; }
+  void enable(TimerImpl& timer, std::chrono::microseconds duration);
+  Slot& slotOf(const TimerImpl& timer);
+  void link(TimerImpl& timer, uint32_t level, uint32_t index);
+  void unlink(TimerImpl& timer);
+  // Adds the timer to the slot of its deadline, relative to the current tick.
+  void insert(TimerImpl& timer);
+  void remove(TimerImpl& timer);
+  // Moves the timers of the current slot of the level to the lower levels.
+  void cascade(uint32_t level);
+  // Fires the timers of the slot of the current tick whose deadline is at or before the limit.
+  void expire(MonotonicTime limit);
+  // Advances the wheel to the current time, and fires the expired timers.
+  void onTimer();
+  // @return the tick at which the wheel reaches the slot of the level, offset slots after the
+  //         current one.
+  uint64_t slotTick(uint32_t level, uint32_t offset) const;
+  // @return the first tick after the current one at which the wheel has a timer to fire or to
+  //         cascade, or UINT64_MAX.
+  uint64_t nextWakeupTick() const;
+  // @return the offset of the first non-empty slot of the level among the SlotsPerLevel slots
+  //         starting first slots after the current one, wrapping around.
+  absl::optional<uint32_t> nextOccupiedOffset(uint32_t level, uint32_t first) const;
+  // Arms timer_ for the next deadline, or the next cascade.
+  void armNext();
+  void armAt(MonotonicTime time);
+
+  Dispatcher& dispatcher_;
+  const MonotonicTime::duration tick_;
+  const MonotonicTime start_;
+  const TimerPtr timer_;
+  std::array<Level, Levels> levels_;
+  Slot expiring_;
+  // The timers of expire() to move to expiring_, kept to reuse its storage.
+  std::vector<TimerImpl*> expired_;
+  // The tick the wheel is at. The slots of the previous ticks are empty.
+  uint64_t current_tick_{};
+  // The time timer_ is armed for, or MonotonicTime::max().
+  MonotonicTime armed_time_{MonotonicTime::max()};
+  uint64_t num_timers_{};
+};
+
+} // namespace Event
+} // namespace Envoy
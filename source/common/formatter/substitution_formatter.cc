@@ -1,7 +1,9 @@
 #include "common/formatter/substitution_formatter.h"
 
 #include <climits>
+#include <cmath>
 #include <cstdint>
+#include <iterator>
 #include <regex>
 #include <string>
 #include <vector>
@@ -24,6 +26,7 @@
 #include "common/runtime/runtime_features.h"
 #include "common/stream_info/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "fmt/format.h"
 
@@ -52,6 +55,118 @@ const std::regex& getSystemTimeFormatNewlinePattern() {
 }
 const std::regex& getNewlinePattern() { CONSTRUCT_ON_FIRST_USE(std::regex, "\n"); }
 
+// Guess of the size of a substituted value, used to size the output of FormatterImpl::format().
+constexpr size_t EstimatedSubstitutionSize = 16;
+
+// Appends str to output with the characters that JSON strings can't contain escaped.
+void appendJsonEscaped(absl::string_view str, std::string& output) {
+  static constexpr absl::string_view HexDigits = "0123456789abcdef";
+  // Runs of characters that need no escaping are appended at once.
+  size_t run_start = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    const unsigned char c = str[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    output.append(str.data() + run_start, i - run_start);
+    run_start = i + 1;
+    switch (c) {
+    case '"':
+      output.append("\\\"");
+      break;
+    case '\\':
+      output.append("\\\\");
+      break;
+    case '\b':
+      output.append("\\b");
+      break;
+    case '\f':
+      output.append("\\f");
+      break;
+    case '\n':
+      output.append("\\n");
+      break;
+    case '\r':
+      output.append("\\r");
+      break;
+    case '\t':
+      output.append("\\t");
+      break;
+    default:
+      output.append("\\u00");
+      output.push_back(HexDigits[c >> 4]);
+      output.push_back(HexDigits[c & 0xf]);
+      break;
+    }
+  }
+  output.append(str.data() + run_start, str.size() - run_start);
+}
+
+void appendJsonString(absl::string_view str, std::string& output) {
+  output.push_back('"');
+  appendJsonEscaped(str, output);
+  output.push_back('"');
+}
+
+void appendJsonNumber(double number, std::string& output) {
+  if (!std::isfinite(number)) {
+    // JSON can't represent these.
+    output.append("null");
+    return;
+  }
+  // Integers below 10^15 are printed in full, as the protobuf JSON serializer does.
+  if (std::abs(number) < 1e15 && number == std::trunc(number)) {
+    absl::StrAppend(&output, static_cast<int64_t>(number));
+    return;
+  }
+  fmt::format_to(std::back_inserter(output), "{}", number);
+}
+
+void appendJsonProtoValue(const ProtobufWkt::Value& value, std::string& output) {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(value.string_value(), output);
+    break;
+  case ProtobufWkt::Value::kNumberValue:
+    appendJsonNumber(value.number_value(), output);
+    break;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    break;
+  case ProtobufWkt::Value::kStructValue: {
+    output.push_back('{');
+    bool first = true;
+    for (const auto& field : value.struct_value().fields()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonString(field.first, output);
+      output.push_back(':');
+      appendJsonProtoValue(field.second, output);
+    }
+    output.push_back('}');
+    break;
+  }
+  case ProtobufWkt::Value::kListValue: {
+    output.push_back('[');
+    bool first = true;
+    for (const auto& element : value.list_value().values()) {
+      if (!first) {
+        output.push_back(',');
+      }
+      first = false;
+      appendJsonProtoValue(element, output);
+    }
+    output.push_back(']');
+    break;
+  }
+  default:
+    output.append("null");
+    break;
+  }
+}
+
 } // namespace
 
 const std::string SubstitutionFormatUtils::DEFAULT_FORMAT =
@@ -111,12 +226,28 @@ const std::string SubstitutionFormatUtils::getHostnameOrDefault() {
 FormatterImpl::FormatterImpl(const std::string& format, bool omit_empty_values)
     : empty_value_string_(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueString) {
   providers_ = SubstitutionFormatParser::parse(format);
+  compile();
 }
 
 FormatterImpl::FormatterImpl(const std::string& format, bool omit_empty_values,
                              const std::vector<CommandParserPtr>& command_parsers)
     : empty_value_string_(omit_empty_values ? EMPTY_STRING : DefaultUnspecifiedValueString) {
   providers_ = SubstitutionFormatParser::parse(format, command_parsers);
+  compile();
+}
+
+void FormatterImpl::compile() {
+  literals_.reserve(providers_.size());
+  for (const FormatterProviderPtr& provider : providers_) {
+    const auto* literal = dynamic_cast<const PlainStringFormatter*>(provider.get());
+    if (literal != nullptr) {
+      literals_.emplace_back(literal->str());
+      estimated_size_ += literal->str().size();
+    } else {
+      literals_.emplace_back(absl::nullopt);
+      estimated_size_ += EstimatedSubstitutionSize;
+    }
+  }
 }
 
 std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
@@ -125,22 +256,47 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info,
                                   absl::string_view local_reply_body) const {
   std::string log_line;
-  log_line.reserve(256);
+  log_line.reserve(estimated_size_);
 
-  for (const FormatterProviderPtr& provider : providers_) {
-    const auto bit = provider->format(request_headers, response_headers, response_trailers,
-                                      stream_info, local_reply_body);
-    log_line += bit.value_or(empty_value_string_);
+  for (size_t i = 0; i < providers_.size(); ++i) {
+    if (literals_[i].has_value()) {
+      log_line.append(literals_[i]->data(), literals_[i]->size());
+      continue;
+    }
+    const auto bit = providers_[i]->format(request_headers, response_headers, response_trailers,
+                                           stream_info, local_reply_body);
+    log_line += bit.has_value() ? *bit : empty_value_string_;
   }
 
   return log_line;
 }
 
+JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping,
+                                     bool preserve_types, bool omit_empty_values)
+    : struct_formatter_(format_mapping, preserve_types, omit_empty_values),
+      stream_json_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.stream_json_access_log_formatter")) {}
+
+JsonFormatterImpl::JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping,
+                                     bool preserve_types, bool omit_empty_values,
+                                     const std::vector<CommandParserPtr>& commands)
+    : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands),
+      stream_json_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.stream_json_access_log_formatter")) {}
+
 std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                       const Http::ResponseHeaderMap& response_headers,
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       absl::string_view local_reply_body) const {
+  if (stream_json_) {
+    std::string log_line;
+    struct_formatter_.formatJson(request_headers, response_headers, response_trailers, stream_info,
+                                 local_reply_body, log_line);
+    log_line.push_back('\n');
+    return log_line;
+  }
+
   const ProtobufWkt::Struct output_struct = struct_formatter_.format(
       request_headers, response_headers, response_trailers, stream_info, local_reply_body);
 
@@ -298,6 +454,109 @@ ProtobufWkt::Struct StructFormatter::format(const Http::RequestHeaderMap& reques
   return structFormatMapCallback(struct_output_format_, visitor).struct_value();
 }
 
+void StructFormatter::formatJson(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 absl::string_view local_reply_body, std::string& output) const {
+  const FormatContext context{request_headers, response_headers, response_trailers, stream_info,
+                              local_reply_body};
+  appendJsonMap(struct_output_format_, context, output);
+}
+
+bool StructFormatter::appendJsonValue(const StructFormatValue& format_value,
+                                      const FormatContext& context, std::string& output) const {
+  if (const auto* providers = absl::get_if<const std::vector<FormatterProviderPtr>>(&format_value);
+      providers != nullptr) {
+    return appendJsonProviders(*providers, context, output);
+  }
+  if (const auto* format_map = absl::get_if<const StructFormatMapWrapper>(&format_value);
+      format_map != nullptr) {
+    appendJsonMap(*format_map, context, output);
+    return true;
+  }
+  appendJsonList(absl::get<const StructFormatListWrapper>(format_value), context, output);
+  return true;
+}
+
+// Mirrors providersCallback().
+bool StructFormatter::appendJsonProviders(const std::vector<FormatterProviderPtr>& providers,
+                                          const FormatContext& context,
+                                          std::string& output) const {
+  ASSERT(!providers.empty());
+  if (providers.size() == 1) {
+    const auto& provider = providers.front();
+    if (preserve_types_) {
+      const ProtobufWkt::Value value = provider->formatValue(
+          context.request_headers_, context.response_headers_, context.response_trailers_,
+          context.stream_info_, context.local_reply_body_);
+      if (omit_empty_values_ && value.kind_case() == ProtobufWkt::Value::kNullValue) {
+        return false;
+      }
+      appendJsonProtoValue(value, output);
+      return true;
+    }
+
+    const auto str = provider->format(context.request_headers_, context.response_headers_,
+                                      context.response_trailers_, context.stream_info_,
+                                      context.local_reply_body_);
+    if (!str.has_value() && omit_empty_values_) {
+      return false;
+    }
+    appendJsonString(str.has_value() ? *str : DefaultUnspecifiedValueString, output);
+    return true;
+  }
+  // Multiple providers forces string output.
+  output.push_back('"');
+  for (const auto& provider : providers) {
+    const auto bit = provider->format(context.request_headers_, context.response_headers_,
+                                      context.response_trailers_, context.stream_info_,
+                                      context.local_reply_body_);
+    appendJsonEscaped(bit.has_value() ? *bit : empty_value_, output);
+  }
+  output.push_back('"');
+  return true;
+}
+
+void StructFormatter::appendJsonMap(const StructFormatMapWrapper& format_map,
+                                    const FormatContext& context, std::string& output) const {
+  output.push_back('{');
+  bool first = true;
+  for (const auto& pair : *format_map.value_) {
+    // The key is written before the value is known, and dropped again if the value is omitted.
+    const size_t field_start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    appendJsonString(pair.first, output);
+    output.push_back(':');
+    if (appendJsonValue(pair.second, context, output)) {
+      first = false;
+    } else {
+      output.resize(field_start);
+    }
+  }
+  output.push_back('}');
+}
+
+void StructFormatter::appendJsonList(const StructFormatListWrapper& format_list,
+                                     const FormatContext& context, std::string& output) const {
+  output.push_back('[');
+  bool first = true;
+  for (const auto& value : *format_list.value_) {
+    const size_t element_start = output.size();
+    if (!first) {
+      output.push_back(',');
+    }
+    if (appendJsonValue(value, context, output)) {
+      first = false;
+    } else {
+      output.resize(element_start);
+    }
+  }
+  output.push_back(']');
+}
+
 void SubstitutionFormatParser::parseCommandHeader(const std::string& token, const size_t start,
                                                   std::string& main_header,
                                                   std::string& alternative_header,
@@ -1162,12 +1421,25 @@ MetadataFormatter::MetadataFormatter(const std::string& filter_namespace,
 
 absl::optional<std::string>
 MetadataFormatter::formatMetadata(const envoy::config::core::v3::Metadata& metadata) const {
-  ProtobufWkt::Value value = formatMetadataValue(metadata);
-  if (value.kind_case() == ProtobufWkt::Value::kNullValue) {
-    return absl::nullopt;
+  // The metadata is serialized where it is, rather than copied into a value first. A struct has
+  // the same JSON representation as a value holding it.
+  const Protobuf::Message* message;
+  if (path_.empty()) {
+    const auto filter_it = metadata.filter_metadata().find(filter_namespace_);
+    if (filter_it == metadata.filter_metadata().end()) {
+      return absl::nullopt;
+    }
+    message = &filter_it->second;
+  } else {
+    const ProtobufWkt::Value& val = Metadata::metadataValue(&metadata, filter_namespace_, path_);
+    if (val.kind_case() == ProtobufWkt::Value::KindCase::KIND_NOT_SET ||
+        val.kind_case() == ProtobufWkt::Value::kNullValue) {
+      return absl::nullopt;
+    }
+    message = &val;
   }
 
-  std::string json = MessageUtil::getJsonStringFromMessageOrDie(value, false, true);
+  std::string json = MessageUtil::getJsonStringFromMessageOrDie(*message, false, true);
   truncate(json, max_length_);
   return json;
 }
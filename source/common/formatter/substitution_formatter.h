@@ -119,8 +119,16 @@ public:
                      absl::string_view local_reply_body) const override;
 
 private:
+  void compile();
+
   const std::string& empty_value_string_;
   std::vector<FormatterProviderPtr> providers_;
+  // The text of each provider that is a literal, so that literals are appended without a virtual
+  // call and a copy.
+  std::vector<absl::optional<absl::string_view>> literals_;
+  // Initial capacity of the formatted string: the size of the literals plus a guess for each
+  // substituted value.
+  size_t estimated_size_{};
 };
 
 // Helper classes for StructFormatter::StructFormatMapVisitor.
@@ -144,6 +152,16 @@ public:
                              const StreamInfo::StreamInfo& stream_info,
                              absl::string_view local_reply_body) const;
 
+  /**
+   * Appends the formatted log entry to output as a JSON object, without building a Struct. The
+   * object has the same content as the JSON serialization of format()'s result.
+   */
+  void formatJson(const Http::RequestHeaderMap& request_headers,
+                  const Http::ResponseHeaderMap& response_headers,
+                  const Http::ResponseTrailerMap& response_trailers,
+                  const StreamInfo::StreamInfo& stream_info, absl::string_view local_reply_body,
+                  std::string& output) const;
+
 private:
   struct StructFormatMapWrapper;
   struct StructFormatListWrapper;
@@ -198,6 +216,24 @@ private:
   structFormatListCallback(const StructFormatter::StructFormatListWrapper& format_list,
                            const StructFormatMapVisitor& visitor) const;
 
+  // Methods for streaming JSON output.
+  struct FormatContext {
+    const Http::RequestHeaderMap& request_headers_;
+    const Http::ResponseHeaderMap& response_headers_;
+    const Http::ResponseTrailerMap& response_trailers_;
+    const StreamInfo::StreamInfo& stream_info_;
+    absl::string_view local_reply_body_;
+  };
+  // Returns false, without appending anything, if the value is omitted because it is empty.
+  bool appendJsonValue(const StructFormatValue& format_value, const FormatContext& context,
+                       std::string& output) const;
+  bool appendJsonProviders(const std::vector<FormatterProviderPtr>& providers,
+                           const FormatContext& context, std::string& output) const;
+  void appendJsonMap(const StructFormatMapWrapper& format_map, const FormatContext& context,
+                     std::string& output) const;
+  void appendJsonList(const StructFormatListWrapper& format_list, const FormatContext& context,
+                      std::string& output) const;
+
   const bool omit_empty_values_;
   const bool preserve_types_;
   const std::string empty_value_;
@@ -210,11 +246,9 @@ using StructFormatterPtr = std::unique_ptr<StructFormatter>;
 class JsonFormatterImpl : public Formatter {
 public:
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
-                    bool omit_empty_values)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values) {}
+                    bool omit_empty_values);
   JsonFormatterImpl(const ProtobufWkt::Struct& format_mapping, bool preserve_types,
-                    bool omit_empty_values, const std::vector<CommandParserPtr>& commands)
-      : struct_formatter_(format_mapping, preserve_types, omit_empty_values, commands) {}
+                    bool omit_empty_values, const std::vector<CommandParserPtr>& commands);
 
   // Formatter::format
   std::string format(const Http::RequestHeaderMap& request_headers,
@@ -225,6 +259,8 @@ public:
 
 private:
   const StructFormatter struct_formatter_;
+  // Whether to write JSON directly rather than serializing a Struct.
+  const bool stream_json_;
 };
 
 /**
@@ -235,6 +271,8 @@ class PlainStringFormatter : public FormatterProvider {
 public:
   PlainStringFormatter(const std::string& str);
 
+  const std::string& str() const { return str_.string_value(); }
+
   // FormatterProvider
   absl::optional<std::string> format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
@@ -47,14 +47,26 @@ AsyncClientFactoryImpl::AsyncClientFactoryImpl(Upstream::ClusterManager& cm,
 
 AsyncClientManagerImpl::AsyncClientManagerImpl(Upstream::ClusterManager& cm,
                                                ThreadLocal::Instance& tls, TimeSource& time_source,
-                                               Api::Api& api, const StatNames& stat_names)
+                                               Api::Api& api, const StatNames& stat_names,
+                                               uint32_t google_grpc_completion_threads)
     : cm_(cm), tls_(tls), time_source_(time_source), api_(api), stat_names_(stat_names) {
 #ifdef ENVOY_GOOGLE_GRPC
+  for (uint32_t i = 0; i < google_grpc_completion_threads; ++i) {
+    google_completion_queues_.push_back(std::make_shared<GoogleCompletionQueue>(api));
+  }
   google_tls_slot_ = tls.allocateSlot();
-  google_tls_slot_->set(
-      [&api](Event::Dispatcher&) { return std::make_shared<GoogleAsyncClientThreadLocal>(api); });
+  google_tls_slot_->set([this, &api](Event::Dispatcher&) {
+    if (google_completion_queues_.empty()) {
+      return std::make_shared<GoogleAsyncClientThreadLocal>(api);
+    }
+    const uint32_t index =
+        next_google_completion_queue_.fetch_add(1, std::memory_order_relaxed) %
+        google_completion_queues_.size();
+    return std::make_shared<GoogleAsyncClientThreadLocal>(google_completion_queues_[index]);
+  });
 #else
   UNREFERENCED_PARAMETER(api_);
+  UNREFERENCED_PARAMETER(google_grpc_completion_threads);
 #endif
 }
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "envoy/api/api.h"
 #include "envoy/config/core/v3/grpc_service.pb.h"
 #include "envoy/grpc/async_client_manager.h"
@@ -45,10 +49,17 @@ private:
   const StatNames& stat_names_;
 };
 
+class GoogleCompletionQueue;
+
 class AsyncClientManagerImpl : public AsyncClientManager {
 public:
+  /**
+   * @param google_grpc_completion_threads supplies the number of completion threads shared by the
+   *        Google gRPC clients of all the threads, or 0 for one completion thread per thread.
+   */
   AsyncClientManagerImpl(Upstream::ClusterManager& cm, ThreadLocal::Instance& tls,
-                         TimeSource& time_source, Api::Api& api, const StatNames& stat_names);
+                         TimeSource& time_source, Api::Api& api, const StatNames& stat_names,
+                         uint32_t google_grpc_completion_threads);
 
   // Grpc::AsyncClientManager
   AsyncClientFactoryPtr factoryForGrpcService(const envoy::config::core::v3::GrpcService& config,
@@ -59,6 +70,9 @@ private:
   Upstream::ClusterManager& cm_;
   ThreadLocal::Instance& tls_;
   ThreadLocal::SlotPtr google_tls_slot_;
+  // The shared completion queues, assigned to the threads in turn.
+  std::vector<std::shared_ptr<GoogleCompletionQueue>> google_completion_queues_;
+  std::atomic<uint32_t> next_google_completion_queue_{};
   TimeSource& time_source_;
   Api::Api& api_;
   const StatNames& stat_names_;
@@ -1,11 +1,13 @@
 #include "common/grpc/codec.h"
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
 
 #include "absl/container/fixed_array.h"
 
@@ -33,15 +35,49 @@ void Encoder::prependFrameHeader(uint8_t flags, Buffer::Instance& buffer) {
 bool Decoder::decode(Buffer::Instance& input, std::vector<Frame>& output) {
   decoding_error_ = false;
   output_ = &output;
-  inspect(input);
-  output_ = nullptr;
-  if (decoding_error_) {
+  if (!HeaderChecker(state_, length_).valid(input)) {
+    // The frames up to the invalid one are copied out, so that the input is left unchanged.
+    inspect(input);
+    output_ = nullptr;
+    ASSERT(decoding_error_);
     return false;
   }
-  input.drain(input.length());
+  // The frame data is moved out of the input, so that the frames share its slices.
+  while (input.length() > 0) {
+    if (state_ == State::Data) {
+      const uint64_t length = std::min<uint64_t>(length_, input.length());
+      frame_.data_->move(input, length);
+      length_ -= length;
+      if (length_ == 0) {
+        frameDataEnd();
+        state_ = State::FhFlag;
+      }
+    } else {
+      const uint8_t c = input.peekBEInt<uint8_t>();
+      input.drain(1);
+      const bool valid = inspectHeader(c);
+      ASSERT(valid);
+    }
+  }
+  output_ = nullptr;
   return true;
 }
 
+Decoder::HeaderChecker::HeaderChecker(State state, uint32_t length) {
+  state_ = state;
+  length_ = length;
+}
+
+bool Decoder::HeaderChecker::valid(const Buffer::Instance& input) {
+  inspect(input);
+  return valid_;
+}
+
+bool Decoder::HeaderChecker::frameStart(uint8_t flags) {
+  valid_ = (flags & ~GRPC_FH_COMPRESSED) == 0;
+  return valid_;
+}
+
 bool Decoder::frameStart(uint8_t flags) {
   // Unsupported flags.
   if (flags & ~GRPC_FH_COMPRESSED) {
@@ -66,54 +102,55 @@ void Decoder::frameDataEnd() {
   frame_.data_ = nullptr;
 }
 
+bool FrameInspector::inspectHeader(uint8_t c) {
+  switch (state_) {
+  case State::FhFlag:
+    if (!frameStart(c)) {
+      return false;
+    }
+    count_ += 1;
+    state_ = State::FhLen0;
+    break;
+  case State::FhLen0:
+    length_ = static_cast<uint32_t>(c) << 24;
+    state_ = State::FhLen1;
+    break;
+  case State::FhLen1:
+    length_ |= static_cast<uint32_t>(c) << 16;
+    state_ = State::FhLen2;
+    break;
+  case State::FhLen2:
+    length_ |= static_cast<uint32_t>(c) << 8;
+    state_ = State::FhLen3;
+    break;
+  case State::FhLen3:
+    length_ |= static_cast<uint32_t>(c);
+    frameDataStart();
+    if (length_ == 0) {
+      frameDataEnd();
+      state_ = State::FhFlag;
+    } else {
+      state_ = State::Data;
+    }
+    break;
+  case State::Data:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+  return true;
+}
+
 uint64_t FrameInspector::inspect(const Buffer::Instance& data) {
-  uint64_t delta = 0;
+  const uint64_t count = count_;
   for (const Buffer::RawSlice& slice : data.getRawSlices()) {
     uint8_t* mem = reinterpret_cast<uint8_t*>(slice.mem_);
     for (uint64_t j = 0; j < slice.len_;) {
-      uint8_t c = *mem;
-      switch (state_) {
-      case State::FhFlag:
-        if (!frameStart(c)) {
-          return delta;
-        }
-        count_ += 1;
-        delta += 1;
-        state_ = State::FhLen0;
-        mem++;
-        j++;
-        break;
-      case State::FhLen0:
-        length_ = static_cast<uint32_t>(c) << 24;
-        state_ = State::FhLen1;
-        mem++;
-        j++;
-        break;
-      case State::FhLen1:
-        length_ |= static_cast<uint32_t>(c) << 16;
-        state_ = State::FhLen2;
-        mem++;
-        j++;
-        break;
-      case State::FhLen2:
-        length_ |= static_cast<uint32_t>(c) << 8;
-        state_ = State::FhLen3;
-        mem++;
-        j++;
-        break;
-      case State::FhLen3:
-        length_ |= static_cast<uint32_t>(c);
-        frameDataStart();
-        if (length_ == 0) {
-          frameDataEnd();
-          state_ = State::FhFlag;
-        } else {
-          state_ = State::Data;
+      if (state_ != State::Data) {
+        if (!inspectHeader(*mem)) {
+          return count_ - count;
         }
         mem++;
         j++;
-        break;
-      case State::Data:
+      } else {
         uint64_t remain_in_buffer = slice.len_ - j;
         if (remain_in_buffer <= length_) {
           frameData(mem, remain_in_buffer);
@@ -130,11 +167,10 @@ uint64_t FrameInspector::inspect(const Buffer::Instance& data) {
           frameDataEnd();
           state_ = State::FhFlag;
         }
-        break;
       }
     }
   }
-  return delta;
+  return count_ - count;
 }
 
 } // namespace Grpc
@@ -90,6 +90,9 @@ public:
   virtual ~FrameInspector() = default;
 
 protected:
+  // Inspects a byte of the frame header, returning false if frameStart returned false.
+  bool inspectHeader(uint8_t c);
+
   virtual bool frameStart(uint8_t) { return true; }
   virtual void frameDataStart() {}
   virtual void frameData(uint8_t*, uint64_t) {}
@@ -103,7 +106,8 @@ protected:
 class Decoder : public FrameInspector {
 public:
   // Decodes the given buffer with GRPC data frame. Drains the input buffer when
-  // decoding succeeded (returns true). If the input is not sufficient to make a
+  // decoding succeeded (returns true), moving its slices into the data of the
+  // frames rather than copying them. If the input is not sufficient to make a
   // complete GRPC data frame, it will be buffered in the decoder. If a decoding
   // error happened, the input buffer remains unchanged.
   // @param input supplies the binary octets wrapped in a GRPC data frame.
@@ -126,6 +130,19 @@ protected:
   void frameDataEnd() override;
 
 private:
+  // Checks the flags of the frame headers of the input, starting from the state of the decoder.
+  class HeaderChecker : public FrameInspector {
+  public:
+    HeaderChecker(State state, uint32_t length);
+    bool valid(const Buffer::Instance& input);
+
+  protected:
+    bool frameStart(uint8_t flags) override;
+
+  private:
+    bool valid_{true};
+  };
+
   Frame frame_;
   std::vector<Frame>* output_{nullptr};
   bool decoding_error_{false};
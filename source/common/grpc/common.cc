@@ -15,6 +15,7 @@
 #include "common/common/macros.h"
 #include "common/common/safe_memcpy.h"
 #include "common/common/utility.h"
+#include "common/grpc/codec.h"
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
@@ -149,13 +150,17 @@ Buffer::InstancePtr Common::serializeToGrpcFrame(const Protobuf::Message& messag
 Buffer::InstancePtr Common::serializeMessage(const Protobuf::Message& message) {
   auto body = std::make_unique<Buffer::OwnedImpl>();
   const uint32_t size = message.ByteSize();
-  auto reservation = body->reserveSingleSlice(size);
-  ASSERT(reservation.slice().len_ >= size);
-  uint8_t* current = reinterpret_cast<uint8_t*>(reservation.slice().mem_);
+  // Leave room for the 5 byte header in front of the message, so that prependGrpcFrameHeader()
+  // writes it into the same slice instead of adding one.
+  const uint32_t alloc_size = size + GRPC_FRAME_HEADER_SIZE;
+  auto reservation = body->reserveSingleSlice(alloc_size);
+  ASSERT(reservation.slice().len_ >= alloc_size);
+  uint8_t* current = reinterpret_cast<uint8_t*>(reservation.slice().mem_) + GRPC_FRAME_HEADER_SIZE;
   Protobuf::io::ArrayOutputStream stream(current, size, -1);
   Protobuf::io::CodedOutputStream codec_stream(&stream);
   message.SerializeWithCachedSizes(&codec_stream);
-  reservation.commit(size);
+  reservation.commit(alloc_size);
+  body->drain(GRPC_FRAME_HEADER_SIZE);
   return body;
 }
 
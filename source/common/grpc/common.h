@@ -119,7 +119,8 @@ public:
   static Buffer::InstancePtr serializeToGrpcFrame(const Protobuf::Message& message);
 
   /**
-   * Serialize protobuf message. Without grpc header.
+   * Serialize protobuf message. Without grpc header, which prependGrpcFrameHeader() can add to the
+   * front of the slice of the message without copying it.
    */
   static Buffer::InstancePtr serializeMessage(const Protobuf::Message& message);
 
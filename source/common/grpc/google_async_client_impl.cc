@@ -1,5 +1,7 @@
 #include "common/grpc/google_async_client_impl.h"
 
+#include <algorithm>
+
 #include "envoy/config/core/v3/grpc_service.pb.h"
 #include "envoy/stats/scope.h"
 
@@ -13,6 +15,7 @@
 #include "common/router/header_parser.h"
 #include "common/tracing/http_tracer_impl.h"
 
+#include "absl/container/inlined_vector.h"
 #include "grpcpp/support/proto_buffer_reader.h"
 
 namespace Envoy {
@@ -21,58 +24,118 @@ namespace {
 static constexpr int DefaultBufferLimitBytes = 1024 * 1024;
 }
 
-GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api)
+GoogleCompletionQueue::GoogleCompletionQueue(Api::Api& api)
     : completion_thread_(api.threadFactory().createThread([this] { completionThread(); },
                                                           Thread::Options{"GrpcGoogClient"})) {}
 
-GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
-  // Force streams to shutdown and invoke TryCancel() to start the drain of
-  // pending op. If we don't do this, Shutdown() below can jam on pending ops.
-  // This is also required to satisfy the contract that once Shutdown is called,
-  // streams no longer queue any additional tags.
-  for (auto it = streams_.begin(); it != streams_.end();) {
-    // resetStream() may result in immediate unregisterStream() and erase(),
-    // which would invalidate the iterator for the current element, so make sure
-    // we point to the next one first.
-    (*it++)->resetStream();
-  }
+GoogleCompletionQueue::~GoogleCompletionQueue() {
+  // All the streams using the queue drained their ops before their thread local released it.
   cq_.Shutdown();
   ENVOY_LOG(debug, "Joining completionThread");
   completion_thread_->join();
   ENVOY_LOG(debug, "Joined completionThread");
-  // Ensure that we have cleaned up all orphan streams, now that CQ is gone.
-  while (!streams_.empty()) {
-    (*streams_.begin())->onCompletedOps();
+}
+
+uint64_t GoogleCompletionQueue::events() {
+  Thread::LockGuard lock(events_lock_);
+  return events_;
+}
+
+void GoogleCompletionQueue::waitForEvents(uint64_t events) {
+  Thread::LockGuard lock(events_lock_);
+  while (events_ <= events) {
+    events_cond_.wait(events_lock_);
   }
 }
 
-void GoogleAsyncClientThreadLocal::completionThread() {
+void GoogleCompletionQueue::completionThread() {
   ENVOY_LOG(debug, "completionThread running");
   void* tag;
   bool ok;
   while (cq_.Next(&tag, &ok)) {
-    const auto& google_async_tag = *reinterpret_cast<GoogleAsyncTag*>(tag);
-    const GoogleAsyncTag::Operation op = google_async_tag.op_;
-    GoogleAsyncStreamImpl& stream = google_async_tag.stream_;
-    ENVOY_LOG(trace, "completionThread CQ event {} {}", op, ok);
-    Thread::LockGuard lock(stream.completed_ops_lock_);
-
-    // It's an invariant that there must only be one pending post for arbitrary
-    // length completed_ops_, otherwise we can race in stream destruction, where
-    // we process multiple events in onCompletedOps() but have only partially
-    // consumed the posts on the dispatcher.
-    // TODO(htuch): This may result in unbounded processing on the silo thread
-    // in onCompletedOps() in extreme cases, when we emplace_back() in
-    // completionThread() at a high rate, consider bounding the length of such
-    // sequences if this behavior becomes an issue.
-    if (stream.completed_ops_.empty()) {
-      stream.dispatcher_.post([&stream] { stream.onCompletedOps(); });
+    // The streams with new completed ops, by dispatcher, so that each dispatcher gets a single
+    // post for the events ready at once.
+    absl::InlinedVector<std::pair<Event::Dispatcher*, std::vector<GoogleAsyncStreamImpl*>>, 4>
+        posts;
+    uint32_t batch_size = 0;
+    do {
+      const auto& google_async_tag = *reinterpret_cast<GoogleAsyncTag*>(tag);
+      const GoogleAsyncTag::Operation op = google_async_tag.op_;
+      GoogleAsyncStreamImpl& stream = google_async_tag.stream_;
+      ENVOY_LOG(trace, "completionThread CQ event {} {}", op, ok);
+      Thread::LockGuard lock(stream.completed_ops_lock_);
+
+      // It's an invariant that there must only be one pending post for arbitrary
+      // length completed_ops_, otherwise we can race in stream destruction, where
+      // we process multiple events in onCompletedOps() but have only partially
+      // consumed the posts on the dispatcher.
+      // TODO(htuch): This may result in unbounded processing on the silo thread
+      // in onCompletedOps() in extreme cases, when we emplace_back() in
+      // completionThread() at a high rate, consider bounding the length of such
+      // sequences if this behavior becomes an issue.
+      if (stream.completed_ops_.empty()) {
+        auto it = std::find_if(posts.begin(), posts.end(), [&stream](const auto& post) {
+          return post.first == &stream.dispatcher_;
+        });
+        if (it == posts.end()) {
+          it = posts.emplace(posts.end(), &stream.dispatcher_,
+                             std::vector<GoogleAsyncStreamImpl*>());
+        }
+        it->second.push_back(&stream);
+      }
+      stream.completed_ops_.emplace_back(op, ok);
+    } while (++batch_size < MaxBatchSize &&
+             cq_.AsyncNext(&tag, &ok, gpr_time_0(GPR_CLOCK_REALTIME)) ==
+                 grpc::CompletionQueue::GOT_EVENT);
+
+    for (auto& post : posts) {
+      post.first->post([streams = std::move(post.second)] {
+        for (GoogleAsyncStreamImpl* stream : streams) {
+          stream->onCompletedOps();
+        }
+      });
     }
-    stream.completed_ops_.emplace_back(op, ok);
+    {
+      Thread::LockGuard lock(events_lock_);
+      events_ += batch_size;
+    }
+    events_cond_.notifyAll();
   }
   ENVOY_LOG(debug, "completionThread exiting");
 }
 
+GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(Api::Api& api)
+    : GoogleAsyncClientThreadLocal(std::make_shared<GoogleCompletionQueue>(api)) {}
+
+GoogleAsyncClientThreadLocal::GoogleAsyncClientThreadLocal(GoogleCompletionQueueSharedPtr queue)
+    : queue_(std::move(queue)) {}
+
+GoogleAsyncClientThreadLocal::~GoogleAsyncClientThreadLocal() {
+  // Force streams to shutdown and invoke TryCancel() to start the drain of
+  // pending op. If we don't do this, the queue shutdown can jam on pending ops.
+  // This is also required to satisfy the contract that once Shutdown is called,
+  // streams no longer queue any additional tags.
+  for (auto it = streams_.begin(); it != streams_.end();) {
+    // resetStream() may result in immediate unregisterStream() and erase(),
+    // which would invalidate the iterator for the current element, so make sure
+    // we point to the next one first.
+    (*it++)->resetStream();
+  }
+  // The queue may be shared with the other threads, so it keeps running: wait for the cancelled
+  // ops of the orphan streams to complete, and clean them up here since the posts to this thread's
+  // dispatcher won't run anymore.
+  while (!streams_.empty()) {
+    const uint64_t events = queue_->events();
+    for (auto it = streams_.begin(); it != streams_.end();) {
+      // onCompletedOps() may result in deferredDelete() and unregisterStream().
+      (*it++)->onCompletedOps();
+    }
+    if (!streams_.empty()) {
+      queue_->waitForEvents(events);
+    }
+  }
+}
+
 GoogleAsyncClientImpl::GoogleAsyncClientImpl(Event::Dispatcher& dispatcher,
                                              GoogleAsyncClientThreadLocal& tls,
                                              GoogleStubFactory& stub_factory,
@@ -66,26 +66,26 @@ struct GoogleAsyncTag {
   const Operation op_;
 };
 
-class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
-                                     Logger::Loggable<Logger::Id::grpc> {
+// A completion queue, and the thread blocking on it to deliver its events to the dispatchers of
+// their streams. A queue is either used by the clients of a single thread, or shared by the
+// clients of several threads when the completion threads are pooled.
+class GoogleCompletionQueue : Logger::Loggable<Logger::Id::grpc> {
 public:
-  GoogleAsyncClientThreadLocal(Api::Api& api);
-  ~GoogleAsyncClientThreadLocal() override;
+  GoogleCompletionQueue(Api::Api& api);
+  ~GoogleCompletionQueue();
 
   grpc::CompletionQueue& completionQueue() { return cq_; }
 
-  void registerStream(GoogleAsyncStreamImpl* stream) {
-    ASSERT(streams_.find(stream) == streams_.end());
-    streams_.insert(stream);
-  }
+  // Returns the number of events delivered so far.
+  uint64_t events();
 
-  void unregisterStream(GoogleAsyncStreamImpl* stream) {
-    auto it = streams_.find(stream);
-    ASSERT(it != streams_.end());
-    streams_.erase(it);
-  }
+  // Blocks until more events than the given number were delivered.
+  void waitForEvents(uint64_t events);
 
 private:
+  // The maximum number of ready events delivered at once, with a single post to each dispatcher.
+  static constexpr uint32_t MaxBatchSize = 64;
+
   void completionThread();
 
   // There is blanket google-grpc initialization in MainCommonBase, but that
@@ -99,16 +99,46 @@ private:
   // The CompletionQueue for in-flight operations. This must precede completion_thread_ to ensure it
   // is constructed before the thread runs.
   grpc::CompletionQueue cq_;
+  Thread::MutexBasicLockable events_lock_;
+  Thread::CondVar events_cond_;
+  uint64_t events_ ABSL_GUARDED_BY(events_lock_){};
   // The threading model for the Google gRPC C++ library is not directly compatible with Envoy's
   // siloed model. We resolve this by issuing non-blocking asynchronous
   // operations on the GoogleAsyncClientImpl silo thread, and then synchronously
   // blocking on a completion queue, cq_, on a distinct thread. When cq_ events
   // are delivered, we cross-post to the silo dispatcher to continue the
   // operation.
-  //
-  // We have an independent completion thread for each TLS silo (i.e. one per worker and
-  // also one for the main thread).
   Thread::ThreadPtr completion_thread_;
+};
+
+using GoogleCompletionQueueSharedPtr = std::shared_ptr<GoogleCompletionQueue>;
+
+class GoogleAsyncClientThreadLocal : public ThreadLocal::ThreadLocalObject,
+                                     Logger::Loggable<Logger::Id::grpc> {
+public:
+  // Uses a completion queue and thread of its own.
+  GoogleAsyncClientThreadLocal(Api::Api& api);
+  // Uses the given completion queue, which may be shared with other threads.
+  GoogleAsyncClientThreadLocal(GoogleCompletionQueueSharedPtr queue);
+  ~GoogleAsyncClientThreadLocal() override;
+
+  grpc::CompletionQueue& completionQueue() { return queue_->completionQueue(); }
+
+  void registerStream(GoogleAsyncStreamImpl* stream) {
+    ASSERT(streams_.find(stream) == streams_.end());
+    streams_.insert(stream);
+  }
+
+  void unregisterStream(GoogleAsyncStreamImpl* stream) {
+    auto it = streams_.find(stream);
+    ASSERT(it != streams_.end());
+    streams_.erase(it);
+  }
+
+private:
+  // Unless the completion threads are pooled, we have an independent completion queue and thread
+  // for each TLS silo (i.e. one per worker and also one for the main thread).
+  const GoogleCompletionQueueSharedPtr queue_;
   // Track all streams that are currently using this CQ, so we can notify them
   // on shutdown.
   absl::node_hash_set<GoogleAsyncStreamImpl*> streams_;
@@ -239,7 +269,7 @@ private:
   // GoogleAsyncClient silo thread.
   void onCompletedOps();
   // Handle Operation completion on GoogleAsyncClient silo thread. This is posted by
-  // GoogleAsyncClientThreadLocal::completionThread() when a message is received on cq_.
+  // GoogleCompletionQueue::completionThread() when a message is received on cq_.
   void handleOpCompletion(GoogleAsyncTag::Operation op, bool ok);
   // Convert from Google gRPC client std::multimap metadata to Envoy Http::HeaderMap.
   void metadataTranslate(const std::multimap<grpc::string_ref, grpc::string_ref>& grpc_metadata,
@@ -315,6 +345,7 @@ private:
 
   friend class GoogleAsyncClientImpl;
   friend class GoogleAsyncClientThreadLocal;
+  friend class GoogleCompletionQueue;
 };
 
 class GoogleAsyncRequestImpl : public AsyncRequest,
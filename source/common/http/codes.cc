@@ -206,6 +206,7 @@ const char* CodeUtility::toString(Code code) {
   // 1xx
   case Code::Continue:                      return "Continue";
   case Code::SwitchingProtocols:            return "Switching Protocols";
+  case Code::EarlyHints:                    return "Early Hints";
 
   // 2xx
   case Code::OK:                            return "OK";
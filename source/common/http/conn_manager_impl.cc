@@ -44,6 +44,7 @@
 #include "common/router/config_impl.h"
 #include "common/runtime/runtime_features.h"
 #include "common/stats/timespan_impl.h"
+#include "common/stats/utility.h"
 
 #include "absl/strings/escaping.h"
 #include "absl/strings/match.h"
@@ -244,6 +245,10 @@ void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
   stream.filter_manager_.log();
 
   stream.filter_manager_.destroyFilters();
+  if (stream.account_ != nullptr) {
+    // The buffers of the stream may outlive it, but the stream can no longer be reset.
+    stream.account_->clearDownstream();
+  }
 
   read_callbacks_->connection().dispatcher().deferredDelete(stream.removeFromList(streams_));
 
@@ -264,6 +269,13 @@ RequestDecoder& ConnectionManagerImpl::newStream(ResponseEncoder& response_encod
   new_stream->response_encoder_ = &response_encoder;
   new_stream->response_encoder_->getStream().addCallbacks(*new_stream);
   new_stream->response_encoder_->getStream().setFlushTimeout(new_stream->idle_timeout_ms_);
+  // The account is tracked by the watermark buffer factory of the worker, which resets the
+  // streams buffering the most memory under memory pressure.
+  new_stream->account_ = std::make_shared<Buffer::AggregatingMemoryAccount>(
+      read_callbacks_->connection().dispatcher().getWatermarkFactory().createAccount(
+          response_encoder.getStream()),
+      stats_.named_.downstream_rq_buffered_bytes_);
+  new_stream->response_encoder_->getStream().setAccount(new_stream->account_);
   // If the network connection is backed up, the stream should be made aware of it on creation.
   // Both HTTP/1.x and HTTP/2 codecs handle this in StreamCallbackHelper::addCallbacksHelper.
   ASSERT(read_callbacks_->connection().aboveHighWatermark() == false ||
@@ -349,6 +361,14 @@ Network::FilterStatus ConnectionManagerImpl::onData(Buffer::Instance& data, bool
   return Network::FilterStatus::StopIteration;
 }
 
+bool ConnectionManagerImpl::canHandOverConnection() const {
+  // An HTTP/1 connection between requests has no state the codec of another process would miss,
+  // unlike the streams and the header compression state of HTTP/2 and HTTP/3.
+  return streams_.empty() &&
+         (codec_ == nullptr || codec_->protocol() == Protocol::Http10 ||
+          codec_->protocol() == Protocol::Http11);
+}
+
 Network::FilterStatus ConnectionManagerImpl::onNewConnection() {
   if (!read_callbacks_->connection().streamInfo().protocol()) {
     // For Non-QUIC traffic, continue passing data to filters.
@@ -599,6 +619,12 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   filter_manager_.streamInfo().setRequestIDProvider(
       connection_manager.config_.requestIDExtension());
 
+  // The filters of a sample of the streams are timed, the sample rate being in parts per million.
+  if (connection_manager_.runtime_.snapshot().featureEnabled("http.filter_timing_sampled", 0,
+                                                              stream_id_, 1000000)) {
+    filter_manager_.enableFilterTiming();
+  }
+
   if (connection_manager_.config_.isRoutable() &&
       connection_manager.config_.routeConfigProvider() != nullptr) {
     route_config_update_requester_ =
@@ -640,8 +666,9 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
 
   if (connection_manager_.config_.requestTimeout().count()) {
     std::chrono::milliseconds request_timeout = connection_manager_.config_.requestTimeout();
-    request_timer_ = connection_manager.read_callbacks_->connection().dispatcher().createTimer(
-        [this]() -> void { onRequestTimeout(); });
+    request_timer_ =
+        connection_manager.read_callbacks_->connection().dispatcher().createWheelTimer(
+            [this]() -> void { onRequestTimeout(); });
     request_timer_->enableTimer(request_timeout, this);
   }
 
@@ -649,7 +676,7 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
     std::chrono::milliseconds request_headers_timeout =
         connection_manager_.config_.requestHeadersTimeout();
     request_header_timer_ =
-        connection_manager.read_callbacks_->connection().dispatcher().createTimer(
+        connection_manager.read_callbacks_->connection().dispatcher().createWheelTimer(
             [this]() -> void { onRequestHeaderTimeout(); });
     request_header_timer_->enableTimer(request_headers_timeout, this);
   }
@@ -657,7 +684,7 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   const auto max_stream_duration = connection_manager_.config_.maxStreamDuration();
   if (max_stream_duration.has_value() && max_stream_duration.value().count()) {
     max_stream_duration_timer_ =
-        connection_manager.read_callbacks_->connection().dispatcher().createTimer(
+        connection_manager.read_callbacks_->connection().dispatcher().createWheelTimer(
             [this]() -> void { onStreamMaxDurationReached(); });
     max_stream_duration_timer_->enableTimer(connection_manager_.config_.maxStreamDuration().value(),
                                             this);
@@ -706,6 +733,14 @@ void ConnectionManagerImpl::ActiveStream::completeRequest() {
   if (state_.successful_upgrade_) {
     connection_manager_.stats_.named_.downstream_cx_upgrades_active_.dec();
   }
+  for (const FilterTiming& timing : filter_manager_.filterTimings()) {
+    Stats::Utility::histogramFromElements(
+        connection_manager_.stats_.scope_,
+        {connection_manager_.stats_.prefixStatName(), Stats::DynamicName("filter"),
+         Stats::DynamicName(timing.config_name_), Stats::DynamicName("time_us")},
+        Stats::Histogram::Unit::Microseconds)
+        .recordValue(std::chrono::duration_cast<std::chrono::microseconds>(timing.time_).count());
+  }
 }
 
 void ConnectionManagerImpl::ActiveStream::resetIdleTimer() {
@@ -1336,6 +1371,22 @@ void ConnectionManagerImpl::ActiveStream::encode100ContinueHeaders(
   response_encoder_->encode100ContinueHeaders(response_headers);
 }
 
+void ConnectionManagerImpl::ActiveStream::encodeEarlyHintsHeaders(
+    ResponseHeaderMap& response_headers) {
+  // Informational responses must not be sent to HTTP/1.0 clients, see
+  // https://tools.ietf.org/html/rfc7231#section-6.2.
+  if (connection_manager_.codec_->protocol() == Protocol::Http10) {
+    return;
+  }
+
+  ConnectionManagerUtility::mutateResponseHeaders(response_headers, request_headers_.get(),
+                                                  connection_manager_.config_, EMPTY_STRING);
+  chargeStats(response_headers);
+
+  ENVOY_STREAM_LOG(debug, "encoding early hints headers via codec:\n{}", *this, response_headers);
+  response_encoder_->encode100ContinueHeaders(response_headers);
+}
+
 void ConnectionManagerImpl::ActiveStream::encodeHeaders(ResponseHeaderMap& headers,
                                                         bool end_stream) {
   // Base headers.
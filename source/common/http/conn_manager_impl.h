@@ -91,6 +91,7 @@ public:
   Network::FilterStatus onData(Buffer::Instance& data, bool end_stream) override;
   Network::FilterStatus onNewConnection() override;
   void initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) override;
+  bool canHandOverConnection() const override;
 
   // Http::ConnectionCallbacks
   void onGoAway(GoAwayErrorCode error_code) override;
@@ -212,6 +213,7 @@ private:
     // FilterManagerCallbacks
     void encodeHeaders(ResponseHeaderMap& response_headers, bool end_stream) override;
     void encode100ContinueHeaders(ResponseHeaderMap& response_headers) override;
+    void encodeEarlyHintsHeaders(ResponseHeaderMap& response_headers) override;
     void encodeData(Buffer::Instance& data, bool end_stream) override;
     void encodeTrailers(ResponseTrailerMap& trailers) override;
     void encodeMetadata(MetadataMapVector& metadata) override;
@@ -280,6 +282,7 @@ private:
     void onLocalReply(Code code) override;
     Tracing::Config& tracingConfig() override;
     const ScopeTrackedObject& scope() override;
+    Buffer::BufferMemoryAccountSharedPtr account() const override { return account_; }
 
     bool enableInternalRedirectsWithBody() const override {
       return connection_manager_.enable_internal_redirects_with_body_;
@@ -362,6 +365,8 @@ private:
     Router::ScopedConfigConstSharedPtr snapped_scoped_routes_config_;
     Tracing::SpanPtr active_span_;
     ResponseEncoder* response_encoder_{};
+    // The account charged with the memory buffered for the stream, by its codec and its filters.
+    Buffer::BufferMemoryAccountSharedPtr account_;
     Stats::TimespanPtr request_response_timespan_;
     // Per-stream idle timeout. This timer gets reset whenever activity occurs on the stream, and,
     // when triggered, will close the stream.
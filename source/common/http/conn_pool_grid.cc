@@ -50,6 +50,9 @@ void ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::onPoolFailu
     Upstream::HostDescriptionConstSharedPtr host) {
   ENVOY_LOG(trace, "{} pool failed to create connection to host '{}'.", describePool(pool()),
             parent_.grid_.host_->hostname());
+  if (parent_.grid_.isPoolHttp3(pool())) {
+    parent_.http3_attempt_failed_ = true;
+  }
   auto delete_this_on_return = removeFromList(parent_.connection_attempts_);
   // In the unlikely event the pool fails before the failover timer fires, try
   // to kick off another connection.
@@ -88,6 +91,13 @@ void ConnectivityGrid::WrapperCallbacks::ConnectionAttemptCallbacks::onPoolReady
     const StreamInfo::StreamInfo& info, absl::optional<Http::Protocol> protocol) {
   ENVOY_LOG(trace, "{} pool successfully connected to host '{}'.", describePool(pool()),
             parent_.grid_.host_->hostname());
+  if (parent_.grid_.isPoolHttp3(pool())) {
+    parent_.grid_.markHttp3Confirmed();
+  } else if (parent_.http3_attempt_failed_) {
+    // HTTP/3 failed where TCP worked: go straight to TCP for a while.
+    ENVOY_LOG(trace, "Marking HTTP/3 broken for host '{}'.", parent_.grid_.host_->hostname());
+    parent_.grid_.markHttp3Broken();
+  }
   auto delete_parent_on_return = removeFromList(parent_.connection_attempts_);
   // The first successful connection is passed up, and all others will be canceled.
   for (auto& attempt : parent_.connection_attempts_) {
@@ -128,7 +138,8 @@ ConnectivityGrid::ConnectivityGrid(
     std::chrono::milliseconds next_attempt_duration, ConnectivityOptions connectivity_options)
     : dispatcher_(dispatcher), random_generator_(random_generator), host_(host),
       priority_(priority), options_(options), transport_socket_options_(transport_socket_options),
-      state_(state), next_attempt_duration_(next_attempt_duration), time_source_(time_source) {
+      state_(state), next_attempt_duration_(next_attempt_duration), time_source_(time_source),
+      http3_status_tracker_(dispatcher_) {
   // TODO(#15649) support v6/v4, WiFi/cellular.
   ASSERT(connectivity_options.protocols_.size() == 3);
   ASSERT(contains(connectivity_options.protocols_,
@@ -178,10 +189,16 @@ ConnectionPool::Cancellable* ConnectivityGrid::newStream(Http::ResponseDecoder&
     createNextPool();
   }
 
-  // TODO(#15649) track pools with successful connections: don't always start at
-  // the front of the list.
-  auto wrapped_callback =
-      std::make_unique<WrapperCallbacks>(*this, decoder, pools_.begin(), callbacks);
+  PoolIterator pool = pools_.begin();
+  if (isHttp3Broken()) {
+    ENVOY_LOG(trace, "HTTP/3 is broken to host '{}', skipping.", host_->hostname());
+    const absl::optional<PoolIterator> next_pool = nextPool(pool);
+    if (next_pool.has_value()) {
+      pool = next_pool.value();
+    }
+  }
+
+  auto wrapped_callback = std::make_unique<WrapperCallbacks>(*this, decoder, pool, callbacks);
   ConnectionPool::Cancellable* ret = wrapped_callback.get();
   LinkedList::moveIntoList(std::move(wrapped_callback), wrapped_callbacks_);
   // Note that in the case of immediate attempt/failure, newStream will delete this.
@@ -232,6 +249,11 @@ absl::optional<ConnectivityGrid::PoolIterator> ConnectivityGrid::nextPool(PoolIt
   return createNextPool();
 }
 
+bool ConnectivityGrid::isPoolHttp3(const ConnectionPool::Instance& pool) {
+  // HTTP/3 is hard-coded as the first pool.
+  return !pools_.empty() && &pool == pools_.front().get();
+}
+
 void ConnectivityGrid::onDrainReceived() {
   // Don't do any work under the stack of ~ConnectivityGrid()
   if (destroying_) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "common/http/conn_pool_base.h"
+#include "common/http/http3_status_tracker.h"
 
 #include "absl/container/flat_hash_map.h"
 
@@ -91,6 +92,8 @@ public:
     Event::TimerPtr next_attempt_timer_;
     // The iterator to the last pool which had a connection attempt.
     PoolIterator current_;
+    // True if the connection attempt to the HTTP/3 pool failed.
+    bool http3_attempt_failed_{};
   };
   using WrapperCallbacksPtr = std::unique_ptr<WrapperCallbacks>;
 
@@ -116,6 +119,19 @@ public:
   // Returns the next pool in the ordered priority list.
   absl::optional<PoolIterator> nextPool(PoolIterator pool_it);
 
+  // Returns true if pool is the grid's HTTP/3 connection pool.
+  bool isPoolHttp3(const ConnectionPool::Instance& pool);
+
+  // Returns true if HTTP/3 is currently broken. While HTTP/3 is broken the grid will not
+  // attempt to make new HTTP/3 connections.
+  bool isHttp3Broken() const { return http3_status_tracker_.isHttp3Broken(); }
+
+  // Marks HTTP/3 broken for a period of time subject to backoff.
+  void markHttp3Broken() { http3_status_tracker_.markHttp3Broken(); }
+
+  // Marks that HTTP/3 is working, which resets the backoff.
+  void markHttp3Confirmed() { http3_status_tracker_.markHttp3Confirmed(); }
+
 private:
   friend class ConnectivityGridForTest;
 
@@ -154,6 +170,9 @@ private:
 
   // Wrapped callbacks are stashed in the wrapped_callbacks_ for ownership.
   std::list<WrapperCallbacksPtr> wrapped_callbacks_;
+
+  // Whether the past HTTP/3 connection attempts to the host worked.
+  Http3StatusTracker http3_status_tracker_;
 };
 
 } // namespace Http
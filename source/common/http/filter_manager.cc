@@ -228,6 +228,10 @@ const ScopeTrackedObject& ActiveStreamFilterBase::scope() {
   return parent_.filter_manager_callbacks_.scope();
 }
 
+Buffer::BufferMemoryAccountSharedPtr ActiveStreamFilterBase::account() const {
+  return parent_.filter_manager_callbacks_.account();
+}
+
 Tracing::Config& ActiveStreamFilterBase::tracingConfig() {
   return parent_.filter_manager_callbacks_.tracingConfig();
 }
@@ -285,6 +289,7 @@ Buffer::InstancePtr ActiveStreamDecoderFilter::createBuffer() {
       [this]() -> void { this->requestDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->bindAccount(account());
   return buffer;
 }
 
@@ -377,6 +382,14 @@ void ActiveStreamDecoderFilter::encode100ContinueHeaders(ResponseHeaderMapPtr&&
   }
 }
 
+void ActiveStreamDecoderFilter::encodeEarlyHintsHeaders(ResponseHeaderMapPtr&& headers) {
+  // The early hints are only useful before the response, and the encoder filters don't expect
+  // several informational responses, so they are sent directly to the codec.
+  if (!parent_.filter_manager_callbacks_.responseHeaders().has_value()) {
+    parent_.filter_manager_callbacks_.encodeEarlyHintsHeaders(*headers);
+  }
+}
+
 ResponseHeaderMapOptRef ActiveStreamDecoderFilter::continueHeaders() const {
   return parent_.filter_manager_callbacks_.continueHeaders();
 }
@@ -429,7 +442,10 @@ void FilterManager::addStreamDecoderFilterWorker(StreamDecoderFilterSharedPtr fi
                                                  FilterMatchStateSharedPtr match_state,
                                                  bool dual_filter) {
   ActiveStreamDecoderFilterPtr wrapper(
-      new ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter));
+      arena_.has_value()
+          ? new (*arena_) ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter)
+          : new ActiveStreamDecoderFilter(*this, filter, match_state, dual_filter));
+  wrapper->timing_ = current_filter_timing_;
 
   // If we're a dual handling filter, have the encoding wrapper be the only thing registering itself
   // as the handling filter.
@@ -453,7 +469,10 @@ void FilterManager::addStreamEncoderFilterWorker(StreamEncoderFilterSharedPtr fi
                                                  FilterMatchStateSharedPtr match_state,
                                                  bool dual_filter) {
   ActiveStreamEncoderFilterPtr wrapper(
-      new ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter));
+      arena_.has_value()
+          ? new (*arena_) ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter)
+          : new ActiveStreamEncoderFilter(*this, filter, match_state, dual_filter));
+  wrapper->timing_ = current_filter_timing_;
 
   if (match_state) {
     match_state->filter_ = filter.get();
@@ -506,7 +525,8 @@ void FilterManager::decodeHeaders(ActiveStreamDecoderFilter* filter, RequestHead
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeHeaders));
     state_.filter_call_state_ |= FilterCallState::DecodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == decoder_filters_.end());
-    FilterHeadersStatus status = (*entry)->decodeHeaders(headers, (*entry)->end_stream_);
+    FilterHeadersStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->decodeHeaders(headers, (*entry)->end_stream_); });
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndDontEndStream && !(*entry)->end_stream_),
            "Filters should not return FilterHeadersStatus::ContinueAndDontEndStream from "
@@ -582,7 +602,7 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
       commonDecodePrefix(filter, filter_iteration_start_state);
 
   for (; entry != decoder_filters_.end(); entry++) {
-    if ((*entry)->skipFilter()) {
+    if ((*entry)->skipFilterForData()) {
       continue;
     }
     // If the filter pointed by entry has stopped for all frame types, return now.
@@ -635,7 +655,8 @@ void FilterManager::decodeData(ActiveStreamDecoderFilter* filter, Buffer::Instan
 
     state_.filter_call_state_ |= FilterCallState::DecodeData;
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.requestTrailers();
-    FilterDataStatus status = (*entry)->handle_->decodeData(data, (*entry)->end_stream_);
+    FilterDataStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->handle_->decodeData(data, (*entry)->end_stream_); });
     if ((*entry)->end_stream_) {
       (*entry)->handle_->decodeComplete();
     }
@@ -719,7 +740,7 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
     (*entry)->maybeEvaluateMatchTreeWithNewData(
         [&](auto& matching_data) { matching_data.onRequestTrailers(trailers); });
 
-    if ((*entry)->skipFilter()) {
+    if ((*entry)->skipFilterForData()) {
       continue;
     }
 
@@ -729,7 +750,8 @@ void FilterManager::decodeTrailers(ActiveStreamDecoderFilter* filter, RequestTra
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::DecodeTrailers));
     state_.filter_call_state_ |= FilterCallState::DecodeTrailers;
-    FilterTrailersStatus status = (*entry)->handle_->decodeTrailers(trailers);
+    FilterTrailersStatus status =
+        timeFilterCallback(**entry, [&] { return (*entry)->handle_->decodeTrailers(trailers); });
     (*entry)->handle_->decodeComplete();
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::DecodeTrailers;
@@ -764,7 +786,8 @@ void FilterManager::decodeMetadata(ActiveStreamDecoderFilter* filter, MetadataMa
       return;
     }
 
-    FilterMetadataStatus status = (*entry)->handle_->decodeMetadata(metadata_map);
+    FilterMetadataStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->handle_->decodeMetadata(metadata_map); });
     ENVOY_STREAM_LOG(trace, "decode metadata called: filter={} status={}, metadata: {}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status),
                      metadata_map);
@@ -987,7 +1010,8 @@ void FilterManager::encode100ContinueHeaders(ActiveStreamEncoderFilter* filter,
 
     ASSERT(!(state_.filter_call_state_ & FilterCallState::Encode100ContinueHeaders));
     state_.filter_call_state_ |= FilterCallState::Encode100ContinueHeaders;
-    FilterHeadersStatus status = (*entry)->handle_->encode100ContinueHeaders(headers);
+    FilterHeadersStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->handle_->encode100ContinueHeaders(headers); });
     state_.filter_call_state_ &= ~FilterCallState::Encode100ContinueHeaders;
     ENVOY_STREAM_LOG(trace, "encode 100 continue headers called: filter={} status={}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status));
@@ -1035,7 +1059,8 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeHeaders));
     state_.filter_call_state_ |= FilterCallState::EncodeHeaders;
     (*entry)->end_stream_ = (end_stream && continue_data_entry == encoder_filters_.end());
-    FilterHeadersStatus status = (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_);
+    FilterHeadersStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->handle_->encodeHeaders(headers, (*entry)->end_stream_); });
 
     ASSERT(!(status == FilterHeadersStatus::ContinueAndDontEndStream && !(*entry)->end_stream_),
            "Filters should not return FilterHeadersStatus::ContinueAndDontEndStream from "
@@ -1069,6 +1094,9 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
   }
 
   const bool modified_end_stream = (end_stream && continue_data_entry == encoder_filters_.end());
+  if (!modified_end_stream) {
+    maybeSkipFiltersForTunnel(headers);
+  }
   state_.non_100_response_headers_encoded_ = true;
   filter_manager_callbacks_.encodeHeaders(headers, modified_end_stream);
   maybeEndEncode(modified_end_stream);
@@ -1078,6 +1106,32 @@ void FilterManager::encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHea
   }
 }
 
+void FilterManager::maybeSkipFiltersForTunnel(const ResponseHeaderMap& headers) {
+  const bool upgraded =
+      Utility::getResponseStatus(headers) == enumToInt(Http::Code::SwitchingProtocols) &&
+      Utility::isUpgrade(headers);
+  const RequestHeaderMap* request_headers = filter_manager_callbacks_.requestHeaders().ptr();
+  if (!upgraded && !HeaderUtility::isConnectResponse(request_headers, headers)) {
+    return;
+  }
+  // The filters which stopped the iteration, or whose data is buffered, still get the data they
+  // are waiting for.
+  if (buffered_request_data_ == nullptr) {
+    for (ActiveStreamDecoderFilterPtr& filter : decoder_filters_) {
+      if (filter->canIterate() && !filter->handle_->needsTunnelData()) {
+        filter->skip_tunnel_data_ = true;
+      }
+    }
+  }
+  if (buffered_response_data_ == nullptr) {
+    for (ActiveStreamEncoderFilterPtr& filter : encoder_filters_) {
+      if (filter->canIterate() && !filter->handle_->needsTunnelData()) {
+        filter->skip_tunnel_data_ = true;
+      }
+    }
+  }
+}
+
 void FilterManager::encodeMetadata(ActiveStreamEncoderFilter* filter,
                                    MetadataMapPtr&& metadata_map_ptr) {
   filter_manager_callbacks_.resetIdleTimer();
@@ -1098,7 +1152,8 @@ void FilterManager::encodeMetadata(ActiveStreamEncoderFilter* filter,
       return;
     }
 
-    FilterMetadataStatus status = (*entry)->handle_->encodeMetadata(*metadata_map_ptr);
+    FilterMetadataStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->handle_->encodeMetadata(*metadata_map_ptr); });
     ENVOY_STREAM_LOG(trace, "encode metadata called: filter={} status={}", *this,
                      static_cast<const void*>((*entry).get()), static_cast<uint64_t>(status));
   }
@@ -1157,7 +1212,7 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
 
   const bool trailers_exists_at_start = filter_manager_callbacks_.responseTrailers().has_value();
   for (; entry != encoder_filters_.end(); entry++) {
-    if ((*entry)->skipFilter()) {
+    if ((*entry)->skipFilterForData()) {
       continue;
     }
     // If the filter pointed by entry has stopped for all frame type, return now.
@@ -1182,7 +1237,8 @@ void FilterManager::encodeData(ActiveStreamEncoderFilter* filter, Buffer::Instan
     recordLatestDataFilter(entry, state_.latest_data_encoding_filter_, encoder_filters_);
 
     (*entry)->end_stream_ = end_stream && !filter_manager_callbacks_.responseTrailers();
-    FilterDataStatus status = (*entry)->handle_->encodeData(data, (*entry)->end_stream_);
+    FilterDataStatus status = timeFilterCallback(
+        **entry, [&] { return (*entry)->handle_->encodeData(data, (*entry)->end_stream_); });
     if ((*entry)->end_stream_) {
       (*entry)->handle_->encodeComplete();
     }
@@ -1225,7 +1281,7 @@ void FilterManager::encodeTrailers(ActiveStreamEncoderFilter* filter,
     (*entry)->maybeEvaluateMatchTreeWithNewData(
         [&](auto& matching_data) { matching_data.onResponseTrailers(trailers); });
 
-    if ((*entry)->skipFilter()) {
+    if ((*entry)->skipFilterForData()) {
       continue;
     }
 
@@ -1235,7 +1291,8 @@ void FilterManager::encodeTrailers(ActiveStreamEncoderFilter* filter,
     }
     ASSERT(!(state_.filter_call_state_ & FilterCallState::EncodeTrailers));
     state_.filter_call_state_ |= FilterCallState::EncodeTrailers;
-    FilterTrailersStatus status = (*entry)->handle_->encodeTrailers(trailers);
+    FilterTrailersStatus status =
+        timeFilterCallback(**entry, [&] { return (*entry)->handle_->encodeTrailers(trailers); });
     (*entry)->handle_->encodeComplete();
     (*entry)->end_stream_ = true;
     state_.filter_call_state_ &= ~FilterCallState::EncodeTrailers;
@@ -1428,6 +1485,7 @@ Buffer::InstancePtr ActiveStreamEncoderFilter::createBuffer() {
       [this]() -> void { this->responseDataTooLarge(); },
       []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
   buffer->setWatermarks(parent_.buffer_limit_);
+  buffer->bindAccount(account());
   return buffer;
 }
 Buffer::InstancePtr& ActiveStreamEncoderFilter::bufferedData() {
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <chrono>
+#include <list>
 #include <memory>
+#include <string>
 
 #include "envoy/common/optref.h"
+#include "envoy/common/time.h"
 #include "envoy/extensions/filters/common/matcher/action/v3/skip_action.pb.h"
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.h"
 #include "envoy/extensions/filters/network/http_connection_manager/v3/http_connection_manager.pb.validate.h"
@@ -14,6 +18,7 @@
 #include "envoy/type/matcher/v3/http_inputs.pb.validate.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena_impl.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
 #include "common/common/logger.h"
@@ -24,6 +29,7 @@
 #include "common/local_reply/local_reply.h"
 #include "common/matcher/matcher.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_features.h"
 #include "common/stream_info/stream_info_impl.h"
 
 namespace Envoy {
@@ -36,6 +42,15 @@ class SkipAction : public Matcher::ActionBase<
 
 struct ActiveStreamFilterBase;
 
+/**
+ * The time spent in the callbacks of the filters created from a filter config, for the streams
+ * whose filters are timed. @see FilterManager::enableFilterTiming().
+ */
+struct FilterTiming {
+  std::string config_name_;
+  std::chrono::nanoseconds time_{};
+};
+
 using MatchDataUpdateFunc = std::function<void(Matching::HttpMatchingDataImpl&)>;
 /**
  * Manages the shared match state between one or two filters.
@@ -86,13 +101,15 @@ public:
  * memory overhead of unused fields) should apply.
  */
 struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
+                                public ArenaAllocatable,
                                 Logger::Loggable<Logger::Id::http> {
   ActiveStreamFilterBase(FilterManager& parent, bool dual_filter,
                          FilterMatchStateSharedPtr match_state)
       : parent_(parent), iteration_state_(IterationState::Continue),
         filter_match_state_(std::move(match_state)), iterate_from_current_filter_(false),
         headers_continued_(false), continue_headers_continued_(false), end_stream_(false),
-        dual_filter_(dual_filter), decode_headers_called_(false), encode_headers_called_(false) {}
+        dual_filter_(dual_filter), decode_headers_called_(false), encode_headers_called_(false),
+        skip_tunnel_data_(false) {}
 
   // Functions in the following block are called after the filter finishes processing
   // corresponding data. Those functions handle state updates and data storage (if needed)
@@ -141,6 +158,7 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   Tracing::Span& activeSpan() override;
   Tracing::Config& tracingConfig() override;
   const ScopeTrackedObject& scope() override;
+  Buffer::BufferMemoryAccountSharedPtr account() const override;
 
   // Functions to set or get iteration state.
   bool canIterate() { return iteration_state_ == IterationState::Continue; }
@@ -165,6 +183,7 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
     return saved_response_metadata_.get();
   }
   bool skipFilter() const { return filter_match_state_ && filter_match_state_->skipFilter(); }
+  bool skipFilterForData() const { return skip_tunnel_data_ || skipFilter(); }
   void maybeEvaluateMatchTreeWithNewData(MatchDataUpdateFunc update_func) {
     if (filter_match_state_) {
       filter_match_state_->evaluateMatchTreeWithNewData(update_func);
@@ -190,6 +209,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   IterationState iteration_state_;
 
   FilterMatchStateSharedPtr filter_match_state_;
+  // The timing of the filter config the filter is created from, if the filters are timed.
+  FilterTiming* timing_{};
   // If the filter resumes iteration from a StopAllBuffer/Watermark state, the current filter
   // hasn't parsed data and trailers. As a result, the filter iteration should start with the
   // current filter instead of the next one. If true, filter iteration starts with the current
@@ -202,6 +223,8 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
   const bool dual_filter_ : 1;
   bool decode_headers_called_ : 1;
   bool encode_headers_called_ : 1;
+  // If true, the stream is a tunnel whose data and trailers the filter doesn't need.
+  bool skip_tunnel_data_ : 1;
 
   friend FilterMatchState;
 };
@@ -256,6 +279,7 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
                       absl::string_view details) override;
   void encode100ContinueHeaders(ResponseHeaderMapPtr&& headers) override;
   ResponseHeaderMapOptRef continueHeaders() const override;
+  void encodeEarlyHintsHeaders(ResponseHeaderMapPtr&& headers) override;
   void encodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream,
                      absl::string_view details) override;
   ResponseHeaderMapOptRef responseHeaders() const override;
@@ -376,6 +400,12 @@ public:
    */
   virtual void encode100ContinueHeaders(ResponseHeaderMap& response_headers) PURE;
 
+  /**
+   * Called with 103 Early Hints headers to be sent before the response headers.
+   * @param response_headers the early hints headers.
+   */
+  virtual void encodeEarlyHintsHeaders(ResponseHeaderMap& response_headers) PURE;
+
   /**
    * Called when the provided data has been encoded by all filters in the chain.
    * @param data the encoded data.
@@ -570,6 +600,11 @@ public:
    */
   virtual const ScopeTrackedObject& scope() PURE;
 
+  /**
+   * Returns the account the memory of the buffers of this stream is charged to, or nullptr.
+   */
+  virtual Buffer::BufferMemoryAccountSharedPtr account() const PURE;
+
   /**
    * Returns whether internal redirects with request bodies is enabled.
    */
@@ -646,9 +681,13 @@ public:
       : filter_manager_callbacks_(filter_manager_callbacks), dispatcher_(dispatcher),
         connection_(connection), stream_id_(stream_id), proxy_100_continue_(proxy_100_continue),
         buffer_limit_(buffer_limit), filter_chain_factory_(filter_chain_factory),
-        local_reply_(local_reply),
+        local_reply_(local_reply), time_source_(time_source),
         stream_info_(protocol, time_source, connection.addressProviderSharedPtr(),
-                     parent_filter_state, filter_state_life_span) {}
+                     parent_filter_state, filter_state_life_span) {
+    if (Runtime::runtimeFeatureEnabled(streamArenaFeature())) {
+      arena_.emplace();
+    }
+  }
   ~FilterManager() override {
     ASSERT(state_.destroyed_);
     ASSERT(state_.filter_call_state_ == 0);
@@ -725,6 +764,30 @@ public:
     addStreamEncoderFilterWorker(filter, nullptr, true);
   }
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override;
+  Arena* streamArena() override { return arena_.has_value() ? &arena_.value() : nullptr; }
+  void setFilterConfigName(absl::string_view name) override {
+    if (filter_timing_enabled_) {
+      filter_timings_.push_back({std::string(name), {}});
+      current_filter_timing_ = &filter_timings_.back();
+    }
+  }
+
+  /**
+   * Times the callbacks of the filters of the stream, by the filter config they are created from.
+   * It must be called before the filter chain is created. The filters added before the name of
+   * their config is set aren't timed.
+   */
+  void enableFilterTiming() {
+    ASSERT(!state_.created_filter_chain_);
+    filter_timing_enabled_ = true;
+  }
+
+  /**
+   * @return the time spent in the callbacks of the filters of each filter config, in the order of
+   *         the configs, if the filters are timed. The time spent in a callback excludes the time
+   *         spent in the callbacks of the other filters run under it, e.g. by a local reply.
+   */
+  const std::list<FilterTiming>& filterTimings() const { return filter_timings_; }
 
   void log() {
     RequestHeaderMap* request_headers = nullptr;
@@ -922,6 +985,47 @@ private:
   // Indicates which filter to start the iteration with.
   enum class FilterIterationStartState { AlwaysStartFromNext, CanStartFromCurrent };
 
+  static const Runtime::RuntimeFeature& streamArenaFeature() {
+    CONSTRUCT_ON_FIRST_USE(Runtime::RuntimeFeature, "envoy.reloadable_features.http_stream_arena");
+  }
+
+  // Adds the time spent in a filter callback to the timing of the filter, minus the time spent in
+  // the callbacks of the other filters run under it. It does nothing if the filter isn't timed.
+  class ScopedFilterTimer {
+  public:
+    ScopedFilterTimer(FilterManager& parent, const ActiveStreamFilterBase& filter)
+        : parent_(parent), timing_(filter.timing_) {
+      if (timing_ != nullptr) {
+        outer_ = parent_.current_filter_timer_;
+        parent_.current_filter_timer_ = this;
+        start_ = parent_.time_source_.monotonicTime();
+      }
+    }
+    ~ScopedFilterTimer() {
+      if (timing_ != nullptr) {
+        const std::chrono::nanoseconds elapsed = parent_.time_source_.monotonicTime() - start_;
+        timing_->time_ += elapsed - nested_;
+        if (outer_ != nullptr) {
+          outer_->nested_ += elapsed;
+        }
+        parent_.current_filter_timer_ = outer_;
+      }
+    }
+
+  private:
+    FilterManager& parent_;
+    FilterTiming* const timing_;
+    ScopedFilterTimer* outer_{};
+    MonotonicTime start_;
+    std::chrono::nanoseconds nested_{};
+  };
+
+  template <class Callback>
+  auto timeFilterCallback(const ActiveStreamFilterBase& filter, Callback callback) {
+    ScopedFilterTimer timer(*this, filter);
+    return callback();
+  }
+
   // Returns the encoder filter to start iteration with.
   std::list<ActiveStreamEncoderFilterPtr>::iterator
   commonEncodePrefix(ActiveStreamEncoderFilter* filter, bool end_stream,
@@ -954,6 +1058,9 @@ private:
       const std::list<ActiveStreamEncoderFilterPtr>::iterator& maybe_continue_data_entry);
   void encodeHeaders(ActiveStreamEncoderFilter* filter, ResponseHeaderMap& headers,
                      bool end_stream);
+  // Once the response headers turned the stream into a tunnel, marks the filters which don't need
+  // its data and trailers as skipped for them, so that each frame only goes through the others.
+  void maybeSkipFiltersForTunnel(const ResponseHeaderMap& headers);
   // Sends data through encoding filter chains. filter_iteration_start_state indicates which
   // filter to start the iteration with, and finally calls encodeDataInternal
   // to update stats, do end stream bookkeeping, and send the data to encoder.
@@ -984,6 +1091,9 @@ private:
   const uint64_t stream_id_;
   const bool proxy_100_continue_;
 
+  // Holds the filter wrappers and any filters the factories allocate from it. It must be declared
+  // before anything that may refer to them so that it is destroyed last.
+  absl::optional<ArenaImpl> arena_;
   std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
   std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
   std::list<StreamFilterBase*> filters_;
@@ -1003,7 +1113,13 @@ private:
 
   FilterChainFactory& filter_chain_factory_;
   const LocalReply::LocalReply& local_reply_;
+  TimeSource& time_source_;
   OverridableRemoteSocketAddressSetterStreamInfo stream_info_;
+  bool filter_timing_enabled_{};
+  std::list<FilterTiming> filter_timings_;
+  // The timing given to the filters added next, and the timer of the innermost filter callback.
+  FilterTiming* current_filter_timing_{};
+  ScopedFilterTimer* current_filter_timer_{};
   // TODO(snowp): Once FM has been moved to its own file we'll make these private classes of FM,
   // at which point they no longer need to be friends.
   friend ActiveStreamFilterBase;
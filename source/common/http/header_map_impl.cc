@@ -40,6 +40,10 @@ InlineHeaderVector& getInVec(VariantHeader& buffer) {
 const InlineHeaderVector& getInVec(const VariantHeader& buffer) {
   return absl::get<InlineHeaderVector>(buffer);
 }
+
+const InlineHeaderVector& getSharedVec(const VariantHeader& buffer) {
+  return *absl::get<SharedHeaderVector>(buffer);
+}
 } // namespace
 
 // Initialize as a Type::Inline
@@ -82,6 +86,14 @@ void HeaderString::append(const char* data, uint32_t data_size) {
     getInVec(buffer_).assign(prev.begin(), prev.end());
     break;
   }
+  case Type::Shared: {
+    // The shared storage is immutable, so copy it before releasing it.
+    InlineHeaderVector copy;
+    copy.reserve(new_capacity);
+    copy.assign(getSharedVec(buffer_).begin(), getSharedVec(buffer_).end());
+    buffer_ = std::move(copy);
+    break;
+  }
   case Type::Inline: {
     getInVec(buffer_).reserve(new_capacity);
     break;
@@ -103,6 +115,9 @@ absl::string_view HeaderString::getStringView() const {
   if (type() == Type::Reference) {
     return getStrView(buffer_);
   }
+  if (type() == Type::Shared) {
+    return {getSharedVec(buffer_).data(), getSharedVec(buffer_).size()};
+  }
   ASSERT(type() == Type::Inline);
   return {getInVec(buffer_).data(), getInVec(buffer_).size()};
 }
@@ -110,12 +125,21 @@ absl::string_view HeaderString::getStringView() const {
 void HeaderString::clear() {
   if (type() == Type::Inline) {
     getInVec(buffer_).clear();
+  } else if (type() == Type::Shared) {
+    // This also covers a moved-from string, whose shared storage is gone.
+    buffer_ = InlineHeaderVector();
   }
 }
 
 void HeaderString::setCopy(const char* data, uint32_t size) {
   ASSERT(validHeaderString(absl::string_view(data, size)));
 
+  if (type() == Type::Shared) {
+    // The data may point into the shared storage, so copy it before releasing the storage.
+    buffer_ = InlineHeaderVector(data, data + size);
+    ASSERT(valid());
+    return;
+  }
   if (!absl::holds_alternative<InlineHeaderVector>(buffer_)) {
     // Switching from Type::Reference to Type::Inline
     buffer_ = InlineHeaderVector();
@@ -140,8 +164,8 @@ void HeaderString::setInteger(uint64_t value) {
   char inner_buffer[MaxIntegerLength];
   const uint32_t int_length = StringUtil::itoa(inner_buffer, MaxIntegerLength, value);
 
-  if (type() == Type::Reference) {
-    // Switching from Type::Reference to Type::Inline
+  if (type() != Type::Inline) {
+    // Switching from Type::Reference or Type::Shared to Type::Inline
     buffer_ = InlineHeaderVector();
   }
   ASSERT((getInVec(buffer_).capacity()) > MaxIntegerLength);
@@ -157,18 +181,45 @@ uint32_t HeaderString::size() const {
   if (type() == Type::Reference) {
     return getStrView(buffer_).size();
   }
+  if (type() == Type::Shared) {
+    return getSharedVec(buffer_).size();
+  }
   ASSERT(type() == Type::Inline);
   return getInVec(buffer_).size();
 }
 
+HeaderString HeaderString::copy() const {
+  HeaderString copy;
+  switch (type()) {
+  case Type::Reference:
+    copy.setCopy(getStrView(buffer_));
+    return copy;
+  case Type::Inline:
+    // Small strings fit in the inline storage of the copy, which is cheaper than sharing.
+    if (getInVec(buffer_).size() <= InlineHeaderVector().capacity()) {
+      copy.setCopy(getStringView());
+      return copy;
+    }
+    // Moving the heap allocated storage doesn't copy the bytes.
+    buffer_ = std::make_shared<const InlineHeaderVector>(std::move(getInVec(buffer_)));
+    break;
+  case Type::Shared:
+    break;
+  }
+  copy.buffer_ = absl::get<SharedHeaderVector>(buffer_);
+  return copy;
+}
+
 HeaderString::Type HeaderString::type() const {
-  // buffer_.index() is correlated with the order of Reference and Inline in the
+  // buffer_.index() is correlated with the order of Reference, Inline and Shared in the
   // enum.
-  ASSERT(buffer_.index() == 0 || buffer_.index() == 1);
+  ASSERT(buffer_.index() <= 2);
   ASSERT((buffer_.index() == 0 && absl::holds_alternative<absl::string_view>(buffer_)) ||
          (buffer_.index() != 0));
   ASSERT((buffer_.index() == 1 && absl::holds_alternative<InlineHeaderVector>(buffer_)) ||
          (buffer_.index() != 1));
+  ASSERT((buffer_.index() == 2 && absl::holds_alternative<SharedHeaderVector>(buffer_)) ||
+         (buffer_.index() != 2));
   return Type(buffer_.index());
 }
 
@@ -250,13 +301,14 @@ template <> HeaderMapImpl::StaticLookupTable<RequestHeaderMap>::StaticLookupTabl
   const auto handle =
       CustomInlineHeaderRegistry::getInlineHeader<RequestHeaderMap::header_map_type>(
           Headers::get().Host);
-  add(Headers::get().HostLegacy.get().c_str(), [handle](HeaderMapImpl& h) -> StaticLookupResponse {
-    return {&h.inlineHeaders()[handle.value().it_->second], &handle.value().it_->first};
-  });
+  table_.add(Headers::get().HostLegacy.get(),
+             {handle.value().it_->second, &handle.value().it_->first});
+  table_.build();
 }
 
 template <> HeaderMapImpl::StaticLookupTable<RequestTrailerMap>::StaticLookupTable() {
   finalizeTable();
+  table_.build();
 }
 
 template <> HeaderMapImpl::StaticLookupTable<ResponseHeaderMap>::StaticLookupTable() {
@@ -268,6 +320,7 @@ template <> HeaderMapImpl::StaticLookupTable<ResponseHeaderMap>::StaticLookupTab
   INLINE_RESP_HEADERS_TRAILERS(REGISTER_RESPONSE_HEADER)
 
   finalizeTable();
+  table_.build();
 }
 
 template <> HeaderMapImpl::StaticLookupTable<ResponseTrailerMap>::StaticLookupTable() {
@@ -277,6 +330,7 @@ template <> HeaderMapImpl::StaticLookupTable<ResponseTrailerMap>::StaticLookupTa
   INLINE_RESP_HEADERS_TRAILERS(REGISTER_RESPONSE_TRAILER)
 
   finalizeTable();
+  table_.build();
 }
 
 uint64_t HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data,
@@ -308,13 +362,8 @@ void HeaderMapImpl::subtractSize(uint64_t size) {
 
 void HeaderMapImpl::copyFrom(HeaderMap& lhs, const HeaderMap& header_map) {
   header_map.iterate([&lhs](const HeaderEntry& header) -> HeaderMap::Iterate {
-    // TODO(mattklein123) PERF: Avoid copying here if not necessary.
-    HeaderString key_string;
-    key_string.setCopy(header.key().getStringView());
-    HeaderString value_string;
-    value_string.setCopy(header.value().getStringView());
-
-    lhs.addViaMove(std::move(key_string), std::move(value_string));
+    // Large values, e.g. cookies and JWTs, are shared with the copy rather than copied.
+    lhs.addViaMove(header.key().copy(), header.value().copy());
     return HeaderMap::Iterate::Continue;
   });
 }
@@ -481,17 +530,21 @@ HeaderMap::GetResult HeaderMapImpl::get(const LowerCaseString& key) const {
 }
 
 HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(const LowerCaseString& key) {
-  // Attempt a trie lookup first to see if the user is requesting an O(1) header. This may be
-  // relatively common in certain header matching / routing patterns.
+  // Attempt a static lookup first to see if the user is requesting an O(1) header. This may be
+  // relatively common in certain header matching / routing patterns. The lazy map indexes all the
+  // headers, the O(1) headers included, so once it is in use it's looked up directly, and the
+  // lookups of the filters of a request only hash the key once.
   // TODO(mattklein123): Add inline handle support directly to the header matcher code to support
   // this use case more directly.
   HeaderMap::NonConstGetResult ret;
-  auto lookup = staticLookup(key.get());
-  if (lookup.has_value()) {
-    if (*lookup.value().entry_ != nullptr) {
-      ret.push_back(*lookup.value().entry_);
+  if (!headers_.mapInUse()) {
+    auto lookup = staticLookup(key.get());
+    if (lookup.has_value()) {
+      if (*lookup.value().entry_ != nullptr) {
+        ret.push_back(*lookup.value().entry_);
+      }
+      return ret;
     }
-    return ret;
   }
 
   // If the requested header is not an O(1) header try using the lazy map to
@@ -510,7 +563,7 @@ HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(const LowerCaseString& k
   }
 
   // If the requested header is not an O(1) header and the lazy map is not in use, we do a full
-  // scan. Doing the trie lookup is wasteful in the miss case, but is present for code consistency
+  // scan. Doing the static lookup is wasteful in the miss case, but is present for code consistency
   // with other functions that do similar things.
   for (HeaderEntryImpl& header : headers_) {
     if (header.key() == key.get().c_str()) {
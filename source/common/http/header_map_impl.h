@@ -10,6 +10,7 @@
 #include "envoy/common/optref.h"
 #include "envoy/http/header_map.h"
 
+#include "common/common/macros.h"
 #include "common/common/non_copyable.h"
 #include "common/common/utility.h"
 #include "common/http/headers.h"
@@ -45,8 +46,8 @@ public:
 
 /**
  * Implementation of Http::HeaderMap. This is heavily optimized for performance. Roughly, when
- * headers are added to the map by string, we do a trie lookup to see if it's one of the O(1)
- * headers. If it is, we store a reference to it that can be accessed later directly via direct
+ * headers are added to the map by string, we do a perfect hash lookup to see if it's one of the
+ * O(1) headers. If it is, we store a reference to it that can be accessed later directly via direct
  * method access. Most high performance paths use O(1) direct method access. In general, we try to
  * copy as little as possible and allocate as little as possible in any of the paths.
  */
@@ -128,7 +129,8 @@ protected:
 
   /**
    * This is the static lookup table that is used to determine whether a header is one of the O(1)
-   * headers. This uses a trie for lookup time at most equal to the size of the incoming string.
+   * headers. This uses a perfect hash of the registered header names, so that a lookup costs at
+   * most two hashes of the incoming string and one comparison.
    */
   struct StaticLookupResponse {
     HeaderEntryImpl** entry_;
@@ -138,9 +140,13 @@ protected:
   /**
    * Base class for a static lookup table that converts a string key into an O(1) header.
    */
-  template <class Interface>
-  struct StaticLookupTable
-      : public TrieLookupTable<std::function<StaticLookupResponse(HeaderMapImpl&)>> {
+  template <class Interface> struct StaticLookupTable {
+    // The inline header slot of a key, and the name of the header it holds.
+    struct Entry {
+      size_t index_;
+      const LowerCaseString* key_;
+    };
+
     StaticLookupTable();
 
     void finalizeTable() {
@@ -148,9 +154,7 @@ protected:
       auto& headers = CustomInlineHeaderRegistry::headers<Interface::header_map_type>();
       size_ = headers.size();
       for (const auto& header : headers) {
-        this->add(header.first.get().c_str(), [&header](HeaderMapImpl& h) -> StaticLookupResponse {
-          return {&h.inlineHeaders()[header.second], &header.first};
-        });
+        table_.add(header.first.get(), {header.second, &header.first});
       }
     }
 
@@ -167,14 +171,15 @@ protected:
 
     static absl::optional<StaticLookupResponse> lookup(HeaderMapImpl& header_map,
                                                        absl::string_view key) {
-      const auto& entry = ConstSingleton<StaticLookupTable>::get().find(key);
+      const Entry* entry = ConstSingleton<StaticLookupTable>::get().table_.find(key);
       if (entry != nullptr) {
-        return entry(header_map);
+        return StaticLookupResponse{&header_map.inlineHeaders()[entry->index_], entry->key_};
       } else {
         return absl::nullopt;
       }
     }
 
+    PerfectHashLookupTable<Entry> table_;
     size_t size_;
   };
 
@@ -182,7 +187,7 @@ protected:
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
    * of the list (as required by nghttp2) and otherwise maintains insertion order.
    * When the list size is greater or equal to the envoy.http.headermap.lazy_map_min_size runtime
-   * feature value (or uint32_t max value if not set), all headers are added to a map, to allow
+   * feature value (or DefaultLazyMapMinSize if not set), all headers are added to a map, to allow
    * fast access given a header key. Once the map is initialized, it will be used even if the number
    * of headers decreases below the threshold.
    *
@@ -195,13 +200,16 @@ protected:
    */
   class HeaderList : NonCopyable {
   public:
+    // The header map benchmarks show that a map pays off for lookups from about 3 headers.
+    static constexpr uint32_t DefaultLazyMapMinSize = 3;
+
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
     HeaderList()
         : pseudo_headers_end_(headers_.end()),
           lazy_map_min_size_(static_cast<uint32_t>(Runtime::getInteger(
-              "envoy.http.headermap.lazy_map_min_size", std::numeric_limits<uint32_t>::max()))) {}
+              "envoy.http.headermap.lazy_map_min_size", DefaultLazyMapMinSize))) {}
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -300,6 +308,7 @@ protected:
     std::list<HeaderEntryImpl>::const_reverse_iterator rend() const { return headers_.rend(); }
     HeaderLazyMap::iterator mapFind(absl::string_view key) { return lazy_map_.find(key); }
     HeaderLazyMap::iterator mapEnd() { return lazy_map_.end(); }
+    bool mapInUse() const { return !lazy_map_.empty(); }
     size_t size() const { return headers_.size(); }
     bool empty() const { return headers_.empty(); }
     void clear() {
@@ -327,6 +336,10 @@ protected:
   void updateSize(uint64_t from_size, uint64_t to_size);
   void addSize(uint64_t size);
   void subtractSize(uint64_t size);
+  static const Runtime::RuntimeFeature& correctlyCoalesceCookiesFeature() {
+    CONSTRUCT_ON_FIRST_USE(Runtime::RuntimeFeature,
+                           "envoy.reloadable_features.header_map_correctly_coalesce_cookies");
+  }
   virtual absl::optional<StaticLookupResponse> staticLookup(absl::string_view) PURE;
   virtual void clearInline() PURE;
   virtual HeaderEntryImpl** inlineHeaders() PURE;
@@ -339,8 +352,8 @@ protected:
   StatefulHeaderKeyFormatterPtr formatter_;
   // This holds the internal byte size of the HeaderMap.
   uint64_t cached_byte_size_ = 0;
-  const bool header_map_correctly_coalesce_cookies_ = Runtime::runtimeFeatureEnabled(
-      "envoy.reloadable_features.header_map_correctly_coalesce_cookies");
+  const bool header_map_correctly_coalesce_cookies_ =
+      Runtime::runtimeFeatureEnabled(correctlyCoalesceCookiesFeature());
 };
 
 /**
@@ -1,5 +1,6 @@
 #include "common/http/http1/codec_impl.h"
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -21,11 +22,13 @@
 #include "common/http/headers.h"
 #include "common/http/http1/header_formatter.h"
 #include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/vectorized_parser_impl.h"
 #include "common/http/utility.h"
 #include "common/runtime/runtime_features.h"
 
 #include "absl/container/fixed_array.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
 
 namespace Envoy {
 namespace Http {
@@ -59,6 +62,39 @@ struct Http1HeaderTypesValues {
 using Http1ResponseCodeDetails = ConstSingleton<Http1ResponseCodeDetailValues>;
 using Http1HeaderTypes = ConstSingleton<Http1HeaderTypesValues>;
 
+// The status lines of the responses, formatted once for the HTTP/1.1 and HTTP/1.0 responses with
+// a status from 100 to 599, so that encoding them is a single copy.
+class Http1StatusLineValues {
+public:
+  static constexpr uint64_t MinStatus = 100;
+  static constexpr uint64_t MaxStatus = 599;
+
+  Http1StatusLineValues() {
+    for (uint64_t status = MinStatus; status <= MaxStatus; status++) {
+      const char* status_string = CodeUtility::toString(static_cast<Code>(status));
+      http11_[status - MinStatus] = absl::StrCat("HTTP/1.1 ", status, " ", status_string, "\r\n");
+      http10_[status - MinStatus] = absl::StrCat("HTTP/1.0 ", status, " ", status_string, "\r\n");
+    }
+  }
+
+  /**
+   * @return the status line of a response with the given status, or an empty string if the status
+   *         is out of range.
+   */
+  absl::string_view get(bool http10, uint64_t status) const {
+    if (status < MinStatus || status > MaxStatus) {
+      return {};
+    }
+    return http10 ? http10_[status - MinStatus] : http11_[status - MinStatus];
+  }
+
+private:
+  std::array<std::string, MaxStatus - MinStatus + 1> http11_;
+  std::array<std::string, MaxStatus - MinStatus + 1> http10_;
+};
+
+using Http1StatusLines = ConstSingleton<Http1StatusLineValues>;
+
 const StringUtil::CaseUnorderedSet& caseUnorderdSetContainingUpgradeAndHttp2Settings() {
   CONSTRUCT_ON_FIRST_USE(StringUtil::CaseUnorderedSet,
                          Http::Headers::get().ConnectionValues.Upgrade,
@@ -120,7 +156,7 @@ void StreamEncoderImpl::encodeFormattedHeader(absl::string_view key, absl::strin
 }
 
 void ResponseEncoderImpl::encode100ContinueHeaders(const ResponseHeaderMap& headers) {
-  ASSERT(headers.Status()->value() == "100");
+  ASSERT(headers.Status()->value() == "100" || headers.Status()->value() == "103");
   encodeHeaders(headers, false);
 }
 
@@ -174,8 +210,9 @@ void StreamEncoderImpl::encodeHeadersBase(const RequestOrResponseHeaderMap& head
   if (saw_content_length || disable_chunk_encoding_) {
     chunk_encoding_ = false;
   } else {
-    if (status && *status == 100) {
-      // Make sure we don't serialize chunk information with 100-Continue headers.
+    if (status && (*status == 100 || *status == 103)) {
+      // Make sure we don't serialize chunk information with 100-Continue or 103 Early Hints
+      // headers.
       chunk_encoding_ = false;
     } else if (end_stream && !is_response_to_head_request_) {
       // If this is a headers-only stream, append an explicit "Content-Length: 0" unless it's a
@@ -226,7 +263,7 @@ void StreamEncoderImpl::encodeHeadersBase(const RequestOrResponseHeaderMap& head
   if (end_stream) {
     endEncode();
   } else {
-    connection_.flushOutput();
+    connection_.flushPartialOutput();
   }
 }
 
@@ -248,7 +285,7 @@ void StreamEncoderImpl::encodeData(Buffer::Instance& data, bool end_stream) {
   if (end_stream) {
     endEncode();
   } else {
-    connection_.flushOutput();
+    connection_.flushPartialOutput();
   }
 }
 
@@ -331,6 +368,14 @@ void ConnectionImpl::flushOutput(bool end_encode) {
   ASSERT(0UL == output_buffer_->length());
 }
 
+void ConnectionImpl::flushPartialOutput() {
+  if (flush_output_callback_ == nullptr) {
+    flushOutput();
+  } else if (!flush_output_callback_->enabled()) {
+    flush_output_callback_->scheduleCallbackCurrentIteration();
+  }
+}
+
 void ConnectionImpl::addToBuffer(absl::string_view data) { output_buffer_->add(data); }
 
 void ConnectionImpl::addCharToBuffer(char c) { output_buffer_->add(&c, 1); }
@@ -373,20 +418,26 @@ void ResponseEncoderImpl::encodeHeaders(const ResponseHeaderMap& headers, bool e
   ASSERT(headers.Status() != nullptr);
   uint64_t numeric_status = Utility::getResponseStatus(headers);
 
-  if (connection_.protocol() == Protocol::Http10 && connection_.supportsHttp10()) {
-    connection_.copyToBuffer(HTTP_10_RESPONSE_PREFIX, sizeof(HTTP_10_RESPONSE_PREFIX) - 1);
+  const bool http10 = connection_.protocol() == Protocol::Http10 && connection_.supportsHttp10();
+  const absl::string_view status_line = Http1StatusLines::get().get(http10, numeric_status);
+  if (!status_line.empty()) {
+    connection_.copyToBuffer(status_line.data(), status_line.size());
   } else {
-    connection_.copyToBuffer(RESPONSE_PREFIX, sizeof(RESPONSE_PREFIX) - 1);
-  }
-  connection_.addIntToBuffer(numeric_status);
-  connection_.addCharToBuffer(' ');
+    if (http10) {
+      connection_.copyToBuffer(HTTP_10_RESPONSE_PREFIX, sizeof(HTTP_10_RESPONSE_PREFIX) - 1);
+    } else {
+      connection_.copyToBuffer(RESPONSE_PREFIX, sizeof(RESPONSE_PREFIX) - 1);
+    }
+    connection_.addIntToBuffer(numeric_status);
+    connection_.addCharToBuffer(' ');
 
-  const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
-  uint32_t status_string_len = strlen(status_string);
-  connection_.copyToBuffer(status_string, status_string_len);
+    const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
+    uint32_t status_string_len = strlen(status_string);
+    connection_.copyToBuffer(status_string, status_string_len);
 
-  connection_.addCharToBuffer('\r');
-  connection_.addCharToBuffer('\n');
+    connection_.addCharToBuffer('\r');
+    connection_.addCharToBuffer('\n');
+  }
 
   if (numeric_status >= 300) {
     // Don't do special CONNECT logic if the CONNECT was rejected.
@@ -466,7 +517,20 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
                                []() -> void { /* TODO(adisuissa): Handle overflow watermark */ })),
       max_headers_kb_(max_headers_kb), max_headers_count_(max_headers_count) {
   output_buffer_->setWatermarks(connection.bufferLimit());
-  parser_ = std::make_unique<LegacyHttpParserImpl>(type, this);
+  if (settings.coalesce_writes_) {
+    flush_output_callback_ = connection.dispatcher().createSchedulableCallback([this]() {
+      // The end of the message may have flushed the output already.
+      if (output_buffer_->length() > 0 &&
+          connection_.state() == Network::Connection::State::Open) {
+        flushOutput();
+      }
+    });
+  }
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http1_use_vectorized_parser")) {
+    parser_ = std::make_unique<VectorizedHttpParserImpl>(type, this);
+  } else {
+    parser_ = std::make_unique<LegacyHttpParserImpl>(type, this);
+  }
 }
 
 Status ConnectionImpl::completeLastHeader() {
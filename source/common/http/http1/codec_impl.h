@@ -9,6 +9,7 @@
 #include "envoy/common/optref.h"
 #include "envoy/common/scope_tracker.h"
 #include "envoy/config/core/v3/protocol.pb.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/http/codec.h"
 #include "envoy/network/connection.h"
 
@@ -68,6 +69,9 @@ public:
     // connection, invoking any watermarks as necessary. There is no internal buffering that would
     // require a flush timeout not already covered by other timeouts.
   }
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {
+    // HTTP/1 streams encode and decode in the buffers of the connection.
+  }
 
   void setIsResponseToHeadRequest(bool value) { is_response_to_head_request_ = value; }
   void setIsResponseToConnectRequest(bool value) { is_response_to_connect_request_ = value; }
@@ -198,6 +202,12 @@ public:
    */
   void flushOutput(bool end_encode = false);
 
+  /**
+   * Flush the pending output of a message that isn't complete yet. With coalesced writes, the
+   * output is only flushed at the end of the dispatcher iteration, or with the end of the message.
+   */
+  void flushPartialOutput();
+
   void addToBuffer(absl::string_view data);
   void addCharToBuffer(char c);
   void addIntToBuffer(uint64_t i);
@@ -406,6 +416,8 @@ private:
   // Buffer used to encode the HTTP message before moving it to the network connection's output
   // buffer. This buffer is always allocated, never nullptr.
   Buffer::InstancePtr output_buffer_;
+  // Flushes the partial output at the end of the dispatcher iteration, with coalesced writes only.
+  Event::SchedulableCallbackPtr flush_output_callback_;
   Protocol protocol_{Protocol::Http11};
   const uint32_t max_headers_kb_;
   const uint32_t max_headers_count_;
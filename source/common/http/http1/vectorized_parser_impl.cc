@@ -0,0 +1,907 @@
+#include "common/http/http1/vectorized_parser_impl.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "absl/base/macros.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Error codes and names, numbered like http-parser's so that both parsers report the same codes.
+enum ParserErrno {
+  HPE_OK = 0,
+  HPE_CB_message_begin = 1,
+  HPE_CB_url = 2,
+  HPE_CB_header_field = 3,
+  HPE_CB_header_value = 4,
+  HPE_CB_headers_complete = 5,
+  HPE_CB_message_complete = 7,
+  HPE_INVALID_EOF_STATE = 11,
+  HPE_CLOSED_CONNECTION = 13,
+  HPE_INVALID_VERSION = 14,
+  HPE_INVALID_STATUS = 15,
+  HPE_INVALID_METHOD = 16,
+  HPE_INVALID_URL = 17,
+  HPE_LF_EXPECTED = 23,
+  HPE_INVALID_HEADER_TOKEN = 24,
+  HPE_INVALID_CONTENT_LENGTH = 25,
+  HPE_UNEXPECTED_CONTENT_LENGTH = 26,
+  HPE_INVALID_CHUNK_SIZE = 27,
+  HPE_INVALID_CONSTANT = 28,
+  HPE_PAUSED = 31,
+  HPE_INVALID_TRANSFER_ENCODING = 33,
+};
+
+constexpr absl::string_view ErrnoNames[] = {
+    "HPE_OK",
+    "HPE_CB_message_begin",
+    "HPE_CB_url",
+    "HPE_CB_header_field",
+    "HPE_CB_header_value",
+    "HPE_CB_headers_complete",
+    "HPE_CB_body",
+    "HPE_CB_message_complete",
+    "HPE_CB_status",
+    "HPE_CB_chunk_header",
+    "HPE_CB_chunk_complete",
+    "HPE_INVALID_EOF_STATE",
+    "HPE_HEADER_OVERFLOW",
+    "HPE_CLOSED_CONNECTION",
+    "HPE_INVALID_VERSION",
+    "HPE_INVALID_STATUS",
+    "HPE_INVALID_METHOD",
+    "HPE_INVALID_URL",
+    "HPE_INVALID_HOST",
+    "HPE_INVALID_PORT",
+    "HPE_INVALID_PATH",
+    "HPE_INVALID_QUERY_STRING",
+    "HPE_INVALID_FRAGMENT",
+    "HPE_LF_EXPECTED",
+    "HPE_INVALID_HEADER_TOKEN",
+    "HPE_INVALID_CONTENT_LENGTH",
+    "HPE_UNEXPECTED_CONTENT_LENGTH",
+    "HPE_INVALID_CHUNK_SIZE",
+    "HPE_INVALID_CONSTANT",
+    "HPE_INVALID_INTERNAL_STATE",
+    "HPE_STRICT",
+    "HPE_PAUSED",
+    "HPE_UNKNOWN",
+    "HPE_INVALID_TRANSFER_ENCODING",
+};
+
+// The methods http-parser accepts, in its order.
+constexpr absl::string_view Methods[] = {
+    "DELETE",     "GET",      "HEAD",       "POST",     "PUT",    "CONNECT",   "OPTIONS",
+    "TRACE",      "COPY",     "LOCK",       "MKCOL",    "MOVE",   "PROPFIND",  "PROPPATCH",
+    "SEARCH",     "UNLOCK",   "BIND",       "REBIND",   "UNBIND", "ACL",       "REPORT",
+    "MKACTIVITY", "CHECKOUT", "MERGE",      "M-SEARCH", "NOTIFY", "SUBSCRIBE", "UNSUBSCRIBE",
+    "PATCH",      "PURGE",    "MKCALENDAR", "LINK",     "UNLINK", "SOURCE",
+};
+
+constexpr size_t MaxMethodLength = 11;
+// "HTTP/1.1"
+constexpr size_t VersionLength = 8;
+// The longest framing header name, "transfer-encoding".
+constexpr size_t MaxFramingHeaderNameLength = 17;
+
+// A set of bytes that may be skipped over in bulk: those in [min_, max_] other than excluded_.
+struct ByteRange {
+  uint8_t min_;
+  uint8_t max_;
+  uint8_t excluded_;
+};
+
+// Visible characters and obs-text. Tab and form feed are also allowed in URLs by http-parser.
+constexpr ByteRange UrlBytes{0x21, 0xff, 0x7f};
+// Visible characters, space and obs-text. Tab is also allowed.
+constexpr ByteRange HeaderValueBytes{0x20, 0xff, 0x7f};
+// Anything but CR, which ends a chunk extension.
+constexpr ByteRange ChunkExtensionBytes{0x00, 0xff, '\r'};
+
+// Returns the first byte in [p, end) that is not in range.
+const char* findNotInRange(const char* p, const char* end, ByteRange range) {
+#if defined(__SSE2__)
+  const __m128i min = _mm_set1_epi8(static_cast<char>(range.min_));
+  const __m128i max = _mm_set1_epi8(static_cast<char>(range.max_));
+  const __m128i excluded = _mm_set1_epi8(static_cast<char>(range.excluded_));
+  for (; end - p >= 16; p += 16) {
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // There are no unsigned byte comparisons, but a byte is at least min if max(byte, min) is the
+    // byte itself.
+    const __m128i in_range = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(bytes, min), bytes),
+                                           _mm_cmpeq_epi8(_mm_min_epu8(bytes, max), bytes));
+    const __m128i accepted = _mm_andnot_si128(_mm_cmpeq_epi8(bytes, excluded), in_range);
+    const uint32_t rejected = ~static_cast<uint32_t>(_mm_movemask_epi8(accepted)) & 0xffff;
+    if (rejected != 0) {
+      return p + __builtin_ctz(rejected);
+    }
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t min = vdupq_n_u8(range.min_);
+  const uint8x16_t max = vdupq_n_u8(range.max_);
+  const uint8x16_t excluded = vdupq_n_u8(range.excluded_);
+  for (; end - p >= 16; p += 16) {
+    const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t rejected = vorrq_u8(vorrq_u8(vcltq_u8(bytes, min), vcgtq_u8(bytes, max)),
+                                         vceqq_u8(bytes, excluded));
+    // NEON has no movemask: narrow each byte of the mask to a nibble of a 64 bit integer instead.
+    const uint64_t nibbles = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(rejected), 4)), 0);
+    if (nibbles != 0) {
+      return p + (__builtin_ctzll(nibbles) >> 2);
+    }
+  }
+#endif
+  for (; p < end; ++p) {
+    const uint8_t c = *p;
+    if (c < range.min_ || c > range.max_ || c == range.excluded_) {
+      return p;
+    }
+  }
+  return p;
+}
+
+// Like findNotInRange(), but also skips over the bytes outside the range that allowed accepts.
+template <class Allowed>
+const char* scan(const char* p, const char* end, ByteRange range, Allowed allowed) {
+  p = findNotInRange(p, end, range);
+  while (p < end && allowed(*p)) {
+    p = findNotInRange(p + 1, end, range);
+  }
+  return p;
+}
+
+constexpr std::array<bool, 256> makeTokenTable() {
+  std::array<bool, 256> table{};
+  for (int c = 0x21; c < 0x7f; ++c) {
+    table[c] = true;
+  }
+  for (const char* separator = "\"(),/:;<=>?@[\\]{}"; *separator != '\0'; ++separator) {
+    table[static_cast<uint8_t>(*separator)] = false;
+  }
+  return table;
+}
+
+// Characters allowed in header names. Names are short, so they are checked with a lookup table
+// rather than with vector operations.
+constexpr std::array<bool, 256> TokenTable = makeTokenTable();
+
+bool isTokenChar(char c) { return TokenTable[static_cast<uint8_t>(c)]; }
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c = absl::ascii_tolower(c);
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+} // namespace
+
+VectorizedHttpParserImpl::VectorizedHttpParserImpl(MessageType type, ParserCallbacks* callbacks)
+    : type_(type), callbacks_(callbacks), state_(State::MessageStart) {
+  token_.reserve(VersionLength);
+  header_name_.reserve(MaxFramingHeaderNameLength);
+}
+
+VectorizedHttpParserImpl::RcVal VectorizedHttpParserImpl::execute(const char* data, int len) {
+  if (error_ != HPE_OK) {
+    return {0, error_};
+  }
+  if (paused_) {
+    return {0, HPE_PAUSED};
+  }
+  if (len == 0) {
+    return onEof();
+  }
+
+  const char* p = data;
+  const char* const end = data + len;
+  stop_execution_ = false;
+  while (p < end && error_ == HPE_OK && !paused_ && !stop_execution_) {
+    switch (state_) {
+    case State::MessageStart:
+      p = parseMessageStart(p, end);
+      break;
+    case State::Method:
+      p = parseMethod(p, end);
+      break;
+    case State::SpacesBeforeUrl:
+      if (*p == ' ') {
+        ++p;
+      } else if (*p == '\r' || *p == '\n') {
+        setError(HPE_INVALID_URL);
+      } else {
+        state_ = State::Url;
+      }
+      break;
+    case State::SpacesBeforeVersion:
+      if (*p == ' ') {
+        ++p;
+      } else if (*p == '\r' || *p == '\n') {
+        p = onHttp09RequestLine(p);
+      } else {
+        token_.clear();
+        state_ = State::RequestVersion;
+      }
+      break;
+    case State::SpacesBeforeStatusCode:
+      if (*p == ' ') {
+        ++p;
+      } else if (absl::ascii_isdigit(*p)) {
+        state_ = State::StatusCode;
+      } else {
+        setError(HPE_INVALID_STATUS);
+      }
+      break;
+    case State::Url:
+      p = parseUrl(p, end);
+      break;
+    case State::RequestVersion:
+    case State::ResponseVersion:
+      p = parseVersion(p, end);
+      break;
+    case State::StatusCode:
+      p = parseStatusCode(p, end);
+      break;
+    case State::ReasonPhrase:
+      // The reason phrase is not reported, only its end is needed.
+      p = scan(p, end, HeaderValueBytes, [](char c) { return c != '\r' && c != '\n'; });
+      if (p < end) {
+        state_ = *p == '\r' ? State::StartLineAlmostDone : State::HeaderLineStart;
+        ++p;
+      }
+      break;
+    case State::StartLineAlmostDone:
+    case State::HeaderValueAlmostDone:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      ++p;
+      if (state_ == State::HeaderValueAlmostDone) {
+        onHeaderComplete();
+      }
+      state_ = State::HeaderLineStart;
+      break;
+    case State::HeaderLineStart:
+      p = parseHeaderLineStart(p, end);
+      break;
+    case State::HeaderField:
+      p = parseHeaderField(p, end);
+      break;
+    case State::HeaderValueStart:
+    case State::HeaderValue:
+      p = parseHeaderValue(p, end);
+      break;
+    case State::HeadersAlmostDone:
+      p = parseHeadersAlmostDone(p);
+      break;
+    case State::HeadersDone:
+      p = parseHeadersDone(p);
+      break;
+    case State::Body:
+    case State::ChunkData: {
+      const size_t length = std::min<uint64_t>(remaining_, static_cast<uint64_t>(end - p));
+      onBody(p, length);
+      p += length;
+      remaining_ -= length;
+      if (remaining_ == 0) {
+        if (state_ == State::Body) {
+          onMessageComplete();
+        } else {
+          state_ = State::ChunkDataAlmostDone;
+        }
+      }
+      break;
+    }
+    case State::BodyUntilEof:
+      onBody(p, end - p);
+      p = end;
+      break;
+    case State::ChunkSizeStart:
+    case State::ChunkSize:
+      p = parseChunkSize(p, end);
+      break;
+    case State::ChunkExtension:
+      p = findNotInRange(p, end, ChunkExtensionBytes);
+      if (p < end) {
+        state_ = State::ChunkSizeAlmostDone;
+        ++p;
+      }
+      break;
+    case State::ChunkSizeAlmostDone:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      ++p;
+      // A 0-byte chunk header signals the end of the chunked body.
+      callbacks_->onChunkHeader(remaining_ == 0);
+      if (remaining_ == 0) {
+        in_trailers_ = true;
+        state_ = State::HeaderLineStart;
+      } else {
+        state_ = State::ChunkData;
+      }
+      break;
+    case State::ChunkDataAlmostDone:
+      if (*p != '\r') {
+        setError(HPE_INVALID_CHUNK_SIZE);
+        break;
+      }
+      ++p;
+      state_ = State::ChunkDataDone;
+      break;
+    case State::ChunkDataDone:
+      if (*p != '\n') {
+        setError(HPE_LF_EXPECTED);
+        break;
+      }
+      ++p;
+      state_ = State::ChunkSizeStart;
+      break;
+    case State::Dead:
+      // Only empty lines may follow the last message of a connection.
+      if (*p != '\r' && *p != '\n') {
+        setError(HPE_CLOSED_CONNECTION);
+        break;
+      }
+      ++p;
+      break;
+    }
+  }
+
+  return {static_cast<size_t>(p - data), error_ != HPE_OK ? error_ : (paused_ ? HPE_PAUSED : 0)};
+}
+
+const char* VectorizedHttpParserImpl::parseMessageStart(const char* p, const char* end) {
+  // Empty lines before a message are ignored.
+  while (p < end && (*p == '\r' || *p == '\n')) {
+    ++p;
+  }
+  if (p == end) {
+    return p;
+  }
+
+  token_.clear();
+  method_ = {};
+  status_code_ = 0;
+  http_major_ = 0;
+  http_minor_ = 0;
+  in_trailers_ = false;
+  content_length_ = absl::nullopt;
+  has_transfer_encoding_ = false;
+  chunked_ = false;
+  connection_close_ = false;
+  connection_keep_alive_ = false;
+  skip_body_ = false;
+  upgrade_ = false;
+  state_ = type_ == MessageType::Request ? State::Method : State::ResponseVersion;
+  if (callbacks_->setAndCheckCallbackStatus(callbacks_->onMessageBegin()) != 0) {
+    setError(HPE_CB_message_begin);
+  }
+  return p;
+}
+
+const char* VectorizedHttpParserImpl::parseMethod(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    if (*p != ' ') {
+      if (token_.size() == MaxMethodLength || !(absl::ascii_isupper(*p) || *p == '-')) {
+        setError(HPE_INVALID_METHOD);
+        return p;
+      }
+      token_.push_back(*p);
+      continue;
+    }
+    for (const absl::string_view method : Methods) {
+      if (method == token_) {
+        method_ = method;
+      }
+    }
+    if (method_.empty()) {
+      setError(HPE_INVALID_METHOD);
+      return p;
+    }
+    state_ = State::SpacesBeforeUrl;
+    return p + 1;
+  }
+  return p;
+}
+
+const char* VectorizedHttpParserImpl::parseUrl(const char* p, const char* end) {
+  const char* url_end = scan(p, end, UrlBytes, [](char c) { return c == '\t' || c == '\f'; });
+  if (url_end > p) {
+    onData(&ParserCallbacks::onUrl, p, url_end - p, HPE_CB_url);
+    if (error_ != HPE_OK) {
+      return url_end;
+    }
+  }
+  if (url_end == end) {
+    return url_end;
+  }
+  switch (*url_end) {
+  case ' ':
+    state_ = State::SpacesBeforeVersion;
+    return url_end + 1;
+  case '\r':
+  case '\n':
+    return onHttp09RequestLine(url_end);
+  default:
+    setError(HPE_INVALID_URL);
+    return url_end;
+  }
+}
+
+const char* VectorizedHttpParserImpl::onHttp09RequestLine(const char* p) {
+  http_major_ = 0;
+  http_minor_ = 9;
+  state_ = *p == '\r' ? State::StartLineAlmostDone : State::HeaderLineStart;
+  return p + 1;
+}
+
+const char* VectorizedHttpParserImpl::parseVersion(const char* p, const char* end) {
+  const bool request = state_ == State::RequestVersion;
+  for (; p < end; ++p) {
+    const bool token_end = request ? (*p == '\r' || *p == '\n') : *p == ' ';
+    if (!token_end) {
+      if (token_.size() == VersionLength) {
+        setError(HPE_INVALID_VERSION);
+        return p;
+      }
+      token_.push_back(*p);
+      continue;
+    }
+    onVersion();
+    if (error_ != HPE_OK) {
+      return p;
+    }
+    if (!request) {
+      state_ = State::SpacesBeforeStatusCode;
+    } else {
+      state_ = *p == '\r' ? State::StartLineAlmostDone : State::HeaderLineStart;
+    }
+    return p + 1;
+  }
+  return p;
+}
+
+void VectorizedHttpParserImpl::onVersion() {
+  if (!absl::StartsWith(token_, "HTTP/")) {
+    setError(HPE_INVALID_CONSTANT);
+    return;
+  }
+  if (token_.size() != VersionLength || !absl::ascii_isdigit(token_[5]) || token_[6] != '.' ||
+      !absl::ascii_isdigit(token_[7])) {
+    setError(HPE_INVALID_VERSION);
+    return;
+  }
+  http_major_ = token_[5] - '0';
+  http_minor_ = token_[7] - '0';
+}
+
+const char* VectorizedHttpParserImpl::parseStatusCode(const char* p, const char* end) {
+  for (; p < end; ++p) {
+    if (absl::ascii_isdigit(*p)) {
+      status_code_ = status_code_ * 10 + (*p - '0');
+      if (status_code_ > 999) {
+        setError(HPE_INVALID_STATUS);
+        return p;
+      }
+      continue;
+    }
+    switch (*p) {
+    case ' ':
+      state_ = State::ReasonPhrase;
+      break;
+    case '\r':
+      state_ = State::StartLineAlmostDone;
+      break;
+    case '\n':
+      state_ = State::HeaderLineStart;
+      break;
+    default:
+      setError(HPE_INVALID_STATUS);
+      return p;
+    }
+    return p + 1;
+  }
+  return p;
+}
+
+const char* VectorizedHttpParserImpl::parseHeaderLineStart(const char* p, const char* end) {
+  switch (*p) {
+  case '\r':
+    state_ = State::HeadersAlmostDone;
+    return p + 1;
+  case '\n':
+    // The LF is consumed by the HeadersAlmostDone state.
+    state_ = State::HeadersAlmostDone;
+    return p;
+  default:
+    if (!isTokenChar(*p)) {
+      setError(HPE_INVALID_HEADER_TOKEN);
+      return p;
+    }
+    header_name_.clear();
+    header_kind_ = HeaderKind::Other;
+    state_ = State::HeaderField;
+    return parseHeaderField(p, end);
+  }
+}
+
+const char* VectorizedHttpParserImpl::parseHeaderField(const char* p, const char* end) {
+  const char* field_end = p;
+  while (field_end < end && isTokenChar(*field_end)) {
+    ++field_end;
+  }
+  if (field_end > p) {
+    if (!in_trailers_ && header_name_.size() + (field_end - p) <= MaxFramingHeaderNameLength) {
+      header_name_.append(p, field_end - p);
+    } else {
+      // Too long to be a framing header; make sure it can't match one.
+      header_name_.assign(MaxFramingHeaderNameLength + 1, ' ');
+    }
+    onData(&ParserCallbacks::onHeaderField, p, field_end - p, HPE_CB_header_field);
+    if (error_ != HPE_OK) {
+      return field_end;
+    }
+  }
+  if (field_end == end) {
+    return field_end;
+  }
+  if (*field_end != ':') {
+    setError(HPE_INVALID_HEADER_TOKEN);
+    return field_end;
+  }
+
+  if (absl::EqualsIgnoreCase(header_name_, "content-length")) {
+    header_kind_ = HeaderKind::ContentLength;
+  } else if (absl::EqualsIgnoreCase(header_name_, "transfer-encoding")) {
+    header_kind_ = HeaderKind::TransferEncoding;
+  } else if (absl::EqualsIgnoreCase(header_name_, "connection")) {
+    header_kind_ = HeaderKind::Connection;
+  }
+  special_value_.clear();
+  state_ = State::HeaderValueStart;
+  return field_end + 1;
+}
+
+const char* VectorizedHttpParserImpl::parseHeaderValue(const char* p, const char* end) {
+  if (state_ == State::HeaderValueStart) {
+    // Leading whitespace is not part of the value.
+    while (p < end && (*p == ' ' || *p == '\t')) {
+      ++p;
+    }
+    if (p == end) {
+      return p;
+    }
+    if (*p == '\r' || *p == '\n') {
+      // Report the empty value so that the next header name isn't appended to this one.
+      onData(&ParserCallbacks::onHeaderValue, p, 0, HPE_CB_header_value);
+      if (error_ != HPE_OK) {
+        return p;
+      }
+    }
+    state_ = State::HeaderValue;
+  }
+
+  const char* value_end = scan(p, end, HeaderValueBytes, [](char c) { return c == '\t'; });
+  if (value_end > p) {
+    if (header_kind_ != HeaderKind::Other) {
+      special_value_.append(p, value_end - p);
+    }
+    onData(&ParserCallbacks::onHeaderValue, p, value_end - p, HPE_CB_header_value);
+    if (error_ != HPE_OK) {
+      return value_end;
+    }
+  }
+  if (value_end == end) {
+    return value_end;
+  }
+  switch (*value_end) {
+  case '\r':
+    state_ = State::HeaderValueAlmostDone;
+    break;
+  case '\n':
+    onHeaderComplete();
+    state_ = State::HeaderLineStart;
+    break;
+  default:
+    setError(HPE_INVALID_HEADER_TOKEN);
+    return value_end;
+  }
+  return value_end + 1;
+}
+
+void VectorizedHttpParserImpl::onHeaderComplete() {
+  if (in_trailers_ || header_kind_ == HeaderKind::Other) {
+    return;
+  }
+  const absl::string_view value = absl::StripAsciiWhitespace(special_value_);
+  switch (header_kind_) {
+  case HeaderKind::ContentLength: {
+    if (content_length_.has_value()) {
+      setError(HPE_UNEXPECTED_CONTENT_LENGTH);
+      return;
+    }
+    if (value.empty()) {
+      setError(HPE_INVALID_CONTENT_LENGTH);
+      return;
+    }
+    uint64_t content_length = 0;
+    for (const char c : value) {
+      if (!absl::ascii_isdigit(c) ||
+          content_length > (std::numeric_limits<uint64_t>::max() - 10) / 10) {
+        setError(HPE_INVALID_CONTENT_LENGTH);
+        return;
+      }
+      content_length = content_length * 10 + (c - '0');
+    }
+    content_length_ = content_length;
+    break;
+  }
+  case HeaderKind::TransferEncoding: {
+    has_transfer_encoding_ = true;
+    // Only a final chunked coding frames the body.
+    const std::vector<absl::string_view> codings = absl::StrSplit(value, ',');
+    chunked_ = absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(codings.back()), "chunked");
+    break;
+  }
+  case HeaderKind::Connection:
+    for (const absl::string_view token : absl::StrSplit(value, ',')) {
+      const absl::string_view option = absl::StripAsciiWhitespace(token);
+      if (absl::EqualsIgnoreCase(option, "close")) {
+        connection_close_ = true;
+      } else if (absl::EqualsIgnoreCase(option, "keep-alive")) {
+        connection_keep_alive_ = true;
+      }
+    }
+    break;
+  case HeaderKind::Other:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+const char* VectorizedHttpParserImpl::parseHeadersAlmostDone(const char* p) {
+  if (*p != '\n') {
+    setError(HPE_LF_EXPECTED);
+    return p;
+  }
+  if (in_trailers_) {
+    onMessageComplete();
+    return p + 1;
+  }
+
+  // Content-Length is only allowed alongside a chunked Transfer-Encoding, which overrides it.
+  if (has_transfer_encoding_ && content_length_.has_value() && !chunked_) {
+    setError(HPE_UNEXPECTED_CONTENT_LENGTH);
+    return p;
+  }
+
+  state_ = State::HeadersDone;
+  const int rc = callbacks_->setAndCheckCallbackStatusOr(callbacks_->onHeadersComplete());
+  switch (rc) {
+  case 0:
+    break;
+  case 2:
+    upgrade_ = true;
+    FALLTHRU;
+  case 1:
+    skip_body_ = true;
+    break;
+  default:
+    setError(HPE_CB_headers_complete);
+    break;
+  }
+  // As in http-parser, the final LF is only consumed once the body framing is acted upon, so that
+  // a pause in onHeadersComplete() takes effect before the message can complete.
+  return p;
+}
+
+const char* VectorizedHttpParserImpl::parseHeadersDone(const char* p) {
+  ASSERT(*p == '\n');
+  ++p;
+  if (upgrade_) {
+    // The rest of the data belongs to the upgraded protocol.
+    onMessageComplete();
+    stop_execution_ = true;
+  } else if (skip_body_) {
+    onMessageComplete();
+  } else if (chunked_) {
+    state_ = State::ChunkSizeStart;
+  } else if (has_transfer_encoding_) {
+    // A request body can't be framed without a final chunked coding. A response body extends to
+    // the end of the connection.
+    if (type_ == MessageType::Request) {
+      setError(HPE_INVALID_TRANSFER_ENCODING);
+    } else {
+      state_ = State::BodyUntilEof;
+    }
+  } else if (content_length_.has_value()) {
+    if (content_length_.value() == 0) {
+      onMessageComplete();
+    } else {
+      remaining_ = content_length_.value();
+      state_ = State::Body;
+    }
+  } else if (type_ == MessageType::Request || status_code_ / 100 == 1 || status_code_ == 204 ||
+             status_code_ == 304) {
+    onMessageComplete();
+  } else {
+    state_ = State::BodyUntilEof;
+  }
+  return p;
+}
+
+const char* VectorizedHttpParserImpl::parseChunkSize(const char* p, const char* end) {
+  if (state_ == State::ChunkSizeStart) {
+    const int digit = hexValue(*p);
+    if (digit < 0) {
+      setError(HPE_INVALID_CHUNK_SIZE);
+      return p;
+    }
+    remaining_ = digit;
+    state_ = State::ChunkSize;
+    ++p;
+  }
+  for (; p < end; ++p) {
+    const int digit = hexValue(*p);
+    if (digit >= 0) {
+      if (remaining_ > (std::numeric_limits<uint64_t>::max() - 16) / 16) {
+        setError(HPE_INVALID_CHUNK_SIZE);
+        return p;
+      }
+      remaining_ = remaining_ * 16 + digit;
+      continue;
+    }
+    switch (*p) {
+    case ';':
+    case ' ':
+      state_ = State::ChunkExtension;
+      break;
+    case '\r':
+      state_ = State::ChunkSizeAlmostDone;
+      break;
+    default:
+      setError(HPE_INVALID_CHUNK_SIZE);
+      return p;
+    }
+    return p + 1;
+  }
+  return p;
+}
+
+void VectorizedHttpParserImpl::onMessageComplete() {
+  state_ = shouldKeepAlive() ? State::MessageStart : State::Dead;
+  if (callbacks_->setAndCheckCallbackStatusOr(callbacks_->onMessageComplete()) != 0) {
+    setError(HPE_CB_message_complete);
+  }
+}
+
+void VectorizedHttpParserImpl::onData(Status (ParserCallbacks::*callback)(const char*, size_t),
+                                      const char* data, size_t length, int error) {
+  if (callbacks_->setAndCheckCallbackStatus((callbacks_->*callback)(data, length)) != 0) {
+    setError(error);
+  }
+}
+
+void VectorizedHttpParserImpl::onBody(const char* data, size_t length) {
+  if (length > 0) {
+    callbacks_->bufferBody(data, length);
+  }
+}
+
+VectorizedHttpParserImpl::RcVal VectorizedHttpParserImpl::onEof() {
+  switch (state_) {
+  case State::BodyUntilEof:
+    onMessageComplete();
+    return {0, error_ != HPE_OK ? error_ : (paused_ ? HPE_PAUSED : 0)};
+  case State::MessageStart:
+  case State::Dead:
+    return {0, HPE_OK};
+  default:
+    setError(HPE_INVALID_EOF_STATE);
+    return {1, error_};
+  }
+}
+
+bool VectorizedHttpParserImpl::shouldKeepAlive() const {
+  if (http_major_ > 0 && http_minor_ > 0) {
+    // HTTP/1.1 connections are persistent unless closed.
+    if (connection_close_) {
+      return false;
+    }
+  } else if (!connection_keep_alive_) {
+    return false;
+  }
+  // A response without framing ends with the connection.
+  return type_ == MessageType::Request || skip_body_ || chunked_ || content_length_.has_value() ||
+         status_code_ / 100 == 1 || status_code_ == 204 || status_code_ == 304;
+}
+
+void VectorizedHttpParserImpl::setError(int error) {
+  if (error_ == HPE_OK) {
+    error_ = error;
+  }
+}
+
+void VectorizedHttpParserImpl::resume() { paused_ = false; }
+
+ParserStatus VectorizedHttpParserImpl::pause() {
+  paused_ = true;
+  // As with http-parser, the pause takes effect when the current callback returns.
+  return ParserStatus::Success;
+}
+
+ParserStatus VectorizedHttpParserImpl::getStatus() {
+  if (error_ != HPE_OK) {
+    return ParserStatus::Error;
+  }
+  return paused_ ? ParserStatus::Paused : ParserStatus::Success;
+}
+
+uint16_t VectorizedHttpParserImpl::statusCode() const { return status_code_; }
+
+int VectorizedHttpParserImpl::httpMajor() const { return http_major_; }
+
+int VectorizedHttpParserImpl::httpMinor() const { return http_minor_; }
+
+absl::optional<uint64_t> VectorizedHttpParserImpl::contentLength() const {
+  return content_length_;
+}
+
+bool VectorizedHttpParserImpl::isChunked() const { return chunked_; }
+
+absl::string_view VectorizedHttpParserImpl::methodName() const { return method_; }
+
+absl::string_view VectorizedHttpParserImpl::errnoName(int rc) const {
+  if (rc < 0 || static_cast<size_t>(rc) >= ABSL_ARRAYSIZE(ErrnoNames)) {
+    return "HPE_UNKNOWN";
+  }
+  return ErrnoNames[rc];
+}
+
+int VectorizedHttpParserImpl::hasTransferEncoding() const { return has_transfer_encoding_; }
+
+int VectorizedHttpParserImpl::statusToInt(const ParserStatus code) const {
+  // The same codes as http-parser, see LegacyHttpParserImpl::statusToInt().
+  switch (code) {
+  case ParserStatus::Error:
+    return -1;
+  case ParserStatus::Success:
+    return 0;
+  case ParserStatus::NoBody:
+    return 1;
+  case ParserStatus::NoBodyData:
+    return 2;
+  case ParserStatus::Paused:
+    return HPE_PAUSED;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/http/http1/parser.h"
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * HTTP/1 parser that locates the end of URLs, header values, chunk extensions and reason phrases
+ * by examining 16 bytes at a time with SSE2 or NEON (with a scalar fallback elsewhere), validating
+ * the characters of the skipped bytes in the same vector operation. It produces the same
+ * ParserCallbacks events, return codes and error names as LegacyHttpParserImpl so that the codec
+ * can switch between the two at runtime.
+ *
+ * Compared to http-parser's non-strict mode, whitespace in header names, obsolete line folding and
+ * a missing CR or LF after chunk data are rejected.
+ */
+class VectorizedHttpParserImpl : public Parser {
+public:
+  VectorizedHttpParserImpl(MessageType type, ParserCallbacks* callbacks);
+
+  // Http1::Parser
+  RcVal execute(const char* data, int len) override;
+  void resume() override;
+  ParserStatus pause() override;
+  ParserStatus getStatus() override;
+  uint16_t statusCode() const override;
+  int httpMajor() const override;
+  int httpMinor() const override;
+  absl::optional<uint64_t> contentLength() const override;
+  bool isChunked() const override;
+  absl::string_view methodName() const override;
+  absl::string_view errnoName(int rc) const override;
+  int hasTransferEncoding() const override;
+  int statusToInt(const ParserStatus code) const override;
+
+private:
+  enum class State {
+    MessageStart,
+    Method,
+    SpacesBeforeUrl,
+    Url,
+    SpacesBeforeVersion,
+    RequestVersion,
+    ResponseVersion,
+    SpacesBeforeStatusCode,
+    StatusCode,
+    ReasonPhrase,
+    StartLineAlmostDone,
+    HeaderLineStart,
+    HeaderField,
+    HeaderValueStart,
+    HeaderValue,
+    HeaderValueAlmostDone,
+    HeadersAlmostDone,
+    HeadersDone,
+    Body,
+    BodyUntilEof,
+    ChunkSizeStart,
+    ChunkSize,
+    ChunkExtension,
+    ChunkSizeAlmostDone,
+    ChunkData,
+    ChunkDataAlmostDone,
+    ChunkDataDone,
+    Dead,
+  };
+
+  // The headers that affect message framing.
+  enum class HeaderKind { Other, ContentLength, TransferEncoding, Connection };
+
+  // Each of these consumes input in the current state and returns the new read position. They stop
+  // early when an error is set, the parser is paused or the current execute() call must return.
+  const char* parseMessageStart(const char* p, const char* end);
+  const char* parseMethod(const char* p, const char* end);
+  const char* parseUrl(const char* p, const char* end);
+  const char* parseVersion(const char* p, const char* end);
+  const char* parseStatusCode(const char* p, const char* end);
+  const char* parseHeaderLineStart(const char* p, const char* end);
+  const char* parseHeaderField(const char* p, const char* end);
+  const char* parseHeaderValue(const char* p, const char* end);
+  const char* parseHeadersAlmostDone(const char* p);
+  const char* parseHeadersDone(const char* p);
+  const char* parseChunkSize(const char* p, const char* end);
+
+  // Handles the end of a request line without a version, which http-parser treats as HTTP/0.9.
+  const char* onHttp09RequestLine(const char* p);
+  // Interprets a completed version token such as "HTTP/1.1".
+  void onVersion();
+  // Called at the end of each header line, with special_value_ holding the value of a framing
+  // header.
+  void onHeaderComplete();
+  void onMessageComplete();
+  void onData(Status (ParserCallbacks::*callback)(const char*, size_t), const char* data,
+              size_t length, int error);
+  void onBody(const char* data, size_t length);
+  RcVal onEof();
+
+  // Whether the connection may carry another message after the current one.
+  bool shouldKeepAlive() const;
+  void setError(int error);
+
+  const MessageType type_;
+  ParserCallbacks* const callbacks_;
+  State state_;
+  int error_{};
+  bool paused_{};
+  // Set by an upgrade, after which the rest of the data belongs to another protocol.
+  bool stop_execution_{};
+
+  // Method, version and status code tokens as they are accumulated across calls.
+  std::string token_;
+  absl::string_view method_;
+  uint16_t status_code_{};
+  int http_major_{};
+  int http_minor_{};
+
+  // Header being parsed. header_name_ is only accumulated while it may still name a framing
+  // header.
+  std::string header_name_;
+  HeaderKind header_kind_{HeaderKind::Other};
+  std::string special_value_;
+  bool in_trailers_{};
+
+  // Framing of the current message.
+  absl::optional<uint64_t> content_length_;
+  bool has_transfer_encoding_{};
+  bool chunked_{};
+  bool connection_close_{};
+  bool connection_keep_alive_{};
+  bool skip_body_{};
+  bool upgrade_{};
+  // Remaining bytes of an identity body or of the current chunk, or the chunk size being parsed.
+  uint64_t remaining_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -82,6 +82,62 @@ int reasonToReset(StreamResetReason reason) {
 
 using Http2ResponseCodeDetails = ConstSingleton<Http2ResponseCodeDetailValues>;
 
+namespace {
+
+// The opaque data of the PINGs sent to estimate the bandwidth-delay product, which tells their
+// ACKs apart from those of keepalive PINGs. Those carry a timestamp in milliseconds, which this
+// ("bdp ping") won't be.
+constexpr uint64_t BdpPingData = 0x6264702070696e67;
+
+uint32_t
+maxAutoTunedConnectionWindowSize(const envoy::config::core::v3::Http2ProtocolOptions& options) {
+  if (!options.has_window_auto_tuning()) {
+    return 0;
+  }
+  return std::max(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+                      options.window_auto_tuning(), max_connection_window_size,
+                      ::Envoy::Http2::Utility::OptionsLimits::
+                          DEFAULT_MAX_AUTO_TUNED_CONNECTION_WINDOW_SIZE),
+                  options.initial_connection_window_size().value());
+}
+
+// The names and values of the static table of HPACK are referenced rather than copied.
+void setHeaderString(HeaderString& header_string, nghttp2_rcbuf* rcbuf) {
+  const nghttp2_vec buf = nghttp2_rcbuf_get_buf(rcbuf);
+  const absl::string_view view(reinterpret_cast<const char*>(buf.base), buf.len);
+  if (nghttp2_rcbuf_is_static(rcbuf)) {
+    header_string.setReference(view);
+  } else {
+    header_string.setCopy(view);
+  }
+}
+
+// The payload of a DATA frame referencing the input it was dispatched from, which it keeps alive.
+class DispatchedInputFragment : public Buffer::BufferFragment {
+public:
+  DispatchedInputFragment(absl::string_view data, std::shared_ptr<Buffer::OwnedImpl> input)
+      : data_(data), input_(std::move(input)) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_.data(); }
+  size_t size() const override { return data_.size(); }
+  void done() override { delete this; }
+
+private:
+  const absl::string_view data_;
+  const std::shared_ptr<Buffer::OwnedImpl> input_;
+};
+
+bool isInSlice(const Buffer::RawSlice* slice, const uint8_t* data, size_t len) {
+  if (slice == nullptr) {
+    return false;
+  }
+  const uint8_t* begin = static_cast<const uint8_t*>(slice->mem_);
+  return data >= begin && data + len <= begin + slice->len_;
+}
+
+} // namespace
+
 ReceivedSettingsImpl::ReceivedSettingsImpl(const nghttp2_settings& settings) {
   for (uint32_t i = 0; i < settings.niv; ++i) {
     if (settings.iv[i].settings_id == NGHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS) {
@@ -148,7 +204,8 @@ void ConnectionImpl::StreamImpl::destroy() {
   parent_.stats_.pending_send_bytes_.sub(pending_send_data_.length());
 }
 
-static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
+static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header,
+                         bool index) {
   uint8_t flags = 0;
   if (header.key().isReference()) {
     flags |= NGHTTP2_NV_FLAG_NO_COPY_NAME;
@@ -158,6 +215,9 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
   }
   const absl::string_view header_key = header.key().getStringView();
   const absl::string_view header_value = header.value().getStringView();
+  if (!index) {
+    flags |= NGHTTP2_NV_FLAG_NO_INDEX;
+  }
   headers.push_back({removeConst<uint8_t>(header_key.data()),
                      removeConst<uint8_t>(header_value.data()), header_key.size(),
                      header_value.size(), flags});
@@ -166,14 +226,20 @@ static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& he
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
                                               const HeaderMap& headers) {
   final_headers.reserve(headers.size());
-  headers.iterate([&final_headers](const HeaderEntry& header) -> HeaderMap::Iterate {
-    insertHeader(final_headers, header);
+  uint64_t header_bytes = 0;
+  headers.iterate([this, &final_headers,
+                   &header_bytes](const HeaderEntry& header) -> HeaderMap::Iterate {
+    const absl::string_view key = header.key().getStringView();
+    const absl::string_view value = header.value().getStringView();
+    insertHeader(final_headers, header, parent_.shouldIndexHeader(key, value));
+    header_bytes += key.size() + value.size();
     return HeaderMap::Iterate::Continue;
   });
+  parent_.stats_.tx_header_bytes_uncompressed_.add(header_bytes);
 }
 
 void ConnectionImpl::ServerStreamImpl::encode100ContinueHeaders(const ResponseHeaderMap& headers) {
-  ASSERT(headers.Status()->value() == "100");
+  ASSERT(headers.Status()->value() == "100" || headers.Status()->value() == "103");
   encodeHeaders(headers, false);
 }
 
@@ -582,8 +648,16 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, CodecStats& stat
       protocol_constraints_(stats, http2_options),
       skip_encoding_empty_trailers_(Runtime::runtimeFeatureEnabled(
           "envoy.reloadable_features.http2_skip_encoding_empty_trailers")),
+      reference_data_frames_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.http2_reference_data_frames")),
       dispatching_(false), raised_goaway_(false), pending_deferred_reset_(false),
-      random_(random_generator) {
+      random_(random_generator),
+      max_connection_window_size_(maxAutoTunedConnectionWindowSize(http2_options)),
+      connection_window_size_(http2_options.initial_connection_window_size().value()),
+      never_index_headers_(http2_options.header_indexing_policy().never_index_headers().begin(),
+                           http2_options.header_indexing_policy().never_index_headers().end()),
+      max_indexed_header_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          http2_options.header_indexing_policy(), max_indexed_header_size, 0)) {
   if (http2_options.has_connection_keepalive()) {
     keepalive_interval_ = std::chrono::milliseconds(
         PROTOBUF_GET_MS_REQUIRED(http2_options.connection_keepalive(), interval));
@@ -646,6 +720,49 @@ void ConnectionImpl::onKeepaliveResponseTimeout() {
   connection_.close(Network::ConnectionCloseType::NoFlush);
 }
 
+bool ConnectionImpl::shouldIndexHeader(absl::string_view key, absl::string_view value) const {
+  // The size of a dynamic table entry as defined by RFC 7541, section 4.1.
+  if (max_indexed_header_size_ != 0 && key.size() + value.size() + 32 > max_indexed_header_size_) {
+    return false;
+  }
+  return never_index_headers_.empty() || !never_index_headers_.contains(key);
+}
+
+void ConnectionImpl::onDataForWindowAutoTuning(size_t len) {
+  if (connection_window_size_ >= max_connection_window_size_) {
+    return;
+  }
+  if (bdp_ping_outstanding_) {
+    bdp_bytes_received_ += len;
+    return;
+  }
+  // Time the next round trip. The PING goes out with the frames sent after this dispatch.
+  int rc =
+      nghttp2_submit_ping(session_, 0 /*flags*/, reinterpret_cast<const uint8_t*>(&BdpPingData));
+  ASSERT(rc == 0);
+  bdp_ping_outstanding_ = true;
+  bdp_bytes_received_ = 0;
+}
+
+void ConnectionImpl::onBdpPingAck() {
+  bdp_ping_outstanding_ = false;
+  // The data received within a round trip is the current bandwidth-delay product, unless the
+  // window held the peer back. Once it fills most of the window, allow for twice as much.
+  if (bdp_bytes_received_ * 3 < uint64_t(connection_window_size_) * 2) {
+    return;
+  }
+  const uint32_t window_size = static_cast<uint32_t>(
+      std::min<uint64_t>(bdp_bytes_received_ * 2, max_connection_window_size_));
+  if (window_size <= connection_window_size_) {
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "growing connection-level window size from {} to {}", connection_,
+                 connection_window_size_, window_size);
+  int rc = nghttp2_session_set_local_window_size(session_, NGHTTP2_FLAG_NONE, 0, window_size);
+  ASSERT(rc == 0);
+  connection_window_size_ = window_size;
+}
+
 Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
   ScopeTrackerScopeState scope(this, connection_.dispatcher());
   ENVOY_CONN_LOG(trace, "dispatching {} bytes", connection_, data.length());
@@ -656,8 +773,17 @@ Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
     dispatching_ = false;
     current_slice_ = nullptr;
     current_stream_id_.reset();
+    dispatched_input_.reset();
   });
-  for (const Buffer::RawSlice& slice : data.getRawSlices()) {
+  Buffer::Instance* input = &data;
+  if (reference_data_frames_) {
+    // The slices of the input are moved rather than copied, so that the DATA frame payloads can
+    // keep referencing them once the input is drained.
+    dispatched_input_ = std::make_shared<Buffer::OwnedImpl>();
+    dispatched_input_->move(data);
+    input = dispatched_input_.get();
+  }
+  for (const Buffer::RawSlice& slice : input->getRawSlices()) {
     current_slice_ = &slice;
     dispatching_ = true;
     ssize_t rc =
@@ -682,8 +808,10 @@ Http::Status ConnectionImpl::dispatch(Buffer::Instance& data) {
     current_stream_id_.reset();
   }
 
-  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, data.length());
-  data.drain(data.length());
+  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, input->length());
+  if (dispatched_input_ == nullptr) {
+    data.drain(data.length());
+  }
 
   // Decoding incoming frames can generate outbound frames so flush pending.
   return sendPendingFrames();
@@ -701,7 +829,13 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   StreamImpl* stream = getStream(stream_id);
   // If this results in buffering too much data, the watermark buffer will call
   // pendingRecvBufferHighWatermark, resulting in ++read_disable_count_
-  stream->pending_recv_data_.add(data, len);
+  if (dispatched_input_ != nullptr && len >= MinReferencedDataLength &&
+      isInSlice(current_slice_, data, len)) {
+    stream->pending_recv_data_.addBufferFragment(*new DispatchedInputFragment(
+        {reinterpret_cast<const char*>(data), len}, dispatched_input_));
+  } else {
+    stream->pending_recv_data_.add(data, len);
+  }
   // Update the window to the peer unless some consumer of this stream's data has hit a flow control
   // limit and disabled reads on this stream
   if (!stream->buffersOverrun()) {
@@ -709,6 +843,9 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   } else {
     stream->unconsumed_bytes_ += len;
   }
+  if (max_connection_window_size_ != 0) {
+    onDataForWindowAutoTuning(len);
+  }
   return 0;
 }
 
@@ -785,7 +922,11 @@ Status ConnectionImpl::onFrameReceived(const nghttp2_frame* frame) {
     safeMemcpy(&data, &(frame->ping.opaque_data));
     ENVOY_CONN_LOG(trace, "recv PING ACK {}", connection_, data);
 
-    onKeepaliveResponse();
+    if (bdp_ping_outstanding_ && data == BdpPingData) {
+      onBdpPingAck();
+    } else {
+      onKeepaliveResponse();
+    }
     return okStatus();
   }
 
@@ -903,6 +1044,8 @@ int ConnectionImpl::onFrameSend(const nghttp2_frame* frame) {
   }
 
   case NGHTTP2_HEADERS:
+    stats_.tx_header_bytes_.add(frame->hd.length);
+    FALLTHRU;
   case NGHTTP2_DATA: {
     StreamImpl* stream = getStream(frame->hd.stream_id);
     stream->local_end_stream_sent_ = frame->hd.flags & NGHTTP2_FLAG_END_STREAM;
@@ -1266,15 +1409,14 @@ ConnectionImpl::Http2Callbacks::Http2Callbacks() {
             std::move(status));
       });
 
-  nghttp2_session_callbacks_set_on_header_callback(
+  nghttp2_session_callbacks_set_on_header_callback2(
       callbacks_,
-      [](nghttp2_session*, const nghttp2_frame* frame, const uint8_t* raw_name, size_t name_length,
-         const uint8_t* raw_value, size_t value_length, uint8_t, void* user_data) -> int {
-        // TODO PERF: Can reference count here to avoid copies.
+      [](nghttp2_session*, const nghttp2_frame* frame, nghttp2_rcbuf* raw_name,
+         nghttp2_rcbuf* raw_value, uint8_t, void* user_data) -> int {
         HeaderString name;
-        name.setCopy(reinterpret_cast<const char*>(raw_name), name_length);
+        setHeaderString(name, raw_name);
         HeaderString value;
-        value.setCopy(reinterpret_cast<const char*>(raw_value), value_length);
+        setHeaderString(value, raw_value);
         return static_cast<ConnectionImpl*>(user_data)->onHeader(frame, std::move(name),
                                                                  std::move(value));
       });
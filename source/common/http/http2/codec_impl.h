@@ -30,6 +30,7 @@
 #include "common/http/status.h"
 #include "common/http/utility.h"
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/types/optional.h"
 #include "nghttp2/nghttp2.h"
 
@@ -203,7 +204,7 @@ protected:
     ssize_t onDataSourceRead(uint64_t length, uint32_t* data_flags);
     void onDataSourceSend(const uint8_t* framehd, size_t length);
     void resetStreamWorker(StreamResetReason reason);
-    static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
+    void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
     void saveHeader(HeaderString&& name, HeaderString&& value);
     void encodeHeadersBase(const std::vector<nghttp2_nv>& final_headers, bool end_stream);
     virtual void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
@@ -237,6 +238,10 @@ protected:
     void setFlushTimeout(std::chrono::milliseconds timeout) override {
       stream_idle_timeout_ = timeout;
     }
+    void setAccount(Buffer::BufferMemoryAccountSharedPtr account) override {
+      pending_recv_data_.bindAccount(account);
+      pending_send_data_.bindAccount(std::move(account));
+    }
 
     // ScopeTrackedObject
     void dumpState(std::ostream& os, int indent_level) const override;
@@ -532,6 +537,13 @@ protected:
   // flag.
   const bool skip_encoding_empty_trailers_;
 
+  // With the "envoy.reloadable_features.http2_reference_data_frames" runtime feature, the DATA
+  // frame payloads of at least MinReferencedDataLength bytes reference the dispatched input rather
+  // than being copied into the receive buffers of the streams. The smaller ones are still copied,
+  // so that they don't pin a whole slice of input each.
+  static constexpr size_t MinReferencedDataLength = 4096;
+  const bool reference_data_frames_;
+
   // dumpState helper method.
   virtual void dumpStreams(std::ostream& os, int indent_level) const;
 
@@ -559,10 +571,18 @@ private:
   void sendKeepalive();
   void onKeepaliveResponse();
   void onKeepaliveResponseTimeout();
+  // Connection window auto tuning: counts DATA received while a BDP PING is outstanding, and grows
+  // the connection window once the PING is acknowledged.
+  void onDataForWindowAutoTuning(size_t len);
+  void onBdpPingAck();
+  // Whether the header indexing policy allows adding a header to the HPACK dynamic table.
+  bool shouldIndexHeader(absl::string_view key, absl::string_view value) const;
   virtual StreamResetReason getMessagingErrorResetReason() const PURE;
 
   // Tracks the current slice we're processing in the dispatch loop.
   const Buffer::RawSlice* current_slice_ = nullptr;
+  // The input being dispatched, shared with the DATA frame payloads referencing it.
+  std::shared_ptr<Buffer::OwnedImpl> dispatched_input_;
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
   bool pending_deferred_reset_ : 1;
@@ -573,6 +593,14 @@ private:
   std::chrono::milliseconds keepalive_interval_;
   std::chrono::milliseconds keepalive_timeout_;
   uint32_t keepalive_interval_jitter_percent_;
+  // The largest connection window auto tuning may grow to, or 0 if it is disabled.
+  const uint32_t max_connection_window_size_;
+  uint32_t connection_window_size_;
+  uint64_t bdp_bytes_received_{};
+  bool bdp_ping_outstanding_{};
+  // The header indexing policy. A max_indexed_header_size_ of 0 leaves the size limit to nghttp2.
+  const absl::flat_hash_set<std::string> never_index_headers_;
+  const uint32_t max_indexed_header_size_;
 };
 
 /**
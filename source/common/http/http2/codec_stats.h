@@ -26,6 +26,8 @@ namespace Http2 {
   COUNTER(rx_reset)                                                                                \
   COUNTER(trailers)                                                                                \
   COUNTER(tx_flush_timeout)                                                                        \
+  COUNTER(tx_header_bytes)                                                                         \
+  COUNTER(tx_header_bytes_uncompressed)                                                            \
   COUNTER(tx_reset)                                                                                \
   COUNTER(keepalive_timeout)                                                                       \
   GAUGE(streams_active, Accumulate)                                                                \
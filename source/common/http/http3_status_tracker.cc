@@ -0,0 +1,50 @@
+#include "common/http/http3_status_tracker.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Envoy {
+namespace Http {
+
+namespace {
+
+// HTTP/3 is first marked broken for 5 minutes.
+constexpr std::chrono::minutes DefaultExpirationTime{5};
+// Caps the broken period at 5 * 2^5 = 160 minutes.
+constexpr uint32_t MaxConsecutiveBrokenCount = 5;
+
+} // namespace
+
+Http3StatusTracker::Http3StatusTracker(Event::Dispatcher& dispatcher)
+    : expiration_timer_(dispatcher.createTimer([this]() -> void { onExpirationTimeout(); })) {}
+
+bool Http3StatusTracker::isHttp3Broken() const { return state_ == State::Broken; }
+
+bool Http3StatusTracker::isHttp3Confirmed() const { return state_ == State::Confirmed; }
+
+void Http3StatusTracker::markHttp3Broken() {
+  state_ = State::Broken;
+  if (!expiration_timer_->enabled()) {
+    expiration_timer_->enableTimer(std::chrono::duration_cast<std::chrono::milliseconds>(
+        DefaultExpirationTime * (1 << consecutive_broken_count_)));
+    consecutive_broken_count_ = std::min(consecutive_broken_count_ + 1, MaxConsecutiveBrokenCount);
+  }
+}
+
+void Http3StatusTracker::markHttp3Confirmed() {
+  state_ = State::Confirmed;
+  consecutive_broken_count_ = 0;
+  expiration_timer_->disableTimer();
+}
+
+void Http3StatusTracker::onExpirationTimeout() {
+  if (state_ != State::Broken) {
+    return;
+  }
+
+  // HTTP/3 will be attempted again, and marked broken again for twice as long if it still fails.
+  state_ = State::Pending;
+}
+
+} // namespace Http
+} // namespace Envoy
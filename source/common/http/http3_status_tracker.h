@@ -0,0 +1,44 @@
+#pragma once
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+
+namespace Envoy {
+namespace Http {
+
+// Tracks the status of HTTP/3 to an origin: whether it's pending, broken or confirmed to work.
+// HTTP/3 is marked broken when its connection attempt failed while the TCP one succeeded, so that
+// the following streams go straight to TCP instead of paying for the failed attempt again. The
+// broken status expires after a period doubling each consecutive time HTTP/3 is marked broken.
+class Http3StatusTracker {
+public:
+  explicit Http3StatusTracker(Event::Dispatcher& dispatcher);
+
+  // Returns true if HTTP/3 is broken.
+  bool isHttp3Broken() const;
+  // Returns true if HTTP/3 is confirmed to be working.
+  bool isHttp3Confirmed() const;
+  // Marks HTTP/3 broken for a period of time, subject to backoff.
+  void markHttp3Broken();
+  // Marks HTTP/3 as confirmed to be working and resets the backoff.
+  void markHttp3Confirmed();
+
+private:
+  enum class State {
+    Pending,
+    Broken,
+    Confirmed,
+  };
+
+  // Called when the broken status expires.
+  void onExpirationTimeout();
+
+  State state_{State::Pending};
+  // The number of consecutive times HTTP/3 has been marked broken.
+  uint32_t consecutive_broken_count_{};
+  // The timer which tracks when the broken status expires.
+  const Event::TimerPtr expiration_timer_;
+};
+
+} // namespace Http
+} // namespace Envoy
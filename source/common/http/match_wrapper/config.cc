@@ -77,6 +77,10 @@ struct DelegatingFactoryCallbacks : public Envoy::Http::FilterChainFactoryCallba
   void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
     delegated_callbacks_.addAccessLogHandler(std::move(handler));
   }
+  Arena* streamArena() override { return delegated_callbacks_.streamArena(); }
+  void setFilterConfigName(absl::string_view name) override {
+    delegated_callbacks_.setFilterConfigName(name);
+  }
 
   Envoy::Http::FilterChainFactoryCallbacks& delegated_callbacks_;
   Matcher::MatchTreeSharedPtr<Envoy::Http::HttpMatchingData> match_tree_;
@@ -1,5 +1,7 @@
 #include "common/http/path_utility.h"
 
+#include <array>
+
 #include "common/common/logger.h"
 #include "common/http/legacy_path_canonicalizer.h"
 #include "common/runtime/runtime_features.h"
@@ -29,14 +31,97 @@ absl::optional<std::string> canonicalizePath(absl::string_view original_path) {
   }
   return LegacyPathCanonicalizer::canonicalizePath(original_path);
 }
+
+// The characters that the canonicalization leaves as they are: the unreserved characters and the
+// sub-delimiters of RFC 3986, ':', '@' and '/'. The dots are only left as they are outside of the
+// dot segments.
+constexpr std::array<bool, 256> canonicalPathChars() {
+  std::array<bool, 256> table{};
+  for (int c = 'a'; c <= 'z'; c++) {
+    table[c] = true;
+  }
+  for (int c = 'A'; c <= 'Z'; c++) {
+    table[c] = true;
+  }
+  for (int c = '0'; c <= '9'; c++) {
+    table[c] = true;
+  }
+  for (const char c : absl::string_view("-._~!$&'()*+,;=:@/")) {
+    table[static_cast<uint8_t>(c)] = true;
+  }
+  return table;
+}
+
+constexpr std::array<bool, 256> CanonicalPathChars = canonicalPathChars();
+
+// Scans the path component of a :path, without its query, in a single pass.
+struct PathScan {
+  // Whether the canonicalization leaves the path as it is.
+  bool canonical_{true};
+  bool has_adjacent_slashes_{};
+};
+
+PathScan scanPath(absl::string_view path) {
+  PathScan scan;
+  if (path.empty() || path[0] != '/') {
+    scan.canonical_ = false;
+    return scan;
+  }
+  const size_t size = path.size();
+  for (size_t i = 1; i < size; i++) {
+    const char c = path[i];
+    if (!CanonicalPathChars[static_cast<uint8_t>(c)]) {
+      scan.canonical_ = false;
+      return scan;
+    }
+    if (path[i - 1] != '/') {
+      continue;
+    }
+    if (c == '/') {
+      scan.has_adjacent_slashes_ = true;
+    } else if (c == '.') {
+      // The "." and ".." segments are removed.
+      const size_t dots = (i + 1 < size && path[i + 1] == '.') ? 2 : 1;
+      if (i + dots == size || path[i + dots] == '/') {
+        scan.canonical_ = false;
+        return scan;
+      }
+    }
+  }
+  return scan;
+}
 } // namespace
 
+/* static */
+bool PathUtil::normalizePath(RequestHeaderMap& headers, bool canonicalize, bool merge_slashes) {
+  ASSERT(headers.Path());
+  if (canonicalize) {
+    const PathScan scan = scanPath(removeQuery(headers.getPathValue()));
+    if (!scan.canonical_) {
+      if (!canonicalPath(headers)) {
+        return false;
+      }
+    } else if (!scan.has_adjacent_slashes_) {
+      return true;
+    }
+  }
+  // Merge slashes after path normalization to catch potential edge cases with percent encoding.
+  if (merge_slashes) {
+    mergeSlashes(headers);
+  }
+  return true;
+}
+
 /* static */
 bool PathUtil::canonicalPath(RequestHeaderMap& headers) {
   ASSERT(headers.Path());
   const auto original_path = headers.getPathValue();
   // canonicalPath is supposed to apply on path component in URL instead of :path header
   const auto query_pos = original_path.find('?');
+  // Most paths are already canonical, which is found without copying them.
+  if (scanPath(original_path.substr(0, query_pos)).canonical_) {
+    return true;
+  }
   auto normalized_path_opt = canonicalizePath(
       query_pos == original_path.npos
           ? original_path
@@ -75,6 +160,10 @@ void PathUtil::mergeSlashes(RequestHeaderMap& headers) {
                                path_suffix, query));
 }
 
+absl::string_view PathUtil::removeQuery(const absl::string_view path) {
+  return path.substr(0, path.find('?'));
+}
+
 absl::string_view PathUtil::removeQueryAndFragment(const absl::string_view path) {
   absl::string_view ret = path;
   // Trim query parameters and/or fragment if present.
@@ -19,6 +19,12 @@ public:
   // Merges two or more adjacent slashes in path part of URI into one.
   // Requires the Path header be present.
   static void mergeSlashes(RequestHeaderMap& headers);
+  // Normalizes the path with canonicalPath() if canonicalize is true, then merges its adjacent
+  // slashes if merge_slashes is true. A path which is already normal is only scanned once.
+  // Returns false if the normalization fails. Requires the Path header be present.
+  static bool normalizePath(RequestHeaderMap& headers, bool canonicalize, bool merge_slashes);
+  // Removes the query string (if present) from the input path.
+  static absl::string_view removeQuery(const absl::string_view path);
   // Removes the query and/or fragment string (if present) from the input path.
   // For example, this function returns "/data" for the input path "/data?param=value#fragment".
   static absl::string_view removeQueryAndFragment(const absl::string_view path);
@@ -505,8 +505,8 @@ void Utility::sendLocalReply(const bool& is_reset, const EncodeFunctions& encode
   std::string body_text(local_reply_data.body_text_);
   absl::string_view content_type(Headers::get().ContentTypeValues.Text);
 
-  ResponseHeaderMapPtr response_headers{createHeaderMap<ResponseHeaderMapImpl>(
-      {{Headers::get().Status, std::to_string(enumToInt(response_code))}})};
+  ResponseHeaderMapPtr response_headers = ResponseHeaderMapImpl::create();
+  response_headers->setStatus(enumToInt(response_code));
 
   if (encode_functions.modify_headers_) {
     encode_functions.modify_headers_(*response_headers);
@@ -517,14 +517,14 @@ void Utility::sendLocalReply(const bool& is_reset, const EncodeFunctions& encode
 
   // Respond with a gRPC trailers-only response if the request is gRPC
   if (local_reply_data.is_grpc_) {
-    response_headers->setStatus(std::to_string(enumToInt(Code::OK)));
+    response_headers->setStatus(enumToInt(Code::OK));
     response_headers->setReferenceContentType(Headers::get().ContentTypeValues.Grpc);
 
     if (response_headers->getGrpcStatusValue().empty()) {
-      response_headers->setGrpcStatus(std::to_string(
+      response_headers->setGrpcStatus(
           enumToInt(local_reply_data.grpc_status_
                         ? local_reply_data.grpc_status_.value()
-                        : Grpc::Utility::httpToGrpcStatus(enumToInt(response_code)))));
+                        : Grpc::Utility::httpToGrpcStatus(enumToInt(response_code))));
     }
 
     if (!body_text.empty() && !local_reply_data.is_head_request_) {
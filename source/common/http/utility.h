@@ -89,6 +89,8 @@ struct OptionsLimits {
   // our default connection-level window also equals to our stream-level
   static const uint32_t DEFAULT_INITIAL_CONNECTION_WINDOW_SIZE = 256 * 1024 * 1024;
   static const uint32_t MAX_INITIAL_CONNECTION_WINDOW_SIZE = (1U << 31) - 1;
+  // Upper bound of an auto tuned connection-level window, unless configured otherwise.
+  static const uint32_t DEFAULT_MAX_AUTO_TUNED_CONNECTION_WINDOW_SIZE = 16 * 1024 * 1024;
 
   // Default limit on the number of outbound frames of all types.
   static const uint32_t DEFAULT_MAX_OUTBOUND_FRAMES = 10000;
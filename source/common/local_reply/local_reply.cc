@@ -18,9 +18,8 @@ namespace LocalReply {
 
 class BodyFormatter {
 public:
-  BodyFormatter()
-      : formatter_(std::make_unique<Envoy::Formatter::FormatterImpl>("%LOCAL_REPLY_BODY%")),
-        content_type_(Http::Headers::get().ContentTypeValues.Text) {}
+  // The default formatter leaves the body as is, so it doesn't need a formatter.
+  BodyFormatter() : content_type_(Http::Headers::get().ContentTypeValues.Text) {}
 
   BodyFormatter(const envoy::config::core::v3::SubstitutionFormatString& config, Api::Api& api)
       : formatter_(Formatter::SubstitutionFormatStringUtils::fromProtoConfig(config, api)),
@@ -36,8 +35,10 @@ public:
               const Http::ResponseTrailerMap& response_trailers,
               const StreamInfo::StreamInfo& stream_info, std::string& body,
               absl::string_view& content_type) const {
-    body =
-        formatter_->format(request_headers, response_headers, response_trailers, stream_info, body);
+    if (formatter_ != nullptr) {
+      body = formatter_->format(request_headers, response_headers, response_trailers, stream_info,
+                                body);
+    }
     content_type = content_type_;
   }
 
@@ -91,7 +92,7 @@ public:
 
     if (status_code_.has_value() && code != status_code_.value()) {
       code = status_code_.value();
-      response_headers.setStatus(std::to_string(enumToInt(code)));
+      response_headers.setStatus(enumToInt(code));
       stream_info.setResponseCode(static_cast<uint32_t>(code));
     }
 
@@ -134,7 +135,7 @@ public:
     // Set response code to stream_info and response_headers due to:
     // 1) StatusCode filter is using response_code from stream_info,
     // 2) %RESP(:status)% is from Status() in response_headers.
-    response_headers.setStatus(std::to_string(enumToInt(code)));
+    response_headers.setStatus(enumToInt(code));
     stream_info.setResponseCode(static_cast<uint32_t>(code));
 
     if (request_headers == nullptr) {
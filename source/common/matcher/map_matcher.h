@@ -0,0 +1,68 @@
+#pragma once
+
+#include "envoy/matcher/matcher.h"
+
+#include "common/common/assert.h"
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Matcher {
+
+/**
+ * Implementation of a map matcher which performs matches against the data provided by DataType.
+ * If the match could not be completed, {MatchState::UnableToMatch, {}} will be returned. If the
+ * match result was determined, {MatchState::MatchComplete, on_match} will be returned. If the match
+ * result was determined to be no match, {MatchState::MatchComplete, on_no_match} will be returned.
+ */
+template <class DataType>
+class MapMatcher : public MatchTree<DataType>, Logger::Loggable<Logger::Id::matcher> {
+public:
+  // Adds a child to the map.
+  virtual void addChild(std::string value, OnMatch<DataType>&& on_match) PURE;
+
+  typename MatchTree<DataType>::MatchResult match(const DataType& data) override {
+    const auto input = data_input_->get(data);
+    ENVOY_LOG(debug, "Attempting to match {}", input);
+    if (input.data_availability_ == DataInputGetResult::DataAvailability::NotAvailable) {
+      return {MatchState::UnableToMatch, absl::nullopt};
+    }
+
+    if (!input.data_) {
+      return {MatchState::MatchComplete, on_no_match_};
+    }
+
+    const auto result = doMatch(*input.data_);
+    if (result) {
+      if (result->matcher_) {
+        return result->matcher_->match(data);
+      } else {
+        return {MatchState::MatchComplete, OnMatch<DataType>{result->action_cb_, nullptr}};
+      }
+    } else if (input.data_availability_ ==
+               DataInputGetResult::DataAvailability::MoreDataMightBeAvailable) {
+      // It's possible that we were attempting a lookup with a partial value, so delay matching
+      // until we know that we actually failed.
+      return {MatchState::UnableToMatch, absl::nullopt};
+    }
+
+    return {MatchState::MatchComplete, on_no_match_};
+  }
+
+protected:
+  MapMatcher(DataInputPtr<DataType>&& data_input, absl::optional<OnMatch<DataType>> on_no_match)
+      : data_input_(std::move(data_input)), on_no_match_(std::move(on_no_match)) {}
+
+  /**
+   * Looks up the OnMatch of the input value.
+   * @param data supplies the input value.
+   * @return the OnMatch of the value, or absl::nullopt if the value doesn't match any child.
+   */
+  virtual absl::optional<OnMatch<DataType>> doMatch(absl::string_view data) PURE;
+
+private:
+  const DataInputPtr<DataType> data_input_;
+  const absl::optional<OnMatch<DataType>> on_no_match_;
+};
+
+} // namespace Matcher
+} // namespace Envoy
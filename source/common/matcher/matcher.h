@@ -13,6 +13,7 @@
 #include "common/matcher/exact_map_matcher.h"
 #include "common/matcher/field_matcher.h"
 #include "common/matcher/list_matcher.h"
+#include "common/matcher/prefix_map_matcher.h"
 #include "common/matcher/validation_visitor.h"
 #include "common/matcher/value_input_matcher.h"
 
@@ -124,25 +125,33 @@ private:
   MatchTreeSharedPtr<DataType>
   createTreeMatcher(const envoy::config::common::matcher::v3::Matcher& matcher) {
     switch (matcher.matcher_tree().tree_type_case()) {
-    case envoy::config::common::matcher::v3::Matcher_MatcherTree::kExactMatchMap: {
-      auto multimap_matcher = std::make_shared<ExactMapMatcher<DataType>>(
-          createDataInput(matcher.matcher_tree().input()), createOnMatch(matcher.on_no_match()));
-
-      for (const auto& children : matcher.matcher_tree().exact_match_map().map()) {
-        multimap_matcher->addChild(children.first,
-                                   *MatchTreeFactory::createOnMatch(children.second));
-      }
-
-      return multimap_matcher;
-    }
+    case envoy::config::common::matcher::v3::Matcher_MatcherTree::kExactMatchMap:
+      return createMapMatcher<ExactMapMatcher>(matcher,
+                                               matcher.matcher_tree().exact_match_map().map());
     case envoy::config::common::matcher::v3::Matcher_MatcherTree::kPrefixMatchMap:
-      NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+      return createMapMatcher<PrefixMapMatcher>(matcher,
+                                                matcher.matcher_tree().prefix_match_map().map());
     case envoy::config::common::matcher::v3::Matcher_MatcherTree::kCustomMatch:
       NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
   }
+
+  template <template <class> class MapMatcherType, class ChildrenType>
+  MatchTreeSharedPtr<DataType>
+  createMapMatcher(const envoy::config::common::matcher::v3::Matcher& matcher,
+                   const ChildrenType& children) {
+    auto map_matcher = std::make_shared<MapMatcherType<DataType>>(
+        createDataInput(matcher.matcher_tree().input()), createOnMatch(matcher.on_no_match()));
+
+    for (const auto& child : children) {
+      map_matcher->addChild(child.first, *MatchTreeFactory::createOnMatch(child.second));
+    }
+
+    return map_matcher;
+  }
+
   absl::optional<OnMatch<DataType>>
   createOnMatch(const envoy::config::common::matcher::v3::Matcher::OnMatch& on_match) {
     if (on_match.has_matcher()) {
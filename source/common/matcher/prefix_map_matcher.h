@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common/common/utility.h"
+#include "common/matcher/map_matcher.h"
+
+namespace Envoy {
+namespace Matcher {
+
+/**
+ * Implementation of a trie match tree which resolves to the OnMatch of the longest prefix of the
+ * input value, in time linear in the length of the value rather than in the number of prefixes.
+ */
+template <class DataType> class PrefixMapMatcher : public MapMatcher<DataType> {
+public:
+  PrefixMapMatcher(DataInputPtr<DataType>&& data_input,
+                   absl::optional<OnMatch<DataType>> on_no_match)
+      : MapMatcher<DataType>(std::move(data_input), std::move(on_no_match)) {}
+
+  void addChild(std::string value, OnMatch<DataType>&& on_match) override {
+    const bool added =
+        children_.add(value, std::make_shared<OnMatch<DataType>>(std::move(on_match)), false);
+    ASSERT(added);
+  }
+
+protected:
+  absl::optional<OnMatch<DataType>> doMatch(absl::string_view data) override {
+    const auto result = children_.findLongestPrefix(data);
+    if (result) {
+      return *result;
+    }
+
+    return absl::nullopt;
+  }
+
+private:
+  TrieLookupTable<std::shared_ptr<OnMatch<DataType>>> children_;
+};
+
+} // namespace Matcher
+} // namespace Envoy
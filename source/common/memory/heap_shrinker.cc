@@ -13,11 +13,14 @@ constexpr std::chrono::milliseconds kTimerInterval = std::chrono::milliseconds(1
 
 HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManager& overload_manager,
                            Stats::Scope& stats)
-    : active_(false) {
+    : active_(false), slice_pool_stats_(Buffer::SlicePool::generateStats(stats)) {
+  Buffer::SlicePool::setStats(&slice_pool_stats_);
   const auto action_name = Server::OverloadActionNames::get().ShrinkHeap;
-  if (overload_manager.registerForAction(
-          action_name, dispatcher,
-          [this](Server::OverloadActionState state) { active_ = state.isSaturated(); })) {
+  if (overload_manager.registerForAction(action_name, dispatcher,
+                                         [this](Server::OverloadActionState state) {
+                                           active_ = state.isSaturated();
+                                           Buffer::SlicePool::setMemoryPressure(active_);
+                                         })) {
     Envoy::Stats::StatNameManagedStorage stat_name(
         absl::StrCat("overload.", action_name, ".shrink_count"), stats.symbolTable());
     shrink_counter_ = &stats.counterFromStatName(stat_name.statName());
@@ -29,6 +32,8 @@ HeapShrinker::HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManage
   }
 }
 
+HeapShrinker::~HeapShrinker() { Buffer::SlicePool::setStats(nullptr); }
+
 void HeapShrinker::shrinkHeap() {
   if (active_) {
     Utils::releaseFreeMemory();
@@ -5,17 +5,22 @@
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats.h"
 
+#include "common/buffer/slice_pool.h"
+
 namespace Envoy {
 namespace Memory {
 
 /**
  * A utility class to periodically attempt to shrink the heap by releasing free memory
  * to the system if the "shrink heap" overload action has been configured and triggered.
+ * The slice pool of its thread is trimmed while the action is triggered, and the slice pools of
+ * all the threads report their stats to its scope.
  */
 class HeapShrinker {
 public:
   HeapShrinker(Event::Dispatcher& dispatcher, Server::OverloadManager& overload_manager,
                Envoy::Stats::Scope& stats);
+  ~HeapShrinker();
 
 private:
   void shrinkHeap();
@@ -23,6 +28,7 @@ private:
   bool active_;
   Envoy::Stats::Counter* shrink_counter_;
   Envoy::Event::TimerPtr timer_;
+  Buffer::SlicePoolStats slice_pool_stats_;
 };
 
 } // namespace Memory
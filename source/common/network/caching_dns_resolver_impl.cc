@@ -0,0 +1,168 @@
+#include "common/network/caching_dns_resolver_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+CachingDnsResolverImpl::CachingDnsResolverImpl(DnsResolverSharedPtr resolver,
+                                               const CachingDnsResolverConfig& config,
+                                               TimeSource& time_source, Stats::Scope& scope)
+    : resolver_(std::move(resolver)), config_(config), time_source_(time_source),
+      stats_{ALL_CACHING_DNS_RESOLVER_STATS(POOL_COUNTER_PREFIX(scope, "dns_resolution_cache."),
+                                            POOL_GAUGE_PREFIX(scope, "dns_resolution_cache."))} {}
+
+CachingDnsResolverImpl::~CachingDnsResolverImpl() {
+  // The wrapped resolver may outlive this one, and its callbacks refer to it.
+  for (auto& in_flight : in_flight_) {
+    in_flight.second.query_->cancel();
+  }
+  stats_.cache_entries_.sub(cache_.size());
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::resolve(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveCb callback) {
+  const Key key{dns_name, dns_lookup_family};
+  auto entry = cache_.find(key);
+  if (entry != cache_.end()) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    if (now < entry->second.expiry_time_) {
+      stats_.cache_hits_.inc();
+      // The callback may resolve names in turn, and the prefetch may complete inline, both of
+      // which may replace the entry.
+      const ResolutionStatus status = entry->second.status_;
+      std::list<DnsResponse> responses = entry->second.responses_;
+      if (now >= entry->second.prefetch_time_ && !in_flight_.contains(key)) {
+        ENVOY_LOG(debug, "prefetching DNS resolution of {}", dns_name);
+        stats_.prefetches_.inc();
+        startResolution(key, in_flight_[key]);
+      }
+      callback(status, std::move(responses));
+      return nullptr;
+    }
+    removeEntry(entry);
+  }
+
+  stats_.cache_misses_.inc();
+  auto in_flight = in_flight_.find(key);
+  const bool coalesced = in_flight != in_flight_.end();
+  if (!coalesced) {
+    in_flight = in_flight_.try_emplace(key).first;
+  } else {
+    stats_.coalesced_queries_.inc();
+  }
+  auto pending_query = std::make_unique<PendingQuery>(*this, key, std::move(callback));
+  PendingQuery* pending_query_ptr = pending_query.get();
+  in_flight->second.pending_queries_.push_back(std::move(pending_query));
+  if (!coalesced && !startResolution(key, in_flight->second)) {
+    return nullptr;
+  }
+  return pending_query_ptr;
+}
+
+bool CachingDnsResolverImpl::startResolution(const Key& key, InFlightResolution& in_flight) {
+  ActiveDnsQuery* query =
+      resolver_->resolve(key.first, key.second,
+                         [this, key](ResolutionStatus status, std::list<DnsResponse>&& responses) {
+                           onResolution(key, status, std::move(responses));
+                         });
+  if (query == nullptr) {
+    // The callback was called inline, which removed the resolution.
+    return false;
+  }
+  in_flight.query_ = query;
+  return true;
+}
+
+void CachingDnsResolverImpl::onResolution(const Key& key, ResolutionStatus status,
+                                          std::list<DnsResponse>&& responses) {
+  auto in_flight = in_flight_.find(key);
+  ASSERT(in_flight != in_flight_.end());
+  std::vector<PendingQueryPtr> pending_queries = std::move(in_flight->second.pending_queries_);
+  in_flight_.erase(in_flight);
+  cacheResolution(key, status, responses);
+
+  // The callbacks may cancel the queries that weren't answered yet.
+  for (const PendingQueryPtr& pending_query : pending_queries) {
+    if (!pending_query->cancelled_) {
+      pending_query->callback_(status, std::list<DnsResponse>(responses));
+    }
+  }
+}
+
+void CachingDnsResolverImpl::PendingQuery::cancel() {
+  cancelled_ = true;
+  parent_.onQueryCancelled(key_);
+}
+
+void CachingDnsResolverImpl::onQueryCancelled(const Key& key) {
+  auto in_flight = in_flight_.find(key);
+  if (in_flight == in_flight_.end()) {
+    // The query was cancelled by the callback of another query of the same resolution.
+    return;
+  }
+  const auto& pending_queries = in_flight->second.pending_queries_;
+  if (std::all_of(pending_queries.begin(), pending_queries.end(),
+                  [](const PendingQueryPtr& pending_query) { return pending_query->cancelled_; })) {
+    in_flight->second.query_->cancel();
+    in_flight_.erase(in_flight);
+  }
+}
+
+void CachingDnsResolverImpl::cacheResolution(const Key& key, ResolutionStatus status,
+                                             const std::list<DnsResponse>& responses) {
+  const MonotonicTime now = time_source_.monotonicTime();
+  auto entry = cache_.find(key);
+  const bool positive = status == ResolutionStatus::Success && !responses.empty();
+  std::chrono::milliseconds ttl = config_.negative_ttl_;
+  if (positive) {
+    ttl = config_.max_ttl_;
+    for (const DnsResponse& response : responses) {
+      ttl = std::min<std::chrono::milliseconds>(ttl, response.ttl_);
+    }
+  } else if (entry != cache_.end() && now < entry->second.expiry_time_ &&
+             !entry->second.responses_.empty()) {
+    // A failed refresh keeps the addresses that didn't expire yet.
+    return;
+  }
+
+  if (ttl.count() == 0) {
+    if (entry != cache_.end()) {
+      removeEntry(entry);
+    }
+    return;
+  }
+  if (entry == cache_.end()) {
+    if (cache_.size() >= config_.max_entries_) {
+      ENVOY_LOG(debug, "evicting DNS resolution of {}", lru_.back().first);
+      stats_.cache_evictions_.inc();
+      removeEntry(cache_.find(lru_.back()));
+    }
+    entry = cache_.try_emplace(key).first;
+    lru_.push_front(key);
+    entry->second.lru_position_ = lru_.begin();
+    stats_.cache_entries_.inc();
+  } else {
+    lru_.splice(lru_.begin(), lru_, entry->second.lru_position_);
+  }
+  entry->second.status_ = status;
+  // DnsResponse can't be assigned, only copied.
+  entry->second.responses_ = std::list<DnsResponse>(responses);
+  entry->second.expiry_time_ = now + ttl;
+  entry->second.prefetch_time_ = entry->second.expiry_time_;
+  if (positive) {
+    entry->second.prefetch_time_ -= ttl * config_.prefetch_percent_ / 100;
+  }
+}
+
+void CachingDnsResolverImpl::removeEntry(absl::node_hash_map<Key, CacheEntry>::iterator entry) {
+  lru_.erase(entry->second.lru_position_);
+  cache_.erase(entry);
+  stats_.cache_entries_.dec();
+}
+
+} // namespace Network
+} // namespace Envoy
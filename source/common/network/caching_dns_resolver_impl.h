@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/network/dns.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+
+#include "absl/container/node_hash_map.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All the stats of a caching DNS resolver. @see stats_macros.h
+ */
+#define ALL_CACHING_DNS_RESOLVER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(cache_evictions)                                                                         \
+  COUNTER(cache_hits)                                                                              \
+  COUNTER(cache_misses)                                                                            \
+  COUNTER(coalesced_queries)                                                                       \
+  COUNTER(prefetches)                                                                              \
+  GAUGE(cache_entries, NeverImport)
+
+/**
+ * Struct definition for the stats of a caching DNS resolver. @see stats_macros.h
+ */
+struct CachingDnsResolverStats {
+  ALL_CACHING_DNS_RESOLVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * The options of a caching DNS resolver.
+ */
+struct CachingDnsResolverConfig {
+  // The maximum number of names cached.
+  uint32_t max_entries_{1024};
+  // The maximum time a resolution is cached for, whatever the TTL of its addresses.
+  std::chrono::milliseconds max_ttl_{300000};
+  // The time a failed resolution, or one without any address, is cached for.
+  std::chrono::milliseconds negative_ttl_{5000};
+  // The percentage of the TTL left when a lookup refreshes the cached resolution.
+  uint32_t prefetch_percent_{10};
+};
+
+/**
+ * A DnsResolver that caches the resolutions of another resolver for the smallest TTL of their
+ * addresses, the failed resolutions for the negative TTL, and coalesces the concurrent
+ * resolutions of a name into a single query. A lookup of a name whose entry is about to expire is
+ * answered from the cache, and refreshes the entry in the background.
+ *
+ * The cached resolutions are answered inline, with resolve() returning nullptr. Like the resolver
+ * it wraps, all calls and callbacks happen on the thread that owns its dispatcher.
+ */
+class CachingDnsResolverImpl : public DnsResolver, Logger::Loggable<Logger::Id::upstream> {
+public:
+  CachingDnsResolverImpl(DnsResolverSharedPtr resolver, const CachingDnsResolverConfig& config,
+                         TimeSource& time_source, Stats::Scope& scope);
+  ~CachingDnsResolverImpl() override;
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+
+private:
+  using Key = std::pair<std::string, DnsLookupFamily>;
+
+  struct CacheEntry {
+    ResolutionStatus status_;
+    std::list<DnsResponse> responses_;
+    MonotonicTime prefetch_time_;
+    MonotonicTime expiry_time_;
+    // The position of the name in lru_.
+    std::list<Key>::iterator lru_position_;
+  };
+
+  // A caller waiting for a resolution in flight.
+  struct PendingQuery : public ActiveDnsQuery {
+    PendingQuery(CachingDnsResolverImpl& parent, const Key& key, ResolveCb callback)
+        : parent_(parent), key_(key), callback_(std::move(callback)) {}
+
+    // Network::ActiveDnsQuery
+    void cancel() override;
+
+    CachingDnsResolverImpl& parent_;
+    const Key key_;
+    const ResolveCb callback_;
+    bool cancelled_{};
+  };
+
+  using PendingQueryPtr = std::unique_ptr<PendingQuery>;
+
+  struct InFlightResolution {
+    ActiveDnsQuery* query_{};
+    std::vector<PendingQueryPtr> pending_queries_;
+  };
+
+  /**
+   * Starts the resolution of a name with the wrapped resolver.
+   * @return whether the resolution is still in flight, or false if it completed inline.
+   */
+  bool startResolution(const Key& key, InFlightResolution& in_flight);
+  void onResolution(const Key& key, ResolutionStatus status, std::list<DnsResponse>&& responses);
+  void onQueryCancelled(const Key& key);
+  void cacheResolution(const Key& key, ResolutionStatus status,
+                       const std::list<DnsResponse>& responses);
+  void removeEntry(absl::node_hash_map<Key, CacheEntry>::iterator entry);
+
+  const DnsResolverSharedPtr resolver_;
+  const CachingDnsResolverConfig config_;
+  TimeSource& time_source_;
+  CachingDnsResolverStats stats_;
+  absl::node_hash_map<Key, CacheEntry> cache_;
+  // The cached names, the most recently resolved first.
+  std::list<Key> lru_;
+  absl::node_hash_map<Key, InFlightResolution> in_flight_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -34,5 +34,72 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+void WorkStealingConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  handlers_.push_back(&handler);
+}
+
+void WorkStealingConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  handlers_.erase(std::find(handlers_.begin(), handlers_.end(), &handler));
+}
+
+BalancedConnectionHandler* WorkStealingConnectionBalancerImpl::leastUtilizedHandler() {
+  BalancedConnectionHandler* min_handler = nullptr;
+  double min_utilization = 0;
+  for (BalancedConnectionHandler* handler : handlers_) {
+    const absl::optional<double> utilization = handler->loopUtilization();
+    if (!utilization.has_value()) {
+      return nullptr;
+    }
+    // Connection counts break ties, which matters mostly before any load has been measured.
+    if (min_handler == nullptr || utilization.value() < min_utilization ||
+        (utilization.value() == min_utilization &&
+         handler->numConnections() < min_handler->numConnections())) {
+      min_handler = handler;
+      min_utilization = utilization.value();
+    }
+  }
+  return min_handler;
+}
+
+BalancedConnectionHandler&
+WorkStealingConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  BalancedConnectionHandler* target_handler = &current_handler;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    BalancedConnectionHandler* min_handler = leastUtilizedHandler();
+    if (min_handler == nullptr) {
+      for (BalancedConnectionHandler* handler : handlers_) {
+        if (handler->numConnections() < target_handler->numConnections()) {
+          target_handler = handler;
+        }
+      }
+    } else if (min_handler->loopUtilization().value() + UtilizationMargin <
+               current_handler.loopUtilization().value_or(1)) {
+      target_handler = min_handler;
+    }
+  }
+
+  target_handler->incNumConnections();
+  return *target_handler;
+}
+
+BalancedConnectionHandler& WorkStealingConnectionBalancerImpl::pickQueuedTargetHandler(
+    BalancedConnectionHandler& current_handler) {
+  const absl::optional<double> current_utilization = current_handler.loopUtilization();
+  if (!current_utilization.has_value() || current_utilization.value() < SaturatedUtilization) {
+    return current_handler;
+  }
+
+  absl::ReaderMutexLock lock(&lock_);
+  BalancedConnectionHandler* min_handler = leastUtilizedHandler();
+  if (min_handler != nullptr &&
+      min_handler->loopUtilization().value() + UtilizationMargin < current_utilization.value()) {
+    return *min_handler;
+  }
+  return current_handler;
+}
+
 } // namespace Network
 } // namespace Envoy
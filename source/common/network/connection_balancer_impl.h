@@ -21,8 +21,43 @@ public:
   void registerHandler(BalancedConnectionHandler& handler) override;
   void unregisterHandler(BalancedConnectionHandler& handler) override;
   BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+  BalancedConnectionHandler&
+  pickQueuedTargetHandler(BalancedConnectionHandler& current_handler) override {
+    return current_handler;
+  }
+
+private:
+  absl::Mutex lock_;
+  std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
+};
+
+/**
+ * Implementation of connection balancer that balances by load rather than connection count. Each
+ * accepted connection goes to the handler whose event loop has been the least utilized recently,
+ * unless the accepting handler is within a margin of it, so that quiet periods don't bounce
+ * connections between threads. A connection that was posted to a handler whose loop has since
+ * become saturated is handed on to the least loaded handler before it becomes active. The
+ * utilization of each loop is read without locking. If utilization isn't measured, i.e. when
+ * dispatcher stats are disabled, connections go to the handler with the fewest connections.
+ */
+class WorkStealingConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  // The utilization difference below which the accepting handler keeps a connection.
+  static constexpr double UtilizationMargin = 0.1;
+  // The utilization above which a handler hands on queued connections.
+  static constexpr double SaturatedUtilization = 0.9;
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+  BalancedConnectionHandler&
+  pickQueuedTargetHandler(BalancedConnectionHandler& current_handler) override;
 
 private:
+  // Returns the least loaded handler, or nullptr if utilization isn't known for all of them.
+  BalancedConnectionHandler* leastUtilizedHandler() ABSL_SHARED_LOCKS_REQUIRED(lock_);
+
   absl::Mutex lock_;
   std::vector<BalancedConnectionHandler*> handlers_ ABSL_GUARDED_BY(lock_);
 };
@@ -42,6 +77,10 @@ public:
     current_handler.incNumConnections();
     return current_handler;
   }
+  BalancedConnectionHandler&
+  pickQueuedTargetHandler(BalancedConnectionHandler& current_handler) override {
+    return current_handler;
+  }
 };
 
 } // namespace Network
@@ -761,6 +761,21 @@ absl::optional<std::chrono::milliseconds> ConnectionImpl::lastRoundTripTime() co
   return socket_->lastRoundTripTime();
 };
 
+ConnectionSocketPtr ConnectionImpl::handOver() {
+  // The state of a secure transport can't be exported, so only plaintext connections are handed
+  // over.
+  if (state() != State::Open || connecting_ || read_buffer_->length() > 0 ||
+      write_buffer_->length() > 0 ||
+      dynamic_cast<RawBufferSocket*>(transport_socket_.get()) == nullptr ||
+      !filter_manager_.canHandOverConnection()) {
+    return nullptr;
+  }
+  ENVOY_CONN_LOG(debug, "handing over the connection", *this);
+  return std::make_unique<ConnectionSocketImpl>(socket_->ioHandle().duplicate(),
+                                                addressProvider().localAddress(),
+                                                addressProvider().remoteAddress());
+}
+
 void ConnectionImpl::flushWriteBuffer() {
   if (state() == State::Open && write_buffer_->length() > 0) {
     onWriteReady();
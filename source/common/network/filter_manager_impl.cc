@@ -45,6 +45,18 @@ bool FilterManagerImpl::initializeReadFilters() {
   return true;
 }
 
+bool FilterManagerImpl::canHandOverConnection() const {
+  if (upstream_filters_.empty()) {
+    return false;
+  }
+  for (const ActiveReadFilterPtr& filter : upstream_filters_) {
+    if (!filter->filter_->canHandOverConnection()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void FilterManagerImpl::onContinueReading(ActiveReadFilter* filter,
                                           ReadBufferSource& buffer_source) {
   // Filter could return status == FilterStatus::StopIteration immediately, close the connection and
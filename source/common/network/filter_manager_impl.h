@@ -109,6 +109,7 @@ public:
   void addReadFilter(ReadFilterSharedPtr filter);
   void removeReadFilter(ReadFilterSharedPtr filter);
   bool initializeReadFilters();
+  bool canHandOverConnection() const;
   void onRead();
   FilterStatus onWrite();
 
@@ -0,0 +1,455 @@
+#include "common/network/happy_eyeballs_connection_impl.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+#include "common/network/connection_impl_base.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+absl::optional<Address::IpVersion> ipVersion(const Address::Instance& address) {
+  if (address.ip() == nullptr) {
+    return absl::nullopt;
+  }
+  return address.ip()->version();
+}
+
+} // namespace
+
+HappyEyeballsConnectionImpl::HappyEyeballsConnectionImpl(
+    Event::Dispatcher& dispatcher, const std::vector<Address::InstanceConstSharedPtr>& address_list,
+    const Address::InstanceConstSharedPtr& source_address, TransportSocketFactory& socket_factory,
+    TransportSocketOptionsSharedPtr transport_socket_options,
+    const ConnectionSocket::OptionsSharedPtr& options)
+    : dispatcher_(dispatcher), address_list_(sortAddresses(address_list)),
+      source_address_(source_address), socket_factory_(socket_factory),
+      transport_socket_options_(transport_socket_options), options_(options),
+      next_attempt_timer_(dispatcher_.createTimer([this]() -> void { tryAnotherAttempt(); })) {
+  ASSERT(!address_list_.empty());
+  attempts_.push_back(createAttempt());
+  // The connection keeps the id of the first attempt whichever attempt connects.
+  id_ = connection().id();
+}
+
+HappyEyeballsConnectionImpl::~HappyEyeballsConnectionImpl() {
+  for (auto& attempt : attempts_) {
+    attempt->connection().removeConnectionCallbacks(*attempt);
+  }
+}
+
+std::vector<Address::InstanceConstSharedPtr> HappyEyeballsConnectionImpl::sortAddresses(
+    const std::vector<Address::InstanceConstSharedPtr>& address_list) {
+  if (address_list.empty()) {
+    return {};
+  }
+  const absl::optional<Address::IpVersion> first_family = ipVersion(*address_list.front());
+  std::vector<Address::InstanceConstSharedPtr> first_family_addresses;
+  std::vector<Address::InstanceConstSharedPtr> other_addresses;
+  for (const auto& address : address_list) {
+    if (ipVersion(*address) == first_family) {
+      first_family_addresses.push_back(address);
+    } else {
+      other_addresses.push_back(address);
+    }
+  }
+
+  std::vector<Address::InstanceConstSharedPtr> sorted;
+  sorted.reserve(address_list.size());
+  for (size_t i = 0; i < std::max(first_family_addresses.size(), other_addresses.size()); ++i) {
+    if (i < first_family_addresses.size()) {
+      sorted.push_back(first_family_addresses[i]);
+    }
+    if (i < other_addresses.size()) {
+      sorted.push_back(other_addresses[i]);
+    }
+  }
+  return sorted;
+}
+
+HappyEyeballsConnectionImpl::AttemptPtr HappyEyeballsConnectionImpl::createAttempt() {
+  ASSERT(next_address_ < address_list_.size());
+  auto attempt = std::make_unique<Attempt>(
+      *this, dispatcher_.createClientConnection(
+                 address_list_[next_address_++], source_address_,
+                 socket_factory_.createTransportSocket(transport_socket_options_), options_));
+
+  ClientConnection& connection = attempt->connection();
+  if (per_connection_state_.detect_early_close_when_read_disabled_.has_value()) {
+    connection.detectEarlyCloseWhenReadDisabled(
+        per_connection_state_.detect_early_close_when_read_disabled_.value());
+  }
+  if (per_connection_state_.no_delay_.has_value()) {
+    connection.noDelay(per_connection_state_.no_delay_.value());
+  }
+  if (per_connection_state_.enable_half_close_.has_value()) {
+    connection.enableHalfClose(per_connection_state_.enable_half_close_.value());
+  }
+  if (per_connection_state_.connection_stats_ != nullptr) {
+    connection.setConnectionStats(*per_connection_state_.connection_stats_);
+  }
+  if (per_connection_state_.buffer_limits_.has_value()) {
+    connection.setBufferLimits(per_connection_state_.buffer_limits_.value());
+  }
+  if (per_connection_state_.delayed_close_timeout_.has_value()) {
+    connection.setDelayedCloseTimeout(per_connection_state_.delayed_close_timeout_.value());
+  }
+  for (const auto& cb : per_connection_state_.bytes_sent_callbacks_) {
+    connection.addBytesSentCallback(cb);
+  }
+  return attempt;
+}
+
+void HappyEyeballsConnectionImpl::connect() {
+  ASSERT(!connect_finished_ && attempts_.size() == 1);
+  ENVOY_CONN_LOG(debug, "connecting to {} addresses, starting with {}", *this,
+                 address_list_.size(), address_list_.front()->asStringView());
+  connection().connect();
+  if (next_address_ < address_list_.size()) {
+    next_attempt_timer_->enableTimer(AttemptDelay);
+  }
+}
+
+void HappyEyeballsConnectionImpl::tryAnotherAttempt() {
+  ASSERT(!connect_finished_ && next_address_ < address_list_.size());
+  ENVOY_CONN_LOG(debug, "connection attempt {} of {} to {}", *this, next_address_ + 1,
+                 address_list_.size(), address_list_[next_address_]->asStringView());
+  attempts_.push_back(createAttempt());
+  attempts_.back()->connection().connect();
+  if (next_address_ < address_list_.size()) {
+    next_attempt_timer_->enableTimer(AttemptDelay);
+  }
+}
+
+void HappyEyeballsConnectionImpl::onEvent(ConnectionEvent event, Attempt& attempt) {
+  if (!connect_finished_) {
+    if (event != ConnectionEvent::Connected) {
+      // Start the next attempt right away rather than once the delay elapses.
+      if (next_address_ < address_list_.size()) {
+        next_attempt_timer_->disableTimer();
+        tryAnotherAttempt();
+      }
+      // The failure is only reported once no other attempt can connect.
+      if (attempts_.size() > 1) {
+        ENVOY_CONN_LOG(debug, "connection attempt to {} failed", *this,
+                       attempt.connection().addressProvider().remoteAddress()->asStringView());
+        removeAttempt(attempt);
+        return;
+      }
+    }
+    setUpFinalConnection(event, attempt);
+  }
+
+  // The callbacks may be added or removed while being raised.
+  for (size_t i = 0; i < callbacks_.size(); ++i) {
+    if (callbacks_[i] != nullptr) {
+      callbacks_[i]->onEvent(event);
+    }
+  }
+}
+
+void HappyEyeballsConnectionImpl::removeAttempt(Attempt& attempt) {
+  attempt.connection().removeConnectionCallbacks(attempt);
+  if (attempt.connection().state() != State::Closed) {
+    attempt.connection().close(ConnectionCloseType::NoFlush);
+  }
+  auto it = std::find_if(attempts_.begin(), attempts_.end(),
+                         [&attempt](const AttemptPtr& other) { return other.get() == &attempt; });
+  ASSERT(it != attempts_.end());
+  // The attempt may be raising the event that got it removed.
+  dispatcher_.deferredDelete(std::move(*it));
+  attempts_.erase(it);
+}
+
+void HappyEyeballsConnectionImpl::setUpFinalConnection(ConnectionEvent event, Attempt& attempt) {
+  connect_finished_ = true;
+  next_attempt_timer_->disableTimer();
+  while (attempts_.size() > 1) {
+    removeAttempt(attempts_.front().get() != &attempt ? *attempts_.front() : *attempts_.back());
+  }
+  ASSERT(attempts_.front().get() == &attempt);
+
+  if (event != ConnectionEvent::Connected) {
+    ENVOY_CONN_LOG(debug, "all the connection attempts failed", *this);
+    return;
+  }
+  ENVOY_CONN_LOG(debug, "connected to {}", *this,
+                 connection().addressProvider().remoteAddress()->asStringView());
+  for (const auto& filter_manager_call : post_connect_state_.filter_manager_calls_) {
+    filter_manager_call(connection());
+  }
+  post_connect_state_.filter_manager_calls_.clear();
+  if (post_connect_state_.write_buffer_.length() > 0 || post_connect_state_.end_stream_) {
+    connection().write(post_connect_state_.write_buffer_, post_connect_state_.end_stream_);
+  }
+  for (uint32_t i = 0; i < post_connect_state_.read_disable_count_; ++i) {
+    connection().readDisable(true);
+  }
+}
+
+void HappyEyeballsConnectionImpl::Attempt::onAboveWriteBufferHighWatermark() {
+  // Only the final connection is written to.
+  if (!parent_.connect_finished_) {
+    return;
+  }
+  for (size_t i = 0; i < parent_.callbacks_.size(); ++i) {
+    if (parent_.callbacks_[i] != nullptr) {
+      parent_.callbacks_[i]->onAboveWriteBufferHighWatermark();
+    }
+  }
+}
+
+void HappyEyeballsConnectionImpl::Attempt::onBelowWriteBufferLowWatermark() {
+  if (!parent_.connect_finished_) {
+    return;
+  }
+  for (size_t i = 0; i < parent_.callbacks_.size(); ++i) {
+    if (parent_.callbacks_[i] != nullptr) {
+      parent_.callbacks_[i]->onBelowWriteBufferLowWatermark();
+    }
+  }
+}
+
+void HappyEyeballsConnectionImpl::addWriteFilter(WriteFilterSharedPtr filter) {
+  if (connect_finished_) {
+    connection().addWriteFilter(filter);
+    return;
+  }
+  // The filters only see the connection that connects.
+  post_connect_state_.filter_manager_calls_.push_back(
+      [filter](FilterManager& filter_manager) { filter_manager.addWriteFilter(filter); });
+}
+
+void HappyEyeballsConnectionImpl::addFilter(FilterSharedPtr filter) {
+  if (connect_finished_) {
+    connection().addFilter(filter);
+    return;
+  }
+  post_connect_state_.has_read_filters_ = true;
+  post_connect_state_.filter_manager_calls_.push_back(
+      [filter](FilterManager& filter_manager) { filter_manager.addFilter(filter); });
+}
+
+void HappyEyeballsConnectionImpl::addReadFilter(ReadFilterSharedPtr filter) {
+  if (connect_finished_) {
+    connection().addReadFilter(filter);
+    return;
+  }
+  post_connect_state_.has_read_filters_ = true;
+  post_connect_state_.filter_manager_calls_.push_back(
+      [filter](FilterManager& filter_manager) { filter_manager.addReadFilter(filter); });
+}
+
+void HappyEyeballsConnectionImpl::removeReadFilter(ReadFilterSharedPtr filter) {
+  if (connect_finished_) {
+    connection().removeReadFilter(filter);
+    return;
+  }
+  post_connect_state_.filter_manager_calls_.push_back(
+      [filter](FilterManager& filter_manager) { filter_manager.removeReadFilter(filter); });
+}
+
+bool HappyEyeballsConnectionImpl::initializeReadFilters() {
+  if (connect_finished_) {
+    return connection().initializeReadFilters();
+  }
+  post_connect_state_.filter_manager_calls_.push_back(
+      [](FilterManager& filter_manager) { filter_manager.initializeReadFilters(); });
+  return post_connect_state_.has_read_filters_;
+}
+
+void HappyEyeballsConnectionImpl::addConnectionCallbacks(ConnectionCallbacks& cb) {
+  callbacks_.push_back(&cb);
+}
+
+void HappyEyeballsConnectionImpl::removeConnectionCallbacks(ConnectionCallbacks& cb) {
+  // The callback is cleared rather than erased as the callbacks may be being raised.
+  for (auto& callback : callbacks_) {
+    if (callback == &cb) {
+      callback = nullptr;
+      return;
+    }
+  }
+}
+
+void HappyEyeballsConnectionImpl::addBytesSentCallback(BytesSentCb cb) {
+  if (!connect_finished_) {
+    per_connection_state_.bytes_sent_callbacks_.push_back(cb);
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().addBytesSentCallback(cb);
+  }
+}
+
+void HappyEyeballsConnectionImpl::enableHalfClose(bool enabled) {
+  if (!connect_finished_) {
+    per_connection_state_.enable_half_close_ = enabled;
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().enableHalfClose(enabled);
+  }
+}
+
+bool HappyEyeballsConnectionImpl::isHalfCloseEnabled() {
+  return connection().isHalfCloseEnabled();
+}
+
+void HappyEyeballsConnectionImpl::close(ConnectionCloseType type) {
+  if (!connect_finished_) {
+    // The oldest attempt is closed in place of the connection, the others silently.
+    connect_finished_ = true;
+    next_attempt_timer_->disableTimer();
+    while (attempts_.size() > 1) {
+      removeAttempt(*attempts_.back());
+    }
+  }
+  connection().close(type);
+}
+
+void HappyEyeballsConnectionImpl::hashKey(std::vector<uint8_t>& hash) const {
+  ConnectionImplBase::addIdToHashKey(hash, id_);
+}
+
+std::string HappyEyeballsConnectionImpl::nextProtocol() const {
+  return connection().nextProtocol();
+}
+
+void HappyEyeballsConnectionImpl::noDelay(bool enable) {
+  if (!connect_finished_) {
+    per_connection_state_.no_delay_ = enable;
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().noDelay(enable);
+  }
+}
+
+void HappyEyeballsConnectionImpl::readDisable(bool disable) {
+  if (connect_finished_) {
+    connection().readDisable(disable);
+    return;
+  }
+  if (disable) {
+    ++post_connect_state_.read_disable_count_;
+  } else {
+    ASSERT(post_connect_state_.read_disable_count_ > 0);
+    --post_connect_state_.read_disable_count_;
+  }
+}
+
+void HappyEyeballsConnectionImpl::detectEarlyCloseWhenReadDisabled(bool should_detect) {
+  if (!connect_finished_) {
+    per_connection_state_.detect_early_close_when_read_disabled_ = should_detect;
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().detectEarlyCloseWhenReadDisabled(should_detect);
+  }
+}
+
+bool HappyEyeballsConnectionImpl::readEnabled() const {
+  if (!connect_finished_) {
+    return post_connect_state_.read_disable_count_ == 0;
+  }
+  return connection().readEnabled();
+}
+
+const SocketAddressProvider& HappyEyeballsConnectionImpl::addressProvider() const {
+  return connection().addressProvider();
+}
+
+SocketAddressProviderSharedPtr HappyEyeballsConnectionImpl::addressProviderSharedPtr() const {
+  return connection().addressProviderSharedPtr();
+}
+
+absl::optional<Connection::UnixDomainSocketPeerCredentials>
+HappyEyeballsConnectionImpl::unixSocketPeerCredentials() const {
+  return connection().unixSocketPeerCredentials();
+}
+
+void HappyEyeballsConnectionImpl::setConnectionStats(const ConnectionStats& stats) {
+  if (!connect_finished_) {
+    per_connection_state_.connection_stats_ = std::make_unique<ConnectionStats>(stats);
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().setConnectionStats(stats);
+  }
+}
+
+Ssl::ConnectionInfoConstSharedPtr HappyEyeballsConnectionImpl::ssl() const {
+  return connection().ssl();
+}
+
+absl::string_view HappyEyeballsConnectionImpl::requestedServerName() const {
+  return connection().requestedServerName();
+}
+
+Connection::State HappyEyeballsConnectionImpl::state() const { return connection().state(); }
+
+bool HappyEyeballsConnectionImpl::connecting() const { return connection().connecting(); }
+
+void HappyEyeballsConnectionImpl::write(Buffer::Instance& data, bool end_stream) {
+  if (connect_finished_) {
+    connection().write(data, end_stream);
+    return;
+  }
+  // The data goes through the write filters once the connection is set up.
+  post_connect_state_.write_buffer_.move(data);
+  post_connect_state_.end_stream_ = end_stream;
+}
+
+void HappyEyeballsConnectionImpl::setBufferLimits(uint32_t limit) {
+  if (!connect_finished_) {
+    per_connection_state_.buffer_limits_ = limit;
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().setBufferLimits(limit);
+  }
+}
+
+uint32_t HappyEyeballsConnectionImpl::bufferLimit() const { return connection().bufferLimit(); }
+
+bool HappyEyeballsConnectionImpl::aboveHighWatermark() const {
+  return connection().aboveHighWatermark();
+}
+
+const ConnectionSocket::OptionsSharedPtr& HappyEyeballsConnectionImpl::socketOptions() const {
+  return connection().socketOptions();
+}
+
+StreamInfo::StreamInfo& HappyEyeballsConnectionImpl::streamInfo() {
+  return connection().streamInfo();
+}
+
+const StreamInfo::StreamInfo& HappyEyeballsConnectionImpl::streamInfo() const {
+  return connection().streamInfo();
+}
+
+void HappyEyeballsConnectionImpl::setDelayedCloseTimeout(std::chrono::milliseconds timeout) {
+  if (!connect_finished_) {
+    per_connection_state_.delayed_close_timeout_ = timeout;
+  }
+  for (auto& attempt : attempts_) {
+    attempt->connection().setDelayedCloseTimeout(timeout);
+  }
+}
+
+absl::string_view HappyEyeballsConnectionImpl::transportFailureReason() const {
+  return connection().transportFailureReason();
+}
+
+bool HappyEyeballsConnectionImpl::startSecureTransport() {
+  return connection().startSecureTransport();
+}
+
+absl::optional<std::chrono::milliseconds> HappyEyeballsConnectionImpl::lastRoundTripTime() const {
+  return connection().lastRoundTripTime();
+}
+
+ConnectionSocketPtr HappyEyeballsConnectionImpl::handOver() {
+  // Only a connected connection can be handed over.
+  return connect_finished_ ? connection().handOver() : nullptr;
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/network/connection.h"
+#include "envoy/network/transport_socket.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * A client connection to a host with several addresses, which races connection attempts to the
+ * addresses as described by RFC 8305 ("Happy Eyeballs"). The first attempt is made to the first
+ * address, and each following attempt is started either once the previous attempt failed or
+ * once the attempt delay elapsed without it succeeding. The first attempt to connect becomes the
+ * connection, and the others are closed. If all the attempts fail, the failure of the last one is
+ * reported.
+ *
+ * The state set on the connection before it's connected is applied to all the attempts, except
+ * the filters, the written data and the read disabling, which are only applied to the attempt
+ * that connects.
+ */
+class HappyEyeballsConnectionImpl : public ClientConnection,
+                                    Logger::Loggable<Logger::Id::connection> {
+public:
+  // The delay before starting the next connection attempt, as recommended by RFC 8305.
+  static constexpr std::chrono::milliseconds AttemptDelay{300};
+
+  HappyEyeballsConnectionImpl(Event::Dispatcher& dispatcher,
+                              const std::vector<Address::InstanceConstSharedPtr>& address_list,
+                              const Address::InstanceConstSharedPtr& source_address,
+                              TransportSocketFactory& socket_factory,
+                              TransportSocketOptionsSharedPtr transport_socket_options,
+                              const ConnectionSocket::OptionsSharedPtr& options);
+
+  ~HappyEyeballsConnectionImpl() override;
+
+  /**
+   * Sorts the addresses in the order of the connection attempts, interleaving the address
+   * families starting with the family of the first address, as described by section 4 of
+   * RFC 8305. The order of the addresses of each family is kept.
+   * @param address_list supplies the addresses, in the order they were resolved.
+   * @return the addresses in the order of the connection attempts.
+   */
+  static std::vector<Address::InstanceConstSharedPtr>
+  sortAddresses(const std::vector<Address::InstanceConstSharedPtr>& address_list);
+
+  // Network::ClientConnection
+  void connect() override;
+
+  // Network::FilterManager
+  void addWriteFilter(WriteFilterSharedPtr filter) override;
+  void addFilter(FilterSharedPtr filter) override;
+  void addReadFilter(ReadFilterSharedPtr filter) override;
+  void removeReadFilter(ReadFilterSharedPtr filter) override;
+  bool initializeReadFilters() override;
+
+  // Network::Connection
+  void addConnectionCallbacks(ConnectionCallbacks& cb) override;
+  void removeConnectionCallbacks(ConnectionCallbacks& cb) override;
+  void addBytesSentCallback(BytesSentCb cb) override;
+  void enableHalfClose(bool enabled) override;
+  bool isHalfCloseEnabled() override;
+  void close(ConnectionCloseType type) override;
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  uint64_t id() const override { return id_; }
+  void hashKey(std::vector<uint8_t>& hash) const override;
+  std::string nextProtocol() const override;
+  void noDelay(bool enable) override;
+  void readDisable(bool disable) override;
+  void detectEarlyCloseWhenReadDisabled(bool should_detect) override;
+  bool readEnabled() const override;
+  const SocketAddressProvider& addressProvider() const override;
+  SocketAddressProviderSharedPtr addressProviderSharedPtr() const override;
+  absl::optional<UnixDomainSocketPeerCredentials> unixSocketPeerCredentials() const override;
+  void setConnectionStats(const ConnectionStats& stats) override;
+  Ssl::ConnectionInfoConstSharedPtr ssl() const override;
+  absl::string_view requestedServerName() const override;
+  State state() const override;
+  bool connecting() const override;
+  void write(Buffer::Instance& data, bool end_stream) override;
+  void setBufferLimits(uint32_t limit) override;
+  uint32_t bufferLimit() const override;
+  bool aboveHighWatermark() const override;
+  const ConnectionSocket::OptionsSharedPtr& socketOptions() const override;
+  StreamInfo::StreamInfo& streamInfo() override;
+  const StreamInfo::StreamInfo& streamInfo() const override;
+  void setDelayedCloseTimeout(std::chrono::milliseconds timeout) override;
+  absl::string_view transportFailureReason() const override;
+  bool startSecureTransport() override;
+  absl::optional<std::chrono::milliseconds> lastRoundTripTime() const override;
+  ConnectionSocketPtr handOver() override;
+
+private:
+  /**
+   * A connection attempt, which forwards the events of its connection to the parent.
+   */
+  class Attempt : public ConnectionCallbacks, public Event::DeferredDeletable {
+  public:
+    Attempt(HappyEyeballsConnectionImpl& parent, ClientConnectionPtr&& connection)
+        : parent_(parent), connection_(std::move(connection)) {
+      connection_->addConnectionCallbacks(*this);
+    }
+
+    ClientConnection& connection() { return *connection_; }
+
+    // Network::ConnectionCallbacks
+    void onEvent(ConnectionEvent event) override { parent_.onEvent(event, *this); }
+    void onAboveWriteBufferHighWatermark() override;
+    void onBelowWriteBufferLowWatermark() override;
+
+  private:
+    HappyEyeballsConnectionImpl& parent_;
+    const ClientConnectionPtr connection_;
+  };
+
+  using AttemptPtr = std::unique_ptr<Attempt>;
+
+  // The state applied to all the attempts.
+  struct PerConnectionState {
+    absl::optional<bool> detect_early_close_when_read_disabled_;
+    absl::optional<bool> no_delay_;
+    absl::optional<bool> enable_half_close_;
+    std::unique_ptr<ConnectionStats> connection_stats_;
+    absl::optional<uint32_t> buffer_limits_;
+    absl::optional<std::chrono::milliseconds> delayed_close_timeout_;
+    std::vector<BytesSentCb> bytes_sent_callbacks_;
+  };
+
+  // The state only applied to the attempt that connects.
+  struct PostConnectState {
+    // The calls to the filter manager, in order.
+    std::vector<std::function<void(FilterManager&)>> filter_manager_calls_;
+    bool has_read_filters_{};
+    Buffer::OwnedImpl write_buffer_;
+    bool end_stream_{};
+    uint32_t read_disable_count_{};
+  };
+
+  ClientConnection& connection() const { return attempts_.front()->connection(); }
+  AttemptPtr createAttempt();
+  void tryAnotherAttempt();
+  void onEvent(ConnectionEvent event, Attempt& attempt);
+  void removeAttempt(Attempt& attempt);
+  void setUpFinalConnection(ConnectionEvent event, Attempt& attempt);
+
+  Event::Dispatcher& dispatcher_;
+  const std::vector<Address::InstanceConstSharedPtr> address_list_;
+  const Address::InstanceConstSharedPtr source_address_;
+  TransportSocketFactory& socket_factory_;
+  const TransportSocketOptionsSharedPtr transport_socket_options_;
+  const ConnectionSocket::OptionsSharedPtr options_;
+  // The index of the address of the next attempt.
+  size_t next_address_{};
+  // The running attempts, the oldest first. Once the connection is set up, only the attempt that
+  // connected, or the last one to fail, is left.
+  std::vector<AttemptPtr> attempts_;
+  uint64_t id_{};
+  Event::TimerPtr next_attempt_timer_;
+  bool connect_finished_{};
+  PerConnectionState per_connection_state_;
+  PostConnectState post_connect_state_;
+  std::vector<ConnectionCallbacks*> callbacks_;
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -1,5 +1,9 @@
 #include "common/network/io_socket_handle_impl.h"
 
+#if ENVOY_ZERO_COPY_SEND
+#include <linux/errqueue.h>
+#endif
+
 #include "envoy/buffer/buffer.h"
 
 #include "common/api/os_sys_calls_impl.h"
@@ -58,10 +62,107 @@ constexpr int messageTruncatedOption() {
 #endif
 }
 
+#if ENVOY_ZERO_COPY_SEND
+/**
+ * Keeps a closed socket open until the kernel reports it's done with the data of its pending zero
+ * copy sends, which it may still retransmit. Its writes are shut down right away, so that the peer
+ * sees the close as it would otherwise.
+ */
+class ZeroCopyLinger {
+public:
+  static void start(Event::Dispatcher& dispatcher, os_fd_t fd,
+                    std::unique_ptr<Network::ZeroCopySends> sends) {
+    Api::OsSysCallsSingleton::get().shutdown(fd, ENVOY_SHUT_WR);
+    // Owns itself until the last completion, it's leaked if the dispatcher is destroyed before.
+    auto* linger = new ZeroCopyLinger(fd, std::move(sends));
+    // The completions are signaled as errors, which are reported as read events.
+    linger->file_event_ = dispatcher.createFileEvent(
+        fd, [linger](uint32_t) { linger->onEvents(); }, Event::PlatformDefaultTriggerType,
+        Event::FileReadyType::Read);
+  }
+
+private:
+  ZeroCopyLinger(os_fd_t fd, std::unique_ptr<Network::ZeroCopySends> sends)
+      : fd_(fd), sends_(std::move(sends)) {}
+
+  void onEvents() {
+    sends_->reapCompletions(fd_);
+    if (sends_->empty()) {
+      file_event_.reset();
+      Api::OsSysCallsSingleton::get().close(fd_);
+      delete this;
+    }
+  }
+
+  const os_fd_t fd_;
+  std::unique_ptr<Network::ZeroCopySends> sends_;
+  Event::FileEventPtr file_event_;
+};
+#endif
+
 } // namespace
 
 namespace Network {
 
+void ZeroCopySends::add(Buffer::Instance& buffer, uint64_t length) {
+  sends_.emplace_back();
+  Buffer::OwnedImpl& data = sends_.back().data_;
+  data.retainDrained(buffer, length);
+  pending_bytes_ += data.length();
+  ++next_id_;
+}
+
+void ZeroCopySends::complete(uint32_t first, uint32_t last) {
+  uint32_t id = next_id_ - sends_.size();
+  for (Send& send : sends_) {
+    if (id - first <= last - first) {
+      send.completed_ = true;
+    }
+    ++id;
+  }
+  while (!sends_.empty() && sends_.front().completed_) {
+    pending_bytes_ -= sends_.front().data_.length();
+    sends_.pop_front();
+  }
+}
+
+void ZeroCopySends::reapCompletions(os_fd_t fd) {
+#if ENVOY_ZERO_COPY_SEND
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  while (!sends_.empty()) {
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    // Fails with EAGAIN once the queue is empty.
+    if (os_syscalls.recvmsg(fd, &message, MSG_ERRQUEUE).rc_ < 0) {
+      return;
+    }
+    bool completed = false;
+    for (cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(&message, cmsg)) {
+      if (!(cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVERR) &&
+          !(cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+        continue;
+      }
+      const auto* error = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+      if (error->ee_origin != SO_EE_ORIGIN_ZEROCOPY || error->ee_errno != 0) {
+        continue;
+      }
+      copied_ = copied_ || (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+      complete(error->ee_info, error->ee_data);
+      completed = true;
+    }
+    if (!completed) {
+      // Only the completions of the sends are expected on the queue.
+      return;
+    }
+  }
+#else
+  UNREFERENCED_PARAMETER(fd);
+#endif
+}
+
 IoSocketHandleImpl::~IoSocketHandleImpl() {
   if (SOCKET_VALID(fd_)) {
     IoSocketHandleImpl::close();
@@ -74,6 +175,17 @@ Api::IoCallUint64Result IoSocketHandleImpl::close() {
   }
 
   ASSERT(SOCKET_VALID(fd_));
+#if ENVOY_ZERO_COPY_SEND
+  if (zero_copy_sends_ != nullptr) {
+    zero_copy_sends_->reapCompletions(fd_);
+    // Without a dispatcher, there is no event loop to wait for the completions on.
+    if (!zero_copy_sends_->empty() && dispatcher_ != nullptr) {
+      ZeroCopyLinger::start(*dispatcher_, fd_, std::move(zero_copy_sends_));
+      SET_SOCKET_INVALID(fd_);
+      return Api::ioCallUint64ResultNoError();
+    }
+  }
+#endif
   const int rc = Api::OsSysCallsSingleton::get().close(fd_).rc_;
   SET_SOCKET_INVALID(fd_);
   return Api::IoCallUint64Result(rc, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
@@ -114,6 +226,10 @@ Api::IoCallUint64Result IoSocketHandleImpl::read(Buffer::Instance& buffer,
   if (max_length == 0) {
     return Api::ioCallUint64ResultNoError();
   }
+  // The completions wake up the reads too, free their data even if nothing is written anymore.
+  if (zero_copy_sends_ != nullptr && !zero_copy_sends_->empty()) {
+    zero_copy_sends_->reapCompletions(fd_);
+  }
   Buffer::Reservation reservation = buffer.reserveForRead();
   Api::IoCallUint64Result result = readv(std::min(reservation.length(), max_length),
                                          reservation.slices(), reservation.numSlices());
@@ -161,10 +277,18 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
 }
 
 Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
-  constexpr uint64_t MaxSlices = 16;
-  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxSlices);
-  Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
-  if (result.ok() && result.rc_ > 0) {
+  if (zero_copy_sends_ != nullptr) {
+    zero_copy_sends_->reapCompletions(fd_);
+    if (zero_copy_ && zero_copy_sends_->copied()) {
+      ENVOY_LOG(debug, "the kernel copies the zero copy sends of fd {}, copying them", fd_);
+      setZeroCopy(false);
+    }
+  }
+  Buffer::RawSliceVector slices = buffer.getRawSlices(MaxWriteSlices);
+  const bool zero_copy = zero_copy_ && buffer.length() >= ZeroCopyMinWriteSize;
+  Api::IoCallUint64Result result =
+      zero_copy ? sendZeroCopy(buffer, slices) : writev(slices.begin(), slices.size());
+  if (!zero_copy && result.ok() && result.rc_ > 0) {
     buffer.drain(static_cast<uint64_t>(result.rc_));
   }
 
@@ -179,6 +303,52 @@ Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
   return result;
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendZeroCopy(Buffer::Instance& buffer,
+                                                         const Buffer::RawSliceVector& slices) {
+  const auto copy = [this, &buffer, &slices]() {
+    Api::IoCallUint64Result result = writev(slices.begin(), slices.size());
+    if (result.ok() && result.rc_ > 0) {
+      buffer.drain(result.rc_);
+    }
+    return result;
+  };
+#if ENVOY_ZERO_COPY_SEND
+  absl::FixedArray<iovec> iov(slices.size());
+  uint64_t num_slices_to_write = 0;
+  for (uint64_t i = 0; i < slices.size(); i++) {
+    if (slices[i].mem_ != nullptr && slices[i].len_ != 0) {
+      iov[num_slices_to_write].iov_base = slices[i].mem_;
+      iov[num_slices_to_write].iov_len = slices[i].len_;
+      num_slices_to_write++;
+    }
+  }
+  msghdr message{};
+  message.msg_iov = iov.begin();
+  message.msg_iovlen = num_slices_to_write;
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().sendmsg(fd_, &message, MSG_ZEROCOPY);
+  if (result.rc_ > 0) {
+    // The kernel references the data until the completion of the send.
+    zero_copy_sends_->add(buffer, result.rc_);
+    return sysCallResultToIoCallResult(result);
+  }
+  // ENOBUFS when the pages pinned by the pending sends exceed the optmem limit of the socket.
+  if (result.rc_ < 0 && result.errno_ == ENOBUFS) {
+    return copy();
+  }
+  return sysCallResultToIoCallResult(result);
+#else
+  return copy();
+#endif
+}
+
+void IoSocketHandleImpl::setZeroCopy(bool zero_copy) {
+  zero_copy_ = zero_copy;
+  if (zero_copy_ && zero_copy_sends_ == nullptr) {
+    zero_copy_sends_ = std::make_unique<ZeroCopySends>();
+  }
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
@@ -557,7 +727,10 @@ IoHandlePtr IoSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen
     return nullptr;
   }
 
-  return std::make_unique<IoSocketHandleImpl>(result.rc_, socket_v6only_, domain_);
+  auto io_handle = std::make_unique<IoSocketHandleImpl>(result.rc_, socket_v6only_, domain_);
+  // The accepted sockets inherit SO_ZEROCOPY from the listener.
+  io_handle->setZeroCopy(zero_copy_);
+  return io_handle;
 }
 
 Api::SysCallIntResult IoSocketHandleImpl::connect(Address::InstanceConstSharedPtr address) {
@@ -566,7 +739,16 @@ Api::SysCallIntResult IoSocketHandleImpl::connect(Address::InstanceConstSharedPt
 
 Api::SysCallIntResult IoSocketHandleImpl::setOption(int level, int optname, const void* optval,
                                                     socklen_t optlen) {
-  return Api::OsSysCallsSingleton::get().setsockopt(fd_, level, optname, optval, optlen);
+  const Api::SysCallIntResult result =
+      Api::OsSysCallsSingleton::get().setsockopt(fd_, level, optname, optval, optlen);
+#if ENVOY_ZERO_COPY_SEND
+  // Configured as a socket option, SO_ZEROCOPY opts the socket in the zero copy sends.
+  if (result.rc_ == 0 && level == SOL_SOCKET && optname == SO_ZEROCOPY &&
+      optlen == sizeof(int)) {
+    setZeroCopy(*static_cast<const int*>(optval) != 0);
+  }
+#endif
+  return result;
 }
 
 Api::SysCallIntResult IoSocketHandleImpl::getOption(int level, int optname, void* optval,
@@ -638,6 +820,7 @@ void IoSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher, Even
   ASSERT(file_event_ == nullptr, "Attempting to initialize two `file_event_` for the same "
                                  "file descriptor. This is not allowed.");
   file_event_ = dispatcher.createFileEvent(fd_, cb, trigger, events);
+  dispatcher_ = &dispatcher;
 }
 
 void IoSocketHandleImpl::activateFileEvents(uint32_t events) {
@@ -1,17 +1,69 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "envoy/api/io_error.h"
 #include "envoy/api/os_sys_calls.h"
 #include "envoy/common/platform.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/network/io_handle.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 #include "common/network/io_socket_error_impl.h"
 
 namespace Envoy {
 namespace Network {
 
+/**
+ * The data of the writes of a socket sent with MSG_ZEROCOPY, which is kept until the kernel reports
+ * on the error queue of the socket that it's done with it: it keeps referencing the data until the
+ * peer acknowledges it, to retransmit it.
+ */
+class ZeroCopySends {
+public:
+  /**
+   * Keeps the data of a send until its completion.
+   * @param buffer supplies the buffer the data was sent from, which is drained of it.
+   * @param length supplies the number of bytes sent.
+   */
+  void add(Buffer::Instance& buffer, uint64_t length);
+
+  /**
+   * Reads the completions queued on the error queue of the socket, and frees the data of the sends
+   * they complete.
+   * @param fd supplies the socket.
+   */
+  void reapCompletions(os_fd_t fd);
+
+  bool empty() const { return sends_.empty(); }
+  uint64_t pendingBytes() const { return pending_bytes_; }
+
+  /**
+   * @return whether the kernel reported copying the data of a send anyway, e.g. over loopback or to
+   *         a device without scatter-gather IO, where sending without copying only adds the cost of
+   *         the completions.
+   */
+  bool copied() const { return copied_; }
+
+private:
+  struct Send {
+    Buffer::OwnedImpl data_;
+    bool completed_{};
+  };
+
+  // Completes the sends in the range of numbers, which may wrap around.
+  void complete(uint32_t first, uint32_t last);
+
+  // The sends until the last one not completed, in order. The kernel numbers the sends of a socket
+  // in order, the last one being next_id_ - 1.
+  std::deque<Send> sends_;
+  uint32_t next_id_{};
+  uint64_t pending_bytes_{};
+  bool copied_{};
+};
+
 /**
  * IoHandle derivative for sockets.
  */
@@ -21,6 +73,16 @@ public:
                               absl::optional<int> domain = absl::nullopt)
       : fd_(fd), socket_v6only_(socket_v6only), domain_(domain) {}
 
+  // Maximum number of buffer slices gathered into a single writev() by write(). Fragmented buffers
+  // (e.g. many small HTTP/2 frames) are flushed with fewer syscalls the larger this is; it is kept
+  // well below IOV_MAX on all supported platforms.
+  static constexpr uint64_t MaxWriteSlices = 64;
+
+  // Once SO_ZEROCOPY is set on the socket, the writes of at least this many bytes are sent without
+  // copying their data to the kernel. Below it, pinning the pages of the data and reading the
+  // completion of the send costs more than the copy.
+  static constexpr uint64_t ZeroCopyMinWriteSize = 16384;
+
   // Close underlying socket if close() hasn't been call yet.
   ~IoSocketHandleImpl() override;
 
@@ -81,7 +143,21 @@ public:
   Api::SysCallIntResult shutdown(int how) override;
   absl::optional<std::chrono::milliseconds> lastRoundTripTime() override;
 
+  /**
+   * @return the number of bytes of the writes sent without copying whose completion the kernel
+   *         didn't report yet.
+   */
+  uint64_t zeroCopyPendingBytes() const {
+    return zero_copy_sends_ != nullptr ? zero_copy_sends_->pendingBytes() : 0;
+  }
+
 protected:
+  // Sends the slices of the buffer with MSG_ZEROCOPY, or copies them if the kernel can't pin more
+  // pages, and drains the buffer of the data sent.
+  Api::IoCallUint64Result sendZeroCopy(Buffer::Instance& buffer,
+                                       const Buffer::RawSliceVector& slices);
+  void setZeroCopy(bool zero_copy);
+
   // Converts a SysCallSizeResult to IoCallUint64Result.
   template <typename T>
   Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallResult<T>& result) {
@@ -104,6 +180,11 @@ protected:
   int socket_v6only_{false};
   const absl::optional<int> domain_;
   Event::FileEventPtr file_event_{nullptr};
+  // The dispatcher of file_event_, for close() to linger on while zero copy sends are pending.
+  Event::Dispatcher* dispatcher_{};
+  // Whether the large writes are sent without copying, and the data of the ones that were.
+  bool zero_copy_{};
+  std::unique_ptr<ZeroCopySends> zero_copy_sends_;
 
   // The minimum cmsg buffer size to filled in destination address, packets dropped and gso
   // size when receiving a packet. It is possible for a received packet to contain both IPv4
@@ -14,6 +14,7 @@
 #include "common/network/cidr_range.h"
 #include "common/network/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_set.h"
 #include "absl/numeric/int128.h"
 #include "fmt/format.h"
@@ -23,11 +24,10 @@ namespace Network {
 namespace LcTrie {
 
 /**
- * Maximum number of nodes an LC trie can hold.
- * @note If the size of LcTrieInternal::LcNode::address_ ever changes, this constant
- *       should be changed to match.
+ * Maximum number of nodes an LC trie can hold. With the default fill factor, this allows for
+ * 2^20 CIDR ranges, for up to 32MiB of nodes.
  */
-constexpr size_t MaxLcTrieNodes = (1 << 20);
+constexpr size_t MaxLcTrieNodes = (1 << 22);
 
 /**
  * Level Compressed Trie for associating data with CIDR ranges. Both IPv4 and IPv6 addresses are
@@ -58,11 +58,10 @@ public:
   LcTrie(const std::vector<std::pair<T, std::vector<Address::CidrRange>>>& data,
          bool exclusive = false, double fill_factor = 0.5, uint32_t root_branching_factor = 0) {
 
-    // The LcTrie implementation uses 20-bit "pointers" in its compact internal representation,
-    // so it cannot hold more than 2^20 nodes. But the number of nodes can be greater than the
-    // number of supported prefixes. Given N prefixes in the data input list, step 2 below can
-    // produce a new list of up to 2*N prefixes to insert in the LC trie. And the LC trie can
-    // use up to 2*N/fill_factor nodes.
+    // The size of the LcTrie implementation is bounded to MaxLcTrieNodes nodes. But the number
+    // of nodes can be greater than the number of supported prefixes. Given N prefixes in the data
+    // input list, step 2 below can produce a new list of up to 2*N prefixes to insert in the LC
+    // trie. And the LC trie can use up to 2*N/fill_factor nodes.
     size_t num_prefixes = 0;
     for (const auto& pair_data : data) {
       num_prefixes += pair_data.second.size();
@@ -106,13 +105,11 @@ public:
     for (const auto& pair_data : data) {
       for (const auto& cidr_range : pair_data.second) {
         if (cidr_range.ip()->version() == Address::IpVersion::v4) {
-          IpPrefix<Ipv4> ip_prefix(ntohl(cidr_range.ip()->ipv4()->address()), cidr_range.length(),
-                                   pair_data.first);
-          ipv4_temp.insert(ip_prefix);
+          ipv4_temp.insert(ntohl(cidr_range.ip()->ipv4()->address()), cidr_range.length(),
+                           pair_data.first);
         } else {
-          IpPrefix<Ipv6> ip_prefix(Utility::Ip6ntohl(cidr_range.ip()->ipv6()->address()),
-                                   cidr_range.length(), pair_data.first);
-          ipv6_temp.insert(ip_prefix);
+          ipv6_temp.insert(Utility::Ip6ntohl(cidr_range.ip()->ipv6()->address()),
+                           cidr_range.length(), pair_data.first);
         }
       }
     }
@@ -136,9 +133,13 @@ public:
     // This trie yields the same match results as the original trie from
     // step 1. But it has a useful new property: now that all the prefixes
     // are at the leaves, they are disjoint: no prefix is nested under another.
+    //
+    // Many leaves usually hold the same data (in the example above, both A leaves), so each
+    // distinct data set is only stored once in data_sets_, and the leaves refer to it by index.
 
-    std::vector<IpPrefix<Ipv4>> ipv4_prefixes = ipv4_temp.push_leaves();
-    std::vector<IpPrefix<Ipv6>> ipv6_prefixes = ipv6_temp.push_leaves();
+    DataSetInterner interner(data_sets_);
+    std::vector<IpPrefix<Ipv4>> ipv4_prefixes = ipv4_temp.push_leaves(interner);
+    std::vector<IpPrefix<Ipv6>> ipv6_prefixes = ipv6_temp.push_leaves(interner);
 
     // Step 3: take the disjoint prefixes from the leaves of each Binary Trie
     // and use them to construct an LC Trie.
@@ -170,8 +171,10 @@ public:
     //
     // The Nilsson and Karlsson paper linked in lc_trie.h has a more thorough example.
 
-    ipv4_trie_.reset(new LcTrieInternal<Ipv4>(ipv4_prefixes, fill_factor, root_branching_factor));
-    ipv6_trie_.reset(new LcTrieInternal<Ipv6>(ipv6_prefixes, fill_factor, root_branching_factor));
+    ipv4_trie_.reset(
+        new LcTrieInternal<Ipv4>(std::move(ipv4_prefixes), fill_factor, root_branching_factor));
+    ipv6_trie_.reset(
+        new LcTrieInternal<Ipv6>(std::move(ipv6_prefixes), fill_factor, root_branching_factor));
   }
 
   /**
@@ -182,16 +185,34 @@ public:
    * empty vector is returned if no prefix contains 'ip_address' or there is no data for the IP
    * version of the ip_address.
    */
-  std::vector<T> getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
+  const std::vector<T>&
+  getData(const Network::Address::InstanceConstSharedPtr& ip_address) const {
+    return data_sets_[getDataSetIndex(ip_address)];
+  }
+
+  /**
+   * Retrieve the index in dataSets() of the data associated with the CIDR range that contains
+   * `ip_address`. This allows the callers to precompute what they derive from each distinct
+   * data set.
+   * @param  ip_address supplies the IP address.
+   * @return the index of the data set, 0 (the empty data set) if no prefix contains 'ip_address'
+   * or there is no data for the IP version of the ip_address.
+   */
+  uint32_t getDataSetIndex(const Network::Address::InstanceConstSharedPtr& ip_address) const {
     if (ip_address->ip()->version() == Address::IpVersion::v4) {
       Ipv4 ip = ntohl(ip_address->ip()->ipv4()->address());
-      return ipv4_trie_->getData(ip);
+      return ipv4_trie_->getDataSetIndex(ip);
     } else {
       Ipv6 ip = Utility::Ip6ntohl(ip_address->ip()->ipv6()->address());
-      return ipv6_trie_->getData(ip);
+      return ipv6_trie_->getDataSetIndex(ip);
     }
   }
 
+  /**
+   * @return the distinct data sets the CIDR ranges resolve to, sorted. The first one is empty.
+   */
+  const std::vector<std::vector<T>>& dataSets() const { return data_sets_; }
+
 private:
   /**
    * Extract n bits from input starting at position p.
@@ -236,18 +257,52 @@ private:
   using DataSetSharedPtr = std::shared_ptr<DataSet>;
 
   /**
-   * Structure to hold a CIDR range and the data associated with it.
+   * Assigns to each distinct data set its index in a vector of data sets, so that the prefixes
+   * with the same data only hold it once.
+   */
+  class DataSetInterner {
+  public:
+    DataSetInterner(std::vector<std::vector<T>>& data_sets) : data_sets_(data_sets) {
+      // The index 0 is the empty data set, returned when no prefix matches.
+      data_sets_.emplace_back();
+      indexes_.emplace(data_sets_.back(), 0);
+    }
+
+    /**
+     * @param data supplies a data set.
+     * @return the index of the data set.
+     */
+    uint32_t intern(const DataSetSharedPtr& data) {
+      // The leaves which inherited their data from the same ancestor share its data set.
+      const auto it = indexes_by_address_.find(data.get());
+      if (it != indexes_by_address_.end()) {
+        return it->second;
+      }
+      std::vector<T> sorted_data(data->begin(), data->end());
+      std::sort(sorted_data.begin(), sorted_data.end());
+      const auto result = indexes_.try_emplace(sorted_data, data_sets_.size());
+      if (result.second) {
+        data_sets_.push_back(std::move(sorted_data));
+      }
+      indexes_by_address_.emplace(data.get(), result.first->second);
+      return result.first->second;
+    }
+
+  private:
+    std::vector<std::vector<T>>& data_sets_;
+    absl::flat_hash_map<std::vector<T>, uint32_t> indexes_;
+    absl::flat_hash_map<const DataSet*, uint32_t> indexes_by_address_;
+  };
+
+  /**
+   * Structure to hold a CIDR range and the index of the data associated with it.
    */
   template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)> struct IpPrefix {
 
     IpPrefix() = default;
 
-    IpPrefix(const IpType& ip, uint32_t length, const T& data) : ip_(ip), length_(length) {
-      data_.insert(data);
-    }
-
-    IpPrefix(const IpType& ip, int length, const DataSet& data)
-        : ip_(ip), length_(length), data_(data) {}
+    IpPrefix(const IpType& ip, uint32_t length, uint32_t data_index)
+        : ip_(ip), length_(length), data_index_(data_index) {}
 
     /**
      * @return -1 if the current object is less than other. 0 if they are the same. 1
@@ -295,8 +350,8 @@ private:
     IpType ip_{0};
     // Length of the cidr range.
     uint32_t length_{0};
-    // Data for this entry.
-    DataSet data_;
+    // Index of the data for this entry in the data sets of the LcTrie.
+    uint32_t data_index_{0};
   };
 
   /**
@@ -318,11 +373,14 @@ private:
     /**
      * Add a CIDR prefix and associated data to the binary trie. If an entry already
      * exists for the prefix, merge the data into the existing entry.
+     * @param ip supplies the address of the CIDR prefix, in host byte order.
+     * @param length supplies the length of the CIDR prefix.
+     * @param data supplies the data associated with the CIDR prefix.
      */
-    void insert(const IpPrefix<IpType>& prefix) {
+    void insert(const IpType& ip, uint32_t length, const T& data) {
       Node* node = root_.get();
-      for (uint32_t i = 0; i < prefix.length_; i++) {
-        auto bit = static_cast<uint32_t>(extractBits(i, 1, prefix.ip_));
+      for (uint32_t i = 0; i < length; i++) {
+        auto bit = static_cast<uint32_t>(extractBits(i, 1, ip));
         NodePtr& next_node = node->children[bit];
         if (next_node == nullptr) {
           next_node = std::make_unique<Node>();
@@ -332,7 +390,7 @@ private:
       if (node->data == nullptr) {
         node->data = std::make_shared<DataSet>();
       }
-      node->data->insert(prefix.data_.begin(), prefix.data_.end());
+      node->data->insert(data);
     }
 
     /**
@@ -343,9 +401,10 @@ private:
      *     new property applies: no prefix in that set is nested under any
      *     other prefix in the set (since, by definition, no leaf of the
      *     trie can be nested under another leaf)
+     * @param interner supplies the interner assigning the indexes of the data of the leaves.
      * @return the prefixes associated with the leaf nodes.
      */
-    std::vector<IpPrefix<IpType>> push_leaves() {
+    std::vector<IpPrefix<IpType>> push_leaves(DataSetInterner& interner) {
       std::vector<IpPrefix<IpType>> prefixes;
       std::function<void(Node*, DataSetSharedPtr, unsigned, IpType)> visit =
           [&](Node* node, DataSetSharedPtr data, unsigned depth, IpType prefix) {
@@ -381,7 +440,7 @@ private:
                 if (depth != 0) {
                   ip <<= (address_size - depth);
                 }
-                prefixes.emplace_back(IpPrefix<IpType>(ip, depth, *node->data));
+                prefixes.emplace_back(ip, depth, interner.intern(node->data));
               }
             }
           };
@@ -409,7 +468,7 @@ private:
    * 'http://www.csc.kth.se/~snilsson/software/router/C/' were used as reference during
    * implementation.
    *
-   * Note: The trie can only support up 524288(2^19) prefixes with a fill_factor of 1 and
+   * Note: The trie can only support up 2097152(2^21) prefixes with a fill_factor of 1 and
    * root_branching_factor not set. Refer to LcTrieInternal::build() method for more details.
    */
   template <class IpType, uint32_t address_size = CHAR_BIT * sizeof(IpType)> class LcTrieInternal {
@@ -423,28 +482,28 @@ private:
      *                              for large LC-Tries to use the value '16' for the root
      *                              branching factor. It reduces the depth of the trie.
      */
-    LcTrieInternal(std::vector<IpPrefix<IpType>>& data, double fill_factor,
+    LcTrieInternal(std::vector<IpPrefix<IpType>>&& data, double fill_factor,
                    uint32_t root_branching_factor);
 
     /**
-     * Retrieve the data associated with the CIDR range that contains `ip_address`.
+     * Retrieve the index of the data associated with the CIDR range that contains `ip_address`.
      * @param  ip_address supplies the IP address in host byte order.
-     * @return a vector of data from the CIDR ranges and IP addresses that encompasses the input.
-     * An empty vector is returned if the LC Trie is empty.
+     * @return the index of the data set from the CIDR ranges and IP addresses that encompasses
+     * the input. The index of the empty data set (0) is returned if the LC Trie is empty.
      */
-    std::vector<T> getData(const IpType& ip_address) const;
+    uint32_t getDataSetIndex(const IpType& ip_address) const;
 
   private:
     /**
      * Builds the Level Compressed Trie, by first sorting the data, removing duplicated
      * prefixes and invoking buildRecursive() to build the trie.
      */
-    void build(std::vector<IpPrefix<IpType>>& data) {
+    void build(std::vector<IpPrefix<IpType>>&& data) {
       if (data.empty()) {
         return;
       }
 
-      ip_prefixes_ = data;
+      ip_prefixes_ = std::move(data);
       std::sort(ip_prefixes_.begin(), ip_prefixes_.end());
 
       // Build the trie_.
@@ -658,7 +717,7 @@ private:
     }
 
     /**
-     * LcNode is a uint32_t. A wrapper is provided to simplify getting/setting the branch, the
+     * LcNode is a uint64_t. A wrapper is provided to simplify getting/setting the branch, the
      * skip and the address values held within the structure.
      *
      * The LcNode has three parts to it
@@ -667,17 +726,14 @@ private:
      * 2, so there can be at most 2^31 descendant nodes.
      * - Skip: the next 7 bits represent the number of bits to skip when looking at an IP address.
      * This value can be between 0 and 127, so IPv6 is supported.
-     * - Address: the remaining 20 bits represent an index either into the trie_ or the
+     * - Address: the next 32 bits represent an index either into the trie_ or the
      * ip_prefixes_. If branch_ != 0, the index is for the trie_. If branch == zero, the index is
      * for the ip_prefixes_.
-     *
-     * Note: If more than 2^19-1 CIDR ranges are to be stored in trie_, uint64_t should be used
-     * instead.
      */
     struct LcNode {
       uint32_t branch_ : 5;
       uint32_t skip_ : 7;
-      uint32_t address_ : 20; // If this 20-bit size changes, please change MaxLcTrieNodes too.
+      uint32_t address_;
     };
 
     // The CIDR range and data needs to be maintained separately from the LC-Trie. A LC-Trie skips
@@ -694,26 +750,26 @@ private:
     const uint32_t root_branching_factor_;
   };
 
+  // The distinct data sets of the prefixes, indexed by IpPrefix::data_index_.
+  std::vector<std::vector<T>> data_sets_;
   std::unique_ptr<LcTrieInternal<Ipv4>> ipv4_trie_;
   std::unique_ptr<LcTrieInternal<Ipv6>> ipv6_trie_;
 };
 
 template <class T>
 template <class IpType, uint32_t address_size>
-LcTrie<T>::LcTrieInternal<IpType, address_size>::LcTrieInternal(std::vector<IpPrefix<IpType>>& data,
-                                                                double fill_factor,
-                                                                uint32_t root_branching_factor)
+LcTrie<T>::LcTrieInternal<IpType, address_size>::LcTrieInternal(
+    std::vector<IpPrefix<IpType>>&& data, double fill_factor, uint32_t root_branching_factor)
     : fill_factor_(fill_factor), root_branching_factor_(root_branching_factor) {
-  build(data);
+  build(std::move(data));
 }
 
 template <class T>
 template <class IpType, uint32_t address_size>
-std::vector<T>
-LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_address) const {
-  std::vector<T> return_vector;
+uint32_t
+LcTrie<T>::LcTrieInternal<IpType, address_size>::getDataSetIndex(const IpType& ip_address) const {
   if (trie_.empty()) {
-    return return_vector;
+    return 0;
   }
 
   LcNode node = trie_[0];
@@ -737,9 +793,9 @@ LcTrie<T>::LcTrieInternal<IpType, address_size>::getData(const IpType& ip_addres
   // ip_address.
   const auto& prefix = ip_prefixes_[address];
   if (prefix.contains(ip_address)) {
-    return std::vector<T>(prefix.data_.begin(), prefix.data_.end());
+    return prefix.data_index_;
   }
-  return std::vector<T>();
+  return 0;
 }
 
 } // namespace LcTrie
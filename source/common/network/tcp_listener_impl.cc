@@ -1,5 +1,7 @@
 #include "common/network/tcp_listener_impl.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -44,8 +46,10 @@ bool TcpListenerImpl::rejectCxOverGlobalLimit() {
 void TcpListenerImpl::onSocketEvent(short flags) {
   ASSERT(flags & (Event::FileReadyType::Read));
 
-  // TODO(fcoras): Add limit on number of accepted calls per wakeup
-  while (1) {
+  // The accepted connections are set up by the callbacks, which is where the time of the batch
+  // goes: the batch size adapts to keep it within its budget.
+  const MonotonicTime batch_start = dispatcher_.timeSource().monotonicTime();
+  for (uint32_t i = 0; i < accept_batch_size_; ++i) {
     if (!socket_->ioHandle().isOpen()) {
       PANIC(fmt::format("listener accept failure: {}", errorDetails(errno)));
     }
@@ -92,13 +96,20 @@ void TcpListenerImpl::onSocketEvent(short flags) {
     cb_.onAccept(
         std::make_unique<AcceptedSocketImpl>(std::move(io_handle), local_address, remote_address));
   }
+
+  const auto batch_time = dispatcher_.timeSource().monotonicTime() - batch_start;
+  if (batch_time > AcceptBatchTimeBudget) {
+    accept_batch_size_ = std::max(accept_batch_size_ / 2, MinAcceptBatchSize);
+  } else if (batch_time < AcceptBatchTimeBudget / 2) {
+    accept_batch_size_ = std::min(accept_batch_size_ * 2, MaxAcceptBatchSize);
+  }
 }
 
 void TcpListenerImpl::setupServerSocket(Event::DispatcherImpl& dispatcher, Socket& socket) {
   socket.ioHandle().listen(backlog_size_);
 
-  // Although onSocketEvent drains to completion, use level triggered mode to avoid potential
-  // loss of the trigger due to transient accept errors.
+  // Use level triggered mode, so that the connections left pending by onSocketEvent, because of
+  // its batch size or transient accept errors, trigger it again.
   socket.ioHandle().initializeFileEvent(
       dispatcher, [this](uint32_t events) -> void { onSocketEvent(events); },
       Event::FileTriggerType::Level, Event::FileReadyType::Read);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+
 #include "envoy/common/random_generator.h"
 #include "envoy/runtime/runtime.h"
 
@@ -24,8 +26,19 @@ public:
   void enable() override;
   void setRejectFraction(UnitFloat reject_fraction) override;
 
+  uint32_t acceptBatchSize() const { return accept_batch_size_; }
+
   static const absl::string_view GlobalMaxCxRuntimeKey;
 
+  // The bounds of the number of connections accepted per socket event. The rest of the pending
+  // connections are accepted in the next iterations of the event loop, so that a burst of
+  // connections doesn't starve the existing ones.
+  static constexpr uint32_t MinAcceptBatchSize = 4;
+  static constexpr uint32_t MaxAcceptBatchSize = 256;
+  // The batch size is halved when accepting a batch takes longer than this, and doubled when it
+  // takes less than half of it.
+  static constexpr std::chrono::milliseconds AcceptBatchTimeBudget{4};
+
 protected:
   void setupServerSocket(Event::DispatcherImpl& dispatcher, Socket& socket);
 
@@ -41,6 +54,7 @@ private:
 
   Random::RandomGenerator& random_;
   UnitFloat reject_fraction_;
+  uint32_t accept_batch_size_{MaxAcceptBatchSize};
 };
 
 } // namespace Network
@@ -0,0 +1,242 @@
+#include "common/network/udp_gso_writer_impl.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_error_impl.h"
+#include "common/network/utility.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+Api::IoCallUint64Result errorResult(int sys_errno) {
+  if (sys_errno == SOCKET_ERROR_AGAIN) {
+    // EAGAIN is frequent enough that its memory allocation should be avoided.
+    return Api::IoCallUint64Result(/*rc=*/0,
+                                   Api::IoErrorPtr(IoSocketError::getIoSocketEagainInstance(),
+                                                   IoSocketError::deleteIoError));
+  }
+  return Api::IoCallUint64Result(
+      /*rc=*/0, Api::IoErrorPtr(new IoSocketError(sys_errno), IoSocketError::deleteIoError));
+}
+
+Api::IoCallUint64Result successResult(uint64_t rc) {
+  return Api::IoCallUint64Result(rc, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+bool gsoSupported() {
+#ifdef UDP_SEGMENT
+  return Api::OsSysCallsSingleton::get().supportsUdpGso();
+#else
+  return false;
+#endif
+}
+
+} // namespace
+
+UdpGsoWriterStats UdpGsoWriterStats::generate(Stats::Scope& scope, const std::string& prefix) {
+  return {UDP_GSO_WRITER_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
+bool UdpGsoWriter::Destination::set(const Address::Ip* local_ip,
+                                    const Address::Instance& peer_address) {
+  const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&peer_address);
+  if (address_base == nullptr || address_base->sockAddr() == nullptr ||
+      address_base->sockAddrLen() > sizeof(peer_)) {
+    return false;
+  }
+  peer_len_ = address_base->sockAddrLen();
+  memcpy(&peer_, address_base->sockAddr(), peer_len_);
+  if (local_ip == nullptr) {
+    local_version_ = absl::nullopt;
+    local_address_ = 0;
+  } else {
+    local_version_ = local_ip->version();
+    local_address_ = local_ip->version() == Address::IpVersion::v4 ? local_ip->ipv4()->address()
+                                                                    : local_ip->ipv6()->address();
+  }
+  return true;
+}
+
+bool UdpGsoWriter::Destination::operator==(const Destination& rhs) const {
+  return peer_len_ == rhs.peer_len_ && memcmp(&peer_, &rhs.peer_, peer_len_) == 0 &&
+         local_version_ == rhs.local_version_ && local_address_ == rhs.local_address_;
+}
+
+UdpGsoWriter::UdpGsoWriter(IoHandle& io_handle, const UdpGsoWriterStats& stats)
+    : io_handle_(io_handle), stats_(stats), gso_supported_(gsoSupported()) {}
+
+Api::IoCallUint64Result UdpGsoWriter::writePacket(const Buffer::Instance& buffer,
+                                                  const Address::Ip* local_ip,
+                                                  const Address::Instance& peer_address) {
+  if (!gso_supported_) {
+    Api::IoCallUint64Result result =
+        Utility::writeToSocket(io_handle_, buffer, local_ip, peer_address);
+    if (result.err_ && result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+      write_blocked_ = true;
+    }
+    return result;
+  }
+
+  if (write_blocked_) {
+    // Datagrams may be dropped, so don't buffer while the socket is blocked.
+    return errorResult(SOCKET_ERROR_AGAIN);
+  }
+  const uint64_t length = buffer.length();
+  if (length > MaxBatchBytes) {
+    return errorResult(SOCKET_ERROR_MSG_SIZE);
+  }
+  Destination destination;
+  if (!destination.set(local_ip, peer_address)) {
+    return IoSocketError::ioResultSocketInvalidAddress();
+  }
+
+  if (segments_ > 0 && !canAppend(destination, length)) {
+    // Failing to send the buffered datagrams only affects this one if the socket is blocked.
+    flush();
+    if (write_blocked_) {
+      return errorResult(SOCKET_ERROR_AGAIN);
+    }
+  }
+
+  if (segments_ == 0) {
+    destination_ = destination;
+    segment_size_ = length;
+  }
+  if (batch_.size() < batch_length_ + length) {
+    batch_.resize(std::min(MaxBatchBytes, std::max(2 * batch_.size(), batch_length_ + length)));
+  }
+  buffer.copyOut(0, length, batch_.data() + batch_length_);
+  batch_length_ += length;
+  ++segments_;
+
+  // A shorter datagram can only be the last one in a batch, and an empty one can't be batched at
+  // all. Otherwise, send as soon as the batch can't take another datagram of the same size.
+  if (length < segment_size_ || length == 0 || segments_ == MaxSegments ||
+      batch_length_ + segment_size_ > MaxBatchBytes) {
+    Api::IoCallUint64Result result = flush();
+    if (!result.ok()) {
+      return result;
+    }
+  }
+  return successResult(length);
+}
+
+bool UdpGsoWriter::canAppend(const Destination& destination, uint64_t length) const {
+  return destination == destination_ && length <= segment_size_ && length > 0 &&
+         segments_ < MaxSegments && batch_length_ + length <= MaxBatchBytes;
+}
+
+Api::IoCallUint64Result UdpGsoWriter::flush() {
+  if (segments_ == 0) {
+    return successResult(0);
+  }
+
+  Api::IoCallUint64Result result =
+      send(batch_.data(), batch_length_, segments_ > 1 ? segment_size_ : 0);
+  if (result.ok()) {
+    stats_.datagrams_per_batch_.recordValue(segments_);
+  } else if (segments_ > 1 && !write_blocked_) {
+    // The kernel rejects GSO sends it can't segment, e.g. if the segments exceed the path MTU or
+    // the device can't checksum them. Fall back to sending the datagrams one at a time.
+    uint64_t bytes_sent = 0;
+    for (uint64_t offset = 0; offset < batch_length_ && !write_blocked_;
+         offset += segment_size_) {
+      result = send(batch_.data() + offset, std::min(segment_size_, batch_length_ - offset), 0);
+      if (result.ok()) {
+        stats_.datagrams_per_batch_.recordValue(1);
+        bytes_sent += result.rc_;
+      }
+    }
+    if (result.ok()) {
+      result = successResult(bytes_sent);
+    }
+  }
+
+  // Whatever could not be sent is dropped, as it would be by an unbatched writer.
+  batch_length_ = 0;
+  segment_size_ = 0;
+  segments_ = 0;
+  return result;
+}
+
+Api::IoCallUint64Result UdpGsoWriter::send(const char* data, uint64_t length,
+                                           uint64_t segment_size) {
+#ifdef UDP_SEGMENT
+  iovec iov;
+  iov.iov_base = const_cast<char*>(data);
+  iov.iov_len = length;
+
+  // Room for the source address and the segment size.
+  constexpr size_t cmsg_space = CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(uint16_t));
+  alignas(cmsghdr) char cbuf[cmsg_space];
+  memset(cbuf, 0, cmsg_space);
+
+  msghdr message;
+  message.msg_name = &destination_.peer_;
+  message.msg_namelen = destination_.peer_len_;
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = cbuf;
+  message.msg_controllen = cmsg_space;
+  message.msg_flags = 0;
+
+  size_t controllen = 0;
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+  if (destination_.local_version_ == Address::IpVersion::v4) {
+    cmsg->cmsg_level = IPPROTO_IP;
+    cmsg->cmsg_type = IP_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    auto* pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi_ifindex = 0;
+    pktinfo->ipi_spec_dst.s_addr = static_cast<uint32_t>(destination_.local_address_);
+    controllen += CMSG_SPACE(sizeof(in_pktinfo));
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  } else if (destination_.local_version_ == Address::IpVersion::v6) {
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    auto* pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi6_ifindex = 0;
+    memcpy(pktinfo->ipi6_addr.s6_addr, &destination_.local_address_, sizeof(absl::uint128));
+    controllen += CMSG_SPACE(sizeof(in6_pktinfo));
+    cmsg = CMSG_NXTHDR(&message, cmsg);
+  }
+  if (segment_size > 0) {
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    const uint16_t gso_size = static_cast<uint16_t>(segment_size);
+    memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+    controllen += CMSG_SPACE(sizeof(uint16_t));
+  }
+  message.msg_controllen = controllen;
+  if (controllen == 0) {
+    message.msg_control = nullptr;
+  }
+
+  const Api::SysCallSizeResult result =
+      Api::OsSysCallsSingleton::get().sendmsg(io_handle_.fdDoNotUse(), &message, 0);
+  if (result.rc_ >= 0) {
+    return successResult(result.rc_);
+  }
+  if (result.errno_ == SOCKET_ERROR_AGAIN) {
+    write_blocked_ = true;
+  }
+  return errorResult(result.errno_);
+#else
+  UNREFERENCED_PARAMETER(data);
+  UNREFERENCED_PARAMETER(length);
+  UNREFERENCED_PARAMETER(segment_size);
+  NOT_REACHED_GCOVR_EXCL_LINE;
+#endif
+}
+
+} // namespace Network
+} // namespace Envoy
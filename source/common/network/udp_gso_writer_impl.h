@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/platform.h"
+#include "envoy/network/udp_packet_writer_handler.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "absl/numeric/int128.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All UDP GSO writer stats. @see stats_macros.h
+ */
+#define UDP_GSO_WRITER_STATS(HISTOGRAM) HISTOGRAM(datagrams_per_batch, Unspecified)
+
+/**
+ * Struct definition for all UDP GSO writer stats. @see stats_macros.h
+ */
+struct UdpGsoWriterStats {
+  UDP_GSO_WRITER_STATS(GENERATE_HISTOGRAM_STRUCT)
+
+  static UdpGsoWriterStats generate(Stats::Scope& scope, const std::string& prefix);
+};
+
+/**
+ * UDP packet writer that coalesces consecutive datagrams to the same peer, sent from the same
+ * local IP, into a single sendmsg() using UDP generic segmentation offload (UDP_SEGMENT). The
+ * kernel (or the NIC) splits the batch back into individual datagrams, so the peer sees exactly
+ * what an unbatched writer would have sent. All datagrams in a batch but the last one must be the
+ * same size; a different size or destination ends the batch.
+ *
+ * Buffered datagrams are sent on flush(), which callers must invoke at the end of each IO event.
+ * The batch buffer grows with the largest batch written, up to MaxBatchBytes. If the OS doesn't
+ * support GSO, every datagram is sent as soon as it is written.
+ */
+class UdpGsoWriter : public UdpPacketWriter {
+public:
+  // The kernel limit for the number of segments in one GSO send.
+  static constexpr uint32_t MaxSegments = 64;
+  // Payload of the largest UDP datagram, which bounds the total size of a batch.
+  static constexpr uint64_t MaxBatchBytes = 65507;
+
+  UdpGsoWriter(IoHandle& io_handle, const UdpGsoWriterStats& stats);
+
+  // Network::UdpPacketWriter
+  Api::IoCallUint64Result writePacket(const Buffer::Instance& buffer, const Address::Ip* local_ip,
+                                      const Address::Instance& peer_address) override;
+  bool isWriteBlocked() const override { return write_blocked_; }
+  void setWritable() override { write_blocked_ = false; }
+  uint64_t getMaxPacketSize(const Address::Instance& /*peer_address*/) const override {
+    return UdpMaxOutgoingPacketSize;
+  }
+  bool isBatchMode() const override { return gso_supported_; }
+  UdpPacketWriterBuffer getNextWriteLocation(const Address::Ip* /*local_ip*/,
+                                             const Address::Instance& /*peer_address*/) override {
+    return {nullptr, 0, nullptr};
+  }
+  Api::IoCallUint64Result flush() override;
+
+  /**
+   * @return the number of datagrams currently buffered.
+   */
+  uint32_t bufferedDatagrams() const { return segments_; }
+
+private:
+  // Copies of the addresses of the current batch. The caller's addresses aren't guaranteed to
+  // outlive the write.
+  struct Destination {
+    bool set(const Address::Ip* local_ip, const Address::Instance& peer_address);
+    bool operator==(const Destination& rhs) const;
+
+    sockaddr_storage peer_{};
+    socklen_t peer_len_{};
+    absl::optional<Address::IpVersion> local_version_;
+    absl::uint128 local_address_{};
+  };
+
+  bool canAppend(const Destination& destination, uint64_t length) const;
+  Api::IoCallUint64Result send(const char* data, uint64_t length, uint64_t segment_size);
+
+  IoHandle& io_handle_;
+  UdpGsoWriterStats stats_;
+  const bool gso_supported_;
+  bool write_blocked_{};
+  Destination destination_;
+  std::vector<char> batch_;
+  uint64_t batch_length_{};
+  uint64_t segment_size_{};
+  uint32_t segments_{};
+};
+
+class UdpGsoWriterFactory : public UdpPacketWriterFactory {
+public:
+  // Network::UdpPacketWriterFactory
+  UdpPacketWriterPtr createUdpPacketWriter(IoHandle& io_handle, Stats::Scope& scope) override {
+    return std::make_unique<UdpGsoWriter>(io_handle,
+                                          UdpGsoWriterStats::generate(scope, "udp.gso_writer."));
+  }
+};
+
+} // namespace Network
+} // namespace Envoy
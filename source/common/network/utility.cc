@@ -93,6 +93,26 @@ uint32_t portFromUrl(const std::string& url, absl::string_view scheme,
   }
 }
 
+/**
+ * A segment of a datagram received with GRO, which references the storage of the whole datagram
+ * instead of copying it. The storage is freed with the last of its segments.
+ */
+class GroSegment : public Buffer::BufferFragment {
+public:
+  GroSegment(const std::shared_ptr<Buffer::Instance>& datagram, const uint8_t* data, size_t size)
+      : datagram_(datagram), data_(data), size_(size) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_; }
+  size_t size() const override { return size_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<Buffer::Instance> datagram_;
+  const uint8_t* const data_;
+  const size_t size_;
+};
+
 Api::IoCallUint64Result receiveMessage(uint64_t max_rx_datagram_size, Buffer::InstancePtr& buffer,
                                        IoHandle::RecvMsgOutput& output, IoHandle& handle,
                                        const Address::Instance& local_address) {
@@ -606,14 +626,17 @@ Api::IoCallUint64Result Utility::readFromSocket(IoHandle& handle,
       return result;
     }
 
-    // Segment the buffer read by the recvmsg syscall into gso_sized sub buffers.
-    // TODO(mattklein123): The following code should be optimized to avoid buffer copies, either by
-    // switching to slices or by using a CoW buffer type.
-    while (buffer->length() > 0) {
-      const uint64_t bytes_to_copy = std::min(buffer->length(), gso_size);
+    // Segment the buffer read by the recvmsg syscall into gso_sized sub buffers, which reference
+    // its single slice instead of copying it.
+    const Buffer::RawSlice slice = buffer->frontSlice();
+    ASSERT(slice.len_ == buffer->length());
+    const std::shared_ptr<Buffer::Instance> datagram = std::move(buffer);
+    const uint8_t* data = static_cast<const uint8_t*>(slice.mem_);
+    for (uint64_t offset = 0; offset < slice.len_; offset += gso_size) {
+      const uint64_t segment_size = std::min<uint64_t>(slice.len_ - offset, gso_size);
       Buffer::InstancePtr sub_buffer = std::make_unique<Buffer::OwnedImpl>();
-      sub_buffer->move(*buffer, bytes_to_copy);
-      passPayloadToProcessor(bytes_to_copy, std::move(sub_buffer), output.msg_[0].peer_address_,
+      sub_buffer->addBufferFragment(*new GroSegment(datagram, data + offset, segment_size));
+      passPayloadToProcessor(segment_size, std::move(sub_buffer), output.msg_[0].peer_address_,
                              output.msg_[0].local_address_, udp_packet_processor, receive_time);
     }
 
@@ -730,11 +753,16 @@ ResolvedUdpSocketConfig::ResolvedUdpSocketConfig(
     const envoy::config::core::v3::UdpSocketConfig& config, bool prefer_gro_default)
     : max_rx_datagram_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_rx_datagram_size,
                                                             DEFAULT_UDP_MAX_DATAGRAM_SIZE)),
-      prefer_gro_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefer_gro, prefer_gro_default)) {
+      prefer_gro_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefer_gro, prefer_gro_default)),
+      prefer_gso_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, prefer_gso, false)) {
   if (prefer_gro_ && !Api::OsSysCallsSingleton::get().supportsUdpGro()) {
     ENVOY_LOG_MISC(
         warn, "GRO requested but not supported by the OS. Check OS config or disable prefer_gro.");
   }
+  if (prefer_gso_ && !Api::OsSysCallsSingleton::get().supportsUdpGso()) {
+    ENVOY_LOG_MISC(
+        warn, "GSO requested but not supported by the OS. Check OS config or disable prefer_gso.");
+  }
 }
 
 } // namespace Network
@@ -76,6 +76,7 @@ struct ResolvedUdpSocketConfig {
 
   uint64_t max_rx_datagram_size_;
   bool prefer_gro_;
+  bool prefer_gso_;
 };
 
 /**
@@ -0,0 +1,196 @@
+#include "common/profiler/sampling_profiler.h"
+
+#include <string>
+
+#ifdef SAMPLING_PROFILER_AVAILABLE
+
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "common/profiler/profiler.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/debugging/stacktrace.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+constexpr uint32_t MaxFrequencyHz = 1000;
+
+struct Sample {
+  // Odd while the sample is being written by a signal handler, zero until it's first written.
+  std::atomic<uint32_t> version_{0};
+  int32_t thread_id_;
+  int32_t depth_;
+  void* stack_[Sampling::MaxStackDepth];
+};
+
+// Allocated when the profiler is first started and never freed, as a signal may still be delivered
+// after the profiler is stopped.
+std::atomic<Sample*> samples{nullptr};
+std::atomic<uint64_t> next_sample{0};
+std::atomic<bool> started{false};
+uint64_t period_us = 0;
+
+void handleSignal(int, siginfo_t*, void* context) {
+  const int saved_errno = errno;
+  Sample* const all_samples = samples.load(std::memory_order_acquire);
+  if (all_samples != nullptr && started.load(std::memory_order_relaxed)) {
+    Sample& sample =
+        all_samples[next_sample.fetch_add(1, std::memory_order_relaxed) % Sampling::MaxSamples];
+    uint32_t version = sample.version_.load(std::memory_order_relaxed);
+    // The slot is skipped if another thread is still writing it after the buffer wrapped around.
+    if (version % 2 == 0 &&
+        sample.version_.compare_exchange_strong(version, version + 1, std::memory_order_acquire)) {
+      sample.thread_id_ = static_cast<int32_t>(syscall(SYS_gettid));
+      sample.depth_ =
+          absl::GetStackTraceWithContext(sample.stack_, Sampling::MaxStackDepth,
+                                         /* skip_count = */ 1, context,
+                                         /* min_dropped_frames = */ nullptr);
+      sample.version_.store(version + 2, std::memory_order_release);
+    }
+  }
+  errno = saved_errno;
+}
+
+bool setTimer(uint64_t interval_us) {
+  itimerval timer{};
+  timer.it_interval.tv_sec = interval_us / 1000000;
+  timer.it_interval.tv_usec = interval_us % 1000000;
+  timer.it_value = timer.it_interval;
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+} // namespace
+
+bool Sampling::profilerAvailable() { return true; }
+
+bool Sampling::isProfilerStarted() { return started.load(std::memory_order_relaxed); }
+
+bool Sampling::startProfiler(uint32_t frequency_hz) {
+  // The gperftools CPU profiler uses the same timer and signal.
+  if (frequency_hz == 0 || frequency_hz > MaxFrequencyHz || isProfilerStarted() ||
+      Cpu::profilerEnabled()) {
+    return false;
+  }
+
+  Sample* all_samples = samples.load(std::memory_order_relaxed);
+  if (all_samples == nullptr) {
+    samples.store(new Sample[MaxSamples], std::memory_order_release);
+  } else {
+    for (uint32_t i = 0; i < MaxSamples; ++i) {
+      all_samples[i].version_.store(0, std::memory_order_relaxed);
+    }
+  }
+  next_sample.store(0, std::memory_order_relaxed);
+
+  struct sigaction action {};
+  action.sa_sigaction = handleSignal;
+  action.sa_flags = SA_RESTART | SA_SIGINFO;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(SIGPROF, &action, nullptr) != 0) {
+    return false;
+  }
+  period_us = 1000000 / frequency_hz;
+  started.store(true, std::memory_order_relaxed);
+  if (!setTimer(period_us)) {
+    stopProfiler();
+    return false;
+  }
+  return true;
+}
+
+void Sampling::stopProfiler() {
+  if (!isProfilerStarted()) {
+    return;
+  }
+  setTimer(0);
+  started.store(false, std::memory_order_relaxed);
+  // The default action of SIGPROF terminates the process, so the signals still in flight are
+  // ignored instead.
+  signal(SIGPROF, SIG_IGN);
+}
+
+std::string Sampling::profile(absl::optional<int64_t> thread_id) {
+  const Sample* const all_samples = samples.load(std::memory_order_acquire);
+  if (all_samples == nullptr) {
+    return "";
+  }
+
+  absl::flat_hash_map<std::vector<uintptr_t>, uint64_t> stacks;
+  std::vector<uintptr_t> stack;
+  for (uint32_t i = 0; i < MaxSamples; ++i) {
+    const Sample& sample = all_samples[i];
+    const uint32_t version = sample.version_.load(std::memory_order_acquire);
+    if (version == 0 || version % 2 != 0) {
+      continue;
+    }
+    const int32_t sample_thread_id = sample.thread_id_;
+    const int32_t depth = std::min<int32_t>(sample.depth_, MaxStackDepth);
+    stack.clear();
+    for (int32_t frame = 0; frame < depth; ++frame) {
+      stack.push_back(reinterpret_cast<uintptr_t>(sample.stack_[frame]));
+    }
+    // The sample is dropped if a signal handler overwrote it while it was copied.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sample.version_.load(std::memory_order_relaxed) != version || stack.empty() ||
+        (thread_id.has_value() && thread_id.value() != sample_thread_id)) {
+      continue;
+    }
+    ++stacks[stack];
+  }
+
+  // See https://github.com/gperftools/gperftools/blob/master/docs/cpuprofile-fileformat.html.
+  std::string output;
+  const auto add_word = [&output](uintptr_t word) {
+    output.append(reinterpret_cast<const char*>(&word), sizeof(word));
+  };
+  add_word(0);
+  add_word(3);
+  add_word(0);
+  add_word(period_us);
+  add_word(0);
+  for (const auto& [pcs, count] : stacks) {
+    add_word(count);
+    add_word(pcs.size());
+    for (const uintptr_t pc : pcs) {
+      add_word(pc);
+    }
+  }
+  add_word(0);
+  add_word(1);
+  add_word(0);
+  // pprof maps the addresses to the binary and the shared libraries with the memory map.
+  std::ifstream maps("/proc/self/maps");
+  output.append(std::istreambuf_iterator<char>(maps), std::istreambuf_iterator<char>());
+  return output;
+}
+
+} // namespace Profiler
+} // namespace Envoy
+
+#else
+
+namespace Envoy {
+namespace Profiler {
+
+bool Sampling::profilerAvailable() { return false; }
+bool Sampling::isProfilerStarted() { return false; }
+bool Sampling::startProfiler(uint32_t) { return false; }
+void Sampling::stopProfiler() {}
+std::string Sampling::profile(absl::optional<int64_t>) { return ""; }
+
+} // namespace Profiler
+} // namespace Envoy
+
+#endif // #ifdef SAMPLING_PROFILER_AVAILABLE
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "absl/types/optional.h"
+
+// The sampling profiler relies on the per-process CPU time interval timer and on the thread ids of
+// Linux.
+#if defined(__linux__)
+#define SAMPLING_PROFILER_AVAILABLE
+#endif
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Process wide, low frequency CPU sampling. The profiler samples the stack of the thread consuming
+ * CPU at the configured frequency, in samples per second of CPU time of the process, and keeps the
+ * last MaxSamples samples in memory, so that a recent profile can be taken at any time without
+ * restarting. It can't run along with the CPU profiler of gperftools, which uses the same timer.
+ */
+class Sampling {
+public:
+  static constexpr uint32_t MaxSamples = 8192;
+  static constexpr uint32_t MaxStackDepth = 64;
+
+  /**
+   * @return whether the profiler is supported on this platform.
+   */
+  static bool profilerAvailable();
+
+  /**
+   * @return whether the profiler is started or not.
+   */
+  static bool isProfilerStarted();
+
+  /**
+   * Start the profiler, dropping the samples taken by a previous run.
+   * @param frequency_hz supplies the number of samples per second of CPU time of the process.
+   * @return bool whether the call to start the profiler succeeded.
+   */
+  static bool startProfiler(uint32_t frequency_hz);
+
+  /**
+   * Stop the profiler. The samples taken so far are kept.
+   */
+  static void stopProfiler();
+
+  /**
+   * Aggregates the samples kept by the profiler into a profile in the legacy binary format of the
+   * gperftools CPU profiler, which the pprof tool reads.
+   * @param thread_id supplies the id of the thread to take the samples of, or nullopt for all the
+   *        threads.
+   * @return the profile, or an empty string if the profiler was never started.
+   */
+  static std::string profile(absl::optional<int64_t> thread_id = absl::nullopt);
+};
+
+} // namespace Profiler
+} // namespace Envoy
@@ -3,6 +3,7 @@
 #include "common/http/utility.h"
 #include "common/quic/envoy_quic_server_connection.h"
 #include "common/quic/envoy_quic_server_session.h"
+#include "common/quic/envoy_quic_utils.h"
 
 namespace Envoy {
 namespace Quic {
@@ -78,5 +79,14 @@ std::unique_ptr<quic::QuicSession> EnvoyQuicDispatcher::CreateQuicSession(
   return quic_session;
 }
 
+quic::QuicConnectionId EnvoyQuicDispatcher::ReplaceLongServerConnectionId(
+    const quic::ParsedQuicVersion& version, const quic::QuicConnectionId& server_connection_id,
+    uint8_t expected_server_connection_id_length) const {
+  quic::QuicConnectionId new_connection_id = quic::QuicDispatcher::ReplaceLongServerConnectionId(
+      version, server_connection_id, expected_server_connection_id_length);
+  adjustNewConnectionIdForRouting(new_connection_id, server_connection_id);
+  return new_connection_id;
+}
+
 } // namespace Quic
 } // namespace Envoy
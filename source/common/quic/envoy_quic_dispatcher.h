@@ -67,6 +67,14 @@ protected:
                                                        const quic::ParsedQuicVersion& version,
                                                        absl::string_view sni) override;
 
+  // quic::QuicDispatcher
+  // The connection ids chosen by the server keep the routing of the connection id of the client,
+  // so that the packets of the connection stay on this worker.
+  quic::QuicConnectionId
+  ReplaceLongServerConnectionId(const quic::ParsedQuicVersion& version,
+                                const quic::QuicConnectionId& server_connection_id,
+                                uint8_t expected_server_connection_id_length) const override;
+
 private:
   Network::ConnectionHandler& connection_handler_;
   Network::ListenerConfig& listener_config_;
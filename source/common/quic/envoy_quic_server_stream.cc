@@ -65,7 +65,7 @@ EnvoyQuicServerStream::EnvoyQuicServerStream(
       headers_with_underscores_action_(headers_with_underscores_action) {}
 
 void EnvoyQuicServerStream::encode100ContinueHeaders(const Http::ResponseHeaderMap& headers) {
-  ASSERT(headers.Status()->value() == "100");
+  ASSERT(headers.Status()->value() == "100" || headers.Status()->value() == "103");
   encodeHeaders(headers, false);
 }
 
@@ -105,6 +105,9 @@ public:
     removeCallbacksHelper(callbacks);
   }
   uint32_t bufferLimit() override { return send_buffer_simulation_.highWatermark(); }
+  void setAccount(Buffer::BufferMemoryAccountSharedPtr) override {
+    // The QUIC streams buffer in the QUICHE stream sequencers, which aren't accounted.
+  }
   const Network::Address::InstanceConstSharedPtr& connectionLocalAddress() override {
     return connection()->addressProvider().localAddress();
   }
@@ -3,6 +3,7 @@
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
 
+#include "common/common/safe_memcpy.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
 
@@ -223,5 +224,17 @@ int deduceSignatureAlgorithmFromPublicKey(const EVP_PKEY* public_key, std::strin
   return sign_alg;
 }
 
+void adjustNewConnectionIdForRouting(quic::QuicConnectionId& new_connection_id,
+                                     const quic::QuicConnectionId& old_connection_id) {
+  if (new_connection_id.length() < sizeof(uint32_t) ||
+      old_connection_id.length() < sizeof(uint32_t)) {
+    // Such short connection ids are routed by their 5-tuple anyway.
+    return;
+  }
+  uint32_t routing_word;
+  safeMemcpyUnsafeSrc(&routing_word, old_connection_id.data());
+  safeMemcpyUnsafeDst(new_connection_id.mutable_data(), &routing_word);
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -21,6 +21,7 @@
 #endif
 
 #include "quiche/quic/core/http/quic_header_list.h"
+#include "quiche/quic/core/quic_connection_id.h"
 #include "quiche/quic/core/quic_error_codes.h"
 #include "quiche/quic/platform/api/quic_ip_address.h"
 #include "quiche/quic/platform/api/quic_socket_address.h"
@@ -125,5 +126,11 @@ bssl::UniquePtr<X509> parseDERCertificate(const std::string& der_bytes, std::str
 // not supported, return 0 with error_details populated correspondingly.
 int deduceSignatureAlgorithmFromPublicKey(const EVP_PKEY* public_key, std::string* error_details);
 
+// Make a server connection id route to the same worker as the connection id it replaces, by
+// copying the first 4 bytes of the old connection id that the workers are selected with, both by
+// the BPF program of the listen sockets and by ActiveQuicListener::destination().
+void adjustNewConnectionIdForRouting(quic::QuicConnectionId& new_connection_id,
+                                     const quic::QuicConnectionId& old_connection_id);
+
 } // namespace Quic
 } // namespace Envoy
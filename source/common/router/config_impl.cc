@@ -70,7 +70,11 @@ std::string SslRedirector::newPath(const Http::RequestHeaderMap& headers) const
 HedgePolicyImpl::HedgePolicyImpl(const envoy::config::route::v3::HedgePolicy& hedge_policy)
     : initial_requests_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(hedge_policy, initial_requests, 1)),
       additional_request_chance_(hedge_policy.additional_request_chance()),
-      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()) {}
+      hedge_on_per_try_timeout_(hedge_policy.hedge_on_per_try_timeout()),
+      latency_hedging_(hedge_policy.has_hedge_on_latency_percentile()
+                           ? std::make_unique<LatencyHedgingImpl>(
+                                 hedge_policy.hedge_on_latency_percentile())
+                           : nullptr) {}
 
 HedgePolicyImpl::HedgePolicyImpl() : initial_requests_(1), hedge_on_per_try_timeout_(false) {}
 
@@ -1113,6 +1117,7 @@ RegexRouteEntryImpl::RegexRouteEntryImpl(
            envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex);
     regex_ = Regex::Utility::parseRegex(route.match().safe_regex());
     regex_str_ = route.match().safe_regex().regex();
+    safe_regex_ = true;
   }
 }
 
@@ -1173,7 +1178,7 @@ RouteConstSharedPtr ConnectRouteEntryImpl::matches(const Http::RequestHeaderMap&
 
 VirtualHostImpl::VirtualHostImpl(
     const envoy::config::route::v3::VirtualHost& virtual_host,
-    const ConfigImpl& global_route_config,
+    const CommonConfigSharedPtr& global_route_config,
     Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
     ProtobufMessage::ValidationVisitor& validator,
     const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters)
@@ -1241,16 +1246,17 @@ VirtualHostImpl::VirtualHostImpl(
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
+  }
 
-    if (validation_clusters.has_value()) {
-      routes_.back()->validateClusters(*validation_clusters);
-      for (const auto& shadow_policy : routes_.back()->shadowPolicies()) {
-        ASSERT(!shadow_policy->cluster().empty());
-        if (!validation_clusters->hasCluster(shadow_policy->cluster())) {
-          throw EnvoyException(
-              fmt::format("route: unknown shadow cluster '{}'", shadow_policy->cluster()));
-        }
-      }
+  if (validation_clusters.has_value()) {
+    validateClusters(*validation_clusters);
+  }
+
+  if (routes_.size() >= MinRoutesForIndex &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.route_path_index")) {
+    auto route_index = std::make_unique<const RouteIndex>(routes_);
+    if (route_index->worthwhile(routes_.size())) {
+      route_index_ = std::move(route_index);
     }
   }
 
@@ -1297,7 +1303,93 @@ VirtualHostImpl::VirtualClusterEntry::VirtualClusterEntry(
   }
 }
 
-const Config& VirtualHostImpl::routeConfig() const { return global_route_config_; }
+VirtualHostImpl::RouteIndex::RouteIndex(
+    const std::vector<RouteEntryImplBaseConstSharedPtr>& routes) {
+  std::vector<std::string> regexes;
+  for (uint32_t i = 0; i < routes.size(); ++i) {
+    const RouteEntryImplBase& route = *routes[i];
+    if (route.caseSensitive() && route.matchType() == PathMatchType::Exact) {
+      exact_path_routes_[route.matcher()].push_back(i);
+    } else if (route.caseSensitive() && route.matchType() == PathMatchType::Prefix) {
+      prefix_routes_[route.matcher()].push_back(i);
+    } else if (route.matchType() == PathMatchType::Regex &&
+               static_cast<const RegexRouteEntryImpl&>(route).safeRegex()) {
+      regex_routes_.push_back(i);
+      regexes.push_back(route.matcher());
+    } else {
+      unindexed_routes_.push_back(i);
+    }
+  }
+
+  if (regex_routes_.size() >= MinRegexRoutesForSet) {
+    try {
+      regex_routes_matcher_ = Regex::Utility::parseRegexSet(regexes);
+    } catch (const EnvoyException& e) {
+      ENVOY_LOG_MISC(debug, "matching the regex routes one by one: {}", e.what());
+    }
+  }
+  if (regex_routes_matcher_ == nullptr) {
+    unindexed_routes_.insert(unindexed_routes_.end(), regex_routes_.begin(), regex_routes_.end());
+    regex_routes_.clear();
+  }
+
+  for (const auto& prefix : prefix_routes_) {
+    prefix_lengths_.push_back(prefix.first.size());
+  }
+  std::sort(prefix_lengths_.begin(), prefix_lengths_.end());
+  prefix_lengths_.erase(std::unique(prefix_lengths_.begin(), prefix_lengths_.end()),
+                        prefix_lengths_.end());
+}
+
+void VirtualHostImpl::RouteIndex::findCandidates(absl::string_view path,
+                                                 Candidates& candidates) const {
+  candidates.assign(unindexed_routes_.begin(), unindexed_routes_.end());
+
+  if (regex_routes_matcher_ != nullptr) {
+    std::vector<int> matches;
+    if (regex_routes_matcher_->match(path, matches)) {
+      for (const int match : matches) {
+        candidates.push_back(regex_routes_[match]);
+      }
+    } else {
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  const auto exact = exact_path_routes_.find(path);
+  if (exact != exact_path_routes_.end()) {
+    candidates.insert(candidates.end(), exact->second.begin(), exact->second.end());
+  }
+
+  for (const size_t length : prefix_lengths_) {
+    if (length > path.size()) {
+      break;
+    }
+    const auto prefix = prefix_routes_.find(path.substr(0, length));
+    if (prefix != prefix_routes_.end()) {
+      candidates.insert(candidates.end(), prefix->second.begin(), prefix->second.end());
+    }
+  }
+
+  // Restore route table order so that the first matching route still wins.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+const CommonConfig& VirtualHostImpl::routeConfig() const { return *global_route_config_; }
+
+void VirtualHostImpl::validateClusters(
+    const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const {
+  for (const auto& route : routes_) {
+    route->validateClusters(cluster_info_maps);
+    for (const auto& shadow_policy : route->shadowPolicies()) {
+      ASSERT(!shadow_policy->cluster().empty());
+      if (!cluster_info_maps.hasCluster(shadow_policy->cluster())) {
+        throw EnvoyException(
+            fmt::format("route: unknown shadow cluster '{}'", shadow_policy->cluster()));
+      }
+    }
+  }
+}
 
 const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::string& name) const {
   return per_filter_configs_.get(name);
@@ -1326,9 +1418,10 @@ const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
 }
 
 RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& route_config,
-                           const ConfigImpl& global_route_config,
+                           const CommonConfigSharedPtr& global_route_config,
                            Server::Configuration::ServerFactoryContext& factory_context,
-                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters)
+                           ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+                           const RouteMatcher* previous_matcher)
     : vhost_scope_(factory_context.scope().scopeFromStatName(
           factory_context.routerContext().virtualClusterStatNames().vhost_)) {
   absl::optional<Upstream::ClusterManager::ClusterInfoMaps> validation_clusters;
@@ -1336,9 +1429,26 @@ RouteMatcher::RouteMatcher(const envoy::config::route::v3::RouteConfiguration& r
     validation_clusters = factory_context.clusterManager().clusters();
   }
   for (const auto& virtual_host_config : route_config.virtual_hosts()) {
-    VirtualHostSharedPtr virtual_host(new VirtualHostImpl(virtual_host_config, global_route_config,
-                                                          factory_context, *vhost_scope_, validator,
-                                                          validation_clusters));
+    VirtualHostSharedPtr virtual_host;
+    if (!validate_clusters) {
+      const uint64_t hash = MessageUtil::hash(virtual_host_config);
+      if (previous_matcher != nullptr) {
+        const auto it = previous_matcher->virtual_hosts_by_hash_.find(hash);
+        if (it != previous_matcher->virtual_hosts_by_hash_.end()) {
+          virtual_host = it->second;
+        }
+      }
+      if (virtual_host == nullptr) {
+        virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                         factory_context, *vhost_scope_, validator,
+                                                         validation_clusters);
+      }
+      virtual_hosts_by_hash_.emplace(hash, virtual_host);
+    } else {
+      virtual_host = std::make_shared<VirtualHostImpl>(virtual_host_config, global_route_config,
+                                                       factory_context, *vhost_scope_, validator,
+                                                       validation_clusters);
+    }
     for (const std::string& domain_name : virtual_host_config.domains()) {
       const std::string domain = Http::LowerCaseString(domain_name).get();
       bool duplicate_found = false;
@@ -1388,6 +1498,22 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return SSL_REDIRECT_ROUTE;
   }
 
+  // The index can only be used when the caller does not need to walk every route that matches,
+  // since it doesn't track whether any routes remain after a candidate.
+  if (route_index_ != nullptr && !cb && headers.Path() != nullptr) {
+    RouteIndex::Candidates candidates;
+    route_index_->findCandidates(Http::PathUtil::removeQueryAndFragment(headers.getPathValue()),
+                                 candidates);
+    for (const uint32_t candidate : candidates) {
+      RouteConstSharedPtr route_entry =
+          routes_[candidate]->matches(headers, stream_info, random_value);
+      if (route_entry != nullptr) {
+        return route_entry;
+      }
+    }
+    return nullptr;
+  }
+
   // Check for a route that matches the request.
   for (auto route = routes_.begin(); route != routes_.end(); ++route) {
     if (!headers.Path() && !(*route)->supportsPathlessHeaders()) {
@@ -1420,6 +1546,31 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
   return nullptr;
 }
 
+void RouteMatcher::validateClusters(
+    const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const {
+  // A virtual host with several domains is found several times.
+  absl::flat_hash_set<const VirtualHostImpl*> validated;
+  const auto validate = [&](const VirtualHostSharedPtr& virtual_host) {
+    if (validated.insert(virtual_host.get()).second) {
+      virtual_host->validateClusters(cluster_info_maps);
+    }
+  };
+  for (const auto& entry : virtual_hosts_) {
+    validate(entry.second);
+  }
+  for (const auto* wildcard_virtual_hosts :
+       {&wildcard_virtual_host_suffixes_, &wildcard_virtual_host_prefixes_}) {
+    for (const auto& by_length : *wildcard_virtual_hosts) {
+      for (const auto& entry : by_length.second) {
+        validate(entry.second);
+      }
+    }
+  }
+  if (default_virtual_host_ != nullptr) {
+    validate(default_virtual_host_);
+  }
+}
+
 const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::RequestHeaderMap& headers) const {
   // Fast path the case where we only have a default virtual host.
   if (virtual_hosts_.empty() && wildcard_virtual_host_suffixes_.empty() &&
@@ -1491,35 +1642,81 @@ VirtualHostImpl::virtualClusterFromEntries(const Http::HeaderMap& headers) const
   return nullptr;
 }
 
-ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
-                       Server::Configuration::ServerFactoryContext& factory_context,
-                       ProtobufMessage::ValidationVisitor& validator,
-                       bool validate_clusters_default)
-    : name_(config.name()), symbol_table_(factory_context.scope().symbolTable()),
-      uses_vhds_(config.has_vhds()),
+CommonConfigImpl::CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config)
+    : request_headers_parser_(HeaderParser::configure(config.request_headers_to_add(),
+                                                      config.request_headers_to_remove())),
+      response_headers_parser_(HeaderParser::configure(config.response_headers_to_add(),
+                                                       config.response_headers_to_remove())),
+      name_(config.name()), uses_vhds_(config.has_vhds()),
       most_specific_header_mutations_wins_(config.most_specific_header_mutations_wins()),
       max_direct_response_body_size_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_direct_response_body_size_bytes,
-                                          DEFAULT_MAX_DIRECT_RESPONSE_BODY_SIZE_BYTES)) {
-  route_matcher_ = std::make_unique<RouteMatcher>(
-      config, *this, factory_context, validator,
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default));
-
+                                          DEFAULT_MAX_DIRECT_RESPONSE_BODY_SIZE_BYTES)),
+      hash_(hash(config)) {
   for (const std::string& header : config.internal_only_headers()) {
     internal_only_headers_.push_back(Http::LowerCaseString(header));
   }
+}
+
+uint64_t CommonConfigImpl::hash(const envoy::config::route::v3::RouteConfiguration& config) {
+  // Copying the fields one by one avoids copying the virtual hosts, which are most of the config.
+  envoy::config::route::v3::RouteConfiguration common_config;
+  common_config.set_name(config.name());
+  if (config.has_vhds()) {
+    *common_config.mutable_vhds() = config.vhds();
+  }
+  *common_config.mutable_internal_only_headers() = config.internal_only_headers();
+  *common_config.mutable_response_headers_to_add() = config.response_headers_to_add();
+  *common_config.mutable_response_headers_to_remove() = config.response_headers_to_remove();
+  *common_config.mutable_request_headers_to_add() = config.request_headers_to_add();
+  *common_config.mutable_request_headers_to_remove() = config.request_headers_to_remove();
+  common_config.set_most_specific_header_mutations_wins(
+      config.most_specific_header_mutations_wins());
+  if (config.has_validate_clusters()) {
+    *common_config.mutable_validate_clusters() = config.validate_clusters();
+  }
+  if (config.has_max_direct_response_body_size_bytes()) {
+    *common_config.mutable_max_direct_response_body_size_bytes() =
+        config.max_direct_response_body_size_bytes();
+  }
+  return MessageUtil::hash(common_config);
+}
 
-  request_headers_parser_ =
-      HeaderParser::configure(config.request_headers_to_add(), config.request_headers_to_remove());
-  response_headers_parser_ = HeaderParser::configure(config.response_headers_to_add(),
-                                                     config.response_headers_to_remove());
+ConfigImpl::ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
+                       Server::Configuration::ServerFactoryContext& factory_context,
+                       ProtobufMessage::ValidationVisitor& validator,
+                       bool validate_clusters_default, const ConfigImpl* previous_config)
+    : route_cache_(RouteCache::create(config)) {
+  const RouteMatcher* previous_matcher = nullptr;
+  if (previous_config != nullptr &&
+      previous_config->shared_config_->hash() == CommonConfigImpl::hash(config)) {
+    shared_config_ = previous_config->shared_config_;
+    previous_matcher = previous_config->route_matcher_.get();
+  } else {
+    shared_config_ = std::make_shared<CommonConfigImpl>(config);
+  }
+  route_matcher_ = std::make_unique<RouteMatcher>(
+      config, shared_config_, factory_context, validator,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, validate_clusters, validate_clusters_default),
+      previous_matcher);
 }
 
 RouteConstSharedPtr ConfigImpl::route(const RouteCallback& cb,
                                       const Http::RequestHeaderMap& headers,
                                       const StreamInfo::StreamInfo& stream_info,
                                       uint64_t random_value) const {
-  return route_matcher_->route(cb, headers, stream_info, random_value);
+  // The callbacks may walk more than the first matching route.
+  if (route_cache_ == nullptr || cb) {
+    return route_matcher_->route(cb, headers, stream_info, random_value);
+  }
+  std::string key = route_cache_->key(headers);
+  absl::optional<RouteConstSharedPtr> cached_route = route_cache_->lookup(key);
+  if (cached_route.has_value()) {
+    return std::move(cached_route.value());
+  }
+  RouteConstSharedPtr route = route_matcher_->route(nullptr, headers, stream_info, random_value);
+  route_cache_->insert(std::move(key), route);
+  return route;
 }
 
 namespace {
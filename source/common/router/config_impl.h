@@ -20,17 +20,22 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/matchers.h"
+#include "common/common/regex.h"
 #include "common/config/metadata.h"
 #include "common/http/hash_policy.h"
 #include "common/http/header_utility.h"
 #include "common/router/config_utility.h"
 #include "common/router/header_formatter.h"
 #include "common/router/header_parser.h"
+#include "common/router/latency_hedging_impl.h"
 #include "common/router/metadatamatchcriteria_impl.h"
+#include "common/router/route_cache_impl.h"
 #include "common/router/router_ratelimit.h"
 #include "common/router/tls_context_match_criteria_impl.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -156,7 +161,55 @@ private:
   const bool legacy_enabled_;
 };
 
-class ConfigImpl;
+/**
+ * The part of a RouteConfiguration that its virtual hosts refer to. It is kept by the next
+ * ConfigImpl of the route when the fields it is built from didn't change, along with the virtual
+ * hosts that didn't change either.
+ */
+class CommonConfigImpl : public CommonConfig {
+public:
+  CommonConfigImpl(const envoy::config::route::v3::RouteConfiguration& config);
+
+  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
+  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+
+  /**
+   * @return the hash of the fields of the RouteConfiguration this was built from, which are all
+   *         the fields but its virtual hosts.
+   */
+  uint64_t hash() const { return hash_; }
+
+  /**
+   * @return the hash of the fields of a RouteConfiguration a CommonConfigImpl is built from.
+   */
+  static uint64_t hash(const envoy::config::route::v3::RouteConfiguration& config);
+
+  // Router::CommonConfig
+  const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
+    return internal_only_headers_;
+  }
+  const std::string& name() const override { return name_; }
+  bool usesVhds() const override { return uses_vhds_; }
+  bool mostSpecificHeaderMutationsWins() const override {
+    return most_specific_header_mutations_wins_;
+  }
+  uint32_t maxDirectResponseBodySizeBytes() const override {
+    return max_direct_response_body_size_bytes_;
+  }
+
+private:
+  std::list<Http::LowerCaseString> internal_only_headers_;
+  HeaderParserPtr request_headers_parser_;
+  HeaderParserPtr response_headers_parser_;
+  const std::string name_;
+  const bool uses_vhds_;
+  const bool most_specific_header_mutations_wins_;
+  const uint32_t max_direct_response_body_size_bytes_;
+  const uint64_t hash_;
+};
+
+using CommonConfigSharedPtr = std::shared_ptr<const CommonConfigImpl>;
+
 /**
  * Holds all routing configuration for an entire virtual host.
  */
@@ -164,7 +217,7 @@ class VirtualHostImpl : public VirtualHost {
 public:
   VirtualHostImpl(
       const envoy::config::route::v3::VirtualHost& virtual_host,
-      const ConfigImpl& global_route_config,
+      const CommonConfigSharedPtr& global_route_config,
       Server::Configuration::ServerFactoryContext& factory_context, Stats::Scope& scope,
       ProtobufMessage::ValidationVisitor& validator,
       const absl::optional<Upstream::ClusterManager::ClusterInfoMaps>& validation_clusters);
@@ -174,15 +227,20 @@ public:
                                           const StreamInfo::StreamInfo& stream_info,
                                           uint64_t random_value) const;
   const VirtualCluster* virtualClusterFromEntries(const Http::HeaderMap& headers) const;
-  const ConfigImpl& globalRouteConfig() const { return global_route_config_; }
+  const CommonConfigImpl& globalRouteConfig() const { return *global_route_config_; }
   const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; }
   const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; }
 
+  /**
+   * Throws an EnvoyException if a route of the virtual host refers to an unknown cluster.
+   */
+  void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
+
   // Router::VirtualHost
   const CorsPolicy* corsPolicy() const override { return cors_policy_.get(); }
   Stats::StatName statName() const override { return stat_name_storage_.statName(); }
   const RateLimitPolicy& rateLimitPolicy() const override { return rate_limit_policy_; }
-  const Config& routeConfig() const override;
+  const CommonConfig& routeConfig() const override;
   const RouteSpecificFilterConfig* perFilterConfig(const std::string&) const override;
   bool includeAttemptCountInRequest() const override { return include_attempt_count_in_request_; }
   bool includeAttemptCountInResponse() const override { return include_attempt_count_in_response_; }
@@ -232,17 +290,63 @@ private:
                              stat_names) {}
   };
 
+  /**
+   * Index over the case sensitive prefix and exact path routes of a virtual host. It is used to
+   * skip routes whose path specifier can not match a request, rather than calling matches() on
+   * every route. The safe regexes of the regex routes are matched at once through a regex set.
+   * Routes which can not be indexed (CONNECT, case insensitive and std::regex routes) are always
+   * candidates. Candidates are still fully evaluated in route table order, so first-match
+   * semantics are unchanged.
+   */
+  class RouteIndex {
+  public:
+    using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+    RouteIndex(const std::vector<RouteEntryImplBaseConstSharedPtr>& routes);
+
+    /**
+     * @return bool whether indexing the routes would allow any of them to be skipped.
+     */
+    bool worthwhile(size_t num_routes) const { return unindexed_routes_.size() < num_routes; }
+
+    /**
+     * Find the routes that may match a path.
+     * @param path supplies the request path with the query string and fragment removed.
+     * @param candidates supplies the vector to fill with the positions of the routes that may
+     *        match, in route table order.
+     */
+    void findCandidates(absl::string_view path, Candidates& candidates) const;
+
+  private:
+    std::vector<uint32_t> unindexed_routes_;
+    // The regex routes whose safe regexes are in regex_routes_matcher_, in the order of the set.
+    std::vector<uint32_t> regex_routes_;
+    Regex::CompiledSetMatcherPtr regex_routes_matcher_;
+    absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_path_routes_;
+    absl::flat_hash_map<std::string, std::vector<uint32_t>> prefix_routes_;
+    // Distinct lengths of the keys of prefix_routes_, in ascending order.
+    std::vector<size_t> prefix_lengths_;
+  };
+
+  // Virtual hosts with fewer routes than this are always scanned linearly, since the index
+  // lookup costs more than calling matches() on a handful of routes.
+  static constexpr size_t MinRoutesForIndex = 8;
+  // The regex routes of a virtual host are only matched through a regex set if there are at least
+  // this many of them.
+  static constexpr size_t MinRegexRoutesForSet = 2;
+
   static const std::shared_ptr<const SslRedirectRoute> SSL_REDIRECT_ROUTE;
 
   const Stats::StatNameManagedStorage stat_name_storage_;
   Stats::ScopePtr vcluster_scope_;
   std::vector<RouteEntryImplBaseConstSharedPtr> routes_;
+  std::unique_ptr<const RouteIndex> route_index_;
   std::vector<VirtualClusterEntry> virtual_clusters_;
   SslRequirements ssl_requirements_;
   const RateLimitPolicyImpl rate_limit_policy_;
   std::unique_ptr<const CorsPolicyImpl> cors_policy_;
-  const ConfigImpl& global_route_config_; // See note in RouteEntryImplBase::clusterEntry() on why
-                                          // raw ref to the top level config is currently safe.
+  // Shared rather than referenced, as the virtual host may outlive the ConfigImpl it was built for.
+  const CommonConfigSharedPtr global_route_config_;
   HeaderParserPtr request_headers_parser_;
   HeaderParserPtr response_headers_parser_;
   PerFilterConfigs per_filter_configs_;
@@ -351,11 +455,13 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  LatencyHedging* latencyHedging() const override { return latency_hedging_.get(); }
 
 private:
   const uint32_t initial_requests_;
   const envoy::type::v3::FractionalPercent additional_request_chance_;
   const bool hedge_on_per_try_timeout_;
+  const std::unique_ptr<LatencyHedgingImpl> latency_hedging_;
 };
 
 /**
@@ -463,6 +569,7 @@ public:
                      ProtobufMessage::ValidationVisitor& validator);
 
   bool isDirectResponse() const { return direct_response_code_.has_value(); }
+  bool caseSensitive() const { return case_sensitive_; }
 
   bool isRedirect() const {
     if (!isDirectResponse()) {
@@ -936,6 +1043,11 @@ public:
   const std::string& matcher() const override { return regex_str_; }
   PathMatchType matchType() const override { return PathMatchType::Regex; }
 
+  /**
+   * @return whether the regex of the route is a safe (RE2) regex.
+   */
+  bool safeRegex() const { return safe_regex_; }
+
   // Router::Matchable
   RouteConstSharedPtr matches(const Http::RequestHeaderMap& headers,
                               const StreamInfo::StreamInfo& stream_info,
@@ -952,6 +1064,7 @@ public:
 private:
   Regex::CompiledMatcherPtr regex_;
   std::string regex_str_;
+  bool safe_regex_{};
 };
 
 /**
@@ -987,16 +1100,27 @@ public:
  */
 class RouteMatcher {
 public:
+  /**
+   * @param previous_matcher supplies the matcher of the previous configuration of the route, whose
+   *        virtual hosts are reused when they didn't change, or nullptr. They are never reused when
+   *        the clusters are validated, as the clusters may have changed since.
+   */
   RouteMatcher(const envoy::config::route::v3::RouteConfiguration& config,
-               const ConfigImpl& global_http_config,
+               const CommonConfigSharedPtr& global_route_config,
                Server::Configuration::ServerFactoryContext& factory_context,
-               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters);
+               ProtobufMessage::ValidationVisitor& validator, bool validate_clusters,
+               const RouteMatcher* previous_matcher);
 
   RouteConstSharedPtr route(const RouteCallback& cb, const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info, uint64_t random_value) const;
 
   const VirtualHostImpl* findVirtualHost(const Http::RequestHeaderMap& headers) const;
 
+  /**
+   * Throws an EnvoyException if a route refers to an unknown cluster.
+   */
+  void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const;
+
 private:
   using WildcardVirtualHosts =
       std::map<int64_t, absl::node_hash_map<std::string, VirtualHostSharedPtr>, std::greater<>>;
@@ -1020,6 +1144,9 @@ private:
   WildcardVirtualHosts wildcard_virtual_host_prefixes_;
 
   VirtualHostSharedPtr default_virtual_host_;
+  // The virtual hosts by the hash of their config, which the next matcher of the route may reuse.
+  // Empty when the clusters are validated.
+  absl::flat_hash_map<uint64_t, VirtualHostSharedPtr> virtual_hosts_by_hash_;
 };
 
 /**
@@ -1027,17 +1154,36 @@ private:
  */
 class ConfigImpl : public Config {
 public:
+  /**
+   * @param previous_config supplies the previous configuration of the route, or nullptr. When the
+   *        fields other than the virtual hosts didn't change, the virtual hosts that didn't change
+   *        either are shared with it rather than built again, so that an update costs in
+   *        proportion to what it changes. @see RouteMatcher.
+   */
   ConfigImpl(const envoy::config::route::v3::RouteConfiguration& config,
              Server::Configuration::ServerFactoryContext& factory_context,
-             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default);
+             ProtobufMessage::ValidationVisitor& validator, bool validate_clusters_default,
+             const ConfigImpl* previous_config = nullptr);
 
-  const HeaderParser& requestHeaderParser() const { return *request_headers_parser_; };
-  const HeaderParser& responseHeaderParser() const { return *response_headers_parser_; };
+  const HeaderParser& requestHeaderParser() const {
+    return shared_config_->requestHeaderParser();
+  };
+  const HeaderParser& responseHeaderParser() const {
+    return shared_config_->responseHeaderParser();
+  };
 
   bool virtualHostExists(const Http::RequestHeaderMap& headers) const {
     return route_matcher_->findVirtualHost(headers) != nullptr;
   }
 
+  /**
+   * Throws an EnvoyException if a route refers to an unknown cluster. This lets a config built
+   * while other clusters existed be checked again before it is shared.
+   */
+  void validateClusters(const Upstream::ClusterManager::ClusterInfoMaps& cluster_info_maps) const {
+    route_matcher_->validateClusters(cluster_info_maps);
+  }
+
   // Router::Config
   RouteConstSharedPtr route(const Http::RequestHeaderMap& headers,
                             const StreamInfo::StreamInfo& stream_info,
@@ -1050,31 +1196,26 @@ public:
                             uint64_t random_value) const override;
 
   const std::list<Http::LowerCaseString>& internalOnlyHeaders() const override {
-    return internal_only_headers_;
+    return shared_config_->internalOnlyHeaders();
   }
 
-  const std::string& name() const override { return name_; }
+  const std::string& name() const override { return shared_config_->name(); }
 
-  bool usesVhds() const override { return uses_vhds_; }
+  bool usesVhds() const override { return shared_config_->usesVhds(); }
 
   bool mostSpecificHeaderMutationsWins() const override {
-    return most_specific_header_mutations_wins_;
+    return shared_config_->mostSpecificHeaderMutationsWins();
   }
 
   uint32_t maxDirectResponseBodySizeBytes() const override {
-    return max_direct_response_body_size_bytes_;
+    return shared_config_->maxDirectResponseBodySizeBytes();
   }
 
 private:
+  CommonConfigSharedPtr shared_config_;
   std::unique_ptr<RouteMatcher> route_matcher_;
-  std::list<Http::LowerCaseString> internal_only_headers_;
-  HeaderParserPtr request_headers_parser_;
-  HeaderParserPtr response_headers_parser_;
-  const std::string name_;
-  Stats::SymbolTable& symbol_table_;
-  const bool uses_vhds_;
-  const bool most_specific_header_mutations_wins_;
-  const uint32_t max_direct_response_body_size_bytes_;
+  // The cache of the route decisions, if it is enabled. It's dropped with the config on updates.
+  const RouteCachePtr route_cache_;
 };
 
 /**
@@ -0,0 +1,104 @@
+#include "common/router/latency_hedging_impl.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Router {
+
+LatencyHedgingImpl::LatencyHedgingImpl(
+    const envoy::config::route::v3::HedgePolicy::LatencyPercentileHedging& config)
+    : percentile_(config.percentile().value()),
+      budget_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(config, budget, 10.0)),
+      min_samples_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, min_samples, 100)),
+      window_(std::max(DefaultWindow, 2 * min_samples_)) {}
+
+uint32_t LatencyHedgingImpl::bucketIndex(uint64_t latency_ms) {
+  latency_ms = std::min<uint64_t>(latency_ms, (1ULL << MaxLatencyBits) - 1);
+  if (latency_ms < SubBuckets) {
+    return latency_ms;
+  }
+  // The power of two of the latency is at least 3, and its 3 next bits select the sub-bucket.
+  const uint32_t exponent = 63 - __builtin_clzll(latency_ms);
+  const uint32_t sub_bucket = (latency_ms >> (exponent - 3)) & (SubBuckets - 1);
+  return SubBuckets * (exponent - 2) + sub_bucket;
+}
+
+uint64_t LatencyHedgingImpl::bucketUpperBound(uint32_t index) {
+  if (index < SubBuckets) {
+    return index;
+  }
+  const uint32_t exponent = index / SubBuckets + 2;
+  const uint64_t lower_bound = static_cast<uint64_t>(SubBuckets + index % SubBuckets)
+                               << (exponent - 3);
+  return lower_bound + (1ULL << (exponent - 3)) - 1;
+}
+
+absl::optional<std::chrono::milliseconds> LatencyHedgingImpl::hedgeDelay() {
+  if (requests_.fetch_add(1, std::memory_order_relaxed) + 1 == window_) {
+    // The requests counted by the other workers meanwhile may be lost, which only makes the budget
+    // a bit less precise.
+    requests_.store(requests_.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+    hedges_.store(hedges_.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+  }
+  const int64_t delay_ms = delay_ms_.load(std::memory_order_relaxed);
+  if (delay_ms < 0) {
+    return absl::nullopt;
+  }
+  return std::chrono::milliseconds(delay_ms);
+}
+
+bool LatencyHedgingImpl::tryHedge() {
+  const uint32_t hedges = hedges_.load(std::memory_order_relaxed);
+  if (hedges * 100.0 >= budget_ * requests_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  hedges_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void LatencyHedgingImpl::recordLatency(std::chrono::milliseconds latency) {
+  buckets_[bucketIndex(std::max<int64_t>(latency.count(), 0))].fetch_add(
+      1, std::memory_order_relaxed);
+  const uint32_t samples = samples_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (samples == window_) {
+    decayLatencies();
+  }
+  if (samples % RefreshInterval == 0 || samples == min_samples_) {
+    refreshDelay();
+  }
+}
+
+void LatencyHedgingImpl::refreshDelay() {
+  uint64_t total = 0;
+  for (const auto& bucket : buckets_) {
+    total += bucket.load(std::memory_order_relaxed);
+  }
+  if (total < min_samples_) {
+    return;
+  }
+  const uint64_t rank = std::max<uint64_t>(1, std::ceil(total * percentile_ / 100.0));
+  uint64_t count = 0;
+  for (uint32_t i = 0; i < NumBuckets; ++i) {
+    count += buckets_[i].load(std::memory_order_relaxed);
+    if (count >= rank) {
+      delay_ms_.store(bucketUpperBound(i), std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+void LatencyHedgingImpl::decayLatencies() {
+  uint32_t samples = 0;
+  for (auto& bucket : buckets_) {
+    const uint32_t count = bucket.load(std::memory_order_relaxed);
+    bucket.fetch_sub(count / 2, std::memory_order_relaxed);
+    samples += count - count / 2;
+  }
+  samples_.store(samples, std::memory_order_relaxed);
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+#include "envoy/router/router.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Tracks the recent latencies of a route in a log-linear histogram of relaxed atomic counters,
+ * which the workers update concurrently. The latencies under 8ms have their own bucket, and the larger
+ * ones are split in 8 buckets per power of two. The counts of the histogram and of the budget are
+ * halved each time they reach their window, so that the older latencies weigh less and less.
+ */
+class LatencyHedgingImpl : public LatencyHedging {
+public:
+  static constexpr uint32_t SubBuckets = 8;
+  // The latencies are capped at 2^24ms, a bit more than 4 hours.
+  static constexpr uint32_t MaxLatencyBits = 24;
+  static constexpr uint32_t NumBuckets = SubBuckets * (MaxLatencyBits - 2);
+  // The number of latencies after which the percentile is computed again.
+  static constexpr uint32_t RefreshInterval = 32;
+  static constexpr uint32_t DefaultWindow = 1024;
+
+  explicit LatencyHedgingImpl(
+      const envoy::config::route::v3::HedgePolicy::LatencyPercentileHedging& config);
+
+  // Router::LatencyHedging
+  absl::optional<std::chrono::milliseconds> hedgeDelay() override;
+  bool tryHedge() override;
+  void recordLatency(std::chrono::milliseconds latency) override;
+
+  static uint32_t bucketIndex(uint64_t latency_ms);
+  // The largest latency of the bucket, so that the requests are hedged late rather than early.
+  static uint64_t bucketUpperBound(uint32_t index);
+
+private:
+  void refreshDelay();
+  void decayLatencies();
+
+  const double percentile_;
+  const double budget_;
+  const uint32_t min_samples_;
+  const uint32_t window_;
+  std::array<std::atomic<uint32_t>, NumBuckets> buckets_{};
+  std::atomic<uint32_t> samples_{};
+  // The latency of the percentile in ms, or -1 until it's computed.
+  std::atomic<int64_t> delay_ms_{-1};
+  std::atomic<uint32_t> requests_{};
+  std::atomic<uint32_t> hedges_{};
+};
+
+} // namespace Router
+} // namespace Envoy
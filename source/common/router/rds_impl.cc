@@ -50,7 +50,8 @@ StaticRouteConfigProviderImpl::StaticRouteConfigProviderImpl(
     Server::Configuration::ServerFactoryContext& factory_context,
     ProtobufMessage::ValidationVisitor& validator,
     RouteConfigProviderManagerImpl& route_config_provider_manager)
-    : config_(new ConfigImpl(config, factory_context, validator, true)),
+    : config_(route_config_provider_manager.internStaticRouteConfig(config, factory_context,
+                                                                    validator)),
       route_config_proto_{config}, last_updated_(factory_context.timeSource().systemTime()),
       route_config_provider_manager_(route_config_provider_manager) {
   route_config_provider_manager_.static_route_config_providers_.insert(this);
@@ -115,12 +116,14 @@ void RdsRouteConfigSubscription::onConfigUpdate(
     throw EnvoyException(fmt::format("Unexpected RDS configuration (expecting {}): {}",
                                      route_config_name_, route_config.name()));
   }
-  if (route_config_provider_opt_.has_value()) {
+  // An unchanged configuration was already validated.
+  const uint64_t config_hash = resources[0].get().hash();
+  if (route_config_provider_opt_.has_value() && config_hash != config_update_info_->configHash()) {
     route_config_provider_opt_.value()->validateConfig(route_config);
   }
   std::unique_ptr<Init::ManagerImpl> noop_init_manager;
   std::unique_ptr<Cleanup> resume_rds;
-  if (config_update_info_->onRdsUpdate(route_config, version_info)) {
+  if (config_update_info_->onRdsUpdate(route_config, version_info, config_hash)) {
     stats_.config_reload_.inc();
     if (config_update_info_->protobufConfiguration().has_vhds() &&
         config_update_info_->vhdsConfigurationChanged()) {
@@ -363,6 +366,41 @@ RouteConfigProviderPtr RouteConfigProviderManagerImpl::createStaticRouteConfigPr
   return provider;
 }
 
+ConfigConstSharedPtr RouteConfigProviderManagerImpl::internStaticRouteConfig(
+    const envoy::config::route::v3::RouteConfiguration& route_config,
+    Server::Configuration::ServerFactoryContext& factory_context,
+    ProtobufMessage::ValidationVisitor& validator) {
+  // Identical configs are only shared when they are checked by the same validation visitor, as
+  // the typed per filter configs are checked at construction.
+  const StaticRouteConfigKey key{MessageUtil::hash(route_config), &validator};
+  auto it = static_route_configs_.find(key);
+  if (it != static_route_configs_.end()) {
+    std::shared_ptr<const ConfigImpl> existing_config = it->second.lock();
+    if (existing_config != nullptr) {
+      // The clusters may have changed since the config was built.
+      if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(route_config, validate_clusters, true)) {
+        existing_config->validateClusters(factory_context.clusterManager().clusters());
+      }
+      return existing_config;
+    }
+  }
+
+  // Like the HTTP tracers, the expired weak references are only reclaimed when a new config is
+  // about to be built, as they are small and the listeners are built far more often with a config
+  // that is in use already.
+  removeExpiredStaticRouteConfigs();
+
+  auto new_config = std::make_shared<const ConfigImpl>(route_config, factory_context, validator,
+                                                       true);
+  static_route_configs_[key] = new_config;
+  return new_config;
+}
+
+void RouteConfigProviderManagerImpl::removeExpiredStaticRouteConfigs() {
+  absl::erase_if(static_route_configs_,
+                 [](const auto& entry) { return entry.second.expired(); });
+}
+
 std::unique_ptr<envoy::admin::v3::RoutesConfigDump>
 RouteConfigProviderManagerImpl::dumpRouteConfigs() const {
   auto config_dump = std::make_unique<envoy::admin::v3::RoutesConfigDump>();
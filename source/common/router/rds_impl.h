@@ -34,6 +34,7 @@
 #include "common/router/route_config_update_receiver_impl.h"
 #include "common/router/vhds.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/container/node_hash_set.h"
 
@@ -250,12 +251,28 @@ public:
                                   ProtobufMessage::ValidationVisitor& validator) override;
 
 private:
+  // Static route configs are shared by the hash of their proto and the validation visitor that
+  // checked them.
+  using StaticRouteConfigKey = std::pair<uint64_t, const ProtobufMessage::ValidationVisitor*>;
+
+  /**
+   * @return the config of an identical static route configuration that is still in use, or a new
+   *         one. Listeners that inline the same route configuration then share its virtual hosts,
+   *         along with their routes and the regexes and header parsers these hold.
+   */
+  ConfigConstSharedPtr
+  internStaticRouteConfig(const envoy::config::route::v3::RouteConfiguration& route_config,
+                          Server::Configuration::ServerFactoryContext& factory_context,
+                          ProtobufMessage::ValidationVisitor& validator);
+  void removeExpiredStaticRouteConfigs();
+
   // TODO(jsedgwick) These two members are prime candidates for the owned-entry list/map
   // as in ConfigTracker. I.e. the ProviderImpls would have an EntryOwner for these lists
   // Then the lifetime management stuff is centralized and opaque.
   absl::node_hash_map<uint64_t, std::weak_ptr<RdsRouteConfigProviderImpl>>
       dynamic_route_config_providers_;
   absl::node_hash_set<RouteConfigProvider*> static_route_config_providers_;
+  absl::flat_hash_map<StaticRouteConfigKey, std::weak_ptr<const ConfigImpl>> static_route_configs_;
   Server::ConfigTracker::EntryOwnerPtr config_tracker_entry_;
 
   friend class RdsRouteConfigSubscription;
@@ -0,0 +1,66 @@
+#include "common/router/retry_buffer.h"
+
+#include "common/buffer/buffer_impl.h"
+
+namespace Envoy {
+namespace Router {
+
+namespace {
+
+// The slices of a chunk smaller than this are copied, since a reference costs more than copying
+// them.
+constexpr uint64_t CopyThreshold = 512;
+
+// A reference to a slice of a chunk, which keeps the chunk until the buffer is done with it.
+class ChunkFragment : public Buffer::BufferFragment {
+public:
+  ChunkFragment(std::shared_ptr<const Buffer::Instance> chunk, const Buffer::RawSlice& slice)
+      : chunk_(std::move(chunk)), slice_(slice) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return slice_.mem_; }
+  size_t size() const override { return slice_.len_; }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const Buffer::Instance> chunk_;
+  const Buffer::RawSlice slice_;
+};
+
+} // namespace
+
+void RetryBuffer::add(Buffer::Instance& data, Buffer::Instance& copy) {
+  if (data.length() == 0) {
+    return;
+  }
+  auto chunk = std::make_shared<Buffer::OwnedImpl>();
+  chunk->move(data);
+  length_ += chunk->length();
+  chunks_.push_back(chunk);
+  addReference(chunks_.back(), data);
+  addReference(chunks_.back(), copy);
+}
+
+void RetryBuffer::snapshot(Buffer::Instance& output) const {
+  for (const ChunkConstSharedPtr& chunk : chunks_) {
+    addReference(chunk, output);
+  }
+}
+
+void RetryBuffer::clear() {
+  chunks_.clear();
+  length_ = 0;
+}
+
+void RetryBuffer::addReference(const ChunkConstSharedPtr& chunk, Buffer::Instance& output) {
+  for (const Buffer::RawSlice& slice : chunk->getRawSlices()) {
+    if (slice.len_ < CopyThreshold) {
+      output.add(slice.mem_, slice.len_);
+    } else {
+      output.addBufferFragment(*new ChunkFragment(chunk, slice));
+    }
+  }
+}
+
+} // namespace Router
+} // namespace Envoy
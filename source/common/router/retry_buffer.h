@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * The request body that the router keeps for retries, as a list of immutable chunks which the
+ * upstream attempts and the buffered request reference instead of each holding a copy of the
+ * body. A chunk lives as long as a buffer references it, so an attempt may outlive the body.
+ */
+class RetryBuffer {
+public:
+  /**
+   * Moves the data into a new chunk of the body.
+   * @param data supplies the data, which is left with a reference to the new chunk.
+   * @param copy supplies the buffer another reference to the new chunk is added to.
+   */
+  void add(Buffer::Instance& data, Buffer::Instance& copy);
+
+  /**
+   * Adds a reference to the whole body to the output, e.g. for a retry.
+   */
+  void snapshot(Buffer::Instance& output) const;
+
+  /**
+   * Forgets the body, which the existing references keep until they're drained.
+   */
+  void clear();
+
+  uint64_t length() const { return length_; }
+
+private:
+  using ChunkConstSharedPtr = std::shared_ptr<const Buffer::Instance>;
+
+  static void addReference(const ChunkConstSharedPtr& chunk, Buffer::Instance& output);
+
+  std::vector<ChunkConstSharedPtr> chunks_;
+  uint64_t length_{};
+};
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,109 @@
+#include "common/router/route_cache_impl.h"
+
+#include <atomic>
+
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/container/flat_hash_set.h"
+
+namespace Envoy {
+namespace Router {
+
+RouteCachePtr RouteCache::create(const envoy::config::route::v3::RouteConfiguration& config) {
+  const uint32_t max_entries = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, route_cache_size, 0);
+  if (max_entries == 0) {
+    return nullptr;
+  }
+
+  // The headers of the virtual host selection, of the SSL redirects and of the gRPC and CONNECT
+  // matches.
+  std::vector<Http::LowerCaseString> headers{Http::Headers::get().Host,
+                                             Http::Headers::get().Path,
+                                             Http::Headers::get().Method,
+                                             Http::Headers::get().ForwardedProto,
+                                             Http::Headers::get().EnvoyInternalRequest,
+                                             Http::Headers::get().ContentType};
+  absl::flat_hash_set<std::string> names;
+  for (const auto& header : headers) {
+    names.insert(header.get());
+  }
+  const auto add_header = [&headers, &names](const std::string& name) {
+    const Http::LowerCaseString header(name);
+    if (names.insert(header.get()).second) {
+      headers.push_back(header);
+    }
+  };
+
+  for (const auto& virtual_host : config.virtual_hosts()) {
+    for (const auto& route : virtual_host.routes()) {
+      // These decisions also depend on the runtime, the connection or a random value.
+      if (route.match().has_runtime_fraction() || route.match().has_tls_context() ||
+          route.route().has_weighted_clusters()) {
+        return nullptr;
+      }
+      for (const auto& header_matcher : route.match().headers()) {
+        add_header(header_matcher.name());
+      }
+      if (!route.route().cluster_header().empty()) {
+        add_header(route.route().cluster_header());
+      }
+    }
+  }
+  return std::make_unique<RouteCache>(max_entries, std::move(headers));
+}
+
+RouteCache::RouteCache(uint32_t max_entries, std::vector<Http::LowerCaseString>&& headers)
+    : max_entries_(max_entries), headers_(std::move(headers)),
+      shards_(std::make_unique<Shard[]>(NumShards)) {}
+
+std::string RouteCache::key(const Http::RequestHeaderMap& headers) const {
+  // The header values can't contain NUL characters, so they end with one, and the values of each
+  // header with a 1, which tells the missing headers from the empty ones.
+  std::string key;
+  for (const auto& header : headers_) {
+    const auto values = headers.get(header);
+    for (size_t i = 0; i < values.size(); ++i) {
+      const absl::string_view value = values[i]->value().getStringView();
+      key.append(value.data(), value.size());
+      key.push_back('\0');
+    }
+    key.push_back('\1');
+  }
+  return key;
+}
+
+absl::optional<RouteConstSharedPtr> RouteCache::lookup(const std::string& key) {
+  Shard& shard = localShard();
+  absl::MutexLock lock(&shard.mutex_);
+  const auto it = shard.entries_.find(key);
+  if (it == shard.entries_.end()) {
+    return absl::nullopt;
+  }
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, it->second);
+  return it->second->second;
+}
+
+void RouteCache::insert(std::string&& key, const RouteConstSharedPtr& route) {
+  Shard& shard = localShard();
+  absl::MutexLock lock(&shard.mutex_);
+  if (shard.entries_.contains(key)) {
+    return;
+  }
+  if (shard.lru_.size() >= max_entries_) {
+    shard.entries_.erase(shard.lru_.back().first);
+    shard.lru_.pop_back();
+  }
+  shard.lru_.emplace_front(std::move(key), route);
+  shard.entries_.emplace(shard.lru_.front().first, shard.lru_.begin());
+}
+
+RouteCache::Shard& RouteCache::localShard() {
+  static std::atomic<uint32_t> next_shard{0};
+  thread_local const uint32_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % NumShards;
+  return shards_[shard];
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/config/route/v3/route.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/router/router.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Router {
+
+class RouteCache;
+using RouteCachePtr = std::unique_ptr<RouteCache>;
+
+/**
+ * A cache of the route decisions of a route table, keyed by the values of the request headers
+ * that the routes of the table depend on. Each thread caches its decisions in the LRU shard picked
+ * for it the first time it uses a cache, so that the workers don't contend on the shards as long
+ * as there are fewer workers than shards. The shards aren't thread local slots, as the route
+ * tables may be destroyed on the workers.
+ */
+class RouteCache {
+public:
+  static constexpr uint32_t NumShards = 16;
+
+  /**
+   * @return the cache of the route decisions of the table, or nullptr if the cache is disabled or
+   *         the decisions of the table don't only depend on the request headers.
+   */
+  static RouteCachePtr create(const envoy::config::route::v3::RouteConfiguration& config);
+
+  /**
+   * @return the key of the route decision for the request headers.
+   */
+  std::string key(const Http::RequestHeaderMap& headers) const;
+
+  /**
+   * @return the cached route decision for the key, which may be no route, or absl::nullopt if the
+   *         decision isn't cached by the shard of the calling thread.
+   */
+  absl::optional<RouteConstSharedPtr> lookup(const std::string& key);
+
+  /**
+   * Caches a route decision in the shard of the calling thread, which evicts its least recently
+   * used decision if it is full.
+   */
+  void insert(std::string&& key, const RouteConstSharedPtr& route);
+
+  RouteCache(uint32_t max_entries, std::vector<Http::LowerCaseString>&& headers);
+
+private:
+  // The decisions, the most recently used first, and their position by key.
+  struct Shard {
+    absl::Mutex mutex_;
+    std::list<std::pair<std::string, RouteConstSharedPtr>> lru_ ABSL_GUARDED_BY(mutex_);
+    absl::flat_hash_map<absl::string_view, decltype(lru_)::iterator>
+        entries_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& localShard();
+
+  const uint32_t max_entries_;
+  // The headers whose values select the routes, including the ones of the virtual host selection.
+  const std::vector<Http::LowerCaseString> headers_;
+  std::unique_ptr<Shard[]> shards_;
+};
+
+} // namespace Router
+} // namespace Envoy
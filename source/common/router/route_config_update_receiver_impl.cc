@@ -16,12 +16,17 @@ namespace Router {
 
 bool RouteConfigUpdateReceiverImpl::onRdsUpdate(
     const envoy::config::route::v3::RouteConfiguration& rc, const std::string& version_info) {
-  const uint64_t new_hash = MessageUtil::hash(rc);
-  if (new_hash == last_config_hash_) {
+  return onRdsUpdate(rc, version_info, MessageUtil::hash(rc));
+}
+
+bool RouteConfigUpdateReceiverImpl::onRdsUpdate(
+    const envoy::config::route::v3::RouteConfiguration& rc, const std::string& version_info,
+    uint64_t config_hash) {
+  if (config_hash == last_config_hash_) {
     return false;
   }
   route_config_proto_ = std::make_unique<envoy::config::route::v3::RouteConfiguration>(rc);
-  last_config_hash_ = new_hash;
+  last_config_hash_ = config_hash;
   const uint64_t new_vhds_config_hash = rc.has_vhds() ? MessageUtil::hash(rc.vhds()) : 0ul;
   vhds_configuration_changed_ = new_vhds_config_hash != last_vhds_config_hash_;
   last_vhds_config_hash_ = new_vhds_config_hash;
@@ -30,7 +35,8 @@ bool RouteConfigUpdateReceiverImpl::onRdsUpdate(
   rebuildRouteConfig(rds_virtual_hosts_, *vhds_virtual_hosts_, *route_config_proto_);
   config_ = std::make_shared<ConfigImpl>(
       *route_config_proto_, factory_context_,
-      factory_context_.messageValidationContext().dynamicValidationVisitor(), false);
+      factory_context_.messageValidationContext().dynamicValidationVisitor(), false,
+      config_.get());
 
   onUpdateCommon(version_info);
   return true;
@@ -53,9 +59,11 @@ bool RouteConfigUpdateReceiverImpl::onVhdsUpdate(
   rebuildRouteConfig(rds_virtual_hosts_, *vhosts_after_this_update,
                      *route_config_after_this_update);
 
+  // Only the virtual hosts this update added or changed are built.
   auto new_config = std::make_shared<ConfigImpl>(
       *route_config_after_this_update, factory_context_,
-      factory_context_.messageValidationContext().dynamicValidationVisitor(), false);
+      factory_context_.messageValidationContext().dynamicValidationVisitor(), false,
+      config_.get());
 
   // No exception, route_config_after_this_update is valid, can update the state.
   vhds_virtual_hosts_ = std::move(vhosts_after_this_update);
@@ -41,6 +41,8 @@ public:
   // Router::RouteConfigUpdateReceiver
   bool onRdsUpdate(const envoy::config::route::v3::RouteConfiguration& rc,
                    const std::string& version_info) override;
+  bool onRdsUpdate(const envoy::config::route::v3::RouteConfiguration& rc,
+                   const std::string& version_info, uint64_t config_hash) override;
   bool onVhdsUpdate(const VirtualHostRefVector& added_vhosts,
                     const std::set<std::string>& added_resource_ids,
                     const Protobuf::RepeatedPtrField<std::string>& removed_resources,
@@ -74,7 +76,8 @@ private:
   absl::optional<RouteConfigProvider::ConfigInfo> config_info_;
   std::set<std::string> resource_ids_in_last_update_;
   bool vhds_configuration_changed_;
-  ConfigConstSharedPtr config_;
+  // Kept as a ConfigImpl so that the next config can reuse the virtual hosts that didn't change.
+  std::shared_ptr<const ConfigImpl> config_;
 };
 
 } // namespace Router
@@ -335,6 +335,8 @@ void Filter::chargeUpstreamCode(uint64_t response_status_code,
     }
     if (upstream_host && Http::CodeUtility::is5xx(response_status_code)) {
       upstream_host->stats().rq_error_.inc();
+      // The request may have failed before it was issued to the host.
+      upstream_host->cluster().loadReportHosts().add(upstream_host);
     }
   }
 }
@@ -637,6 +639,10 @@ Http::FilterHeadersStatus Filter::decodeHeaders(Http::RequestHeaderMap& headers,
       std::make_unique<UpstreamRequest>(*this, std::move(generic_conn_pool));
   LinkedList::moveIntoList(std::move(upstream_request), upstream_requests_);
   upstream_requests_.front()->encodeHeaders(end_stream);
+  if (!active_shadow_policies_.empty() && !upstream_requests_.empty() &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.streaming_shadow")) {
+    startStreamingShadows(end_stream);
+  }
   if (end_stream) {
     onRequestComplete();
   }
@@ -690,6 +696,11 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   // a backoff timer.
   ASSERT(upstream_requests_.size() <= 1);
 
+  // The shadows are sent the data before it's moved upstream.
+  for (auto& shadow_stream : shadow_streams_) {
+    shadow_stream->sendData(data, end_stream);
+  }
+
   bool buffering = (retry_state_ && retry_state_->enabled()) || !active_shadow_policies_.empty() ||
                    (internal_redirects_with_body_enabled_ && route_entry_ &&
                     route_entry_->internalRedirectPolicy().enabled());
@@ -698,6 +709,7 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
     // The request is larger than we should buffer. Give up on the retry/shadow
     cluster_->stats().retry_or_shadow_abandoned_.inc();
     retry_state_.reset();
+    retry_buffer_.clear();
     buffering = false;
     active_shadow_policies_.clear();
     request_buffer_overflowed_ = true;
@@ -720,10 +732,11 @@ Http::FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_strea
   ASSERT(buffering || !upstream_requests_.empty());
 
   if (buffering) {
-    // If we are going to buffer for retries or shadowing, we need to make a copy before encoding
-    // since it's all moves from here on.
+    // If we are going to buffer for retries or shadowing, the upstream request and the buffered
+    // request share the data since it's all moves from here on, instead of each having a copy.
+    Buffer::OwnedImpl copy;
+    retry_buffer_.add(data, copy);
     if (!upstream_requests_.empty()) {
-      Buffer::OwnedImpl copy(data);
       upstream_requests_.front()->encodeData(copy, end_stream);
     }
 
@@ -754,6 +767,9 @@ Http::FilterTrailersStatus Filter::decodeTrailers(Http::RequestTrailerMap& trail
   // a backoff timer.
   ASSERT(upstream_requests_.size() <= 1);
   downstream_trailers_ = &trailers;
+  for (auto& shadow_stream : shadow_streams_) {
+    shadow_stream->sendTrailers(trailers);
+  }
   for (auto& upstream_request : upstream_requests_) {
     upstream_request->encodeTrailers(trailers);
   }
@@ -809,19 +825,42 @@ void Filter::maybeDoShadowing() {
       request->trailers(Http::createHeaderMap<Http::RequestTrailerMapImpl>(*downstream_trailers_));
     }
 
-    auto options = Http::AsyncClient::RequestOptions()
-                       .setTimeout(timeout_.global_timeout_)
-                       .setParentSpan(callbacks_->activeSpan())
-                       .setChildSpanName("mirror")
-                       .setSampled(shadow_policy.traceSampled());
-    config_.shadowWriter().shadow(shadow_policy.cluster(), std::move(request), options);
+    config_.shadowWriter().shadow(shadow_policy.cluster(), std::move(request),
+                                  shadowOptions(shadow_policy));
+  }
+}
+
+Http::AsyncClient::RequestOptions Filter::shadowOptions(const ShadowPolicy& shadow_policy) {
+  return Http::AsyncClient::RequestOptions()
+      .setTimeout(timeout_.global_timeout_)
+      .setParentSpan(callbacks_->activeSpan())
+      .setChildSpanName("mirror")
+      .setSampled(shadow_policy.traceSampled());
+}
+
+void Filter::startStreamingShadows(bool end_stream) {
+  for (const auto& shadow_policy_wrapper : active_shadow_policies_) {
+    const auto& shadow_policy = shadow_policy_wrapper.get();
+
+    ASSERT(!shadow_policy.cluster().empty());
+    ShadowStreamPtr shadow_stream = config_.shadowWriter().streamingShadow(
+        shadow_policy.cluster(),
+        Http::createHeaderMap<Http::RequestHeaderMapImpl>(*downstream_headers_),
+        shadowOptions(shadow_policy), end_stream);
+    if (shadow_stream != nullptr) {
+      shadow_streams_.push_back(std::move(shadow_stream));
+    }
   }
+  // The request doesn't need to be buffered for the streamed shadows.
+  active_shadow_policies_.clear();
 }
 
 void Filter::onRequestComplete() {
   // This should be called exactly once, when the downstream request has been received in full.
   ASSERT(!downstream_end_stream_);
   downstream_end_stream_ = true;
+  // The streamed shadows received the whole request, and go on on their own.
+  shadow_streams_.clear();
   Event::Dispatcher& dispatcher = callbacks_->dispatcher();
   downstream_request_complete_time_ = dispatcher.timeSource().monotonicTime();
 
@@ -832,7 +871,7 @@ void Filter::onRequestComplete() {
     maybeDoShadowing();
 
     if (timeout_.global_timeout_.count() > 0) {
-      response_timeout_ = dispatcher.createTimer([this]() -> void { onResponseTimeout(); });
+      response_timeout_ = dispatcher.createWheelTimer([this]() -> void { onResponseTimeout(); });
       response_timeout_->enableTimer(timeout_.global_timeout_);
     }
 
@@ -845,6 +884,8 @@ void Filter::onRequestComplete() {
 }
 
 void Filter::onDestroy() {
+  // Reset the streamed shadows of an incomplete request.
+  shadow_streams_.clear();
   // Reset any in-flight upstream requests.
   resetAll();
   cleanup();
@@ -928,6 +969,24 @@ void Filter::onSoftPerTryTimeout(UpstreamRequest& upstream_request) {
   }
 }
 
+// Called when the upstream request takes longer than the latency percentile of the route. It isn't
+// a timeout, so unlike onSoftPerTryTimeout() it isn't reported to outlier detection.
+void Filter::onLatencyHedgeTimeout(UpstreamRequest& upstream_request) {
+  if (downstream_response_started_ || !retry_state_ || upstream_request.retried() ||
+      !route_entry_->hedgePolicy().latencyHedging()->tryHedge()) {
+    return;
+  }
+
+  const RetryStatus retry_status =
+      retry_state_->shouldHedgeRetryPerTryTimeout([this]() -> void { doRetry(); });
+  if (retry_status == RetryStatus::Yes) {
+    pending_retries_++;
+    upstream_request.retried(true);
+  } else if (retry_status == RetryStatus::NoOverflow) {
+    callbacks_->streamInfo().setResponseFlag(StreamInfo::ResponseFlag::UpstreamOverflow);
+  }
+}
+
 void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
   if (hedging_params_.hedge_on_per_try_timeout_) {
     onSoftPerTryTimeout(upstream_request);
@@ -1243,6 +1302,12 @@ void Filter::onUpstreamHeaders(uint64_t response_code, Http::ResponseHeaderMapPt
                                UpstreamRequest& upstream_request, bool end_stream) {
   ENVOY_STREAM_LOG(debug, "upstream headers complete: end_stream={}", *callbacks_, end_stream);
 
+  if (LatencyHedging* latency_hedging = route_entry_->hedgePolicy().latencyHedging();
+      latency_hedging != nullptr) {
+    latency_hedging->recordLatency(std::chrono::duration_cast<std::chrono::milliseconds>(
+        timeSource().monotonicTime() - upstream_request.startTime()));
+  }
+
   modify_headers_(*headers);
   // When grpc-status appears in response headers, convert grpc-status to HTTP status code
   // for outlier detection. This does not currently change any stats or logging and does not
@@ -1647,8 +1712,9 @@ void Filter::doRetry() {
   // sure we don't encodeData on the wrong request.
   if (!upstream_requests_.empty() && (upstream_requests_.front().get() == upstream_request_tmp)) {
     if (callbacks_->decodingBuffer()) {
-      // If we are doing a retry we need to make a copy.
-      Buffer::OwnedImpl copy(*callbacks_->decodingBuffer());
+      // If we are doing a retry the attempt references the buffered body instead of copying it.
+      Buffer::OwnedImpl copy;
+      retry_buffer_.snapshot(copy);
       upstream_requests_.front()->encodeData(copy, !downstream_trailers_ && downstream_end_stream_);
     }
 
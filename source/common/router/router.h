@@ -30,6 +30,7 @@
 #include "common/http/utility.h"
 #include "common/router/config_impl.h"
 #include "common/router/context_impl.h"
+#include "common/router/retry_buffer.h"
 #include "common/router/upstream_request.h"
 #include "common/stats/symbol_table_impl.h"
 #include "common/stream_info/stream_info_impl.h"
@@ -253,6 +254,7 @@ public:
                                UpstreamRequest& upstream_request) PURE;
   virtual void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) PURE;
   virtual void onPerTryTimeout(UpstreamRequest& upstream_request) PURE;
+  virtual void onLatencyHedgeTimeout(UpstreamRequest& upstream_request) PURE;
   virtual void onStreamMaxDurationReached(UpstreamRequest& upstream_request) PURE;
 
   virtual Http::StreamDecoderFilterCallbacks* callbacks() PURE;
@@ -428,6 +430,7 @@ public:
                        UpstreamRequest& upstream_request) override;
   void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) override;
   void onPerTryTimeout(UpstreamRequest& upstream_request) override;
+  void onLatencyHedgeTimeout(UpstreamRequest& upstream_request) override;
   void onStreamMaxDurationReached(UpstreamRequest& upstream_request) override;
   Http::StreamDecoderFilterCallbacks* callbacks() override { return callbacks_; }
   Upstream::ClusterInfoConstSharedPtr cluster() override { return cluster_; }
@@ -472,6 +475,8 @@ private:
   UpstreamRequestPtr createUpstreamRequest();
 
   void maybeDoShadowing();
+  Http::AsyncClient::RequestOptions shadowOptions(const ShadowPolicy& shadow_policy);
+  void startStreamingShadows(bool end_stream);
   bool maybeRetryReset(Http::StreamResetReason reset_reason, UpstreamRequest& upstream_request);
   uint32_t numRequestsAwaitingHeaders();
   void onGlobalTimeout();
@@ -528,9 +533,13 @@ private:
   Http::RequestTrailerMap* downstream_trailers_{};
   MonotonicTime downstream_request_complete_time_;
   uint32_t retry_shadow_buffer_limit_{std::numeric_limits<uint32_t>::max()};
+  // The buffered request body, shared by the upstream attempts.
+  RetryBuffer retry_buffer_;
   MetadataMatchCriteriaConstPtr metadata_match_;
   std::function<void(Http::ResponseHeaderMap&)> modify_headers_;
   std::vector<std::reference_wrapper<const ShadowPolicy>> active_shadow_policies_{};
+  // The shadows of the request while it is decoded, if they are streamed.
+  std::vector<ShadowStreamPtr> shadow_streams_;
 
   // list of cookies to add to upstream headers
   std::vector<std::string> downstream_set_cookies_;
@@ -3,7 +3,9 @@
 #include <chrono>
 #include <string>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
+#include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 
 #include "absl/strings/str_join.h"
@@ -22,16 +24,94 @@ void ShadowWriterImpl::shadow(const std::string& cluster, Http::RequestMessagePt
     return;
   }
 
-  ASSERT(!request->headers().getHostValue().empty());
-  // Switch authority to add a shadow postfix. This allows upstream logging to make more sense.
-  auto parts = StringUtil::splitToken(request->headers().getHostValue(), ":");
-  ASSERT(!parts.empty() && parts.size() <= 2);
-  request->headers().setHost(parts.size() == 2
-                                 ? absl::StrJoin(parts, "-shadow:")
-                                 : absl::StrCat(request->headers().getHostValue(), "-shadow"));
+  setShadowHost(request->headers());
   // This is basically fire and forget. We don't handle cancelling.
   thread_local_cluster->httpAsyncClient().send(std::move(request), *this, options);
 }
 
+ShadowStreamPtr ShadowWriterImpl::streamingShadow(const std::string& cluster,
+                                                  Http::RequestHeaderMapPtr&& headers,
+                                                  const Http::AsyncClient::RequestOptions& options,
+                                                  bool end_stream) {
+  const auto thread_local_cluster = cm_.getThreadLocalCluster(cluster);
+  if (thread_local_cluster == nullptr) {
+    ENVOY_LOG(debug, "shadow cluster '{}' does not exist", cluster);
+    return nullptr;
+  }
+
+  setShadowHost(*headers);
+  auto* shadow = new StreamingShadow(std::move(headers));
+  shadow->stream_ = thread_local_cluster->httpAsyncClient().start(*shadow, options);
+  if (shadow->stream_ == nullptr) {
+    // The shadow was reset inline, which deleted it.
+    return nullptr;
+  }
+  auto handle = std::make_unique<StreamingShadowHandle>(*shadow);
+  shadow->handle_ = handle.get();
+  shadow->local_complete_ = end_stream;
+  // The shadow may be reset inline, which clears the handle.
+  shadow->stream_->sendHeaders(*shadow->headers_, end_stream);
+  return handle;
+}
+
+void ShadowWriterImpl::setShadowHost(Http::RequestHeaderMap& headers) {
+  ASSERT(!headers.getHostValue().empty());
+  auto parts = StringUtil::splitToken(headers.getHostValue(), ":");
+  ASSERT(!parts.empty() && parts.size() <= 2);
+  headers.setHost(parts.size() == 2 ? absl::StrJoin(parts, "-shadow:")
+                                    : absl::StrCat(headers.getHostValue(), "-shadow"));
+}
+
+ShadowWriterImpl::StreamingShadowHandle::~StreamingShadowHandle() {
+  if (shadow_ == nullptr) {
+    return;
+  }
+  shadow_->handle_ = nullptr;
+  if (!shadow_->local_complete_) {
+    // The request didn't end, so neither can the shadow.
+    shadow_->stream_->reset();
+  }
+}
+
+void ShadowWriterImpl::StreamingShadowHandle::sendData(const Buffer::Instance& data,
+                                                       bool end_stream) {
+  if (shadow_ != nullptr) {
+    shadow_->sendData(data, end_stream);
+  }
+}
+
+void ShadowWriterImpl::StreamingShadowHandle::sendTrailers(
+    const Http::RequestTrailerMap& trailers) {
+  if (shadow_ != nullptr) {
+    shadow_->sendTrailers(trailers);
+  }
+}
+
+void ShadowWriterImpl::StreamingShadow::sendData(const Buffer::Instance& data, bool end_stream) {
+  if (stream_->isAboveWriteBufferHighWatermark()) {
+    // The shadow can't skip a part of the body, so it is dropped rather than buffered.
+    ENVOY_LOG(debug, "shadow stream above its high watermark, resetting it");
+    stream_->reset();
+    return;
+  }
+  local_complete_ = end_stream;
+  // The request is moved upstream after the chunk is sent to the shadow.
+  Buffer::OwnedImpl copy(data);
+  stream_->sendData(copy, end_stream);
+}
+
+void ShadowWriterImpl::StreamingShadow::sendTrailers(const Http::RequestTrailerMap& trailers) {
+  local_complete_ = true;
+  trailers_ = Http::createHeaderMap<Http::RequestTrailerMapImpl>(trailers);
+  stream_->sendTrailers(*trailers_);
+}
+
+void ShadowWriterImpl::StreamingShadow::onDone() {
+  if (handle_ != nullptr) {
+    handle_->shadow_ = nullptr;
+  }
+  delete this;
+}
+
 } // namespace Router
 } // namespace Envoy
@@ -22,6 +22,9 @@ public:
   // Router::ShadowWriter
   void shadow(const std::string& cluster, Http::RequestMessagePtr&& request,
               const Http::AsyncClient::RequestOptions& options) override;
+  ShadowStreamPtr streamingShadow(const std::string& cluster, Http::RequestHeaderMapPtr&& headers,
+                                  const Http::AsyncClient::RequestOptions& options,
+                                  bool end_stream) override;
 
   // Http::AsyncClient::Callbacks
   void onSuccess(const Http::AsyncClient::Request&, Http::ResponseMessagePtr&&) override {}
@@ -30,6 +33,55 @@ public:
                                     const Http::ResponseHeaderMap*) override {}
 
 private:
+  class StreamingShadow;
+
+  /**
+   * The stream handed to the router filter for a streaming shadow. The shadow outlives it until
+   * its response, and clears it if it's reset first.
+   */
+  class StreamingShadowHandle : public ShadowStream {
+  public:
+    StreamingShadowHandle(StreamingShadow& shadow) : shadow_(&shadow) {}
+    ~StreamingShadowHandle() override;
+
+    // Router::ShadowStream
+    void sendData(const Buffer::Instance& data, bool end_stream) override;
+    void sendTrailers(const Http::RequestTrailerMap& trailers) override;
+
+    StreamingShadow* shadow_;
+  };
+
+  /**
+   * A streaming shadow, which deletes itself once its stream is complete or reset.
+   */
+  class StreamingShadow : Logger::Loggable<Logger::Id::router>,
+                          public Http::AsyncClient::StreamCallbacks {
+  public:
+    StreamingShadow(Http::RequestHeaderMapPtr&& headers) : headers_(std::move(headers)) {}
+
+    void sendData(const Buffer::Instance& data, bool end_stream);
+    void sendTrailers(const Http::RequestTrailerMap& trailers);
+
+    // Http::AsyncClient::StreamCallbacks
+    void onHeaders(Http::ResponseHeaderMapPtr&&, bool) override {}
+    void onData(Buffer::Instance&, bool) override {}
+    void onTrailers(Http::ResponseTrailerMapPtr&&) override {}
+    void onComplete() override { onDone(); }
+    void onReset() override { onDone(); }
+
+    void onDone();
+
+    // The stream needs the headers and trailers until it is complete.
+    Http::RequestHeaderMapPtr headers_;
+    Http::RequestTrailerMapPtr trailers_;
+    Http::AsyncClient::Stream* stream_{};
+    StreamingShadowHandle* handle_{};
+    bool local_complete_{};
+  };
+
+  // Adds the shadow postfix to the authority, which allows upstream logging to make more sense.
+  static void setShadowHost(Http::RequestHeaderMap& headers);
+
   Upstream::ClusterManager& cm_;
 };
 
@@ -46,6 +46,8 @@ namespace Router {
 UpstreamRequest::UpstreamRequest(RouterFilterInterface& parent,
                                  std::unique_ptr<GenericConnPool>&& conn_pool)
     : parent_(parent), conn_pool_(std::move(conn_pool)), grpc_rq_success_deferred_(false),
+      account_(std::make_shared<Buffer::AggregatingMemoryAccount>(
+          parent_.callbacks()->account(), parent_.cluster()->stats().upstream_rq_buffered_bytes_)),
       stream_info_(parent_.callbacks()->dispatcher().timeSource(), nullptr),
       start_time_(parent_.callbacks()->dispatcher().timeSource().monotonicTime()),
       calling_encode_headers_(false), upstream_canary_(false), decode_complete_(false),
@@ -77,6 +79,9 @@ UpstreamRequest::~UpstreamRequest() {
     // Allows for testing.
     per_try_timeout_->disableTimer();
   }
+  if (latency_hedge_timeout_ != nullptr) {
+    latency_hedge_timeout_->disableTimer();
+  }
   if (max_stream_duration_timer_ != nullptr) {
     max_stream_duration_timer_->disableTimer();
   }
@@ -138,6 +143,15 @@ void UpstreamRequest::decodeHeaders(Http::ResponseHeaderMapPtr&& headers, bool e
   // TODO(rodaine): This is actually measuring after the headers are parsed and not the first
   // byte.
   upstream_timing_.onFirstUpstreamRxByteReceived(parent_.callbacks()->dispatcher().timeSource());
+  if (upstream_host_ != nullptr &&
+      upstream_host_->cluster().lbType() == Upstream::LoadBalancerType::PeakEwma &&
+      upstream_timing_.first_upstream_tx_byte_sent_.has_value()) {
+    const MonotonicTime now = upstream_timing_.first_upstream_rx_byte_received_.value();
+    upstream_host_->latencyEstimate().observe(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            now - upstream_timing_.first_upstream_tx_byte_sent_.value()),
+        now);
+  }
   maybeEndDecode(end_stream);
 
   awaiting_headers_ = false;
@@ -224,6 +238,7 @@ void UpstreamRequest::encodeData(Buffer::Instance& data, bool end_stream) {
           [this]() -> void { this->disableDataFromDownstreamForFlowControl(); },
           []() -> void { /* TODO(adisuissa): Handle overflow watermark */ });
       buffered_request_body_->setWatermarks(parent_.callbacks()->decoderBufferLimit());
+      buffered_request_body_->bindAccount(account_);
     }
 
     buffered_request_body_->move(data);
@@ -315,9 +330,34 @@ void UpstreamRequest::setupPerTryTimeout() {
   ASSERT(!per_try_timeout_);
   if (parent_.timeout().per_try_timeout_.count() > 0) {
     per_try_timeout_ =
-        parent_.callbacks()->dispatcher().createTimer([this]() -> void { onPerTryTimeout(); });
+        parent_.callbacks()->dispatcher().createWheelTimer([this]() -> void { onPerTryTimeout(); });
     per_try_timeout_->enableTimer(parent_.timeout().per_try_timeout_);
   }
+
+  // Only the first attempt is hedged on latency, the retries and hedged requests aren't.
+  LatencyHedging* latency_hedging = parent_.routeEntry()->hedgePolicy().latencyHedging();
+  if (latency_hedging == nullptr || parent_.attemptCount() > 1) {
+    return;
+  }
+  const absl::optional<std::chrono::milliseconds> hedge_delay = latency_hedging->hedgeDelay();
+  if (!hedge_delay.has_value() || (parent_.timeout().per_try_timeout_.count() > 0 &&
+                                   hedge_delay.value() >= parent_.timeout().per_try_timeout_)) {
+    return;
+  }
+  // The request may have been in flight for a while already, e.g. to send its body.
+  const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      parent_.callbacks()->dispatcher().timeSource().monotonicTime() - start_time_);
+  latency_hedge_timeout_ =
+      parent_.callbacks()->dispatcher().createWheelTimer([this]() { onLatencyHedgeTimeout(); });
+  latency_hedge_timeout_->enableTimer(
+      std::max(hedge_delay.value() - elapsed, std::chrono::milliseconds(0)));
+}
+
+void UpstreamRequest::onLatencyHedgeTimeout() {
+  if (!parent_.downstreamResponseStarted() && awaiting_headers_) {
+    ENVOY_STREAM_LOG(debug, "upstream latency hedge timeout", *parent_.callbacks());
+    parent_.onLatencyHedgeTimeout(*this);
+  }
 }
 
 void UpstreamRequest::onPerTryTimeout() {
@@ -370,6 +410,7 @@ void UpstreamRequest::onPoolReady(
   ScopeTrackerScopeState scope(&parent_.callbacks()->scope(), parent_.callbacks()->dispatcher());
   ENVOY_STREAM_LOG(debug, "pool ready", *parent_.callbacks());
   upstream_ = std::move(upstream);
+  upstream_->setAccount(account_);
 
   if (parent_.requestVcluster()) {
     // The cluster increases its upstream_rq_total_ counter right before firing this onPoolReady
@@ -47,6 +47,7 @@ public:
   void resetStream();
   void setupPerTryTimeout();
   void onPerTryTimeout();
+  void onLatencyHedgeTimeout();
   void maybeEndDecode(bool end_stream);
   void onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host);
 
@@ -118,6 +119,7 @@ public:
     return create_per_try_timeout_on_request_complete_;
   }
   bool encodeComplete() const { return encode_complete_; }
+  MonotonicTime startTime() const { return start_time_; }
   RouterFilterInterface& parent() { return parent_; }
 
 private:
@@ -132,9 +134,14 @@ private:
   std::unique_ptr<GenericConnPool> conn_pool_;
   bool grpc_rq_success_deferred_;
   Event::TimerPtr per_try_timeout_;
+  // Hedges the request once it takes longer than the latency percentile of the route.
+  Event::TimerPtr latency_hedge_timeout_;
   std::unique_ptr<GenericUpstream> upstream_;
   absl::optional<Http::StreamResetReason> deferred_reset_reason_;
   Buffer::InstancePtr buffered_request_body_;
+  // Charged with the memory buffered for the request, and forwarding it to the account of the
+  // downstream stream.
+  const Buffer::BufferMemoryAccountSharedPtr account_;
   Upstream::HostDescriptionConstSharedPtr upstream_host_;
   DownstreamWatermarkManager downstream_watermark_manager_{*this};
   Tracing::SpanPtr span_;
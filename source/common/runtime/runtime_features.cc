@@ -1,6 +1,7 @@
 #include "common/runtime/runtime_features.h"
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 
 namespace Envoy {
 namespace Runtime {
@@ -21,6 +22,21 @@ bool runtimeFeatureEnabled(absl::string_view feature) {
   return RuntimeFeaturesDefaults::get().enabledByDefault(feature);
 }
 
+RuntimeFeature::RuntimeFeature(absl::string_view feature) {
+  const absl::optional<uint32_t> index = RuntimeFeaturesDefaults::get().index(feature);
+  RELEASE_ASSERT(index.has_value(), absl::StrCat("not a runtime feature: ", feature));
+  index_ = index.value();
+}
+
+bool runtimeFeatureEnabled(const RuntimeFeature& feature) {
+  if (Runtime::LoaderSingleton::getExisting()) {
+    return Runtime::LoaderSingleton::getExisting()->threadsafeSnapshot()->runtimeFeatureEnabled(
+        feature.index());
+  }
+  const RuntimeFeatures& features = RuntimeFeaturesDefaults::get();
+  return features.enabledByDefault(features.name(feature.index()));
+}
+
 uint64_t getInteger(absl::string_view feature, uint64_t default_value) {
   ASSERT(absl::StartsWith(feature, "envoy."));
   if (Runtime::LoaderSingleton::getExisting()) {
@@ -86,10 +102,14 @@ constexpr const char* runtime_features[] = {
     "envoy.reloadable_features.remove_forked_chromium_url",
     "envoy.reloadable_features.require_ocsp_response_for_must_staple_certs",
     "envoy.reloadable_features.return_502_for_upstream_protocol_errors",
+    "envoy.reloadable_features.route_path_index",
+    "envoy.reloadable_features.stream_json_access_log_formatter",
     "envoy.reloadable_features.strict_1xx_and_204_response_headers",
+    "envoy.reloadable_features.tls_inspector_client_hello_parser",
     "envoy.reloadable_features.tls_use_io_handle_bio",
     "envoy.reloadable_features.treat_host_like_authority",
     "envoy.reloadable_features.treat_upstream_connect_timeout_as_connect_failure",
+    "envoy.reloadable_features.upstream_happy_eyeballs",
     "envoy.reloadable_features.upstream_host_weight_change_causes_rebuild",
     "envoy.reloadable_features.use_observable_cluster_name",
     "envoy.reloadable_features.vhds_heartbeats",
@@ -114,10 +134,22 @@ constexpr const char* disabled_runtime_features[] = {
     // Allow Envoy to upgrade or downgrade version of type url, should be removed when support for
     // v2 url is removed from codebase.
     "envoy.reloadable_features.enable_type_url_downgrade_and_upgrade",
+    // Makes the child of a hot restart adopt the idle plaintext connections of its parent.
+    "envoy.reloadable_features.hot_restart_pass_connections",
+    // References the large DATA frame payloads of the HTTP/2 codec input instead of copying them.
+    "envoy.reloadable_features.http2_reference_data_frames",
+    // Swaps http-parser for the vectorized HTTP/1 parser.
+    "envoy.reloadable_features.http1_use_vectorized_parser",
+    // Allocates per-stream filter state from an arena released with the stream.
+    "envoy.reloadable_features.http_stream_arena",
     // TODO(alyssawilk) flip true after the release.
     "envoy.reloadable_features.new_tcp_connection_pool",
     // TODO(asraa) flip to true in a separate PR to enable the new JSON by default.
     "envoy.reloadable_features.remove_legacy_json",
+    // Streams the shadowed requests while they are decoded, instead of once they are buffered.
+    "envoy.reloadable_features.streaming_shadow",
+    // Serializes the Zipkin spans on an export thread, and sends them from the main thread.
+    "envoy.reloadable_features.zipkin_background_span_export",
     // Sentinel and test flag.
     "envoy.reloadable_features.test_feature_false",
 };
@@ -125,9 +157,11 @@ constexpr const char* disabled_runtime_features[] = {
 RuntimeFeatures::RuntimeFeatures() {
   for (auto& feature : runtime_features) {
     enabled_features_.insert(feature);
+    addIndex(feature);
   }
   for (auto& feature : disabled_runtime_features) {
     disabled_features_.insert(feature);
+    addIndex(feature);
   }
 }
 
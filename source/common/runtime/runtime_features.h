@@ -1,19 +1,41 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "envoy/runtime/runtime.h"
 
 #include "common/singleton/const_singleton.h"
 #include "common/singleton/threadsafe_singleton.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Runtime {
 
+/**
+ * A runtime feature resolved once to its index in the runtime features. The snapshots resolve the
+ * value of each runtime feature when they are loaded, so checking a resolved feature doesn't hash
+ * its name. Meant for the features checked for each request or connection.
+ */
+class RuntimeFeature {
+public:
+  /**
+   * @param feature supplies the name of the feature, which must be a runtime feature.
+   */
+  explicit RuntimeFeature(absl::string_view feature);
+
+  uint32_t index() const { return index_; }
+
+private:
+  uint32_t index_;
+};
+
 bool isRuntimeFeature(absl::string_view feature);
 bool runtimeFeatureEnabled(absl::string_view feature);
+bool runtimeFeatureEnabled(const RuntimeFeature& feature);
 uint64_t getInteger(absl::string_view feature, uint64_t default_value);
 
 class RuntimeFeatures {
@@ -29,11 +51,27 @@ public:
     return disabled_features_.find(feature) != disabled_features_.end();
   }
 
+  // The runtime features are indexed from 0 to size() - 1, in the order they were added.
+  absl::optional<uint32_t> index(absl::string_view feature) const {
+    const auto it = indices_.find(feature);
+    return it != indices_.end() ? absl::make_optional(it->second) : absl::nullopt;
+  }
+  const std::string& name(uint32_t index) const { return features_[index]; }
+  uint32_t size() const { return features_.size(); }
+
 private:
   friend class RuntimeFeaturesPeer;
 
+  void addIndex(absl::string_view feature) {
+    if (indices_.emplace(feature, features_.size()).second) {
+      features_.emplace_back(feature);
+    }
+  }
+
   absl::flat_hash_set<std::string> enabled_features_;
   absl::flat_hash_set<std::string> disabled_features_;
+  std::vector<std::string> features_;
+  absl::flat_hash_map<std::string, uint32_t> indices_;
 };
 
 using RuntimeFeaturesDefaults = ConstSingleton<RuntimeFeatures>;
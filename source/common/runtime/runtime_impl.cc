@@ -69,6 +69,14 @@ bool SnapshotImpl::runtimeFeatureEnabled(absl::string_view key) const {
   return getBoolean(key, RuntimeFeaturesDefaults::get().enabledByDefault(key));
 }
 
+bool SnapshotImpl::runtimeFeatureEnabled(uint32_t feature_index) const {
+  if (feature_index < runtime_features_.size()) {
+    return runtime_features_[feature_index];
+  }
+  // A feature added to the runtime features after the snapshot was loaded.
+  return runtimeFeatureEnabled(RuntimeFeaturesDefaults::get().name(feature_index));
+}
+
 bool SnapshotImpl::featureEnabled(absl::string_view key, uint64_t default_value,
                                   uint64_t random_value, uint64_t num_buckets) const {
   return random_value % num_buckets < std::min(getInteger(key, default_value), num_buckets);
@@ -188,6 +196,12 @@ SnapshotImpl::SnapshotImpl(Random::RandomGenerator& generator, RuntimeStats& sta
     }
   }
   stats.num_keys_.set(values_.size());
+
+  const RuntimeFeatures& features = RuntimeFeaturesDefaults::get();
+  runtime_features_.reserve(features.size());
+  for (uint32_t i = 0; i < features.size(); ++i) {
+    runtime_features_.push_back(runtimeFeatureEnabled(features.name(i)));
+  }
 }
 
 SnapshotImpl::Entry SnapshotImpl::createEntry(const std::string& value) {
@@ -69,6 +69,7 @@ public:
   // Runtime::Snapshot
   bool deprecatedFeatureEnabled(absl::string_view key, bool default_value) const override;
   bool runtimeFeatureEnabled(absl::string_view key) const override;
+  bool runtimeFeatureEnabled(uint32_t feature_index) const override;
   bool featureEnabled(absl::string_view key, uint64_t default_value, uint64_t random_value,
                       uint64_t num_buckets) const override;
   bool featureEnabled(absl::string_view key, uint64_t default_value) const override;
@@ -112,6 +113,8 @@ private:
 
   const std::vector<OverrideLayerConstPtr> layers_;
   EntryMap values_;
+  // The values of the runtime features when the snapshot was loaded, by feature index.
+  std::vector<bool> runtime_features_;
   Random::RandomGenerator& generator_;
   RuntimeStats& stats_;
 };
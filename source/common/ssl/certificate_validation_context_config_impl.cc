@@ -6,6 +6,7 @@
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
 #include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Ssl {
@@ -38,6 +39,7 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
               ? absl::make_optional<envoy::config::core::v3::TypedExtensionConfig>(
                     config.custom_validator_config())
               : absl::nullopt),
+      verification_cache_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, verification_cache_size, 0)),
       api_(api) {
   if (ca_cert_.empty() && custom_validator_config_ == absl::nullopt) {
     if (!certificate_revocation_list_.empty()) {
@@ -49,6 +49,8 @@ public:
     return custom_validator_config_;
   }
 
+  uint32_t verificationCacheSize() const override { return verification_cache_size_; }
+
   Api::Api& api() const override { return api_; }
 
 private:
@@ -64,6 +66,7 @@ private:
   const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
       TrustChainVerification trust_chain_verification_;
   const absl::optional<envoy::config::core::v3::TypedExtensionConfig> custom_validator_config_;
+  const uint32_t verification_cache_size_;
   Api::Api& api_;
 };
 
@@ -144,6 +144,66 @@ private:
   std::atomic<uint64_t> pending_increment_{0};
 };
 
+// Counter for hot stats incremented by many threads. Each thread adds to its own cache line, so
+// that increments don't bounce the line holding the counter between cores. Reads sum the shards,
+// which only happens for flushes and admin requests.
+class ShardedCounterImpl : public StatsSharedImpl<Counter> {
+public:
+  static constexpr uint32_t NumShards = 16;
+
+  ShardedCounterImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
+                     const StatNameTagVector& stat_name_tags)
+      : StatsSharedImpl(name, alloc, tag_extracted_name, stat_name_tags) {}
+
+  void removeFromSetLockHeld() ABSL_EXCLUSIVE_LOCKS_REQUIRED(alloc_.mutex_) override {
+    const size_t count = alloc_.counters_.erase(statName());
+    ASSERT(count == 1);
+  }
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    shards_[shardIndex()].value_.fetch_add(amount, std::memory_order_relaxed);
+    // Only write the shared flags once, as writing them on every increment would bounce their
+    // cache line just the same.
+    if (!(flags_.load(std::memory_order_relaxed) & Flags::Used)) {
+      flags_ |= Flags::Used;
+    }
+  }
+  void inc() override { add(1); }
+  uint64_t latch() override {
+    // Only the main thread latches, so the previous total doesn't need an atomic exchange.
+    const uint64_t total = sum();
+    const uint64_t increment = total - latched_total_;
+    latched_total_ = total;
+    return increment;
+  }
+  void reset() override { reset_total_ = sum(); }
+  uint64_t value() const override { return sum() - reset_total_; }
+
+private:
+  struct alignas(64) Shard {
+    std::atomic<uint64_t> value_{0};
+  };
+
+  static uint32_t shardIndex() {
+    static std::atomic<uint32_t> next_index{0};
+    static thread_local const uint32_t index = next_index++ % NumShards;
+    return index;
+  }
+
+  uint64_t sum() const {
+    uint64_t total = 0;
+    for (const Shard& shard : shards_) {
+      total += shard.value_.load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  Shard shards_[NumShards];
+  std::atomic<uint64_t> latched_total_{0};
+  std::atomic<uint64_t> reset_total_{0};
+};
+
 class GaugeImpl : public StatsSharedImpl<Gauge> {
 public:
   GaugeImpl(StatName name, AllocatorImpl& alloc, StatName tag_extracted_name,
@@ -173,18 +233,19 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     child_value_ += amount;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     child_value_ = value;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void sub(uint64_t amount) override {
     ASSERT(child_value_ >= amount);
     ASSERT(used() || amount == 0);
     child_value_ -= amount;
+    flags_ |= Flags::Changed;
   }
   uint64_t value() const override { return child_value_ + parent_value_; }
 
@@ -224,7 +285,13 @@ public:
     }
   }
 
-  void setParentValue(uint64_t value) override { parent_value_ = value; }
+  void setParentValue(uint64_t value) override {
+    parent_value_ = value;
+    flags_ |= Flags::Changed;
+  }
+  bool latchChanged() override {
+    return flags_.fetch_and(static_cast<uint16_t>(~Flags::Changed)) & Flags::Changed;
+  }
 
 private:
   std::atomic<uint64_t> parent_value_{0};
@@ -247,11 +314,15 @@ public:
     std::string value_copy(value);
     absl::MutexLock lock(&mutex_);
     value_ = std::move(value_copy);
+    flags_ |= Flags::Changed;
   }
   std::string value() const override {
     absl::MutexLock lock(&mutex_);
     return value_;
   }
+  bool latchChanged() override {
+    return flags_.fetch_and(static_cast<uint16_t>(~Flags::Changed)) & Flags::Changed;
+  }
 
 private:
   mutable absl::Mutex mutex_;
@@ -272,6 +343,21 @@ CounterSharedPtr AllocatorImpl::makeCounter(StatName name, StatName tag_extracte
   return counter;
 }
 
+CounterSharedPtr AllocatorImpl::makeShardedCounter(StatName name, StatName tag_extracted_name,
+                                                   const StatNameTagVector& stat_name_tags) {
+  Thread::LockGuard lock(mutex_);
+  ASSERT(gauges_.find(name) == gauges_.end());
+  ASSERT(text_readouts_.find(name) == text_readouts_.end());
+  auto iter = counters_.find(name);
+  if (iter != counters_.end()) {
+    return CounterSharedPtr(*iter);
+  }
+  auto counter =
+      CounterSharedPtr(new ShardedCounterImpl(name, *this, tag_extracted_name, stat_name_tags));
+  counters_.insert(counter.get());
+  return counter;
+}
+
 GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, StatName tag_extracted_name,
                                         const StatNameTagVector& stat_name_tags,
                                         Gauge::ImportMode import_mode) {
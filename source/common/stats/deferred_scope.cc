@@ -0,0 +1,73 @@
+#include "common/stats/deferred_scope.h"
+
+namespace Envoy {
+namespace Stats {
+
+Counter& DeferredCounter::create(StatName name) const {
+  return parent_.scope().counterFromStatName(name);
+}
+
+Gauge& DeferredGauge::create(StatName name) const {
+  return parent_.scope().gaugeFromStatName(name, import_mode_);
+}
+
+Histogram& DeferredHistogram::create(StatName name) const {
+  return parent_.scope().histogramFromStatName(name, unit_);
+}
+
+TextReadout& DeferredTextReadout::create(StatName name) const {
+  return parent_.scope().textReadoutFromStatName(name);
+}
+
+DeferredScope::~DeferredScope() {
+  SymbolTable& symbol_table = symbolTable();
+  for (DeferredCounter& counter : counters_) {
+    counter.free(symbol_table);
+  }
+  for (DeferredGauge& gauge : gauges_) {
+    gauge.free(symbol_table);
+  }
+  for (DeferredHistogram& histogram : histograms_) {
+    histogram.free(symbol_table);
+  }
+  for (DeferredTextReadout& text_readout : text_readouts_) {
+    text_readout.free(symbol_table);
+  }
+}
+
+Counter& DeferredScope::counterFromStatNameWithTags(const StatName& name,
+                                                    StatNameTagVectorOptConstRef tags) {
+  if (tags) {
+    return scope_.counterFromStatNameWithTags(name, tags);
+  }
+  return counters_.emplace_back(*this, name);
+}
+
+Gauge& DeferredScope::gaugeFromStatNameWithTags(const StatName& name,
+                                                StatNameTagVectorOptConstRef tags,
+                                                Gauge::ImportMode import_mode) {
+  if (tags) {
+    return scope_.gaugeFromStatNameWithTags(name, tags, import_mode);
+  }
+  return gauges_.emplace_back(*this, name, import_mode);
+}
+
+Histogram& DeferredScope::histogramFromStatNameWithTags(const StatName& name,
+                                                        StatNameTagVectorOptConstRef tags,
+                                                        Histogram::Unit unit) {
+  if (tags) {
+    return scope_.histogramFromStatNameWithTags(name, tags, unit);
+  }
+  return histograms_.emplace_back(*this, name, unit);
+}
+
+TextReadout& DeferredScope::textReadoutFromStatNameWithTags(const StatName& name,
+                                                            StatNameTagVectorOptConstRef tags) {
+  if (tags) {
+    return scope_.textReadoutFromStatNameWithTags(name, tags);
+  }
+  return text_readouts_.emplace_back(*this, name);
+}
+
+} // namespace Stats
+} // namespace Envoy
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats.h"
+
+#include "common/stats/symbol_table_impl.h"
+
+namespace Envoy {
+namespace Stats {
+
+class DeferredScope;
+
+/**
+ * Stand-in for a stat of a DeferredScope. The stat is only created in the underlying scope on the
+ * first write that changes its value, e.g. the first add() of a non-zero amount to a counter, and
+ * reads as zero before that. Metadata accessors such as name() also create the stat.
+ */
+template <class StatType> class DeferredStat : public StatType {
+public:
+  DeferredStat(DeferredScope& parent, StatName name);
+
+  // Metric
+  std::string name() const override { return getOrCreate().name(); }
+  StatName statName() const override { return getOrCreate().statName(); }
+  TagVector tags() const override { return getOrCreate().tags(); }
+  std::string tagExtractedName() const override { return getOrCreate().tagExtractedName(); }
+  StatName tagExtractedStatName() const override { return getOrCreate().tagExtractedStatName(); }
+  void iterateTagStatNames(const Metric::TagStatNameIterFn& fn) const override {
+    getOrCreate().iterateTagStatNames(fn);
+  }
+  bool used() const override {
+    const StatType* stat = get();
+    return stat != nullptr && stat->used();
+  }
+  SymbolTable& symbolTable() override;
+  const SymbolTable& constSymbolTable() const override;
+
+  // RefcountInterface
+  void incRefCount() override { refcount_helper_.incRefCount(); }
+  bool decRefCount() override { return refcount_helper_.decRefCount(); }
+  uint32_t use_count() const override { return refcount_helper_.use_count(); }
+
+  /**
+   * Frees the name of the stat. Must be called before destruction.
+   */
+  void free(SymbolTable& symbol_table) { name_.free(symbol_table); }
+
+protected:
+  /**
+   * @return the stat in the underlying scope, or nullptr if it hasn't been created yet.
+   */
+  StatType* get() const { return stat_.load(std::memory_order_acquire); }
+
+  /**
+   * @return the stat in the underlying scope, creating it if needed.
+   */
+  StatType& getOrCreate() const {
+    StatType* stat = get();
+    if (stat == nullptr) {
+      // Racing threads get the same stat from the scope, so the last store wins harmlessly.
+      stat = &create(name_.statName());
+      stat_.store(stat, std::memory_order_release);
+    }
+    return *stat;
+  }
+
+  virtual StatType& create(StatName name) const PURE;
+
+  DeferredScope& parent_;
+
+private:
+  StatNameStorage name_;
+  mutable std::atomic<StatType*> stat_{};
+  RefcountHelper refcount_helper_;
+};
+
+class DeferredCounter : public DeferredStat<Counter> {
+public:
+  using DeferredStat::DeferredStat;
+
+  // Stats::Counter
+  void add(uint64_t amount) override {
+    if (amount > 0) {
+      getOrCreate().add(amount);
+    }
+  }
+  void inc() override { getOrCreate().inc(); }
+  uint64_t latch() override {
+    Counter* counter = get();
+    return counter == nullptr ? 0 : counter->latch();
+  }
+  void reset() override {
+    Counter* counter = get();
+    if (counter != nullptr) {
+      counter->reset();
+    }
+  }
+  uint64_t value() const override {
+    const Counter* counter = get();
+    return counter == nullptr ? 0 : counter->value();
+  }
+
+protected:
+  Counter& create(StatName name) const override;
+};
+
+class DeferredGauge : public DeferredStat<Gauge> {
+public:
+  DeferredGauge(DeferredScope& parent, StatName name, ImportMode import_mode)
+      : DeferredStat(parent, name), import_mode_(import_mode) {}
+
+  // Stats::Gauge
+  void add(uint64_t amount) override {
+    if (amount > 0) {
+      getOrCreate().add(amount);
+    }
+  }
+  void dec() override { getOrCreate().dec(); }
+  void inc() override { getOrCreate().inc(); }
+  void set(uint64_t value) override {
+    Gauge* gauge = get();
+    if (gauge != nullptr || value > 0) {
+      getOrCreate().set(value);
+    }
+  }
+  void sub(uint64_t amount) override {
+    if (amount > 0) {
+      getOrCreate().sub(amount);
+    }
+  }
+  uint64_t value() const override {
+    const Gauge* gauge = get();
+    return gauge == nullptr ? 0 : gauge->value();
+  }
+  void setParentValue(uint64_t parent_value) override {
+    Gauge* gauge = get();
+    if (gauge != nullptr || parent_value > 0) {
+      getOrCreate().setParentValue(parent_value);
+    }
+  }
+  ImportMode importMode() const override {
+    const Gauge* gauge = get();
+    return gauge == nullptr ? import_mode_ : gauge->importMode();
+  }
+  void mergeImportMode(ImportMode import_mode) override {
+    Gauge* gauge = get();
+    if (gauge != nullptr) {
+      gauge->mergeImportMode(import_mode);
+    } else if (import_mode_ == ImportMode::Uninitialized) {
+      import_mode_ = import_mode;
+    }
+  }
+  bool latchChanged() override {
+    Gauge* gauge = get();
+    return gauge != nullptr && gauge->latchChanged();
+  }
+
+protected:
+  Gauge& create(StatName name) const override;
+
+private:
+  ImportMode import_mode_;
+};
+
+class DeferredHistogram : public DeferredStat<Histogram> {
+public:
+  DeferredHistogram(DeferredScope& parent, StatName name, Unit unit)
+      : DeferredStat(parent, name), unit_(unit) {}
+
+  // Stats::Histogram
+  Unit unit() const override { return unit_; }
+  void recordValue(uint64_t value) override { getOrCreate().recordValue(value); }
+
+protected:
+  Histogram& create(StatName name) const override;
+
+private:
+  const Unit unit_;
+};
+
+class DeferredTextReadout : public DeferredStat<TextReadout> {
+public:
+  using DeferredStat::DeferredStat;
+
+  // Stats::TextReadout
+  void set(absl::string_view value) override {
+    TextReadout* text_readout = get();
+    if (text_readout != nullptr || !value.empty()) {
+      getOrCreate().set(value);
+    }
+  }
+  std::string value() const override {
+    const TextReadout* text_readout = get();
+    return text_readout == nullptr ? "" : text_readout->value();
+  }
+  bool latchChanged() override {
+    TextReadout* text_readout = get();
+    return text_readout != nullptr && text_readout->latchChanged();
+  }
+
+protected:
+  TextReadout& create(StatName name) const override;
+};
+
+/**
+ * Implements a Scope that delegates to a passed-in scope, but only creates the stats in it
+ * once they are first written. Until then, each stat only costs a small placeholder, which saves
+ * memory for large sets of stats that mostly stay at zero, e.g. the stats of thousands of rarely
+ * used clusters. The trade-off is that admin and sinks don't report a stat until it is written.
+ *
+ * Every call creating a stat returns a new placeholder, which lives as long as the scope, so this
+ * is meant for stats structs created once, and not for looking stats up by name on demand.
+ * Stats with tags, as well as stats created by string and scopes, aren't deferred.
+ */
+class DeferredScope : public Scope {
+public:
+  explicit DeferredScope(Scope& scope) : scope_(scope) {}
+  ~DeferredScope() override;
+
+  /**
+   * @return the underlying scope.
+   */
+  Scope& scope() { return scope_; }
+
+  // Scope
+  ScopePtr createScope(const std::string& name) override { return scope_.createScope(name); }
+  ScopePtr scopeFromStatName(StatName name) override { return scope_.scopeFromStatName(name); }
+  Counter& counterFromStatNameWithTags(const StatName& name,
+                                       StatNameTagVectorOptConstRef tags) override;
+  Gauge& gaugeFromStatNameWithTags(const StatName& name, StatNameTagVectorOptConstRef tags,
+                                   Gauge::ImportMode import_mode) override;
+  Histogram& histogramFromStatNameWithTags(const StatName& name, StatNameTagVectorOptConstRef tags,
+                                           Histogram::Unit unit) override;
+  TextReadout& textReadoutFromStatNameWithTags(const StatName& name,
+                                               StatNameTagVectorOptConstRef tags) override;
+  void deliverHistogramToSinks(const Histogram& histogram, uint64_t value) override {
+    scope_.deliverHistogramToSinks(histogram, value);
+  }
+
+  Counter& counterFromString(const std::string& name) override {
+    return scope_.counterFromString(name);
+  }
+  Gauge& gaugeFromString(const std::string& name, Gauge::ImportMode import_mode) override {
+    return scope_.gaugeFromString(name, import_mode);
+  }
+  Histogram& histogramFromString(const std::string& name, Histogram::Unit unit) override {
+    return scope_.histogramFromString(name, unit);
+  }
+  TextReadout& textReadoutFromString(const std::string& name) override {
+    return scope_.textReadoutFromString(name);
+  }
+
+  CounterOptConstRef findCounter(StatName name) const override { return scope_.findCounter(name); }
+  GaugeOptConstRef findGauge(StatName name) const override { return scope_.findGauge(name); }
+  HistogramOptConstRef findHistogram(StatName name) const override {
+    return scope_.findHistogram(name);
+  }
+  TextReadoutOptConstRef findTextReadout(StatName name) const override {
+    return scope_.findTextReadout(name);
+  }
+
+  const SymbolTable& constSymbolTable() const final { return scope_.constSymbolTable(); }
+  SymbolTable& symbolTable() final { return scope_.symbolTable(); }
+
+  NullGaugeImpl& nullGauge(const std::string& str) override { return scope_.nullGauge(str); }
+
+  bool iterate(const IterateFn<Counter>& fn) const override { return scope_.iterate(fn); }
+  bool iterate(const IterateFn<Gauge>& fn) const override { return scope_.iterate(fn); }
+  bool iterate(const IterateFn<Histogram>& fn) const override { return scope_.iterate(fn); }
+  bool iterate(const IterateFn<TextReadout>& fn) const override { return scope_.iterate(fn); }
+
+private:
+  Scope& scope_;
+  // Deques keep the placeholders at stable addresses, with fewer allocations than a list.
+  std::deque<DeferredCounter> counters_;
+  std::deque<DeferredGauge> gauges_;
+  std::deque<DeferredHistogram> histograms_;
+  std::deque<DeferredTextReadout> text_readouts_;
+};
+
+template <class StatType>
+DeferredStat<StatType>::DeferredStat(DeferredScope& parent, StatName name)
+    : parent_(parent), name_(name, parent.symbolTable()) {}
+
+template <class StatType> SymbolTable& DeferredStat<StatType>::symbolTable() {
+  return parent_.symbolTable();
+}
+
+template <class StatType> const SymbolTable& DeferredStat<StatType>::constSymbolTable() const {
+  return parent_.constSymbolTable();
+}
+
+} // namespace Stats
+} // namespace Envoy
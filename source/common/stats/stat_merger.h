@@ -56,6 +56,25 @@ public:
                   const Protobuf::Map<std::string, uint64_t>& gauges,
                   const DynamicsMap& dynamics = DynamicsMap());
 
+  /**
+   * Records the names of the stats that the parent refers to by id in mergeStatsById().
+   *
+   * @param stat_names map of the names of the stats by id.
+   * @param dynamics information about which segments of the names are dynamic.
+   */
+  void addStatNames(const Protobuf::Map<uint32_t, std::string>& stat_names,
+                    const DynamicsMap& dynamics = DynamicsMap());
+
+  /**
+   * Like mergeStats(), for stats named by the ids given to addStatNames(). The stats whose id
+   * is unknown are ignored.
+   *
+   * @param counter_deltas map of counter changes from parent, by id.
+   * @param gauges map of gauge changes from parent, by id.
+   */
+  void mergeStatsById(const Protobuf::Map<uint32_t, uint64_t>& counter_deltas,
+                      const Protobuf::Map<uint32_t, uint64_t>& gauges);
+
   /**
    * Indicates that a gauge's value from the hot-restart parent should be
    * retained, combining it with the child data. By default, data is transferred
@@ -76,8 +95,12 @@ private:
                      const DynamicsMap& dynamics_map);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                    const DynamicsMap& dynamics_map);
+  void mergeCounter(StatName stat_name, uint64_t delta);
+  void mergeGauge(StatName stat_name, uint64_t parent_value);
 
   StatNameHashSet parent_gauges_;
+  // The names of the stats the parent refers to by id.
+  absl::flat_hash_map<uint32_t, StatNameStorage> stat_names_by_id_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
   // shared_ptrs to the stats that live in them, with the question of which stats are living in a
   // given scope determined by which stat names have been accessed via that scope. E.g., if you
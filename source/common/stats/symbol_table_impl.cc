@@ -9,6 +9,7 @@
 #include "common/common/logger.h"
 #include "common/common/utility.h"
 
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/str_cat.h"
 
 namespace Envoy {
@@ -182,9 +183,20 @@ void SymbolTableImpl::Encoding::appendToMemBlock(StatName stat_name,
   }
 }
 
+namespace {
+
+// Bounds the memory of each thread cache. A full cache is cleared, rather than evicting entries one
+// by one, as the working set of tokens that are encoded over and over is usually much smaller.
+constexpr size_t MaxThreadCacheSize = 4096;
+
+std::atomic<uint64_t> next_table_id{1};
+
+} // namespace
+
 SymbolTableImpl::SymbolTableImpl()
     // Have to be explicitly initialized, if we want to use the ABSL_GUARDED_BY macro.
-    : next_symbol_(FirstValidSymbol), monotonic_counter_(FirstValidSymbol) {}
+    : next_symbol_(FirstValidSymbol), monotonic_counter_(FirstValidSymbol),
+      id_(next_table_id.fetch_add(1, std::memory_order_relaxed)) {}
 
 SymbolTableImpl::~SymbolTableImpl() {
   // To avoid leaks into the symbol table, we expect all StatNames to be freed.
@@ -205,20 +217,41 @@ void SymbolTableImpl::addTokensToEncoding(const absl::string_view name, Encoding
   // We want to hold the lock for the minimum amount of time, so we do the
   // string-splitting and prepare a temp vector of Symbol first.
   const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
-  std::vector<Symbol> symbols;
-  symbols.reserve(tokens.size());
+  std::vector<Symbol> symbols(tokens.size());
+
+  // Tokens this thread encoded recently are referenced without the lock. The others are
+  // collected, so that the lock is taken at most once.
+  ThreadCache& cache = threadCache();
+  const bool track_recent_lookups = track_recent_lookups_.load(std::memory_order_relaxed);
+  absl::InlinedVector<uint32_t, 8> missing;
+  for (uint32_t i = 0; i < tokens.size(); ++i) {
+    if (track_recent_lookups || !referenceCached(cache, tokens[i], symbols[i])) {
+      missing.push_back(i);
+    }
+  }
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
-  {
+  // Now take the lock and populate the remaining Symbol objects, which involves
+  // bumping ref-counts in this.
+  if (missing.empty() && !track_recent_lookups) {
+    unlocked_lookups_.fetch_add(1, std::memory_order_relaxed);
+  } else {
     Thread::LockGuard lock(lock_);
     recent_lookups_.lookup(name);
-    for (auto& token : tokens) {
+    for (uint32_t i : missing) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      SharedSymbol& shared_symbol = toSymbol(tokens[i]);
+      symbols[i] = shared_symbol.symbol_;
+      if (!track_recent_lookups) {
+        if (cache.symbols_.size() >= MaxThreadCacheSize) {
+          cache.symbols_.clear();
+        }
+        cache.symbols_.insert_or_assign(
+            std::string(tokens[i]), CachedSymbol{&shared_symbol, shared_symbol.generation_.load(),
+                                                 shared_symbol.symbol_});
+      }
     }
   }
 
@@ -254,7 +287,8 @@ void SymbolTableImpl::incRefCount(const StatName& stat_name) {
            "https://github.com/envoyproxy/envoy/blob/main/source/docs/stats.md#"
            "debugging-symbol-table-assertions");
 
-    ++encode_search->second.ref_count_;
+    // The caller holds a reference, so the count can't be zero.
+    ++encode_search->second->ref_count_;
   }
 }
 
@@ -264,24 +298,75 @@ void SymbolTableImpl::free(const StatName& stat_name) {
 
   Thread::LockGuard lock(lock_);
   for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
+    releaseSymbol(symbol);
+  }
+}
 
-    auto encode_search = encode_map_.find(decode_search->second->toStringView());
-    ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
-      decode_map_.erase(decode_search);
-      encode_map_.erase(encode_search);
-      pool_.push(symbol);
+void SymbolTableImpl::releaseSymbol(Symbol symbol) {
+  auto decode_search = decode_map_.find(symbol);
+  ASSERT(decode_search != decode_map_.end());
+
+  auto encode_search = encode_map_.find(decode_search->second->toStringView());
+  ASSERT(encode_search != encode_map_.end());
+
+  // If that was the last remaining client usage of the symbol, erase the
+  // current mappings and add the now-unused symbol to the reuse pool. Threads
+  // referencing symbols without the lock never increment a zero count, so the
+  // symbol can't be revived concurrently.
+  //
+  // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
+  // symbol_table_speed_test.cc, relative to breaking out the decrement into a
+  // separate step, likely due to the non-trivial dereferences in EXPR.
+  SharedSymbol* shared_symbol = encode_search->second;
+  if (--shared_symbol->ref_count_ == 0) {
+    ++shared_symbol->generation_;
+    free_shared_symbols_.push_back(shared_symbol);
+    decode_map_.erase(decode_search);
+    encode_map_.erase(encode_search);
+    pool_.push(symbol);
+  }
+}
+
+SymbolTableImpl::ThreadCache& SymbolTableImpl::threadCache() const {
+  static thread_local ThreadCache cache;
+  if (cache.table_id_ != id_) {
+    cache.table_id_ = id_;
+    cache.symbols_.clear();
+  }
+  return cache;
+}
+
+bool SymbolTableImpl::referenceCached(ThreadCache& cache, absl::string_view token,
+                                      Symbol& symbol) {
+  auto iter = cache.symbols_.find(token);
+  if (iter == cache.symbols_.end()) {
+    return false;
+  }
+  const CachedSymbol& cached = iter->second;
+  SharedSymbol& shared_symbol = *cached.shared_symbol_;
+
+  // Only take a reference while the symbol is alive: once its count drops to zero, it is erased
+  // under the lock, and may be reused for another symbol.
+  uint32_t ref_count = shared_symbol.ref_count_.load();
+  do {
+    if (ref_count == 0 || shared_symbol.generation_.load() != cached.generation_) {
+      cache.symbols_.erase(iter);
+      return false;
     }
+  } while (!shared_symbol.ref_count_.compare_exchange_weak(ref_count, ref_count + 1));
+
+  if (shared_symbol.generation_.load() != cached.generation_) {
+    // The symbol was erased and its entry reused between the check above and the increment, so
+    // the reference is to another symbol. Hand it back.
+    {
+      Thread::LockGuard lock(lock_);
+      releaseSymbol(shared_symbol.symbol_);
+    }
+    cache.symbols_.erase(iter);
+    return false;
   }
+  symbol = cached.symbol_;
+  return true;
 }
 
 uint64_t SymbolTableImpl::getRecentLookups(const RecentLookupsFn& iter) const {
@@ -295,7 +380,7 @@ uint64_t SymbolTableImpl::getRecentLookups(const RecentLookupsFn& iter) const {
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
-    total += recent_lookups_.total();
+    total += recent_lookups_.total() + unlocked_lookups_.load(std::memory_order_relaxed);
   }
 
   // Now we have the collated name-count map data: we need to vectorize and
@@ -343,11 +428,13 @@ DynamicSpans SymbolTableImpl::getDynamicSpans(StatName stat_name) const {
 void SymbolTableImpl::setRecentLookupCapacity(uint64_t capacity) {
   Thread::LockGuard lock(lock_);
   recent_lookups_.setCapacity(capacity);
+  track_recent_lookups_.store(capacity > 0, std::memory_order_relaxed);
 }
 
 void SymbolTableImpl::clearRecentLookups() {
   Thread::LockGuard lock(lock_);
   recent_lookups_.clear();
+  unlocked_lookups_.store(0, std::memory_order_relaxed);
 }
 
 uint64_t SymbolTableImpl::recentLookupCapacity() const {
@@ -361,30 +448,37 @@ StatNameSetPtr SymbolTableImpl::makeSet(absl::string_view name) {
   return stat_name_set;
 }
 
-Symbol SymbolTableImpl::toSymbol(absl::string_view sv) {
-  Symbol result;
+SymbolTableImpl::SharedSymbol& SymbolTableImpl::toSymbol(absl::string_view sv) {
   auto encode_find = encode_map_.find(sv);
-  // If the string segment doesn't already exist,
-  if (encode_find == encode_map_.end()) {
-    // We create the actual string, place it in the decode_map_, and then insert
-    // a string_view pointing to it in the encode_map_. This allows us to only
-    // store the string once. We use unique_ptr so copies are not made as
-    // flat_hash_map moves values around.
-    InlineStringPtr str = InlineString::create(sv);
-    auto encode_insert = encode_map_.insert({str->toStringView(), SharedSymbol(next_symbol_)});
-    ASSERT(encode_insert.second);
-    auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
-    ASSERT(decode_insert.second);
-
-    result = next_symbol_;
-    newSymbol();
+  if (encode_find != encode_map_.end()) {
+    // If the string segment already exists, up the refcount. The symbol is in
+    // use, so the count can't concurrently drop to zero.
+    ++encode_find->second->ref_count_;
+    return *encode_find->second;
+  }
+
+  // Otherwise we create the actual string, place it in the decode_map_, and
+  // then insert a string_view pointing to it in the encode_map_. This allows us
+  // to only store the string once. We use unique_ptr so copies are not made as
+  // flat_hash_map moves values around.
+  SharedSymbol* shared_symbol;
+  if (free_shared_symbols_.empty()) {
+    shared_symbol = &shared_symbols_.emplace_back();
   } else {
-    // If the insertion didn't take place, return the actual value at that location and up the
-    // refcount at that location
-    result = encode_find->second.symbol_;
-    ++(encode_find->second.ref_count_);
+    shared_symbol = free_shared_symbols_.back();
+    free_shared_symbols_.pop_back();
   }
-  return result;
+  shared_symbol->symbol_ = next_symbol_;
+  shared_symbol->ref_count_ = 1;
+
+  InlineStringPtr str = InlineString::create(sv);
+  auto encode_insert = encode_map_.insert({str->toStringView(), shared_symbol});
+  ASSERT(encode_insert.second);
+  auto decode_insert = decode_map_.insert({next_symbol_, std::move(str)});
+  ASSERT(decode_insert.second);
+
+  newSymbol();
+  return *shared_symbol;
 }
 
 absl::string_view SymbolTableImpl::fromSymbol(const Symbol symbol) const
@@ -432,8 +526,9 @@ void SymbolTableImpl::debugPrint() const {
   std::sort(symbols.begin(), symbols.end());
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
-    const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    const SharedSymbol& shared_symbol = *encode_map_.find(token.toStringView())->second;
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <stack>
 #include <string>
@@ -203,14 +205,35 @@ private:
   friend class StatNameTest;
   friend class StatNameDeathTest;
 
+  // Entries are never deallocated before the table, but reused for new symbols once freed, so
+  // that threads can safely reference them without holding the lock, see referenceCached().
   struct SharedSymbol {
-    SharedSymbol(Symbol symbol) : symbol_(symbol), ref_count_(1) {}
+    // Only written with the lock held.
+    Symbol symbol_{};
+    // Only drops to zero with the lock held, and the symbol is then erased in the same critical
+    // section. Increments from a non-zero count don't need the lock.
+    std::atomic<uint32_t> ref_count_{};
+    // Bumped each time the symbol is erased, so that stale references to the entry can tell that it
+    // has been reused for another symbol.
+    std::atomic<uint64_t> generation_{};
+  };
 
+  // A symbol recently encoded by a thread, with the generation of its entry at the time.
+  struct CachedSymbol {
+    SharedSymbol* shared_symbol_;
+    uint64_t generation_;
     Symbol symbol_;
-    uint32_t ref_count_;
   };
 
-  // This must be held during both encode() and free().
+  // Per-thread cache of the symbols of recently encoded tokens, which lets encode() reference
+  // already known symbols without taking the lock. It only holds the symbols of a single table at
+  // a time, identified by its id_.
+  struct ThreadCache {
+    uint64_t table_id_{};
+    absl::flat_hash_map<std::string, CachedSymbol> symbols_;
+  };
+
+  // This must be held during free(), and during encode() for tokens missing from the thread cache.
   mutable Thread::MutexBasicLockable lock_;
 
   /**
@@ -234,7 +257,29 @@ private:
    * @param sv the individual string to be encoded as a symbol.
    * @return Symbol the encoded string.
    */
-  Symbol toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  SharedSymbol& toSymbol(absl::string_view sv) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  /**
+   * Drops a reference to a symbol, erasing it if it was the last one.
+   *
+   * @param symbol the symbol to release.
+   */
+  void releaseSymbol(Symbol symbol) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  /**
+   * @return the calling thread's cache of this table's symbols.
+   */
+  ThreadCache& threadCache() const;
+
+  /**
+   * Takes a reference to the symbol of token from the thread cache, without the lock.
+   *
+   * @param cache the calling thread's cache.
+   * @param token the token to look up.
+   * @param symbol receives the symbol of the token if it is found.
+   * @return bool whether a reference was taken.
+   */
+  bool referenceCached(ThreadCache& cache, absl::string_view token, Symbol& symbol);
 
   /**
    * Convenience function for decode(), decoding one symbol at a time.
@@ -273,11 +318,23 @@ private:
   // Bitmap implementation.
   // The encode map stores both the symbol and the ref count of that symbol.
   // Using absl::string_view lets us only store the complete string once, in the decode map.
-  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol>;
+  using EncodeMap = absl::flat_hash_map<absl::string_view, SharedSymbol*>;
   using DecodeMap = absl::flat_hash_map<Symbol, InlineStringPtr>;
   EncodeMap encode_map_ ABSL_GUARDED_BY(lock_);
   DecodeMap decode_map_ ABSL_GUARDED_BY(lock_);
 
+  // Storage for the entries of encode_map_, at stable addresses, and the entries available for
+  // reuse.
+  std::deque<SharedSymbol> shared_symbols_ ABSL_GUARDED_BY(lock_);
+  std::vector<SharedSymbol*> free_shared_symbols_ ABSL_GUARDED_BY(lock_);
+
+  // Identifies the table in thread caches. Unlike the address of the table, it is never reused.
+  const uint64_t id_;
+  // Recording recent lookups requires the lock, so the thread caches are bypassed while enabled.
+  std::atomic<bool> track_recent_lookups_{false};
+  // Lookups done without the lock, which are added to the total of recent_lookups_.
+  std::atomic<uint64_t> unlocked_lookups_{0};
+
   // Free pool of symbols for re-use.
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
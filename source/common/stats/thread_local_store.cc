@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -21,6 +22,18 @@
 
 namespace Envoy {
 namespace Stats {
+namespace {
+
+bool matchesAny(const std::vector<Matchers::StringMatcherPtr>& matchers, const std::string& name) {
+  for (const auto& matcher : matchers) {
+    if (matcher->match(name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
 
 const char ThreadLocalStoreImpl::MainDispatcherCleanupSync[] = "main-dispatcher-cleanup";
 
@@ -53,6 +66,24 @@ void ThreadLocalStoreImpl::setHistogramSettings(HistogramSettingsConstPtr&& hist
   histogram_settings_ = std::move(histogram_settings);
 }
 
+void ThreadLocalStoreImpl::setShardedCounters(std::vector<Matchers::StringMatcherPtr>&& matchers) {
+  // Only applies to counters created from now on, so this must be set before the hot counters are.
+  sharded_counters_ = std::move(matchers);
+}
+
+bool ThreadLocalStoreImpl::shardCounter(StatName name) const {
+  if (sharded_counters_.empty()) {
+    return false;
+  }
+  return matchesAny(sharded_counters_, constSymbolTable().toString(name));
+}
+
+void ThreadLocalStoreImpl::setBucketedHistograms(
+    std::vector<Matchers::StringMatcherPtr>&& matchers) {
+  // Only applies to histograms created from now on, like setShardedCounters().
+  bucketed_histograms_ = std::move(matchers);
+}
+
 void ThreadLocalStoreImpl::setStatsMatcher(StatsMatcherPtr&& stats_matcher) {
   stats_matcher_ = std::move(stats_matcher);
   if (stats_matcher_->acceptsAll()) {
@@ -502,8 +533,11 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatNameWithTags(
   return safeMakeStat<Counter>(
       final_stat_name, joiner.tagExtractedName(), stat_name_tags, central_cache_->counters_,
       central_cache_->rejected_stats_,
-      [](Allocator& allocator, StatName name, StatName tag_extracted_name,
-         const StatNameTagVector& tags) -> CounterSharedPtr {
+      [this](Allocator& allocator, StatName name, StatName tag_extracted_name,
+             const StatNameTagVector& tags) -> CounterSharedPtr {
+        if (parent_.shardCounter(name)) {
+          return allocator.makeShardedCounter(name, tag_extracted_name, tags);
+        }
         return allocator.makeCounter(name, tag_extracted_name, tags);
       },
       tls_cache, tls_rejected_stats, parent_.null_counter_);
@@ -607,8 +641,10 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
   } else {
     StatNameTagHelper tag_helper(parent_, joiner.tagExtractedName(), stat_name_tags);
 
+    const std::string name_str = symbolTable().toString(final_stat_name);
     ConstSupportedBuckets* buckets = nullptr;
-    buckets = &parent_.histogram_settings_->buckets(symbolTable().toString(final_stat_name));
+    buckets = &parent_.histogram_settings_->buckets(name_str);
+    const bool bucketed = matchesAny(parent_.bucketed_histograms_, name_str);
 
     RefcountPtr<ParentHistogramImpl> stat;
     {
@@ -619,7 +655,7 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatNameWithTags(
       } else {
         stat = new ParentHistogramImpl(final_stat_name, unit, parent_,
                                        tag_helper.tagExtractedName(), tag_helper.statNameTags(),
-                                       *buckets, parent_.next_histogram_id_++);
+                                       *buckets, bucketed, parent_.next_histogram_id_++);
         if (!parent_.shutting_down_) {
           parent_.histogram_set_.insert(stat.get());
         }
@@ -713,9 +749,9 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 
   StatNameTagHelper tag_helper(*this, parent.statName(), absl::nullopt);
 
-  TlsHistogramSharedPtr hist_tls_ptr(
-      new ThreadLocalHistogramImpl(parent.statName(), parent.unit(), tag_helper.tagExtractedName(),
-                                   tag_helper.statNameTags(), symbolTable()));
+  TlsHistogramSharedPtr hist_tls_ptr(new ThreadLocalHistogramImpl(
+      parent.statName(), parent.unit(), tag_helper.tagExtractedName(), tag_helper.statNameTags(),
+      symbolTable(), parent.bucketed()));
 
   parent.addTlsHistogram(hist_tls_ptr);
 
@@ -729,12 +765,16 @@ Histogram& ThreadLocalStoreImpl::tlsHistogram(ParentHistogramImpl& parent, uint6
 ThreadLocalHistogramImpl::ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit,
                                                    StatName tag_extracted_name,
                                                    const StatNameTagVector& stat_name_tags,
-                                                   SymbolTable& symbol_table)
+                                                   SymbolTable& symbol_table, bool bucketed)
     : HistogramImplHelper(name, tag_extracted_name, stat_name_tags, symbol_table), unit_(unit),
       current_active_(0), used_(false), created_thread_id_(std::this_thread::get_id()),
       symbol_table_(symbol_table) {
   histograms_[0] = hist_alloc();
   histograms_[1] = hist_alloc();
+  if (bucketed) {
+    bucket_counts_[0].resize(NumBuckets);
+    bucket_counts_[1].resize(NumBuckets);
+  }
 }
 
 ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
@@ -745,26 +785,68 @@ ThreadLocalHistogramImpl::~ThreadLocalHistogramImpl() {
 
 void ThreadLocalHistogramImpl::recordValue(uint64_t value) {
   ASSERT(std::this_thread::get_id() == created_thread_id_);
-  hist_insert_intscale(histograms_[current_active_], value, 0, 1);
-  used_ = true;
+  std::vector<uint32_t>& counts = bucket_counts_[current_active_];
+  if (counts.empty() || value >= MaxBucketedValue) {
+    hist_insert_intscale(histograms_[current_active_], value, 0, 1);
+  } else if (value < 100) {
+    // The histogram keeps the first two significant digits, so these values are exact.
+    if (++counts[value] == std::numeric_limits<uint32_t>::max()) {
+      hist_insert_intscale(histograms_[current_active_], value, 0, counts[value]);
+      counts[value] = 0;
+    }
+  } else {
+    // Find the bucket of the first two significant digits of the value.
+    uint64_t divisor = 10;
+    uint32_t exponent = 1;
+    while (value >= divisor * 100) {
+      divisor *= 10;
+      ++exponent;
+    }
+    const uint64_t mantissa = value / divisor;
+    const size_t index = 100 + (exponent - 1) * 90 + (mantissa - 10);
+    if (++counts[index] == std::numeric_limits<uint32_t>::max()) {
+      hist_insert_intscale(histograms_[current_active_], mantissa, exponent, counts[index]);
+      counts[index] = 0;
+    }
+  }
+  // Only written the first time, so that recording doesn't write to a shared cache line.
+  if (!used_.load(std::memory_order_relaxed)) {
+    used_ = true;
+  }
 }
 
 void ThreadLocalHistogramImpl::merge(histogram_t* target) {
   histogram_t** other_histogram = &histograms_[otherHistogramIndex()];
   hist_accumulate(target, other_histogram, 1);
   hist_clear(*other_histogram);
+
+  std::vector<uint32_t>& counts = bucket_counts_[otherHistogramIndex()];
+  for (size_t index = 0; index < counts.size(); ++index) {
+    if (counts[index] == 0) {
+      continue;
+    }
+    if (index < 100) {
+      hist_insert_intscale(target, index, 0, counts[index]);
+    } else {
+      // Inserting mantissa * 10^exponent adds to the bucket of all the values counted here.
+      hist_insert_intscale(target, (index - 100) % 90 + 10, (index - 100) / 90 + 1, counts[index]);
+    }
+    counts[index] = 0;
+  }
 }
 
 ParentHistogramImpl::ParentHistogramImpl(StatName name, Histogram::Unit unit,
                                          ThreadLocalStoreImpl& thread_local_store,
                                          StatName tag_extracted_name,
                                          const StatNameTagVector& stat_name_tags,
-                                         ConstSupportedBuckets& supported_buckets, uint64_t id)
+                                         ConstSupportedBuckets& supported_buckets, bool bucketed,
+                                         uint64_t id)
     : MetricImpl(name, tag_extracted_name, stat_name_tags, thread_local_store.symbolTable()),
       unit_(unit), thread_local_store_(thread_local_store), interval_histogram_(hist_alloc()),
       cumulative_histogram_(hist_alloc()),
       interval_statistics_(interval_histogram_, supported_buckets),
-      cumulative_statistics_(cumulative_histogram_, supported_buckets), merged_(false), id_(id) {}
+      cumulative_statistics_(cumulative_histogram_, supported_buckets), merged_(false),
+      bucketed_(bucketed), id_(id) {}
 
 ParentHistogramImpl::~ParentHistogramImpl() {
   thread_local_store_.releaseHistogramCrossThread(id_);
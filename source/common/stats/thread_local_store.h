@@ -6,6 +6,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/stats/tag.h"
 #include "envoy/thread_local/thread_local.h"
@@ -31,11 +32,22 @@ namespace Stats {
  * A histogram that is stored in TLS and used to record values per thread. This holds two
  * histograms, one to collect the values and other as backup that is used for merge process. The
  * swap happens during the merge process.
+ *
+ * A bucketed histogram also holds two flat arrays of counts, one per log linear histogram bucket
+ * below MaxBucketedValue, and records values by incrementing the count of their bucket. The counts
+ * are added to the target histogram when merging, so recording doesn't have to look up the bucket
+ * in the histogram, or allocate it.
  */
 class ThreadLocalHistogramImpl : public HistogramImplHelper {
 public:
+  // Values from here on are inserted into the histogram even if it's bucketed. Each decimal order
+  // of magnitude from 100 has 90 buckets, and the values below 100 have one bucket each.
+  static constexpr uint64_t MaxBucketedValue = 10000000000;
+  static constexpr size_t NumBuckets = 100 + 8 * 90;
+
   ThreadLocalHistogramImpl(StatName name, Histogram::Unit unit, StatName tag_extracted_name,
-                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table);
+                           const StatNameTagVector& stat_name_tags, SymbolTable& symbol_table,
+                           bool bucketed);
   ~ThreadLocalHistogramImpl() override;
 
   void merge(histogram_t* target);
@@ -67,6 +79,8 @@ private:
   uint64_t otherHistogramIndex() const { return 1 - current_active_; }
   uint64_t current_active_;
   histogram_t* histograms_[2];
+  // Empty unless the histogram is bucketed.
+  std::vector<uint32_t> bucket_counts_[2];
   std::atomic<bool> used_;
   std::thread::id created_thread_id_;
   SymbolTable& symbol_table_;
@@ -83,9 +97,14 @@ class ParentHistogramImpl : public MetricImpl<ParentHistogram> {
 public:
   ParentHistogramImpl(StatName name, Histogram::Unit unit, ThreadLocalStoreImpl& parent,
                       StatName tag_extracted_name, const StatNameTagVector& stat_name_tags,
-                      ConstSupportedBuckets& supported_buckets, uint64_t id);
+                      ConstSupportedBuckets& supported_buckets, bool bucketed, uint64_t id);
   ~ParentHistogramImpl() override;
 
+  /**
+   * @return whether the values of this histogram are recorded in per-thread buckets.
+   */
+  bool bucketed() const { return bucketed_; }
+
   void addTlsHistogram(const TlsHistogramSharedPtr& hist_ptr);
 
   // Stats::Histogram
@@ -132,6 +151,7 @@ private:
   mutable Thread::MutexBasicLockable merge_lock_;
   std::list<TlsHistogramSharedPtr> tls_histograms_ ABSL_GUARDED_BY(merge_lock_);
   bool merged_;
+  const bool bucketed_;
   std::atomic<bool> shutting_down_{false};
   std::atomic<uint32_t> ref_count_{0};
   const uint64_t id_; // Index into TlsCache::histogram_cache_.
@@ -251,6 +271,8 @@ public:
   }
   void setStatsMatcher(StatsMatcherPtr&& stats_matcher) override;
   void setHistogramSettings(HistogramSettingsConstPtr&& histogram_settings) override;
+  void setShardedCounters(std::vector<Matchers::StringMatcherPtr>&& matchers) override;
+  void setBucketedHistograms(std::vector<Matchers::StringMatcherPtr>&& matchers) override;
   void initializeThreading(Event::Dispatcher& main_thread_dispatcher,
                            ThreadLocal::Instance& tls) override;
   void shutdownThreading() override;
@@ -477,6 +499,7 @@ private:
   void releaseScopeCrossThread(ScopeImpl* scope);
   void mergeInternal(PostMergeCb merge_cb);
   bool rejects(StatName name) const;
+  bool shardCounter(StatName name) const;
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
@@ -495,6 +518,8 @@ private:
   TagProducerPtr tag_producer_;
   StatsMatcherPtr stats_matcher_;
   HistogramSettingsConstPtr histogram_settings_;
+  std::vector<Matchers::StringMatcherPtr> sharded_counters_;
+  std::vector<Matchers::StringMatcherPtr> bucketed_histograms_;
   std::atomic<bool> threading_ever_initialized_{};
   std::atomic<bool> shutting_down_{};
   std::atomic<bool> merge_in_progress_{};
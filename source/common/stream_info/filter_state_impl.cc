@@ -13,19 +13,18 @@ void FilterStateImpl::setData(absl::string_view data_name, std::shared_ptr<Objec
           "FilterState::setData<T> called twice with conflicting life_span on the same data_name.");
     }
     maybeCreateParent(ParentAccessMode::ReadWrite);
-    parent_->setData(data_name, data, state_type, life_span);
+    parent_->setData(data_name, std::move(data), state_type, life_span);
     return;
   }
   if (parent_ && parent_->hasDataWithName(data_name)) {
     throw EnvoyException(
         "FilterState::setData<T> called twice with conflicting life_span on the same data_name.");
   }
-  const auto& it = data_storage_.find(data_name);
-  if (it != data_storage_.end()) {
+  FilterStateImpl::FilterObject* current = findInternally(data_name);
+  if (current != nullptr) {
     // We have another object with same data_name. Check for mutability
     // violations namely: readonly data cannot be overwritten. mutable data
     // cannot be overwritten by readonly data.
-    const FilterStateImpl::FilterObject* current = it->second.get();
     if (current->state_type_ == FilterState::StateType::ReadOnly) {
       throw EnvoyException("FilterState::setData<T> called twice on same ReadOnly state.");
     }
@@ -33,12 +32,18 @@ void FilterStateImpl::setData(absl::string_view data_name, std::shared_ptr<Objec
     if (current->state_type_ != state_type) {
       throw EnvoyException("FilterState::setData<T> called twice with different state types.");
     }
+    current->data_ = std::move(data);
+    return;
   }
 
-  std::unique_ptr<FilterStateImpl::FilterObject> filter_object(new FilterStateImpl::FilterObject());
-  filter_object->data_ = data;
-  filter_object->state_type_ = state_type;
-  data_storage_[data_name] = std::move(filter_object);
+  data_storage_.push_back({std::string(data_name), std::move(data), state_type});
+  if (!data_index_.empty()) {
+    data_index_.emplace(data_storage_.back().name_, data_storage_.size() - 1);
+  } else if (data_storage_.size() > MaxLinearLookups) {
+    for (size_t i = 0; i < data_storage_.size(); ++i) {
+      data_index_.emplace(data_storage_[i].name_, i);
+    }
+  }
 }
 
 bool FilterStateImpl::hasDataWithName(absl::string_view data_name) const {
@@ -47,30 +52,28 @@ bool FilterStateImpl::hasDataWithName(absl::string_view data_name) const {
 
 const FilterState::Object*
 FilterStateImpl::getDataReadOnlyGeneric(absl::string_view data_name) const {
-  const auto& it = data_storage_.find(data_name);
+  const FilterStateImpl::FilterObject* current = findInternally(data_name);
 
-  if (it == data_storage_.end()) {
+  if (current == nullptr) {
     if (parent_) {
       return &(parent_->getDataReadOnly<FilterState::Object>(data_name));
     }
     throw EnvoyException("FilterState::getDataReadOnly<T> called for unknown data name.");
   }
 
-  const FilterStateImpl::FilterObject* current = it->second.get();
   return current->data_.get();
 }
 
 FilterState::Object* FilterStateImpl::getDataMutableGeneric(absl::string_view data_name) {
-  const auto& it = data_storage_.find(data_name);
+  FilterStateImpl::FilterObject* current = findInternally(data_name);
 
-  if (it == data_storage_.end()) {
+  if (current == nullptr) {
     if (parent_) {
       return &(parent_->getDataMutable<FilterState::Object>(data_name));
     }
     throw EnvoyException("FilterState::getDataMutable<T> called for unknown data name.");
   }
 
-  FilterStateImpl::FilterObject* current = it->second.get();
   if (current->state_type_ == FilterState::StateType::ReadOnly) {
     throw EnvoyException(
         "FilterState::getDataMutable<T> tried to access immutable data as mutable.");
@@ -87,7 +90,21 @@ bool FilterStateImpl::hasDataAtOrAboveLifeSpan(FilterState::LifeSpan life_span)
 }
 
 bool FilterStateImpl::hasDataWithNameInternally(absl::string_view data_name) const {
-  return data_storage_.count(data_name) > 0;
+  return findInternally(data_name) != nullptr;
+}
+
+const FilterStateImpl::FilterObject*
+FilterStateImpl::findInternally(absl::string_view data_name) const {
+  if (!data_index_.empty()) {
+    const auto it = data_index_.find(data_name);
+    return it != data_index_.end() ? &data_storage_[it->second] : nullptr;
+  }
+  for (const FilterObject& object : data_storage_) {
+    if (object.name_ == data_name) {
+      return &object;
+    }
+  }
+  return nullptr;
 }
 
 void FilterStateImpl::maybeCreateParent(ParentAccessMode parent_access_mode) {
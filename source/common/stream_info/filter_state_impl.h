@@ -1,12 +1,15 @@
 #pragma once
 
+#include <cstddef>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "envoy/stream_info/filter_state.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -52,20 +55,35 @@ public:
   FilterStateSharedPtr parent() const override { return parent_; }
 
 private:
-  // This only checks the local data_storage_ for data_name existence.
-  bool hasDataWithNameInternally(absl::string_view data_name) const;
-  enum class ParentAccessMode { ReadOnly, ReadWrite };
-  void maybeCreateParent(ParentAccessMode parent_access_mode);
-
   struct FilterObject {
+    std::string name_;
     std::shared_ptr<Object> data_;
     FilterState::StateType state_type_;
   };
 
+  // Most streams only set a handful of objects, which are looked up linearly. Beyond this many
+  // objects, they're looked up through an index by name.
+  static constexpr size_t MaxLinearLookups = 8;
+
+  // This only checks the local data_storage_ for data_name existence.
+  bool hasDataWithNameInternally(absl::string_view data_name) const;
+  // This only looks up the local data_storage_, returning nullptr if there is no such object.
+  const FilterObject* findInternally(absl::string_view data_name) const;
+  FilterObject* findInternally(absl::string_view data_name) {
+    return const_cast<FilterObject*>(
+        static_cast<const FilterStateImpl*>(this)->findInternally(data_name));
+  }
+  enum class ParentAccessMode { ReadOnly, ReadWrite };
+  void maybeCreateParent(ParentAccessMode parent_access_mode);
+
   absl::variant<FilterStateSharedPtr, LazyCreateAncestor> ancestor_;
   FilterStateSharedPtr parent_;
   const FilterState::LifeSpan life_span_;
-  absl::flat_hash_map<std::string, std::unique_ptr<FilterObject>> data_storage_;
+  // The objects in the order they were first set, which are never removed.
+  absl::InlinedVector<FilterObject, 2> data_storage_;
+  // The positions of the objects in data_storage_ by name, once there are more than
+  // MaxLinearLookups objects.
+  absl::flat_hash_map<std::string, size_t> data_index_;
 };
 
 } // namespace StreamInfo
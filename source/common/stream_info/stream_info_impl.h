@@ -2,6 +2,8 @@
 
 #include <chrono>
 #include <cstdint>
+#include <memory>
+#include <string>
 
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
@@ -13,6 +15,7 @@
 
 #include "common/common/assert.h"
 #include "common/common/dump_state_utils.h"
+#include "common/common/empty_string.h"
 #include "common/common/macros.h"
 #include "common/network/socket_impl.h"
 #include "common/stream_info/filter_state_impl.h"
@@ -145,11 +148,12 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   const absl::optional<std::string>& connectionTerminationDetails() const override {
-    return connection_termination_details_;
+    return rare_fields_ != nullptr ? rare_fields_->connection_termination_details_
+                                   : emptyConnectionTerminationDetails();
   }
 
   void setConnectionTerminationDetails(absl::string_view connection_termination_details) override {
-    connection_termination_details_.emplace(connection_termination_details);
+    rareFields().connection_termination_details_.emplace(connection_termination_details);
   }
 
   void addBytesSent(uint64_t bytes_sent) override { bytes_sent_ += bytes_sent; }
@@ -223,6 +227,19 @@ struct StreamInfoImpl : public StreamInfo {
     (*metadata_.mutable_filter_metadata())[name].MergeFrom(value);
   };
 
+  void setDynamicMetadata(const std::string& name, ProtobufWkt::Struct&& value) override {
+    ProtobufWkt::Struct& existing = (*metadata_.mutable_filter_metadata())[name];
+    if (existing.fields().empty()) {
+      existing.Swap(&value);
+      return;
+    }
+    // Like MergeFrom(), the new values replace the existing values of the same keys.
+    auto& fields = *existing.mutable_fields();
+    for (auto& field : *value.mutable_fields()) {
+      fields[field.first].Swap(&field.second);
+    }
+  };
+
   const FilterStateSharedPtr& filterState() override { return filter_state_; }
   const FilterState& filterState() const override { return *filter_state_; }
 
@@ -234,17 +251,23 @@ struct StreamInfoImpl : public StreamInfo {
   }
 
   void setRequestedServerName(absl::string_view requested_server_name) override {
-    requested_server_name_ = std::string(requested_server_name);
+    // Most connections don't have a server name, which is set on each of their streams.
+    if (rare_fields_ != nullptr || !requested_server_name.empty()) {
+      rareFields().requested_server_name_ = std::string(requested_server_name);
+    }
   }
 
-  const std::string& requestedServerName() const override { return requested_server_name_; }
+  const std::string& requestedServerName() const override {
+    return rare_fields_ != nullptr ? rare_fields_->requested_server_name_ : EMPTY_STRING;
+  }
 
   void setUpstreamTransportFailureReason(absl::string_view failure_reason) override {
-    upstream_transport_failure_reason_ = std::string(failure_reason);
+    rareFields().upstream_transport_failure_reason_ = std::string(failure_reason);
   }
 
   const std::string& upstreamTransportFailureReason() const override {
-    return upstream_transport_failure_reason_;
+    return rare_fields_ != nullptr ? rare_fields_->upstream_transport_failure_reason_
+                                   : EMPTY_STRING;
   }
 
   void setRequestHeaders(const Http::RequestHeaderMap& headers) override {
@@ -285,10 +308,12 @@ struct StreamInfoImpl : public StreamInfo {
   absl::optional<uint64_t> connectionID() const override { return connection_id_; }
 
   void setFilterChainName(absl::string_view filter_chain_name) override {
-    filter_chain_name_ = filter_chain_name;
+    rareFields().filter_chain_name_ = std::string(filter_chain_name);
   }
 
-  const std::string& filterChainName() const override { return filter_chain_name_; }
+  const std::string& filterChainName() const override {
+    return rare_fields_ != nullptr ? rare_fields_->filter_chain_name_ : EMPTY_STRING;
+  }
 
   TimeSource& time_source_;
   const SystemTime start_time_;
@@ -302,7 +327,6 @@ struct StreamInfoImpl : public StreamInfo {
   absl::optional<Http::Protocol> protocol_;
   absl::optional<uint32_t> response_code_;
   absl::optional<std::string> response_code_details_;
-  absl::optional<std::string> connection_termination_details_;
   uint64_t response_flags_{};
   Upstream::HostDescriptionConstSharedPtr upstream_host_{};
   bool health_check_request_{};
@@ -336,15 +360,33 @@ private:
   const Network::SocketAddressProviderSharedPtr downstream_address_provider_;
   Ssl::ConnectionInfoConstSharedPtr downstream_ssl_info_;
   Ssl::ConnectionInfoConstSharedPtr upstream_ssl_info_;
-  std::string requested_server_name_;
   const Http::RequestHeaderMap* request_headers_{};
   Http::RequestIdStreamInfoProviderSharedPtr request_id_provider_;
   UpstreamTiming upstream_timing_;
-  std::string upstream_transport_failure_reason_;
   absl::optional<Upstream::ClusterInfoConstSharedPtr> upstream_cluster_info_;
   absl::optional<uint64_t> connection_id_;
-  std::string filter_chain_name_;
   Tracing::Reason trace_reason_;
+
+  // The fields that few streams set, allocated the first time one of them is set.
+  struct RareFields {
+    absl::optional<std::string> connection_termination_details_;
+    std::string requested_server_name_;
+    std::string upstream_transport_failure_reason_;
+    std::string filter_chain_name_;
+  };
+
+  RareFields& rareFields() {
+    if (rare_fields_ == nullptr) {
+      rare_fields_ = std::make_unique<RareFields>();
+    }
+    return *rare_fields_;
+  }
+
+  static const absl::optional<std::string>& emptyConnectionTerminationDetails() {
+    CONSTRUCT_ON_FIRST_USE(absl::optional<std::string>);
+  }
+
+  std::unique_ptr<RareFields> rare_fields_;
 };
 
 } // namespace StreamInfo
@@ -321,6 +321,7 @@ OriginalConnPoolImpl::ConnectionWrapper::ConnectionWrapper(ActiveConn& parent) :
   parent_.parent_.host_->cluster().stats().upstream_rq_active_.inc();
   parent_.parent_.host_->stats().rq_total_.inc();
   parent_.parent_.host_->stats().rq_active_.inc();
+  parent_.parent_.host_->cluster().loadReportHosts().add(parent_.parent_.host_);
 }
 
 Network::ClientConnection& OriginalConnPoolImpl::ConnectionWrapper::connection() {
@@ -128,10 +128,16 @@ Config::SharedConfig::SharedConfig(
 Config::Config(const envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy& config,
                Server::Configuration::FactoryContext& context)
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
+      reuse_upstream_connections_(config.reuse_upstream_connections()),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
       random_generator_(context.api().randomGenerator()) {
 
+  if (reuse_upstream_connections_ && config.has_tunneling_config()) {
+    throw EnvoyException(
+        "tcp_proxy: reuse_upstream_connections can't be used with tunneling_config");
+  }
+
   upstream_drain_manager_slot_->set([](Event::Dispatcher&) {
     ThreadLocal::ThreadLocalObjectSharedPtr drain_manager =
         std::make_shared<UpstreamDrainManager>();
@@ -360,12 +366,15 @@ void Filter::UpstreamCallbacks::onUpstreamData(Buffer::Instance& data, bool end_
   }
 }
 
-void Filter::UpstreamCallbacks::onBytesSent() {
-  if (drainer_ == nullptr) {
+bool Filter::UpstreamCallbacks::onBytesSent() {
+  if (drainer_ != nullptr) {
+    drainer_->onBytesSent();
+  } else if (parent_ != nullptr) {
     parent_->resetIdleTimer();
   } else {
-    drainer_->onBytesSent();
+    return false;
   }
+  return true;
 }
 
 void Filter::UpstreamCallbacks::onIdleTimeout() {
@@ -569,13 +578,18 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
   ENVOY_CONN_LOG(trace, "downstream connection received {} bytes, end_stream={}",
                  read_callbacks_->connection(), data.length(), end_stream);
   if (upstream_) {
+    if (end_stream && config_->reuseUpstreamConnections()) {
+      upstream_->encodeData(data, false);
+      endSession();
+      return Network::FilterStatus::StopIteration;
+    }
     upstream_->encodeData(data, end_stream);
   }
   // The upstream should consume all of the data.
   // Before there is an upstream the connection should be readDisabled. If the upstream is
   // destroyed, there should be no further reads as well.
   ASSERT(0 == data.length());
-  resetIdleTimer(); // TODO(ggreenway) PERF: do we need to reset timer on both send and receive?
+  resetIdleTimer();
   return Network::FilterStatus::StopIteration;
 }
 
@@ -593,6 +607,10 @@ void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
     Tcp::ConnectionPool::ConnectionDataPtr conn_data(upstream_->onDownstreamEvent(event));
     if (conn_data != nullptr &&
         conn_data->connection().state() != Network::Connection::State::Closed) {
+      if (idle_timer_ != nullptr) {
+        // The drainer expects the timer to fire at the idle timeout.
+        idle_timer_->enableTimer(idleTimeRemaining());
+      }
       config_->drainManager().add(config_->sharedConfig(), std::move(conn_data),
                                   std::move(upstream_callbacks_), std::move(idle_timer_),
                                   read_callbacks_->upstreamHost());
@@ -614,9 +632,25 @@ void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
 void Filter::onUpstreamData(Buffer::Instance& data, bool end_stream) {
   ENVOY_CONN_LOG(trace, "upstream connection received {} bytes, end_stream={}",
                  read_callbacks_->connection(), data.length(), end_stream);
+  upstream_end_stream_ = upstream_end_stream_ || end_stream;
   read_callbacks_->connection().write(data, end_stream);
   ASSERT(0 == data.length());
-  resetIdleTimer(); // TODO(ggreenway) PERF: do we need to reset timer on both send and receive?
+  resetIdleTimer();
+}
+
+void Filter::endSession() {
+  // The end of the downstream connection ends the session, and isn't proxied, for the upstream
+  // connection to be reused by the next session.
+  if (!upstream_end_stream_ && !upstream_callbacks_->on_high_watermark_called_ &&
+      upstream_->releaseForReuse()) {
+    ENVOY_CONN_LOG(debug, "session ended, releasing the upstream connection",
+                   read_callbacks_->connection());
+    upstream_callbacks_->parent_ = nullptr;
+    upstream_.reset();
+    disableIdleTimer();
+  }
+  // Closes the upstream connection too if it wasn't released.
+  read_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
 }
 
 void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
@@ -666,20 +700,26 @@ void Filter::onUpstreamConnection() {
     idle_timer_ = read_callbacks_->connection().dispatcher().createTimer(
         [upstream_callbacks = upstream_callbacks_]() { upstream_callbacks->onIdleTimeout(); });
     resetIdleTimer();
+    idle_timer_->enableTimer(config_->idleTimeout().value());
     read_callbacks_->connection().addBytesSentCallback([this](uint64_t) {
       resetIdleTimer();
       return true;
     });
     if (upstream_) {
       upstream_->addBytesSentCallback([upstream_callbacks = upstream_callbacks_](uint64_t) -> bool {
-        upstream_callbacks->onBytesSent();
-        return true;
+        return upstream_callbacks->onBytesSent();
       });
     }
   }
 }
 
 void Filter::onIdleTimeout() {
+  const std::chrono::milliseconds idle_time_remaining = idleTimeRemaining();
+  if (idle_time_remaining.count() > 0) {
+    idle_timer_->enableTimer(idle_time_remaining);
+    return;
+  }
+
   ENVOY_CONN_LOG(debug, "Session timed out", read_callbacks_->connection());
   config_->stats().idle_timeout_.inc();
 
@@ -697,8 +737,20 @@ void Filter::onMaxDownstreamConnectionDuration() {
 void Filter::resetIdleTimer() {
   if (idle_timer_ != nullptr) {
     ASSERT(config_->idleTimeout());
-    idle_timer_->enableTimer(config_->idleTimeout().value());
+    last_activity_ = read_callbacks_->connection().dispatcher().timeSource().monotonicTime();
+  }
+}
+
+std::chrono::milliseconds Filter::idleTimeRemaining() const {
+  ASSERT(config_->idleTimeout());
+  const std::chrono::milliseconds idle_timeout = config_->idleTimeout().value();
+  const auto idle_time =
+      read_callbacks_->connection().dispatcher().timeSource().monotonicTime() - last_activity_;
+  if (idle_time >= idle_timeout) {
+    return std::chrono::milliseconds(0);
   }
+  // Rounded up, so that the timer doesn't fire again just before the timeout.
+  return std::chrono::ceil<std::chrono::milliseconds>(idle_timeout - idle_time);
 }
 
 void Filter::disableIdleTimer() {
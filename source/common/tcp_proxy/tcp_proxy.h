@@ -144,6 +144,7 @@ public:
   const TcpProxyStats& stats() { return shared_config_->stats(); }
   const std::vector<AccessLog::InstanceSharedPtr>& accessLogs() { return access_logs_; }
   uint32_t maxConnectAttempts() const { return max_connect_attempts_; }
+  bool reuseUpstreamConnections() const { return reuse_upstream_connections_; }
   const absl::optional<std::chrono::milliseconds>& idleTimeout() {
     return shared_config_->idleTimeout();
   }
@@ -213,6 +214,7 @@ private:
   uint64_t total_cluster_weight_;
   std::vector<AccessLog::InstanceSharedPtr> access_logs_;
   const uint32_t max_connect_attempts_;
+  const bool reuse_upstream_connections_;
   ThreadLocal::SlotPtr upstream_drain_manager_slot_;
   SharedConfigSharedPtr shared_config_;
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
@@ -300,7 +302,9 @@ public:
     void onAboveWriteBufferHighWatermark() override;
     void onBelowWriteBufferLowWatermark() override;
 
-    void onBytesSent();
+    // @return false once the session ended, for the callback to be removed from the upstream
+    // connection released to the pool.
+    bool onBytesSent();
     void onIdleTimeout();
     void drain(Drainer& drainer);
 
@@ -359,6 +363,8 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  std::chrono::milliseconds idleTimeRemaining() const;
+  void endSession();
   void onMaxDownstreamConnectionDuration();
 
   const ConfigSharedPtr config_;
@@ -366,7 +372,10 @@ protected:
   Network::ReadFilterCallbacks* read_callbacks_{};
 
   DownstreamCallbacks downstream_callbacks_;
+  // Re-arming the idle timer for each chunk of data would cost more than proxying the chunk, so
+  // the data only records its time, and the timer is re-armed from it when it fires.
   Event::TimerPtr idle_timer_;
+  MonotonicTime last_activity_;
   Event::TimerPtr connection_duration_timer_;
 
   std::shared_ptr<UpstreamCallbacks> upstream_callbacks_; // shared_ptr required for passing as a
@@ -384,6 +393,7 @@ protected:
   Network::Socket::OptionsSharedPtr upstream_options_;
   uint32_t connect_attempts_{};
   bool connecting_{};
+  bool upstream_end_stream_{};
 };
 
 // This class deals with an upstream connection that needs to finish flushing, when the downstream
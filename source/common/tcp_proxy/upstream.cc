@@ -57,6 +57,17 @@ TcpUpstream::onDownstreamEvent(Network::ConnectionEvent event) {
   return nullptr;
 }
 
+bool TcpUpstream::releaseForReuse() {
+  Network::ClientConnection& connection = upstream_conn_data_->connection();
+  // A read disabled connection has data of the session left to proxy.
+  if (connection.state() != Network::Connection::State::Open || !connection.readEnabled()) {
+    return false;
+  }
+  // Destroying the connection data releases the connection to the pool.
+  upstream_conn_data_.reset();
+  return true;
+}
+
 HttpUpstream::HttpUpstream(Tcp::ConnectionPool::UpstreamCallbacks& callbacks,
                            const TunnelingConfig& config)
     : config_(config), response_decoder_(*this), upstream_callbacks_(callbacks) {
@@ -70,6 +70,11 @@ ThreadLocalObjectSharedPtr InstanceImpl::SlotImpl::getWorker(uint32_t index) {
 
 ThreadLocalObjectSharedPtr InstanceImpl::SlotImpl::get() { return getWorker(index_); }
 
+ThreadLocalObject* InstanceImpl::SlotImpl::getPtr() {
+  ASSERT(currentThreadRegisteredWorker(index_));
+  return thread_local_data_.data_[index_].get();
+}
+
 Event::PostCb InstanceImpl::SlotImpl::dataCallback(const UpdateCb& cb) {
   // See the header file comments for still_alive_guard_ for why we capture index_.
   return [still_alive_guard = std::weak_ptr<bool>(still_alive_guard_), cb, index = index_] {
@@ -23,6 +23,8 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
         Config::getAllVersionTypeUrls<envoy::config::endpoint::v3::ClusterLoadAssignment>();
     maybe_resume_eds = cm_.adsMux()->pause(type_urls);
   }
+  // The workers learn about all the clusters of the update at once.
+  ClusterUpdateBatch cluster_update_batch = cm_.batchClusterUpdates();
 
   ENVOY_LOG(info, "{}: add {} cluster(s), remove {} cluster(s)", name_, added_resources.size(),
             removed_resources.size());
@@ -33,14 +35,16 @@ CdsApiHelper::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& adde
   uint32_t added_or_updated = 0;
   uint32_t skipped = 0;
   for (const auto& resource : added_resources) {
-    envoy::config::cluster::v3::Cluster cluster;
+    // The cluster isn't copied, and its hash comes from the decoding, so that unchanged clusters
+    // are skipped cheaply.
+    const auto& cluster =
+        dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
     TRY_ASSERT_MAIN_THREAD {
-      cluster = dynamic_cast<const envoy::config::cluster::v3::Cluster&>(resource.get().resource());
       if (!cluster_names.insert(cluster.name()).second) {
         // NOTE: at this point, the first of these duplicates has already been successfully applied.
         throw EnvoyException(fmt::format("duplicate cluster {} found", cluster.name()));
       }
-      if (cm_.addOrUpdateCluster(cluster, resource.get().version())) {
+      if (cm_.addOrUpdateCluster(cluster, resource.get().version(), resource.get().hash())) {
         any_applied = true;
         ENVOY_LOG(debug, "{}: add/update cluster '{}'", name_, cluster.name());
         ++added_or_updated;
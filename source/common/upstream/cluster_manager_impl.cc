@@ -19,11 +19,13 @@
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/config/new_grpc_mux_impl.h"
 #include "common/config/utility.h"
 #include "common/config/version_converter.h"
 #include "common/config/xds_resource.h"
+#include "common/config/xds_snapshot.h"
 #include "common/grpc/async_client_manager_impl.h"
 #include "common/http/async_client_impl.h"
 #include "common/http/http1/conn_pool.h"
@@ -43,6 +45,7 @@
 #include "common/upstream/priority_conn_pool_map_impl.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/subset_lb.h"
+#include "common/version/version.h"
 
 #ifdef ENVOY_ENABLE_QUIC
 #include "common/http/http3/conn_pool.h"
@@ -59,6 +62,37 @@ void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
   }
 }
 
+HostVector hostsMatching(const HostVector& hosts,
+                         const std::function<bool(const Host&)>& predicate) {
+  HostVector matching;
+  for (const HostSharedPtr& host : hosts) {
+    if (predicate(*host)) {
+      matching.push_back(host);
+    }
+  }
+  return matching;
+}
+
+PrioritySet::UpdateHostsParams
+filterUpdateHostsParams(const PrioritySet::UpdateHostsParams& params,
+                        const std::function<bool(const Host&)>& predicate) {
+  const auto per_locality = [&predicate](const HostsPerLocalityConstSharedPtr& hosts) {
+    return hosts->filter({predicate})[0];
+  };
+  return HostSetImpl::updateHostsParams(
+      std::make_shared<const HostVector>(hostsMatching(*params.hosts, predicate)),
+      per_locality(params.hosts_per_locality),
+      std::make_shared<const HealthyHostVector>(
+          hostsMatching(params.healthy_hosts->get(), predicate)),
+      per_locality(params.healthy_hosts_per_locality),
+      std::make_shared<const DegradedHostVector>(
+          hostsMatching(params.degraded_hosts->get(), predicate)),
+      per_locality(params.degraded_hosts_per_locality),
+      std::make_shared<const ExcludedHostVector>(
+          hostsMatching(params.excluded_hosts->get(), predicate)),
+      per_locality(params.excluded_hosts_per_locality));
+}
+
 } // namespace
 
 void ClusterManagerInitHelper::addCluster(ClusterManagerCluster& cm_cluster) {
@@ -266,10 +300,13 @@ ClusterManagerImpl::ClusterManagerImpl(
       cluster_circuit_breakers_stat_names_(stats.symbolTable()),
       cluster_request_response_size_stat_names_(stats.symbolTable()),
       cluster_timeout_budget_stat_names_(stats.symbolTable()),
+      deferred_cluster_stats_(bootstrap.cluster_manager().enable_deferred_cluster_stats()),
+      deferred_load_balancers_(bootstrap.cluster_manager().enable_deferred_load_balancers()),
       subscription_factory_(local_info, main_thread_dispatcher, *this,
                             validation_context.dynamicValidationVisitor(), api) {
   async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
-      *this, tls, time_source_, api, grpc_context.statNames());
+      *this, tls, time_source_, api, grpc_context.statNames(),
+      bootstrap.google_grpc_completion_threads());
   const auto& cm_config = bootstrap.cluster_manager();
   if (cm_config.has_outlier_detection()) {
     const std::string event_log_file_path = cm_config.outlier_detection().event_log_path();
@@ -337,12 +374,13 @@ ClusterManagerImpl::ClusterManagerImpl(
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
           Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()), local_info);
     } else {
-      ads_mux_ = std::make_shared<Config::GrpcMuxImpl>(
+      auto grpc_mux = std::make_shared<Config::GrpcMuxImpl>(
           local_info,
           Config::Utility::factoryForGrpcApiConfigSource(*async_client_manager_,
                                                          dyn_resources.ads_config(), stats, false)
               ->create(),
           main_thread_dispatcher,
+          api.threadFactory(),
           *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
               Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()) ==
                       envoy::config::core::v3::ApiVersion::V3
@@ -355,6 +393,12 @@ ClusterManagerImpl::ClusterManagerImpl(
           Config::Utility::getAndCheckTransportVersion(dyn_resources.ads_config()), random_, stats_,
           Envoy::Config::Utility::parseRateLimitSettings(dyn_resources.ads_config()),
           bootstrap.dynamic_resources().ads_config().set_node_on_first_message_only());
+      if (!dyn_resources.ads_snapshot_path().empty()) {
+        grpc_mux->setSnapshot(std::make_unique<Config::XdsSnapshot>(
+            dyn_resources.ads_snapshot_path(), VersionInfo::version(), main_thread_dispatcher,
+            api.fileSystem()));
+      }
+      ads_mux_ = std::move(grpc_mux);
     }
   } else {
     ads_mux_ = std::make_unique<Config::NullGrpcMuxImpl>();
@@ -389,7 +433,8 @@ ClusterManagerImpl::ClusterManagerImpl(
   // Once the initial set of static bootstrap clusters are created (including the local cluster),
   // we can instantiate the thread local cluster manager.
   tls_.set([this, local_cluster_params](Event::Dispatcher& dispatcher) {
-    return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_params);
+    return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_params,
+                                                           next_thread_index_++);
   });
 
   // We can now potentially create the CDS API once the backing cluster exists.
@@ -615,6 +660,12 @@ void ClusterManagerImpl::applyUpdates(ClusterManagerCluster& cluster, uint32_t p
 
 bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                                             const std::string& version_info) {
+  return addOrUpdateCluster(cluster, version_info, MessageUtil::hash(cluster));
+}
+
+bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                                            const std::string& version_info,
+                                            uint64_t new_hash) {
   // First we need to see if this new config is new or an update to an existing dynamic cluster.
   // We don't allow updates to statically configured clusters in the main configuration. We check
   // both the warming clusters and the active clusters to see if we need an update or the update
@@ -622,7 +673,6 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::config::cluster::v3::Cl
   const std::string& cluster_name = cluster.name();
   const auto existing_active_cluster = active_clusters_.find(cluster_name);
   const auto existing_warming_cluster = warming_clusters_.find(cluster_name);
-  const uint64_t new_hash = MessageUtil::hash(cluster);
   if (existing_warming_cluster != warming_clusters_.end()) {
     // If the cluster is the same as the warming cluster of the same name, block the update.
     if (existing_warming_cluster->second->blockUpdate(new_hash)) {
@@ -703,6 +753,7 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
     active_clusters_.erase(existing_active_cluster);
 
     ENVOY_LOG(debug, "removing cluster {}", cluster_name);
+    flushClusterUpdates();
     tls_.runOnAllThreads([cluster_name](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
       ASSERT(cluster_manager->thread_local_clusters_.count(cluster_name) == 1);
       ENVOY_LOG(debug, "removing TLS cluster {}", cluster_name);
@@ -930,6 +981,7 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
 
 void ClusterManagerImpl::postThreadLocalDrainConnections(const Cluster& cluster,
                                                          const HostVector& hosts_removed) {
+  flushClusterUpdates();
   tls_.runOnAllThreads([name = cluster.info()->name(),
                         hosts_removed](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
     cluster_manager->removeHosts(name, hosts_removed);
@@ -947,6 +999,8 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
   LoadBalancerFactorySharedPtr load_balancer_factory;
   if (add_or_update_cluster) {
     load_balancer_factory = cm_cluster.loadBalancerFactory();
+    // The workers waiting for the cluster are notified once they have it.
+    cluster_discovery_timers_.erase(cm_cluster.cluster().info()->name());
   }
 
   for (auto& per_priority : params.per_priority_update_params_) {
@@ -957,38 +1011,117 @@ void ClusterManagerImpl::postThreadLocalClusterUpdate(ClusterManagerCluster& cm_
     per_priority.overprovisioning_factor_ = host_set->overprovisioningFactor();
   }
 
+  ThreadLocalClusterUpdate update{cm_cluster.cluster().info(), std::move(params),
+                                  add_or_update_cluster, load_balancer_factory};
+  if (cluster_update_batch_depth_ > 0) {
+    batched_cluster_updates_.push_back(std::move(update));
+    return;
+  }
+
   tls_.runOnAllThreads(
-      [info = cm_cluster.cluster().info(), params = std::move(params), add_or_update_cluster,
-       load_balancer_factory](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
-        ThreadLocalClusterManagerImpl::ClusterEntry* new_cluster = nullptr;
-        if (add_or_update_cluster) {
-          if (cluster_manager->thread_local_clusters_.count(info->name()) > 0) {
-            ENVOY_LOG(debug, "updating TLS cluster {}", info->name());
-          } else {
-            ENVOY_LOG(debug, "adding TLS cluster {}", info->name());
-          }
+      [update = std::move(update)](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+        cluster_manager->applyClusterUpdate(update);
+      });
+}
 
-          new_cluster = new ThreadLocalClusterManagerImpl::ClusterEntry(*cluster_manager, info,
-                                                                        load_balancer_factory);
-          cluster_manager->thread_local_clusters_[info->name()].reset(new_cluster);
-        }
+ClusterUpdateBatch ClusterManagerImpl::batchClusterUpdates() {
+  cluster_update_batch_depth_++;
+  return std::make_unique<Cleanup>([this] {
+    ASSERT(cluster_update_batch_depth_ > 0);
+    if (--cluster_update_batch_depth_ == 0) {
+      flushClusterUpdates();
+    }
+  });
+}
 
-        for (const auto& per_priority : params.per_priority_update_params_) {
-          cluster_manager->updateClusterMembership(
-              info->name(), per_priority.priority_, per_priority.update_hosts_params_,
-              per_priority.locality_weights_, per_priority.hosts_added_,
-              per_priority.hosts_removed_, per_priority.overprovisioning_factor_);
-        }
+void ClusterManagerImpl::flushClusterUpdates() {
+  if (batched_cluster_updates_.empty()) {
+    return;
+  }
 
-        if (new_cluster != nullptr) {
-          for (auto& cb : cluster_manager->update_callbacks_) {
-            cb->onClusterAddOrUpdate(*new_cluster);
-          }
-        }
+  ENVOY_LOG(debug, "posting {} batched TLS cluster update(s)", batched_cluster_updates_.size());
+  // A single post per batch, rather than one per cluster, as each post wakes up every worker.
+  auto updates = std::make_shared<const std::vector<ThreadLocalClusterUpdate>>(
+      std::move(batched_cluster_updates_));
+  batched_cluster_updates_.clear();
+  tls_.runOnAllThreads([updates](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+    for (const ThreadLocalClusterUpdate& update : *updates) {
+      cluster_manager->applyClusterUpdate(update);
+    }
+  });
+}
+
+OdCdsApiHandleSharedPtr
+ClusterManagerImpl::allocateOdCdsApi(const envoy::config::core::v3::ConfigSource& odcds_config,
+                                     std::chrono::milliseconds idle_timeout,
+                                     ProtobufMessage::ValidationVisitor& validation_visitor) {
+  auto odcds = std::make_shared<OdCdsApiImpl>(odcds_config, idle_timeout, *this, *this, stats_,
+                                              dispatcher_, validation_visitor);
+  return std::make_shared<OdCdsApiHandleImpl>(*this, std::move(odcds));
+}
+
+ClusterManagerImpl::OdCdsApiHandleImpl::~OdCdsApiHandleImpl() {
+  // The provider may only be destroyed on the main thread.
+  if (!parent_.dispatcher_.isThreadSafe()) {
+    parent_.dispatcher_.post([odcds = std::move(odcds_)] {});
+  }
+}
+
+ClusterDiscoveryCallbackHandlePtr ClusterManagerImpl::requestOnDemandClusterDiscovery(
+    const OdCdsApiImplSharedPtr& odcds, const std::string& name,
+    ClusterDiscoveryCallbackPtr callback, std::chrono::milliseconds timeout) {
+  ThreadLocalClusterManagerImpl& cluster_manager = *tls_;
+  auto handle = std::make_unique<ClusterDiscoveryCallbackHandleImpl>(std::move(callback));
+  auto& callbacks = cluster_manager.pending_cluster_discoveries_[name];
+  const bool discovery_in_progress = !callbacks.empty();
+  callbacks.push_back(handle->callback_);
+  if (!discovery_in_progress) {
+    ENVOY_LOG(debug, "requesting on-demand discovery of cluster {}", name);
+    dispatcher_.post(
+        [this, odcds, name, timeout] { startClusterDiscovery(*odcds, name, timeout); });
+  }
+  return handle;
+}
+
+void ClusterManagerImpl::startClusterDiscovery(OdCdsApiImpl& odcds, const std::string& name,
+                                               std::chrono::milliseconds timeout) {
+  if (cluster_discovery_timers_.contains(name)) {
+    return;
+  }
+  // This call always sets a timeout, so that the workers don't wait forever if a known cluster
+  // isn't posted to them after all.
+  auto timer = dispatcher_.createTimer(
+      [this, name] { finishClusterDiscovery(name, ClusterDiscoveryStatus::Timeout); });
+  timer->enableTimer(timeout);
+  cluster_discovery_timers_.emplace(name, std::move(timer));
+  // The known clusters are posted to the workers once warm, so they don't need to be discovered.
+  if (active_clusters_.find(name) == active_clusters_.end() &&
+      warming_clusters_.find(name) == warming_clusters_.end()) {
+    odcds.updateOnDemand(name);
+  }
+}
+
+void ClusterManagerImpl::finishClusterDiscovery(const std::string& name,
+                                                ClusterDiscoveryStatus status) {
+  // The name might belong to the timer erased here.
+  const std::string cluster_name = name;
+  if (cluster_discovery_timers_.erase(cluster_name) == 0) {
+    return;
+  }
+  ENVOY_LOG(debug, "on-demand discovery of cluster {} finished with status {}", cluster_name,
+            enumToInt(status));
+  tls_.runOnAllThreads(
+      [cluster_name, status](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
+        cluster_manager->processClusterDiscovery(cluster_name, status);
       });
 }
 
+void ClusterManagerImpl::notifyMissingCluster(absl::string_view name) {
+  finishClusterDiscovery(std::string(name), ClusterDiscoveryStatus::Missing);
+}
+
 void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host) {
+  flushClusterUpdates();
   tls_.runOnAllThreads([host](OptRef<ThreadLocalClusterManagerImpl> cluster_manager) {
     cluster_manager->onHostHealthFailure(host);
   });
@@ -996,7 +1129,7 @@ void ClusterManagerImpl::postThreadLocalHealthFailure(const HostSharedPtr& host)
 
 Host::CreateConnectionData ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConn(
     LoadBalancerContext* context) {
-  HostConstSharedPtr logical_host = lb_->chooseHost(context);
+  HostConstSharedPtr logical_host = loadBalancer().chooseHost(context);
   if (logical_host) {
     auto conn_info = logical_host->createConnection(
         parent_.thread_local_dispatcher_, nullptr,
@@ -1060,8 +1193,8 @@ ProtobufTypes::MessagePtr ClusterManagerImpl::dumpClusterConfigs() {
 
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl(
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
-    const absl::optional<LocalClusterParams>& local_cluster_params)
-    : parent_(parent), thread_local_dispatcher_(dispatcher) {
+    const absl::optional<LocalClusterParams>& local_cluster_params, uint32_t thread_index)
+    : parent_(parent), thread_local_dispatcher_(dispatcher), thread_index_(thread_index) {
   // If local cluster is defined then we need to initialize it first.
   if (local_cluster_params.has_value()) {
     const auto& local_cluster_name = local_cluster_params->info_->name();
@@ -1212,6 +1345,52 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeHosts(
   cluster_entry->parent_.drainConnPools(hosts_removed);
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::applyClusterUpdate(
+    const ThreadLocalClusterUpdate& update) {
+  const ClusterInfoConstSharedPtr& info = update.info_;
+  ClusterEntry* new_cluster = nullptr;
+  if (update.add_or_update_cluster_) {
+    if (thread_local_clusters_.count(info->name()) > 0) {
+      ENVOY_LOG(debug, "updating TLS cluster {}", info->name());
+    } else {
+      ENVOY_LOG(debug, "adding TLS cluster {}", info->name());
+    }
+
+    new_cluster = new ClusterEntry(*this, info, update.load_balancer_factory_);
+    thread_local_clusters_[info->name()].reset(new_cluster);
+  }
+
+  for (const auto& per_priority : update.params_.per_priority_update_params_) {
+    updateClusterMembership(info->name(), per_priority.priority_,
+                            per_priority.update_hosts_params_, per_priority.locality_weights_,
+                            per_priority.hosts_added_, per_priority.hosts_removed_,
+                            per_priority.overprovisioning_factor_);
+  }
+
+  if (new_cluster != nullptr) {
+    for (auto& cb : update_callbacks_) {
+      cb->onClusterAddOrUpdate(*new_cluster);
+    }
+    processClusterDiscovery(info->name(), ClusterDiscoveryStatus::Available);
+  }
+}
+
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::processClusterDiscovery(
+    const std::string& name, ClusterDiscoveryStatus status) {
+  auto it = pending_cluster_discoveries_.find(name);
+  if (it == pending_cluster_discoveries_.end()) {
+    return;
+  }
+  // The callbacks may request other discoveries, or cancel the other callbacks.
+  const auto callbacks = std::move(it->second);
+  pending_cluster_discoveries_.erase(it);
+  for (const auto& weak_callback : callbacks) {
+    if (const auto callback = weak_callback.lock()) {
+      (*callback)(status);
+    }
+  }
+}
+
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
     const std::string& name, uint32_t priority, PrioritySet::UpdateHostsParams update_hosts_params,
     LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
@@ -1220,15 +1399,45 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
   const auto& cluster_entry = thread_local_clusters_[name];
   ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
             hosts_added.size(), hosts_removed.size());
+
+  // With worker partitions, this thread only sees the hosts of its own partition. As the
+  // partition of a host never changes, the added and removed hosts can be filtered the same way.
+  // Thread aware load balancers pick from state shared by all the workers, so they are left as is.
+  const uint32_t partitions =
+      cluster_entry->lb_factory_ == nullptr ? cluster_entry->cluster_info_->workerPartitions() : 1;
+  HostVector partition_hosts_added;
+  HostVector partition_hosts_removed;
+  if (partitions > 1) {
+    const std::function<bool(const Host&)> in_partition = [this, partitions](const Host& host) {
+      return inWorkerPartition(host, partitions);
+    };
+    update_hosts_params = filterUpdateHostsParams(update_hosts_params, in_partition);
+    partition_hosts_added = hostsMatching(hosts_added, in_partition);
+    partition_hosts_removed = hostsMatching(hosts_removed, in_partition);
+  }
+  const HostVector& added = partitions > 1 ? partition_hosts_added : hosts_added;
+  const HostVector& removed = partitions > 1 ? partition_hosts_removed : hosts_removed;
+
   cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
-                                           std::move(locality_weights), hosts_added, hosts_removed,
+                                           std::move(locality_weights), added, removed,
                                            overprovisioning_factor);
 
-  // If an LB is thread aware, create a new worker local LB on membership changes.
-  if (cluster_entry->lb_factory_ != nullptr) {
+  // If an LB is thread aware, create a new worker local LB on membership changes. A deferred LB
+  // that wasn't created yet will see the new membership when it is.
+  if (cluster_entry->lb_factory_ != nullptr && cluster_entry->lb_ != nullptr) {
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
+
+  if (cluster_entry->cluster_info_->prewarmHosts()) {
+    cluster_entry->prewarmHosts(added);
+  }
+}
+
+bool ClusterManagerImpl::ThreadLocalClusterManagerImpl::inWorkerPartition(
+    const Host& host, uint32_t partitions) const {
+  return HashUtil::xxHash64(host.address()->asStringView()) % partitions ==
+         thread_index_ % partitions;
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::onHostHealthFailure(
@@ -1316,13 +1525,19 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
                          Router::ShadowWriterPtr{new Router::ShadowWriterImpl(parent.parent_)},
                          parent_.parent_.http_context_, parent_.parent_.router_context_) {
   priority_set_.getOrCreateHostSet(0);
+  if (!parent.parent_.deferred_load_balancers_) {
+    createLoadBalancer();
+  }
+}
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::createLoadBalancer() {
+  const ClusterInfoConstSharedPtr& cluster = cluster_info_;
   // TODO(mattklein123): Consider converting other LBs over to thread local. All of them could
   // benefit given the healthy panic, locality, and priority calculations that take place.
   if (cluster->lbSubsetInfo().isEnabled()) {
     lb_ = std::make_unique<SubsetLoadBalancer>(
         cluster->lbType(), priority_set_, parent_.local_priority_set_, cluster->stats(),
-        cluster->statsScope(), parent.parent_.runtime_, parent.parent_.random_,
+        cluster->statsScope(), parent_.parent_.runtime_, parent_.parent_.random_,
         cluster->lbSubsetInfo(), cluster->lbRingHashConfig(), cluster->lbMaglevConfig(),
         cluster->lbLeastRequestConfig(), cluster->lbConfig());
   } else {
@@ -1330,22 +1545,29 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
     case LoadBalancerType::LeastRequest: {
       ASSERT(lb_factory_ == nullptr);
       lb_ = std::make_unique<LeastRequestLoadBalancer>(
-          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
-          parent.parent_.random_, cluster->lbConfig(), cluster->lbLeastRequestConfig());
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent_.parent_.runtime_,
+          parent_.parent_.random_, cluster->lbConfig(), cluster->lbLeastRequestConfig());
       break;
     }
     case LoadBalancerType::Random: {
       ASSERT(lb_factory_ == nullptr);
       lb_ = std::make_unique<RandomLoadBalancer>(priority_set_, parent_.local_priority_set_,
-                                                 cluster->stats(), parent.parent_.runtime_,
-                                                 parent.parent_.random_, cluster->lbConfig());
+                                                 cluster->stats(), parent_.parent_.runtime_,
+                                                 parent_.parent_.random_, cluster->lbConfig());
       break;
     }
     case LoadBalancerType::RoundRobin: {
       ASSERT(lb_factory_ == nullptr);
       lb_ = std::make_unique<RoundRobinLoadBalancer>(priority_set_, parent_.local_priority_set_,
-                                                     cluster->stats(), parent.parent_.runtime_,
-                                                     parent.parent_.random_, cluster->lbConfig());
+                                                     cluster->stats(), parent_.parent_.runtime_,
+                                                     parent_.parent_.random_, cluster->lbConfig());
+      break;
+    }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      lb_ = std::make_unique<PeakEwmaLoadBalancer>(priority_set_, parent_.local_priority_set_,
+                                                   cluster->stats(), parent_.parent_.runtime_,
+                                                   parent_.parent_.random_, cluster->lbConfig());
       break;
     }
     case LoadBalancerType::ClusterProvided:
@@ -1360,6 +1582,14 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
   }
 }
 
+LoadBalancer& ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::loadBalancer() {
+  if (lb_ == nullptr) {
+    ENVOY_LOG(debug, "creating deferred local LB for TLS cluster {}", cluster_info_->name());
+    createLoadBalancer();
+  }
+  return *lb_;
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::~ClusterEntry() {
   // We need to drain all connection pools for the cluster being removed. Then we can remove the
   // cluster.
@@ -1376,7 +1606,8 @@ Http::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     ResourcePriority priority, absl::optional<Http::Protocol> downstream_protocol,
     LoadBalancerContext* context, bool peek) {
-  HostConstSharedPtr host = (peek ? lb_->peekAnotherHost(context) : lb_->chooseHost(context));
+  HostConstSharedPtr host = (peek ? loadBalancer().peekAnotherHost(context)
+                                    : loadBalancer().chooseHost(context));
   if (!host) {
     if (!peek) {
       ENVOY_LOG(debug, "no healthy host for HTTP connection pool");
@@ -1385,6 +1616,13 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     return nullptr;
   }
 
+  return connPoolForHost(host, priority, downstream_protocol, context);
+}
+
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPoolForHost(
+    const HostConstSharedPtr& host, ResourcePriority priority,
+    absl::optional<Http::Protocol> downstream_protocol, LoadBalancerContext* context) {
   // Right now, HTTP, HTTP/2 and ALPN pools are considered separate.
   // We could do better here, and always use the ALPN pool and simply make sure
   // we end up on a connection of the correct protocol, but for simplicity we're
@@ -1444,10 +1682,27 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   }
 }
 
+void ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::prewarmHosts(
+    const HostVector& hosts) {
+  for (const HostSharedPtr& host : hosts) {
+    if (host->health() != Host::Health::Healthy) {
+      continue;
+    }
+    // Only the pool for the default protocol without per stream options can be warmed, as the
+    // options of later streams aren't known yet.
+    Http::ConnectionPool::Instance* pool =
+        connPoolForHost(host, ResourcePriority::Default, absl::nullopt, nullptr);
+    if (pool != nullptr) {
+      pool->maybePreconnect(1);
+    }
+  }
+}
+
 Tcp::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
     ResourcePriority priority, LoadBalancerContext* context, bool peek) {
-  HostConstSharedPtr host = (peek ? lb_->peekAnotherHost(context) : lb_->chooseHost(context));
+  HostConstSharedPtr host = (peek ? loadBalancer().peekAnotherHost(context)
+                                    : loadBalancer().chooseHost(context));
   if (!host) {
     if (!peek) {
       ENVOY_LOG(debug, "no healthy host for TCP connection pool");
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <list>
@@ -31,6 +32,7 @@
 #include "common/config/subscription_factory_impl.h"
 #include "common/http/async_client_impl.h"
 #include "common/upstream/load_stats_reporter.h"
+#include "common/upstream/od_cds_api_impl.h"
 #include "common/upstream/priority_conn_pool_map.h"
 #include "common/upstream/upstream_impl.h"
 
@@ -220,7 +222,9 @@ struct ClusterManagerStats {
  * Implementation of ClusterManager that reads from a proto configuration, maintains a central
  * cluster list, as well as thread local caches of each cluster and associated connection pools.
  */
-class ClusterManagerImpl : public ClusterManager, Logger::Loggable<Logger::Id::upstream> {
+class ClusterManagerImpl : public ClusterManager,
+                           public MissingClusterNotifier,
+                           Logger::Loggable<Logger::Id::upstream> {
 public:
   ClusterManagerImpl(const envoy::config::bootstrap::v3::Bootstrap& bootstrap,
                      ClusterManagerFactory& factory, Stats::Store& stats,
@@ -237,6 +241,8 @@ public:
   // Upstream::ClusterManager
   bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
                           const std::string& version_info) override;
+  bool addOrUpdateCluster(const envoy::config::cluster::v3::Cluster& cluster,
+                          const std::string& version_info, uint64_t new_hash) override;
 
   void setPrimaryClustersInitializedCb(PrimaryClustersReadyCallback callback) override {
     init_helper_.setPrimaryClustersInitializedCb(callback);
@@ -268,6 +274,7 @@ public:
     // Make sure we destroy all potential outgoing connections before this returns.
     cds_api_.reset();
     ads_mux_.reset();
+    cluster_discovery_timers_.clear();
     active_clusters_.clear();
     warming_clusters_.clear();
     updateClusterCounts();
@@ -305,6 +312,15 @@ public:
   const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const override {
     return cluster_timeout_budget_stat_names_;
   }
+  bool deferredClusterStats() const override { return deferred_cluster_stats_; }
+  ClusterUpdateBatch batchClusterUpdates() override;
+  OdCdsApiHandleSharedPtr
+  allocateOdCdsApi(const envoy::config::core::v3::ConfigSource& odcds_config,
+                   std::chrono::milliseconds idle_timeout,
+                   ProtobufMessage::ValidationVisitor& validation_visitor) override;
+
+  // Upstream::MissingClusterNotifier
+  void notifyMissingCluster(absl::string_view name) override;
 
 protected:
   virtual void postThreadLocalDrainConnections(const Cluster& cluster,
@@ -335,6 +351,14 @@ protected:
   virtual void postThreadLocalClusterUpdate(ClusterManagerCluster& cm_cluster,
                                             ThreadLocalClusterUpdateParams&& params);
 
+  // An update of a thread local cluster, as posted to the workers.
+  struct ThreadLocalClusterUpdate {
+    ClusterInfoConstSharedPtr info_;
+    ThreadLocalClusterUpdateParams params_;
+    bool add_or_update_cluster_;
+    LoadBalancerFactorySharedPtr load_balancer_factory_;
+  };
+
 private:
   /**
    * Thread local cached cluster data. Each thread local cluster gets updates from the parent
@@ -396,6 +420,13 @@ private:
       Http::ConnectionPool::Instance* connPool(ResourcePriority priority,
                                                absl::optional<Http::Protocol> downstream_protocol,
                                                LoadBalancerContext* context, bool peek);
+      Http::ConnectionPool::Instance*
+      connPoolForHost(const HostConstSharedPtr& host, ResourcePriority priority,
+                      absl::optional<Http::Protocol> downstream_protocol,
+                      LoadBalancerContext* context);
+
+      // Opens a connection to each of the given hosts that is healthy, ahead of any traffic.
+      void prewarmHosts(const HostVector& hosts);
 
       Tcp::ConnectionPool::Instance* tcpConnPool(ResourcePriority priority,
                                                  LoadBalancerContext* context, bool peek);
@@ -403,7 +434,7 @@ private:
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
-      LoadBalancer& loadBalancer() override { return *lb_; }
+      LoadBalancer& loadBalancer() override;
       Http::ConnectionPool::Instance*
       httpConnPool(ResourcePriority priority, absl::optional<Http::Protocol> downstream_protocol,
                    LoadBalancerContext* context) override;
@@ -412,13 +443,15 @@ private:
       Host::CreateConnectionData tcpConn(LoadBalancerContext* context) override;
       Http::AsyncClient& httpAsyncClient() override;
 
+      void createLoadBalancer();
+
       ThreadLocalClusterManagerImpl& parent_;
       PrioritySetImpl priority_set_;
       // LB factory if applicable. Not all load balancer types have a factory. LB types that have
       // a factory will create a new LB on every membership update. LB types that don't have a
       // factory will create an LB on construction and use it forever.
       LoadBalancerFactorySharedPtr lb_factory_;
-      // Current active LB.
+      // Current active LB. With deferred load balancers, this is only created on first use.
       LoadBalancerPtr lb_;
       ClusterInfoConstSharedPtr cluster_info_;
       Http::AsyncClientImpl http_async_client_;
@@ -432,7 +465,8 @@ private:
     };
 
     ThreadLocalClusterManagerImpl(ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
-                                  const absl::optional<LocalClusterParams>& local_cluster_params);
+                                  const absl::optional<LocalClusterParams>& local_cluster_params,
+                                  uint32_t thread_index);
     ~ThreadLocalClusterManagerImpl() override;
     void drainConnPools(const HostVector& hosts);
     void drainConnPools(HostSharedPtr old_host, ConnPoolsContainer& container);
@@ -445,13 +479,20 @@ private:
                                  LocalityWeightsConstSharedPtr locality_weights,
                                  const HostVector& hosts_added, const HostVector& hosts_removed,
                                  uint64_t overprovisioning_factor);
+    void applyClusterUpdate(const ThreadLocalClusterUpdate& update);
     void onHostHealthFailure(const HostSharedPtr& host);
+    // Invokes the callbacks waiting for the discovery of the cluster.
+    void processClusterDiscovery(const std::string& name, ClusterDiscoveryStatus status);
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
 
+    // Whether a host is in the worker partition of this thread.
+    bool inWorkerPartition(const Host& host, uint32_t partitions) const;
+
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
+    const uint32_t thread_index_;
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
 
     ClusterConnectivityState cluster_manager_state_;
@@ -463,6 +504,11 @@ private:
     absl::node_hash_map<HostConstSharedPtr, TcpConnectionsMap> host_tcp_conn_map_;
 
     std::list<Envoy::Upstream::ClusterUpdateCallbacks*> update_callbacks_;
+    // The callbacks waiting for the on-demand discovery of a cluster, by cluster name. This thread
+    // only asks the main thread for a cluster when no callback waits for it yet. The callbacks
+    // are owned by their handles, so that deleting a handle cancels its callback.
+    absl::flat_hash_map<std::string, std::vector<std::weak_ptr<ClusterDiscoveryCallback>>>
+        pending_cluster_discoveries_;
     const PrioritySet* local_priority_set_{};
     bool destroying_{};
   };
@@ -512,6 +558,32 @@ private:
         : RaiiListElement<ClusterUpdateCallbacks*>(parent, &cb) {}
   };
 
+  struct ClusterDiscoveryCallbackHandleImpl : public ClusterDiscoveryCallbackHandle {
+    explicit ClusterDiscoveryCallbackHandleImpl(ClusterDiscoveryCallbackPtr callback)
+        : callback_(std::move(callback)) {}
+
+    const std::shared_ptr<ClusterDiscoveryCallback> callback_;
+  };
+
+  class OdCdsApiHandleImpl : public OdCdsApiHandle {
+  public:
+    OdCdsApiHandleImpl(ClusterManagerImpl& parent, OdCdsApiImplSharedPtr odcds)
+        : parent_(parent), odcds_(std::move(odcds)) {}
+    ~OdCdsApiHandleImpl() override;
+
+    // Upstream::OdCdsApiHandle
+    ClusterDiscoveryCallbackHandlePtr
+    requestOnDemandClusterDiscovery(const std::string& name, ClusterDiscoveryCallbackPtr callback,
+                                    std::chrono::milliseconds timeout) override {
+      return parent_.requestOnDemandClusterDiscovery(odcds_, name, std::move(callback), timeout);
+    }
+
+  private:
+    ClusterManagerImpl& parent_;
+    // The provider is shared with the discoveries posted to the main thread.
+    OdCdsApiImplSharedPtr odcds_;
+  };
+
   using ClusterDataPtr = std::unique_ptr<ClusterData>;
   // This map is ordered so that config dumping is consistent.
   using ClusterMap = std::map<std::string, ClusterDataPtr>;
@@ -568,8 +640,20 @@ private:
                              bool added_via_api, ClusterMap& cluster_map);
   void onClusterInit(ClusterManagerCluster& cluster);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
+  // Posts the batched thread local cluster updates, so that the updates that follow them are
+  // applied in order.
+  void flushClusterUpdates();
   void updateClusterCounts();
   void clusterWarmingToActive(const std::string& cluster_name);
+  ClusterDiscoveryCallbackHandlePtr
+  requestOnDemandClusterDiscovery(const OdCdsApiImplSharedPtr& odcds, const std::string& name,
+                                  ClusterDiscoveryCallbackPtr callback,
+                                  std::chrono::milliseconds timeout);
+  // Starts discovering the cluster on behalf of a worker, unless another worker already did.
+  void startClusterDiscovery(OdCdsApiImpl& odcds, const std::string& name,
+                             std::chrono::milliseconds timeout);
+  // Ends the discovery of the cluster, notifying the workers that wait for it.
+  void finishClusterDiscovery(const std::string& name, ClusterDiscoveryStatus status);
   static void maybePreconnect(ThreadLocalClusterManagerImpl::ClusterEntry& cluster_entry,
                               const ClusterConnectivityState& cluster_manager_state,
                               std::function<ConnectionPool::Instance*()> preconnect_pool);
@@ -578,6 +662,8 @@ private:
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
   ThreadLocal::TypedSlot<ThreadLocalClusterManagerImpl> tls_;
+  // Hands out the index of each thread local cluster manager, which picks its worker partition.
+  std::atomic<uint32_t> next_thread_index_{0};
   Random::RandomGenerator& random_;
 
 protected:
@@ -609,6 +695,13 @@ private:
   ClusterCircuitBreakersStatNames cluster_circuit_breakers_stat_names_;
   ClusterRequestResponseSizeStatNames cluster_request_response_size_stat_names_;
   ClusterTimeoutBudgetStatNames cluster_timeout_budget_stat_names_;
+  const bool deferred_cluster_stats_;
+  const bool deferred_load_balancers_;
+  // The thread local cluster updates held back by the open batches, in order.
+  std::vector<ThreadLocalClusterUpdate> batched_cluster_updates_;
+  uint32_t cluster_update_batch_depth_{};
+  // The timeouts of the on-demand cluster discoveries in progress, by cluster name.
+  absl::flat_hash_map<std::string, Event::TimerPtr> cluster_discovery_timers_;
 
   Config::SubscriptionFactoryImpl subscription_factory_;
   ClusterSet primary_clusters_;
@@ -1,7 +1,11 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <iostream>
-#include <queue>
+#include <list>
+#include <memory>
+#include <vector>
 
 #include "common/common/assert.h"
 
@@ -33,14 +37,12 @@ public:
   // return the second item which will be picked. As picks occur, that window
   // will shrink.
   std::shared_ptr<C> peekAgain(std::function<double(const C&)> calculate_weight) {
-    if (hasEntry()) {
-      prepick_list_.push_back(std::move(queue_.top().entry_));
-      std::shared_ptr<C> ret{prepick_list_.back()};
-      add(calculate_weight(*ret), ret);
-      queue_.pop();
-      return ret;
+    std::shared_ptr<C> ret = popEarliest();
+    if (ret != nullptr) {
+      prepick_list_.push_back(ret);
+      pushPopped(calculate_weight(*ret));
     }
-    return nullptr;
+    return ret;
   }
 
   /**
@@ -51,21 +53,17 @@ public:
   std::shared_ptr<C> pickAndAdd(std::function<double(const C&)> calculate_weight) {
     while (!prepick_list_.empty()) {
       // In this case the entry was added back during peekAgain so don't re-add.
-      if (prepick_list_.front().expired()) {
-        prepick_list_.pop_front();
-        continue;
-      }
-      std::shared_ptr<C> ret{prepick_list_.front()};
+      std::shared_ptr<C> ret = prepick_list_.front().lock();
       prepick_list_.pop_front();
-      return ret;
+      if (ret != nullptr) {
+        return ret;
+      }
     }
-    if (hasEntry()) {
-      std::shared_ptr<C> ret{queue_.top().entry_};
-      queue_.pop();
-      add(calculate_weight(*ret), ret);
-      return ret;
+    std::shared_ptr<C> ret = popEarliest();
+    if (ret != nullptr) {
+      pushPopped(calculate_weight(*ret));
     }
-    return nullptr;
+    return ret;
   }
 
   /**
@@ -78,8 +76,9 @@ public:
     const double deadline = current_time_ + 1.0 / weight;
     EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
               static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
-    ASSERT(queue_.top().deadline_ >= current_time_);
+    queue_.push_back({deadline, order_offset_++, entry});
+    std::push_heap(queue_.begin(), queue_.end());
+    ASSERT(queue_.front().deadline_ >= current_time_);
   }
 
   /**
@@ -90,28 +89,43 @@ public:
 
 private:
   /**
-   * Clears expired entries, and returns true if there's still entries in the queue.
+   * Moves the entry with the earliest deadline that hasn't expired to the back of queue_, outside
+   * of the heap, discarding expired entries on the way, and advances current_time_ to its
+   * deadline. The caller must either push the entry back with pushPopped() or remove it.
+   * @return std::shared_ptr<C> to the entry, or nullptr if the queue has no entries left.
    */
-  bool hasEntry() {
+  std::shared_ptr<C> popEarliest() {
     EDF_TRACE("Queue pick: queue_.size()={}, current_time_={}.", queue_.size(), current_time_);
-    while (true) {
-      if (queue_.empty()) {
-        EDF_TRACE("Queue is empty.");
-        return false;
-      }
-      const EdfEntry& edf_entry = queue_.top();
-      // Entry has been removed, let's see if there's another one.
-      if (edf_entry.entry_.expired()) {
+    while (!queue_.empty()) {
+      std::pop_heap(queue_.begin(), queue_.end());
+      const EdfEntry& edf_entry = queue_.back();
+      std::shared_ptr<C> ret = edf_entry.entry_.lock();
+      if (ret == nullptr) {
         EDF_TRACE("Entry has expired, repick.");
-        queue_.pop();
+        queue_.pop_back();
         continue;
       }
-      std::shared_ptr<C> ret{edf_entry.entry_};
       ASSERT(edf_entry.deadline_ >= current_time_);
       current_time_ = edf_entry.deadline_;
       EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
-      return true;
+      return ret;
     }
+    EDF_TRACE("Queue is empty.");
+    return nullptr;
+  }
+
+  /**
+   * Reinserts the entry left at the back of queue_ by popEarliest() with a new deadline. This
+   * reuses the entry's weak reference rather than taking a new one.
+   * @param weight floating point weight.
+   */
+  void pushPopped(double weight) {
+    ASSERT(weight > 0);
+    EdfEntry& edf_entry = queue_.back();
+    edf_entry.deadline_ = current_time_ + 1.0 / weight;
+    edf_entry.order_offset_ = order_offset_++;
+    EDF_TRACE("Reinsertion in queue with deadline {} and weight {}.", edf_entry.deadline_, weight);
+    std::push_heap(queue_.begin(), queue_.end());
   }
 
   struct EdfEntry {
@@ -122,7 +136,7 @@ private:
     // be lazily unloaded from the queue.
     std::weak_ptr<C> entry_;
 
-    // Flip < direction to make this a min queue.
+    // Flip < direction to make the std::push_heap() max-heap a min-heap.
     bool operator<(const EdfEntry& other) const {
       return deadline_ > other.deadline_ ||
              (deadline_ == other.deadline_ && order_offset_ > other.order_offset_);
@@ -136,8 +150,10 @@ private:
   // Offset used during addition to break ties when entries have the same weight but should reflect
   // FIFO insertion order in picks.
   uint64_t order_offset_{};
-  // Min priority queue for EDF.
-  std::priority_queue<EdfEntry> queue_;
+  // Min heap of entries ordered by deadline, maintained with std::push_heap() and std::pop_heap().
+  // Unlike std::priority_queue, this lets a picked entry be moved out of the heap and back in
+  // without copying its weak pointer.
+  std::vector<EdfEntry> queue_;
   std::list<std::weak_ptr<C>> prepick_list_;
 };
 
@@ -1,10 +1,13 @@
 #include "common/upstream/health_checker_base_impl.h"
 
+#include "envoy/common/exception.h"
 #include "envoy/config/core/v3/address.pb.h"
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/data/core/v3/health_check_event.pb.h"
 #include "envoy/stats/scope.h"
 
+#include "common/common/fmt.h"
+#include "common/common/hash.h"
 #include "common/network/utility.h"
 #include "common/router/router.h"
 
@@ -37,12 +40,19 @@ HealthCheckerImplBase::HealthCheckerImplBase(const Cluster& cluster,
           PROTOBUF_GET_MS_OR_DEFAULT(config, unhealthy_edge_interval, unhealthy_interval_.count())),
       healthy_edge_interval_(
           PROTOBUF_GET_MS_OR_DEFAULT(config, healthy_edge_interval, interval_.count())),
+      shard_count_(config.fleet_sharding().shard_count()),
+      shard_index_(config.fleet_sharding().shard_index()),
       transport_socket_options_(initTransportSocketOptions(config)),
       transport_socket_match_metadata_(initTransportSocketMatchMetadata(config)),
       member_update_cb_{cluster_.prioritySet().addMemberUpdateCb(
           [this](const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
             onClusterMemberUpdate(hosts_added, hosts_removed);
-          })} {}
+          })} {
+  if (config.has_fleet_sharding() && shard_index_ >= shard_count_) {
+    throw EnvoyException(fmt::format("health check shard_index {} must be smaller than {}",
+                                     shard_index_, shard_count_));
+  }
+}
 
 std::shared_ptr<const Network::TransportSocketOptionsImpl>
 HealthCheckerImplBase::initTransportSocketOptions(
@@ -93,6 +103,11 @@ void HealthCheckerImplBase::incHealthy() { stats_.healthy_.add(1); }
 
 void HealthCheckerImplBase::incDegraded() { stats_.degraded_.add(1); }
 
+bool HealthCheckerImplBase::inShard(const Host& host) const {
+  return shard_count_ <= 1 ||
+         HashUtil::xxHash64(host.address()->asStringView()) % shard_count_ == shard_index_;
+}
+
 std::chrono::milliseconds HealthCheckerImplBase::interval(HealthState state,
                                                           HealthTransition changed_state) const {
   // See if the cluster has ever made a connection. If not, we use a much slower interval to keep
@@ -211,7 +226,8 @@ void HealthCheckerImplBase::setUnhealthyCrossThread(const HostSharedPtr& host,
     }
 
     const auto session = shared_this->active_sessions_.find(host);
-    if (session == shared_this->active_sessions_.end()) {
+    // The hosts of the other shards are never actively checked, so they wouldn't recover.
+    if (session == shared_this->active_sessions_.end() || !session->second->inShard()) {
       return;
     }
 
@@ -229,7 +245,8 @@ HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
     HealthCheckerImplBase& parent, HostSharedPtr host)
     : host_(host), parent_(parent),
       interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
-      timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })) {
+      timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })),
+      in_shard_(parent.inShard(*host)) {
 
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent.incHealthy();
@@ -400,7 +417,34 @@ HealthCheckerImplBase::ActiveHealthCheckSession::clearPendingFlag(HealthTransiti
   return changed_state;
 }
 
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  if (!in_shard_) {
+    // The host is released from the event loop, as a check result would be, so that the cluster
+    // waits for it to initialize.
+    interval_timer_->enableTimer(std::chrono::milliseconds(0));
+    return;
+  }
+  onInitialInterval();
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::onOtherShardHost() {
+  ENVOY_LOG(debug, "health check of {} is left to another shard", host_->address()->asString());
+  HealthTransition changed_state = HealthTransition::Unchanged;
+  if (host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
+    host_->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+    parent_.incHealthy();
+    changed_state = HealthTransition::Changed;
+  }
+  changed_state = clearPendingFlag(changed_state);
+  first_check_ = false;
+  parent_.runCallbacks(host_, changed_state);
+}
+
 void HealthCheckerImplBase::ActiveHealthCheckSession::onIntervalBase() {
+  if (!in_shard_) {
+    onOtherShardHost();
+    return;
+  }
   onInterval();
   timeout_timer_->enableTimer(parent_.timeout_);
   parent_.stats_.attempt_.inc();
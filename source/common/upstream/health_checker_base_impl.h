@@ -78,7 +78,8 @@ protected:
     ~ActiveHealthCheckSession() override;
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start();
+    bool inShard() const { return in_shard_; }
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -100,6 +101,8 @@ protected:
     void onTimeoutBase();
     virtual void onDeferredDelete() PURE;
     void onInitialInterval();
+    // Marks the host of another shard healthy, as its health comes from its management server.
+    void onOtherShardHost();
 
     HealthCheckerImplBase& parent_;
     Event::TimerPtr interval_timer_;
@@ -107,6 +110,7 @@ protected:
     uint32_t num_unhealthy_{};
     uint32_t num_healthy_{};
     bool first_check_{true};
+    const bool in_shard_;
   };
 
   using ActiveHealthCheckSessionPtr = std::unique_ptr<ActiveHealthCheckSession>;
@@ -150,6 +154,8 @@ private:
   HealthCheckerStats generateStats(Stats::Scope& scope);
   void incHealthy();
   void incDegraded();
+  // Whether the host belongs to the shard of the fleet this Envoy checks.
+  bool inShard(const Host& host) const;
   std::chrono::milliseconds interval(HealthState state, HealthTransition changed_state) const;
   std::chrono::milliseconds intervalWithJitter(uint64_t base_time_ms,
                                                std::chrono::milliseconds interval_jitter) const;
@@ -174,6 +180,9 @@ private:
   const std::chrono::milliseconds unhealthy_interval_;
   const std::chrono::milliseconds unhealthy_edge_interval_;
   const std::chrono::milliseconds healthy_edge_interval_;
+  // The hosts are sharded when shard_count_ is more than 1.
+  const uint32_t shard_count_;
+  const uint32_t shard_index_;
   absl::node_hash_map<HostSharedPtr, ActiveHealthCheckSessionPtr> active_sessions_;
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
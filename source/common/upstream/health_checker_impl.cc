@@ -585,8 +585,9 @@ GrpcHealthCheckerImpl::GrpcHealthCheckerImpl(const Cluster& cluster,
       random_generator_(random),
       service_method_(*Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
           "grpc.health.v1.Health.Check")) {
-  if (!config.grpc_health_check().service_name().empty()) {
-    service_name_ = config.grpc_health_check().service_name();
+  service_names_.push_back(config.grpc_health_check().service_name());
+  for (const std::string& service_name : config.grpc_health_check().additional_service_names()) {
+    service_names_.push_back(service_name);
   }
 
   if (!config.grpc_health_check().authority().empty()) {
@@ -701,6 +702,13 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onEvent(Network::Conne
 }
 
 void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onInterval() {
+  service_index_ = 0;
+  sendRequest();
+}
+
+void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::sendRequest() {
+  // The connection is kept between the services of a host, unless it must be closed after each
+  // check.
   if (!client_) {
     Upstream::Host::CreateConnectionData conn =
         host_->createHealthCheckConnection(parent_.dispatcher_, parent_.transportSocketOptions(),
@@ -735,9 +743,7 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onInterval() {
   ASSERT(status.ok());
 
   grpc::health::v1::HealthCheckRequest request;
-  if (parent_.service_name_.has_value()) {
-    request.set_service(parent_.service_name_.value());
-  }
+  request.set_service(parent_.service_names_[service_index_]);
 
   request_encoder_->encodeData(*Grpc::Common::serializeToGrpcFrame(request), true);
 }
@@ -811,7 +817,13 @@ bool GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::isHealthCheckSucceeded
 void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onRpcComplete(
     Grpc::Status::GrpcStatus grpc_status, const std::string& grpc_message, bool end_stream) {
   logHealthCheckStatus(grpc_status, grpc_message);
-  if (isHealthCheckSucceeded(grpc_status)) {
+  // The host is only reported healthy once all its services were checked.
+  const bool check_next_service = isHealthCheckSucceeded(grpc_status) &&
+                                  service_index_ + 1 < parent_.service_names_.size();
+  if (check_next_service) {
+    ENVOY_CONN_LOG(trace, "hc checking service {} of {}", *client_, service_index_ + 2,
+                   parent_.service_names_.size());
+  } else if (isHealthCheckSucceeded(grpc_status)) {
     handleSuccess(false);
   } else {
     handleFailure(envoy::data::core::v3::ACTIVE);
@@ -833,6 +845,11 @@ void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::onRpcComplete(
   if (!parent_.reuse_connection_ || goaway) {
     client_->close();
   }
+
+  if (check_next_service) {
+    service_index_++;
+    sendRequest();
+  }
 }
 
 void GrpcHealthCheckerImpl::GrpcActiveHealthCheckSession::resetState() {
@@ -316,6 +316,7 @@ private:
     GrpcActiveHealthCheckSession(GrpcHealthCheckerImpl& parent, const HostSharedPtr& host);
     ~GrpcActiveHealthCheckSession() override;
 
+    void sendRequest();
     void onRpcComplete(Grpc::Status::GrpcStatus grpc_status, const std::string& grpc_message,
                        bool end_stream);
     bool isHealthCheckSucceeded(Grpc::Status::GrpcStatus grpc_status) const;
@@ -385,6 +386,8 @@ private:
     // If true, we received a GOAWAY (NO_ERROR code) and are deferring closing the connection
     // until the active probe completes.
     bool received_no_error_goaway_ = false;
+    // The index in service_names_ of the service checked by the current request.
+    size_t service_index_ = 0;
   };
 
   virtual Http::CodecClientPtr createCodecClient(Upstream::Host::CreateConnectionData& data) PURE;
@@ -402,7 +405,9 @@ protected:
 
 private:
   const Protobuf::MethodDescriptor& service_method_;
-  absl::optional<std::string> service_name_;
+  // The services checked on each host, one after the other. An empty name checks the overall
+  // health of the server.
+  std::vector<std::string> service_names_;
   absl::optional<std::string> authority_value_;
 };
 
@@ -699,13 +699,15 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
     : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                 common_config),
       seed_(random_.random()) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
+  // We fully recompute the schedulers for a given host set on membership change, which is
   // consistent with what other LB implementations do (e.g. thread aware).
   // The downside of a full recompute is that time complexity is O(n * log n),
   // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+  // https://github.com/envoyproxy/envoy/issues/2874). To bound the cost, the recompute is deferred
+  // until the next pick: a burst of updates then costs a single recompute, and the schedulers of
+  // a cluster that isn't used between updates are never rebuilt.
   priority_update_cb_ = priority_set.addPriorityUpdateCb(
-      [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
+      [this](uint32_t priority, const HostVector&, const HostVector&) { markStale(priority); });
 }
 
 void EdfLoadBalancerBase::initialize() {
@@ -714,6 +716,27 @@ void EdfLoadBalancerBase::initialize() {
   }
 }
 
+void EdfLoadBalancerBase::markStale(uint32_t priority) {
+  if (stale_priorities_.size() <= priority) {
+    stale_priorities_.resize(priority + 1, false);
+  }
+  stale_priorities_[priority] = true;
+  has_stale_priorities_ = true;
+}
+
+void EdfLoadBalancerBase::refreshStalePriorities() {
+  if (!has_stale_priorities_) {
+    return;
+  }
+  has_stale_priorities_ = false;
+  for (uint32_t priority = 0; priority < stale_priorities_.size(); ++priority) {
+    if (stale_priorities_[priority]) {
+      stale_priorities_[priority] = false;
+      refresh(priority);
+    }
+  }
+}
+
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
   const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
     // Nuke existing scheduler if it exists.
@@ -779,6 +802,7 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
   if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
     return nullptr;
   }
+  refreshStalePriorities();
 
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(true));
   if (!hosts_source) {
@@ -807,6 +831,7 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
 }
 
 HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* context) {
+  refreshStalePriorities();
   const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random(false));
   if (!hosts_source) {
     return nullptr;
@@ -843,25 +868,20 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPeek(const HostVector
 
 HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector& hosts_to_use,
                                                                 const HostsSource&) {
-  HostSharedPtr candidate_host = nullptr;
-  for (uint32_t choice_idx = 0; choice_idx < choice_count_; ++choice_idx) {
-    const int rand_idx = random_.random() % hosts_to_use.size();
-    HostSharedPtr sampled_host = hosts_to_use[rand_idx];
-
-    if (candidate_host == nullptr) {
-      // Make a first choice to start the comparisons.
-      candidate_host = sampled_host;
-      continue;
-    }
-
-    const auto candidate_active_rq = candidate_host->stats().rq_active_.value();
-    const auto sampled_active_rq = sampled_host->stats().rq_active_.value();
+  // Compare hosts by index and only take a reference to the winner, rather than copying a shared
+  // pointer (two atomic reference count updates) for every sampled host.
+  uint64_t candidate_idx = random_.random() % hosts_to_use.size();
+  uint64_t candidate_active_rq = hosts_to_use[candidate_idx]->stats().rq_active_.value();
+  for (uint32_t choice_idx = 1; choice_idx < choice_count_; ++choice_idx) {
+    const uint64_t sampled_idx = random_.random() % hosts_to_use.size();
+    const uint64_t sampled_active_rq = hosts_to_use[sampled_idx]->stats().rq_active_.value();
     if (sampled_active_rq < candidate_active_rq) {
-      candidate_host = sampled_host;
+      candidate_idx = sampled_idx;
+      candidate_active_rq = sampled_active_rq;
     }
   }
 
-  return candidate_host;
+  return hosts_to_use[candidate_idx];
 }
 
 HostConstSharedPtr RandomLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
@@ -890,6 +910,42 @@ HostConstSharedPtr RandomLoadBalancer::peekOrChoose(LoadBalancerContext* context
   return hosts_to_use[random_hash % hosts_to_use.size()];
 }
 
+HostConstSharedPtr PeakEwmaLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
+  if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
+    return nullptr;
+  }
+  return peekOrChoose(context, true);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
+  return peekOrChoose(context, false);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::peekOrChoose(LoadBalancerContext* context, bool peek) {
+  const uint64_t random_hash = random(peek);
+  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context, random_hash);
+  if (!hosts_source) {
+    return nullptr;
+  }
+
+  const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+  if (hosts_to_use.empty()) {
+    return nullptr;
+  }
+  if (hosts_to_use.size() == 1) {
+    return hosts_to_use[0];
+  }
+
+  // Both candidates come from the one random value, so that a peek and the pick it stands for
+  // agree. The second candidate is always a different host than the first.
+  const uint64_t size = hosts_to_use.size();
+  const uint64_t first = random_hash % size;
+  const uint64_t second = (first + 1 + (random_hash >> 32) % (size - 1)) % size;
+  const HostSharedPtr& first_host = hosts_to_use[first];
+  const HostSharedPtr& second_host = hosts_to_use[second];
+  return cost(*second_host) < cost(*first_host) ? second_host : first_host;
+}
+
 SubsetSelectorImpl::SubsetSelectorImpl(
     const Protobuf::RepeatedPtrField<std::string>& selector_keys,
     envoy::config::cluster::v3::Cluster::LbSubsetConfig::LbSubsetSelector::
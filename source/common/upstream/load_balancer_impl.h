@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <memory>
@@ -397,6 +398,11 @@ protected:
 
   virtual void refresh(uint32_t priority);
 
+  /**
+   * Recomputes the schedulers of the priorities whose hosts changed since the last pick.
+   */
+  void refreshStalePriorities();
+
   // Seed to allow us to desynchronize load balancers across a fleet. If we don't
   // do this, multiple Envoys that receive an update at the same time (or even
   // multiple load balancers on the same host) will send requests to
@@ -412,8 +418,13 @@ private:
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
 
+  void markStale(uint32_t priority);
+
   // Scheduler for each valid HostsSource.
   absl::node_hash_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
+  // Priorities whose schedulers are out of date, indexed by priority.
+  std::vector<bool> stale_priorities_;
+  bool has_stale_priorities_{};
   Common::CallbackHandlePtr priority_update_cb_;
 };
 
@@ -587,6 +598,37 @@ protected:
   HostConstSharedPtr peekOrChoose(LoadBalancerContext* context, bool peek);
 };
 
+/**
+ * Latency aware load balancer. Each pick compares two random hosts and takes the one with the
+ * lower expected cost, which is the peak EWMA latency of the host scaled by its outstanding
+ * requests and divided by its weight. The latency estimates are fed by the router and shared by
+ * all workers, see Upstream::LatencyEstimate.
+ */
+class PeakEwmaLoadBalancer : public ZoneAwareLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                       ClusterStats& stats, Runtime::Loader& runtime,
+                       Random::RandomGenerator& random,
+                       const envoy::config::cluster::v3::Cluster::CommonLbConfig& common_config)
+      : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                  common_config) {}
+
+  // Upstream::LoadBalancerBase
+  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+  HostConstSharedPtr peekAnotherHost(LoadBalancerContext* context) override;
+
+  /**
+   * @return the expected cost of sending a request to a host.
+   */
+  static double cost(const Host& host) {
+    return host.latencyEstimate().value() * (host.stats().rq_active_.value() + 1) /
+           std::max<uint32_t>(host.weight(), 1);
+  }
+
+private:
+  HostConstSharedPtr peekOrChoose(LoadBalancerContext* context, bool peek);
+};
+
 /**
  * Implementation of SubsetSelector
  */
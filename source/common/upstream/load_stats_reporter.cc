@@ -1,11 +1,17 @@
 #include "common/upstream/load_stats_reporter.h"
 
+#include <map>
+
 #include "envoy/service/load_stats/v3/lrs.pb.h"
 #include "envoy/stats/scope.h"
+#include "envoy/upstream/locality.h"
 
 #include "common/config/version_converter.h"
+#include "common/network/utility.h"
 #include "common/protobuf/protobuf.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -68,6 +74,7 @@ void LoadStatsReporter::sendLoadStatsRequest() {
     auto it = all_clusters.active_clusters_.find(cluster_name);
     if (it == all_clusters.active_clusters_.end()) {
       ENVOY_LOG(debug, "Cluster {} does not exist", cluster_name);
+      hosts_in_progress_.erase(cluster_name);
       continue;
     }
     auto& cluster = it->second.get();
@@ -76,31 +83,7 @@ void LoadStatsReporter::sendLoadStatsRequest() {
     if (cluster.info()->edsServiceName().has_value()) {
       cluster_stats->set_cluster_service_name(cluster.info()->edsServiceName().value());
     }
-    for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
-      ENVOY_LOG(trace, "Load report locality count {}", host_set->hostsPerLocality().get().size());
-      for (auto& hosts : host_set->hostsPerLocality().get()) {
-        ASSERT(!hosts.empty());
-        uint64_t rq_success = 0;
-        uint64_t rq_error = 0;
-        uint64_t rq_active = 0;
-        uint64_t rq_issued = 0;
-        for (const auto& host : hosts) {
-          rq_success += host->stats().rq_success_.latch();
-          rq_error += host->stats().rq_error_.latch();
-          rq_active += host->stats().rq_active_.value();
-          rq_issued += host->stats().rq_total_.latch();
-        }
-        if (rq_success + rq_error + rq_active != 0) {
-          auto* locality_stats = cluster_stats->add_upstream_locality_stats();
-          locality_stats->mutable_locality()->MergeFrom(hosts[0]->locality());
-          locality_stats->set_priority(host_set->priority());
-          locality_stats->set_total_successful_requests(rq_success);
-          locality_stats->set_total_error_requests(rq_error);
-          locality_stats->set_total_requests_in_progress(rq_active);
-          locality_stats->set_total_issued_requests(rq_issued);
-        }
-      }
-    }
+    addLocalityStats(cluster_name, cluster, *cluster_stats);
     cluster_stats->set_total_dropped_requests(
         cluster.info()->loadReportStats().upstream_rq_dropped_.latch());
     const auto now = time_source_.monotonicTime().time_since_epoch();
@@ -122,6 +105,95 @@ void LoadStatsReporter::sendLoadStatsRequest() {
   }
 }
 
+void LoadStatsReporter::addLocalityStats(const std::string& cluster_name, Cluster& cluster,
+                                         envoy::config::endpoint::v3::ClusterStats& cluster_stats) {
+  // Only the hosts which received load since the last report, and the ones which still had
+  // requests in progress then, are visited rather than all the hosts of the cluster.
+  std::vector<HostDescriptionConstSharedPtr> hosts;
+  LoadReportHosts& load_report_hosts = cluster.info()->loadReportHosts();
+  if (load_report_hosts.enabled()) {
+    hosts = load_report_hosts.take();
+  } else {
+    // The cluster was replaced since the last report: its hosts are all visited once.
+    load_report_hosts.setEnabled(true);
+    for (const auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
+      hosts.insert(hosts.end(), host_set->hosts().begin(), host_set->hosts().end());
+    }
+  }
+  std::vector<HostDescriptionConstSharedPtr>& hosts_in_progress = hosts_in_progress_[cluster_name];
+  hosts.insert(hosts.end(), std::make_move_iterator(hosts_in_progress.begin()),
+               std::make_move_iterator(hosts_in_progress.end()));
+  hosts_in_progress.clear();
+
+  // The load of each host, grouped by priority and locality.
+  struct HostLoad {
+    const HostDescription* host_;
+    uint64_t rq_success_;
+    uint64_t rq_error_;
+    uint64_t rq_active_;
+    uint64_t rq_issued_;
+  };
+  std::map<uint32_t, absl::node_hash_map<envoy::config::core::v3::Locality, std::vector<HostLoad>,
+                                         LocalityHash, LocalityEqualTo>>
+      host_loads;
+  absl::flat_hash_set<const HostDescription*> visited_hosts;
+  for (const HostDescriptionConstSharedPtr& host : hosts) {
+    if (!visited_hosts.insert(host.get()).second) {
+      continue;
+    }
+    const HostLoad host_load{host.get(), host->stats().rq_success_.latch(),
+                             host->stats().rq_error_.latch(), host->stats().rq_active_.value(),
+                             host->stats().rq_total_.latch()};
+    if (host_load.rq_active_ != 0) {
+      hosts_in_progress.push_back(host);
+    }
+    if (host_load.rq_success_ + host_load.rq_error_ + host_load.rq_active_ +
+            host_load.rq_issued_ !=
+        0) {
+      host_loads[host->priority()][host->locality()].push_back(host_load);
+    }
+  }
+  ENVOY_LOG(trace, "Load report host count {}", visited_hosts.size());
+
+  const bool report_endpoints = message_ != nullptr && message_->report_endpoint_granularity();
+  for (const auto& priority_and_localities : host_loads) {
+    for (const auto& locality_and_hosts : priority_and_localities.second) {
+      uint64_t rq_success = 0;
+      uint64_t rq_error = 0;
+      uint64_t rq_active = 0;
+      uint64_t rq_issued = 0;
+      for (const HostLoad& host_load : locality_and_hosts.second) {
+        rq_success += host_load.rq_success_;
+        rq_error += host_load.rq_error_;
+        rq_active += host_load.rq_active_;
+        rq_issued += host_load.rq_issued_;
+      }
+      if (rq_success + rq_error + rq_active == 0) {
+        continue;
+      }
+      auto* locality_stats = cluster_stats.add_upstream_locality_stats();
+      locality_stats->mutable_locality()->MergeFrom(locality_and_hosts.first);
+      locality_stats->set_priority(priority_and_localities.first);
+      locality_stats->set_total_successful_requests(rq_success);
+      locality_stats->set_total_error_requests(rq_error);
+      locality_stats->set_total_requests_in_progress(rq_active);
+      locality_stats->set_total_issued_requests(rq_issued);
+      if (!report_endpoints) {
+        continue;
+      }
+      for (const HostLoad& host_load : locality_and_hosts.second) {
+        auto* endpoint_stats = locality_stats->add_upstream_endpoint_stats();
+        Network::Utility::addressToProtobufAddress(*host_load.host_->address(),
+                                                   *endpoint_stats->mutable_address());
+        endpoint_stats->set_total_successful_requests(host_load.rq_success_);
+        endpoint_stats->set_total_error_requests(host_load.rq_error_);
+        endpoint_stats->set_total_requests_in_progress(host_load.rq_active_);
+        endpoint_stats->set_total_issued_requests(host_load.rq_issued_);
+      }
+    }
+  }
+}
+
 void LoadStatsReporter::handleFailure() {
   ENVOY_LOG(warn, "Load reporter stats stream/connection failure, will retry in {} ms.",
             RETRY_DELAY_MS);
@@ -170,6 +242,18 @@ void LoadStatsReporter::startLoadReportPeriod() {
       }
     }
   }
+  // The clusters which are no longer tracked stop collecting their hosts which receive load.
+  for (const auto& cluster_name_and_timestamp : clusters_) {
+    const std::string& cluster_name = cluster_name_and_timestamp.first;
+    if (existing_clusters.contains(cluster_name)) {
+      continue;
+    }
+    hosts_in_progress_.erase(cluster_name);
+    auto it = all_clusters.active_clusters_.find(cluster_name);
+    if (it != all_clusters.active_clusters_.end()) {
+      it->second.get().info()->loadReportHosts().setEnabled(false);
+    }
+  }
   clusters_.clear();
   // Reset stats for all hosts in clusters we are tracking.
   auto handle_cluster_func = [this, &existing_clusters,
@@ -187,11 +271,22 @@ void LoadStatsReporter::startLoadReportPeriod() {
       return;
     }
     auto& cluster = it->second.get();
+    // From now on, the hosts which receive load are collected, and only these, as well as the
+    // ones with requests in progress, are visited on each report.
+    LoadReportHosts& load_report_hosts = cluster.info()->loadReportHosts();
+    load_report_hosts.setEnabled(true);
+    load_report_hosts.take();
+    std::vector<HostDescriptionConstSharedPtr>& hosts_in_progress =
+        hosts_in_progress_[cluster_name];
+    hosts_in_progress.clear();
     for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
       for (const auto& host : host_set->hosts()) {
         host->stats().rq_success_.latch();
         host->stats().rq_error_.latch();
         host->stats().rq_total_.latch();
+        if (host->stats().rq_active_.value() != 0) {
+          hosts_in_progress.push_back(host);
+        }
       }
     }
     cluster.info()->loadReportStats().upstream_rq_dropped_.latch();
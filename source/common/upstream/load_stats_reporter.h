@@ -52,6 +52,9 @@ private:
   void setRetryTimer();
   void establishNewStream();
   void sendLoadStatsRequest();
+  // Adds the load of the localities of a cluster since the last report to its stats.
+  void addLocalityStats(const std::string& cluster_name, Cluster& cluster,
+                        envoy::config::endpoint::v3::ClusterStats& cluster_stats);
   void handleFailure();
   void startLoadReportPeriod();
 
@@ -69,6 +72,9 @@ private:
   std::unique_ptr<envoy::service::load_stats::v3::LoadStatsResponse> message_;
   // Map from cluster name to start of measurement interval.
   absl::node_hash_map<std::string, std::chrono::steady_clock::duration> clusters_;
+  // Map from cluster name to the hosts which had requests in progress at the last report, which
+  // are visited on the next report although they may not receive new requests.
+  absl::node_hash_map<std::string, std::vector<HostDescriptionConstSharedPtr>> hosts_in_progress_;
   TimeSource& time_source_;
 };
 
@@ -1,5 +1,6 @@
 #include "common/upstream/logical_dns_cluster.h"
 
+#include <algorithm>
 #include <chrono>
 #include <list>
 #include <memory>
@@ -41,6 +42,12 @@ convertPriority(const envoy::config::endpoint::v3::ClusterLoadAssignment& load_a
 
   return converted;
 }
+
+bool sameAddresses(const std::vector<Network::Address::InstanceConstSharedPtr>& lhs,
+                   const std::vector<Network::Address::InstanceConstSharedPtr>& rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                    [](const auto& lhs, const auto& rhs) { return *lhs == *rhs; });
+}
 } // namespace
 
 LogicalDnsCluster::LogicalDnsCluster(
@@ -120,10 +127,14 @@ void LogicalDnsCluster::startResolve() {
         if (status == Network::DnsResolver::ResolutionStatus::Success && !response.empty()) {
           info_->stats().update_success_.inc();
           // TODO(mattklein123): Move port handling into the DNS interface.
-          ASSERT(response.front().address_ != nullptr);
-          Network::Address::InstanceConstSharedPtr new_address =
-              Network::Utility::getAddressWithPort(*(response.front().address_),
-                                                   Network::Utility::portFromTcpUrl(dns_url_));
+          const uint32_t port = Network::Utility::portFromTcpUrl(dns_url_);
+          std::vector<Network::Address::InstanceConstSharedPtr> new_addresses;
+          for (const auto& dns_response : response) {
+            ASSERT(dns_response.address_ != nullptr);
+            new_addresses.push_back(
+                Network::Utility::getAddressWithPort(*dns_response.address_, port));
+          }
+          const Network::Address::InstanceConstSharedPtr& new_address = new_addresses.front();
 
           if (!logical_host_) {
             logical_host_ =
@@ -141,12 +152,12 @@ void LogicalDnsCluster::startResolve() {
                 absl::nullopt, absl::nullopt, absl::nullopt);
           }
 
-          if (!current_resolved_address_ || !(*new_address == *current_resolved_address_)) {
-            current_resolved_address_ = new_address;
+          if (!sameAddresses(new_addresses, current_resolved_addresses_)) {
+            current_resolved_addresses_ = new_addresses;
 
             // Make sure that we have an updated address for admin display, health
             // checking, and creating real host connections.
-            logical_host_->setNewAddress(new_address, lbEndpoint());
+            logical_host_->setNewAddresses(new_address, new_addresses, lbEndpoint());
           }
 
           // reset failure backoff strategy because there was a success.
@@ -6,9 +6,16 @@ namespace Upstream {
 Upstream::Host::CreateConnectionData LogicalHost::createConnection(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     Network::TransportSocketOptionsSharedPtr transport_socket_options) const {
-  const auto current_address = address();
+  Network::Address::InstanceConstSharedPtr current_address;
+  std::vector<Network::Address::InstanceConstSharedPtr> current_address_list;
+  {
+    absl::ReaderMutexLock lock(&address_lock_);
+    current_address = address_;
+    current_address_list = address_list_;
+  }
   return {HostImpl::createConnection(
-              dispatcher, cluster(), current_address, transportSocketFactory(), options,
+              dispatcher, cluster(), current_address, current_address_list,
+              transportSocketFactory(), options,
               override_transport_socket_options_ != nullptr ? override_transport_socket_options_
                                                             : transport_socket_options),
           std::make_shared<RealHostDescription>(current_address, shared_from_this())};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "envoy/common/time.h"
 #include "envoy/config/core/v3/base.pb.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
@@ -35,12 +37,21 @@ public:
   // future proof the code.
   void setNewAddress(const Network::Address::InstanceConstSharedPtr& address,
                      const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint) {
+    setNewAddresses(address, {}, lb_endpoint);
+  }
+
+  // Set the new address along with all the resolved addresses, which the connections race to if
+  // there are more than one.
+  void setNewAddresses(const Network::Address::InstanceConstSharedPtr& address,
+                       const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
+                       const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint) {
     const auto& port_value = lb_endpoint.endpoint().health_check_config().port_value();
     auto health_check_address =
         port_value == 0 ? address : Network::Utility::getAddressWithPort(*address, port_value);
 
     absl::WriterMutexLock lock(&address_lock_);
     address_ = address;
+    address_list_ = address_list;
     health_check_address_ = health_check_address;
   }
 
@@ -62,6 +73,8 @@ public:
 private:
   const Network::TransportSocketOptionsSharedPtr override_transport_socket_options_;
   mutable absl::Mutex address_lock_;
+  std::vector<Network::Address::InstanceConstSharedPtr>
+      address_list_ ABSL_GUARDED_BY(address_lock_);
 };
 
 using LogicalHostSharedPtr = std::shared_ptr<LogicalHost>;
@@ -107,6 +120,7 @@ public:
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
   }
   MonotonicTime creationTime() const override { return logical_host_->creationTime(); }
+  LatencyEstimate& latencyEstimate() const override { return logical_host_->latencyEstimate(); }
   uint32_t priority() const override { return logical_host_->priority(); }
   void priority(uint32_t) override { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
 
@@ -18,16 +18,18 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   // Implementation of pseudocode listing 1 in the paper (see header file for more info).
   std::vector<TableBuildEntry> table_build_entries;
   table_build_entries.reserve(normalized_host_weights.size());
+  hosts_.reserve(normalized_host_weights.size());
   for (const auto& host_weight : normalized_host_weights) {
     const auto& host = host_weight.first;
     const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
     ASSERT(!key_to_hash.empty());
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(key_to_hash) % table_size_,
+    table_build_entries.emplace_back(hosts_.size(), HashUtil::xxHash64(key_to_hash) % table_size_,
                                      (HashUtil::xxHash64(key_to_hash, 1) % (table_size_ - 1)) + 1,
                                      host_weight.second);
+    hosts_.push_back(host);
   }
 
-  table_.resize(table_size_);
+  table_.assign(table_size_, EmptySlot);
 
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
@@ -42,14 +44,12 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
         continue;
       }
       entry.target_weight_ += max_normalized_weight;
-      uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
-        entry.next_++;
-        c = permutation(entry);
+      while (table_[entry.permutation_] != EmptySlot) {
+        advance(entry);
       }
 
-      table_[c] = entry.host_;
-      entry.next_++;
+      table_[entry.permutation_] = entry.host_index_;
+      advance(entry);
       entry.count_++;
       table_index++;
     }
@@ -66,8 +66,9 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
 
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (uint64_t i = 0; i < table_.size(); i++) {
-      const absl::string_view key_to_hash = hashKey(table_[i], use_hostname_for_hashing);
-      ENVOY_LOG(trace, "maglev: i={} address={} host={}", i, table_[i]->address()->asString(),
+      const HostConstSharedPtr& host = hosts_[table_[i]];
+      const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
+      ENVOY_LOG(trace, "maglev: i={} address={} host={}", i, host->address()->asString(),
                 key_to_hash);
     }
   }
@@ -85,11 +86,16 @@ HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash, uint32_t attempt) cons
     hash ^= ~0ULL - attempt + 1;
   }
 
-  return table_[hash % table_size_];
+  return hosts_[table_[hash % table_size_]];
 }
 
-uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
-  return (entry.offset_ + (entry.skip_ * entry.next_)) % table_size_;
+void MaglevTable::advance(TableBuildEntry& entry) const {
+  // Both the permutation and the skip are less than the table size, so one subtraction is enough
+  // to wrap around.
+  entry.permutation_ += entry.skip_;
+  if (entry.permutation_ >= table_size_) {
+    entry.permutation_ -= table_size_;
+  }
 }
 
 MaglevLoadBalancer::MaglevLoadBalancer(
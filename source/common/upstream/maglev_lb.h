@@ -1,5 +1,9 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "envoy/common/random_generator.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/stats/scope.h"
@@ -46,22 +50,31 @@ public:
 
 private:
   struct TableBuildEntry {
-    TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+    TableBuildEntry(uint32_t host_index, uint64_t offset, uint64_t skip, double weight)
+        : host_index_(host_index), skip_(skip), weight_(weight), permutation_(offset) {}
 
-    HostConstSharedPtr host_;
-    const uint64_t offset_;
+    const uint32_t host_index_;
     const uint64_t skip_;
     const double weight_;
     double target_weight_{};
-    uint64_t next_{};
+    // The current element of the host's permutation of the table, offset + skip * next modulo the
+    // table size in the terms of the paper. It is advanced one step at a time, which avoids a
+    // modulo per probe.
+    uint64_t permutation_;
     uint64_t count_{};
   };
 
-  uint64_t permutation(const TableBuildEntry& entry);
+  void advance(TableBuildEntry& entry) const;
+
+  // Marks slots that haven't been assigned a host while building the table.
+  static constexpr uint32_t EmptySlot = std::numeric_limits<uint32_t>::max();
 
   const uint64_t table_size_;
-  std::vector<HostConstSharedPtr> table_;
+  std::vector<HostConstSharedPtr> hosts_;
+  // Each slot holds an index into hosts_. This keeps the table a quarter of the size it would be
+  // with host pointers, both while filling it in random order and while it's in use, and saves a
+  // reference count update per slot when building and destroying it.
+  std::vector<uint32_t> table_;
   MaglevLoadBalancerStats& stats_;
 };
 
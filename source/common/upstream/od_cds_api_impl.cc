@@ -0,0 +1,121 @@
+#include "common/upstream/od_cds_api_impl.h"
+
+#include "common/common/fmt.h"
+#include "common/grpc/common.h"
+
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Upstream {
+
+OdCdsApiImpl::OdCdsApiImpl(const envoy::config::core::v3::ConfigSource& odcds_config,
+                           std::chrono::milliseconds idle_timeout, ClusterManager& cm,
+                           MissingClusterNotifier& notifier, Stats::Scope& scope,
+                           Event::Dispatcher& dispatcher,
+                           ProtobufMessage::ValidationVisitor& validation_visitor)
+    : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>(
+          odcds_config.resource_api_version(), validation_visitor, "name"),
+      helper_(cm, "odcds"), cm_(cm), notifier_(notifier),
+      scope_(scope.createScope("cluster_manager.odcds.")), idle_timeout_(idle_timeout) {
+  subscription_ = cm_.subscriptionFactory().subscriptionFromConfigSource(
+      odcds_config, Grpc::Common::typeUrl(getResourceName()), *scope_, *this, resource_decoder_,
+      {});
+  if (idle_timeout_.count() > 0) {
+    idle_timer_ = dispatcher.createTimer([this] { reclaimIdleClusters(); });
+  }
+}
+
+void OdCdsApiImpl::updateOnDemand(const std::string& cluster_name) {
+  awaiting_clusters_.insert(cluster_name);
+  if (!requested_clusters_.insert(cluster_name).second) {
+    // The discovery service sends the cluster once it knows it.
+    return;
+  }
+  ENVOY_LOG(debug, "odcds: requesting cluster '{}'", cluster_name);
+  if (!started_) {
+    started_ = true;
+    subscription_->start(requested_clusters_);
+  } else {
+    subscription_->updateResourceInterest(requested_clusters_);
+  }
+}
+
+void OdCdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& resources,
+                                  const std::string& version_info) {
+  // The state of the world only lists the requested clusters that the discovery service knows.
+  absl::flat_hash_set<std::string> missing_clusters = requested_clusters_;
+  for (const auto& resource : resources) {
+    missing_clusters.erase(resource.get().name());
+  }
+  Protobuf::RepeatedPtrField<std::string> to_remove_repeated;
+  for (const auto& cluster_name : missing_clusters) {
+    *to_remove_repeated.Add() = cluster_name;
+  }
+  onConfigUpdate(resources, to_remove_repeated, version_info);
+}
+
+void OdCdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
+                                  const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                                  const std::string& system_version_info) {
+  auto exception_msgs =
+      helper_.onConfigUpdate(added_resources, removed_resources, system_version_info);
+  for (const auto& resource : added_resources) {
+    awaiting_clusters_.erase(resource.get().name());
+    cluster_requests_.try_emplace(resource.get().name(), 0);
+  }
+  for (const auto& cluster_name : removed_resources) {
+    cluster_requests_.erase(cluster_name);
+    if (awaiting_clusters_.erase(cluster_name) > 0) {
+      ENVOY_LOG(debug, "odcds: cluster '{}' is missing", cluster_name);
+      notifier_.notifyMissingCluster(cluster_name);
+    }
+  }
+  if (idle_timer_ != nullptr && !cluster_requests_.empty() && !idle_timer_->enabled()) {
+    idle_timer_->enableTimer(idle_timeout_);
+  }
+  if (!exception_msgs.empty()) {
+    throw EnvoyException(
+        fmt::format("Error adding/updating cluster(s) {}", absl::StrJoin(exception_msgs, ", ")));
+  }
+}
+
+void OdCdsApiImpl::reclaimIdleClusters() {
+  const ClusterManager::ClusterInfoMaps clusters = cm_.clusters();
+  std::vector<std::string> idle_clusters;
+  for (auto it = cluster_requests_.begin(); it != cluster_requests_.end();) {
+    const auto cluster = clusters.active_clusters_.find(it->first);
+    if (cluster == clusters.active_clusters_.end()) {
+      // A warming cluster is checked once active, a cluster removed meanwhile isn't anymore.
+      if (clusters.hasCluster(it->first)) {
+        ++it;
+      } else {
+        cluster_requests_.erase(it++);
+      }
+      continue;
+    }
+    const ClusterStats& stats = cluster->second.get().info()->stats();
+    const uint64_t requests = stats.upstream_rq_total_.value();
+    if (requests == it->second && stats.upstream_rq_active_.value() == 0) {
+      idle_clusters.push_back(it->first);
+    }
+    it->second = requests;
+    ++it;
+  }
+
+  for (const std::string& cluster_name : idle_clusters) {
+    ENVOY_LOG(debug, "odcds: removing idle cluster '{}'", cluster_name);
+    cm_.removeCluster(cluster_name);
+    cluster_requests_.erase(cluster_name);
+    requested_clusters_.erase(cluster_name);
+  }
+  if (!idle_clusters.empty()) {
+    // Stop the discovery service from sending the removed clusters, until they're requested again.
+    subscription_->updateResourceInterest(requested_clusters_);
+  }
+  if (!cluster_requests_.empty()) {
+    idle_timer_->enableTimer(idle_timeout_);
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.validate.h"
+#include "envoy/config/core/v3/config_source.pb.h"
+#include "envoy/config/subscription.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/protobuf/message_validator.h"
+#include "envoy/stats/scope.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "common/common/logger.h"
+#include "common/config/subscription_base.h"
+#include "common/protobuf/protobuf.h"
+#include "common/upstream/cds_api_helper.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Notified of the clusters requested on demand that the discovery service doesn't know.
+ */
+class MissingClusterNotifier {
+public:
+  virtual ~MissingClusterNotifier() = default;
+
+  /**
+   * @param name supplies the name of the cluster the discovery service doesn't know.
+   */
+  virtual void notifyMissingCluster(absl::string_view name) PURE;
+};
+
+/**
+ * ODCDS API implementation that fetches the clusters requested by name via Subscription. The
+ * clusters which no request used during the idle timeout are removed again. Only used on the main
+ * thread.
+ */
+class OdCdsApiImpl : Envoy::Config::SubscriptionBase<envoy::config::cluster::v3::Cluster>,
+                     Logger::Loggable<Logger::Id::upstream> {
+public:
+  OdCdsApiImpl(const envoy::config::core::v3::ConfigSource& odcds_config,
+               std::chrono::milliseconds idle_timeout, ClusterManager& cm,
+               MissingClusterNotifier& notifier, Stats::Scope& scope,
+               Event::Dispatcher& dispatcher,
+               ProtobufMessage::ValidationVisitor& validation_visitor);
+
+  /**
+   * Requests the cluster from the discovery service, unless it was already requested.
+   * @param cluster_name supplies the name of the cluster.
+   */
+  void updateOnDemand(const std::string& cluster_name);
+
+private:
+  // Config::SubscriptionCallbacks
+  void onConfigUpdate(const std::vector<Config::DecodedResourceRef>& resources,
+                      const std::string& version_info) override;
+  void onConfigUpdate(const std::vector<Config::DecodedResourceRef>& added_resources,
+                      const Protobuf::RepeatedPtrField<std::string>& removed_resources,
+                      const std::string& system_version_info) override;
+  void onConfigUpdateFailed(Envoy::Config::ConfigUpdateFailureReason,
+                            const EnvoyException*) override {
+    // The requests waiting for the clusters time out.
+  }
+
+  void reclaimIdleClusters();
+
+  CdsApiHelper helper_;
+  ClusterManager& cm_;
+  MissingClusterNotifier& notifier_;
+  Stats::ScopePtr scope_;
+  Config::SubscriptionPtr subscription_;
+  bool started_{};
+  // The clusters subscribed to.
+  absl::flat_hash_set<std::string> requested_clusters_;
+  // The requested clusters the discovery service didn't answer yet.
+  absl::flat_hash_set<std::string> awaiting_clusters_;
+  const std::chrono::milliseconds idle_timeout_;
+  Event::TimerPtr idle_timer_;
+  // The total requests of the discovered clusters, as of the last idle check.
+  absl::flat_hash_map<std::string, uint64_t> cluster_requests_;
+};
+
+using OdCdsApiImplSharedPtr = std::shared_ptr<OdCdsApiImpl>;
+
+} // namespace Upstream
+} // namespace Envoy
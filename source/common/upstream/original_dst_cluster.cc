@@ -46,6 +46,13 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
         host->used(true); // Mark as used.
         return host;
       }
+      // Check if this worker already created a host the cluster hasn't synced back yet.
+      it = created_hosts_.find(dst_addr.asString());
+      if (it != created_hosts_.end()) {
+        ENVOY_LOG(debug, "Using created host {}.", it->second->address()->asString());
+        it->second->used(true);
+        return it->second;
+      }
       // Add a new host
       const Network::Address::Ip* dst_ip = dst_addr.ip();
       if (dst_ip) {
@@ -59,6 +66,7 @@ HostConstSharedPtr OriginalDstCluster::LoadBalancer::chooseHost(LoadBalancerCont
             envoy::config::endpoint::v3::Endpoint::HealthCheckConfig().default_instance(), 0,
             envoy::config::core::v3::UNKNOWN, parent_->time_source_));
         ENVOY_LOG(debug, "Created host {}.", host->address()->asString());
+        created_hosts_.emplace(dst_addr.asString(), host);
 
         // Tell the cluster about the new host
         // lambda cannot capture a member by value.
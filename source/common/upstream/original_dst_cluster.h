@@ -48,6 +48,12 @@ public:
    * cluster remains (eventually) consistent. If multiple threads add a host to the same upstream
    * address then two distinct HostSharedPtr's (with the same upstream IP address) will be added,
    * and both of them will eventually time out.
+   *
+   * The load balancer of each worker reads a snapshot of the host map, which is only refreshed
+   * when the load balancer is recreated for a host set update, so choosing a host takes no lock.
+   * The hosts a worker creates are kept in its own map until the snapshot includes them, so that
+   * the requests to the same new destination reuse the host instead of each creating and posting
+   * another one.
    */
   class LoadBalancer : public Upstream::LoadBalancer {
   public:
@@ -64,6 +70,8 @@ public:
 
     const std::shared_ptr<OriginalDstCluster> parent_;
     HostMapConstSharedPtr host_map_;
+    // The hosts created by this load balancer which aren't in host_map_.
+    HostMap created_hosts_;
   };
 
 private:
@@ -1,6 +1,8 @@
 #include "common/upstream/outlier_detection_impl.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -46,6 +48,10 @@ DetectorHostMonitorImpl::DetectorHostMonitorImpl(std::shared_ptr<DetectorImpl> d
   put_result_func_ = detector->config().splitExternalLocalOriginErrors()
                          ? &DetectorHostMonitorImpl::putResultWithLocalExternalSplit
                          : &DetectorHostMonitorImpl::putResultNoLocalExternalSplit;
+  // The response times are only recorded when they can eject the host.
+  if (detector->config().enforcingLatency() > 0) {
+    latency_accumulator_ = std::make_unique<LatencyAccumulator>();
+  }
 }
 
 void DetectorHostMonitorImpl::eject(MonotonicTime ejection_time) {
@@ -62,6 +68,9 @@ void DetectorHostMonitorImpl::uneject(MonotonicTime unejection_time) {
 void DetectorHostMonitorImpl::updateCurrentSuccessRateBucket() {
   external_origin_sr_monitor_.updateCurrentSuccessRateBucket();
   local_origin_sr_monitor_.updateCurrentSuccessRateBucket();
+  if (latency_accumulator_ != nullptr) {
+    latency_accumulator_->updateCurrentWriter();
+  }
 }
 
 void DetectorHostMonitorImpl::putHttpResponseCode(uint64_t response_code) {
@@ -254,7 +263,15 @@ DetectorConfig::DetectorConfig(const envoy::config::cluster::v3::OutlierDetectio
       // base_ejection_time whatever is larger.
       max_ejection_time_ms_(static_cast<uint64_t>(PROTOBUF_GET_MS_OR_DEFAULT(
           config, max_ejection_time,
-          std::max(DEFAULT_MAX_EJECTION_TIME_MS, base_ejection_time_ms_)))) {}
+          std::max(DEFAULT_MAX_EJECTION_TIME_MS, base_ejection_time_ms_)))),
+      latency_threshold_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, latency_threshold, DEFAULT_LATENCY_THRESHOLD))),
+      enforcing_latency_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, enforcing_latency, DEFAULT_ENFORCING_LATENCY))),
+      latency_minimum_hosts_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, latency_minimum_hosts, DEFAULT_LATENCY_MINIMUM_HOSTS))),
+      latency_request_volume_(static_cast<uint64_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, latency_request_volume, DEFAULT_LATENCY_REQUEST_VOLUME))) {}
 
 DetectorImpl::DetectorImpl(const Cluster& cluster,
                            const envoy::config::cluster::v3::OutlierDetection& config,
@@ -389,6 +406,8 @@ bool DetectorImpl::enforceEjection(envoy::data::cluster::v3::OutlierEjectionType
   case envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN:
     return runtime_.snapshot().featureEnabled(EnforcingFailurePercentageLocalOriginRuntime,
                                               config_.enforcingFailurePercentageLocalOrigin());
+  case envoy::data::cluster::v3::LATENCY:
+    return runtime_.snapshot().featureEnabled(EnforcingLatencyRuntime, config_.enforcingLatency());
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -421,6 +440,9 @@ void DetectorImpl::updateEnforcedEjectionStats(envoy::data::cluster::v3::Outlier
   case envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN:
     stats_.ejections_enforced_local_origin_failure_percentage_.inc();
     break;
+  case envoy::data::cluster::v3::LATENCY:
+    stats_.ejections_enforced_latency_.inc();
+    break;
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -450,6 +472,9 @@ void DetectorImpl::updateDetectedEjectionStats(envoy::data::cluster::v3::Outlier
   case envoy::data::cluster::v3::FAILURE_PERCENTAGE_LOCAL_ORIGIN:
     stats_.ejections_detected_local_origin_failure_percentage_.inc();
     break;
+  case envoy::data::cluster::v3::LATENCY:
+    stats_.ejections_detected_latency_.inc();
+    break;
   default:
     // Checked by schema.
     NOT_REACHED_GCOVR_EXCL_LINE;
@@ -701,6 +726,61 @@ void DetectorImpl::processSuccessRateEjections(
   }
 }
 
+void DetectorImpl::processLatencyEjections() {
+  latency_median_ms_ = -1;
+  if (config_.enforcingLatency() == 0) {
+    // The response times were not recorded.
+    return;
+  }
+
+  const uint64_t latency_minimum_hosts =
+      runtime_.snapshot().getInteger(LatencyMinimumHostsRuntime, config_.latencyMinimumHosts());
+  const uint64_t latency_request_volume =
+      runtime_.snapshot().getInteger(LatencyRequestVolumeRuntime, config_.latencyRequestVolume());
+  if (host_monitors_.size() < latency_minimum_hosts) {
+    return;
+  }
+
+  std::vector<std::pair<HostSharedPtr, uint64_t>> valid_latency_hosts;
+  valid_latency_hosts.reserve(host_monitors_.size());
+  for (const auto& host : host_monitors_) {
+    if (host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
+      continue;
+    }
+    const LatencyHistogram& histogram = host.second->latencyAccumulator()->lastInterval();
+    if (histogram.count() < latency_request_volume) {
+      continue;
+    }
+    const uint64_t latency_ms = histogram.quantileMs(0.99);
+    host.second->latencyMs(latency_ms);
+    valid_latency_hosts.emplace_back(host.first, latency_ms);
+  }
+  if (valid_latency_hosts.empty() || valid_latency_hosts.size() < latency_minimum_hosts) {
+    return;
+  }
+
+  // The median only needs a partial sort, which keeps the intervals of the clusters with many hosts
+  // linear in their number of hosts.
+  std::vector<uint64_t> latencies;
+  latencies.reserve(valid_latency_hosts.size());
+  for (const auto& host_latency : valid_latency_hosts) {
+    latencies.push_back(host_latency.second);
+  }
+  const auto median = latencies.begin() + latencies.size() / 2;
+  std::nth_element(latencies.begin(), median, latencies.end());
+  latency_median_ms_ = *median;
+
+  const double latency_threshold_ms =
+      latency_median_ms_ *
+      runtime_.snapshot().getInteger(LatencyThresholdRuntime, config_.latencyThreshold()) / 100.0;
+  for (const auto& host_latency : valid_latency_hosts) {
+    if (host_latency.second > latency_threshold_ms) {
+      updateDetectedEjectionStats(envoy::data::cluster::v3::LATENCY);
+      ejectHost(host_latency.first, envoy::data::cluster::v3::LATENCY);
+    }
+  }
+}
+
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
@@ -713,10 +793,12 @@ void DetectorImpl::onIntervalTimer() {
     // will get updated in processSuccessRateEjections().
     host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin, -1);
     host.second->successRate(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin, -1);
+    host.second->latencyMs(-1);
   }
 
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  processLatencyEjections();
 
   armIntervalTimer();
 }
@@ -759,6 +841,11 @@ void EventLoggerImpl::logEject(const HostDescriptionConstSharedPtr& host, Detect
             : DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin;
     event.mutable_eject_failure_percentage_event()->set_host_success_rate(
         host->outlierDetector().successRate(monitor_type));
+  } else if (type == envoy::data::cluster::v3::LATENCY) {
+    event.mutable_eject_latency_event()->set_host_latency_ms(
+        static_cast<uint64_t>(host->outlierDetector().latencyMs()));
+    event.mutable_eject_latency_event()->set_cluster_median_latency_ms(
+        static_cast<uint64_t>(detector.latencyMedianMs()));
   } else {
     event.mutable_eject_consecutive_event();
   }
@@ -819,6 +906,71 @@ absl::optional<std::pair<double, uint64_t>> SuccessRateAccumulator::getSuccessRa
   return {{success_rate, backup_success_rate_bucket_->total_request_counter_}};
 }
 
+void LatencyHistogram::clear() {
+  for (std::atomic<uint64_t>& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+uint64_t LatencyHistogram::count() const {
+  uint64_t total = 0;
+  for (const std::atomic<uint64_t>& count : counts_) {
+    total += count.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t LatencyHistogram::quantileMs(double quantile) const {
+  std::array<uint64_t, NumBuckets> counts;
+  uint64_t total = 0;
+  for (size_t i = 0; i < NumBuckets; i++) {
+    counts[i] = counts_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+  // The rank of the quantile, from 1 to total.
+  const uint64_t rank =
+      std::max<uint64_t>(1, std::min(total, static_cast<uint64_t>(std::ceil(quantile * total))));
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < NumBuckets - 1; i++) {
+    cumulative += counts[i];
+    if (cumulative >= rank) {
+      return bucketLowerBoundMs(i + 1);
+    }
+  }
+  return bucketLowerBoundMs(NumBuckets - 1);
+}
+
+size_t LatencyHistogram::bucketIndex(int64_t time_ms) {
+  if (time_ms < 4) {
+    return std::max<int64_t>(time_ms, 0);
+  }
+  const uint64_t ms = std::min<uint64_t>(time_ms, uint64_t(1) << MaxExponent);
+  // The exponent of the highest bit of the time, and the 2 bits that follow it.
+  uint32_t exponent = 2;
+  while ((ms >> (exponent + 1)) != 0) {
+    exponent++;
+  }
+  return 4 * (exponent - 1) + ((ms >> (exponent - 2)) & 3);
+}
+
+uint64_t LatencyHistogram::bucketLowerBoundMs(size_t index) {
+  if (index < 4) {
+    return index;
+  }
+  const uint32_t exponent = index / 4 + 1;
+  return (4 + index % 4) << (exponent - 2);
+}
+
+void LatencyAccumulator::updateCurrentWriter() {
+  // Right now current is being written to and backup is not. Flush the backup and swap.
+  backup_histogram_->clear();
+  current_histogram_.swap(backup_histogram_);
+  writer_.store(current_histogram_.get());
+}
+
 } // namespace Outlier
 } // namespace Upstream
 } // namespace Envoy
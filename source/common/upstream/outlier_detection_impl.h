@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
@@ -41,6 +42,7 @@ public:
   const absl::optional<MonotonicTime>& lastEjectionTime() override { return time_; }
   const absl::optional<MonotonicTime>& lastUnejectionTime() override { return time_; }
   double successRate(SuccessRateMonitorType) const override { return -1; }
+  double latencyMs() const override { return -1; }
 
 private:
   const absl::optional<MonotonicTime> time_{};
@@ -131,6 +133,70 @@ private:
   double success_rate_;
 };
 
+/**
+ * A histogram of response times, with 4 buckets per power of 2 milliseconds, so that each bucket
+ * is at most 25% wider than its lower bound. Any thread records to it without a lock.
+ */
+class LatencyHistogram {
+public:
+  void record(std::chrono::milliseconds time) {
+    counts_[bucketIndex(time.count())].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * Resets the counts of all the buckets.
+   */
+  void clear();
+
+  /**
+   * @return the number of response times recorded.
+   */
+  uint64_t count() const;
+
+  /**
+   * @param quantile supplies the quantile, in the range 0-1.
+   * @return the upper bound, in milliseconds, of the bucket of the quantile, or 0 if no response
+   *         time was recorded.
+   */
+  uint64_t quantileMs(double quantile) const;
+
+  static size_t bucketIndex(int64_t time_ms);
+  static uint64_t bucketLowerBoundMs(size_t index);
+
+  // The response times of 2^20ms (about 17 minutes) or more share the last bucket.
+  static constexpr uint32_t MaxExponent = 20;
+  static constexpr size_t NumBuckets = 4 * MaxExponent - 3;
+
+private:
+  std::array<std::atomic<uint64_t>, NumBuckets> counts_{};
+};
+
+/**
+ * The LatencyAccumulator records the response times of a host in a histogram, and keeps the
+ * histogram of the previous interval to run stats over, like the SuccessRateAccumulator.
+ */
+class LatencyAccumulator {
+public:
+  LatencyAccumulator()
+      : current_histogram_(new LatencyHistogram()), backup_histogram_(new LatencyHistogram()),
+        writer_(current_histogram_.get()) {}
+
+  void record(std::chrono::milliseconds time) { writer_.load()->record(time); }
+
+  /**
+   * Starts a new interval. The response times of the interval that ended are returned by
+   * lastInterval() until the next call.
+   */
+  void updateCurrentWriter();
+
+  const LatencyHistogram& lastInterval() const { return *backup_histogram_; }
+
+private:
+  std::unique_ptr<LatencyHistogram> current_histogram_;
+  std::unique_ptr<LatencyHistogram> backup_histogram_;
+  std::atomic<LatencyHistogram*> writer_;
+};
+
 class DetectorImpl;
 
 /**
@@ -154,7 +220,11 @@ public:
   uint32_t numEjections() override { return num_ejections_; }
   void putHttpResponseCode(uint64_t response_code) override;
   void putResult(Result result, absl::optional<uint64_t> code) override;
-  void putResponseTime(std::chrono::milliseconds) override {}
+  void putResponseTime(std::chrono::milliseconds time) override {
+    if (latency_accumulator_ != nullptr) {
+      latency_accumulator_->record(time);
+    }
+  }
   const absl::optional<MonotonicTime>& lastEjectionTime() override { return last_ejection_time_; }
   const absl::optional<MonotonicTime>& lastUnejectionTime() override {
     return last_unejection_time_;
@@ -179,6 +249,11 @@ public:
     getSRMonitor(type).setSuccessRate(new_success_rate);
   }
 
+  double latencyMs() const override { return latency_ms_; }
+  void latencyMs(double new_latency_ms) { latency_ms_ = new_latency_ms; }
+  // Null unless latency based outlier detection is enforced.
+  LatencyAccumulator* latencyAccumulator() { return latency_accumulator_.get(); }
+
   // handlers for reporting local origin errors
   void localOriginFailure();
   void localOriginNoFailure();
@@ -209,6 +284,9 @@ private:
   SuccessRateMonitor external_origin_sr_monitor_;
   SuccessRateMonitor local_origin_sr_monitor_;
 
+  std::unique_ptr<LatencyAccumulator> latency_accumulator_;
+  double latency_ms_{-1};
+
   void putResultNoLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   void putResultWithLocalExternalSplit(Result result, absl::optional<uint64_t> code);
   std::function<void(DetectorHostMonitorImpl*, Result, absl::optional<uint64_t> code)>
@@ -234,6 +312,8 @@ private:
   COUNTER(ejections_enforced_local_origin_success_rate)                                            \
   COUNTER(ejections_detected_local_origin_failure_percentage)                                      \
   COUNTER(ejections_enforced_local_origin_failure_percentage)                                      \
+  COUNTER(ejections_detected_latency)                                                              \
+  COUNTER(ejections_enforced_latency)                                                              \
   COUNTER(ejections_enforced_total)                                                                \
   COUNTER(ejections_overflow)                                                                      \
   COUNTER(ejections_success_rate)                                                                  \
@@ -283,6 +363,11 @@ constexpr absl::string_view SuccessRateStdevFactorRuntime =
     "outlier_detection.success_rate_stdev_factor";
 constexpr absl::string_view FailurePercentageThresholdRuntime =
     "outlier_detection.failure_percentage_threshold";
+constexpr absl::string_view EnforcingLatencyRuntime = "outlier_detection.enforcing_latency";
+constexpr absl::string_view LatencyMinimumHostsRuntime = "outlier_detection.latency_minimum_hosts";
+constexpr absl::string_view LatencyRequestVolumeRuntime =
+    "outlier_detection.latency_request_volume";
+constexpr absl::string_view LatencyThresholdRuntime = "outlier_detection.latency_threshold";
 
 /**
  * Configuration for the outlier detection.
@@ -318,6 +403,10 @@ public:
   }
   uint64_t enforcingLocalOriginSuccessRate() const { return enforcing_local_origin_success_rate_; }
   uint64_t maxEjectionTimeMs() const { return max_ejection_time_ms_; }
+  uint64_t latencyThreshold() const { return latency_threshold_; }
+  uint64_t enforcingLatency() const { return enforcing_latency_; }
+  uint64_t latencyMinimumHosts() const { return latency_minimum_hosts_; }
+  uint64_t latencyRequestVolume() const { return latency_request_volume_; }
 
 private:
   const uint64_t interval_ms_;
@@ -341,6 +430,10 @@ private:
   const uint64_t enforcing_consecutive_local_origin_failure_;
   const uint64_t enforcing_local_origin_success_rate_;
   const uint64_t max_ejection_time_ms_;
+  const uint64_t latency_threshold_;
+  const uint64_t enforcing_latency_;
+  const uint64_t latency_minimum_hosts_;
+  const uint64_t latency_request_volume_;
 
   static constexpr uint64_t DEFAULT_INTERVAL_MS = 10000;
   static constexpr uint64_t DEFAULT_BASE_EJECTION_TIME_MS = 30000;
@@ -362,6 +455,10 @@ private:
   static constexpr uint64_t DEFAULT_ENFORCING_CONSECUTIVE_LOCAL_ORIGIN_FAILURE = 100;
   static constexpr uint64_t DEFAULT_ENFORCING_LOCAL_ORIGIN_SUCCESS_RATE = 100;
   static constexpr uint64_t DEFAULT_MAX_EJECTION_TIME_MS = 10 * DEFAULT_BASE_EJECTION_TIME_MS;
+  static constexpr uint64_t DEFAULT_LATENCY_THRESHOLD = 300;
+  static constexpr uint64_t DEFAULT_ENFORCING_LATENCY = 0;
+  static constexpr uint64_t DEFAULT_LATENCY_MINIMUM_HOSTS = 5;
+  static constexpr uint64_t DEFAULT_LATENCY_REQUEST_VOLUME = 100;
 };
 
 /**
@@ -393,6 +490,7 @@ public:
       DetectorHostMonitor::SuccessRateMonitorType monitor_type) const override {
     return getSRNums(monitor_type).ejection_threshold_;
   }
+  double latencyMedianMs() const override { return latency_median_ms_; }
 
   /**
    * This function returns pair of double values for success rate outlier detection. The pair
@@ -433,6 +531,7 @@ private:
   void updateEnforcedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void updateDetectedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType monitor_type);
+  void processLatencyEjections();
 
   // The helper to double write value and gauge. The gauge could be null value since because any
   // stat might be deactivated.
@@ -470,6 +569,7 @@ private:
   // for external events and local_origin_sr_num_ is used for local origin events.
   EjectionPair external_origin_sr_num_;
   EjectionPair local_origin_sr_num_;
+  double latency_median_ms_{-1};
 
   const EjectionPair& getSRNums(DetectorHostMonitor::SuccessRateMonitorType monitor_type) const {
     return (DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin == monitor_type)
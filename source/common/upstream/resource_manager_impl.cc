@@ -0,0 +1,16 @@
+#include "common/upstream/resource_manager_impl.h"
+
+namespace Envoy {
+namespace Upstream {
+
+uint32_t ShardedResourceCount::localShardIndex() {
+  // The threads are spread over the shards in the order they first use a sharded count, which gives
+  // each worker its own shard as long as there are fewer workers than shards.
+  static std::atomic<uint32_t> next_shard{0};
+  thread_local const uint32_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % NumShards;
+  return shard;
+}
+
+} // namespace Upstream
+} // namespace Envoy
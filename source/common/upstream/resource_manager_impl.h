@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <memory>
@@ -16,26 +17,135 @@
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * A resource count split in per-worker shards, so that the workers don't contend on a shared
+ * atomic. Each shard keeps an estimate of the count of the other shards, which its threads
+ * reconcile every reconcile interval decisions.
+ */
+class ShardedResourceCount {
+public:
+  static constexpr uint32_t NumShards = 16;
+
+  explicit ShardedResourceCount(uint32_t reconcile_interval)
+      : reconcile_interval_(reconcile_interval), shards_(std::make_unique<Shard[]>(NumShards)) {
+    ASSERT(reconcile_interval_ > 0);
+  }
+
+  /**
+   * Adds to the count of the shard of the calling thread. A resource may be released by another
+   * thread than the one that created it, so the count of a shard may be negative.
+   */
+  void add(int64_t amount) { localShard().count_.fetch_add(amount, std::memory_order_relaxed); }
+
+  /**
+   * @return the count summed over all the shards.
+   */
+  uint64_t count() const {
+    int64_t count = 0;
+    for (uint32_t i = 0; i < NumShards; ++i) {
+      count += shards_[i].count_.load(std::memory_order_relaxed);
+    }
+    return std::max<int64_t>(count, 0);
+  }
+
+  /**
+   * Counts a decision of the calling thread, reconciling its estimate of the other shards if due.
+   * @param reconciled supplies whether the estimate was reconciled by this decision, in which case
+   *        the returned estimate is the summed count.
+   * @return the estimate of the count by the calling thread.
+   */
+  uint64_t estimate(bool& reconciled) {
+    Shard& shard = localShard();
+    reconciled =
+        shard.decisions_.fetch_add(1, std::memory_order_relaxed) % reconcile_interval_ == 0;
+    if (reconciled) {
+      shard.other_count_.store(static_cast<int64_t>(count()) -
+                                   shard.count_.load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+    }
+    return std::max<int64_t>(shard.count_.load(std::memory_order_relaxed) +
+                                 shard.other_count_.load(std::memory_order_relaxed),
+                             0);
+  }
+
+private:
+  // The count of the threads of a shard, and their estimate of the count of the other shards. Each
+  // shard has its own cache line, so that the workers don't contend on them.
+  struct alignas(64) Shard {
+    std::atomic<int64_t> count_{};
+    std::atomic<int64_t> other_count_{};
+    std::atomic<uint32_t> decisions_{};
+  };
+
+  // The shard of the calling thread.
+  static uint32_t localShardIndex();
+  Shard& localShard() { return shards_[localShardIndex()]; }
+
+  const uint32_t reconcile_interval_;
+  const std::unique_ptr<Shard[]> shards_;
+};
+
+using ShardedResourceCountPtr = std::unique_ptr<ShardedResourceCount>;
+
 struct ManagedResourceImpl : public BasicResourceLimitImpl {
+  /**
+   * @param reconcile_interval supplies the reconcile interval of the per-worker shards the
+   *        resource is counted in, or zero to count it in a single shared atomic.
+   */
   ManagedResourceImpl(uint64_t max, Runtime::Loader& runtime, const std::string& runtime_key,
-                      Stats::Gauge& open_gauge, Stats::Gauge& remaining)
+                      Stats::Gauge& open_gauge, Stats::Gauge& remaining,
+                      uint32_t reconcile_interval = 0)
       : BasicResourceLimitImpl(max, runtime, runtime_key), open_gauge_(open_gauge),
-        remaining_(remaining) {
+        remaining_(remaining),
+        sharded_count_(reconcile_interval > 0
+                           ? std::make_unique<ShardedResourceCount>(reconcile_interval)
+                           : nullptr) {
     remaining_.set(max);
   }
 
   // BasicResourceLimitImpl
-  bool canCreate() override { return current_ < max(); }
+  bool canCreate() override {
+    if (sharded_count_ != nullptr) {
+      return canCreateSharded();
+    }
+    return current_ < max();
+  }
   void inc() override {
+    if (sharded_count_ != nullptr) {
+      sharded_count_->add(1);
+      return;
+    }
     BasicResourceLimitImpl::inc();
     updateRemaining();
     open_gauge_.set(BasicResourceLimitImpl::canCreate() ? 0 : 1);
   }
   void decBy(uint64_t amount) override {
+    if (sharded_count_ != nullptr) {
+      sharded_count_->add(-static_cast<int64_t>(amount));
+      return;
+    }
     BasicResourceLimitImpl::decBy(amount);
     updateRemaining();
     open_gauge_.set(BasicResourceLimitImpl::canCreate() ? 0 : 1);
   }
+  uint64_t count() const override {
+    return sharded_count_ != nullptr ? sharded_count_->count() : current_.load();
+  }
+
+  /**
+   * The gauges of a sharded resource are only updated when the calling thread reconciles its
+   * estimate, since keeping them exact would need the summed count on every change.
+   */
+  bool canCreateSharded() {
+    bool reconciled;
+    const uint64_t estimate = sharded_count_->estimate(reconciled);
+    const uint64_t max = this->max();
+    if (reconciled) {
+      remaining_.set(max > estimate ? max - estimate : 0);
+      open_gauge_.set(estimate < max ? 0 : 1);
+    }
+    return estimate < max;
+  }
 
   /**
    * We set the gauge instead of incrementing and decrementing because,
@@ -61,6 +171,11 @@ struct ManagedResourceImpl : public BasicResourceLimitImpl {
    * The number of resources remaining before the circuit breaker opens.
    */
   Stats::Gauge& remaining_;
+
+  /**
+   * The per-worker shards of the resource, if it's enforced approximately.
+   */
+  const ShardedResourceCountPtr sharded_count_;
 };
 
 /**
@@ -71,6 +186,12 @@ struct ManagedResourceImpl : public BasicResourceLimitImpl {
  *    occur during high contention.
  * 2) Though atomics are used, it is possible for resources to temporarily go above the supplied
  *    maximums. This should not effect overall behavior.
+ * 3) The retries of a retry budget configured in the cluster are counted in per-worker shards, and
+ *    each worker reconciles its estimate of the retries of the others every ReconcileInterval
+ *    retry decisions. The budget may be exceeded by the retries the other workers made since.
+ * 4) Likewise, if a reconcile interval is supplied for the connections, pending requests and
+ *    requests, they are counted in per-worker shards, and their limits may be exceeded by the
+ *    resources the other workers created since the last reconciliation of the calling worker.
  */
 class ResourceManagerImpl : public ResourceManager {
 public:
@@ -78,13 +199,15 @@ public:
                       uint64_t max_connections, uint64_t max_pending_requests,
                       uint64_t max_requests, uint64_t max_retries, uint64_t max_connection_pools,
                       ClusterCircuitBreakersStats cb_stats, absl::optional<double> budget_percent,
-                      absl::optional<uint32_t> min_retry_concurrency)
+                      absl::optional<uint32_t> min_retry_concurrency,
+                      uint32_t approximate_reconcile_interval = 0)
       : connections_(max_connections, runtime, runtime_key + "max_connections", cb_stats.cx_open_,
-                     cb_stats.remaining_cx_),
+                     cb_stats.remaining_cx_, approximate_reconcile_interval),
         pending_requests_(max_pending_requests, runtime, runtime_key + "max_pending_requests",
-                          cb_stats.rq_pending_open_, cb_stats.remaining_pending_),
+                          cb_stats.rq_pending_open_, cb_stats.remaining_pending_,
+                          approximate_reconcile_interval),
         requests_(max_requests, runtime, runtime_key + "max_requests", cb_stats.rq_open_,
-                  cb_stats.remaining_rq_),
+                  cb_stats.remaining_rq_, approximate_reconcile_interval),
         connection_pools_(max_connection_pools, runtime, runtime_key + "max_connection_pools",
                           cb_stats.cx_pool_open_, cb_stats.remaining_cx_pools_),
         retries_(budget_percent, min_retry_concurrency, max_retries, runtime,
@@ -102,6 +225,8 @@ public:
 private:
   class RetryBudgetImpl : public ResourceLimit {
   public:
+    static constexpr uint32_t ReconcileInterval = 64;
+
     RetryBudgetImpl(absl::optional<double> budget_percent,
                     absl::optional<uint32_t> min_retry_concurrency, uint64_t max_retries,
                     Runtime::Loader& runtime, const std::string& retry_budget_runtime_key,
@@ -113,10 +238,21 @@ private:
           budget_percent_(budget_percent), min_retry_concurrency_(min_retry_concurrency),
           budget_percent_key_(retry_budget_runtime_key + "budget_percent"),
           min_retry_concurrency_key_(retry_budget_runtime_key + "min_retry_concurrency"),
-          requests_(requests), pending_requests_(pending_requests), remaining_(remaining) {}
+          requests_(requests), pending_requests_(pending_requests), open_gauge_(open_gauge),
+          remaining_(remaining) {
+      if (budget_percent_ || min_retry_concurrency_) {
+        // The budget can't be turned off at runtime, so the retries are only counted in the
+        // shards.
+        shards_ = std::make_unique<ShardedResourceCount>(ReconcileInterval);
+        remaining_.set(0);
+      }
+    }
 
     // Envoy::ResourceLimit
     bool canCreate() override {
+      if (shards_ != nullptr) {
+        return estimatedCount() < max();
+      }
       if (!useRetryBudget()) {
         return max_retry_resource_.canCreate();
       }
@@ -124,14 +260,20 @@ private:
       return count() < max();
     }
     void inc() override {
+      if (shards_ != nullptr) {
+        shards_->add(1);
+        return;
+      }
       max_retry_resource_.inc();
       clearRemainingGauge();
     }
-    void dec() override {
-      max_retry_resource_.dec();
-      clearRemainingGauge();
-    }
+    void dec() override { decBy(1); }
     void decBy(uint64_t amount) override {
+      if (shards_ != nullptr) {
+        // The retry may have been counted in the shard of another thread.
+        shards_->add(-static_cast<int64_t>(amount));
+        return;
+      }
       max_retry_resource_.decBy(amount);
       clearRemainingGauge();
     }
@@ -146,16 +288,29 @@ private:
       const uint32_t min_retry_concurrency = runtime_.snapshot().getInteger(
           min_retry_concurrency_key_, min_retry_concurrency_ ? *min_retry_concurrency_ : 3);
 
-      clearRemainingGauge();
+      if (shards_ == nullptr) {
+        clearRemainingGauge();
+      }
 
       // We enforce that the retry concurrency is never allowed to go below the
       // min_retry_concurrency, even if the configured percent of the current active requests
       // yields a value that is smaller.
       return std::max<uint64_t>(budget_percent / 100.0 * current_active, min_retry_concurrency);
     }
-    uint64_t count() const override { return max_retry_resource_.count(); }
+    uint64_t count() const override {
+      return shards_ != nullptr ? shards_->count() : max_retry_resource_.count();
+    }
 
   private:
+    uint64_t estimatedCount() {
+      bool reconciled;
+      const uint64_t retries = shards_->estimate(reconciled);
+      if (reconciled) {
+        open_gauge_.set(retries < max() ? 0 : 1);
+      }
+      return retries;
+    }
+
     bool useRetryBudget() const {
       return runtime_.snapshot().get(budget_percent_key_).has_value() ||
              runtime_.snapshot().get(min_retry_concurrency_key_).has_value() || budget_percent_ ||
@@ -181,7 +336,10 @@ private:
     const std::string min_retry_concurrency_key_;
     const ResourceLimit& requests_;
     const ResourceLimit& pending_requests_;
+    Stats::Gauge& open_gauge_;
     Stats::Gauge& remaining_;
+    // The shards of the retries, if the retry budget is configured in the cluster.
+    ShardedResourceCountPtr shards_;
   };
 
   ManagedResourceImpl connections_;
@@ -11,6 +11,7 @@
 #include "common/upstream/load_balancer_impl.h"
 
 #include "absl/container/inlined_vector.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
@@ -95,7 +96,7 @@ HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h, uint32_t a
     midp = (midp + attempt) % ring_.size();
   }
 
-  return ring_[midp].host_;
+  return hosts_[ring_[midp].host_index_];
 }
 
 using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
@@ -147,36 +148,39 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   double target_hashes = 0.0;
   uint64_t min_hashes_per_host = ring_size;
   uint64_t max_hashes_per_host = 0;
+  hosts_.reserve(normalized_host_weights.size());
   for (const auto& entry : normalized_host_weights) {
     const auto& host = entry.first;
     const absl::string_view key_to_hash = hashKey(host, use_hostname_for_hashing);
     ASSERT(!key_to_hash.empty());
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
 
+    // The key is the host key, an underscore and the index of the hash, which is formatted in
+    // place after the underscore.
     hash_key_buffer.assign(key_to_hash.begin(), key_to_hash.end());
     hash_key_buffer.emplace_back('_');
-    auto offset_start = hash_key_buffer.end();
+    const size_t offset_start = hash_key_buffer.size();
+    hash_key_buffer.resize(offset_start + absl::numbers_internal::kFastToBufferSize);
 
     // As noted above: maintain current_hashes and target_hashes as running sums across the entire
     // host set. `i` is needed only to construct the hash key, and tally min/max hashes per host.
     target_hashes += scale * entry.second;
     uint64_t i = 0;
     while (current_hashes < target_hashes) {
-      const std::string i_str = absl::StrCat("", i);
-      hash_key_buffer.insert(offset_start, i_str.begin(), i_str.end());
-
-      absl::string_view hash_key(static_cast<char*>(hash_key_buffer.data()),
-                                 hash_key_buffer.size());
+      char* const offset_end =
+          absl::numbers_internal::FastIntToBuffer(i, hash_key_buffer.data() + offset_start);
+      absl::string_view hash_key(hash_key_buffer.data(), offset_end - hash_key_buffer.data());
 
       const uint64_t hash =
           (hash_function == HashFunction::Cluster_RingHashLbConfig_HashFunction_MURMUR_HASH_2)
               ? MurmurHash::murmurHash2(hash_key, MurmurHash::STD_HASH_SEED)
               : HashUtil::xxHash64(hash_key);
 
-      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+      ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key, hash);
+      ring_.push_back({hash, host_index});
       ++i;
       ++current_hashes;
-      hash_key_buffer.erase(offset_start, hash_key_buffer.end());
     }
     min_hashes_per_host = std::min(i, min_hashes_per_host);
     max_hashes_per_host = std::max(i, max_hashes_per_host);
@@ -187,7 +191,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   });
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
     for (const auto& entry : ring_) {
-      const absl::string_view key_to_hash = hashKey(entry.host_, use_hostname_for_hashing);
+      const absl::string_view key_to_hash =
+          hashKey(hosts_[entry.host_index_], use_hostname_for_hashing);
       ENVOY_LOG(trace, "ring hash: host={} hash={}", key_to_hash, entry.hash_);
     }
   }
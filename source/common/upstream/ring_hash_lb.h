@@ -51,9 +51,11 @@ public:
 private:
   using HashFunction = envoy::config::cluster::v3::Cluster::RingHashLbConfig::HashFunction;
 
+  // Entries refer to hosts by index into Ring::hosts_, which keeps them small to sort and saves
+  // a reference count update for each of the (possibly millions of) entries.
   struct RingEntry {
     uint64_t hash_;
-    HostConstSharedPtr host_;
+    uint32_t host_index_;
   };
 
   struct Ring : public HashingLoadBalancer {
@@ -64,6 +66,7 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
+    std::vector<HostConstSharedPtr> hosts_;
     std::vector<RingEntry> ring_;
 
     RingHashLoadBalancerStats& stats_;
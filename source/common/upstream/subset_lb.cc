@@ -1,5 +1,6 @@
 #include "common/upstream/subset_lb.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
@@ -7,6 +8,7 @@
 #include "envoy/runtime/runtime.h"
 
 #include "common/common/assert.h"
+#include "common/common/hash.h"
 #include "common/config/metadata.h"
 #include "common/config/well_known_names.h"
 #include "common/protobuf/utility.h"
@@ -68,6 +70,7 @@ SubsetLoadBalancer::SubsetLoadBalancer(
 
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   refreshSubsets();
+  rebuildSubsetIndex();
 
   // This must happen after `initSubsetSelectorMap()` because that initializes `single_`.
   rebuildSingle();
@@ -98,6 +101,7 @@ SubsetLoadBalancer::SubsetLoadBalancer(
         }
 
         purgeEmptySubsets(subsets_);
+        rebuildSubsetIndex();
       });
 }
 
@@ -321,7 +325,7 @@ SubsetLoadBalancer::tryFindSelectorFallbackParams(LoadBalancerContext* context)
   if (!match_criteria) {
     return absl::nullopt;
   }
-  const auto match_criteria_vec = match_criteria->metadataMatchCriteria();
+  const auto& match_criteria_vec = match_criteria->metadataMatchCriteria();
   SubsetSelectorMapPtr selectors = selectors_;
   if (selectors == nullptr) {
     return absl::nullopt;
@@ -384,7 +388,7 @@ HostConstSharedPtr SubsetLoadBalancer::tryChooseHostFromContext(LoadBalancerCont
   }
 
   // Route has metadata match criteria defined, see if we have a matching subset.
-  LbSubsetEntryPtr entry = findSubset(match_criteria->metadataMatchCriteria());
+  LbSubsetEntryPtr entry = findIndexedSubset(match_criteria->metadataMatchCriteria());
   if (entry == nullptr || !entry->active()) {
     // No matching subset or subset not active: use fallback policy.
     return nullptr;
@@ -434,6 +438,68 @@ SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findSubset(
   return nullptr;
 }
 
+// Finds the subset for the given metadata match criteria (which must be lexically sorted by key)
+// in subset_index_. Unlike findSubset(), returns nullptr rather than an uninitialized entry if no
+// subset matches, which callers treat the same.
+SubsetLoadBalancer::LbSubsetEntryPtr SubsetLoadBalancer::findIndexedSubset(
+    const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& match_criteria) {
+  uint64_t hash = 0;
+  for (const auto& match_criterion : match_criteria) {
+    hash = subsetKeyHash(hash, match_criterion->name(), match_criterion->value());
+  }
+
+  const auto it = subset_index_.find(hash);
+  if (it == subset_index_.end()) {
+    // Every initialized subset is indexed.
+    return nullptr;
+  }
+
+  const SubsetKey& key = it->second.key_;
+  if (key.size() == match_criteria.size() &&
+      std::equal(key.begin(), key.end(), match_criteria.begin(),
+                 [](const std::pair<std::string, HashedValue>& kv,
+                    const Router::MetadataMatchCriterionConstSharedPtr& match_criterion) {
+                   return kv.first == match_criterion->name() &&
+                          kv.second == match_criterion->value();
+                 })) {
+    return it->second.entry_;
+  }
+
+  // Another subset whose key hashes the same took the slot. This is rare enough to not bother
+  // with chaining, walk the trie instead.
+  return findSubset(match_criteria);
+}
+
+void SubsetLoadBalancer::rebuildSubsetIndex() {
+  subset_index_.clear();
+  SubsetKey key;
+  indexSubsets(subsets_, key);
+}
+
+void SubsetLoadBalancer::indexSubsets(const LbSubsetMap& subsets, SubsetKey& key) {
+  for (const auto& vsm : subsets) {
+    for (const auto& em : vsm.second) {
+      key.emplace_back(vsm.first, em.first);
+      const LbSubsetEntryPtr& entry = em.second;
+      if (entry->initialized()) {
+        uint64_t hash = 0;
+        for (const auto& kv : key) {
+          hash = subsetKeyHash(hash, kv.first, kv.second);
+        }
+        // On a collision the first subset keeps the slot, see findIndexedSubset().
+        subset_index_.try_emplace(hash, SubsetIndexEntry{key, entry});
+      }
+      indexSubsets(entry->children_, key);
+      key.pop_back();
+    }
+  }
+}
+
+uint64_t SubsetLoadBalancer::subsetKeyHash(uint64_t hash, absl::string_view name,
+                                           const HashedValue& value) {
+  return HashUtil::xxHash64(name, hash + value.hash());
+}
+
 void SubsetLoadBalancer::updateFallbackSubset(uint32_t priority, const HostVector& hosts_added,
                                               const HostVector& hosts_removed) {
 
@@ -757,6 +823,12 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
                                                    subset_lb.random_, subset_lb.common_config_);
     break;
 
+  case LoadBalancerType::PeakEwma:
+    lb_ = std::make_unique<PeakEwmaLoadBalancer>(*this, subset_lb.original_local_priority_set_,
+                                                 subset_lb.stats_, subset_lb.runtime_,
+                                                 subset_lb.random_, subset_lb.common_config_);
+    break;
+
   case LoadBalancerType::RingHash:
     // TODO(mattklein123): The ring hash LB is thread aware, but currently the subset LB is not.
     // We should make the subset LB thread aware since the calculations are costly, and then we
@@ -15,6 +15,7 @@
 #include "common/protobuf/utility.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/types/optional.h"
 
@@ -193,6 +194,15 @@ private:
     PrioritySubsetImplPtr priority_subset_;
   };
 
+  // The full key of a subset: the names and values on the path to it in subsets_.
+  using SubsetKey = std::vector<std::pair<std::string, HashedValue>>;
+
+  struct SubsetIndexEntry {
+    // Compared on lookup, to tell apart subsets whose keys hash the same.
+    SubsetKey key_;
+    LbSubsetEntryPtr entry_;
+  };
+
   // Create filtered default subset (if necessary) and other subsets based on current hosts.
   void refreshSubsets();
   void refreshSubsets(uint32_t priority);
@@ -222,6 +232,11 @@ private:
 
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  LbSubsetEntryPtr
+  findIndexedSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
+  void rebuildSubsetIndex();
+  void indexSubsets(const LbSubsetMap& subsets, SubsetKey& key);
+  static uint64_t subsetKeyHash(uint64_t hash, absl::string_view name, const HashedValue& value);
 
   LbSubsetEntryPtr findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
                                       uint32_t idx);
@@ -260,6 +275,9 @@ private:
 
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
+  // Maps the key hash of every initialized subset in subsets_ to the subset, so that picking a
+  // subset takes a single lookup instead of one per criterion. Rebuilt after each host update.
+  absl::flat_hash_map<uint64_t, SubsetIndexEntry> subset_index_;
   // Forms a trie-like structure of lexically sorted keys+fallback policy from subset
   // selectors configuration
   SubsetSelectorMapPtr selectors_;
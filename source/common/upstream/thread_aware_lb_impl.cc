@@ -185,6 +185,57 @@ LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
   return lb;
 }
 
+ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::BoundedLoadHashingLoadBalancer(
+    HashingLoadBalancerSharedPtr hashing_lb_ptr, NormalizedHostWeightVector normalized_host_weights,
+    uint32_t hash_balance_factor)
+    : hashing_lb_ptr_(std::move(hashing_lb_ptr)),
+      normalized_host_weights_(std::move(normalized_host_weights)),
+      hash_balance_factor_(hash_balance_factor) {
+  ASSERT(hashing_lb_ptr_ != nullptr);
+  ASSERT(hash_balance_factor > 0);
+
+  const uint32_t num_hosts = normalized_host_weights_.size();
+  host_indexes_.reserve(num_hosts);
+  for (uint32_t i = 0; i < num_hosts; i++) {
+    host_indexes_.emplace(normalized_host_weights_[i].first.get(), i);
+  }
+  if (num_hosts == 0) {
+    return;
+  }
+
+  // The random sequence of a probe sequence is seeded by its index, so the same hash gets the same
+  // sequence of hosts all the time.
+  // Not using Random::RandomGenerator as it does not take a seed. Seeded RNG is a requirement
+  // here as we need the same shuffle sequence for the same hash every time.
+  // Further, not using std::default_random_engine and std::uniform_int_distribution as they
+  // are not consistent across Linux and Windows platforms.
+  num_probe_sequences_ =
+      std::max<uint32_t>(std::min(MaxProbeSequences, MaxProbeSequenceEntries / num_hosts), 1);
+  probe_sequences_.resize(static_cast<size_t>(num_probe_sequences_) * num_hosts);
+  for (uint32_t seed = 0; seed < num_probe_sequences_; seed++) {
+    std::mt19937 random(seed);
+
+    // generates a random number in the range [0,k) uniformly.
+    auto uniform_int = [](std::mt19937& random, uint32_t k) -> uint32_t {
+      uint32_t x = k;
+      while (x >= k) {
+        x = random() / ((static_cast<uint64_t>(random.max()) + 1u) / k);
+      }
+      return x;
+    };
+
+    // The random shuffle algorithm
+    uint32_t* host_index = &probe_sequences_[static_cast<size_t>(seed) * num_hosts];
+    for (uint32_t i = 0; i < num_hosts; i++) {
+      host_index[i] = i;
+    }
+    for (uint32_t i = 0; i < num_hosts; i++) {
+      const uint32_t j = uniform_int(random, num_hosts - i);
+      std::swap(host_index[i], host_index[i + j]);
+    }
+  }
+}
+
 double ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::hostOverloadFactor(
     const Host& host, double weight) const {
   // TODO(scheler): This will not work if rq_active cluster stat is disabled, need to detect
@@ -224,6 +275,8 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   //
   // This is an O(N) algorithm, unlike other load balancers. Using a lower `hash_balance_factor`
   // results in more hosts being probed, so use a higher value if you require better performance.
+  // The random jumps are precomputed as a fixed set of probe sequences, so probing only reads the
+  // load of the hosts.
 
   if (normalized_host_weights_.empty()) {
     return nullptr;
@@ -233,7 +286,7 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   if (host == nullptr) {
     return nullptr;
   }
-  const double weight = normalized_host_weights_map_.at(host);
+  const double weight = normalized_host_weights_[host_indexes_.at(host.get())].second;
   double overload_factor = hostOverloadFactor(*host, weight);
   if (overload_factor <= 1.0) {
     ENVOY_LOG_MISC(debug,
@@ -244,37 +297,14 @@ ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::chooseHost(uint64_t
   }
 
   // When a host is overloaded, we choose the next host in a random manner rather than picking the
-  // next one in the ring. The random sequence is seeded by the hash, so the same input gets the
-  // same sequence of hosts all the time.
+  // next one in the ring, following the probe sequence of the hash.
   const uint32_t num_hosts = normalized_host_weights_.size();
-  auto host_index = std::vector<uint32_t>(num_hosts);
-  for (uint32_t i = 0; i < num_hosts; i++) {
-    host_index[i] = i;
-  }
-
-  // Not using Random::RandomGenerator as it does not take a seed. Seeded RNG is a requirement
-  // here as we need the same shuffle sequence for the same hash every time.
-  // Further, not using std::default_random_engine and std::uniform_int_distribution as they
-  // are not consistent across Linux and Windows platforms.
-  const uint64_t seed = hash;
-  std::mt19937 random(seed);
-
-  // generates a random number in the range [0,k) uniformly.
-  auto uniform_int = [](std::mt19937& random, uint32_t k) -> uint32_t {
-    uint32_t x = k;
-    while (x >= k) {
-      x = random() / ((static_cast<uint64_t>(random.max()) + 1u) / k);
-    }
-    return x;
-  };
+  const uint32_t* host_index =
+      &probe_sequences_[static_cast<size_t>(hash % num_probe_sequences_) * num_hosts];
 
   HostConstSharedPtr alt_host, least_overloaded_host = host;
   double least_overload_factor = overload_factor;
   for (uint32_t i = 0; i < num_hosts; i++) {
-    // The random shuffle algorithm
-    const uint32_t j = uniform_int(random, num_hosts - i);
-    std::swap(host_index[i], host_index[i + j]);
-
     const uint32_t k = host_index[i];
     alt_host = normalized_host_weights_[k].first;
     if (alt_host == host) {
@@ -8,6 +8,7 @@
 #include "common/config/well_known_names.h"
 #include "common/upstream/load_balancer_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 
@@ -15,7 +16,6 @@ namespace Envoy {
 namespace Upstream {
 
 using NormalizedHostWeightVector = std::vector<std::pair<HostConstSharedPtr, double>>;
-using NormalizedHostWeightMap = std::map<HostConstSharedPtr, double>;
 
 class ThreadAwareLoadBalancerBase : public LoadBalancerBase, public ThreadAwareLoadBalancer {
 public:
@@ -54,34 +54,29 @@ public:
    */
   class BoundedLoadHashingLoadBalancer : public HashingLoadBalancer {
   public:
+    // The maximum number of probe sequences, and of host indexes in all the probe sequences.
+    static constexpr uint32_t MaxProbeSequences = 64;
+    static constexpr uint32_t MaxProbeSequenceEntries = 1 << 18;
+
     BoundedLoadHashingLoadBalancer(HashingLoadBalancerSharedPtr hashing_lb_ptr,
                                    NormalizedHostWeightVector normalized_host_weights,
-                                   uint32_t hash_balance_factor)
-        : normalized_host_weights_map_(initNormalizedHostWeightMap(normalized_host_weights)),
-          hashing_lb_ptr_(std::move(hashing_lb_ptr)),
-          normalized_host_weights_(std::move(normalized_host_weights)),
-          hash_balance_factor_(hash_balance_factor) {
-      ASSERT(hashing_lb_ptr_ != nullptr);
-      ASSERT(hash_balance_factor > 0);
-    }
+                                   uint32_t hash_balance_factor);
     HostConstSharedPtr chooseHost(uint64_t hash, uint32_t attempt) const override;
 
   protected:
     virtual double hostOverloadFactor(const Host& host, double weight) const;
-    const NormalizedHostWeightMap normalized_host_weights_map_;
 
   private:
-    const NormalizedHostWeightMap
-    initNormalizedHostWeightMap(const NormalizedHostWeightVector& normalized_host_weights) {
-      NormalizedHostWeightMap normalized_host_weights_map;
-      for (auto const& item : normalized_host_weights) {
-        normalized_host_weights_map[item.first] = item.second;
-      }
-      return normalized_host_weights_map;
-    }
     const HashingLoadBalancerSharedPtr hashing_lb_ptr_;
     const NormalizedHostWeightVector normalized_host_weights_;
+    // The index of each host in normalized_host_weights_.
+    absl::flat_hash_map<const Host*, uint32_t> host_indexes_;
     const uint32_t hash_balance_factor_;
+    // The orders in which the hosts are probed when the host chosen for a hash is overloaded, each
+    // a permutation of the host indexes, stored one after the other. The hashes are spread over
+    // the probe sequences, which are computed once so that probing doesn't shuffle the hosts.
+    uint32_t num_probe_sequences_{};
+    std::vector<uint32_t> probe_sequences_;
   };
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
@@ -1,6 +1,8 @@
 #include "common/upstream/upstream_impl.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <list>
@@ -36,6 +38,7 @@
 #include "common/http/http2/codec_stats.h"
 #include "common/http/utility.h"
 #include "common/network/address_impl.h"
+#include "common/network/happy_eyeballs_connection_impl.h"
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/socket_option_impl.h"
@@ -257,7 +260,8 @@ HostDescriptionImpl::HostDescriptionImpl(
       locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
       priority_(priority),
       socket_factory_(resolveTransportSocketFactory(dest_address, metadata_.get())),
-      creation_time_(time_source.monotonicTime()) {
+      creation_time_(time_source.monotonicTime()),
+      latency_estimate_(cluster->lbPeakEwmaConfig()) {
   if (health_check_config.port_value() != 0 && dest_address->type() != Network::Address::Type::Ip) {
     // Setting the health check port to non-0 only works for IP-type addresses. Setting the port
     // for a pipe address is a misconfiguration. Throw an exception.
@@ -270,6 +274,72 @@ HostDescriptionImpl::HostDescriptionImpl(
           : Network::Utility::getAddressWithPort(*dest_address, health_check_config.port_value());
 }
 
+PeakEwmaLatencyEstimate::PeakEwmaLatencyEstimate(
+    const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>& config)
+    : decay_time_ns_(config.has_value() && config->has_decay_time()
+                         ? Protobuf::util::TimeUtil::DurationToNanoseconds(config->decay_time())
+                         : 10e9),
+      estimate_(config.has_value() && config->has_default_latency()
+                    ? Protobuf::util::TimeUtil::DurationToMicroseconds(config->default_latency())
+                    : 10e3) {}
+
+void PeakEwmaLatencyEstimate::observe(std::chrono::microseconds latency, MonotonicTime now) {
+  const double sample = latency.count();
+  const int64_t now_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+  const int64_t last_sample_ns = last_sample_ns_.exchange(now_ns, std::memory_order_relaxed);
+  const double estimate = estimate_.load(std::memory_order_relaxed);
+  if (last_sample_ns == NoSamples || sample > estimate) {
+    // The first sample replaces the default latency, and the peak is taken as is so that a slow
+    // host is penalized right away.
+    estimate_.store(sample, std::memory_order_relaxed);
+    return;
+  }
+  // Weigh the previous estimate by how recent it is, so that the decay doesn't depend on the rate
+  // of samples.
+  const double elapsed_ns = std::max<int64_t>(now_ns - last_sample_ns, 0);
+  const double weight = std::exp(-elapsed_ns / decay_time_ns_);
+  estimate_.store(estimate * weight + sample * (1 - weight), std::memory_order_relaxed);
+}
+
+void LoadReportHostsImpl::add(const HostDescriptionConstSharedPtr& host) {
+  // Only the first load of the host since it was last taken takes the lock.
+  std::atomic<bool>& pending = host->stats().load_report_pending_;
+  if (!enabled_.load(std::memory_order_relaxed) || pending.load(std::memory_order_relaxed) ||
+      pending.exchange(true)) {
+    return;
+  }
+  Thread::LockGuard lock(mutex_);
+  hosts_.emplace_back(host);
+}
+
+std::vector<HostDescriptionConstSharedPtr> LoadReportHostsImpl::take() {
+  std::vector<std::weak_ptr<const HostDescription>> hosts;
+  {
+    Thread::LockGuard lock(mutex_);
+    hosts.swap(hosts_);
+  }
+  std::vector<HostDescriptionConstSharedPtr> live_hosts;
+  live_hosts.reserve(hosts.size());
+  for (const auto& weak_host : hosts) {
+    HostDescriptionConstSharedPtr host = weak_host.lock();
+    if (host != nullptr) {
+      // Cleared before the caller reads the load stats of the host, so that the load received
+      // after they're read adds the host again.
+      host->stats().load_report_pending_.store(false);
+      live_hosts.push_back(std::move(host));
+    }
+  }
+  return live_hosts;
+}
+
+void LoadReportHostsImpl::setEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!enabled) {
+    take();
+  }
+}
+
 Network::TransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFactory(
     const Network::Address::InstanceConstSharedPtr& dest_address,
     const envoy::config::core::v3::Metadata* metadata) const {
@@ -284,7 +354,7 @@ Network::TransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFact
 Host::CreateConnectionData HostImpl::createConnection(
     Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
     Network::TransportSocketOptionsSharedPtr transport_socket_options) const {
-  return {createConnection(dispatcher, *cluster_, address_, socket_factory_, options,
+  return {createConnection(dispatcher, *cluster_, address_, {}, socket_factory_, options,
                            transport_socket_options),
           shared_from_this()};
 }
@@ -315,17 +385,18 @@ Host::CreateConnectionData HostImpl::createHealthCheckConnection(
   Network::TransportSocketFactory& factory =
       (metadata != nullptr) ? resolveTransportSocketFactory(healthCheckAddress(), metadata)
                             : socket_factory_;
-  return {createConnection(dispatcher, *cluster_, healthCheckAddress(), factory, nullptr,
+  return {createConnection(dispatcher, *cluster_, healthCheckAddress(), {}, factory, nullptr,
                            transport_socket_options),
           shared_from_this()};
 }
 
-Network::ClientConnectionPtr
-HostImpl::createConnection(Event::Dispatcher& dispatcher, const ClusterInfo& cluster,
-                           const Network::Address::InstanceConstSharedPtr& address,
-                           Network::TransportSocketFactory& socket_factory,
-                           const Network::ConnectionSocket::OptionsSharedPtr& options,
-                           Network::TransportSocketOptionsSharedPtr transport_socket_options) {
+Network::ClientConnectionPtr HostImpl::createConnection(
+    Event::Dispatcher& dispatcher, const ClusterInfo& cluster,
+    const Network::Address::InstanceConstSharedPtr& address,
+    const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
+    Network::TransportSocketFactory& socket_factory,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    Network::TransportSocketOptionsSharedPtr transport_socket_options) {
   Network::ConnectionSocket::OptionsSharedPtr connection_options;
   if (cluster.clusterSocketOptions() != nullptr) {
     if (options) {
@@ -340,10 +411,18 @@ HostImpl::createConnection(Event::Dispatcher& dispatcher, const ClusterInfo& clu
     connection_options = options;
   }
   ASSERT(!address->envoyInternalAddress());
-  Network::ClientConnectionPtr connection = dispatcher.createClientConnection(
-      address, cluster.sourceAddress(),
-      socket_factory.createTransportSocket(std::move(transport_socket_options)),
-      connection_options);
+  Network::ClientConnectionPtr connection;
+  if (address_list.size() > 1 &&
+      Runtime::runtimeFeatureEnabled("envoy.reloadable_features.upstream_happy_eyeballs")) {
+    connection = std::make_unique<Network::HappyEyeballsConnectionImpl>(
+        dispatcher, address_list, cluster.sourceAddress(), socket_factory,
+        std::move(transport_socket_options), connection_options);
+  } else {
+    connection = dispatcher.createClientConnection(
+        address, cluster.sourceAddress(),
+        socket_factory.createTransportSocket(std::move(transport_socket_options)),
+        connection_options);
+  }
   connection->setBufferLimits(cluster.perConnectionBufferLimitBytes());
   cluster.createNetworkFilterChain(*connection);
   return connection;
@@ -747,10 +826,16 @@ ClusterInfoImpl::ClusterInfoImpl(
           config.preconnect_policy(), per_upstream_preconnect_ratio, 1.0)),
       peekahead_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.preconnect_policy(),
                                                        predictive_preconnect_ratio, 0)),
+      prewarm_hosts_(config.preconnect_policy().prewarm_hosts()),
       per_connection_buffer_limit_bytes_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
       socket_matcher_(std::move(socket_matcher)), stats_scope_(std::move(stats_scope)),
-      stats_(generateStats(*stats_scope_, factory_context.clusterManager().clusterStatNames())),
+      deferred_stats_scope_(factory_context.clusterManager().deferredClusterStats()
+                                ? std::make_unique<Stats::DeferredScope>(*stats_scope_)
+                                : nullptr),
+      stats_(generateStats(deferred_stats_scope_ != nullptr ? *deferred_stats_scope_
+                                                            : *stats_scope_,
+                           factory_context.clusterManager().clusterStatNames())),
       load_report_stats_store_(stats_scope_->symbolTable()),
       load_report_stats_(generateLoadReportStats(
           load_report_stats_store_, factory_context.clusterManager().clusterLoadReportStatNames())),
@@ -767,6 +852,7 @@ ClusterInfoImpl::ClusterInfoImpl(
       lb_least_request_config_(config.least_request_lb_config()),
       lb_ring_hash_config_(config.ring_hash_lb_config()),
       lb_maglev_config_(config.maglev_lb_config()),
+      lb_peak_ewma_config_(config.peak_ewma_lb_config()),
       lb_original_dst_config_(config.original_dst_lb_config()),
       upstream_config_(config.has_upstream_config()
                            ? absl::make_optional<envoy::config::core::v3::TypedExtensionConfig>(
@@ -780,6 +866,8 @@ ClusterInfoImpl::ClusterInfoImpl(
       drain_connections_on_host_removal_(config.ignore_health_on_host_removal()),
       connection_pool_per_downstream_connection_(
           config.connection_pool_per_downstream_connection()),
+      worker_partitions_(
+          std::max<uint32_t>(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, worker_partitions, 1), 1)),
       warm_hosts_(!config.health_checks().empty() &&
                   common_lb_config_.ignore_new_hosts_until_first_hc()),
       cluster_type_(
@@ -821,6 +909,9 @@ ClusterInfoImpl::ClusterInfoImpl(
   case envoy::config::cluster::v3::Cluster::MAGLEV:
     lb_type_ = LoadBalancerType::Maglev;
     break;
+  case envoy::config::cluster::v3::Cluster::PEAK_EWMA:
+    lb_type_ = LoadBalancerType::PeakEwma;
+    break;
   case envoy::config::cluster::v3::Cluster::CLUSTER_PROVIDED:
     if (config.has_lb_subset_config()) {
       throw EnvoyException(
@@ -841,6 +932,11 @@ ClusterInfoImpl::ClusterInfoImpl(
         name_));
   }
 
+  if (config.preconnect_policy().has_rate_based_preconnect_window()) {
+    rate_based_preconnect_window_ = std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+        config.preconnect_policy().rate_based_preconnect_window()));
+  }
+
   if (http_protocol_options_->common_http_protocol_options_.has_idle_timeout()) {
     idle_timeout_ = std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
         http_protocol_options_->common_http_protocol_options_.idle_timeout()));
@@ -1318,6 +1414,7 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::config::cluster::v3::Cluste
 
   absl::optional<double> budget_percent;
   absl::optional<uint32_t> min_retry_concurrency;
+  uint32_t approximate_reconcile_interval = 0;
   if (it != thresholds.cend()) {
     max_connections = PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connections, max_connections);
     max_pending_requests =
@@ -1328,13 +1425,17 @@ ClusterInfoImpl::ResourceManagers::load(const envoy::config::cluster::v3::Cluste
     max_connection_pools =
         PROTOBUF_GET_WRAPPED_OR_DEFAULT(*it, max_connection_pools, max_connection_pools);
     std::tie(budget_percent, min_retry_concurrency) = ClusterInfoImpl::getRetryBudgetParams(*it);
+    if (it->has_approximate_limits()) {
+      approximate_reconcile_interval =
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(it->approximate_limits(), reconcile_interval, 64);
+    }
   }
   return std::make_unique<ResourceManagerImpl>(
       runtime, runtime_prefix, max_connections, max_pending_requests, max_requests, max_retries,
       max_connection_pools,
       ClusterInfoImpl::generateCircuitBreakersStats(stats_scope, priority_stat_name,
                                                     track_remaining, circuit_breakers_stat_names_),
-      budget_percent, min_retry_concurrency);
+      budget_percent, min_retry_concurrency, approximate_reconcile_interval);
 }
 
 PriorityStateManager::PriorityStateManager(ClusterImplBase& cluster,
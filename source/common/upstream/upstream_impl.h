@@ -5,6 +5,7 @@
 #include <chrono>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
@@ -49,6 +50,7 @@
 #include "common/init/manager_impl.h"
 #include "common/network/utility.h"
 #include "common/shared_pool/shared_pool.h"
+#include "common/stats/deferred_scope.h"
 #include "common/stats/isolated_store_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
@@ -74,6 +76,46 @@ public:
   void setUnhealthy(UnhealthyType) override {}
 };
 
+/**
+ * Implementation of Upstream::LatencyEstimate. The estimate is shared by all workers and updated
+ * without locking: samples that race may overwrite each other, which an estimate can tolerate.
+ */
+class PeakEwmaLatencyEstimate : public LatencyEstimate {
+public:
+  explicit PeakEwmaLatencyEstimate(
+      const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>& config);
+
+  // Upstream::LatencyEstimate
+  void observe(std::chrono::microseconds latency, MonotonicTime now) override;
+  double value() const override { return estimate_.load(std::memory_order_relaxed); }
+
+private:
+  // Marks an estimate that is still the default latency.
+  static constexpr int64_t NoSamples = std::numeric_limits<int64_t>::min();
+
+  const double decay_time_ns_;
+  std::atomic<double> estimate_;
+  std::atomic<int64_t> last_sample_ns_{NoSamples};
+};
+
+/**
+ * Implementation of Upstream::LoadReportHosts. The hosts are held weakly, so that the hosts
+ * removed from the cluster are released, and don't keep their cluster alive.
+ */
+class LoadReportHostsImpl : public LoadReportHosts {
+public:
+  // Upstream::LoadReportHosts
+  void add(const HostDescriptionConstSharedPtr& host) override;
+  std::vector<HostDescriptionConstSharedPtr> take() override;
+  bool enabled() const override { return enabled_.load(std::memory_order_relaxed); }
+  void setEnabled(bool enabled) override;
+
+private:
+  std::atomic<bool> enabled_{};
+  Thread::MutexBasicLockable mutex_;
+  std::vector<std::weak_ptr<const HostDescription>> hosts_ ABSL_GUARDED_BY(mutex_);
+};
+
 /**
  * Implementation of Upstream::HostDescription.
  */
@@ -145,6 +187,7 @@ public:
   resolveTransportSocketFactory(const Network::Address::InstanceConstSharedPtr& dest_address,
                                 const envoy::config::core::v3::Metadata* metadata) const;
   MonotonicTime creationTime() const override { return creation_time_; }
+  LatencyEstimate& latencyEstimate() const override { return latency_estimate_; }
 
 protected:
   ClusterInfoConstSharedPtr cluster_;
@@ -163,6 +206,7 @@ protected:
   std::atomic<uint32_t> priority_;
   Network::TransportSocketFactory& socket_factory_;
   const MonotonicTime creation_time_;
+  mutable PeakEwmaLatencyEstimate latency_estimate_;
 };
 
 /**
@@ -237,9 +281,12 @@ public:
   void used(bool new_used) override { used_ = new_used; }
 
 protected:
+  // Races the connection attempts to the addresses of the address list if it has more than one,
+  // and connects to the address otherwise.
   static Network::ClientConnectionPtr
   createConnection(Event::Dispatcher& dispatcher, const ClusterInfo& cluster,
                    const Network::Address::InstanceConstSharedPtr& address,
+                   const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
                    Network::TransportSocketFactory& socket_factory,
                    const Network::ConnectionSocket::OptionsSharedPtr& options,
                    Network::TransportSocketOptionsSharedPtr transport_socket_options);
@@ -552,6 +599,10 @@ public:
   }
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  absl::optional<std::chrono::milliseconds> rateBasedPreconnectWindow() const override {
+    return rate_based_preconnect_window_;
+  }
+  bool prewarmHosts() const override { return prewarm_hosts_; }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -588,6 +639,10 @@ public:
   lbMaglevConfig() const override {
     return lb_maglev_config_;
   }
+  const absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const override {
+    return lb_peak_ewma_config_;
+  }
   const absl::optional<envoy::config::cluster::v3::Cluster::OriginalDstLbConfig>&
   lbOriginalDstConfig() const override {
     return lb_original_dst_config_;
@@ -616,6 +671,7 @@ public:
   }
 
   ClusterLoadReportStats& loadReportStats() const override { return load_report_stats_; }
+  LoadReportHosts& loadReportHosts() const override { return load_report_hosts_; }
 
   ClusterTimeoutBudgetStatsOptRef timeoutBudgetStats() const override {
     if (optional_cluster_stats_ == nullptr ||
@@ -641,6 +697,7 @@ public:
   bool connectionPoolPerDownstreamConnection() const override {
     return connection_pool_per_downstream_connection_;
   }
+  uint32_t workerPartitions() const override { return worker_partitions_; }
   bool warmHosts() const override { return warm_hosts_; }
   const absl::optional<envoy::config::core::v3::UpstreamHttpProtocolOptions>&
   upstreamHttpProtocolOptions() const override {
@@ -699,12 +756,17 @@ private:
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const float per_upstream_preconnect_ratio_;
   const float peekahead_ratio_;
+  absl::optional<std::chrono::milliseconds> rate_based_preconnect_window_;
+  const bool prewarm_hosts_;
   const uint32_t per_connection_buffer_limit_bytes_;
   TransportSocketMatcherPtr socket_matcher_;
   Stats::ScopePtr stats_scope_;
+  // Set if the stats of the cluster are only created when first written.
+  const std::unique_ptr<Stats::DeferredScope> deferred_stats_scope_;
   mutable ClusterStats stats_;
   Stats::IsolatedStoreImpl load_report_stats_store_;
   mutable ClusterLoadReportStats load_report_stats_;
+  mutable LoadReportHostsImpl load_report_hosts_;
   const std::unique_ptr<OptionalClusterStats> optional_cluster_stats_;
   const uint64_t features_;
   mutable ResourceManagers resource_managers_;
@@ -715,6 +777,7 @@ private:
       lb_least_request_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::RingHashLbConfig> lb_ring_hash_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::MaglevLbConfig> lb_maglev_config_;
+  absl::optional<envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig> lb_peak_ewma_config_;
   absl::optional<envoy::config::cluster::v3::Cluster::OriginalDstLbConfig> lb_original_dst_config_;
   absl::optional<envoy::config::core::v3::TypedExtensionConfig> upstream_config_;
   const bool added_via_api_;
@@ -725,6 +788,7 @@ private:
   const Network::ConnectionSocket::OptionsSharedPtr cluster_socket_options_;
   const bool drain_connections_on_host_removal_;
   const bool connection_pool_per_downstream_connection_;
+  const uint32_t worker_partitions_;
   const bool warm_hosts_;
   const absl::optional<envoy::config::core::v3::UpstreamHttpProtocolOptions>
       upstream_http_protocol_options_;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <list>
 #include <memory>
 
 #include "envoy/config/core/v3/config_source.pb.h"
@@ -10,8 +11,10 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/assert.h"
+#include "common/common/linked_object.h"
 #include "common/grpc/typed_async_client.h"
 #include "common/protobuf/utility.h"
+#include "common/tracing/http_tracer_impl.h"
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
@@ -81,9 +84,11 @@ public:
       : GrpcAccessLogClient(std::move(client), service_method, absl::nullopt) {}
   GrpcAccessLogClient(Grpc::RawAsyncClientPtr&& client,
                       const Protobuf::MethodDescriptor& service_method,
-                      envoy::config::core::v3::ApiVersion transport_api_version)
+                      envoy::config::core::v3::ApiVersion transport_api_version,
+                      uint32_t max_pending_requests = 1)
       : client_(std::move(client)), service_method_(service_method),
-        transport_api_version_(transport_api_version) {}
+        transport_api_version_(transport_api_version),
+        max_pending_requests_(max_pending_requests) {}
 
 public:
   struct LocalStream : public Grpc::AsyncStreamCallbacks<LogResponse> {
@@ -105,11 +110,47 @@ public:
 
     GrpcAccessLogClient& parent_;
     Grpc::AsyncStream<LogRequest> stream_{};
+    // Whether a message was sent on the stream.
+    bool sent_message_{};
+  };
+
+  // An export request of the loggers of unary methods, which stays in the list of the pending
+  // requests until it completes.
+  struct LocalRequest : public Grpc::AsyncRequestCallbacks<LogResponse>,
+                        public LinkedObject<LocalRequest> {
+    LocalRequest(GrpcAccessLogClient& parent) : parent_(parent) {}
+    ~LocalRequest() override {
+      if (request_ != nullptr) {
+        request_->cancel();
+      }
+    }
+
+    // Grpc::AsyncRequestCallbacks
+    void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+    void onSuccess(Grpc::ResponsePtr<LogResponse>&&, Tracing::Span&) override { onComplete(); }
+    void onFailure(Grpc::Status::GrpcStatus, const std::string&, Tracing::Span&) override {
+      onComplete();
+    }
+
+    void onComplete() {
+      request_ = nullptr;
+      if (inserted()) {
+        // Otherwise the request failed inline, and send() drops it.
+        removeFromList(parent_.requests_);
+      }
+    }
+
+    GrpcAccessLogClient& parent_;
+    Grpc::AsyncRequest* request_{};
   };
 
   bool isStreamStarted() { return stream_ != nullptr && stream_->stream_ != nullptr; }
 
   bool log(const LogRequest& request) {
+    if (!service_method_.client_streaming()) {
+      return send(request);
+    }
+
     if (!stream_) {
       stream_ = std::make_unique<LocalStream>(*this);
     }
@@ -123,11 +164,15 @@ public:
       if (stream_->stream_->isAboveWriteBufferHighWatermark()) {
         return false;
       }
-      if (transport_api_version_.has_value()) {
+      // Only the first message of the stream carries the identifier of the logger, which may come
+      // from the configuration. The entries of the next ones are built by Envoy, so they're sent
+      // without walking them to prepare them for the wire.
+      if (transport_api_version_.has_value() && !stream_->sent_message_) {
         stream_->stream_->sendMessage(request, transport_api_version_.value(), false);
       } else {
         stream_->stream_->sendMessage(request, false);
       }
+      stream_->sent_message_ = true;
     } else {
       // Clear out the stream data due to stream creation failure.
       stream_.reset();
@@ -135,10 +180,35 @@ public:
     return true;
   }
 
+  // Each message of a unary method is exported with its own request. Up to max_pending_requests_
+  // are in flight at once, after which the message is kept to be sent with the next flush.
+  bool send(const LogRequest& request) {
+    if (requests_.size() >= max_pending_requests_) {
+      return false;
+    }
+    auto local_request = std::make_unique<LocalRequest>(*this);
+    if (transport_api_version_.has_value()) {
+      local_request->request_ =
+          client_->send(service_method_, request, *local_request, Tracing::NullSpan::instance(),
+                        Http::AsyncClient::RequestOptions(), transport_api_version_.value());
+    } else {
+      local_request->request_ =
+          client_->send(service_method_, request, *local_request, Tracing::NullSpan::instance(),
+                        Http::AsyncClient::RequestOptions());
+    }
+    if (local_request->request_ != nullptr) {
+      LinkedList::moveIntoList(std::move(local_request), requests_);
+    }
+    return true;
+  }
+
   Grpc::AsyncClient<LogRequest, LogResponse> client_;
+  // Destroyed before the client, cancelling the pending requests.
+  std::list<std::unique_ptr<LocalRequest>> requests_;
   std::unique_ptr<LocalStream> stream_;
   const Protobuf::MethodDescriptor& service_method_;
   const absl::optional<envoy::config::core::v3::ApiVersion> transport_api_version_;
+  const uint32_t max_pending_requests_;
 };
 
 } // namespace Detail
@@ -180,8 +250,9 @@ public:
                    uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
                    Stats::Scope& scope, std::string access_log_prefix,
                    const Protobuf::MethodDescriptor& service_method,
-                   envoy::config::core::v3::ApiVersion transport_api_version)
-      : client_(std::move(client), service_method, transport_api_version),
+                   envoy::config::core::v3::ApiVersion transport_api_version,
+                   uint32_t max_pending_requests = 1)
+      : client_(std::move(client), service_method, transport_api_version, max_pending_requests),
         buffer_flush_interval_msec_(buffer_flush_interval_msec),
         flush_timer_(dispatcher.createTimer([this]() {
           flush();
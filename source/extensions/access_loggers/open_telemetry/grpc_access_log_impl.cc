@@ -24,14 +24,14 @@ GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(
     Grpc::RawAsyncClientPtr&& client, std::string log_name,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
     Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-    envoy::config::core::v3::ApiVersion transport_api_version)
+    envoy::config::core::v3::ApiVersion transport_api_version, uint32_t max_pending_export_requests)
     : GrpcAccessLogger(
           std::move(client), buffer_flush_interval_msec, max_buffer_size_bytes, dispatcher, scope,
           GRPC_LOG_STATS_PREFIX,
           Grpc::VersionedMethods("opentelemetry.proto.collector.logs.v1.LogsService.Export",
                                  "opentelemetry.proto.collector.logs.v1.LogsService.Export")
               .getMethodDescriptorForVersion(transport_api_version),
-          transport_api_version) {
+          transport_api_version, max_pending_export_requests) {
   initMessageRoot(log_name, local_info);
 }
 
@@ -81,9 +81,10 @@ GrpcAccessLoggerImpl::SharedPtr GrpcAccessLoggerCacheImpl::createLogger(
     envoy::config::core::v3::ApiVersion transport_version, Grpc::RawAsyncClientPtr&& client,
     std::chrono::milliseconds buffer_flush_interval_msec, uint64_t max_buffer_size_bytes,
     Event::Dispatcher& dispatcher, Stats::Scope& scope) {
-  return std::make_shared<GrpcAccessLoggerImpl>(std::move(client), config.log_name(),
-                                                buffer_flush_interval_msec, max_buffer_size_bytes,
-                                                dispatcher, local_info_, scope, transport_version);
+  return std::make_shared<GrpcAccessLoggerImpl>(
+      std::move(client), config.log_name(), buffer_flush_interval_msec, max_buffer_size_bytes,
+      dispatcher, local_info_, scope, transport_version,
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_export_requests, 1));
 }
 
 } // namespace OpenTelemetry
@@ -40,7 +40,8 @@ public:
                        std::chrono::milliseconds buffer_flush_interval_msec,
                        uint64_t max_buffer_size_bytes, Event::Dispatcher& dispatcher,
                        const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-                       envoy::config::core::v3::ApiVersion transport_api_version);
+                       envoy::config::core::v3::ApiVersion transport_api_version,
+                       uint32_t max_pending_export_requests);
 
 private:
   void initMessageRoot(const std::string& log_name, const LocalInfo::LocalInfo& local_info);
@@ -1,5 +1,7 @@
 #include "extensions/clusters/aggregate/cluster.h"
 
+#include <algorithm>
+
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/extensions/clusters/aggregate/v3/cluster.pb.h"
@@ -52,7 +54,7 @@ void AggregateClusterLoadBalancer::addMemberUpdateCallbackForCluster(
                                                                     const Upstream::HostVector&) {
             ENVOY_LOG(debug, "member update for cluster '{}' in aggregate cluster '{}'",
                       target_cluster_info->name(), parent_info_->name());
-            refresh();
+            refreshCluster(target_cluster_info->name());
           });
 }
 
@@ -115,6 +117,49 @@ void AggregateClusterLoadBalancer::refresh(OptRef<const std::string> excluded_cl
   priority_context_ = std::move(priority_context);
 }
 
+void AggregateClusterLoadBalancer::refreshCluster(const std::string& cluster_name) {
+  Upstream::ThreadLocalCluster* tlc = cluster_manager_.getThreadLocalCluster(cluster_name);
+  if (load_balancer_ == nullptr || tlc == nullptr) {
+    refresh();
+    return;
+  }
+
+  // The linearized priorities of the cluster only stay valid if the cluster has hosts in the same
+  // priorities as when the priority set was linearized.
+  const auto& host_sets = tlc->prioritySet().hostSetsPerPriority();
+  std::vector<std::pair<uint32_t, uint32_t>> cluster_to_linearized_priority;
+  for (uint32_t priority = 0; priority < host_sets.size(); ++priority) {
+    auto it = priority_context_->cluster_and_priority_to_linearized_priority_.find(
+        std::make_pair(cluster_name, priority));
+    const bool linearized =
+        it != priority_context_->cluster_and_priority_to_linearized_priority_.end();
+    if (host_sets[priority]->hosts().empty() == linearized) {
+      refresh();
+      return;
+    }
+    if (linearized) {
+      cluster_to_linearized_priority.emplace_back(priority, it->second);
+    }
+  }
+  const auto linearized_priorities =
+      std::count_if(priority_context_->priority_to_cluster_.begin(),
+                    priority_context_->priority_to_cluster_.end(),
+                    [tlc](const auto& entry) { return entry.second == tlc; });
+  if (static_cast<size_t>(linearized_priorities) != cluster_to_linearized_priority.size()) {
+    refresh();
+    return;
+  }
+
+  // Only the host sets of the cluster are copied, the load balancer recalculates the priority
+  // loads as each of them is updated.
+  for (const auto& [priority, linearized_priority] : cluster_to_linearized_priority) {
+    const Upstream::HostSet& host_set = *host_sets[priority];
+    priority_context_->priority_set_.updateHosts(
+        linearized_priority, Upstream::HostSetImpl::updateHostsParams(host_set),
+        host_set.localityWeights(), {}, {}, host_set.overprovisioningFactor());
+  }
+}
+
 void AggregateClusterLoadBalancer::onClusterAddOrUpdate(Upstream::ThreadLocalCluster& cluster) {
   if (std::find(clusters_->begin(), clusters_->end(), cluster.info()->name()) != clusters_->end()) {
     ENVOY_LOG(debug, "adding or updating cluster '{}' for aggregate cluster '{}'",
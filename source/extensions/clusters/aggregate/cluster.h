@@ -119,6 +119,9 @@ private:
   void addMemberUpdateCallbackForCluster(Upstream::ThreadLocalCluster& thread_local_cluster);
   PriorityContextPtr linearizePrioritySet(OptRef<const std::string> excluded_cluster);
   void refresh(OptRef<const std::string> excluded_cluster = OptRef<const std::string>());
+  // Updates the priorities of the given cluster in place if its hosts are still in the same
+  // priorities, refreshes the whole priority set otherwise.
+  void refreshCluster(const std::string& cluster_name);
 
   LoadBalancerImplPtr load_balancer_;
   Upstream::ClusterInfoConstSharedPtr parent_info_;
@@ -20,8 +20,11 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
         return lhs.start() < rhs.start() || (!(lhs.start() < rhs.start()) && lhs.end() < rhs.end());
       });
 
-  if (current_cluster_slot_ && *current_cluster_slot_ == *slots) {
-    return false;
+  {
+    absl::ReaderMutexLock lock(&mutex_);
+    if (current_cluster_slot_ && *current_cluster_slot_ == *slots) {
+      return false;
+    }
   }
 
   auto updated_slots = std::make_shared<SlotArray>();
@@ -64,6 +67,7 @@ bool RedisClusterLoadBalancerFactory::onClusterSlotUpdate(ClusterSlotsPtr&& slot
     current_cluster_slot_ = std::move(slots);
     slot_array_ = std::move(updated_slots);
     shard_vector_ = std::move(shard_vector);
+    version_++;
   }
   return true;
 }
@@ -90,12 +94,45 @@ void RedisClusterLoadBalancerFactory::onHostHealthUpdate() {
   {
     absl::WriterMutexLock lock(&mutex_);
     shard_vector_ = std::move(shard_vector);
+    version_++;
   }
 }
 
+bool RedisClusterLoadBalancerFactory::onMovedRedirection(uint64_t slot,
+                                                         const std::string& primary_address) {
+  absl::WriterMutexLock lock(&mutex_);
+  if (!slot_array_ || slot >= MaxSlot) {
+    return false;
+  }
+
+  for (uint64_t shard = 0; shard < shard_vector_->size(); ++shard) {
+    if ((*shard_vector_)[shard]->primary()->address()->asString() != primary_address) {
+      continue;
+    }
+    // The other workers may have applied the same redirection already.
+    if (slot_array_->at(slot) != shard) {
+      auto updated_slots = std::make_shared<SlotArray>(*slot_array_);
+      updated_slots->at(slot) = shard;
+      slot_array_ = std::move(updated_slots);
+      // The slot array no longer matches the slots it was built from, so the next refresh of the
+      // topology must rebuild it even if the slots are unchanged.
+      current_cluster_slot_ = nullptr;
+      version_++;
+    }
+    return true;
+  }
+  return false;
+}
+
 Upstream::LoadBalancerPtr RedisClusterLoadBalancerFactory::create() {
-  absl::ReaderMutexLock lock(&mutex_);
-  return std::make_unique<RedisClusterLoadBalancer>(slot_array_, shard_vector_, random_);
+  return std::make_unique<RedisClusterLoadBalancer>(*this);
+}
+
+void RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::refresh() {
+  absl::ReaderMutexLock lock(&factory_.mutex_);
+  version_ = factory_.version_.load();
+  slot_array_ = factory_.slot_array_;
+  shard_vector_ = factory_.shard_vector_;
 }
 
 namespace {
@@ -120,6 +157,10 @@ Upstream::HostConstSharedPtr chooseRandomHost(const Upstream::HostSetImpl& host_
 
 Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBalancer::chooseHost(
     Envoy::Upstream::LoadBalancerContext* context) {
+  // The version is only bumped under the lock, after the new topology has been stored.
+  if (factory_.version_.load(std::memory_order_acquire) != version_) {
+    refresh();
+  }
   if (!slot_array_) {
     return nullptr;
   }
@@ -144,18 +185,18 @@ Upstream::HostConstSharedPtr RedisClusterLoadBalancerFactory::RedisClusterLoadBa
       if (shard->primary()->health() == Upstream::Host::Health::Healthy) {
         return shard->primary();
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseRandomHost(shard->allHosts(), factory_.random_);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Replica:
-      return chooseRandomHost(shard->replicas(), random_);
+      return chooseRandomHost(shard->replicas(), factory_.random_);
     case NetworkFilters::Common::Redis::Client::ReadPolicy::PreferReplica:
       if (!shard->replicas().healthyHosts().empty()) {
-        return chooseRandomHost(shard->replicas(), random_);
+        return chooseRandomHost(shard->replicas(), factory_.random_);
       } else {
-        return chooseRandomHost(shard->allHosts(), random_);
+        return chooseRandomHost(shard->allHosts(), factory_.random_);
       }
     case NetworkFilters::Common::Redis::Client::ReadPolicy::Any:
-      return chooseRandomHost(shard->allHosts(), random_);
+      return chooseRandomHost(shard->allHosts(), factory_.random_);
     }
   }
   return shard->primary();
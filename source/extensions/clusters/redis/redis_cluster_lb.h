@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -123,11 +124,30 @@ public:
 
 using ClusterSlotUpdateCallBackSharedPtr = std::shared_ptr<ClusterSlotUpdateCallBack>;
 
+/**
+ * Implemented by the load balancers of Redis Cluster, so that the MOVED redirections received by
+ * the redis proxy move single slots without waiting for a refresh of the whole topology.
+ */
+class MovedRedirectionHandler {
+public:
+  virtual ~MovedRedirectionHandler() = default;
+
+  /**
+   * Assigns a slot to the shard whose primary has the address. Thread safe.
+   * @param slot supplies the slot of the MOVED redirection.
+   * @param primary_address supplies the address of the MOVED redirection.
+   * @return whether the slot is now assigned to the address. It isn't if the address isn't the
+   * primary of a known shard, in which case only a refresh of the topology finds the new owner.
+   */
+  virtual bool onMovedRedirection(uint64_t slot, const std::string& primary_address) PURE;
+};
+
 /**
  * This factory is created and returned by RedisCluster's factory() method, the create() method will
  * be called on each thread to create a thread local RedisClusterLoadBalancer.
  */
 class RedisClusterLoadBalancerFactory : public ClusterSlotUpdateCallBack,
+                                        public MovedRedirectionHandler,
                                         public Upstream::LoadBalancerFactory {
 public:
   RedisClusterLoadBalancerFactory(Random::RandomGenerator& random) : random_(random) {}
@@ -137,6 +157,9 @@ public:
 
   void onHostHealthUpdate() override;
 
+  // MovedRedirectionHandler
+  bool onMovedRedirection(uint64_t slot, const std::string& primary_address) override;
+
   // Upstream::LoadBalancerFactory
   Upstream::LoadBalancerPtr create() override;
 
@@ -179,13 +202,16 @@ private:
    * std::array() of the index of the shard in the shard_vector_. This has a fixed cpu and memory
    * cost and provide a fast lookup constant time lookup similar to Maglev. This will be used by the
    * redis proxy filter for load balancing purpose.
+   *
+   * The topology is an immutable snapshot of the one of the factory. Each update of the factory
+   * bumps its version, and the snapshot is only replaced under the lock of the factory when the
+   * version has changed, so that picking a host normally takes a single atomic load.
    */
-  class RedisClusterLoadBalancer : public Upstream::LoadBalancer {
+  class RedisClusterLoadBalancer : public Upstream::LoadBalancer, public MovedRedirectionHandler {
   public:
-    RedisClusterLoadBalancer(SlotArraySharedPtr slot_array, ShardVectorSharedPtr shard_vector,
-                             Random::RandomGenerator& random)
-        : slot_array_(std::move(slot_array)), shard_vector_(std::move(shard_vector)),
-          random_(random) {}
+    RedisClusterLoadBalancer(RedisClusterLoadBalancerFactory& factory) : factory_(factory) {
+      refresh();
+    }
 
     // Upstream::LoadBalancerBase
     Upstream::HostConstSharedPtr chooseHost(Upstream::LoadBalancerContext*) override;
@@ -193,16 +219,27 @@ private:
       return nullptr;
     }
 
+    // MovedRedirectionHandler
+    bool onMovedRedirection(uint64_t slot, const std::string& primary_address) override {
+      return factory_.onMovedRedirection(slot, primary_address);
+    }
+
   private:
-    const SlotArraySharedPtr slot_array_;
-    const ShardVectorSharedPtr shard_vector_;
-    Random::RandomGenerator& random_;
+    void refresh();
+
+    // The factory outlives the load balancers it creates, as the cluster manager keeps it with
+    // them.
+    RedisClusterLoadBalancerFactory& factory_;
+    uint64_t version_{};
+    SlotArraySharedPtr slot_array_;
+    ShardVectorSharedPtr shard_vector_;
   };
 
   absl::Mutex mutex_;
+  std::atomic<uint64_t> version_{};
   SlotArraySharedPtr slot_array_ ABSL_GUARDED_BY(mutex_);
-  ClusterSlotsSharedPtr current_cluster_slot_;
-  ShardVectorSharedPtr shard_vector_;
+  ClusterSlotsSharedPtr current_cluster_slot_ ABSL_GUARDED_BY(mutex_);
+  ShardVectorSharedPtr shard_vector_ ABSL_GUARDED_BY(mutex_);
   Random::RandomGenerator& random_;
 };
 
@@ -1,5 +1,7 @@
 #include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 
+#include <limits>
+
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 
 #include "common/config/utility.h"
@@ -30,14 +32,19 @@ DnsCacheImpl::DnsCacheImpl(
               envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig>(
               config, refresh_interval_.count(), random)),
       host_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, host_ttl, 300000)),
-      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)) {
+      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)),
+      max_concurrent_resolves_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config, max_concurrent_resolutions, std::numeric_limits<uint32_t>::max())) {
   tls_slot_.set([&](Event::Dispatcher&) { return std::make_shared<ThreadLocalHostInfo>(*this); });
 }
 
 DnsCacheImpl::~DnsCacheImpl() {
-  for (const auto& primary_host : primary_hosts_) {
-    if (primary_host.second->active_query_ != nullptr) {
-      primary_host.second->active_query_->cancel();
+  for (PrimaryHostShard& shard : primary_host_shards_) {
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    for (const auto& primary_host : shard.hosts_) {
+      if (primary_host.second->active_query_ != nullptr) {
+        primary_host.second->active_query_->cancel();
+      }
     }
   }
 
@@ -56,14 +63,23 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
   ENVOY_LOG(debug, "thread local lookup for host '{}'", host);
   ThreadLocalHostInfo& tls_host_info = *tls_slot_;
 
-  auto [is_overflow, host_info] = [&]() {
-    absl::ReaderMutexLock read_lock{&primary_hosts_lock_};
-    auto tls_host = primary_hosts_.find(host);
-    return std::make_tuple(
-        primary_hosts_.size() >= max_hosts_,
-        (tls_host != primary_hosts_.end() && tls_host->second->host_info_->firstResolveComplete())
-            ? absl::optional<DnsHostInfoSharedPtr>(tls_host->second->host_info_)
-            : absl::nullopt);
+  const auto tls_host = tls_host_info.host_map_.find(host);
+  if (tls_host != tls_host_info.host_map_.end()) {
+    ENVOY_LOG(debug, "thread local cache hit for host '{}'", host);
+    return {LoadDnsCacheEntryStatus::InCache, nullptr, tls_host->second};
+  }
+
+  // The main thread may not have reported the host to this thread yet.
+  const bool is_overflow = num_primary_hosts_.load() >= max_hosts_;
+  const auto host_info = [&]() -> absl::optional<DnsHostInfoSharedPtr> {
+    PrimaryHostShard& shard = primaryHostShard(host);
+    absl::ReaderMutexLock read_lock{&shard.lock_};
+    auto primary_host = shard.hosts_.find(host);
+    if (primary_host != shard.hosts_.end() &&
+        primary_host->second->host_info_->firstResolveComplete()) {
+      return primary_host->second->host_info_;
+    }
+    return absl::nullopt;
   }();
 
   if (host_info) {
@@ -94,11 +110,13 @@ Upstream::ResourceAutoIncDecPtr DnsCacheImpl::canCreateDnsRequest() {
 }
 
 void DnsCacheImpl::iterateHostMap(IterateHostMapCb iterate_callback) {
-  absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-  for (const auto& host : primary_hosts_) {
-    // Only include hosts that have ever resolved to an address.
-    if (host.second->host_info_->address() != nullptr) {
-      iterate_callback(host.first, host.second->host_info_);
+  for (PrimaryHostShard& shard : primary_host_shards_) {
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    for (const auto& host : shard.hosts_) {
+      // Only include hosts that have ever resolved to an address.
+      if (host.second->host_info_->address() != nullptr) {
+        iterate_callback(host.first, host.second->host_info_);
+      }
     }
   }
 }
@@ -106,9 +124,10 @@ void DnsCacheImpl::iterateHostMap(IterateHostMapCb iterate_callback) {
 absl::optional<const DnsHostInfoSharedPtr> DnsCacheImpl::getHost(absl::string_view host_name) {
   // Find a host with the given name.
   const auto host_info = [&]() -> const DnsHostInfoSharedPtr {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    auto it = primary_hosts_.find(host_name);
-    return it != primary_hosts_.end() ? it->second->host_info_ : nullptr;
+    PrimaryHostShard& shard = primaryHostShard(host_name);
+    absl::ReaderMutexLock reader_lock{&shard.lock_};
+    auto it = shard.hosts_.find(host_name);
+    return it != shard.hosts_.end() ? it->second->host_info_ : nullptr;
   }();
 
   // Only include hosts that have ever resolved to an address.
@@ -124,6 +143,14 @@ DnsCacheImpl::addUpdateCallbacks(UpdateCallbacks& callbacks) {
   return std::make_unique<AddUpdateCallbacksHandleImpl>(update_callbacks_, callbacks);
 }
 
+DnsCacheImpl::PrimaryHostInfo* DnsCacheImpl::findPrimaryHost(const std::string& host) {
+  ASSERT(main_thread_dispatcher_.isThreadSafe());
+  PrimaryHostShard& shard = primaryHostShard(host);
+  absl::ReaderMutexLock reader_lock{&shard.lock_};
+  auto host_it = shard.hosts_.find(host);
+  return host_it != shard.hosts_.end() ? host_it->second.get() : nullptr;
+}
+
 void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port) {
   ASSERT(main_thread_dispatcher_.isThreadSafe());
 
@@ -131,14 +158,7 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
   // already in the map it's either in the process of being resolved or the resolution is already
   // heading out to the worker threads. Either way the pending resolution will be completed.
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    auto host_it = primary_hosts_.find(host);
-    return host_it != primary_hosts_.end() ? host_it->second.get() : nullptr;
-  }();
-
+  auto* primary_host = findPrimaryHost(host);
   if (primary_host) {
     ENVOY_LOG(debug, "main thread resolve for host '{}' skipped. Entry present", host);
     return;
@@ -150,8 +170,9 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
   // independent primary hosts with independent DNS resolutions. I'm not sure how much this will
   // matter, but we could consider collapsing these down and sharing the underlying DNS resolution.
   {
-    absl::WriterMutexLock writer_lock{&primary_hosts_lock_};
-    primary_host = primary_hosts_
+    PrimaryHostShard& shard = primaryHostShard(host);
+    absl::WriterMutexLock writer_lock{&shard.lock_};
+    primary_host = shard.hosts_
                        // try_emplace() is used here for direct argument forwarding.
                        .try_emplace(host, std::make_unique<PrimaryHostInfo>(
                                               *this, std::string(host_attributes.host_),
@@ -171,14 +192,8 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
   // use-after-free issues
   PrimaryHostInfoPtr host_to_erase;
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    const auto primary_host_it = primary_hosts_.find(host);
-    ASSERT(primary_host_it != primary_hosts_.end());
-    return primary_host_it->second.get();
-  }();
+  auto* primary_host = findPrimaryHost(host);
+  ASSERT(primary_host != nullptr);
 
   const std::chrono::steady_clock::duration now_duration =
       main_thread_dispatcher_.timeSource().monotonicTime().time_since_epoch();
@@ -194,13 +209,14 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
       runRemoveCallbacks(host);
     }
     {
-      absl::WriterMutexLock writer_lock{&primary_hosts_lock_};
-      auto host_it = primary_hosts_.find(host);
-      ASSERT(host_it != primary_hosts_.end());
+      PrimaryHostShard& shard = primaryHostShard(host);
+      absl::WriterMutexLock writer_lock{&shard.lock_};
+      auto host_it = shard.hosts_.find(host);
+      ASSERT(host_it != shard.hosts_.end());
       host_to_erase = std::move(host_it->second);
-      primary_hosts_.erase(host_it);
+      shard.hosts_.erase(host_it);
     }
-    notifyThreads(host, primary_host->host_info_);
+    notifyThreads(host, primary_host->host_info_, true);
   } else {
     startResolve(host, *primary_host);
   }
@@ -211,7 +227,16 @@ void DnsCacheImpl::startResolve(const std::string& host, PrimaryHostInfo& host_i
             host_info.host_info_->resolvedHost(), host_info.port_);
   ASSERT(host_info.active_query_ == nullptr);
 
+  if (active_resolves_ >= max_concurrent_resolves_) {
+    ENVOY_LOG(debug, "queueing main thread resolve for host='{}', {} resolves in flight", host,
+              active_resolves_);
+    stats_.dns_query_queued_.inc();
+    queued_resolves_.push_back(host);
+    return;
+  }
+
   stats_.dns_query_attempt_.inc();
+  ++active_resolves_;
 
   host_info.active_query_ =
       resolver_->resolve(host_info.host_info_->resolvedHost(), dns_lookup_family_,
@@ -227,14 +252,10 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   ASSERT(main_thread_dispatcher_.isThreadSafe());
   ENVOY_LOG(debug, "main thread resolve complete for host '{}'. {} results", host, response.size());
 
-  // Functions like this one that modify primary_hosts_ are only called in the main thread so we
-  // know it is safe to use the PrimaryHostInfo pointers outside of the lock.
-  auto* primary_host_info = [&]() {
-    absl::ReaderMutexLock reader_lock{&primary_hosts_lock_};
-    const auto primary_host_it = primary_hosts_.find(host);
-    ASSERT(primary_host_it != primary_hosts_.end());
-    return primary_host_it->second.get();
-  }();
+  auto* primary_host_info = findPrimaryHost(host);
+  ASSERT(primary_host_info != nullptr);
+  ASSERT(active_resolves_ > 0);
+  --active_resolves_;
 
   const bool first_resolve = !primary_host_info->host_info_->firstResolveComplete();
   primary_host_info->active_query_ = nullptr;
@@ -272,7 +293,7 @@ void DnsCacheImpl::finishResolve(const std::string& host,
 
   if (first_resolve || address_changed) {
     primary_host_info->host_info_->setFirstResolveComplete();
-    notifyThreads(host, primary_host_info->host_info_);
+    notifyThreads(host, primary_host_info->host_info_, false);
   }
 
   // Kick off the refresh timer.
@@ -289,6 +310,19 @@ void DnsCacheImpl::finishResolve(const std::string& host,
     ENVOY_LOG(debug, "DNS refresh rate reset for host '{}', (failure) refresh rate {} ms", host,
               refresh_interval);
   }
+
+  startQueuedResolves();
+}
+
+void DnsCacheImpl::startQueuedResolves() {
+  while (!queued_resolves_.empty() && active_resolves_ < max_concurrent_resolves_) {
+    const std::string host = std::move(queued_resolves_.front());
+    queued_resolves_.pop_front();
+    // The refresh timer of a queued host isn't enabled, so the host can't have been removed.
+    auto* primary_host = findPrimaryHost(host);
+    ASSERT(primary_host != nullptr);
+    startResolve(host, *primary_host);
+  }
 }
 
 void DnsCacheImpl::runAddUpdateCallbacks(const std::string& host,
@@ -305,8 +339,8 @@ void DnsCacheImpl::runRemoveCallbacks(const std::string& host) {
 }
 
 void DnsCacheImpl::notifyThreads(const std::string& host,
-                                 const DnsHostInfoImplSharedPtr& resolved_info) {
-  auto shared_info = std::make_shared<HostMapUpdateInfo>(host, resolved_info);
+                                 const DnsHostInfoImplSharedPtr& resolved_info, bool removed) {
+  auto shared_info = std::make_shared<HostMapUpdateInfo>(host, resolved_info, removed);
   tls_slot_.runOnAllThreads([shared_info](OptRef<ThreadLocalHostInfo> local_host_info) {
     local_host_info->onHostMapUpdate(shared_info);
   });
@@ -323,6 +357,12 @@ DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
 
 void DnsCacheImpl::ThreadLocalHostInfo::onHostMapUpdate(
     const HostMapUpdateInfoSharedPtr& resolved_host) {
+  if (resolved_host->removed_) {
+    host_map_.erase(resolved_host->host_);
+  } else {
+    host_map_[resolved_host->host_] = resolved_host->info_;
+  }
+
   auto host_it = pending_resolutions_.find(resolved_host->host_);
   if (host_it != pending_resolutions_.end()) {
     for (auto* resolution : host_it->second) {
@@ -343,11 +383,13 @@ DnsCacheImpl::PrimaryHostInfo::PrimaryHostInfo(DnsCacheImpl& parent,
                                                    host_to_resolve, is_ip_address)) {
   parent_.stats_.host_added_.inc();
   parent_.stats_.num_hosts_.inc();
+  ++parent_.num_primary_hosts_;
 }
 
 DnsCacheImpl::PrimaryHostInfo::~PrimaryHostInfo() {
   parent_.stats_.host_removed_.inc();
   parent_.stats_.num_hosts_.dec();
+  --parent_.num_primary_hosts_;
 }
 
 } // namespace DynamicForwardProxy
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+
 #include "envoy/common/backoff_strategy.h"
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 #include "envoy/http/filter.h"
@@ -12,6 +15,7 @@
 #include "extensions/common/dynamic_forward_proxy/dns_cache_resource_manager.h"
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -24,6 +28,7 @@ namespace DynamicForwardProxy {
 #define ALL_DNS_CACHE_STATS(COUNTER, GAUGE)                                                        \
   COUNTER(dns_query_attempt)                                                                       \
   COUNTER(dns_query_failure)                                                                       \
+  COUNTER(dns_query_queued)                                                                        \
   COUNTER(dns_query_success)                                                                       \
   COUNTER(host_added)                                                                              \
   COUNTER(host_address_changed)                                                                    \
@@ -72,10 +77,12 @@ private:
   using DnsHostInfoImplSharedPtr = std::shared_ptr<DnsHostInfoImpl>;
 
   struct HostMapUpdateInfo {
-    HostMapUpdateInfo(const std::string& host, DnsHostInfoImplSharedPtr info)
-        : host_(host), info_(std::move(info)) {}
+    HostMapUpdateInfo(const std::string& host, DnsHostInfoImplSharedPtr info, bool removed)
+        : host_(host), info_(std::move(info)), removed_(removed) {}
     std::string host_;
     DnsHostInfoImplSharedPtr info_;
+    // Whether the host was removed from the cache.
+    const bool removed_;
   };
   using HostMapUpdateInfoSharedPtr = std::shared_ptr<HostMapUpdateInfo>;
 
@@ -85,6 +92,9 @@ private:
     ~ThreadLocalHostInfo() override;
     void onHostMapUpdate(const HostMapUpdateInfoSharedPtr& resolved_info);
     absl::flat_hash_map<std::string, std::list<LoadDnsCacheEntryHandleImpl*>> pending_resolutions_;
+    // The hosts whose first resolution completed, as last reported by the main thread, so that
+    // the cache hits don't take any lock.
+    absl::flat_hash_map<std::string, DnsHostInfoImplSharedPtr> host_map_;
     DnsCacheImpl& parent_;
   };
 
@@ -151,6 +161,15 @@ private:
   // individual entries.
   using PrimaryHostInfoPtr = std::unique_ptr<PrimaryHostInfo>;
 
+  // The primary hosts are spread over several maps, each with its own lock, so that the workers
+  // missing their thread local map for different hosts don't contend.
+  struct PrimaryHostShard {
+    absl::Mutex lock_;
+    absl::flat_hash_map<std::string, PrimaryHostInfoPtr> hosts_ ABSL_GUARDED_BY(lock_);
+  };
+
+  static constexpr size_t NumPrimaryHostShards = 16;
+
   struct AddUpdateCallbacksHandleImpl : public AddUpdateCallbacksHandle,
                                         RaiiListElement<AddUpdateCallbacksHandleImpl*> {
     AddUpdateCallbacksHandleImpl(std::list<AddUpdateCallbacksHandleImpl*>& parent,
@@ -160,15 +179,23 @@ private:
     UpdateCallbacks& callbacks_;
   };
 
+  PrimaryHostShard& primaryHostShard(absl::string_view host) {
+    return primary_host_shards_[absl::Hash<absl::string_view>{}(host) % NumPrimaryHostShards];
+  }
+  // Functions like this one are only called in the main thread, which is the only one that
+  // modifies the primary hosts, so the returned pointer stays valid outside of the lock.
+  PrimaryHostInfo* findPrimaryHost(const std::string& host);
+
   void startCacheLoad(const std::string& host, uint16_t default_port);
 
-  void startResolve(const std::string& host, PrimaryHostInfo& host_info)
-      ABSL_LOCKS_EXCLUDED(primary_hosts_lock_);
+  void startResolve(const std::string& host, PrimaryHostInfo& host_info);
+  void startQueuedResolves();
   void finishResolve(const std::string& host, Network::DnsResolver::ResolutionStatus status,
                      std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void runRemoveCallbacks(const std::string& host);
-  void notifyThreads(const std::string& host, const DnsHostInfoImplSharedPtr& resolved_info);
+  void notifyThreads(const std::string& host, const DnsHostInfoImplSharedPtr& resolved_info,
+                     bool removed);
   void onReResolve(const std::string& host);
 
   Event::Dispatcher& main_thread_dispatcher_;
@@ -178,14 +205,19 @@ private:
   Stats::ScopePtr scope_;
   DnsCacheStats stats_;
   std::list<AddUpdateCallbacksHandleImpl*> update_callbacks_;
-  absl::Mutex primary_hosts_lock_;
-  absl::flat_hash_map<std::string, PrimaryHostInfoPtr>
-      primary_hosts_ ABSL_GUARDED_BY(primary_hosts_lock_);
+  // The number of primary hosts across the shards.
+  std::atomic<uint32_t> num_primary_hosts_{};
+  std::array<PrimaryHostShard, NumPrimaryHostShards> primary_host_shards_;
+  // The hosts waiting for a resolution slot, and the number of resolutions in flight. Only used
+  // in the main thread.
+  std::list<std::string> queued_resolves_;
+  uint32_t active_resolves_{};
   DnsCacheResourceManagerImpl resource_manager_;
   const std::chrono::milliseconds refresh_interval_;
   const BackOffStrategyPtr failure_backoff_strategy_;
   const std::chrono::milliseconds host_ttl_;
   const uint32_t max_hosts_;
+  const uint32_t max_concurrent_resolves_;
 };
 
 } // namespace DynamicForwardProxy
@@ -3,6 +3,7 @@
 #include "envoy/config/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/wrapper.pb.h"
+#include "envoy/runtime/runtime.h"
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
@@ -47,12 +48,16 @@ bool Utility::addBufferToProtoBytes(envoy::data::tap::v3::Body& output_body,
 }
 
 TapConfigBaseImpl::TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& proto_config,
-                                     Common::Tap::Sink* admin_streamer)
+                                     Common::Tap::Sink* admin_streamer, Api::Api& api,
+                                     Stats::Scope& scope)
     : max_buffered_rx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_rx_bytes, DefaultMaxBufferedBytes)),
       max_buffered_tx_bytes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           proto_config.output_config(), max_buffered_tx_bytes, DefaultMaxBufferedBytes)),
-      streaming_(proto_config.output_config().streaming()) {
+      streaming_(proto_config.output_config().streaming()), random_(api.randomGenerator()),
+      tap_enabled_(proto_config.has_tap_enabled()
+                       ? absl::make_optional(proto_config.tap_enabled())
+                       : absl::nullopt) {
   ASSERT(proto_config.output_config().sinks().size() == 1);
   // TODO(mattklein123): Add per-sink checks to make sure format makes sense. I.e., when using
   // streaming, we should require the length delimited version of binary proto, etc.
@@ -72,6 +77,15 @@ TapConfigBaseImpl::TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& pr
         std::make_unique<FilePerTapSink>(proto_config.output_config().sinks()[0].file_per_tap());
     sink_to_use_ = sink_.get();
     break;
+  case envoy::config::tap::v3::OutputSink::OutputSinkTypeCase::kStreamingFile:
+    if (sink_format_ != envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED) {
+      throw EnvoyException(
+          "streaming file output only supports the PROTO_BINARY_LENGTH_DELIMITED format");
+    }
+    sink_ = std::make_unique<StreamingFileSink>(
+        proto_config.output_config().sinks()[0].streaming_file(), api, scope);
+    sink_to_use_ = sink_.get();
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -97,6 +111,23 @@ const Matcher& TapConfigBaseImpl::rootMatcher() const {
   return *matchers_[0];
 }
 
+bool TapConfigBaseImpl::tapEnabled() const {
+  if (!tap_enabled_.has_value()) {
+    return true;
+  }
+
+  // The runtime isn't available to the transport sockets, so the tap configurations rely on the
+  // runtime singleton, and on the default value when there is none.
+  const uint64_t random_value = random_.random();
+  const Runtime::Loader* runtime = Runtime::LoaderSingleton::getExisting();
+  if (runtime != nullptr) {
+    return runtime->snapshot().featureEnabled(tap_enabled_->runtime_key(),
+                                              tap_enabled_->default_value(), random_value);
+  }
+  return ProtobufPercentHelper::evaluateFractionalPercent(tap_enabled_->default_value(),
+                                                          random_value);
+}
+
 namespace {
 void swapBytesToString(envoy::data::tap::v3::Body& body) {
   body.set_allocated_as_string(body.release_as_bytes());
@@ -216,6 +247,97 @@ void FilePerTapSink::FilePerTapSinkHandle::submitTrace(
   }
 }
 
+StreamingFileSink::StreamingFileSink(const envoy::config::tap::v3::StreamingFileSink& config,
+                                     Api::Api& api, Stats::Scope& scope)
+    : file_(api.fileSystem().createFile(
+          Filesystem::FilePathAndType{Filesystem::DestinationType::File, config.path()})),
+      max_buffered_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_buffered_bytes, DefaultMaxBufferedBytes)),
+      stats_{
+          ALL_STREAMING_FILE_SINK_STATS(POOL_COUNTER_PREFIX(scope, "tap.streaming_file_sink."))} {
+  static constexpr Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                              1 << Filesystem::File::Operation::Create |
+                                              1 << Filesystem::File::Operation::Append};
+  const Api::IoCallBoolResult result = file_->open(flags);
+  if (!result.rc_) {
+    throw EnvoyException(fmt::format("unable to open tap file '{}': {}", config.path(),
+                                     result.err_->getErrorDetails()));
+  }
+  thread_ = api.threadFactory().createThread([this]() -> void { threadRoutine(); },
+                                             Thread::Options{"TapFileWriter"});
+}
+
+StreamingFileSink::~StreamingFileSink() {
+  {
+    Thread::LockGuard lock(lock_);
+    exit_ = true;
+  }
+  pending_event_.notifyOne();
+  // The thread writes the pending traces before exiting.
+  thread_->join();
+  file_->close();
+}
+
+void StreamingFileSink::StreamingFileSinkHandle::submitTrace(
+    TraceWrapperPtr&& trace, envoy::config::tap::v3::OutputSink::Format format) {
+  ASSERT(format == envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+  parent_.submitTrace(*trace);
+}
+
+void StreamingFileSink::submitTrace(const envoy::data::tap::v3::TraceWrapper& trace) {
+  // Serialize outside of the lock, so that the threads submitting traces only contend on copying
+  // the serialized trace.
+  std::string data;
+  {
+    Protobuf::io::StringOutputStream stream(&data);
+    Protobuf::io::CodedOutputStream coded_stream(&stream);
+    coded_stream.WriteVarint32(trace.ByteSize());
+    trace.SerializeWithCachedSizes(&coded_stream);
+  }
+
+  {
+    Thread::LockGuard lock(lock_);
+    if (pending_.length() + data.size() > max_buffered_bytes_) {
+      stats_.traces_dropped_.inc();
+      return;
+    }
+    pending_.add(data);
+    ++pending_traces_;
+  }
+  pending_event_.notifyOne();
+}
+
+void StreamingFileSink::threadRoutine() {
+  Buffer::OwnedImpl about_to_write;
+  while (true) {
+    uint64_t traces;
+    {
+      Thread::LockGuard lock(lock_);
+      while (pending_.length() == 0 && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        pending_event_.wait(lock_);
+      }
+      if (pending_.length() == 0) {
+        return;
+      }
+      about_to_write.move(pending_);
+      traces = pending_traces_;
+      pending_traces_ = 0;
+    }
+
+    for (const Buffer::RawSlice& slice : about_to_write.getRawSlices()) {
+      const Api::IoCallSizeResult result =
+          file_->write(absl::string_view(static_cast<char*>(slice.mem_), slice.len_));
+      if (!result.ok() || result.rc_ != static_cast<ssize_t>(slice.len_)) {
+        // Probably disk full.
+        stats_.write_failed_.inc();
+      }
+    }
+    about_to_write.drain(about_to_write.length());
+    stats_.traces_written_.add(traces);
+  }
+}
+
 } // namespace Tap
 } // namespace Common
 } // namespace Extensions
@@ -2,14 +2,26 @@
 
 #include <fstream>
 
+#include "envoy/api/api.h"
 #include "envoy/buffer/buffer.h"
+#include "envoy/common/random_generator.h"
+#include "envoy/config/core/v3/base.pb.h"
 #include "envoy/config/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/common.pb.h"
 #include "envoy/data/tap/v3/wrapper.pb.h"
+#include "envoy/filesystem/filesystem.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/thread.h"
 
 #include "extensions/common/matcher/matcher.h"
 #include "extensions/common/tap/tap.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Common {
@@ -102,7 +114,13 @@ public:
 
 protected:
   TapConfigBaseImpl(const envoy::config::tap::v3::TapConfig& proto_config,
-                    Common::Tap::Sink* admin_streamer);
+                    Common::Tap::Sink* admin_streamer, Api::Api& api, Stats::Scope& scope);
+
+  /**
+   * @return whether a new request or connection should be tapped, as configured by the tap_enabled
+   *         field. The extensions don't create a tapper for the ones that shouldn't be.
+   */
+  bool tapEnabled() const;
 
 private:
   // This is the default setting for both RX/TX max buffered bytes. (This means that per tap, the
@@ -112,6 +130,8 @@ private:
   const uint32_t max_buffered_rx_bytes_;
   const uint32_t max_buffered_tx_bytes_;
   const bool streaming_;
+  Random::RandomGenerator& random_;
+  const absl::optional<envoy::config::core::v3::RuntimeFractionalPercent> tap_enabled_;
   Sink* sink_to_use_;
   SinkPtr sink_;
   envoy::config::tap::v3::OutputSink::Format sink_format_;
@@ -147,6 +167,68 @@ private:
   const envoy::config::tap::v3::FilePerTapSink config_;
 };
 
+/**
+ * All stats for the streaming file sink. @see stats_macros.h
+ */
+#define ALL_STREAMING_FILE_SINK_STATS(COUNTER)                                                     \
+  COUNTER(traces_dropped)                                                                          \
+  COUNTER(traces_written)                                                                          \
+  COUNTER(write_failed)
+
+/**
+ * Struct definition for all streaming file sink stats. @see stats_macros.h
+ */
+struct StreamingFileSinkStats {
+  ALL_STREAMING_FILE_SINK_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A tap sink that appends the traces of all the taps to a single file, as length delimited protos.
+ * The traces are serialized by the thread submitting them and written by a background thread, so
+ * that the worker threads never block on the file. The traces submitted while the configured
+ * number of bytes are waiting to be written are dropped, which bounds the memory used by the sink
+ * to twice that number: the bytes waiting and the bytes being written.
+ */
+class StreamingFileSink : public Sink {
+public:
+  StreamingFileSink(const envoy::config::tap::v3::StreamingFileSink& config, Api::Api& api,
+                    Stats::Scope& scope);
+  ~StreamingFileSink() override;
+
+  // Sink
+  PerTapSinkHandlePtr createPerTapSinkHandle(uint64_t) override {
+    return std::make_unique<StreamingFileSinkHandle>(*this);
+  }
+
+private:
+  struct StreamingFileSinkHandle : public PerTapSinkHandle {
+    StreamingFileSinkHandle(StreamingFileSink& parent) : parent_(parent) {}
+
+    // PerTapSinkHandle
+    void submitTrace(TraceWrapperPtr&& trace,
+                     envoy::config::tap::v3::OutputSink::Format format) override;
+
+    StreamingFileSink& parent_;
+  };
+
+  // The default maximum number of bytes of traces waiting to be written.
+  static constexpr uint32_t DefaultMaxBufferedBytes = 1024 * 1024;
+
+  void submitTrace(const envoy::data::tap::v3::TraceWrapper& trace);
+  void threadRoutine();
+
+  const Filesystem::FilePtr file_;
+  const uint32_t max_buffered_bytes_;
+  StreamingFileSinkStats stats_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar pending_event_;
+  Buffer::OwnedImpl pending_ ABSL_GUARDED_BY(lock_);
+  // The number of traces in pending_.
+  uint64_t pending_traces_ ABSL_GUARDED_BY(lock_){};
+  bool exit_ ABSL_GUARDED_BY(lock_){};
+  Thread::ThreadPtr thread_;
+};
+
 } // namespace Tap
 } // namespace Common
 } // namespace Extensions
@@ -718,7 +718,7 @@ WasmResult Context::addHeaderMapValue(WasmHeaderMapType type, absl::string_view
     return WasmResult::BadArgument;
   }
   const Http::LowerCaseString lower_key{std::string(key)};
-  map->addCopy(lower_key, std::string(value));
+  map->addCopy(lower_key, value);
   if (type == WasmHeaderMapType::RequestHeaders) {
     decoder_callbacks_->clearRouteCache();
   }
@@ -780,18 +780,11 @@ WasmResult Context::setHeaderMapPairs(WasmHeaderMapType type, const Pairs& pairs
   if (!map) {
     return WasmResult::BadArgument;
   }
-  std::vector<std::string> keys;
-  map->iterate([&keys](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
-    keys.push_back(std::string(header.key().getStringView()));
-    return Http::HeaderMap::Iterate::Continue;
-  });
-  for (auto& k : keys) {
-    const Http::LowerCaseString lower_key{k};
-    map->remove(lower_key);
-  }
+  // The pairs replace the whole map, so it is cleared at once rather than header by header.
+  map->clear();
   for (auto& p : pairs) {
     const Http::LowerCaseString lower_key{std::string(p.first)};
-    map->addCopy(lower_key, std::string(p.second));
+    map->addCopy(lower_key, p.second);
   }
   if (type == WasmHeaderMapType::RequestHeaders) {
     decoder_callbacks_->clearRouteCache();
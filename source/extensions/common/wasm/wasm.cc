@@ -389,6 +389,8 @@ bool createWasm(const PluginSharedPtr& plugin, const Stats::ScopeSharedPtr& scop
          wasm_factory](absl::string_view vm_key) -> WasmHandleBaseSharedPtr {
       return wasm_factory(config, scope, cluster_manager, dispatcher, lifecycle_notifier, vm_key);
     };
+    // This returns the base VM of an existing configuration with the same vm_key, if any, so that
+    // the code is only compiled once for all the configurations that use the VM.
     auto wasm = proxy_wasm::createWasm(
         vm_key, code, plugin, proxy_wasm_factory,
         getCloneFactory(wasm_extension, dispatcher, create_root_context_for_testing),
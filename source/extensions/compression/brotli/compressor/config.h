@@ -55,7 +55,8 @@ public:
 
 private:
   Envoy::Compression::Compressor::CompressorFactoryPtr createCompressorFactoryFromProtoTyped(
-      const envoy::extensions::compression::brotli::compressor::v3::Brotli& config) override;
+      const envoy::extensions::compression::brotli::compressor::v3::Brotli& config,
+      Server::Configuration::FactoryContext& context) override;
 };
 
 DECLARE_FACTORY(BrotliCompressorLibraryFactory);
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/compression/compressor/compressor.h"
+#include "envoy/thread_local/thread_local.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Compression {
+namespace Common {
+namespace Compressor {
+
+/**
+ * A per-thread pool of the idle compressors of a compressor factory, so that the state of a
+ * compressor, which can take hundreds of KB, is reused by the next streams instead of being
+ * allocated for each of them. Compressors are taken from and returned to the pool of the thread
+ * they are used on, which is the worker thread of their stream.
+ * @tparam CompressorImpl the compressor type, which must have a reset() method that makes it ready
+ *         to compress a new stream with the same parameters.
+ */
+template <class CompressorImpl> class CompressorPool {
+public:
+  using CompressorImplPtr = std::unique_ptr<CompressorImpl>;
+  using CreateCompressorCb = std::function<CompressorImplPtr()>;
+
+  /**
+   * @param tls supplies the allocator of the thread local pools.
+   * @param max_idle_compressors supplies the maximum number of idle compressors in the pool of a
+   *        thread. The compressors returned to a full pool are destroyed.
+   * @param create_compressor supplies the callback creating new compressors.
+   */
+  CompressorPool(ThreadLocal::SlotAllocator& tls, uint32_t max_idle_compressors,
+                 CreateCompressorCb create_compressor)
+      : tls_(ThreadLocal::TypedSlot<ThreadLocalPool>::makeUnique(tls)),
+        create_compressor_(std::move(create_compressor)) {
+    tls_->set([max_idle_compressors](Event::Dispatcher&) {
+      return std::make_shared<ThreadLocalPool>(max_idle_compressors);
+    });
+  }
+
+  /**
+   * @return a compressor for a new stream, which is returned to the pool of the thread once
+   *         destroyed.
+   */
+  Envoy::Compression::Compressor::CompressorPtr acquire() {
+    const std::shared_ptr<IdleCompressors>& idle = (*tls_)->idle_;
+    CompressorImplPtr compressor;
+    if (idle->compressors_.empty()) {
+      compressor = create_compressor_();
+    } else {
+      compressor = std::move(idle->compressors_.back());
+      idle->compressors_.pop_back();
+    }
+    return std::make_unique<PooledCompressor>(std::move(compressor), idle);
+  }
+
+private:
+  struct IdleCompressors {
+    explicit IdleCompressors(uint32_t max_size) : max_size_(max_size) {}
+
+    const uint32_t max_size_;
+    std::vector<CompressorImplPtr> compressors_;
+  };
+
+  struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject {
+    explicit ThreadLocalPool(uint32_t max_idle_compressors)
+        : idle_(std::make_shared<IdleCompressors>(max_idle_compressors)) {}
+
+    const std::shared_ptr<IdleCompressors> idle_;
+  };
+
+  /**
+   * A compressor taken from the pool. The idle compressors are only weakly referenced, as the
+   * stream may outlive the thread local pool.
+   */
+  class PooledCompressor : public Envoy::Compression::Compressor::Compressor {
+  public:
+    PooledCompressor(CompressorImplPtr compressor, std::weak_ptr<IdleCompressors> idle)
+        : compressor_(std::move(compressor)), idle_(std::move(idle)) {}
+
+    ~PooledCompressor() override {
+      std::shared_ptr<IdleCompressors> idle = idle_.lock();
+      if (idle != nullptr && idle->compressors_.size() < idle->max_size_) {
+        compressor_->reset();
+        idle->compressors_.push_back(std::move(compressor_));
+      }
+    }
+
+    // Compression::Compressor::Compressor
+    void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override {
+      compressor_->compress(buffer, state);
+    }
+
+  private:
+    CompressorImplPtr compressor_;
+    const std::weak_ptr<IdleCompressors> idle_;
+  };
+
+  const ThreadLocal::TypedSlotPtr<ThreadLocalPool> tls_;
+  const CreateCompressorCb create_compressor_;
+};
+
+} // namespace Compressor
+} // namespace Common
+} // namespace Compression
+} // namespace Extensions
+} // namespace Envoy
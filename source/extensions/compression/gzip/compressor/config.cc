@@ -22,13 +22,21 @@ const uint32_t DefaultChunkSize = 4096;
 } // namespace
 
 GzipCompressorFactory::GzipCompressorFactory(
-    const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip)
+    const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip,
+    ThreadLocal::SlotAllocator& tls)
     : compression_level_(compressionLevelEnum(gzip.compression_level())),
       compression_strategy_(compressionStrategyEnum(gzip.compression_strategy())),
       memory_level_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, memory_level, DefaultMemoryLevel)),
       window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, window_bits, DefaultWindowBits) |
                    GzipHeaderValue),
-      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, chunk_size, DefaultChunkSize)) {}
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, chunk_size, DefaultChunkSize)) {
+  const uint32_t max_pooled_compressors =
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(gzip, max_pooled_compressors, 0);
+  if (max_pooled_compressors > 0) {
+    pool_ = std::make_unique<Common::Compressor::CompressorPool<ZlibCompressorImpl>>(
+        tls, max_pooled_compressors, [this]() { return makeCompressor(); });
+  }
+}
 
 ZlibCompressorImpl::CompressionLevel GzipCompressorFactory::compressionLevelEnum(
     envoy::extensions::compression::gzip::compressor::v3::Gzip::CompressionLevel
@@ -75,6 +83,13 @@ ZlibCompressorImpl::CompressionStrategy GzipCompressorFactory::compressionStrate
 }
 
 Envoy::Compression::Compressor::CompressorPtr GzipCompressorFactory::createCompressor() {
+  if (pool_ != nullptr) {
+    return pool_->acquire();
+  }
+  return makeCompressor();
+}
+
+std::unique_ptr<ZlibCompressorImpl> GzipCompressorFactory::makeCompressor() const {
   auto compressor = std::make_unique<ZlibCompressorImpl>(chunk_size_);
   compressor->init(compression_level_, compression_strategy_, window_bits_, memory_level_);
   return compressor;
@@ -82,8 +97,9 @@ Envoy::Compression::Compressor::CompressorPtr GzipCompressorFactory::createCompr
 
 Envoy::Compression::Compressor::CompressorFactoryPtr
 GzipCompressorLibraryFactory::createCompressorFactoryFromProtoTyped(
-    const envoy::extensions::compression::gzip::compressor::v3::Gzip& proto_config) {
-  return std::make_unique<GzipCompressorFactory>(proto_config);
+    const envoy::extensions::compression::gzip::compressor::v3::Gzip& proto_config,
+    Server::Configuration::FactoryContext& context) {
+  return std::make_unique<GzipCompressorFactory>(proto_config, context.threadLocal());
 }
 
 /**
@@ -3,9 +3,11 @@
 #include "envoy/compression/compressor/factory.h"
 #include "envoy/extensions/compression/gzip/compressor/v3/gzip.pb.h"
 #include "envoy/extensions/compression/gzip/compressor/v3/gzip.pb.validate.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/http/headers.h"
 
+#include "extensions/compression/common/compressor/compressor_pool.h"
 #include "extensions/compression/common/compressor/factory_base.h"
 #include "extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 #include "extensions/filters/http/well_known_names.h"
@@ -27,7 +29,8 @@ const std::string& gzipExtensionName() {
 
 class GzipCompressorFactory : public Envoy::Compression::Compressor::CompressorFactory {
 public:
-  GzipCompressorFactory(const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip);
+  GzipCompressorFactory(const envoy::extensions::compression::gzip::compressor::v3::Gzip& gzip,
+                        ThreadLocal::SlotAllocator& tls);
 
   // Envoy::Compression::Compressor::CompressorFactory
   Envoy::Compression::Compressor::CompressorPtr createCompressor() override;
@@ -37,6 +40,8 @@ public:
   }
 
 private:
+  std::unique_ptr<ZlibCompressorImpl> makeCompressor() const;
+
   static ZlibCompressorImpl::CompressionLevel
   compressionLevelEnum(envoy::extensions::compression::gzip::compressor::v3::Gzip::CompressionLevel
                            compression_level);
@@ -49,6 +54,8 @@ private:
   const int32_t memory_level_;
   const int32_t window_bits_;
   const uint32_t chunk_size_;
+  // Reuses the compressors of the finished streams, if enabled.
+  std::unique_ptr<Common::Compressor::CompressorPool<ZlibCompressorImpl>> pool_;
 };
 
 class GzipCompressorLibraryFactory
@@ -59,7 +66,8 @@ public:
 
 private:
   Envoy::Compression::Compressor::CompressorFactoryPtr createCompressorFactoryFromProtoTyped(
-      const envoy::extensions::compression::gzip::compressor::v3::Gzip& config) override;
+      const envoy::extensions::compression::gzip::compressor::v3::Gzip& config,
+      Server::Configuration::FactoryContext& context) override;
 };
 
 DECLARE_FACTORY(GzipCompressorLibraryFactory);
@@ -82,6 +82,12 @@ public:
   void init(CompressionLevel level, CompressionStrategy strategy, int64_t window_bits,
             uint64_t memory_level);
 
+  /**
+   * Resets the initialized compressor, so that it compresses a new stream with the same
+   * parameters, without allocating a new zlib state.
+   */
+  void reset();
+
   // Compression::Compressor::Compressor
   void compress(Buffer::Instance& buffer, Envoy::Compression::Compressor::State state) override;
 
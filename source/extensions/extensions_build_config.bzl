@@ -128,6 +128,7 @@ EXTENSIONS = {
     "envoy.filters.network.ext_authz":                  "//source/extensions/filters/network/ext_authz:config",
     "envoy.filters.network.http_connection_manager":    "//source/extensions/filters/network/http_connection_manager:config",
     "envoy.filters.network.kafka_broker":               "//source/extensions/filters/network/kafka:kafka_broker_config_lib",
+    "envoy.filters.network.kafka_mesh":                 "//source/extensions/filters/network/kafka:kafka_mesh_config_lib",
     "envoy.filters.network.local_ratelimit":            "//source/extensions/filters/network/local_ratelimit:config",
     "envoy.filters.network.mongo_proxy":                "//source/extensions/filters/network/mongo_proxy:config",
     "envoy.filters.network.mysql_proxy":                "//source/extensions/filters/network/mysql_proxy:config",
@@ -214,6 +215,7 @@ EXTENSIONS = {
     # CacheFilter plugins
     #
 
+    "envoy.filters.http.cache.file_system_http_cache":  "//source/extensions/filters/http/cache/file_system_http_cache:file_system_http_cache_lib",
     "envoy.filters.http.cache.simple_http_cache":       "//source/extensions/filters/http/cache/simple_http_cache:simple_http_cache_lib",
 
     #
@@ -264,6 +266,12 @@ EXTENSIONS = {
 
     "envoy.tls.cert_validator.spiffe":                  "//source/extensions/transport_sockets/tls/cert_validator/spiffe:config",
 
+    #
+    # TLS private key providers
+    #
+
+    "envoy.tls.key_providers.batched":                  "//source/extensions/transport_sockets/tls/private_key/batched:config",
+
     #
     # HTTP header formatters
     #
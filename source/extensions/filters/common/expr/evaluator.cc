@@ -85,9 +85,17 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::RequestHeaderMap& headers) {
-  Protobuf::Arena arena;
-  auto eval_status = Expr::evaluate(expr, arena, info, &headers, nullptr, nullptr);
-  if (!eval_status.has_value()) {
+  RequestActivation activation(info, headers);
+  return activation.matches(expr);
+}
+
+bool RequestActivation::matches(const Expression& expr) {
+  if (activation_ == nullptr) {
+    arena_.emplace();
+    activation_ = createActivation(arena_.value(), info_, &headers_, nullptr, nullptr);
+  }
+  auto eval_status = expr.Evaluate(*activation_, &arena_.value());
+  if (!eval_status.ok()) {
     return false;
   }
   auto result = eval_status.value();
@@ -52,6 +52,25 @@ absl::optional<CelValue> evaluate(const Expression& expr, Protobuf::Arena& arena
 bool matches(const Expression& expr, const StreamInfo::StreamInfo& info,
              const Http::RequestHeaderMap& headers);
 
+// The activation of a request, shared by the expressions evaluated for it. The arena and the
+// activation are only created by the first evaluation, and the attribute wrappers keep the values
+// they created in the arena for the next evaluations.
+class RequestActivation {
+public:
+  RequestActivation(const StreamInfo::StreamInfo& info, const Http::RequestHeaderMap& headers)
+      : info_(info), headers_(headers) {}
+
+  // Evaluates an expression and returns true if the expression evaluates to "true".
+  // Returns false if the expression fails to evaluate.
+  bool matches(const Expression& expr);
+
+private:
+  const StreamInfo::StreamInfo& info_;
+  const Http::RequestHeaderMap& headers_;
+  absl::optional<Protobuf::Arena> arena_;
+  ActivationPtr activation_;
+};
+
 // Returns a string for a CelValue.
 std::string print(CelValue value);
 
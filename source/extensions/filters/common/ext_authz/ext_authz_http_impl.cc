@@ -82,28 +82,20 @@ struct SuccessResponse {
   ResponsePtr response_;
 };
 
-std::vector<Matchers::StringMatcherPtr>
-createStringMatchers(const envoy::type::matcher::v3::ListStringMatcher& list) {
-  std::vector<Matchers::StringMatcherPtr> matchers;
-  for (const auto& matcher : list.patterns()) {
-    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
+void addExactMatchers(const std::vector<Http::LowerCaseString>& keys, StringMatchers& matchers) {
+  for (const auto& key : keys) {
+    matchers.Add()->set_exact(key.get());
   }
-  return matchers;
 }
 
 } // namespace
 
 // Matchers
-HeaderKeyMatcher::HeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list)
-    : matchers_(std::move(list)) {}
+HeaderKeyMatcher::HeaderKeyMatcher(const StringMatchers& list) : matchers_(list) {}
 
-bool HeaderKeyMatcher::matches(absl::string_view key) const {
-  return std::any_of(matchers_.begin(), matchers_.end(),
-                     [&key](auto& matcher) { return matcher->match(key); });
-}
+bool HeaderKeyMatcher::matches(absl::string_view key) const { return matchers_.match(key); }
 
-NotHeaderKeyMatcher::NotHeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list)
-    : matcher_(std::move(list)) {}
+NotHeaderKeyMatcher::NotHeaderKeyMatcher(const StringMatchers& list) : matcher_(list) {}
 
 bool NotHeaderKeyMatcher::matches(absl::string_view key) const { return !matcher_.matches(key); }
 
@@ -132,34 +124,25 @@ ClientConfig::toRequestMatchers(const envoy::type::matcher::v3::ListStringMatche
       {Http::CustomHeaders::get().Authorization, Http::Headers::get().Method,
        Http::Headers::get().Path, Http::Headers::get().Host}};
 
-  std::vector<Matchers::StringMatcherPtr> matchers(createStringMatchers(list));
-  for (const auto& key : keys) {
-    envoy::type::matcher::v3::StringMatcher matcher;
-    matcher.set_exact(key.get());
-    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
-  }
-
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
+  StringMatchers matchers(list.patterns());
+  addExactMatchers(keys, matchers);
+  return std::make_shared<HeaderKeyMatcher>(matchers);
 }
 
 MatcherSharedPtr
 ClientConfig::toClientMatchersOnSuccess(const envoy::type::matcher::v3::ListStringMatcher& list) {
-  std::vector<Matchers::StringMatcherPtr> matchers(createStringMatchers(list));
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
+  return std::make_shared<HeaderKeyMatcher>(list.patterns());
 }
 
 MatcherSharedPtr
 ClientConfig::toClientMatchers(const envoy::type::matcher::v3::ListStringMatcher& list) {
-  std::vector<Matchers::StringMatcherPtr> matchers(createStringMatchers(list));
+  StringMatchers matchers(list.patterns());
 
   // If list is empty, all authorization response headers, except Host, should be added to
   // the client response.
   if (matchers.empty()) {
-    envoy::type::matcher::v3::StringMatcher matcher;
-    matcher.set_exact(Http::Headers::get().Host.get());
-    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
-
-    return std::make_shared<NotHeaderKeyMatcher>(std::move(matchers));
+    addExactMatchers({Http::Headers::get().Host}, matchers);
+    return std::make_shared<NotHeaderKeyMatcher>(matchers);
   }
 
   // If not empty, all user defined matchers and default matcher's list will
@@ -168,18 +151,13 @@ ClientConfig::toClientMatchers(const envoy::type::matcher::v3::ListStringMatcher
       {Http::Headers::get().Status, Http::Headers::get().ContentLength,
        Http::Headers::get().WWWAuthenticate, Http::Headers::get().Location}};
 
-  for (const auto& key : keys) {
-    envoy::type::matcher::v3::StringMatcher matcher;
-    matcher.set_exact(key.get());
-    matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
-  }
-
-  return std::make_shared<HeaderKeyMatcher>(std::move(matchers));
+  addExactMatchers(keys, matchers);
+  return std::make_shared<HeaderKeyMatcher>(matchers);
 }
 
 MatcherSharedPtr
 ClientConfig::toUpstreamMatchers(const envoy::type::matcher::v3::ListStringMatcher& list) {
-  return std::make_unique<HeaderKeyMatcher>(createStringMatchers(list));
+  return std::make_unique<HeaderKeyMatcher>(list.patterns());
 }
 
 RawHttpClientImpl::RawHttpClientImpl(Upstream::ClusterManager& cm, ClientConfigSharedPtr config)
@@ -37,19 +37,21 @@ public:
   virtual bool matches(absl::string_view key) const PURE;
 };
 
+using StringMatchers = Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>;
+
 class HeaderKeyMatcher : public Matcher {
 public:
-  HeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list);
+  HeaderKeyMatcher(const StringMatchers& list);
 
   bool matches(absl::string_view key) const override;
 
 private:
-  const std::vector<Matchers::StringMatcherPtr> matchers_;
+  const Matchers::StringMatcherSetImpl matchers_;
 };
 
 class NotHeaderKeyMatcher : public Matcher {
 public:
-  NotHeaderKeyMatcher(std::vector<Matchers::StringMatcherPtr>&& list);
+  NotHeaderKeyMatcher(const StringMatchers& list);
 
   bool matches(absl::string_view key) const override;
 
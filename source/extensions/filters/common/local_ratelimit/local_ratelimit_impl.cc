@@ -24,7 +24,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
   token_bucket_.max_tokens_ = max_tokens;
   token_bucket_.tokens_per_fill_ = tokens_per_fill;
   token_bucket_.fill_interval_ = absl::FromChrono(fill_interval);
-  tokens_.tokens_ = max_tokens;
+  tokens_.initialize(max_tokens);
 
   if (fill_timer_) {
     fill_timer_->enableTimer(fill_interval);
@@ -48,7 +48,7 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     new_descriptor.token_bucket_ = token_bucket;
 
     auto token_state = std::make_unique<TokenState>();
-    token_state->tokens_ = token_bucket.max_tokens_;
+    token_state->initialize(token_bucket.max_tokens_);
     token_state->fill_time_ = time_source_.monotonicTime();
     new_descriptor.token_state_ = std::move(token_state);
 
@@ -66,6 +66,22 @@ LocalRateLimiterImpl::~LocalRateLimiterImpl() {
   }
 }
 
+void LocalRateLimiterImpl::TokenState::initialize(uint32_t max_tokens) {
+  // A bucket with few tokens isn't split further than a token per shard.
+  const uint32_t num_shards = std::max(1U, std::min(MaxShards, max_tokens));
+  shards_ = std::vector<Shard>(num_shards);
+  for (uint32_t i = 0; i < num_shards; i++) {
+    shards_[i].max_tokens_ = max_tokens / num_shards + (i < max_tokens % num_shards ? 1 : 0);
+    shards_[i].tokens_ = shards_[i].max_tokens_;
+  }
+}
+
+uint32_t LocalRateLimiterImpl::shardIndex() {
+  static std::atomic<uint32_t> next_index{0};
+  static thread_local const uint32_t index = next_index++ % MaxShards;
+  return index;
+}
+
 void LocalRateLimiterImpl::onFillTimer() {
   onFillTimerHelper(tokens_, token_bucket_);
   onFillTimerDescriptorHelper();
@@ -74,20 +90,42 @@ void LocalRateLimiterImpl::onFillTimer() {
 
 void LocalRateLimiterImpl::onFillTimerHelper(const TokenState& tokens,
                                              const RateLimit::TokenBucket& bucket) {
+  // Every shard gets its share of the tokens. The tokens that don't fit in a full shard are given
+  // to the next ones, and only dropped once all the shards are full.
+  const uint32_t num_shards = tokens.shards_.size();
+  uint32_t carry = 0;
+  for (uint32_t i = 0; i < num_shards; i++) {
+    const uint32_t share =
+        bucket.tokens_per_fill_ / num_shards + (i < bucket.tokens_per_fill_ % num_shards ? 1 : 0);
+    carry = fillShard(tokens.shards_[i], share + carry);
+  }
+  for (uint32_t i = 0; i < num_shards && carry > 0; i++) {
+    carry = fillShard(tokens.shards_[i], carry);
+  }
+}
+
+uint32_t LocalRateLimiterImpl::fillShard(const TokenState::Shard& shard, uint32_t tokens) {
+  if (tokens == 0) {
+    return 0;
+  }
+
   // Relaxed consistency is used for all operations because we don't care about ordering, just the
   // final atomic correctness.
-  uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
+  uint32_t expected_tokens = shard.tokens_.load(std::memory_order_relaxed);
   uint32_t new_tokens_value;
   do {
     // expected_tokens is either initialized above or reloaded during the CAS failure below.
-    new_tokens_value = std::min(bucket.max_tokens_, expected_tokens + bucket.tokens_per_fill_);
+    new_tokens_value = static_cast<uint32_t>(std::min<uint64_t>(
+        shard.max_tokens_, static_cast<uint64_t>(expected_tokens) + tokens));
 
     // Testing hook.
     synchronizer_.syncPoint("on_fill_timer_pre_cas");
 
     // Loop while the weak CAS fails trying to update the tokens value.
-  } while (!tokens.tokens_.compare_exchange_weak(expected_tokens, new_tokens_value,
-                                                 std::memory_order_relaxed));
+  } while (!shard.tokens_.compare_exchange_weak(expected_tokens, new_tokens_value,
+                                                std::memory_order_relaxed));
+
+  return tokens - (new_tokens_value - expected_tokens);
 }
 
 void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
@@ -103,9 +141,21 @@ void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
 }
 
 bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const {
+  // The shard of this thread is tried first, and the others are only touched once it is empty.
+  const uint32_t num_shards = tokens.shards_.size();
+  const uint32_t first = shardIndex() % num_shards;
+  for (uint32_t i = 0; i < num_shards; i++) {
+    if (takeToken(tokens.shards_[(first + i) % num_shards])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool LocalRateLimiterImpl::takeToken(const TokenState::Shard& shard) const {
   // Relaxed consistency is used for all operations because we don't care about ordering, just the
   // final atomic correctness.
-  uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
+  uint32_t expected_tokens = shard.tokens_.load(std::memory_order_relaxed);
   do {
     // expected_tokens is either initialized above or reloaded during the CAS failure below.
     if (expected_tokens == 0) {
@@ -116,8 +166,8 @@ bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const
     synchronizer_.syncPoint("allowed_pre_cas");
 
     // Loop while the weak CAS fails trying to subtract 1 from expected.
-  } while (!tokens.tokens_.compare_exchange_weak(expected_tokens, expected_tokens - 1,
-                                                 std::memory_order_relaxed));
+  } while (!shard.tokens_.compare_exchange_weak(expected_tokens, expected_tokens - 1,
+                                                std::memory_order_relaxed));
 
   // We successfully decremented the counter by 1.
   return true;
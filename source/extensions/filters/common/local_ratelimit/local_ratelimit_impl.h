@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <vector>
 
 #include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
@@ -27,9 +29,24 @@ public:
 
   bool requestAllowed(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
 
+  // The number of shards the tokens of a bucket are split into, so that the workers don't all
+  // update the same cache line.
+  static constexpr uint32_t MaxShards = 8;
+
 private:
+  // The tokens of a bucket, split into shards which each hold up to their share of the maximum
+  // tokens. A thread takes its tokens from its own shard first, then from the others, so that a
+  // request is only refused once the whole bucket is empty.
   struct TokenState {
-    mutable std::atomic<uint32_t> tokens_;
+    struct alignas(64) Shard {
+      mutable std::atomic<uint32_t> tokens_{0};
+      uint32_t max_tokens_{0};
+    };
+
+    // Fills the shards with their share of the maximum tokens.
+    void initialize(uint32_t max_tokens);
+
+    std::vector<Shard> shards_;
     MonotonicTime fill_time_;
   };
   struct LocalDescriptorImpl : public RateLimit::LocalDescriptor {
@@ -60,8 +77,12 @@ private:
 
   void onFillTimer();
   void onFillTimerHelper(const TokenState& state, const RateLimit::TokenBucket& bucket);
+  // Adds up to the given number of tokens to the shard, and returns the number that didn't fit.
+  uint32_t fillShard(const TokenState::Shard& shard, uint32_t tokens);
   void onFillTimerDescriptorHelper();
   bool requestAllowedHelper(const TokenState& tokens) const;
+  bool takeToken(const TokenState::Shard& shard) const;
+  static uint32_t shardIndex();
 
   RateLimit::TokenBucket token_bucket_;
   const Event::TimerPtr fill_timer_;
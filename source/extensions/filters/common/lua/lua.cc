@@ -13,9 +13,36 @@ namespace Extensions {
 namespace Filters {
 namespace Common {
 namespace Lua {
+namespace {
 
-Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state)
-    : coroutine_state_(new_thread_state, false) {}
+int appendBytecode(lua_State*, const void* data, size_t size, void* bytecode) {
+  static_cast<std::string*>(bytecode)->append(static_cast<const char*>(data), size);
+  return 0;
+}
+
+} // namespace
+
+Coroutine::Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state, int ref,
+                     IdleThreads& idle_threads)
+    : idle_threads_(idle_threads) {
+  if (ref == LUA_NOREF) {
+    coroutine_state_.reset(new_thread_state, false);
+  } else {
+    coroutine_state_.adopt(new_thread_state, ref);
+  }
+}
+
+Coroutine::~Coroutine() {
+  // A thread whose coroutine returned, or never started, can run another one. A thread that
+  // yielded or failed can't.
+  lua_State* thread = coroutine_state_.get();
+  if (state_ == State::Yielded || lua_status(thread) != 0 ||
+      idle_threads_.size() >= MaxIdleThreads) {
+    return;
+  }
+  lua_settop(thread, 0);
+  idle_threads_.emplace_back(thread, coroutine_state_.release());
+}
 
 void Coroutine::start(int function_ref, int num_args, const std::function<void()>& yield_callback) {
   ASSERT(state_ == State::NotStarted);
@@ -56,12 +83,20 @@ ThreadLocalState::ThreadLocalState(const std::string& code, ThreadLocal::SlotAll
   RELEASE_ASSERT(state.get() != nullptr, "unable to create new Lua state object");
   luaL_openlibs(state.get());
 
-  if (0 != luaL_dostring(state.get(), code.c_str())) {
+  // The code is only parsed here: the workers load its bytecode.
+  if (0 != luaL_loadstring(state.get(), code.c_str())) {
+    throw LuaException(fmt::format("script load error: {}", lua_tostring(state.get(), -1)));
+  }
+  std::string bytecode;
+  lua_dump(state.get(), appendBytecode, &bytecode);
+  if (0 != lua_pcall(state.get(), 0, LUA_MULTRET, 0)) {
     throw LuaException(fmt::format("script load error: {}", lua_tostring(state.get(), -1)));
   }
 
   // Now initialize on all threads.
-  tls_slot_->set([code](Event::Dispatcher&) { return std::make_shared<LuaThreadLocal>(code); });
+  tls_slot_->set([bytecode = std::move(bytecode)](Event::Dispatcher&) {
+    return std::make_shared<LuaThreadLocal>(bytecode);
+  });
 }
 
 int ThreadLocalState::getGlobalRef(uint64_t slot) {
@@ -90,16 +125,26 @@ uint64_t ThreadLocalState::registerGlobal(const std::string& global,
 }
 
 CoroutinePtr ThreadLocalState::createCoroutine() {
-  lua_State* state = tlsState().get();
-  return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state));
+  LuaThreadLocal& tls = **tls_slot_;
+  lua_State* state = tls.state_.get();
+  if (tls.idle_threads_.empty()) {
+    return std::make_unique<Coroutine>(std::make_pair(lua_newthread(state), state), LUA_NOREF,
+                                       tls.idle_threads_);
+  }
+  const Coroutine::IdleThread thread = tls.idle_threads_.back();
+  tls.idle_threads_.pop_back();
+  return std::make_unique<Coroutine>(std::make_pair(thread.first, state), thread.second,
+                                     tls.idle_threads_);
 }
 
-ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& code)
+ThreadLocalState::LuaThreadLocal::LuaThreadLocal(const std::string& bytecode)
     : state_(luaL_newstate()) {
 
   RELEASE_ASSERT(state_.get() != nullptr, "unable to create new Lua state object");
   luaL_openlibs(state_.get());
-  int rc = luaL_dostring(state_.get(), code.c_str());
+  // The chunk name is the one saved in the bytecode.
+  int rc = luaL_loadbuffer(state_.get(), bytecode.data(), bytecode.size(), "") ||
+           lua_pcall(state_.get(), 0, LUA_MULTRET, 0);
   ASSERT(rc == 0);
 }
 
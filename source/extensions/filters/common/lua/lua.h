@@ -262,6 +262,16 @@ public:
     ASSERT(ref_ != LUA_REFNIL);
   }
 
+  /**
+   * Same as reset(), for an object already referenced in the registry, whose reference passes to
+   * the LuaRef.
+   */
+  void adopt(const std::pair<T*, lua_State*>& object, int ref) {
+    unref();
+    object_ = object;
+    ref_ = ref;
+  }
+
   /**
    * Return a LuaRef to its default/empty state.
    */
@@ -279,6 +289,18 @@ public:
     lua_rawgeti(object_.second, LUA_REGISTRYINDEX, ref_);
   }
 
+  /**
+   * Return the LuaRef to its default/empty state without unreferencing the object, whose
+   * reference passes to the caller.
+   * @return int the reference of the object in the registry.
+   */
+  int release() {
+    const int ref = ref_;
+    object_ = std::pair<T*, lua_State*>{};
+    ref_ = LUA_NOREF;
+    return ref;
+  }
+
 protected:
   void unref() {
     if (object_.second != nullptr) {
@@ -332,7 +354,22 @@ class Coroutine : Logger::Loggable<Logger::Id::lua> {
 public:
   enum class State { NotStarted, Yielded, Finished };
 
-  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state);
+  // A Lua thread that can run another coroutine, with its reference in the registry.
+  using IdleThread = std::pair<lua_State*, int>;
+  using IdleThreads = std::vector<IdleThread>;
+
+  /**
+   * Create a coroutine that returns its thread to a pool once destroyed, if the thread can run
+   * another coroutine.
+   * @param new_thread_state supplies the thread and its parent state.
+   * @param ref supplies the existing reference of the thread in the registry, or LUA_NOREF if the
+   *        thread is at the top of the stack of the parent state.
+   * @param idle_threads supplies the pool, which must outlive the coroutine.
+   */
+  Coroutine(const std::pair<lua_State*, lua_State*>& new_thread_state, int ref,
+            IdleThreads& idle_threads);
+  ~Coroutine();
+
   lua_State* luaState() { return coroutine_state_.get(); }
   State state() { return state_; }
 
@@ -354,9 +391,13 @@ public:
    */
   void resume(int num_args, const std::function<void()>& yield_callback);
 
+  // The most threads kept in a pool for reuse.
+  static constexpr size_t MaxIdleThreads = 128;
+
 private:
   LuaRef<lua_State> coroutine_state_;
   State state_{State::NotStarted};
+  IdleThreads& idle_threads_;
 };
 
 using CoroutinePtr = std::unique_ptr<Coroutine>;
@@ -373,7 +414,8 @@ public:
   ThreadLocalState(const std::string& code, ThreadLocal::SlotAllocator& tls);
 
   /**
-   * @return CoroutinePtr a new coroutine.
+   * @return CoroutinePtr a new coroutine. Its thread is taken from the threads of the finished
+   *         coroutines of this worker, if any.
    */
   CoroutinePtr createCoroutine();
 
@@ -417,10 +459,12 @@ public:
 
 private:
   struct LuaThreadLocal : public ThreadLocal::ThreadLocalObject {
-    LuaThreadLocal(const std::string& code);
+    LuaThreadLocal(const std::string& bytecode);
 
     CSmartPtr<lua_State, lua_close> state_;
     std::vector<int> global_slots_;
+    // Freed with the state.
+    Coroutine::IdleThreads idle_threads_;
   };
 
   CSmartPtr<lua_State, lua_close>& tlsState() { return (*tls_slot_)->state_; }
@@ -84,11 +84,13 @@ public:
    * @param domain specifies the rate limit domain.
    * @param descriptors specifies a list of descriptors to query.
    * @param parent_span source for generating an egress child span as part of the trace.
+   * @param hits_addend specifies the number of hits the request stands for, or 0 for a single hit.
    *
    */
   virtual void limit(RequestCallbacks& callbacks, const std::string& domain,
                      const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
-                     Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info) PURE;
+                     Tracing::Span& parent_span, const StreamInfo::StreamInfo& stream_info,
+                     uint32_t hits_addend) PURE;
 };
 
 using ClientPtr = std::unique_ptr<Client>;
@@ -2,6 +2,8 @@
 
 #include "envoy/config/rbac/v3/rbac.pb.h"
 
+#include <map>
+
 #include "common/http/header_map_impl.h"
 
 namespace Envoy {
@@ -21,9 +23,91 @@ RoleBasedAccessControlEngineImpl::RoleBasedAccessControlEngineImpl(
     }
   }
 
+  // The first matching policy in the order of the names is the effective one.
+  std::map<std::string, const envoy::config::rbac::v3::Policy*> sorted_policies;
   for (const auto& policy : rules.policies()) {
-    policies_.emplace(policy.first, std::make_unique<PolicyMatcher>(policy.second, builder_.get()));
+    sorted_policies.emplace(policy.first, &policy.second);
+  }
+  policies_.reserve(sorted_policies.size());
+  for (const auto& policy : sorted_policies) {
+    policies_.push_back(
+        {policy.first, std::make_unique<PolicyMatcher>(*policy.second, builder_.get())});
   }
+
+  buildPrincipalTries(rules);
+}
+
+void RoleBasedAccessControlEngineImpl::buildPrincipalTries(
+    const envoy::config::rbac::v3::RBAC& rules) {
+  std::array<std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>>,
+             IPMatcher::DownstreamRemote + 1>
+      trie_data;
+  size_t num_ranges = 0;
+  for (uint32_t i = 0; i < policies_.size(); i++) {
+    const auto& principals = rules.policies().at(policies_[i].name_).principals();
+    std::vector<std::pair<IPMatcher::Type, const envoy::config::core::v3::CidrRange*>> ranges;
+    for (const auto& principal : principals) {
+      switch (principal.identifier_case()) {
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kSourceIp:
+        ranges.emplace_back(IPMatcher::ConnectionRemote, &principal.source_ip());
+        break;
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kDirectRemoteIp:
+        ranges.emplace_back(IPMatcher::DownstreamDirectRemote, &principal.direct_remote_ip());
+        break;
+      case envoy::config::rbac::v3::Principal::IdentifierCase::kRemoteIp:
+        ranges.emplace_back(IPMatcher::DownstreamRemote, &principal.remote_ip());
+        break;
+      default:
+        break;
+      }
+    }
+    if (ranges.empty() || ranges.size() != static_cast<size_t>(principals.size())) {
+      continue;
+    }
+
+    policies_[i].ip_principals_ = true;
+    for (const auto& range : ranges) {
+      // An invalid range never matches.
+      const auto cidr = Network::Address::CidrRange::create(*range.second);
+      if (cidr.isValid()) {
+        trie_data[range.first].push_back({i, {cidr}});
+        num_ranges++;
+      }
+    }
+  }
+
+  // The tries can't hold more than MaxLcTrieNodes / 4 ranges with the default fill factor.
+  if (num_ranges > Network::LcTrie::MaxLcTrieNodes / 4) {
+    for (Policy& policy : policies_) {
+      policy.ip_principals_ = false;
+    }
+    return;
+  }
+  for (size_t type = 0; type < trie_data.size(); type++) {
+    if (!trie_data[type].empty()) {
+      principal_tries_[type] = std::make_unique<PrincipalTrie>(trie_data[type]);
+    }
+  }
+}
+
+std::vector<bool>
+RoleBasedAccessControlEngineImpl::matchIpPrincipals(const Network::Connection& connection,
+                                                    const StreamInfo::StreamInfo& info) const {
+  std::vector<bool> matches(policies_.size());
+  for (size_t type = 0; type < principal_tries_.size(); type++) {
+    if (principal_tries_[type] == nullptr) {
+      continue;
+    }
+    const Network::Address::InstanceConstSharedPtr address =
+        IPMatcher::extractIpAddress(static_cast<IPMatcher::Type>(type), connection, info);
+    if (address == nullptr || address->ip() == nullptr) {
+      continue;
+    }
+    for (const uint32_t index : principal_tries_[type]->getData(address)) {
+      matches[index] = true;
+    }
+  }
+  return matches;
 }
 
 bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& connection,
@@ -63,19 +147,32 @@ bool RoleBasedAccessControlEngineImpl::handleAction(const Network::Connection& c
 bool RoleBasedAccessControlEngineImpl::checkPolicyMatch(
     const Network::Connection& connection, const StreamInfo::StreamInfo& info,
     const Envoy::Http::RequestHeaderMap& headers, std::string* effective_policy_id) const {
-  bool matched = false;
-
-  for (const auto& policy : policies_) {
-    if (policy.second->matches(connection, headers, info)) {
-      matched = true;
-      if (effective_policy_id != nullptr) {
-        *effective_policy_id = policy.first;
+  // The IP principals of all the policies are looked up at once, when the first policy that only
+  // has IP principals is reached.
+  absl::optional<std::vector<bool>> ip_principal_matches;
+  // The conditions of the policies share an activation.
+  Expr::RequestActivation activation(info, headers);
+  for (size_t i = 0; i < policies_.size(); i++) {
+    const Policy& policy = policies_[i];
+    if (policy.ip_principals_) {
+      if (!ip_principal_matches.has_value()) {
+        ip_principal_matches = matchIpPrincipals(connection, info);
       }
-      break;
+      if (!ip_principal_matches.value()[i] ||
+          !policy.matcher_->matchesWithoutPrincipals(connection, headers, info, activation)) {
+        continue;
+      }
+    } else if (!policy.matcher_->matches(connection, headers, info, activation)) {
+      continue;
     }
+
+    if (effective_policy_id != nullptr) {
+      *effective_policy_id = policy.name_;
+    }
+    return true;
   }
 
-  return matched;
+  return false;
 }
 
 } // namespace RBAC
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "envoy/config/rbac/v3/rbac.pb.h"
 
+#include "common/network/lc_trie.h"
+
 #include "extensions/filters/common/rbac/engine.h"
 #include "extensions/filters/common/rbac/matchers.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -43,10 +52,30 @@ private:
                         const Envoy::Http::RequestHeaderMap& headers,
                         std::string* effective_policy_id) const;
 
+  struct Policy {
+    std::string name_;
+    std::unique_ptr<PolicyMatcher> matcher_;
+    // Whether the principals of the policy are all IP ranges, which are checked by looking up the
+    // principal tries instead.
+    bool ip_principals_{};
+  };
+
+  using PrincipalTrie = Network::LcTrie::LcTrie<uint32_t>;
+
+  // Indexes the IP principals of the policies whose principals are only made of IP ranges.
+  void buildPrincipalTries(const envoy::config::rbac::v3::RBAC& rules);
+  // Returns, for each policy, whether one of its IP principals matches.
+  std::vector<bool> matchIpPrincipals(const Network::Connection& connection,
+                                      const StreamInfo::StreamInfo& info) const;
+
   const envoy::config::rbac::v3::RBAC::Action action_;
   const EnforcementMode mode_;
 
-  std::map<std::string, std::unique_ptr<PolicyMatcher>> policies_;
+  // The policies, in the order of their names.
+  std::vector<Policy> policies_;
+  // The tries of the IP principals of the policies by IPMatcher::Type, whose data are the indexes
+  // of the policies in policies_.
+  std::array<std::unique_ptr<PrincipalTrie>, IPMatcher::DownstreamRemote + 1> principal_tries_;
 
   Protobuf::Arena constant_arena_;
   Expr::BuilderPtr builder_;
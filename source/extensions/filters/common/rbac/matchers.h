@@ -145,6 +145,13 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo& info) const override;
 
+  /**
+   * @return the address of the connection or the request that a matcher of the given type checks.
+   */
+  static Network::Address::InstanceConstSharedPtr
+  extractIpAddress(Type type, const Network::Connection& connection,
+                   const StreamInfo::StreamInfo& info);
+
 private:
   const Network::Address::CidrRange range_;
   const Type type_;
@@ -200,6 +207,22 @@ public:
   bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
                const StreamInfo::StreamInfo&) const override;
 
+  /**
+   * Same as matches(), with the condition evaluated in an activation shared with the other
+   * policies checked for the same request.
+   */
+  bool matches(const Network::Connection& connection, const Envoy::Http::RequestHeaderMap& headers,
+               const StreamInfo::StreamInfo& info, Expr::RequestActivation& activation) const;
+
+  /**
+   * Returns whether the permissions and the condition of the policy match, for the callers that
+   * already know that its principals match.
+   */
+  bool matchesWithoutPrincipals(const Network::Connection& connection,
+                                const Envoy::Http::RequestHeaderMap& headers,
+                                const StreamInfo::StreamInfo& info,
+                                Expr::RequestActivation& activation) const;
+
 private:
   const OrMatcher permissions_;
   const OrMatcher principals_;
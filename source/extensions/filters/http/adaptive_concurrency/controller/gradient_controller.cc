@@ -8,6 +8,7 @@
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3/adaptive_concurrency.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/cleanup.h"
 #include "common/protobuf/protobuf.h"
@@ -45,14 +46,24 @@ GradientControllerConfig::GradientControllerConfig(
       min_rtt_buffer_pct_(
           PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(proto_config.min_rtt_calc_params(), buffer, 25)) {}
 GradientController::GradientController(GradientControllerConfig config,
-                                       Event::Dispatcher& dispatcher, Runtime::Loader&,
+                                       Event::Dispatcher& dispatcher,
+                                       ThreadLocal::SlotAllocator& tls, Runtime::Loader&,
                                        const std::string& stats_prefix, Stats::Scope& scope,
                                        Random::RandomGenerator& random, TimeSource& time_source)
     : config_(std::move(config)), dispatcher_(dispatcher), scope_(scope),
       stats_(generateStats(scope_, stats_prefix)), random_(random), time_source_(time_source),
       deferred_limit_value_(0), num_rq_outstanding_(0),
       concurrency_limit_(config_.minConcurrency()),
-      latency_sample_hist_(hist_fast_alloc(), hist_free) {
+      latency_sample_hist_(hist_fast_alloc(), hist_free),
+      all_thread_samples_(std::make_shared<AllThreadSamples>()), tls_(tls),
+      num_min_rtt_samples_(0) {
+  tls_.set([all_thread_samples = all_thread_samples_](Event::Dispatcher&) {
+    auto samples = std::make_shared<ThreadLocalSamples>();
+    absl::MutexLock ml(&all_thread_samples->mutex_);
+    all_thread_samples->samples_.push_back(samples);
+    return samples;
+  });
+
   min_rtt_calc_timer_ = dispatcher_.createTimer([this]() -> void { enterMinRTTSamplingWindow(); });
 
   sample_reset_timer_ = dispatcher_.createTimer([this]() -> void {
@@ -103,7 +114,8 @@ void GradientController::enterMinRTTSamplingWindow() {
 
   // Throw away any latency samples from before the recalculation window as it may not represent
   // the minRTT.
-  hist_clear(latency_sample_hist_.get());
+  clearLatencySamples();
+  num_min_rtt_samples_.store(0);
 
   min_rtt_epoch_ = time_source_.monotonicTime();
 }
@@ -111,8 +123,12 @@ void GradientController::enterMinRTTSamplingWindow() {
 void GradientController::updateMinRTT() {
   // Only update minRTT when it is in minRTT sampling window and
   // number of samples is greater than or equal to the minRTTAggregateRequestCount.
-  if (!inMinRTTSamplingWindow() ||
-      hist_sample_count(latency_sample_hist_.get()) < config_.minRTTAggregateRequestCount()) {
+  if (!inMinRTTSamplingWindow()) {
+    return;
+  }
+
+  mergeLatencySamples();
+  if (hist_sample_count(latency_sample_hist_.get()) < config_.minRTTAggregateRequestCount()) {
     return;
   }
 
@@ -142,6 +158,7 @@ void GradientController::resetSampleWindow() {
   // The sampling window must not be reset while sampling for the new minRTT value.
   ASSERT(!inMinRTTSamplingWindow());
 
+  mergeLatencySamples();
   if (hist_sample_count(latency_sample_hist_.get()) == 0) {
     return;
   }
@@ -152,6 +169,25 @@ void GradientController::resetSampleWindow() {
   updateConcurrencyLimit(calculateNewLimit());
 }
 
+void GradientController::mergeLatencySamples() {
+  absl::MutexLock ml(&all_thread_samples_->mutex_);
+  for (const auto& samples : all_thread_samples_->samples_) {
+    absl::MutexLock samples_lock(&samples->mutex_);
+    histogram_t* const thread_hist = samples->latency_sample_hist_.get();
+    hist_accumulate(latency_sample_hist_.get(), &thread_hist, 1);
+    hist_clear(samples->latency_sample_hist_.get());
+  }
+}
+
+void GradientController::clearLatencySamples() {
+  absl::MutexLock ml(&all_thread_samples_->mutex_);
+  for (const auto& samples : all_thread_samples_->samples_) {
+    absl::MutexLock samples_lock(&samples->mutex_);
+    hist_clear(samples->latency_sample_hist_.get());
+  }
+  hist_clear(latency_sample_hist_.get());
+}
+
 std::chrono::microseconds GradientController::processLatencySamplesAndClear() {
   const std::array<double, 1> quantile{config_.sampleAggregatePercentile()};
   std::array<double, 1> calculated_quantile;
@@ -212,8 +248,17 @@ void GradientController::recordLatencySample(MonotonicTime rq_send_time) {
                                                             rq_send_time);
   synchronizer_.syncPoint("pre_hist_insert");
   {
+    ThreadLocalSamples& samples = *tls_;
+    absl::MutexLock ml(&samples.mutex_);
+    hist_insert(samples.latency_sample_hist_.get(), rq_latency.count(), 1);
+  }
+
+  // The samples are merged by the sample reset timer outside of the minRTT calculation window, so
+  // the thread recording a sample only needs to merge them once the minRTT calculation window has
+  // enough samples.
+  if (inMinRTTSamplingWindow() &&
+      ++num_min_rtt_samples_ >= config_.minRTTAggregateRequestCount()) {
     absl::MutexLock ml(&sample_mutation_mtx_);
-    hist_insert(latency_sample_hist_.get(), rq_latency.count(), 1);
     updateMinRTT();
   }
 }
@@ -9,6 +9,7 @@
 #include "envoy/extensions/filters/http/adaptive_concurrency/v3/adaptive_concurrency.pb.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/stats/stats_macros.h"
+#include "envoy/thread_local/thread_local.h"
 
 #include "common/common/thread_synchronizer.h"
 
@@ -195,6 +196,11 @@ using GradientControllerConfigSharedPtr = std::shared_ptr<GradientControllerConf
  * calculation is complete, a timer is set to trigger the next minRTT sampling window by the worker
  * thread who updates the minRTT value.
  *
+ * The latency samples are recorded by each worker thread in a histogram of its own, and the
+ * histograms of all the threads are merged into a single one when the samples are processed, at
+ * the end of the sample window or once a worker thread recorded the last sample of the minRTT
+ * calculation window. This keeps the worker threads from contending on a single histogram.
+ *
  * If the controller is not in a minRTT sampling window, it's possible that the controller is in a
  * sampleRTT calculation window. In this, all of the latency samples are consolidated into a
  * configurable quantile value to represent the measured latencies. This quantile value sets
@@ -209,11 +215,15 @@ using GradientControllerConfigSharedPtr = std::shared_ptr<GradientControllerConf
  * prevent the overlap of these windows. It is necessary for a worker thread to know specifically if
  * the controller is inside of a minRTT recalculation window during the recording of a latency
  * sample, so this extra bit of information is stored in inMinRTTSamplingWindow().
+ *
+ * The histogram of each thread has a mutex of its own, which is only contended when the samples are
+ * merged.
  */
 class GradientController : public ConcurrencyController {
 public:
   GradientController(GradientControllerConfig config, Event::Dispatcher& dispatcher,
-                     Runtime::Loader& runtime, const std::string& stats_prefix, Stats::Scope& scope,
+                     ThreadLocal::SlotAllocator& tls, Runtime::Loader& runtime,
+                     const std::string& stats_prefix, Stats::Scope& scope,
                      Random::RandomGenerator& random, TimeSource& time_source);
 
   // Used in unit tests to validate worker thread interactions.
@@ -229,9 +239,32 @@ public:
   uint32_t concurrencyLimit() const override { return concurrency_limit_.load(); }
 
 private:
+  using HistogramPtr = std::unique_ptr<histogram_t, decltype(&hist_free)>;
+
+  // The latency samples recorded by a single thread since they were last merged.
+  struct ThreadLocalSamples : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalSamples() : latency_sample_hist_(hist_fast_alloc(), hist_free) {}
+
+    absl::Mutex mutex_;
+    HistogramPtr latency_sample_hist_ ABSL_GUARDED_BY(mutex_);
+  };
+  using ThreadLocalSamplesSharedPtr = std::shared_ptr<ThreadLocalSamples>;
+
+  // The samples of all the threads. This is shared with the thread local slot initialization, which
+  // may outlive the controller.
+  struct AllThreadSamples {
+    absl::Mutex mutex_;
+    std::vector<ThreadLocalSamplesSharedPtr> samples_ ABSL_GUARDED_BY(mutex_);
+  };
+  using AllThreadSamplesSharedPtr = std::shared_ptr<AllThreadSamples>;
+
   static GradientControllerStats generateStats(Stats::Scope& scope,
                                                const std::string& stats_prefix);
   void updateMinRTT() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
+  // Moves the samples of all the threads into the latency sample histogram.
+  void mergeLatencySamples() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
+  // Discards the samples of all the threads and the latency sample histogram.
+  void clearLatencySamples() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   std::chrono::microseconds processLatencySamplesAndClear()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
   uint32_t calculateNewLimit() ABSL_EXCLUSIVE_LOCKS_REQUIRED(sample_mutation_mtx_);
@@ -249,9 +282,9 @@ private:
   Random::RandomGenerator& random_;
   TimeSource& time_source_;
 
-  // Protects data related to latency sampling and RTT values. In addition to protecting the latency
-  // sample histogram, the mutex ensures that the minRTT calculation window and the sample window
-  // (where the new concurrency limit is determined) do not overlap.
+  // Protects data related to latency sampling and RTT values. In addition to protecting the merged
+  // latency sample histogram, the mutex ensures that the minRTT calculation window and the sample
+  // window (where the new concurrency limit is determined) do not overlap.
   absl::Mutex sample_mutation_mtx_;
 
   // Stores the value of the concurrency limit prior to entering the minRTT update window. If this
@@ -275,9 +308,14 @@ private:
   std::atomic<uint32_t> concurrency_limit_;
 
   // Stores all sampled latencies and provides percentile estimations when using the sampled data to
-  // calculate a new concurrency limit.
-  std::unique_ptr<histogram_t, decltype(&hist_free)>
-      latency_sample_hist_ ABSL_GUARDED_BY(sample_mutation_mtx_);
+  // calculate a new concurrency limit. The samples of the threads are merged into it before being
+  // processed.
+  HistogramPtr latency_sample_hist_ ABSL_GUARDED_BY(sample_mutation_mtx_);
+  const AllThreadSamplesSharedPtr all_thread_samples_;
+  ThreadLocal::TypedSlot<ThreadLocalSamples> tls_;
+  // Counts the samples recorded during the minRTT calculation window, so that the worker threads
+  // only merge the samples once enough of them were recorded.
+  std::atomic<uint32_t> num_min_rtt_samples_;
 
   // Tracks the number of consecutive times that the concurrency limit is set to the minimum. This
   // is used to determine whether the controller should trigger an additional minRTT measurement
@@ -143,6 +143,10 @@ bool AdmissionControlFilter::shouldRejectRequest() const {
   const double total_requests = request_counts.requests;
   const double successful_requests = request_counts.successes;
   double probability = total_requests - successful_requests / config_->successRateThreshold();
+  if (probability <= 0) {
+    // The success rate is above the threshold, there is no need to draw a random number.
+    return false;
+  }
   probability = probability / (total_requests + 1);
   const auto aggression = config_->aggression();
   if (aggression != 1.0) {
@@ -152,7 +156,7 @@ bool AdmissionControlFilter::shouldRejectRequest() const {
   // Choosing an accuracy of 4 significant figures for the probability.
   static constexpr uint64_t accuracy = 1e4;
   auto r = config_->random().random();
-  return (accuracy * std::max(probability, 0.0)) > (r % accuracy);
+  return (accuracy * probability) > (r % accuracy);
 }
 
 } // namespace AdmissionControl
@@ -33,8 +33,14 @@ Http::FilterFactoryCb AdmissionControlFilterFactory::createFilterFactoryFromProt
   auto sampling_window = std::chrono::seconds(
       PROTOBUF_GET_MS_OR_DEFAULT(config, sampling_window, 1000 * defaultSamplingWindow.count()) /
       1000);
-  tls->set([sampling_window, &context](Event::Dispatcher&) {
-    return std::make_shared<ThreadLocalControllerImpl>(context.timeSource(), sampling_window);
+  SharedRequestCountsSharedPtr shared_counts;
+  if (config.aggregate_across_workers()) {
+    // A slot for each worker and one for the main thread.
+    shared_counts = std::make_shared<SharedRequestCounts>(context.options().concurrency() + 1);
+  }
+  tls->set([sampling_window, shared_counts, &context](Event::Dispatcher&) {
+    return std::make_shared<ThreadLocalControllerImpl>(context.timeSource(), sampling_window,
+                                                       shared_counts);
   });
 
   std::unique_ptr<ResponseEvaluator> response_evaluator;
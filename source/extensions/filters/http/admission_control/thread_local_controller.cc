@@ -1,44 +1,91 @@
 #include "extensions/filters/http/admission_control/thread_local_controller.h"
 
+#include <algorithm>
 #include <cstdint>
 
 #include "envoy/common/pure.h"
 #include "envoy/common/time.h"
 #include "envoy/http/codes.h"
 
+#include "common/common/assert.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace AdmissionControl {
 
-static constexpr std::chrono::seconds defaultHistoryGranularity{1};
+SharedRequestCounts::SharedRequestCounts(uint32_t max_controllers)
+    : max_controllers_(max_controllers), slots_(std::make_unique<Slot[]>(max_controllers)) {}
+
+absl::optional<uint32_t> SharedRequestCounts::registerController() {
+  const uint32_t slot = next_slot_.fetch_add(1, std::memory_order_relaxed);
+  if (slot >= max_controllers_) {
+    return absl::nullopt;
+  }
+  return slot;
+}
+
+void SharedRequestCounts::publish(uint32_t slot, int64_t second,
+                                  const ThreadLocalController::RequestData& counts) {
+  ASSERT(slot < max_controllers_);
+  slots_[slot].requests_.store(counts.requests, std::memory_order_relaxed);
+  slots_[slot].successes_.store(counts.successes, std::memory_order_relaxed);
+  slots_[slot].second_.store(second, std::memory_order_release);
+}
+
+ThreadLocalController::RequestData SharedRequestCounts::othersCounts(uint32_t slot,
+                                                                    int64_t oldest_second) const {
+  ThreadLocalController::RequestData counts;
+  for (uint32_t i = 0; i < max_controllers_; ++i) {
+    if (i == slot || slots_[i].second_.load(std::memory_order_acquire) < oldest_second) {
+      continue;
+    }
+    counts.requests += slots_[i].requests_.load(std::memory_order_relaxed);
+    counts.successes += slots_[i].successes_.load(std::memory_order_relaxed);
+  }
+  return counts;
+}
 
 ThreadLocalControllerImpl::ThreadLocalControllerImpl(TimeSource& time_source,
-                                                     std::chrono::seconds sampling_window)
-    : time_source_(time_source), sampling_window_(sampling_window) {}
+                                                     std::chrono::seconds sampling_window,
+                                                     SharedRequestCountsSharedPtr shared_counts)
+    : time_source_(time_source),
+      buckets_(std::max<int64_t>(1, sampling_window.count())), current_second_(currentSecond()),
+      shared_counts_(std::move(shared_counts)),
+      shared_slot_(shared_counts_ != nullptr ? shared_counts_->registerController()
+                                             : absl::nullopt) {}
+
+void ThreadLocalControllerImpl::maybeRotateBuckets() {
+  const int64_t now = currentSecond();
+  if (now == current_second_) {
+    return;
+  }
 
-void ThreadLocalControllerImpl::maybeUpdateHistoricalData() {
-  // Purge stale samples.
-  while (!historical_data_.empty() && ageOfOldestSample() >= sampling_window_) {
-    removeOldestSample();
+  // Clear the buckets of the seconds since the newest bucket, or all of them if the whole window
+  // went by.
+  const int64_t window = buckets_.size();
+  for (int64_t second = std::max(current_second_ + 1, now - window + 1); second <= now; ++second) {
+    RequestData& stale = bucket(second);
+    global_data_.requests -= stale.requests;
+    global_data_.successes -= stale.successes;
+    stale = RequestData();
   }
+  current_second_ = now;
 
-  // It's possible we purged stale samples from the history and are left with nothing, so it's
-  // necessary to add an empty entry. We will also need to roll over into a new entry in the
-  // historical data if we've exceeded the time specified by the granularity.
-  if (historical_data_.empty() || ageOfNewestSample() >= defaultHistoryGranularity) {
-    historical_data_.emplace_back(time_source_.monotonicTime(), RequestData());
+  if (shared_slot_.has_value()) {
+    shared_counts_->publish(shared_slot_.value(), now, global_data_);
+    others_data_ = shared_counts_->othersCounts(shared_slot_.value(), now - window + 1);
   }
 }
 
 void ThreadLocalControllerImpl::recordRequest(bool success) {
-  maybeUpdateHistoricalData();
+  maybeRotateBuckets();
 
-  // The back of the deque will be the most recent samples.
-  ++historical_data_.back().second.requests;
+  RequestData& current = bucket(current_second_);
+  ++current.requests;
   ++global_data_.requests;
   if (success) {
-    ++historical_data_.back().second.successes;
+    ++current.successes;
     ++global_data_.successes;
   }
 }
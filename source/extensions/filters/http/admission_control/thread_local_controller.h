@@ -1,10 +1,19 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
 #include "envoy/common/pure.h"
 #include "envoy/common/time.h"
 #include "envoy/http/codes.h"
 #include "envoy/thread_local/thread_local_object.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
@@ -39,13 +48,59 @@ public:
   virtual RequestData requestCounts() PURE;
 };
 
+/**
+ * The request counts of the sampling windows of the controllers of all the workers. Each controller
+ * publishes the counts of its window once per second, when it moves to a new bucket, and adds the
+ * counts published by the others to its own. No locks are taken, so a controller sees the counts
+ * of the others up to a second late, and possibly from two different publications.
+ */
+class SharedRequestCounts {
+public:
+  explicit SharedRequestCounts(uint32_t max_controllers);
+
+  /**
+   * @return the slot of a new controller, or absl::nullopt if all the slots are taken.
+   */
+  absl::optional<uint32_t> registerController();
+
+  /**
+   * Publishes the request counts of the window of a controller.
+   * @param slot supplies the slot of the controller.
+   * @param second supplies the second of the newest bucket of the window.
+   * @param counts supplies the request counts of the window.
+   */
+  void publish(uint32_t slot, int64_t second, const ThreadLocalController::RequestData& counts);
+
+  /**
+   * @param slot supplies the slot of the calling controller, whose counts are left out.
+   * @param oldest_second supplies the second of the oldest bucket of the window of the caller,
+   *        the counts published before are stale.
+   * @return the sum of the request counts published by the other controllers.
+   */
+  ThreadLocalController::RequestData othersCounts(uint32_t slot, int64_t oldest_second) const;
+
+private:
+  struct Slot {
+    std::atomic<int64_t> second_{std::numeric_limits<int64_t>::min()};
+    std::atomic<uint32_t> requests_{0};
+    std::atomic<uint32_t> successes_{0};
+  };
+
+  const uint32_t max_controllers_;
+  const std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint32_t> next_slot_{0};
+};
+
+using SharedRequestCountsSharedPtr = std::shared_ptr<SharedRequestCounts>;
+
 /**
  * Thread-local object to track request counts and successes over a rolling time window. Request
- * data for the time window is kept recent via a circular buffer that phases out old request/success
- * counts when recording new samples.
+ * data for the time window is kept in a ring of one bucket per second, and the buckets that go out
+ * of the window are cleared as the controller moves to the bucket of the current second.
  *
  * This controller is thread-local so that we do not need to take any locks on the sample histories
- * to update them, at the cost of decreasing the number of samples.
+ * to update them, at the cost of decreasing the number of samples. With shared request counts, the
+ * samples of the other workers are added to the ones of the controller.
  *
  * The look-back window for request samples is accurate up to a hard-coded 1-second granularity.
  * TODO (tonya11en): Allow the granularity to be configurable.
@@ -53,58 +108,49 @@ public:
 class ThreadLocalControllerImpl : public ThreadLocalController,
                                   public ThreadLocal::ThreadLocalObject {
 public:
-  ThreadLocalControllerImpl(TimeSource& time_source, std::chrono::seconds sampling_window);
+  ThreadLocalControllerImpl(TimeSource& time_source, std::chrono::seconds sampling_window,
+                            SharedRequestCountsSharedPtr shared_counts = nullptr);
   ~ThreadLocalControllerImpl() override = default;
   void recordSuccess() override { recordRequest(true); }
   void recordFailure() override { recordRequest(false); }
 
   RequestData requestCounts() override {
-    maybeUpdateHistoricalData();
-    return global_data_;
+    maybeRotateBuckets();
+    return {global_data_.requests + others_data_.requests,
+            global_data_.successes + others_data_.successes};
   }
 
 private:
   void recordRequest(bool success);
 
-  // Potentially remove any stale samples and record sample aggregates to the historical data.
-  void maybeUpdateHistoricalData();
-
-  // Returns the age of the oldest sample in the historical data.
-  std::chrono::microseconds ageOfOldestSample() const {
-    ASSERT(!historical_data_.empty());
-    using namespace std::chrono;
-    return duration_cast<microseconds>(time_source_.monotonicTime() -
-                                       historical_data_.front().first);
+  int64_t currentSecond() const {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               time_source_.monotonicTime().time_since_epoch())
+        .count();
   }
 
-  // Returns the age of the newest sample in the historical data.
-  std::chrono::microseconds ageOfNewestSample() const {
-    ASSERT(!historical_data_.empty());
-    using namespace std::chrono;
-    return duration_cast<microseconds>(time_source_.monotonicTime() -
-                                       historical_data_.back().first);
-  }
+  RequestData& bucket(int64_t second) { return buckets_[second % buckets_.size()]; }
 
-  // Removes the oldest sample in the historical data and reconciles the global data.
-  void removeOldestSample() {
-    ASSERT(!historical_data_.empty());
-    global_data_.successes -= historical_data_.front().second.successes;
-    global_data_.requests -= historical_data_.front().second.requests;
-    historical_data_.pop_front();
-  }
+  // Clears the buckets that went out of the window since the newest bucket, and publishes the
+  // request counts if they are shared.
+  void maybeRotateBuckets();
 
   TimeSource& time_source_;
 
-  // Stores samples from oldest (front) to newest (back). Since there is no need to read/modify
-  // entries that are not the oldest or newest (front/back), we can get away with using a deque
-  // which allocates memory in chunks and keeps most elements contiguous and cache-friendly.
-  std::deque<std::pair<MonotonicTime, RequestData>> historical_data_;
+  // The buckets of the seconds of the window, indexed by the second modulo the window size.
+  std::vector<RequestData> buckets_;
+
+  // The second of the newest bucket.
+  int64_t current_second_;
 
   // Request data aggregated for the whole look-back window.
   RequestData global_data_;
 
-  // The rolling time window size.
-  const std::chrono::seconds sampling_window_;
+  const SharedRequestCountsSharedPtr shared_counts_;
+  absl::optional<uint32_t> shared_slot_;
+
+  // The request counts of the other workers as of the last rotation.
+  RequestData others_data_;
 };
 
 } // namespace AdmissionControl
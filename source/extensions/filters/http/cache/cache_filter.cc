@@ -3,6 +3,8 @@
 #include "envoy/http/header_map.h"
 
 #include "common/common/enum_to_int.h"
+#include "common/http/codes.h"
+#include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
 
@@ -32,12 +34,17 @@ using CacheResponseCodeDetails = ConstSingleton<CacheResponseCodeDetailValues>;
 
 CacheFilter::CacheFilter(
     const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config, const std::string&,
-    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache)
-    : time_source_(time_source), cache_(http_cache),
-      vary_allow_list_(config.allowed_vary_headers()) {}
+    Stats::Scope&, TimeSource& time_source, HttpCache& http_cache,
+    RequestCollapserSharedPtr collapser, EarlyHintsStoreSharedPtr early_hints)
+    : time_source_(time_source), cache_(http_cache), collapser_(std::move(collapser)),
+      early_hints_(std::move(early_hints)),
+      vary_allow_list_(config.allowed_vary_headers()),
+      accept_encoding_variants_(config.accept_encoding_variants().begin(),
+                                config.accept_encoding_variants().end()) {}
 
 void CacheFilter::onDestroy() {
   filter_state_ = FilterState::Destroyed;
+  releaseFill();
   if (lookup_) {
     lookup_->onDestroy();
   }
@@ -63,8 +70,14 @@ Http::FilterHeadersStatus CacheFilter::decodeHeaders(Http::RequestHeaderMap& hea
   }
   ASSERT(decoder_callbacks_);
 
+  if (!accept_encoding_variants_.empty()) {
+    normalizeAcceptEncoding(headers);
+  }
   LookupRequest lookup_request(headers, time_source_.systemTime(), vary_allow_list_);
   request_allows_inserts_ = !lookup_request.requestCacheControl().no_store_;
+  if (collapser_ || early_hints_) {
+    key_ = lookup_request.key();
+  }
   lookup_ = cache_.makeLookupContext(std::move(lookup_request));
 
   ASSERT(lookup_);
@@ -94,6 +107,10 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     return Http::FilterHeadersStatus::StopIteration;
   }
 
+  if (early_hints_ && Http::CodeUtility::is2xx(Http::Utility::getResponseStatus(headers))) {
+    early_hints_->update(key_, headers);
+  }
+
   // Either a cache miss or a cache entry that is no longer valid.
   // Check if the new response can be cached.
   if (request_allows_inserts_ &&
@@ -104,6 +121,10 @@ Http::FilterHeadersStatus CacheFilter::encodeHeaders(Http::ResponseHeaderMap& he
     const ResponseMetadata metadata = {time_source_.systemTime()};
     insert_->insertHeaders(headers, metadata, end_stream);
   }
+  if (!insert_ || end_stream) {
+    // Nothing more will be inserted, so requests waiting for this response can look it up.
+    releaseFill();
+  }
   return Http::FilterHeadersStatus::Continue;
 }
 
@@ -122,10 +143,22 @@ Http::FilterDataStatus CacheFilter::encodeData(Buffer::Instance& data, bool end_
     // TODO(toddmgreer): Wait for the cache if necessary.
     insert_->insertBody(
         data, [](bool) {}, end_stream);
+    if (end_stream) {
+      releaseFill();
+    }
   }
   return Http::FilterDataStatus::Continue;
 }
 
+void CacheFilter::normalizeAcceptEncoding(Http::RequestHeaderMap& request_headers) const {
+  const Http::LowerCaseString& accept_encoding = Http::CustomHeaders::get().AcceptEncoding;
+  const auto all_values = Http::HeaderUtility::getAllOfHeaderAsString(request_headers,
+                                                                       accept_encoding, ",");
+  const absl::string_view coding = CacheHeadersUtils::negotiateContentCoding(
+      all_values.result().value_or(""), accept_encoding_variants_);
+  request_headers.setCopy(accept_encoding, coding);
+}
+
 void CacheFilter::getHeaders(Http::RequestHeaderMap& request_headers) {
   ASSERT(lookup_, "CacheFilter is trying to call getHeaders with no LookupContext");
 
@@ -241,8 +274,14 @@ void CacheFilter::onHeaders(LookupResult&& result, Http::RequestHeaderMap& reque
     lookup_result_ = std::make_unique<LookupResult>(std::move(result));
     filter_state_ = FilterState::ValidatingCachedResponse;
     injectValidationHeaders(request_headers);
+    encodeEarlyHints();
     break;
   case CacheEntryStatus::Unusable:
+    if (waitForFill(request_headers)) {
+      // The decoding stream stays stopped until the fill finishes and the lookup is repeated.
+      return;
+    }
+    encodeEarlyHints();
     break;
   case CacheEntryStatus::NotSatisfiableRange:
     lookup_result_ = std::make_unique<LookupResult>(std::move(result));
@@ -345,6 +384,63 @@ void CacheFilter::onTrailers(Http::ResponseTrailerMapPtr&& trailers) {
   finalizeEncodingCachedResponse();
 }
 
+bool CacheFilter::waitForFill(Http::RequestHeaderMap& request_headers) {
+  if (!collapser_ || waited_for_fill_) {
+    return false;
+  }
+  // As in getHeaders, the filter may be gone by the time the posted wake callback runs.
+  CacheFilterWeakPtr self = weak_from_this();
+  if (collapser_->tryFill(key_, decoder_callbacks_->dispatcher(), [self, &request_headers]() {
+        if (CacheFilterSharedPtr cache_filter = self.lock()) {
+          cache_filter->onFillFinished(request_headers);
+        }
+      })) {
+    filling_ = true;
+    return false;
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter::onHeaders waiting for another request to fill the cache",
+                   *decoder_callbacks_);
+  waited_for_fill_ = true;
+  return true;
+}
+
+void CacheFilter::onFillFinished(Http::RequestHeaderMap& request_headers) {
+  if (filter_state_ == FilterState::Destroyed) {
+    // The filter is being destroyed, any callbacks should be ignored.
+    return;
+  }
+  lookup_->onDestroy();
+  LookupRequest lookup_request(request_headers, time_source_.systemTime(), vary_allow_list_);
+  lookup_ = cache_.makeLookupContext(std::move(lookup_request));
+  getHeaders(request_headers);
+}
+
+void CacheFilter::releaseFill() {
+  if (filling_) {
+    filling_ = false;
+    collapser_->release(key_);
+  }
+}
+
+void CacheFilter::encodeEarlyHints() {
+  if (!early_hints_ || early_hints_sent_) {
+    return;
+  }
+  const EarlyHintsStore::LinksConstSharedPtr links = early_hints_->find(key_);
+  if (links == nullptr) {
+    return;
+  }
+  early_hints_sent_ = true;
+  Http::ResponseHeaderMapPtr headers = Http::ResponseHeaderMapImpl::create();
+  headers->setStatus(enumToInt(Http::Code::EarlyHints));
+  for (const std::string& link : *links) {
+    headers->addCopy(EarlyHintsStore::linkHeader(), link);
+  }
+  ENVOY_STREAM_LOG(debug, "CacheFilter::onHeaders sending early hints: {}", *decoder_callbacks_,
+                   *headers);
+  decoder_callbacks_->encodeEarlyHintsHeaders(std::move(headers));
+}
+
 void CacheFilter::processSuccessfulValidation(Http::ResponseHeaderMap& response_headers) {
   ASSERT(lookup_result_, "CacheFilter trying to validate a non-existent lookup result");
   ASSERT(
@@ -10,7 +10,9 @@
 #include "common/common/logger.h"
 
 #include "extensions/filters/http/cache/cache_headers_utils.h"
+#include "extensions/filters/http/cache/early_hints_store.h"
 #include "extensions/filters/http/cache/http_cache.h"
+#include "extensions/filters/http/cache/request_collapser.h"
 #include "extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -27,7 +29,8 @@ class CacheFilter : public Http::PassThroughFilter,
 public:
   CacheFilter(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
               const std::string& stats_prefix, Stats::Scope& scope, TimeSource& time_source,
-              HttpCache& http_cache);
+              HttpCache& http_cache, RequestCollapserSharedPtr collapser,
+              EarlyHintsStoreSharedPtr early_hints = nullptr);
   // Http::StreamFilterBase
   void onDestroy() override;
   // Http::StreamDecoderFilter
@@ -39,6 +42,11 @@ public:
   Http::FilterDataStatus encodeData(Buffer::Instance& buffer, bool end_stream) override;
 
 private:
+  // Replaces the Accept-Encoding header of a cacheable request by the coding negotiated among
+  // accept_encoding_variants_, so that the requests negotiating the same coding share a cached
+  // variant.
+  void normalizeAcceptEncoding(Http::RequestHeaderMap& request_headers) const;
+
   // Utility functions; make any necessary checks and call the corresponding lookup_ functions
   void getHeaders(Http::RequestHeaderMap& request_headers);
   void getBody();
@@ -49,6 +57,20 @@ private:
   void onBody(Buffer::InstancePtr&& body);
   void onTrailers(Http::ResponseTrailerMapPtr&& trailers);
 
+  // Called on a cache miss when requests are collapsed. Returns true if another request is already
+  // filling the cache for this key, in which case the lookup is repeated once it has finished.
+  // Otherwise this request becomes the filler and is sent upstream.
+  bool waitForFill(Http::RequestHeaderMap& request_headers);
+
+  // Repeats the cache lookup after the fill this request was waiting for has finished.
+  void onFillFinished(Http::RequestHeaderMap& request_headers);
+
+  // Wakes the requests waiting for this one to fill the cache, if it is a filler.
+  void releaseFill();
+
+  // Sends the early hints remembered for key_ before the request is sent upstream.
+  void encodeEarlyHints();
+
   // Precondition: lookup_result_ points to a cache lookup result that requires validation.
   //               filter_state_ is ValidatingCachedResponse.
   // Serves a validated cached response after updating it with a 304 response.
@@ -81,6 +103,20 @@ private:
   InsertContextPtr insert_;
   LookupResultPtr lookup_result_;
 
+  // Null unless requests are collapsed.
+  const RequestCollapserSharedPtr collapser_;
+  // Null unless early hints are sent.
+  const EarlyHintsStoreSharedPtr early_hints_;
+  // The key this request looked up, kept while requests are collapsed or early hints are sent so
+  // that it's still known after lookup_ has been handed to the insert context.
+  Key key_;
+  // True while this request is filling the cache for key_ on behalf of collapsed requests.
+  bool filling_ = false;
+  // True once this request has waited for a fill, so that it is sent upstream if it misses again.
+  bool waited_for_fill_ = false;
+  // True once the early hints have been sent, so that they are sent at most once per request.
+  bool early_hints_sent_ = false;
+
   // Tracks what body bytes still need to be read from the cache. This is
   // currently only one Range, but will expand when full range support is added. Initialized by
   // onHeaders for Range Responses, otherwise initialized by encodeCachedResponse.
@@ -92,6 +128,10 @@ private:
   // Stores the allow list rules that decide if a header can be varied upon.
   VaryHeader vary_allow_list_;
 
+  // The content codings that cached responses are stored for, in order of preference. Empty unless
+  // Accept-Encoding is normalized.
+  const std::vector<std::string> accept_encoding_variants_;
+
   // True if the response has trailers.
   // TODO(toddmgreer): cache trailers.
   bool response_has_trailers_ = false;
@@ -12,7 +12,9 @@
 #include "extensions/filters/http/cache/cache_custom_headers.h"
 
 #include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_split.h"
 
@@ -231,6 +233,37 @@ CacheHeadersUtils::parseCommaDelimitedList(const Http::HeaderMap::GetResult& ent
   return header_values;
 }
 
+absl::string_view
+CacheHeadersUtils::negotiateContentCoding(absl::string_view accept_encoding,
+                                          const std::vector<std::string>& codings) {
+  // Whether each listed coding is acceptable, which it isn't if its quality value is 0.
+  absl::flat_hash_map<std::string, bool> acceptable;
+  for (absl::string_view entry : absl::StrSplit(accept_encoding, ',', absl::SkipWhitespace())) {
+    const std::vector<absl::string_view> params = absl::StrSplit(entry, ';');
+    bool is_acceptable = true;
+    for (size_t i = 1; i < params.size(); i++) {
+      const absl::string_view param = absl::StripAsciiWhitespace(params[i]);
+      double quality;
+      if (absl::StartsWithIgnoreCase(param, "q=")) {
+        is_acceptable = absl::SimpleAtod(param.substr(2), &quality) && quality > 0;
+      }
+    }
+    acceptable[absl::AsciiStrToLower(absl::StripAsciiWhitespace(params[0]))] = is_acceptable;
+  }
+
+  for (const std::string& coding : codings) {
+    auto it = acceptable.find(coding);
+    if (it == acceptable.end()) {
+      // "*" matches the codings that aren't listed.
+      it = acceptable.find("*");
+    }
+    if (it != acceptable.end() && it->second) {
+      return coding;
+    }
+  }
+  return "identity";
+}
+
 VaryHeader::VaryHeader(
     const Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher>& allow_list) {
 
@@ -118,6 +118,12 @@ public:
   // Parses the values of a comma-delimited list as defined per
   // https://tools.ietf.org/html/rfc7230#section-7.
   static std::vector<std::string> parseCommaDelimitedList(const Http::HeaderMap::GetResult& entry);
+
+  // Returns the first of the given lower case content codings that is accepted by the value of an
+  // Accept-Encoding header, or "identity" if none of them is. The Accept-Encoding header is
+  // defined per https://httpwg.org/specs/rfc7231.html#header.accept-encoding.
+  static absl::string_view negotiateContentCoding(absl::string_view accept_encoding,
+                                                  const std::vector<std::string>& codings);
 };
 
 class VaryHeader {
@@ -18,11 +18,20 @@ Http::FilterFactoryCb CacheFilterFactory::createFilterFactoryFromProtoTyped(
         fmt::format("Didn't find a registered implementation for type: '{}'", type));
   }
 
-  return [config, stats_prefix, &context,
-          http_cache_factory](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+  // Resolve the cache once on the main thread rather than on every filter chain creation.
+  HttpCache& http_cache = http_cache_factory->getCache(config, context);
+  RequestCollapserSharedPtr collapser =
+      config.collapse_requests() ? std::make_shared<RequestCollapser>() : nullptr;
+  EarlyHintsStoreSharedPtr early_hints =
+      config.has_early_hints()
+          ? std::make_shared<EarlyHintsStore>(
+                PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.early_hints(), max_entries, 1024))
+          : nullptr;
+  return [config, stats_prefix, &context, &http_cache, collapser,
+          early_hints](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamFilter(std::make_shared<CacheFilter>(config, stats_prefix, context.scope(),
-                                                            context.timeSource(),
-                                                            http_cache_factory->getCache(config)));
+                                                            context.timeSource(), http_cache,
+                                                            collapser, early_hints));
   };
 }
 
@@ -0,0 +1,113 @@
+#include "extensions/filters/http/cache/early_hints_store.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "common/common/macros.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+namespace {
+
+// Whether the parameters of a link, as in https://tools.ietf.org/html/rfc8288#section-3, give it
+// the preload or preconnect relation.
+bool isEarlyHint(absl::string_view params) {
+  for (absl::string_view param : absl::StrSplit(params, ';')) {
+    const std::pair<absl::string_view, absl::string_view> name_value =
+        absl::StrSplit(param, absl::MaxSplits('=', 1));
+    if (!absl::EqualsIgnoreCase(absl::StripAsciiWhitespace(name_value.first), "rel")) {
+      continue;
+    }
+    absl::string_view relations = absl::StripAsciiWhitespace(name_value.second);
+    if (relations.size() >= 2 && relations.front() == '"' && relations.back() == '"') {
+      relations = relations.substr(1, relations.size() - 2);
+    }
+    for (absl::string_view relation : absl::StrSplit(relations, ' ', absl::SkipEmpty())) {
+      if (absl::EqualsIgnoreCase(relation, "preload") ||
+          absl::EqualsIgnoreCase(relation, "preconnect")) {
+        return true;
+      }
+    }
+    // Only the first rel parameter counts.
+    return false;
+  }
+  return false;
+}
+
+} // namespace
+
+EarlyHintsStore::LinksConstSharedPtr EarlyHintsStore::find(const Key& key) const {
+  absl::MutexLock lock(&mutex_);
+  const auto it = links_.find(key);
+  return it != links_.end() ? it->second : nullptr;
+}
+
+void EarlyHintsStore::update(const Key& key, const Http::ResponseHeaderMap& response_headers) {
+  std::vector<std::string> links;
+  const auto values = response_headers.get(linkHeader());
+  for (size_t i = 0; i < values.size(); i++) {
+    std::vector<std::string> hints = earlyHints(values[i]->value().getStringView());
+    std::move(hints.begin(), hints.end(), std::back_inserter(links));
+  }
+
+  absl::MutexLock lock(&mutex_);
+  if (links.empty()) {
+    links_.erase(key);
+    return;
+  }
+  auto it = links_.find(key);
+  if (it == links_.end()) {
+    if (links_.size() >= max_entries_) {
+      links_.erase(links_.begin());
+    }
+    it = links_.try_emplace(key).first;
+  }
+  it->second = std::make_shared<const std::vector<std::string>>(std::move(links));
+}
+
+std::vector<std::string> EarlyHintsStore::earlyHints(absl::string_view link) {
+  std::vector<std::string> hints;
+  // The links are separated by the commas outside of their URI and of the quoted parameter values.
+  bool in_uri = false;
+  bool in_quotes = false;
+  size_t start = 0;
+  for (size_t i = 0; i <= link.size(); i++) {
+    if (i < link.size()) {
+      const char c = link[i];
+      if (c == '"' && !in_uri) {
+        in_quotes = !in_quotes;
+      } else if (c == '<' && !in_quotes) {
+        in_uri = true;
+      } else if (c == '>' && !in_quotes) {
+        in_uri = false;
+      }
+      if (c != ',' || in_uri || in_quotes) {
+        continue;
+      }
+    }
+    const absl::string_view value = absl::StripAsciiWhitespace(link.substr(start, i - start));
+    // The parameters follow the URI, which is npos if the link has none.
+    const size_t params = value.find(';', value.find('>'));
+    if (params != absl::string_view::npos && isEarlyHint(value.substr(params + 1))) {
+      hints.emplace_back(value);
+    }
+    start = i + 1;
+  }
+  return hints;
+}
+
+const Http::LowerCaseString& EarlyHintsStore::linkHeader() {
+  CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "link");
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
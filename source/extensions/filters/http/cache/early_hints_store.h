@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/http/header_map.h"
+
+#include "common/protobuf/utility.h"
+
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Remembers the early hints of the latest successful response for each cache key, that is its
+ * links with the preload or preconnect relation, so that they can be sent in a 103 Early Hints
+ * response to the later requests for the key that are sent upstream. One store is shared by the
+ * filters of all workers for a filter config, so it is thread-safe.
+ */
+class EarlyHintsStore {
+public:
+  using LinksConstSharedPtr = std::shared_ptr<const std::vector<std::string>>;
+
+  explicit EarlyHintsStore(uint32_t max_entries) : max_entries_(max_entries) {}
+
+  /**
+   * @param key supplies the cache key of a request.
+   * @return the links remembered for key, or nullptr if there are none.
+   */
+  LinksConstSharedPtr find(const Key& key) const;
+
+  /**
+   * Remembers the early hints of a successful response for key, forgetting those of the previous
+   * responses.
+   * @param key supplies the cache key of the request.
+   * @param response_headers supplies the headers of the response.
+   */
+  void update(const Key& key, const Http::ResponseHeaderMap& response_headers);
+
+  /**
+   * @param link supplies a link header value, which may hold several comma-separated links.
+   * @return the links of the value with the preload or preconnect relation.
+   */
+  static std::vector<std::string> earlyHints(absl::string_view link);
+
+  /**
+   * @return the name of the link header.
+   */
+  static const Http::LowerCaseString& linkHeader();
+
+private:
+  const uint32_t max_entries_;
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, LinksConstSharedPtr, MessageUtil, MessageUtil>
+      links_ ABSL_GUARDED_BY(mutex_);
+};
+
+using EarlyHintsStoreSharedPtr = std::shared_ptr<EarlyHintsStore>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,489 @@
+#include "extensions/filters/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "envoy/registry/registry.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/utility.h"
+#include "common/filesystem/directory.h"
+#include "common/http/header_map_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "source/extensions/filters/http/cache/file_system_http_cache/config.pb.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+// Entry files are laid out as:
+//   uint32 magic | uint32 key size | uint32 headers size | int64 response time (ns) | uint64 body
+//   size | serialized Key | headers | body
+// where headers are a sequence of (uint32 name size, name, uint32 value size, value). Integers are
+// in host byte order; entry files are not meant to be moved between machines.
+constexpr uint32_t EntryFileMagic = 0x31434845; // "EHC1"
+constexpr size_t EntryFilePrefixSize =
+    sizeof(uint32_t) * 3 + sizeof(int64_t) + sizeof(uint64_t);
+
+template <class T> void appendInt(std::string& out, T value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <class T> bool consumeInt(absl::string_view& in, T& value) {
+  if (in.size() < sizeof(value)) {
+    return false;
+  }
+  memcpy(&value, in.data(), sizeof(value));
+  in.remove_prefix(sizeof(value));
+  return true;
+}
+
+bool consumeString(absl::string_view& in, uint64_t size, absl::string_view& value) {
+  if (in.size() < size) {
+    return false;
+  }
+  value = in.substr(0, size);
+  in.remove_prefix(size);
+  return true;
+}
+
+std::string encodeHeaders(const Http::ResponseHeaderMap& response_headers) {
+  std::string encoded;
+  response_headers.iterate([&encoded](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
+    const absl::string_view name = header.key().getStringView();
+    const absl::string_view value = header.value().getStringView();
+    appendInt<uint32_t>(encoded, name.size());
+    encoded.append(name.data(), name.size());
+    appendInt<uint32_t>(encoded, value.size());
+    encoded.append(value.data(), value.size());
+    return Http::HeaderMap::Iterate::Continue;
+  });
+  return encoded;
+}
+
+Http::ResponseHeaderMapPtr decodeHeaders(absl::string_view encoded) {
+  Http::ResponseHeaderMapPtr response_headers = Http::ResponseHeaderMapImpl::create();
+  while (!encoded.empty()) {
+    uint32_t size;
+    absl::string_view name;
+    absl::string_view value;
+    if (!consumeInt(encoded, size) || !consumeString(encoded, size, name) ||
+        !consumeInt(encoded, size) || !consumeString(encoded, size, value)) {
+      return nullptr;
+    }
+    response_headers->addCopy(Http::LowerCaseString(std::string(name)), value);
+  }
+  return response_headers;
+}
+
+// Everything preceding the body in an entry file.
+std::string encodeEntryPrefix(const std::string& key, const Http::ResponseHeaderMap& headers,
+                              const ResponseMetadata& metadata, uint64_t body_size) {
+  const std::string encoded_headers = encodeHeaders(headers);
+  std::string prefix;
+  prefix.reserve(EntryFilePrefixSize + key.size() + encoded_headers.size());
+  appendInt<uint32_t>(prefix, EntryFileMagic);
+  appendInt<uint32_t>(prefix, key.size());
+  appendInt<uint32_t>(prefix, encoded_headers.size());
+  appendInt<int64_t>(prefix, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 metadata.response_time_.time_since_epoch())
+                                 .count());
+  appendInt<uint64_t>(prefix, body_size);
+  prefix.append(key);
+  prefix.append(encoded_headers);
+  return prefix;
+}
+
+struct DecodedEntry {
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  absl::string_view body_;
+};
+
+// Returns false if the contents are corrupt or were stored for a different key.
+bool decodeEntry(absl::string_view contents, const std::string& expected_key,
+                 DecodedEntry& entry) {
+  uint32_t magic;
+  uint32_t key_size;
+  uint32_t headers_size;
+  int64_t response_time_ns;
+  uint64_t body_size;
+  absl::string_view key;
+  absl::string_view headers;
+  if (!consumeInt(contents, magic) || magic != EntryFileMagic || !consumeInt(contents, key_size) ||
+      !consumeInt(contents, headers_size) || !consumeInt(contents, response_time_ns) ||
+      !consumeInt(contents, body_size) || !consumeString(contents, key_size, key) ||
+      key != expected_key || !consumeString(contents, headers_size, headers) ||
+      contents.size() != body_size) {
+    return false;
+  }
+  entry.response_headers_ = decodeHeaders(headers);
+  if (entry.response_headers_ == nullptr) {
+    return false;
+  }
+  entry.metadata_.response_time_ = SystemTime(
+      std::chrono::duration_cast<SystemTime::duration>(std::chrono::nanoseconds(response_time_ns)));
+  entry.body_ = contents;
+  return true;
+}
+
+bool writeAll(int fd, absl::string_view data) {
+  while (!data.empty()) {
+    const ssize_t rc = ::write(fd, data.data(), data.size());
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      return false;
+    }
+    data.remove_prefix(rc);
+  }
+  return true;
+}
+
+// Writes the entry to a temporary file and renames it into place, so that lookups never observe a
+// partially written entry.
+bool writeEntryFile(const std::string& path, absl::string_view prefix,
+                    const Buffer::Instance& body) {
+  const std::string temp_path = absl::StrCat(path, ".tmp");
+  const int fd = ::open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (fd < 0) {
+    return false;
+  }
+  bool written = writeAll(fd, prefix);
+  for (const Buffer::RawSlice& slice : body.getRawSlices()) {
+    written = written && writeAll(fd, {static_cast<const char*>(slice.mem_), slice.len_});
+  }
+  written = ::close(fd) == 0 && written;
+  if (!written || ::rename(temp_path.c_str(), path.c_str()) != 0) {
+    ::unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+// A buffer fragment referencing part of a mapped entry file. It holds a reference to the mapping
+// so that the data stays valid until the buffer is done with it.
+class MappedBodyFragment : public Buffer::BufferFragment {
+public:
+  MappedBodyFragment(MappedCacheFileSharedPtr file, absl::string_view data)
+      : file_(std::move(file)), data_(data) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return data_.data(); }
+  size_t size() const override { return data_.size(); }
+  void done() override { delete this; }
+
+private:
+  const MappedCacheFileSharedPtr file_;
+  const absl::string_view data_;
+};
+
+class FileLookupContext : public LookupContext {
+public:
+  FileLookupContext(FileSystemHttpCache& cache, LookupRequest&& request)
+      : cache_(cache), state_(std::make_shared<State>(std::move(request))) {}
+
+  void getHeaders(LookupHeadersCallback&& cb) override {
+    const uint64_t key_hash = localHashKey(state_->request_.key());
+    if (!cache_.mayContain(key_hash)) {
+      cb(LookupResult{});
+      return;
+    }
+
+    // The work only references the shared state, since this context may be destroyed while it is
+    // queued.
+    cache_.post([state = state_, path = cache_.entryPath(key_hash), cb = std::move(cb)]() {
+      MappedCacheFileSharedPtr file = MappedCacheFile::map(path);
+      DecodedEntry entry;
+      const bool found =
+          file != nullptr &&
+          decodeEntry(file->contents(), state->request_.key().SerializeAsString(), entry);
+
+      absl::MutexLock lock(&state->mutex_);
+      if (state->destroyed_) {
+        return;
+      }
+      if (!found) {
+        cb(LookupResult{});
+        return;
+      }
+      state->file_ = std::move(file);
+      state->body_ = entry.body_;
+      cb(state->request_.makeLookupResult(std::move(entry.response_headers_),
+                                          std::move(entry.metadata_), entry.body_.size()));
+    });
+  }
+
+  void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
+    absl::MutexLock lock(&state_->mutex_);
+    ASSERT(state_->file_ != nullptr);
+    ASSERT(range.end() <= state_->body_.length(), "Attempt to read past end of body.");
+    auto body = std::make_unique<Buffer::OwnedImpl>();
+    body->addBufferFragment(*new MappedBodyFragment(
+        state_->file_, state_->body_.substr(range.begin(), range.length())));
+    cb(std::move(body));
+  }
+
+  void getTrailers(LookupTrailersCallback&&) override {
+    // TODO(toddmgreer): Support trailers.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  void onDestroy() override {
+    // Waits for a lookup running on the I/O thread to finish calling back, and stops any queued
+    // one from doing so.
+    absl::MutexLock lock(&state_->mutex_);
+    state_->destroyed_ = true;
+  }
+
+  const LookupRequest& request() const { return state_->request_; }
+
+private:
+  struct State {
+    State(LookupRequest&& request) : request_(std::move(request)) {}
+
+    const LookupRequest request_;
+    absl::Mutex mutex_;
+    bool destroyed_ ABSL_GUARDED_BY(mutex_){false};
+    MappedCacheFileSharedPtr file_ ABSL_GUARDED_BY(mutex_);
+    absl::string_view body_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  FileSystemHttpCache& cache_;
+  const std::shared_ptr<State> state_;
+};
+
+class FileInsertContext : public InsertContext {
+public:
+  FileInsertContext(LookupContext& lookup_context, FileSystemHttpCache& cache)
+      : key_(dynamic_cast<FileLookupContext&>(lookup_context).request().key()), cache_(cache) {}
+
+  void insertHeaders(const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata, bool end_stream) override {
+    ASSERT(!committed_);
+    if (VaryHeader::hasVary(response_headers)) {
+      aborted_ = true;
+      return;
+    }
+    response_headers_ = Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers);
+    metadata_ = metadata;
+    if (end_stream) {
+      commit();
+    }
+  }
+
+  void insertBody(const Buffer::Instance& chunk, InsertCallback ready_for_next_chunk,
+                  bool end_stream) override {
+    ASSERT(!committed_);
+    ASSERT(ready_for_next_chunk || end_stream);
+    if (aborted_) {
+      if (ready_for_next_chunk) {
+        ready_for_next_chunk(false);
+      }
+      return;
+    }
+
+    // TODO(toddmgreer): Stream large bodies to disk rather than assembling them in memory.
+    body_.add(chunk);
+    if (end_stream) {
+      commit();
+    } else {
+      ready_for_next_chunk(true);
+    }
+  }
+
+  void insertTrailers(const Http::ResponseTrailerMap&) override {
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE; // TODO(toddmgreer): support trailers
+  }
+
+  void onDestroy() override {}
+
+private:
+  void commit() {
+    committed_ = true;
+    cache_.insert(key_, *response_headers_, metadata_, body_);
+  }
+
+  const Key key_;
+  FileSystemHttpCache& cache_;
+  Http::ResponseHeaderMapPtr response_headers_;
+  ResponseMetadata metadata_;
+  Buffer::OwnedImpl body_;
+  bool committed_ = false;
+  bool aborted_ = false;
+};
+
+} // namespace
+
+MappedCacheFileSharedPtr MappedCacheFile::map(const std::string& path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat file_stat;
+  void* data = MAP_FAILED;
+  if (::fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    data = ::mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return std::make_shared<const MappedCacheFile>(static_cast<const char*>(data),
+                                                 file_stat.st_size);
+}
+
+MappedCacheFile::~MappedCacheFile() { ::munmap(const_cast<char*>(data_), size_); }
+
+FileSystemHttpCache::FileSystemHttpCache(const std::string& cache_path,
+                                         Thread::ThreadFactory& thread_factory)
+    : cache_path_(cache_path) {
+  for (const Filesystem::DirectoryEntry& entry : Filesystem::Directory(cache_path_)) {
+    uint64_t key_hash;
+    // Temporary files left by an interrupted write don't parse and are ignored.
+    if (entry.type_ == Filesystem::FileType::Regular &&
+        StringUtil::atoull(entry.name_.c_str(), key_hash, 16) &&
+        entry.name_ == entryPath(key_hash).substr(cache_path_.size() + 1)) {
+      absl::MutexLock lock(&index_mutex_);
+      index_.insert(key_hash);
+    }
+  }
+  io_thread_ = thread_factory.createThread([this]() -> void { ioThreadRoutine(); },
+                                           Thread::Options{"HttpCacheIo"});
+}
+
+FileSystemHttpCache::~FileSystemHttpCache() {
+  {
+    Thread::LockGuard lock(queue_lock_);
+    shutting_down_ = true;
+  }
+  queue_event_.notifyOne();
+  io_thread_->join();
+}
+
+void FileSystemHttpCache::ioThreadRoutine() {
+  while (true) {
+    std::function<void()> work;
+    {
+      Thread::LockGuard lock(queue_lock_);
+      while (queue_.empty() && !shutting_down_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        queue_event_.wait(queue_lock_);
+      }
+      if (shutting_down_) {
+        return;
+      }
+      work = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    work();
+  }
+}
+
+void FileSystemHttpCache::post(std::function<void()> work) {
+  {
+    Thread::LockGuard lock(queue_lock_);
+    queue_.push_back(std::move(work));
+  }
+  queue_event_.notifyOne();
+}
+
+bool FileSystemHttpCache::mayContain(uint64_t key_hash) {
+  absl::ReaderMutexLock lock(&index_mutex_);
+  return index_.contains(key_hash);
+}
+
+std::string FileSystemHttpCache::entryPath(uint64_t key_hash) const {
+  return fmt::format("{}/{:016x}", cache_path_, key_hash);
+}
+
+void FileSystemHttpCache::insert(const Key& key, const Http::ResponseHeaderMap& response_headers,
+                                 const ResponseMetadata& metadata, Buffer::Instance& body) {
+  const uint64_t key_hash = localHashKey(key);
+  auto prefix = std::make_shared<const std::string>(
+      encodeEntryPrefix(key.SerializeAsString(), response_headers, metadata, body.length()));
+  auto owned_body = std::make_shared<Buffer::OwnedImpl>();
+  owned_body->move(body);
+
+  post([this, key_hash, prefix, owned_body]() {
+    if (!writeEntryFile(entryPath(key_hash), *prefix, *owned_body)) {
+      ENVOY_LOG(debug, "failed to write cache entry {}", entryPath(key_hash));
+      return;
+    }
+    absl::MutexLock lock(&index_mutex_);
+    index_.insert(key_hash);
+  });
+}
+
+LookupContextPtr FileSystemHttpCache::makeLookupContext(LookupRequest&& request) {
+  return std::make_unique<FileLookupContext>(*this, std::move(request));
+}
+
+InsertContextPtr FileSystemHttpCache::makeInsertContext(LookupContextPtr&& lookup_context) {
+  ASSERT(lookup_context != nullptr);
+  return std::make_unique<FileInsertContext>(*lookup_context, *this);
+}
+
+void FileSystemHttpCache::updateHeaders(const LookupContext&, const Http::ResponseHeaderMap&,
+                                        const ResponseMetadata&) {
+  // TODO(toddmgreer): Support updating headers.
+}
+
+constexpr absl::string_view Name = "envoy.extensions.http.cache.file_system";
+
+CacheInfo FileSystemHttpCache::cacheInfo() const {
+  CacheInfo cache_info;
+  cache_info.name_ = Name;
+  return cache_info;
+}
+
+class FileSystemHttpCacheFactory : public HttpCacheFactory {
+public:
+  // From UntypedFactory
+  std::string name() const override { return std::string(Name); }
+  // From TypedFactory
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<
+        envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig>();
+  }
+  // From HttpCacheFactory
+  HttpCache& getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+                      Server::Configuration::FactoryContext& context) override {
+    envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig cache_config;
+    MessageUtil::unpackTo(config.typed_config(), cache_config);
+    if (!context.api().fileSystem().directoryExists(cache_config.cache_path())) {
+      throw EnvoyException(
+          fmt::format("cache_path '{}' is not an existing directory", cache_config.cache_path()));
+    }
+
+    // Filters configured with the same directory share a cache.
+    auto& cache = caches_[cache_config.cache_path()];
+    if (cache == nullptr) {
+      cache = std::make_unique<FileSystemHttpCache>(cache_config.cache_path(),
+                                                    context.api().threadFactory());
+    }
+    return *cache;
+  }
+
+private:
+  absl::flat_hash_map<std::string, std::unique_ptr<FileSystemHttpCache>> caches_;
+};
+
+static Registry::RegisterFactory<FileSystemHttpCacheFactory, HttpCacheFactory> register_;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+
+#include "extensions/filters/http/cache/http_cache.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Read-only memory mapping of a cache entry file. The mapping is released when the last reference
+ * to it is dropped, so body fragments served from it may outlive the lookup that created it.
+ */
+class MappedCacheFile {
+public:
+  /**
+   * @param path supplies the file to map.
+   * @return std::shared_ptr<const MappedCacheFile> the mapping, or nullptr if the file could not
+   *         be opened or mapped.
+   */
+  static std::shared_ptr<const MappedCacheFile> map(const std::string& path);
+
+  MappedCacheFile(const char* data, size_t size) : data_(data), size_(size) {}
+  ~MappedCacheFile();
+
+  absl::string_view contents() const { return {data_, size_}; }
+
+private:
+  const char* const data_;
+  const size_t size_;
+};
+
+using MappedCacheFileSharedPtr = std::shared_ptr<const MappedCacheFile>;
+
+/**
+ * Cache backend that stores each response in its own file under a directory. All file I/O is done
+ * on a dedicated thread so that workers never block on the disk: inserts are written to a
+ * temporary file which is then renamed into place, and lookups open and map the entry file there.
+ * Hits are served straight from the mapping without copying the body. An in-memory set of the key
+ * hashes of stored entries lets most misses be answered without touching the disk.
+ *
+ * Responses with a vary header are not cached.
+ */
+class FileSystemHttpCache : public HttpCache, Logger::Loggable<Logger::Id::cache_filter> {
+public:
+  /**
+   * @param cache_path supplies an existing directory to store entries in. Entries already in it
+   *        are indexed at construction.
+   * @param thread_factory supplies the factory used to create the I/O thread.
+   */
+  FileSystemHttpCache(const std::string& cache_path, Thread::ThreadFactory& thread_factory);
+  ~FileSystemHttpCache() override;
+
+  // HttpCache
+  LookupContextPtr makeLookupContext(LookupRequest&& request) override;
+  InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
+  void updateHeaders(const LookupContext& lookup_context,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const ResponseMetadata& metadata) override;
+  CacheInfo cacheInfo() const override;
+
+  /**
+   * Runs work on the I/O thread. Work still queued when the cache is destroyed is dropped.
+   */
+  void post(std::function<void()> work);
+
+  /**
+   * @return bool whether an entry may be stored for a key hash. Entries are only served after
+   *         checking that the key stored in the file matches.
+   */
+  bool mayContain(uint64_t key_hash);
+
+  /**
+   * Serializes a response and writes it to the entry file for key on the I/O thread.
+   */
+  void insert(const Key& key, const Http::ResponseHeaderMap& response_headers,
+              const ResponseMetadata& metadata, Buffer::Instance& body);
+
+  std::string entryPath(uint64_t key_hash) const;
+
+private:
+  void ioThreadRoutine();
+
+  const std::string cache_path_;
+
+  absl::Mutex index_mutex_;
+  absl::flat_hash_set<uint64_t> index_ ABSL_GUARDED_BY(index_mutex_);
+
+  Thread::MutexBasicLockable queue_lock_;
+  Thread::CondVar queue_event_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(queue_lock_);
+  bool shutting_down_ ABSL_GUARDED_BY(queue_lock_){false};
+  Thread::ThreadPtr io_thread_;
+};
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,35 @@
+#include "extensions/filters/http/cache/request_collapser.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+bool RequestCollapser::tryFill(const Key& key, Event::Dispatcher& dispatcher, WakeCallback wake) {
+  absl::MutexLock lock(&mutex_);
+  auto [it, inserted] = fills_.try_emplace(key);
+  if (!inserted) {
+    it->second.push_back({&dispatcher, std::move(wake)});
+  }
+  return inserted;
+}
+
+void RequestCollapser::release(const Key& key) {
+  std::vector<Waiter> waiters;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto it = fills_.find(key);
+    ASSERT(it != fills_.end(), "Releasing a fill that isn't in progress.");
+    waiters = std::move(it->second);
+    fills_.erase(it);
+  }
+  // Waiters may be on other workers, so they are always posted rather than run here.
+  for (Waiter& waiter : waiters) {
+    waiter.dispatcher_->post(std::move(waiter.wake_));
+  }
+}
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/protobuf/utility.h"
+
+#include "source/extensions/filters/http/cache/key.pb.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+
+/**
+ * Collapses concurrent cache misses for the same key, so that only the first request (the filler)
+ * goes upstream while the others wait for its response to be inserted and then repeat their
+ * lookup. One collapser is shared by the filters of all workers for a filter config, so it is
+ * thread-safe.
+ */
+class RequestCollapser {
+public:
+  using WakeCallback = std::function<void()>;
+
+  /**
+   * @param key supplies the key that missed the cache.
+   * @param dispatcher supplies the dispatcher to post wake to.
+   * @param wake supplies the callback run when the fill in progress for key finishes.
+   * @return bool true if no fill was in progress for key; the caller is then its filler and must
+   *         call release() once the response has been inserted or turned out not to be cacheable.
+   *         Otherwise wake will be posted to dispatcher once the fill finishes.
+   */
+  bool tryFill(const Key& key, Event::Dispatcher& dispatcher, WakeCallback wake);
+
+  /**
+   * Finishes the fill for key, waking the requests waiting for it.
+   */
+  void release(const Key& key);
+
+private:
+  struct Waiter {
+    Event::Dispatcher* dispatcher_;
+    WakeCallback wake_;
+  };
+
+  absl::Mutex mutex_;
+  // Waiters of each fill in progress.
+  absl::flat_hash_map<Key, std::vector<Waiter>, MessageUtil, MessageUtil>
+      fills_ ABSL_GUARDED_BY(mutex_);
+};
+
+using RequestCollapserSharedPtr = std::shared_ptr<RequestCollapser>;
+
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,7 @@
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include <algorithm>
+
 #include "envoy/registry/registry.h"
 
 #include "common/buffer/buffer_impl.h"
@@ -13,6 +15,23 @@ namespace HttpFilters {
 namespace Cache {
 namespace {
 
+// A buffer fragment referencing part of a cached body. It holds a reference to the body so that
+// the data stays valid even if the entry is replaced or evicted while the response is in flight.
+class CachedBodyFragment : public Buffer::BufferFragment {
+public:
+  CachedBodyFragment(std::shared_ptr<const std::string> body, const AdjustedByteRange& range)
+      : body_(std::move(body)), range_(range) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return body_->data() + range_.begin(); }
+  size_t size() const override { return range_.length(); }
+  void done() override { delete this; }
+
+private:
+  const std::shared_ptr<const std::string> body_;
+  const AdjustedByteRange range_;
+};
+
 class SimpleLookupContext : public LookupContext {
 public:
   SimpleLookupContext(SimpleHttpCache& cache, LookupRequest&& request)
@@ -22,13 +41,17 @@ public:
     auto entry = cache_.lookup(request_);
     body_ = std::move(entry.body_);
     cb(entry.response_headers_ ? request_.makeLookupResult(std::move(entry.response_headers_),
-                                                           std::move(entry.metadata_), body_.size())
+                                                           std::move(entry.metadata_),
+                                                           body_->size())
                                : LookupResult{});
   }
 
   void getBody(const AdjustedByteRange& range, LookupBodyCallback&& cb) override {
-    ASSERT(range.end() <= body_.length(), "Attempt to read past end of body.");
-    cb(std::make_unique<Buffer::OwnedImpl>(&body_[range.begin()], range.length()));
+    ASSERT(body_ != nullptr);
+    ASSERT(range.end() <= body_->length(), "Attempt to read past end of body.");
+    auto body = std::make_unique<Buffer::OwnedImpl>();
+    body->addBufferFragment(*new CachedBodyFragment(body_, range));
+    cb(std::move(body));
   }
 
   void getTrailers(LookupTrailersCallback&&) override {
@@ -42,7 +65,7 @@ public:
 private:
   SimpleHttpCache& cache_;
   const LookupRequest request_;
-  std::string body_;
+  std::shared_ptr<const std::string> body_;
 };
 
 class SimpleInsertContext : public InsertContext {
@@ -114,36 +137,100 @@ void SimpleHttpCache::updateHeaders(const LookupContext&, const Http::ResponseHe
   // NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
 }
 
-SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
+SimpleHttpCache::SimpleHttpCache(uint64_t max_bytes)
+    : max_bytes_per_shard_(max_bytes == 0 ? 0 : std::max<uint64_t>(1, max_bytes / NumShards)) {}
+
+SimpleHttpCache::Entry SimpleHttpCache::lookupKey(const Key& key) {
+  Shard& shard = shardFor(key);
+  if (max_bytes_per_shard_ == 0) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    auto iter = shard.map_.find(key);
+    if (iter == shard.map_.end()) {
+      return Entry{};
+    }
+    const Entry& entry = iter->second.entry_;
+    ASSERT(entry.response_headers_);
+    return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+                 entry.metadata_, entry.body_};
+  }
+
+  // Recording the use requires exclusive access to the shard's LRU list.
+  absl::WriterMutexLock lock(&shard.mutex_);
+  auto iter = shard.map_.find(key);
+  if (iter == shard.map_.end()) {
     return Entry{};
   }
-  ASSERT(iter->second.response_headers_);
+  shard.lru_.splice(shard.lru_.begin(), shard.lru_, iter->second.lru_position_);
+  const Entry& entry = iter->second.entry_;
+  ASSERT(entry.response_headers_);
+  return Entry{Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*entry.response_headers_),
+               entry.metadata_, entry.body_};
+}
+
+void SimpleHttpCache::insertKey(const Key& key, Entry&& entry) {
+  const uint64_t byte_size = entry.response_headers_->byteSize() + entry.body_->size();
+  if (max_bytes_per_shard_ != 0 && byte_size > max_bytes_per_shard_) {
+    // The entry could never fit; don't evict everything else trying to make room for it.
+    return;
+  }
+
+  Shard& shard = shardFor(key);
+  absl::WriterMutexLock lock(&shard.mutex_);
+  auto result = shard.map_.try_emplace(key);
+  ShardEntry& shard_entry = result.first->second;
+  if (!result.second) {
+    shard.byte_size_ -= shard_entry.byte_size_;
+    if (max_bytes_per_shard_ != 0) {
+      shard.lru_.erase(shard_entry.lru_position_);
+    }
+  }
+  shard_entry.entry_ = std::move(entry);
+  shard_entry.byte_size_ = byte_size;
+  shard.byte_size_ += byte_size;
+  if (max_bytes_per_shard_ != 0) {
+    shard_entry.lru_position_ = shard.lru_.insert(shard.lru_.begin(), &result.first->first);
+    evictIfNeeded(shard);
+  }
+}
+
+void SimpleHttpCache::evictIfNeeded(Shard& shard) {
+  while (shard.byte_size_ > max_bytes_per_shard_) {
+    // Entries larger than the budget are never inserted, so the newest entry always fits.
+    ASSERT(shard.lru_.size() > 1);
+    auto iter = shard.map_.find(*shard.lru_.back());
+    ASSERT(iter != shard.map_.end());
+    shard.byte_size_ -= iter->second.byte_size_;
+    shard.lru_.pop_back();
+    shard.map_.erase(iter);
+  }
+}
+
+uint64_t SimpleHttpCache::byteSize() {
+  uint64_t byte_size = 0;
+  for (Shard& shard : shards_) {
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    byte_size += shard.byte_size_;
+  }
+  return byte_size;
+}
 
-  if (VaryHeader::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
-  } else {
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_};
+SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
+  Entry entry = lookupKey(request.key());
+  if (entry.response_headers_ && VaryHeader::hasVary(*entry.response_headers_)) {
+    return varyLookup(request, entry.response_headers_);
   }
+  return entry;
 }
 
 void SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
                              ResponseMetadata&& metadata, std::string&& body) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] =
-      SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata), std::move(body)};
+  insertKey(key, Entry{std::move(response_headers), std::move(metadata),
+                       std::make_shared<const std::string>(std::move(body))});
 }
 
 SimpleHttpCache::Entry
 SimpleHttpCache::varyLookup(const LookupRequest& request,
                             const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
   const auto vary_header = response_headers->get(Http::CustomHeaders::get().Vary);
   ASSERT(!vary_header.empty());
 
@@ -151,47 +238,36 @@ SimpleHttpCache::varyLookup(const LookupRequest& request,
   const std::string vary_key = VaryHeader::createVaryKey(vary_header, request.getVaryHeaders());
   varied_request_key.add_custom_fields(vary_key);
 
-  auto iter = map_.find(varied_request_key);
-  if (iter == map_.end()) {
-    return SimpleHttpCache::Entry{};
-  }
-  ASSERT(iter->second.response_headers_);
-
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_};
+  return lookupKey(varied_request_key);
 }
 
 void SimpleHttpCache::varyInsert(const Key& request_key,
                                  Http::ResponseHeaderMapPtr&& response_headers,
                                  ResponseMetadata&& metadata, std::string&& body,
                                  const Http::RequestHeaderMap& request_vary_headers) {
-  absl::WriterMutexLock lock(&mutex_);
-
   const auto vary_header = response_headers->get(Http::CustomHeaders::get().Vary);
   ASSERT(!vary_header.empty());
+  // TODO(mattklein123): Support multiple vary headers and/or just make the vary header inline.
+  const std::string vary_value(vary_header[0]->value().getStringView());
 
   // Insert the varied response.
   Key varied_request_key = request_key;
   const std::string vary_key = VaryHeader::createVaryKey(vary_header, request_vary_headers);
   varied_request_key.add_custom_fields(vary_key);
-  map_[varied_request_key] =
-      SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata), std::move(body)};
+  insert(varied_request_key, std::move(response_headers), std::move(metadata), std::move(body));
 
-  // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
+  // Add a special entry to flag that this request generates varied responses. The varied entry
+  // and this one may live in different shards, so lookups tolerate either being missing.
+  if (lookupKey(request_key).response_headers_ == nullptr) {
     Http::ResponseHeaderMapPtr vary_only_map =
         Http::createHeaderMap<Http::ResponseHeaderMapImpl>({});
-    // TODO(mattklein123): Support multiple vary headers and/or just make the vary header inline.
-    vary_only_map->setCopy(Http::CustomHeaders::get().Vary,
-                           vary_header[0]->value().getStringView());
+    vary_only_map->setCopy(Http::CustomHeaders::get().Vary, vary_value);
     // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
     // we have inserted as the body for this first lookup. This way, we would know which keys we
     // have inserted for that resource. For the first entry simply use vary_key as the entry_list,
     // for future entries append vary_key to existing list.
     std::string entry_list;
-    map_[request_key] = SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list)};
+    insert(request_key, std::move(vary_only_map), {}, std::move(entry_list));
   }
 }
 
@@ -219,12 +295,23 @@ public:
   }
   // From HttpCacheFactory
   HttpCache&
-  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig&) override {
-    return cache_;
+  getCache(const envoy::extensions::filters::http::cache::v3alpha::CacheConfig& config,
+           Server::Configuration::FactoryContext&) override {
+    envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig cache_config;
+    MessageUtil::unpackTo(config.typed_config(), cache_config);
+
+    // Filters configured with the same budget share a cache.
+    absl::MutexLock lock(&mutex_);
+    auto& cache = caches_[cache_config.max_cache_bytes()];
+    if (cache == nullptr) {
+      cache = std::make_unique<SimpleHttpCache>(cache_config.max_cache_bytes());
+    }
+    return *cache;
   }
 
 private:
-  SimpleHttpCache cache_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<uint64_t, std::unique_ptr<SimpleHttpCache>> caches_ ABSL_GUARDED_BY(mutex_);
 };
 
 static Registry::RegisterFactory<SimpleHttpCacheFactory, HttpCacheFactory> register_;
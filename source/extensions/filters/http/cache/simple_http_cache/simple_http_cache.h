@@ -1,11 +1,15 @@
 #pragma once
 
+#include <array>
+#include <list>
+
 #include "common/protobuf/utility.h"
 
 #include "extensions/filters/http/cache/http_cache.h"
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
@@ -13,20 +17,56 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
+// Example in-memory cache backend. Entries are spread over independently locked shards so that
+// lookups from different workers rarely contend, and bodies are reference counted so that hits
+// are served without copying them. If constructed with a byte budget, each shard evicts its least
+// recently used entries to stay within its share of the budget; otherwise it never evicts.
 class SimpleHttpCache : public HttpCache {
 private:
+  using BodySharedPtr = std::shared_ptr<const std::string>;
+
   struct Entry {
     Http::ResponseHeaderMapPtr response_headers_;
     ResponseMetadata metadata_;
-    std::string body_;
+    BodySharedPtr body_;
+  };
+
+  struct ShardEntry {
+    Entry entry_;
+    uint64_t byte_size_;
+    // Position of this entry's key in Shard::lru_. Only valid if the cache has a byte budget.
+    std::list<const Key*>::iterator lru_position_;
+  };
+
+  struct Shard {
+    absl::Mutex mutex_;
+    // node_hash_map provides the key pointer stability needed by lru_.
+    absl::node_hash_map<Key, ShardEntry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+    // Keys of map_, most recently used first. Only maintained if the cache has a byte budget.
+    std::list<const Key*> lru_ ABSL_GUARDED_BY(mutex_);
+    uint64_t byte_size_ ABSL_GUARDED_BY(mutex_){0};
   };
 
+  Shard& shardFor(const Key& key) { return shards_[localHashKey(key) % shards_.size()]; }
+
+  // Returns a copy of the entry stored under key, or an empty entry if there is none.
+  Entry lookupKey(const Key& key);
+  void insertKey(const Key& key, Entry&& entry);
+  void evictIfNeeded(Shard& shard) ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex_);
+
   // Looks for a response that has been varied. Only called from lookup.
   Entry varyLookup(const LookupRequest& request,
                    const Http::ResponseHeaderMapPtr& response_headers);
 
 public:
+  static constexpr size_t NumShards = 16;
+
+  /**
+   * @param max_bytes supplies the total size of headers and bodies the cache may hold before it
+   *        starts evicting entries. 0 means the cache is unbounded.
+   */
+  explicit SimpleHttpCache(uint64_t max_bytes = 0);
+
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request) override;
   InsertContextPtr makeInsertContext(LookupContextPtr&& lookup_context) override;
@@ -44,8 +84,13 @@ public:
                   ResponseMetadata&& metadata, std::string&& body,
                   const Http::RequestHeaderMap& request_vary_headers);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  // Total size of the entries currently held by the cache.
+  uint64_t byteSize();
+
+private:
+  // Per-shard share of the byte budget, or 0 if the cache is unbounded.
+  const uint64_t max_bytes_per_shard_;
+  std::array<Shard, NumShards> shards_;
 };
 
 } // namespace Cache
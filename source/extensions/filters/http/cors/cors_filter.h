@@ -48,6 +48,7 @@ public:
 
   // Http::StreamFilterBase
   void onDestroy() override {}
+  bool needsTunnelData() const override { return false; }
 
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers,
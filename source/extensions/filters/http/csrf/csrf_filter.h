@@ -94,6 +94,7 @@ public:
 
   // Http::StreamFilterBase
   void onDestroy() override {}
+  bool needsTunnelData() const override { return false; }
 
   // Http::StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers,
@@ -1,5 +1,7 @@
 #include "extensions/filters/http/decompressor/decompressor_filter.h"
 
+#include "envoy/http/codes.h"
+
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
 #include "common/common/macros.h"
@@ -9,6 +11,16 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Decompressor {
 
+namespace {
+
+struct RcDetailsValues {
+  // The request exceeded the maximum decompression ratio.
+  const std::string RatioLimitExceeded = "decompressor.ratio_limit_exceeded";
+};
+using RcDetails = ConstSingleton<RcDetailsValues>;
+
+} // namespace
+
 Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::RequestHeaders>
     accept_encoding_handle(Http::CustomHeaders::get().AcceptEncoding);
 Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::RequestHeaders>
@@ -42,7 +54,9 @@ DecompressorFilterConfig::DirectionConfig::DirectionConfig(
         proto_config,
     const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
     : stats_(generateStats(stats_prefix, scope)),
-      decompression_enabled_(proto_config.enabled(), runtime) {}
+      decompression_enabled_(proto_config.enabled(), runtime),
+      max_decompression_ratio_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, max_decompression_ratio, 0)) {}
 
 DecompressorFilterConfig::RequestDirectionConfig::RequestDirectionConfig(
     const envoy::extensions::filters::http::decompressor::v3::Decompressor::RequestDirectionConfig&
@@ -94,8 +108,12 @@ Http::FilterDataStatus DecompressorFilter::decodeData(Buffer::Instance& data, bo
     if (end_stream) {
       trailers = HeaderMapOptRef(std::ref(decoder_callbacks_->addDecodedTrailers()));
     }
-    decompress(config_->requestDirectionConfig(), request_decompressor_, *decoder_callbacks_, data,
-               request_byte_tracker_, trailers);
+    if (!decompress(config_->requestDirectionConfig(), request_decompressor_, *decoder_callbacks_,
+                    data, request_byte_tracker_, trailers)) {
+      decoder_callbacks_->sendLocalReply(Http::Code::PayloadTooLarge, "", nullptr, absl::nullopt,
+                                         RcDetails::get().RatioLimitExceeded);
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
   }
   return Http::FilterDataStatus::Continue;
 }
@@ -126,8 +144,12 @@ Http::FilterDataStatus DecompressorFilter::encodeData(Buffer::Instance& data, bo
     if (end_stream) {
       trailers = HeaderMapOptRef(std::ref(encoder_callbacks_->addEncodedTrailers()));
     }
-    decompress(config_->responseDirectionConfig(), response_decompressor_, *encoder_callbacks_,
-               data, response_byte_tracker_, trailers);
+    if (!decompress(config_->responseDirectionConfig(), response_decompressor_,
+                    *encoder_callbacks_, data, response_byte_tracker_, trailers)) {
+      // The response headers may already be sent downstream, so the stream can only be reset.
+      encoder_callbacks_->resetStream();
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
   }
   return Http::FilterDataStatus::Continue;
 }
@@ -140,7 +162,7 @@ Http::FilterTrailersStatus DecompressorFilter::encodeTrailers(Http::ResponseTrai
   return Http::FilterTrailersStatus::Continue;
 }
 
-void DecompressorFilter::decompress(
+bool DecompressorFilter::decompress(
     const DecompressorFilterConfig::DirectionConfig& direction_config,
     const Compression::Decompressor::DecompressorPtr& decompressor,
     Http::StreamFilterCallbacks& callbacks, Buffer::Instance& input_buffer,
@@ -157,11 +179,19 @@ void DecompressorFilter::decompress(
                    direction_config.logString(), input_buffer.length(), output_buffer.length());
 
   input_buffer.drain(input_buffer.length());
-  input_buffer.add(output_buffer);
+  if (byte_tracker.exceedsRatio(direction_config.maxDecompressionRatio())) {
+    direction_config.stats().ratio_limit_exceeded_.inc();
+    ENVOY_STREAM_LOG(debug, "{} data exceeded the maximum decompression ratio of {}", callbacks,
+                     direction_config.logString(), direction_config.maxDecompressionRatio());
+    return false;
+  }
+  // Move the decompressed slices rather than copying them.
+  input_buffer.move(output_buffer);
 
   if (trailers.has_value()) {
     byte_tracker.reportTotalBytes(trailers.value().get());
   }
+  return true;
 }
 
 template <>
@@ -22,6 +22,7 @@ namespace Decompressor {
 #define ALL_DECOMPRESSOR_STATS(COUNTER)                                                            \
   COUNTER(decompressed)                                                                            \
   COUNTER(not_decompressed)                                                                        \
+  COUNTER(ratio_limit_exceeded)                                                                    \
   COUNTER(total_uncompressed_bytes)                                                                \
   COUNTER(total_compressed_bytes)
 
@@ -48,6 +49,9 @@ public:
     virtual const std::string& logString() const PURE;
     const DecompressorStats& stats() const { return stats_; }
     bool decompressionEnabled() const { return decompression_enabled_.enabled(); }
+    // The maximum ratio of the decompressed bytes to the compressed bytes of a stream, or 0 if
+    // the decompressed bytes are not limited.
+    uint32_t maxDecompressionRatio() const { return max_decompression_ratio_; }
 
   private:
     static DecompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
@@ -56,6 +60,7 @@ public:
 
     const DecompressorStats stats_;
     const Runtime::FeatureFlag decompression_enabled_;
+    const uint32_t max_decompression_ratio_;
   };
 
   class RequestDirectionConfig : public DirectionConfig {
@@ -148,6 +153,9 @@ private:
       total_compressed_bytes_ += compressed_bytes;
       total_uncompressed_bytes_ += uncompressed_bytes;
     }
+    bool exceedsRatio(uint32_t max_ratio) const {
+      return max_ratio != 0 && total_uncompressed_bytes_ > total_compressed_bytes_ * max_ratio;
+    }
     void reportTotalBytes(Http::HeaderMap& trailers) const {
       trailers.addReferenceKey(compressed_bytes_trailer_, total_compressed_bytes_);
       trailers.addReferenceKey(uncompressed_bytes_trailer_, total_uncompressed_bytes_);
@@ -187,7 +195,9 @@ private:
   }
 
   using HeaderMapOptRef = absl::optional<std::reference_wrapper<Http::HeaderMap>>;
-  void decompress(const DecompressorFilterConfig::DirectionConfig& direction_config,
+  // Returns false if the stream exceeded the maximum decompression ratio of the direction, in
+  // which case nothing is written to the input buffer.
+  bool decompress(const DecompressorFilterConfig::DirectionConfig& direction_config,
                   const Compression::Decompressor::DecompressorPtr& decompressor,
                   Http::StreamFilterCallbacks& callbacks, Buffer::Instance& input_buffer,
                   ByteTracker& byte_tracker, HeaderMapOptRef trailers) const;
@@ -0,0 +1,111 @@
+#include "extensions/filters/http/ext_authz/decision_cache.h"
+
+#include <algorithm>
+
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+namespace {
+
+std::vector<Http::LowerCaseString>
+toLowerCaseStrings(const Protobuf::RepeatedPtrField<std::string>& names) {
+  std::vector<Http::LowerCaseString> lower_case_strings;
+  lower_case_strings.reserve(names.size());
+  for (const std::string& name : names) {
+    lower_case_strings.emplace_back(name);
+  }
+  return lower_case_strings;
+}
+
+} // namespace
+
+DecisionCache::DecisionCache(
+    const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+    ThreadLocal::SlotAllocator& tls, TimeSource& time_source)
+    : key_headers_(toLowerCaseStrings(config.key_headers())),
+      ttl_metadata_key_(config.ttl_metadata_key()),
+      default_ttl_(config.has_default_ttl()
+                       ? absl::optional<std::chrono::milliseconds>(
+                             DurationUtil::durationToMilliseconds(config.default_ttl()))
+                       : absl::nullopt),
+      cache_denied_(config.cache_denied()),
+      max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, DefaultMaxEntries)),
+      time_source_(time_source), tls_(tls) {
+  tls_.set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalCache>(); });
+}
+
+std::string DecisionCache::key(const Http::RequestHeaderMap& headers) const {
+  // The values are prefixed by their length and every header by its number of values, so that no
+  // two different requests have the same key.
+  std::string key;
+  for (const Http::LowerCaseString& name : key_headers_) {
+    const auto values = headers.get(name);
+    absl::StrAppend(&key, values.size(), ";");
+    for (size_t i = 0; i < values.size(); ++i) {
+      const absl::string_view value = values[i]->value().getStringView();
+      absl::StrAppend(&key, value.size(), ":", value);
+    }
+  }
+  return key;
+}
+
+Filters::Common::ExtAuthz::ResponsePtr DecisionCache::lookup(const std::string& key) {
+  auto& entries = tls_->entries_;
+  auto it = entries.find(key);
+  if (it == entries.end()) {
+    return nullptr;
+  }
+  if (it->second.expiry_ <= time_source_.monotonicTime()) {
+    entries.erase(it);
+    return nullptr;
+  }
+  return std::make_unique<Filters::Common::ExtAuthz::Response>(it->second.response_);
+}
+
+void DecisionCache::insert(const std::string& key,
+                           const Filters::Common::ExtAuthz::Response& response) {
+  using Filters::Common::ExtAuthz::CheckStatus;
+  if (response.status != CheckStatus::OK &&
+      (response.status != CheckStatus::Denied || !cache_denied_)) {
+    return;
+  }
+  const absl::optional<std::chrono::milliseconds> ttl = this->ttl(response);
+  if (!ttl.has_value() || ttl.value().count() <= 0) {
+    return;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  auto& entries = tls_->entries_;
+  if (entries.size() >= max_entries_ && !entries.contains(key)) {
+    // Make room by dropping the expired decisions first, and any decision if none expired.
+    absl::erase_if(entries, [now](const auto& entry) { return entry.second.expiry_ <= now; });
+    if (entries.size() >= max_entries_) {
+      entries.erase(entries.begin());
+    }
+  }
+  entries.insert_or_assign(key, Entry{response, now + ttl.value()});
+}
+
+absl::optional<std::chrono::milliseconds>
+DecisionCache::ttl(const Filters::Common::ExtAuthz::Response& response) const {
+  if (!ttl_metadata_key_.empty()) {
+    const auto& fields = response.dynamic_metadata.fields();
+    const auto it = fields.find(ttl_metadata_key_);
+    if (it != fields.end() && it->second.kind_case() == ProtobufWkt::Value::kNumberValue) {
+      // Bounded so that the conversion can't overflow.
+      const double seconds = std::max(0.0, std::min(it->second.number_value(), 1e9));
+      return std::chrono::milliseconds(static_cast<int64_t>(seconds * 1000));
+    }
+  }
+  return default_ttl_;
+}
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
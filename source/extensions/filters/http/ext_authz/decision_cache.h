@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ext_authz/v3/ext_authz.pb.h"
+#include "envoy/http/header_map.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "extensions/filters/common/ext_authz/ext_authz.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace ExtAuthz {
+
+/**
+ * The decisions of the authorization server cached on each worker, by the values of the key
+ * headers of the requests they were made for.
+ */
+class DecisionCache {
+public:
+  DecisionCache(const envoy::extensions::filters::http::ext_authz::v3::DecisionCache& config,
+                ThreadLocal::SlotAllocator& tls, TimeSource& time_source);
+
+  /**
+   * @param headers supplies the headers of a request.
+   * @return the cache key of the request.
+   */
+  std::string key(const Http::RequestHeaderMap& headers) const;
+
+  /**
+   * @param key supplies the cache key of a request.
+   * @return a copy of the response cached on this worker for the key, or nullptr if there is none
+   *         or it expired.
+   */
+  Filters::Common::ExtAuthz::ResponsePtr lookup(const std::string& key);
+
+  /**
+   * Caches the response of the authorization server on this worker, unless its status or its TTL
+   * don't allow it.
+   * @param key supplies the cache key of the request.
+   * @param response supplies the response of the authorization server.
+   */
+  void insert(const std::string& key, const Filters::Common::ExtAuthz::Response& response);
+
+  // The number of decisions cached by each worker when max_entries isn't set.
+  static constexpr uint32_t DefaultMaxEntries = 10000;
+
+private:
+  struct Entry {
+    Filters::Common::ExtAuthz::Response response_;
+    MonotonicTime expiry_;
+  };
+
+  struct ThreadLocalCache : public ThreadLocal::ThreadLocalObject {
+    absl::flat_hash_map<std::string, Entry> entries_;
+  };
+
+  absl::optional<std::chrono::milliseconds>
+  ttl(const Filters::Common::ExtAuthz::Response& response) const;
+
+  const std::vector<Http::LowerCaseString> key_headers_;
+  const std::string ttl_metadata_key_;
+  const absl::optional<std::chrono::milliseconds> default_ttl_;
+  const bool cache_denied_;
+  const uint32_t max_entries_;
+  TimeSource& time_source_;
+  ThreadLocal::TypedSlot<ThreadLocalCache> tls_;
+};
+
+using DecisionCachePtr = std::unique_ptr<DecisionCache>;
+
+} // namespace ExtAuthz
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -39,6 +39,26 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers,
     return;
   }
 
+  DecisionCache* decision_cache = config_->decisionCache();
+  if (decision_cache != nullptr) {
+    std::string key = decision_cache->key(headers);
+    Filters::Common::ExtAuthz::ResponsePtr response = decision_cache->lookup(key);
+    if (response != nullptr) {
+      ENVOY_STREAM_LOG(trace, "ext_authz filter found the decision in the cache",
+                       *decoder_callbacks_);
+      stats_.decision_cache_hit_.inc();
+      state_ = State::Calling;
+      filter_return_ = FilterReturn::StopDecoding;
+      cluster_ = decoder_callbacks_->clusterInfo();
+      initiating_call_ = true;
+      onComplete(std::move(response));
+      initiating_call_ = false;
+      return;
+    }
+    stats_.decision_cache_miss_.inc();
+    cache_key_ = std::move(key);
+  }
+
   auto&& maybe_merged_per_route_config =
       Http::Utility::getMergedPerFilterConfig<FilterConfigPerRoute>(
           HttpFilterNames::get().ExtAuthorization, route,
@@ -208,9 +228,14 @@ void Filter::onComplete(Filters::Common::ExtAuthz::ResponsePtr&& response) {
   using Filters::Common::ExtAuthz::CheckStatus;
   Stats::StatName empty_stat_name;
 
+  if (cache_key_.has_value()) {
+    config_->decisionCache()->insert(cache_key_.value(), *response);
+    cache_key_.reset();
+  }
+
   if (!response->dynamic_metadata.fields().empty()) {
     decoder_callbacks_->streamInfo().setDynamicMetadata(HttpFilterNames::get().ExtAuthorization,
-                                                        response->dynamic_metadata);
+                                                        std::move(response->dynamic_metadata));
   }
 
   switch (response->status) {
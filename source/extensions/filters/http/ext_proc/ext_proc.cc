@@ -100,6 +100,13 @@ FilterHeadersStatus Filter::decodeHeaders(RequestHeaderMap& headers, bool end_st
 
 Http::FilterDataStatus Filter::onData(ProcessorState& state, ProcessingMode::BodySendMode body_mode,
                                       Buffer::Instance& data, bool end_stream) {
+  if (body_mode != ProcessingMode::STREAMED && state.hasStreamedData()) {
+    // The processor stopped the streaming, the rest of the body follows the chunks it was sent.
+    state.pendingStreamedData().move(data);
+    flushStreamedData(state, body_mode, end_stream);
+    return FilterDataStatus::StopIterationNoBuffer;
+  }
+
   switch (body_mode) {
   case ProcessingMode::BUFFERED:
     if (end_stream) {
@@ -124,8 +131,9 @@ Http::FilterDataStatus Filter::onData(ProcessorState& state, ProcessingMode::Bod
       ENVOY_LOG(trace, "onData: Buffering");
     }
     return FilterDataStatus::StopIterationAndBuffer;
-  case ProcessingMode::BUFFERED_PARTIAL:
   case ProcessingMode::STREAMED:
+    return onStreamedData(state, data, end_stream);
+  case ProcessingMode::BUFFERED_PARTIAL:
     ENVOY_LOG(debug, "Ignoring unimplemented request body processing mode");
     return FilterDataStatus::Continue;
   case ProcessingMode::NONE:
@@ -134,6 +142,70 @@ Http::FilterDataStatus Filter::onData(ProcessorState& state, ProcessingMode::Bod
   }
 }
 
+FilterDataStatus Filter::onStreamedData(ProcessorState& state, Buffer::Instance& data,
+                                        bool end_stream) {
+  switch (openStream()) {
+  case StreamOpenState::Error:
+    return FilterDataStatus::StopIterationNoBuffer;
+  case StreamOpenState::IgnoreError:
+    return FilterDataStatus::Continue;
+  case StreamOpenState::Ok:
+    // Fall through
+    break;
+  }
+
+  // The data is held until the processor answers the chunk it is sent in, and is then injected
+  // back in the filter chain, while the next data keeps being sent.
+  state.pendingStreamedData().move(data);
+  if (end_stream || state.pendingStreamedData().length() >= config_->minStreamedChunkSize()) {
+    flushStreamedData(state, ProcessingMode::STREAMED, end_stream);
+  } else {
+    ENVOY_LOG(trace, "onStreamedData: coalescing {} bytes", state.pendingStreamedData().length());
+    state.setCallbackState(ProcessorState::CallbackState::StreamedBody);
+    state.startFlushTimer([this, &state]() { onStreamedChunkDelay(state); },
+                          config_->maxStreamedChunkDelay());
+  }
+  return FilterDataStatus::StopIterationNoBuffer;
+}
+
+void Filter::flushStreamedData(ProcessorState& state, ProcessingMode::BodySendMode body_mode,
+                               bool end_stream) {
+  if (body_mode != ProcessingMode::STREAMED) {
+    state.queuePendingChunk(end_stream, false);
+    return;
+  }
+  if (!state.hasSentChunks()) {
+    state.startMessageTimer(std::bind(&Filter::onMessageTimeout, this), config_->messageTimeout());
+  }
+  sendBodyChunk(state, state.pendingStreamedData(), end_stream);
+  state.queuePendingChunk(end_stream, true);
+}
+
+void Filter::onStreamedChunkDelay(ProcessorState& state) {
+  if (processing_complete_ || state.pendingStreamedData().length() == 0) {
+    return;
+  }
+  const auto body_mode = &state == &decoding_state_ ? processing_mode_.request_body_mode()
+                                                    : processing_mode_.response_body_mode();
+  flushStreamedData(state, body_mode, false);
+}
+
+Http::FilterTrailersStatus Filter::onTrailers(ProcessorState& state,
+                                              ProcessingMode::BodySendMode body_mode) {
+  if (processing_complete_ || !state.hasStreamedData()) {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  // The trailers wait for the rest of the streamed body.
+  if (state.pendingStreamedData().length() > 0) {
+    flushStreamedData(state, body_mode, false);
+  }
+  if (!state.hasStreamedData()) {
+    return Http::FilterTrailersStatus::Continue;
+  }
+  state.setTrailersStopped();
+  return Http::FilterTrailersStatus::StopIteration;
+}
+
 FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_stream) {
   ENVOY_LOG(trace, "decodeData({}): end_stream = {}", data.length(), end_stream);
   if (processing_complete_) {
@@ -147,6 +219,10 @@ FilterDataStatus Filter::decodeData(Buffer::Instance& data, bool end_stream) {
   return status;
 }
 
+Http::FilterTrailersStatus Filter::decodeTrailers(Http::RequestTrailerMap&) {
+  return onTrailers(decoding_state_, processing_mode_.request_body_mode());
+}
+
 FilterHeadersStatus Filter::encodeHeaders(ResponseHeaderMap& headers, bool end_stream) {
   ENVOY_LOG(trace, "encodeHeaders end_stream = {}", end_stream);
 
@@ -173,6 +249,10 @@ FilterDataStatus Filter::encodeData(Buffer::Instance& data, bool end_stream) {
   return status;
 }
 
+Http::FilterTrailersStatus Filter::encodeTrailers(Http::ResponseTrailerMap&) {
+  return onTrailers(encoding_state_, processing_mode_.response_body_mode());
+}
+
 void Filter::sendBodyChunk(const ProcessorState& state, const Buffer::Instance& data,
                            bool end_stream) {
   ENVOY_LOG(debug, "Sending a body chunk of {} bytes", data.length());
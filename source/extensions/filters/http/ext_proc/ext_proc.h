@@ -13,6 +13,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
+#include "common/protobuf/utility.h"
 
 #include "extensions/filters/http/common/pass_through_filter.h"
 #include "extensions/filters/http/ext_proc/client.h"
@@ -43,6 +44,10 @@ public:
                const std::chrono::milliseconds message_timeout, Stats::Scope& scope,
                const std::string& stats_prefix)
       : failure_mode_allow_(config.failure_mode_allow()), message_timeout_(message_timeout),
+        min_streamed_chunk_size_(config.streamed_body_options().min_chunk_size()),
+        max_streamed_chunk_delay_(PROTOBUF_GET_MS_OR_DEFAULT(config.streamed_body_options(),
+                                                             max_chunk_delay,
+                                                             DefaultMaxStreamedChunkDelayMs)),
         stats_(generateStats(stats_prefix, config.stat_prefix(), scope)),
         processing_mode_(config.processing_mode()) {}
 
@@ -50,6 +55,14 @@ public:
 
   const std::chrono::milliseconds& messageTimeout() const { return message_timeout_; }
 
+  // The streamed body data is coalesced into chunks of at least this many bytes.
+  uint32_t minStreamedChunkSize() const { return min_streamed_chunk_size_; }
+
+  // The maximum time the streamed body data is held to be coalesced.
+  const std::chrono::milliseconds& maxStreamedChunkDelay() const {
+    return max_streamed_chunk_delay_;
+  }
+
   const ExtProcFilterStats& stats() const { return stats_; }
 
   const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode&
@@ -64,8 +77,12 @@ private:
     return {ALL_EXT_PROC_FILTER_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
   }
 
+  static constexpr uint64_t DefaultMaxStreamedChunkDelayMs = 10;
+
   const bool failure_mode_allow_;
   const std::chrono::milliseconds message_timeout_;
+  const uint32_t min_streamed_chunk_size_;
+  const std::chrono::milliseconds max_streamed_chunk_delay_;
 
   ExtProcFilterStats stats_;
   const envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode processing_mode_;
@@ -100,10 +117,12 @@ public:
   Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers,
                                           bool end_stream) override;
   Http::FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus decodeTrailers(Http::RequestTrailerMap& trailers) override;
 
   Http::FilterHeadersStatus encodeHeaders(Http::ResponseHeaderMap& headers,
                                           bool end_stream) override;
   Http::FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override;
+  Http::FilterTrailersStatus encodeTrailers(Http::ResponseTrailerMap& trailers) override;
 
   // ExternalProcessorCallbacks
 
@@ -128,6 +147,17 @@ private:
       envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode::BodySendMode body_mode,
       Buffer::Instance& data, bool end_stream);
 
+  Http::FilterDataStatus onStreamedData(ProcessorState& state, Buffer::Instance& data,
+                                        bool end_stream);
+  Http::FilterTrailersStatus onTrailers(
+      ProcessorState& state,
+      envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode::BodySendMode body_mode);
+  void flushStreamedData(
+      ProcessorState& state,
+      envoy::extensions::filters::http::ext_proc::v3alpha::ProcessingMode::BodySendMode body_mode,
+      bool end_stream);
+  void onStreamedChunkDelay(ProcessorState& state);
+
   void sendBodyChunk(const ProcessorState& state, const Buffer::Instance& data, bool end_stream);
 
   const FilterConfigSharedPtr config_;
@@ -14,9 +14,40 @@ void ProcessorState::startMessageTimer(Event::TimerCb cb, std::chrono::milliseco
   if (!message_timer_) {
     message_timer_ = filter_callbacks_->dispatcher().createTimer(cb);
   }
+  message_timeout_ = timeout;
   message_timer_->enableTimer(timeout);
 }
 
+void ProcessorState::startFlushTimer(Event::TimerCb cb, std::chrono::milliseconds delay) {
+  if (!flush_timer_) {
+    flush_timer_ = filter_callbacks_->dispatcher().createTimer(cb);
+  }
+  if (!flush_timer_->enabled()) {
+    flush_timer_->enableTimer(delay);
+  }
+}
+
+void ProcessorState::queuePendingChunk(bool end_stream, bool sent) {
+  if (flush_timer_) {
+    flush_timer_->disableTimer();
+  }
+  auto chunk = std::make_unique<QueuedChunk>();
+  chunk->data_.move(pending_streamed_data_);
+  chunk->end_stream_ = end_stream;
+  chunk->sent_ = sent;
+  queued_bytes_ += chunk->data_.length();
+  chunk_queue_.push_back(std::move(chunk));
+  callback_state_ = CallbackState::StreamedBody;
+
+  const uint32_t limit = bufferLimit();
+  if (!watermark_requested_ && limit > 0 && queued_bytes_ > limit) {
+    ENVOY_LOG(debug, "Too much streamed body data waiting for the processor");
+    watermark_requested_ = true;
+    requestWatermark();
+  }
+  releaseUnsentChunks();
+}
+
 bool ProcessorState::handleHeadersResponse(const HeadersResponse& response) {
   if (callback_state_ == CallbackState::Headers) {
     ENVOY_LOG(debug, "applying headers response");
@@ -41,11 +72,71 @@ bool ProcessorState::handleBodyResponse(const BodyResponse& response) {
     continueProcessing();
     return true;
   }
+  if (callback_state_ == CallbackState::StreamedBody && hasSentChunks()) {
+    ENVOY_LOG(debug, "Applying body response to a streamed chunk");
+    QueuedChunkPtr chunk = std::move(chunk_queue_.front());
+    chunk_queue_.pop_front();
+    queued_bytes_ -= chunk->data_.length();
+    if (hasSentChunks()) {
+      message_timer_->enableTimer(message_timeout_);
+    } else {
+      message_timer_->disableTimer();
+    }
+    MutationUtils::applyCommonBodyResponse(response, chunk->data_);
+    releaseChunk(*chunk);
+    releaseUnsentChunks();
+    return true;
+  }
   return false;
 }
 
+void ProcessorState::releaseUnsentChunks() {
+  while (!chunk_queue_.empty() && !chunk_queue_.front()->sent_) {
+    QueuedChunkPtr chunk = std::move(chunk_queue_.front());
+    chunk_queue_.pop_front();
+    queued_bytes_ -= chunk->data_.length();
+    releaseChunk(*chunk);
+  }
+  onStreamedDataReleased();
+}
+
+void ProcessorState::releaseChunk(QueuedChunk& chunk) {
+  ENVOY_LOG(trace, "Releasing a streamed chunk of {} bytes", chunk.data_.length());
+  injectDataToFilterChain(chunk.data_, chunk.end_stream_);
+}
+
+void ProcessorState::releaseStreamedData() {
+  for (auto& chunk : chunk_queue_) {
+    chunk->sent_ = false;
+  }
+  if (pending_streamed_data_.length() > 0) {
+    queuePendingChunk(false, false);
+  } else {
+    releaseUnsentChunks();
+  }
+}
+
+void ProcessorState::onStreamedDataReleased() {
+  if (watermark_requested_ && queued_bytes_ <= bufferLimit() / 2) {
+    watermark_requested_ = false;
+    clearWatermark();
+  }
+  if (callback_state_ == CallbackState::StreamedBody && !hasStreamedData()) {
+    callback_state_ = CallbackState::Idle;
+    if (trailers_stopped_) {
+      trailers_stopped_ = false;
+      continueProcessing();
+    }
+  }
+}
+
 void ProcessorState::clearAsyncState() {
   cleanUpTimer();
+  if (callback_state_ == CallbackState::StreamedBody) {
+    // The streamed body is released as is.
+    releaseStreamedData();
+    return;
+  }
   if (callback_state_ != CallbackState::Idle) {
     callback_state_ = CallbackState::Idle;
     continueProcessing();
@@ -56,6 +147,9 @@ void ProcessorState::cleanUpTimer() const {
   if (message_timer_ && message_timer_->enabled()) {
     message_timer_->disableTimer();
   }
+  if (flush_timer_ && flush_timer_->enabled()) {
+    flush_timer_->disableTimer();
+  }
 }
 
 } // namespace ExternalProcessing
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "envoy/buffer/buffer.h"
 #include "envoy/event/timer.h"
 #include "envoy/http/filter.h"
 #include "envoy/http/header_map.h"
 #include "envoy/service/ext_proc/v3alpha/external_processor.pb.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/logger.h"
 
 namespace Envoy {
@@ -21,7 +25,20 @@ public:
     Headers,
     // Waiting for a "body" response
     BufferedBody,
+    // Streaming the body: some of it is held until the processor answers the chunks it was sent,
+    // or until enough of it was received to send a chunk.
+    StreamedBody,
+  };
+
+  // A chunk of a streamed body.
+  struct QueuedChunk {
+    Buffer::OwnedImpl data_;
+    bool end_stream_{};
+    // Whether the chunk was sent to the processor, which must answer it before it is released.
+    // The chunks received after the processor stopped the streaming aren't sent.
+    bool sent_{};
   };
+  using QueuedChunkPtr = std::unique_ptr<QueuedChunk>;
 
   virtual ~ProcessorState() = default;
 
@@ -36,6 +53,19 @@ public:
   bool handleHeadersResponse(const envoy::service::ext_proc::v3alpha::HeadersResponse& response);
   bool handleBodyResponse(const envoy::service::ext_proc::v3alpha::BodyResponse& response);
 
+  // The streamed body data received but not sent to the processor yet.
+  Buffer::Instance& pendingStreamedData() { return pending_streamed_data_; }
+  void startFlushTimer(Event::TimerCb cb, std::chrono::milliseconds delay);
+  // Moves the pending data to a new chunk at the end of the queue.
+  void queuePendingChunk(bool end_stream, bool sent);
+  // Whether there is streamed body data that wasn't released yet.
+  bool hasStreamedData() const {
+    return !chunk_queue_.empty() || pending_streamed_data_.length() > 0;
+  }
+  bool hasSentChunks() const { return !chunk_queue_.empty() && chunk_queue_.front()->sent_; }
+  // Set when the trailers wait for the streamed body to be released.
+  void setTrailersStopped() { trailers_stopped_ = true; }
+
   virtual const Buffer::Instance* bufferedData() const PURE;
   virtual void addBufferedData(Buffer::Instance& data) const PURE;
   virtual void modifyBufferedData(std::function<void(Buffer::Instance&)> cb) const PURE;
@@ -43,16 +73,38 @@ public:
   virtual void continueProcessing() const PURE;
   void clearAsyncState();
 
+  virtual void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const PURE;
+  virtual uint32_t bufferLimit() const PURE;
+  virtual void requestWatermark() const PURE;
+  virtual void clearWatermark() const PURE;
+
   virtual envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const PURE;
   virtual envoy::service::ext_proc::v3alpha::HttpBody*
   mutableBody(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const PURE;
 
 protected:
+  // Releases the chunks at the front of the queue that don't wait for a response.
+  void releaseUnsentChunks();
+  void releaseChunk(QueuedChunk& chunk);
+  // Releases all the streamed data, as is.
+  void releaseStreamedData();
+  void onStreamedDataReleased();
+
   Http::StreamFilterCallbacks* filter_callbacks_;
   CallbackState callback_state_ = CallbackState::Idle;
   Http::HeaderMap* headers_ = nullptr;
   Event::TimerPtr message_timer_;
+  std::chrono::milliseconds message_timeout_{};
+
+  Buffer::OwnedImpl pending_streamed_data_;
+  // The chunks of the streamed body not released yet, in order.
+  std::deque<QueuedChunkPtr> chunk_queue_;
+  uint64_t queued_bytes_{};
+  bool watermark_requested_{};
+  bool trailers_stopped_{};
+  // Sends the pending data when it was held for too long.
+  Event::TimerPtr flush_timer_;
 };
 
 class DecodingProcessorState : public ProcessorState {
@@ -76,6 +128,20 @@ public:
 
   void continueProcessing() const override { decoder_callbacks_->continueDecoding(); }
 
+  void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const override {
+    decoder_callbacks_->injectDecodedDataToFilterChain(data, end_stream);
+  }
+
+  uint32_t bufferLimit() const override { return decoder_callbacks_->decoderBufferLimit(); }
+
+  void requestWatermark() const override {
+    decoder_callbacks_->onDecoderFilterAboveWriteBufferHighWatermark();
+  }
+
+  void clearWatermark() const override {
+    decoder_callbacks_->onDecoderFilterBelowWriteBufferLowWatermark();
+  }
+
   envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const override {
     return request.mutable_request_headers();
@@ -111,6 +177,20 @@ public:
 
   void continueProcessing() const override { encoder_callbacks_->continueEncoding(); }
 
+  void injectDataToFilterChain(Buffer::Instance& data, bool end_stream) const override {
+    encoder_callbacks_->injectEncodedDataToFilterChain(data, end_stream);
+  }
+
+  uint32_t bufferLimit() const override { return encoder_callbacks_->encoderBufferLimit(); }
+
+  void requestWatermark() const override {
+    encoder_callbacks_->onEncoderFilterAboveWriteBufferHighWatermark();
+  }
+
+  void clearWatermark() const override {
+    encoder_callbacks_->onEncoderFilterBelowWriteBufferLowWatermark();
+  }
+
   envoy::service::ext_proc::v3alpha::HttpHeaders*
   mutableHeaders(envoy::service::ext_proc::v3alpha::ProcessingRequest& request) const override {
     return request.mutable_response_headers();
@@ -119,6 +119,12 @@ Http::FilterHeadersStatus FaultFilter::decodeHeaders(Http::RequestHeaderMap& hea
     fault_settings_ = per_route_settings ? per_route_settings : fault_settings_;
   }
 
+  // The routes without faults, e.g. those which override the faults of the filter with empty
+  // settings, skip the matching of the request altogether.
+  if (!fault_settings_->hasFaults()) {
+    return Http::FilterHeadersStatus::Continue;
+  }
+
   if (!matchesTargetUpstreamCluster()) {
     return Http::FilterHeadersStatus::Continue;
   }
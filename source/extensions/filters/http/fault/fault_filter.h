@@ -70,6 +70,12 @@ public:
   const std::string& abortGrpcStatusRuntime() const { return abort_grpc_status_runtime_; }
   const std::string& delayDurationRuntime() const { return delay_duration_runtime_; }
   const std::string& maxActiveFaultsRuntime() const { return max_active_faults_runtime_; }
+  // Whether any fault is configured. The runtime only overrides the configured faults, so the
+  // settings without faults never inject one.
+  bool hasFaults() const {
+    return request_delay_config_ != nullptr || request_abort_config_ != nullptr ||
+           response_rate_limit_ != nullptr;
+  }
   const std::string& responseRateLimitPercentRuntime() const {
     return response_rate_limit_percent_runtime_;
   }
@@ -71,10 +71,28 @@ const Http::LowerCaseString& trailerHeader() {
   CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "trailer");
 }
 
+// Transcoded messages at least this large are moved into buffers instead of copied. Smaller ones
+// are cheaper to copy into the free space of the last slice of the buffer.
+constexpr uint64_t MoveMessageMinSize = 16 * 1024;
+
+// Buffer fragment that owns a transcoded message.
+class MessageBufferFragmentImpl : public Buffer::BufferFragment {
+public:
+  explicit MessageBufferFragmentImpl(std::string&& message) : message_(std::move(message)) {}
+
+  // Buffer::BufferFragment
+  const void* data() const override { return message_.data(); }
+  size_t size() const override { return message_.size(); }
+  void done() override { delete this; }
+
+private:
+  const std::string message_;
+};
+
 // Transcoder:
 // https://github.com/grpc-ecosystem/grpc-httpjson-transcoding/blob/master/src/include/grpc_transcoding/transcoder.h
 // implementation based on JsonRequestTranslator & ResponseToJsonTranslator
-class TranscoderImpl : public Transcoder {
+class TranscoderImpl : public MessageTranscoder {
 public:
   /**
    * Construct a transcoder implementation
@@ -101,6 +119,10 @@ public:
   ZeroCopyInputStream* ResponseOutput() override { return response_stream_.get(); }
   ProtobufUtil::Status ResponseStatus() override { return response_translator_->Status(); }
 
+  // MessageTranscoder
+  MessageStream& requestMessages() override { return request_message_stream_; }
+  MessageStream& responseMessages() override { return *response_translator_; }
+
 private:
   RequestMessageTranslatorPtr request_translator_;
   JsonRequestTranslatorPtr json_request_translator_;
@@ -319,7 +341,7 @@ bool JsonTranscoderConfig::convertGrpcStatus() const { return convert_grpc_statu
 ProtobufUtil::Status JsonTranscoderConfig::createTranscoder(
     const Http::RequestHeaderMap& headers, ZeroCopyInputStream& request_input,
     google::grpc::transcoding::TranscoderInputStream& response_input,
-    std::unique_ptr<Transcoder>& transcoder, MethodInfoSharedPtr& method_info) const {
+    MessageTranscoderPtr& transcoder, MethodInfoSharedPtr& method_info) const {
 
   ASSERT(!disabled_);
   const std::string method(headers.getMethodValue());
@@ -483,7 +505,7 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::RequestHeade
       content_type_.assign(content_type.begin(), content_type.end());
     }
 
-    bool done = !readToBuffer(*transcoder_->RequestOutput(), initial_request_data_);
+    bool done = !readToBuffer(transcoder_->requestMessages(), initial_request_data_);
     if (!done) {
       ENVOY_LOG(
           debug,
@@ -522,7 +544,7 @@ Http::FilterHeadersStatus JsonTranscoderFilter::decodeHeaders(Http::RequestHeade
     }
 
     Buffer::OwnedImpl data;
-    readToBuffer(*transcoder_->RequestOutput(), data);
+    readToBuffer(transcoder_->requestMessages(), data);
 
     if (data.length() > 0) {
       decoder_callbacks_->addDecodedData(data, true);
@@ -561,7 +583,7 @@ Http::FilterDataStatus JsonTranscoderFilter::decodeData(Buffer::Instance& data,
       request_in_.finish();
     }
 
-    readToBuffer(*transcoder_->RequestOutput(), data);
+    readToBuffer(transcoder_->requestMessages(), data);
   }
 
   if (checkIfTranscoderFailed(RcDetails::get().GrpcTranscodeFailed)) {
@@ -583,7 +605,7 @@ Http::FilterTrailersStatus JsonTranscoderFilter::decodeTrailers(Http::RequestTra
     request_in_.finish();
 
     Buffer::OwnedImpl data;
-    readToBuffer(*transcoder_->RequestOutput(), data);
+    readToBuffer(transcoder_->requestMessages(), data);
 
     if (data.length()) {
       decoder_callbacks_->addDecodedData(data, true);
@@ -661,7 +683,7 @@ Http::FilterDataStatus JsonTranscoderFilter::encodeData(Buffer::Instance& data,
     response_in_.finish();
   }
 
-  readToBuffer(*transcoder_->ResponseOutput(), data);
+  readToBuffer(transcoder_->responseMessages(), data);
 
   if (!method_->descriptor_->server_streaming() && !end_stream) {
     // Buffer until the response is complete.
@@ -694,7 +716,7 @@ void JsonTranscoderFilter::doTrailers(Http::ResponseHeaderOrTrailerMap& headers_
 
   if (!method_->response_type_is_http_body_) {
     Buffer::OwnedImpl data;
-    readToBuffer(*transcoder_->ResponseOutput(), data);
+    readToBuffer(transcoder_->responseMessages(), data);
     if (data.length()) {
       encoder_callbacks_->addEncodedData(data, true);
     }
@@ -761,18 +783,19 @@ bool JsonTranscoderFilter::checkIfTranscoderFailed(const std::string& details) {
   return false;
 }
 
-bool JsonTranscoderFilter::readToBuffer(Protobuf::io::ZeroCopyInputStream& stream,
-                                        Buffer::Instance& data) {
-  const void* out;
-  int size;
-  while (stream.Next(&out, &size)) {
-    data.add(out, size);
-
-    if (size == 0) {
-      return true;
+bool JsonTranscoderFilter::readToBuffer(MessageStream& stream, Buffer::Instance& data) {
+  // Reading whole messages, rather than through the output streams, lets large messages be moved
+  // into the buffer, so that transcoding MB-sized messages doesn't hold a second copy of them.
+  std::string message;
+  while (stream.NextMessage(&message)) {
+    if (message.size() >= MoveMessageMinSize) {
+      data.addBufferFragment(*new MessageBufferFragmentImpl(std::move(message)));
+      message.clear();
+    } else {
+      data.add(message);
     }
   }
-  return false;
+  return !stream.Finished();
 }
 
 void JsonTranscoderFilter::maybeSendHttpBodyRequestMessage() {
@@ -14,6 +14,7 @@
 #include "extensions/filters/http/grpc_json_transcoder/transcoder_input_stream_impl.h"
 
 #include "google/api/http.pb.h"
+#include "grpc_transcoding/message_stream.h"
 #include "grpc_transcoding/path_matcher.h"
 #include "grpc_transcoding/request_message_translator.h"
 #include "grpc_transcoding/transcoder.h"
@@ -50,6 +51,24 @@ struct MethodInfo {
 };
 using MethodInfoSharedPtr = std::shared_ptr<MethodInfo>;
 
+/**
+ * Transcoder that also gives access to its output a message at a time, so that the transcoded
+ * messages can be moved into buffers rather than copied out of the output streams.
+ */
+class MessageTranscoder : public google::grpc::transcoding::Transcoder {
+public:
+  /**
+   * @return the stream of gRPC messages transcoded from the request.
+   */
+  virtual google::grpc::transcoding::MessageStream& requestMessages() PURE;
+
+  /**
+   * @return the stream of JSON messages transcoded from the response.
+   */
+  virtual google::grpc::transcoding::MessageStream& responseMessages() PURE;
+};
+using MessageTranscoderPtr = std::unique_ptr<MessageTranscoder>;
+
 void createHttpBodyEnvelope(Buffer::Instance& output,
                             const std::vector<const Protobuf::Field*>& request_body_field_path,
                             std::string content_type, uint64_t content_length);
@@ -85,8 +104,7 @@ public:
   createTranscoder(const Http::RequestHeaderMap& headers,
                    Protobuf::io::ZeroCopyInputStream& request_input,
                    google::grpc::transcoding::TranscoderInputStream& response_input,
-                   std::unique_ptr<google::grpc::transcoding::Transcoder>& transcoder,
-                   MethodInfoSharedPtr& method_info) const;
+                   MessageTranscoderPtr& transcoder, MethodInfoSharedPtr& method_info) const;
 
   /**
    * Converts an arbitrary protobuf message to JSON.
@@ -175,7 +193,7 @@ public:
 
 private:
   bool checkIfTranscoderFailed(const std::string& details);
-  bool readToBuffer(Protobuf::io::ZeroCopyInputStream& stream, Buffer::Instance& data);
+  bool readToBuffer(google::grpc::transcoding::MessageStream& stream, Buffer::Instance& data);
   void maybeSendHttpBodyRequestMessage();
   /**
    * Builds response from HttpBody protobuf.
@@ -195,7 +213,7 @@ private:
 
   JsonTranscoderConfig& config_;
   const JsonTranscoderConfig* per_route_config_{};
-  std::unique_ptr<google::grpc::transcoding::Transcoder> transcoder_;
+  MessageTranscoderPtr transcoder_;
   TranscoderInputStreamImpl request_in_;
   TranscoderInputStreamImpl response_in_;
   Http::StreamDecoderFilterCallbacks* decoder_callbacks_{};
@@ -254,8 +254,8 @@ void HeaderToMetadataFilter::writeHeaderToMetadata(Http::HeaderMap& headers,
   }
   // Any matching rules?
   if (!structs_by_namespace.empty()) {
-    for (auto const& entry : structs_by_namespace) {
-      callbacks.streamInfo().setDynamicMetadata(entry.first, entry.second);
+    for (auto& entry : structs_by_namespace) {
+      callbacks.streamInfo().setDynamicMetadata(entry.first, std::move(entry.second));
     }
   }
 }
@@ -139,6 +139,7 @@ public:
 
   // Http::StreamFilterBase
   void onDestroy() override {}
+  bool needsTunnelData() const override { return false; }
 
   // StreamDecoderFilter
   Http::FilterHeadersStatus decodeHeaders(Http::RequestHeaderMap& headers, bool) override;
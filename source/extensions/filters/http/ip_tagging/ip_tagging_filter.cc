@@ -6,6 +6,7 @@
 #include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_join.h"
 
 namespace Envoy {
@@ -19,8 +20,7 @@ IpTaggingFilterConfig::IpTaggingFilterConfig(
     : request_type_(requestTypeEnum(config.request_type())), scope_(scope), runtime_(runtime),
       stat_name_set_(scope.symbolTable().makeSet("IpTagging")),
       stats_prefix_(stat_name_set_->add(stat_prefix + "ip_tagging")),
-      no_hit_(stat_name_set_->add("no_hit")), total_(stat_name_set_->add("total")),
-      unknown_tag_(stat_name_set_->add("unknown_tag.hit")) {
+      no_hit_(stat_name_set_->add("no_hit")), total_(stat_name_set_->add("total")) {
 
   // Once loading IP tags from a file system is supported, the restriction on the size
   // of the set should be removed and observability into what tags are loaded needs
@@ -31,7 +31,12 @@ IpTaggingFilterConfig::IpTaggingFilterConfig(
     throw EnvoyException("HTTP IP Tagging Filter requires ip_tags to be specified.");
   }
 
-  std::vector<std::pair<std::string, std::vector<Network::Address::CidrRange>>> tag_data;
+  // The tags are interned to their IDs, the same tag name listed several times getting the same
+  // ID.
+  absl::flat_hash_map<std::string, uint32_t> tag_ids;
+  std::vector<absl::string_view> tag_names;
+  std::vector<Stats::StatName> hit_stat_names;
+  std::vector<std::pair<uint32_t, std::vector<Network::Address::CidrRange>>> tag_data;
   tag_data.reserve(config.ip_tags().size());
   for (const auto& ip_tag : config.ip_tags()) {
     std::vector<Network::Address::CidrRange> cidr_set;
@@ -49,10 +54,29 @@ IpTaggingFilterConfig::IpTaggingFilterConfig(
       }
     }
 
-    tag_data.emplace_back(ip_tag.ip_tag_name(), cidr_set);
-    stat_name_set_->rememberBuiltin(absl::StrCat(ip_tag.ip_tag_name(), ".hit"));
+    const auto result = tag_ids.try_emplace(ip_tag.ip_tag_name(), tag_names.size());
+    if (result.second) {
+      tag_names.push_back(ip_tag.ip_tag_name());
+      hit_stat_names.push_back(stat_name_set_->add(absl::StrCat(ip_tag.ip_tag_name(), ".hit")));
+    }
+    tag_data.emplace_back(result.first->second, std::move(cidr_set));
+  }
+  trie_ = std::make_unique<Network::LcTrie::LcTrie<uint32_t>>(tag_data);
+
+  // The addresses resolve to a few distinct sets of tags, for which the header value and the
+  // stats are computed once rather than on each request. The tag IDs of each set are sorted, so
+  // the tags are in the order of the configuration.
+  tag_sets_.reserve(trie_->dataSets().size());
+  for (const std::vector<uint32_t>& ids : trie_->dataSets()) {
+    TagSet& tag_set = tag_sets_.emplace_back();
+    std::vector<absl::string_view> names;
+    names.reserve(ids.size());
+    for (const uint32_t id : ids) {
+      names.push_back(tag_names[id]);
+      tag_set.hit_stat_names_.push_back(hit_stat_names[id]);
+    }
+    tag_set.header_value_ = absl::StrJoin(names, ",");
   }
-  trie_ = std::make_unique<Network::LcTrie::LcTrie<std::string>>(tag_data);
 }
 
 void IpTaggingFilterConfig::incCounter(Stats::StatName name) {
@@ -77,12 +101,11 @@ Http::FilterHeadersStatus IpTaggingFilter::decodeHeaders(Http::RequestHeaderMap&
     return Http::FilterHeadersStatus::Continue;
   }
 
-  std::vector<std::string> tags =
-      config_->trie().getData(callbacks_->streamInfo().downstreamAddressProvider().remoteAddress());
+  const IpTaggingFilterConfig::TagSet& tag_set =
+      config_->tagSet(callbacks_->streamInfo().downstreamAddressProvider().remoteAddress());
 
-  if (!tags.empty()) {
-    const std::string tags_join = absl::StrJoin(tags, ",");
-    headers.appendEnvoyIpTags(tags_join, ",");
+  if (!tag_set.hit_stat_names_.empty()) {
+    headers.appendEnvoyIpTags(tag_set.header_value_, ",");
 
     // We must clear the route cache or else we can't match on x-envoy-ip-tags.
     callbacks_->clearRouteCache();
@@ -90,8 +113,8 @@ Http::FilterHeadersStatus IpTaggingFilter::decodeHeaders(Http::RequestHeaderMap&
     // For a large number(ex > 1000) of tags, stats cardinality will be an issue.
     // If there are use cases with a large set of tags, a way to opt into these stats
     // should be exposed and other observability options like logging tags need to be implemented.
-    for (const std::string& tag : tags) {
-      config_->incHit(tag);
+    for (const Stats::StatName hit_stat_name : tag_set.hit_stat_names_) {
+      config_->incHit(hit_stat_name);
     }
   } else {
     config_->incNoHit();
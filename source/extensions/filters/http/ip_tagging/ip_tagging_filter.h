@@ -31,17 +31,33 @@ enum class FilterRequestType { INTERNAL, EXTERNAL, BOTH };
  */
 class IpTaggingFilterConfig {
 public:
+  /**
+   * The tags of a distinct set of tags the addresses resolve to, with what the filter derives
+   * from them precomputed.
+   */
+  struct TagSet {
+    // The value appended to x-envoy-ip-tags, the tags in the order of the configuration.
+    std::string header_value_;
+    // The name of the hit stat of each tag.
+    std::vector<Stats::StatName> hit_stat_names_;
+  };
+
   IpTaggingFilterConfig(const envoy::extensions::filters::http::ip_tagging::v3::IPTagging& config,
                         const std::string& stat_prefix, Stats::Scope& scope,
                         Runtime::Loader& runtime);
 
   Runtime::Loader& runtime() { return runtime_; }
   FilterRequestType requestType() const { return request_type_; }
-  const Network::LcTrie::LcTrie<std::string>& trie() const { return *trie_; }
 
-  void incHit(absl::string_view tag) {
-    incCounter(stat_name_set_->getBuiltin(absl::StrCat(tag, ".hit"), unknown_tag_));
+  /**
+   * @param address supplies an address.
+   * @return the tags of the address, empty if it has none.
+   */
+  const TagSet& tagSet(const Network::Address::InstanceConstSharedPtr& address) const {
+    return tag_sets_[trie_->getDataSetIndex(address)];
   }
+
+  void incHit(Stats::StatName hit_stat_name) { incCounter(hit_stat_name); }
   void incNoHit() { incCounter(no_hit_); }
   void incTotal() { incCounter(total_); }
 
@@ -69,8 +85,11 @@ private:
   const Stats::StatName stats_prefix_;
   const Stats::StatName no_hit_;
   const Stats::StatName total_;
-  const Stats::StatName unknown_tag_;
-  std::unique_ptr<Network::LcTrie::LcTrie<std::string>> trie_;
+  // The trie maps the addresses to the IDs of their tags, the indexes of the tags in the
+  // configuration, so that it holds integers rather than strings.
+  std::unique_ptr<Network::LcTrie::LcTrie<uint32_t>> trie_;
+  // The distinct sets of tags, indexed as the data sets of the trie.
+  std::vector<TagSet> tag_sets_;
 };
 
 using IpTaggingFilterConfigSharedPtr = std::shared_ptr<IpTaggingFilterConfig>;
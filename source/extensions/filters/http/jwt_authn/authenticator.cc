@@ -240,11 +240,18 @@ void AuthenticatorImpl::onDestroy() {
 
 // Verify with a specific public key.
 void AuthenticatorImpl::verifyKey() {
-  const Status status =
-      ::google::jwt_verify::verifyJwtWithoutTimeChecking(*jwt_, *jwks_data_->getJwksObj());
-  if (status != Status::Ok) {
-    doneWithStatus(status);
-    return;
+  // The claims of a cached token were checked again by startVerify(), only its signature is
+  // skipped.
+  if (jwks_data_->isTokenVerified(curr_token_->token())) {
+    ENVOY_LOG(debug, "{}: JWT token found in the cache of the verified tokens", name());
+  } else {
+    const Status status =
+        ::google::jwt_verify::verifyJwtWithoutTimeChecking(*jwt_, *jwks_data_->getJwksObj());
+    if (status != Status::Ok) {
+      doneWithStatus(status);
+      return;
+    }
+    jwks_data_->addVerifiedToken(curr_token_->token(), jwt_->exp_);
   }
 
   // Forward the payload
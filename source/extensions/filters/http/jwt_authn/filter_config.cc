@@ -11,7 +11,7 @@ namespace Extensions {
 namespace HttpFilters {
 namespace JwtAuthn {
 
-void FilterConfigImpl::init() {
+void FilterConfigImpl::init(Server::Configuration::FactoryContext& context) {
   ENVOY_LOG(debug, "Loaded JwtAuthConfig: {}", proto_config_.DebugString());
 
   // Note: `this` and `context` have a a lifetime of the listener.
@@ -23,6 +23,18 @@ void FilterConfigImpl::init() {
                                               shared_this->api_);
   });
 
+  for (const auto& it : proto_config_.providers()) {
+    const auto& provider = it.second;
+    if (provider.has_remote_jwks() && provider.remote_jwks().has_async_fetch()) {
+      const std::string& name = it.first;
+      jwks_async_fetchers_.push_back(std::make_unique<JwksAsyncFetcher>(
+          provider.remote_jwks(), context, Common::JwksFetcher::create, stats_,
+          [this, name](::google::jwt_verify::JwksPtr&& jwks) {
+            setFetchedJwks(name, std::move(jwks));
+          }));
+    }
+  }
+
   std::vector<std::string> names;
   for (const auto& it : proto_config_.requirement_map()) {
     names.push_back(it.first);
@@ -66,6 +78,16 @@ void FilterConfigImpl::init() {
   }
 }
 
+void FilterConfigImpl::setFetchedJwks(const std::string& provider,
+                                      ::google::jwt_verify::JwksPtr&& jwks) {
+  // The workers share the parsed JWKS, which is only read once set.
+  JwksConstSharedPtr shared_jwks = std::move(jwks);
+  tls_->runOnAllThreads([provider, shared_jwks](ThreadLocal::ThreadLocalObjectSharedPtr object) {
+    object->asType<ThreadLocalCache>().getJwksCache().findByProvider(provider)->setFetchedJwks(
+        shared_jwks);
+  });
+}
+
 std::pair<const Verifier*, std::string>
 FilterConfigImpl::findPerRouteVerifier(const PerRouteFilterConfig& per_route) const {
   if (per_route.config().disabled()) {
@@ -8,7 +8,9 @@
 #include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
 #include "extensions/filters/http/jwt_authn/matcher.h"
+#include "extensions/filters/http/jwt_authn/stats.h"
 #include "extensions/filters/http/jwt_authn/verifier.h"
 
 #include "absl/container/flat_hash_map.h"
@@ -39,21 +41,6 @@ private:
   JwksCachePtr jwks_cache_;
 };
 
-/**
- * All stats for the Jwt Authn filter. @see stats_macros.h
- */
-#define ALL_JWT_AUTHN_FILTER_STATS(COUNTER)                                                        \
-  COUNTER(allowed)                                                                                 \
-  COUNTER(cors_preflight_bypassed)                                                                 \
-  COUNTER(denied)
-
-/**
- * Wrapper struct for jwt_authn filter stats. @see stats_macros.h
- */
-struct JwtAuthnFilterStats {
-  ALL_JWT_AUTHN_FILTER_STATS(GENERATE_COUNTER_STRUCT)
-};
-
 /**
  * The per-route filter config
  */
@@ -109,7 +96,7 @@ public:
     // We can't use make_shared here because the constructor of this class is private.
     std::shared_ptr<FilterConfigImpl> ptr(
         new FilterConfigImpl(proto_config, stats_prefix, context));
-    ptr->init();
+    ptr->init(context);
     return ptr;
   }
 
@@ -164,7 +151,10 @@ private:
         tls_(context.threadLocal().allocateSlot()), cm_(context.clusterManager()),
         time_source_(context.dispatcher().timeSource()), api_(context.api()) {}
 
-  void init();
+  void init(Server::Configuration::FactoryContext& context);
+
+  // Sets the JWKS of a provider fetched in the background on all the workers.
+  void setFetchedJwks(const std::string& provider, ::google::jwt_verify::JwksPtr&& jwks);
 
   JwtAuthnFilterStats generateStats(const std::string& prefix, Stats::Scope& scope) {
     const std::string final_prefix = prefix + "jwt_authn.";
@@ -196,6 +186,8 @@ private:
   absl::flat_hash_map<std::string, VerifierConstPtr> name_verifiers_;
   // all requirement_names for debug
   std::string all_requirement_names_;
+  // The fetchers of the providers with async_fetch.
+  std::vector<JwksAsyncFetcherPtr> jwks_async_fetchers_;
   TimeSource& time_source_;
   Api::Api& api_;
 };
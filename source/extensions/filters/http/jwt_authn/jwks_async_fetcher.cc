@@ -0,0 +1,80 @@
+#include "extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
+
+#include "common/protobuf/utility.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "extensions/filters/http/jwt_authn/jwks_cache.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+// Default duration to wait before fetching again after a failure.
+constexpr uint64_t DefaultFailedRefetchDurationMs = 1000;
+
+} // namespace
+
+JwksAsyncFetcher::JwksAsyncFetcher(
+    const envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks& remote_jwks,
+    Server::Configuration::FactoryContext& context, CreateJwksFetcherCb create_fetcher_fn,
+    JwtAuthnFilterStats& stats, JwksDoneFetched done_fn)
+    : remote_jwks_(remote_jwks), cm_(context.clusterManager()),
+      create_fetcher_fn_(create_fetcher_fn), stats_(stats), done_fn_(done_fn),
+      cache_duration_(PROTOBUF_GET_MS_OR_DEFAULT(
+          remote_jwks, cache_duration,
+          std::chrono::milliseconds(JwksCache::DefaultCacheDuration).count())),
+      failed_refetch_duration_(PROTOBUF_GET_MS_OR_DEFAULT(
+          remote_jwks.async_fetch(), failed_refetch_duration, DefaultFailedRefetchDurationMs)),
+      refetch_timer_(context.dispatcher().createTimer([this]() { fetch(); })) {
+  if (remote_jwks_.async_fetch().fast_listener()) {
+    fetch();
+    return;
+  }
+  init_target_ = std::make_unique<Init::TargetImpl>(
+      fmt::format("JwksAsyncFetcher {}", remote_jwks_.http_uri().uri()), [this]() { fetch(); });
+  context.initManager().add(*init_target_);
+}
+
+JwksAsyncFetcher::~JwksAsyncFetcher() {
+  if (fetcher_) {
+    fetcher_->cancel();
+  }
+}
+
+void JwksAsyncFetcher::fetch() {
+  ENVOY_LOG(debug, "Fetching the JWKS from {}", remote_jwks_.http_uri().uri());
+  if (fetcher_) {
+    fetcher_->cancel();
+  }
+  fetcher_ = create_fetcher_fn_(cm_);
+  fetcher_->fetch(remote_jwks_.http_uri(), Tracing::NullSpan::instance(), *this);
+}
+
+void JwksAsyncFetcher::onJwksSuccess(::google::jwt_verify::JwksPtr&& jwks) {
+  stats_.jwks_fetch_success_.inc();
+  done_fn_(std::move(jwks));
+  refetch_timer_->enableTimer(cache_duration_);
+  handleFetchDone();
+}
+
+void JwksAsyncFetcher::onJwksError(Failure) {
+  ENVOY_LOG(warn, "Failed to fetch the JWKS from {}", remote_jwks_.http_uri().uri());
+  stats_.jwks_fetch_failed_.inc();
+  refetch_timer_->enableTimer(failed_refetch_duration_);
+  handleFetchDone();
+}
+
+void JwksAsyncFetcher::handleFetchDone() {
+  // The listener only waits for the first fetch, whether it succeeded or not.
+  if (init_target_) {
+    init_target_->ready();
+    init_target_.reset();
+  }
+}
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
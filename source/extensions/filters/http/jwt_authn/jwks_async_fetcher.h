@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+#include "envoy/server/filter_config.h"
+
+#include "common/common/logger.h"
+#include "common/init/target_impl.h"
+
+#include "extensions/filters/http/jwt_authn/authenticator.h"
+#include "extensions/filters/http/jwt_authn/stats.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+
+/**
+ * JwksDoneFetched is a callback to receive the JWKS fetched in the background.
+ */
+using JwksDoneFetched = std::function<void(::google::jwt_verify::JwksPtr&& jwks)>;
+
+/**
+ * Fetches the remote JWKS of a provider with async_fetch on the main thread, when the listener is
+ * initialized and then every cache_duration, so that the workers never wait for it. A failed
+ * fetch is retried after failed_refetch_duration, while the workers keep the last JWKS.
+ */
+class JwksAsyncFetcher : public Common::JwksFetcher::JwksReceiver,
+                         public Logger::Loggable<Logger::Id::jwt> {
+public:
+  JwksAsyncFetcher(const envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks& remote_jwks,
+                   Server::Configuration::FactoryContext& context,
+                   CreateJwksFetcherCb create_fetcher_fn, JwtAuthnFilterStats& stats,
+                   JwksDoneFetched done_fn);
+  ~JwksAsyncFetcher() override;
+
+  // Common::JwksFetcher::JwksReceiver
+  void onJwksSuccess(::google::jwt_verify::JwksPtr&& jwks) override;
+  void onJwksError(Failure reason) override;
+
+private:
+  void fetch();
+  void handleFetchDone();
+
+  const envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks& remote_jwks_;
+  Upstream::ClusterManager& cm_;
+  CreateJwksFetcherCb create_fetcher_fn_;
+  JwtAuthnFilterStats& stats_;
+  JwksDoneFetched done_fn_;
+  const std::chrono::milliseconds cache_duration_;
+  const std::chrono::milliseconds failed_refetch_duration_;
+  // The fetcher of the current fetch, if any.
+  Common::JwksFetcherPtr fetcher_;
+  Event::TimerPtr refetch_timer_;
+  // Set unless fast_listener is true, to delay the listener until the first fetch is done.
+  std::unique_ptr<Init::TargetImpl> init_target_;
+};
+
+using JwksAsyncFetcherPtr = std::unique_ptr<JwksAsyncFetcher>;
+
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
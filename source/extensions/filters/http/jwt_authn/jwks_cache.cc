@@ -6,9 +6,11 @@
 #include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
 
 #include "common/common/logger.h"
+#include "common/common/utility.h"
 #include "common/config/datasource.h"
 #include "common/protobuf/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "jwt_verify_lib/check_audience.h"
 
@@ -23,13 +25,18 @@ namespace HttpFilters {
 namespace JwtAuthn {
 namespace {
 
-// Default cache expiration time in 5 minutes.
-constexpr int PubkeyCacheExpirationSec = 600;
+// Default number of verified tokens cached for a provider.
+constexpr uint32_t DefaultJwtCacheSize = 100;
 
 class JwksDataImpl : public JwksCache::JwksData, public Logger::Loggable<Logger::Id::jwt> {
 public:
   JwksDataImpl(const JwtProvider& jwt_provider, TimeSource& time_source, Api::Api& api)
-      : jwt_provider_(jwt_provider), time_source_(time_source) {
+      : jwt_provider_(jwt_provider), time_source_(time_source),
+        jwt_cache_size_(!jwt_provider_.has_jwt_cache_config()
+                            ? 0
+                            : jwt_provider_.jwt_cache_config().jwt_cache_size() > 0
+                                  ? jwt_provider_.jwt_cache_config().jwt_cache_size()
+                                  : DefaultJwtCacheSize) {
     std::vector<std::string> audiences;
     for (const auto& aud : jwt_provider_.audiences()) {
       audiences.push_back(aud);
@@ -44,7 +51,7 @@ public:
       if (ptr->getStatus() != Status::Ok) {
         ENVOY_LOG(warn, "Invalid inline jwks for issuer: {}, jwks: {}", jwt_provider_.issuer(),
                   inline_jwks);
-        jwks_obj_.reset(nullptr);
+        jwks_obj_.reset();
       }
     }
   }
@@ -63,6 +70,30 @@ public:
     return setKey(std::move(jwks), getRemoteJwksExpirationTime());
   }
 
+  void setFetchedJwks(JwksConstSharedPtr jwks) override {
+    setKey(std::move(jwks), std::chrono::steady_clock::time_point::max());
+  }
+
+  bool isTokenVerified(const std::string& token) const override {
+    return verified_tokens_.contains(token);
+  }
+
+  void addVerifiedToken(const std::string& token, uint64_t exp) override {
+    if (jwt_cache_size_ == 0) {
+      return;
+    }
+    if (verified_tokens_.size() >= jwt_cache_size_) {
+      // Make room by forgetting the expired tokens first, then any token.
+      const uint64_t now = DateUtil::nowToSeconds(time_source_);
+      absl::erase_if(verified_tokens_,
+                     [now](const auto& entry) { return entry.second != 0 && entry.second < now; });
+      if (verified_tokens_.size() >= jwt_cache_size_) {
+        verified_tokens_.erase(verified_tokens_.begin());
+      }
+    }
+    verified_tokens_.emplace(token, exp);
+  }
+
 private:
   // Get the expiration time for a remote Jwks
   std::chrono::steady_clock::time_point getRemoteJwksExpirationTime() const {
@@ -71,15 +102,16 @@ private:
       expire += std::chrono::milliseconds(
           DurationUtil::durationToMilliseconds(jwt_provider_.remote_jwks().cache_duration()));
     } else {
-      expire += std::chrono::seconds(PubkeyCacheExpirationSec);
+      expire += DefaultCacheDuration;
     }
     return expire;
   }
 
-  const ::google::jwt_verify::Jwks* setKey(::google::jwt_verify::JwksPtr&& jwks,
-                                           MonotonicTime expire) {
+  const ::google::jwt_verify::Jwks* setKey(JwksConstSharedPtr jwks, MonotonicTime expire) {
     jwks_obj_ = std::move(jwks);
     expiration_time_ = expire;
+    // The tokens may have been signed with keys that are no longer in the Jwks.
+    verified_tokens_.clear();
     return jwks_obj_.get();
   }
 
@@ -87,11 +119,15 @@ private:
   const JwtProvider& jwt_provider_;
   // Check audience object
   ::google::jwt_verify::CheckAudiencePtr audiences_;
-  // The generated jwks object.
-  ::google::jwt_verify::JwksPtr jwks_obj_;
+  // The generated jwks object, shared with the other workers if it was fetched in the background.
+  JwksConstSharedPtr jwks_obj_;
   TimeSource& time_source_;
   // The pubkey expiration time.
   MonotonicTime expiration_time_;
+  // The maximum number of verified tokens, 0 if they aren't cached.
+  const uint32_t jwt_cache_size_;
+  // The tokens verified with jwks_obj_, with their `exp` claim.
+  absl::flat_hash_map<std::string, uint64_t> verified_tokens_;
 };
 
 class JwksCacheImpl : public JwksCache {
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+
 #include "envoy/api/api.h"
 #include "envoy/common/pure.h"
 #include "envoy/common/time.h"
@@ -15,6 +18,8 @@ namespace JwtAuthn {
 class JwksCache;
 using JwksCachePtr = std::unique_ptr<JwksCache>;
 
+using JwksConstSharedPtr = std::shared_ptr<const ::google::jwt_verify::Jwks>;
+
 /**
  * Interface to access all configured Jwt rules and their cached Jwks objects.
  * It only caches Jwks specified in the config.
@@ -30,7 +35,13 @@ using JwksCachePtr = std::unique_ptr<JwksCache>;
  *        jwks_data->setRemoteJwks(remote_jwks_str);
  *     }
  *
- *     verifyJwt(jwks_data->getJwksObj(), jwt);
+ *     // Or, with async_fetch, the main thread fetches the Jwks and sets it on each worker.
+ *     jwks_data->setFetchedJwks(jwks);
+ *
+ *     if (!jwks_data->isTokenVerified(token)) {
+ *       verifyJwt(jwks_data->getJwksObj(), jwt);
+ *       jwks_data->addVerifiedToken(token, jwt->exp_);
+ *     }
  */
 
 class JwksCache {
@@ -58,6 +69,17 @@ public:
     // Set a remote Jwks.
     virtual const ::google::jwt_verify::Jwks*
     setRemoteJwks(::google::jwt_verify::JwksPtr&& jwks) PURE;
+
+    // Set a remote Jwks fetched in the background. It doesn't expire: it is kept until the next
+    // fetched Jwks replaces it.
+    virtual void setFetchedJwks(JwksConstSharedPtr jwks) PURE;
+
+    // Return true if the token was verified with the current Jwks object. The verified tokens are
+    // only cached if the provider has a jwt_cache_config.
+    virtual bool isTokenVerified(const std::string& token) const PURE;
+
+    // Add a token verified with the current Jwks object, given its `exp` claim (0 if none).
+    virtual void addVerifiedToken(const std::string& token, uint64_t exp) PURE;
   };
 
   // Lookup issuer cache map. The cache only stores Jwks specified in the config.
@@ -66,6 +88,9 @@ public:
   // Lookup provider cache map.
   virtual JwksData* findByProvider(const std::string& provider) PURE;
 
+  // The default cache duration of a remote Jwks.
+  static constexpr std::chrono::seconds DefaultCacheDuration{600};
+
   // Factory function to create an instance.
   static JwksCachePtr
   create(const envoy::extensions::filters::http::jwt_authn::v3::JwtAuthentication& config,
@@ -82,6 +82,28 @@ int HeaderMapWrapper::luaReplace(lua_State* state) {
   return 0;
 }
 
+int HeaderMapWrapper::luaToTable(lua_State* state) {
+  lua_createtable(state, 0, headers_.size());
+  headers_.iterate([state](const Http::HeaderEntry& header) -> Http::HeaderMap::Iterate {
+    const absl::string_view key = header.key().getStringView();
+    const absl::string_view value = header.value().getStringView();
+    lua_pushlstring(state, key.data(), key.size());
+    lua_pushvalue(state, -1);
+    lua_rawget(state, -3);
+    if (lua_isnil(state, -1)) {
+      lua_pop(state, 1);
+      lua_pushlstring(state, value.data(), value.size());
+    } else {
+      lua_pushliteral(state, ",");
+      lua_pushlstring(state, value.data(), value.size());
+      lua_concat(state, 3);
+    }
+    lua_rawset(state, -3);
+    return Http::HeaderMap::Iterate::Continue;
+  });
+  return 1;
+}
+
 int HeaderMapWrapper::luaRemove(lua_State* state) {
   checkModifiable(state);
 
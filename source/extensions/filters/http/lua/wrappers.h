@@ -50,6 +50,7 @@ public:
             {"get", static_luaGet},
             {"remove", static_luaRemove},
             {"replace", static_luaReplace},
+            {"toTable", static_luaToTable},
             {"__pairs", static_luaPairs}};
   }
 
@@ -90,6 +91,13 @@ private:
    */
   DECLARE_LUA_FUNCTION(HeaderMapWrapper, luaReplace);
 
+  /**
+   * Get all the headers of the map at once, without the iterator that pairs() creates.
+   * @return table mapping each header name to its value. The values of a header that is repeated
+   *         are joined with ',', as by get().
+   */
+  DECLARE_LUA_FUNCTION(HeaderMapWrapper, luaToTable);
+
   void checkModifiable(lua_State* state);
 
   // Envoy::Lua::BaseLuaObject
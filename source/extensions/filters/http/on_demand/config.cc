@@ -10,11 +10,13 @@ namespace HttpFilters {
 namespace OnDemand {
 
 Http::FilterFactoryCb OnDemandFilterFactory::createFilterFactoryFromProtoTyped(
-    const envoy::extensions::filters::http::on_demand::v3::OnDemand&, const std::string&,
-    Server::Configuration::FactoryContext&) {
-  return [](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    const envoy::extensions::filters::http::on_demand::v3::OnDemand& proto_config,
+    const std::string&, Server::Configuration::FactoryContext& context) {
+  OnDemandFilterConfigSharedPtr config = std::make_shared<const OnDemandFilterConfig>(
+      proto_config, context.clusterManager(), context.messageValidationVisitor());
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
     callbacks.addStreamDecoderFilter(
-        std::make_shared<Extensions::HttpFilters::OnDemand::OnDemandRouteUpdate>());
+        std::make_shared<Extensions::HttpFilters::OnDemand::OnDemandRouteUpdate>(config));
   };
 }
 
@@ -4,16 +4,45 @@
 #include "common/common/enum_to_int.h"
 #include "common/common/logger.h"
 #include "common/http/codes.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace OnDemand {
 
-Http::FilterHeadersStatus OnDemandRouteUpdate::decodeHeaders(Http::RequestHeaderMap&, bool) {
+OnDemandFilterConfig::OnDemandFilterConfig(
+    const envoy::extensions::filters::http::on_demand::v3::OnDemand& proto_config,
+    Upstream::ClusterManager& cm, ProtobufMessage::ValidationVisitor& validation_visitor)
+    : odcds_timeout_(PROTOBUF_GET_MS_OR_DEFAULT(proto_config.odcds(), timeout, 5000)) {
+  if (proto_config.has_odcds()) {
+    const auto& odcds_config = proto_config.odcds();
+    odcds_ = cm.allocateOdCdsApi(
+        odcds_config.source(),
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(odcds_config, idle_timeout, 0)),
+        validation_visitor);
+  }
+}
 
-  if (callbacks_->route() != nullptr) {
+Http::FilterHeadersStatus OnDemandRouteUpdate::decodeHeaders(Http::RequestHeaderMap&, bool) {
+  Router::RouteConstSharedPtr route = callbacks_->route();
+  if (route != nullptr) {
     filter_iteration_state_ = Http::FilterHeadersStatus::Continue;
+    const Router::RouteEntry* entry = route->routeEntry();
+    if (config_->odcds() == nullptr || entry == nullptr || callbacks_->clusterInfo() != nullptr) {
+      return filter_iteration_state_;
+    }
+    // The route's cluster isn't known yet, it's discovered without blocking the worker.
+    decode_headers_active_ = true;
+    filter_iteration_state_ = Http::FilterHeadersStatus::StopIteration;
+    cluster_discovery_handle_ = config_->odcds()->requestOnDemandClusterDiscovery(
+        entry->clusterName(),
+        std::make_unique<Upstream::ClusterDiscoveryCallback>(
+            [this](Upstream::ClusterDiscoveryStatus cluster_status) {
+              onClusterDiscoveryCompletion(cluster_status);
+            }),
+        config_->odcdsTimeout());
+    decode_headers_active_ = false;
     return filter_iteration_state_;
   }
   // decodeHeaders() is interrupted.
@@ -45,7 +74,10 @@ void OnDemandRouteUpdate::setDecoderFilterCallbacks(Http::StreamDecoderFilterCal
 // A weak_ptr copy of the route_config_updated_callback_ is kept by RdsRouteConfigProviderImpl
 // in config_update_callbacks_. By resetting the pointer in onDestroy() callback we ensure
 // that this filter/filter-chain will not be resumed if the corresponding has been closed
-void OnDemandRouteUpdate::onDestroy() { route_config_updated_callback_.reset(); }
+void OnDemandRouteUpdate::onDestroy() {
+  route_config_updated_callback_.reset();
+  cluster_discovery_handle_.reset();
+}
 
 // This is the callback which is called when an update requested in requestRouteConfigUpdate()
 // has been propagated to workers, at which point the request processing is restarted from the
@@ -70,6 +102,30 @@ void OnDemandRouteUpdate::onRouteConfigUpdateCompletion(bool route_exists) {
   callbacks_->continueDecoding();
 }
 
+// This is the callback which is called when the cluster requested in decodeHeaders() is available
+// on this worker, or its discovery failed.
+void OnDemandRouteUpdate::onClusterDiscoveryCompletion(
+    Upstream::ClusterDiscoveryStatus cluster_status) {
+  filter_iteration_state_ = Http::FilterHeadersStatus::Continue;
+
+  // Don't call continueDecoding in the middle of decodeHeaders()
+  if (decode_headers_active_) {
+    return;
+  }
+
+  if (cluster_status == Upstream::ClusterDiscoveryStatus::Available) {
+    if (!callbacks_->decodingBuffer() && // Redirects with body not yet supported.
+        callbacks_->recreateStream(/*headers=*/nullptr)) {
+      return;
+    }
+    // The cached cluster info of the route is stale now.
+    callbacks_->clearRouteCache();
+  }
+
+  // If the cluster is still unknown, the router responds that there is no cluster.
+  callbacks_->continueDecoding();
+}
+
 } // namespace OnDemand
 } // namespace HttpFilters
 } // namespace Extensions
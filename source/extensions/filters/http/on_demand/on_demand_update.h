@@ -1,18 +1,46 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+
+#include "envoy/extensions/filters/http/on_demand/v3/on_demand.pb.h"
 #include "envoy/http/filter.h"
+#include "envoy/protobuf/message_validator.h"
+#include "envoy/upstream/cluster_manager.h"
 
 namespace Envoy {
 namespace Extensions {
 namespace HttpFilters {
 namespace OnDemand {
 
+/**
+ * Configuration of the on-demand filter.
+ */
+class OnDemandFilterConfig {
+public:
+  OnDemandFilterConfig(
+      const envoy::extensions::filters::http::on_demand::v3::OnDemand& proto_config,
+      Upstream::ClusterManager& cm, ProtobufMessage::ValidationVisitor& validation_visitor);
+
+  // The on-demand CDS provider, or nullptr if on-demand cluster discovery is disabled.
+  const Upstream::OdCdsApiHandleSharedPtr& odcds() const { return odcds_; }
+  std::chrono::milliseconds odcdsTimeout() const { return odcds_timeout_; }
+
+private:
+  Upstream::OdCdsApiHandleSharedPtr odcds_;
+  std::chrono::milliseconds odcds_timeout_;
+};
+
+using OnDemandFilterConfigSharedPtr = std::shared_ptr<const OnDemandFilterConfig>;
+
 class OnDemandRouteUpdate : public Http::StreamDecoderFilter {
 public:
-  OnDemandRouteUpdate() = default;
+  explicit OnDemandRouteUpdate(OnDemandFilterConfigSharedPtr config) : config_(std::move(config)) {}
 
   void onRouteConfigUpdateCompletion(bool route_exists);
 
+  void onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus cluster_status);
+
   void setFilterIterationState(Envoy::Http::FilterHeadersStatus status) {
     filter_iteration_state_ = status;
   }
@@ -30,8 +58,10 @@ public:
   void onDestroy() override;
 
 private:
+  const OnDemandFilterConfigSharedPtr config_;
   Http::StreamDecoderFilterCallbacks* callbacks_{};
   Http::RouteConfigUpdatedCallbackSharedPtr route_config_updated_callback_;
+  Upstream::ClusterDiscoveryCallbackHandlePtr cluster_discovery_handle_;
   Envoy::Http::FilterHeadersStatus filter_iteration_state_{Http::FilterHeadersStatus::Continue};
   bool decode_headers_active_{false};
 };
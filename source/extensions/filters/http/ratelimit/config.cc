@@ -22,11 +22,23 @@ Http::FilterFactoryCb RateLimitFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::http::ratelimit::v3::RateLimit& proto_config,
     const std::string&, Server::Configuration::FactoryContext& context) {
   ASSERT(!proto_config.domain().empty());
-  FilterConfigSharedPtr filter_config(new FilterConfig(proto_config, context.localInfo(),
-                                                       context.scope(), context.runtime(),
-                                                       context.httpContext()));
   const std::chrono::milliseconds timeout =
       std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(proto_config, timeout, 20));
+  QuotaLeasesPtr quota_leases;
+  if (proto_config.has_quota_lease()) {
+    quota_leases = std::make_unique<QuotaLeases>(
+        proto_config.quota_lease(), proto_config.domain(), context.threadLocal(),
+        context.timeSource(),
+        [&context, grpc_service = proto_config.rate_limit_service().grpc_service(), timeout,
+         transport_version =
+             Config::Utility::getAndCheckTransportVersion(proto_config.rate_limit_service())]() {
+          return Filters::Common::RateLimit::rateLimitClient(context, grpc_service, timeout,
+                                                             transport_version);
+        });
+  }
+  FilterConfigSharedPtr filter_config(
+      new FilterConfig(proto_config, context.localInfo(), context.scope(), context.runtime(),
+                       context.httpContext(), std::move(quota_leases)));
 
   return [proto_config, &context, timeout,
           transport_version =
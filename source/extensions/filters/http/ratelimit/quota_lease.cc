@@ -0,0 +1,137 @@
+#include "extensions/filters/http/ratelimit/quota_lease.h"
+
+#include "common/protobuf/utility.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+QuotaLeases::QuotaLeases(const envoy::extensions::filters::http::ratelimit::v3::QuotaLease& config,
+                         const std::string& domain, ThreadLocal::SlotAllocator& tls,
+                         TimeSource& time_source, ClientFactory client_factory)
+    : domain_(domain), hits_per_lease_(config.hits_per_lease()),
+      lease_duration_(DurationUtil::durationToMilliseconds(config.lease_duration())),
+      renewal_threshold_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, renewal_threshold, hits_per_lease_ / 4)),
+      time_source_(time_source), client_factory_(std::move(client_factory)), tls_(tls) {
+  tls_.set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalLeases>(); });
+}
+
+std::string QuotaLeases::key(const std::vector<Envoy::RateLimit::Descriptor>& descriptors) {
+  // The keys and values are prefixed by their length and every descriptor by its number of
+  // entries, so that no two different lists of descriptors have the same key.
+  std::string key;
+  for (const Envoy::RateLimit::Descriptor& descriptor : descriptors) {
+    absl::StrAppend(&key, descriptor.entries_.size(), ";");
+    for (const Envoy::RateLimit::DescriptorEntry& entry : descriptor.entries_) {
+      absl::StrAppend(&key, entry.key_.size(), ":", entry.key_, entry.value_.size(), ":",
+                      entry.value_);
+    }
+    if (descriptor.limit_.has_value()) {
+      absl::StrAppend(&key, "/", descriptor.limit_->requests_per_unit_, "/",
+                      descriptor.limit_->unit_);
+    }
+    absl::StrAppend(&key, ";");
+  }
+  return key;
+}
+
+bool QuotaLeases::tryTakeHit(const std::string& key) {
+  auto& leases = tls_->leases_;
+  auto it = leases.find(key);
+  if (it == leases.end()) {
+    return false;
+  }
+  if (it->second->tryTakeHit()) {
+    return true;
+  }
+  if (it->second->expired()) {
+    leases.erase(it);
+  }
+  return false;
+}
+
+void QuotaLeases::onLeaseResponse(const std::string& key,
+                                  const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                                  Filters::Common::RateLimit::LimitStatus status) {
+  if (status != Filters::Common::RateLimit::LimitStatus::OK) {
+    return;
+  }
+
+  auto& leases = tls_->leases_;
+  auto it = leases.find(key);
+  if (it == leases.end()) {
+    if (leases.size() >= MaxLeases) {
+      absl::erase_if(leases, [](const auto& lease) { return lease.second->expired(); });
+      if (leases.size() >= MaxLeases) {
+        return;
+      }
+    }
+    it = leases.emplace(key, std::make_unique<Lease>(*this, descriptors)).first;
+  }
+  // The request that asked for the lease took one of its hits.
+  it->second->grant(hits_per_lease_ - 1);
+}
+
+QuotaLeases::Lease::Lease(QuotaLeases& parent,
+                          const std::vector<Envoy::RateLimit::Descriptor>& descriptors)
+    : parent_(parent), descriptors_(descriptors), stream_info_(parent.time_source_, nullptr) {}
+
+QuotaLeases::Lease::~Lease() {
+  if (renewing_) {
+    client_->cancel();
+  }
+}
+
+void QuotaLeases::Lease::grant(uint32_t hits) {
+  // The hits left from an expired lease can't be used anymore.
+  remaining_ = expired() ? hits : remaining_ + hits;
+  expiry_ = parent_.time_source_.monotonicTime() + parent_.lease_duration_;
+  if (remaining_ > parent_.renewal_threshold_) {
+    renewal_done_ = false;
+  }
+}
+
+bool QuotaLeases::Lease::tryTakeHit() {
+  if (remaining_ == 0 || expired()) {
+    remaining_ = 0;
+    return false;
+  }
+  remaining_--;
+  if (remaining_ <= parent_.renewal_threshold_ && !renewal_done_ && !renewing_) {
+    renew();
+  }
+  return true;
+}
+
+void QuotaLeases::Lease::renew() {
+  if (client_ == nullptr) {
+    client_ = parent_.client_factory_();
+  }
+  renewing_ = true;
+  client_->limit(*this, parent_.domain_, descriptors_, Tracing::NullSpan::instance(),
+                 stream_info_, parent_.hits_per_lease_);
+}
+
+void QuotaLeases::Lease::complete(Filters::Common::RateLimit::LimitStatus status,
+                                  Filters::Common::RateLimit::DescriptorStatusListPtr&&,
+                                  Http::ResponseHeaderMapPtr&&, Http::RequestHeaderMapPtr&&,
+                                  const std::string&,
+                                  Filters::Common::RateLimit::DynamicMetadataPtr&&) {
+  renewing_ = false;
+  // A refused renewal isn't retried until the hits run out, at which point the requests call the
+  // service again.
+  renewal_done_ = true;
+  if (status == Filters::Common::RateLimit::LimitStatus::OK) {
+    grant(parent_.hits_per_lease_);
+  }
+}
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/extensions/filters/http/ratelimit/v3/rate_limit.pb.h"
+#include "envoy/ratelimit/ratelimit.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/stream_info/stream_info_impl.h"
+
+#include "extensions/filters/common/ratelimit/ratelimit.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace RateLimitFilter {
+
+/**
+ * The leases of hits from the rate limit service of each worker, by the descriptors of the
+ * requests they allow. The first request of a list of descriptors asks for a lease of
+ * hits_per_lease hits, and the next requests take the hits left in the lease without calling the
+ * service. The lease is renewed in the background before it runs out.
+ */
+class QuotaLeases {
+public:
+  using ClientFactory = std::function<Filters::Common::RateLimit::ClientPtr()>;
+
+  QuotaLeases(const envoy::extensions::filters::http::ratelimit::v3::QuotaLease& config,
+              const std::string& domain, ThreadLocal::SlotAllocator& tls, TimeSource& time_source,
+              ClientFactory client_factory);
+
+  /**
+   * @param descriptors supplies the descriptors of a request.
+   * @return the key of the lease of the descriptors.
+   */
+  static std::string key(const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+
+  /**
+   * Takes a hit from the lease of this worker for the key, and renews the lease if few hits are
+   * left.
+   * @param key supplies the key of the lease.
+   * @return whether the lease had a hit left, in which case the request is allowed.
+   */
+  bool tryTakeHit(const std::string& key);
+
+  /**
+   * Called with the answer of the rate limit service to a request sent with a hits_addend of
+   * hitsPerLease(), one hit of which was taken by the request itself.
+   * @param key supplies the key of the lease.
+   * @param descriptors supplies the descriptors of the request.
+   * @param status supplies the status returned by the service.
+   */
+  void onLeaseResponse(const std::string& key,
+                       const std::vector<Envoy::RateLimit::Descriptor>& descriptors,
+                       Filters::Common::RateLimit::LimitStatus status);
+
+  /**
+   * @return the number of hits of a lease.
+   */
+  uint32_t hitsPerLease() const { return hits_per_lease_; }
+
+  // The number of leases each worker keeps before dropping the expired ones.
+  static constexpr uint32_t MaxLeases = 10000;
+
+private:
+  class Lease : public Filters::Common::RateLimit::RequestCallbacks {
+  public:
+    Lease(QuotaLeases& parent, const std::vector<Envoy::RateLimit::Descriptor>& descriptors);
+    ~Lease() override;
+
+    // Adds the hits of a lease granted by the service.
+    void grant(uint32_t hits);
+    bool expired() const { return expiry_ <= parent_.time_source_.monotonicTime(); }
+    bool tryTakeHit();
+
+    // Filters::Common::RateLimit::RequestCallbacks
+    void complete(Filters::Common::RateLimit::LimitStatus status,
+                  Filters::Common::RateLimit::DescriptorStatusListPtr&& descriptor_statuses,
+                  Http::ResponseHeaderMapPtr&& response_headers_to_add,
+                  Http::RequestHeaderMapPtr&& request_headers_to_add,
+                  const std::string& response_body,
+                  Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) override;
+
+  private:
+    void renew();
+
+    QuotaLeases& parent_;
+    const std::vector<Envoy::RateLimit::Descriptor> descriptors_;
+    uint32_t remaining_{};
+    MonotonicTime expiry_;
+    // Whether the lease was renewed, or its renewal refused, since its hits fell to the renewal
+    // threshold.
+    bool renewal_done_{};
+    bool renewing_{};
+    Filters::Common::RateLimit::ClientPtr client_;
+    StreamInfo::StreamInfoImpl stream_info_;
+  };
+
+  struct ThreadLocalLeases : public ThreadLocal::ThreadLocalObject {
+    absl::flat_hash_map<std::string, std::unique_ptr<Lease>> leases_;
+  };
+
+  const std::string domain_;
+  const uint32_t hits_per_lease_;
+  const std::chrono::milliseconds lease_duration_;
+  const uint32_t renewal_threshold_;
+  TimeSource& time_source_;
+  const ClientFactory client_factory_;
+  ThreadLocal::TypedSlot<ThreadLocalLeases> tls_;
+};
+
+using QuotaLeasesPtr = std::unique_ptr<QuotaLeases>;
+
+} // namespace RateLimitFilter
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
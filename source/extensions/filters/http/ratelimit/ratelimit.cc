@@ -71,10 +71,24 @@ void Filter::initiateCall(const Http::RequestHeaderMap& headers) {
   }
 
   if (!descriptors.empty()) {
+    uint32_t hits_addend = 0;
+    QuotaLeases* quota_leases = config_->quotaLeases();
+    if (quota_leases != nullptr) {
+      std::string lease_key = QuotaLeases::key(descriptors);
+      if (quota_leases->tryTakeHit(lease_key)) {
+        cluster_->statsScope().counterFromStatName(config_->statNames().ok_).inc();
+        return;
+      }
+      // The request takes a hit from the new lease.
+      hits_addend = quota_leases->hitsPerLease();
+      lease_key_ = std::move(lease_key);
+      lease_descriptors_ = descriptors;
+    }
+
     state_ = State::Calling;
     initiating_call_ = true;
     client_->limit(*this, config_->domain(), descriptors, callbacks_->activeSpan(),
-                   callbacks_->streamInfo());
+                   callbacks_->streamInfo(), hits_addend);
     initiating_call_ = false;
   }
 }
@@ -147,6 +161,9 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
                       const std::string& response_body,
                       Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) {
   state_ = State::Complete;
+  if (lease_key_.has_value()) {
+    config_->quotaLeases()->onLeaseResponse(lease_key_.value(), lease_descriptors_, status);
+  }
   response_headers_to_add_ = std::move(response_headers_to_add);
   Http::HeaderMapPtr req_headers_to_add = std::move(request_headers_to_add);
   Stats::StatName empty_stat_name;
@@ -154,7 +171,7 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
 
   if (dynamic_metadata != nullptr && !dynamic_metadata->fields().empty()) {
     callbacks_->streamInfo().setDynamicMetadata(HttpFilterNames::get().RateLimit,
-                                                *dynamic_metadata);
+                                                std::move(*dynamic_metadata));
   }
 
   switch (status) {
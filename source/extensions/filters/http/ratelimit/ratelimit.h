@@ -19,6 +19,7 @@
 
 #include "extensions/filters/common/ratelimit/ratelimit.h"
 #include "extensions/filters/common/ratelimit/stat_names.h"
+#include "extensions/filters/http/ratelimit/quota_lease.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -42,7 +43,8 @@ class FilterConfig {
 public:
   FilterConfig(const envoy::extensions::filters::http::ratelimit::v3::RateLimit& config,
                const LocalInfo::LocalInfo& local_info, Stats::Scope& scope,
-               Runtime::Loader& runtime, Http::Context& http_context)
+               Runtime::Loader& runtime, Http::Context& http_context,
+               QuotaLeasesPtr&& quota_leases = nullptr)
       : domain_(config.domain()), stage_(static_cast<uint64_t>(config.stage())),
         request_type_(config.request_type().empty() ? stringToType("both")
                                                     : stringToType(config.request_type())),
@@ -56,7 +58,8 @@ public:
             config.rate_limited_as_resource_exhausted()
                 ? absl::make_optional(Grpc::Status::WellKnownGrpcStatus::ResourceExhausted)
                 : absl::nullopt),
-        http_context_(http_context), stat_names_(scope.symbolTable()) {}
+        http_context_(http_context), stat_names_(scope.symbolTable()),
+        quota_leases_(std::move(quota_leases)) {}
   const std::string& domain() const { return domain_; }
   const LocalInfo::LocalInfo& localInfo() const { return local_info_; }
   uint64_t stage() const { return stage_; }
@@ -71,6 +74,8 @@ public:
   }
   Http::Context& httpContext() { return http_context_; }
   Filters::Common::RateLimit::StatNames& statNames() { return stat_names_; }
+  // The leases of hits from the rate limit service, or nullptr if they aren't configured.
+  QuotaLeases* quotaLeases() { return quota_leases_.get(); }
 
 private:
   static FilterRequestType stringToType(const std::string& request_type) {
@@ -96,6 +101,7 @@ private:
   const absl::optional<Grpc::Status::GrpcStatus> rate_limited_grpc_status_;
   Http::Context& http_context_;
   Filters::Common::RateLimit::StatNames stat_names_;
+  const QuotaLeasesPtr quota_leases_;
 };
 
 using FilterConfigSharedPtr = std::shared_ptr<FilterConfig>;
@@ -174,6 +180,9 @@ private:
   bool initiating_call_{};
   Http::ResponseHeaderMapPtr response_headers_to_add_;
   Http::RequestHeaderMap* request_headers_{};
+  // Set while asking for a lease of hits.
+  absl::optional<std::string> lease_key_;
+  std::vector<Envoy::RateLimit::Descriptor> lease_descriptors_;
 };
 
 } // namespace RateLimitFilter
@@ -97,7 +97,7 @@ RoleBasedAccessControlFilter::decodeHeaders(Http::RequestHeaderMap& headers, boo
     }
 
     *fields[config_->shadowEngineResultField()].mutable_string_value() = shadow_resp_code;
-    callbacks_->streamInfo().setDynamicMetadata(HttpFilterNames::get().Rbac, metrics);
+    callbacks_->streamInfo().setDynamicMetadata(HttpFilterNames::get().Rbac, std::move(metrics));
   }
 
   const auto engine =
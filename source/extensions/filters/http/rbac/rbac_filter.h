@@ -100,6 +100,7 @@ public:
 
   // Http::StreamFilterBase
   void onDestroy() override {}
+  bool needsTunnelData() const override { return false; }
 
 private:
   RoleBasedAccessControlFilterConfigSharedPtr config_;
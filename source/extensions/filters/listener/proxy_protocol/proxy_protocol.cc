@@ -304,9 +304,10 @@ ReadOrParseState Filter::parseExtensions(Network::IoHandle& io_handle, uint8_t*
   // If we ever implement extensions elsewhere, be sure to
   // continue to skip and ignore those for LOCAL.
   while (proxy_protocol_header_.value().extensions_length_) {
-    int to_read = std::min(buf_size, proxy_protocol_header_.value().extensions_length_);
-    buf += (nullptr != buf_off) ? *buf_off : 0;
-    const auto recv_result = io_handle.recv(buf, to_read, 0);
+    int to_read = std::min(buf_size - ((nullptr != buf_off) ? *buf_off : 0),
+                           proxy_protocol_header_.value().extensions_length_);
+    const auto recv_result =
+        io_handle.recv(buf + ((nullptr != buf_off) ? *buf_off : 0), to_read, 0);
     if (!recv_result.ok()) {
       if (recv_result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
         return ReadOrParseState::TryAgainLater;
@@ -417,6 +418,33 @@ ReadOrParseState Filter::readExtensions(Network::IoHandle& io_handle) {
   return ReadOrParseState::Done;
 }
 
+ReadOrParseState Filter::consumeV2Header(Network::IoHandle& io_handle, size_t missing) {
+  WireHeader& header = proxy_protocol_header_.value();
+  const size_t header_len = buf_off_ + missing;
+  Buffer::RawSlice slices[2] = {{buf_ + buf_off_, missing}, {nullptr, 0}};
+  if (header.local_command_ || 0 == config_->numberOfNeededTlvTypes()) {
+    // The TLVs are discarded, the end of buf_ is enough to read those that already arrived.
+    slices[1] = {buf_ + header_len, std::min(header.extensions_length_, sizeof(buf_) - header_len)};
+  } else {
+    buf_tlv_.resize(header.extensions_length_);
+    slices[1] = {buf_tlv_.data(), buf_tlv_.size()};
+  }
+
+  const uint64_t num_slices = slices[1].len_ > 0 ? 2 : 1;
+  const auto result = io_handle.readv(missing + slices[1].len_, slices, num_slices);
+  if (!result.ok() || result.rc_ < missing) {
+    ENVOY_LOG(debug, "failed to read proxy protocol (remote closed)");
+    return ReadOrParseState::Error;
+  }
+  buf_off_ += missing;
+  const size_t extensions_read = result.rc_ - missing;
+  header.extensions_length_ -= extensions_read;
+  if (!buf_tlv_.empty()) {
+    buf_tlv_off_ += extensions_read;
+  }
+  return ReadOrParseState::Done;
+}
+
 ReadOrParseState Filter::readProxyHeader(Network::IoHandle& io_handle) {
   while (buf_off_ < MAX_PROXY_PROTO_LEN_V2) {
     const auto result =
@@ -453,16 +481,6 @@ ReadOrParseState Filter::readProxyHeader(Network::IoHandle& io_handle) {
         ENVOY_LOG(debug, "Unsupported V2 proxy protocol version");
         return ReadOrParseState::Error;
       }
-      if (buf_off_ < PROXY_PROTO_V2_HEADER_LEN) {
-        ssize_t exp = PROXY_PROTO_V2_HEADER_LEN - buf_off_;
-        const auto read_result = io_handle.recv(buf_ + buf_off_, exp, 0);
-        if (!result.ok() || read_result.rc_ != uint64_t(exp)) {
-          ENVOY_LOG(debug, "failed to read proxy protocol (remote closed)");
-          return ReadOrParseState::Error;
-        }
-        buf_off_ += read_result.rc_;
-        nread -= read_result.rc_;
-      }
       absl::optional<ssize_t> addr_len_opt = lenV2Address(buf_);
       if (!addr_len_opt.has_value()) {
         return ReadOrParseState::Error;
@@ -475,21 +493,25 @@ ReadOrParseState Filter::readProxyHeader(Network::IoHandle& io_handle) {
         ENVOY_LOG(debug, "failed to read proxy protocol (insufficient data)");
         return ReadOrParseState::Error;
       }
-      if (ssize_t(buf_off_) + nread >= PROXY_PROTO_V2_HEADER_LEN + addr_len) {
-        ssize_t missing = (PROXY_PROTO_V2_HEADER_LEN + addr_len) - buf_off_;
-        const auto read_result = io_handle.recv(buf_ + buf_off_, missing, 0);
-        if (!result.ok() || read_result.rc_ != uint64_t(missing)) {
+      if (buf_off_ < PROXY_PROTO_V2_HEADER_LEN &&
+          ssize_t(buf_off_) + nread < PROXY_PROTO_V2_HEADER_LEN + addr_len) {
+        ssize_t exp = PROXY_PROTO_V2_HEADER_LEN - buf_off_;
+        const auto read_result = io_handle.recv(buf_ + buf_off_, exp, 0);
+        if (!result.ok() || read_result.rc_ != uint64_t(exp)) {
           ENVOY_LOG(debug, "failed to read proxy protocol (remote closed)");
           return ReadOrParseState::Error;
         }
         buf_off_ += read_result.rc_;
-        // The TLV remain, they are read/discard in parseExtensions() which is called from the
-        // parent (if needed).
-        if (parseV2Header(buf_)) {
-          return ReadOrParseState::Done;
-        } else {
+        nread -= read_result.rc_;
+      }
+      if (ssize_t(buf_off_) + nread >= PROXY_PROTO_V2_HEADER_LEN + addr_len) {
+        // The whole header was peeked, so it is parsed from buf_ and consumed along with the TLVs
+        // already received in a single syscall. The TLV that remain are read/discard in
+        // parseExtensions() which is called from the parent (if needed).
+        if (!parseV2Header(buf_)) {
           return ReadOrParseState::Error;
         }
+        return consumeV2Header(io_handle, (PROXY_PROTO_V2_HEADER_LEN + addr_len) - buf_off_);
       } else {
         const auto result = io_handle.recv(buf_ + buf_off_, nread, 0);
         nread = result.rc_;
@@ -103,6 +103,13 @@ private:
    */
   ReadOrParseState readProxyHeader(Network::IoHandle& io_handle);
 
+  /**
+   * Consumes the rest of a peeked and parsed V2 header, along with the TLVs that already arrived,
+   * with a single syscall.
+   * @param missing supplies the number of bytes of the header that are still to be consumed.
+   */
+  ReadOrParseState consumeV2Header(Network::IoHandle& io_handle, size_t missing);
+
   /**
    * Parse (and discard unknown) header extensions (until hdr.extensions_length == 0)
    */
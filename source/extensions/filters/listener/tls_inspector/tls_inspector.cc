@@ -12,6 +12,7 @@
 
 #include "common/api/os_sys_calls_impl.h"
 #include "common/common/assert.h"
+#include "common/runtime/runtime_features.h"
 
 #include "extensions/transport_sockets/well_known_names.h"
 
@@ -30,7 +31,9 @@ const unsigned Config::TLS_MAX_SUPPORTED_VERSION = TLS1_3_VERSION;
 Config::Config(Stats::Scope& scope, uint32_t max_client_hello_size)
     : stats_{ALL_TLS_INSPECTOR_STATS(POOL_COUNTER_PREFIX(scope, "tls_inspector."))},
       ssl_ctx_(SSL_CTX_new(TLS_with_buffers_method())),
-      max_client_hello_size_(max_client_hello_size) {
+      max_client_hello_size_(max_client_hello_size),
+      client_hello_parser_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.tls_inspector_client_hello_parser")) {
 
   if (max_client_hello_size_ > TLS_MAX_CLIENT_HELLO) {
     throw EnvoyException(fmt::format("max_client_hello_size of {} is greater than maximum of {}.",
@@ -68,9 +71,15 @@ bssl::UniquePtr<SSL> Config::newSsl() { return bssl::UniquePtr<SSL>{SSL_new(ssl_
 
 thread_local uint8_t Filter::buf_[Config::TLS_MAX_CLIENT_HELLO];
 
-Filter::Filter(const ConfigSharedPtr config) : config_(config), ssl_(config_->newSsl()) {
+Filter::Filter(const ConfigSharedPtr config) : config_(config) {
   RELEASE_ASSERT(sizeof(buf_) >= config_->maxClientHelloSize(), "");
+  if (!config_->clientHelloParser()) {
+    initializeSsl();
+  }
+}
 
+void Filter::initializeSsl() {
+  ssl_ = config_->newSsl();
   SSL_set_app_data(ssl_.get(), this);
   SSL_set_accept_state(ssl_.get());
 }
@@ -180,21 +189,192 @@ ParseState Filter::onRead() {
 
   // Because we're doing a MSG_PEEK, data we've seen before gets returned every time, so
   // skip over what we've already processed.
-  if (static_cast<uint64_t>(result.rc_) > read_) {
-    const uint8_t* data = buf_ + read_;
-    const size_t len = result.rc_ - read_;
+  if (static_cast<uint64_t>(result.rc_) <= read_) {
+    return ParseState::Continue;
+  }
+
+  if (ssl_ == nullptr) {
+    // The ClientHello is parsed again from its start as more of it is received, which is cheaper
+    // than creating an SSL for each connection.
     read_ = result.rc_;
-    return parseClientHello(data, len);
+    const absl::optional<ParseState> parse_state = parseClientHelloFast(buf_, read_);
+    if (parse_state.has_value()) {
+      return parse_state.value();
+    }
+    ENVOY_LOG(trace, "tls inspector: falling back to BoringSSL");
+    initializeSsl();
+    read_ = 0;
+  }
+
+  const uint8_t* data = buf_ + read_;
+  const size_t len = result.rc_ - read_;
+  read_ = result.rc_;
+  return parseClientHello(data, len);
+}
+
+ParseState Filter::onNeedMoreData() {
+  if (read_ == config_->maxClientHelloSize()) {
+    // We've hit the specified size limit. This is an unreasonably large ClientHello;
+    // indicate failure.
+    config_->stats().client_hello_too_large_.inc();
+    return ParseState::Error;
   }
   return ParseState::Continue;
 }
 
+void Filter::onClientHelloParsed() {
+  config_->stats().tls_found_.inc();
+  if (alpn_found_) {
+    config_->stats().alpn_found_.inc();
+  } else {
+    config_->stats().alpn_not_found_.inc();
+  }
+  cb_->socket().setDetectedTransportProtocol(TransportSockets::TransportProtocolNames::get().Tls);
+}
+
 void Filter::done(bool success) {
   ENVOY_LOG(trace, "tls inspector: done: {}", success);
   cb_->socket().ioHandle().resetFileEvents();
   cb_->continueFilterChain(success);
 }
 
+absl::optional<ParseState> Filter::parseClientHelloFast(const uint8_t* data, size_t len) {
+  if (len < SSL3_RT_HEADER_LENGTH) {
+    return onNeedMoreData();
+  }
+
+  CBS input;
+  CBS_init(&input, data, len);
+  uint8_t content_type;
+  uint16_t record_version;
+  uint16_t record_length;
+  CBS_get_u8(&input, &content_type);
+  CBS_get_u16(&input, &record_version);
+  CBS_get_u16(&input, &record_length);
+  if (content_type != SSL3_RT_HANDSHAKE) {
+    if (content_type & 0x80) {
+      // Possibly a V2ClientHello.
+      return absl::nullopt;
+    }
+    config_->stats().tls_not_found_.inc();
+    return ParseState::Done;
+  }
+  if ((record_version >> 8) != SSL3_VERSION_MAJOR || record_length > SSL3_RT_MAX_PLAIN_LENGTH) {
+    return absl::nullopt;
+  }
+
+  CBS record;
+  if (!CBS_get_bytes(&input, &record, record_length)) {
+    return onNeedMoreData();
+  }
+
+  // The ClientHello must be the only message of the record: the fragmented ones are left to
+  // BoringSSL.
+  uint8_t message_type;
+  uint32_t message_length;
+  CBS client_hello;
+  if (!CBS_get_u8(&record, &message_type) || message_type != SSL3_MT_CLIENT_HELLO ||
+      !CBS_get_u24(&record, &message_length) ||
+      !CBS_get_bytes(&record, &client_hello, message_length) || CBS_len(&record) != 0) {
+    return absl::nullopt;
+  }
+
+  uint16_t client_version;
+  CBS random, session_id, cipher_suites, compression_methods;
+  if (!CBS_get_u16(&client_hello, &client_version) ||
+      !CBS_get_bytes(&client_hello, &random, SSL3_RANDOM_SIZE) ||
+      !CBS_get_u8_length_prefixed(&client_hello, &session_id) ||
+      CBS_len(&session_id) > SSL_MAX_SSL_SESSION_ID_LENGTH ||
+      !CBS_get_u16_length_prefixed(&client_hello, &cipher_suites) ||
+      !CBS_get_u8_length_prefixed(&client_hello, &compression_methods) ||
+      client_version < Config::TLS_MIN_SUPPORTED_VERSION) {
+    return absl::nullopt;
+  }
+
+  // The extensions are optional.
+  CBS extensions;
+  CBS_init(&extensions, nullptr, 0);
+  if (CBS_len(&client_hello) != 0 &&
+      (!CBS_get_u16_length_prefixed(&client_hello, &extensions) || CBS_len(&client_hello) != 0)) {
+    return absl::nullopt;
+  }
+
+  // Only the extensions needed here are checked, the others are left to the TLS stack of the
+  // connection.
+  struct Extension {
+    bool found_{false};
+    CBS contents_;
+  };
+  Extension server_name, alpn, supported_versions;
+  while (CBS_len(&extensions) != 0) {
+    uint16_t type;
+    CBS contents;
+    if (!CBS_get_u16(&extensions, &type) ||
+        !CBS_get_u16_length_prefixed(&extensions, &contents)) {
+      return absl::nullopt;
+    }
+    Extension* extension = nullptr;
+    if (type == TLSEXT_TYPE_server_name) {
+      extension = &server_name;
+    } else if (type == TLSEXT_TYPE_application_layer_protocol_negotiation) {
+      extension = &alpn;
+    } else if (type == TLSEXT_TYPE_supported_versions) {
+      extension = &supported_versions;
+    }
+    if (extension != nullptr) {
+      if (extension->found_) {
+        return absl::nullopt;
+      }
+      extension->found_ = true;
+      extension->contents_ = contents;
+    }
+  }
+
+  if (supported_versions.found_) {
+    CBS versions;
+    bool supported = false;
+    if (!CBS_get_u8_length_prefixed(&supported_versions.contents_, &versions) ||
+        CBS_len(&supported_versions.contents_) != 0 || CBS_len(&versions) == 0) {
+      return absl::nullopt;
+    }
+    while (CBS_len(&versions) != 0) {
+      uint16_t version;
+      if (!CBS_get_u16(&versions, &version)) {
+        return absl::nullopt;
+      }
+      supported |= version >= Config::TLS_MIN_SUPPORTED_VERSION &&
+                   version <= Config::TLS_MAX_SUPPORTED_VERSION;
+    }
+    if (!supported) {
+      return absl::nullopt;
+    }
+  }
+
+  // The server names BoringSSL rejects are left to it.
+  absl::string_view name;
+  if (server_name.found_) {
+    CBS server_name_list, host_name;
+    uint8_t name_type;
+    if (!CBS_get_u16_length_prefixed(&server_name.contents_, &server_name_list) ||
+        !CBS_get_u8(&server_name_list, &name_type) || name_type != TLSEXT_NAMETYPE_host_name ||
+        !CBS_get_u16_length_prefixed(&server_name_list, &host_name) ||
+        CBS_len(&server_name_list) != 0 || CBS_len(&server_name.contents_) != 0 ||
+        CBS_len(&host_name) == 0 || CBS_len(&host_name) > TLSEXT_MAXLEN_host_name ||
+        CBS_contains_zero_byte(&host_name)) {
+      return absl::nullopt;
+    }
+    name = absl::string_view(reinterpret_cast<const char*>(CBS_data(&host_name)),
+                             CBS_len(&host_name));
+  }
+
+  if (alpn.found_) {
+    onALPN(CBS_data(&alpn.contents_), CBS_len(&alpn.contents_));
+  }
+  onServername(name);
+  onClientHelloParsed();
+  return ParseState::Done;
+}
+
 ParseState Filter::parseClientHello(const void* data, size_t len) {
   // Ownership is passed to ssl_ in SSL_set_bio()
   bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(data, len));
@@ -212,23 +392,10 @@ ParseState Filter::parseClientHello(const void* data, size_t len) {
   ASSERT(ret <= 0);
   switch (SSL_get_error(ssl_.get(), ret)) {
   case SSL_ERROR_WANT_READ:
-    if (read_ == config_->maxClientHelloSize()) {
-      // We've hit the specified size limit. This is an unreasonably large ClientHello;
-      // indicate failure.
-      config_->stats().client_hello_too_large_.inc();
-      return ParseState::Error;
-    }
-    return ParseState::Continue;
+    return onNeedMoreData();
   case SSL_ERROR_SSL:
     if (clienthello_success_) {
-      config_->stats().tls_found_.inc();
-      if (alpn_found_) {
-        config_->stats().alpn_found_.inc();
-      } else {
-        config_->stats().alpn_not_found_.inc();
-      }
-      cb_->socket().setDetectedTransportProtocol(
-          TransportSockets::TransportProtocolNames::get().Tls);
+      onClientHelloParsed();
     } else {
       config_->stats().tls_not_found_.inc();
     }
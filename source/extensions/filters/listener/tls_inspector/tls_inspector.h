@@ -8,6 +8,7 @@
 
 #include "common/common/logger.h"
 
+#include "absl/types/optional.h"
 #include "openssl/ssl.h"
 
 namespace Envoy {
@@ -54,6 +55,7 @@ public:
   const TlsInspectorStats& stats() const { return stats_; }
   bssl::UniquePtr<SSL> newSsl();
   uint32_t maxClientHelloSize() const { return max_client_hello_size_; }
+  bool clientHelloParser() const { return client_hello_parser_; }
 
   static constexpr size_t TLS_MAX_CLIENT_HELLO = 64 * 1024;
   static const unsigned TLS_MIN_SUPPORTED_VERSION;
@@ -63,6 +65,7 @@ private:
   TlsInspectorStats stats_;
   bssl::UniquePtr<SSL_CTX> ssl_ctx_;
   const uint32_t max_client_hello_size_;
+  const bool client_hello_parser_;
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
@@ -78,8 +81,14 @@ public:
   Network::FilterStatus onAccept(Network::ListenerFilterCallbacks& cb) override;
 
 private:
+  // Parses a ClientHello that fits in a single record, directly from the peeked data. Returns
+  // absl::nullopt on anything unusual, which is then left to BoringSSL.
+  absl::optional<ParseState> parseClientHelloFast(const uint8_t* data, size_t len);
   ParseState parseClientHello(const void* data, size_t len);
   ParseState onRead();
+  ParseState onNeedMoreData();
+  void onClientHelloParsed();
+  void initializeSsl();
   void done(bool success);
   void onALPN(const unsigned char* data, unsigned int len);
   void onServername(absl::string_view name);
@@ -87,6 +96,7 @@ private:
   ConfigSharedPtr config_;
   Network::ListenerFilterCallbacks* cb_;
 
+  // Only created if the ClientHello is left to BoringSSL.
   bssl::UniquePtr<SSL> ssl_;
   uint64_t read_{0};
   bool alpn_found_{false};
@@ -56,6 +56,21 @@ public:
                              bool ask_redirection) PURE;
 };
 
+/**
+ * Callbacks for the values that a redis server sends without a request, such as the messages of
+ * the channels that a client has subscribed to.
+ */
+class PushCallbacks {
+public:
+  virtual ~PushCallbacks() = default;
+
+  /**
+   * Called when a value is received while no request is pending.
+   * @param value supplies the value which is now owned by the callee.
+   */
+  virtual void onPush(RespValuePtr&& value) PURE;
+};
+
 /**
  * DoNothingPoolCallbacks is used for internally generated commands whose response is
  * transparently filtered, and redirection never occurs (e.g., "asking", "auth", etc.).
@@ -107,6 +122,13 @@ public:
    * @param auth password for upstream host.
    */
   virtual void initialize(const std::string& auth_username, const std::string& auth_password) PURE;
+
+  /**
+   * Sets the callbacks for the values the server sends while no request is pending. Without
+   * them, such a value is a protocol error that closes the connection.
+   * @param callbacks supplies the callbacks.
+   */
+  virtual void setPushCallbacks(PushCallbacks& callbacks) PURE;
 };
 
 using ClientPtr = std::unique_ptr<Client>;
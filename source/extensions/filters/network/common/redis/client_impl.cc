@@ -204,7 +204,14 @@ void ClientImpl::onEvent(Network::ConnectionEvent event) {
 }
 
 void ClientImpl::onRespValue(RespValuePtr&& value) {
-  ASSERT(!pending_requests_.empty());
+  if (pending_requests_.empty()) {
+    if (push_callbacks_ == nullptr) {
+      throw ProtocolError("unexpected value");
+    }
+    push_callbacks_->onPush(std::move(value));
+    return;
+  }
+
   PendingRequest& request = pending_requests_.front();
   const bool canceled = request.canceled_;
 
@@ -275,6 +282,7 @@ ClientImpl::PendingRequest::PendingRequest(ClientImpl& parent, ClientCallbacks&
   parent.host_->stats().rq_total_.inc();
   parent.host_->cluster().stats().upstream_rq_active_.inc();
   parent.host_->stats().rq_active_.inc();
+  parent.host_->cluster().loadReportHosts().add(parent.host_);
 }
 
 ClientImpl::PendingRequest::~PendingRequest() {
@@ -89,6 +89,7 @@ public:
   bool active() override { return !pending_requests_.empty(); }
   void flushBufferAndResetTimer();
   void initialize(const std::string& auth_username, const std::string& auth_password) override;
+  void setPushCallbacks(PushCallbacks& callbacks) override { push_callbacks_ = &callbacks; }
 
 private:
   friend class RedisClientImplTest;
@@ -138,6 +139,7 @@ private:
   Buffer::OwnedImpl encoder_buffer_;
   DecoderPtr decoder_;
   const Config& config_;
+  PushCallbacks* push_callbacks_{};
   std::list<PendingRequest> pending_requests_;
   Event::TimerPtr connect_or_op_timer_;
   bool connected_{};
@@ -1,6 +1,7 @@
 #include "extensions/filters/network/common/redis/codec_impl.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -347,7 +348,7 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
     case State::ValueRootStart: {
       ENVOY_LOG(trace, "parse slice: ValueRootStart");
       pending_value_root_ = std::make_unique<RespValue>();
-      pending_value_stack_.push_front({pending_value_root_.get(), 0});
+      pending_value_stack_.push_back({pending_value_root_.get(), 0});
       state_ = State::ValueStart;
       break;
     }
@@ -358,27 +359,27 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       switch (buffer[0]) {
       case '*': {
         state_ = State::IntegerStart;
-        pending_value_stack_.front().value_->type(RespType::Array);
+        pending_value_stack_.back().value_->type(RespType::Array);
         break;
       }
       case '$': {
         state_ = State::IntegerStart;
-        pending_value_stack_.front().value_->type(RespType::BulkString);
+        pending_value_stack_.back().value_->type(RespType::BulkString);
         break;
       }
       case '-': {
         state_ = State::SimpleString;
-        pending_value_stack_.front().value_->type(RespType::Error);
+        pending_value_stack_.back().value_->type(RespType::Error);
         break;
       }
       case '+': {
         state_ = State::SimpleString;
-        pending_value_stack_.front().value_->type(RespType::SimpleString);
+        pending_value_stack_.back().value_->type(RespType::SimpleString);
         break;
       }
       case ':': {
         state_ = State::IntegerStart;
-        pending_value_stack_.front().value_->type(RespType::Integer);
+        pending_value_stack_.back().value_->type(RespType::Integer);
         break;
       }
       default: {
@@ -430,7 +431,7 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       remaining--;
       buffer++;
 
-      PendingValue& current_value = pending_value_stack_.front();
+      PendingValue& current_value = pending_value_stack_.back();
       if (current_value.value_->type() == RespType::Array) {
         if (pending_integer_.negative_) {
           // Null array. Convert to null.
@@ -441,7 +442,7 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
         } else {
           std::vector<RespValue> values(pending_integer_.integer_);
           current_value.value_->asArray().swap(values);
-          pending_value_stack_.push_front({&current_value.value_->asArray()[0], 0});
+          pending_value_stack_.push_back({&current_value.value_->asArray()[0], 0});
           state_ = State::ValueStart;
         }
       } else if (current_value.value_->type() == RespType::Integer) {
@@ -458,7 +459,10 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       } else {
         ASSERT(current_value.value_->type() == RespType::BulkString);
         if (!pending_integer_.negative_) {
-          // TODO(mattklein123): reserve and define max length since we don't stream currently.
+          // Reserve the body up front so that a body split across slices is only copied once. The
+          // reservation is bounded, as the length is supplied by the peer.
+          current_value.value_->asString().reserve(
+              std::min(pending_integer_.integer_, MaxBulkStringReserve));
           state_ = State::BulkStringBody;
         } else {
           // Null bulk string. Switch type to null and move to value complete.
@@ -474,14 +478,14 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
       ASSERT(!pending_integer_.negative_);
       uint64_t length_to_copy =
           std::min(static_cast<uint64_t>(pending_integer_.integer_), remaining);
-      pending_value_stack_.front().value_->asString().append(buffer, length_to_copy);
+      pending_value_stack_.back().value_->asString().append(buffer, length_to_copy);
       pending_integer_.integer_ -= length_to_copy;
       remaining -= length_to_copy;
       buffer += length_to_copy;
 
       if (pending_integer_.integer_ == 0) {
         ENVOY_LOG(trace, "parse slice: BulkStringBody complete: {}",
-                  pending_value_stack_.front().value_->asString());
+                  pending_value_stack_.back().value_->asString());
         state_ = State::CR;
       }
 
@@ -514,30 +518,34 @@ void DecoderImpl::parseSlice(const Buffer::RawSlice& slice) {
 
     case State::SimpleString: {
       ENVOY_LOG(trace, "parse slice: SimpleString: {}", buffer[0]);
-      if (buffer[0] == '\r') {
+      // Copy everything up to the carriage return at once rather than a character at a time.
+      const char* cr = static_cast<const char*>(memchr(buffer, '\r', remaining));
+      const uint64_t length_to_copy = cr == nullptr ? remaining : cr - buffer;
+      pending_value_stack_.back().value_->asString().append(buffer, length_to_copy);
+      remaining -= length_to_copy;
+      buffer += length_to_copy;
+
+      if (cr != nullptr) {
         state_ = State::LF;
-      } else {
-        pending_value_stack_.front().value_->asString().push_back(buffer[0]);
+        remaining--;
+        buffer++;
       }
-
-      remaining--;
-      buffer++;
       break;
     }
 
     case State::ValueComplete: {
       ENVOY_LOG(trace, "parse slice: ValueComplete");
       ASSERT(!pending_value_stack_.empty());
-      pending_value_stack_.pop_front();
+      pending_value_stack_.pop_back();
       if (pending_value_stack_.empty()) {
         callbacks_.onRespValue(std::move(pending_value_root_));
         state_ = State::ValueRootStart;
       } else {
-        PendingValue& current_value = pending_value_stack_.front();
+        PendingValue& current_value = pending_value_stack_.back();
         ASSERT(current_value.value_->type() == RespType::Array);
         if (current_value.current_array_element_ < current_value.value_->asArray().size() - 1) {
           current_value.current_array_element_++;
-          pending_value_stack_.push_front(
+          pending_value_stack_.push_back(
               {&current_value.value_->asArray()[current_value.current_array_element_], 0});
           state_ = State::ValueStart;
         }
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstdint>
-#include <forward_list>
 #include <string>
 #include <vector>
 
@@ -41,6 +40,9 @@ private:
     ValueComplete
   };
 
+  // The most that is reserved for the body of a bulk string before it is received.
+  static constexpr uint64_t MaxBulkStringReserve = 64 * 1024;
+
   struct PendingInteger {
     void reset() {
       integer_ = 0;
@@ -62,7 +64,9 @@ private:
   State state_{State::ValueRootStart};
   PendingInteger pending_integer_;
   RespValuePtr pending_value_root_;
-  std::forward_list<PendingValue> pending_value_stack_;
+  // The values being decoded, innermost last. Kept as a vector so that its storage is reused by
+  // the values that follow on the connection.
+  std::vector<PendingValue> pending_value_stack_;
 };
 
 /**
@@ -2,6 +2,8 @@
 
 #include "common/common/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -83,6 +85,52 @@ const SetRequest& SetRequest::instance() {
   static const SetRequest* instance = new SetRequest{};
   return *instance;
 }
+
+ClientIdRequest::ClientIdRequest() {
+  std::vector<RespValue> values(2);
+  values[0].type(RespType::BulkString);
+  values[0].asString() = "client";
+  values[1].type(RespType::BulkString);
+  values[1].asString() = "id";
+  type(RespType::Array);
+  asArray().swap(values);
+}
+
+const ClientIdRequest& ClientIdRequest::instance() {
+  static const ClientIdRequest* instance = new ClientIdRequest{};
+  return *instance;
+}
+
+SubscribeInvalidationsRequest::SubscribeInvalidationsRequest() {
+  std::vector<RespValue> values(2);
+  values[0].type(RespType::BulkString);
+  values[0].asString() = "subscribe";
+  values[1].type(RespType::BulkString);
+  values[1].asString() = std::string(InvalidationsChannel);
+  type(RespType::Array);
+  asArray().swap(values);
+}
+
+const SubscribeInvalidationsRequest& SubscribeInvalidationsRequest::instance() {
+  static const SubscribeInvalidationsRequest* instance = new SubscribeInvalidationsRequest{};
+  return *instance;
+}
+
+ClientTrackingRequest::ClientTrackingRequest(int64_t redirect_client_id) {
+  std::vector<RespValue> values(5);
+  values[0].type(RespType::BulkString);
+  values[0].asString() = "client";
+  values[1].type(RespType::BulkString);
+  values[1].asString() = "tracking";
+  values[2].type(RespType::BulkString);
+  values[2].asString() = "on";
+  values[3].type(RespType::BulkString);
+  values[3].asString() = "redirect";
+  values[4].type(RespType::BulkString);
+  values[4].asString() = absl::StrCat(redirect_client_id);
+  type(RespType::Array);
+  asArray().swap(values);
+}
 } // namespace Utility
 } // namespace Redis
 } // namespace Common
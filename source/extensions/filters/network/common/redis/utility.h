@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #include "extensions/filters/network/common/redis/codec.h"
 
+#include "absl/strings/string_view.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -43,6 +46,35 @@ public:
   static const SetRequest& instance();
 };
 
+class ClientIdRequest : public Redis::RespValue {
+public:
+  ClientIdRequest();
+  static const ClientIdRequest& instance();
+};
+
+/**
+ * Subscribes to the channel that the invalidations of client side caching are sent to.
+ */
+class SubscribeInvalidationsRequest : public Redis::RespValue {
+public:
+  SubscribeInvalidationsRequest();
+  static const SubscribeInvalidationsRequest& instance();
+};
+
+/**
+ * Enables client side caching for the keys read by a connection, with the invalidations sent to
+ * another connection.
+ */
+class ClientTrackingRequest : public Redis::RespValue {
+public:
+  ClientTrackingRequest(int64_t redirect_client_id);
+};
+
+/**
+ * The channel that the invalidations of client side caching are sent to.
+ */
+constexpr absl::string_view InvalidationsChannel = "__redis__:invalidate";
+
 } // namespace Utility
 } // namespace Redis
 } // namespace Common
@@ -71,8 +71,9 @@ public:
     void remove(const std::string& key);
     const std::string* lookup(const std::string& key) const;
 
-    // Http::HeaderMap wrapper to attachment.
-    const Http::HeaderMap& headers() const { return *headers_; }
+    // Http::HeaderMap wrapper to attachment, built the first time it's needed.
+    const Http::HeaderMap& headers() const;
+    bool hasHeaders() const { return headers_ != nullptr; }
 
     // Whether the attachment should be re-serialized.
     bool attachmentUpdated() const { return attachment_updated_; }
@@ -91,7 +92,8 @@ public:
     // To reuse the HeaderMatcher API and related tools provided by Envoy, we store the key/value
     // pair of the string type in the attachment in the Http::HeaderMap. This introduces additional
     // overhead and ignores the case of the key in the attachment. But for now, it's acceptable.
-    Http::HeaderMapPtr headers_;
+    // It's only built for the routes matching the headers, the other lookups go to the map.
+    mutable Http::HeaderMapPtr headers_;
   };
   using AttachmentPtr = std::unique_ptr<Attachment>;
 
@@ -609,6 +609,7 @@ void HttpConnectionManagerConfig::createFilterChainForFactories(
     Http::FilterChainFactoryCallbacks& callbacks, const FilterFactoriesList& filter_factories) {
   bool added_missing_config_filter = false;
   for (const auto& filter_config_provider : filter_factories) {
+    callbacks.setFilterConfigName(filter_config_provider->name());
     auto config = filter_config_provider->config();
     if (config.has_value()) {
       config.value()(callbacks);
@@ -70,14 +70,24 @@ absl::flat_hash_map<int32_t, MonotonicTime>& KafkaMetricsFacadeImpl::getRequestA
 }
 
 KafkaBrokerFilter::KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source,
-                                     const std::string& stat_prefix)
+                                     const std::string& stat_prefix, const bool parse_headers_only)
     : KafkaBrokerFilter{
-          std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix)} {};
-
-KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics)
-    : metrics_{metrics}, response_decoder_{new ResponseDecoder({metrics})},
-      request_decoder_{
-          new RequestDecoder({std::make_shared<Forwarder>(*response_decoder_), metrics})} {};
+          std::make_shared<KafkaMetricsFacadeImpl>(scope, time_source, stat_prefix),
+          parse_headers_only ? HeaderOnlyRequestParserResolver::getInstance()
+                             : RequestParserResolver::getDefaultInstance(),
+          parse_headers_only ? HeaderOnlyResponseParserResolver::getInstance()
+                             : ResponseParserResolver::getDefaultInstance()} {};
+
+KafkaBrokerFilter::KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                                     const RequestParserResolver& request_parser_resolver,
+                                     const ResponseParserResolver& response_parser_resolver)
+    : metrics_{metrics}, response_decoder_{new ResponseDecoder(
+                             ResponseInitialParserFactory::getDefaultInstance(),
+                             response_parser_resolver, {metrics})},
+      request_decoder_{new RequestDecoder(InitialParserFactory::getDefaultInstance(),
+                                          request_parser_resolver,
+                                          {std::make_shared<Forwarder>(*response_decoder_),
+                                           metrics})} {};
 
 KafkaBrokerFilter::KafkaBrokerFilter(KafkaMetricsFacadeSharedPtr metrics,
                                      ResponseDecoderSharedPtr response_decoder,
@@ -137,9 +137,10 @@ public:
   /**
    * Main constructor.
    * Creates decoders that eventually update prefixed metrics stored in scope, using time source for
-   * duration calculation.
+   * duration calculation. If parse_headers_only is set, the decoders skip message payloads.
    */
-  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix);
+  KafkaBrokerFilter(Stats::Scope& scope, TimeSource& time_source, const std::string& stat_prefix,
+                    bool parse_headers_only);
 
   /**
    * Visible for testing.
@@ -161,9 +162,11 @@ public:
 private:
   /**
    * Helper delegate constructor.
-   * Passes metrics facade as argument to decoders.
+   * Passes metrics facade as argument to decoders, which use the given parser resolvers.
    */
-  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics);
+  KafkaBrokerFilter(const KafkaMetricsFacadeSharedPtr& metrics,
+                    const RequestParserResolver& request_parser_resolver,
+                    const ResponseParserResolver& response_parser_resolver);
 
   const KafkaMetricsFacadeSharedPtr metrics_;
   const ResponseDecoderSharedPtr response_decoder_;
@@ -121,6 +121,23 @@ public:
 
 using AbstractRequestSharedPtr = std::shared_ptr<AbstractRequest>;
 
+/**
+ * Request whose payload has been skipped instead of being deserialized, so only its header is
+ * known. As the payload is missing, such a request cannot be encoded.
+ */
+class HeaderOnlyRequest : public AbstractRequest {
+public:
+  HeaderOnlyRequest(const RequestHeader& request_header) : AbstractRequest{request_header} {};
+
+  uint32_t computeSize() const override {
+    throw EnvoyException("cannot compute size of request without payload");
+  }
+
+  uint32_t encode(Buffer::Instance&) const override {
+    throw EnvoyException("cannot encode request without payload");
+  }
+};
+
 /**
  * Concrete request that carries data particular to given request type.
  * @param Data concrete request data type.
@@ -163,7 +180,9 @@ public:
     return request_header_ == rhs.request_header_ && data_ == rhs.data_;
   };
 
-private:
+  /**
+   * Request's data.
+   */
   const Data data_;
 };
 
@@ -9,6 +9,20 @@ const RequestParserResolver& RequestParserResolver::getDefaultInstance() {
   CONSTRUCT_ON_FIRST_USE(RequestParserResolver);
 }
 
+RequestParserSharedPtr
+HeaderOnlyRequestParserResolver::createParser(int16_t api_key, int16_t api_version,
+                                              RequestContextSharedPtr context) const {
+  if (requestHasParser(api_key, api_version)) {
+    return std::make_shared<PayloadSkippingParser>(context);
+  } else {
+    return std::make_shared<SentinelParser>(context);
+  }
+}
+
+const HeaderOnlyRequestParserResolver& HeaderOnlyRequestParserResolver::getInstance() {
+  CONSTRUCT_ON_FIRST_USE(HeaderOnlyRequestParserResolver);
+}
+
 RequestParseResponse RequestStartParser::parse(absl::string_view& data) {
   request_length_.feed(data);
   if (request_length_.ready()) {
@@ -43,10 +43,26 @@ struct RequestContext {
    * Returns data needed for construction of parse failure message.
    */
   const RequestHeader asFailureData() const { return request_header_; }
+
+  /**
+   * Returns message carrying the request header, for requests whose payload has been skipped.
+   */
+  AbstractRequestSharedPtr asHeaderOnlyMessage() const {
+    return std::make_shared<HeaderOnlyRequest>(request_header_);
+  }
 };
 
 using RequestContextSharedPtr = std::shared_ptr<RequestContext>;
 
+/**
+ * Decides if there is a parser for request with given api key & version.
+ * This method gets implemented in generated code through 'kafka_request_resolver_cc.j2'.
+ * @param api_key Kafka request key.
+ * @param api_version Kafka request's version.
+ * @return Whether requests with this key & version can be parsed.
+ */
+bool requestHasParser(const int16_t api_key, const int16_t api_version);
+
 /**
  * Request decoder configuration object.
  * Resolves the parser that will be responsible for consuming the request-specific data.
@@ -72,6 +88,23 @@ public:
   static const RequestParserResolver& getDefaultInstance();
 };
 
+/**
+ * Request parser resolver that does not deserialize request payloads.
+ * Requests that could have been parsed are consumed by PayloadSkippingParser, so only their headers
+ * are captured. Requests that could not have been parsed are still handled by SentinelParser.
+ */
+class HeaderOnlyRequestParserResolver : public RequestParserResolver {
+public:
+  // RequestParserResolver
+  RequestParserSharedPtr createParser(int16_t api_key, int16_t api_version,
+                                      RequestContextSharedPtr context) const override;
+
+  /**
+   * Return the instance of header-only resolver.
+   */
+  static const HeaderOnlyRequestParserResolver& getInstance();
+};
+
 /**
  * Request parser responsible for consuming request length and setting up context with this data.
  * @see http://kafka.apache.org/protocol.html#protocol_common
@@ -176,6 +209,22 @@ public:
   }
 };
 
+/**
+ * Parser that consumes the payload of a request without deserializing it, and then returns a
+ * request carrying only the header (stored in context).
+ */
+class PayloadSkippingParser
+    : public AbstractPayloadSkippingParser<RequestContextSharedPtr, RequestParseResponse>,
+      public RequestParser {
+public:
+  PayloadSkippingParser(RequestContextSharedPtr context)
+      : AbstractPayloadSkippingParser{context} {};
+
+  RequestParseResponse parse(absl::string_view& data) override {
+    return AbstractPayloadSkippingParser::parse(data);
+  }
+};
+
 /**
  * Request parser uses a single deserializer to construct a request object.
  * This parser is responsible for consuming request-specific data (e.g. topic names) and always
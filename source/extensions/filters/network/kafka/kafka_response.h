@@ -1,5 +1,7 @@
 #pragma once
 
+#include "envoy/common/exception.h"
+
 #include "extensions/filters/network/kafka/external/serialization_composite.h"
 #include "extensions/filters/network/kafka/serialization.h"
 #include "extensions/filters/network/kafka/tagged_fields.h"
@@ -101,6 +103,23 @@ public:
 
 using AbstractResponseSharedPtr = std::shared_ptr<AbstractResponse>;
 
+/**
+ * Response whose payload has been skipped instead of being deserialized, so only its metadata is
+ * known. As the payload is missing, such a response cannot be encoded.
+ */
+class HeaderOnlyResponse : public AbstractResponse {
+public:
+  HeaderOnlyResponse(const ResponseMetadata& metadata) : AbstractResponse{metadata} {};
+
+  uint32_t computeSize() const override {
+    throw EnvoyException("cannot compute size of response without payload");
+  }
+
+  uint32_t encode(Buffer::Instance&) const override {
+    throw EnvoyException("cannot encode response without payload");
+  }
+};
+
 /**
  * Concrete response that carries data particular to given response type.
  * @param Data concrete response data type.
@@ -141,7 +160,9 @@ public:
     return metadata_ == rhs.metadata_ && data_ == rhs.data_;
   };
 
-private:
+  /**
+   * Response's data.
+   */
   const Data data_;
 };
 
@@ -11,6 +11,19 @@ const ResponseParserResolver& ResponseParserResolver::getDefaultInstance() {
   CONSTRUCT_ON_FIRST_USE(ResponseParserResolver);
 }
 
+ResponseParserSharedPtr
+HeaderOnlyResponseParserResolver::createParser(ResponseContextSharedPtr context) const {
+  if (responseHasParser(context->api_key_, context->api_version_)) {
+    return std::make_shared<PayloadSkippingResponseParser>(context);
+  } else {
+    return std::make_shared<SentinelResponseParser>(context);
+  }
+}
+
+const HeaderOnlyResponseParserResolver& HeaderOnlyResponseParserResolver::getInstance() {
+  CONSTRUCT_ON_FIRST_USE(HeaderOnlyResponseParserResolver);
+}
+
 ResponseParseResponse ResponseHeaderParser::parse(absl::string_view& data) {
   length_deserializer_.feed(data);
   if (!length_deserializer_.ready()) {
@@ -62,10 +62,26 @@ struct ResponseContext {
   const ResponseMetadata asFailureData() const {
     return {api_key_, api_version_, correlation_id_, tagged_fields_};
   }
+
+  /**
+   * Returns message carrying the response metadata, for responses whose payload has been skipped.
+   */
+  AbstractResponseSharedPtr asHeaderOnlyMessage() const {
+    return std::make_shared<HeaderOnlyResponse>(asFailureData());
+  }
 };
 
 using ResponseContextSharedPtr = std::shared_ptr<ResponseContext>;
 
+/**
+ * Decides if there is a parser for response with given api key & version.
+ * This method gets implemented in generated code through 'kafka_response_resolver_cc.j2'.
+ * @param api_key Kafka response key.
+ * @param api_version Kafka response's version.
+ * @return Whether responses with this key & version can be parsed.
+ */
+bool responseHasParser(const int16_t api_key, const int16_t api_version);
+
 // Helper container for response api key & version.
 using ExpectedResponseSpec = std::pair<int16_t, int16_t>;
 // Response metadata store (maps from correlation id to api key & version).
@@ -94,6 +110,23 @@ public:
   static const ResponseParserResolver& getDefaultInstance();
 };
 
+/**
+ * Response parser resolver that does not deserialize response payloads.
+ * Responses that could have been parsed are consumed by PayloadSkippingResponseParser, so only
+ * their metadata is captured. Responses that could not have been parsed are still handled by
+ * SentinelResponseParser.
+ */
+class HeaderOnlyResponseParserResolver : public ResponseParserResolver {
+public:
+  // ResponseParserResolver
+  ResponseParserSharedPtr createParser(ResponseContextSharedPtr metadata) const override;
+
+  /**
+   * Return the instance of header-only resolver.
+   */
+  static const HeaderOnlyResponseParserResolver& getInstance();
+};
+
 /**
  * Response parser responsible for consuming response header (payload length and correlation id) and
  * setting up context with this data.
@@ -151,6 +184,22 @@ public:
   }
 };
 
+/**
+ * Parser that consumes the payload of a response without deserializing it, and then returns a
+ * response carrying only the metadata (stored in context).
+ */
+class PayloadSkippingResponseParser
+    : public AbstractPayloadSkippingParser<ResponseContextSharedPtr, ResponseParseResponse>,
+      public ResponseParser {
+public:
+  PayloadSkippingResponseParser(ResponseContextSharedPtr context)
+      : AbstractPayloadSkippingParser{context} {};
+
+  ResponseParseResponse parse(absl::string_view& data) override {
+    return AbstractPayloadSkippingParser::parse(data);
+  }
+};
+
 /**
  * Response parser uses a single deserializer to construct a response object.
  * This parser is responsible for consuming response-specific data (e.g. topic names) and always
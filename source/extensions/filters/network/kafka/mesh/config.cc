@@ -0,0 +1,39 @@
+#include "extensions/filters/network/kafka/mesh/config.h"
+
+#include "envoy/registry/registry.h"
+#include "envoy/server/filter_config.h"
+
+#include "extensions/filters/network/kafka/mesh/filter.h"
+#include "extensions/filters/network/kafka/mesh/upstream_kafka_client.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+Network::FilterFactoryCb KafkaMeshConfigFactory::createFilterFactoryFromProtoTyped(
+    const KafkaMeshProtoConfig& config, Server::Configuration::FactoryContext& context) {
+
+  const UpstreamKafkaConfigurationSharedPtr configuration =
+      std::make_shared<UpstreamKafkaConfigurationImpl>(config);
+  const UpstreamKafkaFacadeSharedPtr upstream_kafka_facade =
+      std::make_shared<UpstreamKafkaFacadeImpl>(context.threadLocal(), context.clusterManager());
+
+  return [configuration, upstream_kafka_facade](Network::FilterManager& filter_manager) -> void {
+    Network::ReadFilterSharedPtr filter =
+        std::make_shared<KafkaMeshFilter>(*configuration, *upstream_kafka_facade);
+    filter_manager.addReadFilter(filter);
+  };
+}
+
+/**
+ * Static registration for the Kafka mesh filter. @see RegisterFactory.
+ */
+REGISTER_FACTORY(KafkaMeshConfigFactory, Server::Configuration::NamedNetworkFilterConfigFactory);
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#include "extensions/filters/network/kafka/mesh/filter.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/kafka/response_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+KafkaMeshFilter::KafkaMeshFilter(const UpstreamKafkaConfiguration& configuration,
+                                 UpstreamKafkaFacade& upstream_kafka_facade)
+    : request_decoder_{std::make_shared<RequestDecoder>(std::vector<RequestCallbackSharedPtr>{
+          std::make_shared<RequestProcessor>(*this, configuration, upstream_kafka_facade)})} {}
+
+Network::FilterStatus KafkaMeshFilter::onNewConnection() { return Network::FilterStatus::Continue; }
+
+void KafkaMeshFilter::initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) {
+  read_filter_callbacks_ = &callbacks;
+  read_filter_callbacks_->connection().addConnectionCallbacks(*this);
+}
+
+Network::FilterStatus KafkaMeshFilter::onData(Buffer::Instance& data, bool) {
+  try {
+    request_decoder_->onData(data);
+    // The decoder has consumed all the bytes.
+    data.drain(data.length());
+  } catch (const EnvoyException& e) {
+    ENVOY_CONN_LOG(debug, "kafka mesh: closing connection: {}",
+                   read_filter_callbacks_->connection(), e.what());
+    data.drain(data.length());
+    abandonAllInFlightRequests();
+    read_filter_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
+  }
+  return Network::FilterStatus::StopIteration;
+}
+
+void KafkaMeshFilter::onEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    abandonAllInFlightRequests();
+  }
+}
+
+void KafkaMeshFilter::onRequest(InFlightRequestSharedPtr request) {
+  requests_waiting_for_answer_.push_back(request);
+  request->startProcessing();
+}
+
+void KafkaMeshFilter::onRequestReadyForAnswer() {
+  while (!requests_waiting_for_answer_.empty() &&
+         requests_waiting_for_answer_.front()->finished()) {
+    const InFlightRequestSharedPtr request = requests_waiting_for_answer_.front();
+    requests_waiting_for_answer_.pop_front();
+    const AbstractResponseSharedPtr response = request->computeAnswer();
+    if (response != nullptr) {
+      Buffer::OwnedImpl buffer;
+      ResponseEncoder{buffer}.encode(*response);
+      read_filter_callbacks_->connection().write(buffer, false);
+    }
+  }
+}
+
+void KafkaMeshFilter::abandonAllInFlightRequests() { requests_waiting_for_answer_.clear(); }
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <list>
+
+#include "envoy/network/connection.h"
+#include "envoy/network/filter.h"
+
+#include "common/common/logger.h"
+
+#include "extensions/filters/network/kafka/mesh/request_processor.h"
+#include "extensions/filters/network/kafka/mesh/upstream_config.h"
+#include "extensions/filters/network/kafka/mesh/upstream_kafka_client.h"
+#include "extensions/filters/network/kafka/request_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+/**
+ * Main entry point.
+ * Decoded requests are forwarded to the upstream clusters of their topics, or answered right
+ * away if they are about the cluster itself. Responses are sent downstream in the order of their
+ * requests, as the Kafka protocol requires.
+ *
+ * The filter is a terminal one, as it acts like a Kafka broker towards its clients: Metadata
+ * requests are answered with the advertised address being the only broker, leading all the
+ * partitions of the topics forwarded by the configuration. Produce requests get their records
+ * sent to the upstream clusters of their topics by the producers of the worker, which batch the
+ * records of all the downstream connections. Other requests close the connection.
+ */
+class KafkaMeshFilter : public Network::ReadFilter,
+                        public Network::ConnectionCallbacks,
+                        public AbstractRequestListener,
+                        private Logger::Loggable<Logger::Id::kafka> {
+public:
+  KafkaMeshFilter(const UpstreamKafkaConfiguration& configuration,
+                  UpstreamKafkaFacade& upstream_kafka_facade);
+
+  // Network::ReadFilter
+  Network::FilterStatus onData(Buffer::Instance& data, bool end_stream) override;
+  Network::FilterStatus onNewConnection() override;
+  void initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) override;
+
+  // Network::ConnectionCallbacks
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+  // AbstractRequestListener
+  void onRequest(InFlightRequestSharedPtr request) override;
+  void onRequestReadyForAnswer() override;
+
+  // Visible for testing.
+  const std::list<InFlightRequestSharedPtr>& getRequestsWaitingForAnswer() const {
+    return requests_waiting_for_answer_;
+  }
+
+private:
+  // Drops the requests in flight, so their results are never sent downstream.
+  void abandonAllInFlightRequests();
+
+  const RequestDecoderSharedPtr request_decoder_;
+  Network::ReadFilterCallbacks* read_filter_callbacks_{};
+  std::list<InFlightRequestSharedPtr> requests_waiting_for_answer_;
+};
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,169 @@
+#include "extensions/filters/network/kafka/mesh/request_processor.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+namespace {
+
+// The only broker advertised to clients, which is the mesh filter itself.
+constexpr int32_t BrokerId = 0;
+
+// Api versions advertised to clients.
+constexpr int16_t MinProduceVersion = 0;
+constexpr int16_t MaxProduceVersion = 8;
+constexpr int16_t MinMetadataVersion = 0;
+constexpr int16_t MaxMetadataVersion = 1;
+constexpr int16_t MinApiVersionsVersion = 0;
+constexpr int16_t MaxApiVersionsVersion = 3;
+
+} // namespace
+
+void ApiVersionsRequestHolder::startProcessing() { filter_.onRequestReadyForAnswer(); }
+
+AbstractResponseSharedPtr ApiVersionsRequestHolder::computeAnswer() const {
+  const ResponseMetadata metadata{request_header_.api_key_, request_header_.api_version_,
+                                  request_header_.correlation_id_};
+  const std::vector<ApiVersionsResponseKey> api_keys = {
+      {ProduceRequestApiKey, MinProduceVersion, MaxProduceVersion},
+      {MetadataRequestApiKey, MinMetadataVersion, MaxMetadataVersion},
+      {ApiVersionsRequestApiKey, MinApiVersionsVersion, MaxApiVersionsVersion},
+  };
+  const ApiVersionsResponse data{0, api_keys};
+  return std::make_shared<Response<ApiVersionsResponse>>(metadata, data);
+}
+
+void MetadataRequestHolder::startProcessing() { filter_.onRequestReadyForAnswer(); }
+
+AbstractResponseSharedPtr MetadataRequestHolder::computeAnswer() const {
+  const RequestHeader& header = request_->request_header_;
+  const ResponseMetadata metadata{header.api_key_, header.api_version_, header.correlation_id_};
+
+  const std::pair<std::string, int32_t> address = configuration_.getAdvertisedAddress();
+  const std::vector<MetadataResponseBroker> brokers = {{BrokerId, address.first, address.second}};
+
+  std::vector<MetadataResponseTopic> topics;
+  // Clients asking for all the topics get none, as the mesh filter doesn't know them.
+  if (request_->data_.topics_.has_value()) {
+    for (const MetadataRequestTopic& topic : *request_->data_.topics_) {
+      const absl::optional<ClusterConfig> cluster =
+          configuration_.computeClusterConfigForTopic(topic.name_);
+      if (!cluster.has_value()) {
+        topics.emplace_back(UnknownTopicOrPartition, topic.name_, false,
+                            std::vector<MetadataResponsePartition>{});
+        continue;
+      }
+      std::vector<MetadataResponsePartition> partitions;
+      for (int32_t partition = 0; partition < cluster->partition_count_; ++partition) {
+        partitions.emplace_back(0, partition, BrokerId, std::vector<int32_t>{BrokerId},
+                                std::vector<int32_t>{BrokerId});
+      }
+      topics.emplace_back(0, topic.name_, false, partitions);
+    }
+  }
+
+  const MetadataResponse data{brokers, BrokerId, topics};
+  return std::make_shared<Response<MetadataResponse>>(metadata, data);
+}
+
+void ProduceRequestHolder::startProcessing() {
+  const RequestHeader& header = request_->request_header_;
+  const ProduceRequest& data = request_->data_;
+  const ProduceSpec spec{header.api_version_, data.acks_, data.transactional_id_,
+                         data.timeout_ms_};
+
+  // Results of partitions failing right away must not finish the request while others are
+  // still being sent.
+  dispatching_ = true;
+  for (const TopicProduceData& topic : data.topics_) {
+    const absl::optional<ClusterConfig> cluster =
+        configuration_.computeClusterConfigForTopic(topic.name_);
+    for (const PartitionProduceData& partition : topic.partitions_) {
+      if (!cluster.has_value() || partition.partition_index_ < 0 ||
+          partition.partition_index_ >= cluster->partition_count_) {
+        results_[topic.name_].emplace_back(partition.partition_index_, UnknownTopicOrPartition,
+                                           -1);
+        continue;
+      }
+      pending_partitions_++;
+      upstream_kafka_facade_.getProducerForCluster(*cluster).send(
+          shared_from_this(), spec, topic.name_, partition.partition_index_, partition.records_);
+    }
+  }
+  dispatching_ = false;
+
+  if (finished()) {
+    filter_.onRequestReadyForAnswer();
+  }
+}
+
+bool ProduceRequestHolder::finished() const {
+  // Clients don't wait for the results of requests sent with acks=0.
+  return request_->data_.acks_ == 0 || (!dispatching_ && pending_partitions_ == 0);
+}
+
+AbstractResponseSharedPtr ProduceRequestHolder::computeAnswer() const {
+  if (request_->data_.acks_ == 0) {
+    return nullptr;
+  }
+
+  const RequestHeader& header = request_->request_header_;
+  const ResponseMetadata metadata{header.api_key_, header.api_version_, header.correlation_id_};
+  std::vector<TopicProduceResponse> responses;
+  for (const auto& topic : results_) {
+    responses.emplace_back(topic.first, topic.second);
+  }
+  const ProduceResponse data{responses, 0};
+  return std::make_shared<Response<ProduceResponse>>(metadata, data);
+}
+
+void ProduceRequestHolder::onPartitionResult(const std::string& topic,
+                                             const PartitionProduceResponse& result) {
+  ASSERT(pending_partitions_ > 0);
+  results_[topic].push_back(result);
+  pending_partitions_--;
+  if (finished()) {
+    filter_.onRequestReadyForAnswer();
+  }
+}
+
+void RequestProcessor::onMessage(AbstractRequestSharedPtr request) {
+  const int16_t api_key = request->request_header_.api_key_;
+  InFlightRequestSharedPtr in_flight_request;
+  switch (api_key) {
+  case ProduceRequestApiKey:
+    in_flight_request = std::make_shared<ProduceRequestHolder>(
+        filter_, configuration_, upstream_kafka_facade_,
+        std::dynamic_pointer_cast<Request<ProduceRequest>>(request));
+    break;
+  case MetadataRequestApiKey:
+    in_flight_request = std::make_shared<MetadataRequestHolder>(
+        filter_, configuration_, std::dynamic_pointer_cast<Request<MetadataRequest>>(request));
+    break;
+  case ApiVersionsRequestApiKey:
+    in_flight_request =
+        std::make_shared<ApiVersionsRequestHolder>(filter_, request->request_header_);
+    break;
+  default:
+    throw EnvoyException(absl::StrCat("unsupported Kafka request with api key ", api_key));
+  }
+  filter_.onRequest(in_flight_request);
+}
+
+void RequestProcessor::onFailedParse(RequestParseFailureSharedPtr parse_failure) {
+  throw EnvoyException(absl::StrCat("unparseable Kafka request with api key ",
+                                    parse_failure->request_header_.api_key_));
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/pure.h"
+
+#include "common/common/logger.h"
+
+#include "extensions/filters/network/kafka/external/requests.h"
+#include "extensions/filters/network/kafka/external/responses.h"
+#include "extensions/filters/network/kafka/kafka_request.h"
+#include "extensions/filters/network/kafka/kafka_response.h"
+#include "extensions/filters/network/kafka/mesh/upstream_config.h"
+#include "extensions/filters/network/kafka/mesh/upstream_kafka_client.h"
+#include "extensions/filters/network/kafka/request_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+// Api keys of the requests answered by the mesh filter itself.
+constexpr int16_t MetadataRequestApiKey = 3;
+constexpr int16_t ApiVersionsRequestApiKey = 18;
+
+/**
+ * Request received from a downstream client, from the moment it's decoded until it's answered.
+ */
+class InFlightRequest {
+public:
+  virtual ~InFlightRequest() = default;
+
+  /**
+   * Begins processing the request, what might involve sending it upstream.
+   */
+  virtual void startProcessing() PURE;
+
+  /**
+   * @return whether the request has been processed and can be answered.
+   */
+  virtual bool finished() const PURE;
+
+  /**
+   * @return the response to be sent downstream once the request has finished, or nullptr if the
+   *         client doesn't expect one.
+   */
+  virtual AbstractResponseSharedPtr computeAnswer() const PURE;
+};
+
+using InFlightRequestSharedPtr = std::shared_ptr<InFlightRequest>;
+
+/**
+ * Receives the requests decoded from a downstream connection, and the notifications about them
+ * being ready to be answered.
+ */
+class AbstractRequestListener {
+public:
+  virtual ~AbstractRequestListener() = default;
+
+  /**
+   * Called when a request has been decoded. The listener starts its processing.
+   */
+  virtual void onRequest(InFlightRequestSharedPtr request) PURE;
+
+  /**
+   * Called when a request has finished, so the responses that can be sent (in the order of their
+   * requests) should be sent.
+   */
+  virtual void onRequestReadyForAnswer() PURE;
+};
+
+/**
+ * Answers ApiVersions requests with the api versions supported by the mesh filter.
+ */
+class ApiVersionsRequestHolder : public InFlightRequest {
+public:
+  ApiVersionsRequestHolder(AbstractRequestListener& filter, const RequestHeader& request_header)
+      : filter_(filter), request_header_(request_header) {}
+
+  // InFlightRequest
+  void startProcessing() override;
+  bool finished() const override { return true; }
+  AbstractResponseSharedPtr computeAnswer() const override;
+
+private:
+  AbstractRequestListener& filter_;
+  const RequestHeader request_header_;
+};
+
+/**
+ * Answers Metadata requests, making clients send the requests of all topics and partitions to
+ * the advertised address.
+ */
+class MetadataRequestHolder : public InFlightRequest {
+public:
+  MetadataRequestHolder(AbstractRequestListener& filter,
+                        const UpstreamKafkaConfiguration& configuration,
+                        const std::shared_ptr<Request<MetadataRequest>>& request)
+      : filter_(filter), configuration_(configuration), request_(request) {}
+
+  // InFlightRequest
+  void startProcessing() override;
+  bool finished() const override { return true; }
+  AbstractResponseSharedPtr computeAnswer() const override;
+
+private:
+  AbstractRequestListener& filter_;
+  const UpstreamKafkaConfiguration& configuration_;
+  const std::shared_ptr<Request<MetadataRequest>> request_;
+};
+
+/**
+ * Sends the records of a Produce request to the upstream clusters of their topics, and answers
+ * with the results of all the partitions once they are known.
+ */
+class ProduceRequestHolder : public InFlightRequest,
+                             public ProduceFinishCb,
+                             public std::enable_shared_from_this<ProduceRequestHolder> {
+public:
+  ProduceRequestHolder(AbstractRequestListener& filter,
+                       const UpstreamKafkaConfiguration& configuration,
+                       UpstreamKafkaFacade& upstream_kafka_facade,
+                       const std::shared_ptr<Request<ProduceRequest>>& request)
+      : filter_(filter), configuration_(configuration),
+        upstream_kafka_facade_(upstream_kafka_facade), request_(request) {}
+
+  // InFlightRequest
+  void startProcessing() override;
+  bool finished() const override;
+  AbstractResponseSharedPtr computeAnswer() const override;
+
+  // ProduceFinishCb
+  void onPartitionResult(const std::string& topic,
+                         const PartitionProduceResponse& result) override;
+
+private:
+  AbstractRequestListener& filter_;
+  const UpstreamKafkaConfiguration& configuration_;
+  UpstreamKafkaFacade& upstream_kafka_facade_;
+  const std::shared_ptr<Request<ProduceRequest>> request_;
+  // Results of the partitions, by topic.
+  std::map<std::string, std::vector<PartitionProduceResponse>> results_;
+  // Number of partitions sent upstream, whose results are not known yet.
+  uint32_t pending_partitions_{};
+  // Whether the partitions are still being sent upstream.
+  bool dispatching_{};
+};
+
+/**
+ * Turns the requests decoded from a downstream connection into in-flight requests, and passes
+ * them to the listener. Throws on requests the mesh filter can't handle.
+ */
+class RequestProcessor : public RequestCallback, private Logger::Loggable<Logger::Id::kafka> {
+public:
+  RequestProcessor(AbstractRequestListener& filter,
+                   const UpstreamKafkaConfiguration& configuration,
+                   UpstreamKafkaFacade& upstream_kafka_facade)
+      : filter_(filter), configuration_(configuration),
+        upstream_kafka_facade_(upstream_kafka_facade) {}
+
+  // RequestCallback
+  void onMessage(AbstractRequestSharedPtr request) override;
+  void onFailedParse(RequestParseFailureSharedPtr parse_failure) override;
+
+private:
+  AbstractRequestListener& filter_;
+  const UpstreamKafkaConfiguration& configuration_;
+  UpstreamKafkaFacade& upstream_kafka_facade_;
+};
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
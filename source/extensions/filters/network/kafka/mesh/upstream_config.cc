@@ -0,0 +1,61 @@
+#include "extensions/filters/network/kafka/mesh/upstream_config.h"
+
+#include "envoy/common/exception.h"
+
+#include "common/protobuf/utility.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+UpstreamKafkaConfigurationImpl::UpstreamKafkaConfigurationImpl(const KafkaMeshProtoConfig& config)
+    : advertised_address_{config.advertised_host(), config.advertised_port()} {
+
+  for (const auto& upstream_cluster : config.upstream_clusters()) {
+    const std::string& cluster_name = upstream_cluster.cluster();
+    if (cluster_name_to_cluster_config_.count(cluster_name) > 0) {
+      throw EnvoyException(absl::StrCat("kafka mesh: cluster ", cluster_name, " is defined twice"));
+    }
+    const std::chrono::milliseconds linger{PROTOBUF_GET_MS_OR_DEFAULT(
+        upstream_cluster, linger, static_cast<uint64_t>(DefaultLinger.count()))};
+    const uint32_t max_batch_size_bytes = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        upstream_cluster, max_batch_size_bytes, DefaultMaxBatchSizeBytes);
+    cluster_name_to_cluster_config_[cluster_name] = {
+        cluster_name, upstream_cluster.partition_count(), linger, max_batch_size_bytes};
+  }
+
+  for (const auto& rule : config.forwarding_rules()) {
+    const std::string& target_cluster = rule.target_cluster();
+    if (cluster_name_to_cluster_config_.count(target_cluster) == 0) {
+      throw EnvoyException(
+          absl::StrCat("kafka mesh: forwarding rule targets undefined cluster ", target_cluster));
+    }
+    topic_prefix_to_cluster_name_.emplace_back(rule.topic_prefix(), target_cluster);
+  }
+}
+
+absl::optional<ClusterConfig>
+UpstreamKafkaConfigurationImpl::computeClusterConfigForTopic(const std::string& topic) const {
+  // The first matching rule wins.
+  for (const auto& rule : topic_prefix_to_cluster_name_) {
+    if (absl::StartsWith(topic, rule.first)) {
+      return cluster_name_to_cluster_config_.at(rule.second);
+    }
+  }
+  return absl::nullopt;
+}
+
+std::pair<std::string, int32_t> UpstreamKafkaConfigurationImpl::getAdvertisedAddress() const {
+  return advertised_address_;
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/extensions/filters/network/kafka_mesh/v3alpha/kafka_mesh.pb.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+using KafkaMeshProtoConfig = envoy::extensions::filters::network::kafka_mesh::v3alpha::KafkaMesh;
+
+/**
+ * Minimal configuration of an upstream cluster, that the records of topics are produced to.
+ */
+struct ClusterConfig {
+  // Name of the Envoy cluster.
+  std::string name_;
+  // Number of partitions of the topics forwarded to the cluster.
+  int32_t partition_count_;
+  // How long the records are held back before being sent upstream.
+  std::chrono::milliseconds linger_;
+  // Size of the held back records that makes them be sent upstream right away.
+  uint32_t max_batch_size_bytes_;
+
+  bool operator==(const ClusterConfig& rhs) const {
+    return name_ == rhs.name_ && partition_count_ == rhs.partition_count_ &&
+           linger_ == rhs.linger_ && max_batch_size_bytes_ == rhs.max_batch_size_bytes_;
+  };
+};
+
+/**
+ * Keeps the configuration related to upstream Kafka clusters.
+ */
+class UpstreamKafkaConfiguration {
+public:
+  virtual ~UpstreamKafkaConfiguration() = default;
+
+  /**
+   * Finds the cluster that the records of given topic are produced to.
+   * @param topic topic name.
+   * @return the cluster's configuration, or nothing if no forwarding rule matches the topic.
+   */
+  virtual absl::optional<ClusterConfig>
+  computeClusterConfigForTopic(const std::string& topic) const PURE;
+
+  /**
+   * @return the host and the port that clients are told to connect to.
+   */
+  virtual std::pair<std::string, int32_t> getAdvertisedAddress() const PURE;
+};
+
+using UpstreamKafkaConfigurationSharedPtr = std::shared_ptr<const UpstreamKafkaConfiguration>;
+
+/**
+ * Implementation that uses only topic-prefix to figure out which Kafka cluster to use.
+ */
+class UpstreamKafkaConfigurationImpl : public UpstreamKafkaConfiguration {
+public:
+  static constexpr std::chrono::milliseconds DefaultLinger{5};
+  static constexpr uint32_t DefaultMaxBatchSizeBytes = 1024 * 1024;
+
+  /**
+   * Creates the configuration, throwing if a forwarding rule targets an undefined cluster.
+   */
+  UpstreamKafkaConfigurationImpl(const KafkaMeshProtoConfig& config);
+
+  // UpstreamKafkaConfiguration
+  absl::optional<ClusterConfig>
+  computeClusterConfigForTopic(const std::string& topic) const override;
+  std::pair<std::string, int32_t> getAdvertisedAddress() const override;
+
+private:
+  const std::pair<std::string, int32_t> advertised_address_;
+  std::map<std::string, ClusterConfig> cluster_name_to_cluster_config_;
+  // Topic prefixes with the names of their clusters, in order of configuration.
+  std::vector<std::pair<std::string, std::string>> topic_prefix_to_cluster_name_;
+};
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
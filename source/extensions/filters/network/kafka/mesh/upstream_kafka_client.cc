@@ -0,0 +1,306 @@
+#include "extensions/filters/network/kafka/mesh/upstream_kafka_client.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "extensions/filters/network/kafka/external/requests.h"
+#include "extensions/filters/network/kafka/kafka_request.h"
+#include "extensions/filters/network/kafka/request_codec.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+namespace {
+
+// Client id of the requests sent upstream.
+const NullableString& clientId() { CONSTRUCT_ON_FIRST_USE(NullableString, "envoy-kafka-mesh"); }
+
+} // namespace
+
+UpstreamKafkaProducer::UpstreamKafkaProducer(const ClusterConfig& cluster_config,
+                                             Upstream::ClusterManager& cluster_manager,
+                                             Event::Dispatcher& dispatcher)
+    : cluster_config_(cluster_config), cluster_manager_(cluster_manager), dispatcher_(dispatcher),
+      linger_timer_(dispatcher.createTimer([this]() -> void { flushAll(); })) {}
+
+UpstreamKafkaProducer::~UpstreamKafkaProducer() {
+  // The batches in flight are abandoned without calling back into the producer.
+  in_flight_.clear();
+}
+
+void UpstreamKafkaProducer::send(const ProduceFinishCbSharedPtr& callback, const ProduceSpec& spec,
+                                 const std::string& topic, int32_t partition,
+                                 const NullableBytes& records) {
+  const BatchKey key{spec.api_version_, spec.acks_, spec.transactional_id_};
+  auto it = pending_.find(key);
+  // A produce request can carry only one record batch per partition.
+  if (it != pending_.end() && it->second.deliveries_.count({topic, partition}) > 0) {
+    flush(key);
+    it = pending_.end();
+  }
+  if (it == pending_.end()) {
+    it = pending_.emplace(key, PendingBatch{}).first;
+  }
+
+  PendingBatch& batch = it->second;
+  batch.timeout_ms_ = std::max(batch.timeout_ms_, spec.timeout_ms_);
+  batch.records_[topic].emplace(partition, records);
+  batch.deliveries_.emplace(TopicPartition{topic, partition}, callback);
+  batch.size_ += records.has_value() ? records->size() : 0;
+
+  if (batch.size_ >= cluster_config_.max_batch_size_bytes_) {
+    flush(key);
+  } else if (!linger_timer_->enabled()) {
+    linger_timer_->enableTimer(cluster_config_.linger_);
+  }
+}
+
+void UpstreamKafkaProducer::flush(const BatchKey& key) {
+  auto it = pending_.find(key);
+  ASSERT(it != pending_.end());
+  PendingBatch batch = std::move(it->second);
+  pending_.erase(it);
+
+  std::vector<TopicProduceData> topics;
+  for (const auto& topic : batch.records_) {
+    std::vector<PartitionProduceData> partitions;
+    for (const auto& partition : topic.second) {
+      partitions.emplace_back(partition.first, partition.second);
+    }
+    topics.emplace_back(topic.first, partitions);
+  }
+
+  const int16_t api_version = std::get<0>(key);
+  const int16_t acks = std::get<1>(key);
+  const int32_t correlation_id = next_correlation_id_;
+  next_correlation_id_ =
+      next_correlation_id_ == std::numeric_limits<int32_t>::max() ? 0 : next_correlation_id_ + 1;
+
+  const RequestHeader header{ProduceRequestApiKey, api_version, correlation_id, clientId()};
+  const ProduceRequest data{std::get<2>(key), acks, batch.timeout_ms_, topics};
+  const Request<ProduceRequest> request{header, data};
+  Buffer::OwnedImpl buffer;
+  RequestEncoder{buffer}.encode(request);
+
+  ENVOY_LOG(trace, "kafka mesh: sending {} partitions to cluster {} with correlation id {}",
+            batch.deliveries_.size(), cluster_config_.name_, correlation_id);
+  // Upstream doesn't answer requests sent with acks=0.
+  in_flight_.push_back(std::make_unique<InFlightBatch>(
+      *this, std::move(batch.deliveries_), buffer, correlation_id, api_version, acks != 0));
+  in_flight_.back()->start();
+}
+
+void UpstreamKafkaProducer::flushAll() {
+  while (!pending_.empty()) {
+    flush(pending_.begin()->first);
+  }
+}
+
+void UpstreamKafkaProducer::destroy(InFlightBatch& batch) {
+  auto it = std::find_if(in_flight_.begin(), in_flight_.end(),
+                         [&batch](const InFlightBatchPtr& entry) { return entry.get() == &batch; });
+  ASSERT(it != in_flight_.end());
+  dispatcher_.deferredDelete(std::move(*it));
+  in_flight_.erase(it);
+}
+
+void UpstreamKafkaProducer::ResponseReceiver::onMessage(AbstractResponseSharedPtr response) {
+  parent_.onResponse(response);
+}
+
+void UpstreamKafkaProducer::ResponseReceiver::onFailedParse(ResponseMetadataSharedPtr) {
+  parent_.close();
+}
+
+UpstreamKafkaProducer::InFlightBatch::InFlightBatch(UpstreamKafkaProducer& parent,
+                                                    Deliveries&& deliveries,
+                                                    Buffer::OwnedImpl& request,
+                                                    int32_t correlation_id, int16_t api_version,
+                                                    bool expects_response)
+    : parent_(parent), deliveries_(std::move(deliveries)), correlation_id_(correlation_id),
+      api_version_(api_version), expects_response_(expects_response) {
+  request_.move(request);
+}
+
+UpstreamKafkaProducer::InFlightBatch::~InFlightBatch() {
+  destroyed_ = true;
+  if (pool_handle_ != nullptr) {
+    pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+  // The response may still arrive, so the connection can't be reused.
+  if (conn_data_ != nullptr) {
+    conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::start() {
+  Upstream::ThreadLocalCluster* cluster =
+      parent_.cluster_manager_.getThreadLocalCluster(parent_.cluster_config_.name_);
+  if (cluster == nullptr) {
+    ENVOY_LOG(debug, "kafka mesh: unknown cluster {}", parent_.cluster_config_.name_);
+    fail(NetworkException);
+    return;
+  }
+  Tcp::ConnectionPool::Instance* pool =
+      cluster->tcpConnPool(Upstream::ResourcePriority::Default, nullptr);
+  if (pool == nullptr) {
+    ENVOY_LOG(debug, "kafka mesh: no healthy upstream in cluster {}",
+              parent_.cluster_config_.name_);
+    fail(NetworkException);
+    return;
+  }
+
+  // The pool may call back before newConnection() returns.
+  Tcp::ConnectionPool::Cancellable* handle = pool->newConnection(*this);
+  if (handle != nullptr && conn_data_ == nullptr && !destroyed_) {
+    pool_handle_ = handle;
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::onPoolFailure(ConnectionPool::PoolFailureReason,
+                                                         Upstream::HostDescriptionConstSharedPtr) {
+  pool_handle_ = nullptr;
+  fail(NetworkException);
+}
+
+void UpstreamKafkaProducer::InFlightBatch::onPoolReady(
+    Tcp::ConnectionPool::ConnectionDataPtr&& conn, Upstream::HostDescriptionConstSharedPtr) {
+  pool_handle_ = nullptr;
+  conn_data_ = std::move(conn);
+  conn_data_->addUpstreamCallbacks(*this);
+  if (expects_response_) {
+    decoder_ = std::make_shared<ResponseDecoder>(
+        std::vector<ResponseCallbackSharedPtr>{std::make_shared<ResponseReceiver>(*this)});
+    decoder_->expectResponse(correlation_id_, ProduceRequestApiKey, api_version_);
+  }
+  conn_data_->connection().write(request_, false);
+  if (!expects_response_) {
+    // The request is written out by the connection after it's returned to the pool.
+    destroy();
+    conn_data_.reset();
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::onUpstreamData(Buffer::Instance& data, bool) {
+  if (decoder_ == nullptr || destroyed_) {
+    // Nothing is expected from upstream.
+    data.drain(data.length());
+    close();
+    return;
+  }
+  try {
+    decoder_->onData(data);
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(debug, "kafka mesh: invalid response from cluster {}: {}",
+              parent_.cluster_config_.name_, e.what());
+    close();
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::onEvent(Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::RemoteClose &&
+      event != Network::ConnectionEvent::LocalClose) {
+    return;
+  }
+  // The pool releases the connection itself.
+  conn_data_.reset();
+  fail(NetworkException);
+}
+
+void UpstreamKafkaProducer::InFlightBatch::onResponse(const AbstractResponseSharedPtr& response) {
+  if (destroyed_) {
+    return;
+  }
+  const auto produce_response = std::dynamic_pointer_cast<Response<ProduceResponse>>(response);
+  if (produce_response == nullptr) {
+    close();
+    return;
+  }
+
+  Deliveries deliveries;
+  deliveries.swap(deliveries_);
+  // The connection is returned to the pool, as nothing else is expected on it.
+  destroy();
+  conn_data_.reset();
+
+  for (const TopicProduceResponse& topic : produce_response->data_.responses_) {
+    for (const PartitionProduceResponse& partition : topic.partitions_) {
+      auto it = deliveries.find({topic.name_, partition.partition_index_});
+      if (it == deliveries.end()) {
+        continue;
+      }
+      ProduceFinishCbSharedPtr callback = it->second.lock();
+      deliveries.erase(it);
+      if (callback != nullptr) {
+        callback->onPartitionResult(topic.name_, partition);
+      }
+    }
+  }
+
+  // Partitions missing from the response.
+  for (auto& delivery : deliveries) {
+    ProduceFinishCbSharedPtr callback = delivery.second.lock();
+    if (callback != nullptr) {
+      callback->onPartitionResult(delivery.first.first,
+                                  {delivery.first.second, UnknownServerError, -1});
+    }
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::close() {
+  // The event raised by closing the connection fails the deliveries.
+  if (conn_data_ != nullptr) {
+    conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::fail(int16_t error_code) {
+  if (destroyed_) {
+    return;
+  }
+  Deliveries deliveries;
+  deliveries.swap(deliveries_);
+  destroy();
+  for (auto& delivery : deliveries) {
+    ProduceFinishCbSharedPtr callback = delivery.second.lock();
+    if (callback != nullptr) {
+      callback->onPartitionResult(delivery.first.first, {delivery.first.second, error_code, -1});
+    }
+  }
+}
+
+void UpstreamKafkaProducer::InFlightBatch::destroy() {
+  if (!destroyed_) {
+    destroyed_ = true;
+    parent_.destroy(*this);
+  }
+}
+
+UpstreamKafkaFacadeImpl::UpstreamKafkaFacadeImpl(ThreadLocal::SlotAllocator& tls,
+                                                 Upstream::ClusterManager& cluster_manager)
+    : tls_(ThreadLocal::TypedSlot<ThreadLocalKafkaFacade>::makeUnique(tls)) {
+  tls_->set([&cluster_manager](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalKafkaFacade>(cluster_manager, dispatcher);
+  });
+}
+
+KafkaProducer& UpstreamKafkaFacadeImpl::getProducerForCluster(const ClusterConfig& cluster_config) {
+  ThreadLocalKafkaFacade& facade = **tls_;
+  std::unique_ptr<KafkaProducer>& producer = facade.producers_[cluster_config.name_];
+  if (producer == nullptr) {
+    producer = std::make_unique<UpstreamKafkaProducer>(cluster_config, facade.cluster_manager_,
+                                                       facade.dispatcher_);
+  }
+  return *producer;
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "envoy/common/pure.h"
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/timer.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "extensions/filters/network/kafka/external/responses.h"
+#include "extensions/filters/network/kafka/kafka_types.h"
+#include "extensions/filters/network/kafka/mesh/upstream_config.h"
+#include "extensions/filters/network/kafka/response_codec.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+constexpr int16_t ProduceRequestApiKey = 0;
+
+// Kafka error codes used when records could not be delivered upstream.
+constexpr int16_t UnknownServerError = -1;
+constexpr int16_t UnknownTopicOrPartition = 3;
+constexpr int16_t NetworkException = 13;
+
+/**
+ * Callback of the records sent to an upstream cluster.
+ */
+class ProduceFinishCb {
+public:
+  virtual ~ProduceFinishCb() = default;
+
+  /**
+   * Called once the upstream cluster has answered for the records of a partition, or once they
+   * could not be delivered. Never called for records sent with acks=0.
+   * @param topic topic of the records.
+   * @param result result of the partition, as received from upstream.
+   */
+  virtual void onPartitionResult(const std::string& topic,
+                                 const PartitionProduceResponse& result) PURE;
+};
+
+using ProduceFinishCbSharedPtr = std::shared_ptr<ProduceFinishCb>;
+
+/**
+ * Attributes of a produce request that the records sent upstream together need to share.
+ */
+struct ProduceSpec {
+  int16_t api_version_;
+  int16_t acks_;
+  NullableString transactional_id_;
+  int32_t timeout_ms_;
+};
+
+/**
+ * Sends the records of produce requests to an upstream cluster.
+ */
+class KafkaProducer {
+public:
+  virtual ~KafkaProducer() = default;
+
+  /**
+   * Sends the records of a partition upstream. The records may be held back for a while, so that
+   * they are sent together with the records of other requests.
+   * @param callback callback to be notified once the upstream cluster has answered. It's not kept
+   *        alive by the producer, so the results of a destroyed callback are dropped.
+   * @param spec attributes of the produce request carrying the records.
+   * @param topic topic of the records.
+   * @param partition partition of the records.
+   * @param records record batch.
+   */
+  virtual void send(const ProduceFinishCbSharedPtr& callback, const ProduceSpec& spec,
+                    const std::string& topic, int32_t partition,
+                    const NullableBytes& records) PURE;
+};
+
+/**
+ * Gives the producers of the current worker thread.
+ */
+class UpstreamKafkaFacade {
+public:
+  virtual ~UpstreamKafkaFacade() = default;
+
+  /**
+   * @param cluster_config upstream cluster.
+   * @return the producer of the current worker thread that sends records to given cluster.
+   */
+  virtual KafkaProducer& getProducerForCluster(const ClusterConfig& cluster_config) PURE;
+};
+
+using UpstreamKafkaFacadeSharedPtr = std::shared_ptr<UpstreamKafkaFacade>;
+
+/**
+ * Producer that batches the records of the produce requests received by a worker, and sends them
+ * upstream through the TCP connection pool of an Envoy cluster.
+ *
+ * Records are batched by the api version, acks and transactional id of their requests, as these
+ * are attributes of the whole upstream request. As a produce request may carry only a single
+ * record batch per partition, a batch holding records of a partition is sent upstream before more
+ * records of that partition are added. Batches are sent upstream once their linger time elapses,
+ * or once they exceed their maximum size.
+ */
+class UpstreamKafkaProducer : public KafkaProducer, private Logger::Loggable<Logger::Id::kafka> {
+public:
+  UpstreamKafkaProducer(const ClusterConfig& cluster_config,
+                        Upstream::ClusterManager& cluster_manager, Event::Dispatcher& dispatcher);
+  ~UpstreamKafkaProducer() override;
+
+  // KafkaProducer
+  void send(const ProduceFinishCbSharedPtr& callback, const ProduceSpec& spec,
+            const std::string& topic, int32_t partition, const NullableBytes& records) override;
+
+private:
+  // Api version, acks and transactional id of the requests whose records are sent together.
+  using BatchKey = std::tuple<int16_t, int16_t, NullableString>;
+  using TopicPartition = std::pair<std::string, int32_t>;
+  using Deliveries = std::map<TopicPartition, std::weak_ptr<ProduceFinishCb>>;
+
+  struct PendingBatch {
+    int32_t timeout_ms_{};
+    // Records by topic and partition.
+    std::map<std::string, std::map<int32_t, NullableBytes>> records_;
+    Deliveries deliveries_;
+    uint64_t size_{};
+  };
+
+  class InFlightBatch;
+  using InFlightBatchPtr = std::unique_ptr<InFlightBatch>;
+
+  class ResponseReceiver : public ResponseCallback {
+  public:
+    ResponseReceiver(InFlightBatch& parent) : parent_(parent) {}
+
+    // ResponseCallback
+    void onMessage(AbstractResponseSharedPtr response) override;
+    void onFailedParse(ResponseMetadataSharedPtr) override;
+
+  private:
+    InFlightBatch& parent_;
+  };
+
+  /**
+   * Upstream request carrying a batch, from the moment it's sent until it's answered.
+   */
+  class InFlightBatch : public Tcp::ConnectionPool::Callbacks,
+                        public Tcp::ConnectionPool::UpstreamCallbacks,
+                        public Event::DeferredDeletable,
+                        private Logger::Loggable<Logger::Id::kafka> {
+  public:
+    InFlightBatch(UpstreamKafkaProducer& parent, Deliveries&& deliveries,
+                  Buffer::OwnedImpl& request, int32_t correlation_id, int16_t api_version,
+                  bool expects_response);
+    ~InFlightBatch() override;
+
+    void start();
+    void onResponse(const AbstractResponseSharedPtr& response);
+    void close();
+
+    // Tcp::ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+
+    // Tcp::ConnectionPool::UpstreamCallbacks
+    void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+  private:
+    // Fails the deliveries that are still waiting, and destroys the batch.
+    void fail(int16_t error_code);
+    void destroy();
+
+    UpstreamKafkaProducer& parent_;
+    Deliveries deliveries_;
+    Buffer::OwnedImpl request_;
+    const int32_t correlation_id_;
+    const int16_t api_version_;
+    const bool expects_response_;
+    Tcp::ConnectionPool::Cancellable* pool_handle_{};
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    ResponseDecoderSharedPtr decoder_;
+    bool destroyed_{};
+  };
+
+  void flush(const BatchKey& key);
+  void flushAll();
+  void destroy(InFlightBatch& batch);
+
+  const ClusterConfig cluster_config_;
+  Upstream::ClusterManager& cluster_manager_;
+  Event::Dispatcher& dispatcher_;
+  const Event::TimerPtr linger_timer_;
+  std::map<BatchKey, PendingBatch> pending_;
+  std::list<InFlightBatchPtr> in_flight_;
+  int32_t next_correlation_id_{};
+};
+
+/**
+ * Keeps the producers of each worker thread, which are created on first use.
+ */
+class UpstreamKafkaFacadeImpl : public UpstreamKafkaFacade {
+public:
+  UpstreamKafkaFacadeImpl(ThreadLocal::SlotAllocator& tls,
+                          Upstream::ClusterManager& cluster_manager);
+
+  // UpstreamKafkaFacade
+  KafkaProducer& getProducerForCluster(const ClusterConfig& cluster_config) override;
+
+private:
+  struct ThreadLocalKafkaFacade : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalKafkaFacade(Upstream::ClusterManager& cluster_manager,
+                           Event::Dispatcher& dispatcher)
+        : cluster_manager_(cluster_manager), dispatcher_(dispatcher) {}
+
+    Upstream::ClusterManager& cluster_manager_;
+    Event::Dispatcher& dispatcher_;
+    // Producers by cluster name.
+    absl::flat_hash_map<std::string, std::unique_ptr<KafkaProducer>> producers_;
+  };
+
+  const ThreadLocal::TypedSlotPtr<ThreadLocalKafkaFacade> tls_;
+};
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
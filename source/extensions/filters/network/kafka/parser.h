@@ -113,6 +113,34 @@ private:
   ContextType context_;
 };
 
+/**
+ * Parser that consumes the payload of a message without deserializing it, and then returns a
+ * message carrying only the data that was captured into the context (e.g. the request header).
+ * The payload is only stepped over, so large payloads (like record batches) are never copied.
+ * @param ContextType context type, provides remaining size and the header-only message.
+ * @param ResponseType parse response type.
+ */
+template <typename ContextType, typename ResponseType> class AbstractPayloadSkippingParser {
+public:
+  AbstractPayloadSkippingParser(ContextType context) : context_{context} {};
+
+  ResponseType parse(absl::string_view& data) {
+    const uint32_t min = std::min<uint32_t>(context_->remaining(), data.size());
+    data = {data.data() + min, data.size() - min};
+    context_->remaining() -= min;
+    if (0 == context_->remaining()) {
+      return ResponseType::parsedMessage(context_->asHeaderOnlyMessage());
+    } else {
+      return ResponseType::stillWaiting();
+    }
+  }
+
+  const ContextType contextForTest() const { return context_; }
+
+private:
+  ContextType context_;
+};
+
 } // namespace Kafka
 } // namespace NetworkFilters
 } // namespace Extensions
@@ -117,6 +117,24 @@ std::string BufferHelper::removeBinary(Buffer::Instance& data) {
   return ret;
 }
 
+void BufferHelper::skipBytes(Buffer::Instance& data, uint64_t length) {
+  if (data.length() < length) {
+    throw EnvoyException("invalid buffer size");
+  }
+
+  data.drain(length);
+}
+
+void BufferHelper::skipCString(Buffer::Instance& data) {
+  char end = '\0';
+  ssize_t index = data.search(&end, sizeof(end), 0);
+  if (index == -1) {
+    throw EnvoyException("invalid CString");
+  }
+
+  data.drain(index + 1);
+}
+
 void BufferHelper::writeCString(Buffer::Instance& data, const std::string& value) {
   data.add(value.c_str(), value.size() + 1);
 }
@@ -369,13 +387,17 @@ std::string FieldImpl::toString() const {
   NOT_REACHED_GCOVR_EXCL_LINE;
 }
 
-void DocumentImpl::fromBuffer(Buffer::Instance& data) {
+void DocumentImpl::fromBuffer(Buffer::Instance& data, const KeySet* keys) {
   uint64_t original_buffer_length = data.length();
   int32_t message_length = BufferHelper::removeInt32(data);
   if (static_cast<uint64_t>(message_length) > original_buffer_length) {
     throw EnvoyException("invalid BSON message length");
   }
 
+  if (keys != nullptr) {
+    sparse_byte_size_ = message_length;
+  }
+
   ENVOY_LOG(trace, "BSON document length: {} data length: {}", message_length,
             original_buffer_length);
 
@@ -392,6 +414,16 @@ void DocumentImpl::fromBuffer(Buffer::Instance& data) {
     }
 
     uint8_t element_type = BufferHelper::removeByte(data);
+    // The first field is always kept, as it is the command name of a query.
+    if (keys != nullptr && !fields_.empty()) {
+      const absl::string_view peeked_key = peekKey(data);
+      if (!keys->contains(peeked_key)) {
+        data.drain(peeked_key.size() + 1);
+        skipValue(data, element_type);
+        continue;
+      }
+    }
+
     std::string key = BufferHelper::removeCString(data);
     ENVOY_LOG(trace, "BSON element type: {:#x} key: {}", element_type, key);
     switch (static_cast<Field::Type>(element_type)) {
@@ -418,13 +450,13 @@ void DocumentImpl::fromBuffer(Buffer::Instance& data) {
 
     case Field::Type::Document: {
       ENVOY_LOG(trace, "BSON document");
-      addDocument(key, DocumentImpl::create(data));
+      addDocument(key, keys != nullptr ? createSparse(data, *keys) : create(data));
       break;
     }
 
     case Field::Type::Array: {
       ENVOY_LOG(trace, "BSON array");
-      addArray(key, DocumentImpl::create(data));
+      addArray(key, keys != nullptr ? createSparse(data, *keys) : create(data));
       break;
     }
 
@@ -499,7 +531,81 @@ void DocumentImpl::fromBuffer(Buffer::Instance& data) {
   }
 }
 
+int32_t DocumentImpl::skip(Buffer::Instance& data) {
+  int32_t message_length = BufferHelper::peekInt32(data);
+  // Minimum size is 5.
+  if (message_length < static_cast<int32_t>(sizeof(int32_t) + 1) ||
+      static_cast<uint64_t>(message_length) > data.length()) {
+    throw EnvoyException("invalid BSON message length");
+  }
+
+  data.drain(message_length);
+  return message_length;
+}
+
+absl::string_view DocumentImpl::peekKey(Buffer::Instance& data) {
+  char end = '\0';
+  ssize_t index = data.search(&end, sizeof(end), 0);
+  if (index == -1) {
+    throw EnvoyException("invalid CString");
+  }
+
+  return {reinterpret_cast<char*>(data.linearize(index + 1)), static_cast<size_t>(index)};
+}
+
+void DocumentImpl::skipValue(Buffer::Instance& data, uint8_t element_type) {
+  switch (static_cast<Field::Type>(element_type)) {
+  case Field::Type::Double:
+  case Field::Type::Datetime:
+  case Field::Type::Timestamp:
+  case Field::Type::Int64:
+    BufferHelper::skipBytes(data, sizeof(int64_t));
+    return;
+
+  case Field::Type::String:
+  case Field::Type::Symbol:
+    BufferHelper::skipBytes(data, static_cast<uint32_t>(BufferHelper::removeInt32(data)));
+    return;
+
+  case Field::Type::Document:
+  case Field::Type::Array:
+    skip(data);
+    return;
+
+  case Field::Type::Binary:
+    // The length doesn't include the subtype.
+    BufferHelper::skipBytes(data, static_cast<uint32_t>(BufferHelper::removeInt32(data)) + 1ULL);
+    return;
+
+  case Field::Type::ObjectId:
+    BufferHelper::skipBytes(data, sizeof(Field::ObjectId));
+    return;
+
+  case Field::Type::Boolean:
+    BufferHelper::skipBytes(data, sizeof(uint8_t));
+    return;
+
+  case Field::Type::NullValue:
+    return;
+
+  case Field::Type::Regex:
+    BufferHelper::skipCString(data);
+    BufferHelper::skipCString(data);
+    return;
+
+  case Field::Type::Int32:
+    BufferHelper::skipBytes(data, sizeof(int32_t));
+    return;
+  }
+
+  throw EnvoyException(fmt::format("invalid BSON element type: {:#x}", element_type));
+}
+
 int32_t DocumentImpl::byteSize() const {
+  if (sparse_byte_size_ > 0) {
+    return sparse_byte_size_;
+  }
+
   // Minimum size is 5.
   int32_t total_size = sizeof(int32_t) + 1;
   for (const FieldPtr& field : fields_) {
@@ -12,6 +12,8 @@
 
 #include "extensions/filters/network/mongo_proxy/bson.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -32,6 +34,8 @@ public:
   static int64_t removeInt64(Buffer::Instance& data);
   static std::string removeString(Buffer::Instance& data);
   static std::string removeBinary(Buffer::Instance& data);
+  static void skipBytes(Buffer::Instance& data, uint64_t length);
+  static void skipCString(Buffer::Instance& data);
   static void writeCString(Buffer::Instance& data, const std::string& value);
   static void writeInt32(Buffer::Instance& data, int32_t value);
   static void writeInt64(Buffer::Instance& data, int64_t value);
@@ -178,6 +182,11 @@ private:
   Value value_;
 };
 
+/**
+ * The keys of the fields a sparse document is decoded with.
+ */
+using KeySet = absl::flat_hash_set<std::string>;
+
 class DocumentImpl : public Document,
                      Logger::Loggable<Logger::Id::mongo>,
                      public std::enable_shared_from_this<DocumentImpl> {
@@ -185,10 +194,28 @@ public:
   static DocumentSharedPtr create() { return DocumentSharedPtr{new DocumentImpl()}; }
   static DocumentSharedPtr create(Buffer::Instance& data) {
     std::shared_ptr<DocumentImpl> new_doc{new DocumentImpl()};
-    new_doc->fromBuffer(data);
+    new_doc->fromBuffer(data, nullptr);
     return new_doc;
   }
 
+  /**
+   * Decodes a document keeping only its first field and the fields with one of the given keys. The
+   * documents and arrays that are kept are decoded the same way. The other fields are skipped
+   * without being copied out of the buffer. byteSize() still returns the size of the whole document
+   * on the wire, so a sparse document is meant to be inspected, not modified or encoded.
+   */
+  static DocumentSharedPtr createSparse(Buffer::Instance& data, const KeySet& keys) {
+    std::shared_ptr<DocumentImpl> new_doc{new DocumentImpl()};
+    new_doc->fromBuffer(data, &keys);
+    return new_doc;
+  }
+
+  /**
+   * Skips a document without decoding its fields.
+   * @return int32_t the size of the document on the wire.
+   */
+  static int32_t skip(Buffer::Instance& data);
+
   // Mongo::Document
   DocumentSharedPtr addDouble(const std::string& key, double value) override {
     fields_.emplace_back(new FieldImpl(key, value));
@@ -271,9 +298,13 @@ public:
 private:
   DocumentImpl() = default;
 
-  void fromBuffer(Buffer::Instance& data);
+  void fromBuffer(Buffer::Instance& data, const KeySet* keys);
+  static absl::string_view peekKey(Buffer::Instance& data);
+  static void skipValue(Buffer::Instance& data, uint8_t element_type);
 
   std::list<FieldPtr> fields_;
+  // The size of a sparse document on the wire, or 0 if the document holds all of its fields.
+  int32_t sparse_byte_size_{};
 };
 
 } // namespace Bson
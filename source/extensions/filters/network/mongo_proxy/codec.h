@@ -152,6 +152,18 @@ public:
   virtual void numberReturned(int32_t number_returned) PURE;
   virtual const std::list<Bson::DocumentSharedPtr>& documents() const PURE;
   virtual std::list<Bson::DocumentSharedPtr>& documents() PURE;
+
+  /**
+   * @return uint64_t the number of documents of the reply, including the ones that were skipped
+   *         rather than decoded.
+   */
+  virtual uint64_t documentCount() const PURE;
+
+  /**
+   * @return uint64_t the size on the wire of the documents of the reply, including the ones that
+   *         were skipped rather than decoded.
+   */
+  virtual uint64_t documentsByteSize() const PURE;
 };
 
 using ReplyMessagePtr = std::unique_ptr<ReplyMessage>;
@@ -11,6 +11,7 @@
 
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
+#include "common/common/macros.h"
 
 #include "extensions/filters/network/mongo_proxy/bson_impl.h"
 
@@ -18,6 +19,20 @@ namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
 namespace MongoProxy {
+namespace {
+
+// The query fields QueryMessageInfo computes stats from, besides the first field, which is the
+// command name.
+const Bson::KeySet& queryStatsKeys() {
+  CONSTRUCT_ON_FIRST_USE(Bson::KeySet, {"$maxTimeMS", "maxTimeMS", "$query", "$comment", "_id",
+                                        "comment", "filter"});
+}
+
+// The fields kept of the documents stats don't look at, which is only the first one so the
+// document can still be logged at trace level.
+const Bson::KeySet& noKeys() { CONSTRUCT_ON_FIRST_USE(Bson::KeySet, {}); }
+
+} // namespace
 
 std::string
 MessageImpl::documentListToString(const std::list<Bson::DocumentSharedPtr>& documents) const {
@@ -68,6 +83,10 @@ void InsertMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& da
   flags_ = Bson::BufferHelper::removeInt32(data);
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   while (data.length() - (original_buffer_length - message_length) > 0) {
+    if (stats_only_) {
+      Bson::DocumentImpl::skip(data);
+      continue;
+    }
     documents_.emplace_back(Bson::DocumentImpl::create(data));
   }
 
@@ -142,10 +161,18 @@ void QueryMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& dat
   full_collection_name_ = Bson::BufferHelper::removeCString(data);
   number_to_skip_ = Bson::BufferHelper::removeInt32(data);
   number_to_return_ = Bson::BufferHelper::removeInt32(data);
-  query_ = Bson::DocumentImpl::create(data);
+  if (stats_only_) {
+    query_ = Bson::DocumentImpl::createSparse(data, queryStatsKeys());
+  } else {
+    query_ = Bson::DocumentImpl::create(data);
+  }
 
   if (data.length() - (original_buffer_length - message_length) > 0) {
-    return_fields_selector_ = Bson::DocumentImpl::create(data);
+    if (stats_only_) {
+      Bson::DocumentImpl::skip(data);
+    } else {
+      return_fields_selector_ = Bson::DocumentImpl::create(data);
+    }
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
@@ -190,12 +217,26 @@ void ReplyMessageImpl::fromBuffer(uint32_t, Buffer::Instance& data) {
   starting_from_ = Bson::BufferHelper::removeInt32(data);
   number_returned_ = Bson::BufferHelper::removeInt32(data);
   for (int32_t i = 0; i < number_returned_; i++) {
+    if (stats_only_) {
+      skipped_documents_byte_size_ += Bson::DocumentImpl::skip(data);
+      skipped_documents_++;
+      continue;
+    }
     documents_.emplace_back(Bson::DocumentImpl::create(data));
   }
 
   ENVOY_LOG(trace, "{}", toString(true));
 }
 
+uint64_t ReplyMessageImpl::documentsByteSize() const {
+  uint64_t byte_size = skipped_documents_byte_size_;
+  for (const Bson::DocumentSharedPtr& document : documents_) {
+    byte_size += document->byteSize();
+  }
+
+  return byte_size;
+}
+
 bool ReplyMessageImpl::operator==(const ReplyMessage& rhs) const {
   if (!(requestId() == rhs.requestId() && responseTo() == rhs.responseTo() &&
         flags() == rhs.flags() && cursorId() == rhs.cursorId() &&
@@ -219,7 +260,7 @@ std::string ReplyMessageImpl::toString(bool full) const {
       R"EOF({{"opcode": "OP_REPLY", "id": {}, "response_to": {}, "flags": "{:#x}", "cursor": "{}", )EOF"
       R"EOF("from": {}, "returned": {}, "documents": {}}})EOF",
       request_id_, response_to_, flags_, cursor_id_, starting_from_, number_returned_,
-      full ? documentListToString(documents_) : std::to_string(documents_.size()));
+      full ? documentListToString(documents_) : std::to_string(documentCount()));
 }
 
 /*
@@ -232,13 +273,22 @@ void CommandMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instance& d
 
   database_ = Bson::BufferHelper::removeCString(data);
   command_name_ = Bson::BufferHelper::removeCString(data);
-  metadata_ = Bson::DocumentImpl::create(data);
-  command_args_ = Bson::DocumentImpl::create(data);
+  if (stats_only_) {
+    metadata_ = Bson::DocumentImpl::createSparse(data, noKeys());
+    command_args_ = Bson::DocumentImpl::createSparse(data, noKeys());
+  } else {
+    metadata_ = Bson::DocumentImpl::create(data);
+    command_args_ = Bson::DocumentImpl::create(data);
+  }
 
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
+    if (stats_only_) {
+      Bson::DocumentImpl::skip(data);
+      continue;
+    }
     input_docs_.emplace_back(Bson::DocumentImpl::create(data));
   }
 
@@ -292,13 +342,22 @@ void CommandReplyMessageImpl::fromBuffer(uint32_t message_length, Buffer::Instan
   const uint64_t original_data_length = data.length();
   ASSERT(data.length() >= message_length); // See comment below about relationship.
 
-  metadata_ = Bson::DocumentImpl::create(data);
-  command_reply_ = Bson::DocumentImpl::create(data);
+  if (stats_only_) {
+    metadata_ = Bson::DocumentImpl::createSparse(data, noKeys());
+    command_reply_ = Bson::DocumentImpl::createSparse(data, noKeys());
+  } else {
+    metadata_ = Bson::DocumentImpl::create(data);
+    command_reply_ = Bson::DocumentImpl::create(data);
+  }
 
   // There may be additional docs.
   // message_length is mongo message length. original_data_length contains
   // mongo message and possibly first few bytes of next message.
   while (data.length() - (original_data_length - message_length) > 0) {
+    if (stats_only_) {
+      Bson::DocumentImpl::skip(data);
+      continue;
+    }
     output_docs_.emplace_back(Bson::DocumentImpl::create(data));
   }
 
@@ -368,6 +427,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   switch (op_code) {
   case Message::OpCode::Reply: {
     std::unique_ptr<ReplyMessageImpl> message(new ReplyMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeReply(std::move(message));
     break;
@@ -375,6 +435,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Query: {
     std::unique_ptr<QueryMessageImpl> message(new QueryMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeQuery(std::move(message));
     break;
@@ -382,6 +443,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::GetMore: {
     std::unique_ptr<GetMoreMessageImpl> message(new GetMoreMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeGetMore(std::move(message));
     break;
@@ -389,6 +451,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Insert: {
     std::unique_ptr<InsertMessageImpl> message(new InsertMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeInsert(std::move(message));
     break;
@@ -397,6 +460,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   case Message::OpCode::KillCursors: {
     std::unique_ptr<KillCursorsMessageImpl> message(
         new KillCursorsMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeKillCursors(std::move(message));
     break;
@@ -404,6 +468,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
 
   case Message::OpCode::Command: {
     std::unique_ptr<CommandMessageImpl> message(new CommandMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeCommand(std::move(message));
     break;
@@ -412,6 +477,7 @@ bool DecoderImpl::decode(Buffer::Instance& data) {
   case Message::OpCode::CommandReply: {
     std::unique_ptr<CommandReplyMessageImpl> message(
         new CommandReplyMessageImpl(request_id, response_to));
+    message->statsOnly(stats_only_);
     message->fromBuffer(message_length, data);
     callbacks_.decodeCommandReply(std::move(message));
     break;
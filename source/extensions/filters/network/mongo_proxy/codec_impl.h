@@ -21,6 +21,12 @@ public:
 
   virtual void fromBuffer(uint32_t message_length, Buffer::Instance& data) PURE;
 
+  /**
+   * Sets whether the message is decoded only to compute stats. The documents that stats don't
+   * look at are then skipped, and queries only keep the fields QueryMessageInfo reads.
+   */
+  void statsOnly(bool stats_only) { stats_only_ = stats_only; }
+
   // Mongo::Message
   int32_t requestId() const override { return request_id_; }
   int32_t responseTo() const override { return response_to_; }
@@ -30,6 +36,7 @@ protected:
 
   const int32_t request_id_;
   const int32_t response_to_;
+  bool stats_only_{};
 };
 
 class GetMoreMessageImpl : public MessageImpl,
@@ -178,6 +185,8 @@ public:
   void numberReturned(int32_t number_returned) override { number_returned_ = number_returned; }
   const std::list<Bson::DocumentSharedPtr>& documents() const override { return documents_; }
   std::list<Bson::DocumentSharedPtr>& documents() override { return documents_; }
+  uint64_t documentCount() const override { return documents_.size() + skipped_documents_; }
+  uint64_t documentsByteSize() const override;
 
 private:
   int32_t flags_{};
@@ -185,6 +194,8 @@ private:
   int32_t starting_from_{};
   int32_t number_returned_{};
   std::list<Bson::DocumentSharedPtr> documents_;
+  uint64_t skipped_documents_{};
+  uint64_t skipped_documents_byte_size_{};
 };
 
 // OP_COMMAND message.
@@ -251,7 +262,13 @@ private:
 
 class DecoderImpl : public Decoder, Logger::Loggable<Logger::Id::mongo> {
 public:
-  DecoderImpl(DecoderCallbacks& callbacks) : callbacks_(callbacks) {}
+  /**
+   * @param callbacks supplies the callbacks the decoded messages are passed to.
+   * @param stats_only supplies whether the messages are decoded only to compute stats.
+   *        @see MessageImpl::statsOnly().
+   */
+  DecoderImpl(DecoderCallbacks& callbacks, bool stats_only = false)
+      : callbacks_(callbacks), stats_only_(stats_only) {}
 
   // Mongo::Decoder
   void onData(Buffer::Instance& data) override;
@@ -260,6 +277,7 @@ private:
   bool decode(Buffer::Instance& data);
 
   DecoderCallbacks& callbacks_;
+  const bool stats_only_;
 };
 
 class EncoderImpl : public Encoder, Logger::Loggable<Logger::Id::mongo> {
@@ -74,18 +74,16 @@ ProxyFilter::ProxyFilter(const std::string& stat_prefix, Stats::Scope& scope,
 ProxyFilter::~ProxyFilter() { ASSERT(!delay_timer_); }
 
 void ProxyFilter::setDynamicMetadata(std::string operation, std::string resource) {
-  ProtobufWkt::Struct metadata(
+  // The operation is appended in place, rather than merging a copy of the whole namespace back.
+  ProtobufWkt::Struct& metadata =
       (*read_callbacks_->connection()
             .streamInfo()
             .dynamicMetadata()
-            .mutable_filter_metadata())[NetworkFilterNames::get().MongoProxy]);
+            .mutable_filter_metadata())[NetworkFilterNames::get().MongoProxy];
   auto& fields = *metadata.mutable_fields();
   // TODO(rshriram): reverse the resource string (table.db)
   auto& operations = *fields[resource].mutable_list_value();
   operations.add_values()->set_string_value(operation);
-
-  read_callbacks_->connection().streamInfo().setDynamicMetadata(
-      NetworkFilterNames::get().MongoProxy, metadata);
 }
 
 void ProxyFilter::decodeGetMore(GetMoreMessagePtr&& message) {
@@ -292,20 +290,16 @@ void ProxyFilter::onDrainClose() {
 
 void ProxyFilter::chargeReplyStats(ActiveQuery& active_query, Stats::ElementVec& names,
                                    const ReplyMessage& message) {
-  uint64_t reply_documents_byte_size = 0;
-  for (const Bson::DocumentSharedPtr& document : message.documents()) {
-    reply_documents_byte_size += document->byteSize();
-  }
-
   // Write 3 different histograms; appending 3 different suffixes to the name
   // that was passed in. Here we overwrite the passed-in names, but we restore
   // names to its original state upon return.
   const size_t orig_size = names.size();
   names.push_back(mongo_stats_->reply_num_docs_);
   mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Unspecified,
-                                message.documents().size());
+                                message.documentCount());
   names[orig_size] = mongo_stats_->reply_size_;
-  mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Bytes, reply_documents_byte_size);
+  mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Bytes,
+                                message.documentsByteSize());
   names[orig_size] = mongo_stats_->reply_time_ms_;
   mongo_stats_->recordHistogram(names, Stats::Histogram::Unit::Milliseconds,
                                 std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -389,7 +383,7 @@ Network::FilterStatus ProxyFilter::onWrite(Buffer::Instance& data, bool) {
 }
 
 DecoderPtr ProdProxyFilter::createDecoder(DecoderCallbacks& callbacks) {
-  return DecoderPtr{new DecoderImpl(callbacks)};
+  return DecoderPtr{new DecoderImpl(callbacks, statsOnly())};
 }
 
 absl::optional<std::chrono::milliseconds> ProxyFilter::delayDuration() {
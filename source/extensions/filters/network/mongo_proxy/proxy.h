@@ -142,6 +142,11 @@ public:
 
   void setDynamicMetadata(std::string operation, std::string resource);
 
+protected:
+  // Whether messages are decoded only to compute stats, which is the case when they aren't
+  // logged.
+  bool statsOnly() const { return access_log_ == nullptr; }
+
 private:
   struct ActiveQuery {
     ActiveQuery(ProxyFilter& parent, const QueryMessage& query)
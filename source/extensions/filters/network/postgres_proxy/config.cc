@@ -1,5 +1,7 @@
 #include "extensions/filters/network/postgres_proxy/config.h"
 
+#include "common/config/datasource.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -19,6 +21,12 @@ NetworkFilters::PostgresProxy::PostgresConfigFactory::createFilterFactoryFromPro
   config_options.enable_sql_parsing_ =
       PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config, enable_sql_parsing, true);
   config_options.terminate_ssl_ = proto_config.terminate_ssl();
+  if (proto_config.has_transaction_pooling()) {
+    const auto& pooling = proto_config.transaction_pooling();
+    config_options.transaction_pooling_ = std::make_shared<const TransactionPoolingConfig>(
+        context.clusterManager(), pooling.cluster(), pooling.user(), pooling.database(),
+        Config::DataSource::read(pooling.password(), true, context.api()));
+  }
 
   PostgresFilterConfigSharedPtr filter_config(
       std::make_shared<PostgresFilterConfig>(config_options, context.scope()));
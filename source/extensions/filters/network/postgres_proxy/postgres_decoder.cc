@@ -85,7 +85,8 @@ void DecoderImpl::initialize() {
   BE_known_msgs['S'] = MessageProcessor{"ParameterStatus", BODY_FORMAT(String, String), {}};
   BE_known_msgs['1'] = MessageProcessor{"ParseComplete", NO_BODY, {}};
   BE_known_msgs['s'] = MessageProcessor{"PortalSuspend", NO_BODY, {}};
-  BE_known_msgs['Z'] = MessageProcessor{"ReadyForQuery", BODY_FORMAT(Byte1), {}};
+  BE_known_msgs['Z'] = MessageProcessor{
+      "ReadyForQuery", BODY_FORMAT(Byte1), {&DecoderImpl::decodeBackendReadyForQuery}};
   BE_known_msgs['T'] = MessageProcessor{
       "RowDescription",
       BODY_FORMAT(Array<Sequence<String, Int32, Int16, Int32, Int16, Int32, Int16>>),
@@ -384,6 +385,14 @@ void DecoderImpl::decodeBackendErrorResponse() { decodeErrorNotice(BE_errors_);
 // indicating its meaning. It can be warning, notice, info, debug or log.
 void DecoderImpl::decodeBackendNoticeResponse() { decodeErrorNotice(BE_notices_); }
 
+// Method parses Z (ReadyForQuery) message, whose only byte is the transaction status.
+void DecoderImpl::decodeBackendReadyForQuery() {
+  if (message_.empty()) {
+    return;
+  }
+  callbacks_->onReadyForQuery(message_[0]);
+}
+
 // Method parses Parse message of the following format:
 // String: The name of the destination prepared statement (an empty string selects the unnamed
 // prepared statement).
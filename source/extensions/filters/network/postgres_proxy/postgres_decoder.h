@@ -45,6 +45,10 @@ public:
   virtual void processQuery(const std::string&) PURE;
 
   virtual bool onSSLRequest() PURE;
+
+  // Called when the server is ready for the next query, with the transaction status it reported:
+  // 'I' if idle, 'T' if in a transaction block or 'E' if in a failed transaction block.
+  virtual void onReadyForQuery(char transaction_status) PURE;
 };
 
 // Postgres message decoder.
@@ -138,6 +142,7 @@ protected:
   void decodeBackendStatements();
   void decodeBackendErrorResponse();
   void decodeBackendNoticeResponse();
+  void decodeBackendReadyForQuery();
   void decodeFrontendTerminate();
   void decodeErrorNotice(MsgParserDict& types);
   void onQuery();
@@ -14,7 +14,8 @@ namespace PostgresProxy {
 PostgresFilterConfig::PostgresFilterConfig(const PostgresFilterConfigOptions& config_options,
                                            Stats::Scope& scope)
     : enable_sql_parsing_(config_options.enable_sql_parsing_),
-      terminate_ssl_(config_options.terminate_ssl_), scope_{scope},
+      terminate_ssl_(config_options.terminate_ssl_),
+      transaction_pooling_(config_options.transaction_pooling_), scope_{scope},
       stats_{generateStats(config_options.stats_prefix_, scope)} {}
 
 PostgresFilter::PostgresFilter(PostgresFilterConfigSharedPtr config) : config_{config} {
@@ -28,12 +29,30 @@ Network::FilterStatus PostgresFilter::onData(Buffer::Instance& data, bool) {
   ENVOY_CONN_LOG(trace, "postgres_proxy: got {} bytes", read_callbacks_->connection(),
                  data.length());
 
+  // The decoder takes a GSSENCRequest for the start of an encrypted session, which a pooled session
+  // can't be. The client falls back to an unencrypted session when told that encryption is not
+  // supported.
+  if (pooled_session_ != nullptr && frontend_buffer_.length() == 0 &&
+      PooledSession::isGssEncRequest(data)) {
+    Buffer::OwnedImpl buf;
+    buf.add("N");
+    read_callbacks_->connection().write(buf, false);
+    data.drain(PooledSession::GssEncRequestLength);
+  }
+
   // Frontend Buffer
   frontend_buffer_.add(data);
   Network::FilterStatus result = doDecode(frontend_buffer_, true);
   if (result == Network::FilterStatus::StopIteration) {
     ASSERT(frontend_buffer_.length() == 0);
     data.drain(data.length());
+    return result;
+  }
+
+  // In transaction pooling mode the filter is terminal.
+  if (pooled_session_ != nullptr) {
+    pooled_session_->onClientData(data);
+    return Network::FilterStatus::StopIteration;
   }
   return result;
 }
@@ -42,6 +61,10 @@ Network::FilterStatus PostgresFilter::onNewConnection() { return Network::Filter
 
 void PostgresFilter::initializeReadFilterCallbacks(Network::ReadFilterCallbacks& callbacks) {
   read_callbacks_ = &callbacks;
+  if (config_->transaction_pooling_ != nullptr) {
+    pooled_session_ =
+        std::make_unique<PooledSession>(*config_->transaction_pooling_, config_->stats_, callbacks);
+  }
 }
 
 // Network::WriteFilter
@@ -190,8 +213,16 @@ void PostgresFilter::processQuery(const std::string& sql) {
 
 bool PostgresFilter::onSSLRequest() {
   if (!config_->terminate_ssl_) {
-    // Signal to the decoder to continue.
-    return true;
+    if (pooled_session_ == nullptr) {
+      // Signal to the decoder to continue.
+      return true;
+    }
+    // The pooled session can't be encrypted end to end, so tell the client that encryption is not
+    // supported and wait for its StartupMessage.
+    Buffer::OwnedImpl buf;
+    buf.add("N");
+    read_callbacks_->connection().write(buf, false);
+    return false;
   }
   // Send single bytes 'S' to indicate switch to TLS.
   // Refer to official documentation for protocol details:
@@ -226,6 +257,12 @@ bool PostgresFilter::onSSLRequest() {
   return false;
 }
 
+void PostgresFilter::onReadyForQuery(char transaction_status) {
+  if (pooled_session_ != nullptr) {
+    pooled_session_->onReadyForQuery(transaction_status);
+  }
+}
+
 Network::FilterStatus PostgresFilter::doDecode(Buffer::Instance& data, bool frontend) {
   // Keep processing data until buffer is empty or decoder says
   // that it cannot process data in the buffer.
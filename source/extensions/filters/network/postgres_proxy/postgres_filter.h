@@ -9,6 +9,7 @@
 #include "common/common/logger.h"
 
 #include "extensions/filters/network/postgres_proxy/postgres_decoder.h"
+#include "extensions/filters/network/postgres_proxy/postgres_pooling.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -49,7 +50,10 @@ namespace PostgresProxy {
   COUNTER(notices_debug)                                                                           \
   COUNTER(notices_info)                                                                            \
   COUNTER(notices_log)                                                                             \
-  COUNTER(notices_unknown)
+  COUNTER(notices_unknown)                                                                         \
+  COUNTER(pool_checkouts)                                                                          \
+  COUNTER(pool_errors)                                                                             \
+  COUNTER(pool_logins)
 
 /**
  * Struct definition for all Postgres proxy stats. @see stats_macros.h
@@ -67,11 +71,14 @@ public:
     std::string stats_prefix_;
     bool enable_sql_parsing_;
     bool terminate_ssl_;
+    // Set if the filter runs in transaction pooling mode.
+    TransactionPoolingConfigSharedPtr transaction_pooling_;
   };
   PostgresFilterConfig(const PostgresFilterConfigOptions& config_options, Stats::Scope& scope);
 
   bool enable_sql_parsing_{true};
   bool terminate_ssl_{false};
+  const TransactionPoolingConfigSharedPtr transaction_pooling_;
   Stats::Scope& scope_;
   PostgresProxyStats stats_;
 
@@ -112,6 +119,7 @@ public:
   void incTransactionsRollback() override;
   void processQuery(const std::string&) override;
   bool onSSLRequest() override;
+  void onReadyForQuery(char transaction_status) override;
 
   Network::FilterStatus doDecode(Buffer::Instance& data, bool);
   DecoderPtr createDecoder(DecoderCallbacks* callbacks);
@@ -131,6 +139,8 @@ private:
   Buffer::OwnedImpl frontend_buffer_;
   Buffer::OwnedImpl backend_buffer_;
   std::unique_ptr<Decoder> decoder_;
+  // Set in transaction pooling mode.
+  PooledSessionPtr pooled_session_;
 };
 
 } // namespace PostgresProxy
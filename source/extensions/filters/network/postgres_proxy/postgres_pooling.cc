@@ -0,0 +1,369 @@
+#include "extensions/filters/network/postgres_proxy/postgres_pooling.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+#include "extensions/filters/network/postgres_proxy/postgres_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace PostgresProxy {
+namespace {
+
+// The size of the type and the length of a message.
+constexpr uint64_t MessageHeaderSize = 5;
+
+void addCString(Buffer::Instance& data, absl::string_view value) {
+  data.add(value);
+  data.writeByte(0);
+}
+
+void addMessage(Buffer::Instance& data, char type, Buffer::Instance& body) {
+  data.writeByte(type);
+  data.writeBEInt<uint32_t>(sizeof(uint32_t) + body.length());
+  data.move(body);
+}
+
+} // namespace
+
+PooledSession::PooledSession(const TransactionPoolingConfig& config, PostgresProxyStats& stats,
+                             Network::ReadFilterCallbacks& read_callbacks)
+    : config_(config), stats_(stats), read_callbacks_(read_callbacks) {}
+
+PooledSession::~PooledSession() {
+  state_ = State::Closed;
+  if (upstream_handle_ != nullptr) {
+    upstream_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+  // The server may still be running a transaction of the client, so the connection can't be
+  // reused.
+  if (conn_data_ != nullptr &&
+      (login_state_ != nullptr || pending_ready_for_query_ > 0 || unsynced_ || in_transaction_)) {
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data = std::move(conn_data_);
+    conn_data->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void PooledSession::onClientData(Buffer::Instance& data) {
+  client_buffer_.move(data);
+  processClientData();
+}
+
+void PooledSession::onReadyForQuery(char transaction_status) {
+  if (state_ != State::Ready) {
+    return;
+  }
+
+  if (pending_ready_for_query_ > 0) {
+    pending_ready_for_query_--;
+  }
+  in_transaction_ = transaction_status != 'I';
+  mayReleaseUpstream();
+}
+
+void PooledSession::processClientData() {
+  while (state_ == State::AwaitingStartup) {
+    if (client_buffer_.length() < 2 * sizeof(uint32_t)) {
+      return;
+    }
+    const uint32_t length = client_buffer_.peekBEInt<uint32_t>();
+    if (length < 2 * sizeof(uint32_t) || length > MaxStartupMessageLength) {
+      fail("invalid startup packet length");
+      return;
+    }
+    if (client_buffer_.length() < length) {
+      return;
+    }
+
+    // The parameters of the client are ignored, as the upstream connections are shared.
+    const uint32_t code = client_buffer_.peekBEInt<uint32_t>(sizeof(uint32_t));
+    client_buffer_.drain(length);
+    if (code != ProtocolVersion) {
+      fail(fmt::format("unsupported startup request {:#x}", code));
+      return;
+    }
+
+    state_ = State::StartingUp;
+    acquireUpstream();
+  }
+
+  if (state_ != State::Ready) {
+    return;
+  }
+
+  while (client_buffer_.length() >= MessageHeaderSize) {
+    const char type = client_buffer_.peekInt<char>();
+    const uint32_t length = client_buffer_.peekBEInt<uint32_t>(1);
+    if (length < sizeof(uint32_t)) {
+      fail("invalid message length");
+      return;
+    }
+    if (client_buffer_.length() < 1 + static_cast<uint64_t>(length)) {
+      break;
+    }
+
+    switch (type) {
+    case 'X':
+      // The upstream connection outlives the session of the client.
+      client_buffer_.drain(client_buffer_.length());
+      read_callbacks_.connection().close(Network::ConnectionCloseType::FlushWrite);
+      return;
+    case 'Q':
+    case 'F':
+      pending_ready_for_query_++;
+      break;
+    case 'S':
+      pending_ready_for_query_++;
+      unsynced_ = false;
+      break;
+    case 'P':
+    case 'B':
+    case 'D':
+    case 'E':
+    case 'C':
+    case 'H':
+      unsynced_ = true;
+      break;
+    default:
+      break;
+    }
+    upstream_request_.move(client_buffer_, 1 + length);
+  }
+
+  if (upstream_request_.length() == 0) {
+    return;
+  }
+  if (conn_data_ != nullptr && login_state_ == nullptr) {
+    conn_data_->connection().write(upstream_request_, false);
+  } else if (conn_data_ == nullptr && upstream_handle_ == nullptr) {
+    acquireUpstream();
+  }
+}
+
+void PooledSession::acquireUpstream() {
+  Upstream::ThreadLocalCluster* cluster =
+      config_.cluster_manager_.getThreadLocalCluster(config_.cluster_);
+  if (cluster == nullptr) {
+    fail(fmt::format("unknown cluster '{}'", config_.cluster_));
+    return;
+  }
+
+  Tcp::ConnectionPool::Instance* conn_pool =
+      cluster->tcpConnPool(Upstream::ResourcePriority::Default, nullptr);
+  if (conn_pool == nullptr) {
+    fail(fmt::format("no healthy upstream for '{}'", config_.cluster_));
+    return;
+  }
+
+  // The pool may call back before newConnection() returns.
+  Tcp::ConnectionPool::Cancellable* handle = conn_pool->newConnection(*this);
+  if (handle != nullptr && conn_data_ == nullptr && state_ != State::Closed) {
+    upstream_handle_ = handle;
+  }
+}
+
+void PooledSession::onPoolFailure(ConnectionPool::PoolFailureReason,
+                                  Upstream::HostDescriptionConstSharedPtr) {
+  upstream_handle_ = nullptr;
+  fail("cannot connect to the server");
+}
+
+void PooledSession::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
+                                Upstream::HostDescriptionConstSharedPtr) {
+  upstream_handle_ = nullptr;
+  conn_data_ = std::move(conn);
+  conn_data_->addUpstreamCallbacks(*this);
+  stats_.pool_checkouts_.inc();
+
+  if (conn_data_->connectionStateTyped<UpstreamConnectionState>() == nullptr) {
+    login_state_ = std::make_unique<UpstreamConnectionState>();
+    sendStartup();
+    return;
+  }
+  onUpstreamReady();
+}
+
+void PooledSession::onUpstreamReady() {
+  if (state_ == State::StartingUp) {
+    UpstreamConnectionState* upstream_state =
+        conn_data_->connectionStateTyped<UpstreamConnectionState>();
+    ASSERT(upstream_state != nullptr);
+
+    Buffer::OwnedImpl reply;
+    Buffer::OwnedImpl body;
+    body.writeBEInt<uint32_t>(0);
+    addMessage(reply, 'R', body);
+    reply.add(upstream_state->parameter_status_);
+    body.writeByte('I');
+    addMessage(reply, 'Z', body);
+
+    // The upstream connection is released once the decoder sees the ReadyForQuery.
+    state_ = State::Ready;
+    read_callbacks_.connection().write(reply, false);
+    processClientData();
+    return;
+  }
+
+  if (upstream_request_.length() > 0) {
+    conn_data_->connection().write(upstream_request_, false);
+  } else {
+    mayReleaseUpstream();
+  }
+}
+
+void PooledSession::onUpstreamData(Buffer::Instance& data, bool) {
+  if (login_state_ != nullptr) {
+    processLogin(data);
+    return;
+  }
+
+  read_callbacks_.connection().write(data, false);
+}
+
+void PooledSession::onEvent(Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::RemoteClose &&
+      event != Network::ConnectionEvent::LocalClose) {
+    return;
+  }
+
+  // The pool releases the connection itself.
+  if (conn_data_ == nullptr) {
+    return;
+  }
+  conn_data_.reset();
+  login_state_.reset();
+  fail("server closed the connection unexpectedly");
+}
+
+void PooledSession::processLogin(Buffer::Instance& data) {
+  login_buffer_.move(data);
+  while (login_state_ != nullptr && login_buffer_.length() >= MessageHeaderSize) {
+    const char type = login_buffer_.peekInt<char>();
+    const uint32_t length = login_buffer_.peekBEInt<uint32_t>(1);
+    if (length < sizeof(uint32_t)) {
+      fail("invalid message length from the server");
+      return;
+    }
+    if (login_buffer_.length() < 1 + static_cast<uint64_t>(length)) {
+      return;
+    }
+
+    switch (type) {
+    case 'R': {
+      if (length < 2 * sizeof(uint32_t)) {
+        fail("invalid authentication request from the server");
+        return;
+      }
+      // 0 is AuthenticationOk and 3 AuthenticationCleartextPassword.
+      const uint32_t code = login_buffer_.peekBEInt<uint32_t>(MessageHeaderSize);
+      if (code == 3) {
+        if (config_.password_.empty()) {
+          fail("the server asks for a password but none is configured");
+          return;
+        }
+        sendPassword();
+      } else if (code != 0) {
+        fail(fmt::format("unsupported authentication request {} from the server", code));
+        return;
+      }
+      login_buffer_.drain(1 + length);
+      break;
+    }
+    case 'S':
+      login_state_->parameter_status_.move(login_buffer_, 1 + length);
+      break;
+    case 'E':
+      fail(fmt::format("the server refused the login of '{}'", config_.user_));
+      return;
+    case 'Z': {
+      login_buffer_.drain(login_buffer_.length());
+      conn_data_->setConnectionState(std::move(login_state_));
+      stats_.pool_logins_.inc();
+      onUpstreamReady();
+      return;
+    }
+    default:
+      // BackendKeyData isn't passed to the clients, as their sessions don't own the connection.
+      login_buffer_.drain(1 + length);
+      break;
+    }
+  }
+}
+
+void PooledSession::sendStartup() {
+  Buffer::OwnedImpl body;
+  body.writeBEInt<uint32_t>(ProtocolVersion);
+  addCString(body, "user");
+  addCString(body, config_.user_);
+  addCString(body, "database");
+  addCString(body, config_.database_);
+  body.writeByte(0);
+
+  Buffer::OwnedImpl startup;
+  startup.writeBEInt<uint32_t>(sizeof(uint32_t) + body.length());
+  startup.move(body);
+  conn_data_->connection().write(startup, false);
+}
+
+void PooledSession::sendPassword() {
+  Buffer::OwnedImpl body;
+  addCString(body, config_.password_);
+  Buffer::OwnedImpl message;
+  addMessage(message, 'p', body);
+  conn_data_->connection().write(message, false);
+}
+
+void PooledSession::mayReleaseUpstream() {
+  if (conn_data_ != nullptr && login_state_ == nullptr && pending_ready_for_query_ == 0 &&
+      !unsynced_ && !in_transaction_ && upstream_request_.length() == 0) {
+    releaseUpstream();
+  }
+}
+
+void PooledSession::releaseUpstream() {
+  ENVOY_CONN_LOG(trace, "postgres_proxy: returning the upstream connection to the pool",
+                 read_callbacks_.connection());
+  conn_data_.reset();
+}
+
+void PooledSession::fail(const std::string& message) {
+  if (state_ == State::Closed) {
+    return;
+  }
+  state_ = State::Closed;
+  stats_.pool_errors_.inc();
+  ENVOY_CONN_LOG(debug, "postgres_proxy: closing the pooled session: {}",
+                 read_callbacks_.connection(), message);
+
+  if (upstream_handle_ != nullptr) {
+    upstream_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+    upstream_handle_ = nullptr;
+  }
+  if (conn_data_ != nullptr) {
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data = std::move(conn_data_);
+    login_state_.reset();
+    conn_data->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+
+  // 08006 is the SQLSTATE of a connection failure.
+  Buffer::OwnedImpl body;
+  body.writeByte('S');
+  addCString(body, "FATAL");
+  body.writeByte('V');
+  addCString(body, "FATAL");
+  body.writeByte('C');
+  addCString(body, "08006");
+  body.writeByte('M');
+  addCString(body, message);
+  body.writeByte(0);
+  Buffer::OwnedImpl error;
+  addMessage(error, 'E', body);
+  read_callbacks_.connection().write(error, false);
+  read_callbacks_.connection().close(Network::ConnectionCloseType::FlushWrite);
+}
+
+} // namespace PostgresProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
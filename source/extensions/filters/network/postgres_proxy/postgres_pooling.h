@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/network/connection.h"
+#include "envoy/network/filter.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/upstream/cluster_manager.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace PostgresProxy {
+
+struct PostgresProxyStats;
+
+/**
+ * Configuration of the transaction pooling mode of the Postgres proxy filter.
+ */
+struct TransactionPoolingConfig {
+  TransactionPoolingConfig(Upstream::ClusterManager& cluster_manager, const std::string& cluster,
+                           const std::string& user, const std::string& database,
+                           const std::string& password)
+      : cluster_manager_(cluster_manager), cluster_(cluster), user_(user),
+        database_(database.empty() ? user : database), password_(password) {}
+
+  Upstream::ClusterManager& cluster_manager_;
+  const std::string cluster_;
+  const std::string user_;
+  const std::string database_;
+  const std::string password_;
+};
+
+using TransactionPoolingConfigSharedPtr = std::shared_ptr<const TransactionPoolingConfig>;
+
+/**
+ * The session of a client in transaction pooling mode. The session answers the startup of the
+ * client itself, then forwards the messages of the client to an upstream connection taken from the
+ * TCP connection pool of the cluster, and returns the connection to the pool once the transaction
+ * is over. The upstream connections log in once, when they are established, and the parameters
+ * their server reported are replayed to the clients that use them.
+ *
+ * The end of a transaction is reported by the filter, whose decoder sees the ReadyForQuery
+ * messages the session writes to the client. @see onReadyForQuery().
+ */
+class PooledSession : public Tcp::ConnectionPool::Callbacks,
+                      public Tcp::ConnectionPool::UpstreamCallbacks,
+                      Logger::Loggable<Logger::Id::filter> {
+public:
+  PooledSession(const TransactionPoolingConfig& config, PostgresProxyStats& stats,
+                Network::ReadFilterCallbacks& read_callbacks);
+  ~PooledSession() override;
+
+  /**
+   * Called with the data received from the client, other than the SSLRequest or GSSENCRequest the
+   * filter already answered.
+   */
+  void onClientData(Buffer::Instance& data);
+
+  /**
+   * Called when the server is ready for the next query of the client.
+   * @param transaction_status supplies the transaction status reported by the server.
+   */
+  void onReadyForQuery(char transaction_status);
+
+  // Tcp::ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+  void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
+                   Upstream::HostDescriptionConstSharedPtr host) override;
+
+  // Tcp::ConnectionPool::UpstreamCallbacks
+  void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+  void onEvent(Network::ConnectionEvent event) override;
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+  // The code of the protocol version 3.0 in a StartupMessage.
+  static constexpr uint32_t ProtocolVersion = 0x00030000;
+  // Startup messages longer than this are rejected, like the server does.
+  static constexpr uint32_t MaxStartupMessageLength = 10000;
+  // The code and the length of a GSSENCRequest.
+  static constexpr uint32_t GssEncRequestCode = 80877104;
+  static constexpr uint32_t GssEncRequestLength = 8;
+
+  /**
+   * @return whether the data starts with a GSSENCRequest.
+   */
+  static bool isGssEncRequest(const Buffer::Instance& data) {
+    return data.length() >= GssEncRequestLength &&
+           data.peekBEInt<uint32_t>() == GssEncRequestLength &&
+           data.peekBEInt<uint32_t>(sizeof(uint32_t)) == GssEncRequestCode;
+  }
+
+private:
+  enum class State {
+    // Waiting for the StartupMessage of the client.
+    AwaitingStartup,
+    // Waiting for an upstream connection to answer the StartupMessage of the client.
+    StartingUp,
+    // Forwarding the messages of the client.
+    Ready,
+    Closed
+  };
+
+  // The state kept with a pooled upstream connection once it logged in.
+  struct UpstreamConnectionState : public Tcp::ConnectionPool::ConnectionState {
+    // The ParameterStatus messages the server sent while logging in.
+    Buffer::OwnedImpl parameter_status_;
+  };
+
+  void processClientData();
+  void acquireUpstream();
+  void onUpstreamReady();
+  void processLogin(Buffer::Instance& data);
+  void sendStartup();
+  void sendPassword();
+  void mayReleaseUpstream();
+  void releaseUpstream();
+  void fail(const std::string& message);
+
+  const TransactionPoolingConfig& config_;
+  PostgresProxyStats& stats_;
+  Network::ReadFilterCallbacks& read_callbacks_;
+  State state_{State::AwaitingStartup};
+  Buffer::OwnedImpl client_buffer_;
+  // The messages of the client waiting for an upstream connection.
+  Buffer::OwnedImpl upstream_request_;
+  Tcp::ConnectionPool::Cancellable* upstream_handle_{};
+  Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+  // Set while the upstream connection logs in.
+  std::unique_ptr<UpstreamConnectionState> login_state_;
+  Buffer::OwnedImpl login_buffer_;
+  // The number of ReadyForQuery messages the client is still waiting for.
+  uint32_t pending_ready_for_query_{};
+  // Whether the client sent extended query messages that weren't followed by a Sync yet.
+  bool unsynced_{};
+  // Whether the last ReadyForQuery reported a transaction block.
+  bool in_transaction_{};
+};
+
+using PooledSessionPtr = std::unique_ptr<PooledSession>;
+
+} // namespace PostgresProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -52,7 +52,7 @@ Network::FilterStatus Filter::onNewConnection() {
     config_->stats().total_.inc();
     calling_limit_ = true;
     client_->limit(*this, config_->domain(), config_->descriptors(), Tracing::NullSpan::instance(),
-                   filter_callbacks_->connection().streamInfo());
+                   filter_callbacks_->connection().streamInfo(), 0);
     calling_limit_ = false;
   }
 
@@ -78,7 +78,7 @@ void Filter::complete(Filters::Common::RateLimit::LimitStatus status,
                       Filters::Common::RateLimit::DynamicMetadataPtr&& dynamic_metadata) {
   if (dynamic_metadata != nullptr && !dynamic_metadata->fields().empty()) {
     filter_callbacks_->connection().streamInfo().setDynamicMetadata(
-        NetworkFilterNames::get().RateLimit, *dynamic_metadata);
+        NetworkFilterNames::get().RateLimit, std::move(*dynamic_metadata));
   }
 
   status_ = Status::Complete;
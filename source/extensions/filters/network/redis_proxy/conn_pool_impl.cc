@@ -17,6 +17,10 @@
 
 #include "extensions/filters/network/redis_proxy/config.h"
 
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace NetworkFilters {
@@ -34,6 +38,13 @@ const Common::Redis::RespValue& getRequest(const RespVariant& request) {
     return *(absl::get<Common::Redis::RespValueConstSharedPtr>(request));
   }
 }
+
+bool isGet(const Common::Redis::RespValue& request) {
+  return request.type() == Common::Redis::RespType::Array && request.asArray().size() == 2 &&
+         request.asArray()[0].type() == Common::Redis::RespType::BulkString &&
+         request.asArray()[1].type() == Common::Redis::RespType::BulkString &&
+         absl::EqualsIgnoreCase(request.asArray()[0].asString(), "get");
+}
 } // namespace
 
 InstanceImpl::InstanceImpl(
@@ -49,7 +60,19 @@ InstanceImpl::InstanceImpl(
       stats_scope_(std::move(stats_scope)),
       redis_command_stats_(redis_command_stats), redis_cluster_stats_{REDIS_CLUSTER_STATS(
                                                      POOL_COUNTER(*stats_scope_))},
-      refresh_manager_(std::move(refresh_manager)) {}
+      refresh_manager_(std::move(refresh_manager)),
+      get_coalescing_window_(config.has_get_coalescing()
+                                 ? std::chrono::microseconds(
+                                       Protobuf::util::TimeUtil::DurationToMicroseconds(
+                                           config.get_coalescing().window()))
+                                 : std::chrono::microseconds(0)),
+      max_coalesced_gets_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.get_coalescing(), max_keys,
+                                                          DefaultMaxCoalescedGets)),
+      near_cache_max_bytes_(config.near_cache().max_bytes()) {
+  if (near_cache_max_bytes_ > 0) {
+    near_cache_stats_ = std::make_unique<NearCacheStats>(generateNearCacheStats(*stats_scope_));
+  }
+}
 
 void InstanceImpl::init() {
   // Note: `this` and `cluster_name` have a a lifetime of the filter.
@@ -90,7 +113,14 @@ InstanceImpl::ThreadLocalPool::ThreadLocalPool(std::shared_ptr<InstanceImpl> par
       is_redis_cluster_(false), client_factory_(parent->client_factory_), config_(parent->config_),
       stats_scope_(parent->stats_scope_), redis_command_stats_(parent->redis_command_stats_),
       redis_cluster_stats_(parent->redis_cluster_stats_),
-      refresh_manager_(parent->refresh_manager_) {
+      refresh_manager_(parent->refresh_manager_),
+      get_coalescing_window_(parent->get_coalescing_window_),
+      max_coalesced_gets_(parent->max_coalesced_gets_) {
+  if (parent->near_cache_max_bytes_ > 0) {
+    near_cache_ =
+        std::make_unique<NearCache>(parent->near_cache_max_bytes_, *parent->near_cache_stats_);
+    near_cache_hit_timer_ = dispatcher.createTimer([this]() -> void { onNearCacheHits(); });
+  }
   cluster_update_handle_ = parent->cm_.addThreadLocalClusterUpdateCallbacks(*this);
   Upstream::ThreadLocalCluster* cluster = parent->cm_.getThreadLocalCluster(cluster_name_);
   if (cluster != nullptr) {
@@ -102,6 +132,14 @@ InstanceImpl::ThreadLocalPool::~ThreadLocalPool() {
   while (!pending_requests_.empty()) {
     pending_requests_.pop_front();
   }
+  open_get_batches_.clear();
+  get_batches_.clear();
+  for (NearCacheHit& hit : near_cache_hits_) {
+    if (!hit.cancelled_) {
+      hit.pool_callbacks_.onFailure();
+    }
+  }
+  near_cache_hits_.clear();
   while (!client_map_.empty()) {
     client_map_.begin()->second->redis_client_->close();
   }
@@ -178,6 +216,11 @@ void InstanceImpl::ThreadLocalPool::onClusterRemoval(const std::string& cluster_
 
 void InstanceImpl::ThreadLocalPool::onHostsAdded(
     const std::vector<Upstream::HostSharedPtr>& hosts_added) {
+  // The keys of the cached values may map to other hosts now, whose writes wouldn't invalidate
+  // them.
+  if (near_cache_ != nullptr && !hosts_added.empty()) {
+    near_cache_->clear();
+  }
   for (const auto& host : hosts_added) {
     std::string host_address = host->address()->asString();
     // Insert new host into address map, possibly overwriting a previous host's entry.
@@ -195,6 +238,9 @@ void InstanceImpl::ThreadLocalPool::onHostsAdded(
 
 void InstanceImpl::ThreadLocalPool::onHostsRemoved(
     const std::vector<Upstream::HostSharedPtr>& hosts_removed) {
+  if (near_cache_ != nullptr && !hosts_removed.empty()) {
+    near_cache_->clear();
+  }
   for (const auto& host : hosts_removed) {
     auto it = client_map_.find(host);
     if (it != client_map_.end()) {
@@ -240,6 +286,9 @@ InstanceImpl::ThreadLocalPool::threadLocalActiveClient(Upstream::HostConstShared
                                auth_username_, auth_password_);
     client->redis_client_->addConnectionCallbacks(*client);
   }
+  if (near_cache_ != nullptr && client->invalidation_client_ == nullptr) {
+    client->invalidation_client_ = std::make_unique<InvalidationClient>(*client);
+  }
   return client;
 }
 
@@ -260,14 +309,42 @@ InstanceImpl::ThreadLocalPool::makeRequest(const std::string& key, RespVariant&&
     ENVOY_LOG(debug, "host not found: '{}'", key);
     return nullptr;
   }
+  const bool get = isGet(getRequest(request));
+  bool fill_near_cache = false;
+  if (near_cache_ != nullptr) {
+    if (!get) {
+      // Drop the value of a key that is written through the pool right away, so that a read
+      // that follows the write doesn't depend on the invalidation having arrived.
+      near_cache_->invalidate(key);
+    } else {
+      const std::string& get_key = getRequest(request).asArray()[1].asString();
+      const Common::Redis::RespValue* cached = near_cache_->lookup(get_key);
+      if (cached != nullptr) {
+        return makeNearCacheHit(*cached, callbacks);
+      }
+      near_cache_->startFill(get_key);
+      fill_near_cache = true;
+    }
+  }
+
+  // The keys of an MGET to Redis Cluster must be in the same hash slot, so its GETs aren't
+  // coalesced.
+  if (get_coalescing_window_.count() > 0 && !is_redis_cluster_ && get) {
+    return makeCoalescedGet(host, getRequest(request).asArray()[1].asString(), callbacks,
+                            fill_near_cache);
+  }
   pending_requests_.emplace_back(*this, std::move(request), callbacks);
   PendingRequest& pending_request = pending_requests_.back();
+  if (fill_near_cache) {
+    pending_request.near_cache_fill_host_ = host;
+  }
   ThreadLocalActiveClientPtr& client = this->threadLocalActiveClient(host);
   pending_request.request_handler_ = client->redis_client_->makeRequest(
       getRequest(pending_request.incoming_request_), pending_request);
   if (pending_request.request_handler_) {
     return &pending_request;
   } else {
+    pending_request.finishNearCacheFill(nullptr);
     onRequestCompleted();
     return nullptr;
   }
@@ -343,6 +420,88 @@ Common::Redis::Client::PoolRequest* InstanceImpl::ThreadLocalPool::makeRequestTo
   return client->redis_client_->makeRequest(request, callbacks);
 }
 
+Common::Redis::Client::PoolRequest*
+InstanceImpl::ThreadLocalPool::makeCoalescedGet(Upstream::HostConstSharedPtr host,
+                                                const std::string& key, PoolCallbacks& callbacks,
+                                                bool fill_near_cache) {
+  auto it = open_get_batches_.find(host);
+  if (it == open_get_batches_.end()) {
+    auto batch = std::make_unique<CoalescedGetBatch>(*this, host);
+    batch->window_timer_->enableHRTimer(get_coalescing_window_);
+    it = open_get_batches_.emplace(host, batch.get()).first;
+    LinkedList::moveIntoList(std::move(batch), get_batches_);
+  }
+
+  CoalescedGetBatch& batch = *it->second;
+  Common::Redis::Client::PoolRequest* get = batch.add(key, callbacks, fill_near_cache);
+  if (batch.gets_.size() >= max_coalesced_gets_) {
+    // Send the full batch once the current event has been processed rather than from within
+    // makeRequest(), so that a failure to send doesn't call back the caller before it has the
+    // handle. The GETs that follow are coalesced into a new batch.
+    open_get_batches_.erase(it);
+    batch.window_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+  return get;
+}
+
+void InstanceImpl::ThreadLocalPool::onCoalescedGetBatchCompleted(CoalescedGetBatch& batch) {
+  dispatcher_.deferredDelete(batch.removeFromList(get_batches_));
+}
+
+Common::Redis::Client::PoolRequest*
+InstanceImpl::ThreadLocalPool::makeNearCacheHit(const Common::Redis::RespValue& value,
+                                                PoolCallbacks& callbacks) {
+  // Respond once the current event has been processed, as the caller can't be called back from
+  // within makeRequest().
+  near_cache_hits_.emplace_back(value, callbacks);
+  if (!near_cache_hit_timer_->enabled()) {
+    near_cache_hit_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+  return &near_cache_hits_.back();
+}
+
+void InstanceImpl::ThreadLocalPool::onNearCacheHits() {
+  std::list<NearCacheHit> hits;
+  hits.swap(near_cache_hits_);
+  // The callbacks of a hit may cancel the hits that follow it, so check each hit as it is reached.
+  for (NearCacheHit& hit : hits) {
+    if (!hit.cancelled_) {
+      hit.pool_callbacks_.onResponse(
+          std::make_unique<Common::Redis::RespValue>(std::move(hit.value_)));
+    }
+  }
+}
+
+void InstanceImpl::ThreadLocalPool::finishNearCacheFill(const Upstream::HostConstSharedPtr& host,
+                                                        const std::string& key,
+                                                        const Common::Redis::RespValue* response) {
+  // The value can only be cached if the invalidations of its key are sent to the pool. They are
+  // if tracking is enabled on the connection by the time the response arrives, as the response
+  // to CLIENT TRACKING arrives before the responses to the commands sent after it.
+  auto client = client_map_.find(host);
+  if (client == client_map_.end() || !client->second->tracking_) {
+    response = nullptr;
+  }
+  near_cache_->finishFill(key, response);
+}
+
+bool InstanceImpl::ThreadLocalPool::applyMovedRedirection(const Common::Redis::RespValue& error,
+                                                          const std::string& host_address) {
+  if (!is_redis_cluster_ || cluster_ == nullptr) {
+    return false;
+  }
+  auto* handler =
+      dynamic_cast<Clusters::Redis::MovedRedirectionHandler*>(&cluster_->loadBalancer());
+  if (handler == nullptr) {
+    return false;
+  }
+  // MOVED errors look like "MOVED <slot> <host>:<port>".
+  const std::vector<absl::string_view> parts = absl::StrSplit(error.asString(), ' ');
+  uint64_t slot;
+  return parts.size() == 3 && absl::SimpleAtoi(parts[1], &slot) &&
+         handler->onMovedRedirection(slot, host_address);
+}
+
 void InstanceImpl::ThreadLocalPool::onRequestCompleted() {
   ASSERT(!pending_requests_.empty());
 
@@ -353,9 +512,24 @@ void InstanceImpl::ThreadLocalPool::onRequestCompleted() {
   }
 }
 
+void InstanceImpl::ThreadLocalActiveClient::enableTracking(int64_t invalidation_client_id) {
+  redis_client_->makeRequest(Common::Redis::Utility::ClientTrackingRequest(invalidation_client_id),
+                             *this);
+}
+
+void InstanceImpl::ThreadLocalActiveClient::onResponse(Common::Redis::RespValuePtr&& response) {
+  tracking_ =
+      response->type() == Common::Redis::RespType::SimpleString && response->asString() == "OK";
+}
+
 void InstanceImpl::ThreadLocalActiveClient::onEvent(Network::ConnectionEvent event) {
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    // The keys read through the connection are no longer tracked. Closing the invalidation client
+    // drops their values from the near cache.
+    if (invalidation_client_ != nullptr) {
+      invalidation_client_->redis_client_->close();
+    }
     auto client_to_delete = parent_.client_map_.find(host_);
     if (client_to_delete != parent_.client_map_.end()) {
       parent_.dispatcher_.deferredDelete(std::move(redis_client_));
@@ -386,6 +560,7 @@ InstanceImpl::PendingRequest::~PendingRequest() {
   if (request_handler_) {
     request_handler_->cancel();
     request_handler_ = nullptr;
+    finishNearCacheFill(nullptr);
     // If we have to cancel the request on the client, then we'll treat this as failure for pool
     // callback
     pool_callbacks_.onFailure();
@@ -394,12 +569,14 @@ InstanceImpl::PendingRequest::~PendingRequest() {
 
 void InstanceImpl::PendingRequest::onResponse(Common::Redis::RespValuePtr&& response) {
   request_handler_ = nullptr;
+  finishNearCacheFill(response.get());
   pool_callbacks_.onResponse(std::move(response));
   parent_.onRequestCompleted();
 }
 
 void InstanceImpl::PendingRequest::onFailure() {
   request_handler_ = nullptr;
+  finishNearCacheFill(nullptr);
   pool_callbacks_.onFailure();
   parent_.refresh_manager_->onFailure(parent_.cluster_name_);
   parent_.onRequestCompleted();
@@ -408,6 +585,13 @@ void InstanceImpl::PendingRequest::onFailure() {
 bool InstanceImpl::PendingRequest::onRedirection(Common::Redis::RespValuePtr&& value,
                                                  const std::string& host_address,
                                                  bool ask_redirection) {
+  // A redirection means that keys have moved between hosts, so the writes of a cached key may no
+  // longer reach the host that invalidates it.
+  if (parent_.near_cache_ != nullptr) {
+    finishNearCacheFill(nullptr);
+    parent_.near_cache_->clear();
+  }
+
   // Prepend request with an asking command if redirected via an ASK error. The returned handle is
   // not important since there is no point in being able to cancel the request. The use of
   // null_pool_callbacks ensures the transparent filtering of the Redis server's response to the
@@ -424,7 +608,11 @@ bool InstanceImpl::PendingRequest::onRedirection(Common::Redis::RespValuePtr&& v
     onResponse(std::move(value));
     return false;
   } else {
-    parent_.refresh_manager_->onRedirection(parent_.cluster_name_);
+    // The load balancer moves the slot of a MOVED redirection to a known primary right away, so
+    // it doesn't count towards a refresh of the topology. ASK redirections don't move the slot.
+    if (ask_redirection || !parent_.applyMovedRedirection(*value, host_address)) {
+      parent_.refresh_manager_->onRedirection(parent_.cluster_name_);
+    }
     return true;
   }
 }
@@ -432,9 +620,209 @@ bool InstanceImpl::PendingRequest::onRedirection(Common::Redis::RespValuePtr&& v
 void InstanceImpl::PendingRequest::cancel() {
   request_handler_->cancel();
   request_handler_ = nullptr;
+  finishNearCacheFill(nullptr);
   parent_.onRequestCompleted();
 }
 
+void InstanceImpl::PendingRequest::finishNearCacheFill(const Common::Redis::RespValue* response) {
+  if (near_cache_fill_host_ != nullptr) {
+    parent_.finishNearCacheFill(near_cache_fill_host_,
+                                getRequest(incoming_request_).asArray()[1].asString(), response);
+    near_cache_fill_host_ = nullptr;
+  }
+}
+
+InstanceImpl::CoalescedGetBatch::CoalescedGetBatch(InstanceImpl::ThreadLocalPool& parent,
+                                                   Upstream::HostConstSharedPtr host)
+    : parent_(parent), host_(std::move(host)),
+      window_timer_(parent.dispatcher_.createTimer([this]() -> void { send(); })) {
+  request_.type(Common::Redis::RespType::Array);
+  request_.asArray().emplace_back();
+  request_.asArray().back().type(Common::Redis::RespType::BulkString);
+  request_.asArray().back().asString() = "mget";
+}
+
+InstanceImpl::CoalescedGetBatch::~CoalescedGetBatch() {
+  // The GETs are only left if the pool is destroyed before the batch completes. Treat that as a
+  // failure of the GETs, as for the other requests of the pool.
+  if (request_handler_) {
+    request_handler_->cancel();
+    request_handler_ = nullptr;
+  }
+  finishNearCacheFills(nullptr);
+  for (CoalescedGet& get : gets_) {
+    if (!get.cancelled_) {
+      get.pool_callbacks_.onFailure();
+    }
+  }
+}
+
+Common::Redis::Client::PoolRequest*
+InstanceImpl::CoalescedGetBatch::add(const std::string& key, PoolCallbacks& callbacks,
+                                     bool fill_near_cache) {
+  request_.asArray().emplace_back();
+  request_.asArray().back().type(Common::Redis::RespType::BulkString);
+  request_.asArray().back().asString() = key;
+  gets_.emplace_back(callbacks);
+  gets_.back().fill_near_cache_ = fill_near_cache;
+  return &gets_.back();
+}
+
+void InstanceImpl::CoalescedGetBatch::finishNearCacheFills(
+    const Common::Redis::RespValue* response) {
+  // Keys start after the command.
+  auto key = request_.asArray().begin() + 1;
+  const Common::Redis::RespValue* value =
+      response != nullptr ? response->asArray().data() : nullptr;
+  for (CoalescedGet& get : gets_) {
+    if (get.fill_near_cache_) {
+      parent_.finishNearCacheFill(host_, key->asString(), value);
+      get.fill_near_cache_ = false;
+    }
+    ++key;
+    if (value != nullptr) {
+      ++value;
+    }
+  }
+}
+
+void InstanceImpl::CoalescedGetBatch::send() {
+  // A full batch has already been closed, and a new one may be open for the host.
+  auto it = parent_.open_get_batches_.find(host_);
+  if (it != parent_.open_get_batches_.end() && it->second == this) {
+    parent_.open_get_batches_.erase(it);
+  }
+
+  parent_.redis_cluster_stats_.upstream_rq_coalesced_mget_.inc();
+  parent_.redis_cluster_stats_.upstream_rq_coalesced_get_.add(gets_.size());
+  ThreadLocalActiveClientPtr& client = parent_.threadLocalActiveClient(host_);
+  request_handler_ = client->redis_client_->makeRequest(request_, *this);
+  if (!request_handler_) {
+    onFailure();
+  }
+}
+
+void InstanceImpl::CoalescedGetBatch::onResponse(Common::Redis::RespValuePtr&& response) {
+  request_handler_ = nullptr;
+  // The callbacks of a GET may cancel the GETs that follow it, so check each GET as it is reached.
+  if (response->type() == Common::Redis::RespType::Array &&
+      response->asArray().size() == gets_.size()) {
+    finishNearCacheFills(response.get());
+    auto value = response->asArray().begin();
+    for (CoalescedGet& get : gets_) {
+      if (!get.cancelled_) {
+        get.pool_callbacks_.onResponse(
+            std::make_unique<Common::Redis::RespValue>(std::move(*value)));
+      }
+      ++value;
+    }
+  } else {
+    finishNearCacheFills(nullptr);
+    // An error response to the MGET is the response to each of its GETs.
+    for (CoalescedGet& get : gets_) {
+      if (!get.cancelled_) {
+        get.pool_callbacks_.onResponse(std::make_unique<Common::Redis::RespValue>(*response));
+      }
+    }
+  }
+  gets_.clear();
+  parent_.onCoalescedGetBatchCompleted(*this);
+}
+
+void InstanceImpl::CoalescedGetBatch::onFailure() {
+  request_handler_ = nullptr;
+  finishNearCacheFills(nullptr);
+  for (CoalescedGet& get : gets_) {
+    if (!get.cancelled_) {
+      get.pool_callbacks_.onFailure();
+    }
+  }
+  gets_.clear();
+  parent_.refresh_manager_->onFailure(parent_.cluster_name_);
+  parent_.onCoalescedGetBatchCompleted(*this);
+}
+
+bool InstanceImpl::CoalescedGetBatch::onRedirection(Common::Redis::RespValuePtr&& value,
+                                                    const std::string&, bool) {
+  // GETs are only coalesced for clusters that aren't Redis Cluster, so there is nowhere to
+  // redirect the MGET to. Pass the error to the GETs unchanged.
+  onResponse(std::move(value));
+  return false;
+}
+
+InstanceImpl::InvalidationClient::InvalidationClient(InstanceImpl::ThreadLocalActiveClient& parent)
+    : parent_(parent) {
+  ThreadLocalPool& pool = parent.parent_;
+  redis_client_ =
+      pool.client_factory_.create(parent.host_, pool.dispatcher_, *pool.config_,
+                                  pool.redis_command_stats_, *(pool.stats_scope_),
+                                  pool.auth_username_, pool.auth_password_);
+  redis_client_->addConnectionCallbacks(*this);
+  redis_client_->setPushCallbacks(*this);
+  redis_client_->makeRequest(Common::Redis::Utility::ClientIdRequest::instance(), *this);
+  redis_client_->makeRequest(Common::Redis::Utility::SubscribeInvalidationsRequest::instance(),
+                             *this);
+}
+
+void InstanceImpl::InvalidationClient::onResponse(Common::Redis::RespValuePtr&& response) {
+  if (closed_) {
+    return;
+  }
+  if (!client_id_.has_value()) {
+    // The response to CLIENT ID.
+    if (response->type() != Common::Redis::RespType::Integer) {
+      redis_client_->close();
+      return;
+    }
+    client_id_ = response->asInteger();
+  } else if (response->type() == Common::Redis::RespType::Array) {
+    // The response to SUBSCRIBE. The invalidations of the keys that the active client reads from
+    // now on are received.
+    parent_.enableTracking(client_id_.value());
+  } else {
+    redis_client_->close();
+  }
+}
+
+void InstanceImpl::InvalidationClient::onPush(Common::Redis::RespValuePtr&& value) {
+  // Invalidations are messages of the invalidation channel, which look like:
+  // ["message", "__redis__:invalidate", [key ...]]. The keys are null if every key is
+  // invalidated, for example by FLUSHALL.
+  if (closed_ || value->type() != Common::Redis::RespType::Array ||
+      value->asArray().size() != 3 ||
+      value->asArray()[0].type() != Common::Redis::RespType::BulkString ||
+      value->asArray()[0].asString() != "message") {
+    return;
+  }
+  NearCache& near_cache = *parent_.parent_.near_cache_;
+  const Common::Redis::RespValue& keys = value->asArray()[2];
+  if (keys.type() == Common::Redis::RespType::Null) {
+    near_cache.clear();
+  } else if (keys.type() == Common::Redis::RespType::Array) {
+    for (const Common::Redis::RespValue& key : keys.asArray()) {
+      if (key.type() == Common::Redis::RespType::BulkString) {
+        near_cache.invalidate(key.asString());
+      }
+    }
+  }
+}
+
+void InstanceImpl::InvalidationClient::onEvent(Network::ConnectionEvent event) {
+  if (closed_ || (event != Network::ConnectionEvent::RemoteClose &&
+                  event != Network::ConnectionEvent::LocalClose)) {
+    return;
+  }
+  // Without the connection, the values of the keys read through the active client can't be
+  // invalidated anymore, so drop them all. A new invalidation client is created by the next
+  // request to the host.
+  closed_ = true;
+  ThreadLocalPool& pool = parent_.parent_;
+  parent_.tracking_ = false;
+  pool.near_cache_->clear();
+  pool.dispatcher_.deferredDelete(std::move(redis_client_));
+  pool.dispatcher_.deferredDelete(std::move(parent_.invalidation_client_));
+}
+
 } // namespace ConnPool
 } // namespace RedisProxy
 } // namespace NetworkFilters
@@ -13,6 +13,7 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/linked_object.h"
 #include "common/network/address_impl.h"
 #include "common/network/filter_impl.h"
 #include "common/protobuf/utility.h"
@@ -28,8 +29,10 @@
 #include "extensions/filters/network/common/redis/codec_impl.h"
 #include "extensions/filters/network/common/redis/utility.h"
 #include "extensions/filters/network/redis_proxy/conn_pool.h"
+#include "extensions/filters/network/redis_proxy/near_cache_impl.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/types/optional.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -42,6 +45,8 @@ namespace ConnPool {
 
 #define REDIS_CLUSTER_STATS(COUNTER)                                                               \
   COUNTER(upstream_cx_drained)                                                                     \
+  COUNTER(upstream_rq_coalesced_get)                                                               \
+  COUNTER(upstream_rq_coalesced_mget)                                                              \
   COUNTER(max_upstream_unknown_connections_reached)
 
 struct RedisClusterStats {
@@ -56,6 +61,8 @@ public:
 
 class InstanceImpl : public Instance, public std::enable_shared_from_this<InstanceImpl> {
 public:
+  static constexpr uint32_t DefaultMaxCoalescedGets = 100;
+
   InstanceImpl(
       const std::string& cluster_name, Upstream::ClusterManager& cm,
       Common::Redis::Client::ClientFactory& client_factory, ThreadLocal::SlotAllocator& tls,
@@ -88,22 +95,113 @@ public:
 
 private:
   struct ThreadLocalPool;
+  struct ThreadLocalActiveClient;
+
+  // The connection to an upstream host that receives the invalidations of the keys that the near
+  // cache reads through the ThreadLocalActiveClient of the host. It gets its client ID, subscribes
+  // to the invalidation channel, and then has the active client redirect the invalidations of its
+  // keys to it.
+  struct InvalidationClient : public Common::Redis::Client::ClientCallbacks,
+                              public Common::Redis::Client::PushCallbacks,
+                              public Network::ConnectionCallbacks,
+                              public Event::DeferredDeletable {
+    InvalidationClient(ThreadLocalActiveClient& parent);
+
+    // Common::Redis::Client::ClientCallbacks
+    void onResponse(Common::Redis::RespValuePtr&& response) override;
+    void onFailure() override {}
+    bool onRedirection(Common::Redis::RespValuePtr&&, const std::string&, bool) override {
+      return false;
+    }
+
+    // Common::Redis::Client::PushCallbacks
+    void onPush(Common::Redis::RespValuePtr&& value) override;
+
+    // Network::ConnectionCallbacks
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
 
-  struct ThreadLocalActiveClient : public Network::ConnectionCallbacks {
+    ThreadLocalActiveClient& parent_;
+    Common::Redis::Client::ClientPtr redis_client_;
+    absl::optional<int64_t> client_id_;
+    bool closed_{};
+  };
+
+  using InvalidationClientPtr = std::unique_ptr<InvalidationClient>;
+
+  struct ThreadLocalActiveClient : public Network::ConnectionCallbacks,
+                                   public Common::Redis::Client::ClientCallbacks {
     ThreadLocalActiveClient(ThreadLocalPool& parent) : parent_(parent) {}
 
+    void enableTracking(int64_t invalidation_client_id);
+
     // Network::ConnectionCallbacks
     void onEvent(Network::ConnectionEvent event) override;
     void onAboveWriteBufferHighWatermark() override {}
     void onBelowWriteBufferLowWatermark() override {}
 
+    // Common::Redis::Client::ClientCallbacks
+    // These are the callbacks of the CLIENT TRACKING command sent by enableTracking().
+    void onResponse(Common::Redis::RespValuePtr&& response) override;
+    void onFailure() override {}
+    bool onRedirection(Common::Redis::RespValuePtr&&, const std::string&, bool) override {
+      return false;
+    }
+
     ThreadLocalPool& parent_;
     Upstream::HostConstSharedPtr host_;
     Common::Redis::Client::ClientPtr redis_client_;
+    InvalidationClientPtr invalidation_client_;
+    // Whether the invalidations of the keys read through redis_client_ are sent to
+    // invalidation_client_, so that their values can be cached.
+    bool tracking_{};
   };
 
   using ThreadLocalActiveClientPtr = std::unique_ptr<ThreadLocalActiveClient>;
 
+  // A GET that is sent to the upstream as part of the MGET of a CoalescedGetBatch.
+  struct CoalescedGet : public Common::Redis::Client::PoolRequest {
+    CoalescedGet(PoolCallbacks& pool_callbacks) : pool_callbacks_(pool_callbacks) {}
+
+    // PoolRequest
+    void cancel() override { cancelled_ = true; }
+
+    PoolCallbacks& pool_callbacks_;
+    bool cancelled_{};
+    bool fill_near_cache_{};
+  };
+
+  // The GETs to an upstream host that are coalesced into one MGET. The batch collects GETs until
+  // its window ends or it is full, sends the MGET, and fans the values of the response out to the
+  // GETs.
+  struct CoalescedGetBatch : public Common::Redis::Client::ClientCallbacks,
+                             public Event::DeferredDeletable,
+                             public LinkedObject<CoalescedGetBatch> {
+    CoalescedGetBatch(ThreadLocalPool& parent, Upstream::HostConstSharedPtr host);
+    ~CoalescedGetBatch() override;
+
+    Common::Redis::Client::PoolRequest* add(const std::string& key, PoolCallbacks& callbacks,
+                                            bool fill_near_cache);
+    void send();
+    void finishNearCacheFills(const Common::Redis::RespValue* response);
+
+    // Common::Redis::Client::ClientCallbacks
+    void onResponse(Common::Redis::RespValuePtr&& response) override;
+    void onFailure() override;
+    bool onRedirection(Common::Redis::RespValuePtr&& value, const std::string& host_address,
+                       bool ask_redirection) override;
+
+    ThreadLocalPool& parent_;
+    const Upstream::HostConstSharedPtr host_;
+    Common::Redis::RespValue request_;
+    std::list<CoalescedGet> gets_;
+    Event::TimerPtr window_timer_;
+    Common::Redis::Client::PoolRequest* request_handler_{};
+  };
+
+  using CoalescedGetBatchPtr = std::unique_ptr<CoalescedGetBatch>;
+
   struct PendingRequest : public Common::Redis::Client::ClientCallbacks,
                           public Common::Redis::Client::PoolRequest {
     PendingRequest(ThreadLocalPool& parent, RespVariant&& incoming_request,
@@ -119,10 +217,27 @@ private:
     // PoolRequest
     void cancel() override;
 
+    void finishNearCacheFill(const Common::Redis::RespValue* response);
+
     ThreadLocalPool& parent_;
     const RespVariant incoming_request_;
     Common::Redis::Client::PoolRequest* request_handler_;
     PoolCallbacks& pool_callbacks_;
+    // The host the GET is sent to, if the near cache is filled with its response.
+    Upstream::HostConstSharedPtr near_cache_fill_host_;
+  };
+
+  // A GET that is answered from the near cache once the current event has been processed.
+  struct NearCacheHit : public Common::Redis::Client::PoolRequest {
+    NearCacheHit(const Common::Redis::RespValue& value, PoolCallbacks& pool_callbacks)
+        : value_(value), pool_callbacks_(pool_callbacks) {}
+
+    // PoolRequest
+    void cancel() override { cancelled_ = true; }
+
+    Common::Redis::RespValue value_;
+    PoolCallbacks& pool_callbacks_;
+    bool cancelled_{};
   };
 
   struct ThreadLocalPool : public ThreadLocal::ThreadLocalObject,
@@ -137,6 +252,18 @@ private:
     Common::Redis::Client::PoolRequest*
     makeRequestToHost(const std::string& host_address, const Common::Redis::RespValue& request,
                       Common::Redis::Client::ClientCallbacks& callbacks);
+    Common::Redis::Client::PoolRequest* makeCoalescedGet(Upstream::HostConstSharedPtr host,
+                                                         const std::string& key,
+                                                         PoolCallbacks& callbacks,
+                                                         bool fill_near_cache);
+    void onCoalescedGetBatchCompleted(CoalescedGetBatch& batch);
+    Common::Redis::Client::PoolRequest* makeNearCacheHit(const Common::Redis::RespValue& value,
+                                                         PoolCallbacks& callbacks);
+    void onNearCacheHits();
+    void finishNearCacheFill(const Upstream::HostConstSharedPtr& host, const std::string& key,
+                             const Common::Redis::RespValue* response);
+    bool applyMovedRedirection(const Common::Redis::RespValue& error,
+                               const std::string& host_address);
 
     void onClusterAddOrUpdateNonVirtual(Upstream::ThreadLocalCluster& cluster);
     void onHostsAdded(const std::vector<Upstream::HostSharedPtr>& hosts_added);
@@ -164,6 +291,13 @@ private:
     std::list<Upstream::HostSharedPtr> created_via_redirect_hosts_;
     std::list<ThreadLocalActiveClientPtr> clients_to_drain_;
     std::list<PendingRequest> pending_requests_;
+    // The batches that are still collecting GETs, by the upstream host they are sent to.
+    absl::node_hash_map<Upstream::HostConstSharedPtr, CoalescedGetBatch*> open_get_batches_;
+    std::list<CoalescedGetBatchPtr> get_batches_;
+    // Null if the pool has no near cache.
+    NearCachePtr near_cache_;
+    std::list<NearCacheHit> near_cache_hits_;
+    Event::TimerPtr near_cache_hit_timer_;
 
     /* This timer is used to poll the active clients in clients_to_drain_ to determine whether they
      * have been drained (have no active requests) or not. It is only enabled after a client has
@@ -179,6 +313,8 @@ private:
     Common::Redis::RedisCommandStatsSharedPtr redis_command_stats_;
     RedisClusterStats redis_cluster_stats_;
     const Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager_;
+    const std::chrono::microseconds get_coalescing_window_;
+    const uint32_t max_coalesced_gets_;
   };
 
   const std::string cluster_name_;
@@ -191,6 +327,12 @@ private:
   Common::Redis::RedisCommandStatsSharedPtr redis_command_stats_;
   RedisClusterStats redis_cluster_stats_;
   const Extensions::Common::Redis::ClusterRefreshManagerSharedPtr refresh_manager_;
+  // Zero if GETs aren't coalesced.
+  const std::chrono::microseconds get_coalescing_window_;
+  const uint32_t max_coalesced_gets_;
+  // Zero if the pool has no near cache.
+  const uint64_t near_cache_max_bytes_;
+  std::unique_ptr<NearCacheStats> near_cache_stats_;
 };
 
 } // namespace ConnPool
@@ -0,0 +1,104 @@
+#include "extensions/filters/network/redis_proxy/near_cache_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+NearCacheStats generateNearCacheStats(Stats::Scope& scope) {
+  const std::string prefix = "near_cache.";
+  return {ALL_NEAR_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                               POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+NearCache::NearCache(uint64_t max_bytes, NearCacheStats& stats)
+    : max_bytes_(max_bytes), stats_(stats) {}
+
+NearCache::~NearCache() { stats_.bytes_.sub(bytes_); }
+
+const Common::Redis::RespValue* NearCache::lookup(const std::string& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    stats_.miss_.inc();
+    return nullptr;
+  }
+  stats_.hit_.inc();
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return &it->second->value_;
+}
+
+void NearCache::startFill(const std::string& key) { pending_fills_[key].outstanding_++; }
+
+void NearCache::finishFill(const std::string& key, const Common::Redis::RespValue* value) {
+  auto it = pending_fills_.find(key);
+  ASSERT(it != pending_fills_.end());
+  const bool invalidated = it->second.invalidated_;
+  if (--it->second.outstanding_ == 0) {
+    pending_fills_.erase(it);
+  }
+  if (value != nullptr && !invalidated && cacheable(*value)) {
+    insert(key, *value);
+  }
+}
+
+void NearCache::invalidate(const std::string& key) {
+  auto fill = pending_fills_.find(key);
+  if (fill != pending_fills_.end()) {
+    fill->second.invalidated_ = true;
+  }
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    stats_.invalidation_.inc();
+    erase(it->second);
+  }
+}
+
+void NearCache::clear() {
+  for (auto& fill : pending_fills_) {
+    fill.second.invalidated_ = true;
+  }
+  stats_.invalidation_.add(entries_.size());
+  stats_.bytes_.sub(bytes_);
+  bytes_ = 0;
+  entries_.clear();
+  lru_.clear();
+}
+
+void NearCache::insert(const std::string& key, const Common::Redis::RespValue& value) {
+  const uint64_t bytes =
+      EntryOverheadBytes + 2 * key.size() +
+      (value.type() == Common::Redis::RespType::BulkString ? value.asString().size() : 0);
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    erase(it->second);
+  }
+  while (bytes_ + bytes > max_bytes_) {
+    stats_.eviction_.inc();
+    erase(std::prev(lru_.end()));
+  }
+
+  lru_.push_front({key, value, bytes});
+  entries_.emplace(key, lru_.begin());
+  bytes_ += bytes;
+  stats_.bytes_.add(bytes);
+}
+
+void NearCache::erase(std::list<Entry>::iterator entry) {
+  bytes_ -= entry->bytes_;
+  stats_.bytes_.sub(entry->bytes_);
+  entries_.erase(entry->key_);
+  lru_.erase(entry);
+}
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
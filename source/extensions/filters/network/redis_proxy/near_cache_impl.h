@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "extensions/filters/network/common/redis/codec.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+/**
+ * All near cache stats. @see stats_macros.h
+ */
+#define ALL_NEAR_CACHE_STATS(COUNTER, GAUGE)                                                       \
+  COUNTER(eviction)                                                                                \
+  COUNTER(hit)                                                                                     \
+  COUNTER(invalidation)                                                                            \
+  COUNTER(miss)                                                                                    \
+  GAUGE(bytes, Accumulate)
+
+/**
+ * Struct definition for all near cache stats. @see stats_macros.h
+ */
+struct NearCacheStats {
+  ALL_NEAR_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+NearCacheStats generateNearCacheStats(Stats::Scope& scope);
+
+/**
+ * The values of the GETs of a worker, kept in its memory up to a byte budget and evicted least
+ * recently used first. Values are only inserted by fills, which are started when a GET is sent
+ * upstream and finished with its response, so that a value isn't cached if its key is
+ * invalidated while the GET is in flight. Not thread safe.
+ */
+class NearCache {
+public:
+  NearCache(uint64_t max_bytes, NearCacheStats& stats);
+  ~NearCache();
+
+  /**
+   * @return the cached value of the key, or nullptr if it isn't cached.
+   */
+  const Common::Redis::RespValue* lookup(const std::string& key);
+
+  /**
+   * Starts a fill of the key, for a GET that is sent upstream.
+   */
+  void startFill(const std::string& key);
+
+  /**
+   * Finishes a fill started by startFill().
+   * @param key supplies the key.
+   * @param value supplies the response to the GET, or nullptr if it can't be cached. It is only
+   *        inserted if the key hasn't been invalidated since the fill was started.
+   */
+  void finishFill(const std::string& key, const Common::Redis::RespValue* value);
+
+  /**
+   * Removes the value of the key, and keeps the fills of the key that are in flight from
+   * inserting their values.
+   */
+  void invalidate(const std::string& key);
+
+  /**
+   * Invalidates every key.
+   */
+  void clear();
+
+  static bool cacheable(const Common::Redis::RespValue& value) {
+    return value.type() == Common::Redis::RespType::BulkString ||
+           value.type() == Common::Redis::RespType::Null;
+  }
+
+private:
+  // An approximation of the memory that an entry takes besides its key and value.
+  static constexpr uint64_t EntryOverheadBytes = 64;
+
+  struct Entry {
+    std::string key_;
+    Common::Redis::RespValue value_;
+    uint64_t bytes_;
+  };
+
+  struct PendingFill {
+    uint32_t outstanding_{};
+    bool invalidated_{};
+  };
+
+  void insert(const std::string& key, const Common::Redis::RespValue& value);
+  void erase(std::list<Entry>::iterator entry);
+
+  const uint64_t max_bytes_;
+  NearCacheStats& stats_;
+  uint64_t bytes_{};
+  // Most recently used first.
+  std::list<Entry> lru_;
+  absl::flat_hash_map<std::string, std::list<Entry>::iterator> entries_;
+  absl::flat_hash_map<std::string, PendingFill> pending_fills_;
+};
+
+using NearCachePtr = std::unique_ptr<NearCache>;
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -4,6 +4,8 @@
 #include "envoy/extensions/filters/network/thrift_proxy/router/v3/router.pb.validate.h"
 #include "envoy/registry/registry.h"
 
+#include "common/protobuf/utility.h"
+
 #include "extensions/filters/network/thrift_proxy/router/router_impl.h"
 
 namespace Envoy {
@@ -15,11 +17,19 @@ namespace Router {
 ThriftFilters::FilterFactoryCb RouterFilterConfig::createFilterFactoryFromProtoTyped(
     const envoy::extensions::filters::network::thrift_proxy::router::v3::Router& proto_config,
     const std::string& stat_prefix, Server::Configuration::FactoryContext& context) {
-  UNREFERENCED_PARAMETER(proto_config);
+  UpstreamMultiplexerSharedPtr multiplexer;
+  if (proto_config.has_upstream_multiplexing()) {
+    multiplexer = std::make_shared<UpstreamMultiplexer>(
+        context.threadLocal(),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(proto_config.upstream_multiplexing(),
+                                        max_concurrent_requests,
+                                        UpstreamMultiplexer::DefaultMaxConcurrentRequests));
+  }
 
-  return [&context, stat_prefix](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
-    callbacks.addDecoderFilter(
-        std::make_shared<Router>(context.clusterManager(), stat_prefix, context.scope()));
+  return [&context, stat_prefix,
+          multiplexer](ThriftFilters::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addDecoderFilter(std::make_shared<Router>(context.clusterManager(), stat_prefix,
+                                                        context.scope(), multiplexer.get()));
   };
 }
 
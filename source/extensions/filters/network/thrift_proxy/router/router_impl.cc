@@ -275,9 +275,11 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
                                         : callbacks_->downstreamProtocolType();
   ASSERT(protocol != ProtocolType::Auto);
 
-  if (callbacks_->downstreamTransportType() == TransportType::Framed &&
-      transport == TransportType::Framed && callbacks_->downstreamProtocolType() == protocol &&
-      protocol != ProtocolType::Twitter) {
+  // The framed and header transports carry the size of the payload, so it can be forwarded
+  // without being decoded as long as it doesn't need to be translated.
+  if (callbacks_->downstreamTransportType() == transport &&
+      (transport == TransportType::Framed || transport == TransportType::Header) &&
+      callbacks_->downstreamProtocolType() == protocol && protocol != ProtocolType::Twitter) {
     passthrough_supported_ = true;
   }
 
@@ -302,8 +304,13 @@ FilterStatus Router::messageBegin(MessageMetadataSharedPtr metadata) {
     }
   }
 
-  upstream_request_ =
-      std::make_unique<UpstreamRequest>(*this, *conn_pool, metadata, transport, protocol);
+  // Only framed responses can be split off a shared connection, and the twitter protocol's upgrade
+  // is negotiated per connection.
+  UpstreamMultiplexer* multiplexer =
+      transport == TransportType::Framed && protocol != ProtocolType::Twitter ? multiplexer_
+                                                                              : nullptr;
+  upstream_request_ = std::make_unique<UpstreamRequest>(*this, *conn_pool, metadata, transport,
+                                                        protocol, multiplexer);
   return upstream_request_->start();
 }
 
@@ -316,7 +323,7 @@ FilterStatus Router::messageEnd() {
 
   upstream_request_->transport_->encodeFrame(transport_buffer, *upstream_request_->metadata_,
                                              upstream_request_buffer_);
-  upstream_request_->conn_data_->connection().write(transport_buffer, false);
+  upstream_request_->connection().write(transport_buffer, false);
   upstream_request_->onRequestComplete();
   return FilterStatus::Continue;
 }
@@ -424,11 +431,13 @@ void Router::cleanup() { upstream_request_.reset(); }
 
 Router::UpstreamRequest::UpstreamRequest(Router& parent, Tcp::ConnectionPool::Instance& pool,
                                          MessageMetadataSharedPtr& metadata,
-                                         TransportType transport_type, ProtocolType protocol_type)
+                                         TransportType transport_type, ProtocolType protocol_type,
+                                         UpstreamMultiplexer* multiplexer)
     : parent_(parent), conn_pool_(pool), metadata_(metadata),
       transport_(NamedTransportConfigFactory::getFactory(transport_type).createTransport()),
       protocol_(NamedProtocolConfigFactory::getFactory(protocol_type).createProtocol()),
-      request_complete_(false), response_started_(false), response_complete_(false) {}
+      multiplexer_(multiplexer), request_complete_(false), response_started_(false),
+      response_complete_(false) {}
 
 Router::UpstreamRequest::~UpstreamRequest() {
   if (conn_pool_handle_) {
@@ -437,6 +446,16 @@ Router::UpstreamRequest::~UpstreamRequest() {
 }
 
 FilterStatus Router::UpstreamRequest::start() {
+  if (multiplexer_ != nullptr) {
+    multiplexed_ = multiplexer_->attach(conn_pool_, protocol_->type(), *this);
+    if (multiplexed_connection_ == nullptr) {
+      // Pause while we wait for the shared connection, or after it failed.
+      return FilterStatus::StopIteration;
+    }
+
+    return FilterStatus::Continue;
+  }
+
   Tcp::ConnectionPool::Cancellable* handle = conn_pool_.newConnection(*this);
   if (handle) {
     // Pause while we wait for a connection.
@@ -464,6 +483,15 @@ void Router::UpstreamRequest::releaseConnection(const bool close) {
 
   conn_state_ = nullptr;
 
+  if (multiplexed_ != nullptr) {
+    // The connection is shared with other requests, so the multiplexer closes it once they're done
+    // if a response may still arrive for this one.
+    multiplexed_connection_ = nullptr;
+    MultiplexedRequestPtr multiplexed = std::move(multiplexed_);
+    multiplexed->release(close);
+    return;
+  }
+
   // The event triggered by close will also release this connection so clear conn_data_ before
   // closing.
   auto conn_data = std::move(conn_data_);
@@ -474,6 +502,10 @@ void Router::UpstreamRequest::releaseConnection(const bool close) {
 
 void Router::UpstreamRequest::resetStream() { releaseConnection(true); }
 
+Network::Connection& Router::UpstreamRequest::connection() {
+  return multiplexed_connection_ != nullptr ? *multiplexed_connection_ : conn_data_->connection();
+}
+
 void Router::UpstreamRequest::onPoolFailure(ConnectionPool::PoolFailureReason reason,
                                             Upstream::HostDescriptionConstSharedPtr host) {
   conn_pool_handle_ = nullptr;
@@ -511,10 +543,39 @@ void Router::UpstreamRequest::onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr
   onRequestStart(continue_decoding);
 }
 
+void Router::UpstreamRequest::onMultiplexedConnectionReady(
+    Network::Connection& connection, Upstream::HostDescriptionConstSharedPtr host,
+    int32_t sequence_id) {
+  // Only invoke continueDecoding if attach() already returned, as start() then paused.
+  bool continue_decoding = multiplexed_ != nullptr;
+
+  onUpstreamHostSelected(host);
+  multiplexed_connection_ = &connection;
+  multiplexed_sequence_id_ = sequence_id;
+  onRequestStart(continue_decoding);
+}
+
+void Router::UpstreamRequest::onMultiplexedConnectionFailure(
+    ConnectionPool::PoolFailureReason reason, Upstream::HostDescriptionConstSharedPtr host) {
+  // Mimic an upstream reset.
+  onUpstreamHostSelected(host);
+  onResetStream(reason);
+}
+
+void Router::UpstreamRequest::onMultiplexedResponse(Buffer::Instance& frame) {
+  // The frame holds the whole response, so no more data is coming for it.
+  parent_.onUpstreamData(frame, true);
+}
+
+void Router::UpstreamRequest::onMultiplexedConnectionClose(Network::ConnectionEvent event) {
+  parent_.onEvent(event);
+}
+
 void Router::UpstreamRequest::onRequestStart(bool continue_decoding) {
   parent_.initProtocolConverter(*protocol_, parent_.upstream_request_buffer_);
 
-  metadata_->setSequenceId(conn_state_->nextSequenceId());
+  metadata_->setSequenceId(multiplexed_connection_ != nullptr ? multiplexed_sequence_id_
+                                                              : conn_state_->nextSequenceId());
   parent_.convertMessageBegin(metadata_);
 
   if (continue_decoding) {
@@ -528,6 +589,11 @@ void Router::UpstreamRequest::onResponseComplete() {
   response_complete_ = true;
   conn_state_ = nullptr;
   conn_data_.reset();
+  multiplexed_connection_ = nullptr;
+  if (multiplexed_ != nullptr) {
+    MultiplexedRequestPtr multiplexed = std::move(multiplexed_);
+    multiplexed->release(false);
+  }
 }
 
 void Router::UpstreamRequest::onUpstreamHostSelected(Upstream::HostDescriptionConstSharedPtr host) {
@@ -19,6 +19,7 @@
 #include "extensions/filters/network/thrift_proxy/filters/filter.h"
 #include "extensions/filters/network/thrift_proxy/router/router.h"
 #include "extensions/filters/network/thrift_proxy/router/router_ratelimit_impl.h"
+#include "extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
 #include "extensions/filters/network/thrift_proxy/thrift_object.h"
 
 #include "absl/types/optional.h"
@@ -177,8 +178,9 @@ class Router : public Tcp::ConnectionPool::UpstreamCallbacks,
                Logger::Loggable<Logger::Id::thrift> {
 public:
   Router(Upstream::ClusterManager& cluster_manager, const std::string& stat_prefix,
-         Stats::Scope& scope)
-      : cluster_manager_(cluster_manager), stats_(generateStats(stat_prefix, scope)),
+         Stats::Scope& scope, UpstreamMultiplexer* multiplexer = nullptr)
+      : cluster_manager_(cluster_manager), multiplexer_(multiplexer),
+        stats_(generateStats(stat_prefix, scope)),
         stat_name_set_(scope.symbolTable().makeSet("thrift_proxy")),
         request_call_(stat_name_set_->add("request_call")),
         request_oneway_(stat_name_set_->add("request_oneway")),
@@ -224,15 +226,17 @@ public:
   void onBelowWriteBufferLowWatermark() override {}
 
 private:
-  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks {
+  struct UpstreamRequest : public Tcp::ConnectionPool::Callbacks,
+                           public MultiplexedRequestCallbacks {
     UpstreamRequest(Router& parent, Tcp::ConnectionPool::Instance& pool,
                     MessageMetadataSharedPtr& metadata, TransportType transport_type,
-                    ProtocolType protocol_type);
+                    ProtocolType protocol_type, UpstreamMultiplexer* multiplexer);
     ~UpstreamRequest() override;
 
     FilterStatus start();
     void resetStream();
     void releaseConnection(bool close);
+    Network::Connection& connection();
 
     // Tcp::ConnectionPool::Callbacks
     void onPoolFailure(ConnectionPool::PoolFailureReason reason,
@@ -240,6 +244,15 @@ private:
     void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
                      Upstream::HostDescriptionConstSharedPtr host) override;
 
+    // MultiplexedRequestCallbacks
+    void onMultiplexedConnectionReady(Network::Connection& connection,
+                                      Upstream::HostDescriptionConstSharedPtr host,
+                                      int32_t sequence_id) override;
+    void onMultiplexedConnectionFailure(ConnectionPool::PoolFailureReason reason,
+                                        Upstream::HostDescriptionConstSharedPtr host) override;
+    void onMultiplexedResponse(Buffer::Instance& frame) override;
+    void onMultiplexedConnectionClose(Network::ConnectionEvent event) override;
+
     void onRequestStart(bool continue_decoding);
     void onRequestComplete();
     void onResponseComplete();
@@ -257,6 +270,11 @@ private:
     TransportPtr transport_;
     ProtocolPtr protocol_;
     ThriftObjectPtr upgrade_response_;
+    // Set if the request shares its connection with other requests.
+    UpstreamMultiplexer* const multiplexer_;
+    MultiplexedRequestPtr multiplexed_;
+    Network::Connection* multiplexed_connection_{};
+    int32_t multiplexed_sequence_id_{};
 
     bool request_complete_ : 1;
     bool response_started_ : 1;
@@ -272,6 +290,7 @@ private:
   }
 
   Upstream::ClusterManager& cluster_manager_;
+  UpstreamMultiplexer* const multiplexer_;
   RouterStats stats_;
   Stats::StatNameSetPtr stat_name_set_;
   const Stats::StatName request_call_;
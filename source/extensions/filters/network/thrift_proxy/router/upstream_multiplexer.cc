@@ -0,0 +1,287 @@
+#include "extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/common/assert.h"
+
+#include "extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "extensions/filters/network/thrift_proxy/metadata.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+namespace {
+
+// The size of the frame size of the framed transport.
+constexpr uint64_t FrameSizeBytes = 4;
+
+// The bytes of a frame that are first tried for decoding its message begin, which is long enough
+// for all but the longest method names.
+constexpr uint64_t MessageBeginPeekBytes = 256;
+
+} // namespace
+
+UpstreamMultiplexer::UpstreamMultiplexer(ThreadLocal::SlotAllocator& tls,
+                                         uint32_t max_concurrent_requests)
+    : tls_(ThreadLocal::TypedSlot<ThreadLocalMultiplexer>::makeUnique(tls)) {
+  tls_->set([max_concurrent_requests](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalMultiplexer>(dispatcher, max_concurrent_requests);
+  });
+}
+
+MultiplexedRequestPtr UpstreamMultiplexer::attach(Tcp::ConnectionPool::Instance& pool,
+                                                  ProtocolType protocol,
+                                                  MultiplexedRequestCallbacks& callbacks) {
+  ThreadLocalMultiplexer& multiplexer = **tls_;
+  std::list<SharedConnectionPtr>& connections = multiplexer.connections_[{&pool, protocol}];
+  auto it = std::find_if(connections.begin(), connections.end(),
+                         [](const SharedConnectionPtr& connection) {
+                           return !connection->full() && !connection->draining();
+                         });
+
+  bool connect = false;
+  if (it == connections.end()) {
+    connections.push_back(std::make_unique<SharedConnection>(multiplexer, pool, protocol));
+    it = std::prev(connections.end());
+    connect = true;
+  }
+
+  SharedConnection& connection = **it;
+  auto attachment = std::make_unique<Attachment>(connection, callbacks);
+  connection.add(*attachment);
+  if (connect) {
+    connection.connect();
+  }
+  return attachment;
+}
+
+void UpstreamMultiplexer::Attachment::release(bool abandoned) {
+  if (connection_ != nullptr) {
+    SharedConnection* connection = connection_;
+    connection_ = nullptr;
+    connection->remove(*this, abandoned);
+  }
+}
+
+UpstreamMultiplexer::SharedConnection::SharedConnection(ThreadLocalMultiplexer& parent,
+                                                        Tcp::ConnectionPool::Instance& pool,
+                                                        ProtocolType protocol)
+    : parent_(parent), pool_(pool), protocol_type_(protocol),
+      protocol_(NamedProtocolConfigFactory::getFactory(protocol).createProtocol()) {}
+
+UpstreamMultiplexer::SharedConnection::~SharedConnection() {
+  if (pool_handle_ != nullptr) {
+    pool_handle_->cancel(Tcp::ConnectionPool::CancelPolicy::Default);
+  }
+  for (Attachment* attachment : waiting_) {
+    attachment->connection_ = nullptr;
+  }
+  for (auto& active : active_) {
+    active.second->connection_ = nullptr;
+  }
+  // Responses may still arrive for the requests in flight, so the connection can't be reused.
+  if (conn_data_ != nullptr && !active_.empty()) {
+    conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::connect() {
+  // The pool may call back before newConnection() returns.
+  Tcp::ConnectionPool::Cancellable* handle = pool_.newConnection(*this);
+  if (handle != nullptr && conn_data_ == nullptr && !destroyed_) {
+    pool_handle_ = handle;
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::add(Attachment& attachment) {
+  attachments_++;
+  if (conn_data_ == nullptr) {
+    waiting_.push_back(&attachment);
+  } else {
+    ready(attachment);
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::remove(Attachment& attachment, bool abandoned) {
+  ASSERT(attachments_ > 0);
+  attachments_--;
+  if (!attachment.ready_) {
+    waiting_.remove(&attachment);
+  } else {
+    auto it = active_.find(attachment.sequence_id_);
+    if (it != active_.end() && it->second == &attachment) {
+      active_.erase(it);
+      // A response may still arrive for the sequence ID, and be taken for the response to a
+      // later request with the same ID.
+      if (abandoned) {
+        draining_ = true;
+      }
+    }
+  }
+
+  if (attachments_ == 0) {
+    if (draining_ && conn_data_ != nullptr) {
+      close();
+    }
+    destroy();
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::ready(Attachment& attachment) {
+  // Skip the sequence IDs that are still in flight after wrapping around.
+  while (active_.contains(next_sequence_id_)) {
+    next_sequence_id_ = next_sequence_id_ == std::numeric_limits<int32_t>::max()
+                            ? 0
+                            : next_sequence_id_ + 1;
+  }
+  const int32_t sequence_id = next_sequence_id_;
+  next_sequence_id_ =
+      next_sequence_id_ == std::numeric_limits<int32_t>::max() ? 0 : next_sequence_id_ + 1;
+
+  attachment.ready_ = true;
+  attachment.sequence_id_ = sequence_id;
+  active_[sequence_id] = &attachment;
+  attachment.callbacks_.onMultiplexedConnectionReady(conn_data_->connection(), host_,
+                                                     sequence_id);
+}
+
+void UpstreamMultiplexer::SharedConnection::onPoolFailure(
+    ConnectionPool::PoolFailureReason reason, Upstream::HostDescriptionConstSharedPtr host) {
+  pool_handle_ = nullptr;
+  std::list<Attachment*> waiting;
+  waiting.swap(waiting_);
+  for (Attachment* attachment : waiting) {
+    attachment->connection_ = nullptr;
+    attachments_--;
+  }
+  destroy();
+  for (Attachment* attachment : waiting) {
+    attachment->callbacks_.onMultiplexedConnectionFailure(reason, host);
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::onPoolReady(
+    Tcp::ConnectionPool::ConnectionDataPtr&& conn, Upstream::HostDescriptionConstSharedPtr host) {
+  pool_handle_ = nullptr;
+  conn_data_ = std::move(conn);
+  conn_data_->addUpstreamCallbacks(*this);
+  host_ = std::move(host);
+
+  // The callbacks of a request may release the requests that follow it.
+  while (!waiting_.empty() && !destroyed_) {
+    Attachment* attachment = waiting_.front();
+    waiting_.pop_front();
+    ready(*attachment);
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::onUpstreamData(Buffer::Instance& data, bool) {
+  response_buffer_.move(data);
+  while (!destroyed_ && response_buffer_.length() >= FrameSizeBytes) {
+    const int32_t frame_size = response_buffer_.peekBEInt<int32_t>();
+    if (frame_size <= 0 || frame_size > FramedTransportImpl::MaxFrameSize) {
+      ENVOY_LOG(debug, "thrift multiplexed connection: invalid frame size {}", frame_size);
+      close();
+      return;
+    }
+    if (response_buffer_.length() < FrameSizeBytes + static_cast<uint64_t>(frame_size)) {
+      return;
+    }
+
+    Buffer::OwnedImpl frame;
+    frame.move(response_buffer_, FrameSizeBytes + frame_size);
+    const absl::optional<int32_t> sequence_id = sequenceId(frame);
+    if (!sequence_id.has_value()) {
+      ENVOY_LOG(debug, "thrift multiplexed connection: invalid message begin");
+      close();
+      return;
+    }
+
+    auto it = active_.find(sequence_id.value());
+    if (it == active_.end()) {
+      // The request was abandoned.
+      continue;
+    }
+    Attachment* attachment = it->second;
+    active_.erase(it);
+    attachment->callbacks_.onMultiplexedResponse(frame);
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::onEvent(Network::ConnectionEvent event) {
+  if (event != Network::ConnectionEvent::RemoteClose &&
+      event != Network::ConnectionEvent::LocalClose) {
+    return;
+  }
+
+  // The pool releases the connection itself.
+  conn_data_.reset();
+  absl::flat_hash_map<int32_t, Attachment*> active;
+  active.swap(active_);
+  for (auto& request : active) {
+    request.second->connection_ = nullptr;
+    attachments_--;
+  }
+  destroy();
+  for (auto& request : active) {
+    request.second->callbacks_.onMultiplexedConnectionClose(event);
+  }
+}
+
+absl::optional<int32_t> UpstreamMultiplexer::SharedConnection::sequenceId(Buffer::Instance& frame) {
+  MessageMetadata metadata;
+  const uint64_t peek_bytes = std::min<uint64_t>(frame.length(), FrameSizeBytes +
+                                                                     MessageBeginPeekBytes);
+  uint8_t peek[FrameSizeBytes + MessageBeginPeekBytes];
+  frame.copyOut(0, peek_bytes, peek);
+  Buffer::OwnedImpl message_begin(peek + FrameSizeBytes, peek_bytes - FrameSizeBytes);
+  try {
+    if (!protocol_->readMessageBegin(message_begin, metadata)) {
+      Buffer::OwnedImpl payload;
+      payload.add(frame);
+      payload.drain(FrameSizeBytes);
+      if (!protocol_->readMessageBegin(payload, metadata)) {
+        return absl::nullopt;
+      }
+    }
+  } catch (const EnvoyException&) {
+    return absl::nullopt;
+  }
+  return metadata.sequenceId();
+}
+
+void UpstreamMultiplexer::SharedConnection::close() {
+  // The event raised by closing the connection fails the requests in flight.
+  if (conn_data_ != nullptr) {
+    conn_data_->connection().close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void UpstreamMultiplexer::SharedConnection::destroy() {
+  if (destroyed_) {
+    return;
+  }
+  destroyed_ = true;
+
+  auto it = parent_.connections_.find(std::make_pair(&pool_, protocol_type_));
+  ASSERT(it != parent_.connections_.end());
+  std::list<SharedConnectionPtr>& connections = it->second;
+  auto connection = std::find_if(
+      connections.begin(), connections.end(),
+      [this](const SharedConnectionPtr& connection) { return connection.get() == this; });
+  ASSERT(connection != connections.end());
+  parent_.dispatcher_.deferredDelete(std::move(*connection));
+  connections.erase(connection);
+  if (connections.empty()) {
+    parent_.connections_.erase(it);
+  }
+}
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <utility>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/network/connection.h"
+#include "envoy/tcp/conn_pool.h"
+#include "envoy/thread_local/thread_local.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+
+#include "extensions/filters/network/thrift_proxy/protocol.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+/**
+ * Callbacks of a request sent over a connection shared with other requests.
+ */
+class MultiplexedRequestCallbacks {
+public:
+  virtual ~MultiplexedRequestCallbacks() = default;
+
+  /**
+   * Called once the request can be written to the shared connection. It may be called before
+   * UpstreamMultiplexer::attach() returns.
+   * @param connection supplies the shared connection. Only whole frames may be written to it.
+   * @param host supplies the upstream host of the connection.
+   * @param sequence_id supplies the sequence ID of the request, which is unique among the requests
+   *        in flight on the connection.
+   */
+  virtual void onMultiplexedConnectionReady(Network::Connection& connection,
+                                            Upstream::HostDescriptionConstSharedPtr host,
+                                            int32_t sequence_id) PURE;
+
+  /**
+   * Called if the shared connection can't be established. It may be called before
+   * UpstreamMultiplexer::attach() returns.
+   * @param reason supplies the reason of the failure.
+   * @param host supplies the upstream host, if one was selected.
+   */
+  virtual void onMultiplexedConnectionFailure(ConnectionPool::PoolFailureReason reason,
+                                              Upstream::HostDescriptionConstSharedPtr host) PURE;
+
+  /**
+   * Called with the frame of the response to the request.
+   * @param frame supplies the whole frame, including its transport.
+   */
+  virtual void onMultiplexedResponse(Buffer::Instance& frame) PURE;
+
+  /**
+   * Called if the shared connection closes while the request is in flight.
+   * @param event supplies the close event.
+   */
+  virtual void onMultiplexedConnectionClose(Network::ConnectionEvent event) PURE;
+};
+
+/**
+ * A request attached to a shared connection. Destroying it detaches the request, after which its
+ * callbacks are no longer called.
+ */
+class MultiplexedRequest {
+public:
+  virtual ~MultiplexedRequest() = default;
+
+  /**
+   * Detaches the request from the shared connection.
+   * @param abandoned supplies whether a response may still arrive for the request, e.g. because
+   *        it was reset. The connection is then closed once its other requests are done, as its
+   *        sequence IDs can't be trusted anymore.
+   */
+  virtual void release(bool abandoned) PURE;
+};
+
+using MultiplexedRequestPtr = std::unique_ptr<MultiplexedRequest>;
+
+/**
+ * Pipelines the requests of each worker to an upstream host over a few connections of the TCP
+ * connection pool of the host. Responses are matched to their requests by sequence ID, so they may
+ * arrive out of order. Only the framed transport is supported. A shared connection is returned to
+ * its pool once it has no requests left, so the pool can reuse it, drain it or close it as usual.
+ */
+class UpstreamMultiplexer {
+public:
+  static constexpr uint32_t DefaultMaxConcurrentRequests = 100;
+
+  UpstreamMultiplexer(ThreadLocal::SlotAllocator& tls, uint32_t max_concurrent_requests);
+
+  /**
+   * Attaches a request to a shared connection of the pool. Called on the worker thread of the
+   * pool.
+   * @param pool supplies the connection pool of the upstream host.
+   * @param protocol supplies the protocol of the upstream, which the responses are decoded with.
+   * @param callbacks supplies the callbacks of the request.
+   * @return MultiplexedRequestPtr the attached request.
+   */
+  MultiplexedRequestPtr attach(Tcp::ConnectionPool::Instance& pool, ProtocolType protocol,
+                               MultiplexedRequestCallbacks& callbacks);
+
+private:
+  class SharedConnection;
+  using SharedConnectionPtr = std::unique_ptr<SharedConnection>;
+
+  struct Attachment : public MultiplexedRequest {
+    Attachment(SharedConnection& connection, MultiplexedRequestCallbacks& callbacks)
+        : connection_(&connection), callbacks_(callbacks) {}
+    ~Attachment() override { release(true); }
+
+    // MultiplexedRequest
+    void release(bool abandoned) override;
+
+    SharedConnection* connection_;
+    MultiplexedRequestCallbacks& callbacks_;
+    int32_t sequence_id_{};
+    bool ready_{};
+  };
+
+  struct ThreadLocalMultiplexer;
+
+  class SharedConnection : public Tcp::ConnectionPool::Callbacks,
+                           public Tcp::ConnectionPool::UpstreamCallbacks,
+                           public Event::DeferredDeletable,
+                           Logger::Loggable<Logger::Id::thrift> {
+  public:
+    SharedConnection(ThreadLocalMultiplexer& parent, Tcp::ConnectionPool::Instance& pool,
+                     ProtocolType protocol);
+    ~SharedConnection() override;
+
+    void connect();
+    void add(Attachment& attachment);
+    void remove(Attachment& attachment, bool abandoned);
+    bool full() const { return attachments_ >= parent_.max_concurrent_requests_; }
+    bool draining() const { return draining_; }
+
+    // Tcp::ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(Tcp::ConnectionPool::ConnectionDataPtr&& conn,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+
+    // Tcp::ConnectionPool::UpstreamCallbacks
+    void onUpstreamData(Buffer::Instance& data, bool end_stream) override;
+    void onEvent(Network::ConnectionEvent event) override;
+    void onAboveWriteBufferHighWatermark() override {}
+    void onBelowWriteBufferLowWatermark() override {}
+
+  private:
+    void ready(Attachment& attachment);
+    absl::optional<int32_t> sequenceId(Buffer::Instance& frame);
+    void close();
+    void destroy();
+
+    ThreadLocalMultiplexer& parent_;
+    Tcp::ConnectionPool::Instance& pool_;
+    const ProtocolType protocol_type_;
+    const ProtocolPtr protocol_;
+    Tcp::ConnectionPool::Cancellable* pool_handle_{};
+    Tcp::ConnectionPool::ConnectionDataPtr conn_data_;
+    Upstream::HostDescriptionConstSharedPtr host_;
+    // The requests waiting for the connection.
+    std::list<Attachment*> waiting_;
+    // The requests in flight, by sequence ID.
+    absl::flat_hash_map<int32_t, Attachment*> active_;
+    uint32_t attachments_{};
+    int32_t next_sequence_id_{};
+    Buffer::OwnedImpl response_buffer_;
+    bool draining_{};
+    bool destroyed_{};
+  };
+
+  struct ThreadLocalMultiplexer : public ThreadLocal::ThreadLocalObject {
+    ThreadLocalMultiplexer(Event::Dispatcher& dispatcher, uint32_t max_concurrent_requests)
+        : dispatcher_(dispatcher), max_concurrent_requests_(max_concurrent_requests) {}
+
+    Event::Dispatcher& dispatcher_;
+    const uint32_t max_concurrent_requests_;
+    // The shared connections, by pool and protocol.
+    absl::flat_hash_map<std::pair<Tcp::ConnectionPool::Instance*, ProtocolType>,
+                        std::list<SharedConnectionPtr>>
+        connections_;
+  };
+
+  const ThreadLocal::TypedSlotPtr<ThreadLocalMultiplexer> tls_;
+};
+
+using UpstreamMultiplexerSharedPtr = std::shared_ptr<UpstreamMultiplexer>;
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
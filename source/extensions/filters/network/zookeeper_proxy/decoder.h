@@ -10,7 +10,7 @@
 
 #include "extensions/filters/network/zookeeper_proxy/utils.h"
 
-#include "absl/container/node_hash_map.h"
+#include "absl/container/flat_hash_map.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -171,7 +171,7 @@ private:
   const uint32_t max_packet_bytes_;
   BufferHelper helper_;
   TimeSource& time_source_;
-  absl::node_hash_map<int32_t, RequestBegin> requests_by_xid_;
+  absl::flat_hash_map<int32_t, RequestBegin> requests_by_xid_;
 };
 
 } // namespace ZooKeeperProxy
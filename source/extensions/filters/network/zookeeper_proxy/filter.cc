@@ -26,7 +26,9 @@ ZooKeeperFilterConfig::ZooKeeperFilterConfig(const std::string& stat_prefix,
       stat_prefix_(stat_name_set_->add(stat_prefix)), auth_(stat_name_set_->add("auth")),
       connect_latency_(stat_name_set_->add("connect_response_latency")),
       unknown_scheme_rq_(stat_name_set_->add("unknown_scheme_rq")),
-      unknown_opcode_latency_(stat_name_set_->add("unknown_opcode_latency")) {
+      unknown_opcode_latency_(stat_name_set_->add("unknown_opcode_latency")),
+      connect_latency_histogram_(latencyHistogram(connect_latency_)),
+      unknown_opcode_latency_histogram_(latencyHistogram(unknown_opcode_latency_)) {
   // https://zookeeper.apache.org/doc/r3.5.4-beta/zookeeperProgrammers.html#sc_BuiltinACLSchemes
   // lists commons schemes: "world", "auth", "digest", "host", "x509", and
   // "ip". These are used in filter.cc by appending "_rq".
@@ -65,7 +67,13 @@ void ZooKeeperFilterConfig::initOpCode(OpCodes opcode, Stats::Counter& counter,
   OpCodeInfo& opcode_info = op_code_map_[opcode];
   opcode_info.counter_ = &counter;
   opcode_info.opname_ = std::string(name);
-  opcode_info.latency_name_ = stat_name_set_->add(absl::StrCat(name, "_latency"));
+  opcode_info.latency_histogram_ =
+      &latencyHistogram(stat_name_set_->add(absl::StrCat(name, "_latency")));
+}
+
+Stats::Histogram& ZooKeeperFilterConfig::latencyHistogram(Stats::StatName latency_name) {
+  return Stats::Utility::histogramFromStatNames(scope_, {stat_prefix_, latency_name},
+                                                Stats::Histogram::Unit::Milliseconds);
 }
 
 ZooKeeperFilter::ZooKeeperFilter(ZooKeeperFilterConfigSharedPtr config, TimeSource& time_source)
@@ -120,7 +128,7 @@ void ZooKeeperFilter::setDynamicMetadata(
   }
 
   read_callbacks_->connection().streamInfo().setDynamicMetadata(
-      NetworkFilterNames::get().ZooKeeperProxy, metadata);
+      NetworkFilterNames::get().ZooKeeperProxy, std::move(metadata));
 }
 
 void ZooKeeperFilter::onConnect(const bool readonly) {
@@ -289,11 +297,7 @@ void ZooKeeperFilter::onConnectResponse(const int32_t proto_version, const int32
                                         const bool readonly,
                                         const std::chrono::milliseconds& latency) {
   config_->stats_.connect_resp_.inc();
-
-  Stats::Histogram& histogram = Stats::Utility::histogramFromElements(
-      config_->scope_, {config_->stat_prefix_, config_->connect_latency_},
-      Stats::Histogram::Unit::Milliseconds);
-  histogram.recordValue(latency.count());
+  config_->connect_latency_histogram_.recordValue(latency.count());
 
   setDynamicMetadata({{"opname", "connect_response"},
                       {"protocol_version", std::to_string(proto_version)},
@@ -303,20 +307,16 @@ void ZooKeeperFilter::onConnectResponse(const int32_t proto_version, const int32
 
 void ZooKeeperFilter::onResponse(const OpCodes opcode, const int32_t xid, const int64_t zxid,
                                  const int32_t error, const std::chrono::milliseconds& latency) {
-  Stats::StatName opcode_latency = config_->unknown_opcode_latency_;
+  Stats::Histogram* histogram = &config_->unknown_opcode_latency_histogram_;
   auto iter = config_->op_code_map_.find(opcode);
   std::string opname = "";
   if (iter != config_->op_code_map_.end()) {
     const ZooKeeperFilterConfig::OpCodeInfo& opcode_info = iter->second;
     opcode_info.counter_->inc();
     opname = opcode_info.opname_;
-    opcode_latency = opcode_info.latency_name_;
+    histogram = opcode_info.latency_histogram_;
   }
-
-  Stats::Histogram& histogram = Stats::Utility::histogramFromStatNames(
-      config_->scope_, {config_->stat_prefix_, opcode_latency},
-      Stats::Histogram::Unit::Milliseconds);
-  histogram.recordValue(latency.count());
+  histogram->recordValue(latency.count());
 
   setDynamicMetadata({{"opname", opname},
                       {"xid", std::to_string(xid)},
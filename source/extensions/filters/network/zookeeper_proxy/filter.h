@@ -101,13 +101,13 @@ public:
   uint32_t maxPacketBytes() const { return max_packet_bytes_; }
 
   // Captures the counter used to track total op-code usage, as well as the
-  // StatName under which to collect the latency for that op-code. The
-  // latency-name will be joined with the stat_prefix_, which varies per filter
-  // instance.
+  // histogram collecting the latency for that op-code, named after the
+  // stat_prefix_, which varies per filter instance. The histograms are created
+  // with the config so that the responses don't look them up by name.
   struct OpCodeInfo {
     Stats::Counter* counter_;
     std::string opname_;
-    Stats::StatName latency_name_;
+    Stats::Histogram* latency_histogram_;
   };
 
   absl::flat_hash_map<OpCodes, OpCodeInfo> op_code_map_;
@@ -120,9 +120,12 @@ public:
   const Stats::StatName connect_latency_;
   const Stats::StatName unknown_scheme_rq_;
   const Stats::StatName unknown_opcode_latency_;
+  Stats::Histogram& connect_latency_histogram_;
+  Stats::Histogram& unknown_opcode_latency_histogram_;
 
 private:
   void initOpCode(OpCodes opcode, Stats::Counter& counter, absl::string_view name);
+  Stats::Histogram& latencyHistogram(Stats::StatName latency_name);
 
   ZooKeeperProxyStats generateStats(const std::string& prefix, Stats::Scope& scope) {
     return ZooKeeperProxyStats{ALL_ZOOKEEPER_PROXY_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
@@ -150,6 +150,7 @@ DnsFilterEnvoyConfig::DnsFilterEnvoyConfig(
         client_config, resolver_timeout, DEFAULT_RESOLVER_TIMEOUT.count()));
 
     max_pending_lookups_ = client_config.max_pending_lookups();
+    max_cached_answers_ = client_config.max_cached_answers();
   }
 }
 
@@ -212,9 +213,12 @@ DnsFilter::DnsFilter(Network::UdpReadFilterCallbacks& callbacks,
     }
 
     incrementExternalQueryTypeCount(query->type_);
+    const std::chrono::seconds ttl = getDomainTTL(query->name_);
+    if (context->resolution_status_ == Network::DnsResolver::ResolutionStatus::Success) {
+      cacheAnswers(*query, iplist, ttl);
+    }
     for (const auto& ip : iplist) {
       incrementExternalQueryTypeAnswerCount(query->type_);
-      const std::chrono::seconds ttl = getDomainTTL(query->name_);
       message_parser_.storeDnsAnswerRecord(context, *query, ttl, std::move(ip));
     }
     sendDnsResponse(std::move(context));
@@ -292,6 +296,11 @@ DnsLookupResponseCode DnsFilter::getResponseForQuery(DnsQueryContextPtr& context
       }
     }
 
+    // Determine whether the external resolvers answered this query recently
+    if (resolveViaAnswerCache(context, *query)) {
+      continue;
+    }
+
     ENVOY_LOG(debug, "resolving name [{}] via external resolvers", query->name_);
     resolver_->resolveExternalQuery(std::move(context), query.get());
 
@@ -318,6 +327,52 @@ bool DnsFilter::resolveViaConfiguredHosts(DnsQueryContextPtr& context,
   }
 }
 
+bool DnsFilter::resolveViaAnswerCache(DnsQueryContextPtr& context, const DnsQueryRecord& query) {
+  if (answer_cache_.empty()) {
+    return false;
+  }
+
+  const auto iter = answer_cache_.find(std::make_pair(query.name_, query.type_));
+  if (iter == answer_cache_.end()) {
+    return false;
+  }
+
+  // The answers are returned with the remainder of their TTL, and dropped once less than a second
+  // is left.
+  const auto ttl = std::chrono::duration_cast<std::chrono::seconds>(
+      iter->second.expiry_time_ - listener_.dispatcher().timeSource().monotonicTime());
+  if (ttl.count() <= 0) {
+    answer_cache_.erase(iter);
+    return false;
+  }
+
+  ENVOY_LOG(debug, "resolving name [{}] from the cached external answers", query.name_);
+  config_->stats().external_cache_hits_.inc();
+  for (const auto& ip : iter->second.addresses_) {
+    message_parser_.storeDnsAnswerRecord(context, query, ttl, ip);
+  }
+  return true;
+}
+
+void DnsFilter::cacheAnswers(const DnsQueryRecord& query, const AddressConstPtrVec& iplist,
+                             std::chrono::seconds ttl) {
+  const uint64_t max_cached_answers = config_->maxCachedAnswers();
+  if (max_cached_answers == 0 || iplist.empty()) {
+    return;
+  }
+
+  const MonotonicTime now = listener_.dispatcher().timeSource().monotonicTime();
+  if (answer_cache_.size() >= max_cached_answers) {
+    // Make room by dropping the expired answers first, then any cached answers.
+    absl::erase_if(answer_cache_,
+                   [now](const auto& entry) { return entry.second.expiry_time_ <= now; });
+    if (answer_cache_.size() >= max_cached_answers) {
+      answer_cache_.erase(answer_cache_.begin());
+    }
+  }
+  answer_cache_[std::make_pair(query.name_, query.type_)] = {iplist, now + ttl};
+}
+
 std::chrono::seconds DnsFilter::getDomainTTL(const absl::string_view domain) {
   const auto& domain_ttl_config = config_->domainTtl();
   const auto& iter = domain_ttl_config.find(domain);
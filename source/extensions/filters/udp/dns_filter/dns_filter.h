@@ -13,6 +13,7 @@
 #include "extensions/filters/udp/dns_filter/dns_filter_resolver.h"
 #include "extensions/filters/udp/dns_filter/dns_parser.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
@@ -38,6 +39,7 @@ namespace DnsFilter {
   COUNTER(external_a_record_answers)                                                               \
   COUNTER(external_aaaa_record_answers)                                                            \
   COUNTER(external_aaaa_record_queries)                                                            \
+  COUNTER(external_cache_hits)                                                                     \
   COUNTER(external_unsupported_answers)                                                            \
   COUNTER(external_unsupported_queries)                                                            \
   COUNTER(externally_resolved_queries)                                                             \
@@ -93,6 +95,7 @@ public:
   uint64_t retryCount() const { return retry_count_; }
   Random::RandomGenerator& random() const { return random_; }
   uint64_t maxPendingLookups() const { return max_pending_lookups_; }
+  uint64_t maxCachedAnswers() const { return max_cached_answers_; }
 
 private:
   static DnsFilterStats generateStats(const std::string& stat_prefix, Stats::Scope& scope) {
@@ -120,6 +123,7 @@ private:
   std::chrono::milliseconds resolver_timeout_;
   Random::RandomGenerator& random_;
   uint64_t max_pending_lookups_;
+  uint64_t max_cached_answers_{};
 };
 
 using DnsFilterEnvoyConfigSharedPtr = std::shared_ptr<const DnsFilterEnvoyConfig>;
@@ -222,6 +226,26 @@ private:
    */
   bool resolveViaConfiguredHosts(DnsQueryContextPtr& context, const DnsQueryRecord& query);
 
+  /**
+   * @brief Resolves the supplied query from the cached answers of the external resolvers
+   *
+   * @param context object containing the query context
+   * @param query query object containing the name to be resolved
+   * @return bool true if the answers for the name and record type are cached and not expired
+   */
+  bool resolveViaAnswerCache(DnsQueryContextPtr& context, const DnsQueryRecord& query);
+
+  /**
+   * @brief Caches the answers of the external resolvers for the supplied query, for the TTL of
+   * the answer records
+   *
+   * @param query query object containing the name that was resolved
+   * @param iplist the addresses returned by the external resolvers
+   * @param ttl the TTL of the answer records
+   */
+  void cacheAnswers(const DnsQueryRecord& query, const AddressConstPtrVec& iplist,
+                    std::chrono::seconds ttl);
+
   /**
    * @brief Increment the counter for the given query type for external queries
    *
@@ -359,6 +383,12 @@ private:
    */
   const absl::string_view getClusterNameForDomain(const absl::string_view domain);
 
+  // The addresses returned by the external resolvers for a name and record type.
+  struct CachedAnswers {
+    AddressConstPtrVec addresses_;
+    MonotonicTime expiry_time_;
+  };
+
   const DnsFilterEnvoyConfigSharedPtr config_;
   Network::UdpListener& listener_;
   Upstream::ClusterManager& cluster_manager_;
@@ -367,6 +397,7 @@ private:
   Network::Address::InstanceConstSharedPtr local_;
   Network::Address::InstanceConstSharedPtr peer_;
   DnsFilterResolverCallback resolver_callback_;
+  absl::flat_hash_map<std::pair<std::string, uint16_t>, CachedAnswers> answer_cache_;
 };
 
 } // namespace DnsFilter
@@ -72,7 +72,12 @@ UdpProxyFilter::ClusterInfo::ClusterInfo(UdpProxyFilter& filter,
                 host_to_sessions_.erase(host_sessions_it);
               }
             }
-          })) {}
+          })) {
+  if (filter_.config_->upstreamSocketConfig().prefer_gso_) {
+    flush_cb_ = filter_.read_callbacks_->udpListener().dispatcher().createSchedulableCallback(
+        [this] { flushSessions(); });
+  }
+}
 
 UdpProxyFilter::ClusterInfo::~ClusterInfo() {
   // Sanity check the session accounting. This is not as fast as a straight teardown, but this is
@@ -128,6 +133,18 @@ void UdpProxyFilter::ClusterInfo::onData(Network::UdpRecvData& data) {
   active_session->write(*data.buffer_);
 }
 
+void UdpProxyFilter::ClusterInfo::scheduleFlush(ActiveSession& session) {
+  sessions_to_flush_.insert(&session);
+  flush_cb_->scheduleCallbackCurrentIteration();
+}
+
+void UdpProxyFilter::ClusterInfo::flushSessions() {
+  for (ActiveSession* session : sessions_to_flush_) {
+    session->flush();
+  }
+  sessions_to_flush_.clear();
+}
+
 UdpProxyFilter::ActiveSession*
 UdpProxyFilter::ClusterInfo::createSession(Network::UdpRecvData::LocalPeerAddresses&& addresses,
                                            const Upstream::HostConstSharedPtr& host) {
@@ -162,6 +179,10 @@ UdpProxyFilter::ActiveSession::ActiveSession(ClusterInfo& cluster,
       // NOTE: The socket call can only fail due to memory/fd exhaustion. No local ephemeral port
       //       is bound until the first packet is sent to the upstream host.
       socket_(cluster.filter_.createSocket(host)) {
+  if (cluster_.filter_.config_->upstreamSocketConfig().prefer_gso_) {
+    writer_ = std::make_unique<Network::UdpGsoWriter>(
+        socket_->ioHandle(), cluster_.filter_.config_->upstreamWriterStats().value());
+  }
 
   socket_->ioHandle().initializeFileEvent(
       cluster.filter_.read_callbacks_->udpListener().dispatcher(),
@@ -199,6 +220,11 @@ UdpProxyFilter::ActiveSession::~ActiveSession() {
   ENVOY_LOG(debug, "deleting the session: downstream={} local={} upstream={}",
             addresses_.peer_->asStringView(), addresses_.local_->asStringView(),
             host_->address()->asStringView());
+  if (writer_ != nullptr) {
+    // Don't drop the datagrams that were already accepted.
+    cluster_.cancelFlush(*this);
+    flush();
+  }
   cluster_.filter_.config_->stats().downstream_sess_active_.dec();
   cluster_.cluster_.info()
       ->resourceManager(Upstream::ResourcePriority::Default)
@@ -246,8 +272,18 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   //       set. We allow the OS to select the right IP based on outbound routing rules if
   //       use_original_src_ip_ is not set, else use downstream peer IP as local IP.
   const Network::Address::Ip* local_ip = use_original_src_ip_ ? addresses_.peer_->ip() : nullptr;
-  Api::IoCallUint64Result rc =
-      Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
+  Api::IoCallUint64Result rc = Api::ioCallUint64ResultNoError();
+  if (writer_ != nullptr) {
+    // The socket doesn't watch for write events, so retry on each write like the unbatched path
+    // does.
+    writer_->setWritable();
+    rc = writer_->writePacket(buffer, local_ip, *host_->address());
+    if (writer_->bufferedDatagrams() > 0) {
+      cluster_.scheduleFlush(*this);
+    }
+  } else {
+    rc = Network::Utility::writeToSocket(socket_->ioHandle(), buffer, local_ip, *host_->address());
+  }
   if (!rc.ok()) {
     cluster_.cluster_stats_.sess_tx_errors_.inc();
   } else {
@@ -256,6 +292,13 @@ void UdpProxyFilter::ActiveSession::write(const Buffer::Instance& buffer) {
   }
 }
 
+void UdpProxyFilter::ActiveSession::flush() {
+  const Api::IoCallUint64Result rc = writer_->flush();
+  if (!rc.ok()) {
+    cluster_.cluster_stats_.sess_tx_errors_.inc();
+  }
+}
+
 void UdpProxyFilter::ActiveSession::processPacket(Network::Address::InstanceConstSharedPtr,
                                                   Network::Address::InstanceConstSharedPtr,
                                                   Buffer::InstancePtr buffer, MonotonicTime) {
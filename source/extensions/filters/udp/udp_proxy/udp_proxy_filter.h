@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/event/file_event.h"
+#include "envoy/event/schedulable_cb.h"
 #include "envoy/event/timer.h"
 #include "envoy/extensions/filters/udp/udp_proxy/v3/udp_proxy.pb.h"
 #include "envoy/network/filter.h"
@@ -9,6 +10,7 @@
 #include "common/api/os_sys_calls_impl.h"
 #include "common/network/socket_impl.h"
 #include "common/network/socket_interface.h"
+#include "common/network/udp_gso_writer_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
 #include "common/upstream/load_balancer_impl.h"
@@ -74,6 +76,10 @@ public:
         stats_(generateStats(config.stat_prefix(), root_scope)),
         // Default prefer_gro to true for upstream client traffic.
         upstream_socket_config_(config.upstream_socket_config(), true) {
+    if (upstream_socket_config_.prefer_gso_) {
+      upstream_writer_stats_ = Network::UdpGsoWriterStats::generate(
+          root_scope, absl::StrCat("udp.", config.stat_prefix(), ".upstream_gso_writer."));
+    }
     if (use_original_src_ip_ && !Api::OsSysCallsSingleton::get().supportsIpTransparent()) {
       ExceptionUtil::throwEnvoyException(
           "The platform does not support either IP_TRANSPARENT or IPV6_TRANSPARENT. Or the envoy "
@@ -94,6 +100,10 @@ public:
   const Network::ResolvedUdpSocketConfig& upstreamSocketConfig() const {
     return upstream_socket_config_;
   }
+  // Only set if GSO is preferred for upstream sockets.
+  const absl::optional<Network::UdpGsoWriterStats>& upstreamWriterStats() const {
+    return upstream_writer_stats_;
+  }
 
 private:
   static UdpProxyDownstreamStats generateStats(const std::string& stat_prefix,
@@ -111,6 +121,7 @@ private:
   std::unique_ptr<const HashPolicyImpl> hash_policy_;
   mutable UdpProxyDownstreamStats stats_;
   const Network::ResolvedUdpSocketConfig upstream_socket_config_;
+  absl::optional<Network::UdpGsoWriterStats> upstream_writer_stats_;
 };
 
 using UdpProxyFilterConfigSharedPtr = std::shared_ptr<const UdpProxyFilterConfig>;
@@ -163,6 +174,7 @@ private:
     const Network::UdpRecvData::LocalPeerAddresses& addresses() const { return addresses_; }
     const Upstream::Host& host() const { return *host_; }
     void write(const Buffer::Instance& buffer);
+    void flush();
 
   private:
     void onIdleTimer();
@@ -193,6 +205,9 @@ private:
     // packets from the upstream host. Note that a a local ephemeral port is bound on the first
     // write to the upstream host.
     const Network::SocketPtr socket_;
+    // Coalesces the datagrams written to the upstream host during an event loop iteration if GSO
+    // is preferred. Otherwise each datagram is written as soon as it is received.
+    std::unique_ptr<Network::UdpGsoWriter> writer_;
   };
 
   using ActiveSessionPtr = std::unique_ptr<ActiveSession>;
@@ -244,6 +259,8 @@ private:
     ~ClusterInfo();
     void onData(Network::UdpRecvData& data);
     void removeSession(const ActiveSession* session);
+    void scheduleFlush(ActiveSession& session);
+    void cancelFlush(ActiveSession& session) { sessions_to_flush_.erase(&session); }
 
     UdpProxyFilter& filter_;
     Upstream::ThreadLocalCluster& cluster_;
@@ -257,7 +274,13 @@ private:
       return {ALL_UDP_PROXY_UPSTREAM_STATS(POOL_COUNTER_PREFIX(scope, final_prefix))};
     }
 
+    void flushSessions();
+
     Envoy::Common::CallbackHandlePtr member_update_cb_handle_;
+    // Sessions with datagrams buffered by their writer, flushed once the current event loop
+    // iteration has delivered every datagram it read from the downstream socket.
+    absl::flat_hash_set<ActiveSession*> sessions_to_flush_;
+    Event::SchedulableCallbackPtr flush_cb_;
     absl::flat_hash_set<ActiveSessionPtr, HeterogeneousActiveSessionHash,
                         HeterogeneousActiveSessionEqual>
         sessions_;
@@ -1,5 +1,7 @@
 #include "extensions/stat_sinks/common/statsd/statsd.h"
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -15,6 +17,7 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/fmt.h"
+#include "common/common/logger.h"
 #include "common/common/utility.h"
 #include "common/config/utility.h"
 #include "common/network/socket_interface.h"
@@ -34,6 +37,10 @@ UdpStatsdSink::WriterImpl::WriterImpl(UdpStatsdSink& parent)
                                                            parent_.server_address_)) {}
 
 void UdpStatsdSink::WriterImpl::write(const std::string& message) {
+  if (batching_) {
+    batch_.push_back(message);
+    return;
+  }
   // TODO(mattklein123): We can avoid this const_cast pattern by having a constant variant of
   // RawSlice. This can be fixed elsewhere as well.
   Buffer::RawSlice slice{const_cast<char*>(message.c_str()), message.size()};
@@ -41,9 +48,56 @@ void UdpStatsdSink::WriterImpl::write(const std::string& message) {
 }
 
 void UdpStatsdSink::WriterImpl::writeBuffer(Buffer::Instance& data) {
+  if (batching_) {
+    batch_.push_back(data.toString());
+    return;
+  }
   Network::Utility::writeToSocket(*io_handle_, data, nullptr, *parent_.server_address_);
 }
 
+void UdpStatsdSink::WriterImpl::endBatch() {
+  batching_ = false;
+  sendBatch();
+  batch_.clear();
+}
+
+void UdpStatsdSink::WriterImpl::sendBatch() {
+  const os_fd_t fd = io_handle_->fdDoNotUse();
+  if (batch_.size() < 2 || !io_handle_->supportsMmsg() || !SOCKET_VALID(fd)) {
+    for (const std::string& message : batch_) {
+      write(message);
+    }
+    return;
+  }
+
+  // The datagrams of a flush are sent with as few system calls as possible. As for the single
+  // writes, the datagrams that can't be sent are dropped.
+  std::array<mmsghdr, MaxDatagramsPerSend> messages;
+  std::array<iovec, MaxDatagramsPerSend> iovs;
+  uint64_t next = 0;
+  while (next < batch_.size()) {
+    const uint32_t count = std::min<uint64_t>(batch_.size() - next, MaxDatagramsPerSend);
+    for (uint32_t i = 0; i < count; ++i) {
+      std::string& message = batch_[next + i];
+      iovs[i].iov_base = message.data();
+      iovs[i].iov_len = message.size();
+      messages[i] = {};
+      messages[i].msg_hdr.msg_name = const_cast<sockaddr*>(parent_.server_address_->sockAddr());
+      messages[i].msg_hdr.msg_namelen = parent_.server_address_->sockAddrLen();
+      messages[i].msg_hdr.msg_iov = &iovs[i];
+      messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    const Api::SysCallIntResult result =
+        Api::OsSysCallsSingleton::get().sendmmsg(fd, messages.data(), count, 0);
+    if (result.rc_ <= 0) {
+      ENVOY_LOG_MISC(debug, "statsd: dropping {} datagrams, sendmmsg() failed: errno {}",
+                     batch_.size() - next, result.errno_);
+      return;
+    }
+    next += result.rc_;
+  }
+}
+
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
                              const std::string& prefix, absl::optional<uint64_t> buffer_size)
@@ -58,6 +112,7 @@ UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   Writer& writer = tls_->getTyped<Writer>();
   Buffer::OwnedImpl buffer;
+  writer.beginBatch();
 
   for (const auto& counter : snapshot.counters()) {
     if (counter.counter_.get().used()) {
@@ -78,6 +133,7 @@ void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   }
 
   flushBuffer(buffer, writer);
+  writer.endBatch();
   // TODO(efimki): Add support of text readouts stats.
 }
 
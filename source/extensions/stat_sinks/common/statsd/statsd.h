@@ -38,6 +38,16 @@ public:
   public:
     virtual void write(const std::string& message) PURE;
     virtual void writeBuffer(Buffer::Instance& data) PURE;
+
+    /**
+     * Starts a batch: the datagrams written until endBatch() may be held back, to be sent together.
+     */
+    virtual void beginBatch() PURE;
+
+    /**
+     * Ends the batch started by beginBatch(), sending the datagrams held back.
+     */
+    virtual void endBatch() PURE;
   };
 
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
@@ -73,10 +83,19 @@ private:
     // Writer
     void write(const std::string& message) override;
     void writeBuffer(Buffer::Instance& data) override;
+    void beginBatch() override { batching_ = true; }
+    void endBatch() override;
 
   private:
+    // The most datagrams sent by a single sendmmsg() call.
+    static constexpr uint32_t MaxDatagramsPerSend = 64;
+
+    void sendBatch();
+
     UdpStatsdSink& parent_;
     const Network::IoHandlePtr io_handle_;
+    bool batching_{};
+    std::vector<std::string> batch_;
   };
 
   void flushBuffer(Buffer::OwnedImpl& buffer, Writer& writer) const;
@@ -11,8 +11,10 @@
 #include "common/common/logger.h"
 #include "common/config/well_known_names.h"
 #include "common/http/headers.h"
+#include "common/http/utility.h"
 #include "common/stats/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "fmt/printf.h"
@@ -29,6 +31,24 @@ Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::Respons
 Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::ResponseHeaders>
     cache_control_handle(Http::CustomHeaders::get().CacheControl);
 
+namespace {
+
+// Adds the shared data to the buffer without copying it, the data being kept alive until the buffer
+// releases it.
+void addSharedData(Buffer::Instance& buffer, const std::shared_ptr<const std::string>& data) {
+  if (data->empty()) {
+    return;
+  }
+  auto* fragment = new Buffer::BufferFragmentImpl(
+      data->data(), data->size(),
+      [data](const void*, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+        delete this_fragment;
+      });
+  buffer.addBufferFragment(*fragment);
+}
+
+} // namespace
+
 const uint64_t HystrixSink::DEFAULT_NUM_BUCKETS;
 ClusterStatsCache::ClusterStatsCache(const std::string& cluster_name)
     : cluster_name_(cluster_name) {}
@@ -43,10 +63,11 @@ void ClusterStatsCache::printToStream(std::stringstream& out_str) {
   printRollingWindow(absl::StrCat(cluster_name_prefix, "total"), total_, out_str);
 }
 
-void ClusterStatsCache::printRollingWindow(absl::string_view name, RollingWindow rolling_window,
+void ClusterStatsCache::printRollingWindow(absl::string_view name,
+                                           const RollingWindow& rolling_window,
                                            std::stringstream& out_str) {
   out_str << name << " | ";
-  for (uint64_t& specific_stat_vec_itr : rolling_window) {
+  for (const uint64_t specific_stat_vec_itr : rolling_window) {
     out_str << specific_stat_vec_itr << " | ";
   }
   out_str << std::endl;
@@ -74,7 +95,7 @@ void HystrixSink::pushNewValue(RollingWindow& rolling_window, uint64_t value) {
   }
 }
 
-uint64_t HystrixSink::getRollingValue(RollingWindow rolling_window) {
+uint64_t HystrixSink::getRollingValue(const RollingWindow& rolling_window) {
 
   if (rolling_window.empty()) {
     return 0;
@@ -122,8 +143,6 @@ void HystrixSink::updateRollingWindowMap(const Upstream::ClusterInfo& cluster_in
   // leading to wrong results such as error percentage higher than 100%
   uint64_t total = errors + timeouts + success + rejected;
   pushNewValue(cluster_stats_cache.total_, total);
-
-  ENVOY_LOG(trace, "{}", printRollingWindows());
 }
 
 void HystrixSink::resetRollingWindow() { cluster_stats_cache_map_.clear(); }
@@ -290,7 +309,7 @@ HystrixSink::HystrixSink(Server::Configuration::ServerFactoryContext& server,
                    MAKE_ADMIN_HANDLER(handlerHystrixEventStream), false, false);
 }
 
-Http::Code HystrixSink::handlerHystrixEventStream(absl::string_view,
+Http::Code HystrixSink::handlerHystrixEventStream(absl::string_view path_and_query,
                                                   Http::ResponseHeaderMap& response_headers,
                                                   Buffer::Instance&,
                                                   Server::AdminStream& admin_stream) {
@@ -312,7 +331,19 @@ Http::Code HystrixSink::handlerHystrixEventStream(absl::string_view,
     admin_stream.http1StreamEncoderOptions().value().get().disableChunkEncoding();
   }
 
-  registerConnection(&stream_decoder_filter_callbacks);
+  // The cluster query parameter restricts the stream to a comma separated list of clusters.
+  absl::flat_hash_set<std::string> clusters;
+  const Http::Utility::QueryParams params =
+      Http::Utility::parseAndDecodeQueryString(path_and_query);
+  const auto cluster_param = params.find("cluster");
+  if (cluster_param != params.end()) {
+    for (const absl::string_view cluster : absl::StrSplit(cluster_param->second, ',')) {
+      if (!cluster.empty()) {
+        clusters.emplace(cluster);
+      }
+    }
+  }
+  registerConnection(&stream_decoder_filter_callbacks, std::move(clusters));
 
   admin_stream.setEndStreamOnComplete(false); // set streaming
 
@@ -338,11 +369,22 @@ Http::Code HystrixSink::handlerHystrixEventStream(absl::string_view,
 }
 
 void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
-  if (callbacks_list_.empty()) {
+  if (connections_.empty()) {
     return;
   }
   incCounter();
-  std::stringstream ss;
+
+  // Only the clusters streamed to a connection are serialized.
+  bool stream_all_clusters = false;
+  absl::flat_hash_set<absl::string_view> streamed_clusters;
+  for (const Connection& connection : connections_) {
+    if (connection.clusters_.empty()) {
+      stream_all_clusters = true;
+    } else {
+      streamed_clusters.insert(connection.clusters_.begin(), connection.clusters_.end());
+    }
+  }
+
   Upstream::ClusterManager::ClusterInfoMaps all_clusters = server_.clusterManager().clusters();
 
   // Save a map of the relevant histograms per cluster in a convenient format.
@@ -374,6 +416,10 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
     }
   }
 
+  // The events of each cluster are serialized once per flush, and shared by all the connections
+  // streaming them.
+  std::string all_cluster_events;
+  absl::flat_hash_map<std::string, std::shared_ptr<const std::string>> cluster_events;
   for (auto& cluster : all_clusters.active_clusters_) {
     Upstream::ClusterInfoConstSharedPtr cluster_info = cluster.second.get().info();
 
@@ -386,7 +432,12 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
     // update rolling window with cluster stats
     updateRollingWindowMap(*cluster_info, *cluster_stats_cache_ptr);
 
+    const bool streamed = streamed_clusters.contains(cluster_info->name());
+    if (!stream_all_clusters && !streamed) {
+      continue;
+    }
     // append it to stream to be sent
+    std::stringstream ss;
     addClusterStatsToStream(
         *cluster_stats_cache_ptr, cluster_info->name(),
         cluster_info->resourceManager(Upstream::ResourcePriority::Default).pendingRequests().max(),
@@ -394,20 +445,40 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
             .gaugeFromStatName(membership_total_, Stats::Gauge::ImportMode::NeverImport)
             .value(),
         server_.statsConfig().flushInterval(), time_histograms[cluster_info->name()], ss);
+    std::string events = ss.str();
+    if (stream_all_clusters) {
+      all_cluster_events.append(events);
+    }
+    if (streamed) {
+      cluster_events.emplace(cluster_info->name(),
+                             std::make_shared<const std::string>(std::move(events)));
+    }
   }
+  ENVOY_LOG(trace, "{}", printRollingWindows());
 
-  Buffer::OwnedImpl data;
-  for (auto callbacks : callbacks_list_) {
-    data.add(ss.str());
-    callbacks->encodeData(data, false);
+  const auto shared_all_cluster_events =
+      std::make_shared<const std::string>(std::move(all_cluster_events));
+  for (const Connection& connection : connections_) {
+    Buffer::OwnedImpl data;
+    if (connection.clusters_.empty()) {
+      addSharedData(data, shared_all_cluster_events);
+    } else {
+      for (const std::string& cluster_name : connection.clusters_) {
+        const auto events = cluster_events.find(cluster_name);
+        if (events != cluster_events.end()) {
+          addSharedData(data, events->second);
+        }
+      }
+    }
+    connection.callbacks_->encodeData(data, false);
   }
 
   // send keep alive ping
   // TODO (@trabetti) : is it ok to send together with data?
   Buffer::OwnedImpl ping_data;
-  for (auto callbacks : callbacks_list_) {
+  for (const Connection& connection : connections_) {
     ping_data.add(":\n\n");
-    callbacks->encodeData(ping_data, false);
+    connection.callbacks_->encodeData(ping_data, false);
   }
 
   // check if any clusters were removed, and remove from cache
@@ -424,21 +495,22 @@ void HystrixSink::flush(Stats::MetricSnapshot& snapshot) {
   }
 }
 
-void HystrixSink::registerConnection(Http::StreamDecoderFilterCallbacks* callbacks_to_register) {
-  callbacks_list_.emplace_back(callbacks_to_register);
+void HystrixSink::registerConnection(Http::StreamDecoderFilterCallbacks* callbacks_to_register,
+                                     absl::flat_hash_set<std::string> clusters) {
+  connections_.push_back({callbacks_to_register, std::move(clusters)});
 }
 
 void HystrixSink::unregisterConnection(Http::StreamDecoderFilterCallbacks* callbacks_to_remove) {
-  for (auto it = callbacks_list_.begin(); it != callbacks_list_.end(); ++it) {
-    if ((*it)->streamId() == callbacks_to_remove->streamId()) {
-      callbacks_list_.erase(it);
+  for (auto it = connections_.begin(); it != connections_.end(); ++it) {
+    if (it->callbacks_->streamId() == callbacks_to_remove->streamId()) {
+      connections_.erase(it);
       break;
     }
   }
   // If there are no callbacks, clear the map to avoid stale values or having to keep updating the
   // map. When a new callback is assigned, the rollingWindow is initialized with current statistics
   // and within RollingWindow time, the results showed in the dashboard will be reliable
-  if (callbacks_list_.empty()) {
+  if (connections_.empty()) {
     resetRollingWindow();
   }
 }
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "envoy/server/admin.h"
@@ -11,13 +11,15 @@
 
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace StatSinks {
 namespace Hystrix {
 
+// The values of a stat at the last flushes, in a ring indexed by the current index of the sink.
 using RollingWindow = std::vector<uint64_t>;
-using RollingStatsMap = std::map<const std::string, RollingWindow>;
 
 using QuantileLatencyMap = absl::node_hash_map<double, double>;
 static const std::vector<double> hystrix_quantiles = {0,    0.25, 0.5,   0.75, 0.90,
@@ -31,7 +33,7 @@ struct ClusterStatsCache {
   ClusterStatsCache(const std::string& cluster_name);
 
   void printToStream(std::stringstream& out_str);
-  void printRollingWindow(absl::string_view name, RollingWindow rolling_window,
+  void printRollingWindow(absl::string_view name, const RollingWindow& rolling_window,
                           std::stringstream& out_str);
   std::string cluster_name_;
 
@@ -55,8 +57,12 @@ public:
 
   /**
    * Register a new connection.
+   * @param callbacks_to_register supplies the callbacks of the stream of the connection.
+   * @param clusters supplies the names of the clusters streamed to the connection, or empty to
+   *        stream all of them.
    */
-  void registerConnection(Http::StreamDecoderFilterCallbacks* callbacks_to_register);
+  void registerConnection(Http::StreamDecoderFilterCallbacks* callbacks_to_register,
+                          absl::flat_hash_set<std::string> clusters = {});
 
   /**
    * Remove registered connection.
@@ -100,7 +106,7 @@ public:
   /**
    * Get the statistic's value change over the rolling window time frame.
    */
-  uint64_t getRollingValue(RollingWindow rolling_window);
+  uint64_t getRollingValue(const RollingWindow& rolling_window);
 
   /**
    * Format the given key and value to "key"=value, and adding to the stringstream.
@@ -148,7 +154,13 @@ private:
                             uint64_t reporting_hosts, std::chrono::milliseconds rolling_window_ms,
                             std::stringstream& ss);
 
-  std::vector<Http::StreamDecoderFilterCallbacks*> callbacks_list_;
+  struct Connection {
+    Http::StreamDecoderFilterCallbacks* callbacks_;
+    // The names of the clusters streamed to the connection, or empty for all of them.
+    absl::flat_hash_set<std::string> clusters_;
+  };
+
+  std::vector<Connection> connections_;
   Server::Configuration::ServerFactoryContext& server_;
   uint64_t current_index_;
   const uint64_t window_size_;
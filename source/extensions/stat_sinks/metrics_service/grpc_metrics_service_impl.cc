@@ -32,8 +32,8 @@ GrpcMetricsStreamerImpl::GrpcMetricsStreamerImpl(
 
 void GrpcMetricsStreamerImpl::send(MetricsPtr&& metrics) {
   envoy::service::metrics::v3::StreamMetricsMessage message;
-  message.mutable_envoy_metrics()->Reserve(metrics->size());
-  message.mutable_envoy_metrics()->MergeFrom(*metrics);
+  // The metric families are moved into the message rather than copied.
+  message.mutable_envoy_metrics()->Swap(metrics.get());
 
   if (stream_ == nullptr) {
     stream_ = client_->start(service_method_, *this, Http::AsyncClient::StreamOptions());
@@ -53,8 +53,9 @@ MetricsPtr MetricsFlusher::flush(Stats::MetricSnapshot& snapshot) const {
   // TODO(mrice32): there's probably some more sophisticated preallocation we can do here where we
   // actually preallocate the submessages and then pass ownership to the proto (rather than just
   // preallocating the pointer array).
+  // Each histogram is reported as both a summary and a histogram family.
   metrics->Reserve(snapshot.counters().size() + snapshot.gauges().size() +
-                   snapshot.histograms().size());
+                   2 * snapshot.histograms().size());
   int64_t snapshot_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                                  snapshot.snapshotTime().time_since_epoch())
                                  .count();
@@ -112,13 +113,16 @@ void MetricsFlusher::flushHistogram(io::prometheus::client::MetricFamily& summar
   // information. We should make this configurable if it turns out that sending both affects
   // performance.
 
+  const std::string name = envoy_histogram.name();
+
   // Add summary information for histograms.
   summary_metrics_family.set_type(io::prometheus::client::MetricType::SUMMARY);
-  summary_metrics_family.set_name(envoy_histogram.name());
+  summary_metrics_family.set_name(name);
   auto* summary_metric = summary_metrics_family.add_metric();
   summary_metric->set_timestamp_ms(snapshot_time_ms);
   auto* summary = summary_metric->mutable_summary();
   const Stats::HistogramStatistics& hist_stats = envoy_histogram.intervalStatistics();
+  summary->mutable_quantile()->Reserve(hist_stats.supportedQuantiles().size());
   for (size_t i = 0; i < hist_stats.supportedQuantiles().size(); i++) {
     auto* quantile = summary->add_quantile();
     quantile->set_quantile(hist_stats.supportedQuantiles()[i]);
@@ -127,12 +131,13 @@ void MetricsFlusher::flushHistogram(io::prometheus::client::MetricFamily& summar
 
   // Add bucket information for histograms.
   histogram_metrics_family.set_type(io::prometheus::client::MetricType::HISTOGRAM);
-  histogram_metrics_family.set_name(envoy_histogram.name());
+  histogram_metrics_family.set_name(name);
   auto* histogram_metric = histogram_metrics_family.add_metric();
   histogram_metric->set_timestamp_ms(snapshot_time_ms);
   auto* histogram = histogram_metric->mutable_histogram();
   histogram->set_sample_count(hist_stats.sampleCount());
   histogram->set_sample_sum(hist_stats.sampleSum());
+  histogram->mutable_bucket()->Reserve(hist_stats.supportedBuckets().size());
   for (size_t i = 0; i < hist_stats.supportedBuckets().size(); i++) {
     auto* bucket = histogram->add_bucket();
     bucket->set_upper_bound(hist_stats.supportedBuckets()[i]);
@@ -0,0 +1,90 @@
+#include "extensions/tracers/common/span_export_pipeline.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Common {
+
+SpanExportPipelineBase::SpanExportPipelineBase(const SpanExportOptions& options,
+                                               Stats::Scope& scope,
+                                               const std::string& stat_prefix,
+                                               Event::Dispatcher& main_dispatcher,
+                                               Thread::ThreadFactory& thread_factory,
+                                               BatchExporter& exporter)
+    : options_(options), stats_{ALL_SPAN_EXPORT_STATS(POOL_COUNTER_PREFIX(scope, stat_prefix))},
+      main_dispatcher_(main_dispatcher), thread_factory_(thread_factory), exporter_(exporter) {}
+
+SpanExportPipelineBase::~SpanExportPipelineBase() { ASSERT(thread_ == nullptr); }
+
+void SpanExportPipelineBase::start() {
+  thread_ = thread_factory_.createThread([this]() -> void { threadRoutine(); },
+                                         Thread::Options{"span_export"});
+}
+
+void SpanExportPipelineBase::stop() {
+  if (thread_ == nullptr) {
+    return;
+  }
+  {
+    Thread::LockGuard guard(lock_);
+    shutdown_ = true;
+    condvar_.notifyOne();
+  }
+  thread_->join();
+  thread_.reset();
+  // The spans still in the rings are dropped, as the main thread may be shutting down.
+  alive_.reset();
+}
+
+void SpanExportPipelineBase::threadRoutine() {
+  while (true) {
+    {
+      Thread::LockGuard guard(lock_);
+      if (!shutdown_) {
+        condvar_.waitFor(lock_, options_.flush_interval_);
+      }
+      if (shutdown_) {
+        return;
+      }
+    }
+    flush();
+  }
+}
+
+void SpanExportPipelineBase::flush() {
+  while (true) {
+    if (pending_batches_.load() >= options_.max_pending_batches_) {
+      ENVOY_LOG(debug, "span export: {} batches are pending, keeping the spans in the rings",
+                pending_batches_.load());
+      return;
+    }
+
+    std::string payload;
+    const uint64_t num_spans = serializeBatch(options_.max_batch_spans_, payload);
+    if (num_spans == 0) {
+      return;
+    }
+
+    pending_batches_++;
+    std::weak_ptr<bool> alive = alive_;
+    main_dispatcher_.post([this, alive, payload = std::move(payload), num_spans]() mutable {
+      if (alive.expired()) {
+        return;
+      }
+      stats_.spans_exported_.add(num_spans);
+      stats_.batches_exported_.inc();
+      exporter_.exportBatch(std::move(payload), num_spans, [this, alive]() -> void {
+        if (!alive.expired()) {
+          pending_batches_--;
+        }
+      });
+    });
+  }
+}
+
+} // namespace Common
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,284 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Common {
+
+/**
+ * All the stats of a span export pipeline. @see stats_macros.h
+ */
+#define ALL_SPAN_EXPORT_STATS(COUNTER)                                                             \
+  COUNTER(batches_exported)                                                                        \
+  COUNTER(spans_dropped)                                                                           \
+  COUNTER(spans_exported)
+
+/**
+ * Struct definition for the stats of a span export pipeline. @see stats_macros.h
+ */
+struct SpanExportStats {
+  ALL_SPAN_EXPORT_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+/**
+ * A bounded queue of spans with a single producer, the worker that finishes the spans, and a
+ * single consumer, the export thread. Neither side takes a lock.
+ */
+template <class T> class SpanRing : NonCopyable {
+public:
+  /**
+   * @param capacity supplies the minimum number of spans the ring holds. It is rounded up to a
+   *        power of 2.
+   */
+  explicit SpanRing(uint32_t capacity)
+      : slots_(roundUpCapacity(capacity)), mask_(slots_.size() - 1) {}
+
+  /**
+   * Adds a span to the ring. Called by the producer only.
+   * @return whether the span was added, or false if the ring was full.
+   */
+  bool push(T&& span) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == slots_.size()) {
+      return false;
+    }
+    slots_[tail & mask_].emplace(std::move(span));
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Removes the oldest span of the ring. Called by the consumer only.
+   * @return the span, or absl::nullopt if the ring was empty.
+   */
+  absl::optional<T> pop() {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return absl::nullopt;
+    }
+    absl::optional<T> span = std::move(slots_[head & mask_]);
+    slots_[head & mask_].reset();
+    head_.store(head + 1, std::memory_order_release);
+    return span;
+  }
+
+  /**
+   * @return the number of spans in the ring.
+   */
+  uint64_t size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @return the number of spans the ring can hold.
+   */
+  uint64_t capacity() const { return slots_.size(); }
+
+private:
+  static uint64_t roundUpCapacity(uint32_t capacity) {
+    uint64_t rounded = 1;
+    while (rounded < capacity) {
+      rounded <<= 1;
+    }
+    return rounded;
+  }
+
+  std::vector<absl::optional<T>> slots_;
+  const uint64_t mask_;
+  // The producer and the consumer each write their own index, on separate cache lines.
+  alignas(64) std::atomic<uint64_t> head_{0};
+  alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+/**
+ * Sends the batches of serialized spans to a collector. Only used on the main thread.
+ */
+class BatchExporter {
+public:
+  virtual ~BatchExporter() = default;
+
+  /**
+   * Exports a batch.
+   * @param payload supplies the serialized spans.
+   * @param num_spans supplies the number of spans in the batch.
+   * @param done supplies the callback to call on the main thread once the batch was sent or
+   *        failed. It may be called before exportBatch() returns.
+   */
+  virtual void exportBatch(std::string&& payload, uint64_t num_spans,
+                           std::function<void()> done) PURE;
+};
+
+/**
+ * The options of a span export pipeline.
+ */
+struct SpanExportOptions {
+  // The number of spans each worker can hold until the next flush. The spans finished while the
+  // ring of the worker is full are dropped.
+  uint32_t ring_capacity_{4096};
+  // The maximum number of spans in a batch.
+  uint32_t max_batch_spans_{1024};
+  // The interval between the flushes of the export thread.
+  std::chrono::milliseconds flush_interval_{1000};
+  // The maximum number of batches waiting for the collector. The spans stay in the rings while
+  // this many batches are pending, so that a slow collector makes the workers drop the spans
+  // rather than queue them.
+  uint32_t max_pending_batches_{4};
+};
+
+/**
+ * The part of a span export pipeline that doesn't depend on the span type. It runs the export
+ * thread, which wakes up every flush interval to serialize the spans of the rings in batches, and
+ * posts the batches to the exporter on the main thread.
+ */
+class SpanExportPipelineBase : protected Logger::Loggable<Logger::Id::tracing> {
+public:
+  virtual ~SpanExportPipelineBase();
+
+  /**
+   * Exports the spans the rings hold, as the export thread does every flush interval.
+   */
+  void flushForTest() { flush(); }
+
+  const SpanExportStats& stats() const { return stats_; }
+
+protected:
+  SpanExportPipelineBase(const SpanExportOptions& options, Stats::Scope& scope,
+                         const std::string& stat_prefix, Event::Dispatcher& main_dispatcher,
+                         Thread::ThreadFactory& thread_factory, BatchExporter& exporter);
+
+  /**
+   * Starts the export thread. Called at the end of the constructor of the derived class.
+   */
+  void start();
+
+  /**
+   * Stops and joins the export thread. Called first in the destructor of the derived class, as
+   * the thread uses it.
+   */
+  void stop();
+
+  /**
+   * Removes up to max_spans spans from the rings and serializes them. Called on the export thread.
+   * @param max_spans supplies the maximum number of spans to serialize.
+   * @param payload set to the serialized spans.
+   * @return the number of spans serialized.
+   */
+  virtual uint64_t serializeBatch(uint64_t max_spans, std::string& payload) PURE;
+
+  const SpanExportOptions options_;
+  SpanExportStats stats_;
+
+private:
+  void threadRoutine();
+  void flush();
+
+  Event::Dispatcher& main_dispatcher_;
+  Thread::ThreadFactory& thread_factory_;
+  BatchExporter& exporter_;
+  Thread::MutexBasicLockable lock_;
+  Thread::CondVar condvar_;
+  bool shutdown_ ABSL_GUARDED_BY(lock_){};
+  // The batches posted to the main thread whose export isn't done yet.
+  std::atomic<uint32_t> pending_batches_{0};
+  // Expires with the pipeline, so that the callbacks posted to the main thread don't outlive it.
+  std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+  Thread::ThreadPtr thread_;
+};
+
+/**
+ * A span export pipeline for the spans of type T. Each worker reports its finished spans to its
+ * own ring, so that the workers only push the spans, and the export thread serializes them.
+ */
+template <class T> class SpanExportPipeline : public SpanExportPipelineBase {
+public:
+  // Serializes a batch of spans. Called on the export thread.
+  using Serializer = std::function<std::string(const std::vector<T>& spans)>;
+  using Ring = SpanRing<T>;
+  using RingSharedPtr = std::shared_ptr<Ring>;
+
+  SpanExportPipeline(const SpanExportOptions& options, Stats::Scope& scope,
+                     const std::string& stat_prefix, Event::Dispatcher& main_dispatcher,
+                     Thread::ThreadFactory& thread_factory, BatchExporter& exporter,
+                     Serializer serializer)
+      : SpanExportPipelineBase(options, scope, stat_prefix, main_dispatcher, thread_factory,
+                               exporter),
+        serializer_(std::move(serializer)) {
+    start();
+  }
+
+  ~SpanExportPipeline() override { stop(); }
+
+  /**
+   * Creates the ring of a worker. May be called on any thread.
+   * @return the ring the worker reports its spans to.
+   */
+  RingSharedPtr createRing() {
+    auto ring = std::make_shared<Ring>(options_.ring_capacity_);
+    Thread::LockGuard guard(rings_lock_);
+    rings_.push_back(ring);
+    return ring;
+  }
+
+  /**
+   * Reports a finished span. Called by the worker that owns the ring.
+   * @param ring supplies the ring of the worker.
+   * @param span supplies the span.
+   */
+  void reportSpan(Ring& ring, T&& span) {
+    if (!ring.push(std::move(span))) {
+      stats_.spans_dropped_.inc();
+    }
+  }
+
+protected:
+  uint64_t serializeBatch(uint64_t max_spans, std::string& payload) override {
+    std::vector<T> spans;
+    {
+      Thread::LockGuard guard(rings_lock_);
+      for (const RingSharedPtr& ring : rings_) {
+        while (spans.size() < max_spans) {
+          absl::optional<T> span = ring->pop();
+          if (!span.has_value()) {
+            break;
+          }
+          spans.push_back(std::move(span.value()));
+        }
+      }
+    }
+    if (spans.empty()) {
+      return 0;
+    }
+    payload = serializer_(spans);
+    return spans.size();
+  }
+
+private:
+  const Serializer serializer_;
+  // Only taken to create a ring, and by the export thread, never when a span is reported.
+  Thread::MutexBasicLockable rings_lock_;
+  std::vector<RingSharedPtr> rings_ ABSL_GUARDED_BY(rings_lock_);
+};
+
+} // namespace Common
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -24,7 +24,8 @@ Tracing::HttpTracerSharedPtr ZipkinTracerFactory::createHttpTracerTyped(
       context.serverFactoryContext().scope(), context.serverFactoryContext().threadLocal(),
       context.serverFactoryContext().runtime(), context.serverFactoryContext().localInfo(),
       context.serverFactoryContext().api().randomGenerator(),
-      context.serverFactoryContext().timeSource());
+      context.serverFactoryContext().timeSource(), context.serverFactoryContext().dispatcher(),
+      context.serverFactoryContext().api().threadFactory());
 
   return std::make_shared<Tracing::HttpTracerImpl>(std::move(zipkin_driver),
                                                    context.serverFactoryContext().localInfo());
@@ -29,13 +29,7 @@ SpanBuffer::SpanBuffer(
 }
 
 bool SpanBuffer::addSpan(Span&& span) {
-  const auto& annotations = span.annotations();
-  if (span_buffer_.size() == span_buffer_.capacity() || annotations.empty() ||
-      annotations.end() ==
-          std::find_if(annotations.begin(), annotations.end(), [](const auto& annotation) {
-            return annotation.value() == CLIENT_SEND || annotation.value() == SERVER_RECV;
-          })) {
-
+  if (span_buffer_.size() == span_buffer_.capacity() || !isValidSpan(span)) {
     // Buffer full or invalid span.
     return false;
   }
@@ -45,6 +39,13 @@ bool SpanBuffer::addSpan(Span&& span) {
   return true;
 }
 
+bool SpanBuffer::isValidSpan(const Span& span) {
+  const auto& annotations = span.annotations();
+  return std::find_if(annotations.begin(), annotations.end(), [](const auto& annotation) {
+           return annotation.value() == CLIENT_SEND || annotation.value() == SERVER_RECV;
+         }) != annotations.end();
+}
+
 SerializerPtr SpanBuffer::makeSerializer(
     const envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion& version,
     const bool shared_span_context) {
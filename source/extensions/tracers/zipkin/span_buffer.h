@@ -81,11 +81,21 @@ public:
    */
   std::string serialize() const { return serializer_->serialize(span_buffer_); }
 
-private:
-  SerializerPtr
+  /**
+   * @return whether the span can be sent to Zipkin, i.e. it has a CLIENT_SEND or SERVER_RECV
+   * annotation.
+   */
+  static bool isValidSpan(const Span& span);
+
+  /**
+   * @return the serializer of the spans for the given collector version.
+   */
+  static SerializerPtr
   makeSerializer(const envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion& version,
                  bool shared_span_context);
 
+private:
+
   // We use a pre-allocated vector to improve performance
   std::vector<Span> span_buffer_;
   SerializerPtr serializer_;
@@ -10,6 +10,7 @@
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
 #include "common/http/utility.h"
+#include "common/runtime/runtime_features.h"
 #include "common/tracing/http_tracer_impl.h"
 
 #include "extensions/tracers/zipkin/span_context_extractor.h"
@@ -19,6 +20,30 @@ namespace Envoy {
 namespace Extensions {
 namespace Tracers {
 namespace Zipkin {
+namespace {
+
+Http::RequestMessagePtr makeCollectorRequest(const CollectorInfo& collector,
+                                             const std::string& hostname,
+                                             const std::string& body) {
+  Http::RequestMessagePtr message = std::make_unique<Http::RequestMessageImpl>();
+  message->headers().setReferenceMethod(Http::Headers::get().MethodValues.Post);
+  message->headers().setPath(collector.endpoint_);
+  message->headers().setHost(hostname);
+  message->headers().setReferenceContentType(
+      collector.version_ == envoy::config::trace::v3::ZipkinConfig::HTTP_PROTO
+          ? Http::Headers::get().ContentTypeValues.Protobuf
+          : Http::Headers::get().ContentTypeValues.Json);
+
+  message->body().add(body);
+  return message;
+}
+
+std::chrono::milliseconds collectorRequestTimeout(Runtime::Loader& runtime) {
+  return std::chrono::milliseconds(
+      runtime.snapshot().getInteger("tracing.zipkin.request_timeout", 5000U));
+}
+
+} // namespace
 
 ZipkinSpan::ZipkinSpan(Zipkin::Span& span, Zipkin::Tracer& tracer) : span_(span), tracer_(tracer) {}
 
@@ -73,7 +98,8 @@ Driver::Driver(const envoy::config::trace::v3::ZipkinConfig& zipkin_config,
                Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
                ThreadLocal::SlotAllocator& tls, Runtime::Loader& runtime,
                const LocalInfo::LocalInfo& local_info, Random::RandomGenerator& random_generator,
-               TimeSource& time_source)
+               TimeSource& time_source, Event::Dispatcher& main_dispatcher,
+               Thread::ThreadFactory& thread_factory)
     : cm_(cluster_manager), tracer_stats_{ZIPKIN_TRACER_STATS(
                                 POOL_COUNTER_PREFIX(scope, "tracing.zipkin."))},
       tls_(tls.allocateSlot()), runtime_(runtime), local_info_(local_info),
@@ -96,17 +122,35 @@ Driver::Driver(const envoy::config::trace::v3::ZipkinConfig& zipkin_config,
       zipkin_config, shared_span_context, DEFAULT_SHARED_SPAN_CONTEXT);
   collector.shared_span_context_ = shared_span_context;
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.zipkin_background_span_export")) {
+    Common::SpanExportOptions options;
+    options.flush_interval_ = std::chrono::milliseconds(
+        runtime_.snapshot().getInteger("tracing.zipkin.flush_interval_ms", 5000U));
+    std::shared_ptr<Serializer> serializer =
+        SpanBuffer::makeSerializer(collector.version_, collector.shared_span_context_);
+    exporter_ = std::make_unique<CollectorExporter>(*this, collector);
+    export_pipeline_ = std::make_unique<SpanExportPipeline>(
+        options, scope, "tracing.zipkin.export.", main_dispatcher, thread_factory, *exporter_,
+        [serializer](const std::vector<Span>& spans) { return serializer->serialize(spans); });
+  }
+
   tls_->set([this, collector, &random_generator, trace_id_128bit, shared_span_context](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     TracerPtr tracer =
         std::make_unique<Tracer>(local_info_.clusterName(), local_info_.address(), random_generator,
                                  trace_id_128bit, shared_span_context, time_source_);
-    tracer->setReporter(
-        ReporterImpl::NewInstance(std::ref(*this), std::ref(dispatcher), collector));
+    if (export_pipeline_ != nullptr) {
+      tracer->setReporter(std::make_unique<PipelineReporterImpl>(*export_pipeline_));
+    } else {
+      tracer->setReporter(
+          ReporterImpl::NewInstance(std::ref(*this), std::ref(dispatcher), collector));
+    }
     return std::make_shared<TlsTracer>(std::move(tracer), *this);
   });
 }
 
+Driver::~Driver() = default;
+
 Tracing::SpanPtr Driver::startSpan(const Tracing::Config& config,
                                    Http::RequestHeaderMap& request_headers, const std::string&,
                                    SystemTime start_time,
@@ -180,25 +224,15 @@ void ReporterImpl::flushSpans() {
   if (span_buffer_->pendingSpans()) {
     driver_.tracerStats().spans_sent_.add(span_buffer_->pendingSpans());
     const std::string request_body = span_buffer_->serialize();
-    Http::RequestMessagePtr message = std::make_unique<Http::RequestMessageImpl>();
-    message->headers().setReferenceMethod(Http::Headers::get().MethodValues.Post);
-    message->headers().setPath(collector_.endpoint_);
-    message->headers().setHost(driver_.hostname());
-    message->headers().setReferenceContentType(
-        collector_.version_ == envoy::config::trace::v3::ZipkinConfig::HTTP_PROTO
-            ? Http::Headers::get().ContentTypeValues.Protobuf
-            : Http::Headers::get().ContentTypeValues.Json);
-
-    message->body().add(request_body);
-
-    const uint64_t timeout =
-        driver_.runtime().snapshot().getInteger("tracing.zipkin.request_timeout", 5000U);
+    Http::RequestMessagePtr message =
+        makeCollectorRequest(collector_, driver_.hostname(), request_body);
 
     if (collector_cluster_.threadLocalCluster().has_value()) {
       Http::AsyncClient::Request* request =
           collector_cluster_.threadLocalCluster()->get().httpAsyncClient().send(
               std::move(message), *this,
-              Http::AsyncClient::RequestOptions().setTimeout(std::chrono::milliseconds(timeout)));
+              Http::AsyncClient::RequestOptions().setTimeout(
+                  collectorRequestTimeout(driver_.runtime())));
       if (request) {
         active_requests_.add(*request);
       }
@@ -228,6 +262,73 @@ void ReporterImpl::onSuccess(const Http::AsyncClient::Request& request,
   }
 }
 
+PipelineReporterImpl::PipelineReporterImpl(SpanExportPipeline& pipeline)
+    : pipeline_(pipeline), ring_(pipeline.createRing()) {}
+
+void PipelineReporterImpl::reportSpan(Span&& span) {
+  if (SpanBuffer::isValidSpan(span)) {
+    pipeline_.reportSpan(*ring_, std::move(span));
+  }
+}
+
+CollectorExporter::CollectorExporter(Driver& driver, const CollectorInfo& collector)
+    : driver_(driver), collector_(collector),
+      collector_cluster_(driver_.clusterManager(), driver_.cluster()) {}
+
+CollectorExporter::~CollectorExporter() {
+  for (const PendingExportPtr& pending_export : pending_exports_) {
+    if (pending_export->request_ != nullptr) {
+      pending_export->request_->cancel();
+    }
+  }
+}
+
+void CollectorExporter::exportBatch(std::string&& payload, uint64_t num_spans,
+                                    std::function<void()> done) {
+  driver_.tracerStats().spans_sent_.add(num_spans);
+  if (!collector_cluster_.threadLocalCluster().has_value()) {
+    ENVOY_LOG(debug, "collector cluster '{}' does not exist", driver_.cluster());
+    driver_.tracerStats().reports_skipped_no_cluster_.inc();
+    done();
+    return;
+  }
+
+  auto pending_export = std::make_unique<PendingExport>(*this, std::move(done));
+  PendingExport& pending_export_ref = *pending_export;
+  LinkedList::moveIntoList(std::move(pending_export), pending_exports_);
+  // An inline failure completes the pending export before send() returns.
+  Http::AsyncClient::Request* request =
+      collector_cluster_.threadLocalCluster()->get().httpAsyncClient().send(
+          makeCollectorRequest(collector_, driver_.hostname(), payload), pending_export_ref,
+          Http::AsyncClient::RequestOptions().setTimeout(
+              collectorRequestTimeout(driver_.runtime())));
+  if (request != nullptr) {
+    pending_export_ref.request_ = request;
+  }
+}
+
+void CollectorExporter::PendingExport::onSuccess(const Http::AsyncClient::Request&,
+                                                 Http::ResponseMessagePtr&& http_response) {
+  if (Http::Utility::getResponseStatus(http_response->headers()) !=
+      enumToInt(Http::Code::Accepted)) {
+    parent_.driver_.tracerStats().reports_dropped_.inc();
+  } else {
+    parent_.driver_.tracerStats().reports_sent_.inc();
+  }
+  complete();
+}
+
+void CollectorExporter::PendingExport::onFailure(const Http::AsyncClient::Request&,
+                                                 Http::AsyncClient::FailureReason) {
+  parent_.driver_.tracerStats().reports_failed_.inc();
+  complete();
+}
+
+void CollectorExporter::PendingExport::complete() {
+  done_();
+  PendingExportPtr self = removeFromList(parent_.pending_exports_);
+}
+
 } // namespace Zipkin
 } // namespace Tracers
 } // namespace Extensions
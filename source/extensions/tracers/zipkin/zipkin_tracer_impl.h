@@ -1,19 +1,25 @@
 #pragma once
 
+#include <list>
+
 #include "envoy/common/random_generator.h"
 #include "envoy/config/trace/v3/zipkin.pb.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/local_info/local_info.h"
 #include "envoy/runtime/runtime.h"
+#include "envoy/thread/thread.h"
 #include "envoy/thread_local/thread_local.h"
 #include "envoy/tracing/http_tracer.h"
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/empty_string.h"
+#include "common/common/linked_object.h"
 #include "common/http/async_client_utility.h"
 #include "common/http/header_map_impl.h"
 #include "common/json/json_loader.h"
 #include "common/upstream/cluster_update_tracker.h"
 
+#include "extensions/tracers/common/span_export_pipeline.h"
 #include "extensions/tracers/zipkin/span_buffer.h"
 #include "extensions/tracers/zipkin/tracer.h"
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
@@ -96,6 +102,10 @@ private:
 
 using ZipkinSpanPtr = std::unique_ptr<ZipkinSpan>;
 
+using SpanExportPipeline = Common::SpanExportPipeline<Span>;
+
+class CollectorExporter;
+
 /**
  * Class for a Zipkin-specific Driver.
  */
@@ -104,12 +114,16 @@ public:
   /**
    * Constructor. It adds itself and a newly-created Zipkin::Tracer object to a thread-local store.
    * Also, it associates the given random-number generator to the Zipkin::Tracer object it creates.
+   * When the envoy.reloadable_features.zipkin_background_span_export runtime feature is enabled,
+   * the spans are serialized on an export thread and sent from the main dispatcher.
    */
   Driver(const envoy::config::trace::v3::ZipkinConfig& zipkin_config,
          Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
          ThreadLocal::SlotAllocator& tls, Runtime::Loader& runtime,
          const LocalInfo::LocalInfo& localinfo, Random::RandomGenerator& random_generator,
-         TimeSource& time_source);
+         TimeSource& time_source, Event::Dispatcher& main_dispatcher,
+         Thread::ThreadFactory& thread_factory);
+  ~Driver() override;
 
   /**
    * This function is inherited from the abstract Driver class.
@@ -131,6 +145,8 @@ public:
   const std::string& hostname() { return hostname_; }
   Runtime::Loader& runtime() { return runtime_; }
   ZipkinTracerStats& tracerStats() { return tracer_stats_; }
+  // The span export pipeline, or nullptr if the spans are sent by each worker.
+  SpanExportPipeline* exportPipeline() { return export_pipeline_.get(); }
 
 private:
   /**
@@ -151,6 +167,9 @@ private:
   Runtime::Loader& runtime_;
   const LocalInfo::LocalInfo& local_info_;
   TimeSource& time_source_;
+  std::unique_ptr<CollectorExporter> exporter_;
+  // Declared after the exporter, as the export thread uses it.
+  std::unique_ptr<SpanExportPipeline> export_pipeline_;
 };
 
 /**
@@ -247,6 +266,62 @@ private:
   // Track active HTTP requests to be able to cancel them on destruction.
   Http::AsyncClientRequestTracker active_requests_;
 };
+
+/**
+ * A Zipkin::Reporter that reports the spans of a worker to the span export pipeline, which
+ * serializes them on its export thread.
+ */
+class PipelineReporterImpl : public Reporter {
+public:
+  explicit PipelineReporterImpl(SpanExportPipeline& pipeline);
+
+  // Zipkin::Reporter
+  void reportSpan(Span&& span) override;
+
+private:
+  SpanExportPipeline& pipeline_;
+  const SpanExportPipeline::RingSharedPtr ring_;
+};
+
+/**
+ * Sends the batches of the span export pipeline to Zipkin using the Http::AsyncClient of the main
+ * thread. The requests use the same runtime timeout as the ones of the workers.
+ */
+class CollectorExporter : public Common::BatchExporter, Logger::Loggable<Logger::Id::tracing> {
+public:
+  CollectorExporter(Driver& driver, const CollectorInfo& collector);
+  ~CollectorExporter() override;
+
+  // Common::BatchExporter
+  void exportBatch(std::string&& payload, uint64_t num_spans,
+                   std::function<void()> done) override;
+
+private:
+  struct PendingExport : public Http::AsyncClient::Callbacks,
+                         public LinkedObject<PendingExport> {
+    PendingExport(CollectorExporter& parent, std::function<void()> done)
+        : parent_(parent), done_(std::move(done)) {}
+
+    // Http::AsyncClient::Callbacks
+    void onSuccess(const Http::AsyncClient::Request&, Http::ResponseMessagePtr&&) override;
+    void onFailure(const Http::AsyncClient::Request&, Http::AsyncClient::FailureReason) override;
+    void onBeforeFinalizeUpstreamSpan(Tracing::Span&, const Http::ResponseHeaderMap*) override {}
+
+    // Calls the done callback and deletes this.
+    void complete();
+
+    CollectorExporter& parent_;
+    std::function<void()> done_;
+    Http::AsyncClient::Request* request_{};
+  };
+  using PendingExportPtr = std::unique_ptr<PendingExport>;
+
+  Driver& driver_;
+  const CollectorInfo collector_;
+  Upstream::ClusterUpdateTracker collector_cluster_;
+  std::list<PendingExportPtr> pending_exports_;
+};
+
 } // namespace Zipkin
 } // namespace Tracers
 } // namespace Extensions
@@ -18,18 +18,21 @@ namespace Tap {
 
 class SocketTapConfigFactoryImpl : public Extensions::Common::Tap::TapConfigFactory {
 public:
-  SocketTapConfigFactoryImpl(TimeSource& time_source) : time_source_(time_source) {}
+  SocketTapConfigFactoryImpl(TimeSource& time_source, Api::Api& api, Stats::Scope& scope)
+      : time_source_(time_source), api_(api), scope_(scope) {}
 
   // TapConfigFactory
   Extensions::Common::Tap::TapConfigSharedPtr
   createConfigFromProto(const envoy::config::tap::v3::TapConfig& proto_config,
                         Extensions::Common::Tap::Sink* admin_streamer) override {
     return std::make_shared<SocketTapConfigImpl>(std::move(proto_config), admin_streamer,
-                                                 time_source_);
+                                                 time_source_, api_, scope_);
   }
 
 private:
   TimeSource& time_source_;
+  Api::Api& api_;
+  Stats::Scope& scope_;
 };
 
 Network::TransportSocketFactoryPtr UpstreamTapSocketConfigFactory::createTransportSocketFactory(
@@ -45,7 +48,9 @@ Network::TransportSocketFactoryPtr UpstreamTapSocketConfigFactory::createTranspo
   auto inner_transport_factory =
       inner_config_factory.createTransportSocketFactory(*inner_factory_config, context);
   return std::make_unique<TapSocketFactory>(
-      outer_config, std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource()),
+      outer_config,
+      std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource(), context.api(),
+                                                   context.scope()),
       context.admin(), context.singletonManager(), context.threadLocal(), context.dispatcher(),
       std::move(inner_transport_factory));
 }
@@ -64,7 +69,9 @@ Network::TransportSocketFactoryPtr DownstreamTapSocketConfigFactory::createTrans
   auto inner_transport_factory = inner_config_factory.createTransportSocketFactory(
       *inner_factory_config, context, server_names);
   return std::make_unique<TapSocketFactory>(
-      outer_config, std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource()),
+      outer_config,
+      std::make_unique<SocketTapConfigFactoryImpl>(context.dispatcher().timeSource(), context.api(),
+                                                   context.scope()),
       context.admin(), context.singletonManager(), context.threadLocal(), context.dispatcher(),
       std::move(inner_transport_factory));
 }
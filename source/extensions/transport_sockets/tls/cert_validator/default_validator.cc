@@ -1,5 +1,6 @@
 #include "extensions/transport_sockets/tls/cert_validator/default_validator.h"
 
+#include <algorithm>
 #include <array>
 #include <deque>
 #include <functional>
@@ -42,8 +43,9 @@ namespace Tls {
 
 DefaultCertValidator::DefaultCertValidator(
     const Envoy::Ssl::CertificateValidationContextConfig* config, SslStats& stats,
-    TimeSource& time_source)
-    : config_(config), stats_(stats), time_source_(time_source) {
+    TimeSource& time_source, TlsMaterialCache* material_cache)
+    : config_(config), stats_(stats), time_source_(time_source), material_cache_(material_cache),
+      verification_cache_size_(config != nullptr ? config->verificationCacheSize() : 0) {
   if (config_ != nullptr) {
     allow_untrusted_certificate_ = config_->trustChainVerification() ==
                                    envoy::extensions::transport_sockets::tls::v3::
@@ -68,7 +70,24 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
     }
   }
 
-  if (config_ != nullptr && !config_->caCert().empty() && !provides_certificates) {
+  if (config_ != nullptr && !config_->caCert().empty() && !provides_certificates &&
+      material_cache_ != nullptr && !contexts.empty()) {
+    ca_file_path_ = config_->caCertPath();
+    // The trust store is shared with the contexts that trust the same CAs and revocation lists.
+    trust_store_ = material_cache_->trustStore(
+        config_->caCert(), config_->caCertPath(), config_->certificateRevocationList(),
+        config_->certificateRevocationListPath(),
+        config_->allowExpiredCertificate() ? CertValidatorUtil::ignoreCertificateExpirationCallback
+                                           : nullptr);
+    X509_up_ref(trust_store_->ca_cert_.get());
+    ca_cert_.reset(trust_store_->ca_cert_.get());
+    for (auto& ctx : contexts) {
+      X509_STORE_up_ref(trust_store_->store_.get());
+      SSL_CTX_set_cert_store(ctx, trust_store_->store_.get());
+    }
+    verify_mode = SSL_VERIFY_PEER;
+    verify_trusted_ca_ = true;
+  } else if (config_ != nullptr && !config_->caCert().empty() && !provides_certificates) {
     ca_file_path_ = config_->caCertPath();
     bssl::UniquePtr<BIO> bio(
         BIO_new_mem_buf(const_cast<char*>(config_->caCert().data()), config_->caCert().size()));
@@ -117,7 +136,8 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
     }
   }
 
-  if (config_ != nullptr && !config_->certificateRevocationList().empty()) {
+  if (config_ != nullptr && !config_->certificateRevocationList().empty() &&
+      trust_store_ == nullptr) {
     bssl::UniquePtr<BIO> bio(
         BIO_new_mem_buf(const_cast<char*>(config_->certificateRevocationList().data()),
                         config_->certificateRevocationList().size()));
@@ -192,6 +212,26 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
 int DefaultCertValidator::doVerifyCertChain(
     X509_STORE_CTX* store_ctx, Ssl::SslExtendedSocketInfo* ssl_extended_info, X509& leaf_cert,
     const Network::TransportSocketOptions* transport_socket_options) {
+  const std::vector<std::string>& verify_san_list =
+      transport_socket_options &&
+              !transport_socket_options->verifySubjectAltNameListOverride().empty()
+          ? transport_socket_options->verifySubjectAltNameListOverride()
+          : verify_subject_alt_name_list_;
+
+  std::string cache_key;
+  if (verification_cache_size_ > 0) {
+    cache_key = verificationCacheKey(store_ctx, leaf_cert, verify_san_list);
+    const absl::optional<Envoy::Ssl::ClientValidationStatus> cached = lookupVerification(cache_key);
+    if (cached.has_value()) {
+      stats_.cert_verification_cache_hit_.inc();
+      if (ssl_extended_info && cached.value() != Envoy::Ssl::ClientValidationStatus::NotValidated) {
+        ssl_extended_info->setCertificateValidationStatus(cached.value());
+      }
+      return 1;
+    }
+    stats_.cert_verification_cache_miss_.inc();
+  }
+
   if (verify_trusted_ca_) {
     int ret = X509_verify_cert(store_ctx);
     if (ssl_extended_info) {
@@ -206,13 +246,8 @@ int DefaultCertValidator::doVerifyCertChain(
     }
   }
 
-  Envoy::Ssl::ClientValidationStatus validated = verifyCertificate(
-      &leaf_cert,
-      transport_socket_options &&
-              !transport_socket_options->verifySubjectAltNameListOverride().empty()
-          ? transport_socket_options->verifySubjectAltNameListOverride()
-          : verify_subject_alt_name_list_,
-      subject_alt_name_matchers_);
+  Envoy::Ssl::ClientValidationStatus validated =
+      verifyCertificate(&leaf_cert, verify_san_list, subject_alt_name_matchers_);
 
   if (ssl_extended_info) {
     if (ssl_extended_info->certificateValidationStatus() ==
@@ -223,10 +258,99 @@ int DefaultCertValidator::doVerifyCertChain(
     }
   }
 
+  if (!cache_key.empty() && validated != Envoy::Ssl::ClientValidationStatus::Failed) {
+    cacheVerification(std::move(cache_key),
+                      verify_trusted_ca_ &&
+                              validated == Envoy::Ssl::ClientValidationStatus::NotValidated
+                          ? Envoy::Ssl::ClientValidationStatus::Validated
+                          : validated,
+                      store_ctx, leaf_cert);
+  }
+
   return allow_untrusted_certificate_ ? 1
                                       : (validated != Envoy::Ssl::ClientValidationStatus::Failed);
 }
 
+std::string
+DefaultCertValidator::verificationCacheKey(X509_STORE_CTX* store_ctx, X509& leaf_cert,
+                                           const std::vector<std::string>& verify_san_list) {
+  bssl::ScopedEVP_MD_CTX md;
+  RELEASE_ASSERT(EVP_DigestInit(md.get(), EVP_sha256()) == 1,
+                 Utility::getLastCryptoError().value_or(""));
+
+  const auto update_with_cert = [&md](X509* cert) {
+    uint8_t cert_hash[EVP_MAX_MD_SIZE];
+    unsigned cert_hash_length;
+    RELEASE_ASSERT(X509_digest(cert, EVP_sha256(), cert_hash, &cert_hash_length) == 1,
+                   Utility::getLastCryptoError().value_or(""));
+    EVP_DigestUpdate(md.get(), cert_hash, cert_hash_length);
+  };
+  update_with_cert(&leaf_cert);
+  STACK_OF(X509)* untrusted = X509_STORE_CTX_get0_untrusted(store_ctx);
+  for (size_t i = 0; untrusted != nullptr && i < sk_X509_num(untrusted); ++i) {
+    update_with_cert(sk_X509_value(untrusted, i));
+  }
+  // The subject alt names to verify can be overridden per connection, so they're part of the key.
+  for (const std::string& san : verify_san_list) {
+    EVP_DigestUpdate(md.get(), san.data(), san.size() + 1);
+  }
+
+  uint8_t hash[EVP_MAX_MD_SIZE];
+  unsigned hash_length;
+  RELEASE_ASSERT(EVP_DigestFinal(md.get(), hash, &hash_length) == 1,
+                 Utility::getLastCryptoError().value_or(""));
+  return std::string(reinterpret_cast<const char*>(hash), hash_length);
+}
+
+absl::optional<Envoy::Ssl::ClientValidationStatus>
+DefaultCertValidator::lookupVerification(const std::string& key) {
+  absl::MutexLock lock(&verification_cache_mutex_);
+  auto it = verification_cache_.find(key);
+  if (it == verification_cache_.end()) {
+    return absl::nullopt;
+  }
+  if (it->second.expiration_time_ <= time_source_.systemTime()) {
+    verification_cache_lru_.erase(it->second.lru_position_);
+    verification_cache_.erase(it);
+    return absl::nullopt;
+  }
+  verification_cache_lru_.splice(verification_cache_lru_.begin(), verification_cache_lru_,
+                                 it->second.lru_position_);
+  return it->second.validated_;
+}
+
+void DefaultCertValidator::cacheVerification(std::string&& key,
+                                             Envoy::Ssl::ClientValidationStatus validated,
+                                             X509_STORE_CTX* store_ctx, X509& leaf_cert) {
+  SystemTime expiration_time = Utility::getExpirationTime(leaf_cert);
+  if (verify_trusted_ca_) {
+    STACK_OF(X509)* chain = X509_STORE_CTX_get0_chain(store_ctx);
+    for (size_t i = 0; chain != nullptr && i < sk_X509_num(chain); ++i) {
+      expiration_time =
+          std::min(expiration_time, Utility::getExpirationTime(*sk_X509_value(chain, i)));
+    }
+  }
+  // Expired certificates are only accepted with allow_expired_certificate, and are verified every
+  // time.
+  if (expiration_time <= time_source_.systemTime()) {
+    return;
+  }
+
+  absl::MutexLock lock(&verification_cache_mutex_);
+  if (verification_cache_.contains(key)) {
+    // Another worker verified the same chain concurrently.
+    return;
+  }
+  if (verification_cache_.size() >= verification_cache_size_) {
+    verification_cache_.erase(verification_cache_lru_.back());
+    verification_cache_lru_.pop_back();
+  }
+  verification_cache_lru_.push_front(key);
+  verification_cache_.emplace(std::move(key),
+                              CachedVerification{validated, expiration_time,
+                                                 verification_cache_lru_.begin()});
+}
+
 Envoy::Ssl::ClientValidationStatus DefaultCertValidator::verifyCertificate(
     X509* cert, const std::vector<std::string>& verify_san_list,
     const std::vector<Matchers::StringMatcherImpl>& subject_alt_name_matchers) {
@@ -468,8 +592,9 @@ size_t DefaultCertValidator::daysUntilFirstCertExpires() const {
 class DefaultCertValidatorFactory : public CertValidatorFactory {
 public:
   CertValidatorPtr createCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config,
-                                       SslStats& stats, TimeSource& time_source) override {
-    return std::make_unique<DefaultCertValidator>(config, stats, time_source);
+                                       SslStats& stats, TimeSource& time_source,
+                                       TlsMaterialCache& material_cache) override {
+    return std::make_unique<DefaultCertValidator>(config, stats, time_source, &material_cache);
   }
 
   absl::string_view name() override { return CertValidatorNames::get().Default; }
@@ -3,6 +3,7 @@
 #include <array>
 #include <deque>
 #include <functional>
+#include <list>
 #include <string>
 #include <vector>
 
@@ -19,8 +20,11 @@
 
 #include "extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "extensions/transport_sockets/tls/stats.h"
+#include "extensions/transport_sockets/tls/tls_material_cache.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
 #include "openssl/ssl.h"
 #include "openssl/x509v3.h"
 
@@ -31,8 +35,13 @@ namespace Tls {
 
 class DefaultCertValidator : public CertValidator {
 public:
+  /**
+   * @param material_cache supplies the cache of the trust stores shared with the other contexts,
+   *        or nullptr to build the trust stores of this validator only.
+   */
   DefaultCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config,
-                       SslStats& stats, TimeSource& time_source);
+                       SslStats& stats, TimeSource& time_source,
+                       TlsMaterialCache* material_cache = nullptr);
 
   ~DefaultCertValidator() override = default;
 
@@ -107,18 +116,45 @@ public:
                       const std::vector<Matchers::StringMatcherImpl>& subject_alt_name_matchers);
 
 private:
+  // A successful verification of a peer certificate chain.
+  struct CachedVerification {
+    // The validation status that the verification sets on the connection.
+    Envoy::Ssl::ClientValidationStatus validated_;
+    // When the first certificate of the verified chain expires.
+    SystemTime expiration_time_;
+    // Position of the entry's key in verification_cache_lru_.
+    std::list<std::string>::iterator lru_position_;
+  };
+
+  std::string verificationCacheKey(X509_STORE_CTX* store_ctx, X509& leaf_cert,
+                                   const std::vector<std::string>& verify_san_list);
+  absl::optional<Envoy::Ssl::ClientValidationStatus> lookupVerification(const std::string& key);
+  void cacheVerification(std::string&& key, Envoy::Ssl::ClientValidationStatus validated,
+                         X509_STORE_CTX* store_ctx, X509& leaf_cert);
+
   const Envoy::Ssl::CertificateValidationContextConfig* config_;
   SslStats& stats_;
   TimeSource& time_source_;
+  TlsMaterialCache* const material_cache_;
+  const uint32_t verification_cache_size_;
 
   bool allow_untrusted_certificate_{false};
   bssl::UniquePtr<X509> ca_cert_;
+  // The trust store of the contexts, if it's shared through the material cache.
+  TlsMaterialCache::TrustStoreConstSharedPtr trust_store_;
   std::string ca_file_path_;
   std::vector<Matchers::StringMatcherImpl> subject_alt_name_matchers_;
   std::vector<std::vector<uint8_t>> verify_certificate_hash_list_;
   std::vector<std::vector<uint8_t>> verify_certificate_spki_list_;
   std::vector<std::string> verify_subject_alt_name_list_;
   bool verify_trusted_ca_{false};
+
+  // Contexts are shared by the workers, so the cache is too. The most recently used key is at the
+  // front of verification_cache_lru_.
+  absl::Mutex verification_cache_mutex_;
+  absl::flat_hash_map<std::string, CachedVerification>
+      verification_cache_ ABSL_GUARDED_BY(verification_cache_mutex_);
+  std::list<std::string> verification_cache_lru_ ABSL_GUARDED_BY(verification_cache_mutex_);
 };
 
 DECLARE_FACTORY(DefaultCertValidatorFactory);
@@ -7,6 +7,7 @@
 
 #include "extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "extensions/transport_sockets/tls/stats.h"
+#include "extensions/transport_sockets/tls/tls_material_cache.h"
 
 #include "absl/strings/string_view.h"
 
@@ -21,9 +22,13 @@ class CertValidatorFactory {
 public:
   virtual ~CertValidatorFactory() = default;
 
+  /**
+   * @param material_cache supplies the cache through which the validator may share the trusted
+   *        CAs it parses with the validators of the other contexts.
+   */
   virtual CertValidatorPtr
   createCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config, SslStats& stats,
-                      TimeSource& time_source) PURE;
+                      TimeSource& time_source, TlsMaterialCache& material_cache) PURE;
 
   virtual absl::string_view name() PURE;
 
@@ -281,7 +281,8 @@ Envoy::Ssl::CertificateDetailsPtr SPIFFEValidator::getCaCertInformation() const
 class SPIFFEValidatorFactory : public CertValidatorFactory {
 public:
   CertValidatorPtr createCertValidator(const Envoy::Ssl::CertificateValidationContextConfig* config,
-                                       SslStats& stats, TimeSource& time_source) override {
+                                       SslStats& stats, TimeSource& time_source,
+                                       TlsMaterialCache&) override {
     return std::make_unique<SPIFFEValidator>(config, stats, time_source);
   }
 
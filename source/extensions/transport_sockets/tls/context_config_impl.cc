@@ -1,5 +1,6 @@
 #include "extensions/transport_sockets/tls/context_config_impl.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -8,10 +9,13 @@
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/config/datasource.h"
+#include "common/config/utility.h"
 #include "common/protobuf/utility.h"
 #include "common/secret/sds_api.h"
 #include "common/ssl/certificate_validation_context_config_impl.h"
 
+#include "extensions/transport_sockets/tls/handshake_offload_pool.h"
+#include "extensions/transport_sockets/tls/ocsp/ocsp_fetcher.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 
 #include "openssl/ssl.h"
@@ -161,6 +165,39 @@ bool getStatelessSessionResumptionDisabled(
   }
 }
 
+Ssl::SessionCacheSharedPtr
+getSessionCache(const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext& config,
+                Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  if (!config.has_session_cache()) {
+    return nullptr;
+  }
+  auto& factory =
+      Config::Utility::getAndCheckFactory<Ssl::SessionCacheFactory>(config.session_cache());
+  ProtobufTypes::MessagePtr message = Config::Utility::translateAnyToFactoryConfig(
+      config.session_cache().typed_config(), factory_context.messageValidationVisitor(), factory);
+  return factory.createSessionCache(*message, factory_context);
+}
+
+Ssl::RecordSizing
+getRecordSizing(const envoy::extensions::transport_sockets::tls::v3::CommonTlsContext& config) {
+  Ssl::RecordSizing record_sizing;
+  if (config.has_dynamic_record_sizing()) {
+    const auto& sizing = config.dynamic_record_sizing();
+    record_sizing.initial_record_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+        sizing, initial_record_size, record_sizing.initial_record_size_);
+    record_sizing.boost_threshold_ =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(sizing, boost_threshold, record_sizing.boost_threshold_);
+    record_sizing.idle_timeout_ =
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(sizing, idle_timeout, 0));
+  }
+  return record_sizing;
+}
+
+bool sameSessionTicketKeyName(const Ssl::ServerContextConfig::SessionTicketKey& a,
+                              const Ssl::ServerContextConfig::SessionTicketKey& b) {
+  return a.name_ == b.name_;
+}
+
 } // namespace
 
 ContextConfigImpl::ContextConfigImpl(
@@ -180,7 +217,8 @@ ContextConfigImpl::ContextConfigImpl(
       min_protocol_version_(tlsVersionFromProto(config.tls_params().tls_minimum_protocol_version(),
                                                 default_min_protocol_version)),
       max_protocol_version_(tlsVersionFromProto(config.tls_params().tls_maximum_protocol_version(),
-                                                default_max_protocol_version)) {
+                                                default_max_protocol_version)),
+      record_sizing_(getRecordSizing(config)) {
   if (certificate_validation_context_provider_ != nullptr) {
     if (default_cvc_) {
       // We need to validate combined certificate validation context.
@@ -378,6 +416,44 @@ const std::string ServerContextConfigImpl::DEFAULT_CURVES =
 #endif
     "P-256";
 
+SessionTicketKeyRingImpl::SessionTicketKeyRingImpl(TimeSource& time_source,
+                                                   std::chrono::milliseconds grace_period)
+    : time_source_(time_source), grace_period_(grace_period),
+      keys_(std::make_shared<const Keys>()) {}
+
+std::shared_ptr<const SessionTicketKeyRingImpl::Keys> SessionTicketKeyRingImpl::keys() const {
+  absl::MutexLock lock(&mutex_);
+  return keys_;
+}
+
+void SessionTicketKeyRingImpl::update(
+    const std::vector<Ssl::ServerContextConfig::SessionTicketKey>& keys) {
+  auto new_keys = std::make_shared<Keys>();
+  new_keys->keys_ = keys;
+  const auto is_current = [&keys](const Ssl::ServerContextConfig::SessionTicketKey& key) {
+    return std::any_of(keys.begin(), keys.end(),
+                       [&key](const Ssl::ServerContextConfig::SessionTicketKey& current) {
+                         return sameSessionTicketKeyName(key, current);
+                       });
+  };
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  absl::MutexLock lock(&mutex_);
+  if (grace_period_.count() > 0) {
+    for (const auto& retired_key : keys_->retired_keys_) {
+      if (retired_key.second > now && !is_current(retired_key.first)) {
+        new_keys->retired_keys_.push_back(retired_key);
+      }
+    }
+    for (const auto& key : keys_->keys_) {
+      if (!is_current(key)) {
+        new_keys->retired_keys_.emplace_back(key, now + grace_period_);
+      }
+    }
+  }
+  keys_ = std::move(new_keys);
+}
+
 ServerContextConfigImpl::ServerContextConfigImpl(
     const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext& config,
     Server::Configuration::TransportSocketFactoryContext& factory_context)
@@ -387,9 +463,28 @@ ServerContextConfigImpl::ServerContextConfigImpl(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, require_client_certificate, false)),
       ocsp_staple_policy_(ocspStaplePolicyFromProto(config.ocsp_staple_policy())),
       session_ticket_keys_provider_(getTlsSessionTicketKeysConfigProvider(factory_context, config)),
-      disable_stateless_session_resumption_(getStatelessSessionResumptionDisabled(config)) {
+      session_ticket_keys_grace_period_(std::chrono::milliseconds(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, session_ticket_keys_grace_period, 0))),
+      disable_stateless_session_resumption_(getStatelessSessionResumptionDisabled(config)),
+      session_cache_(getSessionCache(config, factory_context)),
+      handshake_offload_pool_(config.has_handshake_offload()
+                                  ? std::make_shared<HandshakeOffloadPoolImpl>(
+                                        config.handshake_offload(), factory_context)
+                                  : nullptr),
+      enable_kernel_tls_tx_(config.enable_kernel_tls_tx()),
+      ocsp_fetcher_(
+          config.has_ocsp_fetch()
+              ? std::make_shared<Ocsp::OcspFetcherImpl>(config.ocsp_fetch(), factory_context)
+              : nullptr) {
+  if (handshake_offload_pool_ != nullptr && session_cache_ != nullptr) {
+    // Session cache lookups complete on the worker threads, while the handshake may still be
+    // running on a handshake thread.
+    throw EnvoyException("handshake_offload can't be used with session_cache");
+  }
 
   if (session_ticket_keys_provider_ != nullptr) {
+    session_ticket_key_ring_ = std::make_shared<SessionTicketKeyRingImpl>(
+        api_.timeSource(), session_ticket_keys_grace_period_);
     // Validate tls session ticket keys early to reject bad sds updates.
     stk_validation_callback_handle_ = session_ticket_keys_provider_->addValidationCallback(
         [this](const envoy::extensions::transport_sockets::tls::v3::TlsSessionTicketKeys& keys) {
@@ -398,6 +493,7 @@ ServerContextConfigImpl::ServerContextConfigImpl(
     // Load inlined, static or dynamic secret that's already available.
     if (session_ticket_keys_provider_->secret() != nullptr) {
       session_ticket_keys_ = getSessionTicketKeys(*session_ticket_keys_provider_->secret());
+      session_ticket_key_ring_->update(session_ticket_keys_);
     }
   }
 
@@ -424,7 +520,19 @@ void ServerContextConfigImpl::setSecretUpdateCallback(std::function<void()> call
     // ContextConfigImpl::session_ticket_keys_ with new session ticket keys.
     stk_update_callback_handle_ =
         session_ticket_keys_provider_->addUpdateCallback([this, callback]() {
+          const bool had_keys = !session_ticket_keys_.empty();
           session_ticket_keys_ = getSessionTicketKeys(*session_ticket_keys_provider_->secret());
+          if (had_keys && !session_ticket_keys_.empty()) {
+            // The contexts encrypting session tickets with the key ring pick up the new keys in
+            // place.
+            session_ticket_key_ring_->update(session_ticket_keys_);
+            return;
+          }
+          // Whether the contexts encrypt session tickets with the keys changes, so they are
+          // recreated with a new key ring, and the existing contexts keep the keys they have.
+          session_ticket_key_ring_ = std::make_shared<SessionTicketKeyRingImpl>(
+              api_.timeSource(), session_ticket_keys_grace_period_);
+          session_ticket_key_ring_->update(session_ticket_keys_);
           callback();
         });
   }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "envoy/common/time.h"
 #include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
 #include "envoy/secret/secret_callbacks.h"
 #include "envoy/secret/secret_provider.h"
@@ -13,6 +16,8 @@
 #include "common/json/json_loader.h"
 #include "common/ssl/tls_certificate_config_impl.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -56,6 +61,7 @@ public:
   Ssl::HandshakerFactoryCb createHandshaker() const override;
   Ssl::HandshakerCapabilities capabilities() const override { return capabilities_; }
   Ssl::SslCtxCb sslctxCb() const override { return sslctx_cb_; }
+  Ssl::RecordSizing recordSizing() const override { return record_sizing_; }
 
   Ssl::CertificateValidationContextConfigPtr getCombinedValidationContextConfig(
       const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext&
@@ -95,6 +101,7 @@ private:
   Envoy::Common::CallbackHandlePtr cvc_validation_callback_handle_;
   const unsigned min_protocol_version_;
   const unsigned max_protocol_version_;
+  const Ssl::RecordSizing record_sizing_;
 
   Ssl::HandshakerFactoryCb handshaker_factory_cb_;
   Ssl::HandshakerCapabilities capabilities_;
@@ -131,6 +138,26 @@ private:
   const std::string sigalgs_;
 };
 
+class SessionTicketKeyRingImpl : public Envoy::Ssl::ServerContextConfig::SessionTicketKeyRing {
+public:
+  SessionTicketKeyRingImpl(TimeSource& time_source, std::chrono::milliseconds grace_period);
+
+  // Ssl::ServerContextConfig::SessionTicketKeyRing
+  std::shared_ptr<const Keys> keys() const override;
+
+  /**
+   * Replaces the keys. The keys that are removed keep being accepted for decrypting session
+   * tickets for the grace period.
+   */
+  void update(const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey>& keys);
+
+private:
+  TimeSource& time_source_;
+  const std::chrono::milliseconds grace_period_;
+  mutable absl::Mutex mutex_;
+  std::shared_ptr<const Keys> keys_ ABSL_GUARDED_BY(mutex_);
+};
+
 class ServerContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ServerContextConfig {
 public:
   ServerContextConfigImpl(
@@ -143,6 +170,9 @@ public:
   const std::vector<SessionTicketKey>& sessionTicketKeys() const override {
     return session_ticket_keys_;
   }
+  SessionTicketKeyRingSharedPtr sessionTicketKeyRing() const override {
+    return session_ticket_key_ring_;
+  }
   absl::optional<std::chrono::seconds> sessionTimeout() const override { return session_timeout_; }
 
   bool isReady() const override {
@@ -156,6 +186,12 @@ public:
   bool disableStatelessSessionResumption() const override {
     return disable_stateless_session_resumption_;
   }
+  Ssl::SessionCacheSharedPtr sessionCache() const override { return session_cache_; }
+  Ssl::HandshakeOffloadPoolSharedPtr handshakeOffloadPool() const override {
+    return handshake_offload_pool_;
+  }
+  bool enableKernelTlsTx() const override { return enable_kernel_tls_tx_; }
+  Ssl::OcspFetcherSharedPtr ocspFetcher() const override { return ocsp_fetcher_; }
 
 private:
   static const unsigned DEFAULT_MIN_VERSION;
@@ -167,6 +203,7 @@ private:
   const OcspStaplePolicy ocsp_staple_policy_;
   std::vector<SessionTicketKey> session_ticket_keys_;
   const Secret::TlsSessionTicketKeysConfigProviderSharedPtr session_ticket_keys_provider_;
+  std::shared_ptr<SessionTicketKeyRingImpl> session_ticket_key_ring_;
   Envoy::Common::CallbackHandlePtr stk_update_callback_handle_;
   Envoy::Common::CallbackHandlePtr stk_validation_callback_handle_;
 
@@ -178,7 +215,12 @@ private:
           policy);
 
   absl::optional<std::chrono::seconds> session_timeout_;
+  const std::chrono::milliseconds session_ticket_keys_grace_period_;
   const bool disable_stateless_session_resumption_;
+  const Ssl::SessionCacheSharedPtr session_cache_;
+  const Ssl::HandshakeOffloadPoolSharedPtr handshake_offload_pool_;
+  const bool enable_kernel_tls_tx_;
+  const Ssl::OcspFetcherSharedPtr ocsp_fetcher_;
 };
 
 } // namespace Tls
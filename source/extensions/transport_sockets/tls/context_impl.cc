@@ -54,6 +54,40 @@ bool cbsContainsU16(CBS& cbs, uint16_t n) {
   return false;
 }
 
+// Returns the issuer of the certificate of a context, which is the first certificate of its chain
+// if it issued the certificate, or nullptr.
+X509* issuer(const TlsContext& ctx) {
+  STACK_OF(X509)* chain = nullptr;
+  if (!SSL_CTX_get_extra_chain_certs(ctx.ssl_ctx_.get(), &chain) || chain == nullptr ||
+      sk_X509_num(chain) == 0) {
+    return nullptr;
+  }
+  X509* issuer = sk_X509_value(chain, 0);
+  return X509_check_issued(issuer, ctx.cert_chain_.get()) == X509_V_OK ? issuer : nullptr;
+}
+
+// The state of the external session cache lookup of a connection, stored in its SSL instance.
+struct SessionCacheLookupState {
+  SessionCacheLookupState(SessionCacheLookupCallbacks& callbacks, Event::Dispatcher& dispatcher)
+      : callbacks_(callbacks), dispatcher_(dispatcher) {}
+  ~SessionCacheLookupState() {
+    if (lookup_ != nullptr && !completed_) {
+      lookup_->cancel();
+    }
+  }
+
+  SessionCacheLookupCallbacks& callbacks_;
+  Event::Dispatcher& dispatcher_;
+  Ssl::SessionCacheLookupPtr lookup_;
+  bool started_{};
+  bool completed_{};
+  bssl::UniquePtr<SSL_SESSION> session_;
+};
+
+void freeSessionCacheLookupState(void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+  delete static_cast<SessionCacheLookupState*>(ptr);
+}
+
 } // namespace
 
 int ContextImpl::sslExtendedSocketInfoIndex() {
@@ -65,9 +99,9 @@ int ContextImpl::sslExtendedSocketInfoIndex() {
 }
 
 ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-                         TimeSource& time_source)
+                         TimeSource& time_source, TlsMaterialCache& material_cache)
     : scope_(scope), stats_(generateSslStats(scope)), time_source_(time_source),
-      tls_max_version_(config.maxProtocolVersion()),
+      tls_max_version_(config.maxProtocolVersion()), record_sizing_(config.recordSizing()),
       stat_name_set_(scope.symbolTable().makeSet("TransportSockets::Tls")),
       unknown_ssl_cipher_(stat_name_set_->add("unknown_ssl_cipher")),
       unknown_ssl_curve_(stat_name_set_->add("unknown_ssl_curve")),
@@ -88,7 +122,7 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
   }
 
   cert_validator_ = cert_validator_factory->createCertValidator(
-      config.certificateValidationContext(), stats_, time_source_);
+      config.certificateValidationContext(), stats_, time_source_, material_cache);
 
   const auto tls_certificates = config.tlsCertificates();
   tls_contexts_.resize(std::max(static_cast<size_t>(1), tls_certificates.size()));
@@ -168,11 +202,12 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       // Load certificate chain.
       const auto& tls_certificate = tls_certificates[i].get();
       ctx.cert_chain_file_path_ = tls_certificate.certificateChainPath();
-      bssl::UniquePtr<BIO> bio(
-          BIO_new_mem_buf(const_cast<char*>(tls_certificate.certificateChain().data()),
-                          tls_certificate.certificateChain().size()));
-      RELEASE_ASSERT(bio != nullptr, "");
-      ctx.cert_chain_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
+      // The parsed certificate chain is shared with the contexts that use the same one.
+      ctx.parsed_cert_chain_ = material_cache.certificateChain(tls_certificate.certificateChain());
+      if (ctx.parsed_cert_chain_ != nullptr) {
+        X509_up_ref(ctx.parsed_cert_chain_->leaf_.get());
+        ctx.cert_chain_.reset(ctx.parsed_cert_chain_->leaf_.get());
+      }
       if (ctx.cert_chain_ == nullptr ||
           !SSL_CTX_use_certificate(ctx.ssl_ctx_.get(), ctx.cert_chain_.get())) {
         while (uint64_t err = ERR_get_error()) {
@@ -183,12 +218,10 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
         throw EnvoyException(
             absl::StrCat("Failed to load certificate chain from ", ctx.cert_chain_file_path_));
       }
-      // Read rest of the certificate chain.
-      while (true) {
-        bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
-        if (cert == nullptr) {
-          break;
-        }
+      // Add the rest of the certificate chain.
+      for (const bssl::UniquePtr<X509>& intermediate : ctx.parsed_cert_chain_->intermediates_) {
+        X509_up_ref(intermediate.get());
+        bssl::UniquePtr<X509> cert(intermediate.get());
         if (!SSL_CTX_add_extra_chain_cert(ctx.ssl_ctx_.get(), cert.get())) {
           throw EnvoyException(
               absl::StrCat("Failed to load certificate chain from ", ctx.cert_chain_file_path_));
@@ -196,14 +229,6 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
         // SSL_CTX_add_extra_chain_cert() takes ownership.
         cert.release();
       }
-      // Check for EOF.
-      const uint32_t err = ERR_peek_last_error();
-      if (ERR_GET_LIB(err) == ERR_LIB_PEM && ERR_GET_REASON(err) == PEM_R_NO_START_LINE) {
-        ERR_clear_error();
-      } else {
-        throw EnvoyException(
-            absl::StrCat("Failed to load certificate chain from ", ctx.cert_chain_file_path_));
-      }
 
       // The must staple extension means the certificate promises to carry
       // with it an OCSP staple. https://tools.ietf.org/html/rfc7633#section-6
@@ -288,15 +313,10 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
 #endif
         SSL_CTX_set_private_key_method(ctx.ssl_ctx_.get(), private_key_method.get());
       } else {
-        // Load private key.
-        bio.reset(BIO_new_mem_buf(const_cast<char*>(tls_certificate.privateKey().data()),
-                                  tls_certificate.privateKey().size()));
-        RELEASE_ASSERT(bio != nullptr, "");
-        bssl::UniquePtr<EVP_PKEY> pkey(
-            PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr,
-                                    !tls_certificate.password().empty()
-                                        ? const_cast<char*>(tls_certificate.password().c_str())
-                                        : nullptr));
+        // Load private key, shared with the contexts that use the same one.
+        const TlsMaterialCache::PrivateKeySharedPtr pkey =
+            material_cache.privateKey(tls_certificate.privateKey(), tls_certificate.password());
+        ctx.private_key_ = pkey;
 
         if (pkey == nullptr || !SSL_CTX_use_PrivateKey(ctx.ssl_ctx_.get(), pkey.get())) {
           throw EnvoyException(fmt::format("Failed to load private key from {}, Cause: {}",
@@ -516,10 +536,19 @@ size_t ContextImpl::daysUntilFirstCertExpires() const {
 absl::optional<uint64_t> ContextImpl::secondsUntilFirstOcspResponseExpires() const {
   absl::optional<uint64_t> secs_until_expiration;
   for (auto& ctx : tls_contexts_) {
+    absl::optional<uint64_t> next_expiration;
     if (ctx.ocsp_response_) {
-      uint64_t next_expiration = ctx.ocsp_response_->secondsUntilExpiration();
+      next_expiration = ctx.ocsp_response_->secondsUntilExpiration();
+    } else if (auto fetched_response = ctx.fetchedOcspResponse(); fetched_response != nullptr) {
+      const auto validity = fetched_response->next_update_ - time_source_.systemTime();
+      next_expiration =
+          validity.count() > 0 ? std::chrono::duration_cast<std::chrono::seconds>(validity).count()
+                               : 0;
+    }
+    if (next_expiration.has_value()) {
       secs_until_expiration = std::min<uint64_t>(
-          next_expiration, secs_until_expiration.value_or(std::numeric_limits<uint64_t>::max()));
+          next_expiration.value(),
+          secs_until_expiration.value_or(std::numeric_limits<uint64_t>::max()));
     }
   }
 
@@ -554,8 +583,8 @@ std::vector<Envoy::Ssl::CertificateDetailsPtr> ContextImpl::getCertChainInformat
 
 ClientContextImpl::ClientContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ClientContextConfig& config,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source),
+                                     TimeSource& time_source, TlsMaterialCache& material_cache)
+    : ContextImpl(scope, config, time_source, material_cache),
       server_name_indication_(config.serverNameIndication()),
       allow_renegotiation_(config.allowRenegotiation()),
       max_session_keys_(config.maxSessionKeys()) {
@@ -704,8 +733,13 @@ uint16_t ClientContextImpl::parseSigningAlgorithmsForTest(const std::string& sig
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
-    : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()),
+                                     TimeSource& time_source, TlsMaterialCache& material_cache)
+    : ContextImpl(scope, config, time_source, material_cache),
+      session_ticket_key_ring_(config.sessionTicketKeyRing()),
+      session_cache_(config.capabilities().handles_session_resumption ? nullptr
+                                                                      : config.sessionCache()),
+      handshake_offload_pool_(config.handshakeOffloadPool()),
+      enable_kernel_tls_tx_(config.enableKernelTlsTx()),
       ocsp_staple_policy_(config.ocspStaplePolicy()) {
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
@@ -752,7 +786,9 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
     // `SSL_CTX_set_tlsext_ticket_key_cb`.
     if (config.disableStatelessSessionResumption()) {
       SSL_CTX_set_options(ctx.ssl_ctx_.get(), SSL_OP_NO_TICKET);
-    } else if (!session_ticket_keys_.empty() && !config.capabilities().handles_session_resumption) {
+    } else if (session_ticket_key_ring_ != nullptr &&
+               !session_ticket_key_ring_->keys()->keys_.empty() &&
+               !config.capabilities().handles_session_resumption) {
       SSL_CTX_set_tlsext_ticket_key_cb(
           ctx.ssl_ctx_.get(),
           [](SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx,
@@ -766,6 +802,28 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
           });
     }
 
+    if (session_cache_ != nullptr) {
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        ContextImpl* context_impl =
+            static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+        RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+        return server_context_impl->newSession(session);
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* session_id, int session_id_len,
+             int* out_copy) -> SSL_SESSION* {
+            ContextImpl* context_impl =
+                static_cast<ContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+            ServerContextImpl* server_context_impl = dynamic_cast<ServerContextImpl*>(context_impl);
+            RELEASE_ASSERT(server_context_impl != nullptr, ""); // for Coverity
+            // The returned session is owned by the caller.
+            *out_copy = 0;
+            return server_context_impl->lookupSession(ssl, session_id, session_id_len);
+          });
+    }
+
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
       auto timeout = config.sessionTimeout().value().count();
       SSL_CTX_set_timeout(ctx.ssl_ctx_.get(), uint32_t(timeout));
@@ -776,7 +834,12 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
     RELEASE_ASSERT(rc == 1, Utility::getLastCryptoError().value_or(""));
 
     auto& ocsp_resp_bytes = tls_certificates[i].get().ocspStaple();
-    if (ocsp_resp_bytes.empty()) {
+    if (ocsp_resp_bytes.empty() && config.ocspFetcher() != nullptr) {
+      // The response is fetched in the background, and handshakes that require one fail until it
+      // is fetched.
+      ctx.fetched_ocsp_response_ = config.ocspFetcher()->fetch(*ctx.cert_chain_, issuer(ctx));
+    }
+    if (ocsp_resp_bytes.empty() && ctx.fetched_ocsp_response_ == nullptr) {
       if (Runtime::runtimeFeatureEnabled(
               "envoy.reloadable_features.require_ocsp_response_for_must_staple_certs") &&
           ctx.is_must_staple_) {
@@ -785,7 +848,7 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
       if (ocsp_staple_policy_ == Ssl::ServerContextConfig::OcspStaplePolicy::MustStaple) {
         throw EnvoyException("Required OCSP response is missing from TLS context");
       }
-    } else {
+    } else if (!ocsp_resp_bytes.empty()) {
       auto response = std::make_unique<Ocsp::OcspResponseWrapper>(ocsp_resp_bytes, time_source_);
       if (!response->matchesCertificate(*ctx.cert_chain_)) {
         throw EnvoyException("OCSP response does not match its TLS certificate");
@@ -899,19 +962,107 @@ ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string
   return session_id;
 }
 
+int ServerContextImpl::sslSessionCacheLookupIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    // Frees the state of connections that are freed without being unregistered.
+    const int index =
+        SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, freeSessionCacheLookupState);
+    RELEASE_ASSERT(index >= 0, "");
+    return index;
+  }());
+}
+
+void ServerContextImpl::registerSessionCacheLookupCallbacks(SSL* ssl,
+                                                            SessionCacheLookupCallbacks& callbacks,
+                                                            Event::Dispatcher& dispatcher) {
+  if (session_cache_ == nullptr) {
+    return;
+  }
+  ASSERT(SSL_get_ex_data(ssl, sslSessionCacheLookupIndex()) == nullptr);
+  SSL_set_ex_data(ssl, sslSessionCacheLookupIndex(),
+                  new SessionCacheLookupState(callbacks, dispatcher));
+}
+
+void ServerContextImpl::unregisterSessionCacheLookupCallbacks(SSL* ssl) {
+  if (session_cache_ == nullptr) {
+    return;
+  }
+  delete static_cast<SessionCacheLookupState*>(SSL_get_ex_data(ssl, sslSessionCacheLookupIndex()));
+  SSL_set_ex_data(ssl, sslSessionCacheLookupIndex(), nullptr);
+}
+
+int ServerContextImpl::newSession(SSL_SESSION* session) {
+  unsigned session_id_len;
+  const uint8_t* session_id = SSL_SESSION_get_id(session, &session_id_len);
+  uint8_t* data;
+  size_t len;
+  if (session_id_len == 0 || !SSL_SESSION_to_bytes(session, &data, &len)) {
+    return 0;
+  }
+  std::string serialized_session(reinterpret_cast<const char*>(data), len);
+  OPENSSL_free(data);
+
+  session_cache_->insert(
+      absl::string_view(reinterpret_cast<const char*>(session_id), session_id_len),
+      std::move(serialized_session), std::chrono::seconds(SSL_SESSION_get_timeout(session)));
+  // The session isn't kept, so BoringSSL keeps ownership of it.
+  return 0;
+}
+
+SSL_SESSION* ServerContextImpl::lookupSession(SSL* ssl, const uint8_t* session_id,
+                                              int session_id_len) {
+  auto* state =
+      static_cast<SessionCacheLookupState*>(SSL_get_ex_data(ssl, sslSessionCacheLookupIndex()));
+  if (state == nullptr) {
+    // The connection has no callbacks to resume its handshake with.
+    return nullptr;
+  }
+  if (state->completed_) {
+    return state->session_.release();
+  }
+  if (state->started_) {
+    // The handshake was retried, e.g. because more data was read, while the lookup is pending.
+    return SSL_magic_pending_session_ptr();
+  }
+
+  state->started_ = true;
+  const SSL_CTX* ssl_ctx = SSL_get_SSL_CTX(ssl);
+  Ssl::SessionCacheLookupPtr lookup = session_cache_->lookup(
+      absl::string_view(reinterpret_cast<const char*>(session_id), session_id_len),
+      state->dispatcher_,
+      [state, ssl_ctx](absl::optional<std::string>&& session) {
+        state->completed_ = true;
+        if (session.has_value()) {
+          state->session_.reset(SSL_SESSION_from_bytes(
+              reinterpret_cast<const uint8_t*>(session->data()), session->size(), ssl_ctx));
+        }
+        if (state->lookup_ != nullptr) {
+          // The lookup completed asynchronously. Resuming the handshake may destroy the state.
+          state->callbacks_.onSessionCacheLookupComplete();
+        }
+      });
+  if (state->completed_) {
+    return state->session_.release();
+  }
+  ASSERT(lookup != nullptr);
+  state->lookup_ = std::move(lookup);
+  return SSL_magic_pending_session_ptr();
+}
+
 int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv,
                                             EVP_CIPHER_CTX* ctx, HMAC_CTX* hmac_ctx, int encrypt) {
   const EVP_MD* hmac = EVP_sha256();
   const EVP_CIPHER* cipher = EVP_aes_256_cbc();
 
+  const auto keys = session_ticket_key_ring_->keys();
   if (encrypt == 1) {
     // Encrypt
-    RELEASE_ASSERT(!session_ticket_keys_.empty(), "");
+    RELEASE_ASSERT(!keys->keys_.empty(), "");
     // TODO(ggreenway): validate in SDS that session_ticket_keys_ cannot be empty,
     // or if we allow it to be emptied, reconfigure the context so this callback
     // isn't set.
 
-    const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = session_ticket_keys_.front();
+    const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = keys->keys_.front();
 
     static_assert(std::tuple_size<decltype(key.name_)>::value == SSL_TICKET_KEY_NAME_LEN,
                   "Expected key.name length");
@@ -934,17 +1085,21 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
     return 1; // success
   } else {
     // Decrypt
+    const auto init_decrypt = [&](const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key) {
+      if (!HMAC_Init_ex(hmac_ctx, key.hmac_key_.data(), key.hmac_key_.size(), hmac, nullptr)) {
+        return false;
+      }
+
+      RELEASE_ASSERT(key.aes_key_.size() == EVP_CIPHER_key_length(cipher), "");
+      return EVP_DecryptInit_ex(ctx, cipher, nullptr, key.aes_key_.data(), iv) == 1;
+    };
+
     bool is_enc_key = true; // first element is the encryption key
-    for (const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key : session_ticket_keys_) {
+    for (const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key : keys->keys_) {
       static_assert(std::tuple_size<decltype(key.name_)>::value == SSL_TICKET_KEY_NAME_LEN,
                     "Expected key.name length");
       if (std::equal(key.name_.begin(), key.name_.end(), key_name)) {
-        if (!HMAC_Init_ex(hmac_ctx, key.hmac_key_.data(), key.hmac_key_.size(), hmac, nullptr)) {
-          return -1;
-        }
-
-        RELEASE_ASSERT(key.aes_key_.size() == EVP_CIPHER_key_length(cipher), "");
-        if (!EVP_DecryptInit_ex(ctx, cipher, nullptr, key.aes_key_.data(), iv)) {
+        if (!init_decrypt(key)) {
           return -1;
         }
 
@@ -955,6 +1110,16 @@ int ServerContextImpl::sessionTicketProcess(SSL*, uint8_t* key_name, uint8_t* iv
       is_enc_key = false;
     }
 
+    // Keys that have been rotated out are accepted until their grace period ends, and the tickets
+    // they decrypt are always renewed.
+    const MonotonicTime now = time_source_.monotonicTime();
+    for (const auto& retired_key : keys->retired_keys_) {
+      const Envoy::Ssl::ServerContextConfig::SessionTicketKey& key = retired_key.first;
+      if (retired_key.second > now && std::equal(key.name_.begin(), key.name_.end(), key_name)) {
+        return init_decrypt(key) ? 2 : -1;
+      }
+    }
+
     return 0; // decryption failed
   }
 }
@@ -1040,17 +1205,20 @@ bool ServerContextImpl::isClientOcspCapable(const SSL_CLIENT_HELLO* ssl_client_h
   return false;
 }
 
-OcspStapleAction ServerContextImpl::ocspStapleAction(const TlsContext& ctx,
-                                                     bool client_ocsp_capable) {
+OcspStapleAction
+ServerContextImpl::ocspStapleAction(const TlsContext& ctx,
+                                    const Ssl::FetchedOcspResponse* fetched_response,
+                                    bool client_ocsp_capable) {
   if (!client_ocsp_capable) {
     return OcspStapleAction::ClientNotCapable;
   }
 
   auto& response = ctx.ocsp_response_;
+  const bool has_response = response != nullptr || fetched_response != nullptr;
   if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.check_ocsp_policy")) {
     // Expiration check is disabled. Proceed as if the policy is LenientStapling and the response
     // is not expired.
-    return response ? OcspStapleAction::Staple : OcspStapleAction::NoStaple;
+    return has_response ? OcspStapleAction::Staple : OcspStapleAction::NoStaple;
   }
 
   auto policy = ocsp_staple_policy_;
@@ -1059,7 +1227,10 @@ OcspStapleAction ServerContextImpl::ocspStapleAction(const TlsContext& ctx,
     policy = Ssl::ServerContextConfig::OcspStaplePolicy::MustStaple;
   }
 
-  const bool valid_response = response && !response->isExpired();
+  const bool valid_response =
+      response ? !response->isExpired()
+               : fetched_response != nullptr &&
+                     fetched_response->next_update_ >= time_source_.systemTime();
 
   switch (policy) {
   case Ssl::ServerContextConfig::OcspStaplePolicy::LenientStapling:
@@ -1072,7 +1243,7 @@ OcspStapleAction ServerContextImpl::ocspStapleAction(const TlsContext& ctx,
     if (valid_response) {
       return OcspStapleAction::Staple;
     }
-    if (response) {
+    if (has_response) {
       // Expired response.
       return OcspStapleAction::Fail;
     }
@@ -1094,20 +1265,25 @@ ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
   const bool client_ecdsa_capable = isClientEcdsaCapable(ssl_client_hello);
   const bool client_ocsp_capable = isClientOcspCapable(ssl_client_hello);
 
-  // Fallback on first certificate.
+  // Fallback on first certificate. The fetched OCSP responses may be replaced concurrently, so the
+  // one of the selected context is kept until it is stapled.
   const TlsContext* selected_ctx = &tls_contexts_[0];
-  auto ocsp_staple_action = ocspStapleAction(*selected_ctx, client_ocsp_capable);
+  Ssl::FetchedOcspResponseConstSharedPtr fetched_response = selected_ctx->fetchedOcspResponse();
+  auto ocsp_staple_action =
+      ocspStapleAction(*selected_ctx, fetched_response.get(), client_ocsp_capable);
   for (const auto& ctx : tls_contexts_) {
     if (client_ecdsa_capable != ctx.is_ecdsa_) {
       continue;
     }
 
-    auto action = ocspStapleAction(ctx, client_ocsp_capable);
+    Ssl::FetchedOcspResponseConstSharedPtr ctx_fetched_response = ctx.fetchedOcspResponse();
+    auto action = ocspStapleAction(ctx, ctx_fetched_response.get(), client_ocsp_capable);
     if (action == OcspStapleAction::Fail) {
       continue;
     }
 
     selected_ctx = &ctx;
+    fetched_response = std::move(ctx_fetched_response);
     ocsp_staple_action = action;
     break;
   }
@@ -1125,9 +1301,10 @@ ServerContextImpl::selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello) {
   switch (ocsp_staple_action) {
   case OcspStapleAction::Staple: {
     // We avoid setting the OCSP response if the client didn't request it, but doing so is safe.
-    RELEASE_ASSERT(selected_ctx->ocsp_response_,
+    RELEASE_ASSERT(selected_ctx->ocsp_response_ || fetched_response,
                    "OCSP response must be present under OcspStapleAction::Staple");
-    auto& resp_bytes = selected_ctx->ocsp_response_->rawBytes();
+    auto& resp_bytes = selected_ctx->ocsp_response_ ? selected_ctx->ocsp_response_->rawBytes()
+                                                    : fetched_response->der_;
     int rc = SSL_set_ocsp_response(ssl_client_hello->ssl, resp_bytes.data(), resp_bytes.size());
     RELEASE_ASSERT(rc != 0, "");
     stats_.ocsp_staple_responses_.inc();
@@ -6,10 +6,13 @@
 #include <string>
 #include <vector>
 
+#include "envoy/event/dispatcher.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/ssl/context.h"
 #include "envoy/ssl/context_config.h"
+#include "envoy/ssl/handshake_offload.h"
 #include "envoy/ssl/private_key/private_key.h"
+#include "envoy/ssl/session_cache.h"
 #include "envoy/ssl/ssl_socket_extended_info.h"
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
@@ -21,6 +24,7 @@
 #include "extensions/transport_sockets/tls/context_manager_impl.h"
 #include "extensions/transport_sockets/tls/ocsp/ocsp.h"
 #include "extensions/transport_sockets/tls/stats.h"
+#include "extensions/transport_sockets/tls/tls_material_cache.h"
 
 #include "absl/synchronization/mutex.h"
 #include "openssl/ssl.h"
@@ -42,19 +46,42 @@ struct TlsContext {
   // SSL_CTX_set_select_certificate_cb() callback following ClientHello.
   bssl::UniquePtr<SSL_CTX> ssl_ctx_;
   bssl::UniquePtr<X509> cert_chain_;
+  // The parsed certificate chain and private key, which may be shared with other contexts.
+  TlsMaterialCache::CertificateChainConstSharedPtr parsed_cert_chain_;
+  TlsMaterialCache::PrivateKeySharedPtr private_key_;
   std::string cert_chain_file_path_;
   Ocsp::OcspResponseWrapperPtr ocsp_response_;
+  // The OCSP responses fetched for the certificate if it has no OCSP staple in the config.
+  Ssl::OcspResponseSlotSharedPtr fetched_ocsp_response_;
   bool is_ecdsa_{};
   bool is_must_staple_{};
   Ssl::PrivateKeyMethodProviderSharedPtr private_key_method_provider_{};
 
   std::string getCertChainFileName() const { return cert_chain_file_path_; };
+  Ssl::FetchedOcspResponseConstSharedPtr fetchedOcspResponse() const {
+    return fetched_ocsp_response_ != nullptr ? fetched_ocsp_response_->response() : nullptr;
+  }
   bool isCipherEnabled(uint16_t cipher_id, uint16_t client_version);
   Envoy::Ssl::PrivateKeyMethodProviderSharedPtr getPrivateKeyMethodProvider() {
     return private_key_method_provider_;
   }
 };
 
+/**
+ * Callbacks of a connection whose handshake waits for a lookup in the external session cache of
+ * its context.
+ */
+class SessionCacheLookupCallbacks {
+public:
+  virtual ~SessionCacheLookupCallbacks() = default;
+
+  /**
+   * Called on the worker thread of the connection when the lookup completes, to resume the
+   * handshake.
+   */
+  virtual void onSessionCacheLookupComplete() PURE;
+};
+
 class ContextImpl : public virtual Envoy::Ssl::Context {
 public:
   virtual bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options);
@@ -67,6 +94,11 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return how much plaintext the TLS records written to the connections of the context hold.
+   */
+  const Ssl::RecordSizing& recordSizing() const { return record_sizing_; }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -83,9 +115,39 @@ public:
 
   bool verifyCertChain(X509& leaf_cert, STACK_OF(X509) & intermediates, std::string& error_details);
 
+  /**
+   * Associates a connection with the callbacks that resume its handshake when a lookup in the
+   * external session cache of the context completes. Does nothing if the context has no external
+   * session cache.
+   * @param ssl supplies the connection.
+   * @param callbacks supplies the callbacks of the connection.
+   * @param dispatcher supplies the dispatcher of the worker thread of the connection.
+   */
+  virtual void registerSessionCacheLookupCallbacks(SSL*, SessionCacheLookupCallbacks&,
+                                                   Event::Dispatcher&) {}
+
+  /**
+   * Dissociates a connection from its session cache lookup callbacks, and cancels its pending
+   * lookup if there is one.
+   * @param ssl supplies the connection.
+   */
+  virtual void unregisterSessionCacheLookupCallbacks(SSL*) {}
+
+  /**
+   * @return the pool of threads to run the handshakes of the context on, or nullptr if they run on
+   *         the worker threads of their connections.
+   */
+  virtual Ssl::HandshakeOffloadPoolSharedPtr handshakeOffloadPool() const { return nullptr; }
+
+  /**
+   * @return whether the encryption of the data written to the connections of the context is
+   *         offloaded to the kernel once their handshakes complete.
+   */
+  virtual bool enableKernelTlsTx() const { return false; }
+
 protected:
   ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& config,
-              TimeSource& time_source);
+              TimeSource& time_source, TlsMaterialCache& material_cache);
 
   /**
    * The global SSL-library index used for storing a pointer to the context
@@ -115,6 +177,7 @@ protected:
   std::string cert_chain_file_path_;
   TimeSource& time_source_;
   const unsigned tls_max_version_;
+  const Ssl::RecordSizing record_sizing_;
   mutable Stats::StatNameSetPtr stat_name_set_;
   const Stats::StatName unknown_ssl_cipher_;
   const Stats::StatName unknown_ssl_curve_;
@@ -132,7 +195,7 @@ using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
 class ClientContextImpl : public ContextImpl, public Envoy::Ssl::ClientContext {
 public:
   ClientContextImpl(Stats::Scope& scope, const Envoy::Ssl::ClientContextConfig& config,
-                    TimeSource& time_source);
+                    TimeSource& time_source, TlsMaterialCache& material_cache);
 
   bssl::UniquePtr<SSL> newSsl(const Network::TransportSocketOptions* options) override;
 
@@ -153,27 +216,50 @@ enum class OcspStapleAction { Staple, NoStaple, Fail, ClientNotCapable };
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    TlsMaterialCache& material_cache);
 
   // Select the TLS certificate context in SSL_CTX_set_select_certificate_cb() callback with
   // ClientHello details. This is made public for use by custom TLS extensions who want to
   // manually create and use this as a client hello callback.
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
 
+  // ContextImpl
+  void registerSessionCacheLookupCallbacks(SSL* ssl, SessionCacheLookupCallbacks& callbacks,
+                                           Event::Dispatcher& dispatcher) override;
+  void unregisterSessionCacheLookupCallbacks(SSL* ssl) override;
+  Ssl::HandshakeOffloadPoolSharedPtr handshakeOffloadPool() const override {
+    return handshake_offload_pool_;
+  }
+  bool enableKernelTlsTx() const override { return enable_kernel_tls_tx_; }
+
 private:
   using SessionContextID = std::array<uint8_t, SSL_MAX_SSL_SESSION_ID_LENGTH>;
 
+  /**
+   * The global SSL-library index used for storing the state of the session cache lookup of a
+   * connection in the SSL instance.
+   */
+  static int sslSessionCacheLookupIndex();
+
   int alpnSelectCallback(const unsigned char** out, unsigned char* outlen, const unsigned char* in,
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  int newSession(SSL_SESSION* session);
+  SSL_SESSION* lookupSession(SSL* ssl, const uint8_t* session_id, int session_id_len);
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   bool isClientOcspCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
-  OcspStapleAction ocspStapleAction(const TlsContext& ctx, bool client_ocsp_capable);
+  OcspStapleAction ocspStapleAction(const TlsContext& ctx,
+                                    const Ssl::FetchedOcspResponse* fetched_response,
+                                    bool client_ocsp_capable);
 
   SessionContextID generateHashForSessionContextId(const std::vector<std::string>& server_names);
 
-  const std::vector<Envoy::Ssl::ServerContextConfig::SessionTicketKey> session_ticket_keys_;
+  const Ssl::ServerContextConfig::SessionTicketKeyRingSharedPtr session_ticket_key_ring_;
+  const Ssl::SessionCacheSharedPtr session_cache_;
+  const Ssl::HandshakeOffloadPoolSharedPtr handshake_offload_pool_;
+  const bool enable_kernel_tls_tx_;
   const Ssl::ServerContextConfig::OcspStaplePolicy ocsp_staple_policy_;
 };
 
@@ -45,7 +45,7 @@ ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
   }
 
   Envoy::Ssl::ClientContextSharedPtr context =
-      std::make_shared<ClientContextImpl>(scope, config, time_source_);
+      std::make_shared<ClientContextImpl>(scope, config, time_source_, material_cache_);
   removeOldContext(old_context);
   removeEmptyContexts();
   contexts_.emplace_back(context);
@@ -60,7 +60,8 @@ Envoy::Ssl::ServerContextSharedPtr ContextManagerImpl::createSslServerContext(
   }
 
   Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_,
+                                          material_cache_);
   removeOldContext(old_context);
   removeEmptyContexts();
   contexts_.emplace_back(context);
@@ -9,6 +9,7 @@
 #include "envoy/stats/scope.h"
 
 #include "extensions/transport_sockets/tls/private_key/private_key_manager_impl.h"
+#include "extensions/transport_sockets/tls/tls_material_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -20,7 +21,8 @@ namespace Tls {
  * Contexts can be allocated via any thread (through in practice they are only allocated on the main
  * thread). They can be released from any thread (and in practice are since cluster information can
  * be released from any thread). Context allocation/free is a very uncommon thing so we just do a
- * global lock to protect it all.
+ * global lock to protect it all. The certificates, private keys and trust stores parsed by the
+ * contexts are shared between them through the material cache of the manager.
  */
 class ContextManagerImpl final : public Envoy::Ssl::ContextManager {
 public:
@@ -48,6 +50,7 @@ private:
   TimeSource& time_source_;
   std::list<std::weak_ptr<Envoy::Ssl::Context>> contexts_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
+  TlsMaterialCache material_cache_;
 };
 
 } // namespace Tls
@@ -0,0 +1,90 @@
+#include "extensions/transport_sockets/tls/handshake_offload_pool.h"
+
+#include "common/common/lock_guard.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+HandshakeOffloadPoolStats generateStats(Stats::Scope& scope) {
+  const std::string prefix = "ssl.handshake_offload.";
+  return {ALL_HANDSHAKE_OFFLOAD_POOL_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                           POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+} // namespace
+
+HandshakeOffloadPoolImpl::HandshakeOffloadPoolImpl(
+    const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext::HandshakeOffload&
+        config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : stats_(generateStats(factory_context.scope())),
+      overload_manager_(factory_context.overloadManager()),
+      max_pending_handshakes_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_handshakes,
+                                                              DefaultMaxPendingHandshakes)) {
+  const uint32_t thread_count = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, thread_count, 1);
+  for (uint32_t i = 0; i < thread_count; ++i) {
+    threads_.push_back(factory_context.api().threadFactory().createThread(
+        [this]() { threadRoutine(); }, Thread::Options{"tls-handshake"}));
+  }
+}
+
+HandshakeOffloadPoolImpl::~HandshakeOffloadPoolImpl() {
+  {
+    Thread::LockGuard lock(mutex_);
+    shutting_down_ = true;
+  }
+  queue_not_empty_.notifyAll();
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+bool HandshakeOffloadPoolImpl::tryPost(std::function<void()> step) {
+  if (overload_manager_ != nullptr &&
+      overload_manager_->getThreadLocalOverloadState()
+          .getState(Server::OverloadActionNames::get().RejectTlsHandshakes)
+          .isSaturated()) {
+    stats_.rejected_.inc();
+    return false;
+  }
+  {
+    Thread::LockGuard lock(mutex_);
+    if (queue_.size() >= max_pending_handshakes_) {
+      stats_.rejected_.inc();
+      return false;
+    }
+    queue_.push_back(std::move(step));
+    stats_.pending_.inc();
+  }
+  stats_.offloaded_.inc();
+  queue_not_empty_.notifyOne();
+  return true;
+}
+
+void HandshakeOffloadPoolImpl::threadRoutine() {
+  while (true) {
+    std::function<void()> step;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (queue_.empty() && !shutting_down_) {
+        queue_not_empty_.wait(mutex_);
+      }
+      if (shutting_down_) {
+        return;
+      }
+      step = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    stats_.pending_.dec();
+    step();
+  }
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
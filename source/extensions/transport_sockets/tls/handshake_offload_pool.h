@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
+#include "envoy/server/overload/overload_manager.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/ssl/handshake_offload.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * All handshake offload pool stats. @see stats_macros.h
+ */
+#define ALL_HANDSHAKE_OFFLOAD_POOL_STATS(COUNTER, GAUGE)                                           \
+  COUNTER(offloaded)                                                                               \
+  COUNTER(rejected)                                                                                \
+  GAUGE(pending, Accumulate)
+
+/**
+ * Struct definition for all handshake offload pool stats. @see stats_macros.h
+ */
+struct HandshakeOffloadPoolStats {
+  ALL_HANDSHAKE_OFFLOAD_POOL_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+class HandshakeOffloadPoolImpl : public Ssl::HandshakeOffloadPool {
+public:
+  static constexpr uint32_t DefaultMaxPendingHandshakes = 1024;
+
+  HandshakeOffloadPoolImpl(
+      const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext::HandshakeOffload&
+          config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+  ~HandshakeOffloadPoolImpl() override;
+
+  // Ssl::HandshakeOffloadPool
+  bool tryPost(std::function<void()> step) override;
+
+private:
+  void threadRoutine();
+
+  HandshakeOffloadPoolStats stats_;
+  Server::OverloadManager* overload_manager_;
+  const uint32_t max_pending_handshakes_;
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar queue_not_empty_;
+  std::deque<std::function<void()>> queue_ ABSL_GUARDED_BY(mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(mutex_){};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
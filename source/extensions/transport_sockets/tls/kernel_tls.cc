@@ -0,0 +1,116 @@
+#include "extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "openssl/mem.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+#if defined(__linux__)
+namespace {
+
+// The size of the implicit part of the AES-GCM nonces of TLS 1.2, which is all that the key block
+// holds for the IVs of AEAD ciphers.
+constexpr size_t AesGcmSaltSize = 4;
+
+template <class CryptoInfo>
+bool installTxKey(Network::IoHandle& io_handle, uint16_t cipher_type, const uint8_t* key,
+                  const uint8_t* salt, uint64_t sequence) {
+  CryptoInfo crypto_info{};
+  crypto_info.info.version = TLS_1_2_VERSION;
+  crypto_info.info.cipher_type = cipher_type;
+  static_assert(sizeof(crypto_info.salt) == AesGcmSaltSize, "unexpected AES-GCM salt size");
+  memcpy(crypto_info.key, key, sizeof(crypto_info.key));
+  memcpy(crypto_info.salt, salt, sizeof(crypto_info.salt));
+  // The kernel sends the record sequence number as the explicit part of the nonce, as BoringSSL
+  // does, so both start from the sequence number of the next record.
+  static_assert(sizeof(crypto_info.rec_seq) == sizeof(sequence) &&
+                    sizeof(crypto_info.iv) == sizeof(sequence),
+                "unexpected AES-GCM record sequence size");
+  for (size_t i = 0; i < sizeof(sequence); ++i) {
+    crypto_info.rec_seq[i] = static_cast<uint8_t>(sequence >> (8 * (sizeof(sequence) - 1 - i)));
+  }
+  memcpy(crypto_info.iv, crypto_info.rec_seq, sizeof(crypto_info.iv));
+
+  const bool installed =
+      io_handle.setOption(SOL_TLS, TLS_TX, &crypto_info, sizeof(crypto_info)).rc_ == 0;
+  OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  return installed;
+}
+
+} // namespace
+
+bool enableKernelTlsTx(SSL* ssl, Network::IoHandle& io_handle) {
+  if (SSL_version(ssl) != TLS1_2_VERSION) {
+    // TLS 1.3 connections may update their keys at any time, which the TLS library would have to
+    // be told about.
+    return false;
+  }
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  if (cipher == nullptr) {
+    return false;
+  }
+  size_t key_size;
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    key_size = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+    break;
+  case NID_aes_256_gcm:
+    key_size = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+    break;
+  default:
+    return false;
+  }
+
+  // The key block of AEAD ciphers holds the client and server write keys followed by the client
+  // and server implicit nonces.
+  std::vector<uint8_t> key_block(SSL_get_key_block_len(ssl));
+  if (key_block.size() != 2 * (key_size + AesGcmSaltSize) ||
+      !SSL_generate_key_block(ssl, key_block.data(), key_block.size())) {
+    return false;
+  }
+  const bool is_server = SSL_is_server(ssl);
+  const uint8_t* key = key_block.data() + (is_server ? key_size : 0);
+  const uint8_t* salt = key_block.data() + 2 * key_size + (is_server ? AesGcmSaltSize : 0);
+
+  static constexpr char UpperLayerProtocol[] = "tls";
+  bool installed =
+      io_handle.setOption(IPPROTO_TCP, TCP_ULP, UpperLayerProtocol, sizeof(UpperLayerProtocol))
+          .rc_ == 0;
+  if (installed) {
+    const uint64_t sequence = SSL_get_write_sequence(ssl);
+    installed = key_size == TLS_CIPHER_AES_GCM_128_KEY_SIZE
+                    ? installTxKey<tls12_crypto_info_aes_gcm_128>(
+                          io_handle, TLS_CIPHER_AES_GCM_128, key, salt, sequence)
+                    : installTxKey<tls12_crypto_info_aes_gcm_256>(
+                          io_handle, TLS_CIPHER_AES_GCM_256, key, salt, sequence);
+  }
+  OPENSSL_cleanse(key_block.data(), key_block.size());
+  return installed;
+}
+#else
+bool enableKernelTlsTx(SSL*, Network::IoHandle&) { return false; }
+#endif
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "envoy/network/io_handle.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Offloads the encryption of the records written to a connection whose handshake completed to the
+ * kernel (kTLS), by installing the write key and sequence number negotiated by the handshake on
+ * the socket. This is only supported on Linux, for TLS 1.2 connections negotiating AES-GCM, since
+ * these never change their keys after the handshake.
+ * @param ssl supplies the SSL connection object of the connection.
+ * @param io_handle supplies the socket of the connection.
+ * @return whether the encryption is offloaded, in which case the data of the connection must be
+ *         written directly to the socket instead of with SSL_write(). If not, the socket is left
+ *         unchanged, apart from the tls upper layer protocol that may have been installed and
+ *         passes the data through unchanged.
+ */
+bool enableKernelTlsTx(SSL* ssl, Network::IoHandle& io_handle);
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
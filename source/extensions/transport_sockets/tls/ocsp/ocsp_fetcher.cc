@@ -0,0 +1,253 @@
+#include "extensions/transport_sockets/tls/ocsp/ocsp_fetcher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/common/enum_to_int.h"
+#include "common/http/headers.h"
+#include "common/http/message_impl.h"
+#include "common/http/utility.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/transport_sockets/tls/ocsp/ocsp.h"
+
+#include "openssl/bytestring.h"
+#include "openssl/mem.h"
+#include "openssl/obj.h"
+#include "openssl/sha.h"
+#include "openssl/x509v3.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace Ocsp {
+
+namespace {
+
+constexpr absl::string_view OcspRequestContentType{"application/ocsp-request"};
+
+OcspFetcherStats generateStats(Stats::Scope& scope) {
+  const std::string prefix = "ssl.ocsp_fetch.";
+  return {ALL_OCSP_FETCHER_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
+}
+
+// Returns the first OCSP responder URL of the authority information access extension of the
+// certificate, or an empty string if it has none.
+std::string ocspResponderUrl(X509& certificate) {
+  STACK_OF(OPENSSL_STRING)* urls = X509_get1_ocsp(&certificate);
+  std::string url;
+  if (urls != nullptr && sk_OPENSSL_STRING_num(urls) > 0) {
+    url = sk_OPENSSL_STRING_value(urls, 0);
+  }
+  X509_email_free(urls);
+  return url;
+}
+
+} // namespace
+
+Ssl::FetchedOcspResponseConstSharedPtr OcspResponseSlotImpl::response() const {
+  absl::ReaderMutexLock lock(&mutex_);
+  return response_;
+}
+
+void OcspResponseSlotImpl::setResponse(Ssl::FetchedOcspResponseConstSharedPtr response) {
+  absl::MutexLock lock(&mutex_);
+  response_ = std::move(response);
+}
+
+std::string buildOcspRequest(X509& certificate, X509& issuer) {
+  // The certificate ID holds the hashes of the DER encoded name of the issuer and of the value of
+  // the bit string of its public key, and the serial number of the certificate.
+  uint8_t* name_der = nullptr;
+  const int name_der_len = i2d_X509_NAME(X509_get_subject_name(&issuer), &name_der);
+  if (name_der_len <= 0) {
+    return "";
+  }
+  bssl::UniquePtr<uint8_t> name_der_ptr(name_der);
+  uint8_t name_hash[SHA_DIGEST_LENGTH];
+  SHA1(name_der, name_der_len, name_hash);
+
+  const ASN1_BIT_STRING* key = X509_get0_pubkey_bitstr(&issuer);
+  if (key == nullptr) {
+    return "";
+  }
+  uint8_t key_hash[SHA_DIGEST_LENGTH];
+  SHA1(ASN1_STRING_get0_data(key), ASN1_STRING_length(key), key_hash);
+
+  uint8_t* serial_der = nullptr;
+  const int serial_der_len = i2d_ASN1_INTEGER(X509_get_serialNumber(&certificate), &serial_der);
+  if (serial_der_len <= 0) {
+    return "";
+  }
+  bssl::UniquePtr<uint8_t> serial_der_ptr(serial_der);
+
+  bssl::ScopedCBB cbb;
+  CBB ocsp_request, tbs_request, request_list, request, cert_id, hash_algorithm, parameters,
+      issuer_name_hash, issuer_key_hash;
+  uint8_t* der;
+  size_t der_len;
+  if (!CBB_init(cbb.get(), 128) || !CBB_add_asn1(cbb.get(), &ocsp_request, CBS_ASN1_SEQUENCE) ||
+      !CBB_add_asn1(&ocsp_request, &tbs_request, CBS_ASN1_SEQUENCE) ||
+      !CBB_add_asn1(&tbs_request, &request_list, CBS_ASN1_SEQUENCE) ||
+      !CBB_add_asn1(&request_list, &request, CBS_ASN1_SEQUENCE) ||
+      !CBB_add_asn1(&request, &cert_id, CBS_ASN1_SEQUENCE) ||
+      !CBB_add_asn1(&cert_id, &hash_algorithm, CBS_ASN1_SEQUENCE) ||
+      !OBJ_nid2cbb(&hash_algorithm, NID_sha1) ||
+      !CBB_add_asn1(&hash_algorithm, &parameters, CBS_ASN1_NULL) ||
+      !CBB_add_asn1(&cert_id, &issuer_name_hash, CBS_ASN1_OCTETSTRING) ||
+      !CBB_add_bytes(&issuer_name_hash, name_hash, sizeof(name_hash)) ||
+      !CBB_add_asn1(&cert_id, &issuer_key_hash, CBS_ASN1_OCTETSTRING) ||
+      !CBB_add_bytes(&issuer_key_hash, key_hash, sizeof(key_hash)) ||
+      !CBB_add_bytes(&cert_id, serial_der, serial_der_len) ||
+      !CBB_finish(cbb.get(), &der, &der_len)) {
+    return "";
+  }
+  bssl::UniquePtr<uint8_t> der_ptr(der);
+  return {reinterpret_cast<const char*>(der), der_len};
+}
+
+OcspFetcherImpl::OcspFetcherImpl(
+    const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext::OcspFetch& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : cluster_manager_(factory_context.clusterManager()),
+      dispatcher_(factory_context.dispatcher()), time_source_(factory_context.api().timeSource()),
+      stats_(generateStats(factory_context.scope())), cluster_(config.cluster()),
+      timeout_(PROTOBUF_GET_MS_OR_DEFAULT(config, timeout, DefaultTimeout.count())),
+      retry_interval_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, retry_interval, DefaultRetryInterval.count())) {}
+
+Ssl::OcspResponseSlotSharedPtr OcspFetcherImpl::fetch(X509& certificate, X509* issuer) {
+  if (issuer == nullptr) {
+    ENVOY_LOG(warn, "not fetching the OCSP response of a certificate whose issuer isn't in its "
+                    "certificate chain");
+    return nullptr;
+  }
+  const std::string url = ocspResponderUrl(certificate);
+  if (url.empty()) {
+    ENVOY_LOG(warn, "not fetching the OCSP response of a certificate without OCSP responder URL");
+    return nullptr;
+  }
+  std::string request_body = buildOcspRequest(certificate, *issuer);
+  if (request_body.empty()) {
+    ENVOY_LOG(warn, "failed to build the OCSP request of a certificate");
+    return nullptr;
+  }
+
+  auto it = entries_.find(request_body);
+  if (it != entries_.end()) {
+    return it->second->slot();
+  }
+  absl::string_view host;
+  absl::string_view path;
+  Http::Utility::extractHostPathFromUri(url, host, path);
+  X509_up_ref(&certificate);
+  auto entry = std::make_unique<Entry>(*this, bssl::UniquePtr<X509>(&certificate), request_body,
+                                       std::string(host), std::string(path));
+  Ssl::OcspResponseSlotSharedPtr slot = entry->slot();
+  entries_.emplace(std::move(request_body), std::move(entry));
+  return slot;
+}
+
+void OcspFetcherImpl::removeEntry(const std::string& request_body) {
+  auto it = entries_.find(request_body);
+  ASSERT(it != entries_.end());
+  // The entry is removed from its own timer callback.
+  dispatcher_.deferredDelete(std::move(it->second));
+  entries_.erase(it);
+}
+
+OcspFetcherImpl::Entry::Entry(OcspFetcherImpl& parent, bssl::UniquePtr<X509> certificate,
+                              std::string request, std::string host, std::string path)
+    : parent_(parent), certificate_(std::move(certificate)), request_body_(std::move(request)),
+      host_(std::move(host)), path_(std::move(path)),
+      slot_(std::make_shared<OcspResponseSlotImpl>()),
+      refresh_timer_(parent_.dispatcher_.createTimer([this]() { refresh(); })) {
+  refresh_timer_->enableTimer(std::chrono::milliseconds(0));
+}
+
+OcspFetcherImpl::Entry::~Entry() {
+  if (request_ != nullptr) {
+    request_->cancel();
+  }
+}
+
+void OcspFetcherImpl::Entry::refresh() {
+  if (slot_.use_count() == 1) {
+    // No context uses the certificate anymore.
+    parent_.removeEntry(request_body_);
+    return;
+  }
+
+  const auto thread_local_cluster =
+      parent_.cluster_manager_.getThreadLocalCluster(parent_.cluster_);
+  if (thread_local_cluster == nullptr) {
+    ENVOY_LOG(debug, "OCSP fetch from {}{}: no cluster {}", host_, path_, parent_.cluster_);
+    onFetchFailed();
+    return;
+  }
+
+  Http::RequestMessagePtr message = std::make_unique<Http::RequestMessageImpl>();
+  message->headers().setReferenceMethod(Http::Headers::get().MethodValues.Post);
+  message->headers().setHost(host_);
+  message->headers().setPath(path_);
+  message->headers().setContentType(OcspRequestContentType);
+  message->body().add(request_body_);
+  request_ = thread_local_cluster->httpAsyncClient().send(
+      std::move(message), *this, Http::AsyncClient::RequestOptions().setTimeout(parent_.timeout_));
+}
+
+void OcspFetcherImpl::Entry::onSuccess(const Http::AsyncClient::Request&,
+                                       Http::ResponseMessagePtr&& response) {
+  request_ = nullptr;
+  const uint64_t status_code = Http::Utility::getResponseStatus(response->headers());
+  if (status_code != enumToInt(Http::Code::OK)) {
+    ENVOY_LOG(debug, "OCSP fetch from {}{}: response status code {}", host_, path_, status_code);
+    onFetchFailed();
+    return;
+  }
+
+  const std::string body = response->bodyAsString();
+  auto fetched = std::make_shared<Ssl::FetchedOcspResponse>();
+  fetched->der_.assign(body.begin(), body.end());
+  try {
+    OcspResponseWrapper wrapper(fetched->der_, parent_.time_source_);
+    if (!wrapper.matchesCertificate(*certificate_)) {
+      throw EnvoyException("OCSP response does not match its TLS certificate");
+    }
+    if (wrapper.isExpired()) {
+      throw EnvoyException("OCSP response is expired");
+    }
+    fetched->next_update_ = wrapper.getNextUpdate();
+  } catch (const EnvoyException& e) {
+    ENVOY_LOG(debug, "OCSP fetch from {}{}: invalid response: {}", host_, path_, e.what());
+    onFetchFailed();
+    return;
+  }
+
+  ENVOY_LOG(debug, "OCSP fetch from {}{}: success", host_, path_);
+  parent_.stats_.success_.inc();
+  const std::chrono::milliseconds validity = std::chrono::duration_cast<std::chrono::milliseconds>(
+      fetched->next_update_ - parent_.time_source_.systemTime());
+  slot_->setResponse(std::move(fetched));
+  // Refresh the response once half of its remaining validity elapsed, leaving time for retries.
+  refresh_timer_->enableTimer(std::max(validity / 2, parent_.retry_interval_));
+}
+
+void OcspFetcherImpl::Entry::onFailure(const Http::AsyncClient::Request&,
+                                       Http::AsyncClient::FailureReason reason) {
+  request_ = nullptr;
+  ENVOY_LOG(debug, "OCSP fetch from {}{}: network error {}", host_, path_, enumToInt(reason));
+  onFetchFailed();
+}
+
+void OcspFetcherImpl::Entry::onFetchFailed() {
+  parent_.stats_.failure_.inc();
+  refresh_timer_->enableTimer(parent_.retry_interval_);
+}
+
+} // namespace Ocsp
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
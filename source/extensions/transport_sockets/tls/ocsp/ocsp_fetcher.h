@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/timer.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls.pb.h"
+#include "envoy/http/async_client.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/ssl/ocsp_fetcher.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace Ocsp {
+
+/**
+ * All OCSP fetcher stats. @see stats_macros.h
+ */
+#define ALL_OCSP_FETCHER_STATS(COUNTER)                                                            \
+  COUNTER(success)                                                                                 \
+  COUNTER(failure)
+
+/**
+ * Struct definition for all OCSP fetcher stats. @see stats_macros.h
+ */
+struct OcspFetcherStats {
+  ALL_OCSP_FETCHER_STATS(GENERATE_COUNTER_STRUCT)
+};
+
+class OcspResponseSlotImpl : public Ssl::OcspResponseSlot {
+public:
+  // Ssl::OcspResponseSlot
+  Ssl::FetchedOcspResponseConstSharedPtr response() const override;
+
+  void setResponse(Ssl::FetchedOcspResponseConstSharedPtr response);
+
+private:
+  mutable absl::Mutex mutex_;
+  Ssl::FetchedOcspResponseConstSharedPtr response_ ABSL_GUARDED_BY(mutex_);
+};
+
+/**
+ * Builds the DER encoded OCSP request for the status of a certificate, as specified by RFC 6960
+ * section 4.1, with a SHA-1 certificate ID and no extensions.
+ * @param certificate supplies the certificate.
+ * @param issuer supplies the issuer of the certificate.
+ * @return the request, or an empty string if it can't be built.
+ */
+std::string buildOcspRequest(X509& certificate, X509& issuer);
+
+class OcspFetcherImpl : public Ssl::OcspFetcher, Logger::Loggable<Logger::Id::connection> {
+public:
+  static constexpr std::chrono::milliseconds DefaultTimeout{5000};
+  static constexpr std::chrono::milliseconds DefaultRetryInterval{60000};
+
+  OcspFetcherImpl(
+      const envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext::OcspFetch& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+
+  // Ssl::OcspFetcher
+  Ssl::OcspResponseSlotSharedPtr fetch(X509& certificate, X509* issuer) override;
+
+private:
+  /**
+   * The fetching of the OCSP responses of a certificate.
+   */
+  class Entry : public Http::AsyncClient::Callbacks, public Event::DeferredDeletable {
+  public:
+    Entry(OcspFetcherImpl& parent, bssl::UniquePtr<X509> certificate, std::string request,
+          std::string host, std::string path);
+    ~Entry() override;
+
+    const Ssl::OcspResponseSlotSharedPtr& slot() const { return slot_; }
+
+    // Http::AsyncClient::Callbacks
+    void onSuccess(const Http::AsyncClient::Request&, Http::ResponseMessagePtr&& response) override;
+    void onFailure(const Http::AsyncClient::Request&,
+                   Http::AsyncClient::FailureReason reason) override;
+    void onBeforeFinalizeUpstreamSpan(Envoy::Tracing::Span&,
+                                      const Http::ResponseHeaderMap*) override {}
+
+  private:
+    void refresh();
+    void onFetchFailed();
+
+    OcspFetcherImpl& parent_;
+    const bssl::UniquePtr<X509> certificate_;
+    // The OCSP request, which also identifies the entry in the fetcher.
+    const std::string request_body_;
+    const std::string host_;
+    const std::string path_;
+    const std::shared_ptr<OcspResponseSlotImpl> slot_;
+    const Event::TimerPtr refresh_timer_;
+    Http::AsyncClient::Request* request_{};
+  };
+
+  using EntryPtr = std::unique_ptr<Entry>;
+
+  void removeEntry(const std::string& request_body);
+
+  Upstream::ClusterManager& cluster_manager_;
+  Event::Dispatcher& dispatcher_;
+  TimeSource& time_source_;
+  OcspFetcherStats stats_;
+  const std::string cluster_;
+  const std::chrono::milliseconds timeout_;
+  const std::chrono::milliseconds retry_interval_;
+  absl::flat_hash_map<std::string, EntryPtr> entries_;
+};
+
+} // namespace Ocsp
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,350 @@
+#include "extensions/transport_sockets/tls/private_key/batched/batched_private_key_provider.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
+#include "common/config/datasource.h"
+#include "common/protobuf/utility.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+namespace {
+
+BatchedPrivateKeyProviderStats generateStats(Stats::Scope& scope) {
+  const std::string prefix = "private_key_provider.batched.";
+  return {ALL_BATCHED_PRIVATE_KEY_PROVIDER_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                                 POOL_GAUGE_PREFIX(scope, prefix),
+                                                 POOL_HISTOGRAM_PREFIX(scope, prefix))};
+}
+
+struct RegisteredProvider {
+  BatchedPrivateKeyMethodProvider* provider_;
+  Ssl::PrivateKeyConnectionCallbacks* callbacks_;
+  Event::Dispatcher* dispatcher_;
+};
+
+/**
+ * The batched providers a connection is registered with, i.e. one per key type of the certificates
+ * of its context, and its operation in progress.
+ */
+struct ConnectionData {
+  ~ConnectionData() {
+    if (operation_ != nullptr) {
+      operation_->cancel();
+    }
+  }
+
+  absl::InlinedVector<RegisteredProvider, 2> providers_;
+  PrivateKeyOperationSharedPtr operation_;
+};
+
+void freeConnectionData(void*, void* ptr, CRYPTO_EX_DATA*, int, long, // NOLINT(google-runtime-int)
+                        void*) {
+  delete static_cast<ConnectionData*>(ptr);
+}
+
+int connectionIndex() {
+  CONSTRUCT_ON_FIRST_USE(int, []() -> int {
+    // Frees the data of connections that are freed without being unregistered.
+    const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, freeConnectionData);
+    RELEASE_ASSERT(index >= 0, "Failed to get SSL user data index.");
+    return index;
+  }());
+}
+
+ConnectionData* connectionData(SSL* ssl) {
+  return static_cast<ConnectionData*>(SSL_get_ex_data(ssl, connectionIndex()));
+}
+
+ssl_private_key_result_t queueOperation(SSL* ssl, int key_type,
+                                        absl::optional<uint16_t> signature_algorithm,
+                                        const uint8_t* in, size_t in_len) {
+  ConnectionData* data = connectionData(ssl);
+  if (data == nullptr || data->operation_ != nullptr) {
+    return ssl_private_key_failure;
+  }
+  for (const RegisteredProvider& registered : data->providers_) {
+    if (registered.provider_->keyType() == key_type) {
+      data->operation_ = registered.provider_->queueOperation(
+          *registered.callbacks_, *registered.dispatcher_, signature_algorithm, in, in_len);
+      return ssl_private_key_retry;
+    }
+  }
+  return ssl_private_key_failure;
+}
+
+ssl_private_key_result_t privateKeySign(SSL* ssl, uint8_t*, size_t*, size_t,
+                                        uint16_t signature_algorithm, const uint8_t* in,
+                                        size_t in_len) {
+  return queueOperation(ssl, SSL_get_signature_algorithm_key_type(signature_algorithm),
+                        signature_algorithm, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyDecrypt(SSL* ssl, uint8_t*, size_t*, size_t, const uint8_t* in,
+                                           size_t in_len) {
+  return queueOperation(ssl, EVP_PKEY_RSA, absl::nullopt, in, in_len);
+}
+
+ssl_private_key_result_t privateKeyComplete(SSL* ssl, uint8_t* out, size_t* out_len,
+                                            size_t max_out) {
+  ConnectionData* data = connectionData(ssl);
+  if (data == nullptr || data->operation_ == nullptr) {
+    return ssl_private_key_failure;
+  }
+  if (!data->operation_->completed()) {
+    return ssl_private_key_retry;
+  }
+
+  PrivateKeyOperationSharedPtr operation = std::move(data->operation_);
+  const std::vector<uint8_t>& output = operation->output();
+  if (!operation->succeeded() || output.size() > max_out) {
+    return ssl_private_key_failure;
+  }
+  std::copy(output.begin(), output.end(), out);
+  *out_len = output.size();
+  return ssl_private_key_success;
+}
+
+bool sign(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::vector<uint8_t>& in,
+          std::vector<uint8_t>& out) {
+  const EVP_MD* md = SSL_get_signature_algorithm_digest(signature_algorithm);
+  if (md == nullptr ||
+      SSL_get_signature_algorithm_key_type(signature_algorithm) != EVP_PKEY_id(pkey)) {
+    return false;
+  }
+
+  bssl::ScopedEVP_MD_CTX ctx;
+  EVP_PKEY_CTX* pkey_ctx;
+  if (!EVP_DigestSignInit(ctx.get(), &pkey_ctx, md, nullptr, pkey)) {
+    return false;
+  }
+  if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+      (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+       !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+    return false;
+  }
+
+  size_t out_len = EVP_PKEY_size(pkey);
+  out.resize(out_len);
+  if (!EVP_DigestSign(ctx.get(), out.data(), &out_len, in.data(), in.size())) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+bool decrypt(EVP_PKEY* pkey, const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey);
+  if (rsa == nullptr) {
+    return false;
+  }
+
+  size_t out_len = RSA_size(rsa);
+  out.resize(out_len);
+  if (!RSA_decrypt(rsa, &out_len, out.data(), out.size(), in.data(), in.size(), RSA_NO_PADDING)) {
+    return false;
+  }
+  out.resize(out_len);
+  return true;
+}
+
+} // namespace
+
+PrivateKeyOperation::PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& callbacks,
+                                         Event::Dispatcher& dispatcher,
+                                         BatchedPrivateKeyProviderStats& stats,
+                                         TimeSource& time_source,
+                                         absl::optional<uint16_t> signature_algorithm,
+                                         const uint8_t* in, size_t in_len)
+    : signature_algorithm_(signature_algorithm), input_(in, in + in_len), stats_(stats),
+      time_source_(time_source), queued_time_(time_source.monotonicTime()), callbacks_(&callbacks),
+      dispatcher_(dispatcher) {}
+
+void PrivateKeyOperation::execute(EVP_PKEY* pkey) {
+  succeeded_ = signature_algorithm_.has_value() ? sign(pkey, *signature_algorithm_, input_, output_)
+                                                : decrypt(pkey, input_, output_);
+  stats_.operations_.inc();
+  if (!succeeded_) {
+    stats_.failures_.inc();
+  }
+}
+
+void PrivateKeyOperation::postComplete() {
+  // Holding the lock keeps the connection, and with it the dispatcher, from going away while
+  // posting.
+  Thread::LockGuard lock(mutex_);
+  if (callbacks_ != nullptr) {
+    dispatcher_.post([operation = shared_from_this()]() { operation->complete(); });
+  }
+}
+
+void PrivateKeyOperation::cancel() {
+  Thread::LockGuard lock(mutex_);
+  callbacks_ = nullptr;
+}
+
+void PrivateKeyOperation::complete() {
+  Ssl::PrivateKeyConnectionCallbacks* callbacks;
+  {
+    Thread::LockGuard lock(mutex_);
+    callbacks = callbacks_;
+  }
+  if (callbacks == nullptr) {
+    // The connection was closed after the completion was posted.
+    return;
+  }
+
+  completed_ = true;
+  stats_.operation_time_.recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                                         time_source_.monotonicTime() - queued_time_)
+                                         .count());
+  // Resumes the handshake, which picks up the output via privateKeyComplete().
+  callbacks->onPrivateKeyMethodComplete();
+}
+
+BatchedPrivateKeyMethodProvider::BatchedPrivateKeyMethodProvider(
+    const envoy::extensions::transport_sockets::tls::v3::BatchedPrivateKeyProviderConfig& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context)
+    : time_source_(factory_context.api().timeSource()),
+      stats_(generateStats(factory_context.scope())),
+      max_batch_size_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_size, DefaultMaxBatchSize)) {
+  const std::string private_key =
+      Config::DataSource::read(config.private_key(), false, factory_context.api());
+  bssl::UniquePtr<BIO> bio(
+      BIO_new_mem_buf(const_cast<char*>(private_key.data()), private_key.size()));
+  pkey_.reset(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  if (pkey_ == nullptr) {
+    throw EnvoyException("Failed to load the private key of the batched private key provider.");
+  }
+  if (keyType() != EVP_PKEY_RSA && keyType() != EVP_PKEY_EC) {
+    throw EnvoyException("The batched private key provider only supports RSA and ECDSA keys.");
+  }
+
+  method_ = std::make_shared<SSL_PRIVATE_KEY_METHOD>();
+  method_->sign = privateKeySign;
+  method_->decrypt = privateKeyDecrypt;
+  method_->complete = privateKeyComplete;
+
+  const uint32_t signing_threads = std::max(config.signing_threads(), 1U);
+  for (uint32_t i = 0; i < signing_threads; ++i) {
+    signing_threads_.push_back(factory_context.api().threadFactory().createThread(
+        [this]() { signingThreadRoutine(); }, Thread::Options{"pk-signer"}));
+  }
+}
+
+BatchedPrivateKeyMethodProvider::~BatchedPrivateKeyMethodProvider() {
+  {
+    Thread::LockGuard lock(queue_mutex_);
+    shutting_down_ = true;
+  }
+  queue_not_empty_.notifyAll();
+  for (Thread::ThreadPtr& thread : signing_threads_) {
+    thread->join();
+  }
+}
+
+void BatchedPrivateKeyMethodProvider::registerPrivateKeyMethod(
+    SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb, Event::Dispatcher& dispatcher) {
+  ConnectionData* data = connectionData(ssl);
+  if (data == nullptr) {
+    data = new ConnectionData();
+    SSL_set_ex_data(ssl, connectionIndex(), data);
+  }
+  for (const RegisteredProvider& registered : data->providers_) {
+    if (registered.provider_->keyType() == keyType()) {
+      throw EnvoyException("Can't register two batched private key providers with the same key "
+                           "type for the same SSL object.");
+    }
+  }
+  data->providers_.push_back({this, &cb, &dispatcher});
+}
+
+void BatchedPrivateKeyMethodProvider::unregisterPrivateKeyMethod(SSL* ssl) {
+  ConnectionData* data = connectionData(ssl);
+  if (data == nullptr) {
+    return;
+  }
+  // Connections are only unregistered when they are closed, so any operation in progress is
+  // cancelled.
+  if (data->operation_ != nullptr) {
+    data->operation_->cancel();
+    data->operation_.reset();
+  }
+  data->providers_.erase(std::remove_if(data->providers_.begin(), data->providers_.end(),
+                                        [this](const RegisteredProvider& registered) {
+                                          return registered.provider_ == this;
+                                        }),
+                         data->providers_.end());
+  if (data->providers_.empty()) {
+    SSL_set_ex_data(ssl, connectionIndex(), nullptr);
+    delete data;
+  }
+}
+
+bool BatchedPrivateKeyMethodProvider::checkFips() {
+  if (keyType() == EVP_PKEY_RSA) {
+    RSA* rsa_private_key = EVP_PKEY_get0_RSA(pkey_.get());
+    return rsa_private_key != nullptr && RSA_check_fips(rsa_private_key);
+  }
+  const EC_KEY* ecdsa_private_key = EVP_PKEY_get0_EC_KEY(pkey_.get());
+  return ecdsa_private_key != nullptr && EC_KEY_check_fips(ecdsa_private_key);
+}
+
+PrivateKeyOperationSharedPtr BatchedPrivateKeyMethodProvider::queueOperation(
+    Ssl::PrivateKeyConnectionCallbacks& callbacks, Event::Dispatcher& dispatcher,
+    absl::optional<uint16_t> signature_algorithm, const uint8_t* in, size_t in_len) {
+  auto operation = std::make_shared<PrivateKeyOperation>(
+      callbacks, dispatcher, stats_, time_source_, signature_algorithm, in, in_len);
+  stats_.queue_size_.inc();
+  {
+    Thread::LockGuard lock(queue_mutex_);
+    queue_.push_back(operation);
+  }
+  queue_not_empty_.notifyOne();
+  return operation;
+}
+
+void BatchedPrivateKeyMethodProvider::signingThreadRoutine() {
+  std::vector<PrivateKeyOperationSharedPtr> batch;
+  batch.reserve(max_batch_size_);
+  while (true) {
+    {
+      Thread::LockGuard lock(queue_mutex_);
+      while (queue_.empty() && !shutting_down_) {
+        queue_not_empty_.wait(queue_mutex_);
+      }
+      if (shutting_down_) {
+        return;
+      }
+      while (!queue_.empty() && batch.size() < max_batch_size_) {
+        batch.push_back(std::move(queue_.front()));
+        queue_.pop_front();
+      }
+    }
+
+    stats_.queue_size_.sub(batch.size());
+    stats_.batches_.inc();
+    for (const PrivateKeyOperationSharedPtr& operation : batch) {
+      operation->execute(pkey_.get());
+    }
+    for (const PrivateKeyOperationSharedPtr& operation : batch) {
+      operation->postComplete();
+    }
+    batch.clear();
+  }
+}
+
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/time.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls_batched_private_key_provider_config.pb.h"
+#include "envoy/server/transport_socket_config.h"
+#include "envoy/ssl/private_key/private_key.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+#include "envoy/thread/thread.h"
+
+#include "common/common/thread.h"
+
+#include "absl/types/optional.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+
+/**
+ * All batched private key provider stats. @see stats_macros.h
+ */
+#define ALL_BATCHED_PRIVATE_KEY_PROVIDER_STATS(COUNTER, GAUGE, HISTOGRAM)                          \
+  COUNTER(batches)                                                                                 \
+  COUNTER(failures)                                                                                \
+  COUNTER(operations)                                                                              \
+  GAUGE(queue_size, Accumulate)                                                                    \
+  HISTOGRAM(operation_time, Microseconds)
+
+/**
+ * Struct definition for all batched private key provider stats. @see stats_macros.h
+ */
+struct BatchedPrivateKeyProviderStats {
+  ALL_BATCHED_PRIVATE_KEY_PROVIDER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT,
+                                         GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * A private key operation of a handshake, which is queued on the worker thread of the connection,
+ * executed on a signing thread, and completed back on the worker thread.
+ */
+class PrivateKeyOperation : public std::enable_shared_from_this<PrivateKeyOperation> {
+public:
+  PrivateKeyOperation(Ssl::PrivateKeyConnectionCallbacks& callbacks, Event::Dispatcher& dispatcher,
+                      BatchedPrivateKeyProviderStats& stats, TimeSource& time_source,
+                      absl::optional<uint16_t> signature_algorithm, const uint8_t* in,
+                      size_t in_len);
+
+  /**
+   * Performs the operation with a private key. Called on a signing thread.
+   */
+  void execute(EVP_PKEY* pkey);
+
+  /**
+   * Posts the completion of the operation to the worker thread of its connection, unless the
+   * operation has been cancelled. Called on a signing thread after execute().
+   */
+  void postComplete();
+
+  /**
+   * Stops the operation from completing or touching its connection's dispatcher. Called on the
+   * worker thread when the connection is closed before the operation completes.
+   */
+  void cancel();
+
+  bool completed() const { return completed_; }
+  bool succeeded() const { return succeeded_; }
+  const std::vector<uint8_t>& output() const { return output_; }
+
+private:
+  void complete();
+
+  // The signature algorithm for a sign operation, or none for a decrypt operation.
+  const absl::optional<uint16_t> signature_algorithm_;
+  const std::vector<uint8_t> input_;
+  BatchedPrivateKeyProviderStats& stats_;
+  TimeSource& time_source_;
+  const MonotonicTime queued_time_;
+  // Only written by execute(), and only read after complete().
+  std::vector<uint8_t> output_;
+  bool succeeded_{};
+  // Only accessed on the worker thread.
+  bool completed_{};
+
+  Thread::MutexBasicLockable mutex_;
+  Ssl::PrivateKeyConnectionCallbacks* callbacks_ ABSL_GUARDED_BY(mutex_);
+  Event::Dispatcher& dispatcher_;
+};
+
+using PrivateKeyOperationSharedPtr = std::shared_ptr<PrivateKeyOperation>;
+
+/**
+ * A private key method provider that takes the private key operations of handshakes off the
+ * worker threads. Operations are queued, executed in batches on dedicated signing threads, and
+ * their handshakes are resumed on their worker threads via onPrivateKeyMethodComplete().
+ */
+class BatchedPrivateKeyMethodProvider : public virtual Ssl::PrivateKeyMethodProvider {
+public:
+  static constexpr uint32_t DefaultMaxBatchSize = 32;
+
+  BatchedPrivateKeyMethodProvider(
+      const envoy::extensions::transport_sockets::tls::v3::BatchedPrivateKeyProviderConfig& config,
+      Server::Configuration::TransportSocketFactoryContext& factory_context);
+  ~BatchedPrivateKeyMethodProvider() override;
+
+  // Ssl::PrivateKeyMethodProvider
+  void registerPrivateKeyMethod(SSL* ssl, Ssl::PrivateKeyConnectionCallbacks& cb,
+                                Event::Dispatcher& dispatcher) override;
+  void unregisterPrivateKeyMethod(SSL* ssl) override;
+  bool checkFips() override;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr getBoringSslPrivateKeyMethod() override {
+    return method_;
+  }
+
+  /**
+   * Queues an operation for the signing threads.
+   * @param callbacks supplies the callbacks of the connection to notify when the operation is
+   *        complete.
+   * @param dispatcher supplies the dispatcher of the connection's worker thread.
+   * @param signature_algorithm supplies the signature algorithm of a sign operation, or none for a
+   *        decrypt operation.
+   * @param in supplies the input of the operation.
+   * @param in_len supplies the length of the input.
+   * @return the queued operation.
+   */
+  PrivateKeyOperationSharedPtr queueOperation(Ssl::PrivateKeyConnectionCallbacks& callbacks,
+                                              Event::Dispatcher& dispatcher,
+                                              absl::optional<uint16_t> signature_algorithm,
+                                              const uint8_t* in, size_t in_len);
+
+  /**
+   * @return the key type of the provider's private key, e.g. EVP_PKEY_RSA.
+   */
+  int keyType() const { return EVP_PKEY_id(pkey_.get()); }
+
+private:
+  void signingThreadRoutine();
+
+  bssl::UniquePtr<EVP_PKEY> pkey_;
+  Ssl::BoringSslPrivateKeyMethodSharedPtr method_;
+  TimeSource& time_source_;
+  BatchedPrivateKeyProviderStats stats_;
+  const uint32_t max_batch_size_;
+
+  Thread::MutexBasicLockable queue_mutex_;
+  Thread::CondVar queue_not_empty_;
+  std::deque<PrivateKeyOperationSharedPtr> queue_ ABSL_GUARDED_BY(queue_mutex_);
+  bool shutting_down_ ABSL_GUARDED_BY(queue_mutex_){};
+  std::vector<Thread::ThreadPtr> signing_threads_;
+};
+
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,35 @@
+#include "extensions/transport_sockets/tls/private_key/batched/config.h"
+
+#include "envoy/extensions/transport_sockets/tls/v3/tls_batched_private_key_provider_config.pb.h"
+#include "envoy/extensions/transport_sockets/tls/v3/tls_batched_private_key_provider_config.pb.validate.h"
+#include "envoy/registry/registry.h"
+#include "envoy/server/transport_socket_config.h"
+
+#include "common/protobuf/utility.h"
+
+#include "extensions/transport_sockets/tls/private_key/batched/batched_private_key_provider.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+
+Ssl::PrivateKeyMethodProviderSharedPtr
+BatchedPrivateKeyMethodFactory::createPrivateKeyMethodProviderInstance(
+    const envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider& config,
+    Server::Configuration::TransportSocketFactoryContext& factory_context) {
+  const auto message = MessageUtil::anyConvertAndValidate<
+      envoy::extensions::transport_sockets::tls::v3::BatchedPrivateKeyProviderConfig>(
+      config.typed_config(), factory_context.messageValidationVisitor());
+  return std::make_shared<BatchedPrivateKeyMethodProvider>(message, factory_context);
+}
+
+/**
+ * Static registration for the batched private key provider. @see RegisterFactory.
+ */
+REGISTER_FACTORY(BatchedPrivateKeyMethodFactory, Ssl::PrivateKeyMethodProviderInstanceFactory);
+
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
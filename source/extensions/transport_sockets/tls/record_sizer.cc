@@ -0,0 +1,48 @@
+#include "extensions/transport_sockets/tls/record_sizer.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+void RecordSizer::onWrite(TimeSource& time_source) {
+  if (sizing_.idle_timeout_.count() == 0) {
+    return;
+  }
+  const MonotonicTime now = time_source.monotonicTime();
+  if (bytes_written_ > 0 && now - last_write_time_ >= sizing_.idle_timeout_) {
+    bytes_written_ = 0;
+    records_written_ = 0;
+  }
+  last_write_time_ = now;
+}
+
+uint64_t RecordSizer::nextRecordSize(const Buffer::Instance& buffer) const {
+  // The records grow in an arithmetic progression, which reaches the maximum record size after a
+  // few round trips worth of data.
+  uint64_t record_size = MaxRecordSize;
+  if (bytes_written_ < sizing_.boost_threshold_) {
+    record_size = std::min(MaxRecordSize, sizing_.initial_record_size_ * (records_written_ + 1));
+  }
+  record_size = std::min(record_size, buffer.length());
+
+  const uint64_t front_slice_size = buffer.frontSlice().len_;
+  if (front_slice_size < record_size && front_slice_size >= MinSliceRecordSize) {
+    return front_slice_size;
+  }
+  return record_size;
+}
+
+void RecordSizer::onRecordWritten(uint64_t size) {
+  bytes_written_ += size;
+  if (bytes_written_ < sizing_.boost_threshold_) {
+    ++records_written_;
+  }
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/time.h"
+#include "envoy/ssl/context_config.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Picks how much plaintext of a write buffer each SSL_write(), and so each TLS record, covers.
+ *
+ * The first records of a connection are small, so that the peer can start decrypting them as soon
+ * as their first TCP segments arrive instead of waiting for whole 16KB records, and then grow
+ * until they reach the maximum record size, which minimizes the per record overhead of bulk
+ * transfers. Records also stop at the end of the front slice of the buffer when it is large
+ * enough, so that SSL_write() encrypts directly from the slice instead of from a copy of the
+ * slices linearized into a new one.
+ */
+class RecordSizer {
+public:
+  // The largest amount of plaintext a TLS record holds.
+  static constexpr uint64_t MaxRecordSize = 16384;
+  // The smallest front slice that a record ends at instead of being linearized with the next
+  // slices. Smaller records would cost more in per record overhead than the copy saves.
+  static constexpr uint64_t MinSliceRecordSize = 4096;
+
+  explicit RecordSizer(const Ssl::RecordSizing& sizing) : sizing_(sizing) {}
+
+  /**
+   * Called before the records of a write are sized, to shrink them back to the initial size if
+   * the connection has been idle.
+   * @param time_source supplies the time source of the connection, which is only read if the
+   *        records shrink after an idle timeout.
+   */
+  void onWrite(TimeSource& time_source);
+
+  /**
+   * @param buffer supplies the plaintext that remains to be written.
+   * @return the number of bytes from the front of buffer for the next record.
+   */
+  uint64_t nextRecordSize(const Buffer::Instance& buffer) const;
+
+  /**
+   * Called when a record has been written.
+   * @param size supplies the amount of plaintext in the record.
+   */
+  void onRecordWritten(uint64_t size);
+
+private:
+  const Ssl::RecordSizing sizing_;
+  uint64_t bytes_written_{};
+  uint64_t records_written_{};
+  MonotonicTime last_write_time_;
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include "common/common/assert.h"
 #include "common/common/empty_string.h"
 #include "common/common/hex.h"
+#include "common/common/lock_guard.h"
 #include "common/http/headers.h"
 
 #include "extensions/transport_sockets/tls/utility.h"
@@ -36,6 +37,8 @@ SslHandshakerImpl::SslHandshakerImpl(bssl::UniquePtr<SSL> ssl, int ssl_extended_
   SSL_set_ex_data(ssl_.get(), ssl_extended_socket_info_index, &(this->extended_socket_info_));
 }
 
+SslHandshakerImpl::~SslHandshakerImpl() { cancelOffloadedHandshake(); }
+
 bool SslHandshakerImpl::peerCertificatePresented() const {
   bssl::UniquePtr<X509> cert(SSL_get_peer_certificate(ssl()));
   return cert != nullptr;
@@ -222,7 +225,14 @@ const std::string& SslHandshakerImpl::tlsVersion() const {
 
 Network::PostIoAction SslHandshakerImpl::doHandshake() {
   ASSERT(state_ != Ssl::SocketState::HandshakeComplete && state_ != Ssl::SocketState::ShutdownSent);
+  if (offload_pool_ != nullptr) {
+    return offloadHandshake();
+  }
   int rc = SSL_do_handshake(ssl());
+  return processHandshakeResult(rc, rc == 1 ? SSL_ERROR_NONE : SSL_get_error(ssl(), rc));
+}
+
+Network::PostIoAction SslHandshakerImpl::processHandshakeResult(int rc, int err) {
   if (rc == 1) {
     state_ = Ssl::SocketState::HandshakeComplete;
     handshake_callbacks_->onSuccess(ssl());
@@ -232,7 +242,6 @@ Network::PostIoAction SslHandshakerImpl::doHandshake() {
                ? PostIoAction::KeepOpen
                : PostIoAction::Close;
   } else {
-    int err = SSL_get_error(ssl(), rc);
     ENVOY_CONN_LOG(trace, "ssl error occurred while read: {}", handshake_callbacks_->connection(),
                    Utility::getErrorDescription(err));
     switch (err) {
@@ -240,6 +249,7 @@ Network::PostIoAction SslHandshakerImpl::doHandshake() {
     case SSL_ERROR_WANT_WRITE:
       return PostIoAction::KeepOpen;
     case SSL_ERROR_WANT_PRIVATE_KEY_OPERATION:
+    case SSL_ERROR_PENDING_SESSION:
       state_ = Ssl::SocketState::HandshakeInProgress;
       return PostIoAction::KeepOpen;
     default:
@@ -249,6 +259,112 @@ Network::PostIoAction SslHandshakerImpl::doHandshake() {
   }
 }
 
+Network::PostIoAction SslHandshakerImpl::offloadHandshake() {
+  if (offloaded_step_ != nullptr) {
+    // The step may not see what made the connection readable or writable.
+    retry_offloaded_step_ = true;
+    return PostIoAction::KeepOpen;
+  }
+
+  offloaded_step_ = std::make_shared<OffloadedHandshakeStep>(
+      *this, handshake_callbacks_->connection().dispatcher());
+  if (!offload_pool_->tryPost([step = offloaded_step_]() { step->run(); })) {
+    offloaded_step_.reset();
+    ENVOY_CONN_LOG(debug, "handshake rejected by the handshake offload pool",
+                   handshake_callbacks_->connection());
+    handshake_callbacks_->onFailure();
+    return PostIoAction::Close;
+  }
+  state_ = Ssl::SocketState::HandshakeInProgress;
+  return PostIoAction::KeepOpen;
+}
+
+void SslHandshakerImpl::cancelOffloadedHandshake() {
+  if (offloaded_step_ != nullptr) {
+    offloaded_step_->cancel();
+    offloaded_step_.reset();
+  }
+}
+
+void SslHandshakerImpl::onOffloadedHandshakeComplete(int rc, int err) {
+  offloaded_step_.reset();
+  const bool retry = retry_offloaded_step_;
+  retry_offloaded_step_ = false;
+  PostIoAction action;
+  if (retry && rc != 1 &&
+      (err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE ||
+       err == SSL_ERROR_WANT_PRIVATE_KEY_OPERATION)) {
+    action = offloadHandshake();
+  } else {
+    action = processHandshakeResult(rc, err);
+  }
+
+  if (action == PostIoAction::Close) {
+    ENVOY_CONN_LOG(debug, "offloaded handshake error", handshake_callbacks_->connection());
+    handshake_callbacks_->connection().close(Network::ConnectionCloseType::FlushWrite);
+  } else if (state_ == Ssl::SocketState::HandshakeComplete &&
+             handshake_callbacks_->transportSocketCallbacks() != nullptr) {
+    // The step may have read application data along with the end of the handshake, which is only
+    // read from the TLS library once the connection reads again.
+    handshake_callbacks_->transportSocketCallbacks()->setTransportSocketIsReadable();
+  }
+}
+
+void OffloadedHandshakeStep::run() {
+  SSL* ssl;
+  {
+    Thread::LockGuard lock(mutex_);
+    if (handshaker_ == nullptr) {
+      // The connection was closed while the step was queued.
+      return;
+    }
+    running_ = true;
+    ssl = handshaker_->ssl();
+  }
+
+  // The connection can't be closed while the step is running, so the SSL object and the socket
+  // aren't used by the worker thread meanwhile.
+  rc_ = SSL_do_handshake(ssl);
+  err_ = rc_ == 1 ? SSL_ERROR_NONE : SSL_get_error(ssl, rc_);
+  const char* file;
+  int line;
+  while (uint32_t packed_error = ERR_get_error_line(&file, &line)) {
+    errors_.push_back({packed_error, file, line});
+  }
+
+  Thread::LockGuard lock(mutex_);
+  running_ = false;
+  not_running_.notifyAll();
+  if (handshaker_ != nullptr) {
+    dispatcher_.post([this_ptr = shared_from_this()]() { this_ptr->complete(); });
+  }
+}
+
+void OffloadedHandshakeStep::cancel() {
+  Thread::LockGuard lock(mutex_);
+  handshaker_ = nullptr;
+  while (running_) {
+    not_running_.wait(mutex_);
+  }
+}
+
+void OffloadedHandshakeStep::complete() {
+  SslHandshakerImpl* handshaker;
+  {
+    Thread::LockGuard lock(mutex_);
+    handshaker = handshaker_;
+  }
+  if (handshaker == nullptr) {
+    // The connection was closed after the completion was posted.
+    return;
+  }
+  for (const Error& error : errors_) {
+    ERR_put_error(ERR_GET_LIB(error.packed_error_), 0, ERR_GET_REASON(error.packed_error_),
+                  error.file_, static_cast<unsigned>(error.line_));
+  }
+  handshaker->onOffloadedHandshakeComplete(rc_, err_);
+}
+
 const std::string& SslHandshakerImpl::serialNumberPeerCertificate() const {
   if (!cached_serial_number_peer_certificate_.empty()) {
     return cached_serial_number_peer_certificate_;
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
+#include "envoy/event/dispatcher.h"
 #include "envoy/network/connection.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/secret/secret_callbacks.h"
+#include "envoy/ssl/handshake_offload.h"
 #include "envoy/ssl/handshaker.h"
 #include "envoy/ssl/private_key/private_key_callbacks.h"
 #include "envoy/ssl/ssl_socket_extended_info.h"
@@ -14,6 +18,7 @@
 #include "envoy/stats/stats_macros.h"
 
 #include "common/common/logger.h"
+#include "common/common/thread.h"
 
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -37,12 +42,60 @@ private:
       Envoy::Ssl::ClientValidationStatus::NotValidated};
 };
 
+class SslHandshakerImpl;
+
+/**
+ * A call to SSL_do_handshake() that runs on a thread of a handshake offload pool, and completes on
+ * the worker thread of its connection.
+ */
+class OffloadedHandshakeStep : public std::enable_shared_from_this<OffloadedHandshakeStep> {
+public:
+  OffloadedHandshakeStep(SslHandshakerImpl& handshaker, Event::Dispatcher& dispatcher)
+      : handshaker_(&handshaker), dispatcher_(dispatcher) {}
+
+  /**
+   * Advances the handshake, and posts the completion of the step to the worker thread unless the
+   * step has been cancelled. Called on a thread of the pool.
+   */
+  void run();
+
+  /**
+   * Stops the step from completing, waiting for it if it is running. Called on the worker thread.
+   */
+  void cancel();
+
+private:
+  // An error of the TLS library, which is moved from the error queue of the thread of the pool to
+  // the one of the worker thread.
+  struct Error {
+    uint32_t packed_error_;
+    const char* file_;
+    int line_;
+  };
+
+  void complete();
+
+  // Only written by run(), and only read after it.
+  int rc_{};
+  int err_{};
+  std::vector<Error> errors_;
+
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar not_running_;
+  SslHandshakerImpl* handshaker_ ABSL_GUARDED_BY(mutex_);
+  bool running_ ABSL_GUARDED_BY(mutex_){};
+  Event::Dispatcher& dispatcher_;
+};
+
+using OffloadedHandshakeStepSharedPtr = std::shared_ptr<OffloadedHandshakeStep>;
+
 class SslHandshakerImpl : public Ssl::ConnectionInfo,
                           public Ssl::Handshaker,
                           protected Logger::Loggable<Logger::Id::connection> {
 public:
   SslHandshakerImpl(bssl::UniquePtr<SSL> ssl, int ssl_extended_socket_info_index,
                     Ssl::HandshakeCallbacks* handshake_callbacks);
+  ~SslHandshakerImpl() override;
 
   // Ssl::ConnectionInfo
   bool peerCertificatePresented() const override;
@@ -74,10 +127,40 @@ public:
   SSL* ssl() const { return ssl_.get(); }
   Ssl::HandshakeCallbacks* handshakeCallbacks() { return handshake_callbacks_; }
 
+  /**
+   * Runs the steps of the handshake on the threads of a pool instead of on the worker thread.
+   * @param pool supplies the pool.
+   */
+  void setHandshakeOffloadPool(Ssl::HandshakeOffloadPoolSharedPtr pool) {
+    offload_pool_ = std::move(pool);
+  }
+
+  /**
+   * Stops the step of the handshake that is offloaded, if any, from completing, waiting for it if
+   * it is running. Called before the connection is closed.
+   */
+  void cancelOffloadedHandshake();
+
+  /**
+   * Processes the result of an offloaded step of the handshake. Called on the worker thread.
+   * @param rc supplies the return value of SSL_do_handshake().
+   * @param err supplies the error of SSL_do_handshake() if it failed.
+   */
+  void onOffloadedHandshakeComplete(int rc, int err);
+
   bssl::UniquePtr<SSL> ssl_;
 
 private:
+  Network::PostIoAction offloadHandshake();
+  Network::PostIoAction processHandshakeResult(int rc, int err);
+
   Ssl::HandshakeCallbacks* handshake_callbacks_;
+  Ssl::HandshakeOffloadPoolSharedPtr offload_pool_;
+  // The step of the handshake running on the offload pool.
+  OffloadedHandshakeStepSharedPtr offloaded_step_;
+  // Whether the connection became readable or writable while the step was running, in which case
+  // it is followed by another one.
+  bool retry_offloaded_step_{};
 
   Ssl::SocketState state_;
   mutable std::vector<std::string> cached_uri_san_local_certificate_;
@@ -9,6 +9,7 @@
 #include "common/runtime/runtime_features.h"
 
 #include "extensions/transport_sockets/tls/io_handle_bio.h"
+#include "extensions/transport_sockets/tls/kernel_tls.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -50,7 +51,7 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
                      const Network::TransportSocketOptionsSharedPtr& transport_socket_options,
                      Ssl::HandshakerFactoryCb handshaker_factory_cb)
     : transport_socket_options_(transport_socket_options),
-      ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)),
+      ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)), record_sizer_(ctx_->recordSizing()),
       info_(std::dynamic_pointer_cast<SslHandshakerImpl>(
           handshaker_factory_cb(ctx_->newSsl(transport_socket_options_.get()),
                                 ctx_->sslExtendedSocketInfoIndex(), this))) {
@@ -59,6 +60,7 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
   } else {
     ASSERT(state == InitialState::Server);
     SSL_set_accept_state(rawSsl());
+    info_->setHandshakeOffloadPool(ctx_->handshakeOffloadPool());
   }
 }
 
@@ -71,6 +73,7 @@ void SslSocket::setTransportSocketCallbacks(Network::TransportSocketCallbacks& c
   for (auto const& provider : ctx_->getPrivateKeyMethodProviders()) {
     provider->registerPrivateKeyMethod(rawSsl(), *this, callbacks_->connection().dispatcher());
   }
+  ctx_->registerSessionCacheLookupCallbacks(rawSsl(), *this, callbacks_->connection().dispatcher());
 
   BIO* bio;
   if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.tls_use_io_handle_bio")) {
@@ -170,7 +173,11 @@ Network::IoResult SslSocket::doRead(Buffer::Instance& read_buffer) {
   return {action, bytes_read, end_stream};
 }
 
-void SslSocket::onPrivateKeyMethodComplete() {
+void SslSocket::onPrivateKeyMethodComplete() { resumeHandshake(); }
+
+void SslSocket::onSessionCacheLookupComplete() { resumeHandshake(); }
+
+void SslSocket::resumeHandshake() {
   ASSERT(isThreadSafe());
   ASSERT(info_->state() == Ssl::SocketState::HandshakeInProgress);
 
@@ -186,6 +193,16 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->enableKernelTlsTx()) {
+    kernel_tls_tx_ = enableKernelTlsTx(ssl, callbacks_->ioHandle());
+    if (kernel_tls_tx_) {
+      ctx_->stats().kernel_tls_tx_enabled_.inc();
+    } else {
+      ctx_->stats().kernel_tls_tx_unsupported_.inc();
+    }
+    ENVOY_CONN_LOG(debug, "kernel TLS transmit offload: {}", callbacks_->connection(),
+                   kernel_tls_tx_);
+  }
   callbacks_->raiseEvent(Network::ConnectionEvent::Connected);
 }
 
@@ -232,12 +249,20 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_tx_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
+  if (write_buffer.length() > 0) {
+    record_sizer_.onWrite(callbacks_->connection().dispatcher().timeSource());
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = record_sizer_.nextRecordSize(write_buffer);
   }
 
   uint64_t total_bytes_written = 0;
@@ -247,7 +272,8 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
 
     // SSL_write() requires that if a previous call returns SSL_ERROR_WANT_WRITE, we need to call
     // it again with the same parameters. This is done by tracking last write size, but not write
-    // data, since linearize() will return the same undrained data anyway.
+    // data, since linearize() will return the same undrained data anyway. The record sizer keeps
+    // linearize() from copying when the front slice of the buffer is large.
     ASSERT(bytes_to_write <= write_buffer.length());
     int rc = SSL_write(rawSsl(), write_buffer.linearize(bytes_to_write), bytes_to_write);
     ENVOY_CONN_LOG(trace, "ssl write returns: {}", callbacks_->connection(), rc);
@@ -255,7 +281,9 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      record_sizer_.onRecordWritten(rc);
+      ctx_->stats().write_record_size_.recordValue(rc);
+      bytes_to_write = record_sizer_.nextRecordSize(write_buffer);
     } else {
       int err = SSL_get_error(rawSsl(), rc);
       ENVOY_CONN_LOG(trace, "ssl error occurred while write: {}", callbacks_->connection(),
@@ -282,12 +310,43 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  // The kernel encrypts the data as it is written to the socket, so it bypasses SSL_write().
+  PostIoAction action = PostIoAction::KeepOpen;
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "kernel tls write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() != Api::IoError::IoErrorCode::Again) {
+        action = PostIoAction::Close;
+      }
+      break;
+    }
+    ENVOY_CONN_LOG(trace, "kernel tls write returns: {}", callbacks_->connection(), result.rc_);
+    total_bytes_written += result.rc_;
+  }
+
+  if (write_buffer.length() == 0 && end_stream) {
+    shutdownSsl();
+  }
+
+  return {action, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
 
 void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
+  if (kernel_tls_tx_) {
+    // The TLS library no longer knows the sequence number of the records written to the socket,
+    // so it can't send the close_notify alert.
+    shutdownBasic();
+    return;
+  }
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
     int rc = SSL_shutdown(rawSsl());
@@ -318,10 +377,16 @@ void SslSocket::shutdownBasic() {
 }
 
 void SslSocket::closeSocket(Network::ConnectionEvent) {
-  // Unregister the SSL connection object from private key method providers.
+  // Wait for the step of the handshake running on a handshake offload thread, if any, as it uses
+  // the SSL connection object and the socket.
+  info_->cancelOffloadedHandshake();
+
+  // Unregister the SSL connection object from private key method providers and from the session
+  // cache lookups of the context.
   for (auto const& provider : ctx_->getPrivateKeyMethodProviders()) {
     provider->unregisterPrivateKeyMethod(rawSsl());
   }
+  ctx_->unregisterSessionCacheLookupCallbacks(rawSsl());
 
   // Attempt to send a shutdown before closing the socket. It's possible this won't go out if
   // there is no room on the socket. We can extend the state machine to handle this at some point
@@ -16,6 +16,7 @@
 #include "common/common/logger.h"
 
 #include "extensions/transport_sockets/tls/context_impl.h"
+#include "extensions/transport_sockets/tls/record_sizer.h"
 #include "extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "extensions/transport_sockets/tls/utility.h"
 
@@ -45,6 +46,7 @@ enum class InitialState { Client, Server };
 
 class SslSocket : public Network::TransportSocket,
                   public Envoy::Ssl::PrivateKeyConnectionCallbacks,
+                  public SessionCacheLookupCallbacks,
                   public Ssl::HandshakeCallbacks,
                   protected Logger::Loggable<Logger::Id::connection> {
 public:
@@ -65,6 +67,8 @@ public:
   bool startSecureTransport() override { return false; }
   // Ssl::PrivateKeyConnectionCallbacks
   void onPrivateKeyMethodComplete() override;
+  // SessionCacheLookupCallbacks
+  void onSessionCacheLookupComplete() override;
   // Ssl::HandshakeCallbacks
   Network::Connection& connection() const override;
   void onSuccess(SSL* ssl) override;
@@ -84,9 +88,11 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  void resumeHandshake();
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
   bool isThreadSafe() const {
     return callbacks_ != nullptr && callbacks_->connection().dispatcher().isThreadSafe();
   }
@@ -95,6 +101,9 @@ private:
   Network::TransportSocketCallbacks* callbacks_{};
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
+  RecordSizer record_sizer_;
+  // Whether the records written to the socket are encrypted by the kernel.
+  bool kernel_tls_tx_{};
   std::string failure_reason_;
 
   SslHandshakerImplSharedPtr info_;
@@ -17,10 +17,15 @@ namespace Tls {
   COUNTER(fail_verify_error)                                                                       \
   COUNTER(fail_verify_san)                                                                         \
   COUNTER(fail_verify_cert_hash)                                                                   \
+  COUNTER(cert_verification_cache_hit)                                                             \
+  COUNTER(cert_verification_cache_miss)                                                            \
+  COUNTER(kernel_tls_tx_enabled)                                                                   \
+  COUNTER(kernel_tls_tx_unsupported)                                                               \
   COUNTER(ocsp_staple_failed)                                                                      \
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
-  COUNTER(ocsp_staple_requests)
+  COUNTER(ocsp_staple_requests)                                                                    \
+  HISTOGRAM(write_record_size, Bytes)
 
 /**
  * Wrapper struct for SSL stats. @see stats_macros.h
@@ -0,0 +1,169 @@
+#include "extensions/transport_sockets/tls/tls_material_cache.h"
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+#include "openssl/sha.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+namespace {
+
+// The SHA-256 digest of the given parts, each prefixed by its length so that different parts
+// can't produce the same digest.
+std::string digest(std::initializer_list<absl::string_view> parts) {
+  SHA256_CTX sha256;
+  SHA256_Init(&sha256);
+  for (const absl::string_view part : parts) {
+    const uint64_t size = part.size();
+    SHA256_Update(&sha256, &size, sizeof(size));
+    SHA256_Update(&sha256, part.data(), part.size());
+  }
+  std::string result(SHA256_DIGEST_LENGTH, '\0');
+  SHA256_Final(reinterpret_cast<uint8_t*>(&result[0]), &sha256);
+  return result;
+}
+
+bssl::UniquePtr<BIO> memBio(absl::string_view data) {
+  bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(data.data(), data.size()));
+  RELEASE_ASSERT(bio != nullptr, "");
+  return bio;
+}
+
+} // namespace
+
+TlsMaterialCache::CertificateChainConstSharedPtr
+TlsMaterialCache::certificateChain(absl::string_view pem) {
+  const std::string key = digest({pem});
+  absl::MutexLock lock(&mutex_);
+  auto cached = certificate_chains_.find(key);
+  if (cached != nullptr) {
+    return cached;
+  }
+
+  bssl::UniquePtr<BIO> bio = memBio(pem);
+  auto chain = std::make_shared<CertificateChain>();
+  chain->leaf_.reset(PEM_read_bio_X509_AUX(bio.get(), nullptr, nullptr, nullptr));
+  if (chain->leaf_ == nullptr) {
+    return nullptr;
+  }
+  // Read rest of the certificate chain.
+  while (true) {
+    bssl::UniquePtr<X509> cert(PEM_read_bio_X509(bio.get(), nullptr, nullptr, nullptr));
+    if (cert == nullptr) {
+      break;
+    }
+    chain->intermediates_.push_back(std::move(cert));
+  }
+  // Check for EOF.
+  const uint32_t err = ERR_peek_last_error();
+  if (ERR_GET_LIB(err) != ERR_LIB_PEM || ERR_GET_REASON(err) != PEM_R_NO_START_LINE) {
+    return nullptr;
+  }
+  ERR_clear_error();
+
+  certificate_chains_.insert(key, chain);
+  return chain;
+}
+
+TlsMaterialCache::PrivateKeySharedPtr TlsMaterialCache::privateKey(absl::string_view pem,
+                                                                  const std::string& password) {
+  const std::string key = digest({pem, password});
+  absl::MutexLock lock(&mutex_);
+  auto cached = private_keys_.find(key);
+  if (cached != nullptr) {
+    return cached;
+  }
+
+  bssl::UniquePtr<BIO> bio = memBio(pem);
+  EVP_PKEY* pkey = PEM_read_bio_PrivateKey(
+      bio.get(), nullptr, nullptr,
+      !password.empty() ? const_cast<char*>(password.c_str()) : nullptr);
+  if (pkey == nullptr) {
+    return nullptr;
+  }
+  PrivateKeySharedPtr private_key(pkey, EVP_PKEY_free);
+  private_keys_.insert(key, private_key);
+  return private_key;
+}
+
+TlsMaterialCache::TrustStoreConstSharedPtr
+TlsMaterialCache::trustStore(absl::string_view ca_pem, const std::string& ca_path,
+                             absl::string_view crl_pem, const std::string& crl_path,
+                             X509_STORE_CTX_verify_cb verify_cb) {
+  const std::string key =
+      digest({ca_pem, crl_pem,
+              absl::string_view(reinterpret_cast<const char*>(&verify_cb), sizeof(verify_cb))});
+  absl::MutexLock lock(&mutex_);
+  auto cached = trust_stores_.find(key);
+  if (cached != nullptr) {
+    return cached;
+  }
+
+  // Based on BoringSSL's X509_load_cert_crl_file().
+  bssl::UniquePtr<BIO> bio = memBio(ca_pem);
+  bssl::UniquePtr<STACK_OF(X509_INFO)> list(
+      PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+  if (list == nullptr) {
+    throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ", ca_path));
+  }
+
+  auto trust_store = std::make_shared<TrustStore>();
+  trust_store->store_.reset(X509_STORE_new());
+  RELEASE_ASSERT(trust_store->store_ != nullptr, "");
+  X509_STORE* store = trust_store->store_.get();
+  bool has_crl = false;
+  for (const X509_INFO* item : list.get()) {
+    if (item->x509) {
+      X509_STORE_add_cert(store, item->x509);
+      if (trust_store->ca_cert_ == nullptr) {
+        X509_up_ref(item->x509);
+        trust_store->ca_cert_.reset(item->x509);
+      }
+    }
+    if (item->crl) {
+      X509_STORE_add_crl(store, item->crl);
+      has_crl = true;
+    }
+  }
+  if (trust_store->ca_cert_ == nullptr) {
+    throw EnvoyException(absl::StrCat("Failed to load trusted CA certificates from ", ca_path));
+  }
+  if (verify_cb != nullptr) {
+    X509_STORE_set_verify_cb(store, verify_cb);
+  }
+
+  if (!crl_pem.empty()) {
+    bio = memBio(crl_pem);
+    bssl::UniquePtr<STACK_OF(X509_INFO)> crl_list(
+        PEM_X509_INFO_read_bio(bio.get(), nullptr, nullptr, nullptr));
+    if (crl_list == nullptr) {
+      throw EnvoyException(absl::StrCat("Failed to load CRL from ", crl_path));
+    }
+    for (const X509_INFO* item : crl_list.get()) {
+      if (item->crl) {
+        X509_STORE_add_crl(store, item->crl);
+      }
+    }
+    has_crl = true;
+  }
+  if (has_crl) {
+    X509_STORE_set_flags(store, X509_V_FLAG_CRL_CHECK | X509_V_FLAG_CRL_CHECK_ALL);
+  }
+
+  trust_stores_.insert(key, trust_store);
+  return trust_store;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
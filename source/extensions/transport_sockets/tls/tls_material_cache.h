@@ -0,0 +1,114 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+#include "openssl/x509v3.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A content-addressed cache of the certificate chains, private keys and trust stores parsed from
+ * PEM, so that the contexts of the listeners and clusters which use the same secrets share the
+ * parsed objects, instead of each context parsing its own copy. The cache only holds weak
+ * references: the entries live as long as a context uses them. All the methods may be called from
+ * any thread.
+ */
+class TlsMaterialCache {
+public:
+  struct CertificateChain {
+    bssl::UniquePtr<X509> leaf_;
+    std::vector<bssl::UniquePtr<X509>> intermediates_;
+  };
+  using CertificateChainConstSharedPtr = std::shared_ptr<const CertificateChain>;
+
+  struct TrustStore {
+    bssl::UniquePtr<X509_STORE> store_;
+    // The first trusted CA certificate.
+    bssl::UniquePtr<X509> ca_cert_;
+  };
+  using TrustStoreConstSharedPtr = std::shared_ptr<const TrustStore>;
+
+  using PrivateKeySharedPtr = std::shared_ptr<EVP_PKEY>;
+
+  /**
+   * @param pem supplies the PEM encoded certificate chain, the leaf certificate first.
+   * @return the parsed certificate chain, or nullptr if it's invalid, with the errors left in the
+   *         error queue of the SSL library.
+   */
+  CertificateChainConstSharedPtr certificateChain(absl::string_view pem);
+
+  /**
+   * @param pem supplies the PEM encoded private key.
+   * @param password supplies the password of the private key, or empty if it isn't encrypted.
+   * @return the parsed private key, or nullptr if it's invalid, with the errors left in the error
+   *         queue of the SSL library.
+   */
+  PrivateKeySharedPtr privateKey(absl::string_view pem, const std::string& password);
+
+  /**
+   * Returns the trust store of the given trusted CAs and revocation lists. The store must not be
+   * modified, since it may be shared by several contexts.
+   * @param ca_pem supplies the PEM encoded trusted CA certificates, and their revocation lists.
+   * @param ca_path supplies the path of the trusted CA certificates, for the error messages.
+   * @param crl_pem supplies the PEM encoded certificate revocation lists, which may be empty.
+   * @param crl_path supplies the path of the certificate revocation lists, for the error messages.
+   * @param verify_cb supplies the verification callback of the store, which may be nullptr.
+   * @return the trust store.
+   * @throw EnvoyException if the trusted CA certificates or the revocation lists are invalid.
+   */
+  TrustStoreConstSharedPtr trustStore(absl::string_view ca_pem, const std::string& ca_path,
+                                      absl::string_view crl_pem, const std::string& crl_path,
+                                      X509_STORE_CTX_verify_cb verify_cb);
+
+private:
+  // Weak references to the parsed objects, by the digest of their content.
+  template <class T> class Entries {
+  public:
+    std::shared_ptr<T> find(const std::string& digest) const {
+      const auto it = entries_.find(digest);
+      return it != entries_.end() ? it->second.lock() : nullptr;
+    }
+
+    void insert(const std::string& digest, const std::shared_ptr<T>& value) {
+      // The expired entries are swept once the entries doubled since the last sweep, so that
+      // sweeping stays linear in the number of insertions.
+      if (entries_.size() >= sweep_size_) {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+          if (it->second.expired()) {
+            entries_.erase(it++);
+          } else {
+            ++it;
+          }
+        }
+        sweep_size_ = std::max<size_t>(MinSweepSize, entries_.size() * 2);
+      }
+      entries_[digest] = value;
+    }
+
+  private:
+    static constexpr size_t MinSweepSize = 16;
+
+    absl::flat_hash_map<std::string, std::weak_ptr<T>> entries_;
+    size_t sweep_size_{MinSweepSize};
+  };
+
+  absl::Mutex mutex_;
+  Entries<const CertificateChain> certificate_chains_ ABSL_GUARDED_BY(mutex_);
+  Entries<EVP_PKEY> private_keys_ ABSL_GUARDED_BY(mutex_);
+  Entries<const TrustStore> trust_stores_ ABSL_GUARDED_BY(mutex_);
+};
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
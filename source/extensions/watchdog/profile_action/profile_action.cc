@@ -2,9 +2,11 @@
 
 #include <chrono>
 
+#include "envoy/filesystem/filesystem.h"
 #include "envoy/thread/thread.h"
 
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 #include "common/protobuf/utility.h"
 #include "common/stats/symbol_table_impl.h"
 
@@ -91,6 +93,15 @@ void ProfileAction::run(
   // Generate file path for output and try to profile
   profile_filename_ = generateProfileFilePath(path_, context_.api_.timeSource());
 
+  if (Profiler::Sampling::isProfilerStarted()) {
+    // The recent samples of the sampling profiler already cover the time before the event.
+    ++profiles_started_;
+    if (writeSamplingProfile()) {
+      profiles_successfully_captured_.inc();
+    }
+    return;
+  }
+
   if (!Profiler::Cpu::profilerEnabled()) {
     if (Profiler::Cpu::startProfiler(profile_filename_)) {
       // Update state
@@ -107,6 +118,25 @@ void ProfileAction::run(
   }
 }
 
+bool ProfileAction::writeSamplingProfile() {
+  const std::string profile = Profiler::Sampling::profile();
+  Filesystem::FilePtr file = context_.api_.fileSystem().createFile(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, profile_filename_});
+  static constexpr Filesystem::FlagSet flags{1 << Filesystem::File::Operation::Write |
+                                             1 << Filesystem::File::Operation::Create};
+  if (!file->open(flags).rc_) {
+    ENVOY_LOG_MISC(error, "Profile Action unable to open {}.", profile_filename_);
+    return false;
+  }
+  const bool written = file->write(profile).rc_ == static_cast<ssize_t>(profile.size());
+  if (!file->close().rc_ || !written) {
+    ENVOY_LOG_MISC(error, "Profile Action unable to write the sampling profile to {}.",
+                   profile_filename_);
+    return false;
+  }
+  return true;
+}
+
 } // namespace ProfileAction
 } // namespace Watchdog
 } // namespace Extensions
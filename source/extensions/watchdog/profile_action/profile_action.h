@@ -14,7 +14,8 @@ namespace Watchdog {
 namespace ProfileAction {
 
 /**
- * A GuardDogAction that will start CPU profiling.
+ * A GuardDogAction that will start CPU profiling, or write the recent samples of the sampling
+ * profiler when it's running.
  */
 class ProfileAction : public Server::Configuration::GuardDogAction {
 public:
@@ -26,6 +27,9 @@ public:
            MonotonicTime now) override;
 
 private:
+  // Writes the recent samples of the sampling profiler to profile_filename_.
+  bool writeSamplingProfile();
+
   const std::string path_;
   const std::chrono::milliseconds duration_;
   const uint64_t max_profiles_;
@@ -1,7 +1,12 @@
 #include "server/active_raw_udp_listener_config.h"
 
+#if defined(__linux__)
+#include <linux/filter.h>
+#endif
+
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "server/active_udp_listener.h"
 #include "server/connection_handler_impl.h"
@@ -17,8 +22,81 @@ ActiveRawUdpListenerFactory::createActiveUdpListener(uint32_t worker_index,
                                                      Network::UdpConnectionHandler& parent,
                                                      Event::Dispatcher& dispatcher,
                                                      Network::ListenerConfig& config) {
-  return std::make_unique<ActiveRawUdpListener>(worker_index, concurrency_, parent, dispatcher,
-                                                config);
+  Network::SocketSharedPtr listen_socket = config.listenSocketFactory().getListenSocket();
+  if (concurrency_ > 1 && config.udpListenerConfig()->config().route_by_source_address()) {
+    // The program is shared by all sockets in the SO_REUSEPORT group, so it only needs to be
+    // attached to one of them.
+    absl::call_once(install_bpf_once_, [this, &listen_socket]() {
+      if (listen_socket != nullptr) {
+        installSteeringProgram(*listen_socket);
+      }
+    });
+  }
+  return std::make_unique<ActiveRawUdpListener>(worker_index, concurrency_, parent, listen_socket,
+                                                dispatcher, config);
+}
+
+void ActiveRawUdpListenerFactory::installSteeringProgram(Network::Socket& socket) {
+#if defined(SO_ATTACH_REUSEPORT_CBPF) && defined(__linux__)
+  // This BPF filter computes ActiveRawUdpListener::sourceAddressHash() from the IP and UDP headers
+  // and mods it by the number of workers to get the socket index in the SO_REUSEPORT socket group.
+  // IPv6 extension headers aren't skipped, so such datagrams are steered by the wrong port and
+  // then forwarded to the right worker. Datagrams that are neither IPv4 nor IPv6 are dispatched
+  // based on the receive hash.
+  // SPELLCHECKER(off)
+  std::vector<sock_filter> filter = {
+      BPF_STMT(BPF_LD | BPF_B | BPF_ABS, SKF_NET_OFF),          //       ldb [net]
+      BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 4),                   //       rsh #4
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 4, 0, 6),             //       jne #4, ipv6
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 12),     //       ld [net + 12]
+      BPF_STMT(BPF_ST, 0),                                      //       st M[0]
+      BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, SKF_NET_OFF),         //       ldxb 4 * ([net] & 0xf)
+      BPF_STMT(BPF_LD | BPF_H | BPF_IND, SKF_NET_OFF),          //       ldh [x + net]
+      BPF_STMT(BPF_LDX | BPF_MEM, 0),                           //       ldx M[0]
+      BPF_STMT(BPF_JMP | BPF_JA, 14),                           //       ja hash
+      BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 6, 0, 20),            // ipv6: jne #6, other
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 8),      //       ld [net + 8]
+      BPF_STMT(BPF_MISC | BPF_TAX, 0),                          //       tax
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 12),     //       ld [net + 12]
+      BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),                   //       xor x
+      BPF_STMT(BPF_MISC | BPF_TAX, 0),                          //       tax
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 16),     //       ld [net + 16]
+      BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),                   //       xor x
+      BPF_STMT(BPF_MISC | BPF_TAX, 0),                          //       tax
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_NET_OFF + 20),     //       ld [net + 20]
+      BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),                   //       xor x
+      BPF_STMT(BPF_ST, 0),                                      //       st M[0]
+      BPF_STMT(BPF_LD | BPF_H | BPF_ABS, SKF_NET_OFF + 40),     //       ldh [net + 40]
+      BPF_STMT(BPF_LDX | BPF_MEM, 0),                           //       ldx M[0]
+      BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),                   // hash: xor x
+      BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9e3779b1),          //       mul #0x9e3779b1
+      BPF_STMT(BPF_MISC | BPF_TAX, 0),                          //       tax
+      BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16),                  //       rsh #16
+      BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0),                   //       xor x
+      BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, concurrency_),        //       mod #socket_count
+      BPF_STMT(BPF_RET | BPF_A, 0),                             //       ret a
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, SKF_AD_OFF + SKF_AD_RXHASH), // other: ld rxhash
+      BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, concurrency_),        //       mod #socket_count
+      BPF_STMT(BPF_RET | BPF_A, 0),                             //       ret a
+  };
+  // SPELLCHECKER(on)
+  sock_fprog prog;
+  prog.len = filter.size();
+  prog.filter = filter.data();
+  const Api::SysCallIntResult result =
+      socket.setSocketOption(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+  if (result.rc_ != 0) {
+    ENVOY_LOG(warn,
+              "Failed to attach the UDP steering program to {} (errno {}). Datagrams will be "
+              "forwarded to the worker that owns their source address.",
+              socket.addressProvider().localAddress()->asString(), result.errno_);
+  }
+#else
+  UNREFERENCED_PARAMETER(socket);
+  ENVOY_LOG(warn, "Steering UDP datagrams by source address in the kernel is not supported on "
+                  "this platform. Datagrams will be forwarded to the worker that owns their "
+                  "source address.");
+#endif
 }
 
 } // namespace Server
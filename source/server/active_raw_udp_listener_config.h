@@ -2,10 +2,15 @@
 
 #include "envoy/network/connection_handler.h"
 
+#include "common/common/logger.h"
+
+#include "absl/base/call_once.h"
+
 namespace Envoy {
 namespace Server {
 
-class ActiveRawUdpListenerFactory : public Network::ActiveUdpListenerFactory {
+class ActiveRawUdpListenerFactory : public Network::ActiveUdpListenerFactory,
+                                    Logger::Loggable<Logger::Id::udp> {
 public:
   ActiveRawUdpListenerFactory(uint32_t concurrency);
 
@@ -16,7 +21,10 @@ public:
   bool isTransportConnectionless() const override { return true; }
 
 private:
+  void installSteeringProgram(Network::Socket& socket);
+
   const uint32_t concurrency_;
+  absl::once_flag install_bpf_once_;
 };
 
 } // namespace Server
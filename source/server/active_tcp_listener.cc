@@ -375,12 +375,51 @@ void ActiveTcpListener::post(Network::ConnectionSocketPtr&& socket) {
                              handoff = config_->handOffRestoredDestinationConnections()]() {
     auto balanced_handler = parent.getBalancedHandlerByTag(tag);
     if (balanced_handler.has_value()) {
-      balanced_handler->get().onAcceptWorker(std::move(socket_to_rebalance->socket), handoff, true);
+      // Balanced handlers are always TCP listeners, see getBalancedHandlerByTag().
+      static_cast<ActiveTcpListener&>(balanced_handler->get())
+          .onQueuedAccept(std::move(socket_to_rebalance->socket), handoff);
       return;
     }
   });
 }
 
+void ActiveTcpListener::onQueuedAccept(Network::ConnectionSocketPtr&& socket,
+                                       bool hand_off_restored_destination_connections) {
+  Network::BalancedConnectionHandler& target_handler =
+      config_->connectionBalancer().pickQueuedTargetHandler(*this);
+  if (&target_handler != this) {
+    decNumConnections();
+    target_handler.incNumConnections();
+    target_handler.post(std::move(socket));
+    return;
+  }
+  onAcceptWorker(std::move(socket), hand_off_restored_destination_connections, true);
+}
+
+void ActiveTcpListener::handOverConnections(std::vector<Network::ConnectionSocketPtr>& sockets) {
+  std::vector<Network::Connection*> handed_over;
+  for (const auto& filter_chain_and_connections : connections_by_context_) {
+    for (const auto& active_connection : filter_chain_and_connections.second->connections_) {
+      Network::ConnectionSocketPtr socket = active_connection->connection_->handOver();
+      if (socket != nullptr) {
+        sockets.push_back(std::move(socket));
+        handed_over.push_back(active_connection->connection_.get());
+      }
+    }
+  }
+  // Closing a connection removes it from its list, but the deletion of the connection is deferred.
+  for (Network::Connection* connection : handed_over) {
+    connection->close(Network::ConnectionCloseType::NoFlush);
+  }
+}
+
+void ActiveTcpListener::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  // The connection isn't balanced again, it is counted like an accepted one.
+  incNumConnections();
+  auto active_socket = std::make_unique<ActiveTcpSocket>(*this, std::move(socket), false);
+  active_socket->newConnection();
+}
+
 ActiveConnections::ActiveConnections(ActiveTcpListener& listener,
                                      const Network::FilterChain& filter_chain)
     : listener_(listener), filter_chain_(filter_chain) {}
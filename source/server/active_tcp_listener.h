@@ -67,10 +67,20 @@ public:
     ++num_listener_connections_;
     config_->openConnections().inc();
   }
+  absl::optional<double> loopUtilization() const override {
+    return parent_.dispatcher().loopUtilization();
+  }
   void post(Network::ConnectionSocketPtr&& socket) override;
   void onAcceptWorker(Network::ConnectionSocketPtr&& socket,
                       bool hand_off_restored_destination_connections, bool rebalanced) override;
 
+  /**
+   * Accept a connection that was posted to this listener by another worker, unless the balancer
+   * moves it on to a less loaded one.
+   */
+  void onQueuedAccept(Network::ConnectionSocketPtr&& socket,
+                      bool hand_off_restored_destination_connections);
+
   /**
    * Remove and destroy an active connection.
    * @param connection supplies the connection to remove.
@@ -83,6 +93,18 @@ public:
   void newConnection(Network::ConnectionSocketPtr&& socket,
                      std::unique_ptr<StreamInfo::StreamInfo> stream_info);
 
+  /**
+   * Hand over the connections that another process can continue and close them.
+   * @param sockets supplies the vector the duplicated sockets of the connections are added to.
+   */
+  void handOverConnections(std::vector<Network::ConnectionSocketPtr>& sockets);
+
+  /**
+   * Create a new connection from a socket handed over by another process, skipping the listener
+   * filters.
+   */
+  void adoptConnection(Network::ConnectionSocketPtr&& socket);
+
   /**
    * Return the active connections container attached with the given filter chain.
    */
@@ -1,9 +1,12 @@
 #include "server/active_udp_listener.h"
 
+#include <cstring>
+
 #include "envoy/network/exception.h"
 #include "envoy/server/listener_manager.h"
 #include "envoy/stats/scope.h"
 
+#include "common/common/assert.h"
 #include "common/network/utility.h"
 
 #include "spdlog/spdlog.h"
@@ -97,6 +100,7 @@ ActiveRawUdpListener::ActiveRawUdpListener(uint32_t worker_index, uint32_t concu
                                            Network::ListenerConfig& config)
     : ActiveUdpListenerBase(worker_index, concurrency, parent, listen_socket, std::move(listener),
                             &config),
+      route_by_source_address_(config.udpListenerConfig()->config().route_by_source_address()),
       read_filter_(nullptr) {
   // Create the filter chain on creating a new udp listener
   config_->filterChainFactory().createUdpListenerFilterChain(*this, *this);
@@ -137,5 +141,34 @@ void ActiveRawUdpListener::addReadFilter(Network::UdpListenerReadFilterPtr&& fil
 
 Network::UdpListener& ActiveRawUdpListener::udpListener() { return *udp_listener_; }
 
+uint32_t ActiveRawUdpListener::destination(const Network::UdpRecvData& data) const {
+  const Network::Address::InstanceConstSharedPtr& peer = data.addresses_.peer_;
+  if (!route_by_source_address_ || peer == nullptr || peer->ip() == nullptr) {
+    return ActiveUdpListenerBase::destination(data);
+  }
+  return sourceAddressHash(*peer) % concurrency_;
+}
+
+uint32_t ActiveRawUdpListener::sourceAddressHash(const Network::Address::Instance& address) {
+  ASSERT(address.ip() != nullptr);
+  const Network::Address::Ip& ip = *address.ip();
+  // Fold the address into 32 bits the way the BPF program reads it: as big-endian words.
+  uint32_t hash = ip.port();
+  if (ip.version() == Network::Address::IpVersion::v4) {
+    hash ^= ntohl(ip.ipv4()->address());
+  } else {
+    const absl::uint128 address6 = ip.ipv6()->address();
+    uint32_t words[4];
+    static_assert(sizeof(words) == sizeof(address6), "unexpected IPv6 address size");
+    memcpy(words, &address6, sizeof(words));
+    for (const uint32_t word : words) {
+      hash ^= ntohl(word);
+    }
+  }
+  // Multiplicative mixing, so that neighbouring addresses and ports spread across workers.
+  hash *= 0x9e3779b1;
+  return hash ^ (hash >> 16);
+}
+
 } // namespace Server
 } // namespace Envoy
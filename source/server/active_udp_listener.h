@@ -104,7 +104,21 @@ public:
   // Network::UdpReadFilterCallbacks
   Network::UdpListener& udpListener() override;
 
+  /**
+   * Hashes the IP address and port of a datagram's source. This is what
+   * route_by_source_address steers by, both here and in the kernel, so it must stay in sync with
+   * the program attached by ActiveRawUdpListenerFactory.
+   * @param address the source address, which must be an IP address.
+   * @return the hash of the address.
+   */
+  static uint32_t sourceAddressHash(const Network::Address::Instance& address);
+
+protected:
+  // ActiveUdpListenerBase
+  uint32_t destination(const Network::UdpRecvData& data) const override;
+
 private:
+  const bool route_by_source_address_;
   Network::UdpListenerReadFilterPtr read_filter_;
   Network::UdpPacketWriterPtr udp_packet_writer_;
 };
@@ -172,6 +172,11 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(stats_handler_.handlerContention), false, false},
           {"/cpuprofiler", "enable/disable the CPU profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerCpuProfiler), false, true},
+          {"/cpuprofiler/sampling", "enable/disable the always-on sampling CPU profiler",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerSamplingProfiler), false, true},
+          {"/cpuprofiler/sampling/profile",
+           "download the recent samples of the sampling CPU profiler in pprof format",
+           MAKE_ADMIN_HANDLER(profiling_handler_.handlerSamplingProfile), false, false},
           {"/heapprofiler", "enable/disable the heap profiler",
            MAKE_ADMIN_HANDLER(profiling_handler_.handlerHeapProfiler), false, true},
           {"/healthcheck/fail", "cause the server to fail health checks",
@@ -192,6 +197,11 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(stats_handler_.handlerResetCounters), false, true},
           {"/drain_listeners", "drain listeners",
            MAKE_ADMIN_HANDLER(listeners_handler_.handlerDrainListeners), false, true},
+          {"/slow_callbacks", "print the recent slow dispatcher callbacks",
+           MAKE_ADMIN_HANDLER(server_info_handler_.handlerSlowCallbacks), false, false},
+          {"/slow_callbacks/threshold",
+           "set the duration above which the dispatcher callbacks are recorded as slow",
+           MAKE_ADMIN_HANDLER(server_info_handler_.handlerSlowCallbacksThreshold), false, true},
           {"/server_info", "print server version/status information",
            MAKE_ADMIN_HANDLER(server_info_handler_.handlerServerInfo), false, false},
           {"/ready", "print server state, return 200 if LIVE, otherwise return 503",
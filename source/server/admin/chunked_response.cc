@@ -0,0 +1,103 @@
+#include "server/admin/chunked_response.h"
+
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/schedulable_cb.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/filter.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+/**
+ * Sends the rest of a chunked response on a stream, one chunk per dispatcher iteration, pausing
+ * while the downstream is above its write buffer high watermark.
+ */
+class ChunkedResponseStreamer : public Http::DownstreamWatermarkCallbacks {
+public:
+  explicit ChunkedResponseStreamer(ChunkedResponsePtr&& body) : body_(std::move(body)) {}
+
+  ~ChunkedResponseStreamer() override {
+    if (callbacks_ != nullptr) {
+      callbacks_->removeDownstreamWatermarkCallbacks(*this);
+    }
+  }
+
+  void start(Http::StreamDecoderFilterCallbacks& callbacks) {
+    callbacks_ = &callbacks;
+    next_chunk_cb_ = callbacks_->dispatcher().createSchedulableCallback([this]() { sendChunk(); });
+    // This calls onAboveWriteBufferHighWatermark() right away if the stream is already above it.
+    callbacks_->addDownstreamWatermarkCallbacks(*this);
+    if (high_watermark_count_ == 0) {
+      next_chunk_cb_->scheduleCallbackNextIteration();
+    }
+  }
+
+  /**
+   * Stops sending, as the stream has been destroyed.
+   */
+  void cancel() {
+    if (next_chunk_cb_ != nullptr) {
+      next_chunk_cb_->cancel();
+    }
+    if (callbacks_ != nullptr) {
+      callbacks_->removeDownstreamWatermarkCallbacks(*this);
+      callbacks_ = nullptr;
+    }
+  }
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override {
+    ++high_watermark_count_;
+    next_chunk_cb_->cancel();
+  }
+  void onBelowWriteBufferLowWatermark() override {
+    ASSERT(high_watermark_count_ > 0);
+    if (--high_watermark_count_ == 0) {
+      next_chunk_cb_->scheduleCallbackNextIteration();
+    }
+  }
+
+private:
+  void sendChunk() {
+    Buffer::OwnedImpl chunk;
+    const bool more = body_->nextChunk(chunk);
+    if (more && high_watermark_count_ == 0) {
+      next_chunk_cb_->scheduleCallbackNextIteration();
+    }
+    // This may destroy the stream, and with it this object, if it is the last chunk.
+    callbacks_->encodeData(chunk, !more);
+  }
+
+  ChunkedResponsePtr body_;
+  Http::StreamDecoderFilterCallbacks* callbacks_{};
+  Event::SchedulableCallbackPtr next_chunk_cb_;
+  uint32_t high_watermark_count_{};
+};
+
+} // namespace
+
+void ChunkedResponse::send(ChunkedResponsePtr&& body, Buffer::Instance& response,
+                           AdminStream& admin_stream) {
+  if (!body->nextChunk(response)) {
+    return;
+  }
+  if (!admin_stream.canStreamResponse()) {
+    while (body->nextChunk(response)) {
+    }
+    return;
+  }
+
+  // Send the rest once the headers and the first chunk have been encoded. The streamer lives until
+  // the stream is destroyed.
+  auto streamer = std::make_shared<ChunkedResponseStreamer>(std::move(body));
+  admin_stream.setEndStreamOnComplete(false);
+  streamer->start(admin_stream.getDecoderFilterCallbacks());
+  admin_stream.addOnDestroyCallback([streamer]() { streamer->cancel(); });
+}
+
+} // namespace Server
+} // namespace Envoy
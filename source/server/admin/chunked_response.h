@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/pure.h"
+#include "envoy/server/admin.h"
+
+namespace Envoy {
+namespace Server {
+
+class ChunkedResponse;
+using ChunkedResponsePtr = std::unique_ptr<ChunkedResponse>;
+
+/**
+ * Produces the body of an admin response one chunk at a time, so that large responses don't have
+ * to be assembled in memory before they are sent.
+ */
+class ChunkedResponse {
+public:
+  // Number of bytes a chunk is filled to before it is sent, unless the body ends first.
+  static constexpr uint64_t DefaultChunkSize = 64 * 1024;
+
+  virtual ~ChunkedResponse() = default;
+
+  /**
+   * Adds the next chunk of the body to response.
+   * @return bool whether there are more chunks.
+   */
+  virtual bool nextChunk(Buffer::Instance& response) PURE;
+
+  /**
+   * Adds the first chunk of body to response, and if there is more, sends the rest on the admin
+   * stream after the handler returns, one chunk per dispatcher iteration so that other events on
+   * the main thread are handled in between. Sending pauses while the downstream connection is
+   * above its write buffer high watermark. If the admin stream can't stream the response, e.g.
+   * for AdminImpl::request(), the whole body is added to response instead.
+   * @param body supplies the body to send.
+   * @param response supplies the buffer that the handler returns the response in.
+   * @param admin_stream supplies the stream of the admin request.
+   */
+  static void send(ChunkedResponsePtr&& body, Buffer::Instance& response,
+                   AdminStream& admin_stream);
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -3,12 +3,17 @@
 #include "envoy/config/core/v3/health_check.pb.h"
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 
+#include "common/common/empty_string.h"
+#include "common/common/thread.h"
 #include "common/http/headers.h"
 #include "common/http/utility.h"
 #include "common/network/utility.h"
 
+#include "server/admin/chunked_response.h"
 #include "server/admin/utils.h"
 
+#include "absl/strings/str_replace.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -112,6 +117,110 @@ bool shouldIncludeEdsInDump(const Http::Utility::QueryParams& params) {
   return Utility::queryParam(params, "include_eds") != absl::nullopt;
 }
 
+// Helper method to get the name_regex parameter. Returns false if the regex is invalid.
+bool nameRegexParam(const Http::Utility::QueryParams& params, Buffer::Instance& response,
+                    absl::optional<std::regex>& regex) {
+  const auto pattern = Utility::queryParam(params, "name_regex");
+  if (pattern.has_value()) {
+    TRY_ASSERT_MAIN_THREAD { regex = std::regex(pattern.value()); }
+    END_TRY
+    catch (std::regex_error& error) {
+      response.add(fmt::format("Invalid name_regex: \"{}\"\n", error.what()));
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the name of a config dump resource, e.g. of a DynamicListener, or if it has no name
+// field of its own, of the resource packed in its Any field, e.g. the cluster of a StaticCluster.
+std::string resourceName(const Protobuf::Message& message) {
+  const Protobuf::Descriptor* descriptor = message.GetDescriptor();
+  const Protobuf::Reflection* reflection = message.GetReflection();
+  for (const char* name_field : {"name", "cluster_name"}) {
+    const Protobuf::FieldDescriptor* field = descriptor->FindFieldByName(name_field);
+    if (field != nullptr && !field->is_repeated() &&
+        field->type() == Protobuf::FieldDescriptor::TYPE_STRING) {
+      return reflection->GetString(message, field);
+    }
+  }
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const Protobuf::FieldDescriptor* field = descriptor->field(i);
+    if (field->message_type() != nullptr && !field->is_repeated() &&
+        field->message_type()->full_name() == "google.protobuf.Any" &&
+        reflection->HasField(message, field)) {
+      ProtobufWkt::Any any_message;
+      any_message.MergeFrom(reflection->GetMessage(message, field));
+      const std::string inner_type_name{
+          TypeUtil::typeUrlToDescriptorFullName(any_message.type_url())};
+      const Protobuf::Descriptor* inner_descriptor =
+          Protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(inner_type_name);
+      if (inner_descriptor == nullptr) {
+        continue;
+      }
+      Protobuf::DynamicMessageFactory dmf;
+      std::unique_ptr<Protobuf::Message> inner_message(dmf.GetPrototype(inner_descriptor)->New());
+      if (any_message.UnpackTo(inner_message.get())) {
+        return resourceName(*inner_message);
+      }
+    }
+  }
+  return EMPTY_STRING;
+}
+
+/**
+ * Streams a ConfigDump one config at a time. The output is the same as serializing the whole
+ * ConfigDump with pretty printing, but at most one config and its JSON are held at a time, on top
+ * of whatever the next config function holds.
+ */
+class ConfigDumpResponse : public ChunkedResponse {
+public:
+  // Sets config to the next config of the dump. Returns false if there are no more.
+  using NextConfigFn = std::function<bool(ProtobufWkt::Any& config)>;
+
+  explicit ConfigDumpResponse(NextConfigFn next_config) : next_config_(std::move(next_config)) {}
+
+  // ChunkedResponse
+  bool nextChunk(Buffer::Instance& response) override {
+    std::string output;
+    while (!done_ && output.size() < DefaultChunkSize) {
+      ProtobufWkt::Any config;
+      if (!next_config_(config)) {
+        done_ = true;
+        if (configs_ == 0) {
+          // The configs field isn't printed at all if it is empty.
+          output = MessageUtil::getJsonStringFromMessageOrError(envoy::admin::v3::ConfigDump(),
+                                                                true);
+        } else {
+          output.append("\n ]\n}\n");
+        }
+        break;
+      }
+      auto json_or_error = MessageUtil::getJsonStringFromMessage(config, true);
+      if (!json_or_error.ok()) {
+        // Like a failure to serialize the whole dump, this ends the response with the error.
+        done_ = true;
+        absl::StrAppend(&output, configs_ == 0 ? "" : "\n",
+                        "Failed to convert protobuf message to JSON string: ",
+                        json_or_error.status().ToString());
+        break;
+      }
+      // Indent the config as an element of the configs array of the ConfigDump. JSON strings can't
+      // contain raw newlines, so every newline is a line break of the pretty printer.
+      absl::StrAppend(&output, configs_++ == 0 ? "{\n \"configs\": [\n" : ",\n", "  ",
+                      absl::StrReplaceAll(absl::StripSuffix(json_or_error.value(), "\n"),
+                                          {{"\n", "\n  "}}));
+    }
+    response.add(output);
+    return !done_;
+  }
+
+private:
+  NextConfigFn next_config_;
+  uint64_t configs_{};
+  bool done_{};
+};
+
 } // namespace
 
 ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Instance& server)
@@ -119,34 +228,37 @@ ConfigDumpHandler::ConfigDumpHandler(ConfigTracker& config_tracker, Server::Inst
 
 Http::Code ConfigDumpHandler::handlerConfigDump(absl::string_view url,
                                                 Http::ResponseHeaderMap& response_headers,
-                                                Buffer::Instance& response, AdminStream&) const {
+                                                Buffer::Instance& response,
+                                                AdminStream& admin_stream) const {
   Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
   const auto resource = resourceParam(query_params);
   const auto mask = maskParam(query_params);
   const bool include_eds = shouldIncludeEdsInDump(query_params);
+  absl::optional<std::regex> name_regex;
+  if (!nameRegexParam(query_params, response, name_regex)) {
+    return Http::Code::BadRequest;
+  }
 
-  envoy::admin::v3::ConfigDump dump;
-
+  ChunkedResponsePtr dump;
   if (resource.has_value()) {
-    auto err = addResourceToDump(dump, mask, resource.value(), include_eds);
+    auto err = resourceDump(resource.value(), mask, name_regex, include_eds, dump);
     if (err.has_value()) {
       response.add(err.value().second);
       return err.value().first;
     }
+  } else if (name_regex.has_value()) {
+    response.add("name_regex can only be used with resource\n");
+    return Http::Code::BadRequest;
   } else {
-    addAllConfigToDump(dump, mask, include_eds);
+    dump = allConfigDump(mask, include_eds);
   }
-  MessageUtil::redact(dump);
 
   response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
-  response.add(MessageUtil::getJsonStringFromMessageOrError(dump, true)); // pretty-print
+  ChunkedResponse::send(std::move(dump), response, admin_stream);
   return Http::Code::OK;
 }
 
-absl::optional<std::pair<Http::Code, std::string>>
-ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
-                                     const absl::optional<std::string>& mask,
-                                     const std::string& resource, bool include_eds) const {
+ConfigTracker::CbsMap ConfigDumpHandler::callbacksMap(bool include_eds) const {
   Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
   if (include_eds) {
     // TODO(mattklein123): Add ability to see warming clusters in admin output.
@@ -155,14 +267,20 @@ ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
       callbacks_map.emplace("endpoint", [this] { return dumpEndpointConfigs(); });
     }
   }
+  return callbacks_map;
+}
 
-  for (const auto& [name, callback] : callbacks_map) {
+absl::optional<std::pair<Http::Code, std::string>>
+ConfigDumpHandler::resourceDump(const std::string& resource,
+                                const absl::optional<std::string>& mask,
+                                const absl::optional<std::regex>& name_regex, bool include_eds,
+                                ChunkedResponsePtr& dump) const {
+  for (const auto& [name, callback] : callbacksMap(include_eds)) {
     UNREFERENCED_PARAMETER(name);
     ProtobufTypes::MessagePtr message = callback();
     ASSERT(message);
 
     auto field_descriptor = message->GetDescriptor()->FindFieldByName(resource);
-    const Protobuf::Reflection* reflection = message->GetReflection();
     if (!field_descriptor) {
       continue;
     } else if (!field_descriptor->is_repeated()) {
@@ -172,16 +290,32 @@ ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
                       field_descriptor->name(), field_descriptor->name()))};
     }
 
-    auto repeated = reflection->GetRepeatedPtrField<Protobuf::Message>(*message, field_descriptor);
-    for (Protobuf::Message& msg : repeated) {
-      if (mask.has_value()) {
-        Protobuf::FieldMask field_mask;
-        ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-        trimResourceMessage(field_mask, msg);
-      }
-      auto* config = dump.add_configs();
-      config->PackFrom(msg);
+    absl::optional<Protobuf::FieldMask> field_mask;
+    if (mask.has_value()) {
+      field_mask.emplace();
+      ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask.value());
     }
+    // Resources are filtered, trimmed and packed one at a time, as the response is sent.
+    dump = std::make_unique<ConfigDumpResponse>(
+        [message = std::shared_ptr<Protobuf::Message>(std::move(message)), field_descriptor,
+         field_mask, name_regex, index = 0](ProtobufWkt::Any& config) mutable {
+          const Protobuf::Reflection* reflection = message->GetReflection();
+          while (index < reflection->FieldSize(*message, field_descriptor)) {
+            Protobuf::Message* msg =
+                reflection->MutableRepeatedMessage(message.get(), field_descriptor, index++);
+            if (name_regex.has_value() &&
+                !std::regex_search(resourceName(*msg), name_regex.value())) {
+              continue;
+            }
+            if (field_mask.has_value()) {
+              trimResourceMessage(field_mask.value(), *msg);
+            }
+            MessageUtil::redact(*msg);
+            config.PackFrom(*msg);
+            return true;
+          }
+          return false;
+        });
 
     // We found the desired resource so there is no need to continue iterating over
     // the other keys.
@@ -192,34 +326,44 @@ ConfigDumpHandler::addResourceToDump(envoy::admin::v3::ConfigDump& dump,
       std::make_pair(Http::Code::NotFound, fmt::format("{} not found in config dump", resource))};
 }
 
-void ConfigDumpHandler::addAllConfigToDump(envoy::admin::v3::ConfigDump& dump,
-                                           const absl::optional<std::string>& mask,
-                                           bool include_eds) const {
-  Envoy::Server::ConfigTracker::CbsMap callbacks_map = config_tracker_.getCallbacksMap();
-  if (include_eds) {
-    // TODO(mattklein123): Add ability to see warming clusters in admin output.
-    auto all_clusters = server_.clusterManager().clusters();
-    if (!all_clusters.active_clusters_.empty()) {
-      callbacks_map.emplace("endpoint", [this] { return dumpEndpointConfigs(); });
-    }
+ChunkedResponsePtr ConfigDumpHandler::allConfigDump(const absl::optional<std::string>& mask,
+                                                    bool include_eds) const {
+  std::vector<std::string> keys;
+  for (const auto& [name, callback] : callbacksMap(include_eds)) {
+    UNREFERENCED_PARAMETER(callback);
+    keys.push_back(name);
+  }
+  absl::optional<Protobuf::FieldMask> field_mask;
+  if (mask.has_value()) {
+    field_mask.emplace();
+    ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask.value());
   }
 
-  for (const auto& [name, callback] : callbacks_map) {
-    UNREFERENCED_PARAMETER(name);
-    ProtobufTypes::MessagePtr message = callback();
-    ASSERT(message);
-
-    if (mask.has_value()) {
-      Protobuf::FieldMask field_mask;
-      ProtobufUtil::FieldMaskUtil::FromString(mask.value(), &field_mask);
-      // We don't use trimMessage() above here since masks don't support
-      // indexing through repeated fields.
-      ProtobufUtil::FieldMaskUtil::TrimMessage(field_mask, message.get());
-    }
+  // Each config is only dumped when it is its turn to be sent. Its callback is looked up again at
+  // that point, as its owner may have been destroyed in the meantime.
+  return std::make_unique<ConfigDumpResponse>(
+      [this, keys = std::move(keys), field_mask, include_eds,
+       index = size_t(0)](ProtobufWkt::Any& config) mutable {
+        while (index < keys.size()) {
+          const ConfigTracker::CbsMap callbacks_map = callbacksMap(include_eds);
+          const auto it = callbacks_map.find(keys[index++]);
+          if (it == callbacks_map.end()) {
+            continue;
+          }
+          ProtobufTypes::MessagePtr message = it->second();
+          ASSERT(message);
 
-    auto* config = dump.add_configs();
-    config->PackFrom(*message);
-  }
+          if (field_mask.has_value()) {
+            // We don't use trimResourceMessage() here since masks don't support
+            // indexing through repeated fields.
+            ProtobufUtil::FieldMaskUtil::TrimMessage(field_mask.value(), message.get());
+          }
+          MessageUtil::redact(*message);
+          config.PackFrom(*message);
+          return true;
+        }
+        return false;
+      });
 }
 
 ProtobufTypes::MessagePtr ConfigDumpHandler::dumpEndpointConfigs() const {
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <regex>
+
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/buffer/buffer.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
@@ -9,6 +11,7 @@
 #include "envoy/server/admin.h"
 #include "envoy/server/instance.h"
 
+#include "server/admin/chunked_response.h"
 #include "server/admin/config_tracker_impl.h"
 #include "server/admin/handler_ctx.h"
 
@@ -24,19 +27,27 @@ public:
 
   Http::Code handlerConfigDump(absl::string_view path_and_query,
                                Http::ResponseHeaderMap& response_headers,
-                               Buffer::Instance& response, AdminStream&) const;
+                               Buffer::Instance& response, AdminStream& admin_stream) const;
 
 private:
-  void addAllConfigToDump(envoy::admin::v3::ConfigDump& dump,
-                          const absl::optional<std::string>& mask, bool include_eds) const;
   /**
-   * Add the config matching the passed resource to the passed config dump.
+   * @return the config tracker callbacks, plus one for endpoints if include_eds is set.
+   */
+  ConfigTracker::CbsMap callbacksMap(bool include_eds) const;
+  /**
+   * @return a dump of the configs of all config tracker callbacks.
+   */
+  ChunkedResponsePtr allConfigDump(const absl::optional<std::string>& mask,
+                                   bool include_eds) const;
+  /**
+   * Sets dump to a dump of the resources of the passed type whose names match name_regex, if set.
    * @return absl::nullopt on success, else the Http::Code and an error message that should be added
    * to the admin response.
    */
   absl::optional<std::pair<Http::Code, std::string>>
-  addResourceToDump(envoy::admin::v3::ConfigDump& dump, const absl::optional<std::string>& mask,
-                    const std::string& resource, bool include_eds) const;
+  resourceDump(const std::string& resource, const absl::optional<std::string>& mask,
+               const absl::optional<std::regex>& name_regex, bool include_eds,
+               ChunkedResponsePtr& dump) const;
 
   /**
    * Helper methods to add endpoints config
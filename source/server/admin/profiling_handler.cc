@@ -1,9 +1,12 @@
 #include "server/admin/profiling_handler.h"
 
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 
 #include "server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -20,6 +23,10 @@ Http::Code ProfilingHandler::handlerCpuProfiler(absl::string_view url, Http::Res
 
   bool enable = query_params.begin()->second == "y";
   if (enable && !Profiler::Cpu::profilerEnabled()) {
+    if (Profiler::Sampling::isProfilerStarted()) {
+      response.add("failure to start the profiler: the sampling profiler is running");
+      return Http::Code::BadRequest;
+    }
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
       return Http::Code::InternalServerError;
@@ -80,5 +87,64 @@ Http::Code ProfilingHandler::handlerHeapProfiler(absl::string_view url, Http::Re
   return res;
 }
 
+Http::Code ProfilingHandler::handlerSamplingProfiler(absl::string_view url,
+                                                     Http::ResponseHeaderMap&,
+                                                     Buffer::Instance& response, AdminStream&) {
+  if (!Profiler::Sampling::profilerAvailable()) {
+    response.add("The current platform does not support the sampling profiler");
+    return Http::Code::NotImplemented;
+  }
+
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  const auto enable = query_params.find("enable");
+  const auto frequency = query_params.find("frequency_hz");
+  uint32_t frequency_hz = DefaultSamplingFrequencyHz;
+  if (enable == query_params.end() || (enable->second != "y" && enable->second != "n") ||
+      query_params.size() != (frequency == query_params.end() ? 1 : 2) ||
+      (frequency != query_params.end() && !absl::SimpleAtoi(frequency->second, &frequency_hz))) {
+    response.add("?enable=<y|n>[&frequency_hz=<samples per CPU second>]\n");
+    return Http::Code::BadRequest;
+  }
+
+  if (enable->second == "n") {
+    Profiler::Sampling::stopProfiler();
+  } else {
+    // Restarted to apply the new frequency.
+    Profiler::Sampling::stopProfiler();
+    if (!Profiler::Sampling::startProfiler(frequency_hz)) {
+      response.add("failure to start the sampling profiler");
+      return Http::Code::InternalServerError;
+    }
+  }
+
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
+Http::Code ProfilingHandler::handlerSamplingProfile(absl::string_view url,
+                                                    Http::ResponseHeaderMap& response_headers,
+                                                    Buffer::Instance& response, AdminStream&) {
+  Http::Utility::QueryParams query_params = Http::Utility::parseAndDecodeQueryString(url);
+  absl::optional<int64_t> thread_id;
+  if (!query_params.empty()) {
+    int64_t id;
+    if (query_params.size() != 1 || query_params.begin()->first != "thread_id" ||
+        !absl::SimpleAtoi(query_params.begin()->second, &id)) {
+      response.add("?thread_id=<thread id>\n");
+      return Http::Code::BadRequest;
+    }
+    thread_id = id;
+  }
+
+  const std::string profile = Profiler::Sampling::profile(thread_id);
+  if (profile.empty()) {
+    response.add("The sampling profiler was never started");
+    return Http::Code::NotFound;
+  }
+  response_headers.setContentType("application/octet-stream");
+  response.add(profile);
+  return Http::Code::OK;
+}
+
 } // namespace Server
 } // namespace Envoy
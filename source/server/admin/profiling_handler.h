@@ -23,6 +23,18 @@ public:
                                  Http::ResponseHeaderMap& response_headers,
                                  Buffer::Instance& response, AdminStream&);
 
+  Http::Code handlerSamplingProfiler(absl::string_view path_and_query,
+                                     Http::ResponseHeaderMap& response_headers,
+                                     Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerSamplingProfile(absl::string_view path_and_query,
+                                    Http::ResponseHeaderMap& response_headers,
+                                    Buffer::Instance& response, AdminStream&);
+
+  // The frequency of the sampling profiler when it's enabled without one, low enough to keep it
+  // running at all times.
+  static constexpr uint32_t DefaultSamplingFrequencyHz = 19;
+
 private:
   const std::string profile_path_;
 };
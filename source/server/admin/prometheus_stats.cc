@@ -4,6 +4,7 @@
 #include "common/common/macros.h"
 #include "common/stats/histogram_impl.h"
 
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
 
 namespace Envoy {
@@ -11,7 +12,6 @@ namespace Server {
 
 namespace {
 
-const std::regex& promRegex() { CONSTRUCT_ON_FIRST_USE(std::regex, "[^a-zA-Z0-9_]"); }
 const std::regex& namespaceRegex() {
   CONSTRUCT_ON_FIRST_USE(std::regex, "^[a-zA-Z_][a-zA-Z0-9]*$");
 }
@@ -19,11 +19,18 @@ const std::regex& namespaceRegex() {
 /**
  * Take a string and sanitize it according to Prometheus conventions.
  */
-std::string sanitizeName(const std::string& name) {
+std::string sanitizeName(absl::string_view name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
   // The initial [a-zA-Z_] constraint is always satisfied by the namespace prefix.
-  return std::regex_replace(name, promRegex(), "_");
+  // This runs for every tag of every metric, so avoid std::regex_replace.
+  std::string sanitized(name);
+  for (char& c : sanitized) {
+    if (!absl::ascii_isalnum(c) && c != '_') {
+      c = '_';
+    }
+  }
+  return sanitized;
 }
 
 /*
@@ -48,112 +55,31 @@ struct MetricLessThan {
   }
 };
 
-/**
- * Processes a stat type (counter, gauge, histogram) by generating all output lines, sorting
- * them by tag-extracted metric name, and then outputting them in the correct sorted order into
- * response.
- *
- * @param response The buffer to put the output into.
- * @param used_only Whether to only output stats that are used.
- * @param regex A filter on which stats to output.
- * @param metrics The metrics to output stats for. This must contain all stats of the given type
- *        to be included in the same output.
- * @param generate_output A function which returns the output text for this metric.
- * @param type The name of the prometheus metric type for used in TYPE annotations.
- */
-template <class StatType>
-uint64_t outputStatType(
-    Buffer::Instance& response, const bool used_only, const absl::optional<std::regex>& regex,
-    const std::vector<Stats::RefcountPtr<StatType>>& metrics,
-    const std::function<std::string(
-        const StatType& metric, const std::string& prefixed_tag_extracted_name)>& generate_output,
-    absl::string_view type) {
-
-  /*
-   * From
-   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
-   *
-   * All lines for a given metric must be provided as one single group, with the optional HELP and
-   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
-   * expositions is preferred but not required, i.e. do not sort if the computational cost is
-   * prohibitive.
-   */
-
-  // This is an unsorted collection of dumb-pointers (no need to increment then decrement every
-  // refcount; ownership is held throughout by `metrics`). It is unsorted for efficiency, but will
-  // be sorted before producing the final output to satisfy the "preferred" ordering from the
-  // prometheus spec: metrics will be sorted by their tags' textual representation, which will be
-  // consistent across calls.
-  using StatTypeUnsortedCollection = std::vector<const StatType*>;
-
-  // Return early to avoid crashing when getting the symbol table from the first metric.
-  if (metrics.empty()) {
-    return 0;
-  }
-
-  // There should only be one symbol table for all of the stats in the admin
-  // interface. If this assumption changes, the name comparisons in this function
-  // will have to change to compare to convert all StatNames to strings before
-  // comparison.
-  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
-
-  // Sorted collection of metrics sorted by their tagExtractedName, to satisfy the requirements
-  // of the exposition format.
-  std::map<Stats::StatName, StatTypeUnsortedCollection, Stats::StatNameLessThan> groups(
-      global_symbol_table);
-
-  for (const auto& metric : metrics) {
-    ASSERT(&global_symbol_table == &metric->constSymbolTable());
-
-    if (!shouldShowMetric(*metric, used_only, regex)) {
-      continue;
-    }
-
-    groups[metric->tagExtractedStatName()].push_back(metric.get());
-  }
-
-  for (auto& group : groups) {
-    const std::string prefixed_tag_extracted_name =
-        PrometheusStatsFormatter::metricName(global_symbol_table.toString(group.first));
-    response.add(fmt::format("# TYPE {0} {1}\n", prefixed_tag_extracted_name, type));
-
-    // Sort before producing the final output to satisfy the "preferred" ordering from the
-    // prometheus spec: metrics will be sorted by their tags' textual representation, which will
-    // be consistent across calls.
-    std::sort(group.second.begin(), group.second.end(), MetricLessThan());
-
-    for (const auto& metric : group.second) {
-      response.add(generate_output(*metric, prefixed_tag_extracted_name));
-    }
-    response.add("\n");
-  }
-  return groups.size();
-}
-
 /*
- * Return the prometheus output for a numeric Stat (Counter or Gauge).
+ * Append the prometheus output for a numeric Stat (Counter or Gauge).
  */
 template <class StatType>
-std::string generateNumericOutput(const StatType& metric,
-                                  const std::string& prefixed_tag_extracted_name) {
-  const std::string tags = PrometheusStatsFormatter::formattedTags(metric.tags());
-  return fmt::format("{0}{{{1}}} {2}\n", prefixed_tag_extracted_name, tags, metric.value());
+void appendNumericOutput(const StatType& metric, const std::string& prefixed_tag_extracted_name,
+                         std::string& output) {
+  absl::StrAppend(&output, prefixed_tag_extracted_name, "{",
+                  PrometheusStatsFormatter::formattedTags(metric.tags()), "} ", metric.value(),
+                  "\n");
 }
 
 /*
- * Returns the prometheus output for a histogram. The output is a multi-line string (with embedded
+ * Appends the prometheus output for a histogram. The output is a multi-line string (with embedded
  * newlines) that contains all the individual bucket counts and sum/count for a single histogram
  * (metric_name plus all tags).
  */
-std::string generateHistogramOutput(const Stats::ParentHistogram& histogram,
-                                    const std::string& prefixed_tag_extracted_name) {
+void appendHistogramOutput(const Stats::ParentHistogram& histogram,
+                           const std::string& prefixed_tag_extracted_name, std::string& output) {
   const std::string tags = PrometheusStatsFormatter::formattedTags(histogram.tags());
-  const std::string hist_tags = histogram.tags().empty() ? EMPTY_STRING : (tags + ",");
+  const std::string hist_tags = tags.empty() ? EMPTY_STRING : (tags + ",");
 
   const Stats::HistogramStatistics& stats = histogram.cumulativeStatistics();
   Stats::ConstSupportedBuckets& supported_buckets = stats.supportedBuckets();
   const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
-  std::string output;
+  auto out = std::back_inserter(output);
   for (size_t i = 0; i < supported_buckets.size(); ++i) {
     double bucket = supported_buckets[i];
     uint64_t value = computed_buckets[i];
@@ -162,19 +88,17 @@ std::string generateHistogramOutput(const Stats::ParentHistogram& histogram,
     // 'g' operator which prints the number in general fixed point format or scientific format
     // with precision 50 to round the number up to 32 significant digits in fixed point format
     // which should cover pretty much all cases
-    output.append(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", prefixed_tag_extracted_name,
-                              hist_tags, bucket, value));
+    fmt::format_to(out, "{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", prefixed_tag_extracted_name,
+                   hist_tags, bucket, value);
   }
 
-  output.append(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", prefixed_tag_extracted_name,
-                            hist_tags, stats.sampleCount()));
-  output.append(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", prefixed_tag_extracted_name, tags,
-                            stats.sampleSum()));
-  output.append(fmt::format("{0}_count{{{1}}} {2}\n", prefixed_tag_extracted_name, tags,
-                            stats.sampleCount()));
-
-  return output;
-};
+  fmt::format_to(out, "{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", prefixed_tag_extracted_name, hist_tags,
+                 stats.sampleCount());
+  fmt::format_to(out, "{0}_sum{{{1}}} {2:.32g}\n", prefixed_tag_extracted_name, tags,
+                 stats.sampleSum());
+  fmt::format_to(out, "{0}_count{{{1}}} {2}\n", prefixed_tag_extracted_name, tags,
+                 stats.sampleCount());
+}
 
 absl::flat_hash_set<std::string>& prometheusNamespaces() {
   MUTABLE_CONSTRUCT_ON_FIRST_USE(absl::flat_hash_set<std::string>);
@@ -183,12 +107,12 @@ absl::flat_hash_set<std::string>& prometheusNamespaces() {
 } // namespace
 
 std::string PrometheusStatsFormatter::formattedTags(const std::vector<Stats::Tag>& tags) {
-  std::vector<std::string> buf;
-  buf.reserve(tags.size());
+  std::string formatted;
   for (const Stats::Tag& tag : tags) {
-    buf.push_back(fmt::format("{}=\"{}\"", sanitizeName(tag.name_), tag.value_));
+    absl::StrAppend(&formatted, formatted.empty() ? "" : ",", sanitizeName(tag.name_), "=\"",
+                    tag.value_, "\"");
   }
-  return absl::StrJoin(buf, ",");
+  return formatted;
 }
 
 std::string PrometheusStatsFormatter::metricName(const std::string& extracted_name) {
@@ -207,24 +131,127 @@ std::string PrometheusStatsFormatter::metricName(const std::string& extracted_na
   return absl::StrCat("envoy_", sanitized_name);
 }
 
-// TODO(efimki): Add support of text readouts stats.
-uint64_t PrometheusStatsFormatter::statsAsPrometheus(
+PrometheusStatsRenderer::PrometheusStatsRenderer(
     const std::vector<Stats::CounterSharedPtr>& counters,
     const std::vector<Stats::GaugeSharedPtr>& gauges,
-    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
-    const bool used_only, const absl::optional<std::regex>& regex) {
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, const bool used_only,
+    const absl::optional<std::regex>& regex) {
+  addFamilies(counters, Type::Counter, used_only, regex);
+  addFamilies(gauges, Type::Gauge, used_only, regex);
+  addFamilies(histograms, Type::Histogram, used_only, regex);
+}
 
-  uint64_t metric_name_count = 0;
-  metric_name_count += outputStatType<Stats::Counter>(
-      response, used_only, regex, counters, generateNumericOutput<Stats::Counter>, "counter");
+template <class StatType>
+void PrometheusStatsRenderer::addFamilies(const std::vector<Stats::RefcountPtr<StatType>>& metrics,
+                                          Type type, const bool used_only,
+                                          const absl::optional<std::regex>& regex) {
+  /*
+   * From
+   * https:*github.com/prometheus/docs/blob/master/content/docs/instrumenting/exposition_formats.md#grouping-and-sorting:
+   *
+   * All lines for a given metric must be provided as one single group, with the optional HELP and
+   * TYPE lines first (in no particular order). Beyond that, reproducible sorting in repeated
+   * expositions is preferred but not required, i.e. do not sort if the computational cost is
+   * prohibitive.
+   */
 
-  metric_name_count += outputStatType<Stats::Gauge>(response, used_only, regex, gauges,
-                                                    generateNumericOutput<Stats::Gauge>, "gauge");
+  // Return early to avoid crashing when getting the symbol table from the first metric.
+  if (metrics.empty()) {
+    return;
+  }
 
-  metric_name_count += outputStatType<Stats::ParentHistogram>(
-      response, used_only, regex, histograms, generateHistogramOutput, "histogram");
+  // There should only be one symbol table for all of the stats in the admin
+  // interface. If this assumption changes, the name comparisons in this function
+  // will have to change to compare to convert all StatNames to strings before
+  // comparison.
+  const Stats::SymbolTable& global_symbol_table = metrics.front()->constSymbolTable();
+  symbol_table_ = &global_symbol_table;
+
+  // Metrics grouped by their tagExtractedName, sorted to satisfy the requirements of the
+  // exposition format. The metrics of each family are left unsorted until rendered.
+  std::map<Stats::StatName, std::vector<const Stats::Metric*>, Stats::StatNameLessThan> groups(
+      global_symbol_table);
+  for (const auto& metric : metrics) {
+    ASSERT(&global_symbol_table == &metric->constSymbolTable());
+
+    if (!shouldShowMetric(*metric, used_only, regex)) {
+      continue;
+    }
 
-  return metric_name_count;
+    // These are dumb-pointers (no need to increment then decrement every refcount); ownership is
+    // held by the caller throughout.
+    groups[metric->tagExtractedStatName()].push_back(metric.get());
+  }
+
+  for (auto& group : groups) {
+    families_.push_back({group.first, type, std::move(group.second)});
+  }
+}
+
+bool PrometheusStatsRenderer::nextChunk(Buffer::Instance& response, uint64_t chunk_size) {
+  std::string output;
+  while (next_family_ < families_.size() && output.size() < chunk_size) {
+    renderFamily(families_[next_family_++], output);
+  }
+  response.add(output);
+  return next_family_ < families_.size();
+}
+
+void PrometheusStatsRenderer::renderFamily(Family& family, std::string& output) {
+  const std::string prefixed_tag_extracted_name =
+      PrometheusStatsFormatter::metricName(symbol_table_->toString(family.tag_extracted_name_));
+  absl::StrAppend(&output, "# TYPE ", prefixed_tag_extracted_name, " ", typeName(family.type_),
+                  "\n");
+
+  // Sort before producing the final output to satisfy the "preferred" ordering from the
+  // prometheus spec: metrics will be sorted by their tags' textual representation, which will
+  // be consistent across calls.
+  std::sort(family.metrics_.begin(), family.metrics_.end(), MetricLessThan());
+
+  for (const Stats::Metric* metric : family.metrics_) {
+    switch (family.type_) {
+    case Type::Counter:
+      appendNumericOutput(*static_cast<const Stats::Counter*>(metric), prefixed_tag_extracted_name,
+                          output);
+      break;
+    case Type::Gauge:
+      appendNumericOutput(*static_cast<const Stats::Gauge*>(metric), prefixed_tag_extracted_name,
+                          output);
+      break;
+    case Type::Histogram:
+      appendHistogramOutput(*static_cast<const Stats::ParentHistogram*>(metric),
+                            prefixed_tag_extracted_name, output);
+      break;
+    }
+  }
+  output.append("\n");
+
+  // The metrics of a rendered family aren't needed anymore.
+  family.metrics_ = {};
+}
+
+absl::string_view PrometheusStatsRenderer::typeName(Type type) {
+  switch (type) {
+  case Type::Counter:
+    return "counter";
+  case Type::Gauge:
+    return "gauge";
+  case Type::Histogram:
+    return "histogram";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+// TODO(efimki): Add support of text readouts stats.
+uint64_t PrometheusStatsFormatter::statsAsPrometheus(
+    const std::vector<Stats::CounterSharedPtr>& counters,
+    const std::vector<Stats::GaugeSharedPtr>& gauges,
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
+    const bool used_only, const absl::optional<std::regex>& regex) {
+  PrometheusStatsRenderer renderer(counters, gauges, histograms, used_only, regex);
+  while (renderer.nextChunk(response, PrometheusStatsRenderer::DefaultChunkSize)) {
+  }
+  return renderer.metricNameCount();
 }
 
 bool PrometheusStatsFormatter::registerPrometheusNamespace(absl::string_view prometheus_namespace) {
@@ -2,6 +2,7 @@
 
 #include <regex>
 #include <string>
+#include <vector>
 
 #include "envoy/buffer/buffer.h"
 #include "envoy/stats/histogram.h"
@@ -9,6 +10,54 @@
 
 namespace Envoy {
 namespace Server {
+
+/**
+ * Renders stats in the Prometheus text format a few metric families at a time, so that a large
+ * output can be sent in chunks across dispatcher iterations instead of being built in one go.
+ * The metrics are filtered and grouped into families on construction, and only sorted and
+ * formatted as their family is rendered. The metrics must outlive the renderer.
+ */
+class PrometheusStatsRenderer {
+public:
+  static constexpr uint64_t DefaultChunkSize = 64 * 1024;
+
+  PrometheusStatsRenderer(const std::vector<Stats::CounterSharedPtr>& counters,
+                          const std::vector<Stats::GaugeSharedPtr>& gauges,
+                          const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                          const bool used_only, const absl::optional<std::regex>& regex);
+
+  /**
+   * Renders metric families into response until at least chunk_size bytes have been added or all
+   * families have been rendered.
+   * @return bool whether there are families left to render.
+   */
+  bool nextChunk(Buffer::Instance& response, uint64_t chunk_size);
+
+  /**
+   * @return uint64_t total number of metric families in the output.
+   */
+  uint64_t metricNameCount() const { return families_.size(); }
+
+private:
+  enum class Type { Counter, Gauge, Histogram };
+
+  struct Family {
+    Stats::StatName tag_extracted_name_;
+    Type type_;
+    std::vector<const Stats::Metric*> metrics_;
+  };
+
+  template <class StatType>
+  void addFamilies(const std::vector<Stats::RefcountPtr<StatType>>& metrics, Type type,
+                   const bool used_only, const absl::optional<std::regex>& regex);
+  void renderFamily(Family& family, std::string& output);
+  static absl::string_view typeName(Type type);
+
+  const Stats::SymbolTable* symbol_table_{};
+  std::vector<Family> families_;
+  size_t next_family_{};
+};
+
 /**
  * Formatter for metric/labels exported to Prometheus.
  *
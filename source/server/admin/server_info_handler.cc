@@ -1,12 +1,18 @@
 #include "server/admin/server_info_handler.h"
 
 #include "envoy/admin/v3/memory.pb.h"
+#include "envoy/event/slow_callback_log.h"
 
+#include "common/common/utility.h"
 #include "common/memory/stats.h"
 #include "common/version/version.h"
 
 #include "server/admin/utils.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -56,6 +62,58 @@ Http::Code ServerInfoHandler::handlerMemory(absl::string_view,
   return Http::Code::OK;
 }
 
+namespace {
+
+absl::string_view slowCallbackTypeName(Event::SlowCallback::Type type) {
+  switch (type) {
+  case Event::SlowCallback::Type::Timer:
+    return "timer";
+  case Event::SlowCallback::Type::FileEvent:
+    return "file_event";
+  case Event::SlowCallback::Type::SchedulableCallback:
+    return "schedulable_callback";
+  case Event::SlowCallback::Type::Post:
+    return "post";
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+} // namespace
+
+Http::Code ServerInfoHandler::handlerSlowCallbacks(absl::string_view, Http::ResponseHeaderMap&,
+                                                   Buffer::Instance& response, AdminStream&) {
+  Event::SlowCallbackLog& log = server_.api().slowCallbackLog();
+  response.add(fmt::format("threshold_us: {}\n", log.threshold().count()));
+  for (const Event::SlowCallback& callback : log.recentCallbacks()) {
+    response.add(fmt::format("{} {} {} {}us\n",
+                             AccessLogDateTimeFormatter::fromTime(callback.time_),
+                             callback.dispatcher_name_, slowCallbackTypeName(callback.type_),
+                             callback.duration_.count()));
+    for (absl::string_view line :
+         absl::StrSplit(callback.tracked_object_, '\n', absl::SkipEmpty())) {
+      response.add(absl::StrCat("  ", line, "\n"));
+    }
+  }
+  return Http::Code::OK;
+}
+
+Http::Code ServerInfoHandler::handlerSlowCallbacksThreshold(absl::string_view url,
+                                                            Http::ResponseHeaderMap&,
+                                                            Buffer::Instance& response,
+                                                            AdminStream&) {
+  const Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  const auto threshold = query_params.find("threshold_us");
+  uint64_t threshold_us;
+  if (query_params.size() != 1 || threshold == query_params.end() ||
+      !absl::SimpleAtoi(threshold->second, &threshold_us)) {
+    response.add("usage: /slow_callbacks/threshold?threshold_us=<microseconds> (0 to disable)\n");
+    return Http::Code::BadRequest;
+  }
+  server_.api().slowCallbackLog().setThreshold(std::chrono::microseconds(threshold_us));
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
 Http::Code ServerInfoHandler::handlerReady(absl::string_view, Http::ResponseHeaderMap&,
                                            Buffer::Instance& response, AdminStream&) {
   const envoy::admin::v3::ServerInfo::State state =
@@ -37,6 +37,14 @@ public:
   Http::Code handlerMemory(absl::string_view path_and_query,
                            Http::ResponseHeaderMap& response_headers, Buffer::Instance& response,
                            AdminStream&);
+
+  Http::Code handlerSlowCallbacks(absl::string_view path_and_query,
+                                  Http::ResponseHeaderMap& response_headers,
+                                  Buffer::Instance& response, AdminStream&);
+
+  Http::Code handlerSlowCallbacksThreshold(absl::string_view path_and_query,
+                                           Http::ResponseHeaderMap& response_headers,
+                                           Buffer::Instance& response, AdminStream&);
 };
 
 } // namespace Server
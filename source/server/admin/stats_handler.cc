@@ -7,6 +7,7 @@
 #include "common/http/headers.h"
 #include "common/http/utility.h"
 
+#include "server/admin/chunked_response.h"
 #include "server/admin/prometheus_stats.h"
 #include "server/admin/utils.h"
 
@@ -15,6 +16,76 @@ namespace Server {
 
 const uint64_t RecentLookupsCapacity = 100;
 
+namespace {
+
+/**
+ * Renders a Prometheus response from snapshots of the stats, which keep them alive while the
+ * response is sent.
+ */
+class PrometheusStatsResponse : public ChunkedResponse {
+public:
+  PrometheusStatsResponse(Server::Instance& server, const bool used_only,
+                          const absl::optional<std::regex>& regex)
+      : counters_(server.stats().counters()), gauges_(server.stats().gauges()),
+        histograms_(server.stats().histograms()),
+        renderer_(counters_, gauges_, histograms_, used_only, regex) {}
+
+  // ChunkedResponse
+  bool nextChunk(Buffer::Instance& response) override {
+    return renderer_.nextChunk(response, DefaultChunkSize);
+  }
+
+private:
+  const std::vector<Stats::CounterSharedPtr> counters_;
+  const std::vector<Stats::GaugeSharedPtr> gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  PrometheusStatsRenderer renderer_;
+};
+
+/**
+ * Renders the plain text /stats response. Histogram summaries are only computed when their chunk
+ * is rendered.
+ */
+class TextStatsResponse : public ChunkedResponse {
+public:
+  TextStatsResponse(std::map<std::string, std::string>&& text_readouts,
+                    std::map<std::string, uint64_t>&& all_stats,
+                    std::map<std::string, Stats::ParentHistogramSharedPtr>&& histograms)
+      : text_readouts_(std::move(text_readouts)), all_stats_(std::move(all_stats)),
+        histograms_(std::move(histograms)), text_readout_it_(text_readouts_.begin()),
+        stat_it_(all_stats_.begin()), histogram_it_(histograms_.begin()) {}
+
+  // ChunkedResponse
+  bool nextChunk(Buffer::Instance& response) override {
+    std::string output;
+    for (; text_readout_it_ != text_readouts_.end() && output.size() < DefaultChunkSize;
+         ++text_readout_it_) {
+      absl::StrAppend(&output, text_readout_it_->first, ": \"",
+                      Html::Utility::sanitize(text_readout_it_->second), "\"\n");
+    }
+    for (; stat_it_ != all_stats_.end() && output.size() < DefaultChunkSize; ++stat_it_) {
+      absl::StrAppend(&output, stat_it_->first, ": ", stat_it_->second, "\n");
+    }
+    for (; histogram_it_ != histograms_.end() && output.size() < DefaultChunkSize;
+         ++histogram_it_) {
+      absl::StrAppend(&output, histogram_it_->first, ": ", histogram_it_->second->quantileSummary(),
+                      "\n");
+    }
+    response.add(output);
+    return histogram_it_ != histograms_.end();
+  }
+
+private:
+  const std::map<std::string, std::string> text_readouts_;
+  const std::map<std::string, uint64_t> all_stats_;
+  const std::map<std::string, Stats::ParentHistogramSharedPtr> histograms_;
+  std::map<std::string, std::string>::const_iterator text_readout_it_;
+  std::map<std::string, uint64_t>::const_iterator stat_it_;
+  std::map<std::string, Stats::ParentHistogramSharedPtr>::const_iterator histogram_it_;
+};
+
+} // namespace
+
 StatsHandler::StatsHandler(Server::Instance& server) : HandlerContextBase(server) {}
 
 Http::Code StatsHandler::handlerResetCounters(absl::string_view, Http::ResponseHeaderMap&,
@@ -77,6 +148,11 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
 
   Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseAndDecodeQueryString(url);
+  const auto format_value = Utility::formatParam(params);
+  if (format_value == "prometheus") {
+    // Prometheus output is rendered straight from the stats, without the maps below.
+    return handlerPrometheusStats(url, response_headers, response, admin_stream);
+  }
 
   const bool used_only = params.find("usedonly") != params.end();
   absl::optional<std::regex> regex;
@@ -105,43 +181,36 @@ Http::Code StatsHandler::handlerStats(absl::string_view url,
     }
   }
 
-  if (const auto format_value = Utility::formatParam(params)) {
+  if (format_value.has_value()) {
     if (format_value.value() == "json") {
       response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Json);
       response.add(
           statsAsJson(all_stats, text_readouts, server_.stats().histograms(), used_only, regex));
-    } else if (format_value.value() == "prometheus") {
-      return handlerPrometheusStats(url, response_headers, response, admin_stream);
     } else {
       response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
       response.add("\n");
       rc = Http::Code::NotFound;
     }
   } else { // Display plain stats if format query param is not there.
-    for (const auto& text_readout : text_readouts) {
-      response.add(fmt::format("{}: \"{}\"\n", text_readout.first,
-                               Html::Utility::sanitize(text_readout.second)));
-    }
-    for (const auto& stat : all_stats) {
-      response.add(fmt::format("{}: {}\n", stat.first, stat.second));
-    }
-    std::map<std::string, std::string> all_histograms;
+    std::map<std::string, Stats::ParentHistogramSharedPtr> all_histograms;
     for (const Stats::ParentHistogramSharedPtr& histogram : server_.stats().histograms()) {
       if (shouldShowMetric(*histogram, used_only, regex)) {
-        auto insert = all_histograms.emplace(histogram->name(), histogram->quantileSummary());
+        auto insert = all_histograms.emplace(histogram->name(), histogram);
         ASSERT(insert.second); // No duplicates expected.
       }
     }
-    for (const auto& histogram : all_histograms) {
-      response.add(fmt::format("{}: {}\n", histogram.first, histogram.second));
-    }
+    ChunkedResponse::send(std::make_unique<TextStatsResponse>(std::move(text_readouts),
+                                                              std::move(all_stats),
+                                                              std::move(all_histograms)),
+                          response, admin_stream);
   }
   return rc;
 }
 
 Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query,
                                                 Http::ResponseHeaderMap&,
-                                                Buffer::Instance& response, AdminStream&) {
+                                                Buffer::Instance& response,
+                                                AdminStream& admin_stream) {
   const Http::Utility::QueryParams params =
       Http::Utility::parseAndDecodeQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
@@ -149,9 +218,8 @@ Http::Code StatsHandler::handlerPrometheusStats(absl::string_view path_and_query
   if (!Utility::filterParam(params, response, regex)) {
     return Http::Code::BadRequest;
   }
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only,
-                                              regex);
+  ChunkedResponse::send(std::make_unique<PrometheusStatsResponse>(server_, used_only, regex),
+                        response, admin_stream);
   return Http::Code::OK;
 }
 
@@ -1,6 +1,7 @@
 #include "server/config_validation/cluster_manager.h"
 
 #include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/core/v3/config_source.pb.h"
 
 #include "common/common/utility.h"
@@ -15,6 +16,21 @@ ClusterManagerPtr ValidationClusterManagerFactory::clusterManagerFromProto(
       admin_, validation_context_, api_, http_context_, grpc_context_, router_context_);
 }
 
+std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr>
+ValidationClusterManagerFactory::clusterFromProto(
+    const envoy::config::cluster::v3::Cluster& cluster, ClusterManager& cm,
+    Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api) {
+  if (resource_timings_ == nullptr) {
+    return ProdClusterManagerFactory::clusterFromProto(cluster, cm, outlier_event_logger,
+                                                       added_via_api);
+  }
+  const MonotonicTime start = resource_timings_->start();
+  auto result =
+      ProdClusterManagerFactory::clusterFromProto(cluster, cm, outlier_event_logger, added_via_api);
+  resource_timings_->record("cluster", cluster.name(), start);
+  return result;
+}
+
 CdsApiPtr ValidationClusterManagerFactory::createCds(
     const envoy::config::core::v3::ConfigSource& cds_config,
     const xds::core::v3::ResourceLocator* cds_resources_locator, ClusterManager& cm) {
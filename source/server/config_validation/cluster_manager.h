@@ -9,6 +9,8 @@
 #include "common/http/context_impl.h"
 #include "common/upstream/cluster_manager_impl.h"
 
+#include "server/config_validation/resource_timings.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -28,16 +30,24 @@ public:
       ProtobufMessage::ValidationContext& validation_context, Api::Api& api,
       Http::Context& http_context, Grpc::Context& grpc_context, Router::Context& router_context,
       AccessLog::AccessLogManager& log_manager, Singleton::Manager& singleton_manager,
-      const Server::Options& options)
+      const Server::Options& options,
+      Server::ValidationResourceTimings* resource_timings = nullptr)
       : ProdClusterManagerFactory(admin, runtime, stats, tls, dns_resolver, ssl_context_manager,
                                   main_thread_dispatcher, local_info, secret_manager,
                                   validation_context, api, http_context, grpc_context,
                                   router_context, log_manager, singleton_manager, options),
-        grpc_context_(grpc_context), router_context_(router_context) {}
+        grpc_context_(grpc_context), router_context_(router_context),
+        resource_timings_(resource_timings) {}
 
   ClusterManagerPtr
   clusterManagerFromProto(const envoy::config::bootstrap::v3::Bootstrap& bootstrap) override;
 
+  // Delegates to ProdClusterManagerFactory::clusterFromProto, recording the time spent building the
+  // cluster if the resource timings are given.
+  std::pair<ClusterSharedPtr, ThreadAwareLoadBalancerPtr>
+  clusterFromProto(const envoy::config::cluster::v3::Cluster& cluster, ClusterManager& cm,
+                   Outlier::EventLoggerSharedPtr outlier_event_logger, bool added_via_api) override;
+
   // Delegates to ProdClusterManagerFactory::createCds, but discards the result and returns nullptr
   // unconditionally.
   CdsApiPtr createCds(const envoy::config::core::v3::ConfigSource& cds_config,
@@ -47,6 +57,7 @@ public:
 private:
   Grpc::Context& grpc_context_;
   Router::Context& router_context_;
+  Server::ValidationResourceTimings* const resource_timings_;
 };
 
 /**
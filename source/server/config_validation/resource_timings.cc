@@ -0,0 +1,40 @@
+#include "server/config_validation/resource_timings.h"
+
+#include <algorithm>
+
+namespace Envoy {
+namespace Server {
+
+void ValidationResourceTimings::record(absl::string_view type, absl::string_view name,
+                                       MonotonicTime start) {
+  const auto time =
+      std::chrono::duration_cast<std::chrono::microseconds>(time_source_.monotonicTime() - start);
+  ENVOY_LOG(debug, "built {} '{}' in {}us", type, name, time.count());
+  timings_.push_back({std::string(type), std::string(name), time});
+}
+
+std::vector<ValidationResourceTimings::Timing>
+ValidationResourceTimings::slowest(size_t count) const {
+  std::vector<Timing> slowest(timings_);
+  count = std::min(count, slowest.size());
+  std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+                    [](const Timing& lhs, const Timing& rhs) { return lhs.time_ > rhs.time_; });
+  slowest.resize(count);
+  return slowest;
+}
+
+void ValidationResourceTimings::log(size_t count) const {
+  std::chrono::microseconds total{};
+  for (const Timing& timing : timings_) {
+    total += timing.time_;
+  }
+  ENVOY_LOG(info, "built {} resources in {}ms", timings_.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(total).count());
+  for (const Timing& timing : slowest(count)) {
+    ENVOY_LOG(info, "  {} '{}': {}ms", timing.type_, timing.name_,
+              std::chrono::duration_cast<std::chrono::milliseconds>(timing.time_).count());
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+
+#include "common/common/logger.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * The time spent building each resource of the config being validated, to find the slow parts of
+ * large configs.
+ */
+class ValidationResourceTimings : Logger::Loggable<Logger::Id::config> {
+public:
+  struct Timing {
+    // The type of the resource, e.g. "cluster".
+    std::string type_;
+    std::string name_;
+    std::chrono::microseconds time_;
+  };
+
+  explicit ValidationResourceTimings(TimeSource& time_source) : time_source_(time_source) {}
+
+  /**
+   * @return the start time of building a resource, to pass to record().
+   */
+  MonotonicTime start() const { return time_source_.monotonicTime(); }
+
+  /**
+   * Records the time spent building a resource, from its start until now.
+   * @param type supplies the type of the resource.
+   * @param name supplies the name of the resource.
+   * @param start supplies the start time returned by start().
+   */
+  void record(absl::string_view type, absl::string_view name, MonotonicTime start);
+
+  /**
+   * @param count supplies the maximum number of timings to return.
+   * @return the timings of the slowest resources, the slowest first.
+   */
+  std::vector<Timing> slowest(size_t count) const;
+
+  /**
+   * Logs the total time spent building the resources, and the timings of the slowest ones.
+   * @param count supplies the maximum number of timings to log.
+   */
+  void log(size_t count) const;
+
+private:
+  TimeSource& time_source_;
+  std::vector<Timing> timings_;
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -16,6 +16,12 @@
 
 namespace Envoy {
 namespace Server {
+namespace {
+
+// The number of the slowest resources whose build time is logged once the config is built.
+constexpr size_t SlowestResourcesLogged = 10;
+
+} // namespace
 
 bool validateConfig(const Options& options,
                     const Network::Address::InstanceConstSharedPtr& local_address,
@@ -54,7 +60,7 @@ ValidationInstance::ValidationInstance(
                           store),
       mutex_tracer_(nullptr), grpc_context_(stats_store_.symbolTable()),
       http_context_(stats_store_.symbolTable()), router_context_(stats_store_.symbolTable()),
-      time_system_(time_system), server_contexts_(*this) {
+      time_system_(time_system), server_contexts_(*this), resource_timings_(api_->timeSource()) {
   TRY_ASSERT_MAIN_THREAD { initialize(options, local_address, component_factory); }
   END_TRY
   catch (const EnvoyException& e) {
@@ -92,7 +98,8 @@ void ValidationInstance::initialize(const Options& options,
   overload_manager_ = std::make_unique<OverloadManagerImpl>(
       dispatcher(), stats(), threadLocal(), bootstrap.overload_manager(),
       messageValidationContext().staticValidationVisitor(), *api_, options_);
-  listener_manager_ = std::make_unique<ListenerManagerImpl>(*this, *this, *this, false);
+  listener_manager_ =
+      std::make_unique<ValidationListenerManager>(*this, *this, *this, resource_timings_);
   Configuration::InitialImpl initial_config(bootstrap, options, *this);
   thread_local_.registerThread(*dispatcher_, true);
   runtime_singleton_ = std::make_unique<Runtime::ScopedLoaderSingleton>(
@@ -102,8 +109,10 @@ void ValidationInstance::initialize(const Options& options,
   cluster_manager_factory_ = std::make_unique<Upstream::ValidationClusterManagerFactory>(
       admin(), runtime(), stats(), threadLocal(), dnsResolver(), sslContextManager(), dispatcher(),
       localInfo(), *secret_manager_, messageValidationContext(), *api_, http_context_,
-      grpc_context_, router_context_, accessLogManager(), singletonManager(), options);
+      grpc_context_, router_context_, accessLogManager(), singletonManager(), options,
+      &resource_timings_);
   config_.initialize(bootstrap, *this, *cluster_manager_factory_);
+  resource_timings_.log(SlowestResourcesLogged);
   runtime().initialize(clusterManager());
   clusterManager().setInitializedCb([this]() -> void { init_manager_.initialize(init_watcher_); });
 }
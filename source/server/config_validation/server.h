@@ -27,6 +27,7 @@
 #include "server/config_validation/api.h"
 #include "server/config_validation/cluster_manager.h"
 #include "server/config_validation/dns.h"
+#include "server/config_validation/resource_timings.h"
 #include "server/listener_manager_impl.h"
 #include "server/server.h"
 
@@ -44,6 +45,33 @@ bool validateConfig(const Options& options,
                     ComponentFactory& component_factory, Thread::ThreadFactory& thread_factory,
                     Filesystem::Instance& file_system);
 
+/**
+ * Config-validation-only listener manager, which records the time spent building each listener.
+ */
+class ValidationListenerManager : public ListenerManagerImpl {
+public:
+  ValidationListenerManager(Instance& server, ListenerComponentFactory& listener_factory,
+                            WorkerFactory& worker_factory,
+                            ValidationResourceTimings& resource_timings)
+      : ListenerManagerImpl(server, listener_factory, worker_factory, false),
+        resource_timings_(resource_timings) {}
+
+  // Server::ListenerManager
+  using ListenerManagerImpl::addOrUpdateListener;
+  bool addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
+                           const std::string& version_info, bool added_via_api,
+                           uint64_t config_hash) override {
+    const MonotonicTime start = resource_timings_.start();
+    const bool added =
+        ListenerManagerImpl::addOrUpdateListener(config, version_info, added_via_api, config_hash);
+    resource_timings_.record("listener", config.name(), start);
+    return added;
+  }
+
+private:
+  ValidationResourceTimings& resource_timings_;
+};
+
 /**
  * ValidationInstance does the bulk of the work for config-validation runs of Envoy. It implements
  * Server::Instance, but some functionality not needed until serving time, such as updating
@@ -209,6 +237,7 @@ private:
   Router::ContextImpl router_context_;
   Event::TimeSystem& time_system_;
   ServerFactoryContextImpl server_contexts_;
+  ValidationResourceTimings resource_timings_;
 };
 
 } // namespace Server
@@ -170,6 +170,13 @@ ConnectionHandlerImpl::getBalancedHandlerByTag(uint64_t listener_tag) {
 
 Network::BalancedConnectionHandlerOptRef
 ConnectionHandlerImpl::getBalancedHandlerByAddress(const Network::Address::Instance& address) {
+  auto tcp_listener = findActiveTcpListenerByAddress(address);
+  return tcp_listener.has_value() ? Network::BalancedConnectionHandlerOptRef(tcp_listener->get())
+                                  : absl::nullopt;
+}
+
+ConnectionHandlerImpl::ActiveTcpListenerOptRef
+ConnectionHandlerImpl::findActiveTcpListenerByAddress(const Network::Address::Instance& address) {
   // This is a linear operation, may need to add a map<address, listener> to improve performance.
   // However, linear performance might be adequate since the number of listeners is small.
   // We do not return stopped listeners.
@@ -184,8 +191,7 @@ ConnectionHandlerImpl::getBalancedHandlerByAddress(const Network::Address::Insta
 
   // If there is exact address match, return the corresponding listener.
   if (listener_it != listeners_.end()) {
-    return Network::BalancedConnectionHandlerOptRef(
-        listener_it->second.tcpListener().value().get());
+    return listener_it->second.tcpListener();
   }
 
   // Otherwise, we need to look for the wild card match, i.e., 0.0.0.0:[address_port].
@@ -202,13 +208,28 @@ ConnectionHandlerImpl::getBalancedHandlerByAddress(const Network::Address::Insta
                             p.first->ip()->port() == address.ip()->port() &&
                             p.first->ip()->isAnyAddress();
                    });
-  return (listener_it != listeners_.end())
-             ? Network::BalancedConnectionHandlerOptRef(
-                   ActiveTcpListenerOptRef(absl::get<std::reference_wrapper<ActiveTcpListener>>(
-                                               listener_it->second.typed_listener_))
-                       .value()
-                       .get())
-             : absl::nullopt;
+  return (listener_it != listeners_.end()) ? listener_it->second.tcpListener() : absl::nullopt;
+}
+
+std::vector<Network::ConnectionSocketPtr> ConnectionHandlerImpl::handOverConnections() {
+  std::vector<Network::ConnectionSocketPtr> sockets;
+  for (auto& listener : listeners_) {
+    if (auto tcp_listener = listener.second.tcpListener(); tcp_listener.has_value()) {
+      tcp_listener->get().handOverConnections(sockets);
+    }
+  }
+  return sockets;
+}
+
+void ConnectionHandlerImpl::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  auto tcp_listener = findActiveTcpListenerByAddress(*socket->addressProvider().localAddress());
+  if (!tcp_listener.has_value()) {
+    ENVOY_LOG(debug, "closing adopted connection: no listener on {}",
+              socket->addressProvider().localAddress()->asString());
+    socket->close();
+    return;
+  }
+  tcp_listener->get().adoptConnection(std::move(socket));
 }
 
 } // namespace Server
@@ -53,6 +53,8 @@ public:
   void enableListeners() override;
   void setListenerRejectFraction(UnitFloat reject_fraction) override;
   const std::string& statPrefix() const override { return per_handler_stat_prefix_; }
+  std::vector<Network::ConnectionSocketPtr> handOverConnections() override;
+  void adoptConnection(Network::ConnectionSocketPtr&& socket) override;
 
   // Network::TcpConnectionHandler
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
@@ -80,6 +82,7 @@ private:
   };
   using ActiveListenerDetailsOptRef = absl::optional<std::reference_wrapper<ActiveListenerDetails>>;
   ActiveListenerDetailsOptRef findActiveListenerByTag(uint64_t listener_tag);
+  ActiveTcpListenerOptRef findActiveTcpListenerByAddress(const Network::Address::Instance& address);
 
   // This has a value on worker threads, and no value on the main thread.
   const absl::optional<uint32_t> worker_index_;
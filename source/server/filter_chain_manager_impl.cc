@@ -205,7 +205,8 @@ void FilterChainManagerImpl::addFilterChains(
     // Reuse created filter chain if possible.
     // FilterChainManager maintains the lifetime of FilterChainFactoryContext
     // ListenerImpl maintains the dependencies of FilterChainFactoryContext
-    auto filter_chain_impl = findExistingFilterChain(*filter_chain);
+    const FilterChainMessageKey filter_chain_key(*filter_chain);
+    auto filter_chain_impl = findExistingFilterChain(filter_chain_key);
     if (filter_chain_impl == nullptr) {
       filter_chain_impl =
           filter_chain_factory_builder.buildFilterChain(*filter_chain, context_creator);
@@ -219,7 +220,7 @@ void FilterChainManagerImpl::addFilterChains(
         filter_chain_match.application_protocols(), filter_chain_match.source_type(), source_ips,
         filter_chain_match.source_ports(), filter_chain_impl);
 
-    fc_contexts_[*filter_chain] = filter_chain_impl;
+    fc_contexts_[filter_chain_key] = filter_chain_impl;
   }
   convertIPsToTries();
   copyOrRebuildDefaultFilterChain(default_filter_chain, filter_chain_factory_builder,
@@ -270,11 +271,7 @@ void FilterChainManagerImpl::addFilterChainForDestinationPorts(
     const std::vector<std::string>& source_ips,
     const absl::Span<const Protobuf::uint32> source_ports,
     const Network::FilterChainSharedPtr& filter_chain) {
-  if (destination_ports_map.find(destination_port) == destination_ports_map.end()) {
-    destination_ports_map[destination_port] =
-        std::make_pair<DestinationIPsMap, DestinationIPsTriePtr>(DestinationIPsMap{}, nullptr);
-  }
-  addFilterChainForDestinationIPs(destination_ports_map[destination_port].first, destination_ips,
+  addFilterChainForDestinationIPs(destination_ports_map[destination_port].map_, destination_ips,
                                   server_names, transport_protocol, application_protocols,
                                   source_type, source_ips, source_ports, filter_chain);
 }
@@ -358,11 +355,11 @@ void FilterChainManagerImpl::addFilterChainForSourceTypes(
     const absl::Span<const Protobuf::uint32> source_ports,
     const Network::FilterChainSharedPtr& filter_chain) {
   if (source_ips.empty()) {
-    addFilterChainForSourceIPs(source_types_array[source_type].first, EMPTY_STRING, source_ports,
+    addFilterChainForSourceIPs(source_types_array[source_type].map_, EMPTY_STRING, source_ports,
                                filter_chain);
   } else {
     for (const auto& source_ip : source_ips) {
-      addFilterChainForSourceIPs(source_types_array[source_type].first, source_ip, source_ports,
+      addFilterChainForSourceIPs(source_types_array[source_type].map_, source_ip, source_ports,
                                  filter_chain);
     }
   }
@@ -432,7 +429,7 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
   if (address->type() == Network::Address::Type::Ip) {
     const auto port_match = destination_ports_map_.find(address->ip()->port());
     if (port_match != destination_ports_map_.end()) {
-      best_match_filter_chain = findFilterChainForDestinationIP(*port_match->second.second, socket);
+      best_match_filter_chain = findFilterChainForDestinationIP(port_match->second, socket);
       if (best_match_filter_chain != nullptr) {
         return best_match_filter_chain;
       } else {
@@ -445,7 +442,7 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
   // Match on catch-all port 0 if there is no specific port sub tree.
   const auto port_match = destination_ports_map_.find(0);
   if (port_match != destination_ports_map_.end()) {
-    best_match_filter_chain = findFilterChainForDestinationIP(*port_match->second.second, socket);
+    best_match_filter_chain = findFilterChainForDestinationIP(port_match->second, socket);
   }
   return best_match_filter_chain != nullptr
              ? best_match_filter_chain
@@ -454,14 +451,18 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinationIP(
-    const DestinationIPsTrie& destination_ips_trie, const Network::ConnectionSocket& socket) const {
+    const DestinationIPs& destination_ips, const Network::ConnectionSocket& socket) const {
+  if (destination_ips.catch_all_ != nullptr) {
+    return findFilterChainForServerName(*destination_ips.catch_all_, socket);
+  }
+
   auto address = socket.addressProvider().localAddress();
   if (address->type() != Network::Address::Type::Ip) {
     address = fakeAddress();
   }
 
   // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = destination_ips_trie.getData(address);
+  const auto& data = destination_ips.trie_->getData(address);
   if (!data.empty()) {
     ASSERT(data.size() == 1);
     return findFilterChainForServerName(*data.back(), socket);
@@ -473,7 +474,8 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
   ASSERT(absl::AsciiStrToLower(socket.requestedServerName()) == socket.requestedServerName());
-  const std::string server_name(socket.requestedServerName());
+  // The maps are looked up by views of the server name, without copying it for each suffix.
+  const absl::string_view server_name = socket.requestedServerName();
 
   // Match on exact server name, i.e. "www.example.com" for "www.example.com".
   const auto server_name_exact_match = server_names_map.find(server_name);
@@ -484,8 +486,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
   // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
   size_t pos = server_name.find('.', 1);
   while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
-    const auto server_name_wildcard_match = server_names_map.find(wildcard);
+    const auto server_name_wildcard_match = server_names_map.find(server_name.substr(pos));
     if (server_name_wildcard_match != server_names_map.end()) {
       return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
     }
@@ -504,7 +505,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -552,44 +553,48 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceType
 
   // isSameIpOrLoopback can be expensive. Call it only if LOCAL or EXTERNAL have entries.
   const bool is_local_connection =
-      (!filter_chain_local.first.empty() || !filter_chain_external.first.empty())
+      (!filter_chain_local.empty() || !filter_chain_external.empty())
           ? Network::Utility::isSameIpOrLoopback(socket)
           : false;
 
   if (is_local_connection) {
-    if (!filter_chain_local.first.empty()) {
-      return findFilterChainForSourceIpAndPort(*filter_chain_local.second, socket);
+    if (!filter_chain_local.empty()) {
+      return findFilterChainForSourceIpAndPort(filter_chain_local, socket);
     }
   } else {
-    if (!filter_chain_external.first.empty()) {
-      return findFilterChainForSourceIpAndPort(*filter_chain_external.second, socket);
+    if (!filter_chain_external.empty()) {
+      return findFilterChainForSourceIpAndPort(filter_chain_external, socket);
     }
   }
 
   const auto& filter_chain_any = source_types[envoy::config::listener::v3::FilterChainMatch::ANY];
 
-  if (!filter_chain_any.first.empty()) {
-    return findFilterChainForSourceIpAndPort(*filter_chain_any.second, socket);
+  if (!filter_chain_any.empty()) {
+    return findFilterChainForSourceIpAndPort(filter_chain_any, socket);
   } else {
     return nullptr;
   }
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceIpAndPort(
-    const SourceIPsTrie& source_ips_trie, const Network::ConnectionSocket& socket) const {
+    const SourceIPs& source_ips, const Network::ConnectionSocket& socket) const {
   auto address = socket.addressProvider().remoteAddress();
   if (address->type() != Network::Address::Type::Ip) {
     address = fakeAddress();
   }
 
-  // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = source_ips_trie.getData(address);
-  if (data.empty()) {
-    return nullptr;
+  const SourcePortsMap* source_ports_map_ptr = source_ips.catch_all_.get();
+  if (source_ports_map_ptr == nullptr) {
+    // Match on both: exact IP and wider CIDR ranges using LcTrie.
+    const auto& data = source_ips.trie_->getData(address);
+    if (data.empty()) {
+      return nullptr;
+    }
+    ASSERT(data.size() == 1);
+    source_ports_map_ptr = data.back().get();
   }
 
-  ASSERT(data.size() == 1);
-  const auto& source_ports_map = *data.back();
+  const auto& source_ports_map = *source_ports_map_ptr;
   const uint32_t source_port = address->ip()->port();
   const auto port_match = source_ports_map.find(source_port);
 
@@ -610,49 +615,66 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceIpAn
 }
 
 void FilterChainManagerImpl::convertIPsToTries() {
-  for (auto& [destination_port, destination_ips_pair] : destination_ports_map_) {
+  for (auto& [destination_port, destination_ips] : destination_ports_map_) {
     UNREFERENCED_PARAMETER(destination_port);
-    // These variables are used as we build up the destination CIDRs used for the trie.
-    auto& [destination_ips_map, destination_ips_trie] = destination_ips_pair;
-    std::vector<std::pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>>
-        destination_ips_list;
-    destination_ips_list.reserve(destination_ips_map.size());
+    auto& destination_ips_map = destination_ips.map_;
 
     for (const auto& [destination_ip, server_names_map_ptr] : destination_ips_map) {
-      destination_ips_list.push_back(makeCidrListEntry(destination_ip, server_names_map_ptr));
-
+      UNREFERENCED_PARAMETER(destination_ip);
       // This hugely nested for loop greatly pains me, but I'm not sure how to make it better.
       // We need to get access to all of the source IP strings so that we can convert them into
-      // a trie like we did for the destination IPs above.
+      // a trie like we do for the destination IPs below.
       for (auto& [server_name, transport_protocols_map] : *server_names_map_ptr) {
         UNREFERENCED_PARAMETER(server_name);
         for (auto& [transport_protocol, application_protocols_map] : transport_protocols_map) {
           UNREFERENCED_PARAMETER(transport_protocol);
           for (auto& [application_protocol, source_arrays] : application_protocols_map) {
             UNREFERENCED_PARAMETER(application_protocol);
-            for (auto& [source_ips_map, source_ips_trie] : source_arrays) {
-              std::vector<
-                  std::pair<SourcePortsMapSharedPtr, std::vector<Network::Address::CidrRange>>>
-                  source_ips_list;
-              source_ips_list.reserve(source_ips_map.size());
-
-              for (auto& [source_ip, source_port_map_ptr] : source_ips_map) {
-                source_ips_list.push_back(makeCidrListEntry(source_ip, source_port_map_ptr));
-              }
-
-              source_ips_trie = std::make_unique<SourceIPsTrie>(source_ips_list, true);
+            for (auto& source_ips : source_arrays) {
+              convertSourceIPsToTrie(source_ips);
             }
           }
         }
       }
     }
 
-    destination_ips_trie = std::make_unique<DestinationIPsTrie>(destination_ips_list, true);
+    if (destination_ips_map.size() == 1 && destination_ips_map.begin()->first == EMPTY_STRING) {
+      destination_ips.catch_all_ = destination_ips_map.begin()->second;
+    } else {
+      std::vector<std::pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>>
+          destination_ips_list;
+      destination_ips_list.reserve(destination_ips_map.size());
+      for (const auto& [destination_ip, server_names_map_ptr] : destination_ips_map) {
+        destination_ips_list.push_back(makeCidrListEntry(destination_ip, server_names_map_ptr));
+      }
+      destination_ips.trie_ = std::make_unique<DestinationIPsTrie>(destination_ips_list, true);
+    }
+    destination_ips_map = DestinationIPsMap();
+  }
+}
+
+void FilterChainManagerImpl::convertSourceIPsToTrie(SourceIPs& source_ips) {
+  auto& source_ips_map = source_ips.map_;
+  if (source_ips_map.empty()) {
+    return;
+  }
+
+  if (source_ips_map.size() == 1 && source_ips_map.begin()->first == EMPTY_STRING) {
+    source_ips.catch_all_ = source_ips_map.begin()->second;
+  } else {
+    std::vector<std::pair<SourcePortsMapSharedPtr, std::vector<Network::Address::CidrRange>>>
+        source_ips_list;
+    source_ips_list.reserve(source_ips_map.size());
+    for (const auto& [source_ip, source_port_map_ptr] : source_ips_map) {
+      source_ips_list.push_back(makeCidrListEntry(source_ip, source_port_map_ptr));
+    }
+    source_ips.trie_ = std::make_unique<SourceIPsTrie>(source_ips_list, true);
   }
+  source_ips_map = SourceIPsMap();
 }
 
-Network::DrainableFilterChainSharedPtr FilterChainManagerImpl::findExistingFilterChain(
-    const envoy::config::listener::v3::FilterChain& filter_chain_message) {
+Network::DrainableFilterChainSharedPtr
+FilterChainManagerImpl::findExistingFilterChain(const FilterChainMessageKey& filter_chain_message) {
   // Origin filter chain manager could be empty if the current is the ancestor.
   const auto* origin = getOriginFilterChainManager();
   if (origin == nullptr) {
@@ -660,8 +682,6 @@ Network::DrainableFilterChainSharedPtr FilterChainManagerImpl::findExistingFilte
   }
   auto iter = origin->fc_contexts_.find(filter_chain_message);
   if (iter != origin->fc_contexts_.end()) {
-    // copy the context to this filter chain manager.
-    fc_contexts_.emplace(filter_chain_message, iter->second);
     return iter->second;
   }
   return nullptr;
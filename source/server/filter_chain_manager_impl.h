@@ -16,6 +16,7 @@
 #include "common/init/manager_impl.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
+#include "common/protobuf/utility.h"
 
 #include "server/filter_chain_factory_context_callback.h"
 
@@ -179,9 +180,29 @@ class FilterChainManagerImpl : public Network::FilterChainManager,
                                public FilterChainFactoryContextCreator,
                                Logger::Loggable<Logger::Id::config> {
 public:
+  // A filter chain message of the listener config, which outlives the filter chain manager, with
+  // its hash. The hash is computed once per listener update, so that matching the filter chains
+  // of a generation of the listener against the previous one neither copies nor serializes the
+  // messages again, which dominates the cost of updating listeners with many filter chains.
+  struct FilterChainMessageKey {
+    FilterChainMessageKey(const envoy::config::listener::v3::FilterChain& message)
+        : message_(&message), hash_(MessageUtil::hash(message)) {}
+
+    bool operator==(const FilterChainMessageKey& rhs) const {
+      return hash_ == rhs.hash_ && MessageUtil()(*message_, *rhs.message_);
+    }
+    template <typename H> friend H AbslHashValue(H h, const FilterChainMessageKey& key) {
+      return H::combine(std::move(h), key.hash_);
+    }
+
+    const envoy::config::listener::v3::FilterChain& message() const { return *message_; }
+
+  private:
+    const envoy::config::listener::v3::FilterChain* message_;
+    uint64_t hash_;
+  };
   using FcContextMap =
-      absl::flat_hash_map<envoy::config::listener::v3::FilterChain,
-                          Network::DrainableFilterChainSharedPtr, MessageUtil, MessageUtil>;
+      absl::flat_hash_map<FilterChainMessageKey, Network::DrainableFilterChainSharedPtr>;
   FilterChainManagerImpl(const Network::Address::InstanceConstSharedPtr& address,
                          Configuration::FactoryContext& factory_context,
                          Init::Manager& init_manager)
@@ -200,7 +221,7 @@ public:
   findFilterChain(const Network::ConnectionSocket& socket) const override;
 
   // Add all filter chains into this manager. During the lifetime of FilterChainManagerImpl this
-  // should be called at most once.
+  // should be called at most once. The filter chain messages must outlive the manager.
   void addFilterChains(
       absl::Span<const envoy::config::listener::v3::FilterChain* const> filter_chain_span,
       const envoy::config::listener::v3::FilterChain* default_filter_chain,
@@ -222,6 +243,7 @@ public:
 
 private:
   void convertIPsToTries();
+  static void convertSourceIPsToTrie(SourceIPs& source_ips);
 
   // Build default filter chain from filter chain message. Skip the build but copy from original
   // filter chain manager if the default filter chain message duplicates the message in origin
@@ -236,7 +258,17 @@ private:
   using SourceIPsMap = absl::flat_hash_map<std::string, SourcePortsMapSharedPtr>;
   using SourceIPsTrie = Network::LcTrie::LcTrie<SourcePortsMapSharedPtr>;
   using SourceIPsTriePtr = std::unique_ptr<SourceIPsTrie>;
-  using SourceTypesArray = std::array<std::pair<SourceIPsMap, SourceIPsTriePtr>, 3>;
+  // The source IPs of a source type. Most filter chains don't match on the source IP, so the trie
+  // is only built if there are other source IPs than the catch-all one.
+  struct SourceIPs {
+    bool empty() const { return trie_ == nullptr && catch_all_ == nullptr; }
+
+    // Only used to build the trie or catch_all_, and released then.
+    SourceIPsMap map_;
+    SourceIPsTriePtr trie_;
+    SourcePortsMapSharedPtr catch_all_;
+  };
+  using SourceTypesArray = std::array<SourceIPs, 3>;
   using ApplicationProtocolsMap = absl::flat_hash_map<std::string, SourceTypesArray>;
   using TransportProtocolsMap = absl::flat_hash_map<std::string, ApplicationProtocolsMap>;
   // Both exact server names and wildcard domains are part of the same map, in which wildcard
@@ -247,8 +279,14 @@ private:
   using DestinationIPsMap = absl::flat_hash_map<std::string, ServerNamesMapSharedPtr>;
   using DestinationIPsTrie = Network::LcTrie::LcTrie<ServerNamesMapSharedPtr>;
   using DestinationIPsTriePtr = std::unique_ptr<DestinationIPsTrie>;
-  using DestinationPortsMap =
-      absl::flat_hash_map<uint16_t, std::pair<DestinationIPsMap, DestinationIPsTriePtr>>;
+  // The destination IPs of a destination port, looked up like SourceIPs.
+  struct DestinationIPs {
+    // Only used to build the trie or catch_all_, and released then.
+    DestinationIPsMap map_;
+    DestinationIPsTriePtr trie_;
+    ServerNamesMapSharedPtr catch_all_;
+  };
+  using DestinationPortsMap = absl::flat_hash_map<uint16_t, DestinationIPs>;
 
   void addFilterChainForDestinationPorts(
       DestinationPortsMap& destination_ports_map, uint16_t destination_port,
@@ -296,7 +334,7 @@ private:
                                     const Network::FilterChainSharedPtr& filter_chain);
 
   const Network::FilterChain*
-  findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
+  findFilterChainForDestinationIP(const DestinationIPs& destination_ips,
                                   const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
   findFilterChainForServerName(const ServerNamesMap& server_names_map,
@@ -312,16 +350,17 @@ private:
                                 const Network::ConnectionSocket& socket) const;
 
   const Network::FilterChain*
-  findFilterChainForSourceIpAndPort(const SourceIPsTrie& source_ips_trie,
+  findFilterChainForSourceIpAndPort(const SourceIPs& source_ips,
                                     const Network::ConnectionSocket& socket) const;
 
   const FilterChainManagerImpl* getOriginFilterChainManager() { return origin_.value(); }
   // Duplicate the inherent factory context if any.
   Network::DrainableFilterChainSharedPtr
-  findExistingFilterChain(const envoy::config::listener::v3::FilterChain& filter_chain_message);
+  findExistingFilterChain(const FilterChainMessageKey& filter_chain_message);
 
   // Mapping from filter chain message to filter chain. This is used by LDS response handler to
-  // detect the filter chains in the intersection of existing listener and new listener.
+  // detect the filter chains in the intersection of existing listener and new listener. The keys
+  // point into the filter chains passed to addFilterChains().
   FcContextMap fc_contexts_;
 
   absl::optional<envoy::config::listener::v3::FilterChain> default_filter_chain_message_;
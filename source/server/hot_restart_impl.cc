@@ -118,6 +118,8 @@ int HotRestartImpl::duplicateParentListenSocket(const std::string& address) {
   return as_child_.duplicateParentListenSocket(address);
 }
 
+int HotRestartImpl::duplicateParentConnection() { return as_child_.duplicateParentConnection(); }
+
 void HotRestartImpl::initialize(Event::Dispatcher& dispatcher, Server::Instance& server) {
   as_parent_.initialize(dispatcher, server);
 }
@@ -133,11 +135,17 @@ HotRestartImpl::mergeParentStatsIfAny(Stats::StoreRoot& stats_store) {
   std::unique_ptr<envoy::HotRestartMessage> wrapper_msg = as_child_.getParentStats();
   ServerStatsFromParent response;
   // getParentStats() will happily and cleanly return nullptr if we have no parent.
-  if (wrapper_msg) {
+  if (!wrapper_msg) {
+    return response;
+  }
+  // Each reply is merged as it arrives, so that only one is held at a time.
+  as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
+  while (wrapper_msg->reply().stats().more()) {
+    wrapper_msg = as_child_.getMoreParentStats();
     as_child_.mergeParentStats(stats_store, wrapper_msg->reply().stats());
-    response.parent_memory_allocated_ = wrapper_msg->reply().stats().memory_allocated();
-    response.parent_connections_ = wrapper_msg->reply().stats().num_connections();
   }
+  response.parent_memory_allocated_ = wrapper_msg->reply().stats().memory_allocated();
+  response.parent_connections_ = wrapper_msg->reply().stats().num_connections();
   return response;
 }
 
@@ -104,6 +104,7 @@ public:
   // Server::HotRestart
   void drainParentListeners() override;
   int duplicateParentListenSocket(const std::string& address) override;
+  int duplicateParentConnection() override;
   void initialize(Event::Dispatcher& dispatcher, Server::Instance& server) override;
   void sendParentAdminShutdownRequest(time_t& original_start_time) override;
   void sendParentTerminateRequest() override;
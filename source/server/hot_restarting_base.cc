@@ -98,10 +98,11 @@ void HotRestartingBase::sendHotRestartMessage(sockaddr_un& address,
     message.msg_iov = iov;
     message.msg_iovlen = 1;
 
-    // Control data stuff, only relevant for the fd passing done with PassListenSocketReply.
+    // Control data stuff, only relevant for the fd passing done with PassListenSocketReply and
+    // PassConnection.
     uint8_t control_buffer[CMSG_SPACE(sizeof(int))];
-    if (replyIsExpectedType(&proto, HotRestartMessage::Reply::kPassListenSocket) &&
-        proto.reply().pass_listen_socket().fd() != -1) {
+    const int passed_fd = passedFd(proto);
+    if (passed_fd != -1) {
       memset(control_buffer, 0, CMSG_SPACE(sizeof(int)));
       message.msg_control = control_buffer;
       message.msg_controllen = CMSG_SPACE(sizeof(int));
@@ -109,7 +110,7 @@ void HotRestartingBase::sendHotRestartMessage(sockaddr_un& address,
       control_message->cmsg_level = SOL_SOCKET;
       control_message->cmsg_type = SCM_RIGHTS;
       control_message->cmsg_len = CMSG_LEN(sizeof(int));
-      *reinterpret_cast<int*>(CMSG_DATA(control_message)) = proto.reply().pass_listen_socket().fd();
+      *reinterpret_cast<int*>(CMSG_DATA(control_message)) = passed_fd;
       ASSERT(sent == total_size, "an fd passing message was too long for one sendmsg().");
     }
 
@@ -153,20 +154,41 @@ bool HotRestartingBase::replyIsExpectedType(const HotRestartMessage* proto,
          proto->reply().reply_case() == oneof_type;
 }
 
+int HotRestartingBase::passedFd(const HotRestartMessage& proto) {
+  if (proto.requestreply_case() != HotRestartMessage::kReply) {
+    return -1;
+  }
+  switch (proto.reply().reply_case()) {
+  case HotRestartMessage::Reply::kPassListenSocket:
+    return proto.reply().pass_listen_socket().fd();
+  case HotRestartMessage::Reply::kPassConnection:
+    return proto.reply().pass_connection().fd();
+  default:
+    return -1;
+  }
+}
+
 // Pull the cloned fd, if present, out of the control data and write it into the
-// PassListenSocketReply proto; the higher level code will see a listening fd that Just Works. We
-// should only get control data in a PassListenSocketReply, it should only be the fd passing type,
+// PassListenSocketReply or PassConnection proto; the higher level code will see an fd that Just
+// Works. We should only get control data in these replies, it should only be the fd passing type,
 // and there should only be one at a time. Crash on any other control data.
 void HotRestartingBase::getPassedFdIfPresent(HotRestartMessage* out, msghdr* message) {
   cmsghdr* cmsg = CMSG_FIRSTHDR(message);
   if (cmsg != nullptr) {
+    const bool passes_listen_socket =
+        replyIsExpectedType(out, HotRestartMessage::Reply::kPassListenSocket);
     RELEASE_ASSERT(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
-                       replyIsExpectedType(out, HotRestartMessage::Reply::kPassListenSocket),
+                       (passes_listen_socket ||
+                        replyIsExpectedType(out, HotRestartMessage::Reply::kPassConnection)),
                    "recvmsg() came with control data when the message's purpose was not to pass a "
                    "file descriptor.");
 
-    out->mutable_reply()->mutable_pass_listen_socket()->set_fd(
-        *reinterpret_cast<int*>(CMSG_DATA(cmsg)));
+    const int fd = *reinterpret_cast<int*>(CMSG_DATA(cmsg));
+    if (passes_listen_socket) {
+      out->mutable_reply()->mutable_pass_listen_socket()->set_fd(fd);
+    } else {
+      out->mutable_reply()->mutable_pass_connection()->set_fd(fd);
+    }
 
     RELEASE_ASSERT(CMSG_NXTHDR(message, cmsg) == nullptr,
                    "More than one control data on a single hot restart recvmsg().");
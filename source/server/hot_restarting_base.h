@@ -67,6 +67,8 @@ protected:
   static Stats::Gauge& hotRestartGeneration(Stats::Scope& scope);
 
 private:
+  // Returns the fd the message passes, or -1 if it doesn't pass one.
+  static int passedFd(const envoy::HotRestartMessage& proto);
   void getPassedFdIfPresent(envoy::HotRestartMessage* out, msghdr* message);
   std::unique_ptr<envoy::HotRestartMessage> parseProtoAndResetState();
   void initRecvBufIfNewMessage();
@@ -34,15 +34,35 @@ int HotRestartingChild::duplicateParentListenSocket(const std::string& address)
   return wrapped_reply->reply().pass_listen_socket().fd();
 }
 
+int HotRestartingChild::duplicateParentConnection() {
+  if (restart_epoch_ == 0 || parent_terminated_) {
+    return -1;
+  }
+
+  HotRestartMessage wrapped_request;
+  wrapped_request.mutable_request()->mutable_pass_connection();
+  sendHotRestartMessage(parent_address_, wrapped_request);
+
+  // A parent that doesn't support the request replies that it didn't recognize it.
+  std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
+  if (!replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kPassConnection)) {
+    return -1;
+  }
+  return wrapped_reply->reply().pass_connection().fd();
+}
+
 std::unique_ptr<HotRestartMessage> HotRestartingChild::getParentStats() {
   if (restart_epoch_ == 0 || parent_terminated_) {
     return nullptr;
   }
 
   HotRestartMessage wrapped_request;
-  wrapped_request.mutable_request()->mutable_stats();
+  wrapped_request.mutable_request()->mutable_stats()->set_max_stats_per_reply(MaxStatsPerReply);
   sendHotRestartMessage(parent_address_, wrapped_request);
+  return getMoreParentStats();
+}
 
+std::unique_ptr<HotRestartMessage> HotRestartingChild::getMoreParentStats() {
   std::unique_ptr<HotRestartMessage> wrapped_reply = receiveHotRestartMessage(Blocking::Yes);
   RELEASE_ASSERT(replyIsExpectedType(wrapped_reply.get(), HotRestartMessage::Reply::kStats),
                  "Hot restart parent did not respond as expected to get stats request.");
@@ -114,6 +134,8 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
     }
   }
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
+  stat_merger_->addStatNames(stats_proto.stat_names(), dynamics);
+  stat_merger_->mergeStatsById(stats_proto.counter_deltas_by_id(), stats_proto.gauges_by_id());
 }
 
 } // namespace Server
@@ -16,13 +16,20 @@ public:
                      mode_t socket_mode);
 
   int duplicateParentListenSocket(const std::string& address);
+  int duplicateParentConnection();
+  // Returns the first reply of the parent to a stats request, or nullptr if there's no parent.
   std::unique_ptr<envoy::HotRestartMessage> getParentStats();
+  // Returns the next reply of the parent after one with 'more' set.
+  std::unique_ptr<envoy::HotRestartMessage> getMoreParentStats();
   void drainParentListeners();
   void sendParentAdminShutdownRequest(time_t& original_start_time);
   void sendParentTerminateRequest();
   void mergeParentStats(Stats::Store& stats_store,
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
 
+  // The number of stats per reply the parent is asked for.
+  static constexpr uint32_t MaxStatsPerReply = 1000;
+
 private:
   const int restart_epoch_;
   bool parent_terminated_{};
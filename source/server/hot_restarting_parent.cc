@@ -56,6 +56,15 @@ void HotRestartingParent::onSocketEvent() {
     }
 
     case HotRestartMessage::Request::kStats: {
+      const uint32_t max_stats_per_reply =
+          wrapped_request->request().stats().max_stats_per_reply();
+      if (max_stats_per_reply > 0) {
+        for (const HotRestartMessage& wrapped_reply :
+             internal_->exportStatsByIdToChild(max_stats_per_reply)) {
+          sendHotRestartMessage(child_address_, wrapped_reply);
+        }
+        break;
+      }
       HotRestartMessage wrapped_reply;
       internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
       sendHotRestartMessage(child_address_, wrapped_reply);
@@ -67,6 +76,11 @@ void HotRestartingParent::onSocketEvent() {
       break;
     }
 
+    case HotRestartMessage::Request::kPassConnection: {
+      onPassConnectionRequest();
+      break;
+    }
+
     case HotRestartMessage::Request::kTerminate: {
       ENVOY_LOG(info, "shutting down due to child request");
       kill(getpid(), SIGTERM);
@@ -84,7 +98,53 @@ void HotRestartingParent::onSocketEvent() {
   }
 }
 
-void HotRestartingParent::shutdown() { socket_event_.reset(); }
+void HotRestartingParent::onPassConnectionRequest() {
+  switch (connection_hand_over_state_) {
+  case ConnectionHandOverState::NotStarted:
+    // The workers hand over their connections asynchronously, the child waits for the reply.
+    connection_hand_over_state_ = ConnectionHandOverState::InProgress;
+    internal_->handOverConnections([this](std::vector<Network::ConnectionSocketPtr>&& sockets) {
+      ENVOY_LOG(info, "handing over {} connections to the child", sockets.size());
+      handed_over_sockets_ = std::move(sockets);
+      connection_hand_over_state_ = ConnectionHandOverState::Done;
+      if (socket_event_ != nullptr) {
+        sendHandedOverConnection();
+      }
+    });
+    break;
+  case ConnectionHandOverState::InProgress:
+    // The child only sends the next request once it got the reply.
+    ENVOY_LOG(error, "child asked for a connection while the previous request is pending");
+    break;
+  case ConnectionHandOverState::Done:
+    sendHandedOverConnection();
+    break;
+  }
+}
+
+void HotRestartingParent::sendHandedOverConnection() {
+  HotRestartMessage wrapped_reply;
+  wrapped_reply.mutable_reply()->mutable_pass_connection()->set_fd(-1);
+  if (handed_over_sockets_.empty()) {
+    sendHotRestartMessage(child_address_, wrapped_reply);
+    return;
+  }
+  Network::ConnectionSocketPtr socket = std::move(handed_over_sockets_.back());
+  handed_over_sockets_.pop_back();
+  wrapped_reply.mutable_reply()->mutable_pass_connection()->set_fd(
+      socket->ioHandle().fdDoNotUse());
+  sendHotRestartMessage(child_address_, wrapped_reply);
+  // The child has its own copy of the socket once the message is sent.
+  socket->close();
+}
+
+void HotRestartingParent::shutdown() {
+  socket_event_.reset();
+  handed_over_sockets_.clear();
+  // The stats exported by id are referenced until then, and the stats store doesn't outlive the
+  // server.
+  internal_.reset();
+}
 
 HotRestartingParent::Internal::Internal(Server::Instance* server) : server_(server) {
   Stats::Gauge& hot_restart_generation = hotRestartGeneration(server->stats());
@@ -119,10 +179,11 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
   return wrapped_reply;
 }
 
-// TODO(fredlas) if there are enough stats for stat name length to become an issue, this current
-// implementation can negate the benefit of symbolized stat names by periodically reaching the
-// magnitude of memory usage that they are meant to avoid, since this map holds full-string
-// names. The problem can be solved by splitting the export up over many chunks.
+// Used for the children that don't ask for the stats by id. If there are enough stats for stat
+// name length to become an issue, this implementation can negate the benefit of symbolized stat
+// names by periodically reaching the magnitude of memory usage that they are meant to avoid, since
+// this map holds full-string names. exportStatsByIdToChild() splits the export up over many chunks
+// and only sends each name once.
 void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
   for (const auto& gauge : server_->stats().gauges()) {
     if (gauge->used()) {
@@ -148,6 +209,80 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
   stats->set_num_connections(server_->listenerManager().numConnections());
 }
 
+std::vector<HotRestartMessage>
+HotRestartingParent::Internal::exportStatsByIdToChild(uint32_t max_stats_per_reply) {
+  ASSERT(max_stats_per_reply > 0);
+  std::vector<HotRestartMessage> replies;
+  uint32_t stats_in_reply = 0;
+  // Returns the reply the next stat goes into.
+  const auto next_stats = [&]() -> HotRestartMessage::Reply::Stats* {
+    if (replies.empty() || stats_in_reply == max_stats_per_reply) {
+      if (!replies.empty()) {
+        replies.back().mutable_reply()->mutable_stats()->set_more(true);
+      }
+      replies.emplace_back();
+      stats_in_reply = 0;
+    }
+    stats_in_reply++;
+    return replies.back().mutable_reply()->mutable_stats();
+  };
+  const auto add_name = [this](HotRestartMessage::Reply::Stats* stats, uint32_t id,
+                               const Stats::Metric& metric) {
+    const std::string name = metric.name();
+    (*stats->mutable_stat_names())[id] = name;
+    recordDynamics(stats, name, metric.statName());
+  };
+
+  for (const auto& gauge : server_->stats().gauges()) {
+    if (!gauge->used()) {
+      continue;
+    }
+    const uint64_t value = gauge->value();
+    auto result = exported_gauges_.try_emplace(gauge.get(), ExportedGauge{gauge, next_stat_id_, 0});
+    ExportedGauge& exported = result.first->second;
+    if (result.second) {
+      next_stat_id_++;
+    } else if (exported.value_ == value) {
+      // The child still has the value last exported.
+      continue;
+    }
+    exported.value_ = value;
+    HotRestartMessage::Reply::Stats* stats = next_stats();
+    if (result.second) {
+      add_name(stats, exported.id_, *gauge);
+    }
+    (*stats->mutable_gauges_by_id())[exported.id_] = value;
+  }
+
+  for (const auto& counter : server_->stats().counters()) {
+    if (!counter->used()) {
+      continue;
+    }
+    // As in exportStatsToChild(), only this export latches the counters.
+    const uint64_t latched_value = counter->latch();
+    if (latched_value == 0) {
+      continue;
+    }
+    auto result =
+        exported_counters_.try_emplace(counter.get(), ExportedCounter{counter, next_stat_id_});
+    ExportedCounter& exported = result.first->second;
+    HotRestartMessage::Reply::Stats* stats = next_stats();
+    if (result.second) {
+      next_stat_id_++;
+      add_name(stats, exported.id_, *counter);
+    }
+    (*stats->mutable_counter_deltas_by_id())[exported.id_] = latched_value;
+  }
+
+  if (replies.empty()) {
+    replies.emplace_back();
+  }
+  HotRestartMessage::Reply::Stats* last_stats = replies.back().mutable_reply()->mutable_stats();
+  last_stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
+  last_stats->set_num_connections(server_->listenerManager().numConnections());
+  return replies;
+}
+
 void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Stats* stats,
                                                    const std::string& name,
                                                    Stats::StatName stat_name) {
@@ -174,5 +309,10 @@ void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Sta
 
 void HotRestartingParent::Internal::drainListeners() { server_->drainListeners(); }
 
+void HotRestartingParent::Internal::handOverConnections(
+    ListenerManager::HandOverConnectionsCallback callback) {
+  server_->listenerManager().handOverConnections(std::move(callback));
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -1,9 +1,17 @@
 #pragma once
 
+#include <vector>
+
+#include "envoy/network/listen_socket.h"
+#include "envoy/server/listener_manager.h"
+#include "envoy/stats/stats.h"
+
 #include "common/common/hash.h"
 
 #include "server/hot_restarting_base.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -31,21 +39,50 @@ public:
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Return value is the replies to a stats request that asked for the stats by id. Only the
+    // counters and gauges that changed since the last export are included, at most
+    // 'max_stats_per_reply' per reply.
+    std::vector<envoy::HotRestartMessage> exportStatsByIdToChild(uint32_t max_stats_per_reply);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
+    // 'callback' is called with the sockets of the connections to pass to the child.
+    void handOverConnections(ListenerManager::HandOverConnectionsCallback callback);
 
   private:
+    // The stats already exported by id. They are kept alive so that their ids stay unique.
+    struct ExportedCounter {
+      Stats::CounterSharedPtr counter_;
+      uint32_t id_;
+    };
+    struct ExportedGauge {
+      Stats::GaugeSharedPtr gauge_;
+      uint32_t id_;
+      // The value last exported.
+      uint64_t value_;
+    };
+
     Server::Instance* const server_{};
+    absl::flat_hash_map<const Stats::Counter*, ExportedCounter> exported_counters_;
+    absl::flat_hash_map<const Stats::Gauge*, ExportedGauge> exported_gauges_;
+    uint32_t next_stat_id_{};
   };
 
 private:
+  enum class ConnectionHandOverState { NotStarted, InProgress, Done };
+
   void onSocketEvent();
+  void onPassConnectionRequest();
+  void sendHandedOverConnection();
 
   const int restart_epoch_;
   sockaddr_un child_address_;
   Event::FileEventPtr socket_event_;
   std::unique_ptr<Internal> internal_;
+  // The connections are handed over once, on the first request of the child, and then passed one
+  // per request.
+  ConnectionHandOverState connection_hand_over_state_{ConnectionHandOverState::NotStarted};
+  std::vector<Network::ConnectionSocketPtr> handed_over_sockets_;
 };
 
 } // namespace Server
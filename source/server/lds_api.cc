@@ -65,16 +65,18 @@ void LdsApiImpl::onConfigUpdate(const std::vector<Config::DecodedResourceRef>& a
   absl::node_hash_set<std::string> listener_names;
   std::string message;
   for (const auto& resource : added_resources) {
-    envoy::config::listener::v3::Listener listener;
+    // The listener isn't copied, and its hash comes from the decoding, so that unchanged listeners
+    // are skipped cheaply.
+    const auto& listener =
+        dynamic_cast<const envoy::config::listener::v3::Listener&>(resource.get().resource());
     TRY_ASSERT_MAIN_THREAD {
-      listener =
-          dynamic_cast<const envoy::config::listener::v3::Listener&>(resource.get().resource());
       if (!listener_names.insert(listener.name()).second) {
         // NOTE: at this point, the first of these duplicates has already been successfully
         // applied.
         throw EnvoyException(fmt::format("duplicate listener {} found", listener.name()));
       }
-      if (listener_manager_.addOrUpdateListener(listener, resource.get().version(), true)) {
+      if (listener_manager_.addOrUpdateListener(listener, resource.get().version(), true,
+                                                resource.get().hash())) {
         ENVOY_LOG(info, "lds: add/update listener '{}'", listener.name());
         any_applied = true;
       } else {
@@ -18,6 +18,7 @@
 #include "common/network/resolver_impl.h"
 #include "common/network/socket_option_factory.h"
 #include "common/network/socket_option_impl.h"
+#include "common/network/udp_gso_writer_impl.h"
 #include "common/network/udp_listener_impl.h"
 #include "common/network/udp_packet_writer_handler_impl.h"
 #include "common/network/utility.h"
@@ -419,6 +420,10 @@ void ListenerImpl::buildUdpListenerFactory(Network::Socket::Type socket_type,
   } else {
     udp_listener_config_->listener_factory_ =
         std::make_unique<Server::ActiveRawUdpListenerFactory>(concurrency);
+    if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.udp_listener_config().downstream_socket_config(),
+                                        prefer_gso, false)) {
+      udp_listener_config_->writer_factory_ = std::make_unique<Network::UdpGsoWriterFactory>();
+    }
   }
   udp_listener_config_->listener_worker_router_ =
       std::make_unique<Network::UdpListenerWorkerRouterImpl>(concurrency);
@@ -510,6 +515,7 @@ void ListenerImpl::buildFilterChains() {
       parent_.server_.stats(), parent_.server_.singletonManager(), parent_.server_.threadLocal(),
       validation_visitor_, parent_.server_.api(), parent_.server_.options());
   transport_factory_context.setInitManager(*dynamic_init_manager_);
+  transport_factory_context.setOverloadManager(parent_.server_.overloadManager());
   ListenerFilterChainFactoryBuilder builder(*this, transport_factory_context);
   filter_chain_manager_.addFilterChains(
       config_.filter_chains(),
@@ -522,9 +528,17 @@ void ListenerImpl::buildSocketOptions() {
   if (connection_balancer_ == nullptr) {
     // Not in place listener update.
     if (config_.has_connection_balance_config()) {
-      // Currently exact balance is the only supported type and there are no options.
-      ASSERT(config_.connection_balance_config().has_exact_balance());
-      connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+      // There are no options for any of the balancer types.
+      switch (config_.connection_balance_config().balance_type_case()) {
+      case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kExactBalance:
+        connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+        break;
+      case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kWorkStealingBalance:
+        connection_balancer_ = std::make_shared<Network::WorkStealingConnectionBalancerImpl>();
+        break;
+      default:
+        NOT_REACHED_GCOVR_EXCL_LINE;
+      }
     } else {
       connection_balancer_ = std::make_shared<Network::NopConnectionBalancerImpl>();
     }
@@ -1,6 +1,7 @@
 #include "server/listener_manager_impl.h"
 
 #include <algorithm>
+#include <iterator>
 
 #include "envoy/admin/v3/config_dump.pb.h"
 #include "envoy/config/core/v3/address.pb.h"
@@ -332,6 +333,12 @@ ListenerManagerStats ListenerManagerImpl::generateStats(Stats::Scope& scope) {
 
 bool ListenerManagerImpl::addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
                                               const std::string& version_info, bool added_via_api) {
+  return addOrUpdateListener(config, version_info, added_via_api, MessageUtil::hash(config));
+}
+
+bool ListenerManagerImpl::addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
+                                              const std::string& version_info, bool added_via_api,
+                                              uint64_t config_hash) {
   RELEASE_ASSERT(
       !config.address().has_envoy_internal_address(),
       fmt::format("listener {} has envoy internal address {}. Internal address cannot be used by "
@@ -362,7 +369,7 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::config::listener::v3:
 
   auto it = error_state_tracker_.find(name);
   TRY_ASSERT_MAIN_THREAD {
-    return addOrUpdateListenerInternal(config, version_info, added_via_api, name);
+    return addOrUpdateListenerInternal(config, version_info, added_via_api, name, config_hash);
   }
   END_TRY
   catch (const EnvoyException& e) {
@@ -381,7 +388,7 @@ bool ListenerManagerImpl::addOrUpdateListener(const envoy::config::listener::v3:
 
 bool ListenerManagerImpl::addOrUpdateListenerInternal(
     const envoy::config::listener::v3::Listener& config, const std::string& version_info,
-    bool added_via_api, const std::string& name) {
+    bool added_via_api, const std::string& name, uint64_t hash) {
 
   if (listenersStopped(config)) {
     ENVOY_LOG(
@@ -391,7 +398,6 @@ bool ListenerManagerImpl::addOrUpdateListenerInternal(
     return false;
   }
 
-  const uint64_t hash = MessageUtil::hash(config);
   ENVOY_LOG(debug, "begin add/update listener: name={} hash={}", name, hash);
 
   auto existing_active_listener = getListenerByName(active_listeners_, name);
@@ -974,6 +980,39 @@ void ListenerManagerImpl::stopWorkers() {
   }
 }
 
+void ListenerManagerImpl::handOverConnections(HandOverConnectionsCallback callback) {
+  if (!workers_started_ || workers_.empty()) {
+    callback({});
+    return;
+  }
+  const auto sockets = std::make_shared<std::vector<Network::ConnectionSocketPtr>>();
+  const auto workers_pending = std::make_shared<uint64_t>(workers_.size());
+  for (const auto& worker : workers_) {
+    worker->handOverConnections([this, callback, sockets, workers_pending](
+                                    std::vector<Network::ConnectionSocketPtr>&& worker_sockets) {
+      // The completion is called on the worker thread. We post back to the main thread to gather
+      // the sockets of all workers.
+      const auto shared_worker_sockets =
+          std::make_shared<std::vector<Network::ConnectionSocketPtr>>(std::move(worker_sockets));
+      server_.dispatcher().post([callback, sockets, workers_pending, shared_worker_sockets]() {
+        std::move(shared_worker_sockets->begin(), shared_worker_sockets->end(),
+                  std::back_inserter(*sockets));
+        if (--(*workers_pending) == 0) {
+          callback(std::move(*sockets));
+        }
+      });
+    });
+  }
+}
+
+void ListenerManagerImpl::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  if (!workers_started_ || workers_.empty()) {
+    socket->close();
+    return;
+  }
+  workers_[next_adopting_worker_++ % workers_.size()]->adoptConnection(std::move(socket));
+}
+
 void ListenerManagerImpl::endListenerUpdate(FailureStates&& failure_states) {
   overall_error_state_ = std::move(failure_states);
 }
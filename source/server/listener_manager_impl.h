@@ -184,6 +184,9 @@ public:
   // Server::ListenerManager
   bool addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
                            const std::string& version_info, bool added_via_api) override;
+  bool addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
+                           const std::string& version_info, bool added_via_api,
+                           uint64_t config_hash) override;
   void createLdsApi(const envoy::config::core::v3::ConfigSource& lds_config,
                     const xds::core::v3::ResourceLocator* lds_resources_locator) override {
     ASSERT(lds_api_ == nullptr);
@@ -196,6 +199,8 @@ public:
   void startWorkers(GuardDog& guard_dog, std::function<void()> callback) override;
   void stopListeners(StopListenersType stop_listeners_type) override;
   void stopWorkers() override;
+  void handOverConnections(HandOverConnectionsCallback callback) override;
+  void adoptConnection(Network::ConnectionSocketPtr&& socket) override;
   void beginListenerUpdate() override { error_state_tracker_.clear(); }
   void endListenerUpdate(FailureStates&& failure_state) override;
   bool isWorkerStarted() override { return workers_started_; }
@@ -214,7 +219,7 @@ private:
 
   bool addOrUpdateListenerInternal(const envoy::config::listener::v3::Listener& config,
                                    const std::string& version_info, bool added_via_api,
-                                   const std::string& name);
+                                   const std::string& name, uint64_t hash);
   bool removeListenerInternal(const std::string& listener_name, bool dynamic_listeners_only);
 
   struct DrainingListener {
@@ -304,6 +309,8 @@ private:
 
   std::vector<WorkerPtr> workers_;
   bool workers_started_{};
+  // The worker the next adopted connection goes to.
+  uint64_t next_adopting_worker_{};
   absl::optional<StopListenersType> stop_listeners_type_;
   Stats::ScopePtr scope_;
   ListenerManagerStats stats_;
@@ -146,6 +146,9 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
       "", "enable-mutex-tracing", "Enable mutex contention tracing functionality", cmd, false);
   TCLAP::SwitchArg cpuset_threads(
       "", "cpuset-threads", "Get the default # of worker threads from cpuset size", cmd, false);
+  TCLAP::SwitchArg worker_cpu_affinity(
+      "", "worker-cpu-affinity", "Pin each worker thread to one of the CPUs of the process", cmd,
+      false);
 
   TCLAP::ValueArg<std::string> disable_extensions("", "disable-extensions",
                                                   "Comma-separated list of extensions to disable",
@@ -184,6 +187,7 @@ OptionsImpl::OptionsImpl(std::vector<std::string> args,
   core_dump_enabled_ = enable_core_dump.getValue();
 
   cpuset_threads_ = cpuset_threads.getValue();
+  worker_cpu_affinity_ = worker_cpu_affinity.getValue();
 
   if (log_level.isSet()) {
     log_level_ = parseAndValidateLogLevel(log_level.getValue());
@@ -419,8 +423,8 @@ OptionsImpl::OptionsImpl(const std::string& service_cluster, const std::string&
       service_zone_(service_zone), file_flush_interval_msec_(10000), drain_time_(600),
       parent_shutdown_time_(900), drain_strategy_(Server::DrainStrategy::Gradual),
       mode_(Server::Mode::Serve), hot_restart_disabled_(false), signal_handling_enabled_(true),
-      mutex_tracing_enabled_(false), cpuset_threads_(false), socket_path_("@envoy_domain_socket"),
-      socket_mode_(0) {}
+      mutex_tracing_enabled_(false), cpuset_threads_(false), worker_cpu_affinity_(false),
+      socket_path_("@envoy_domain_socket"), socket_mode_(0) {}
 
 void OptionsImpl::disableExtensions(const std::vector<std::string>& names) {
   for (const auto& name : names) {
@@ -150,6 +150,7 @@ public:
   Server::CommandLineOptionsPtr toCommandLineOptions() const override;
   void parseComponentLogLevels(const std::string& component_log_levels);
   bool cpusetThreadsEnabled() const override { return cpuset_threads_; }
+  bool workerCpuAffinityEnabled() const override { return worker_cpu_affinity_; }
   const std::vector<std::string>& disabledExtensions() const override {
     return disabled_extensions_;
   }
@@ -202,6 +203,7 @@ private:
   bool mutex_tracing_enabled_;
   bool core_dump_enabled_;
   bool cpuset_threads_;
+  bool worker_cpu_affinity_;
   std::vector<std::string> disabled_extensions_;
   uint32_t count_;
 
@@ -21,34 +21,6 @@
 namespace Envoy {
 namespace Server {
 
-/**
- * Thread-local copy of the state of each configured overload action.
- */
-class ThreadLocalOverloadStateImpl : public ThreadLocalOverloadState {
-public:
-  explicit ThreadLocalOverloadStateImpl(const NamedOverloadActionSymbolTable& action_symbol_table)
-      : action_symbol_table_(action_symbol_table),
-        actions_(action_symbol_table.size(), OverloadActionState(UnitFloat::min())) {}
-
-  const OverloadActionState& getState(const std::string& action) override {
-    if (const auto symbol = action_symbol_table_.lookup(action); symbol != absl::nullopt) {
-      return actions_[symbol->index()];
-    }
-    return always_inactive_;
-  }
-
-  void setState(NamedOverloadActionSymbolTable::Symbol action, OverloadActionState state) {
-    actions_[action.index()] = state;
-  }
-
-private:
-  static const OverloadActionState always_inactive_;
-  const NamedOverloadActionSymbolTable& action_symbol_table_;
-  std::vector<OverloadActionState> actions_;
-};
-
-const OverloadActionState ThreadLocalOverloadStateImpl::always_inactive_{UnitFloat::min()};
-
 namespace {
 
 class ThresholdTriggerImpl final : public OverloadAction::Trigger {
@@ -107,6 +79,17 @@ private:
   OverloadActionState state_;
 };
 
+OverloadAction::TriggerPtr createTrigger(const envoy::config::overload::v3::Trigger& config) {
+  switch (config.trigger_oneof_case()) {
+  case envoy::config::overload::v3::Trigger::TriggerOneofCase::kThreshold:
+    return std::make_unique<ThresholdTriggerImpl>(config.threshold());
+  case envoy::config::overload::v3::Trigger::TriggerOneofCase::kScaled:
+    return std::make_unique<ScaledTriggerImpl>(config.scaled());
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
 Stats::Counter& makeCounter(Stats::Scope& scope, absl::string_view a, absl::string_view b) {
   Stats::StatNameManagedStorage stat_name(absl::StrCat("overload.", a, ".", b),
                                           scope.symbolTable());
@@ -168,6 +151,81 @@ parseTimerMinimums(const ProtobufWkt::Any& typed_config,
 
 } // namespace
 
+/**
+ * Thread-local copy of the state of each configured overload action. The state of an action is the
+ * maximum of the state computed by the overload manager, and of the state of the triggers of the
+ * worker resources, which each worker evaluates on its own.
+ */
+class ThreadLocalOverloadStateImpl : public ThreadLocalOverloadState {
+public:
+  ThreadLocalOverloadStateImpl(const NamedOverloadActionSymbolTable& action_symbol_table,
+                               Event::Dispatcher& dispatcher,
+                               const std::vector<OverloadWorkerTriggerConfig>& worker_triggers,
+                               std::chrono::milliseconds worker_refresh_interval)
+      : action_symbol_table_(action_symbol_table),
+        actions_(action_symbol_table.size(), OverloadActionState(UnitFloat::min())),
+        manager_states_(action_symbol_table.size(), OverloadActionState(UnitFloat::min())) {
+    if (worker_triggers.empty()) {
+      return;
+    }
+    for (const auto& worker_trigger : worker_triggers) {
+      worker_triggers_.emplace_back(worker_trigger.action_, createTrigger(worker_trigger.config_));
+    }
+    refresh_timer_ = dispatcher.createTimer([this, &dispatcher, worker_refresh_interval]() {
+      if (const auto loop_utilization = dispatcher.loopUtilization();
+          loop_utilization.has_value()) {
+        updateWorkerResources(loop_utilization.value());
+      }
+      refresh_timer_->enableTimer(worker_refresh_interval);
+    });
+    refresh_timer_->enableTimer(worker_refresh_interval);
+  }
+
+  const OverloadActionState& getState(const std::string& action) override {
+    if (const auto symbol = action_symbol_table_.lookup(action); symbol != absl::nullopt) {
+      return actions_[symbol->index()];
+    }
+    return always_inactive_;
+  }
+
+  void setState(NamedOverloadActionSymbolTable::Symbol action, OverloadActionState state) {
+    manager_states_[action.index()] = state;
+    updateState(action);
+  }
+
+  // Updates the triggers of the worker resources with the loop utilization of the worker.
+  void updateWorkerResources(double loop_utilization) {
+    for (auto& [action, trigger] : worker_triggers_) {
+      if (trigger->updateValue(loop_utilization)) {
+        updateState(action);
+      }
+    }
+  }
+
+private:
+  void updateState(NamedOverloadActionSymbolTable::Symbol action) {
+    OverloadActionState state = manager_states_[action.index()];
+    for (const auto& [trigger_action, trigger] : worker_triggers_) {
+      if (trigger_action.index() == action.index() &&
+          trigger->actionState().value() > state.value()) {
+        state = trigger->actionState();
+      }
+    }
+    actions_[action.index()] = state;
+  }
+
+  static const OverloadActionState always_inactive_;
+  const NamedOverloadActionSymbolTable& action_symbol_table_;
+  std::vector<OverloadActionState> actions_;
+  // The states computed by the overload manager, without the worker resources.
+  std::vector<OverloadActionState> manager_states_;
+  std::vector<std::pair<NamedOverloadActionSymbolTable::Symbol, OverloadAction::TriggerPtr>>
+      worker_triggers_;
+  Event::TimerPtr refresh_timer_;
+};
+
+const OverloadActionState ThreadLocalOverloadStateImpl::always_inactive_{UnitFloat::min()};
+
 NamedOverloadActionSymbolTable::Symbol
 NamedOverloadActionSymbolTable::get(absl::string_view string) {
   if (auto it = table_.find(string); it != table_.end()) {
@@ -207,20 +265,7 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction
       scale_percent_gauge_(makeGauge(stats_scope, config.name(), "scale_percent",
                                      Stats::Gauge::ImportMode::Accumulate)) {
   for (const auto& trigger_config : config.triggers()) {
-    TriggerPtr trigger;
-
-    switch (trigger_config.trigger_oneof_case()) {
-    case envoy::config::overload::v3::Trigger::TriggerOneofCase::kThreshold:
-      trigger = std::make_unique<ThresholdTriggerImpl>(trigger_config.threshold());
-      break;
-    case envoy::config::overload::v3::Trigger::TriggerOneofCase::kScaled:
-      trigger = std::make_unique<ScaledTriggerImpl>(trigger_config.scaled());
-      break;
-    default:
-      NOT_REACHED_GCOVR_EXCL_LINE;
-    }
-
-    if (!triggers_.try_emplace(trigger_config.name(), std::move(trigger)).second) {
+    if (!triggers_.try_emplace(trigger_config.name(), createTrigger(trigger_config)).second) {
       throw EnvoyException(
           absl::StrCat("Duplicate trigger resource for overload action ", config.name()));
     }
@@ -266,7 +311,8 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
                                          Api::Api& api, const Server::Options& options)
     : started_(false), dispatcher_(dispatcher), tls_(slot_allocator),
       refresh_interval_(
-          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))) {
+          std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))),
+      worker_refresh_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, worker_refresh_interval, 50)) {
   Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, options, api,
                                                            validation_visitor);
   for (const auto& resource : config.resource_monitors()) {
@@ -308,6 +354,20 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
     for (const auto& trigger : action.triggers()) {
       const std::string& resource = trigger.name();
 
+      if (resource == OverloadWorkerResourceNames::get().LoopUtilization) {
+        // Only the actions the workers look up in their thread-local state see the worker
+        // resources, the callbacks of the other actions run with the state of the overload
+        // manager.
+        if (name != OverloadActionNames::get().StopAcceptingRequests &&
+            name != OverloadActionNames::get().DisableHttpKeepAlive &&
+            name != OverloadActionNames::get().RejectTlsHandshakes) {
+          throw EnvoyException(fmt::format(
+              "Worker resource {} can't trigger overload action {}", resource, name));
+        }
+        worker_triggers_.push_back({symbol, trigger});
+        continue;
+      }
+
       if (resources_.find(resource) == resources_.end()) {
         throw EnvoyException(
             fmt::format("Unknown trigger resource {} for overload action {}", resource, name));
@@ -322,8 +382,10 @@ void OverloadManagerImpl::start() {
   ASSERT(!started_);
   started_ = true;
 
-  tls_.set([this](Event::Dispatcher&) {
-    return std::make_shared<ThreadLocalOverloadStateImpl>(action_symbol_table_);
+  tls_.set([this](Event::Dispatcher& dispatcher) {
+    return std::make_shared<ThreadLocalOverloadStateImpl>(action_symbol_table_, dispatcher,
+                                                          worker_triggers_,
+                                                          worker_refresh_interval_);
   });
 
   if (resources_.empty()) {
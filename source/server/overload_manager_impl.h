@@ -102,6 +102,12 @@ private:
   std::vector<std::string> names_;
 };
 
+// A trigger of a worker resource, evaluated by each worker on its own.
+struct OverloadWorkerTriggerConfig {
+  NamedOverloadActionSymbolTable::Symbol action_;
+  envoy::config::overload::v3::Trigger config_;
+};
+
 class ThreadLocalOverloadStateImpl;
 
 class OverloadManagerImpl : Logger::Loggable<Logger::Id::main>, public OverloadManager {
@@ -171,6 +177,8 @@ private:
   ThreadLocal::TypedSlot<ThreadLocalOverloadStateImpl> tls_;
   NamedOverloadActionSymbolTable action_symbol_table_;
   const std::chrono::milliseconds refresh_interval_;
+  const std::chrono::milliseconds worker_refresh_interval_;
+  std::vector<OverloadWorkerTriggerConfig> worker_triggers_;
   Event::TimerPtr timer_;
   absl::node_hash_map<std::string, Resource> resources_;
   absl::node_hash_map<NamedOverloadActionSymbolTable::Symbol, OverloadAction> actions_;
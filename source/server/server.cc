@@ -26,6 +26,7 @@
 
 #include "common/api/api_impl.h"
 #include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/slice_pool.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/mutex_tracer_impl.h"
 #include "common/common/utility.h"
@@ -36,11 +37,16 @@
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
+#include "common/network/caching_dns_resolver_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
 #include "common/network/socket_interface.h"
 #include "common/network/socket_interface_impl.h"
 #include "common/network/tcp_listener_impl.h"
+#include "common/profiler/sampling_profiler.h"
 #include "common/protobuf/utility.h"
 #include "common/router/rds_impl.h"
+#include "common/runtime/runtime_features.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/signal/fatal_error_handler.h"
 #include "common/singleton/manager_impl.h"
@@ -81,7 +87,8 @@ InstanceImpl::InstanceImpl(
       dispatcher_(api_->allocateDispatcher("main_thread")),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(new ConnectionHandlerImpl(*dispatcher_, absl::nullopt)),
-      listener_component_factory_(*this), worker_factory_(thread_local_, *api_, hooks),
+      listener_component_factory_(*this),
+      worker_factory_(thread_local_, *api_, hooks, options.workerCpuAffinityEnabled()),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
                           store),
       terminated_(false),
@@ -164,42 +171,53 @@ void InstanceImpl::failHealthcheck(bool fail) {
   server_stats_->live_.set(live_.load());
 }
 
-MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source) {
+MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store, TimeSource& time_source,
+                                       bool changed_only) {
+  // With changed_only, all the counters are still latched, but only the changed metrics are kept.
   snapped_counters_ = store.counters();
-  counters_.reserve(snapped_counters_.size());
+  counters_.reserve(changed_only ? 0 : snapped_counters_.size());
   for (const auto& counter : snapped_counters_) {
-    counters_.push_back({counter->latch(), *counter});
+    const uint64_t delta = counter->latch();
+    if (!changed_only || delta > 0) {
+      counters_.push_back({delta, *counter});
+    }
   }
 
   snapped_gauges_ = store.gauges();
-  gauges_.reserve(snapped_gauges_.size());
+  gauges_.reserve(changed_only ? 0 : snapped_gauges_.size());
   for (const auto& gauge : snapped_gauges_) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
-    gauges_.push_back(*gauge);
+    if (!changed_only || gauge->latchChanged()) {
+      gauges_.push_back(*gauge);
+    }
   }
 
   snapped_histograms_ = store.histograms();
-  histograms_.reserve(snapped_histograms_.size());
+  histograms_.reserve(changed_only ? 0 : snapped_histograms_.size());
   for (const auto& histogram : snapped_histograms_) {
-    histograms_.push_back(*histogram);
+    if (!changed_only || histogram->intervalStatistics().sampleCount() > 0) {
+      histograms_.push_back(*histogram);
+    }
   }
 
   snapped_text_readouts_ = store.textReadouts();
-  text_readouts_.reserve(snapped_text_readouts_.size());
+  text_readouts_.reserve(changed_only ? 0 : snapped_text_readouts_.size());
   for (const auto& text_readout : snapped_text_readouts_) {
-    text_readouts_.push_back(*text_readout);
+    if (!changed_only || text_readout->latchChanged()) {
+      text_readouts_.push_back(*text_readout);
+    }
   }
 
   snapshot_time_ = time_source.systemTime();
 }
 
 void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
-                                       TimeSource& time_source) {
+                                       TimeSource& time_source, bool changed_only) {
   // Create a snapshot and flush to all sinks.
   // NOTE: Even if there are no sinks, creating the snapshot has the important property that it
   //       latches all counters on a periodic basis. The hot restart code assumes this is being
   //       done so this should not be removed.
-  MetricSnapshotImpl snapshot(store, time_source);
+  MetricSnapshotImpl snapshot(store, time_source, changed_only);
   for (const auto& sink : sinks) {
     sink->flush(snapshot);
   }
@@ -251,7 +269,8 @@ void InstanceImpl::updateServerStats() {
 void InstanceImpl::flushStatsInternal() {
   updateServerStats();
   auto& stats_config = config_.statsConfig();
-  InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, timeSource());
+  InstanceUtil::flushMetricsToSinks(stats_config.sinks(), stats_store_, timeSource(),
+                                    stats_config.flushChangedOnly());
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
     stat_flush_timer_->enableTimer(stats_config.flushInterval());
@@ -358,6 +377,8 @@ void InstanceImpl::initialize(const Options& options,
   stats_store_.setTagProducer(Config::Utility::createTagProducer(bootstrap_));
   stats_store_.setStatsMatcher(Config::Utility::createStatsMatcher(bootstrap_));
   stats_store_.setHistogramSettings(Config::Utility::createHistogramSettings(bootstrap_));
+  stats_store_.setShardedCounters(Config::Utility::createShardedCounterMatchers(bootstrap_));
+  stats_store_.setBucketedHistograms(Config::Utility::createBucketedHistogramMatchers(bootstrap_));
 
   const std::string server_stats_prefix = "server.";
   const std::string server_compilation_settings_stats_prefix = "server.compilation_settings";
@@ -440,6 +461,13 @@ void InstanceImpl::initialize(const Options& options,
 
   heap_shrinker_ =
       std::make_unique<Memory::HeapShrinker>(*dispatcher_, *overload_manager_, stats_store_);
+  // Before the workers start allocating slices.
+  Buffer::SlicePool::setHugePageSlabs(bootstrap_.buffer_huge_page_slabs());
+  if (bootstrap_.cpu_sampling_profiler_frequency_hz() > 0 &&
+      !Profiler::Sampling::isProfilerStarted() &&
+      !Profiler::Sampling::startProfiler(bootstrap_.cpu_sampling_profiler_frequency_hz())) {
+    ENVOY_LOG(warn, "unable to start the sampling CPU profiler");
+  }
 
   for (const auto& bootstrap_extension : bootstrap_.bootstrap_extensions()) {
     auto& factory = Config::Utility::getAndCheckFactory<Configuration::BootstrapExtensionFactory>(
@@ -537,6 +565,18 @@ void InstanceImpl::initialize(const Options& options,
 
   const bool use_tcp_for_dns_lookups = bootstrap_.use_tcp_for_dns_lookups();
   dns_resolver_ = dispatcher_->createDnsResolver({}, use_tcp_for_dns_lookups);
+  if (bootstrap_.has_dns_resolution_cache()) {
+    const auto& cache_config = bootstrap_.dns_resolution_cache();
+    Network::CachingDnsResolverConfig config;
+    config.max_entries_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, max_entries, 1024);
+    config.max_ttl_ =
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(cache_config, max_ttl, 300000));
+    config.negative_ttl_ =
+        std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(cache_config, negative_ttl, 5000));
+    config.prefetch_percent_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(cache_config, prefetch_percent, 10);
+    dns_resolver_ = std::make_shared<Network::CachingDnsResolverImpl>(dns_resolver_, config,
+                                                                      time_source_, stats_store_);
+  }
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, dns_resolver_,
@@ -613,7 +653,8 @@ void InstanceImpl::onRuntimeReady() {
   if (bootstrap_.has_hds_config()) {
     const auto& hds_config = bootstrap_.hds_config();
     async_client_manager_ = std::make_unique<Grpc::AsyncClientManagerImpl>(
-        *config_.clusterManager(), thread_local_, time_source_, *api_, grpc_context_.statNames());
+        *config_.clusterManager(), thread_local_, time_source_, *api_, grpc_context_.statNames(),
+        bootstrap_.google_grpc_completion_threads());
     TRY_ASSERT_MAIN_THREAD {
       hds_delegate_ = std::make_unique<Upstream::HdsDelegate>(
           stats_store_,
@@ -658,10 +699,35 @@ void InstanceImpl::startWorkers() {
     // At this point we are ready to take traffic and all listening ports are up. Notify our
     // parent if applicable that they can stop listening and drain.
     restarter_.drainParentListeners();
+    adoptParentConnections();
     drain_manager_->startParentShutdownSequence();
   });
 }
 
+void InstanceImpl::adoptParentConnections() {
+  if (!Runtime::runtimeFeatureEnabled("envoy.reloadable_features.hot_restart_pass_connections")) {
+    return;
+  }
+  uint64_t adopted = 0;
+  int fd;
+  while ((fd = restarter_.duplicateParentConnection()) != -1) {
+    Network::IoHandlePtr io_handle = std::make_unique<Network::IoSocketHandleImpl>(fd);
+    // The addresses can't be read if the peer reset the connection in the meantime.
+    TRY_ASSERT_MAIN_THREAD {
+      Network::Address::InstanceConstSharedPtr local_address = io_handle->localAddress();
+      Network::Address::InstanceConstSharedPtr remote_address = io_handle->peerAddress();
+      listener_manager_->adoptConnection(std::make_unique<Network::ConnectionSocketImpl>(
+          std::move(io_handle), local_address, remote_address));
+      adopted++;
+    }
+    END_TRY
+    catch (const EnvoyException& e) {
+      ENVOY_LOG(debug, "dropping a connection of the parent: {}", e.what());
+    }
+  }
+  ENVOY_LOG(info, "adopted {} connections of the parent", adopted);
+}
+
 Runtime::LoaderPtr InstanceUtil::createRuntime(Instance& server,
                                                Server::Configuration::Initial& config) {
   ENVOY_LOG(info, "runtime: {}", MessageUtil::getYamlStringFromMessage(config.runtime()));
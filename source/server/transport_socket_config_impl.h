@@ -31,6 +31,14 @@ public:
    */
   void setInitManager(Init::Manager& init_manager) { init_manager_ = &init_manager; }
 
+  /**
+   * Pass the overload manager of the server to the transport sockets of a listener.
+   * @param overload_manager the overload manager.
+   */
+  void setOverloadManager(OverloadManager& overload_manager) {
+    overload_manager_ = &overload_manager;
+  }
+
   // TransportSocketFactoryContext
   Server::Admin& admin() override { return admin_; }
   Ssl::ContextManager& sslContextManager() override { return context_manager_; }
@@ -53,6 +61,7 @@ public:
   }
   Api::Api& api() override { return api_; }
   const Server::Options& options() override { return options_; }
+  OverloadManager* overloadManager() override { return overload_manager_; }
 
 private:
   Server::Admin& admin_;
@@ -68,6 +77,7 @@ private:
   ProtobufMessage::ValidationVisitor& validation_visitor_;
   Api::Api& api_;
   const Server::Options& options_;
+  OverloadManager* overload_manager_{};
 };
 
 } // namespace Configuration
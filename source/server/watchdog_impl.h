@@ -24,14 +24,19 @@ public:
 
   // Server::WatchDog
   void touch() override {
-    // Set touched_ if not already set.
-    bool expected = false;
-    touched_.compare_exchange_strong(expected, true, std::memory_order_relaxed);
+    // Set touched_ if not already set. The watched thread touches its watchdog on every event loop
+    // iteration, so the flag is only written once per GuardDog check, rather than taking the
+    // ownership of its cache line with a read-modify-write each time.
+    if (!touched_.load(std::memory_order_relaxed)) {
+      touched_.store(true, std::memory_order_relaxed);
+    }
   }
 
 private:
   const Thread::ThreadId thread_id_;
-  std::atomic<bool> touched_{false};
+  // On its own cache line, so that the touches of a watched thread don't contend with the other
+  // watchdogs or the data of their owners.
+  alignas(64) std::atomic<bool> touched_{false};
 };
 
 } // namespace Server
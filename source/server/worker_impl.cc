@@ -9,6 +9,8 @@
 #include "envoy/server/configuration.h"
 #include "envoy/thread_local/thread_local.h"
 
+#include "common/buffer/slice_pool.h"
+
 #include "server/connection_handler_impl.h"
 
 namespace Envoy {
@@ -20,14 +22,16 @@ WorkerPtr ProdWorkerFactory::createWorker(uint32_t index, OverloadManager& overl
       api_.allocateDispatcher(worker_name, overload_manager.scaledTimerFactory()));
   auto conn_handler = std::make_unique<ConnectionHandlerImpl>(*dispatcher, index);
   return std::make_unique<WorkerImpl>(tls_, hooks_, std::move(dispatcher), std::move(conn_handler),
-                                      overload_manager, api_);
+                                      overload_manager, api_,
+                                      cpu_affinity_ ? absl::make_optional(index) : absl::nullopt);
 }
 
 WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
                        Event::DispatcherPtr&& dispatcher, Network::ConnectionHandlerPtr handler,
-                       OverloadManager& overload_manager, Api::Api& api)
+                       OverloadManager& overload_manager, Api::Api& api,
+                       absl::optional<uint32_t> cpu_index)
     : tls_(tls), hooks_(hooks), dispatcher_(std::move(dispatcher)), handler_(std::move(handler)),
-      api_(api) {
+      api_(api), cpu_index_(cpu_index) {
   tls_.registerThread(*dispatcher_, false);
   overload_manager.registerForAction(
       OverloadActionNames::get().StopAcceptingConnections, *dispatcher_,
@@ -35,6 +39,16 @@ WorkerImpl::WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks,
   overload_manager.registerForAction(
       OverloadActionNames::get().RejectIncomingConnections, *dispatcher_,
       [this](OverloadActionState state) { rejectIncomingConnectionsCb(state); });
+  // The pools of the slices are per thread, the heap shrinker of the main thread returns the
+  // memory the pools release to the system.
+  overload_manager.registerForAction(OverloadActionNames::get().ShrinkHeap, *dispatcher_,
+                                     [](OverloadActionState state) {
+                                       Buffer::SlicePool::setMemoryPressure(state.isSaturated());
+                                     });
+  overload_manager.registerForAction(
+      OverloadActionNames::get().ResetStreams, *dispatcher_, [this](OverloadActionState state) {
+        dispatcher_->getWatermarkFactory().resetAccountsGivenPressure(state.value().value());
+      });
 }
 
 void WorkerImpl::addListener(absl::optional<uint64_t> overridden_listener,
@@ -101,6 +115,7 @@ void WorkerImpl::start(GuardDog& guard_dog) {
   // TODO(jmarantz): consider refactoring how this naming works so this naming
   // architecture is centralized, resulting in clearer names.
   Thread::Options options{absl::StrCat("wrk:", dispatcher_->name())};
+  options.cpu_index_ = cpu_index_;
   thread_ = api_.threadFactory().createThread(
       [this, &guard_dog]() -> void { threadRoutine(guard_dog); }, options);
 }
@@ -127,6 +142,22 @@ void WorkerImpl::stopListener(Network::ListenerConfig& listener, std::function<v
   });
 }
 
+void WorkerImpl::handOverConnections(HandOverConnectionsCompletion completion) {
+  ASSERT(thread_);
+  dispatcher_->post(
+      [this, completion]() -> void { completion(handler_->handOverConnections()); });
+}
+
+void WorkerImpl::adoptConnection(Network::ConnectionSocketPtr&& socket) {
+  ASSERT(thread_);
+  // The posted callback must be copyable.
+  std::shared_ptr<Network::ConnectionSocketPtr> shared_socket =
+      std::make_shared<Network::ConnectionSocketPtr>(std::move(socket));
+  dispatcher_->post([this, shared_socket]() -> void {
+    handler_->adoptConnection(std::move(*shared_socket));
+  });
+}
+
 void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
   ENVOY_LOG(debug, "worker entering dispatch loop");
   // The watch dog must be created after the dispatcher starts running and has post events flushed,
@@ -19,8 +19,9 @@ namespace Server {
 
 class ProdWorkerFactory : public WorkerFactory, Logger::Loggable<Logger::Id::main> {
 public:
-  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks)
-      : tls_(tls), api_(api), hooks_(hooks) {}
+  ProdWorkerFactory(ThreadLocal::Instance& tls, Api::Api& api, ListenerHooks& hooks,
+                    bool cpu_affinity = false)
+      : tls_(tls), api_(api), hooks_(hooks), cpu_affinity_(cpu_affinity) {}
 
   // Server::WorkerFactory
   WorkerPtr createWorker(uint32_t index, OverloadManager& overload_manager,
@@ -30,6 +31,8 @@ private:
   ThreadLocal::Instance& tls_;
   Api::Api& api_;
   ListenerHooks& hooks_;
+  // Whether each worker is pinned to the CPU of its index among the CPUs of the process.
+  const bool cpu_affinity_;
 };
 
 /**
@@ -39,7 +42,7 @@ class WorkerImpl : public Worker, Logger::Loggable<Logger::Id::main> {
 public:
   WorkerImpl(ThreadLocal::Instance& tls, ListenerHooks& hooks, Event::DispatcherPtr&& dispatcher,
              Network::ConnectionHandlerPtr handler, OverloadManager& overload_manager,
-             Api::Api& api);
+             Api::Api& api, absl::optional<uint32_t> cpu_index = absl::nullopt);
 
   // Server::Worker
   void addListener(absl::optional<uint64_t> overridden_listener, Network::ListenerConfig& listener,
@@ -54,6 +57,8 @@ public:
   void initializeStats(Stats::Scope& scope) override;
   void stop() override;
   void stopListener(Network::ListenerConfig& listener, std::function<void()> completion) override;
+  void handOverConnections(HandOverConnectionsCompletion completion) override;
+  void adoptConnection(Network::ConnectionSocketPtr&& socket) override;
 
 private:
   void threadRoutine(GuardDog& guard_dog);
@@ -65,6 +70,7 @@ private:
   Event::DispatcherPtr dispatcher_;
   Network::ConnectionHandlerPtr handler_;
   Api::Api& api_;
+  const absl::optional<uint32_t> cpu_index_;
   Thread::ThreadPtr thread_;
   WatchDogSharedPtr watch_dog_;
 };
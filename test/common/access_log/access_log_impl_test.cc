@@ -423,6 +423,56 @@ typed_config:
   log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
 }
 
+TEST_F(AccessLogImplTest, TailSamplingFilter) {
+  const std::string yaml = R"EOF(
+name: accesslog
+filter:
+  tail_sampling_filter:
+    slow_request_threshold: 1s
+    sample_rate:
+      numerator: 1
+      denominator: HUNDRED
+typed_config:
+  "@type": type.googleapis.com/envoy.extensions.access_loggers.file.v3.FileAccessLog
+  path: /dev/null
+  )EOF";
+
+  InstanceSharedPtr log = AccessLogFactory::fromProto(parseAccessLogFromV3Yaml(yaml), context_);
+
+  // The other requests are sampled.
+  stream_info_.response_code_ = 200;
+  EXPECT_CALL(context_.api_.random_, random()).WillOnce(Return(42));
+  EXPECT_CALL(*file_, write(_)).Times(0);
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+
+  EXPECT_CALL(context_.api_.random_, random()).WillOnce(Return(100));
+  EXPECT_CALL(*file_, write(_));
+  log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info_);
+
+  // The failed and slow requests are always kept, without drawing a random value.
+  EXPECT_CALL(context_.api_.random_, random()).Times(0);
+  {
+    TestStreamInfo stream_info;
+    stream_info.response_code_ = 503;
+    EXPECT_CALL(*file_, write(_));
+    log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info);
+  }
+  {
+    TestStreamInfo stream_info;
+    stream_info.response_code_ = 200;
+    stream_info.setResponseFlag(StreamInfo::ResponseFlag::UpstreamOverflow);
+    EXPECT_CALL(*file_, write(_));
+    log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info);
+  }
+  {
+    TestStreamInfo stream_info;
+    stream_info.response_code_ = 200;
+    stream_info.end_time_ = stream_info.startTimeMonotonic() + std::chrono::seconds(2);
+    EXPECT_CALL(*file_, write(_));
+    log->log(&request_headers_, &response_headers_, &response_trailers_, stream_info);
+  }
+}
+
 TEST_F(AccessLogImplTest, PathRewrite) {
   request_headers_ = {{":method", "GET"}, {":path", "/foo"}, {"x-envoy-original-path", "/bar"}};
 
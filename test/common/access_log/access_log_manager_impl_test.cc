@@ -27,6 +27,24 @@ namespace Envoy {
 namespace AccessLog {
 namespace {
 
+// Counts the threads created through another thread factory.
+class CountingThreadFactory : public Thread::ThreadFactory {
+public:
+  explicit CountingThreadFactory(Thread::ThreadFactory& thread_factory)
+      : thread_factory_(thread_factory) {}
+
+  // Thread::ThreadFactory
+  Thread::ThreadPtr createThread(std::function<void()> thread_routine,
+                                 Thread::OptionsOptConstRef options) override {
+    ++threads_created_;
+    return thread_factory_.createThread(std::move(thread_routine), options);
+  }
+  Thread::ThreadId currentThreadId() override { return thread_factory_.currentThreadId(); }
+
+  Thread::ThreadFactory& thread_factory_;
+  std::atomic<uint32_t> threads_created_{0};
+};
+
 class AccessLogManagerImplTest : public testing::Test {
 protected:
   AccessLogManagerImplTest()
@@ -547,6 +565,59 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+TEST_F(AccessLogManagerImplTest, FilesShareFlushThread) {
+  CountingThreadFactory counting_thread_factory(thread_factory_);
+  EXPECT_CALL(api_, threadFactory()).WillRepeatedly(ReturnRef(counting_thread_factory));
+  EXPECT_CALL(dispatcher_, createTimer_(_)).WillRepeatedly(ReturnNew<NiceMock<Event::MockTimer>>());
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  NiceMock<Filesystem::MockFile>* file2 = new NiceMock<Filesystem::MockFile>;
+  EXPECT_CALL(*file2, path()).WillRepeatedly(Return("bar"));
+  EXPECT_CALL(file_system_,
+              createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
+                  Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"})))
+      .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file2))));
+  EXPECT_CALL(*file2, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log2 = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "bar"});
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("foo data"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file2, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("bar data"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log->write("foo data");
+  log2->write("bar data");
+
+  {
+    Thread::LockGuard lock(file_->write_mutex_);
+    while (file_->num_writes_ != 1) {
+      file_->write_event_.wait(file_->write_mutex_);
+    }
+  }
+  {
+    Thread::LockGuard lock(file2->write_mutex_);
+    while (file2->num_writes_ != 1) {
+      file2->write_event_.wait(file2->write_mutex_);
+    }
+  }
+
+  // Both files were flushed by the same thread.
+  EXPECT_EQ(1, counting_thread_factory.threads_created_);
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file2, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -0,0 +1,203 @@
+#include <string>
+
+#include "envoy/http/stream_reset_handler.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/buffer/watermark_buffer.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+using testing::_;
+
+constexpr uint64_t MiB = 1024 * 1024;
+
+class MockStreamResetHandler : public Http::StreamResetHandler {
+public:
+  MOCK_METHOD(void, resetStream, (Http::StreamResetReason reason));
+};
+
+class BufferMemoryAccountTest : public testing::Test {
+protected:
+  // Adds a slice of the given size to the buffer.
+  void addSlice(Instance& buffer, uint64_t size) { buffer.add(std::string(size, 'a')); }
+
+  WatermarkBufferFactory factory_;
+  MockStreamResetHandler reset_handler_;
+};
+
+// The storage of the slices of the buffer is charged to its account while they hold it.
+TEST_F(BufferMemoryAccountTest, ChargesSlices) {
+  BufferMemoryAccountSharedPtr account = factory_.createAccount(reset_handler_);
+  {
+    OwnedImpl buffer;
+    buffer.bindAccount(account);
+    buffer.add("a");
+    EXPECT_EQ(4096, account->balance());
+    // Fills the first slice, and adds a slice for the rest.
+    addSlice(buffer, 8192);
+    EXPECT_EQ(4096 + 8192, account->balance());
+
+    buffer.drain(4096);
+    EXPECT_EQ(8192, account->balance());
+  }
+  EXPECT_EQ(0, account->balance());
+}
+
+// The slices moved between buffers stay charged to the account of the buffer that created them,
+// and the unaccounted slices are charged to the account of the buffer they are moved to.
+TEST_F(BufferMemoryAccountTest, MovedSlices) {
+  BufferMemoryAccountSharedPtr account1 = factory_.createAccount(reset_handler_);
+  BufferMemoryAccountSharedPtr account2 = factory_.createAccount(reset_handler_);
+  OwnedImpl buffer1;
+  buffer1.bindAccount(account1);
+  OwnedImpl buffer2;
+  buffer2.bindAccount(account2);
+
+  addSlice(buffer1, 8192);
+  buffer2.move(buffer1);
+  EXPECT_EQ(8192, account1->balance());
+  EXPECT_EQ(0, account2->balance());
+
+  OwnedImpl unaccounted;
+  addSlice(unaccounted, 8192);
+  buffer2.move(unaccounted);
+  EXPECT_EQ(8192, account1->balance());
+  EXPECT_EQ(8192, account2->balance());
+
+  buffer2.drain(buffer2.length());
+  EXPECT_EQ(0, account1->balance());
+  EXPECT_EQ(0, account2->balance());
+}
+
+// The accounts are tracked in the bucket of the power of two of their balance, starting at 1MiB.
+TEST_F(BufferMemoryAccountTest, TracksLargeAccounts) {
+  BufferMemoryAccountSharedPtr account = factory_.createAccount(reset_handler_);
+  OwnedImpl buffer;
+  buffer.bindAccount(account);
+
+  addSlice(buffer, MiB / 2);
+  EXPECT_EQ(0, factory_.trackedAccounts(0));
+  addSlice(buffer, MiB / 2);
+  EXPECT_EQ(1, factory_.trackedAccounts(0));
+  addSlice(buffer, 3 * MiB);
+  EXPECT_EQ(0, factory_.trackedAccounts(0));
+  EXPECT_EQ(1, factory_.trackedAccounts(2));
+
+  // The largest accounts share the last bucket.
+  account->charge(1024 * MiB);
+  EXPECT_EQ(0, factory_.trackedAccounts(2));
+  EXPECT_EQ(1, factory_.trackedAccounts(WatermarkBufferFactory::NumBuckets - 1));
+  account->credit(1024 * MiB);
+  EXPECT_EQ(1, factory_.trackedAccounts(2));
+
+  buffer.drain(buffer.length());
+  EXPECT_EQ(0, factory_.trackedAccounts(2));
+}
+
+// The accounts of the streams that ended aren't tracked anymore.
+TEST_F(BufferMemoryAccountTest, ClearDownstream) {
+  BufferMemoryAccountSharedPtr account = factory_.createAccount(reset_handler_);
+  OwnedImpl buffer;
+  buffer.bindAccount(account);
+  addSlice(buffer, MiB);
+  EXPECT_EQ(1, factory_.trackedAccounts(0));
+
+  account->clearDownstream();
+  EXPECT_EQ(0, factory_.trackedAccounts(0));
+  EXPECT_CALL(reset_handler_, resetStream(_)).Times(0);
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(1.0));
+
+  // The buffers may outlive the stream.
+  addSlice(buffer, MiB);
+  EXPECT_EQ(2 * MiB, account->balance());
+  EXPECT_EQ(0, factory_.trackedAccounts(1));
+}
+
+// The higher the pressure, the more buckets of the largest accounts are reset.
+TEST_F(BufferMemoryAccountTest, ResetsLargestAccounts) {
+  MockStreamResetHandler small_handler;
+  MockStreamResetHandler large_handler;
+  BufferMemoryAccountSharedPtr small_account = factory_.createAccount(small_handler);
+  BufferMemoryAccountSharedPtr large_account = factory_.createAccount(large_handler);
+  small_account->charge(MiB);
+  large_account->charge(128 * MiB);
+
+  EXPECT_EQ(0, factory_.resetAccountsGivenPressure(0.1));
+
+  EXPECT_CALL(large_handler, resetStream(Http::StreamResetReason::LocalReset));
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(0.5));
+  EXPECT_EQ(0, factory_.trackedAccounts(WatermarkBufferFactory::NumBuckets - 1));
+
+  EXPECT_CALL(small_handler, resetStream(Http::StreamResetReason::LocalReset));
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(1.0));
+  EXPECT_EQ(0, factory_.trackedAccounts(0));
+
+  // The buffers of the reset streams are freed once they end.
+  small_account->credit(MiB);
+  large_account->credit(128 * MiB);
+}
+
+// A reset frees the buffers of the stream, and may end other streams.
+TEST_F(BufferMemoryAccountTest, ResetFreesBuffers) {
+  MockStreamResetHandler handler1;
+  MockStreamResetHandler handler2;
+  BufferMemoryAccountSharedPtr account1 = factory_.createAccount(handler1);
+  BufferMemoryAccountSharedPtr account2 = factory_.createAccount(handler2);
+  auto buffer1 = std::make_unique<OwnedImpl>();
+  buffer1->bindAccount(account1);
+  auto buffer2 = std::make_unique<OwnedImpl>();
+  buffer2->bindAccount(account2);
+  addSlice(*buffer1, 4 * MiB);
+  addSlice(*buffer2, 4 * MiB);
+
+  // Whichever stream is reset first ends both.
+  auto end_streams = [&](Http::StreamResetReason) {
+    buffer1.reset();
+    buffer2.reset();
+    account1->clearDownstream();
+    account2->clearDownstream();
+    account1.reset();
+    account2.reset();
+  };
+  EXPECT_CALL(handler1, resetStream(_)).Times(testing::AtMost(1)).WillOnce(end_streams);
+  EXPECT_CALL(handler2, resetStream(_)).Times(testing::AtMost(1)).WillOnce(end_streams);
+  EXPECT_EQ(1, factory_.resetAccountsGivenPressure(1.0));
+}
+
+// The aggregating accounts forward their charges to their parent, and keep the total in a gauge.
+TEST_F(BufferMemoryAccountTest, AggregatingAccount) {
+  Stats::TestUtil::TestStore store;
+  Stats::Gauge& gauge = store.gauge("buffered_bytes", Stats::Gauge::ImportMode::Accumulate);
+  BufferMemoryAccountSharedPtr parent = factory_.createAccount(reset_handler_);
+  auto account1 = std::make_shared<AggregatingMemoryAccount>(parent, gauge);
+  auto account2 = std::make_shared<AggregatingMemoryAccount>(nullptr, gauge);
+  {
+    OwnedImpl buffer1;
+    buffer1.bindAccount(account1);
+    OwnedImpl buffer2;
+    buffer2.bindAccount(account2);
+    addSlice(buffer1, MiB);
+    addSlice(buffer2, 8192);
+    EXPECT_EQ(MiB, account1->balance());
+    EXPECT_EQ(MiB, parent->balance());
+    EXPECT_EQ(8192, account2->balance());
+    EXPECT_EQ(MiB + 8192, gauge.value());
+    EXPECT_EQ(1, factory_.trackedAccounts(0));
+
+    account1->clearDownstream();
+    EXPECT_EQ(0, factory_.trackedAccounts(0));
+  }
+  EXPECT_EQ(0, parent->balance());
+  EXPECT_EQ(0, gauge.value());
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -213,6 +213,31 @@ static void bufferMovePartial(benchmark::State& state) {
 }
 BENCHMARK(bufferMovePartial)->Arg(1)->Arg(4096)->Arg(16384)->Arg(65536);
 
+// Test the allocation of the slices of buffers, with a number of buffers in flight at once. The
+// slices come from the slice pool while there are fewer of them than its high watermark for their
+// size, and from the heap beyond.
+static void bufferSliceAllocation(benchmark::State& state) {
+  const std::string data(state.range(0), 'a');
+  std::vector<Buffer::OwnedImpl> buffers(state.range(1));
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (auto& buffer : buffers) {
+      buffer.add(data);
+    }
+    for (auto& buffer : buffers) {
+      buffer.drain(buffer.length());
+    }
+  }
+  benchmark::DoNotOptimize(buffers.size());
+}
+BENCHMARK(bufferSliceAllocation)
+    ->Args({4096, 4})
+    ->Args({4096, 256})
+    ->Args({16384, 4})
+    ->Args({16384, 256})
+    ->Args({65536, 4})
+    ->Args({65536, 256});
+
 // Test the reserve+commit cycle, for the special case where the reserved space is
 // fully used (and therefore the commit size equals the reservation size).
 static void bufferReserveCommit(benchmark::State& state) {
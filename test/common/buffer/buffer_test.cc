@@ -323,6 +323,24 @@ TEST(UnownedSliceTest, CreateDeleteOwnedBufferFragment) {
   EXPECT_TRUE(release_callback_called);
 }
 
+// The external ring grown by a burst of slices is released once the deque is empty.
+TEST(SliceDequeTest, ReleaseExternalRing) {
+  SliceDeque slices;
+  for (int round = 0; round < 2; ++round) {
+    for (uint64_t i = 0; i < 20; ++i) {
+      slices.emplace_back(Slice(4096));
+    }
+    EXPECT_FALSE(slices.inlineRing());
+    for (uint64_t i = 0; i < 19; ++i) {
+      slices.pop_front();
+    }
+    EXPECT_FALSE(slices.inlineRing());
+    slices.pop_back();
+    EXPECT_TRUE(slices.empty());
+    EXPECT_TRUE(slices.inlineRing());
+  }
+}
+
 TEST(SliceDequeTest, CreateDelete) {
   bool slice1_deleted = false;
   bool slice2_deleted = false;
@@ -1,6 +1,7 @@
 #include "envoy/api/io_error.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/cleanup.h"
 #include "common/network/io_socket_handle_impl.h"
 
 #include "test/common/buffer/utility.h"
@@ -584,6 +585,35 @@ TEST_F(OwnedImplTest, MoveDrainTrackersWhenCopying) {
   done.Call();
 }
 
+// The storage of the drained slices is retained whole, without coalescing, and their drain trackers
+// are called as with drain(), the ones of a partially drained slice staying with its rest.
+TEST_F(OwnedImplTest, RetainDrained) {
+  testing::InSequence s;
+
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("a");
+  testing::MockFunction<void()> tracker1;
+  buffer.addDrainTracker(tracker1.AsStdFunction());
+  buffer.appendSliceForTest("bcd");
+  testing::MockFunction<void()> tracker2;
+  buffer.addDrainTracker(tracker2.AsStdFunction());
+  const void* storage = buffer.getRawSlices()[1].mem_;
+
+  Buffer::OwnedImpl retained;
+  testing::MockFunction<void()> done;
+  EXPECT_CALL(tracker1, Call());
+  EXPECT_CALL(done, Call());
+  retained.retainDrained(buffer, 2);
+  done.Call();
+  EXPECT_EQ("cd", buffer.toString());
+  EXPECT_EQ("abcd", retained.toString());
+  EXPECT_EQ(2, retained.getRawSlices().size());
+  EXPECT_EQ(storage, retained.getRawSlices()[1].mem_);
+
+  EXPECT_CALL(tracker2, Call());
+  buffer.drain(2);
+}
+
 TEST_F(OwnedImplTest, PartialMoveDrainTrackers) {
   testing::InSequence s;
 
@@ -864,6 +894,30 @@ TEST_F(OwnedImplTest, ReserveCommit) {
   }
 }
 
+// With huge page slabs, the buffers whose reads fill their reservations reserve slab slices, until
+// a read fits in one.
+TEST_F(OwnedImplTest, HugePageSlabsReadReservations) {
+  SlicePool::setHugePageSlabs(true);
+  Cleanup restore([]() { SlicePool::setHugePageSlabs(false); });
+  Buffer::OwnedImpl buffer;
+  // Reads the given length, and returns the length of the reservation and of its slices.
+  using Read = std::pair<uint64_t, uint64_t>;
+  auto read = [&buffer](uint64_t length) {
+    auto reservation = buffer.reserveForRead();
+    const Read result(reservation.length(), reservation.slices()[0].len_);
+    reservation.commit(std::min(length, reservation.length()));
+    buffer.drain(buffer.length());
+    return result;
+  };
+  const Read small(Reservation::MAX_SLICES_ * 16384, 16384);
+  const Read large(Reservation::MAX_SLICES_ * SlicePool::SlabSliceSize, SlicePool::SlabSliceSize);
+
+  EXPECT_EQ(small, read(UINT64_MAX));
+  EXPECT_EQ(large, read(SlicePool::SlabSliceSize));
+  EXPECT_EQ(large, read(1000));
+  EXPECT_EQ(small, read(UINT64_MAX));
+}
+
 TEST_F(OwnedImplTest, ReserveCommitReuse) {
   Buffer::OwnedImpl buffer;
 
@@ -0,0 +1,152 @@
+#include <vector>
+
+#include "common/buffer/slice_pool.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Buffer {
+namespace {
+
+class SlicePoolTest : public testing::Test {
+protected:
+  SlicePoolTest() : stats_(SlicePool::generateStats(store_)) {
+    // Start the counters from the activity of this test only.
+    SlicePool::setStats(&stats_);
+    SlicePool::flushStats();
+    stats_.slices_allocated_.reset();
+    stats_.slices_released_.reset();
+    stats_.slices_reused_.reset();
+    stats_.slabs_allocated_.reset();
+  }
+
+  ~SlicePoolTest() override {
+    SlicePool::setHugePageSlabs(false);
+    SlicePool::setMemoryPressure(false);
+    SlicePool::setStats(nullptr);
+  }
+
+  // Allocates the given number of slices, which empties the free list of their size first.
+  std::vector<SlicePool::StoragePtr> allocate(uint64_t capacity, uint32_t count) {
+    std::vector<SlicePool::StoragePtr> storages;
+    for (uint32_t i = 0; i < count; ++i) {
+      storages.push_back(SlicePool::allocate(capacity));
+    }
+    return storages;
+  }
+
+  void free(std::vector<SlicePool::StoragePtr>& storages, uint64_t capacity) {
+    for (auto& storage : storages) {
+      SlicePool::free(std::move(storage), capacity);
+    }
+    storages.clear();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  SlicePoolStats stats_;
+};
+
+// The storage of a freed slice is reused by the next slice of the same size.
+TEST_F(SlicePoolTest, Reuse) {
+  auto storages = allocate(16384, 1);
+  const uint8_t* storage = storages[0].get();
+  const uint64_t cached_slices = SlicePool::cachedSlices();
+  free(storages, 16384);
+  EXPECT_EQ(cached_slices + 1, SlicePool::cachedSlices());
+
+  storages = allocate(16384, 1);
+  EXPECT_EQ(storage, storages[0].get());
+  EXPECT_EQ(cached_slices, SlicePool::cachedSlices());
+  free(storages, 16384);
+}
+
+// Only the storage of the sizes of the pool is cached.
+TEST_F(SlicePoolTest, OtherSizes) {
+  const uint64_t cached_slices = SlicePool::cachedSlices();
+  auto storages = allocate(8192, 4);
+  free(storages, 8192);
+  EXPECT_EQ(cached_slices, SlicePool::cachedSlices());
+}
+
+// The free lists are capped by the high watermark, and trimmed down to the low watermark under
+// memory pressure.
+TEST_F(SlicePoolTest, Watermarks) {
+  const auto& size_class = SlicePool::SizeClasses[2];
+  ASSERT_EQ(65536, size_class.capacity_);
+  auto storages = allocate(65536, size_class.high_watermark_ + 4);
+  const uint64_t cached_slices = SlicePool::cachedSlices();
+  SlicePool::flushStats();
+  const uint64_t cached_bytes = stats_.cached_bytes_.value();
+  free(storages, 65536);
+  EXPECT_EQ(cached_slices + size_class.high_watermark_, SlicePool::cachedSlices());
+
+  SlicePool::flushStats();
+  EXPECT_EQ(4, stats_.slices_released_.value());
+  EXPECT_EQ(cached_bytes + size_class.high_watermark_ * 65536, stats_.cached_bytes_.value());
+
+  // The free lists of the other sizes are below their low watermark.
+  SlicePool::setMemoryPressure(true);
+  EXPECT_EQ(cached_slices + size_class.low_watermark_, SlicePool::cachedSlices());
+  EXPECT_EQ(4 + size_class.high_watermark_ - size_class.low_watermark_,
+            stats_.slices_released_.value());
+
+  // The cap stays at the low watermark until the pressure goes away.
+  storages = allocate(65536, size_class.high_watermark_);
+  free(storages, 65536);
+  EXPECT_EQ(cached_slices + size_class.low_watermark_, SlicePool::cachedSlices());
+
+  SlicePool::setMemoryPressure(false);
+  storages = allocate(65536, size_class.high_watermark_);
+  free(storages, 65536);
+  EXPECT_EQ(cached_slices + size_class.high_watermark_, SlicePool::cachedSlices());
+}
+
+// The stats of the pool are reported in batches.
+TEST_F(SlicePoolTest, Stats) {
+  auto storages = allocate(4096, 1);
+  free(storages, 4096);
+  storages = allocate(4096, 1);
+  free(storages, 4096);
+  SlicePool::flushStats();
+  EXPECT_LE(1, stats_.slices_reused_.value());
+  EXPECT_EQ(2, stats_.slices_allocated_.value() + stats_.slices_reused_.value());
+}
+
+// With huge page slabs, the slab slices are carved out of aligned slabs once their free list is
+// empty.
+TEST_F(SlicePoolTest, HugePageSlabs) {
+  SlicePool::setHugePageSlabs(true);
+  const auto& size_class = SlicePool::SizeClasses[2];
+  ASSERT_EQ(SlicePool::SlabSliceSize, size_class.capacity_);
+  auto cached = allocate(SlicePool::SlabSliceSize, size_class.high_watermark_);
+
+  const uint32_t slices_per_slab = SlicePool::SlabSize / SlicePool::SlabSliceSize;
+  auto storages = allocate(SlicePool::SlabSliceSize, slices_per_slab);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(storages[0].get()) % SlicePool::SlabSize);
+  for (uint32_t i = 1; i < slices_per_slab; ++i) {
+    EXPECT_EQ(storages[0].get() + i * SlicePool::SlabSliceSize, storages[i].get());
+  }
+  SlicePool::flushStats();
+  EXPECT_EQ(1, stats_.slabs_allocated_.value());
+
+  // The slab is exhausted, the next slice is carved out of a new one.
+  auto next = allocate(SlicePool::SlabSliceSize, 1);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(next[0].get()) % SlicePool::SlabSize);
+  SlicePool::flushStats();
+  EXPECT_EQ(2, stats_.slabs_allocated_.value());
+
+  // The other sizes are still allocated on the heap.
+  auto other = allocate(16384, 1);
+  EXPECT_EQ(nullptr, other[0].get_deleter().slab_);
+
+  free(other, 16384);
+  free(next, SlicePool::SlabSliceSize);
+  free(storages, SlicePool::SlabSliceSize);
+  free(cached, SlicePool::SlabSliceSize);
+}
+
+} // namespace
+} // namespace Buffer
+} // namespace Envoy
@@ -0,0 +1,93 @@
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common/common/arena_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+bool isAligned(const void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(ArenaImplTest, BumpAllocatesFromBlocks) {
+  ArenaImpl arena(64);
+  EXPECT_EQ(0, arena.blockCount());
+
+  char* first = static_cast<char*>(arena.allocate(1, 1));
+  EXPECT_EQ(1, arena.blockCount());
+  void* second = arena.allocate(8, 8);
+  EXPECT_EQ(first + 8, second);
+  void* third = arena.allocate(16, 16);
+  EXPECT_EQ(first + 16, third);
+  EXPECT_EQ(1, arena.blockCount());
+
+  void* fourth = arena.allocate(16, 16);
+  EXPECT_EQ(first + 32, fourth);
+  void* fifth = arena.allocate(16, 16);
+  EXPECT_EQ(first + 48, fifth);
+  void* sixth = arena.allocate(1, 1);
+  EXPECT_EQ(2, arena.blockCount());
+  EXPECT_TRUE(isAligned(sixth, alignof(std::max_align_t)));
+  EXPECT_EQ(1 + 8 + 16 + 16 + 16 + 1, arena.bytesAllocated());
+}
+
+TEST(ArenaImplTest, LargeAllocationsGetTheirOwnBlock) {
+  ArenaImpl arena(64);
+  char* small = static_cast<char*>(arena.allocate(4, 4));
+  void* large = arena.allocate(100, 8);
+  EXPECT_EQ(2, arena.blockCount());
+  EXPECT_TRUE(isAligned(large, alignof(std::max_align_t)));
+  // The current block is still used for small allocations.
+  EXPECT_EQ(small + 4, arena.allocate(4, 4));
+  EXPECT_EQ(2, arena.blockCount());
+}
+
+TEST(ArenaImplTest, Allocator) {
+  ArenaImpl arena;
+  {
+    std::shared_ptr<std::string> value = makeArenaShared<std::string>(&arena, "value");
+    EXPECT_EQ("value", *value);
+    EXPECT_EQ(1, arena.blockCount());
+  }
+  std::shared_ptr<std::string> value = makeArenaShared<std::string>(nullptr, "value");
+  EXPECT_EQ("value", *value);
+  EXPECT_EQ(1, arena.blockCount());
+
+  EXPECT_EQ(ArenaAllocator<int>(arena), ArenaAllocator<char>(arena));
+  ArenaImpl other;
+  EXPECT_NE(ArenaAllocator<int>(arena), ArenaAllocator<int>(other));
+}
+
+class TestObject : public ArenaAllocatable {
+public:
+  explicit TestObject(bool& destroyed) : destroyed_(destroyed) {}
+  ~TestObject() { destroyed_ = true; }
+
+private:
+  bool& destroyed_;
+  alignas(std::max_align_t) char data_[24];
+};
+
+TEST(ArenaAllocatableTest, HeapAndArena) {
+  bool destroyed = false;
+  auto heap_object = std::make_unique<TestObject>(destroyed);
+  EXPECT_TRUE(isAligned(heap_object.get(), alignof(TestObject)));
+  heap_object.reset();
+  EXPECT_TRUE(destroyed);
+
+  ArenaImpl arena;
+  destroyed = false;
+  std::unique_ptr<TestObject> arena_object(new (arena) TestObject(destroyed));
+  EXPECT_TRUE(isAligned(arena_object.get(), alignof(TestObject)));
+  EXPECT_EQ(1, arena.blockCount());
+  EXPECT_LT(sizeof(TestObject), arena.bytesAllocated());
+  arena_object.reset();
+  EXPECT_TRUE(destroyed);
+}
+
+} // namespace
+} // namespace Envoy
@@ -367,6 +367,78 @@ TEST(StringMatcher, SafeRegexValueIgnoreCase) {
                             "ignore_case has no effect for safe_regex.");
 }
 
+TEST(StringMatcherSet, Empty) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> matchers;
+  EXPECT_FALSE(Matchers::StringMatcherSetImpl(matchers).match(""));
+  EXPECT_FALSE(Matchers::StringMatcherSetImpl(matchers).match("value"));
+}
+
+TEST(StringMatcherSet, MatchAnyPattern) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> matchers;
+  matchers.Add()->set_exact("exact");
+  matchers.Add()->set_exact("other-exact");
+  matchers.Add()->set_prefix("x-");
+  matchers.Add()->set_prefix("x-envoy-");
+  matchers.Add()->set_suffix("-id");
+  matchers.Add()->set_contains("auth");
+  auto* regex = matchers.Add()->mutable_safe_regex();
+  regex->mutable_google_re2();
+  regex->set_regex("[0-9]+");
+  const Matchers::StringMatcherSetImpl set(matchers);
+
+  EXPECT_TRUE(set.match("exact"));
+  EXPECT_TRUE(set.match("other-exact"));
+  EXPECT_FALSE(set.match("EXACT"));
+  EXPECT_FALSE(set.match("exac"));
+  EXPECT_TRUE(set.match("x-"));
+  EXPECT_TRUE(set.match("x-envoy-original-path"));
+  EXPECT_FALSE(set.match("x"));
+  EXPECT_TRUE(set.match("request-id"));
+  EXPECT_FALSE(set.match("id"));
+  EXPECT_TRUE(set.match("authorization"));
+  EXPECT_TRUE(set.match("proxy-authenticate"));
+  EXPECT_TRUE(set.match("12345"));
+  EXPECT_FALSE(set.match("12345a"));
+  EXPECT_FALSE(set.match("content-type"));
+}
+
+TEST(StringMatcherSet, MatchIgnoreCase) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> matchers;
+  matchers.Add()->set_exact("Exact");
+  auto* matcher = matchers.Add();
+  matcher->set_exact("IgnoreCase");
+  matcher->set_ignore_case(true);
+  matcher = matchers.Add();
+  matcher->set_prefix("X-");
+  matcher->set_ignore_case(true);
+  matcher = matchers.Add();
+  matcher->set_suffix("-ID");
+  matcher->set_ignore_case(true);
+  matcher = matchers.Add();
+  matcher->set_contains("Auth");
+  matcher->set_ignore_case(true);
+  const Matchers::StringMatcherSetImpl set(matchers);
+
+  EXPECT_TRUE(set.match("Exact"));
+  EXPECT_FALSE(set.match("exact"));
+  EXPECT_TRUE(set.match("ignorecase"));
+  EXPECT_TRUE(set.match("IGNORECASE"));
+  EXPECT_TRUE(set.match("x-foo"));
+  EXPECT_TRUE(set.match("Request-Id"));
+  EXPECT_TRUE(set.match("AUTHORIZATION"));
+  EXPECT_FALSE(set.match("content-type"));
+}
+
+TEST(StringMatcherSet, RegexIgnoreCase) {
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> matchers;
+  auto* matcher = matchers.Add();
+  matcher->mutable_safe_regex()->mutable_google_re2();
+  matcher->mutable_safe_regex()->set_regex("foo");
+  matcher->set_ignore_case(true);
+  EXPECT_THROW_WITH_MESSAGE(Matchers::StringMatcherSetImpl(matchers).match("foo"), EnvoyException,
+                            "ignore_case has no effect for safe_regex.");
+}
+
 TEST(PathMatcher, MatchExactPath) {
   const auto matcher = Envoy::Matchers::PathMatcher::createExact("/exact", false);
 
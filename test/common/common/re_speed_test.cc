@@ -1,13 +1,18 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from
 // a quiescent system with disabled cstate power management.
 
+#include <memory>
 #include <regex>
+#include <string>
+#include <vector>
 
 #include "common/common/assert.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "benchmark/benchmark.h"
 #include "re2/re2.h"
+#include "re2/set.h"
 
 // NOLINT(namespace-envoy)
 
@@ -126,3 +131,51 @@ static void BM_RE2_AltPattern(benchmark::State& state) {
   RELEASE_ASSERT(passes > 0, "");
 }
 BENCHMARK(BM_RE2_AltPattern);
+
+// The path templates of the routes of a large virtual host, of which only the last one matches.
+static std::vector<std::string> routeRegexes(int count) {
+  std::vector<std::string> regexes;
+  for (int i = 0; i < count; ++i) {
+    regexes.push_back(absl::StrCat("/shelves/[^/]+/route_", i));
+  }
+  return regexes;
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_Sequential(benchmark::State& state) {
+  std::vector<std::unique_ptr<re2::RE2>> regexes;
+  for (const std::string& regex : routeRegexes(state.range(0))) {
+    regexes.push_back(std::make_unique<re2::RE2>(regex, re2::RE2::Quiet));
+  }
+  const std::string path = absl::StrCat("/shelves/shelf/route_", state.range(0) - 1);
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const auto& regex : regexes) {
+      if (re2::RE2::FullMatch(path, *regex)) {
+        ++passes;
+        break;
+      }
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_RE2_Sequential)->Arg(10)->Arg(100)->Arg(500);
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_RE2_Set(benchmark::State& state) {
+  re2::RE2::Set set(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH);
+  for (const std::string& regex : routeRegexes(state.range(0))) {
+    RELEASE_ASSERT(set.Add(regex, nullptr) >= 0, "");
+  }
+  RELEASE_ASSERT(set.Compile(), "");
+  const std::string path = absl::StrCat("/shelves/shelf/route_", state.range(0) - 1);
+  uint32_t passes = 0;
+  for (auto _ : state) { // NOLINT
+    std::vector<int> matches;
+    if (set.Match(path, &matches)) {
+      ++passes;
+    }
+  }
+  RELEASE_ASSERT(passes > 0, "");
+}
+BENCHMARK(BM_RE2_Set)->Arg(10)->Arg(100)->Arg(500);
@@ -41,6 +41,40 @@ TEST(Utility, ParseStdRegex) {
   }
 }
 
+TEST(Utility, ParseRegexSet) {
+  EXPECT_THROW_WITH_REGEX(Utility::parseRegexSet({"/foo", "(+invalid)"}), EnvoyException,
+                          "Invalid regex '\\(\\+invalid\\)': .+");
+
+  const auto matcher = Utility::parseRegexSet({"/foo/[0-9]+", "/bar", "/foo/.*", "/foo"});
+  std::vector<int> matches;
+  EXPECT_TRUE(matcher->match("/foo/1", matches));
+  EXPECT_EQ((std::vector<int>{0, 2}), matches);
+  EXPECT_TRUE(matcher->match("/foo", matches));
+  EXPECT_EQ((std::vector<int>{3}), matches);
+  // The regexes fully match the value.
+  EXPECT_TRUE(matcher->match("/bar/baz", matches));
+  EXPECT_TRUE(matches.empty());
+}
+
+// The matchers of identical regexes share their program, which outlives any one of them, and
+// invalid regexes are rejected every time.
+TEST(Utility, ParseIdenticalRegexes) {
+  envoy::type::matcher::v3::RegexMatcher matcher;
+  matcher.mutable_google_re2();
+  matcher.set_regex("/shared/.*");
+  auto first_matcher = Utility::parseRegex(matcher);
+  const auto second_matcher = Utility::parseRegex(matcher);
+  first_matcher.reset();
+  EXPECT_TRUE(second_matcher->match("/shared/path"));
+  EXPECT_EQ("/other/path", second_matcher->replaceAll("/shared/path", "/other/path"));
+
+  matcher.set_regex("(+invalid)");
+  for (int i = 0; i < 2; i++) {
+    EXPECT_THROW_WITH_MESSAGE(Utility::parseRegex(matcher), EnvoyException,
+                              "no argument for repetition operator: +");
+  }
+}
+
 TEST(Utility, ParseRegex) {
   {
     envoy::type::matcher::v3::RegexMatcher matcher;
@@ -1023,6 +1023,40 @@ TEST(TrieLookupTable, LongestPrefix) {
   EXPECT_EQ(nullptr, trie.findLongestPrefix("toto"));
   EXPECT_EQ(nullptr, trie.find(" "));
   EXPECT_EQ(nullptr, trie.findLongestPrefix(" "));
+
+  // The key ends within a longer prefix.
+  EXPECT_TRUE(trie.add("foobar", cstr_c));
+  EXPECT_EQ(cstr_a, trie.findLongestPrefix("fooba"));
+  EXPECT_EQ(cstr_a, trie.findLongestPrefix(absl::string_view("foobar").substr(0, 5)));
+  EXPECT_EQ(cstr_c, trie.findLongestPrefix("foobar"));
+}
+
+TEST(PerfectHashLookupTable, Find) {
+  PerfectHashLookupTable<int> table;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 100; ++i) {
+    keys.push_back(absl::StrCat("key-", i));
+    EXPECT_TRUE(table.add(keys.back(), i));
+  }
+  EXPECT_FALSE(table.add("key-0", 100));
+  table.build();
+  EXPECT_EQ(100, table.size());
+
+  for (int i = 0; i < 100; ++i) {
+    const int* value = table.find(keys[i]);
+    ASSERT_NE(nullptr, value);
+    EXPECT_EQ(i, *value);
+  }
+  EXPECT_EQ(nullptr, table.find("key-100"));
+  EXPECT_EQ(nullptr, table.find("key"));
+  EXPECT_EQ(nullptr, table.find(""));
+}
+
+TEST(PerfectHashLookupTable, Empty) {
+  PerfectHashLookupTable<int> table;
+  table.build();
+  EXPECT_EQ(0, table.size());
+  EXPECT_EQ(nullptr, table.find("foo"));
 }
 
 TEST(InlineStorageTest, InlineString) {
@@ -5,7 +5,9 @@
 
 #include "gtest/gtest.h"
 
+using ::testing::_;
 using ::testing::InvokeWithoutArgs;
+using ::testing::NiceMock;
 using ::testing::Return;
 
 namespace Envoy {
@@ -80,6 +82,31 @@ TEST(DecodedResourceImplTest, All) {
   }
 }
 
+// The hash of a resource comes from its encoding, and the Resource wrapper isn't part of it.
+TEST(DecodedResourceImplTest, Hash) {
+  NiceMock<MockOpaqueResourceDecoder> resource_decoder;
+  ON_CALL(resource_decoder, decodeResource(_))
+      .WillByDefault(InvokeWithoutArgs(
+          []() -> ProtobufTypes::MessagePtr { return std::make_unique<ProtobufWkt::Empty>(); }));
+  ProtobufWkt::Any resource;
+  resource.set_type_url("some_type_url");
+  resource.set_value("some_value");
+  ProtobufWkt::Any other_resource = resource;
+  other_resource.set_value("other_value");
+
+  const auto decoded_resource = DecodedResourceImpl::fromResource(resource_decoder, resource, "1");
+  EXPECT_EQ(decoded_resource->hash(),
+            DecodedResourceImpl::fromResource(resource_decoder, resource, "2")->hash());
+  EXPECT_NE(decoded_resource->hash(),
+            DecodedResourceImpl::fromResource(resource_decoder, other_resource, "1")->hash());
+
+  envoy::service::discovery::v3::Resource resource_wrapper;
+  resource_wrapper.set_name("real_name");
+  resource_wrapper.mutable_resource()->MergeFrom(resource);
+  EXPECT_EQ(decoded_resource->hash(),
+            DecodedResourceImpl(resource_decoder, resource_wrapper).hash());
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
@@ -21,6 +21,7 @@
 #include "test/mocks/grpc/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/test_common/environment.h"
 #include "test/test_common/logging.h"
 #include "test/test_common/resources.h"
 #include "test/test_common/simulated_time_system.h"
@@ -60,6 +61,7 @@ public:
   void setup() {
     grpc_mux_ = std::make_unique<GrpcMuxImpl>(
         local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+        Thread::threadFactoryForTest(),
         *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
             "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
         envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, rate_limit_settings_, true);
@@ -68,6 +70,7 @@ public:
   void setup(const RateLimitSettings& custom_rate_limit_settings) {
     grpc_mux_ = std::make_unique<GrpcMuxImpl>(
         local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+        Thread::threadFactoryForTest(),
         *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
             "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
         envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, custom_rate_limit_settings,
@@ -492,6 +495,147 @@ TEST_F(GrpcMuxImplTest, WildcardWatch) {
   }
 }
 
+// The snapshot is applied before the management server answers, and the request of the watch
+// doesn't acknowledge its version. The responses of the management server replace it.
+TEST_F(GrpcMuxImplTest, Snapshot) {
+  setup();
+
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  const std::string path = TestEnvironment::temporaryPath("grpc_mux_xds_snapshot");
+  envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+  load_assignment.set_cluster_name("x");
+  envoy::service::discovery::v3::DiscoveryResponse snapshot_response;
+  snapshot_response.set_type_url(type_url);
+  snapshot_response.set_version_info("1");
+  snapshot_response.add_resources()->PackFrom(load_assignment);
+  TestEnvironment::writeStringToFileForTest(
+      path,
+      XdsSnapshot::serialize("test_version", {{type_url, snapshot_response.SerializeAsString()}}),
+      true);
+
+  // The timers are matched in the reverse order of their creation.
+  auto* snapshot_timer = new Event::MockTimer(&dispatcher_);
+  auto* write_timer = new Event::MockTimer(&dispatcher_);
+  Api::ApiPtr api = Api::createApiForTest();
+  grpc_mux_->setSnapshot(
+      std::make_unique<XdsSnapshot>(path, "test_version", dispatcher_, api->fileSystem()));
+
+  InSequence s;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  auto foo_sub = grpc_mux_->addWatch(type_url, {"x"}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {"x"}, "", true);
+  grpc_mux_->start();
+
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([&load_assignment](const std::vector<DecodedResourceRef>& resources,
+                                          const std::string&) {
+        EXPECT_EQ(1, resources.size());
+        EXPECT_TRUE(TestUtility::protoEqual(resources[0].get().resource(), load_assignment));
+      }));
+  snapshot_timer->invokeCallback();
+
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("2");
+  response->add_resources()->PackFrom(load_assignment);
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "2"));
+  expectSendMessage(type_url, {"x"}, "2");
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+
+  write_timer->invokeCallback();
+  std::string build_version;
+  absl::btree_map<std::string, std::string> serialized_responses;
+  EXPECT_TRUE(XdsSnapshot::parse(api->fileSystem().fileReadToEnd(path), build_version,
+                                 serialized_responses));
+  envoy::service::discovery::v3::DiscoveryResponse saved_response;
+  saved_response.ParseFromString(serialized_responses[type_url]);
+  EXPECT_EQ("2", saved_response.version_info());
+}
+
+// Large responses are parsed in parallel, and delivered in order.
+TEST_F(GrpcMuxImplTest, ParallelParsing) {
+  setup();
+
+  InSequence s;
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  const uint32_t resource_count = 4 * ParallelResourceParser::MinResourcesPerThread + 1;
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  for (uint32_t i = 0; i < resource_count; i++) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(absl::StrCat("x", i));
+    if (i % 2 == 0) {
+      response->add_resources()->PackFrom(load_assignment);
+      continue;
+    }
+    // Half of the resources are wrapped in a Resource.
+    envoy::service::discovery::v3::Resource resource;
+    resource.set_name(absl::StrCat("x", i));
+    resource.mutable_resource()->PackFrom(load_assignment);
+    response->add_resources()->PackFrom(resource);
+  }
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, "1"))
+      .WillOnce(Invoke([resource_count](const std::vector<DecodedResourceRef>& resources,
+                                        const std::string&) {
+        ASSERT_EQ(resource_count, resources.size());
+        for (uint32_t i = 0; i < resource_count; i++) {
+          EXPECT_EQ(absl::StrCat("x", i), resources[i].get().name());
+          EXPECT_EQ(absl::StrCat("x", i),
+                    dynamic_cast<const envoy::config::endpoint::v3::ClusterLoadAssignment&>(
+                        resources[i].get().resource())
+                        .cluster_name());
+        }
+      }));
+  expectSendMessage(type_url, {}, "1");
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+}
+
+// A large response is rejected for the first invalid resource, as when it's parsed serially.
+TEST_F(GrpcMuxImplTest, ParallelParsingRejected) {
+  setup();
+
+  const std::string& type_url = Config::TypeUrl::get().ClusterLoadAssignment;
+  TestUtility::TestOpaqueResourceDecoderImpl<envoy::config::endpoint::v3::ClusterLoadAssignment>
+      resource_decoder("cluster_name");
+  auto foo_sub = grpc_mux_->addWatch(type_url, {}, callbacks_, resource_decoder, {});
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage(type_url, {}, "", true);
+  grpc_mux_->start();
+
+  const uint32_t resource_count = 4 * ParallelResourceParser::MinResourcesPerThread;
+  auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+  response->set_type_url(type_url);
+  response->set_version_info("1");
+  for (uint32_t i = 0; i < resource_count; i++) {
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name(absl::StrCat("x", i));
+    if (i == resource_count - 2) {
+      // An unknown field is reported before the constraint violation of a later resource.
+      load_assignment.GetReflection()->MutableUnknownFields(&load_assignment)->AddFixed32(1000, 1);
+    } else if (i == resource_count - 1) {
+      load_assignment.clear_cluster_name();
+    }
+    response->add_resources()->PackFrom(load_assignment);
+  }
+  EXPECT_CALL(callbacks_, onConfigUpdate(_, _)).Times(0);
+  EXPECT_CALL(callbacks_, onConfigUpdateFailed(_, _))
+      .WillOnce(Invoke([](Envoy::Config::ConfigUpdateFailureReason, const EnvoyException* e) {
+        EXPECT_TRUE(IsSubstring("", "", "has unknown fields", e->what()));
+      }));
+  EXPECT_CALL(async_stream_, sendMessageRaw_(_, false));
+  grpc_mux_->grpcStreamForTest().onReceiveMessage(std::move(response));
+}
+
 // Validate behavior when watches specify resources (potentially overlapping).
 TEST_F(GrpcMuxImplTest, WatchDemux) {
   setup();
@@ -849,6 +993,7 @@ TEST_F(GrpcMuxImplTest, BadLocalInfoEmptyClusterName) {
   EXPECT_THROW_WITH_MESSAGE(
       GrpcMuxImpl(
           local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+          Thread::threadFactoryForTest(),
           *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
               "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
           envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, rate_limit_settings_, true),
@@ -862,6 +1007,7 @@ TEST_F(GrpcMuxImplTest, BadLocalInfoEmptyNodeName) {
   EXPECT_THROW_WITH_MESSAGE(
       GrpcMuxImpl(
           local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+          Thread::threadFactoryForTest(),
           *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
               "envoy.service.discovery.v2.AggregatedDiscoveryService.StreamAggregatedResources"),
           envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, rate_limit_settings_, true),
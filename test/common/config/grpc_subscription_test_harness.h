@@ -51,7 +51,7 @@ public:
 
     mux_ = std::make_shared<Config::GrpcMuxImpl>(
         local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
-        *method_descriptor_, envoy::config::core::v3::ApiVersion::AUTO, random_, stats_store_,
+        Thread::threadFactoryForTest(), *method_descriptor_, envoy::config::core::v3::ApiVersion::AUTO, random_, stats_store_,
         rate_limit_settings_, true);
     subscription_ = std::make_unique<GrpcSubscriptionImpl>(
         mux_, callbacks_, resource_decoder_, stats_, Config::TypeUrl::get().ClusterLoadAssignment,
@@ -101,6 +101,59 @@ TEST_F(OpaqueResourceDecoderImplTest, Success) {
   EXPECT_EQ("foo", result.second);
 }
 
+// The parse step unpacks the resource, and leaves the reporting of its constraint violations to
+// the check step.
+TEST_F(OpaqueResourceDecoderImplTest, ParseAndCheck) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_resource;
+  cluster_resource.set_cluster_name("foo");
+  ProtobufWkt::Any opaque_resource;
+  opaque_resource.PackFrom(cluster_resource);
+  std::string error;
+  const auto parsed_resource = resource_decoder_.parseResource(opaque_resource, error);
+  ASSERT_NE(nullptr, parsed_resource);
+  EXPECT_THAT(*parsed_resource, ProtoEq(cluster_resource));
+  EXPECT_EQ("", error);
+  resource_decoder_.checkResource(opaque_resource, *parsed_resource, error);
+
+  opaque_resource.PackFrom(envoy::config::endpoint::v3::ClusterLoadAssignment());
+  const auto invalid_resource = resource_decoder_.parseResource(opaque_resource, error);
+  ASSERT_NE(nullptr, invalid_resource);
+  EXPECT_NE("", error);
+  EXPECT_THROW(resource_decoder_.checkResource(opaque_resource, *invalid_resource, error),
+               ProtoValidationException);
+}
+
+// Unknown fields are reported by the check step.
+TEST_F(OpaqueResourceDecoderImplTest, CheckUnknownField) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment strange_resource;
+  strange_resource.set_cluster_name("fare");
+  strange_resource.GetReflection()->MutableUnknownFields(&strange_resource)->AddFixed32(1000, 1);
+  ProtobufWkt::Any opaque_resource;
+  opaque_resource.PackFrom(strange_resource);
+  std::string error;
+  const auto parsed_resource = resource_decoder_.parseResource(opaque_resource, error);
+  ASSERT_NE(nullptr, parsed_resource);
+  EXPECT_THROW_WITH_REGEX(resource_decoder_.checkResource(opaque_resource, *parsed_resource, error),
+                          EnvoyException, "unknown field");
+}
+
+// Resources of another type or of an earlier API version are left to decodeResource().
+TEST_F(OpaqueResourceDecoderImplTest, ParseFallback) {
+  ProtobufWkt::Any opaque_resource;
+  std::string error;
+  opaque_resource.set_type_url("huh");
+  EXPECT_EQ(nullptr, resource_decoder_.parseResource(opaque_resource, error));
+  opaque_resource.set_type_url("type.googleapis.com/envoy.api.v2.ClusterLoadAssignment");
+  EXPECT_EQ(nullptr, resource_decoder_.parseResource(opaque_resource, error));
+
+  // An empty Any is parsed into the default instance, without checks.
+  opaque_resource.Clear();
+  const auto parsed_resource = resource_decoder_.parseResource(opaque_resource, error);
+  ASSERT_NE(nullptr, parsed_resource);
+  EXPECT_EQ("", error);
+  resource_decoder_.checkResource(opaque_resource, *parsed_resource, error);
+}
+
 } // namespace
 } // namespace Config
 } // namespace Envoy
@@ -0,0 +1,117 @@
+#include <cstdio>
+
+#include "envoy/config/endpoint/v3/endpoint.pb.h"
+#include "envoy/service/discovery/v3/discovery.pb.h"
+
+#include "common/config/xds_snapshot.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Config {
+namespace {
+
+const char TypeUrl[] = "type.googleapis.com/envoy.config.endpoint.v3.ClusterLoadAssignment";
+
+class XdsSnapshotTest : public testing::Test {
+public:
+  XdsSnapshotTest()
+      : api_(Api::createApiForTest()), path_(TestEnvironment::temporaryPath("xds_snapshot")) {
+    std::remove(path_.c_str());
+  }
+
+  static envoy::service::discovery::v3::DiscoveryResponse response(const std::string& version) {
+    envoy::service::discovery::v3::DiscoveryResponse response;
+    response.set_type_url(TypeUrl);
+    response.set_version_info(version);
+    response.set_nonce("nonce");
+    envoy::config::endpoint::v3::ClusterLoadAssignment load_assignment;
+    load_assignment.set_cluster_name("x");
+    response.add_resources()->PackFrom(load_assignment);
+    return response;
+  }
+
+  void writeSnapshot(const std::string& build_version, const std::string& version) {
+    TestEnvironment::writeStringToFileForTest(
+        path_,
+        XdsSnapshot::serialize(build_version, {{TypeUrl, response(version).SerializeAsString()}}),
+        true);
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Api::ApiPtr api_;
+  const std::string path_;
+};
+
+// The responses recorded are written once, after a delay, and loaded by the next Envoy.
+TEST_F(XdsSnapshotTest, WriteAndLoad) {
+  auto* write_timer = new Event::MockTimer(&dispatcher_);
+  XdsSnapshot snapshot(path_, "test_version", dispatcher_, api_->fileSystem());
+  EXPECT_EQ(nullptr, snapshot.takeResponse(TypeUrl));
+
+  EXPECT_CALL(*write_timer, enableTimer(XdsSnapshot::WriteDelay, _));
+  snapshot.recordResponse(TypeUrl, response("1"));
+  snapshot.recordResponse(TypeUrl, response("2"));
+  EXPECT_FALSE(api_->fileSystem().fileExists(path_));
+  write_timer->invokeCallback();
+  EXPECT_FALSE(api_->fileSystem().fileExists(path_ + ".tmp"));
+
+  XdsSnapshot loaded(path_, "test_version", dispatcher_, api_->fileSystem());
+  EXPECT_TRUE(loaded.trusted());
+  auto loaded_response = loaded.takeResponse(TypeUrl);
+  ASSERT_NE(nullptr, loaded_response);
+  EXPECT_EQ("2", loaded_response->version_info());
+  // The nonce belongs to the stream of the previous Envoy.
+  EXPECT_EQ("", loaded_response->nonce());
+  EXPECT_EQ(1, loaded_response->resources_size());
+  EXPECT_EQ(nullptr, loaded.takeResponse(TypeUrl));
+}
+
+// A snapshot written by another build is applied, but its resources are fully checked.
+TEST_F(XdsSnapshotTest, OtherBuild) {
+  writeSnapshot("other_version", "1");
+  XdsSnapshot snapshot(path_, "test_version", dispatcher_, api_->fileSystem());
+  EXPECT_FALSE(snapshot.trusted());
+  EXPECT_NE(nullptr, snapshot.takeResponse(TypeUrl));
+}
+
+// A snapshot whose content doesn't match its hash is ignored.
+TEST_F(XdsSnapshotTest, Corrupted) {
+  std::string content =
+      XdsSnapshot::serialize("test_version", {{TypeUrl, response("1").SerializeAsString()}});
+  content.back() ^= 1;
+  TestEnvironment::writeStringToFileForTest(path_, content, true);
+
+  XdsSnapshot snapshot(path_, "test_version", dispatcher_, api_->fileSystem());
+  EXPECT_FALSE(snapshot.trusted());
+  EXPECT_EQ(nullptr, snapshot.takeResponse(TypeUrl));
+}
+
+TEST_F(XdsSnapshotTest, Parse) {
+  std::string build_version;
+  absl::btree_map<std::string, std::string> serialized_responses;
+  EXPECT_FALSE(XdsSnapshot::parse("", build_version, serialized_responses));
+  EXPECT_FALSE(XdsSnapshot::parse("XDSSNAP0aaaaaaaa", build_version, serialized_responses));
+
+  const std::string content =
+      XdsSnapshot::serialize("test_version", {{TypeUrl, response("1").SerializeAsString()}});
+  // A truncated snapshot is rejected by its hash.
+  EXPECT_FALSE(XdsSnapshot::parse(content.substr(0, content.size() - 1), build_version,
+                                  serialized_responses));
+  EXPECT_TRUE(XdsSnapshot::parse(content, build_version, serialized_responses));
+  EXPECT_EQ("test_version", build_version);
+  EXPECT_EQ(1, serialized_responses.size());
+  EXPECT_EQ(response("1").SerializeAsString(), serialized_responses[TypeUrl]);
+}
+
+} // namespace
+} // namespace Config
+} // namespace Envoy
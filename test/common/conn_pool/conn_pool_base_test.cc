@@ -4,6 +4,7 @@
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/mocks/upstream/host.h"
+#include "test/test_common/simulated_time_system.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -115,6 +116,47 @@ TEST_F(ConnPoolImplBaseTest, BasicPreconnect) {
   pool_.destructAllConnections();
 }
 
+class ConnPoolImplBaseRateTest : public Event::TestUsingSimulatedTime,
+                                 public ConnPoolImplBaseTest {
+public:
+  ConnPoolImplBaseRateTest() {
+    ON_CALL(*cluster_, rateBasedPreconnectWindow)
+        .WillByDefault(Return(std::chrono::milliseconds(100)));
+  }
+};
+
+TEST_F(ConnPoolImplBaseRateTest, PreconnectForStreamArrivals) {
+  // The first stream gets its own connection, and there is one more for the next one.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 2 /*connecting capacity*/);
+
+  // Two streams arrived in this window, so keep two spare connections.
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(2);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 2 /*pending*/, 4 /*connecting capacity*/);
+
+  // After two quiet windows, only the new stream is expected again, and a spare connection is
+  // still there for it.
+  simTime().advanceTimeWait(std::chrono::milliseconds(250));
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(0);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 3 /*pending*/, 4 /*connecting capacity*/);
+
+  EXPECT_CALL(pool_, onPoolFailure).Times(3);
+  pool_.destructAllConnections();
+}
+
+TEST_F(ConnPoolImplBaseRateTest, NoPreconnectForStreamArrivalsIfUnhealthy) {
+  host_->healthFlagSet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(1);
+  pool_.newStream(context_);
+  CHECK_STATE(0 /*active*/, 1 /*pending*/, 1 /*connecting capacity*/);
+
+  EXPECT_CALL(pool_, onPoolFailure).Times(1);
+  pool_.destructAllConnections();
+}
+
 TEST_F(ConnPoolImplBaseTest, PreconnectOnDisconnect) {
   testing::InSequence s;
 
@@ -1,4 +1,6 @@
 #include <functional>
+#include <list>
+#include <vector>
 
 #include "envoy/common/scope_tracker.h"
 #include "envoy/thread/thread.h"
@@ -319,6 +321,29 @@ TEST(DeferredDeleteTest, DeferredDeleteAndPostOrdering) {
   dispatcher->run(Dispatcher::RunType::NonBlock);
 }
 
+// With a budget, each run of the deferred deletion deletes up to the budget, and the rest of the
+// objects in the next iterations, in FIFO order.
+TEST(DeferredDeleteTest, DeferredDeleteBudget) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.dispatcher.max_deferred_deletes_per_iteration", "2"}});
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher("test_thread"));
+
+  std::vector<int> deleted;
+  for (int i = 0; i < 5; ++i) {
+    dispatcher->deferredDelete(
+        std::make_unique<TestDeferredDeletable>([&deleted, i]() -> void { deleted.push_back(i); }));
+  }
+  // The post callbacks run after a budgeted run of the deferred deletion.
+  size_t deleted_before_post = 0;
+  dispatcher->post([&]() { deleted_before_post = deleted.size(); });
+  dispatcher->run(Dispatcher::RunType::Block);
+
+  EXPECT_EQ(2, deleted_before_post);
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), deleted);
+}
+
 class DispatcherImplTest : public testing::Test {
 protected:
   DispatcherImplTest()
@@ -389,6 +414,28 @@ TEST_F(DispatcherImplTest, InitializeStats) {
   dispatcher_->initializeStats(scope_, "test.");
 }
 
+TEST_F(DispatcherImplTest, LoopUtilization) {
+  EXPECT_FALSE(dispatcher_->loopUtilization().has_value());
+  dispatcher_->initializeStats(scope_, "test.");
+
+  // Stats are initialized from a posted callback, so they are by the time this one runs.
+  dispatcher_->post([this]() {
+    {
+      Thread::LockGuard lock(mu_);
+      work_finished_ = true;
+    }
+    cv_.notifyOne();
+  });
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  const absl::optional<double> utilization = dispatcher_->loopUtilization();
+  ASSERT_TRUE(utilization.has_value());
+  EXPECT_GE(utilization.value(), 0);
+  EXPECT_LE(utilization.value(), 1);
+}
+
 TEST_F(DispatcherImplTest, Post) {
   dispatcher_->post([this]() {
     {
@@ -405,6 +452,28 @@ TEST_F(DispatcherImplTest, Post) {
   }
 }
 
+TEST_F(DispatcherImplTest, PostBatch) {
+  std::vector<int> run_order;
+  std::list<PostCb> callbacks;
+  for (int i = 0; i < 3; ++i) {
+    callbacks.push_back([this, &run_order, i]() {
+      Thread::LockGuard lock(mu_);
+      run_order.push_back(i);
+      if (run_order.size() == 3) {
+        work_finished_ = true;
+        cv_.notifyOne();
+      }
+    });
+  }
+  dispatcher_->postBatch(std::move(callbacks));
+
+  Thread::LockGuard lock(mu_);
+  while (!work_finished_) {
+    cv_.wait(mu_);
+  }
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), run_order);
+}
+
 TEST_F(DispatcherImplTest, PostExecuteAndDestructOrder) {
   ReadyWatcher parent_watcher;
   ReadyWatcher deferred_delete_watcher;
@@ -1587,6 +1656,58 @@ TEST_F(DispatcherWithWatchdogTest, TouchBeforeFdEvent) {
   dispatcher_->run(Dispatcher::RunType::NonBlock);
 }
 
+class DispatcherSlowCallbackTest : public testing::Test {
+protected:
+  DispatcherSlowCallbackTest()
+      : api_(Api::createApiForTest(time_system_)),
+        dispatcher_(api_->allocateDispatcher("test_thread")) {
+    api_->slowCallbackLog().setThreshold(std::chrono::milliseconds(10));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+// The callbacks running for longer than the threshold are recorded with the object they ran for.
+TEST_F(DispatcherSlowCallbackTest, RecordsSlowCallbacks) {
+  MessageTrackedObject timer_object("timer object");
+  MessageTrackedObject post_object("post object");
+
+  auto timer = dispatcher_->createTimer(
+      [&]() { time_system_.advanceTimeAsync(std::chrono::milliseconds(20)); });
+  timer->enableTimer(std::chrono::milliseconds(0), &timer_object);
+  dispatcher_->post([&]() {
+    // The object is captured before it's popped at the end of the callback.
+    ScopeTrackerScopeState scope(&post_object, *dispatcher_);
+    time_system_.advanceTimeAsync(std::chrono::milliseconds(15));
+  });
+  dispatcher_->post([&]() { time_system_.advanceTimeAsync(std::chrono::milliseconds(5)); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+
+  const std::vector<SlowCallback> callbacks = api_->slowCallbackLog().recentCallbacks();
+  ASSERT_EQ(2, callbacks.size());
+  // The timer and the post callbacks may run in either order.
+  const bool timer_first = callbacks[0].type_ == SlowCallback::Type::Timer;
+  const SlowCallback& timer_callback = callbacks[timer_first ? 0 : 1];
+  const SlowCallback& post_callback = callbacks[timer_first ? 1 : 0];
+  EXPECT_EQ("test_thread", timer_callback.dispatcher_name_);
+  EXPECT_EQ(SlowCallback::Type::Timer, timer_callback.type_);
+  EXPECT_EQ(std::chrono::milliseconds(20), timer_callback.duration_);
+  EXPECT_EQ("timer object", timer_callback.tracked_object_);
+  EXPECT_EQ(SlowCallback::Type::Post, post_callback.type_);
+  EXPECT_EQ(std::chrono::milliseconds(15), post_callback.duration_);
+  EXPECT_EQ("post object", post_callback.tracked_object_);
+}
+
+// Nothing is recorded once the threshold is reset.
+TEST_F(DispatcherSlowCallbackTest, Disabled) {
+  api_->slowCallbackLog().setThreshold(std::chrono::microseconds(0));
+  dispatcher_->post([&]() { time_system_.advanceTimeAsync(std::chrono::milliseconds(20)); });
+  dispatcher_->run(Dispatcher::RunType::NonBlock);
+  EXPECT_TRUE(api_->slowCallbackLog().recentCallbacks().empty());
+}
+
 } // namespace
 } // namespace Event
 } // namespace Envoy
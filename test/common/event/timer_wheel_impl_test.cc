@@ -0,0 +1,160 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "envoy/event/timer.h"
+
+#include "common/event/dispatcher_impl.h"
+#include "common/event/timer_wheel_impl.h"
+
+#include "test/mocks/common.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Event {
+namespace {
+
+using testing::ElementsAre;
+using testing::MockFunction;
+
+class TimerWheelTest : public testing::Test, public TestUsingSimulatedTime {
+public:
+  TimerWheelTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  // Creates a timer of the wheel that records its name when it fires.
+  TimerPtr createTimer(TimerWheel& wheel, std::vector<std::string>& fired, std::string name) {
+    return wheel.createTimer([&fired, name]() { fired.push_back(name); });
+  }
+
+  void advance(std::chrono::milliseconds duration) {
+    simTime().advanceTimeAndRun(duration, *dispatcher_, Dispatcher::RunType::Block);
+  }
+
+  Api::ApiPtr api_;
+  DispatcherPtr dispatcher_;
+};
+
+TEST_F(TimerWheelTest, FiresAtDeadline) {
+  TimerWheel wheel(*dispatcher_, std::chrono::milliseconds(10));
+  MockFunction<TimerCb> callback;
+  TimerPtr timer = wheel.createTimer(callback.AsStdFunction());
+
+  // The deadline isn't rounded to the ticks of the wheel.
+  timer->enableTimer(std::chrono::milliseconds(25));
+  EXPECT_TRUE(timer->enabled());
+  EXPECT_EQ(1UL, wheel.size());
+  advance(std::chrono::milliseconds(24));
+
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0UL, wheel.size());
+}
+
+TEST_F(TimerWheelTest, EnableAndDisable) {
+  TimerWheel wheel(*dispatcher_, std::chrono::milliseconds(1));
+  MockFunction<TimerCb> callback;
+  TimerPtr timer = wheel.createTimer(callback.AsStdFunction());
+
+  timer->enableTimer(std::chrono::milliseconds(10));
+  timer->disableTimer();
+  EXPECT_FALSE(timer->enabled());
+  EXPECT_EQ(0UL, wheel.size());
+  advance(std::chrono::milliseconds(20));
+
+  // Enabling an enabled timer moves its deadline.
+  timer->enableTimer(std::chrono::milliseconds(10));
+  timer->enableTimer(std::chrono::milliseconds(30));
+  EXPECT_EQ(1UL, wheel.size());
+  advance(std::chrono::milliseconds(29));
+  EXPECT_CALL(callback, Call());
+  advance(std::chrono::milliseconds(1));
+}
+
+// The timers fire in the order of their deadlines, and in the order they were enabled for the
+// same deadline.
+TEST_F(TimerWheelTest, Ordering) {
+  TimerWheel wheel(*dispatcher_, std::chrono::milliseconds(10));
+  std::vector<std::string> fired;
+  TimerPtr timer1 = createTimer(wheel, fired, "1");
+  TimerPtr timer2 = createTimer(wheel, fired, "2");
+  TimerPtr timer3 = createTimer(wheel, fired, "3");
+  TimerPtr timer4 = createTimer(wheel, fired, "4");
+
+  timer1->enableTimer(std::chrono::milliseconds(8));
+  timer2->enableTimer(std::chrono::milliseconds(5));
+  timer3->enableTimer(std::chrono::milliseconds(8));
+  timer4->enableHRTimer(std::chrono::microseconds(4500));
+  advance(std::chrono::milliseconds(20));
+  EXPECT_THAT(fired, ElementsAre("4", "2", "1", "3"));
+}
+
+// The timers of the higher levels are cascaded down to fire at their deadline, including the ones
+// beyond the range of the wheel.
+TEST_F(TimerWheelTest, Cascade) {
+  TimerWheel wheel(*dispatcher_, std::chrono::milliseconds(1));
+  std::vector<std::string> fired;
+  TimerPtr timer1 = createTimer(wheel, fired, "1");
+  TimerPtr timer2 = createTimer(wheel, fired, "2");
+  TimerPtr timer3 = createTimer(wheel, fired, "3");
+
+  timer1->enableTimer(std::chrono::milliseconds(300));
+  timer2->enableTimer(std::chrono::seconds(100));
+  timer3->enableTimer(std::chrono::hours(24 * 60));
+
+  advance(std::chrono::milliseconds(299));
+  EXPECT_TRUE(fired.empty());
+  advance(std::chrono::milliseconds(1));
+  EXPECT_THAT(fired, ElementsAre("1"));
+
+  advance(std::chrono::milliseconds(100000 - 301));
+  EXPECT_THAT(fired, ElementsAre("1"));
+  advance(std::chrono::milliseconds(1));
+  EXPECT_THAT(fired, ElementsAre("1", "2"));
+
+  advance(std::chrono::hours(24 * 60) - std::chrono::milliseconds(100001));
+  EXPECT_THAT(fired, ElementsAre("1", "2"));
+  advance(std::chrono::milliseconds(1));
+  EXPECT_THAT(fired, ElementsAre("1", "2", "3"));
+}
+
+// The callbacks may disable the other timers expiring at the same time, and the timers they enable
+// fire after them.
+TEST_F(TimerWheelTest, EnableAndDisableInCallback) {
+  TimerWheel wheel(*dispatcher_, std::chrono::milliseconds(10));
+  std::vector<std::string> fired;
+  TimerPtr timer2 = createTimer(wheel, fired, "2");
+  TimerPtr timer3 = createTimer(wheel, fired, "3");
+  TimerPtr timer1 = wheel.createTimer([&]() {
+    fired.push_back("1");
+    timer2->disableTimer();
+    timer3->enableTimer(std::chrono::milliseconds(0));
+  });
+
+  timer1->enableTimer(std::chrono::milliseconds(5));
+  timer2->enableTimer(std::chrono::milliseconds(5));
+  advance(std::chrono::milliseconds(5));
+  EXPECT_THAT(fired, ElementsAre("1", "3"));
+  EXPECT_EQ(0UL, wheel.size());
+}
+
+// The wheel timers of the dispatcher share its wheel.
+TEST_F(TimerWheelTest, DispatcherWheelTimers) {
+  std::vector<std::string> fired;
+  TimerPtr timer1 = dispatcher_->createWheelTimer([&fired]() { fired.push_back("1"); });
+  TimerPtr timer2 = dispatcher_->createWheelTimer([&fired]() { fired.push_back("2"); });
+
+  timer1->enableTimer(std::chrono::seconds(2));
+  timer2->enableTimer(std::chrono::seconds(1));
+  advance(std::chrono::seconds(2));
+  EXPECT_THAT(fired, ElementsAre("2", "1"));
+}
+
+} // namespace
+} // namespace Event
+} // namespace Envoy
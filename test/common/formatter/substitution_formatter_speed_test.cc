@@ -28,6 +28,23 @@ std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> makeJsonFormatter(bool type
   return std::make_unique<Envoy::Formatter::JsonFormatterImpl>(JsonLogFormat, typed, false);
 }
 
+std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> makeNestedJsonFormatter() {
+  ProtobufWkt::Struct JsonLogFormat;
+  const std::string format_yaml = R"EOF(
+    request:
+      method: '%REQ(:METHOD)%'
+      path: '%REQ(X-ENVOY-ORIGINAL-PATH?:PATH)%'
+      headers: ['%REQ(REFERER)%', '%REQ(USER-AGENT)%']
+    response:
+      code: '%RESPONSE_CODE%'
+      bytes_sent: '%BYTES_SENT%'
+      duration: '%DURATION%'
+    upstream: ['%UPSTREAM_HOST%', '%UPSTREAM_CLUSTER%', 'static']
+  )EOF";
+  TestUtility::loadFromYaml(format_yaml, JsonLogFormat);
+  return std::make_unique<Envoy::Formatter::JsonFormatterImpl>(JsonLogFormat, true, false);
+}
+
 std::unique_ptr<Envoy::Formatter::StructFormatter> makeStructFormatter(bool typed) {
   ProtobufWkt::Struct StructLogFormat;
   const std::string format_yaml = R"EOF(
@@ -163,4 +180,29 @@ static void BM_TypedJsonAccessLogFormatter(benchmark::State& state) {
 }
 BENCHMARK(BM_TypedJsonAccessLogFormatter);
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_TypedNestedJsonAccessLogFormatter(benchmark::State& state) {
+  std::unique_ptr<Envoy::TestStreamInfo> stream_info = makeStreamInfo();
+  std::unique_ptr<Envoy::Formatter::JsonFormatterImpl> nested_json_formatter =
+      makeNestedJsonFormatter();
+
+  size_t output_bytes = 0;
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"},
+      {":path", "/search?q=\"quoted\"&lang=en"},
+      {"referer", "https://example.com/a\\b"},
+      {"user-agent", "Mozilla/5.0 (X11; Linux x86_64)\t\"test\""}};
+  Http::TestResponseHeaderMapImpl response_headers;
+  Http::TestResponseTrailerMapImpl response_trailers;
+  std::string body;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    output_bytes +=
+        nested_json_formatter
+            ->format(request_headers, response_headers, response_trailers, *stream_info, body)
+            .length();
+  }
+  benchmark::DoNotOptimize(output_bytes);
+}
+BENCHMARK(BM_TypedNestedJsonAccessLogFormatter);
+
 } // namespace Envoy
@@ -2478,6 +2478,67 @@ TEST(SubstitutionFormatterTest, JsonFormatterTest) {
   EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected));
 }
 
+TEST(SubstitutionFormatterTest, JsonFormatterStreamsSameContentAsStruct) {
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  Http::TestRequestHeaderMapImpl request_header{
+      {"escaped", "quote\" backslash\\ newline\n tab\t control\x01 <html>"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+  std::string body;
+
+  envoy::config::core::v3::Metadata metadata;
+  populateMetadataTestData(metadata);
+  EXPECT_CALL(Const(stream_info), dynamicMetadata()).WillRepeatedly(ReturnRef(metadata));
+  absl::optional<Http::Protocol> protocol = Http::Protocol::Http11;
+  EXPECT_CALL(stream_info, protocol()).WillRepeatedly(Return(protocol));
+  EXPECT_CALL(Const(stream_info), lastDownstreamRxByteReceived())
+      .WillRepeatedly(Return(std::chrono::nanoseconds(5000000)));
+
+  ProtobufWkt::Struct key_mapping;
+  TestUtility::loadFromYaml(R"EOF(
+    request_duration: '%REQUEST_DURATION%'
+    missing: '%REQ(missing)%'
+    escaped: '%REQ(escaped)%'
+    concatenated: '%PROTOCOL% %REQ(missing)% %REQ(escaped)%'
+    metadata: '%DYNAMIC_METADATA(com.test)%'
+    nested_level:
+      plain_string: plain_string_value
+      list:
+      - '%PROTOCOL%'
+      - '%REQ(missing)%'
+      - key: '%REQUEST_DURATION%'
+  )EOF",
+                            key_mapping);
+
+  for (const bool preserve_types : {false, true}) {
+    for (const bool omit_empty_values : {false, true}) {
+      SCOPED_TRACE(fmt::format("preserve_types: {}, omit_empty_values: {}", preserve_types,
+                               omit_empty_values));
+      StructFormatter struct_formatter(key_mapping, preserve_types, omit_empty_values);
+      const std::string expected = MessageUtil::getJsonStringFromMessageOrDie(
+          struct_formatter.format(request_header, response_header, response_trailer, stream_info,
+                                  body),
+          false, true);
+
+      std::string streamed;
+      struct_formatter.formatJson(request_header, response_header, response_trailer, stream_info,
+                                  body, streamed);
+      EXPECT_TRUE(TestUtility::jsonStringEqual(streamed, expected)) << streamed;
+
+      for (const std::string stream_json : {"true", "false"}) {
+        TestScopedRuntime scoped_runtime;
+        Runtime::LoaderSingleton::getExisting()->mergeValues(
+            {{"envoy.reloadable_features.stream_json_access_log_formatter", stream_json}});
+        JsonFormatterImpl formatter(key_mapping, preserve_types, omit_empty_values);
+        const std::string out_json =
+            formatter.format(request_header, response_header, response_trailer, stream_info, body);
+        EXPECT_EQ('\n', out_json.back());
+        EXPECT_TRUE(TestUtility::jsonStringEqual(out_json, expected)) << out_json;
+      }
+    }
+  }
+}
+
 TEST(SubstitutionFormatterTest, CompositeFormatterSuccess) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
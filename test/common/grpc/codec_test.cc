@@ -193,6 +193,37 @@ TEST(GrpcCodecTest, decodeSingleFrame) {
   EXPECT_EQ("hello", result.name());
 }
 
+// The slices of the frame data are moved out of the input rather than copied, including the ones
+// of a frame split across decode() calls.
+TEST(GrpcCodecTest, decodeMovesSlices) {
+  const std::string data(16384, 'a');
+  std::array<uint8_t, 5> header;
+  Encoder().newFrame(GRPC_FH_DEFAULT, 2 * data.size(), header);
+
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(header.data(), header.size());
+  buffer.appendSliceForTest(data);
+  const void* slice1 = buffer.getRawSlices()[1].mem_;
+
+  std::vector<Frame> frames;
+  Decoder decoder;
+  EXPECT_TRUE(decoder.decode(buffer, frames));
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_TRUE(frames.empty());
+  EXPECT_TRUE(decoder.hasBufferedData());
+
+  buffer.appendSliceForTest(data);
+  const void* slice2 = buffer.getRawSlices()[0].mem_;
+  EXPECT_TRUE(decoder.decode(buffer, frames));
+  ASSERT_EQ(1, frames.size());
+  EXPECT_FALSE(decoder.hasBufferedData());
+  EXPECT_EQ(2 * data.size(), frames[0].length_);
+  const auto slices = frames[0].data_->getRawSlices();
+  ASSERT_EQ(2, slices.size());
+  EXPECT_EQ(slice1, slices[0].mem_);
+  EXPECT_EQ(slice2, slices[1].mem_);
+}
+
 TEST(GrpcCodecTest, decodeMultipleFrame) {
   helloworld::HelloRequest request;
   request.set_name("hello");
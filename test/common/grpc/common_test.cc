@@ -381,5 +381,17 @@ TEST(GrpcContextTest, PrependGrpcFrameHeader) {
   EXPECT_EQ(buffer->toString(), header_string + "test");
 }
 
+// The serialized messages have room for the frame header in front of their slice.
+TEST(GrpcContextTest, SerializeMessageFrameHeader) {
+  helloworld::HelloRequest request;
+  request.set_name("hello");
+  Buffer::InstancePtr buffer = Common::serializeMessage(request);
+  EXPECT_EQ(request.SerializeAsString(), buffer->toString());
+
+  Common::prependGrpcFrameHeader(*buffer);
+  EXPECT_EQ(1, buffer->getRawSlices().size());
+  EXPECT_EQ(Common::serializeToGrpcFrame(request)->toString(), buffer->toString());
+}
+
 } // namespace Grpc
 } // namespace Envoy
@@ -194,6 +194,33 @@ TEST_F(EnvoyGoogleLessMockedAsyncClientImplTest, TestOverflow) {
   EXPECT_TRUE(grpc_stream->isAboveWriteBufferHighWatermark());
 }
 
+// The thread locals sharing a completion queue drain the ops of their own streams when destroyed,
+// while the queue keeps running for the others.
+TEST_F(EnvoyGoogleLessMockedAsyncClientImplTest, SharedCompletionQueue) {
+  auto queue = std::make_shared<GoogleCompletionQueue>(*api_);
+  tls_ = std::make_unique<GoogleAsyncClientThreadLocal>(queue);
+  auto other_tls = std::make_unique<GoogleAsyncClientThreadLocal>(queue);
+  initialize();
+
+  NiceMock<MockAsyncStreamCallbacks<helloworld::HelloReply>> grpc_callbacks;
+  AsyncStream<helloworld::HelloRequest> grpc_stream =
+      grpc_client_->start(*method_descriptor_, grpc_callbacks, Http::AsyncClient::RequestOptions());
+  EXPECT_FALSE(grpc_stream == nullptr);
+  grpc_stream->resetStream();
+  // The dispatcher doesn't run, the cancelled ops are drained by the destructor.
+  tls_.reset();
+  EXPECT_LT(0, queue->events());
+
+  GoogleAsyncClientImpl other_client(*dispatcher_, *other_tls, real_stub_factory_, scope_, config_,
+                                     *api_, stat_names_);
+  NiceMock<MockAsyncStreamCallbacks<helloworld::HelloReply>> other_callbacks;
+  RawAsyncStream* other_stream = other_client.startRaw(
+      "helloworld.Greeter", "SayHello", other_callbacks, Http::AsyncClient::RequestOptions());
+  EXPECT_NE(nullptr, other_stream);
+  other_stream->resetStream();
+  other_tls.reset();
+}
+
 } // namespace
 } // namespace Grpc
 } // namespace Envoy
@@ -0,0 +1,247 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the whole downstream path of an HTTP/1.1 request, from the bytes read on the connection
+// to the bytes of the response written back: the real HTTP/1 codec, connection manager, route
+// table and filter chain, with the requests answered by the direct response of their route.
+
+#include "envoy/config/route/v3/route.pb.h"
+
+#include "common/common/empty_string.h"
+#include "common/http/conn_manager_impl.h"
+#include "common/http/context_impl.h"
+#include "common/http/date_provider_impl.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/local_reply/local_reply.h"
+#include "common/network/address_impl.h"
+#include "common/router/config_impl.h"
+#include "common/tracing/http_tracer_impl.h"
+
+#include "extensions/filters/http/common/pass_through_filter.h"
+#include "extensions/request_id/uuid/config.h"
+
+#include "test/mocks/local_info/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/server/instance.h"
+#include "test/mocks/server/overload_manager.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/test_time.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+constexpr char RouteConfig[] = R"EOF(
+virtual_hosts:
+- name: benchmark
+  domains: ["*"]
+  routes:
+  - match: { prefix: "/" }
+    direct_response: { status: 200 }
+)EOF";
+
+// Answers the requests with the direct response of their route, as the router does.
+class DirectResponseFilter : public PassThroughDecoderFilter {
+public:
+  FilterHeadersStatus decodeHeaders(RequestHeaderMap&, bool) override {
+    const Router::DirectResponseEntry* entry = decoder_callbacks_->route()->directResponseEntry();
+    ResponseHeaderMapPtr headers = ResponseHeaderMapImpl::create();
+    headers->setStatus(enumToInt(entry->responseCode()));
+    decoder_callbacks_->encodeHeaders(std::move(headers), true, "direct_response");
+    return FilterHeadersStatus::StopIteration;
+  }
+};
+
+// The configuration of a connection manager with the given number of pass-through filters in
+// front of the direct response one.
+class BenchmarkConfig : public ConnectionManagerConfig, public FilterChainFactory {
+public:
+  struct RouteConfigProvider : public Router::RouteConfigProvider {
+    RouteConfigProvider(Router::ConfigConstSharedPtr config, TimeSource& time_source)
+        : config_(std::move(config)), time_source_(time_source) {}
+
+    // Router::RouteConfigProvider
+    Router::ConfigConstSharedPtr config() override { return config_; }
+    absl::optional<ConfigInfo> configInfo() const override { return {}; }
+    SystemTime lastUpdated() const override { return time_source_.systemTime(); }
+    void onConfigUpdate() override {}
+
+    const Router::ConfigConstSharedPtr config_;
+    TimeSource& time_source_;
+  };
+
+  BenchmarkConfig(uint32_t num_filters)
+      : num_filters_(num_filters),
+        stats_(ConnectionManagerImpl::generateStats("http.benchmark.", store_)),
+        tracing_stats_(ConnectionManagerImpl::generateTracingStats("http.benchmark.", store_)),
+        listener_stats_(ConnectionManagerImpl::generateListenerStats("http.benchmark.", store_)),
+        request_id_extension_(
+            Extensions::RequestId::UUIDRequestIDExtension::defaultInstance(random_)),
+        local_reply_(LocalReply::Factory::createDefault()),
+        route_config_provider_(
+            std::make_shared<const Router::ConfigImpl>(
+                TestUtility::parseYaml<envoy::config::route::v3::RouteConfiguration>(RouteConfig),
+                factory_context_, ProtobufMessage::getNullValidationVisitor(), false),
+            time_system_) {}
+
+  // Http::FilterChainFactory
+  void createFilterChain(FilterChainFactoryCallbacks& callbacks) override {
+    for (uint32_t i = 0; i < num_filters_; ++i) {
+      callbacks.addStreamFilter(std::make_shared<PassThroughFilter>());
+    }
+    callbacks.addStreamDecoderFilter(std::make_shared<DirectResponseFilter>());
+  }
+  bool createUpgradeFilterChain(absl::string_view, const UpgradeMap*,
+                                FilterChainFactoryCallbacks&) override {
+    return false;
+  }
+
+  // Http::ConnectionManagerConfig
+  const RequestIDExtensionSharedPtr& requestIDExtension() override { return request_id_extension_; }
+  const std::list<AccessLog::InstanceSharedPtr>& accessLogs() override { return access_logs_; }
+  ServerConnectionPtr createCodec(Network::Connection& connection, const Buffer::Instance&,
+                                  ServerConnectionCallbacks& callbacks) override {
+    return std::make_unique<Http1::ServerConnectionImpl>(
+        connection, Http1::CodecStats::atomicGet(http1_codec_stats_, store_), callbacks,
+        http1_settings_, maxRequestHeadersKb(), maxRequestHeadersCount(),
+        headersWithUnderscoresAction());
+  }
+  DateProvider& dateProvider() override { return date_provider_; }
+  std::chrono::milliseconds drainTimeout() const override { return std::chrono::milliseconds(100); }
+  FilterChainFactory& filterFactory() override { return *this; }
+  bool generateRequestId() const override { return true; }
+  bool preserveExternalRequestId() const override { return false; }
+  bool alwaysSetRequestIdInResponse() const override { return false; }
+  uint32_t maxRequestHeadersKb() const override { return DEFAULT_MAX_REQUEST_HEADERS_KB; }
+  uint32_t maxRequestHeadersCount() const override { return DEFAULT_MAX_HEADERS_COUNT; }
+  absl::optional<std::chrono::milliseconds> idleTimeout() const override { return absl::nullopt; }
+  bool isRoutable() const override { return true; }
+  absl::optional<std::chrono::milliseconds> maxConnectionDuration() const override {
+    return absl::nullopt;
+  }
+  absl::optional<std::chrono::milliseconds> maxStreamDuration() const override {
+    return absl::nullopt;
+  }
+  std::chrono::milliseconds streamIdleTimeout() const override { return {}; }
+  std::chrono::milliseconds requestTimeout() const override { return {}; }
+  std::chrono::milliseconds requestHeadersTimeout() const override { return {}; }
+  std::chrono::milliseconds delayedCloseTimeout() const override { return {}; }
+  Router::RouteConfigProvider* routeConfigProvider() override { return &route_config_provider_; }
+  Config::ConfigProvider* scopedRouteConfigProvider() override { return nullptr; }
+  const std::string& serverName() const override { return server_name_; }
+  HttpConnectionManagerProto::ServerHeaderTransformation
+  serverHeaderTransformation() const override {
+    return HttpConnectionManagerProto::OVERWRITE;
+  }
+  ConnectionManagerStats& stats() override { return stats_; }
+  ConnectionManagerTracingStats& tracingStats() override { return tracing_stats_; }
+  bool useRemoteAddress() const override { return true; }
+  const InternalAddressConfig& internalAddressConfig() const override {
+    return internal_address_config_;
+  }
+  uint32_t xffNumTrustedHops() const override { return 0; }
+  bool skipXffAppend() const override { return false; }
+  const std::string& via() const override { return EMPTY_STRING; }
+  ForwardClientCertType forwardClientCert() const override {
+    return ForwardClientCertType::Sanitize;
+  }
+  const std::vector<ClientCertDetailsType>& setCurrentClientCertDetails() const override {
+    return set_current_client_cert_details_;
+  }
+  const Network::Address::Instance& localAddress() override { return local_address_; }
+  const absl::optional<std::string>& userAgent() override { return user_agent_; }
+  Tracing::HttpTracerSharedPtr tracer() override { return http_tracer_; }
+  const TracingConnectionManagerConfig* tracingConfig() override { return nullptr; }
+  ConnectionManagerListenerStats& listenerStats() override { return listener_stats_; }
+  bool proxy100Continue() const override { return false; }
+  bool streamErrorOnInvalidHttpMessaging() const override { return false; }
+  const Http1Settings& http1Settings() const override { return http1_settings_; }
+  bool shouldNormalizePath() const override { return false; }
+  bool shouldMergeSlashes() const override { return false; }
+  StripPortType stripPortType() const override { return StripPortType::None; }
+  envoy::config::core::v3::HttpProtocolOptions::HeadersWithUnderscoresAction
+  headersWithUnderscoresAction() const override {
+    return envoy::config::core::v3::HttpProtocolOptions::ALLOW;
+  }
+  const LocalReply::LocalReply& localReply() const override { return *local_reply_; }
+
+  const uint32_t num_filters_;
+  Stats::IsolatedStoreImpl store_;
+  ConnectionManagerStats stats_;
+  ConnectionManagerTracingStats tracing_stats_;
+  ConnectionManagerListenerStats listener_stats_;
+  Http1::CodecStats::AtomicPtr http1_codec_stats_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  RequestIDExtensionSharedPtr request_id_extension_;
+  LocalReply::LocalReplyPtr local_reply_;
+  std::list<AccessLog::InstanceSharedPtr> access_logs_;
+  Event::TestRealTimeSystem time_system_;
+  SlowDateProviderImpl date_provider_{time_system_};
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context_;
+  RouteConfigProvider route_config_provider_;
+  std::string server_name_{"envoy"};
+  DefaultInternalAddressConfig internal_address_config_;
+  std::vector<ClientCertDetailsType> set_current_client_cert_details_;
+  Network::Address::Ipv4Instance local_address_{"127.0.0.1"};
+  absl::optional<std::string> user_agent_;
+  Tracing::HttpTracerSharedPtr http_tracer_{std::make_shared<Tracing::HttpNullTracer>()};
+  Http1Settings http1_settings_;
+};
+
+// Arguments are (number of pass-through filters). Each iteration reads a request on a keep-alive
+// connection and writes its response.
+static void bmHttp1RequestResponse(benchmark::State& state) {
+  BenchmarkConfig config(state.range(0));
+  NiceMock<Network::MockDrainDecision> drain_close;
+  NiceMock<Random::MockRandomGenerator> random;
+  Http::ContextImpl http_context(config.store_.symbolTable());
+  NiceMock<Runtime::MockLoader> runtime;
+  NiceMock<LocalInfo::MockLocalInfo> local_info;
+  NiceMock<Upstream::MockClusterManager> cluster_manager;
+  NiceMock<Server::MockOverloadManager> overload_manager;
+  NiceMock<Network::MockReadFilterCallbacks> filter_callbacks;
+  filter_callbacks.connection_.stream_info_.downstream_address_provider_->setLocalAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1"));
+  filter_callbacks.connection_.stream_info_.downstream_address_provider_->setRemoteAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("10.0.0.1"));
+  uint64_t response_bytes = 0;
+  ON_CALL(filter_callbacks.connection_, write(_, _))
+      .WillByDefault(Invoke([&response_bytes](Buffer::Instance& data, bool) {
+        response_bytes += data.length();
+        data.drain(data.length());
+      }));
+
+  ConnectionManagerImpl conn_manager(config, drain_close, random, http_context, runtime, local_info,
+                                     cluster_manager, overload_manager, config.time_system_);
+  conn_manager.initializeReadFilterCallbacks(filter_callbacks);
+
+  const std::string request = "GET /benchmark HTTP/1.1\r\nhost: example.com\r\n"
+                              "user-agent: benchmark\r\naccept: */*\r\n\r\n";
+  for (auto _ : state) {
+    Buffer::OwnedImpl data(request);
+    conn_manager.onData(data, false);
+    filter_callbacks.connection_.dispatcher_.clearDeferredDeleteList();
+  }
+  if (config.stats_.named_.downstream_rq_2xx_.value() != state.iterations()) {
+    state.SkipWithError("not all the requests were answered");
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["response_bytes"] =
+      benchmark::Counter(response_bytes, benchmark::Counter::kAvgIterations);
+
+  filter_callbacks.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
+  filter_callbacks.connection_.dispatcher_.clearDeferredDeleteList();
+}
+BENCHMARK(bmHttp1RequestResponse)->Arg(0)->Arg(4)->Arg(16);
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
@@ -192,6 +192,55 @@ TEST_F(HttpConnectionManagerImplTest, 100ContinueResponseWithEncoderFilters) {
   doRemoteClose();
 }
 
+// The early hints bypass the encoder filters, and are dropped once the response has started.
+TEST_F(HttpConnectionManagerImplTest, EarlyHintsResponse) {
+  setup(false, "envoy-custom-server", false);
+  setUpEncoderAndDecoder(false, false);
+  sendRequestHeadersAndData();
+
+  EXPECT_CALL(*encoder_filters_[0], encode100ContinueHeaders(_)).Times(0);
+  EXPECT_CALL(*encoder_filters_[1], encode100ContinueHeaders(_)).Times(0);
+  EXPECT_CALL(response_encoder_, encode100ContinueHeaders(_))
+      .WillOnce(Invoke([](const ResponseHeaderMap& headers) {
+        EXPECT_EQ("103", headers.getStatusValue());
+        EXPECT_EQ("</style.css>; rel=preload; as=style",
+                  headers.get(LowerCaseString("link"))[0]->value().getStringView());
+      }));
+  ResponseHeaderMapPtr early_hints_headers{new TestResponseHeaderMapImpl{
+      {":status", "103"}, {"link", "</style.css>; rel=preload; as=style"}}};
+  decoder_filters_[0]->callbacks_->encodeEarlyHintsHeaders(std::move(early_hints_headers));
+
+  EXPECT_CALL(*encoder_filters_[0], encodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*encoder_filters_[1], encodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, false));
+  ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+  decoder_filters_[0]->callbacks_->streamInfo().setResponseCodeDetails("");
+  decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), false, "details");
+
+  early_hints_headers.reset(new TestResponseHeaderMapImpl{{":status", "103"}});
+  decoder_filters_[0]->callbacks_->encodeEarlyHintsHeaders(std::move(early_hints_headers));
+
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_1xx_.value());
+  doRemoteClose();
+}
+
+// The early hints are not sent to HTTP/1.0 clients.
+TEST_F(HttpConnectionManagerImplTest, EarlyHintsResponseHttp10) {
+  http1_settings_.accept_http_10_ = true;
+  setup(false, "envoy-custom-server", false);
+  codec_->protocol_ = Protocol::Http10;
+  setUpEncoderAndDecoder(false, false);
+  sendRequestHeadersAndData();
+
+  EXPECT_CALL(response_encoder_, encode100ContinueHeaders(_)).Times(0);
+  ResponseHeaderMapPtr early_hints_headers{new TestResponseHeaderMapImpl{{":status", "103"}}};
+  decoder_filters_[0]->callbacks_->encodeEarlyHintsHeaders(std::move(early_hints_headers));
+
+  doRemoteClose();
+}
+
 TEST_F(HttpConnectionManagerImplTest, PauseResume100Continue) {
   proxy_100_continue_ = true;
   setup(false, "envoy-custom-server", false);
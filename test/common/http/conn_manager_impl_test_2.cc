@@ -2900,6 +2900,30 @@ private:
 
 } // namespace
 
+// An HTTP/1 connection can be handed over to another process between requests, unlike an HTTP/2
+// connection.
+TEST_F(HttpConnectionManagerImplTest, CanHandOverIdleHttp1Connection) {
+  setup(false, "");
+  setupFilterChain(1, 0);
+  EXPECT_TRUE(conn_manager_->canHandOverConnection());
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  startRequest(true);
+  EXPECT_FALSE(conn_manager_->canHandOverConnection());
+
+  EXPECT_CALL(response_encoder_, encodeHeaders(_, true));
+  EXPECT_CALL(*decoder_filters_[0], onStreamComplete());
+  EXPECT_CALL(*decoder_filters_[0], onDestroy());
+  ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+  decoder_filters_[0]->callbacks_->streamInfo().setResponseCodeDetails("");
+  decoder_filters_[0]->callbacks_->encodeHeaders(std::move(response_headers), true, "details");
+  EXPECT_TRUE(conn_manager_->canHandOverConnection());
+
+  codec_->protocol_ = Protocol::Http2;
+  EXPECT_FALSE(conn_manager_->canHandOverConnection());
+}
+
 TEST_F(HttpConnectionManagerImplTest, ConnectionFilterState) {
   filter_callbacks_.connection_.stream_info_.filter_state_->setData(
       "connection_provided_data", std::make_shared<SimpleType>(555),
@@ -82,6 +82,7 @@ public:
   }
 
   ConnectionPool::Callbacks* callbacks(int index = 0) { return callbacks_[index]; }
+  bool isHttp3Confirmed() const { return http3_status_tracker_.isHttp3Confirmed(); }
 
   StreamInfo::MockStreamInfo* info_;
   NiceMock<MockRequestEncoder>* encoder_;
@@ -255,6 +256,44 @@ TEST_F(ConnectivityGridTest, FailureThenSuccessForMultipleConnectionsSerial) {
   cancel2->cancel(Envoy::ConnectionPool::CancelPolicy::CloseExcess);
 }
 
+// Test that HTTP/3 is marked broken when its pool fails and the TCP one connects, so that the
+// next streams go straight to the TCP pool.
+TEST_F(ConnectivityGridTest, FailureThenSuccessMarksHttp3Broken) {
+  grid_.newStream(decoder_, callbacks_);
+  EXPECT_FALSE(grid_.isHttp3Broken());
+
+  grid_.callbacks()->onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                                   "reason", host_);
+  ASSERT_NE(grid_.second(), nullptr);
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  grid_.callbacks(1)->onPoolReady(encoder_, host_, info_, absl::nullopt);
+  EXPECT_TRUE(grid_.isHttp3Broken());
+
+  // The next stream skips the HTTP/3 pool.
+  NiceMock<ConnPoolCallbacks> callbacks2;
+  EXPECT_CALL(*grid_.first(), newStream(_, _)).Times(0);
+  EXPECT_CALL(*grid_.second(), newStream(_, _));
+  EXPECT_LOG_CONTAINS("trace", "HTTP/3 is broken to host 'hostname', skipping.",
+                      grid_.newStream(decoder_, callbacks2));
+}
+
+// Test that a successful HTTP/3 connection confirms HTTP/3.
+TEST_F(ConnectivityGridTest, SuccessConfirmsHttp3) {
+  grid_.newStream(decoder_, callbacks_);
+  EXPECT_CALL(callbacks_.pool_ready_, ready());
+  grid_.callbacks()->onPoolReady(encoder_, host_, info_, absl::nullopt);
+  EXPECT_FALSE(grid_.isHttp3Broken());
+  EXPECT_TRUE(grid_.isHttp3Confirmed());
+}
+
+// Test that HTTP/3 isn't marked broken when both pools fail.
+TEST_F(ConnectivityGridTest, DoubleFailureDoesNotMarkHttp3Broken) {
+  grid_.immediate_failure_ = true;
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  EXPECT_EQ(grid_.newStream(decoder_, callbacks_), nullptr);
+  EXPECT_FALSE(grid_.isHttp3Broken());
+}
+
 // Test double failure under the stack of newStream.
 TEST_F(ConnectivityGridTest, ImmediateDoubleFailure) {
   grid_.immediate_failure_ = true;
@@ -15,6 +15,7 @@
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_reply/mocks.h"
 #include "test/mocks/network/mocks.h"
+#include "test/test_common/test_runtime.h"
 
 #include "gtest/gtest.h"
 
@@ -545,6 +546,189 @@ TEST_F(FilterManagerTest, MultipleOnLocalReply) {
   filter_manager_->destroyFilters();
 }
 
+// Verifies that streams don't have an arena unless it is enabled.
+TEST_F(FilterManagerTest, NoStreamArenaByDefault) {
+  initialize();
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        EXPECT_EQ(nullptr, callbacks.streamArena());
+      }));
+  filter_manager_->createFilterChain();
+  filter_manager_->destroyFilters();
+}
+
+// Verifies that filters allocated from the stream arena run and are destroyed with the stream.
+TEST_F(FilterManagerTest, StreamArena) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http_stream_arena", "true"}});
+  initialize();
+
+  MockStreamDecoderFilter* filter = nullptr;
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        ASSERT_NE(nullptr, callbacks.streamArena());
+        auto arena_filter =
+            makeArenaShared<NiceMock<MockStreamDecoderFilter>>(callbacks.streamArena());
+        filter = arena_filter.get();
+        callbacks.addStreamDecoderFilter(std::move(arena_filter));
+      }));
+  filter_manager_->createFilterChain();
+  ASSERT_NE(nullptr, filter);
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders()).WillByDefault(Return(makeOptRef(*headers)));
+  filter_manager_->requestHeadersInitialized();
+
+  EXPECT_CALL(*filter, decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  filter_manager_->decodeHeaders(*headers, true);
+
+  EXPECT_CALL(*filter, onDestroy());
+  filter_manager_->destroyFilters();
+  // Releases the arena, verifying the expectations of the filter as it is destroyed.
+  filter_manager_.reset();
+}
+
+// Verifies that the time spent in the filter callbacks is attributed to the config of the filters,
+// excluding the time spent in the callbacks of the filters run under them.
+TEST_F(FilterManagerTest, FilterTiming) {
+  initialize();
+  filter_manager_->enableFilterTiming();
+
+  MonotonicTime now;
+  ON_CALL(time_source_, monotonicTime()).WillByDefault(Invoke([&]() { return now; }));
+  ON_CALL(filter_manager_callbacks_, responseHeaders())
+      .WillByDefault(Invoke([&]() -> ResponseHeaderMapOptRef {
+        return makeOptRefFromPtr(filter_manager_callbacks_.response_headers_.get());
+      }));
+
+  auto untimed_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  auto decoder_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  auto encoder_filter = std::make_shared<NiceMock<MockStreamEncoderFilter>>();
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(untimed_filter);
+        callbacks.setFilterConfigName("encoder");
+        callbacks.addStreamEncoderFilter(encoder_filter);
+        callbacks.setFilterConfigName("decoder");
+        callbacks.addStreamDecoderFilter(decoder_filter);
+      }));
+  filter_manager_->createFilterChain();
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders()).WillByDefault(Return(makeOptRef(*headers)));
+  filter_manager_->requestHeadersInitialized();
+
+  EXPECT_CALL(*untimed_filter, decodeHeaders(_, true))
+      .WillOnce(Invoke([&](RequestHeaderMap&, bool) -> FilterHeadersStatus {
+        now += std::chrono::milliseconds(1);
+        return FilterHeadersStatus::Continue;
+      }));
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, true))
+      .WillOnce(Invoke([&](RequestHeaderMap&, bool) -> FilterHeadersStatus {
+        now += std::chrono::milliseconds(2);
+        decoder_filter->callbacks_->encodeHeaders(
+            ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, true,
+            "details");
+        now += std::chrono::milliseconds(3);
+        return FilterHeadersStatus::StopIteration;
+      }));
+  EXPECT_CALL(*encoder_filter, encodeHeaders(_, true))
+      .WillOnce(Invoke([&](ResponseHeaderMap&, bool) -> FilterHeadersStatus {
+        now += std::chrono::milliseconds(5);
+        return FilterHeadersStatus::Continue;
+      }));
+  filter_manager_->decodeHeaders(*headers, true);
+
+  const std::list<FilterTiming>& timings = filter_manager_->filterTimings();
+  ASSERT_EQ(2, timings.size());
+  EXPECT_EQ("encoder", timings.front().config_name_);
+  EXPECT_EQ(std::chrono::milliseconds(5), timings.front().time_);
+  EXPECT_EQ("decoder", timings.back().config_name_);
+  EXPECT_EQ(std::chrono::milliseconds(5), timings.back().time_);
+
+  filter_manager_->destroyFilters();
+}
+
+// Verifies that the filters aren't timed unless it is enabled.
+TEST_F(FilterManagerTest, NoFilterTimingByDefault) {
+  initialize();
+
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.setFilterConfigName("decoder");
+        callbacks.addStreamDecoderFilter(std::make_shared<NiceMock<MockStreamDecoderFilter>>());
+      }));
+  filter_manager_->createFilterChain();
+  EXPECT_TRUE(filter_manager_->filterTimings().empty());
+  filter_manager_->destroyFilters();
+}
+
+// A stream filter which doesn't need the data of the tunnels.
+class TunnelHeadersOnlyFilter : public MockStreamFilter {
+public:
+  bool needsTunnelData() const override { return false; }
+};
+
+// Verifies that once the CONNECT request is accepted, the data are no longer passed to the filters
+// which don't need them.
+TEST_F(FilterManagerTest, TunnelDataSkipsFilters) {
+  initialize();
+
+  EXPECT_CALL(dispatcher_, pushTrackedObject(_)).Times(testing::AnyNumber());
+  EXPECT_CALL(dispatcher_, popTrackedObject(_)).Times(testing::AnyNumber());
+
+  auto headers_only_filter = std::make_shared<NiceMock<TunnelHeadersOnlyFilter>>();
+  auto terminal_filter = std::make_shared<NiceMock<MockStreamDecoderFilter>>();
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamFilter(headers_only_filter);
+        callbacks.addStreamDecoderFilter(terminal_filter);
+      }));
+
+  RequestHeaderMapPtr headers{
+      new TestRequestHeaderMapImpl{{":authority", "host:443"}, {":method", "CONNECT"}}};
+  ON_CALL(filter_manager_callbacks_, requestHeaders()).WillByDefault(Return(makeOptRef(*headers)));
+  filter_manager_->createFilterChain();
+  filter_manager_->requestHeadersInitialized();
+
+  // The data received before the tunnel is established goes through all the filters.
+  EXPECT_CALL(*headers_only_filter, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(*terminal_filter, decodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  filter_manager_->decodeHeaders(*headers, false);
+  Buffer::OwnedImpl data("early");
+  EXPECT_CALL(*headers_only_filter, decodeData(_, false))
+      .WillOnce(Return(FilterDataStatus::Continue));
+  EXPECT_CALL(*terminal_filter, decodeData(_, false))
+      .WillOnce(Return(FilterDataStatus::StopIterationNoBuffer));
+  filter_manager_->decodeData(data, false);
+
+  EXPECT_CALL(*headers_only_filter, encodeHeaders(_, false))
+      .WillOnce(Return(FilterHeadersStatus::Continue));
+  EXPECT_CALL(filter_manager_callbacks_, encodeHeaders(_, false));
+  ResponseHeaderMapPtr response_headers{new TestResponseHeaderMapImpl{{":status", "200"}}};
+  terminal_filter->callbacks_->encodeHeaders(std::move(response_headers), false, "details");
+
+  // The tunnel data skips the filter in both directions.
+  EXPECT_CALL(*headers_only_filter, decodeData(_, _)).Times(0);
+  EXPECT_CALL(*terminal_filter, decodeData(_, false))
+      .WillOnce(Return(FilterDataStatus::StopIterationNoBuffer));
+  filter_manager_->decodeData(data, false);
+
+  EXPECT_CALL(*headers_only_filter, encodeData(_, _)).Times(0);
+  EXPECT_CALL(filter_manager_callbacks_, encodeData(_, false));
+  Buffer::OwnedImpl response_data("response");
+  terminal_filter->callbacks_->encodeData(response_data, false);
+
+  filter_manager_->destroyFilters();
+}
+
 } // namespace
 } // namespace Http
 } // namespace Envoy
@@ -353,6 +353,60 @@ TEST(HeaderStringTest, All) {
     EXPECT_EQ(5U, string.size());
     EXPECT_FALSE(string.isReference());
   }
+
+  // copy
+  {
+    // Small and reference strings are copied.
+    const std::string static_string = "hello";
+    HeaderString reference(static_string);
+    HeaderString reference_copy = reference.copy();
+    EXPECT_EQ("hello", reference_copy.getStringView());
+    EXPECT_NE(reference_copy.getStringView().data(), static_string.data());
+    EXPECT_FALSE(reference_copy.isReference());
+    EXPECT_FALSE(reference_copy.isShared());
+
+    HeaderString small;
+    small.setCopy(static_string);
+    HeaderString small_copy = small.copy();
+    EXPECT_EQ("hello", small_copy.getStringView());
+    EXPECT_FALSE(small.isShared());
+    EXPECT_FALSE(small_copy.isShared());
+
+    // Large strings share their storage, which stays where it was.
+    const std::string large(129, 'a');
+    HeaderString string;
+    string.setCopy(large);
+    const char* data = string.getStringView().data();
+    HeaderString copy = string.copy();
+    HeaderString copy_of_copy = copy.copy();
+    EXPECT_TRUE(string.isShared());
+    EXPECT_TRUE(copy.isShared());
+    EXPECT_EQ(data, string.getStringView().data());
+    EXPECT_EQ(data, copy.getStringView().data());
+    EXPECT_EQ(data, copy_of_copy.getStringView().data());
+    EXPECT_EQ(large, copy.getStringView());
+    EXPECT_EQ(129U, copy.size());
+
+    // Changing a string doesn't change its copies.
+    string.append("b", 1);
+    EXPECT_FALSE(string.isShared());
+    EXPECT_EQ(large + "b", string.getStringView());
+    EXPECT_EQ(large, copy.getStringView());
+    copy.setCopy(copy.getStringView().substr(1));
+    EXPECT_EQ(large.substr(1), copy.getStringView());
+    EXPECT_EQ(large, copy_of_copy.getStringView());
+    copy_of_copy.setInteger(5);
+    EXPECT_EQ("5", copy_of_copy.getStringView());
+
+    // A moved-from shared string is empty.
+    HeaderString shared = string.copy();
+    HeaderString moved(std::move(shared));
+    EXPECT_EQ(large + "b", moved.getStringView());
+    EXPECT_TRUE(shared.empty()); // NOLINT(bugprone-use-after-move)
+    moved.clear();
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(large + "b", string.getStringView());
+  }
 }
 
 Http::RegisterCustomInlineHeader<Http::CustomInlineHeaderRegistry::Type::RequestHeaders>
@@ -1031,6 +1085,30 @@ TEST_P(HeaderMapImplTest, Get) {
   }
 }
 
+// The O(1) headers looked up by name are found through the lazy map once it is in use, as they
+// are set, appended to and removed.
+TEST_P(HeaderMapImplTest, GetInlineAfterLazyMap) {
+  auto headers = TestRequestHeaderMapImpl(
+      {{Headers::get().Path.get(), "/"}, {"hello", "world"}, {"foo", "bar"}});
+  // The lookup of a header which isn't O(1) makes the lazy map, if it's in use.
+  EXPECT_EQ("world", headers.get(LowerCaseString("hello"))[0]->value().getStringView());
+  EXPECT_EQ("/", headers.get(Headers::get().Path)[0]->value().getStringView());
+  EXPECT_TRUE(headers.get(Headers::get().Host).empty());
+
+  headers.setHost("host");
+  ASSERT_EQ(1, headers.get(Headers::get().Host).size());
+  EXPECT_EQ(headers.Host(), headers.get(Headers::get().Host)[0]);
+  headers.addCopy(Headers::get().Host, "other");
+  ASSERT_EQ(1, headers.get(Headers::get().Host).size());
+  EXPECT_EQ("host,other", headers.get(Headers::get().Host)[0]->value().getStringView());
+
+  headers.removeHost();
+  EXPECT_TRUE(headers.get(Headers::get().Host).empty());
+  headers.removePath();
+  EXPECT_TRUE(headers.get(Headers::get().Path).empty());
+  EXPECT_EQ("bar", headers.get(LowerCaseString("foo"))[0]->value().getStringView());
+}
+
 TEST_P(HeaderMapImplTest, CreateHeaderMapFromIterator) {
   std::vector<std::pair<LowerCaseString, std::string>> iter_headers{
       {LowerCaseString(Headers::get().Path), "/"}, {LowerCaseString("hello"), "world"}};
@@ -1283,6 +1361,24 @@ TEST_P(HeaderMapImplTest, TestRequestHeaderMapImplCopy) {
   EXPECT_EQ("bar", baz.get(LowerCaseString("foo"))[0]->value().getStringView());
 }
 
+// Validate that copying a header map shares large values instead of copying them.
+TEST_P(HeaderMapImplTest, CopySharesLargeValues) {
+  const std::string cookie(1024, 'c');
+  TestRequestHeaderMapImpl headers{{":path", "/"}, {"cookie", cookie}};
+  const LowerCaseString cookie_key("cookie");
+  const char* data = headers.get(cookie_key)[0]->value().getStringView().data();
+  auto copy = createHeaderMap<RequestHeaderMapImpl>(headers);
+  EXPECT_EQ(cookie, copy->get(cookie_key)[0]->value().getStringView());
+  EXPECT_EQ(data, copy->get(cookie_key)[0]->value().getStringView().data());
+  EXPECT_EQ(data, headers.get(cookie_key)[0]->value().getStringView().data());
+  EXPECT_EQ(headers.byteSize(), copy->byteSize());
+
+  // Changing the original leaves the copy alone.
+  headers.setCopy(cookie_key, "a=b");
+  EXPECT_EQ(cookie, copy->get(cookie_key)[0]->value().getStringView());
+  EXPECT_EQ("/", copy->getPathValue());
+}
+
 // Make sure 'host' -> ':authority' auto translation only occurs for request headers.
 TEST_P(HeaderMapImplTest, HostHeader) {
   TestRequestHeaderMapImpl request_headers{{"host", "foo"}};
@@ -498,6 +498,38 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedBody) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+// The vectorized parser decodes the same chunked request as http-parser.
+TEST_F(Http1ServerConnectionImplTest, ChunkedBodyVectorizedParser) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http1_use_vectorized_parser", "true"}});
+  initialize();
+
+  InSequence sequence;
+
+  MockRequestDecoder decoder;
+  EXPECT_CALL(callbacks_, newStream(_, _)).WillOnce(ReturnRef(decoder));
+
+  TestRequestHeaderMapImpl expected_headers{
+      {":path", "/"},
+      {":method", "POST"},
+      {"transfer-encoding", "chunked"},
+  };
+  EXPECT_CALL(decoder, decodeHeaders_(HeaderMapEqual(&expected_headers), false));
+  Buffer::OwnedImpl expected_data("Hello World");
+  EXPECT_CALL(decoder, decodeData(BufferEqual(&expected_data), false));
+  Buffer::OwnedImpl empty("");
+  EXPECT_CALL(decoder, decodeData(BufferEqual(&empty), true));
+
+  Buffer::OwnedImpl buffer("POST / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n"
+                           "6\r\nHello \r\n"
+                           "5\r\nWorld\r\n"
+                           "0\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0U, buffer.length());
+}
+
 // Verify dispatch behavior when dispatching an incomplete chunk, and resumption of the parse via a
 // second dispatch.
 TEST_F(Http1ServerConnectionImplTest, ChunkedBodySplitOverTwoDispatches) {
@@ -1438,6 +1470,31 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith204) {
   EXPECT_EQ("HTTP/1.1 204 No Content\r\n\r\n", output);
 }
 
+// The status lines are preformatted for the statuses from 100 to 599, the others are formatted
+// for each response.
+TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWithUnknownStatus) {
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+
+  std::string output;
+  ON_CALL(connection_, write(_, _)).WillByDefault(AddBufferToString(&output));
+
+  TestResponseHeaderMapImpl headers{{":status", "999"}};
+  response_encoder->encodeHeaders(headers, true);
+  EXPECT_EQ("HTTP/1.1 999 Unknown\r\ncontent-length: 0\r\n\r\n", output);
+}
+
 TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
   initialize();
 
@@ -1469,6 +1526,37 @@ TEST_F(Http1ServerConnectionImplTest, HeaderOnlyResponseWith100Then200) {
   EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n", output);
 }
 
+TEST_F(Http1ServerConnectionImplTest, EarlyHintsThen200) {
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  auto status = codec_->dispatch(buffer);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(0U, buffer.length());
+
+  std::string output;
+  ON_CALL(connection_, write(_, _)).WillByDefault(AddBufferToString(&output));
+
+  // The early hints are sent neither chunked nor with a content length.
+  TestResponseHeaderMapImpl early_hints_headers{{":status", "103"},
+                                                {"link", "</style.css>; rel=preload"}};
+  response_encoder->encode100ContinueHeaders(early_hints_headers);
+  EXPECT_EQ("HTTP/1.1 103 Early Hints\r\nlink: </style.css>; rel=preload\r\n\r\n", output);
+  output.clear();
+
+  TestResponseHeaderMapImpl headers{{":status", "200"}};
+  response_encoder->encodeHeaders(headers, true);
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ncontent-length: 0\r\n\r\n", output);
+}
+
 TEST_F(Http1ServerConnectionImplTest, MetadataTest) {
   initialize();
 
@@ -1528,6 +1616,61 @@ TEST_F(Http1ServerConnectionImplTest, ChunkedResponse) {
             output);
 }
 
+// With coalesced writes, the parts of a response are written together at the end of the
+// dispatcher iteration or with the end of the response.
+TEST_F(Http1ServerConnectionImplTest, CoalescedWrites) {
+  codec_settings_.coalesce_writes_ = true;
+  auto* flush_callback = new NiceMock<Event::MockSchedulableCallback>(&connection_.dispatcher_);
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  Http::ResponseEncoder* response_encoder = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+
+  std::vector<std::string> writes;
+  ON_CALL(connection_, write(_, _)).WillByDefault(Invoke([&writes](Buffer::Instance& data, bool) {
+    writes.push_back(data.toString());
+    data.drain(data.length());
+  }));
+
+  Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+  EXPECT_TRUE(codec_->dispatch(buffer).ok());
+
+  // The end of the response flushes all of it.
+  TestResponseHeaderMapImpl headers{{":status", "200"}};
+  response_encoder->encodeHeaders(headers, false);
+  Buffer::OwnedImpl hello("Hello");
+  response_encoder->encodeData(hello, false);
+  EXPECT_TRUE(writes.empty());
+  EXPECT_TRUE(flush_callback->enabled_);
+  Buffer::OwnedImpl world(" World");
+  response_encoder->encodeData(world, true);
+  ASSERT_EQ(1, writes.size());
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n5\r\nHello\r\n6\r\n "
+            "World\r\n0\r\n\r\n",
+            writes[0]);
+  // Nothing is left to flush at the end of the iteration.
+  flush_callback->invokeCallback();
+  EXPECT_EQ(1, writes.size());
+
+  // The partial response is flushed at the end of the iteration.
+  buffer.add("GET / HTTP/1.1\r\n\r\n");
+  EXPECT_TRUE(codec_->dispatch(buffer).ok());
+  writes.clear();
+  response_encoder->encodeHeaders(headers, false);
+  Buffer::OwnedImpl partial("Hello");
+  response_encoder->encodeData(partial, false);
+  EXPECT_TRUE(writes.empty());
+  flush_callback->invokeCallback();
+  ASSERT_EQ(1, writes.size());
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n5\r\nHello\r\n", writes[0]);
+}
+
 TEST_F(Http1ServerConnectionImplTest, ChunkedResponseWithTrailers) {
   codec_settings_.enable_trailers_ = true;
   initialize();
@@ -0,0 +1,76 @@
+#include <memory>
+#include <string>
+
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/vectorized_parser_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+// Callbacks that do nothing, so that only the parser itself is measured.
+class NullCallbacks : public ParserCallbacks {
+public:
+  // ParserCallbacks
+  Status onMessageBegin() override { return okStatus(); }
+  Status onUrl(const char*, size_t) override { return okStatus(); }
+  Status onHeaderField(const char*, size_t) override { return okStatus(); }
+  Status onHeaderValue(const char*, size_t) override { return okStatus(); }
+  Envoy::StatusOr<ParserStatus> onHeadersComplete() override { return ParserStatus::Success; }
+  void bufferBody(const char*, size_t) override {}
+  Envoy::StatusOr<ParserStatus> onMessageComplete() override { return ParserStatus::Success; }
+  void onChunkHeader(bool) override {}
+  int setAndCheckCallbackStatus(Status&&) override { return 0; }
+  int setAndCheckCallbackStatusOr(Envoy::StatusOr<ParserStatus>&&) override { return 0; }
+};
+
+/**
+ * Build a request with num_headers browser-like headers.
+ */
+static std::string makeRequest(size_t num_headers) {
+  std::string request = "GET /static/images/logo.png?version=1234567890&size=large HTTP/1.1\r\n"
+                        "Host: www.example.com\r\n";
+  for (size_t i = 0; i < num_headers; i++) {
+    request += "x-dummy-header-" + std::to_string(i) +
+               ": Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)\r\n";
+  }
+  request += "\r\n";
+  return request;
+}
+
+/**
+ * Measure the speed of parsing a pipeline of requests. The first Arg selects the parser (0 for
+ * http-parser, 1 for the vectorized parser) and the second the number of headers per request.
+ */
+static void parseRequests(benchmark::State& state) {
+  const std::string request = makeRequest(state.range(1));
+  std::string requests;
+  for (size_t i = 0; i < 16; i++) {
+    requests += request;
+  }
+
+  NullCallbacks callbacks;
+  ParserPtr parser;
+  if (state.range(0) == 0) {
+    parser = std::make_unique<LegacyHttpParserImpl>(MessageType::Request, &callbacks);
+  } else {
+    parser = std::make_unique<VectorizedHttpParserImpl>(MessageType::Request, &callbacks);
+  }
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(parser->execute(requests.data(), requests.size()).nread);
+  }
+  state.SetBytesProcessed(state.iterations() * requests.size());
+}
+BENCHMARK(parseRequests)
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Args({0, 10})
+    ->Args({1, 10})
+    ->Args({0, 50})
+    ->Args({1, 50});
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,263 @@
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/vectorized_parser_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records the parser events as a string, merging consecutive data events of the same kind so that
+// the record doesn't depend on how the input was split.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  void setParser(Parser& parser) { parser_ = &parser; }
+
+  // ParserCallbacks
+  Status onMessageBegin() override {
+    addEvent("begin");
+    return okStatus();
+  }
+  Status onUrl(const char* data, size_t length) override {
+    addData("url", data, length);
+    return okStatus();
+  }
+  Status onHeaderField(const char* data, size_t length) override {
+    addData("field", data, length);
+    return okStatus();
+  }
+  Status onHeaderValue(const char* data, size_t length) override {
+    addData("value", data, length);
+    return okStatus();
+  }
+  Envoy::StatusOr<ParserStatus> onHeadersComplete() override {
+    // http-parser reports a meaningless method for responses.
+    const absl::string_view method = parser_->statusCode() == 0 ? parser_->methodName() : "";
+    addEvent(absl::StrCat("headers ", method, " ", parser_->statusCode(), " ",
+                          parser_->httpMajor(), ".", parser_->httpMinor(), " length=",
+                          parser_->contentLength().value_or(0), " chunked=", parser_->isChunked(),
+                          " te=", parser_->hasTransferEncoding()));
+    return headers_complete_status_;
+  }
+  void bufferBody(const char* data, size_t length) override { addData("body", data, length); }
+  Envoy::StatusOr<ParserStatus> onMessageComplete() override {
+    addEvent("complete");
+    if (pause_on_message_complete_) {
+      return parser_->pause();
+    }
+    return ParserStatus::Success;
+  }
+  void onChunkHeader(bool is_final_chunk) override {
+    addEvent(is_final_chunk ? "last-chunk" : "chunk");
+  }
+  int setAndCheckCallbackStatus(Status&& status) override {
+    return parser_->statusToInt(status.ok() ? ParserStatus::Success : ParserStatus::Error);
+  }
+  int setAndCheckCallbackStatusOr(Envoy::StatusOr<ParserStatus>&& statusor) override {
+    return parser_->statusToInt(statusor.ok() ? statusor.value() : ParserStatus::Error);
+  }
+
+  void addEvent(absl::string_view event) {
+    absl::StrAppend(&record_, "|", event);
+    last_data_kind_ = {};
+  }
+
+  std::string record_;
+  ParserStatus headers_complete_status_{ParserStatus::Success};
+  bool pause_on_message_complete_{};
+
+private:
+  void addData(absl::string_view kind, const char* data, size_t length) {
+    if (kind != last_data_kind_) {
+      absl::StrAppend(&record_, "|", kind, ":");
+      last_data_kind_ = kind;
+    }
+    record_.append(data, length);
+  }
+
+  Parser* parser_{};
+  absl::string_view last_data_kind_;
+};
+
+ParserPtr createParser(ParserType parser_type, MessageType message_type,
+                       ParserCallbacks& callbacks) {
+  if (parser_type == ParserType::Vectorized) {
+    return std::make_unique<VectorizedHttpParserImpl>(message_type, &callbacks);
+  }
+  return std::make_unique<LegacyHttpParserImpl>(message_type, &callbacks);
+}
+
+// Parses input in slices of at most slice_size bytes, followed by the end of the connection, and
+// returns the recorded events.
+std::string parse(ParserType parser_type, MessageType message_type, absl::string_view input,
+                  size_t slice_size, ParserStatus headers_complete_status = ParserStatus::Success) {
+  RecordingCallbacks callbacks;
+  callbacks.headers_complete_status_ = headers_complete_status;
+  ParserPtr parser = createParser(parser_type, message_type, callbacks);
+  callbacks.setParser(*parser);
+
+  while (!input.empty()) {
+    const absl::string_view slice = input.substr(0, slice_size);
+    const Parser::RcVal result = parser->execute(slice.data(), slice.size());
+    if (result.rc != 0) {
+      callbacks.addEvent(parser->errnoName(result.rc));
+      return callbacks.record_;
+    }
+    EXPECT_EQ(slice.size(), result.nread);
+    input.remove_prefix(slice.size());
+  }
+  const Parser::RcVal result = parser->execute(nullptr, 0);
+  if (result.rc != 0) {
+    callbacks.addEvent(parser->errnoName(result.rc));
+  }
+  return callbacks.record_;
+}
+
+// Returns the name of the error that parsing input ends with, or HPE_OK.
+std::string parseError(ParserType parser_type, MessageType message_type,
+                       absl::string_view input) {
+  RecordingCallbacks callbacks;
+  ParserPtr parser = createParser(parser_type, message_type, callbacks);
+  callbacks.setParser(*parser);
+  Parser::RcVal result = parser->execute(input.data(), input.size());
+  if (result.rc == 0) {
+    result = parser->execute(nullptr, 0);
+  }
+  return std::string(parser->errnoName(result.rc));
+}
+
+class VectorizedHttpParserImplTest : public testing::TestWithParam<size_t> {
+protected:
+  // Expects both parsers to produce the same events, whatever the input is split into, and returns
+  // them.
+  std::string expectSameEvents(MessageType message_type, absl::string_view input,
+                               ParserStatus headers_complete_status = ParserStatus::Success) {
+    const std::string legacy =
+        parse(ParserType::Legacy, message_type, input, input.size(), headers_complete_status);
+    EXPECT_EQ(legacy, parse(ParserType::Vectorized, message_type, input, GetParam(),
+                            headers_complete_status));
+    return legacy;
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(SliceSizes, VectorizedHttpParserImplTest,
+                         testing::Values(1, 3, 16, std::numeric_limits<size_t>::max()));
+
+TEST_P(VectorizedHttpParserImplTest, Requests) {
+  EXPECT_EQ("|begin|url:/index.html?q=1|field:Host|value:example.com|field:User-Agent|value:test\t "
+            "agent |field:Accept|value:*/*|headers GET 0 1.1 length=0 chunked=0 te=0|complete",
+            expectSameEvents(MessageType::Request, "GET /index.html?q=1 HTTP/1.1\r\n"
+                                                   "Host: example.com\r\n"
+                                                   "User-Agent: test\t agent \r\n"
+                                                   "Accept: */*\r\n\r\n"));
+  expectSameEvents(MessageType::Request,
+                   "POST /upload HTTP/1.1\r\nHost: h\r\nContent-Length: 11\r\n\r\nhello world");
+  expectSameEvents(MessageType::Request, "\r\nGET /a HTTP/1.1\r\nHost: h\r\n\r\n"
+                                         "GET /b HTTP/1.1\r\nHost: h\r\n\r\n");
+  expectSameEvents(MessageType::Request,
+                   "GET / HTTP/1.1\r\nX-Empty:\r\nX-Ws:   \r\nHost: h\r\n\r\n");
+  expectSameEvents(MessageType::Request, "HEAD /x HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+  expectSameEvents(MessageType::Request, "GET / HTTP/1.1\nHost: h\n\n");
+  expectSameEvents(MessageType::Request,
+                   "GET /a/long/path/that/spans/several/vectors?with=\xff\xfe HTTP/1.1\r\n"
+                   "X-Long: a header value that spans several vectors\twith a tab\r\n\r\n");
+}
+
+TEST_P(VectorizedHttpParserImplTest, ChunkedRequest) {
+  EXPECT_EQ("|begin|url:/|field:Transfer-Encoding|value:chunked|headers POST 0 1.1 length=0 "
+            "chunked=1 te=1|chunk|body:hello|chunk|body: world|last-chunk|field:Trailer-Key|"
+            "value:v|complete",
+            expectSameEvents(MessageType::Request,
+                             "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                             "5;ext=1\r\nhello\r\n6\r\n world\r\n0\r\nTrailer-Key: v\r\n\r\n"));
+}
+
+TEST_P(VectorizedHttpParserImplTest, Responses) {
+  expectSameEvents(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello");
+  expectSameEvents(MessageType::Response,
+                   "HTTP/1.1 204 No Content\r\n\r\nHTTP/1.1 100 Continue\r\n\r\n"
+                   "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n0\r\n\r\n");
+  expectSameEvents(MessageType::Response, "HTTP/1.1 200\r\nContent-Length: 0\r\n\r\n");
+  // Without framing headers the body extends to the end of the connection.
+  EXPECT_EQ("|begin|field:Server|value:x|headers  200 1.1 length=0 chunked=0 te=0|"
+            "body:body until close|complete",
+            expectSameEvents(MessageType::Response,
+                             "HTTP/1.1 200 OK\r\nServer: x\r\n\r\nbody until close"));
+}
+
+TEST_P(VectorizedHttpParserImplTest, NoBody) {
+  // As for the response to a HEAD request.
+  EXPECT_EQ("|begin|field:Content-Length|value:10|headers  200 1.1 length=10 chunked=0 te=0|"
+            "complete",
+            expectSameEvents(MessageType::Response, "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n",
+                             ParserStatus::NoBody));
+}
+
+TEST(VectorizedHttpParserImplErrorTest, Errors) {
+  const struct {
+    MessageType message_type_;
+    std::string input_;
+    std::string error_;
+  } test_cases[] = {
+      {MessageType::Request, "get / HTTP/1.1\r\n\r\n", "HPE_INVALID_METHOD"},
+      {MessageType::Request, "GET / FTP/1.1\r\n\r\n", "HPE_INVALID_CONSTANT"},
+      {MessageType::Request, "GET / HTTP/1.1\r\nBad\x01Header: x\r\n\r\n",
+       "HPE_INVALID_HEADER_TOKEN"},
+      {MessageType::Request, std::string("GET / HTTP/1.1\r\nX: a\0b\r\n\r\n", 28),
+       "HPE_INVALID_HEADER_TOKEN"},
+      {MessageType::Request, "POST / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n",
+       "HPE_INVALID_CONTENT_LENGTH"},
+      {MessageType::Request, "POST / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 1\r\n\r\n",
+       "HPE_UNEXPECTED_CONTENT_LENGTH"},
+      {MessageType::Request, "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n",
+       "HPE_INVALID_CHUNK_SIZE"},
+      {MessageType::Request, "GET / HTTP/1.1\r\nTransfer-Encoding: gzip\r\n\r\n",
+       "HPE_INVALID_TRANSFER_ENCODING"},
+      {MessageType::Request, "GET / HTTP/1.1\r\nConnection: close\r\n\r\nGET / HTTP/1.1\r\n",
+       "HPE_CLOSED_CONNECTION"},
+      {MessageType::Request, "GET / HTTP/1.1\r\nHost:", "HPE_INVALID_EOF_STATE"},
+      {MessageType::Response, "HTTP/1.1 abc OK\r\n\r\n", "HPE_INVALID_STATUS"},
+  };
+  for (const auto& test_case : test_cases) {
+    SCOPED_TRACE(test_case.input_);
+    EXPECT_EQ(test_case.error_,
+              parseError(ParserType::Legacy, test_case.message_type_, test_case.input_));
+    EXPECT_EQ(test_case.error_,
+              parseError(ParserType::Vectorized, test_case.message_type_, test_case.input_));
+  }
+}
+
+TEST(VectorizedHttpParserImplPauseTest, PauseOnMessageComplete) {
+  const absl::string_view input = "GET /a HTTP/1.1\r\n\r\nGET /b HTTP/1.1\r\n\r\n";
+  for (const ParserType parser_type : {ParserType::Legacy, ParserType::Vectorized}) {
+    RecordingCallbacks callbacks;
+    callbacks.pause_on_message_complete_ = true;
+    ParserPtr parser = createParser(parser_type, MessageType::Request, callbacks);
+    callbacks.setParser(*parser);
+
+    // Parsing stops right after the first message.
+    Parser::RcVal result = parser->execute(input.data(), input.size());
+    EXPECT_EQ(input.find("GET /b"), result.nread);
+    EXPECT_EQ(parser->statusToInt(ParserStatus::Paused), result.rc);
+    EXPECT_EQ(ParserStatus::Paused, parser->getStatus());
+
+    parser->resume();
+    const size_t first_message_size = result.nread;
+    result = parser->execute(input.data() + first_message_size, input.size() - first_message_size);
+    EXPECT_EQ(input.size() - first_message_size, result.nread);
+    EXPECT_EQ("|begin|url:/a|headers GET 0 1.1 length=0 chunked=0 te=0|complete"
+              "|begin|url:/b|headers GET 0 1.1 length=0 chunked=0 te=0|complete",
+              callbacks.record_);
+  }
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
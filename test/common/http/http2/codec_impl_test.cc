@@ -749,6 +749,39 @@ TEST_P(Http2CodecImplTest, SubmitTrailingEmptyHeaders) {
   response_encoder_->encodeTrailers(TestResponseTrailerMapImpl{});
 }
 
+// The headers of the HPACK static table are referenced, and with
+// "envoy.reloadable_features.http2_reference_data_frames" the large DATA frame payloads reference
+// the dispatched input.
+TEST_P(Http2CodecImplTest, ReferenceDataFrames) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.http2_reference_data_frames", "true"}});
+
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false))
+      .WillOnce(Invoke([](RequestHeaderMapPtr& headers, bool) {
+        EXPECT_EQ("GET", headers->getMethodValue());
+        EXPECT_TRUE(headers->Method()->value().isReference());
+      }));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+
+  std::string received;
+  EXPECT_CALL(request_decoder_, decodeData(_, _))
+      .WillRepeatedly(Invoke([&received](Buffer::Instance& data, bool) {
+        received.append(data.toString());
+        data.drain(data.length());
+      }));
+  const std::string large(16 * 1024 - 9, 'a');
+  Buffer::OwnedImpl large_data(large);
+  request_encoder_->encodeData(large_data, false);
+  Buffer::OwnedImpl small_data("hello");
+  request_encoder_->encodeData(small_data, true);
+  EXPECT_EQ(large + "hello", received);
+}
+
 TEST_P(Http2CodecImplTest, TrailingHeadersLargeClientBody) {
   initialize();
 
@@ -782,6 +815,45 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeClientBody) {
   response_encoder_->encodeTrailers(TestResponseTrailerMapImpl{{"trailing", "header"}});
 }
 
+// Verify that headers on the never index list are left out of the HPACK dynamic table.
+TEST_P(Http2CodecImplTest, NeverIndexHeaders) {
+  client_http2_options_.mutable_header_indexing_policy()->add_never_index_headers("x-request-id");
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  const size_t table_size = nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session());
+  EXPECT_GT(table_size, 0);
+
+  // The other headers are already in the table, so it doesn't grow.
+  request_headers.addCopy("x-request-id", "0123456789abcdef");
+  TestRequestHeaderMapImpl expected_headers(request_headers);
+  MockResponseDecoder response_decoder;
+  RequestEncoder* request_encoder = &client_->newStream(response_decoder);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(HeaderMapEqual(&expected_headers), true));
+  EXPECT_TRUE(request_encoder->encodeHeaders(request_headers, true).ok());
+  EXPECT_EQ(table_size, nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session()));
+}
+
+// Verify that headers above the size limit are left out of the HPACK dynamic table, and that the
+// header bytes sent are counted.
+TEST_P(Http2CodecImplTest, MaxIndexedHeaderSize) {
+  client_http2_options_.mutable_header_indexing_policy()
+      ->mutable_max_indexed_header_size()
+      ->set_value(1);
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, true));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, true).ok());
+  EXPECT_EQ(0, nghttp2_session_get_hd_deflate_dynamic_table_size(client_->session()));
+  EXPECT_GT(client_stats_store_.counter("http2.tx_header_bytes").value(), 0);
+  EXPECT_GT(client_stats_store_.counter("http2.tx_header_bytes_uncompressed").value(), 0);
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataVecTest) {
   allow_metadata_ = true;
   initialize();
@@ -1426,6 +1498,45 @@ TEST_P(Http2CodecImplFlowControlTest, FlowControlPendingRecvData) {
   request_encoder_->encodeData(data, false);
 }
 
+// Verify that the connection window grows when the request body fills it within a round trip.
+TEST_P(Http2CodecImplFlowControlTest, ConnectionWindowAutoTuning) {
+  server_http2_options_.mutable_window_auto_tuning();
+  initialize();
+  const uint32_t initial_window_size =
+      nghttp2_session_get_effective_local_window_size(server_->session());
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers, "POST");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  EXPECT_CALL(request_decoder_, decodeData(_, _)).Times(AtLeast(1));
+  Buffer::OwnedImpl body(std::string(1024 * 1024, 'a'));
+  request_encoder_->encodeData(body, true);
+
+  EXPECT_GT(nghttp2_session_get_effective_local_window_size(server_->session()),
+            initial_window_size);
+}
+
+// Verify that the auto tuned connection window doesn't grow past the configured maximum.
+TEST_P(Http2CodecImplFlowControlTest, ConnectionWindowAutoTuningMaximum) {
+  const uint32_t max_window_size =
+      CommonUtility::OptionsLimits::MIN_INITIAL_CONNECTION_WINDOW_SIZE + 1;
+  server_http2_options_.mutable_window_auto_tuning()
+      ->mutable_max_connection_window_size()
+      ->set_value(max_window_size);
+  initialize();
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers, "POST");
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  EXPECT_CALL(request_decoder_, decodeData(_, _)).Times(AtLeast(1));
+  Buffer::OwnedImpl body(std::string(1024 * 1024, 'a'));
+  request_encoder_->encodeData(body, true);
+
+  EXPECT_EQ(max_window_size, nghttp2_session_get_effective_local_window_size(server_->session()));
+}
+
 // Verify that we create and disable the stream flush timer when trailers follow a stream that
 // does not have enough window.
 TEST_P(Http2CodecImplFlowControlTest, TrailingHeadersLargeServerBody) {
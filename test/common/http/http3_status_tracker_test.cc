@@ -0,0 +1,80 @@
+#include "common/http/http3_status_tracker.h"
+
+#include "test/mocks/event/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class Http3StatusTrackerTest : public testing::Test {
+public:
+  Http3StatusTrackerTest()
+      : timer_(new NiceMock<Event::MockTimer>(&dispatcher_)), tracker_(dispatcher_) {}
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::MockTimer* timer_; // Owned by the tracker.
+  Http3StatusTracker tracker_;
+};
+
+TEST_F(Http3StatusTrackerTest, Initialized) {
+  EXPECT_FALSE(tracker_.isHttp3Broken());
+  EXPECT_FALSE(tracker_.isHttp3Confirmed());
+}
+
+TEST_F(Http3StatusTrackerTest, MarkBroken) {
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(5 * 60 * 1000), nullptr));
+  tracker_.markHttp3Broken();
+  EXPECT_TRUE(tracker_.isHttp3Broken());
+  EXPECT_FALSE(tracker_.isHttp3Confirmed());
+}
+
+TEST_F(Http3StatusTrackerTest, MarkBrokenRepeatedly) {
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(5 * 60 * 1000), nullptr));
+  tracker_.markHttp3Broken();
+
+  // The timer isn't re-armed while HTTP/3 is broken.
+  tracker_.markHttp3Broken();
+  EXPECT_TRUE(tracker_.isHttp3Broken());
+}
+
+TEST_F(Http3StatusTrackerTest, MarkBrokenThenExpires) {
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(5 * 60 * 1000), nullptr));
+  tracker_.markHttp3Broken();
+
+  timer_->invokeCallback();
+  EXPECT_FALSE(tracker_.isHttp3Broken());
+  EXPECT_FALSE(tracker_.isHttp3Confirmed());
+}
+
+TEST_F(Http3StatusTrackerTest, MarkBrokenWithBackoff) {
+  for (const int minutes : {5, 10, 20, 40, 80, 160, 160}) {
+    EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(minutes * 60 * 1000), nullptr));
+    tracker_.markHttp3Broken();
+    EXPECT_TRUE(tracker_.isHttp3Broken());
+    timer_->invokeCallback();
+    EXPECT_FALSE(tracker_.isHttp3Broken());
+  }
+}
+
+TEST_F(Http3StatusTrackerTest, MarkConfirmedResetsBackoff) {
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(5 * 60 * 1000), nullptr));
+  tracker_.markHttp3Broken();
+  timer_->invokeCallback();
+
+  EXPECT_CALL(*timer_, disableTimer());
+  tracker_.markHttp3Confirmed();
+  EXPECT_FALSE(tracker_.isHttp3Broken());
+  EXPECT_TRUE(tracker_.isHttp3Confirmed());
+
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(5 * 60 * 1000), nullptr));
+  tracker_.markHttp3Broken();
+  EXPECT_TRUE(tracker_.isHttp3Broken());
+  EXPECT_FALSE(tracker_.isHttp3Confirmed());
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
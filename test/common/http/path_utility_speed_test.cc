@@ -0,0 +1,50 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the cost of normalizing the :path of a request, for a path which is already normal and
+// for paths which have to be canonicalized or have their slashes merged.
+
+#include <string>
+
+#include "common/http/path_utility.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/strings/string_view.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+// The paths are: already normal, with dot segments, with adjacent slashes and percent-encoded.
+constexpr absl::string_view Paths[] = {
+    "/api/v1/users/1234/profile.json?fields=name,email",
+    "/api/v1/users/./1234/../1234/profile.json?fields=name,email",
+    "/api/v1//users/1234//profile.json?fields=name,email",
+    "/api/v1/users/%31234/profile.json?fields=name,email",
+};
+
+// Arguments are (index of the path, merge slashes).
+static void bmNormalizePath(benchmark::State& state) {
+  const std::string path(Paths[state.range(0)]);
+  const bool merge_slashes = state.range(1) != 0;
+  TestRequestHeaderMapImpl headers;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    headers.setPath(path);
+    benchmark::DoNotOptimize(PathUtil::normalizePath(headers, true, merge_slashes));
+  }
+}
+BENCHMARK(bmNormalizePath)
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({2, 0})
+    ->Args({2, 1})
+    ->Args({3, 0})
+    ->Args({3, 1});
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
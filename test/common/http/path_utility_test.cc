@@ -5,6 +5,7 @@
 
 #include "test/test_common/utility.h"
 
+#include "absl/types/optional.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -113,6 +114,54 @@ TEST_F(PathUtilityTest, MergeSlashes) {
   EXPECT_EQ("/a/?b", mergeSlashes("//a/?b"));             // ends with slash + query
 }
 
+// The dots outside of the dot segments are left as they are, while the dot segments are removed.
+TEST_F(PathUtilityTest, DotsOutsideDotSegments) {
+  const std::vector<std::pair<std::string, std::string>> path_pairs{
+      {"/a/.b", "/a/.b"},           // leading dot
+      {"/a/..b", "/a/..b"},         // leading dots
+      {"/a/b.", "/a/b."},           // trailing dot
+      {"/a/b../c", "/a/b../c"},     // trailing dots
+      {"/...", "/..."},             // three dots
+      {"/a/.", "/a/"},              // current dir at the end
+      {"/a/..", "/"},               // parent dir at the end
+      {"/a/./?b=/..", "/a/?b=/.."}, // dot segments in the query are ignored
+      {"/", "/"},                   // root
+  };
+  for (const auto& path_pair : path_pairs) {
+    auto& path_header = pathHeaderEntry(path_pair.first);
+    EXPECT_TRUE(PathUtil::canonicalPath(headers_)) << "original path: " << path_pair.first;
+    EXPECT_EQ(path_header.value().getStringView(), path_pair.second)
+        << "original path: " << path_pair.first;
+  }
+}
+
+// The path is canonicalized before its slashes are merged.
+TEST_F(PathUtilityTest, NormalizePath) {
+  auto normalizePath = [this](const std::string& path_value, bool canonicalize,
+                              bool merge_slashes) -> absl::optional<std::string> {
+    auto& path_header = pathHeaderEntry(path_value);
+    if (!PathUtil::normalizePath(headers_, canonicalize, merge_slashes)) {
+      return absl::nullopt;
+    }
+    return std::string(path_header.value().getStringView());
+  };
+  EXPECT_EQ("/a/b/c", normalizePath("/a//b/./c", true, true));
+  EXPECT_EQ("/a//b/c", normalizePath("/a//b/./c", true, false));
+  EXPECT_EQ("/a/b", normalizePath("/a//b", true, true));
+  EXPECT_EQ("/a//b", normalizePath("/a//b", true, false));
+  EXPECT_EQ("/b?c=//", normalizePath("/a/../b?c=//", true, true));
+  EXPECT_EQ("a/b", normalizePath("a//b", false, true));
+  EXPECT_EQ("/a/./b", normalizePath("/a/./b", false, false));
+  EXPECT_EQ(absl::nullopt, normalizePath("/xyz/.%00../abc", true, true));
+}
+
+TEST_F(PathUtilityTest, RemoveQuery) {
+  EXPECT_EQ("", PathUtil::removeQuery(""));
+  EXPECT_EQ("/abc", PathUtil::removeQuery("/abc"));
+  EXPECT_EQ("/abc", PathUtil::removeQuery("/abc?param=value"));
+  EXPECT_EQ("/abc#fragment", PathUtil::removeQuery("/abc#fragment"));
+}
+
 TEST_F(PathUtilityTest, RemoveQueryAndFragment) {
   EXPECT_EQ("", PathUtil::removeQueryAndFragment(""));
   EXPECT_EQ("/abc", PathUtil::removeQueryAndFragment("/abc"));
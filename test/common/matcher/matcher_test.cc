@@ -80,6 +80,55 @@ matcher_tree:
   EXPECT_NE(result.on_match_->action_cb_, nullptr);
 }
 
+TEST_F(MatcherTest, TestPrefixMatcher) {
+  const std::string yaml = R"EOF(
+matcher_tree:
+  input:
+    name: outer_input
+    typed_config:
+      "@type": type.googleapis.com/google.protobuf.StringValue
+  prefix_match_map:
+    map:
+      val:
+        action:
+          name: test_action
+          typed_config:
+            "@type": type.googleapis.com/google.protobuf.StringValue
+            value: short
+      valu:
+        action:
+          name: test_action
+          typed_config:
+            "@type": type.googleapis.com/google.protobuf.StringValue
+            value: long
+      values:
+        action:
+          name: test_action
+          typed_config:
+            "@type": type.googleapis.com/google.protobuf.StringValue
+            value: too long
+  )EOF";
+
+  envoy::config::common::matcher::v3::Matcher matcher;
+  MessageUtil::loadFromYaml(yaml, matcher, ProtobufMessage::getStrictValidationVisitor());
+
+  TestUtility::validate(matcher);
+
+  MatchTreeFactory<TestData> factory(factory_context_, validation_visitor_);
+
+  auto outer_factory = TestDataInputFactory("outer_input", "value");
+
+  EXPECT_CALL(validation_visitor_,
+              performDataInputValidation(_, "type.googleapis.com/google.protobuf.StringValue"));
+  auto match_tree = factory.create(matcher);
+
+  const auto result = match_tree->match(TestData());
+  EXPECT_EQ(result.match_state_, MatchState::MatchComplete);
+  EXPECT_TRUE(result.on_match_.has_value());
+  EXPECT_EQ(*static_cast<StringAction*>(result.on_match_->action_cb_().get()),
+            *stringValue("long"));
+}
+
 TEST_F(MatcherTest, CustomGenericInput) {
   const std::string yaml = R"EOF(
 matcher_list:
@@ -0,0 +1,142 @@
+#include <memory>
+
+#include "common/matcher/prefix_map_matcher.h"
+
+#include "test/common/matcher/test_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Matcher {
+
+class PrefixMapMatcherTest : public ::testing::Test {
+public:
+  void verifyNoMatch(const MatchTree<TestData>::MatchResult& result) {
+    EXPECT_EQ(MatchState::MatchComplete, result.match_state_);
+    EXPECT_FALSE(result.on_match_.has_value());
+  }
+
+  void verifyImmediateMatch(const MatchTree<TestData>::MatchResult& result,
+                            absl::string_view expected_value) {
+    EXPECT_EQ(MatchState::MatchComplete, result.match_state_);
+    EXPECT_TRUE(result.on_match_.has_value());
+
+    EXPECT_EQ(nullptr, result.on_match_->matcher_);
+    EXPECT_NE(result.on_match_->action_cb_, nullptr);
+
+    EXPECT_EQ(*static_cast<StringAction*>(result.on_match_->action_cb_().get()),
+              *stringValue(expected_value));
+  }
+
+  void verifyNotEnoughDataForMatch(const MatchTree<TestData>::MatchResult& result) {
+    EXPECT_EQ(MatchState::UnableToMatch, result.match_state_);
+    EXPECT_FALSE(result.on_match_.has_value());
+  }
+};
+
+TEST_F(PrefixMapMatcherTest, NoMatch) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(
+          DataInputGetResult{DataInputGetResult::DataAvailability::AllDataAvailable, "blah"}),
+      absl::nullopt);
+
+  matcher.addChild("match", stringOnMatch<TestData>("match"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyNoMatch(result);
+}
+
+TEST_F(PrefixMapMatcherTest, NoMatchDueToNoData) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(DataInputGetResult{
+          DataInputGetResult::DataAvailability::AllDataAvailable, absl::nullopt}),
+      absl::nullopt);
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyNoMatch(result);
+}
+
+TEST_F(PrefixMapMatcherTest, NoMatchWithFallback) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(
+          DataInputGetResult{DataInputGetResult::DataAvailability::AllDataAvailable, "mat"}),
+      stringOnMatch<TestData>("no_match"));
+
+  matcher.addChild("match", stringOnMatch<TestData>("match"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyImmediateMatch(result, "no_match");
+}
+
+TEST_F(PrefixMapMatcherTest, LongestPrefixMatch) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(DataInputGetResult{
+          DataInputGetResult::DataAvailability::AllDataAvailable, "/api/v1/users"}),
+      stringOnMatch<TestData>("no_match"));
+
+  matcher.addChild("/", stringOnMatch<TestData>("root"));
+  matcher.addChild("/api", stringOnMatch<TestData>("api"));
+  matcher.addChild("/api/v1/", stringOnMatch<TestData>("v1"));
+  matcher.addChild("/api/v1/users/", stringOnMatch<TestData>("users"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyImmediateMatch(result, "v1");
+}
+
+TEST_F(PrefixMapMatcherTest, EmptyPrefixMatch) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(
+          DataInputGetResult{DataInputGetResult::DataAvailability::AllDataAvailable, "blah"}),
+      stringOnMatch<TestData>("no_match"));
+
+  matcher.addChild("", stringOnMatch<TestData>("empty"));
+  matcher.addChild("match", stringOnMatch<TestData>("match"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyImmediateMatch(result, "empty");
+}
+
+TEST_F(PrefixMapMatcherTest, DataNotAvailable) {
+  PrefixMapMatcher<TestData> matcher(std::make_unique<TestInput>(DataInputGetResult{
+                                         DataInputGetResult::DataAvailability::NotAvailable, {}}),
+                                     stringOnMatch<TestData>("no_match"));
+
+  matcher.addChild("match", stringOnMatch<TestData>("match"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyNotEnoughDataForMatch(result);
+}
+
+TEST_F(PrefixMapMatcherTest, MoreDataMightBeAvailableNoMatch) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(DataInputGetResult{
+          DataInputGetResult::DataAvailability::MoreDataMightBeAvailable, "mat"}),
+      stringOnMatch<TestData>("no_match"));
+
+  matcher.addChild("match", stringOnMatch<TestData>("match"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyNotEnoughDataForMatch(result);
+}
+
+TEST_F(PrefixMapMatcherTest, MoreDataMightBeAvailableMatch) {
+  PrefixMapMatcher<TestData> matcher(
+      std::make_unique<TestInput>(DataInputGetResult{
+          DataInputGetResult::DataAvailability::MoreDataMightBeAvailable, "matches"}),
+      stringOnMatch<TestData>("no_match"));
+
+  matcher.addChild("match", stringOnMatch<TestData>("match"));
+
+  TestData data;
+  const auto result = matcher.match(data);
+  verifyImmediateMatch(result, "match");
+}
+} // namespace Matcher
+} // namespace Envoy
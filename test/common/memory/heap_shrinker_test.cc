@@ -1,3 +1,4 @@
+#include "common/buffer/slice_pool.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/memory/heap_shrinker.h"
 #include "common/memory/stats.h"
@@ -83,6 +84,32 @@ TEST_F(HeapShrinkerTest, ShrinkWhenTriggered) {
   EXPECT_EQ(2, shrink_count.value());
 }
 
+TEST_F(HeapShrinkerTest, TrimSlicePoolWhenTriggered) {
+  Server::OverloadActionCb action_cb;
+  EXPECT_CALL(overload_manager_, registerForAction(_, _, _))
+      .WillOnce(Invoke([&](const std::string&, Event::Dispatcher&, Server::OverloadActionCb cb) {
+        action_cb = cb;
+        return true;
+      }));
+  HeapShrinker h(dispatcher_, overload_manager_, stats_);
+
+  std::vector<Buffer::SlicePool::StoragePtr> storages;
+  for (uint32_t i = 0; i < Buffer::SlicePool::SizeClasses[2].high_watermark_; ++i) {
+    storages.push_back(Buffer::SlicePool::allocate(65536));
+  }
+  for (auto& storage : storages) {
+    Buffer::SlicePool::free(std::move(storage), 65536);
+  }
+  const uint64_t cached_slices = Buffer::SlicePool::cachedSlices();
+
+  action_cb(Server::OverloadActionState::saturated());
+  EXPECT_GT(cached_slices, Buffer::SlicePool::cachedSlices());
+  Buffer::SlicePool::flushStats();
+  EXPECT_LT(0, stats_.counter("buffer.slice_pool.slices_released").value());
+
+  action_cb(Server::OverloadActionState::inactive());
+}
+
 } // namespace
 } // namespace Memory
 } // namespace Envoy
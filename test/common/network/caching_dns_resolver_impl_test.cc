@@ -0,0 +1,250 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/network/caching_dns_resolver_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ElementsAre;
+using testing::Invoke;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CachingDnsResolverImplTest : public testing::Test {
+public:
+  void initialize() {
+    resolver_ = std::make_shared<MockDnsResolver>();
+    caching_resolver_ =
+        std::make_unique<CachingDnsResolverImpl>(resolver_, config_, time_system_, store_);
+  }
+
+  // Expects a resolution of the name by the wrapped resolver, whose callback is saved.
+  void expectResolution(const std::string& dns_name) {
+    EXPECT_CALL(*resolver_, resolve(dns_name, DnsLookupFamily::V4Only, _))
+        .WillOnce(Invoke([this](const std::string&, DnsLookupFamily,
+                                DnsResolver::ResolveCb callback) -> ActiveDnsQuery* {
+          resolve_cb_ = callback;
+          return &resolver_->active_query_;
+        }));
+  }
+
+  // Resolves the name with the caching resolver, whose answers are saved.
+  ActiveDnsQuery* resolve(const std::string& dns_name) {
+    return caching_resolver_->resolve(
+        dns_name, DnsLookupFamily::V4Only,
+        [this](DnsResolver::ResolutionStatus status, std::list<DnsResponse>&& responses) {
+          std::vector<std::string> addresses;
+          for (const DnsResponse& response : responses) {
+            addresses.push_back(response.address_->ip()->addressAsString());
+          }
+          statuses_.push_back(status);
+          answers_.push_back(addresses);
+        });
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("dns_resolution_cache." + name).value();
+  }
+
+  uint64_t cacheEntries() {
+    return store_
+        .gauge("dns_resolution_cache.cache_entries", Stats::Gauge::ImportMode::NeverImport)
+        .value();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  CachingDnsResolverConfig config_;
+  std::shared_ptr<MockDnsResolver> resolver_;
+  std::unique_ptr<CachingDnsResolverImpl> caching_resolver_;
+  DnsResolver::ResolveCb resolve_cb_;
+  std::vector<DnsResolver::ResolutionStatus> statuses_;
+  std::vector<std::vector<std::string>> answers_;
+};
+
+// The concurrent resolutions of a name share a query, and the resolution is cached for the
+// smallest TTL of its addresses.
+TEST_F(CachingDnsResolverImplTest, CoalesceAndCache) {
+  initialize();
+  expectResolution("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1UL, counter("coalesced_queries"));
+
+  resolve_cb_(DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(30)));
+  ASSERT_EQ(2UL, answers_.size());
+  EXPECT_THAT(answers_[0], ElementsAre("10.0.0.1"));
+  EXPECT_THAT(answers_[1], ElementsAre("10.0.0.1"));
+  EXPECT_EQ(1UL, cacheEntries());
+
+  // Answered inline from the cache.
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  ASSERT_EQ(3UL, answers_.size());
+  EXPECT_THAT(answers_[2], ElementsAre("10.0.0.1"));
+  EXPECT_EQ(1UL, counter("cache_hits"));
+  EXPECT_EQ(2UL, counter("cache_misses"));
+
+  // The entry expires with the TTL.
+  time_system_.advanceTimeWait(std::chrono::seconds(30));
+  expectResolution("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_EQ(3UL, counter("cache_misses"));
+}
+
+// The TTL of a resolution is bounded by max_ttl.
+TEST_F(CachingDnsResolverImplTest, MaxTtl) {
+  config_.max_ttl_ = std::chrono::seconds(10);
+  initialize();
+  expectResolution("foo.com");
+  resolve("foo.com");
+  resolve_cb_(DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(3600)));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  expectResolution("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+}
+
+// A resolution with a TTL of 0 isn't cached.
+TEST_F(CachingDnsResolverImplTest, ZeroTtl) {
+  initialize();
+  expectResolution("foo.com");
+  resolve("foo.com");
+  resolve_cb_(DnsResolver::ResolutionStatus::Success, TestUtility::makeDnsResponse({"10.0.0.1"}));
+
+  expectResolution("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+}
+
+// A lookup shortly before the entry expires refreshes it in the background.
+TEST_F(CachingDnsResolverImplTest, Prefetch) {
+  initialize();
+  expectResolution("foo.com");
+  resolve("foo.com");
+  resolve_cb_(DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(100)));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(89));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(0UL, counter("prefetches"));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  expectResolution("foo.com");
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1UL, counter("prefetches"));
+  EXPECT_THAT(answers_.back(), ElementsAre("10.0.0.1"));
+
+  // The lookups answered while the prefetch is in flight don't start another one.
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1UL, counter("prefetches"));
+
+  resolve_cb_(DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.2"}, std::chrono::seconds(100)));
+  time_system_.advanceTimeWait(std::chrono::seconds(50));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_THAT(answers_.back(), ElementsAre("10.0.0.2"));
+}
+
+// The failed resolutions are cached for the negative TTL, but don't replace the addresses that
+// didn't expire yet.
+TEST_F(CachingDnsResolverImplTest, NegativeCaching) {
+  initialize();
+  expectResolution("foo.com");
+  resolve("foo.com");
+  resolve_cb_(DnsResolver::ResolutionStatus::Failure, {});
+
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Failure, statuses_.back());
+  EXPECT_THAT(answers_.back(), IsEmpty());
+
+  time_system_.advanceTimeWait(std::chrono::seconds(5));
+  expectResolution("foo.com");
+  resolve("foo.com");
+  resolve_cb_(DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(100)));
+
+  // The prefetch fails.
+  time_system_.advanceTimeWait(std::chrono::seconds(95));
+  expectResolution("foo.com");
+  resolve("foo.com");
+  resolve_cb_(DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Success, statuses_.back());
+  EXPECT_THAT(answers_.back(), ElementsAre("10.0.0.1"));
+}
+
+// The wrapped query is only cancelled once all the coalesced queries are.
+TEST_F(CachingDnsResolverImplTest, Cancel) {
+  initialize();
+  expectResolution("foo.com");
+  ActiveDnsQuery* query1 = resolve("foo.com");
+  ActiveDnsQuery* query2 = resolve("foo.com");
+
+  EXPECT_CALL(resolver_->active_query_, cancel()).Times(0);
+  query1->cancel();
+  testing::Mock::VerifyAndClearExpectations(&resolver_->active_query_);
+
+  EXPECT_CALL(resolver_->active_query_, cancel());
+  query2->cancel();
+  EXPECT_THAT(answers_, IsEmpty());
+
+  // The next lookup starts another query.
+  expectResolution("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+
+  // The queries in flight are cancelled with the resolver.
+  EXPECT_CALL(resolver_->active_query_, cancel());
+  caching_resolver_.reset();
+}
+
+// A resolution completed inline by the wrapped resolver is answered inline.
+TEST_F(CachingDnsResolverImplTest, InlineResolution) {
+  initialize();
+  EXPECT_CALL(*resolver_, resolve("10.0.0.1", DnsLookupFamily::V4Only, _))
+      .WillOnce(Invoke([](const std::string&, DnsLookupFamily,
+                          DnsResolver::ResolveCb callback) -> ActiveDnsQuery* {
+        callback(DnsResolver::ResolutionStatus::Success,
+                 TestUtility::makeDnsResponse({"10.0.0.1"}));
+        return nullptr;
+      }));
+  EXPECT_EQ(nullptr, resolve("10.0.0.1"));
+  ASSERT_EQ(1UL, answers_.size());
+  EXPECT_THAT(answers_[0], ElementsAre("10.0.0.1"));
+}
+
+// The least recently resolved name is evicted once the cache is full.
+TEST_F(CachingDnsResolverImplTest, Eviction) {
+  config_.max_entries_ = 2;
+  initialize();
+  for (const std::string dns_name : {"foo.com", "bar.com", "baz.com"}) {
+    expectResolution(dns_name);
+    resolve(dns_name);
+    resolve_cb_(DnsResolver::ResolutionStatus::Success,
+                TestUtility::makeDnsResponse({"10.0.0.1"}, std::chrono::seconds(100)));
+  }
+  EXPECT_EQ(1UL, counter("cache_evictions"));
+  EXPECT_EQ(2UL, cacheEntries());
+
+  EXPECT_EQ(nullptr, resolve("bar.com"));
+  EXPECT_EQ(nullptr, resolve("baz.com"));
+  expectResolution("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,102 @@
+#include "common/network/connection_balancer_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  absl::optional<double> loopUtilization() const override { return utilization_; }
+  void post(ConnectionSocketPtr&&) override {}
+  void onAcceptWorker(ConnectionSocketPtr&&, bool, bool) override {}
+
+  uint64_t num_connections_{};
+  absl::optional<double> utilization_;
+};
+
+class WorkStealingConnectionBalancerTest : public testing::Test {
+public:
+  WorkStealingConnectionBalancerTest() {
+    for (auto& handler : handlers_) {
+      balancer_.registerHandler(handler);
+    }
+  }
+
+  ~WorkStealingConnectionBalancerTest() override {
+    for (auto& handler : handlers_) {
+      balancer_.unregisterHandler(handler);
+    }
+  }
+
+  void setUtilization(double first, double second, double third) {
+    handlers_[0].utilization_ = first;
+    handlers_[1].utilization_ = second;
+    handlers_[2].utilization_ = third;
+  }
+
+  WorkStealingConnectionBalancerImpl balancer_;
+  TestBalancedConnectionHandler handlers_[3];
+};
+
+TEST_F(WorkStealingConnectionBalancerTest, FewestConnectionsWithoutUtilization) {
+  handlers_[0].num_connections_ = 2;
+  handlers_[1].num_connections_ = 1;
+  handlers_[2].num_connections_ = 2;
+  EXPECT_EQ(&handlers_[1], &balancer_.pickTargetHandler(handlers_[0]));
+  EXPECT_EQ(2, handlers_[1].num_connections_);
+  // Ties keep the connection on the current handler.
+  EXPECT_EQ(&handlers_[2], &balancer_.pickTargetHandler(handlers_[2]));
+  EXPECT_EQ(3, handlers_[2].num_connections_);
+}
+
+TEST_F(WorkStealingConnectionBalancerTest, LeastUtilized) {
+  setUtilization(0.8, 0.2, 0.5);
+  EXPECT_EQ(&handlers_[1], &balancer_.pickTargetHandler(handlers_[0]));
+  EXPECT_EQ(1, handlers_[1].num_connections_);
+  EXPECT_EQ(&handlers_[1], &balancer_.pickTargetHandler(handlers_[2]));
+  EXPECT_EQ(2, handlers_[1].num_connections_);
+  EXPECT_EQ(0, handlers_[0].num_connections_);
+  EXPECT_EQ(0, handlers_[2].num_connections_);
+}
+
+TEST_F(WorkStealingConnectionBalancerTest, CurrentHandlerWithinMargin) {
+  setUtilization(0.25, 0.2, 0.5);
+  EXPECT_EQ(&handlers_[0], &balancer_.pickTargetHandler(handlers_[0]));
+  EXPECT_EQ(1, handlers_[0].num_connections_);
+}
+
+TEST_F(WorkStealingConnectionBalancerTest, UtilizationTiesBrokenByConnections) {
+  setUtilization(0.5, 0, 0);
+  handlers_[1].num_connections_ = 3;
+  handlers_[2].num_connections_ = 1;
+  EXPECT_EQ(&handlers_[2], &balancer_.pickTargetHandler(handlers_[0]));
+}
+
+TEST_F(WorkStealingConnectionBalancerTest, QueuedConnectionMovesOffSaturatedHandler) {
+  // Queued connections stay put unless their handler is saturated.
+  setUtilization(0.85, 0.1, 0.5);
+  EXPECT_EQ(&handlers_[0], &balancer_.pickQueuedTargetHandler(handlers_[0]));
+
+  setUtilization(0.95, 0.1, 0.5);
+  EXPECT_EQ(&handlers_[1], &balancer_.pickQueuedTargetHandler(handlers_[0]));
+  // The caller moves the connection count.
+  EXPECT_EQ(0, handlers_[1].num_connections_);
+
+  // Stay put if every handler is as busy.
+  setUtilization(0.95, 0.9, 1);
+  EXPECT_EQ(&handlers_[0], &balancer_.pickQueuedTargetHandler(handlers_[0]));
+
+  // Or if the load of another handler isn't known.
+  setUtilization(0.95, 0.1, 0.5);
+  handlers_[2].utilization_ = absl::nullopt;
+  EXPECT_EQ(&handlers_[0], &balancer_.pickQueuedTargetHandler(handlers_[0]));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -284,6 +284,36 @@ TEST_P(ConnectionImplTest, UniqueId) {
   disconnect(false);
 }
 
+// The duplicated socket of a handed over connection keeps the connection open once the connection
+// is closed.
+TEST_P(ConnectionImplTest, HandOver) {
+  setUpBasicConnection();
+  connect();
+
+  // The read filters are assumed to keep state by default.
+  EXPECT_EQ(nullptr, server_connection_->handOver());
+
+  EXPECT_CALL(*read_filter_, canHandOverConnection()).WillRepeatedly(Return(true));
+  Network::ConnectionSocketPtr socket = server_connection_->handOver();
+  ASSERT_NE(nullptr, socket);
+  EXPECT_EQ(*server_connection_->addressProvider().remoteAddress(),
+            *socket->addressProvider().remoteAddress());
+  EXPECT_CALL(server_callbacks_, onEvent(ConnectionEvent::LocalClose));
+  server_connection_->close(ConnectionCloseType::NoFlush);
+
+  Buffer::OwnedImpl data("hello");
+  client_connection_->write(data, false);
+  Buffer::OwnedImpl received;
+  while (received.length() < 5) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    socket->ioHandle().read(received, 5 - received.length());
+  }
+  EXPECT_EQ("hello", received.toString());
+
+  socket->close();
+  disconnect(false);
+}
+
 TEST_P(ConnectionImplTest, CloseDuringConnectCallback) {
   setUpBasicConnection();
 
@@ -0,0 +1,195 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/happy_eyeballs_connection_impl.h"
+#include "common/network/utility.h"
+
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::StrictMock;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class HappyEyeballsConnectionImplTest : public testing::Test {
+protected:
+  HappyEyeballsConnectionImplTest()
+      : next_attempt_timer_(new NiceMock<Event::MockTimer>(&dispatcher_)),
+        address_list_({Utility::resolveUrl("tcp://10.0.0.1:123"),
+                       Utility::resolveUrl("tcp://10.0.0.2:123"),
+                       Utility::resolveUrl("tcp://[::1]:123")}) {
+    expectAttempt("tcp://10.0.0.1:123");
+    impl_ = std::make_unique<HappyEyeballsConnectionImpl>(
+        dispatcher_, address_list_, nullptr, transport_socket_factory_, nullptr, nullptr);
+    impl_->addConnectionCallbacks(callbacks_);
+  }
+
+  // Expects the next connection attempt to be made to the given address.
+  void expectAttempt(const std::string& address) {
+    connections_.push_back(new NiceMock<MockClientConnection>());
+    EXPECT_CALL(dispatcher_, createClientConnection_(PointeesEq(Utility::resolveUrl(address)), _,
+                                                     _, _))
+        .WillOnce(Return(connections_.back()));
+  }
+
+  // Starts the second attempt once the attempt delay elapsed.
+  void startSecondAttempt() {
+    EXPECT_CALL(*connections_[0], connect());
+    EXPECT_CALL(*next_attempt_timer_, enableTimer(HappyEyeballsConnectionImpl::AttemptDelay, _));
+    impl_->connect();
+
+    expectAttempt("tcp://[::1]:123");
+    EXPECT_CALL(*connections_[1], connect());
+    EXPECT_CALL(*next_attempt_timer_, enableTimer(HappyEyeballsConnectionImpl::AttemptDelay, _));
+    next_attempt_timer_->invokeCallback();
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::MockTimer* next_attempt_timer_;
+  NiceMock<MockTransportSocketFactory> transport_socket_factory_;
+  const std::vector<Address::InstanceConstSharedPtr> address_list_;
+  std::vector<NiceMock<MockClientConnection>*> connections_;
+  StrictMock<MockConnectionCallbacks> callbacks_;
+  std::unique_ptr<HappyEyeballsConnectionImpl> impl_;
+};
+
+// The address families are interleaved, starting with the family of the first address.
+TEST(HappyEyeballsSortAddressesTest, InterleaveFamilies) {
+  const auto v4_1 = Utility::resolveUrl("tcp://10.0.0.1:123");
+  const auto v4_2 = Utility::resolveUrl("tcp://10.0.0.2:123");
+  const auto v4_3 = Utility::resolveUrl("tcp://10.0.0.3:123");
+  const auto v6_1 = Utility::resolveUrl("tcp://[::1]:123");
+  const auto v6_2 = Utility::resolveUrl("tcp://[::2]:123");
+
+  EXPECT_EQ(std::vector<Address::InstanceConstSharedPtr>({v4_1, v6_1, v4_2, v6_2, v4_3}),
+            HappyEyeballsConnectionImpl::sortAddresses({v4_1, v4_2, v4_3, v6_1, v6_2}));
+  EXPECT_EQ(std::vector<Address::InstanceConstSharedPtr>({v6_1, v4_1, v6_2, v4_2, v4_3}),
+            HappyEyeballsConnectionImpl::sortAddresses({v6_1, v6_2, v4_1, v4_2, v4_3}));
+  EXPECT_EQ(std::vector<Address::InstanceConstSharedPtr>({v4_1, v4_2}),
+            HappyEyeballsConnectionImpl::sortAddresses({v4_1, v4_2}));
+  EXPECT_TRUE(HappyEyeballsConnectionImpl::sortAddresses({}).empty());
+}
+
+// The first attempt connects before the attempt delay elapses.
+TEST_F(HappyEyeballsConnectionImplTest, FirstAttemptConnects) {
+  EXPECT_CALL(*connections_[0], connect());
+  EXPECT_CALL(*next_attempt_timer_, enableTimer(HappyEyeballsConnectionImpl::AttemptDelay, _));
+  impl_->connect();
+
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::Connected));
+  connections_[0]->raiseEvent(ConnectionEvent::Connected);
+  EXPECT_FALSE(next_attempt_timer_->enabled());
+
+  // The events of the connection are forwarded.
+  EXPECT_CALL(callbacks_, onAboveWriteBufferHighWatermark());
+  connections_[0]->runHighWatermarkCallbacks();
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::RemoteClose));
+  connections_[0]->raiseEvent(ConnectionEvent::RemoteClose);
+}
+
+// The second attempt connects first, the first one is closed without notifying the callbacks.
+TEST_F(HappyEyeballsConnectionImplTest, SecondAttemptConnects) {
+  startSecondAttempt();
+
+  EXPECT_CALL(*connections_[0], close(ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::Connected));
+  connections_[1]->raiseEvent(ConnectionEvent::Connected);
+  EXPECT_FALSE(next_attempt_timer_->enabled());
+
+  // The connection now forwards to the second attempt.
+  EXPECT_CALL(*connections_[1], close(ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::LocalClose));
+  impl_->close(ConnectionCloseType::FlushWrite);
+}
+
+// A failed attempt starts the next one right away, and the failure is only reported once all the
+// attempts failed.
+TEST_F(HappyEyeballsConnectionImplTest, AllAttemptsFail) {
+  EXPECT_CALL(*connections_[0], connect());
+  impl_->connect();
+
+  expectAttempt("tcp://[::1]:123");
+  EXPECT_CALL(*connections_[1], connect());
+  EXPECT_CALL(*next_attempt_timer_, enableTimer(HappyEyeballsConnectionImpl::AttemptDelay, _));
+  connections_[0]->raiseEvent(ConnectionEvent::RemoteClose);
+  EXPECT_TRUE(next_attempt_timer_->enabled());
+
+  expectAttempt("tcp://10.0.0.2:123");
+  EXPECT_CALL(*connections_[2], connect());
+  connections_[1]->raiseEvent(ConnectionEvent::RemoteClose);
+  EXPECT_FALSE(next_attempt_timer_->enabled());
+
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::RemoteClose));
+  connections_[2]->raiseEvent(ConnectionEvent::RemoteClose);
+}
+
+// The state set before connecting is applied to all the attempts, the filters, the data and the
+// read disabling only to the attempt that connects.
+TEST_F(HappyEyeballsConnectionImplTest, StateAppliedToAttempts) {
+  EXPECT_CALL(*connections_[0], noDelay(true));
+  impl_->noDelay(true);
+  EXPECT_CALL(*connections_[0], setBufferLimits(42));
+  impl_->setBufferLimits(42);
+
+  auto read_filter = std::make_shared<NiceMock<MockReadFilter>>();
+  EXPECT_CALL(*connections_[0], addReadFilter(_)).Times(0);
+  impl_->addReadFilter(read_filter);
+  EXPECT_TRUE(impl_->initializeReadFilters());
+  Buffer::OwnedImpl data("data");
+  impl_->write(data, false);
+  EXPECT_EQ(0, data.length());
+  impl_->readDisable(true);
+  EXPECT_FALSE(impl_->readEnabled());
+
+  EXPECT_CALL(*connections_[0], connect());
+  impl_->connect();
+  expectAttempt("tcp://[::1]:123");
+  EXPECT_CALL(*connections_[1], noDelay(true));
+  EXPECT_CALL(*connections_[1], setBufferLimits(42));
+  EXPECT_CALL(*connections_[1], connect());
+  next_attempt_timer_->invokeCallback();
+
+  {
+    testing::InSequence s;
+    EXPECT_CALL(*connections_[1], addReadFilter(_));
+    EXPECT_CALL(*connections_[1], initializeReadFilters());
+    EXPECT_CALL(*connections_[1], write(BufferStringEqual("data"), false));
+    EXPECT_CALL(*connections_[1], readDisable(true));
+    EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::Connected));
+  }
+  connections_[1]->raiseEvent(ConnectionEvent::Connected);
+
+  EXPECT_CALL(*connections_[1], readDisable(false));
+  impl_->readDisable(false);
+  EXPECT_CALL(*connections_[1], close(ConnectionCloseType::NoFlush));
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::LocalClose));
+  impl_->close(ConnectionCloseType::NoFlush);
+}
+
+// Closing before any attempt connected closes the first attempt in place of the connection.
+TEST_F(HappyEyeballsConnectionImplTest, CloseBeforeConnected) {
+  startSecondAttempt();
+
+  EXPECT_CALL(*connections_[1], close(ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*connections_[0], close(ConnectionCloseType::FlushWrite));
+  EXPECT_CALL(callbacks_, onEvent(ConnectionEvent::LocalClose));
+  impl_->close(ConnectionCloseType::FlushWrite);
+  EXPECT_FALSE(next_attempt_timer_->enabled());
+  EXPECT_EQ(Connection::State::Closed, impl_->state());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
@@ -1,3 +1,8 @@
+#if ENVOY_ZERO_COPY_SEND
+#include <linux/errqueue.h>
+#endif
+
+#include "common/buffer/buffer_impl.h"
 #include "common/common/utility.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
@@ -95,6 +100,120 @@ TEST(IoSocketHandleImpl, LastRoundTripTimeReturnsRttIfSuccessful) {
   EXPECT_THAT(io_handle.lastRoundTripTime(),
               Eq(std::chrono::duration_cast<std::chrono::milliseconds>(rtt)));
 }
+
+TEST(IoSocketHandleImpl, WriteGathersUpToMaxWriteSlices) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+
+  const uint64_t num_slices = IoSocketHandleImpl::MaxWriteSlices + 10;
+  Buffer::OwnedImpl buffer;
+  for (uint64_t i = 0; i < num_slices; i++) {
+    buffer.appendSliceForTest("a");
+  }
+
+  IoSocketHandleImpl io_handle(42);
+  // The first write() gathers MaxWriteSlices slices into a single writev().
+  EXPECT_CALL(os_sys_calls, writev(42, _, IoSocketHandleImpl::MaxWriteSlices))
+      .WillOnce(Return(Api::SysCallSizeResult{IoSocketHandleImpl::MaxWriteSlices, 0}));
+  Api::IoCallUint64Result result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(IoSocketHandleImpl::MaxWriteSlices, result.rc_);
+  EXPECT_EQ(10, buffer.length());
+
+  // The remainder is flushed with one more call.
+  EXPECT_CALL(os_sys_calls, writev(42, _, 10)).WillOnce(Return(Api::SysCallSizeResult{10, 0}));
+  result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, buffer.length());
+}
+
+#if ENVOY_ZERO_COPY_SEND
+// Queues the completion of the zero copy sends in the range on the error queue read by recvmsg().
+Api::SysCallSizeResult zeroCopyCompletion(msghdr* message, uint32_t first, uint32_t last,
+                                          bool copied) {
+  sock_extended_err error{};
+  error.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  error.ee_code = copied ? SO_EE_CODE_ZEROCOPY_COPIED : 0;
+  error.ee_info = first;
+  error.ee_data = last;
+  cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+  cmsg->cmsg_level = IPPROTO_IP;
+  cmsg->cmsg_type = IP_RECVERR;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(error));
+  memcpy(CMSG_DATA(cmsg), &error, sizeof(error));
+  message->msg_controllen = CMSG_SPACE(sizeof(error));
+  return {0, 0};
+}
+
+// Once SO_ZEROCOPY is set, the large writes are sent with MSG_ZEROCOPY and their data is kept until
+// their completion, while the small ones are still copied.
+TEST(IoSocketHandleImpl, ZeroCopySends) {
+  NiceMock<Envoy::Api::MockOsSysCalls> os_sys_calls;
+  auto os_calls =
+      std::make_unique<Envoy::TestThreadsafeSingletonInjector<Envoy::Api::OsSysCallsImpl>>(
+          &os_sys_calls);
+
+  IoSocketHandleImpl io_handle(42);
+  const int enable = 1;
+  EXPECT_EQ(0, io_handle.setOption(SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)).rc_);
+
+  const uint64_t slice_size = IoSocketHandleImpl::ZeroCopyMinWriteSize;
+  Buffer::OwnedImpl buffer;
+  for (int i = 0; i < 3; i++) {
+    buffer.appendSliceForTest(std::string(slice_size, static_cast<char>('a' + i)));
+  }
+
+  // A partial send keeps the whole storage of the slice partially sent.
+  EXPECT_CALL(os_sys_calls, sendmsg(42, _, MSG_ZEROCOPY))
+      .WillOnce(Return(Api::SysCallSizeResult{static_cast<ssize_t>(slice_size + 10), 0}));
+  Api::IoCallUint64Result result = io_handle.write(buffer);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(slice_size + 10, result.rc_);
+  EXPECT_EQ(2 * slice_size - 10, buffer.length());
+  EXPECT_EQ(2 * slice_size, io_handle.zeroCopyPendingBytes());
+  EXPECT_EQ(std::string(slice_size - 10, 'b'), buffer.toString().substr(0, slice_size - 10));
+
+  // Nothing completed yet.
+  EXPECT_CALL(os_sys_calls, recvmsg(42, _, MSG_ERRQUEUE))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  EXPECT_CALL(os_sys_calls, sendmsg(42, _, MSG_ZEROCOPY))
+      .WillOnce(Return(Api::SysCallSizeResult{static_cast<ssize_t>(slice_size), 0}));
+  result = io_handle.write(buffer);
+  EXPECT_EQ(slice_size, result.rc_);
+  EXPECT_EQ(slice_size - 10, buffer.length());
+  // The rest of the first partially sent slice, and the whole third one.
+  EXPECT_EQ(4 * slice_size - 10, io_handle.zeroCopyPendingBytes());
+
+  // The second send completes first, its data is kept until the first one completes too. The rest
+  // of the buffer is too small to be sent without copying.
+  EXPECT_CALL(os_sys_calls, recvmsg(42, _, MSG_ERRQUEUE))
+      .WillOnce(Invoke([](os_fd_t, msghdr* message, int) {
+        return zeroCopyCompletion(message, 1, 1, false);
+      }))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  EXPECT_CALL(os_sys_calls, writev(42, _, 1))
+      .WillOnce(Return(Api::SysCallSizeResult{static_cast<ssize_t>(slice_size - 10), 0}));
+  result = io_handle.write(buffer);
+  EXPECT_EQ(slice_size - 10, result.rc_);
+  EXPECT_EQ(0, buffer.length());
+  EXPECT_EQ(4 * slice_size - 10, io_handle.zeroCopyPendingBytes());
+
+  // Once the kernel reports copying the data anyway, the writes are copied.
+  EXPECT_CALL(os_sys_calls, recvmsg(42, _, MSG_ERRQUEUE))
+      .WillOnce(Invoke([](os_fd_t, msghdr* message, int) {
+        return zeroCopyCompletion(message, 0, 0, true);
+      }));
+  buffer.appendSliceForTest(std::string(slice_size, 'd'));
+  EXPECT_CALL(os_sys_calls, writev(42, _, 1))
+      .WillOnce(Return(Api::SysCallSizeResult{static_cast<ssize_t>(slice_size), 0}));
+  result = io_handle.write(buffer);
+  EXPECT_EQ(slice_size, result.rc_);
+  EXPECT_EQ(0, io_handle.zeroCopyPendingBytes());
+}
+#endif
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
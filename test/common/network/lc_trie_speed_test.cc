@@ -50,6 +50,34 @@ struct CidrInputs {
       tag_data_minimal_;
 };
 
+struct LargeCidrInputs {
+  LargeCidrInputs() {
+    // Construct a set of 1,000,000 /24 prefixes spread over 256 tags, as loaded from geo or
+    // threat feeds, and a 0.0.0.0/0 catch-all.
+    static const size_t num_prefixes = 1000000;
+    tag_data_.resize(257);
+    for (size_t i = 0; i < 256; i++) {
+      tag_data_[i].first = fmt::format("tag_{}", i);
+      tag_data_[i].second.reserve(num_prefixes / 256 + 1);
+    }
+    for (size_t i = 0; i < num_prefixes; i++) {
+      tag_data_[i % 256].second.emplace_back(Envoy::Network::Address::CidrRange::create(
+          fmt::format("{}.{}.{}.0/24", i >> 16, (i >> 8) & 0xff, i & 0xff)));
+    }
+    tag_data_[256].first = "catch_all";
+    tag_data_[256].second.emplace_back(Envoy::Network::Address::CidrRange::create("0.0.0.0/0"));
+
+    // Random test addresses within the prefixes.
+    for (size_t i = 0; i < 10; i++) {
+      addresses_.push_back(Envoy::Network::Utility::parseInternetAddress(
+          fmt::format("{}.{}.{}.{}", i, (i * 37) & 0xff, (i * 101) & 0xff, i * 25)));
+    }
+  }
+
+  std::vector<std::pair<std::string, std::vector<Envoy::Network::Address::CidrRange>>> tag_data_;
+  std::vector<Envoy::Network::Address::InstanceConstSharedPtr> addresses_;
+};
+
 } // namespace
 
 namespace Envoy {
@@ -91,6 +119,18 @@ static void lcTrieConstructMinimal(benchmark::State& state) {
 
 BENCHMARK(lcTrieConstructMinimal);
 
+static void lcTrieConstructLarge(benchmark::State& state) {
+  LargeCidrInputs inputs;
+
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> trie;
+  for (auto _ : state) {
+    trie = std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(inputs.tag_data_);
+  }
+  benchmark::DoNotOptimize(trie);
+}
+
+BENCHMARK(lcTrieConstructLarge)->Unit(benchmark::kMillisecond);
+
 static void lcTrieLookup(benchmark::State& state) {
   CidrInputs cidr_inputs;
   AddressInputs address_inputs;
@@ -146,4 +186,21 @@ static void lcTrieLookupMinimal(benchmark::State& state) {
 
 BENCHMARK(lcTrieLookupMinimal);
 
+static void lcTrieLookupLarge(benchmark::State& state) {
+  LargeCidrInputs inputs;
+  std::unique_ptr<Envoy::Network::LcTrie::LcTrie<std::string>> lc_trie_large =
+      std::make_unique<Envoy::Network::LcTrie::LcTrie<std::string>>(inputs.tag_data_);
+
+  static size_t i = 0;
+  size_t output_tags = 0;
+  for (auto _ : state) {
+    i++;
+    i %= inputs.addresses_.size();
+    output_tags += lc_trie_large->getData(inputs.addresses_[i]).size();
+  }
+  benchmark::DoNotOptimize(output_tags);
+}
+
+BENCHMARK(lcTrieLookupLarge);
+
 } // namespace Envoy
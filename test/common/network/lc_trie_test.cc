@@ -325,10 +325,60 @@ TEST_F(LcTrieTest, ExclusiveNestedPrefixesWithCatchAll) {
   expectIPAndTags(test_case);
 }
 
-// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^20 nodes
+// The prefixes resolving to the same data share a single data set.
+TEST_F(LcTrieTest, SharedDataSets) {
+  std::vector<std::vector<std::string>> cidr_range_strings = {
+      {"0.0.0.0/0"},                                         // tag_0
+      {"10.0.0.0/8", "192.168.0.0/16", "2001:db8::/32"},     // tag_1
+      {"10.1.0.0/16", "10.2.0.0/16", "192.168.1.0/24"},      // tag_2
+      {"10.1.0.0/16", "2001:db8:1::/48", "2001:db8:2::/48"}, // tag_3
+  };
+  setup(cidr_range_strings);
+
+  std::vector<std::pair<std::string, std::vector<std::string>>> test_case = {
+      {"1.2.3.4", {"tag_0"}},
+      {"10.0.0.1", {"tag_0", "tag_1"}},
+      {"10.1.0.1", {"tag_0", "tag_1", "tag_2", "tag_3"}},
+      {"10.2.0.1", {"tag_0", "tag_1", "tag_2"}},
+      {"192.168.1.1", {"tag_0", "tag_1", "tag_2"}},
+      {"2001:db8::1", {"tag_1"}},
+      {"2001:db8:1::1", {"tag_1", "tag_3"}},
+      {"2001:db8:2::1", {"tag_1", "tag_3"}},
+      {"::1", {}}};
+  expectIPAndTags(test_case);
+
+  // The empty data set, and the 6 distinct data sets above.
+  EXPECT_EQ(7, trie_->dataSets().size());
+  EXPECT_TRUE(trie_->dataSets()[0].empty());
+  EXPECT_EQ(trie_->getDataSetIndex(Utility::parseInternetAddress("10.2.0.1")),
+            trie_->getDataSetIndex(Utility::parseInternetAddress("192.168.1.1")));
+  EXPECT_EQ(0, trie_->getDataSetIndex(Utility::parseInternetAddress("::1")));
+}
+
+// The trie holds more than the 2^18 CIDR ranges it was previously limited to.
+TEST_F(LcTrieTest, LargeNumberOfEntries) {
+  static const size_t num_prefixes = 1 << 19;
+  std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input(2);
+  ip_tags_input[0].first = "even";
+  ip_tags_input[1].first = "odd";
+  for (size_t i = 0; i < num_prefixes; i++) {
+    ip_tags_input[i % 2].second.emplace_back(Address::CidrRange::create(
+        fmt::format("10.{}.{}.{}/32", i >> 16, (i >> 8) & 0xff, i & 0xff)));
+  }
+
+  LcTrie<std::string> trie(ip_tags_input);
+  EXPECT_EQ(std::vector<std::string>{"even"},
+            trie.getData(Utility::parseInternetAddress("10.7.255.254")));
+  EXPECT_EQ(std::vector<std::string>{"odd"},
+            trie.getData(Utility::parseInternetAddress("10.7.255.255")));
+  EXPECT_TRUE(trie.getData(Utility::parseInternetAddress("10.8.0.0")).empty());
+  EXPECT_EQ(3, trie.dataSets().size());
+}
+
+// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^22 nodes
 // when using the default fill factor.
 TEST_F(LcTrieTest, MaximumEntriesExceptionDefault) {
-  static const size_t num_prefixes = 1 << 19;
+  static const size_t num_prefixes = 1 << 21;
   Address::CidrRange address = Address::CidrRange::create("10.0.0.1/8");
   std::vector<Address::CidrRange> prefixes;
   prefixes.reserve(num_prefixes);
@@ -337,24 +387,24 @@ TEST_F(LcTrieTest, MaximumEntriesExceptionDefault) {
   }
   EXPECT_EQ(num_prefixes, prefixes.size());
 
-  std::pair<std::string, std::vector<Address::CidrRange>> ip_tag =
-      std::make_pair("bad_tag", prefixes);
-  std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input{ip_tag};
+  // The prefixes are moved rather than copied, given their number.
+  std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input;
+  ip_tags_input.emplace_back("bad_tag", std::move(prefixes));
   EXPECT_THROW_WITH_MESSAGE(new LcTrie<std::string>(ip_tags_input), EnvoyException,
-                            "The input vector has '524288' CIDR range entries. "
-                            "LC-Trie can only support '262144' CIDR ranges with "
+                            "The input vector has '2097152' CIDR range entries. "
+                            "LC-Trie can only support '1048576' CIDR ranges with "
                             "the specified fill factor.");
 }
 
-// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^20 nodes
+// Ensure the trie will reject inputs that would cause it to exceed the maximum 2^22 nodes
 // when using a fill factor override.
 TEST_F(LcTrieTest, MaximumEntriesExceptionOverride) {
-  static const size_t num_prefixes = 8192;
+  static const size_t num_prefixes = 32768;
   std::vector<Address::CidrRange> prefixes;
   prefixes.reserve(num_prefixes);
   for (size_t i = 0; i < 16; i++) {
     for (size_t j = 0; j < 16; j++) {
-      for (size_t k = 0; k < 32; k++) {
+      for (size_t k = 0; k < 128; k++) {
         prefixes.emplace_back(Address::CidrRange::create(fmt::format("10.{}.{}.{}/8", i, j, k)));
       }
     }
@@ -365,8 +415,8 @@ TEST_F(LcTrieTest, MaximumEntriesExceptionOverride) {
       std::make_pair("bad_tag", prefixes);
   std::vector<std::pair<std::string, std::vector<Address::CidrRange>>> ip_tags_input{ip_tag};
   EXPECT_THROW_WITH_MESSAGE(new LcTrie<std::string>(ip_tags_input, false, 0.01), EnvoyException,
-                            "The input vector has '8192' CIDR range entries. "
-                            "LC-Trie can only support '5242' CIDR ranges with "
+                            "The input vector has '32768' CIDR range entries. "
+                            "LC-Trie can only support '20971' CIDR ranges with "
                             "the specified fill factor.");
 }
 
@@ -342,6 +342,45 @@ TEST_P(TcpListenerImplTest, DisableAndEnableListener) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Test that the accept batch size shrinks when setting up the accepted connections is slow, and
+// grows back when it's fast.
+TEST_P(TcpListenerImplTest, AdaptiveAcceptBatchSize) {
+  auto socket = std::make_shared<TcpListenSocket>(
+      Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
+  MockTcpListenerCallbacks listener_callbacks;
+  Random::MockRandomGenerator random_generator;
+  TestTcpListenerImpl listener(dispatcherImpl(), random_generator, socket, listener_callbacks,
+                               true);
+  EXPECT_EQ(TcpListenerImpl::MaxAcceptBatchSize, listener.acceptBatchSize());
+
+  std::vector<ClientConnectionPtr> client_connections;
+  auto connect = [&]() {
+    client_connections.emplace_back(dispatcher_->createClientConnection(
+        socket->addressProvider().localAddress(), Address::InstanceConstSharedPtr(),
+        Network::Test::createRawBufferSocket(), nullptr));
+    client_connections.back()->connect();
+  };
+
+  connect();
+  EXPECT_CALL(listener_callbacks, onAccept_(_)).WillOnce(Invoke([&](ConnectionSocketPtr&) -> void {
+    time_system_.advanceTimeAsync(2 * TcpListenerImpl::AcceptBatchTimeBudget);
+    dispatcher_->exit();
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(TcpListenerImpl::MaxAcceptBatchSize / 2, listener.acceptBatchSize());
+
+  connect();
+  EXPECT_CALL(listener_callbacks, onAccept_(_)).WillOnce(Invoke([&](ConnectionSocketPtr&) -> void {
+    dispatcher_->exit();
+  }));
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(TcpListenerImpl::MaxAcceptBatchSize, listener.acceptBatchSize());
+
+  for (const auto& conn : client_connections) {
+    conn->close(ConnectionCloseType::NoFlush);
+  }
+}
+
 TEST_P(TcpListenerImplTest, SetListenerRejectFractionZero) {
   auto socket = std::make_shared<TcpListenSocket>(
       Network::Test::getCanonicalLoopbackAddress(version_), nullptr, true);
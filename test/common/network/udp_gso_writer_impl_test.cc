@@ -0,0 +1,210 @@
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/address_impl.h"
+#include "common/network/io_socket_error_impl.h"
+#include "common/network/udp_gso_writer_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/mocks/network/io_handle.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::ByMove;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class MockOsSysCallsWithGso : public Api::MockOsSysCalls {
+public:
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+};
+
+// What a single sendmsg() call carried.
+struct SentMessage {
+  std::string data_;
+  uint16_t segment_size_{};
+  bool has_pktinfo_{};
+};
+
+class UdpGsoWriterTest : public testing::Test {
+public:
+  UdpGsoWriterTest() {
+    ON_CALL(os_sys_calls_, supportsUdpGso()).WillByDefault(Return(true));
+    ON_CALL(os_sys_calls_, sendmsg(_, _, _))
+        .WillByDefault(Invoke([this](os_fd_t, const msghdr* message, int) {
+          SentMessage sent;
+          for (size_t i = 0; i < message->msg_iovlen; ++i) {
+            sent.data_.append(static_cast<const char*>(message->msg_iov[i].iov_base),
+                              message->msg_iov[i].iov_len);
+          }
+          for (const cmsghdr* cmsg = CMSG_FIRSTHDR(message); cmsg != nullptr;
+               cmsg = CMSG_NXTHDR(const_cast<msghdr*>(message), const_cast<cmsghdr*>(cmsg))) {
+#ifdef UDP_SEGMENT
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_SEGMENT) {
+              sent.segment_size_ = *reinterpret_cast<const uint16_t*>(CMSG_DATA(cmsg));
+            }
+#endif
+            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+              sent.has_pktinfo_ = true;
+            }
+          }
+          sent_.push_back(sent);
+          return Api::SysCallSizeResult{static_cast<ssize_t>(sent.data_.size()), 0};
+        }));
+  }
+
+  Api::IoCallUint64Result write(UdpGsoWriter& writer, const std::string& data,
+                                const Address::Instance& peer,
+                                const Address::Ip* local_ip = nullptr) {
+    Buffer::OwnedImpl buffer(data);
+    return writer.writePacket(buffer, local_ip, peer);
+  }
+
+  NiceMock<MockOsSysCallsWithGso> os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_{&os_sys_calls_};
+  NiceMock<MockIoHandle> io_handle_;
+  Stats::IsolatedStoreImpl store_;
+  const UdpGsoWriterStats stats_{UdpGsoWriterStats::generate(store_, "udp_gso_writer.")};
+  const Address::InstanceConstSharedPtr peer_{
+      Utility::parseInternetAddressAndPort("10.0.0.1:1000")};
+  const Address::InstanceConstSharedPtr other_peer_{
+      Utility::parseInternetAddressAndPort("10.0.0.2:1000")};
+  std::vector<SentMessage> sent_;
+};
+
+#ifdef UDP_SEGMENT
+TEST_F(UdpGsoWriterTest, CoalescesUntilFlush) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  EXPECT_TRUE(writer.isBatchMode());
+  for (int i = 0; i < 3; ++i) {
+    const Api::IoCallUint64Result result = write(writer, "hello", *peer_);
+    EXPECT_TRUE(result.ok());
+    EXPECT_EQ(5, result.rc_);
+  }
+  EXPECT_EQ(3, writer.bufferedDatagrams());
+  EXPECT_TRUE(sent_.empty());
+
+  const Api::IoCallUint64Result result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(15, result.rc_);
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ("hellohellohello", sent_[0].data_);
+  EXPECT_EQ(5, sent_[0].segment_size_);
+  EXPECT_EQ(0, writer.bufferedDatagrams());
+
+  // Nothing left to send.
+  EXPECT_TRUE(writer.flush().ok());
+  EXPECT_EQ(1, sent_.size());
+}
+
+TEST_F(UdpGsoWriterTest, ShorterDatagramEndsBatch) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_TRUE(write(writer, "hi", *peer_).ok());
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ("hellohellohi", sent_[0].data_);
+  EXPECT_EQ(5, sent_[0].segment_size_);
+  EXPECT_EQ(0, writer.bufferedDatagrams());
+}
+
+TEST_F(UdpGsoWriterTest, LongerDatagramStartsNewBatch) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  EXPECT_TRUE(write(writer, "hi", *peer_).ok());
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  // A batch of one is sent without a segment size.
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ("hi", sent_[0].data_);
+  EXPECT_EQ(0, sent_[0].segment_size_);
+  EXPECT_EQ(1, writer.bufferedDatagrams());
+}
+
+TEST_F(UdpGsoWriterTest, DestinationChangeEndsBatch) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  const Address::InstanceConstSharedPtr local =
+      Utility::parseInternetAddressAndPort("10.0.0.3:80");
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_TRUE(write(writer, "hello", *other_peer_).ok());
+  EXPECT_TRUE(write(writer, "hello", *other_peer_, local->ip()).ok());
+  EXPECT_TRUE(writer.flush().ok());
+  ASSERT_EQ(3, sent_.size());
+  EXPECT_EQ("hellohello", sent_[0].data_);
+  EXPECT_FALSE(sent_[0].has_pktinfo_);
+  EXPECT_EQ("hello", sent_[1].data_);
+  EXPECT_FALSE(sent_[1].has_pktinfo_);
+  EXPECT_EQ("hello", sent_[2].data_);
+  EXPECT_TRUE(sent_[2].has_pktinfo_);
+}
+
+TEST_F(UdpGsoWriterTest, FullBatchIsSent) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  for (uint32_t i = 0; i < UdpGsoWriter::MaxSegments; ++i) {
+    EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  }
+  ASSERT_EQ(1, sent_.size());
+  EXPECT_EQ(5 * UdpGsoWriter::MaxSegments, sent_[0].data_.size());
+  EXPECT_EQ(0, writer.bufferedDatagrams());
+}
+
+TEST_F(UdpGsoWriterTest, FallsBackToSingleDatagramsIfGsoFails) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, EIO}))
+      .WillRepeatedly(Return(Api::SysCallSizeResult{5, 0}));
+  const Api::IoCallUint64Result result = writer.flush();
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(10, result.rc_);
+}
+
+TEST_F(UdpGsoWriterTest, WriteBlocked) {
+  UdpGsoWriter writer(io_handle_, stats_);
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, _))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  Api::IoCallUint64Result result = writer.flush();
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_TRUE(writer.isWriteBlocked());
+  EXPECT_EQ(0, writer.bufferedDatagrams());
+
+  // Nothing is buffered while blocked.
+  result = write(writer, "hello", *peer_);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(0, writer.bufferedDatagrams());
+
+  writer.setWritable();
+  EXPECT_TRUE(write(writer, "hello", *peer_).ok());
+  EXPECT_EQ(1, writer.bufferedDatagrams());
+}
+#endif
+
+TEST_F(UdpGsoWriterTest, WritesImmediatelyWithoutGso) {
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillRepeatedly(Return(false));
+  UdpGsoWriter writer(io_handle_, stats_);
+  EXPECT_FALSE(writer.isBatchMode());
+  EXPECT_CALL(io_handle_, sendmsg(_, 1, 0, nullptr, _))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          5, Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError)))));
+  const Api::IoCallUint64Result result = write(writer, "hello", *peer_);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.rc_);
+  EXPECT_EQ(0, writer.bufferedDatagrams());
+  EXPECT_TRUE(writer.flush().ok());
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
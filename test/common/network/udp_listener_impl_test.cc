@@ -576,6 +576,8 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
       }))
       .WillRepeatedly(Return(Api::SysCallSizeResult{-1, EAGAIN}));
 
+  // The packets reference the storage of the concatenated payload instead of copying it.
+  const char* first_packet = nullptr;
   EXPECT_CALL(listener_callbacks_, onReadReady());
   EXPECT_CALL(listener_callbacks_, onData(_))
       .WillOnce(Invoke([&](const UdpRecvData& data) -> void {
@@ -583,12 +585,15 @@ TEST_P(UdpListenerImplTest, UdpGroBasic) {
 
         const std::string data_str = data.buffer_->toString();
         EXPECT_EQ(data_str, client_data[num_packets_received_by_listener_ - 1]);
+        first_packet = static_cast<const char*>(data.buffer_->frontSlice().mem_);
       }))
       .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
         validateRecvCallbackParams(data, client_data.size());
 
         const std::string data_str = data.buffer_->toString();
         EXPECT_EQ(data_str, client_data[num_packets_received_by_listener_ - 1]);
+        EXPECT_EQ(first_packet + 8 * (num_packets_received_by_listener_ - 1),
+                  data.buffer_->frontSlice().mem_);
       }));
 
   EXPECT_CALL(listener_callbacks_, onWriteReady(_)).WillOnce(Invoke([&](const Socket& socket) {
@@ -109,5 +109,25 @@ TEST(EnvoyQuicUtilsTest, HeadersConversion) {
             quicHeadersToEnvoyHeaders<Http::RequestHeaderMapImpl>(quic_headers2, validator));
 }
 
+TEST(EnvoyQuicUtilsTest, AdjustNewConnectionIdForRouting) {
+  const char old_data[] = {0x12, 0x34, 0x56, 0x78, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+  quic::QuicConnectionId old_connection_id(old_data, sizeof(old_data));
+  quic::QuicConnectionId new_connection_id = quic::test::TestConnectionId(0xabcdef);
+  const quic::QuicConnectionId original_new_connection_id = new_connection_id;
+
+  adjustNewConnectionIdForRouting(new_connection_id, old_connection_id);
+  EXPECT_EQ(original_new_connection_id.length(), new_connection_id.length());
+  EXPECT_EQ(0, memcmp(old_data, new_connection_id.data(), 4));
+  // The rest of the new connection id is left as is.
+  EXPECT_EQ(0, memcmp(original_new_connection_id.data() + 4, new_connection_id.data() + 4,
+                      new_connection_id.length() - 4));
+
+  // Connection ids shorter than the routing word aren't adjusted.
+  quic::QuicConnectionId short_connection_id(old_data, 2);
+  quic::QuicConnectionId unchanged_connection_id = original_new_connection_id;
+  adjustNewConnectionIdForRouting(unchanged_connection_id, short_connection_id);
+  EXPECT_EQ(original_new_connection_id, unchanged_connection_id);
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -1270,6 +1270,188 @@ virtual_hosts:
   }
 }
 
+// Virtual hosts with enough routes are matched through a path index; ensure it evaluates
+// candidates in route table order and agrees with the linear scan.
+TEST_F(RouteMatcherTest, RouteIndexPreservesFirstMatch) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: www
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/foo/bar"
+          headers:
+            - name: x-exp
+              present_match: true
+        route: { cluster: "header" }
+      - match: { path: "/foo" }
+        route: { cluster: "exact_foo" }
+      - match: { prefix: "/FOO", case_sensitive: false }
+        route: { cluster: "case_insensitive" }
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/foo/[0-9]+"
+        route: { cluster: "regex" }
+      - match: { prefix: "/foo/" }
+        route: { cluster: "foo_prefix" }
+      - match: { path: "/foo/1" }
+        route: { cluster: "exact_foo_1" }
+      - match: { prefix: "/bar" }
+        route: { cluster: "bar" }
+      - match: { prefix: "/" }
+        route: { cluster: "root" }
+  )EOF";
+
+  for (const std::string& index_enabled : {"true", "false"}) {
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.route_path_index", index_enabled}});
+
+    factory_context_.cluster_manager_.initializeClusters(
+        {"header", "exact_foo", "case_insensitive", "regex", "foo_prefix", "exact_foo_1", "bar",
+         "root"},
+        {});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+    auto cluster_for_path = [&config](const std::string& path) {
+      return config.route(genHeaders("www.lyft.com", path, "GET"), 0)->routeEntry()->clusterName();
+    };
+
+    EXPECT_EQ("exact_foo", cluster_for_path("/foo"));
+    EXPECT_EQ("exact_foo", cluster_for_path("/foo?a=b"));
+    EXPECT_EQ("case_insensitive", cluster_for_path("/Foo"));
+    EXPECT_EQ("regex", cluster_for_path("/foo/1"));
+    EXPECT_EQ("foo_prefix", cluster_for_path("/foo/x"));
+    EXPECT_EQ("foo_prefix", cluster_for_path("/foo/bar"));
+    EXPECT_EQ("bar", cluster_for_path("/bar/baz"));
+    EXPECT_EQ("root", cluster_for_path("/baz"));
+
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo/bar", "GET");
+    headers.addCopy("x-exp", "1");
+    EXPECT_EQ("header", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+}
+
+// The safe regexes of the regex routes are matched at once through the path index; ensure the
+// first matching regex route in route table order still wins.
+TEST_F(RouteMatcherTest, RouteIndexRegexSet) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: www
+    domains: ["*"]
+    routes:
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/foo/[0-9]+"
+          headers:
+            - name: x-exp
+              present_match: true
+        route: { cluster: "header" }
+      - match: { prefix: "/foo/1" }
+        route: { cluster: "prefix_foo_1" }
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/foo/[0-9]+"
+        route: { cluster: "regex_number" }
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/foo/.*"
+        route: { cluster: "regex_any" }
+      - match: { prefix: "/BAR/", case_sensitive: false }
+        route: { cluster: "case_insensitive" }
+      - match: { prefix: "/bar" }
+        route: { cluster: "bar" }
+      - match: { path: "/baz" }
+        route: { cluster: "baz" }
+      - match: { prefix: "/" }
+        route: { cluster: "root" }
+  )EOF";
+
+  for (const std::string& index_enabled : {"true", "false"}) {
+    TestScopedRuntime scoped_runtime;
+    Runtime::LoaderSingleton::getExisting()->mergeValues(
+        {{"envoy.reloadable_features.route_path_index", index_enabled}});
+
+    factory_context_.cluster_manager_.initializeClusters(
+        {"header", "prefix_foo_1", "regex_number", "regex_any", "case_insensitive", "bar", "baz",
+         "root"},
+        {});
+    TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+    auto cluster_for_path = [&config](const std::string& path) {
+      return config.route(genHeaders("www.lyft.com", path, "GET"), 0)->routeEntry()->clusterName();
+    };
+
+    EXPECT_EQ("prefix_foo_1", cluster_for_path("/foo/12"));
+    EXPECT_EQ("regex_number", cluster_for_path("/foo/2"));
+    EXPECT_EQ("regex_number", cluster_for_path("/foo/2?a=b"));
+    EXPECT_EQ("regex_any", cluster_for_path("/foo/x"));
+    EXPECT_EQ("case_insensitive", cluster_for_path("/bar/x"));
+    EXPECT_EQ("bar", cluster_for_path("/bar"));
+    EXPECT_EQ("root", cluster_for_path("/foo"));
+
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo/2", "GET");
+    headers.addCopy("x-exp", "1");
+    EXPECT_EQ("header", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+}
+
+// The cached route decisions are the same as the ones of the route matching, including for the
+// headers that the routes match on.
+TEST_F(RouteMatcherTest, RouteCache) {
+  const std::string yaml = R"EOF(
+route_cache_size: 2
+virtual_hosts:
+  - name: secure
+    domains: ["secure.lyft.com"]
+    require_tls: ALL
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "secure" }
+  - name: default
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/"
+          headers:
+            - name: x-exp
+              exact_match: "1"
+        route: { cluster: "header" }
+      - match: { prefix: "/dynamic" }
+        route: { cluster_header: "x-cluster" }
+      - match: { prefix: "/foo" }
+        route: { cluster: "foo" }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters({"secure", "header", "foo"}, {});
+  TestConfigImpl config(parseRouteConfigurationFromYaml(yaml), factory_context_, true);
+
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_EQ("foo", config.route(genHeaders("www.lyft.com", "/foo", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+    EXPECT_EQ(nullptr, config.route(genHeaders("www.lyft.com", "/bar", "GET"), 0));
+
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo", "GET");
+    headers.addCopy("x-exp", "1");
+    EXPECT_EQ("header", config.route(headers, 0)->routeEntry()->clusterName());
+
+    headers = genHeaders("www.lyft.com", "/dynamic", "GET");
+    headers.addCopy("x-cluster", "bar");
+    EXPECT_EQ("bar", config.route(headers, 0)->routeEntry()->clusterName());
+    headers.setCopy(Http::LowerCaseString("x-cluster"), "baz");
+    EXPECT_EQ("baz", config.route(headers, 0)->routeEntry()->clusterName());
+
+    EXPECT_NE(nullptr, config.route(genHeaders("secure.lyft.com", "/", "GET", "http"), 0)
+                           ->directResponseEntry());
+    EXPECT_EQ("secure", config.route(genHeaders("secure.lyft.com", "/", "GET", "https"), 0)
+                            ->routeEntry()
+                            ->clusterName());
+  }
+}
+
 TEST_F(RouteMatcherTest, TestRoutesWithWildcardAndDefaultOnly) {
   const std::string yaml = R"EOF(
 virtual_hosts:
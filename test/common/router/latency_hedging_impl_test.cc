@@ -0,0 +1,91 @@
+#include <chrono>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+
+#include "common/router/latency_hedging_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+LatencyHedgingImpl createLatencyHedging(const std::string& yaml) {
+  envoy::config::route::v3::HedgePolicy::LatencyPercentileHedging config;
+  TestUtility::loadFromYaml(yaml, config);
+  return LatencyHedgingImpl(config);
+}
+
+// The latencies under 8ms have their own bucket, and each power of two above is split in 8.
+TEST(LatencyHedgingImplTest, Buckets) {
+  EXPECT_EQ(0, LatencyHedgingImpl::bucketIndex(0));
+  EXPECT_EQ(7, LatencyHedgingImpl::bucketIndex(7));
+  EXPECT_EQ(7, LatencyHedgingImpl::bucketUpperBound(7));
+  EXPECT_EQ(8, LatencyHedgingImpl::bucketIndex(8));
+  EXPECT_EQ(8, LatencyHedgingImpl::bucketUpperBound(8));
+  EXPECT_EQ(36, LatencyHedgingImpl::bucketIndex(96));
+  EXPECT_EQ(36, LatencyHedgingImpl::bucketIndex(103));
+  EXPECT_EQ(37, LatencyHedgingImpl::bucketIndex(104));
+  EXPECT_EQ(103, LatencyHedgingImpl::bucketUpperBound(36));
+
+  // The largest latencies share the last bucket.
+  EXPECT_EQ(LatencyHedgingImpl::NumBuckets - 1,
+            LatencyHedgingImpl::bucketIndex(std::chrono::hours(24 * 365).count()));
+  EXPECT_EQ((1ULL << LatencyHedgingImpl::MaxLatencyBits) - 1,
+            LatencyHedgingImpl::bucketUpperBound(LatencyHedgingImpl::NumBuckets - 1));
+}
+
+// The requests aren't hedged until the route has enough latencies to compute the percentile.
+TEST(LatencyHedgingImplTest, Percentile) {
+  LatencyHedgingImpl hedging = createLatencyHedging(R"EOF(
+percentile:
+  value: 90
+min_samples: 10
+)EOF");
+
+  for (uint32_t i = 0; i < 9; ++i) {
+    hedging.recordLatency(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(absl::nullopt, hedging.hedgeDelay());
+
+  hedging.recordLatency(std::chrono::milliseconds(100));
+  EXPECT_EQ(std::chrono::milliseconds(5), hedging.hedgeDelay());
+
+  // The delay follows the latencies as they are recorded.
+  for (uint32_t i = 10; i < LatencyHedgingImpl::RefreshInterval; ++i) {
+    hedging.recordLatency(std::chrono::milliseconds(100));
+  }
+  EXPECT_EQ(std::chrono::milliseconds(103), hedging.hedgeDelay());
+}
+
+// The hedges are capped to the budget of the requests of the route.
+TEST(LatencyHedgingImplTest, Budget) {
+  LatencyHedgingImpl hedging = createLatencyHedging(R"EOF(
+percentile:
+  value: 95
+budget:
+  value: 20
+)EOF");
+
+  EXPECT_FALSE(hedging.tryHedge());
+  for (uint32_t i = 0; i < 10; ++i) {
+    hedging.hedgeDelay();
+  }
+  EXPECT_TRUE(hedging.tryHedge());
+  EXPECT_TRUE(hedging.tryHedge());
+  EXPECT_FALSE(hedging.tryHedge());
+
+  hedging.hedgeDelay();
+  hedging.hedgeDelay();
+  hedging.hedgeDelay();
+  hedging.hedgeDelay();
+  hedging.hedgeDelay();
+  EXPECT_TRUE(hedging.tryHedge());
+  EXPECT_FALSE(hedging.tryHedge());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -580,6 +580,53 @@ dynamic_route_configs:
   EXPECT_EQ(expected_route_config_dump.DebugString(), route_config_dump3.DebugString());
 }
 
+// Static providers of identical route configurations share the same config.
+TEST_F(RouteConfigProviderManagerImplTest, StaticRouteConfigsAreShared) {
+  const std::string config_yaml = R"EOF(
+name: foo
+virtual_hosts:
+  - name: bar
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: baz }
+)EOF";
+  const auto route_config = parseRouteConfigurationFromV3Yaml(config_yaml);
+  auto other_route_config = route_config;
+  other_route_config.set_name("other");
+
+  server_factory_context_.cluster_manager_.initializeClusters({"baz"}, {});
+  RouteConfigProviderPtr provider1 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, server_factory_context_, validation_visitor_);
+  RouteConfigProviderPtr provider2 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, server_factory_context_, validation_visitor_);
+  RouteConfigProviderPtr provider3 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          other_route_config, server_factory_context_, validation_visitor_);
+  EXPECT_EQ(provider1->config(), provider2->config());
+  EXPECT_NE(provider1->config(), provider3->config());
+  EXPECT_EQ("other", provider3->config()->name());
+
+  // A shared config is validated against the current clusters.
+  server_factory_context_.cluster_manager_.initializeClusters({}, {});
+  EXPECT_THROW_WITH_MESSAGE(route_config_provider_manager_->createStaticRouteConfigProvider(
+                                route_config, server_factory_context_, validation_visitor_),
+                            EnvoyException, "route: unknown cluster 'baz'");
+
+  // The config is built again once no provider holds it.
+  server_factory_context_.cluster_manager_.initializeClusters({"baz"}, {});
+  const Config* config = provider1->config().get();
+  provider1.reset();
+  EXPECT_EQ(config, provider2->config().get());
+  provider2.reset();
+  RouteConfigProviderPtr provider4 =
+      route_config_provider_manager_->createStaticRouteConfigProvider(
+          route_config, server_factory_context_, validation_visitor_);
+  EXPECT_EQ("foo", provider4->config()->name());
+}
+
 TEST_F(RouteConfigProviderManagerImplTest, Basic) {
   Buffer::OwnedImpl data;
 
@@ -0,0 +1,74 @@
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/router/retry_buffer.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+// The data and its copy reference the chunk, which the snapshots share.
+TEST(RetryBufferTest, SnapshotsShareChunks) {
+  RetryBuffer retry_buffer;
+  const std::string large(4096, 'a');
+  Buffer::OwnedImpl data(large);
+  Buffer::OwnedImpl copy;
+  retry_buffer.add(data, copy);
+  EXPECT_EQ(large, data.toString());
+  EXPECT_EQ(large, copy.toString());
+  EXPECT_EQ(4096, retry_buffer.length());
+
+  Buffer::OwnedImpl snapshot;
+  retry_buffer.snapshot(snapshot);
+  EXPECT_EQ(large, snapshot.toString());
+  EXPECT_EQ(data.frontSlice().mem_, snapshot.frontSlice().mem_);
+  EXPECT_EQ(copy.frontSlice().mem_, snapshot.frontSlice().mem_);
+}
+
+// The small chunks are copied, and the snapshots hold the chunks in order.
+TEST(RetryBufferTest, SmallChunksCopied) {
+  RetryBuffer retry_buffer;
+  Buffer::OwnedImpl data("hello");
+  Buffer::OwnedImpl copy;
+  retry_buffer.add(data, copy);
+  EXPECT_EQ("hello", copy.toString());
+  EXPECT_NE(data.frontSlice().mem_, copy.frontSlice().mem_);
+
+  Buffer::OwnedImpl empty;
+  retry_buffer.add(empty, copy);
+  const std::string large(1024, 'b');
+  Buffer::OwnedImpl more(large);
+  retry_buffer.add(more, copy);
+  EXPECT_EQ(5 + 1024, retry_buffer.length());
+
+  Buffer::OwnedImpl snapshot;
+  retry_buffer.snapshot(snapshot);
+  EXPECT_EQ("hello" + large, snapshot.toString());
+}
+
+// The references outlive the body.
+TEST(RetryBufferTest, ReferencesOutliveBody) {
+  Buffer::OwnedImpl snapshot;
+  {
+    RetryBuffer retry_buffer;
+    Buffer::OwnedImpl data(std::string(2048, 'c'));
+    Buffer::OwnedImpl copy;
+    retry_buffer.add(data, copy);
+    retry_buffer.snapshot(snapshot);
+    retry_buffer.clear();
+    EXPECT_EQ(0, retry_buffer.length());
+
+    Buffer::OwnedImpl cleared;
+    retry_buffer.snapshot(cleared);
+    EXPECT_EQ(0, cleared.length());
+  }
+  EXPECT_EQ(std::string(2048, 'c'), snapshot.toString());
+  snapshot.drain(1024);
+  EXPECT_EQ(std::string(1024, 'c'), snapshot.toString());
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,115 @@
+#include <string>
+
+#include "envoy/config/route/v3/route.pb.h"
+
+#include "common/router/route_cache_impl.h"
+
+#include "test/mocks/router/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+envoy::config::route::v3::RouteConfiguration parseRouteConfiguration(const std::string& yaml) {
+  envoy::config::route::v3::RouteConfiguration config;
+  TestUtility::loadFromYaml(yaml, config);
+  return config;
+}
+
+// The decisions of the routes that don't only depend on the headers aren't cached.
+TEST(RouteCacheTest, Disabled) {
+  EXPECT_EQ(nullptr, RouteCache::create(parseRouteConfiguration(R"EOF(
+virtual_hosts:
+  - name: default
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route: { cluster: "foo" }
+  )EOF")));
+
+  EXPECT_EQ(nullptr, RouteCache::create(parseRouteConfiguration(R"EOF(
+route_cache_size: 10
+virtual_hosts:
+  - name: default
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/"
+          runtime_fraction:
+            default_value: { numerator: 50 }
+            runtime_key: key
+        route: { cluster: "foo" }
+  )EOF")));
+
+  EXPECT_EQ(nullptr, RouteCache::create(parseRouteConfiguration(R"EOF(
+route_cache_size: 10
+virtual_hosts:
+  - name: default
+    domains: ["*"]
+    routes:
+      - match: { prefix: "/" }
+        route:
+          weighted_clusters:
+            clusters:
+              - { name: "foo", weight: 50 }
+              - { name: "bar", weight: 50 }
+  )EOF")));
+}
+
+// The keys of the requests differ by the values of the headers the routes depend on only.
+TEST(RouteCacheTest, Keys) {
+  RouteCachePtr cache = RouteCache::create(parseRouteConfiguration(R"EOF(
+route_cache_size: 10
+virtual_hosts:
+  - name: default
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/"
+          headers:
+            - name: x-exp
+              present_match: true
+        route: { cluster: "foo" }
+  )EOF"));
+  ASSERT_NE(nullptr, cache);
+
+  Http::TestRequestHeaderMapImpl headers{{":authority", "host"}, {":path", "/"}};
+  const std::string key = cache->key(headers);
+  headers.addCopy("x-other", "1");
+  EXPECT_EQ(key, cache->key(headers));
+  headers.addCopy("x-exp", "");
+  const std::string empty_header_key = cache->key(headers);
+  EXPECT_NE(key, empty_header_key);
+  headers.addCopy("x-exp", "");
+  EXPECT_NE(empty_header_key, cache->key(headers));
+  headers.setPath("/foo");
+  EXPECT_NE(empty_header_key, cache->key(headers));
+}
+
+// Each shard keeps the most recently used decisions.
+TEST(RouteCacheTest, Lru) {
+  RouteCache cache(2, {});
+  auto route1 = std::make_shared<MockRoute>();
+  auto route2 = std::make_shared<MockRoute>();
+
+  cache.insert("1", route1);
+  cache.insert("2", route2);
+  cache.insert("3", nullptr);
+  EXPECT_EQ(absl::nullopt, cache.lookup("1"));
+  EXPECT_EQ(route2, cache.lookup("2"));
+  EXPECT_EQ(nullptr, cache.lookup("3"));
+
+  // The lookup of "2" made "3" the least recently used decision.
+  cache.lookup("2");
+  cache.insert("1", route1);
+  EXPECT_EQ(absl::nullopt, cache.lookup("3"));
+  EXPECT_EQ(route1, cache.lookup("1"));
+  EXPECT_EQ(route2, cache.lookup("2"));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -4507,6 +4507,61 @@ TEST_F(RouterTest, Shadow) {
   EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
 }
 
+// With the streaming shadows, the request is sent to the shadow while it is decoded, without
+// buffering it.
+TEST_F(RouterTest, StreamingShadow) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.streaming_shadow", "true"}});
+
+  ShadowPolicyPtr policy = std::make_unique<TestShadowPolicy>("foo", "bar");
+  callbacks_.route_->route_entry_.shadow_policies_.push_back(std::move(policy));
+  ON_CALL(callbacks_, streamId()).WillByDefault(Return(43));
+
+  NiceMock<Http::MockRequestEncoder> encoder;
+  Http::ResponseDecoder* response_decoder = nullptr;
+  EXPECT_CALL(cm_.thread_local_cluster_.conn_pool_, newStream(_, _))
+      .WillOnce(Invoke(
+          [&](Http::ResponseDecoder& decoder,
+              Http::ConnectionPool::Callbacks& callbacks) -> Http::ConnectionPool::Cancellable* {
+            response_decoder = &decoder;
+            callbacks.onPoolReady(encoder, cm_.thread_local_cluster_.conn_pool_.host_,
+                                  upstream_stream_info_, Http::Protocol::Http10);
+            return nullptr;
+          }));
+  expectResponseTimerCreate();
+
+  EXPECT_CALL(runtime_.snapshot_, featureEnabled("bar", 0, 43, 10000)).WillOnce(Return(true));
+  auto* shadow_stream = new Router::MockShadowStream();
+  EXPECT_CALL(*shadow_writer_, streamingShadow_("foo", _, _, false))
+      .WillOnce(Invoke([&](const std::string&, Http::RequestHeaderMapPtr& headers,
+                           const Http::AsyncClient::RequestOptions& options,
+                           bool) -> ShadowStream* {
+        EXPECT_EQ("host", headers->getHostValue());
+        EXPECT_EQ(absl::optional<std::chrono::milliseconds>(10), options.timeout);
+        return shadow_stream;
+      }));
+
+  Http::TestRequestHeaderMapImpl headers;
+  HttpTestUtility::addDefaultHeaders(headers);
+  router_.decodeHeaders(headers, false);
+
+  Buffer::OwnedImpl body_data("hello");
+  EXPECT_CALL(*shadow_stream, sendData(BufferStringEqual("hello"), false));
+  EXPECT_CALL(callbacks_, addDecodedData(_, _)).Times(0);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, router_.decodeData(body_data, false));
+
+  Http::TestRequestTrailerMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(*shadow_stream, sendTrailers(HeaderMapEqualRef(&trailers)));
+  EXPECT_CALL(*shadow_writer_, shadow_(_, _, _)).Times(0);
+  router_.decodeTrailers(trailers);
+
+  Http::ResponseHeaderMapPtr response_headers(
+      new Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  response_decoder->decodeHeaders(std::move(response_headers), true);
+  EXPECT_TRUE(verifyHostUpstreamStats(1, 0));
+}
+
 TEST_F(RouterTest, AltStatName) {
   // Also test no upstream timeout here.
   EXPECT_CALL(callbacks_.route_->route_entry_, timeout())
@@ -1,11 +1,16 @@
 #include <chrono>
 #include <string>
 
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
 #include "common/http/headers.h"
 #include "common/http/message_impl.h"
 #include "common/router/shadow_writer_impl.h"
 
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -42,8 +47,32 @@ public:
     writer_.shadow("foo", std::move(message), options);
   }
 
+  ShadowStreamPtr expectStreamingShadow(bool end_stream) {
+    Http::RequestHeaderMapPtr headers = Http::RequestHeaderMapImpl::create();
+    headers->setHost("cluster1");
+    cm_.initializeThreadLocalClusters({"foo"});
+    EXPECT_CALL(cm_, getThreadLocalCluster(Eq("foo")));
+    EXPECT_CALL(cm_.thread_local_cluster_, httpAsyncClient())
+        .WillOnce(ReturnRef(cm_.thread_local_cluster_.async_client_));
+    EXPECT_CALL(cm_.thread_local_cluster_.async_client_, start(_, _))
+        .WillOnce(Invoke(
+            [&](Http::AsyncClient::StreamCallbacks& callbacks,
+                const Http::AsyncClient::StreamOptions&) -> Http::AsyncClient::Stream* {
+              stream_callbacks_ = &callbacks;
+              return &stream_;
+            }));
+    EXPECT_CALL(stream_, sendHeaders(_, end_stream))
+        .WillOnce(Invoke([](Http::RequestHeaderMap& headers, bool) -> void {
+          EXPECT_EQ("cluster1-shadow", headers.getHostValue());
+        }));
+    return writer_.streamingShadow("foo", std::move(headers), Http::AsyncClient::RequestOptions(),
+                                   end_stream);
+  }
+
   Upstream::MockClusterManager cm_;
   ShadowWriterImpl writer_{cm_};
+  Http::MockAsyncClientStream stream_;
+  Http::AsyncClient::StreamCallbacks* stream_callbacks_{};
   Http::MockAsyncClientRequest request_{&cm_.thread_local_cluster_.async_client_};
   Http::AsyncClient::Callbacks* callback_{};
 };
@@ -73,6 +102,61 @@ TEST_F(ShadowWriterImplTest, NoCluster) {
   writer_.shadow("foo", std::move(message), options);
 }
 
+// The streamed shadow goes on once the request is complete, until its response.
+TEST_F(ShadowWriterImplTest, StreamingShadow) {
+  InSequence s;
+
+  ShadowStreamPtr shadow_stream = expectStreamingShadow(false);
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
+  EXPECT_CALL(stream_, sendData(BufferStringEqual("hello"), false))
+      .WillOnce(Invoke([](Buffer::Instance& data, bool) -> void { data.drain(data.length()); }));
+  shadow_stream->sendData(data, false);
+  EXPECT_EQ("hello", data.toString());
+
+  Http::TestRequestTrailerMapImpl trailers{{"some", "trailer"}};
+  EXPECT_CALL(stream_, sendTrailers(HeaderMapEqualRef(&trailers)));
+  shadow_stream->sendTrailers(trailers);
+
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow_stream.reset();
+  stream_callbacks_->onComplete();
+}
+
+// The shadow of a request that doesn't end is reset.
+TEST_F(ShadowWriterImplTest, StreamingShadowIncomplete) {
+  InSequence s;
+
+  ShadowStreamPtr shadow_stream = expectStreamingShadow(false);
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([this]() { stream_callbacks_->onReset(); }));
+  shadow_stream.reset();
+}
+
+// The shadow is dropped rather than buffering the request above its high watermark.
+TEST_F(ShadowWriterImplTest, StreamingShadowAboveHighWatermark) {
+  InSequence s;
+
+  ShadowStreamPtr shadow_stream = expectStreamingShadow(false);
+  Buffer::OwnedImpl data("hello");
+  EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(true));
+  EXPECT_CALL(stream_, reset()).WillOnce(Invoke([this]() { stream_callbacks_->onReset(); }));
+  shadow_stream->sendData(data, false);
+
+  EXPECT_CALL(stream_, sendData(_, _)).Times(0);
+  shadow_stream->sendData(data, true);
+  shadow_stream.reset();
+}
+
+// The shadow may be reset by its upstream while the request is decoded.
+TEST_F(ShadowWriterImplTest, StreamingShadowUpstreamReset) {
+  InSequence s;
+
+  ShadowStreamPtr shadow_stream = expectStreamingShadow(false);
+  stream_callbacks_->onReset();
+  EXPECT_CALL(stream_, reset()).Times(0);
+  shadow_stream.reset();
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
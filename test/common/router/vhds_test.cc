@@ -16,6 +16,7 @@
 #include "test/mocks/config/mocks.h"
 #include "test/mocks/init/mocks.h"
 #include "test/mocks/server/instance.h"
+#include "test/mocks/stream_info/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/simulated_time_system.h"
@@ -211,6 +212,56 @@ vhds:
               "vhost_vhds1" == actual_vhost_2.name());
 }
 
+// verify that a VHDS update only builds the virtual hosts it changes
+TEST_F(VhdsTest, VhdsReusesUnchangedVirtualHosts) {
+  const auto route_config =
+      TestUtility::parseYaml<envoy::config::route::v3::RouteConfiguration>(default_vhds_config_);
+  RouteConfigUpdatePtr config_update_info = makeRouteConfigUpdate(route_config);
+
+  VhdsSubscription subscription(config_update_info, factory_context_, context_, provider_);
+  const Protobuf::RepeatedPtrField<std::string> removed_resources;
+  const auto decoded_resources =
+      TestUtility::decodeResources<envoy::config::route::v3::VirtualHost>(
+          buildAddedResources({buildVirtualHost("vhost1", "vhost.first"),
+                               buildVirtualHost("vhost2", "vhost.second")}));
+  factory_context_.cluster_manager_.subscription_factory_.callbacks_->onConfigUpdate(
+      decoded_resources.refvec_, removed_resources, "1");
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  auto route = [&](const std::string& host) -> RouteConstSharedPtr {
+    Http::TestRequestHeaderMapImpl headers{
+        {":authority", host}, {":path", "/"}, {":method", "GET"}, {"x-forwarded-proto", "http"}};
+    RouteConstSharedPtr result =
+        config_update_info->parsedConfiguration()->route(headers, stream_info, 0);
+    EXPECT_NE(nullptr, result);
+    return result;
+  };
+  // The first config is kept so that its virtual hosts can be compared with the next ones.
+  const ConfigConstSharedPtr first_config = config_update_info->parsedConfiguration();
+  const VirtualHost* first = &route("vhost.first")->routeEntry()->virtualHost();
+  const VirtualHost* second = &route("vhost.second")->routeEntry()->virtualHost();
+
+  auto updated_vhost = buildVirtualHost("vhost2", "vhost.second");
+  updated_vhost.mutable_routes(0)->mutable_route()->set_cluster("my_other_service");
+  const auto updated_resources =
+      TestUtility::decodeResources<envoy::config::route::v3::VirtualHost>(
+          buildAddedResources({updated_vhost}));
+  factory_context_.cluster_manager_.subscription_factory_.callbacks_->onConfigUpdate(
+      updated_resources.refvec_, removed_resources, "2");
+
+  EXPECT_NE(first_config, config_update_info->parsedConfiguration());
+  EXPECT_EQ(first, &route("vhost.first")->routeEntry()->virtualHost());
+  EXPECT_NE(second, &route("vhost.second")->routeEntry()->virtualHost());
+  EXPECT_EQ("my_other_service", route("vhost.second")->routeEntry()->clusterName());
+
+  // A change of the fields shared by the virtual hosts builds all of them again.
+  auto updated_route_config = route_config;
+  updated_route_config.add_internal_only_headers("x-internal");
+  config_update_info->onRdsUpdate(updated_route_config, "3");
+  EXPECT_NE(first, &route("vhost.first")->routeEntry()->virtualHost());
+  EXPECT_EQ(1UL, config_update_info->parsedConfiguration()->internalOnlyHeaders().size());
+}
+
 } // namespace
 } // namespace Router
 } // namespace Envoy
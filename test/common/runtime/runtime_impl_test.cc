@@ -541,6 +541,25 @@ TEST_F(StaticLoaderImplTest, All) {
   testNewOverrides(*loader_, store_);
 }
 
+// The features resolved by index follow the overrides of the snapshots.
+TEST_F(StaticLoaderImplTest, RuntimeFeatureIndex) {
+  setup();
+  const RuntimeFeature feature_true("envoy.reloadable_features.test_feature_true");
+  const RuntimeFeature feature_false("envoy.reloadable_features.test_feature_false");
+  EXPECT_TRUE(loader_->snapshot().runtimeFeatureEnabled(feature_true.index()));
+  EXPECT_FALSE(loader_->snapshot().runtimeFeatureEnabled(feature_false.index()));
+
+  loader_->mergeValues({{"envoy.reloadable_features.test_feature_true", "false"},
+                        {"envoy.reloadable_features.test_feature_false", "true"}});
+  EXPECT_FALSE(loader_->snapshot().runtimeFeatureEnabled(feature_true.index()));
+  EXPECT_TRUE(loader_->snapshot().runtimeFeatureEnabled(feature_false.index()));
+
+  loader_->mergeValues({{"envoy.reloadable_features.test_feature_true", ""},
+                        {"envoy.reloadable_features.test_feature_false", ""}});
+  EXPECT_TRUE(loader_->snapshot().runtimeFeatureEnabled(feature_true.index()));
+  EXPECT_FALSE(loader_->snapshot().runtimeFeatureEnabled(feature_false.index()));
+}
+
 // Validate proto parsing sanity.
 TEST_F(StaticLoaderImplTest, ProtoParsing) {
   base_ = TestUtility::parseYaml<ProtobufWkt::Struct>(R"EOF(
@@ -802,6 +821,10 @@ TEST(NoRuntime, FeatureEnabled) {
   // Feature defaults should still work.
   EXPECT_EQ(false, runtimeFeatureEnabled("envoy.reloadable_features.test_feature_false"));
   EXPECT_EQ(true, runtimeFeatureEnabled("envoy.reloadable_features.test_feature_true"));
+  EXPECT_EQ(false, runtimeFeatureEnabled(
+                       RuntimeFeature("envoy.reloadable_features.test_feature_false")));
+  EXPECT_EQ(true,
+            runtimeFeatureEnabled(RuntimeFeature("envoy.reloadable_features.test_feature_true")));
 }
 
 TEST(NoRuntime, DefaultIntValues) {
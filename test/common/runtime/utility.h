@@ -10,6 +10,8 @@ class RuntimeFeaturesPeer {
 public:
   static bool enableFeature(const std::string& feature) {
     // Remove from disabled features and add to enabled features.
+    const_cast<Runtime::RuntimeFeatures*>(&Runtime::RuntimeFeaturesDefaults::get())
+        ->addIndex(feature);
     const_cast<Runtime::RuntimeFeatures*>(&Runtime::RuntimeFeaturesDefaults::get())
         ->disabled_features_.erase(feature);
     return const_cast<Runtime::RuntimeFeatures*>(&Runtime::RuntimeFeaturesDefaults::get())
@@ -18,6 +20,8 @@ public:
   }
   static bool disableFeature(const std::string& feature) {
     // Remove from enabled features and add to disabled features.
+    const_cast<Runtime::RuntimeFeatures*>(&Runtime::RuntimeFeaturesDefaults::get())
+        ->addIndex(feature);
     const_cast<Runtime::RuntimeFeatures*>(&Runtime::RuntimeFeaturesDefaults::get())
         ->enabled_features_.erase(feature);
     return const_cast<Runtime::RuntimeFeatures*>(&Runtime::RuntimeFeaturesDefaults::get())
@@ -72,6 +72,74 @@ TEST_F(AllocatorImplTest, GaugesWithSameName) {
   EXPECT_EQ(0, g2->value());
 }
 
+// Gauges and text readouts track whether they were written since they were last latched.
+TEST_F(AllocatorImplTest, LatchChanged) {
+  GaugeSharedPtr gauge =
+      alloc_.makeGauge(makeStat("gauge.name"), StatName(), {}, Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->set(0);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+  gauge->add(2);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->sub(1);
+  EXPECT_TRUE(gauge->latchChanged());
+  gauge->setParentValue(3);
+  EXPECT_TRUE(gauge->latchChanged());
+  EXPECT_FALSE(gauge->latchChanged());
+  // The other flags are kept.
+  EXPECT_TRUE(gauge->used());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, gauge->importMode());
+
+  TextReadoutSharedPtr text_readout =
+      alloc_.makeTextReadout(makeStat("text.name"), StatName(), {});
+  EXPECT_FALSE(text_readout->latchChanged());
+  text_readout->set("value");
+  EXPECT_TRUE(text_readout->latchChanged());
+  EXPECT_FALSE(text_readout->latchChanged());
+}
+
+TEST_F(AllocatorImplTest, ShardedCounter) {
+  StatName counter_name = makeStat("counter.name");
+  CounterSharedPtr c1 = alloc_.makeShardedCounter(counter_name, StatName(), {});
+  EXPECT_EQ(c1.get(), alloc_.makeShardedCounter(counter_name, StatName(), {}).get());
+  EXPECT_EQ(c1.get(), alloc_.makeCounter(counter_name, StatName(), {}).get());
+  EXPECT_FALSE(c1->used());
+
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  // More threads than shards, so that some of them share a shard.
+  const uint32_t num_threads = 20;
+  const uint32_t iters = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  absl::Notification go;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([&]() {
+      go.WaitForNotification();
+      for (uint32_t i = 0; i < iters; ++i) {
+        c1->inc();
+      }
+      c1->add(10);
+    }));
+  }
+  go.Notify();
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads[i]->join();
+  }
+
+  const uint64_t total = num_threads * (iters + 10);
+  EXPECT_TRUE(c1->used());
+  EXPECT_EQ(total, c1->value());
+  EXPECT_EQ(total, c1->latch());
+  EXPECT_EQ(0, c1->latch());
+  c1->add(5);
+  EXPECT_EQ(5, c1->latch());
+  c1->reset();
+  EXPECT_EQ(0, c1->value());
+  c1->inc();
+  EXPECT_EQ(1, c1->value());
+  EXPECT_EQ(1, c1->latch());
+}
+
 // Test for a race-condition where we may decrement the ref-count of a stat to
 // zero at the same time as we are allocating another instance of that
 // stat. This test reproduces that race organically by having a 12 threads each
@@ -0,0 +1,114 @@
+#include "envoy/stats/stats_macros.h"
+
+#include "common/stats/deferred_scope.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+class DeferredScopeTest : public testing::Test {
+protected:
+  DeferredScopeTest()
+      : store_(std::make_unique<IsolatedStoreImpl>(symbol_table_)), pool_(symbol_table_),
+        scope_(std::make_unique<DeferredScope>(*store_)) {}
+  ~DeferredScopeTest() override {
+    scope_.reset();
+    pool_.clear();
+    store_.reset();
+    EXPECT_EQ(0, symbol_table_.numSymbols());
+  }
+
+  StatName makeStatName(absl::string_view name) { return pool_.add(name); }
+
+  SymbolTableImpl symbol_table_;
+  std::unique_ptr<IsolatedStoreImpl> store_;
+  StatNamePool pool_;
+  std::unique_ptr<DeferredScope> scope_;
+};
+
+TEST_F(DeferredScopeTest, Counter) {
+  const StatName name = makeStatName("c1");
+  Counter& c1 = scope_->counterFromStatName(name);
+  c1.add(0);
+  c1.reset();
+  EXPECT_EQ(0, c1.value());
+  EXPECT_EQ(0, c1.latch());
+  EXPECT_FALSE(c1.used());
+  EXPECT_FALSE(store_->findCounter(name).has_value());
+
+  c1.add(2);
+  ASSERT_TRUE(store_->findCounter(name).has_value());
+  EXPECT_EQ(2, store_->findCounter(name)->get().value());
+  c1.inc();
+  EXPECT_EQ(3, c1.value());
+  EXPECT_TRUE(c1.used());
+  EXPECT_EQ(3, c1.latch());
+  EXPECT_EQ("c1", c1.name());
+}
+
+TEST_F(DeferredScopeTest, Gauge) {
+  const StatName name = makeStatName("g1");
+  Gauge& g1 = scope_->gaugeFromStatName(name, Gauge::ImportMode::Accumulate);
+  g1.set(0);
+  g1.add(0);
+  g1.sub(0);
+  EXPECT_EQ(0, g1.value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, g1.importMode());
+  EXPECT_FALSE(store_->findGauge(name).has_value());
+
+  g1.set(5);
+  ASSERT_TRUE(store_->findGauge(name).has_value());
+  EXPECT_EQ(Gauge::ImportMode::Accumulate, store_->findGauge(name)->get().importMode());
+  g1.dec();
+  EXPECT_EQ(4, g1.value());
+  // Setting zero is kept once the gauge exists.
+  g1.set(0);
+  EXPECT_EQ(0, store_->findGauge(name)->get().value());
+}
+
+TEST_F(DeferredScopeTest, Histogram) {
+  const StatName name = makeStatName("h1");
+  Histogram& h1 = scope_->histogramFromStatName(name, Histogram::Unit::Milliseconds);
+  EXPECT_EQ(Histogram::Unit::Milliseconds, h1.unit());
+  EXPECT_FALSE(store_->findHistogram(name).has_value());
+  h1.recordValue(0);
+  EXPECT_TRUE(store_->findHistogram(name).has_value());
+}
+
+TEST_F(DeferredScopeTest, TextReadout) {
+  const StatName name = makeStatName("t1");
+  TextReadout& t1 = scope_->textReadoutFromStatName(name);
+  t1.set("");
+  EXPECT_EQ("", t1.value());
+  EXPECT_FALSE(store_->findTextReadout(name).has_value());
+  t1.set("hello");
+  EXPECT_EQ("hello", t1.value());
+  EXPECT_TRUE(store_->findTextReadout(name).has_value());
+}
+
+#define TEST_STATS(COUNTER, GAUGE, HISTOGRAM, TEXT_READOUT, STATNAME)                              \
+  COUNTER(requests)                                                                                \
+  COUNTER(errors)                                                                                  \
+  GAUGE(active, Accumulate)
+
+MAKE_STAT_NAMES_STRUCT(TestStatNames, TEST_STATS);
+MAKE_STATS_STRUCT(TestStats, TestStatNames, TEST_STATS);
+
+TEST_F(DeferredScopeTest, StatsStruct) {
+  TestStatNames stat_names(symbol_table_);
+  TestStats stats(stat_names, *scope_, makeStatName("prefix"));
+  stats.requests_.inc();
+  stats.active_.inc();
+  // Only the stats that were written exist in the store.
+  EXPECT_EQ(1, store_->counters().size());
+  EXPECT_EQ(1, store_->gauges().size());
+  EXPECT_EQ(1, store_->counterFromString("prefix.requests").value());
+  EXPECT_EQ(0, stats.errors_.value());
+}
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
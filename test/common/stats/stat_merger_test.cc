@@ -103,6 +103,35 @@ TEST_F(StatMergerTest, BasicDefaultAccumulationImport) {
   EXPECT_EQ(789, whywassixafraidofseven_.value());
 }
 
+TEST_F(StatMergerTest, MergeById) {
+  Protobuf::Map<uint32_t, std::string> stat_names;
+  stat_names[0] = "draculaer";
+  stat_names[1] = "whywassixafraidofseven";
+  stat_merger_.addStatNames(stat_names);
+
+  Protobuf::Map<uint32_t, uint64_t> counter_deltas;
+  Protobuf::Map<uint32_t, uint64_t> gauges;
+  counter_deltas[0] = 3;
+  gauges[1] = 111;
+  // Unknown ids are ignored.
+  counter_deltas[2] = 1;
+  stat_merger_.mergeStatsById(counter_deltas, gauges);
+  EXPECT_EQ(3, store_.counterFromString("draculaer").value());
+  EXPECT_EQ(789, whywassixafraidofseven_.value());
+
+  // A gauge the parent doesn't send again keeps its parent value.
+  counter_deltas.clear();
+  gauges.clear();
+  counter_deltas[0] = 2;
+  stat_merger_.mergeStatsById(counter_deltas, gauges);
+  EXPECT_EQ(5, store_.counterFromString("draculaer").value());
+  EXPECT_EQ(789, whywassixafraidofseven_.value());
+
+  gauges[1] = 11;
+  stat_merger_.mergeStatsById(counter_deltas, gauges);
+  EXPECT_EQ(689, whywassixafraidofseven_.value());
+}
+
 TEST_F(StatMergerTest, MultipleImportsWithAccumulationLogic) {
   {
     Protobuf::Map<std::string, uint64_t> gauges;
@@ -682,6 +682,59 @@ TEST_F(StatNameTest, RecentLookups) {
   EXPECT_EQ(0, num_calls);
 }
 
+// Lookups that hit the thread cache, and so don't take the lock, still count towards the total.
+TEST_F(StatNameTest, RecentLookupsTotalIncludesCachedLookups) {
+  encodeDecode("cached.stat");
+  encodeDecode("cached.stat");
+  EXPECT_EQ(2, table_.getRecentLookups([](absl::string_view, uint64_t) {}));
+  table_.clearRecentLookups();
+  EXPECT_EQ(0, table_.getRecentLookups([](absl::string_view, uint64_t) {}));
+}
+
+// Test that a token is encoded correctly after its symbol was freed, and the entry the thread
+// cache still refers to was reused for another token.
+TEST_F(StatNameTest, EncodeAfterSymbolReuse) {
+  {
+    StatNameManagedStorage a("a", table_);
+  }
+  EXPECT_EQ(0, table_.numSymbols());
+  StatNameManagedStorage b("b", table_);
+  StatNameManagedStorage a("a", table_);
+  EXPECT_EQ("b", table_.toString(b.statName()));
+  EXPECT_EQ("a", table_.toString(a.statName()));
+  EXPECT_EQ(2, table_.numSymbols());
+
+  // This one is referenced from the thread cache.
+  StatNameManagedStorage a2("a", table_);
+  EXPECT_EQ(getSymbols(a.statName()), getSymbols(a2.statName()));
+  EXPECT_EQ(2, table_.numSymbols());
+}
+
+// Validates that we don't get tsan or other errors when threads concurrently
+// encode and free the same tokens, so that thread caches refer to symbols that
+// are being erased and reused.
+TEST_F(StatNameTest, RacingEncodeAndFree) {
+  Thread::ThreadFactory& thread_factory = Thread::threadFactoryForTest();
+  constexpr int num_threads = 16;
+  std::vector<Thread::ThreadPtr> threads;
+  threads.reserve(num_threads);
+  ConditionalInitializer start;
+  for (int i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory.createThread([this, i, &start]() {
+      start.wait();
+      for (int count = 0; count < 1000; ++count) {
+        const std::string name = absl::StrCat("shared.symbol", (i + count) % 5, ".stat");
+        StatNameManagedStorage storage(name, table_);
+        EXPECT_EQ(name, table_.toString(storage.statName()));
+      }
+    }));
+  }
+  start.setReady();
+  for (auto& thread : threads) {
+    thread->join();
+  }
+}
+
 TEST_F(StatNameTest, StatNameEmptyEquivalent) {
   StatName empty1;
   StatName empty2 = makeStat("");
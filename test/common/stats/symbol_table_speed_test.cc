@@ -61,6 +61,31 @@ static void bmCreateRace(benchmark::State& state) {
 }
 BENCHMARK(bmCreateRace)->Unit(::benchmark::kMillisecond);
 
+// Measures encoding names whose tokens already have symbols, from several threads at once.
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void bmEncodeExisting(benchmark::State& state) {
+  // Shared by all the benchmark threads, and leaked as they may still use it on exit.
+  static auto* table = new Envoy::Stats::SymbolTableImpl;
+  static auto* initial = new Envoy::Stats::StatNameStorage("here.is.a.stat.name", *table);
+  UNREFERENCED_PARAMETER(initial);
+
+  std::vector<Envoy::Stats::SymbolTable::StoragePtr> storages;
+  storages.reserve(1000);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (int i = 0; i < 1000; ++i) {
+      storages.push_back(table->encode("here.is.a.stat.name"));
+    }
+    state.PauseTiming();
+    for (const Envoy::Stats::SymbolTable::StoragePtr& storage : storages) {
+      table->free(Envoy::Stats::StatName(storage.get()));
+    }
+    storages.clear();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(bmEncodeExisting)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 static void bmJoinStatNames(benchmark::State& state) {
   Envoy::Stats::SymbolTableImpl symbol_table;
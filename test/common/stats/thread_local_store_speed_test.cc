@@ -103,5 +103,51 @@ static void BM_StatsWithTls(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTls);
 
+// Tests the cost of incrementing one counter from several threads at once. The argument selects a
+// plain counter (0), which all threads update in place, or a sharded counter (1).
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_CounterIncMultiThread(benchmark::State& state) {
+  // Shared by all the benchmark threads, and leaked so that their destruction doesn't race with
+  // threads still finishing up.
+  static auto* symbol_table = new Envoy::Stats::SymbolTableImpl;
+  static auto* alloc = new Envoy::Stats::AllocatorImpl(*symbol_table);
+  static auto* pool = new Envoy::Stats::StatNamePool(*symbol_table);
+  static auto* counters = new std::vector<Envoy::Stats::CounterSharedPtr>{
+      alloc->makeCounter(pool->add("plain"), Envoy::Stats::StatName(), {}),
+      alloc->makeShardedCounter(pool->add("sharded"), Envoy::Stats::StatName(), {})};
+
+  Envoy::Stats::Counter& counter = *(*counters)[state.range(0)];
+  for (auto _ : state) {
+    counter.inc();
+  }
+}
+BENCHMARK(BM_CounterIncMultiThread)->Arg(0)->Arg(1)->Threads(1)->Threads(4)->Threads(16);
+
+// Tests the cost of recording values in a thread local histogram, and of merging them once per
+// 64K values. The argument selects a plain histogram (0) or a bucketed histogram (1).
+// NOLINTNEXTLINE(readability-identifier-naming)
+static void BM_HistogramRecordValue(benchmark::State& state) {
+  Envoy::Stats::SymbolTableImpl symbol_table;
+  Envoy::Stats::StatNamePool pool(symbol_table);
+  Envoy::Stats::ThreadLocalHistogramImpl histogram(
+      pool.add("histogram"), Envoy::Stats::Histogram::Unit::Milliseconds,
+      Envoy::Stats::StatName(), {}, symbol_table, state.range(0) == 1);
+  histogram_t* target = hist_alloc();
+
+  uint64_t value = 0;
+  uint64_t recorded = 0;
+  for (auto _ : state) {
+    // Spread the values over a few orders of magnitude, like request latencies.
+    value = (value * 7919 + 13) % 100000;
+    histogram.recordValue(value);
+    if (++recorded % 65536 == 0) {
+      histogram.beginMerge();
+      histogram.merge(target);
+    }
+  }
+  hist_free(target);
+}
+BENCHMARK(BM_HistogramRecordValue)->Arg(0)->Arg(1);
+
 // TODO(jmarantz): add multi-threaded variant of this test, that aggressively
 // looks up stats in multiple threads to try to trigger contention issues.
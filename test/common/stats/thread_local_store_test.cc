@@ -6,6 +6,7 @@
 #include "envoy/stats/histogram.h"
 
 #include "common/common/c_smart_ptr.h"
+#include "common/common/matchers.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/memory/stats.h"
 #include "common/stats/stats_matcher_impl.h"
@@ -271,6 +272,30 @@ TEST_F(StatsThreadLocalStoreTest, NoTls) {
   store_->shutdownThreading();
 }
 
+TEST_F(StatsThreadLocalStoreTest, ShardedCounters) {
+  InSequence s;
+  envoy::type::matcher::v3::StringMatcher matcher;
+  matcher.set_suffix("rq_total");
+  std::vector<Matchers::StringMatcherPtr> matchers;
+  matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
+  store_->setShardedCounters(std::move(matchers));
+  store_->initializeThreading(main_thread_dispatcher_, tls_);
+
+  Counter& sharded = store_->counterFromString("cluster.foo.upstream_rq_total");
+  Counter& plain = store_->counterFromString("cluster.foo.upstream_cx_total");
+  EXPECT_EQ(&sharded, &store_->counterFromString("cluster.foo.upstream_rq_total"));
+  EXPECT_NE(typeid(sharded), typeid(plain));
+  sharded.add(3);
+  plain.add(3);
+  EXPECT_EQ(3, sharded.value());
+  EXPECT_EQ(3, sharded.latch());
+  EXPECT_EQ(3, plain.latch());
+  EXPECT_EQ(2UL, store_->counters().size());
+
+  store_->shutdownThreading();
+  tls_.shutdownThread();
+}
+
 TEST_F(StatsThreadLocalStoreTest, Tls) {
   InSequence s;
   store_->initializeThreading(main_thread_dispatcher_, tls_);
@@ -1276,6 +1301,32 @@ TEST_F(HistogramTest, BasicMultiHistogramMerge) {
   EXPECT_EQ(2, validateMerge());
 }
 
+TEST_F(HistogramTest, BucketedHistogramMerge) {
+  envoy::type::matcher::v3::StringMatcher matcher;
+  matcher.set_exact("h1");
+  std::vector<Matchers::StringMatcherPtr> matchers;
+  matchers.push_back(std::make_unique<Matchers::StringMatcherImpl>(matcher));
+  store_->setBucketedHistograms(std::move(matchers));
+  Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
+  Histogram& h2 = store_->histogramFromString("h2", Stats::Histogram::Unit::Unspecified);
+
+  // Covers the exact buckets below 100, the bounds of the bucketed orders of magnitude, and values
+  // that are too large to be bucketed.
+  for (uint64_t value : {0UL, 7UL, 43UL, 99UL, 100UL, 415UL, 999UL, 1000UL, 2201UL, 123456789UL,
+                         9999999999UL, 10000000000UL, 123456789012UL}) {
+    expectCallAndAccumulate(h1, value);
+    expectCallAndAccumulate(h2, value);
+  }
+  EXPECT_EQ(2, validateMerge());
+
+  // The buckets are cleared when merging.
+  expectCallAndAccumulate(h1, 415);
+  expectCallAndAccumulate(h1, 416);
+  expectCallAndAccumulate(h2, 3);
+  EXPECT_EQ(2, validateMerge());
+  EXPECT_EQ(2, validateMerge());
+}
+
 TEST_F(HistogramTest, MultiHistogramMultipleMerges) {
   Histogram& h1 = store_->histogramFromString("h1", Stats::Histogram::Unit::Unspecified);
   Histogram& h2 = store_->histogramFromString("h2", Stats::Histogram::Unit::Unspecified);
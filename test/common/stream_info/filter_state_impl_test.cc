@@ -4,6 +4,7 @@
 
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -385,5 +386,27 @@ TEST_F(FilterStateImplTest, SetSameDataWithDifferentLifeSpan) {
   EXPECT_EQ(2, filter_state().getDataMutable<SimpleType>("test_2").access());
 }
 
+// The objects are found before and after they're indexed by name.
+TEST_F(FilterStateImplTest, ManyObjects) {
+  for (int i = 0; i < 20; ++i) {
+    filter_state().setData(absl::StrCat("test_", i), std::make_unique<SimpleType>(i),
+                           FilterState::StateType::Mutable);
+    for (int j = 0; j <= i; ++j) {
+      EXPECT_EQ(j, filter_state().getDataReadOnly<SimpleType>(absl::StrCat("test_", j)).access());
+    }
+    EXPECT_FALSE(filter_state().hasDataWithName(absl::StrCat("test_", i + 1)));
+  }
+
+  filter_state().getDataMutable<SimpleType>("test_3").set(42);
+  EXPECT_EQ(42, filter_state().getDataReadOnly<SimpleType>("test_3").access());
+  filter_state().setData("test_15", std::make_unique<SimpleType>(99),
+                         FilterState::StateType::Mutable);
+  EXPECT_EQ(99, filter_state().getDataReadOnly<SimpleType>("test_15").access());
+  EXPECT_THROW_WITH_MESSAGE(filter_state().setData("test_0", std::make_unique<SimpleType>(0),
+                                                   FilterState::StateType::ReadOnly),
+                            EnvoyException,
+                            "FilterState::setData<T> called twice with different state types.");
+}
+
 } // namespace StreamInfo
 } // namespace Envoy
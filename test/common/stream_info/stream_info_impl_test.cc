@@ -180,10 +180,21 @@ TEST_F(StreamInfoImplTest, MiscSettersAndGetters) {
     EXPECT_EQ(1,
               stream_info.upstreamFilterState()->getDataReadOnly<TestIntAccessor>("test").access());
 
+    EXPECT_EQ("", stream_info.requestedServerName());
+    stream_info.setRequestedServerName("");
     EXPECT_EQ("", stream_info.requestedServerName());
     absl::string_view sni_name = "stubserver.org";
     stream_info.setRequestedServerName(sni_name);
     EXPECT_EQ(std::string(sni_name), stream_info.requestedServerName());
+    stream_info.setRequestedServerName("");
+    EXPECT_EQ("", stream_info.requestedServerName());
+
+    EXPECT_EQ("", stream_info.filterChainName());
+    stream_info.setFilterChainName("foo");
+    EXPECT_EQ("foo", stream_info.filterChainName());
+    EXPECT_EQ("", stream_info.upstreamTransportFailureReason());
+    stream_info.setUpstreamTransportFailureReason("TLS error");
+    EXPECT_EQ("TLS error", stream_info.upstreamTransportFailureReason());
 
     EXPECT_EQ(absl::nullopt, stream_info.upstreamClusterInfo());
     Upstream::ClusterInfoConstSharedPtr cluster_info(new NiceMock<Upstream::MockClusterInfo>());
@@ -229,6 +240,22 @@ TEST_F(StreamInfoImplTest, DynamicMetadataTest) {
   EXPECT_TRUE(json.find("\"another_key\":\"another_value\"") != std::string::npos);
 }
 
+// The moved structs are merged like the copied ones.
+TEST_F(StreamInfoImplTest, MovedDynamicMetadataTest) {
+  StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), nullptr);
+
+  ProtobufWkt::Struct struct_obj = MessageUtil::keyValueStruct({{"a", "1"}, {"b", "2"}});
+  stream_info.setDynamicMetadata("com.test", std::move(struct_obj));
+  struct_obj = MessageUtil::keyValueStruct({{"b", "3"}, {"c", "4"}});
+  stream_info.setDynamicMetadata("com.test", std::move(struct_obj));
+
+  const auto& fields = stream_info.dynamicMetadata().filter_metadata().at("com.test").fields();
+  EXPECT_EQ(3, fields.size());
+  EXPECT_EQ("1", fields.at("a").string_value());
+  EXPECT_EQ("3", fields.at("b").string_value());
+  EXPECT_EQ("4", fields.at("c").string_value());
+}
+
 TEST_F(StreamInfoImplTest, DumpStateTest) {
   StreamInfoImpl stream_info(Http::Protocol::Http2, test_time_.timeSystem(), nullptr);
   std::string prefix = "";
@@ -51,6 +51,21 @@ max_downstream_connection_duration: 10s
   EXPECT_EQ(std::chrono::seconds(10), config_obj.maxDownstreamConnectionDuration().value());
 }
 
+TEST(ConfigTest, ReuseUpstreamConnectionsWithTunneling) {
+  const std::string yaml = R"EOF(
+stat_prefix: name
+cluster: foo
+reuse_upstream_connections: true
+tunneling_config:
+  hostname: example.com:80
+)EOF";
+
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  EXPECT_THROW_WITH_MESSAGE(
+      constructConfigFromV3Yaml(yaml, factory_context), EnvoyException,
+      "tcp_proxy: reuse_upstream_connections can't be used with tunneling_config");
+}
+
 TEST(ConfigTest, NoRouteConfig) {
   const std::string yaml = R"EOF(
   stat_prefix: name
@@ -173,6 +173,49 @@ TEST_F(TcpProxyTest, HalfCloseProxy) {
   upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+// With upstream connection reuse, the end of the downstream connection ends the session, and the
+// upstream connection is released to the pool instead of being half closed.
+TEST_F(TcpProxyTest, ReuseUpstreamConnections) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_reuse_upstream_connections(true);
+  setup(1, config);
+  raiseEventUpstreamConnected(0);
+
+  Buffer::OwnedImpl response("world");
+  EXPECT_CALL(filter_callbacks_.connection_, write(BufferEqual(&response), false));
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  bool released = false;
+  upstream_connection_data_.at(0)->release_callback_ = [&released]() { released = true; };
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  EXPECT_CALL(*upstream_connections_.at(0), close(_)).Times(0);
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  filter_->onData(buffer, true);
+  EXPECT_TRUE(released);
+}
+
+// The upstream connections that ended are closed at the end of the session.
+TEST_F(TcpProxyTest, ReuseUpstreamConnectionsAfterUpstreamEnd) {
+  envoy::extensions::filters::network::tcp_proxy::v3::TcpProxy config = defaultConfig();
+  config.set_reuse_upstream_connections(true);
+  setup(1, config);
+  raiseEventUpstreamConnected(0);
+
+  Buffer::OwnedImpl response("world");
+  EXPECT_CALL(filter_callbacks_.connection_, write(BufferEqual(&response), true));
+  upstream_callbacks_->onUpstreamData(response, true);
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite))
+      .WillOnce(Invoke([this](Network::ConnectionCloseType) {
+        filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::LocalClose);
+      }));
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  filter_->onData(buffer, true);
+}
+
 // Test with an explicitly configured upstream.
 TEST_F(TcpProxyTest, ExplicitFactory) {
   // Explicitly configure an HTTP upstream, to test factory creation.
@@ -752,20 +795,28 @@ TEST_F(TcpProxyTest, IdleTimeout) {
   EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
   raiseEventUpstreamConnected(0);
 
+  // The activity is recorded without re-arming the timer.
   Buffer::OwnedImpl buffer("hello");
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  simTime().advanceTimeWait(std::chrono::milliseconds(100));
   filter_->onData(buffer, false);
 
   buffer.add("hello2");
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  simTime().advanceTimeWait(std::chrono::milliseconds(100));
   upstream_callbacks_->onUpstreamData(buffer, false);
 
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  simTime().advanceTimeWait(std::chrono::milliseconds(100));
   filter_callbacks_.connection_.raiseBytesSentCallbacks(1);
 
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
+  simTime().advanceTimeWait(std::chrono::milliseconds(100));
   upstream_connections_.at(0)->raiseBytesSentCallbacks(2);
 
+  // When the timer fires, it's re-armed for the rest of the timeout since the last activity.
+  simTime().advanceTimeWait(std::chrono::milliseconds(600));
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(400), _));
+  idle_timer->invokeCallback();
+  EXPECT_EQ(0U, config_->stats().idle_timeout_.value());
+
+  simTime().advanceTimeWait(std::chrono::milliseconds(400));
   EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
   EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush));
   EXPECT_CALL(*idle_timer, disableTimer());
@@ -811,18 +862,14 @@ TEST_F(TcpProxyTest, IdleTimeoutWithOutstandingDataFlushed) {
   raiseEventUpstreamConnected(0);
 
   Buffer::OwnedImpl buffer("hello");
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
   filter_->onData(buffer, false);
 
   buffer.add("hello2");
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
   upstream_callbacks_->onUpstreamData(buffer, false);
 
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
   filter_callbacks_.connection_.raiseBytesSentCallbacks(1);
-
-  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
   upstream_connections_.at(0)->raiseBytesSentCallbacks(2);
+  simTime().advanceTimeWait(std::chrono::milliseconds(1000));
 
   // Mark the upstream connection as blocked.
   // This should read-disable the downstream connection.
@@ -987,6 +1034,9 @@ TEST_F(TcpProxyTest, UpstreamFlushTimeoutConfigured) {
       .WillOnce(Return()); // Cancel default action of raising LocalClose
   EXPECT_CALL(*upstream_connections_.at(0), state())
       .WillOnce(Return(Network::Connection::State::Closing));
+  // The timer is handed over to the drainer armed for the rest of the idle timeout.
+  simTime().advanceTimeWait(std::chrono::milliseconds(100));
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(900), _));
   filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
 
   filter_.reset();
@@ -1019,6 +1069,7 @@ TEST_F(TcpProxyTest, UpstreamFlushTimeoutExpired) {
       .WillOnce(Return()); // Cancel default action of raising LocalClose
   EXPECT_CALL(*upstream_connections_.at(0), state())
       .WillOnce(Return(Network::Connection::State::Closing));
+  EXPECT_CALL(*idle_timer, enableTimer(std::chrono::milliseconds(1000), _));
   filter_callbacks_.connection_.raiseEvent(Network::ConnectionEvent::RemoteClose);
 
   filter_.reset();
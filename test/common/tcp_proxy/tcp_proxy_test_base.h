@@ -35,6 +35,7 @@
 #include "test/mocks/stream_info/mocks.h"
 #include "test/mocks/tcp/mocks.h"
 #include "test/mocks/upstream/host.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -68,7 +69,7 @@ inline Config constructConfigFromV3Yaml(const std::string& yaml,
   return Config(tcp_proxy, context);
 }
 
-class TcpProxyTestBase : public testing::Test {
+class TcpProxyTestBase : public Event::TestUsingSimulatedTime, public testing::Test {
 public:
   TcpProxyTestBase() {
     ON_CALL(*factory_context_.access_log_manager_.file_, write(_))
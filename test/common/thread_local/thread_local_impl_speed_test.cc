@@ -0,0 +1,44 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "common/thread_local/thread_local_impl.h"
+
+#include "test/mocks/event/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace ThreadLocal {
+
+namespace {
+
+class CounterObject : public ThreadLocalObject {
+public:
+  uint64_t value_{1};
+};
+
+} // namespace
+
+// Reads the object stored in a slot through its typed accessors, as the filters do for each
+// request.
+static void typedSlotAccess(benchmark::State& state) {
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  InstanceImpl tls;
+  tls.registerThread(dispatcher, true);
+  uint64_t sum = 0;
+  {
+    TypedSlot<CounterObject> slot(tls);
+    slot.set([](Event::Dispatcher&) { return std::make_shared<CounterObject>(); });
+    for (auto _ : state) {
+      sum += slot->value_;
+      sum += slot.get()->value_;
+    }
+  }
+  benchmark::DoNotOptimize(sum);
+  tls.shutdownGlobalThreading();
+  tls.shutdownThread();
+}
+BENCHMARK(typedSlotAccess);
+
+} // namespace ThreadLocal
+} // namespace Envoy
@@ -227,6 +227,22 @@ TEST_F(ThreadLocalInstanceImplTest, TypedUpdateCallback) {
   tls_.shutdownThread();
 }
 
+// The typed accessors refer to the object stored in the slot, without copying it.
+TEST_F(ThreadLocalInstanceImplTest, TypedAccess) {
+  TypedSlot<StringSlotObject> slot(tls_);
+
+  auto object = std::make_shared<StringSlotObject>();
+  EXPECT_CALL(thread_dispatcher_, post(_));
+  slot.set([object](Event::Dispatcher&) -> std::shared_ptr<StringSlotObject> { return object; });
+
+  EXPECT_EQ(object.get(), slot.get().ptr());
+  EXPECT_EQ(object.get(), slot.operator->());
+  EXPECT_EQ(object.get(), &*slot);
+
+  tls_.shutdownGlobalThreading();
+  tls_.shutdownThread();
+}
+
 TEST_F(ThreadLocalInstanceImplTest, NoDataCallback) {
   InSequence s;
   TypedSlot<StringSlotObject> slot(tls_);
@@ -247,6 +247,34 @@ TEST_F(BoundedLoadHashingLoadBalancerTest, MultipleHashSameHostOverloaded) {
   EXPECT_EQ(host2->address()->asString(), "127.0.0.10:90");
 };
 
+// The hashes are spread over a fixed set of probe sequences, so hashes which are equal modulo the
+// number of sequences probe the hosts in the same order.
+TEST_F(BoundedLoadHashingLoadBalancerTest, HashesShareProbeSequences) {
+  // Host 2 is overloaded and is on the whole ring. The random shuffle sequence of 5 elements with
+  // seed 2 is 2 1 0 4 3, so host 1 is picked up for both hashes 2 and 66.
+  std::vector<std::string> addresses;
+  addresses.push_back("127.0.0.12:90");
+  host_overload_factor_predicate_ = getHostOverloadFactorPredicate(addresses);
+
+  NormalizedHostWeightVector normalized_host_weights;
+  createHosts(5, normalized_host_weights);
+
+  NormalizedHostWeightVector ring(
+      ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::MaxProbeSequences + 3,
+      normalized_host_weights[2]);
+  hlb_ = std::make_shared<TestHashingLoadBalancer>(ring);
+
+  lb_ = std::make_unique<TestBoundedLoadHashingLoadBalancer>(hlb_, normalized_host_weights, 1,
+                                                             host_overload_factor_predicate_);
+
+  HostConstSharedPtr host1 = lb_->chooseHost(2, 1);
+  ASSERT_NE(host1, nullptr);
+  EXPECT_EQ(host1->address()->asString(), "127.0.0.11:90");
+  HostConstSharedPtr host2 = lb_->chooseHost(
+      2 + ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::MaxProbeSequences, 1);
+  EXPECT_EQ(host1, host2);
+};
+
 // Works correctly for the case when all hosts are overloaded
 TEST_F(BoundedLoadHashingLoadBalancerTest, AllHostsOverloaded) {
   std::vector<std::string> addresses;
@@ -23,6 +23,7 @@
 
 using testing::_;
 using testing::InSequence;
+using testing::Invoke;
 using testing::Return;
 using testing::StrEq;
 using testing::Throw;
@@ -171,6 +172,35 @@ TEST_F(CdsApiImplTest, ConfigUpdateWith2ValidClusters) {
   cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "");
 }
 
+// Verifies that the clusters of an update are posted to the workers in a single batch.
+TEST_F(CdsApiImplTest, ConfigUpdateBatchesClusterUpdates) {
+  {
+    InSequence s;
+    setup();
+  }
+
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({})));
+  EXPECT_CALL(initialized_, ready());
+
+  bool batch_closed = false;
+  {
+    InSequence s;
+    EXPECT_CALL(cm_, batchClusterUpdates()).WillOnce(Invoke([&batch_closed]() {
+      return std::make_unique<Cleanup>([&batch_closed]() { batch_closed = true; });
+    }));
+    expectAdd("cluster_1");
+    expectAdd("cluster_2");
+  }
+
+  envoy::config::cluster::v3::Cluster cluster_1;
+  cluster_1.set_name("cluster_1");
+  envoy::config::cluster::v3::Cluster cluster_2;
+  cluster_2.set_name("cluster_2");
+  const auto decoded_resources = TestUtility::decodeResources({cluster_1, cluster_2});
+  cds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "");
+  EXPECT_TRUE(batch_closed);
+}
+
 TEST_F(CdsApiImplTest, DeltaConfigUpdate) {
   {
     InSequence s;
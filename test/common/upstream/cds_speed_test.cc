@@ -0,0 +1,115 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/endpoint/v3/endpoint_components.pb.h"
+
+#include "common/grpc/context_impl.h"
+#include "common/http/context_impl.h"
+#include "common/router/context_impl.h"
+#include "common/upstream/cds_api_helper.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/test_cluster_manager.h"
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/server/admin.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+
+namespace Envoy {
+namespace Upstream {
+
+// Measures how long a CDS update takes to add many clusters. The thread local updates run inline,
+// as if there was a single worker.
+class CdsSpeedTest {
+public:
+  CdsSpeedTest(State& state, bool deferred_load_balancers)
+      : state_(state), http_context_(factory_.stats_.symbolTable()),
+        grpc_context_(factory_.stats_.symbolTable()),
+        router_context_(factory_.stats_.symbolTable()) {
+    envoy::config::bootstrap::v3::Bootstrap bootstrap;
+    bootstrap.mutable_cluster_manager()->set_enable_deferred_load_balancers(
+        deferred_load_balancers);
+    cluster_manager_ = std::make_unique<TestClusterManagerImpl>(
+        bootstrap, factory_, factory_.stats_, factory_.tls_, factory_.runtime_,
+        factory_.local_info_, log_manager_, factory_.dispatcher_, admin_, validation_context_,
+        *factory_.api_, http_context_, grpc_context_, router_context_);
+    helper_ = std::make_unique<CdsApiHelper>(*cluster_manager_, "cds");
+  }
+
+  ~CdsSpeedTest() { factory_.tls_.shutdownThread(); }
+
+  // Adds static clusters with the given number of hosts each in a single CDS update, then picks a
+  // host from the given number of them, as the workers would for the clusters that see traffic.
+  void addClustersHelper(size_t num_clusters, size_t num_hosts, size_t num_used_clusters) {
+    state_.PauseTiming();
+
+    std::vector<envoy::config::cluster::v3::Cluster> clusters;
+    clusters.reserve(num_clusters);
+    for (size_t i = 0; i < num_clusters; ++i) {
+      envoy::config::cluster::v3::Cluster cluster;
+      cluster.set_name(fmt::format("cluster_{}", i));
+      cluster.set_type(envoy::config::cluster::v3::Cluster::STATIC);
+      cluster.mutable_connect_timeout()->set_seconds(1);
+      auto* load_assignment = cluster.mutable_load_assignment();
+      load_assignment->set_cluster_name(cluster.name());
+      auto* endpoints = load_assignment->add_endpoints();
+      for (size_t j = 0; j < num_hosts; ++j) {
+        auto* socket_address = endpoints->add_lb_endpoints()
+                                   ->mutable_endpoint()
+                                   ->mutable_address()
+                                   ->mutable_socket_address();
+        socket_address->set_address("10.0.1." + std::to_string(j / 60000));
+        socket_address->set_port_value((1000 + j) % 60000);
+      }
+      clusters.push_back(std::move(cluster));
+    }
+    const auto decoded_resources = TestUtility::decodeResources(clusters);
+
+    state_.ResumeTiming();
+    helper_->onConfigUpdate(decoded_resources.refvec_, {}, "1");
+    for (size_t i = 0; i < num_used_clusters; ++i) {
+      ThreadLocalCluster* cluster =
+          cluster_manager_->getThreadLocalCluster(fmt::format("cluster_{}", i));
+      RELEASE_ASSERT(cluster != nullptr, "");
+      cluster->loadBalancer().chooseHost(nullptr);
+    }
+    RELEASE_ASSERT(cluster_manager_->clusters().active_clusters_.size() == num_clusters, "");
+  }
+
+  State& state_;
+  TestClusterManagerFactory factory_;
+  NiceMock<ProtobufMessage::MockValidationContext> validation_context_;
+  NiceMock<AccessLog::MockAccessLogManager> log_manager_;
+  NiceMock<Server::MockAdmin> admin_;
+  Http::ContextImpl http_context_;
+  Grpc::ContextImpl grpc_context_;
+  Router::ContextImpl router_context_;
+  std::unique_ptr<TestClusterManagerImpl> cluster_manager_;
+  std::unique_ptr<CdsApiHelper> helper_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
+
+static void addClusters(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) {
+    Envoy::Upstream::CdsSpeedTest speed_test(state, state.range(0));
+    // if we've been instructed to skip tests, only run once no matter the argument:
+    const uint32_t clusters = skipExpensiveBenchmarks() ? 1 : state.range(1);
+
+    // Only a tenth of the clusters see traffic.
+    speed_test.addClustersHelper(clusters, 10, clusters / 10);
+  }
+}
+
+BENCHMARK(addClusters)->Ranges({{false, true}, {1, 10000}})->Unit(benchmark::kMillisecond);
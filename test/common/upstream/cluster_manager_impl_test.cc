@@ -4,6 +4,7 @@
 #include "envoy/config/cluster/v3/cluster.pb.validate.h"
 #include "envoy/config/core/v3/base.pb.h"
 
+#include "common/common/hash.h"
 #include "common/network/raw_buffer_socket.h"
 #include "common/router/context_impl.h"
 
@@ -15,6 +16,7 @@
 #include "test/mocks/upstream/cluster_real_priority_set.h"
 #include "test/mocks/upstream/cluster_update_callbacks.h"
 #include "test/mocks/upstream/health_checker.h"
+#include "test/mocks/upstream/load_balancer.h"
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/thread_aware_load_balancer.h"
 #include "test/test_common/test_runtime.h"
@@ -1551,6 +1553,28 @@ TEST_F(ClusterManagerImplTest, ShutdownWithWarming) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// The hash supplied with a cluster decides whether it changed, rather than the hash of its proto.
+TEST_F(ClusterManagerImplTest, AddOrUpdateClusterWithHash) {
+  create(defaultConfig());
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), "", 1));
+  cluster1->initialize_callback_();
+
+  auto update_cluster = defaultStaticCluster("fake_cluster");
+  update_cluster.mutable_per_connection_buffer_limit_bytes()->set_value(12345);
+  EXPECT_FALSE(cluster_manager_->addOrUpdateCluster(update_cluster, "", 1));
+  checkStats(1 /*added*/, 0 /*modified*/, 0 /*removed*/, 1 /*active*/, 0 /*warming*/);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster2, nullptr)));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(update_cluster, "", 2));
+  checkStats(1 /*added*/, 1 /*modified*/, 0 /*removed*/, 1 /*active*/, 1 /*warming*/);
+}
+
 TEST_F(ClusterManagerImplTest, DynamicAddRemove) {
   create(defaultConfig());
 
@@ -1727,6 +1751,206 @@ TEST_F(ClusterManagerImplTest, HostsPostedToTlsCluster) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
 }
 
+// Verifies that with worker partitions, the TLS cluster only gets the hosts of its partition.
+TEST_F(ClusterManagerImplTest, HostsPostedToTlsClusterWithWorkerPartitions) {
+  const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                        clustersJson({defaultStaticClusterJson("fake_cluster")}));
+  std::shared_ptr<MockClusterRealPrioritySet> cluster1(new NiceMock<MockClusterRealPrioritySet>());
+  ON_CALL(*cluster1->info_, workerPartitions()).WillByDefault(Return(2));
+  InSequence s;
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  EXPECT_CALL(*cluster1, initialize(_));
+
+  create(parseBootstrapFromV3Json(json));
+
+  ReadyWatcher initialized;
+  cluster_manager_->setInitializedCb([&]() -> void { initialized.ready(); });
+
+  EXPECT_CALL(initialized, ready());
+  cluster1->initialize_callback_();
+
+  // The only thread local cluster manager is the first one, so it gets partition 0.
+  HostVector hosts;
+  HostVector partition_hosts;
+  for (int i = 0; i < 16; ++i) {
+    HostSharedPtr host = makeTestHost(cluster1->info_, fmt::format("tcp://127.0.0.1:{}", 80 + i),
+                                      time_system_);
+    hosts.push_back(host);
+    if (HashUtil::xxHash64(host->address()->asStringView()) % 2 == 0) {
+      partition_hosts.push_back(host);
+    }
+  }
+  ASSERT_GT(partition_hosts.size(), 0);
+  ASSERT_LT(partition_hosts.size(), hosts.size());
+
+  auto hosts_ptr = std::make_shared<HostVector>(hosts);
+  cluster1->priority_set_.updateHosts(
+      0, HostSetImpl::partitionHosts(hosts_ptr, HostsPerLocalityImpl::empty()), nullptr, hosts, {},
+      100);
+
+  auto* tls_cluster = cluster_manager_->getThreadLocalCluster(cluster1->info_->name());
+  const HostSet& host_set = *tls_cluster->prioritySet().hostSetsPerPriority()[0];
+  EXPECT_EQ(partition_hosts, host_set.hosts());
+  EXPECT_EQ(partition_hosts, host_set.healthyHosts());
+
+  // Removing a host of the other partition leaves the TLS cluster as it is.
+  const auto other_host = std::find_if(hosts.begin(), hosts.end(), [&](const HostSharedPtr& host) {
+    return std::find(partition_hosts.begin(), partition_hosts.end(), host) ==
+           partition_hosts.end();
+  });
+  const HostVector removed{*other_host};
+  hosts.erase(other_host);
+  hosts_ptr = std::make_shared<HostVector>(hosts);
+  cluster1->priority_set_.updateHosts(
+      0, HostSetImpl::partitionHosts(hosts_ptr, HostsPerLocalityImpl::empty()), nullptr, {},
+      removed, 100);
+  EXPECT_EQ(partition_hosts, tls_cluster->prioritySet().hostSetsPerPriority()[0]->hosts());
+
+  factory_.tls_.shutdownThread();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
+// Verifies that the cluster updates of a batch reach the workers at once, when the batch closes.
+TEST_F(ClusterManagerImplTest, BatchedClusterUpdates) {
+  create(defaultConfig());
+
+  std::unique_ptr<MockClusterUpdateCallbacks> callbacks(new NiceMock<MockClusterUpdateCallbacks>());
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(*callbacks);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "cluster_1";
+  std::shared_ptr<MockClusterMockPrioritySet> cluster2(new NiceMock<MockClusterMockPrioritySet>());
+  cluster2->info_->name_ = "cluster_2";
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)))
+      .WillOnce(Return(std::make_pair(cluster2, nullptr)));
+  auto inline_init = [](std::function<void()> initialize_callback) { initialize_callback(); };
+  EXPECT_CALL(*cluster1, initialize(_)).WillOnce(Invoke(inline_init));
+  EXPECT_CALL(*cluster2, initialize(_)).WillOnce(Invoke(inline_init));
+
+  {
+    ClusterUpdateBatch batch = cluster_manager_->batchClusterUpdates();
+    ClusterUpdateBatch nested_batch = cluster_manager_->batchClusterUpdates();
+    EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_1"), ""));
+    nested_batch.reset();
+    EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("cluster_2"), ""));
+    EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_1"));
+    EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("cluster_2"));
+
+    InSequence s;
+    EXPECT_CALL(factory_.tls_, runOnAllThreads(_))
+        .WillOnce(Invoke(&factory_.tls_, &ThreadLocal::MockInstance::runOnAllThreads1_))
+        .RetiresOnSaturation();
+    EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_))
+        .WillOnce(Invoke([](ThreadLocalCluster& cluster) {
+          EXPECT_EQ("cluster_1", cluster.info()->name());
+        }));
+    EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_))
+        .WillOnce(Invoke([](ThreadLocalCluster& cluster) {
+          EXPECT_EQ("cluster_2", cluster.info()->name());
+        }));
+  }
+
+  EXPECT_EQ(cluster1->info_, cluster_manager_->getThreadLocalCluster("cluster_1")->info());
+  EXPECT_EQ(cluster2->info_, cluster_manager_->getThreadLocalCluster("cluster_2")->info());
+
+  factory_.tls_.shutdownThread();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster2.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
+}
+
+// Verifies that removing a cluster in a batch posts the batched updates first.
+TEST_F(ClusterManagerImplTest, BatchedClusterUpdatesBeforeRemoval) {
+  create(defaultConfig());
+
+  std::unique_ptr<MockClusterUpdateCallbacks> callbacks(new NiceMock<MockClusterUpdateCallbacks>());
+  ClusterUpdateCallbacksHandlePtr cb =
+      cluster_manager_->addThreadLocalClusterUpdateCallbacks(*callbacks);
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, nullptr)));
+  EXPECT_CALL(*cluster1, initialize(_))
+      .WillOnce(Invoke([](std::function<void()> initialize_callback) { initialize_callback(); }));
+
+  ClusterUpdateBatch batch = cluster_manager_->batchClusterUpdates();
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(defaultStaticCluster("fake_cluster"), ""));
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("fake_cluster"));
+
+  InSequence s;
+  EXPECT_CALL(*callbacks, onClusterAddOrUpdate(_));
+  EXPECT_CALL(*callbacks, onClusterRemoval("fake_cluster"));
+  EXPECT_TRUE(cluster_manager_->removeCluster("fake_cluster"));
+  EXPECT_EQ(nullptr, cluster_manager_->getThreadLocalCluster("fake_cluster"));
+
+  // Nothing is left to post.
+  EXPECT_CALL(factory_.tls_, runOnAllThreads(_)).Times(0);
+  batch.reset();
+
+  factory_.tls_.shutdownThread();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(callbacks.get()));
+}
+
+// A thread aware LB factory that counts the worker LBs it creates.
+class CountingLoadBalancerFactory : public LoadBalancerFactory {
+public:
+  LoadBalancerPtr create() override {
+    created_++;
+    return std::make_unique<NiceMock<MockLoadBalancer>>();
+  }
+
+  uint32_t created_{};
+};
+
+// Verifies that with deferred load balancers, the worker LB of a cluster is only created on first
+// use, and then re-created on membership updates as usual.
+TEST_F(ClusterManagerImplTest, DeferredLoadBalancers) {
+  const std::string json = fmt::sprintf(
+      "{\"cluster_manager\":{\"enable_deferred_load_balancers\":true},"
+      "\"static_resources\":{%s}}",
+      clustersJson({defaultStaticClusterJson("cluster_0")}));
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "cluster_0";
+  cluster1->info_->lb_type_ = LoadBalancerType::ClusterProvided;
+  auto lb_factory = std::make_shared<CountingLoadBalancerFactory>();
+  auto* thread_aware_lb = new NiceMock<MockThreadAwareLoadBalancer>();
+  ON_CALL(*thread_aware_lb, factory()).WillByDefault(Return(lb_factory));
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, thread_aware_lb)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  create(parseBootstrapFromV3Json(json));
+  cluster1->initialize_callback_();
+
+  // A membership update doesn't create the LB of a worker that never used the cluster.
+  MockHostSet* host_set = cluster1->prioritySet().getMockHostSet(0);
+  host_set->hosts_ = {makeTestHost(cluster1->info_, "tcp://127.0.0.1:80", time_system_)};
+  host_set->runCallbacks(host_set->hosts_, {});
+  ThreadLocalCluster* cluster = cluster_manager_->getThreadLocalCluster("cluster_0");
+  ASSERT_NE(nullptr, cluster);
+  EXPECT_EQ(0, lb_factory->created_);
+
+  cluster->loadBalancer();
+  cluster->loadBalancer();
+  EXPECT_EQ(1, lb_factory->created_);
+
+  host_set->hosts_.push_back(makeTestHost(cluster1->info_, "tcp://127.0.0.1:81", time_system_));
+  host_set->runCallbacks({host_set->hosts_.back()}, {});
+  EXPECT_EQ(2, lb_factory->created_);
+
+  factory_.tls_.shutdownThread();
+
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(cluster1.get()));
+}
+
 // Test that we close all HTTP connection pool connections when there is a host health failure.
 TEST_F(ClusterManagerImplTest, CloseHttpConnectionsOnHealthFailure) {
   const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
@@ -14,6 +14,7 @@
 #include "common/config/utility.h"
 #include "common/singleton/manager_impl.h"
 #include "common/upstream/eds.h"
+#include "common/upstream/load_balancer_impl.h"
 
 #include "server/transport_socket_config_impl.h"
 
@@ -49,6 +50,7 @@ public:
         api_(Api::createApiForTest(stats_)), async_client_(new Grpc::MockAsyncClient()),
         grpc_mux_(new Config::GrpcMuxImpl(
             local_info_, std::unique_ptr<Grpc::MockAsyncClient>(async_client_), dispatcher_,
+            api_->threadFactory(),
             *Protobuf::DescriptorPool::generated_pool()->FindMethodByName(
                 "envoy.service.endpoint.v3.EndpointDiscoveryService.StreamEndpoints"),
             envoy::config::core::v3::ApiVersion::AUTO, random_, stats_, {}, true)) {
@@ -93,7 +95,7 @@ public:
   // Set up an EDS config with multiple priorities, localities, weights and make sure
   // they are loaded as expected.
   void priorityAndLocalityWeightedHelper(bool ignore_unknown_dynamic_fields, size_t num_hosts,
-                                         bool healthy) {
+                                         bool healthy, bool weighted = false) {
     state_.PauseTiming();
 
     envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
@@ -116,6 +118,9 @@ public:
       } else {
         lb_endpoint->set_health_status(envoy::config::core::v3::UNHEALTHY);
       }
+      if (weighted) {
+        lb_endpoint->mutable_load_balancing_weight()->set_value(i % 2 + 1);
+      }
       auto* socket_address =
           lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
       socket_address->set_address("10.0.1." + std::to_string(i / 60000));
@@ -142,6 +147,13 @@ public:
            num_hosts);
   }
 
+  // Creates a worker style load balancer for the cluster, which is refreshed on every update.
+  void createLoadBalancer() {
+    lb_ = std::make_unique<RoundRobinLoadBalancer>(cluster_->prioritySet(), nullptr,
+                                                   cluster_->info()->stats(), runtime_, random_,
+                                                   cluster_->info()->lbConfig());
+  }
+
   TestDeprecatedV2Api _deprecated_v2_api_;
   State& state_;
   const bool v2_config_;
@@ -171,6 +183,7 @@ public:
   NiceMock<Grpc::MockAsyncStream> async_stream_;
   Config::GrpcMuxImplSharedPtr grpc_mux_;
   Config::GrpcSubscriptionImplPtr subscription_;
+  std::unique_ptr<RoundRobinLoadBalancer> lb_;
 };
 
 } // namespace Upstream
@@ -223,3 +236,29 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Range(1, 100000)->Unit(benchmark::kMillisecond);
+
+// Measures a burst of updates that each add a host, followed by a pick, with a load balancer
+// attached to the cluster as on a worker. Arguments are (weighted hosts, number of hosts).
+static void membershipUpdateBurst(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  for (auto _ : state) {
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+    const bool weighted = state.range(0);
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 1 : state.range(1);
+
+    speed_test.priorityAndLocalityWeightedHelper(true, endpoints, true, weighted);
+    state.PauseTiming();
+    speed_test.createLoadBalancer();
+    state.ResumeTiming();
+    for (uint32_t i = 1; i <= 10; ++i) {
+      speed_test.priorityAndLocalityWeightedHelper(true, endpoints + i, true, weighted);
+    }
+    speed_test.lb_->chooseHost(nullptr);
+  }
+}
+
+BENCHMARK(membershipUpdateBurst)
+    ->Ranges({{false, true}, {1, 100000}})
+    ->Unit(benchmark::kMillisecond);
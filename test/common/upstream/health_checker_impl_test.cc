@@ -12,6 +12,7 @@
 
 #include "common/buffer/buffer_impl.h"
 #include "common/buffer/zero_copy_input_stream_impl.h"
+#include "common/common/hash.h"
 #include "common/grpc/common.h"
 #include "common/http/headers.h"
 #include "common/json/json_loader.h"
@@ -746,6 +747,72 @@ TEST_F(HttpHealthCheckerImplTest, Success) {
   EXPECT_EQ(Host::Health::Healthy, cluster_->prioritySet().getMockHostSet(0)->hosts_[0]->health());
 }
 
+// With fleet sharding, only the hosts of the shard of this Envoy are checked. The hosts of the
+// other shards are released as healthy without a check.
+TEST_F(HttpHealthCheckerImplTest, FleetSharding) {
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    http_health_check:
+      path: /healthcheck
+    fleet_sharding:
+      shard_count: 2
+      shard_index: 0
+    )EOF";
+  allocHealthChecker(yaml);
+  addCompletionCallback();
+
+  std::string in_shard_url;
+  std::string other_shard_url;
+  for (int port = 80; in_shard_url.empty() || other_shard_url.empty(); port++) {
+    const std::string address = fmt::format("127.0.0.1:{}", port);
+    (HashUtil::xxHash64(address) % 2 == 0 ? in_shard_url : other_shard_url) = "tcp://" + address;
+  }
+  HostSharedPtr in_shard_host = makeTestHost(cluster_->info_, in_shard_url, simTime());
+  HostSharedPtr other_shard_host = makeTestHost(cluster_->info_, other_shard_url, simTime());
+  other_shard_host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+  // The sessions take the timers of the test sessions in reverse order.
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {other_shard_host, in_shard_host};
+  cluster_->info_->stats().upstream_cx_total_.inc();
+  expectSessionCreate();
+  expectStreamCreate(0);
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, enableTimer(_, _));
+  expectSessionCreate();
+  EXPECT_CALL(*test_sessions_[1]->interval_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  health_checker_->start();
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+
+  EXPECT_CALL(*this, onHostStatus(other_shard_host, HealthTransition::Changed));
+  test_sessions_[1]->interval_timer_->invokeCallback();
+  EXPECT_EQ(Host::Health::Healthy, other_shard_host->health());
+
+  EXPECT_CALL(*this, onHostStatus(in_shard_host, HealthTransition::Unchanged));
+  EXPECT_CALL(*test_sessions_[0]->interval_timer_, enableTimer(_, _));
+  EXPECT_CALL(*test_sessions_[0]->timeout_timer_, disableTimer());
+  respond(0, "200", false, false, true);
+  EXPECT_EQ(Host::Health::Healthy, in_shard_host->health());
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.attempt").value());
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+}
+
+TEST_F(HttpHealthCheckerImplTest, FleetShardingInvalidIndex) {
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 1s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    http_health_check:
+      path: /healthcheck
+    fleet_sharding:
+      shard_count: 2
+      shard_index: 2
+    )EOF";
+  EXPECT_THROW_WITH_MESSAGE(allocHealthChecker(yaml), EnvoyException,
+                            "health check shard_index 2 must be smaller than 2");
+}
+
 TEST_F(HttpHealthCheckerImplTest, Degraded) {
   setupNoServiceValidationHC();
   EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Changed)).Times(2);
@@ -4066,6 +4133,30 @@ public:
     addCompletionCallback();
   }
 
+  void setupAdditionalServiceNamesHC() {
+    auto config = createGrpcHealthCheckConfig();
+    config.mutable_grpc_health_check()->set_service_name("service");
+    config.mutable_grpc_health_check()->add_additional_service_names("other_service");
+    allocHealthChecker(config);
+    addCompletionCallback();
+  }
+
+  // Records the service of each request of a session.
+  void expectServiceRequests(size_t index, int times, std::vector<std::string>& services) {
+    EXPECT_CALL(test_sessions_[index]->request_encoder_, encodeData(_, true))
+        .Times(times)
+        .WillRepeatedly(Invoke([&services](Buffer::Instance& data, bool) {
+          std::vector<Grpc::Frame> decoded_frames;
+          Grpc::Decoder decoder;
+          ASSERT_TRUE(decoder.decode(data, decoded_frames));
+          ASSERT_EQ(1U, decoded_frames.size());
+          Buffer::ZeroCopyInputStreamImpl stream(std::move(decoded_frames[0].data_));
+          grpc::health::v1::HealthCheckRequest request;
+          ASSERT_TRUE(request.ParseFromZeroCopyStream(&stream));
+          services.push_back(request.service());
+        }));
+  }
+
   void setupNoReuseConnectionHC() {
     auto config = createGrpcHealthCheckConfig();
     config.mutable_reuse_connection()->set_value(false);
@@ -4350,6 +4441,61 @@ TEST_F(GrpcHealthCheckerImplTest, SuccessWithCustomAuthority) {
   testSingleHostSuccess(authority);
 }
 
+// The additional services are checked on the same connection before the host is reported healthy.
+TEST_F(GrpcHealthCheckerImplTest, SuccessWithAdditionalServiceNames) {
+  setupAdditionalServiceNamesHC();
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80", simTime())};
+
+  expectSessionCreate();
+  expectHealthcheckStart(0);
+  std::vector<std::string> services;
+  expectServiceRequests(0, 2, services);
+  health_checker_->start();
+  EXPECT_EQ(std::vector<std::string>{"service"}, services);
+
+  EXPECT_CALL(*this, onHostStatus(_, _)).Times(0);
+  expectStreamCreate(0);
+  respondServiceStatus(0, grpc::health::v1::HealthCheckResponse::SERVING);
+  EXPECT_EQ((std::vector<std::string>{"service", "other_service"}), services);
+
+  EXPECT_CALL(runtime_.snapshot_, getInteger("health_check.max_interval", _));
+  EXPECT_CALL(runtime_.snapshot_, getInteger("health_check.min_interval", _))
+      .WillOnce(Return(45000));
+  expectHealthcheckStop(0, 45000);
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Unchanged));
+  respondServiceStatus(0, grpc::health::v1::HealthCheckResponse::SERVING);
+  expectHostHealthy(true);
+}
+
+// A host with an additional service that isn't serving is unhealthy, and the next check starts
+// again from the first service.
+TEST_F(GrpcHealthCheckerImplTest, AdditionalServiceNotServing) {
+  setupAdditionalServiceNamesHC();
+  cluster_->prioritySet().getMockHostSet(0)->hosts_ = {
+      makeTestHost(cluster_->info_, "tcp://127.0.0.1:80", simTime())};
+
+  expectSessionCreate();
+  expectHealthcheckStart(0);
+  std::vector<std::string> services;
+  expectServiceRequests(0, 3, services);
+  health_checker_->start();
+
+  expectStreamCreate(0);
+  respondServiceStatus(0, grpc::health::v1::HealthCheckResponse::SERVING);
+
+  expectHealthcheckStop(0);
+  EXPECT_CALL(*this, onHostStatus(_, HealthTransition::Changed));
+  EXPECT_CALL(event_logger_, logEjectUnhealthy(_, _, _));
+  EXPECT_CALL(event_logger_, logUnhealthy(_, _, _, true));
+  respondServiceStatus(0, grpc::health::v1::HealthCheckResponse::NOT_SERVING);
+  expectHostHealthy(false);
+
+  expectHealthcheckStart(0);
+  test_sessions_[0]->interval_timer_->invokeCallback();
+  EXPECT_EQ((std::vector<std::string>{"service", "other_service", "service"}), services);
+}
+
 // Test host check success when gRPC response payload is split between several incoming data chunks.
 TEST_F(GrpcHealthCheckerImplTest, SuccessResponseSplitBetweenChunks) {
   setupServiceNameHC(absl::nullopt);
@@ -1,11 +1,13 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
 #include <memory>
+#include <random>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 
 #include "common/common/random_generator.h"
 #include "common/memory/stats.h"
+#include "common/router/metadatamatchcriteria_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
 #include "common/upstream/subset_lb.h"
@@ -57,6 +59,20 @@ public:
                                     {}, hosts, {}, absl::nullopt);
   }
 
+  // Replaces the first host with a new one, as an EDS update that moves one endpoint would.
+  void replaceFirstHost() {
+    HostVector hosts = priority_set_.hostSetsPerPriority()[0]->hosts();
+    const HostVector hosts_removed = {hosts[0]};
+    hosts[0] = makeTestHost(info_, fmt::format("tcp://10.1.0.{}:6379", ++replaced_hosts_ % 256),
+                            simTime());
+    const HostVector hosts_added = {hosts[0]};
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    priority_set_.updateHosts(0, HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality), {},
+                              hosts_added, hosts_removed, absl::nullopt);
+  }
+
+  uint64_t replaced_hosts_{};
   Envoy::Thread::MutexBasicLockable lock_;
   // Reduce default log level to warn while running this benchmark to avoid problems due to
   // excessive debug logging in upstream_impl.cc
@@ -89,7 +105,9 @@ public:
 
 class LeastRequestTester : public BaseTester {
 public:
-  LeastRequestTester(uint64_t num_hosts, uint32_t choice_count) : BaseTester(num_hosts) {
+  LeastRequestTester(uint64_t num_hosts, uint32_t choice_count,
+                     uint32_t weighted_subset_percent = 0, uint32_t weight = 0)
+      : BaseTester(num_hosts, weighted_subset_percent, weight) {
     envoy::config::cluster::v3::Cluster::LeastRequestLbConfig lr_lb_config;
     lr_lb_config.mutable_choice_count()->set_value(choice_count);
     lb_ =
@@ -205,6 +223,24 @@ BENCHMARK(benchmarkRingHashLoadBalancerBuildRing)
     ->Args({500, 256000})
     ->Unit(::benchmark::kMillisecond);
 
+void benchmarkRingHashLoadBalancerRebuildRing(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  RingHashTester tester(num_hosts, min_ring_size);
+  tester.ring_hash_lb_->initialize();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    // Time the rebuild that follows a host set change.
+    tester.replaceFirstHost();
+  }
+}
+BENCHMARK(benchmarkRingHashLoadBalancerRebuildRing)
+    ->Args({100, 65536})
+    ->Args({500, 65536})
+    ->Args({5000, 65536})
+    ->Args({500, 256000})
+    ->Args({5000, 256000})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkMaglevLoadBalancerBuildTable(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     state.PauseTiming();
@@ -229,6 +265,21 @@ BENCHMARK(benchmarkMaglevLoadBalancerBuildTable)
     ->Arg(500)
     ->Unit(::benchmark::kMillisecond);
 
+void benchmarkMaglevLoadBalancerRebuildTable(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  MaglevTester tester(num_hosts);
+  tester.maglev_lb_->initialize();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    // Time the rebuild that follows a host set change.
+    tester.replaceFirstHost();
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerRebuildTable)
+    ->Arg(100)
+    ->Arg(500)
+    ->Arg(5000)
+    ->Unit(::benchmark::kMillisecond);
+
 class TestLoadBalancerContext : public LoadBalancerContextBase {
 public:
   // Upstream::LoadBalancerContext
@@ -299,6 +350,42 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Arguments are (number of hosts, percentage of hosts with a weight of 2). Hosts are weighted so
+// that the picks go through the EDF scheduler.
+void benchmarkRoundRobinLoadBalancerPick(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  RoundRobinTester tester(num_hosts, state.range(1), 2);
+  tester.initialize();
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmarkRoundRobinLoadBalancerPick)
+    ->Args({10, 0})
+    ->Args({1000, 0})
+    ->Args({10000, 0})
+    ->Args({10, 50})
+    ->Args({1000, 50})
+    ->Args({10000, 50});
+
+// Arguments are (number of hosts, percentage of hosts with a weight of 2).
+void benchmarkLeastRequestLoadBalancerPick(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  LeastRequestTester tester(num_hosts, 2, state.range(1), 2);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    ::benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(benchmarkLeastRequestLoadBalancerPick)
+    ->Args({10, 0})
+    ->Args({1000, 0})
+    ->Args({10000, 0})
+    ->Args({10, 50})
+    ->Args({1000, 50})
+    ->Args({10000, 50});
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
@@ -371,6 +458,90 @@ BENCHMARK(benchmarkMaglevLoadBalancerChooseHost)
     ->Args({500, 100000})
     ->Unit(::benchmark::kMillisecond);
 
+// Draws the ranks of keys following a Zipf distribution, so that a few keys get most of the picks.
+class ZipfKeys {
+public:
+  ZipfKeys(uint64_t num_keys, double exponent) : cdf_(num_keys) {
+    double sum = 0;
+    for (uint64_t i = 0; i < num_keys; i++) {
+      sum += 1.0 / std::pow(i + 1, exponent);
+      cdf_[i] = sum;
+    }
+    for (double& value : cdf_) {
+      value /= sum;
+    }
+  }
+
+  uint64_t next() {
+    const double u = static_cast<double>(random_()) / random_.max();
+    return std::min<uint64_t>(std::lower_bound(cdf_.begin(), cdf_.end(), u) - cdf_.begin(),
+                              cdf_.size() - 1);
+  }
+
+private:
+  std::vector<double> cdf_;
+  std::mt19937_64 random_{42};
+};
+
+// Arguments are (number of hosts, hash balance factor, Zipf exponent * 100). A window of requests
+// is kept active, so that the hosts of the most frequent keys are overloaded and the picks probe
+// for other hosts.
+void benchmarkMaglevLoadBalancerBoundedLoadZipf(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t keys_to_simulate = 100000;
+  const uint64_t active_requests = 1000;
+  MaglevTester tester(num_hosts);
+  tester.common_config_.mutable_consistent_hashing_lb_config()
+      ->mutable_hash_balance_factor()
+      ->set_value(state.range(1));
+  tester.maglev_lb_ = std::make_unique<MaglevLoadBalancer>(
+      tester.priority_set_, tester.stats_, tester.stats_store_, tester.runtime_, tester.random_,
+      tester.config_, tester.common_config_);
+  tester.maglev_lb_->initialize();
+  LoadBalancerPtr lb = tester.maglev_lb_->factory()->create();
+  ZipfKeys keys(10000, state.range(2) / 100.0);
+  Stats::Gauge& cluster_active = tester.info_->stats_.upstream_rq_active_;
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    absl::node_hash_map<std::string, uint64_t> hit_counter;
+    std::vector<HostConstSharedPtr> active(active_requests);
+    TestLoadBalancerContext context;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < keys_to_simulate; i++) {
+      HostConstSharedPtr& slot = active[i % active_requests];
+      if (slot != nullptr) {
+        slot->stats().rq_active_.dec();
+        cluster_active.dec();
+      }
+      context.hash_key_ = hashInt(keys.next());
+      slot = lb->chooseHost(&context);
+      slot->stats().rq_active_.inc();
+      cluster_active.inc();
+      hit_counter[slot->address()->asString()] += 1;
+    }
+
+    // Do not time computation of mean, standard deviation, and relative standard deviation.
+    state.PauseTiming();
+    for (const HostConstSharedPtr& host : active) {
+      if (host != nullptr) {
+        host->stats().rq_active_.dec();
+        cluster_active.dec();
+      }
+    }
+    computeHitStats(state, hit_counter);
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkMaglevLoadBalancerBoundedLoadZipf)
+    ->Args({100, 125, 0})
+    ->Args({100, 125, 100})
+    ->Args({100, 150, 100})
+    ->Args({500, 125, 100})
+    ->Args({500, 125, 150})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerHostLoss(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t min_ring_size = state.range(1);
@@ -609,6 +780,43 @@ BENCHMARK(benchmarkSubsetLoadBalancerUpdate)
     ->Ranges({{false, true}, {50, 2500}})
     ->Unit(::benchmark::kMillisecond);
 
+class SubsetLbContext : public LoadBalancerContextBase {
+public:
+  explicit SubsetLbContext(const ProtobufWkt::Struct& metadata_matches)
+      : criteria_(metadata_matches) {}
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return &criteria_; }
+
+private:
+  const Router::MetadataMatchCriteriaImpl criteria_;
+};
+
+void benchmarkSubsetLoadBalancerChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  SubsetLbTester tester(num_hosts, false /* single_host_per_subset */);
+  // Every host is in a subset of its own, pick from each of them in turn.
+  std::vector<std::unique_ptr<SubsetLbContext>> contexts;
+  for (uint64_t i = 0; i < num_hosts; i++) {
+    ProtobufWkt::Struct metadata_matches;
+    (*metadata_matches.mutable_fields())[std::string(BaseTester::metadata_key)].set_number_value(i);
+    contexts.push_back(std::make_unique<SubsetLbContext>(metadata_matches));
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(contexts[i++ % num_hosts].get()));
+  }
+  state.counters["subsets_selected"] = tester.stats_.lb_subsets_selected_.value();
+}
+
+BENCHMARK(benchmarkSubsetLoadBalancerChooseHost)->Ranges({{50, 2500}});
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -954,6 +954,35 @@ TEST_P(RoundRobinLoadBalancerTest, Weighted) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Validate that only the hosts of the last of several membership updates are picked, even though
+// the schedule isn't rebuilt until the next pick.
+TEST_P(RoundRobinLoadBalancerTest, WeightedUpdatesBeforePick) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // Add a host, then remove it again along with one of the original hosts.
+  HostSharedPtr added_host = makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3);
+  hostSet().healthy_hosts_.push_back(added_host);
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({added_host}, {});
+  HostVector removed_hosts = {hostSet().hosts_[1], added_host};
+  hostSet().healthy_hosts_ = {hostSet().hosts_[0],
+                              makeTestHost(info_, "tcp://127.0.0.1:83", simTime(), 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({hostSet().healthy_hosts_[1]}, removed_hosts);
+
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
 // Validate that the RNG seed influences pick order when weighted RR.
 TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
@@ -1767,6 +1796,67 @@ TEST_P(RandomLoadBalancerTest, FailClusterOnPanic) {
 
 INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, RandomLoadBalancerTest, ::testing::Values(true, false));
 
+class PeakEwmaLoadBalancerTest : public LoadBalancerTestBase {
+public:
+  void init() {
+    lb_ = std::make_shared<PeakEwmaLoadBalancer>(priority_set_, nullptr, stats_, runtime_,
+                                                 random_, common_config_);
+  }
+  std::shared_ptr<LoadBalancer> lb_;
+};
+
+TEST_P(PeakEwmaLoadBalancerTest, NoHosts) {
+  init();
+
+  EXPECT_EQ(nullptr, lb_->peekAnotherHost(nullptr));
+  EXPECT_EQ(nullptr, lb_->chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, SingleHost) {
+  init();
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime())};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+}
+
+TEST_P(PeakEwmaLoadBalancerTest, PrefersLowerCost) {
+  init();
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime()),
+                              makeTestHost(info_, "tcp://127.0.0.1:82", simTime())};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // Without samples all hosts have the default latency, so the first candidate wins ties. A random
+  // value of 0 compares hosts 0 and 1.
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return(0));
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+
+  hostSet().healthy_hosts_[0]->latencyEstimate().observe(std::chrono::milliseconds(100),
+                                                          simTime().monotonicTime());
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // Outstanding requests scale the latency.
+  hostSet().healthy_hosts_[1]->latencyEstimate().observe(std::chrono::milliseconds(10),
+                                                          simTime().monotonicTime());
+  hostSet().healthy_hosts_[1]->stats().rq_active_.set(10);
+  EXPECT_EQ(hostSet().healthy_hosts_[0], lb_->chooseHost(nullptr));
+
+  // And weights divide it.
+  hostSet().healthy_hosts_[1]->weight(2);
+  EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
+
+  // The high bits of the random value offset the second candidate from the first, here hosts 1
+  // and 2 are compared.
+  EXPECT_CALL(random_, random()).WillRepeatedly(Return((uint64_t(2) << 32) | 2));
+  EXPECT_EQ(hostSet().healthy_hosts_[2], lb_->chooseHost(nullptr));
+}
+
+INSTANTIATE_TEST_SUITE_P(PrimaryOrFailover, PeakEwmaLoadBalancerTest,
+                         ::testing::Values(true, false));
+
 TEST(LoadBalancerSubsetInfoImplTest, DefaultConfigIsDiabled) {
   auto subset_info = LoadBalancerSubsetInfoImpl(
       envoy::config::cluster::v3::Cluster::LbSubsetConfig::default_instance());
@@ -3,6 +3,7 @@
 #include "envoy/config/endpoint/v3/load_report.pb.h"
 #include "envoy/service/load_stats/v3/lrs.pb.h"
 
+#include "common/network/utility.h"
 #include "common/upstream/load_stats_reporter.h"
 
 #include "test/mocks/event/mocks.h"
@@ -10,6 +11,7 @@
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/mocks/upstream/host.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -21,6 +23,7 @@ using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
+using testing::ReturnRef;
 
 // The tests in this file provide just coverage over some corner cases in error handling. The test
 // for the happy path for LoadStatsReporter is provided in //test/integration:load_stats_reporter.
@@ -61,10 +64,12 @@ public:
         sendMessageRaw_(Grpc::ProtoBufferEqIgnoreRepeatedFieldOrdering(expected_request), false));
   }
 
-  void deliverLoadStatsResponse(const std::vector<std::string>& cluster_names) {
+  void deliverLoadStatsResponse(const std::vector<std::string>& cluster_names,
+                                bool report_endpoint_granularity = false) {
     std::unique_ptr<envoy::service::load_stats::v3::LoadStatsResponse> response(
         new envoy::service::load_stats::v3::LoadStatsResponse());
     response->mutable_load_reporting_interval()->set_seconds(42);
+    response->set_report_endpoint_granularity(report_endpoint_granularity);
     std::copy(cluster_names.begin(), cluster_names.end(),
               Protobuf::RepeatedPtrFieldBackInserter(response->mutable_clusters()));
 
@@ -222,6 +227,93 @@ TEST_F(LoadStatsReporterTest, ExistingClusters) {
   response_timer_cb_();
 }
 
+// Only the hosts which received load, or had requests in progress at the last report, are
+// visited, and their load is reported per endpoint if requested.
+TEST_F(LoadStatsReporterTest, HostsWithLoad) {
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
+  expectSendMessage({});
+  createLoadStatsReporter();
+  time_system_.setMonotonicTime(std::chrono::microseconds(3));
+
+  NiceMock<MockClusterMockPrioritySet> foo_cluster;
+  envoy::config::core::v3::Locality locality_a;
+  locality_a.set_zone("a");
+  envoy::config::core::v3::Locality locality_b;
+  locality_b.set_zone("b");
+  auto host_a = std::make_shared<NiceMock<MockHost>>();
+  auto host_b = std::make_shared<NiceMock<MockHost>>();
+  auto idle_host = std::make_shared<NiceMock<MockHost>>();
+  for (const auto& host : {host_a, host_b, idle_host}) {
+    ON_CALL(*host, locality()).WillByDefault(ReturnRef(locality_a));
+    ON_CALL(*host, priority()).WillByDefault(Return(0));
+  }
+  ON_CALL(*host_b, locality()).WillByDefault(ReturnRef(locality_b));
+  ON_CALL(*host_a, address())
+      .WillByDefault(Return(Network::Utility::resolveUrl("tcp://10.0.0.1:80")));
+  ON_CALL(*host_b, address())
+      .WillByDefault(Return(Network::Utility::resolveUrl("tcp://10.0.0.2:80")));
+  foo_cluster.prioritySet().getMockHostSet(0)->hosts_ = {host_a, host_b, idle_host};
+  MockClusterManager::ClusterInfoMaps cluster_info{{{"foo", foo_cluster}}, {}};
+  ON_CALL(cm_, clusters()).WillByDefault(Return(cluster_info));
+
+  // host_a has a request in progress when the cluster starts being tracked.
+  host_a->stats_.rq_total_.inc();
+  host_a->stats_.rq_active_.inc();
+  deliverLoadStatsResponse({"foo"}, true);
+
+  // The request in progress completes, and a request is issued to host_b.
+  host_a->stats_.rq_success_.inc();
+  host_a->stats_.rq_active_.dec();
+  host_b->stats_.rq_total_.inc();
+  host_b->stats_.rq_error_.inc();
+  foo_cluster.info_->loadReportHosts().add(host_b);
+  time_system_.setMonotonicTime(std::chrono::microseconds(5));
+  {
+    envoy::config::endpoint::v3::ClusterStats foo_cluster_stats;
+    foo_cluster_stats.set_cluster_name("foo");
+    foo_cluster_stats.mutable_load_report_interval()->MergeFrom(
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(2));
+    auto* locality_a_stats = foo_cluster_stats.add_upstream_locality_stats();
+    locality_a_stats->mutable_locality()->MergeFrom(locality_a);
+    locality_a_stats->set_total_successful_requests(1);
+    auto* host_a_stats = locality_a_stats->add_upstream_endpoint_stats();
+    host_a_stats->mutable_address()->mutable_socket_address()->set_address("10.0.0.1");
+    host_a_stats->mutable_address()->mutable_socket_address()->set_port_value(80);
+    host_a_stats->set_total_successful_requests(1);
+    auto* locality_b_stats = foo_cluster_stats.add_upstream_locality_stats();
+    locality_b_stats->mutable_locality()->MergeFrom(locality_b);
+    locality_b_stats->set_total_error_requests(1);
+    locality_b_stats->set_total_issued_requests(1);
+    auto* host_b_stats = locality_b_stats->add_upstream_endpoint_stats();
+    host_b_stats->mutable_address()->mutable_socket_address()->set_address("10.0.0.2");
+    host_b_stats->mutable_address()->mutable_socket_address()->set_port_value(80);
+    host_b_stats->set_total_error_requests(1);
+    host_b_stats->set_total_issued_requests(1);
+    expectSendMessage({foo_cluster_stats});
+  }
+  EXPECT_CALL(*response_timer_, enableTimer(std::chrono::milliseconds(42000), _));
+  response_timer_cb_();
+  EXPECT_FALSE(host_b->stats_.load_report_pending_.load());
+
+  // Without new load, the next report is empty.
+  time_system_.setMonotonicTime(std::chrono::microseconds(8));
+  {
+    envoy::config::endpoint::v3::ClusterStats foo_cluster_stats;
+    foo_cluster_stats.set_cluster_name("foo");
+    foo_cluster_stats.mutable_load_report_interval()->MergeFrom(
+        Protobuf::util::TimeUtil::MicrosecondsToDuration(3));
+    expectSendMessage({foo_cluster_stats});
+  }
+  EXPECT_CALL(*response_timer_, enableTimer(std::chrono::milliseconds(42000), _));
+  response_timer_cb_();
+
+  // Once the cluster is no longer tracked, its hosts aren't collected anymore.
+  deliverLoadStatsResponse({});
+  EXPECT_FALSE(foo_cluster.info_->loadReportHosts().enabled());
+  foo_cluster.info_->loadReportHosts().add(host_b);
+  EXPECT_FALSE(host_b->stats_.load_report_pending_.load());
+}
+
 // Validate that the client can recover from a remote stream closure via retry.
 TEST_F(LoadStatsReporterTest, RemoteStreamClose) {
   EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(&async_stream_));
@@ -0,0 +1,173 @@
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/config/core/v3/config_source.pb.h"
+
+#include "common/protobuf/utility.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/upstream/od_cds_api_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/protobuf/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Return;
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+MATCHER_P(WithName, expectedName, "") { return arg.name() == expectedName; }
+
+class MockMissingClusterNotifier : public MissingClusterNotifier {
+public:
+  MOCK_METHOD(void, notifyMissingCluster, (absl::string_view name));
+};
+
+class OdCdsApiImplTest : public testing::Test {
+protected:
+  void setup(std::chrono::milliseconds idle_timeout = std::chrono::milliseconds(0)) {
+    envoy::config::core::v3::ConfigSource odcds_config;
+    if (idle_timeout.count() > 0) {
+      idle_timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+    }
+    odcds_ = std::make_unique<OdCdsApiImpl>(odcds_config, idle_timeout, cm_, notifier_, store_,
+                                            dispatcher_, validation_visitor_);
+    odcds_callbacks_ = cm_.subscription_factory_.callbacks_;
+  }
+
+  // Discovers the given cluster, which is the only one requested.
+  void discoverCluster(const std::string& cluster_name) {
+    EXPECT_CALL(*cm_.subscription_factory_.subscription_,
+                start(absl::flat_hash_set<std::string>({cluster_name})));
+    odcds_->updateOnDemand(cluster_name);
+
+    envoy::config::cluster::v3::Cluster cluster;
+    cluster.set_name(cluster_name);
+    const auto decoded_resources = TestUtility::decodeResources({cluster});
+    EXPECT_CALL(cm_, addOrUpdateCluster(WithName(cluster_name), _)).WillOnce(Return(true));
+    odcds_callbacks_->onConfigUpdate(decoded_resources.refvec_, {}, "v1");
+  }
+
+  ClusterManager::ClusterInfoMaps makeClusterInfoMaps(const std::vector<std::string>& clusters) {
+    ClusterManager::ClusterInfoMaps maps;
+    for (const auto& cluster : clusters) {
+      maps.active_clusters_.emplace(cluster, cm_.thread_local_cluster_.cluster_);
+    }
+    return maps;
+  }
+
+  NiceMock<MockClusterManager> cm_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  Event::MockTimer* idle_timer_{};
+  MockMissingClusterNotifier notifier_;
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<ProtobufMessage::MockValidationVisitor> validation_visitor_;
+  std::unique_ptr<OdCdsApiImpl> odcds_;
+  Config::SubscriptionCallbacks* odcds_callbacks_{};
+};
+
+// The subscription starts with the first requested cluster, and is updated once per new cluster.
+TEST_F(OdCdsApiImplTest, RequestedClustersUpdateResourceInterest) {
+  InSequence s;
+  setup();
+
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_,
+              start(absl::flat_hash_set<std::string>({"fare"})));
+  odcds_->updateOnDemand("fare");
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_,
+              updateResourceInterest(absl::flat_hash_set<std::string>({"fare", "bus"})));
+  odcds_->updateOnDemand("bus");
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, updateResourceInterest(_)).Times(0);
+  odcds_->updateOnDemand("fare");
+}
+
+// The requested clusters that a state of the world update doesn't list are missing.
+TEST_F(OdCdsApiImplTest, StateOfTheWorldNotifiesMissingClusters) {
+  setup();
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
+  odcds_->updateOnDemand("fare");
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, updateResourceInterest(_));
+  odcds_->updateOnDemand("bus");
+
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("fare");
+  const auto decoded_resources = TestUtility::decodeResources({cluster});
+  EXPECT_CALL(cm_, addOrUpdateCluster(WithName("fare"), _)).WillOnce(Return(true));
+  EXPECT_CALL(cm_, removeCluster("bus")).WillOnce(Return(false));
+  EXPECT_CALL(notifier_, notifyMissingCluster(absl::string_view("bus")));
+  odcds_callbacks_->onConfigUpdate(decoded_resources.refvec_, "v1");
+
+  // A cluster which was discovered already isn't missing once it's removed.
+  EXPECT_CALL(cm_, removeCluster("fare")).WillOnce(Return(true));
+  EXPECT_CALL(cm_, removeCluster("bus")).WillOnce(Return(false));
+  EXPECT_CALL(notifier_, notifyMissingCluster(_)).Times(0);
+  odcds_callbacks_->onConfigUpdate({}, "v2");
+}
+
+// The removed clusters of a delta update that weren't discovered yet are missing.
+TEST_F(OdCdsApiImplTest, DeltaNotifiesMissingClusters) {
+  setup();
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
+  odcds_->updateOnDemand("fare");
+
+  Protobuf::RepeatedPtrField<std::string> removed;
+  *removed.Add() = "fare";
+  EXPECT_CALL(cm_, removeCluster("fare")).WillOnce(Return(false));
+  EXPECT_CALL(notifier_, notifyMissingCluster(absl::string_view("fare")));
+  odcds_callbacks_->onConfigUpdate({}, removed, "v1");
+}
+
+// The errors of adding the clusters are reported once all the clusters were handled.
+TEST_F(OdCdsApiImplTest, AddClusterFailure) {
+  setup();
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_, start(_));
+  odcds_->updateOnDemand("fare");
+
+  envoy::config::cluster::v3::Cluster cluster;
+  cluster.set_name("fare");
+  const auto decoded_resources = TestUtility::decodeResources({cluster});
+  EXPECT_CALL(cm_, addOrUpdateCluster(WithName("fare"), _))
+      .WillOnce(testing::Throw(EnvoyException("bad cluster")));
+  EXPECT_THROW_WITH_MESSAGE(odcds_callbacks_->onConfigUpdate(decoded_resources.refvec_, {}, ""),
+                            EnvoyException, "Error adding/updating cluster(s) fare: bad cluster");
+}
+
+// The discovered clusters which no request used during the idle timeout are removed.
+TEST_F(OdCdsApiImplTest, IdleClustersReclaimed) {
+  setup(std::chrono::milliseconds(60000));
+  EXPECT_CALL(*idle_timer_, enableTimer(std::chrono::milliseconds(60000), _));
+  discoverCluster("fare");
+
+  // The cluster served a request since it was discovered.
+  cm_.thread_local_cluster_.cluster_.info_->stats().upstream_rq_total_.inc();
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"fare"})));
+  EXPECT_CALL(cm_, removeCluster(_)).Times(0);
+  EXPECT_CALL(*idle_timer_, enableTimer(std::chrono::milliseconds(60000), _));
+  idle_timer_->invokeCallback();
+
+  // The cluster is idle, and requested again later.
+  EXPECT_CALL(cm_, clusters()).WillOnce(Return(makeClusterInfoMaps({"fare"})));
+  EXPECT_CALL(cm_, removeCluster("fare")).WillOnce(Return(true));
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_,
+              updateResourceInterest(absl::flat_hash_set<std::string>()));
+  EXPECT_CALL(*idle_timer_, enableTimer(_, _)).Times(0);
+  idle_timer_->invokeCallback();
+
+  EXPECT_CALL(*cm_.subscription_factory_.subscription_,
+              updateResourceInterest(absl::flat_hash_set<std::string>({"fare"})));
+  odcds_->updateOnDemand("fare");
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
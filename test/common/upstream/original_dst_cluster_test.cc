@@ -461,6 +461,44 @@ TEST_F(OriginalDstClusterTest, Connection) {
   host->createConnection(dispatcher_, nullptr, nullptr);
 }
 
+// The requests to a new destination reuse the host created by the load balancer until the
+// cluster added it.
+TEST_F(OriginalDstClusterTest, ReuseCreatedHost) {
+  std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 1.250s
+    type: ORIGINAL_DST
+    lb_policy: CLUSTER_PROVIDED
+  )EOF";
+
+  EXPECT_CALL(initialized_, ready());
+  EXPECT_CALL(*cleanup_timer_, enableTimer(_, _));
+  setupFromYaml(yaml);
+
+  NiceMock<Network::MockConnection> connection;
+  TestLoadBalancerContext lb_context(&connection);
+  connection.stream_info_.downstream_address_provider_->restoreLocalAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("10.10.11.11"));
+
+  OriginalDstCluster::LoadBalancer lb(cluster_);
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  HostConstSharedPtr host = lb.chooseHost(&lb_context);
+  ASSERT_NE(host, nullptr);
+  EXPECT_EQ(host, lb.chooseHost(&lb_context));
+  EXPECT_EQ(host, lb.chooseHost(&lb_context));
+
+  EXPECT_CALL(membership_updated_, ready());
+  post_cb();
+  ASSERT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(host, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+
+  // The load balancer recreated for the update finds the host in the host map.
+  OriginalDstCluster::LoadBalancer lb2(cluster_);
+  EXPECT_CALL(dispatcher_, post(_)).Times(0);
+  EXPECT_EQ(host, lb2.chooseHost(&lb_context));
+}
+
 TEST_F(OriginalDstClusterTest, MultipleClusters) {
   std::string yaml = R"EOF(
     name: name
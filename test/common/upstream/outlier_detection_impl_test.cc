@@ -162,6 +162,10 @@ max_ejection_time: 400s
   EXPECT_EQ(25UL, detector->config().failurePercentageRequestVolume());
   EXPECT_EQ(70UL, detector->config().failurePercentageThreshold());
   EXPECT_EQ(400000UL, detector->config().maxEjectionTimeMs());
+  EXPECT_EQ(300UL, detector->config().latencyThreshold());
+  EXPECT_EQ(0UL, detector->config().enforcingLatency());
+  EXPECT_EQ(5UL, detector->config().latencyMinimumHosts());
+  EXPECT_EQ(100UL, detector->config().latencyRequestVolume());
 }
 
 // Test verifies that detector is properly initialized with
@@ -1207,6 +1211,88 @@ TEST_F(OutlierDetectorImplTest, BasicFlowFailurePercentageExternalOrigin) {
                     DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin));
 }
 
+TEST_F(OutlierDetectorImplTest, BasicFlowLatency) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  envoy::config::cluster::v3::OutlierDetection outlier_detection;
+  outlier_detection.mutable_enforcing_latency()->set_value(100);
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingLatencyRuntime, 100))
+      .WillByDefault(Return(true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, outlier_detection, dispatcher_, runtime_, time_system_, event_logger_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+
+  // The fifth host is ten times slower than the others.
+  for (int i = 0; i < 100; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      hosts_[j]->outlierDetector().putResponseTime(std::chrono::milliseconds(10));
+    }
+    hosts_[4]->outlierDetector().putResponseTime(std::chrono::milliseconds(100));
+  }
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(*event_logger_, logEject(std::static_pointer_cast<const HostDescription>(hosts_[4]),
+                                       _, envoy::data::cluster::v3::LATENCY, true));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  // The response times are the upper bounds of their histogram buckets.
+  EXPECT_EQ(12, hosts_[0]->outlierDetector().latencyMs());
+  EXPECT_EQ(112, hosts_[4]->outlierDetector().latencyMs());
+  EXPECT_EQ(12, detector->latencyMedianMs());
+  EXPECT_FALSE(hosts_[3]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_TRUE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(1UL, outlier_detection_ejections_active_.value());
+  EXPECT_EQ(1UL,
+            cluster_.info_->stats_store_.counter("outlier_detection.ejections_enforced_latency")
+                .value());
+
+  // Too few responses in the next interval.
+  for (size_t j = 0; j < 4; j++) {
+    hosts_[j]->outlierDetector().putResponseTime(std::chrono::milliseconds(10));
+  }
+  time_system_.setMonotonicTime(std::chrono::milliseconds(19999));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(-1, hosts_[0]->outlierDetector().latencyMs());
+  EXPECT_EQ(-1, detector->latencyMedianMs());
+}
+
+// The response times are not recorded unless latency based detection is enforced.
+TEST_F(OutlierDetectorImplTest, LatencyDisabled) {
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_system_, event_logger_));
+
+  for (int i = 0; i < 100; i++) {
+    for (const HostSharedPtr& host : hosts_) {
+      host->outlierDetector().putResponseTime(
+          std::chrono::milliseconds(host == hosts_[0] ? 1000 : 10));
+    }
+  }
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(-1, hosts_[0]->outlierDetector().latencyMs());
+  EXPECT_EQ(-1, detector->latencyMedianMs());
+  EXPECT_EQ(0UL, outlier_detection_ejections_active_.value());
+}
+
 TEST_F(OutlierDetectorImplTest, BasicFlowFailurePercentageLocalOrigin) {
   EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
   addHosts({
@@ -2010,6 +2096,55 @@ TEST(OutlierDetectionEventLoggerImplTest, All) {
       .WillOnce(SaveArg<0>(&log6));
   event_logger.logUneject(host);
   Json::Factory::loadFromString(log6);
+
+  StringViewSaver log7;
+  EXPECT_CALL(host->outlier_detector_, lastUnejectionTime()).WillOnce(ReturnRef(monotonic_time));
+  EXPECT_CALL(host->outlier_detector_, latencyMs()).WillOnce(Return(112));
+  EXPECT_CALL(detector, latencyMedianMs()).WillOnce(Return(12));
+  EXPECT_CALL(*file,
+              write(absl::string_view(
+                  "{\"type\":\"LATENCY\",\"cluster_name\":\"fake_cluster\","
+                  "\"upstream_url\":\"10.0.0.1:443\",\"action\":\"EJECT\","
+                  "\"num_ejections\":0,\"enforced\":true,\"eject_latency_event\":{"
+                  "\"host_latency_ms\":\"112\",\"cluster_median_latency_ms\":\"12\"},"
+                  "\"timestamp\":\"2018-12-18T09:00:00Z\",\"secs_since_last_action\":\"30\"}\n")))
+      .WillOnce(SaveArg<0>(&log7));
+  event_logger.logEject(host, detector, envoy::data::cluster::v3::LATENCY, true);
+  Json::Factory::loadFromString(log7);
+}
+
+TEST(LatencyHistogramTest, Buckets) {
+  EXPECT_EQ(0, LatencyHistogram::bucketIndex(-1));
+  EXPECT_EQ(3, LatencyHistogram::bucketIndex(3));
+  EXPECT_EQ(4, LatencyHistogram::bucketIndex(4));
+  EXPECT_EQ(8, LatencyHistogram::bucketIndex(8));
+  EXPECT_EQ(8, LatencyHistogram::bucketIndex(9));
+  EXPECT_EQ(9, LatencyHistogram::bucketIndex(10));
+  EXPECT_EQ(LatencyHistogram::NumBuckets - 1, LatencyHistogram::bucketIndex(1 << 20));
+  EXPECT_EQ(LatencyHistogram::NumBuckets - 1, LatencyHistogram::bucketIndex(1LL << 40));
+  for (size_t i = 0; i < LatencyHistogram::NumBuckets; i++) {
+    EXPECT_EQ(i, LatencyHistogram::bucketIndex(LatencyHistogram::bucketLowerBoundMs(i)));
+    if (i > 0) {
+      EXPECT_EQ(i - 1, LatencyHistogram::bucketIndex(LatencyHistogram::bucketLowerBoundMs(i) - 1));
+    }
+  }
+}
+
+TEST(LatencyHistogramTest, Quantile) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.quantileMs(0.99));
+
+  for (int i = 0; i < 98; i++) {
+    histogram.record(std::chrono::milliseconds(1));
+  }
+  histogram.record(std::chrono::milliseconds(50));
+  histogram.record(std::chrono::milliseconds(50));
+  EXPECT_EQ(100, histogram.count());
+  EXPECT_EQ(2, histogram.quantileMs(0.5));
+  EXPECT_EQ(56, histogram.quantileMs(0.99));
+
+  histogram.clear();
+  EXPECT_EQ(0, histogram.count());
 }
 
 TEST(OutlierUtility, SRThreshold) {
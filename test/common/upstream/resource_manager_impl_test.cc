@@ -5,6 +5,7 @@
 
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/stats/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -165,6 +166,81 @@ TEST(ResourceManagerImplTest, RetryBudgetOverrideGauge) {
   EXPECT_EQ(0U, stats.remaining_retries_.value());
   rm.retries().dec();
 }
+
+// The retries of the other threads are only accounted for in the budget once the estimate of the
+// thread is reconciled.
+TEST(ResourceManagerImplTest, RetryBudgetReconcilesOtherThreads) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = clusterCircuitBreakersStats(store);
+  ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 1, 2,
+                         1, 0, 3, stats, 0.0, 1);
+
+  EXPECT_TRUE(rm.retries().canCreate());
+  Thread::ThreadPtr thread =
+      Thread::threadFactoryForTest().createThread([&rm]() -> void { rm.retries().inc(); });
+  thread->join();
+  EXPECT_EQ(1U, rm.retries().count());
+
+  // The first decision reconciled the estimate.
+  for (uint32_t i = 1; i < 64; ++i) {
+    EXPECT_TRUE(rm.retries().canCreate());
+  }
+  EXPECT_FALSE(rm.retries().canCreate());
+  EXPECT_EQ(1U, stats.rq_retry_open_.value());
+
+  // The retry is released by another thread than the one that counted it.
+  rm.retries().dec();
+  EXPECT_EQ(0U, rm.retries().count());
+  EXPECT_TRUE(rm.retries().canCreate());
+}
+
+// With a reconcile interval, the limits are checked against the estimate of the calling thread,
+// which only accounts for the resources of the other threads once it's reconciled.
+TEST(ResourceManagerImplTest, ApproximateLimitsReconcileOtherThreads) {
+  NiceMock<Runtime::MockLoader> runtime;
+  Stats::IsolatedStoreImpl store;
+
+  auto stats = clusterCircuitBreakersStats(store);
+  ResourceManagerImpl rm(runtime, "circuit_breakers.runtime_resource_manager_test.default.", 2, 2,
+                         2, 0, 3, stats, absl::nullopt, absl::nullopt, 4);
+
+  EXPECT_TRUE(rm.requests().canCreate());
+  EXPECT_EQ(2U, stats.remaining_rq_.value());
+  rm.requests().inc();
+  Thread::ThreadPtr thread =
+      Thread::threadFactoryForTest().createThread([&rm]() -> void { rm.requests().inc(); });
+  thread->join();
+  EXPECT_EQ(2U, rm.requests().count());
+
+  // The gauges are only updated when the estimate is reconciled.
+  EXPECT_EQ(2U, stats.remaining_rq_.value());
+  EXPECT_EQ(0U, stats.rq_open_.value());
+  for (uint32_t i = 1; i < 4; ++i) {
+    EXPECT_TRUE(rm.requests().canCreate());
+  }
+  EXPECT_FALSE(rm.requests().canCreate());
+  EXPECT_EQ(0U, stats.remaining_rq_.value());
+  EXPECT_EQ(1U, stats.rq_open_.value());
+
+  // The request counted by the other thread is released by this one.
+  rm.requests().decBy(2);
+  EXPECT_EQ(0U, rm.requests().count());
+  EXPECT_TRUE(rm.requests().canCreate());
+
+  // The other limits are sharded too, but not the connection pools.
+  rm.connections().inc();
+  rm.pendingRequests().inc();
+  rm.connectionPools().inc();
+  EXPECT_EQ(1U, rm.connections().count());
+  EXPECT_EQ(1U, rm.pendingRequests().count());
+  EXPECT_EQ(2U, stats.remaining_cx_.value());
+  EXPECT_EQ(2U, stats.remaining_cx_pools_.value());
+  rm.connections().dec();
+  rm.pendingRequests().dec();
+  rm.connectionPools().dec();
+}
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -1311,6 +1311,36 @@ TEST_F(HostImplTest, HealthcheckHostname) {
   EXPECT_EQ("foo", descr.hostnameForHealthChecks());
 }
 
+TEST_F(HostImplTest, PeakEwmaLatencyEstimate) {
+  envoy::config::cluster::v3::Cluster::PeakEwmaLbConfig config;
+  config.mutable_decay_time()->set_seconds(1);
+  config.mutable_default_latency()->set_nanos(5000000);
+  PeakEwmaLatencyEstimate estimate(config);
+  EXPECT_DOUBLE_EQ(5000, estimate.value());
+
+  // The first sample replaces the default, even if it is lower.
+  const MonotonicTime start = simTime().monotonicTime();
+  estimate.observe(std::chrono::milliseconds(2), start);
+  EXPECT_DOUBLE_EQ(2000, estimate.value());
+
+  // Peaks are taken as is.
+  estimate.observe(std::chrono::milliseconds(8), start + std::chrono::milliseconds(1));
+  EXPECT_DOUBLE_EQ(8000, estimate.value());
+
+  // Lower samples are averaged in, weighing the estimate by its age.
+  const MonotonicTime later = start + std::chrono::milliseconds(1001);
+  estimate.observe(std::chrono::milliseconds(2), later);
+  const double decayed = 8000 * std::exp(-1) + 2000 * (1 - std::exp(-1));
+  EXPECT_NEAR(decayed, estimate.value(), 0.001);
+  estimate.observe(std::chrono::milliseconds(2), later);
+  EXPECT_NEAR(decayed, estimate.value(), 0.001);
+}
+
+TEST_F(HostImplTest, PeakEwmaLatencyEstimateDefaults) {
+  PeakEwmaLatencyEstimate estimate(absl::nullopt);
+  EXPECT_DOUBLE_EQ(10000, estimate.value());
+}
+
 class StaticClusterImplTest : public testing::Test, public UpstreamImplTestBase {};
 
 TEST_F(StaticClusterImplTest, InitialHosts) {
@@ -2292,6 +2322,27 @@ TEST_F(ClusterInfoImplTest, Metadata) {
   EXPECT_EQ(LoadBalancerType::Maglev, cluster->info()->lbType());
 }
 
+// Cluster stats are only created once written if deferred stats are enabled.
+TEST_F(ClusterInfoImplTest, DeferredStats) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+  )EOF";
+
+  cm_.deferred_cluster_stats_ = true;
+  auto cluster = makeCluster(yaml);
+  ClusterStats& stats = cluster->info()->stats();
+  EXPECT_EQ(0, stats.upstream_rq_total_.value());
+  EXPECT_FALSE(stats_.findCounterByString("cluster.name.upstream_rq_total").has_value());
+
+  stats.upstream_rq_total_.inc();
+  EXPECT_EQ(1, stats_.counter("cluster.name.upstream_rq_total").value());
+  EXPECT_EQ(1, stats.upstream_rq_total_.value());
+  EXPECT_FALSE(stats_.findCounterByString("cluster.name.upstream_rq_timeout").has_value());
+}
+
 // Verify retry budget default values are honored.
 TEST_F(ClusterInfoImplTest, RetryBudgetDefaultPopulation) {
   std::string yaml = R"EOF(
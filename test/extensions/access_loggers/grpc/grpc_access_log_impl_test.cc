@@ -123,6 +123,48 @@ tcp_logs:
   logger_->log(envoy::data::accesslog::v3::TCPAccessLogEntry(tcp_entry));
 }
 
+// The first message of the stream, which carries the identifier, is prepared for the wire, and the
+// next ones only carry the log entries.
+TEST(GrpcAccessLoggerImplV3Test, PrepareIdentifierForWire) {
+  LocalInfo::MockLocalInfo local_info;
+  local_info.node_.set_hidden_envoy_deprecated_build_version("build_version");
+  Event::MockDispatcher dispatcher;
+  auto* timer = new Event::MockTimer(&dispatcher);
+  EXPECT_CALL(*timer, enableTimer(_, _));
+  auto* async_client = new Grpc::MockAsyncClient;
+  GrpcAccessLoggerImplTestHelper helper(local_info, async_client);
+  Stats::IsolatedStoreImpl stats_store;
+  GrpcAccessLoggerImpl logger(Grpc::RawAsyncClientPtr{async_client}, "test_log_name",
+                              FlushInterval, BUFFER_SIZE_BYTES, dispatcher, local_info,
+                              stats_store, envoy::config::core::v3::ApiVersion::V3);
+
+  helper.expectStreamMessage(R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+http_logs:
+  log_entry:
+    request:
+      path: /test/path1
+)EOF");
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path("/test/path1");
+  logger.log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+
+  helper.expectStreamMessage(R"EOF(
+http_logs:
+  log_entry:
+    request:
+      path: /test/path2
+)EOF");
+  entry.mutable_request()->set_path("/test/path2");
+  logger.log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+}
+
 class GrpcAccessLoggerCacheImplTest : public testing::Test {
 public:
   GrpcAccessLoggerCacheImplTest()
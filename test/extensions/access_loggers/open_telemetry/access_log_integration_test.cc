@@ -132,9 +132,18 @@ public:
     Config::VersionUtil::scrubHiddenEnvoyDeprecated(expected_request_msg);
     EXPECT_TRUE(TestUtility::protoEqual(request_msg, expected_request_msg,
                                         /*ignore_repeated_field_ordering=*/false));
+    // Each export is a unary request.
+    VERIFY_ASSERTION(access_log_request_->waitForEndStream(*dispatcher_));
     return AssertionSuccess();
   }
 
+  void sendAccessLogResponse() {
+    access_log_request_->startGrpcStream();
+    opentelemetry::proto::collector::logs::v1::ExportLogsServiceResponse response_msg;
+    access_log_request_->sendGrpcMessage(response_msg);
+    access_log_request_->finishGrpcStream(Grpc::Status::Ok);
+  }
+
   void cleanup() {
     if (fake_access_log_connection_ != nullptr) {
       AssertionResult result = fake_access_log_connection_->close();
@@ -159,25 +168,22 @@ TEST_P(AccessLogIntegrationTest, BasicAccessLogFlow) {
   ASSERT_TRUE(waitForAccessLogConnection());
   ASSERT_TRUE(waitForAccessLogStream());
   ASSERT_TRUE(waitForAccessLogRequest(EXPECTED_REQUEST_MESSAGE));
+  sendAccessLogResponse();
 
+  // The next export is sent with a new request once the previous one completed.
   BufferingStreamDecoderPtr response = IntegrationUtil::makeSingleRequest(
       lookupPort("http"), "GET", "/notfound", "", downstream_protocol_, version_);
   EXPECT_TRUE(response->complete());
   EXPECT_EQ("404", response->headers().getStatusValue());
+  ASSERT_TRUE(waitForAccessLogStream());
   ASSERT_TRUE(waitForAccessLogRequest(EXPECTED_REQUEST_MESSAGE));
-
-  // Send an empty response and end the stream. This should never happen but make sure nothing
-  // breaks and we make a new stream on a follow up request.
-  access_log_request_->startGrpcStream();
-  opentelemetry::proto::collector::logs::v1::ExportLogsServiceResponse response_msg;
-  access_log_request_->sendGrpcMessage(response_msg);
-  access_log_request_->finishGrpcStream(Grpc::Status::Ok);
+  sendAccessLogResponse();
   switch (clientType()) {
   case Grpc::ClientType::EnvoyGrpc:
     test_server_->waitForGaugeEq("cluster.accesslog.upstream_rq_active", 0);
     break;
   case Grpc::ClientType::GoogleGrpc:
-    test_server_->waitForCounterGe("grpc.accesslog.streams_closed_0", 1);
+    test_server_->waitForCounterGe("grpc.accesslog.streams_closed_0", 2);
     break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
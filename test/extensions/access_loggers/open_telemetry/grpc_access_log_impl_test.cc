@@ -20,7 +20,6 @@
 using testing::_;
 using testing::Invoke;
 using testing::NiceMock;
-using testing::Return;
 using testing::ReturnRef;
 
 namespace Envoy {
@@ -35,43 +34,46 @@ const std::string ZONE_NAME = "zone_name";
 const std::string CLUSTER_NAME = "cluster_name";
 const std::string NODE_NAME = "node_name";
 
-// A helper test class to mock and intercept GrpcAccessLoggerImpl streams.
+// A helper test class to mock and intercept GrpcAccessLoggerImpl export requests.
 class GrpcAccessLoggerImplTestHelper {
 public:
-  using MockAccessLogStream = Grpc::MockAsyncStream;
-  using AccessLogCallbacks = Grpc::AsyncStreamCallbacks<
-      opentelemetry::proto::collector::logs::v1::ExportLogsServiceResponse>;
-
   GrpcAccessLoggerImplTestHelper(LocalInfo::MockLocalInfo& local_info,
-                                 Grpc::MockAsyncClient* async_client) {
+                                 Grpc::MockAsyncClient* async_client)
+      : async_client_(async_client) {
     EXPECT_CALL(local_info, zoneName()).WillOnce(ReturnRef(ZONE_NAME));
     EXPECT_CALL(local_info, clusterName()).WillOnce(ReturnRef(CLUSTER_NAME));
     EXPECT_CALL(local_info, nodeName()).WillOnce(ReturnRef(NODE_NAME));
-    EXPECT_CALL(*async_client, startRaw(_, _, _, _))
-        .WillOnce(
-            Invoke([this](absl::string_view, absl::string_view, Grpc::RawAsyncStreamCallbacks& cbs,
-                          const Http::AsyncClient::StreamOptions&) {
-              this->callbacks_ = dynamic_cast<AccessLogCallbacks*>(&cbs);
-              return &this->stream_;
-            }));
   }
 
-  void expectStreamMessage(const std::string& expected_message_yaml) {
+  void expectSentMessage(const std::string& expected_message_yaml) {
     opentelemetry::proto::collector::logs::v1::ExportLogsServiceRequest expected_message;
     TestUtility::loadFromYaml(expected_message_yaml, expected_message);
-    EXPECT_CALL(stream_, isAboveWriteBufferHighWatermark()).WillOnce(Return(false));
-    EXPECT_CALL(stream_, sendMessageRaw_(_, false))
-        .WillOnce(Invoke([expected_message](Buffer::InstancePtr& request, bool) {
+    EXPECT_CALL(*async_client_, sendRaw(_, _, _, _, _, _))
+        .WillOnce(Invoke([this, expected_message](
+                             absl::string_view service_full_name, absl::string_view method_name,
+                             Buffer::InstancePtr&& request, Grpc::RawAsyncRequestCallbacks& cbs,
+                             Tracing::Span&, const Http::AsyncClient::RequestOptions&) {
+          EXPECT_EQ("opentelemetry.proto.collector.logs.v1.LogsService", service_full_name);
+          EXPECT_EQ("Export", method_name);
           opentelemetry::proto::collector::logs::v1::ExportLogsServiceRequest message;
           Buffer::ZeroCopyInputStreamImpl request_stream(std::move(request));
           EXPECT_TRUE(message.ParseFromZeroCopyStream(&request_stream));
           EXPECT_EQ(message.DebugString(), expected_message.DebugString());
+          callbacks_ = &cbs;
+          return &request_;
         }));
   }
 
+  // Fails the last export request.
+  void failRequest() {
+    callbacks_->onFailure(Grpc::Status::WellKnownGrpcStatus::Unavailable, "",
+                          Tracing::NullSpan::instance());
+  }
+
 private:
-  MockAccessLogStream stream_;
-  AccessLogCallbacks* callbacks_;
+  Grpc::MockAsyncClient* async_client_;
+  NiceMock<Grpc::MockAsyncRequest> request_;
+  Grpc::RawAsyncRequestCallbacks* callbacks_{};
 };
 
 class GrpcAccessLoggerImplTest : public testing::Test {
@@ -82,7 +84,7 @@ public:
     EXPECT_CALL(*timer_, enableTimer(_, _));
     logger_ = std::make_unique<GrpcAccessLoggerImpl>(
         Grpc::RawAsyncClientPtr{async_client_}, "test_log_name", FlushInterval, BUFFER_SIZE_BYTES,
-        dispatcher_, local_info_, stats_store_, envoy::config::core::v3::ApiVersion::V3);
+        dispatcher_, local_info_, stats_store_, envoy::config::core::v3::ApiVersion::V3, 1);
   }
 
   Grpc::MockAsyncClient* async_client_;
@@ -90,12 +92,13 @@ public:
   LocalInfo::MockLocalInfo local_info_;
   Event::MockDispatcher dispatcher_;
   Event::MockTimer* timer_;
-  std::unique_ptr<GrpcAccessLoggerImpl> logger_;
+  // Outlives the logger, which cancels its pending request.
   GrpcAccessLoggerImplTestHelper grpc_access_logger_impl_test_helper_;
+  std::unique_ptr<GrpcAccessLoggerImpl> logger_;
 };
 
 TEST_F(GrpcAccessLoggerImplTest, LogHttp) {
-  grpc_access_logger_impl_test_helper_.expectStreamMessage(R"EOF(
+  grpc_access_logger_impl_test_helper_.expectSentMessage(R"EOF(
   resource_logs:
     resource:
       attributes:
@@ -121,7 +124,7 @@ TEST_F(GrpcAccessLoggerImplTest, LogHttp) {
 }
 
 TEST_F(GrpcAccessLoggerImplTest, LogTcp) {
-  grpc_access_logger_impl_test_helper_.expectStreamMessage(R"EOF(
+  grpc_access_logger_impl_test_helper_.expectSentMessage(R"EOF(
   resource_logs:
     resource:
       attributes:
@@ -146,12 +149,53 @@ TEST_F(GrpcAccessLoggerImplTest, LogTcp) {
   logger_->log(opentelemetry::proto::logs::v1::LogRecord(entry));
 }
 
+// The entries logged while the export request is pending are sent in the next one.
+TEST_F(GrpcAccessLoggerImplTest, PendingExportRequest) {
+  const std::string expected_message_format = R"EOF(
+  resource_logs:
+    resource:
+      attributes:
+        - key: "log_name"
+          value:
+            string_value: "test_log_name"
+        - key: "zone_name"
+          value:
+            string_value: "zone_name"
+        - key: "cluster_name"
+          value:
+            string_value: "cluster_name"
+        - key: "node_name"
+          value:
+            string_value: "node_name"
+    instrumentation_library_logs:
+      - logs:
+{}
+  )EOF";
+  grpc_access_logger_impl_test_helper_.expectSentMessage(
+      fmt::format(expected_message_format, R"EOF(
+          - severity_text: "first")EOF"));
+  opentelemetry::proto::logs::v1::LogRecord entry;
+  entry.set_severity_text("first");
+  logger_->log(opentelemetry::proto::logs::v1::LogRecord(entry));
+
+  entry.set_severity_text("second");
+  logger_->log(opentelemetry::proto::logs::v1::LogRecord(entry));
+
+  grpc_access_logger_impl_test_helper_.failRequest();
+  grpc_access_logger_impl_test_helper_.expectSentMessage(
+      fmt::format(expected_message_format, R"EOF(
+          - severity_text: "second"
+          - severity_text: "third")EOF"));
+  entry.set_severity_text("third");
+  logger_->log(opentelemetry::proto::logs::v1::LogRecord(entry));
+}
+
 class GrpcAccessLoggerCacheImplTest : public testing::Test {
 public:
   GrpcAccessLoggerCacheImplTest()
       : async_client_(new Grpc::MockAsyncClient), factory_(new Grpc::MockAsyncClientFactory),
-        logger_cache_(async_client_manager_, scope_, tls_, local_info_),
-        grpc_access_logger_impl_test_helper_(local_info_, async_client_) {
+        grpc_access_logger_impl_test_helper_(local_info_, async_client_),
+        logger_cache_(async_client_manager_, scope_, tls_, local_info_) {
     EXPECT_CALL(async_client_manager_, factoryForGrpcService(_, _, false))
         .WillOnce(Invoke([this](const envoy::config::core::v3::GrpcService&, Stats::Scope&, bool) {
           EXPECT_CALL(*factory_, create()).WillOnce(Invoke([this] {
@@ -165,10 +209,11 @@ public:
   Grpc::MockAsyncClientFactory* factory_;
   Grpc::MockAsyncClientManager async_client_manager_;
   LocalInfo::MockLocalInfo local_info_;
+  // Outlives the loggers of the thread local cache, which cancel their pending requests.
+  GrpcAccessLoggerImplTestHelper grpc_access_logger_impl_test_helper_;
   NiceMock<Stats::MockIsolatedStatsStore> scope_;
   NiceMock<ThreadLocal::MockInstance> tls_;
   GrpcAccessLoggerCacheImpl logger_cache_;
-  GrpcAccessLoggerImplTestHelper grpc_access_logger_impl_test_helper_;
 };
 
 // Test that the logger is created according to the config (by inspecting the generated log).
@@ -181,7 +226,7 @@ TEST_F(GrpcAccessLoggerCacheImplTest, LoggerCreation) {
 
   GrpcAccessLoggerSharedPtr logger = logger_cache_.getOrCreateLogger(
       config, envoy::config::core::v3::ApiVersion::V3, Common::GrpcAccessLoggerType::HTTP, scope_);
-  grpc_access_logger_impl_test_helper_.expectStreamMessage(R"EOF(
+  grpc_access_logger_impl_test_helper_.expectSentMessage(R"EOF(
   resource_logs:
     resource:
       attributes:
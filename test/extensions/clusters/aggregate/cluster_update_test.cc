@@ -241,6 +241,53 @@ TEST_F(AggregateClusterUpdateTest, LoadBalancingTest) {
   }
 }
 
+// The host updates of a cluster which keep its hosts in the same priorities update the merged
+// priority set in place.
+TEST_F(AggregateClusterUpdateTest, HostUpdatesInSamePriorities) {
+  initialize(default_yaml_config_);
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(Upstream::defaultStaticCluster("primary"), ""));
+  auto primary = cluster_manager_->getThreadLocalCluster("primary");
+  EXPECT_NE(nullptr, primary);
+  EXPECT_TRUE(
+      cluster_manager_->addOrUpdateCluster(Upstream::defaultStaticCluster("secondary"), ""));
+  auto secondary = cluster_manager_->getThreadLocalCluster("secondary");
+  EXPECT_NE(nullptr, secondary);
+
+  auto update_hosts = [this](const std::string& name, const Upstream::HostVector& hosts,
+                             const Upstream::HostVector& hosts_removed) {
+    Upstream::Cluster& cluster = cluster_manager_->activeClusters().find(name)->second;
+    cluster.prioritySet().updateHosts(
+        0,
+        Upstream::HostSetImpl::partitionHosts(std::make_shared<Upstream::HostVector>(hosts),
+                                              Upstream::HostsPerLocalityImpl::empty()),
+        nullptr, hosts, hosts_removed, 100);
+  };
+
+  Upstream::HostSharedPtr host1 =
+      Upstream::makeTestHost(primary->info(), "tcp://127.0.0.1:80", simTime());
+  Upstream::HostSharedPtr host2 =
+      Upstream::makeTestHost(secondary->info(), "tcp://127.0.0.2:80", simTime());
+  update_hosts("primary", {host1}, {});
+  update_hosts("secondary", {host2}, {});
+  EXPECT_CALL(factory_.random_, random()).WillRepeatedly(Return(50));
+  EXPECT_EQ(host1, cluster_->loadBalancer().chooseHost(nullptr));
+
+  // The new host of the primary cluster replaces the old one.
+  Upstream::HostSharedPtr host3 =
+      Upstream::makeTestHost(primary->info(), "tcp://127.0.0.3:80", simTime());
+  update_hosts("primary", {host3}, {host1});
+  EXPECT_EQ(host3, cluster_->loadBalancer().chooseHost(nullptr));
+
+  // The priority loads are recalculated once the primary cluster has no healthy host.
+  host3->healthFlagSet(Upstream::HostImpl::HealthFlag::FAILED_ACTIVE_HC);
+  update_hosts("primary", {host3}, {});
+  EXPECT_EQ(host2, cluster_->loadBalancer().chooseHost(nullptr));
+
+  // Without hosts in the primary cluster, the priority set is linearized again.
+  update_hosts("primary", {}, {host3});
+  EXPECT_EQ(host2, cluster_->loadBalancer().chooseHost(nullptr));
+}
+
 TEST_F(AggregateClusterUpdateTest, InitializeAggregateClusterAfterOtherClusters) {
   const std::string config = R"EOF(
  static_resources:
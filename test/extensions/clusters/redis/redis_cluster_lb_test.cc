@@ -382,6 +382,41 @@ TEST_F(RedisClusterLoadBalancerTest, ClusterSlotNoUpdate) {
   validateAssignment(hosts, expected_assignments);
 }
 
+// A MOVED redirection to a known primary moves its slot in the load balancers that already exist.
+TEST_F(RedisClusterLoadBalancerTest, MovedRedirection) {
+  Upstream::HostVector hosts{Upstream::makeTestHost(info_, "tcp://127.0.0.1:90", simTime()),
+                             Upstream::makeTestHost(info_, "tcp://127.0.0.1:91", simTime())};
+  std::vector<ClusterSlot> slots{ClusterSlot(0, 1000, hosts[0]->address()),
+                                 ClusterSlot(1001, 16383, hosts[1]->address())};
+  Upstream::HostMap all_hosts = generateHostMap(hosts);
+  init();
+  EXPECT_FALSE(factory_->onMovedRedirection(100, hosts[1]->address()->asString()));
+  EXPECT_TRUE(
+      factory_->onClusterSlotUpdate(std::make_unique<std::vector<ClusterSlot>>(slots), all_hosts));
+
+  Upstream::LoadBalancerPtr lb = lb_->factory()->create();
+  auto* handler = dynamic_cast<MovedRedirectionHandler*>(lb.get());
+  ASSERT_NE(nullptr, handler);
+  EXPECT_TRUE(handler->onMovedRedirection(100, hosts[1]->address()->asString()));
+  // Applying the same redirection again is a no-op.
+  EXPECT_TRUE(handler->onMovedRedirection(100, hosts[1]->address()->asString()));
+  EXPECT_FALSE(handler->onMovedRedirection(101, "127.0.0.1:92"));
+  EXPECT_FALSE(handler->onMovedRedirection(MaxSlot, hosts[1]->address()->asString()));
+
+  TestLoadBalancerContext moved_context(100, false,
+                                        NetworkFilters::Common::Redis::Client::ReadPolicy::Primary);
+  EXPECT_EQ(hosts[1], lb->chooseHost(&moved_context));
+  TestLoadBalancerContext context(101, false,
+                                  NetworkFilters::Common::Redis::Client::ReadPolicy::Primary);
+  EXPECT_EQ(hosts[0], lb->chooseHost(&context));
+  validateAssignment(hosts, {{100, 1}, {101, 0}, {1100, 1}});
+
+  // A refresh of the topology rebuilds the slots even though they are unchanged.
+  EXPECT_TRUE(
+      factory_->onClusterSlotUpdate(std::make_unique<std::vector<ClusterSlot>>(slots), all_hosts));
+  EXPECT_EQ(hosts[0], lb->chooseHost(&moved_context));
+}
+
 TEST_F(RedisLoadBalancerContextImplTest, Basic) {
   // Simple read command
   std::vector<NetworkFilters::Common::Redis::RespValue> get_foo(2);
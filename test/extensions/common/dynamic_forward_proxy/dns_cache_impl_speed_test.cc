@@ -0,0 +1,114 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/extensions/common/dynamic_forward_proxy/mocks.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using ::benchmark::State;
+using Envoy::benchmark::skipExpensiveBenchmarks;
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace DynamicForwardProxy {
+
+// A DNS cache whose hosts are all resolved, shared by the threads of the benchmarks. The mock
+// thread local instance gives all the threads the same thread local host map, which they only
+// read.
+class DnsCacheSpeedTest {
+public:
+  explicit DnsCacheSpeedTest(uint32_t num_hosts) {
+    // Leaked, see get().
+    testing::Mock::AllowLeak(&dispatcher_);
+    testing::Mock::AllowLeak(resolver_.get());
+    ON_CALL(dispatcher_, createDnsResolver(_, _)).WillByDefault(Return(resolver_));
+    ON_CALL(*resolver_, resolve(_, _, _))
+        .WillByDefault(Invoke([](const std::string&, Network::DnsLookupFamily,
+                                 Network::DnsResolver::ResolveCb callback) {
+          callback(Network::DnsResolver::ResolutionStatus::Success,
+                   TestUtility::makeDnsResponse({"10.0.0.1"}));
+          return nullptr;
+        }));
+    envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config;
+    config.set_name("speed_test");
+    config.mutable_max_hosts()->set_value(num_hosts);
+    dns_cache_ =
+        std::make_unique<DnsCacheImpl>(dispatcher_, tls_, random_, loader_, store_, config);
+
+    hosts_.reserve(num_hosts);
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      hosts_.push_back(fmt::format("host{}.example.com", i));
+      // The main thread dispatcher of the mock runs the resolution inline.
+      dns_cache_->loadDnsCacheEntry(hosts_.back(), 80, callbacks_);
+    }
+  }
+
+  static DnsCacheSpeedTest& get() {
+    // Shared by all the benchmark threads, and leaked so that its destruction doesn't race with
+    // threads still finishing up.
+    static auto* speed_test = new DnsCacheSpeedTest(skipExpensiveBenchmarks() ? 100 : 100000);
+    return *speed_test;
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::shared_ptr<Network::MockDnsResolver> resolver_{
+      std::make_shared<NiceMock<Network::MockDnsResolver>>()};
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Runtime::MockLoader> loader_;
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<MockLoadDnsCacheEntryCallbacks> callbacks_;
+  std::unique_ptr<DnsCacheImpl> dns_cache_;
+  std::vector<std::string> hosts_;
+};
+
+} // namespace DynamicForwardProxy
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
+
+// Measures the cache hits of the workers, answered from their thread local host map.
+static void loadDnsCacheEntry(State& state) {
+  auto& speed_test = Envoy::Extensions::Common::DynamicForwardProxy::DnsCacheSpeedTest::get();
+  const auto& hosts = speed_test.hosts_;
+  size_t i = state.thread_index;
+  for (auto _ : state) {
+    auto result = speed_test.dns_cache_->loadDnsCacheEntry(hosts[i % hosts.size()], 80,
+                                                           speed_test.callbacks_);
+    ::benchmark::DoNotOptimize(result);
+    i += 7919;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(loadDnsCacheEntry)->Threads(1)->Threads(4)->Threads(16);
+
+// Measures the lookups of the sharded host map, as done by getHost().
+static void getHost(State& state) {
+  auto& speed_test = Envoy::Extensions::Common::DynamicForwardProxy::DnsCacheSpeedTest::get();
+  const auto& hosts = speed_test.hosts_;
+  size_t i = state.thread_index;
+  for (auto _ : state) {
+    auto host_info = speed_test.dns_cache_->getHost(hosts[i % hosts.size()]);
+    ::benchmark::DoNotOptimize(host_info);
+    i += 7919;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(getHost)->Threads(1)->Threads(4)->Threads(16);
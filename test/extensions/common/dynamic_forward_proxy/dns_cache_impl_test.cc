@@ -625,6 +625,47 @@ TEST_F(DnsCacheImplTest, MultipleResolveDifferentHost) {
   EXPECT_EQ(dns_cache_->getHost("baz.com"), absl::nullopt);
 }
 
+// The resolutions beyond max_concurrent_resolutions wait for the ones in flight.
+TEST_F(DnsCacheImplTest, MaxConcurrentResolutions) {
+  config_.mutable_max_concurrent_resolutions()->set_value(1);
+  initialize();
+  InSequence s;
+
+  MockLoadDnsCacheEntryCallbacks callbacks1;
+  Network::DnsResolver::ResolveCb resolve_cb1;
+  EXPECT_CALL(*resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb1), Return(&resolver_->active_query_)));
+  auto result1 = dns_cache_->loadDnsCacheEntry("foo.com", 80, callbacks1);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result1.status_);
+
+  MockLoadDnsCacheEntryCallbacks callbacks2;
+  auto result2 = dns_cache_->loadDnsCacheEntry("bar.com", 443, callbacks2);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result2.status_);
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.dns_query_queued")->value());
+  checkStats(1 /* attempt */, 0 /* success */, 0 /* failure */, 0 /* address changed */,
+             2 /* added */, 0 /* removed */, 2 /* num hosts */);
+
+  // The completion of the first resolution starts the queued one.
+  EXPECT_CALL(update_callbacks_,
+              onDnsHostAddOrUpdate("foo.com", DnsHostInfoEquals("10.0.0.1:80", "foo.com", false)));
+  EXPECT_CALL(callbacks1,
+              onLoadDnsCacheComplete(DnsHostInfoEquals("10.0.0.1:80", "foo.com", false)));
+  Network::DnsResolver::ResolveCb resolve_cb2;
+  EXPECT_CALL(*resolver_, resolve("bar.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb2), Return(&resolver_->active_query_)));
+  resolve_cb1(Network::DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.1"}));
+
+  EXPECT_CALL(update_callbacks_,
+              onDnsHostAddOrUpdate("bar.com", DnsHostInfoEquals("10.0.0.2:443", "bar.com", false)));
+  EXPECT_CALL(callbacks2,
+              onLoadDnsCacheComplete(DnsHostInfoEquals("10.0.0.2:443", "bar.com", false)));
+  resolve_cb2(Network::DnsResolver::ResolutionStatus::Success,
+              TestUtility::makeDnsResponse({"10.0.0.2"}));
+  checkStats(2 /* attempt */, 2 /* success */, 0 /* failure */, 2 /* address changed */,
+             2 /* added */, 0 /* removed */, 2 /* num hosts */);
+}
+
 // A successful resolve followed by a cache hit.
 TEST_F(DnsCacheImplTest, CacheHit) {
   initialize();
@@ -8,6 +8,11 @@
 
 #include "extensions/common/tap/tap_config_base.h"
 
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/common/tap/common.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -161,6 +166,107 @@ TEST(TrimSlice, All) {
   }
 }
 
+class TestTapConfig : public TapConfigBaseImpl {
+public:
+  TestTapConfig(const envoy::config::tap::v3::TapConfig& proto_config, Api::Api& api,
+                Stats::Scope& scope)
+      : TapConfigBaseImpl(proto_config, nullptr, api, scope) {}
+
+  using TapConfigBaseImpl::tapEnabled;
+};
+
+envoy::config::tap::v3::TapConfig makeTapConfig(const std::string& sink_yaml) {
+  envoy::config::tap::v3::TapConfig proto_config;
+  TestUtility::loadFromYaml(fmt::format(R"EOF(
+match:
+  any_match: true
+output_config:
+  sinks:
+  - {}
+)EOF",
+                                        sink_yaml),
+                            proto_config);
+  return proto_config;
+}
+
+TEST(TapConfigBaseImpl, TapEnabled) {
+  Stats::TestUtil::TestStore store;
+  Api::ApiPtr api = Api::createApiForTest(store);
+  envoy::config::tap::v3::TapConfig proto_config = makeTapConfig(fmt::format(
+      "file_per_tap: {{path_prefix: {}}}", TestEnvironment::temporaryPath("tap_enabled")));
+
+  // Everything is tapped without tap_enabled.
+  EXPECT_TRUE(TestTapConfig(proto_config, *api, store).tapEnabled());
+
+  proto_config.mutable_tap_enabled()->set_runtime_key("tap.enabled");
+  proto_config.mutable_tap_enabled()->mutable_default_value()->set_numerator(0);
+  EXPECT_FALSE(TestTapConfig(proto_config, *api, store).tapEnabled());
+
+  proto_config.mutable_tap_enabled()->mutable_default_value()->set_numerator(100);
+  EXPECT_TRUE(TestTapConfig(proto_config, *api, store).tapEnabled());
+}
+
+TEST(StreamingFileSink, WritesTraces) {
+  Stats::TestUtil::TestStore store;
+  Api::ApiPtr api = Api::createApiForTest(store);
+  const std::string path = TestEnvironment::temporaryPath("streaming_file_sink_writes");
+  TestEnvironment::removePath(path);
+
+  envoy::config::tap::v3::StreamingFileSink config;
+  config.set_path(path);
+  {
+    StreamingFileSink sink(config, *api, store);
+    for (uint64_t trace_id = 1; trace_id <= 2; ++trace_id) {
+      TraceWrapperPtr trace = makeTraceWrapper();
+      trace->mutable_http_streamed_trace_segment()->set_trace_id(trace_id);
+      sink.createPerTapSinkHandle(trace_id)->submitTrace(
+          std::move(trace), envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+    }
+  }
+
+  // The sink writes the pending traces before being destroyed.
+  const auto traces = readTracesFromFile(path);
+  ASSERT_EQ(2, traces.size());
+  EXPECT_EQ(1, traces[0].http_streamed_trace_segment().trace_id());
+  EXPECT_EQ(2, traces[1].http_streamed_trace_segment().trace_id());
+  EXPECT_EQ(2, store.counter("tap.streaming_file_sink.traces_written").value());
+  EXPECT_EQ(0, store.counter("tap.streaming_file_sink.traces_dropped").value());
+}
+
+TEST(StreamingFileSink, DropsTracesAboveMaxBufferedBytes) {
+  Stats::TestUtil::TestStore store;
+  Api::ApiPtr api = Api::createApiForTest(store);
+  const std::string path = TestEnvironment::temporaryPath("streaming_file_sink_drops");
+  TestEnvironment::removePath(path);
+
+  envoy::config::tap::v3::StreamingFileSink config;
+  config.set_path(path);
+  config.mutable_max_buffered_bytes()->set_value(1);
+  {
+    StreamingFileSink sink(config, *api, store);
+    TraceWrapperPtr trace = makeTraceWrapper();
+    trace->mutable_http_streamed_trace_segment()->set_trace_id(1);
+    sink.createPerTapSinkHandle(1)->submitTrace(
+        std::move(trace), envoy::config::tap::v3::OutputSink::PROTO_BINARY_LENGTH_DELIMITED);
+  }
+
+  EXPECT_TRUE(readTracesFromFile(path).empty());
+  EXPECT_EQ(0, store.counter("tap.streaming_file_sink.traces_written").value());
+  EXPECT_EQ(1, store.counter("tap.streaming_file_sink.traces_dropped").value());
+}
+
+// The streaming file sink only writes length delimited protos.
+TEST(StreamingFileSink, RequiresLengthDelimitedFormat) {
+  Stats::TestUtil::TestStore store;
+  Api::ApiPtr api = Api::createApiForTest(store);
+  envoy::config::tap::v3::TapConfig proto_config =
+      makeTapConfig(fmt::format("streaming_file: {{path: {}}}",
+                                TestEnvironment::temporaryPath("streaming_file_sink_format")));
+  EXPECT_THROW_WITH_MESSAGE(
+      TestTapConfig(proto_config, *api, store), EnvoyException,
+      "streaming file output only supports the PROTO_BINARY_LENGTH_DELIMITED format");
+}
+
 } // namespace
 } // namespace Tap
 } // namespace Common
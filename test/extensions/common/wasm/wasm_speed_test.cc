@@ -3,6 +3,7 @@
 
 #include "extensions/common/wasm/wasm.h"
 
+#include "test/mocks/http/mocks.h"
 #include "test/mocks/server/mocks.h"
 #include "test/mocks/upstream/mocks.h"
 #include "test/test_common/environment.h"
@@ -64,6 +65,71 @@ void bmWasmSpeedTest(benchmark::State& state) {
 
 BENCHMARK(bmWasmSpeedTest);
 
+// A context whose request headers are set without running a plugin.
+class HeaderMapContext : public Envoy::Extensions::Common::Wasm::Context {
+public:
+  using Envoy::Extensions::Common::Wasm::Context::Context;
+  void setRequestHeaders(Envoy::Http::RequestHeaderMap* headers) { request_headers_ = headers; }
+};
+
+// Reads and rewrites every request header of a header heavy request, either one at a time as with
+// proxy_get_header_map_value and proxy_replace_header_map_value, or all at once as with
+// proxy_get_header_map_pairs and proxy_set_header_map_pairs. The values are copied, as they would
+// be into and out of the VM memory.
+void bmWasmHeaderMap(benchmark::State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  Envoy::Logger::Registry::getLog(Envoy::Logger::Id::wasm).set_level(spdlog::level::off);
+  Envoy::Stats::IsolatedStoreImpl stats_store;
+  Envoy::Api::ApiPtr api = Envoy::Api::createApiForTest(stats_store);
+  Envoy::Upstream::MockClusterManager cluster_manager;
+  Envoy::Event::DispatcherPtr dispatcher(api->allocateDispatcher("wasm_test"));
+  auto scope = Envoy::Stats::ScopeSharedPtr(stats_store.createScope("wasm."));
+
+  envoy::extensions::wasm::v3::PluginConfig plugin_config;
+  *plugin_config.mutable_vm_config()->mutable_runtime() = "envoy.wasm.runtime.null";
+  auto config = Envoy::Extensions::Common::Wasm::WasmConfig(plugin_config);
+  auto wasm = std::make_unique<Envoy::Extensions::Common::Wasm::Wasm>(config, "", scope,
+                                                                      cluster_manager, *dispatcher);
+
+  testing::NiceMock<Envoy::Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  auto context = std::make_shared<HeaderMapContext>(wasm.get());
+  context->setDecoderFilterCallbacks(decoder_callbacks);
+  Envoy::Http::TestRequestHeaderMapImpl headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  std::vector<std::string> keys;
+  for (int i = 0; i < 20; i++) {
+    headers.addCopy(Envoy::Http::LowerCaseString(absl::StrCat("x-header-", i)), "value");
+  }
+  headers.iterate([&keys](const Envoy::Http::HeaderEntry& header) {
+    keys.emplace_back(header.key().getStringView());
+    return Envoy::Http::HeaderMap::Iterate::Continue;
+  });
+  context->setRequestHeaders(&headers);
+  const bool all_at_once = state.range(0);
+
+  for (__attribute__((unused)) auto _ : state) {
+    if (all_at_once) {
+      Envoy::Extensions::Common::Wasm::Pairs pairs;
+      context->getHeaderMapPairs(proxy_wasm::WasmHeaderMapType::RequestHeaders, &pairs);
+      const std::vector<std::pair<std::string, std::string>> copies(pairs.begin(), pairs.end());
+      context->setHeaderMapPairs(proxy_wasm::WasmHeaderMapType::RequestHeaders,
+                                 Envoy::Extensions::Common::Wasm::Pairs(copies.begin(),
+                                                                        copies.end()));
+    } else {
+      for (const std::string& key : keys) {
+        absl::string_view value;
+        context->getHeaderMapValue(proxy_wasm::WasmHeaderMapType::RequestHeaders, key, &value);
+        const std::string copy(value);
+        context->replaceHeaderMapValue(proxy_wasm::WasmHeaderMapType::RequestHeaders, key, copy);
+      }
+    }
+  }
+}
+
+BENCHMARK(bmWasmHeaderMap)->Arg(false)->Arg(true);
+
 } // namespace Envoy
 
 int main(int argc, char** argv) {
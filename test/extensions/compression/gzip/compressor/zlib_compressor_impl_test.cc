@@ -4,6 +4,7 @@
 #include "extensions/compression/gzip/compressor/config.h"
 #include "extensions/compression/gzip/compressor/zlib_compressor_impl.h"
 
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/container/fixed_array.h"
@@ -151,8 +152,9 @@ TEST_P(ZlibCompressorImplFactoryTest, CreateCompressorTest) {
                        strategy, compression_level);
   }
   TestUtility::loadFromJson(json, gzip);
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
   Envoy::Compression::Compressor::CompressorPtr compressor =
-      GzipCompressorFactory(gzip).createCompressor();
+      GzipCompressorFactory(gzip, tls).createCompressor();
   // Check the created compressor produces valid output.
   TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
   compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
@@ -160,6 +162,30 @@ TEST_P(ZlibCompressorImplFactoryTest, CreateCompressorTest) {
   drainBuffer(buffer);
 }
 
+// Verifies that the pooled compressors are reset before being reused by another stream.
+TEST(ZlibCompressorPoolTest, ReuseCompressor) {
+  envoy::extensions::compression::gzip::compressor::v3::Gzip gzip;
+  gzip.mutable_max_pooled_compressors()->set_value(1);
+  testing::NiceMock<ThreadLocal::MockInstance> tls;
+  GzipCompressorFactory factory(gzip, tls);
+
+  Buffer::OwnedImpl buffer;
+  for (uint32_t i = 0; i < 3; i++) {
+    Envoy::Compression::Compressor::CompressorPtr compressor = factory.createCompressor();
+    TestUtility::feedBufferWithRandomCharacters(buffer, 4096, i);
+    compressor->compress(buffer, Envoy::Compression::Compressor::State::Finish);
+    expectValidFinishedBuffer(buffer, 4096);
+    drainBuffer(buffer);
+
+    // A stream that is destroyed before finishing leaves its compressor in the pool too.
+    Envoy::Compression::Compressor::CompressorPtr unfinished_compressor =
+        factory.createCompressor();
+    TestUtility::feedBufferWithRandomCharacters(buffer, 1024, i);
+    unfinished_compressor->compress(buffer, Envoy::Compression::Compressor::State::Flush);
+    drainBuffer(buffer);
+  }
+}
+
 // Exercises death by passing bad initialization params or by calling
 // compress before init.
 TEST_F(ZlibCompressorImplDeathTest, CompressorDeathTest) {
@@ -205,6 +231,26 @@ TEST_F(ZlibCompressorImplTest, CallingFinishOnly) {
   expectValidFinishedBuffer(buffer, 4096);
 }
 
+// Exercises compressing another stream after resetting the compressor.
+TEST_F(ZlibCompressorImplTest, CompressAfterReset) {
+  Buffer::OwnedImpl buffer;
+
+  ZlibCompressorImplTester compressor;
+  compressor.init(ZlibCompressorImpl::CompressionLevel::Standard,
+                  ZlibCompressorImpl::CompressionStrategy::Standard, gzip_window_bits,
+                  memory_level);
+  TestUtility::feedBufferWithRandomCharacters(buffer, 4096);
+  compressor.finish(buffer);
+  expectValidFinishedBuffer(buffer, 4096);
+  drainBuffer(buffer);
+
+  compressor.reset();
+  EXPECT_EQ(0, compressor.checksum());
+  TestUtility::feedBufferWithRandomCharacters(buffer, default_input_size);
+  compressor.finish(buffer);
+  expectValidFinishedBuffer(buffer, default_input_size);
+}
+
 TEST_F(ZlibCompressorImplTest, CompressWithSmallChunkSize) {
   Buffer::OwnedImpl buffer;
   Buffer::OwnedImpl accumulation_buffer;
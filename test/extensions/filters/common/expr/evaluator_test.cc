@@ -1,5 +1,6 @@
 #include "extensions/filters/common/expr/evaluator.h"
 
+#include "test/mocks/stream_info/mocks.h"
 #include "test/test_common/utility.h"
 
 #include "absl/time/time.h"
@@ -40,6 +41,44 @@ TEST(Evaluator, Print) {
   EXPECT_EQ(print(CelValue::CreateError(&status)), "CelError value");
 }
 
+// The expressions evaluated in the same request activation see the same attributes.
+TEST(Evaluator, RequestActivation) {
+  auto builder = createBuilder(nullptr);
+  auto header_matches = createExpression(
+      *builder, TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(R"EOF(
+    call_expr:
+      function: _==_
+      args:
+      - call_expr:
+          function: _[_]
+          args:
+          - select_expr:
+              operand:
+                ident_expr:
+                  name: request
+              field: headers
+          - const_expr:
+              string_value: x
+      - const_expr:
+          string_value: y
+  )EOF"));
+  auto not_bool = createExpression(
+      *builder, TestUtility::parseYaml<google::api::expr::v1alpha1::Expr>(R"EOF(
+    const_expr:
+      string_value: "true"
+  )EOF"));
+
+  testing::NiceMock<StreamInfo::MockStreamInfo> info;
+  Http::TestRequestHeaderMapImpl headers{{"x", "y"}};
+  RequestActivation activation(info, headers);
+  EXPECT_TRUE(activation.matches(*header_matches));
+  EXPECT_FALSE(activation.matches(*not_bool));
+  EXPECT_TRUE(activation.matches(*header_matches));
+
+  Http::TestRequestHeaderMapImpl other_headers{{"x", "z"}};
+  EXPECT_FALSE(matches(*header_matches, info, other_headers));
+}
+
 } // namespace
 } // namespace Expr
 } // namespace Common
@@ -172,6 +172,39 @@ TEST_F(LocalRateLimiterImplTest, TokenBucketMaxTokensGreaterThanTokensPerFill) {
   EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
 }
 
+// Verify that the shards of a bucket share their tokens between threads.
+TEST_F(LocalRateLimiterImplTest, TokenBucketShards) {
+  initialize(std::chrono::milliseconds(200), 2 * LocalRateLimiterImpl::MaxShards,
+             2 * LocalRateLimiterImpl::MaxShards);
+
+  // Another thread takes half of the tokens, and this thread the other half.
+  std::thread t1([&] {
+    for (uint32_t i = 0; i < LocalRateLimiterImpl::MaxShards; i++) {
+      EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+    }
+  });
+  t1.join();
+  for (uint32_t i = 0; i < LocalRateLimiterImpl::MaxShards; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // 0 -> 2 * MaxShards tokens
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+  fill_timer_->invokeCallback();
+
+  // The fill doesn't go over the maximum of the bucket, even with some shards full.
+  for (uint32_t i = 0; i < LocalRateLimiterImpl::MaxShards; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_CALL(*fill_timer_, enableTimer(std::chrono::milliseconds(200), nullptr));
+  fill_timer_->invokeCallback();
+  for (uint32_t i = 0; i < 2 * LocalRateLimiterImpl::MaxShards; i++) {
+    EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  }
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+}
+
 class LocalRateLimiterDescriptorImplTest : public LocalRateLimiterImplTest {
 public:
   void initializeWithDescriptor(const std::chrono::milliseconds fill_interval,
@@ -116,6 +116,50 @@ TEST_F(LuaTest, YieldAndResume) {
   lua_gc(cr->luaState(), LUA_GCCOLLECT, 0);
 }
 
+// The thread of a finished coroutine runs the next one, but not the thread of a yielded one.
+TEST_F(LuaTest, CoroutineReuse) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      object:testCall()
+    end
+
+    function yieldMe()
+      coroutine.yield()
+    end
+  )EOF"};
+
+  setup(SCRIPT);
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("callMe", initializers_)));
+  EXPECT_NE(LUA_REFNIL, state_->getGlobalRef(state_->registerGlobal("yieldMe", initializers_)));
+
+  CoroutinePtr cr1(state_->createCoroutine());
+  lua_State* thread1 = cr1->luaState();
+  TestObject* object1 = TestObject::create(cr1->luaState()).first;
+  EXPECT_CALL(*object1, doTestCall(_));
+  cr1->start(state_->getGlobalRef(0), 1, yield_callback_);
+  EXPECT_EQ(cr1->state(), Coroutine::State::Finished);
+  cr1.reset();
+
+  CoroutinePtr cr2(state_->createCoroutine());
+  EXPECT_EQ(thread1, cr2->luaState());
+  EXPECT_EQ(0, lua_gettop(cr2->luaState()));
+  EXPECT_CALL(on_yield_, ready());
+  cr2->start(state_->getGlobalRef(1), 0, yield_callback_);
+  EXPECT_EQ(cr2->state(), Coroutine::State::Yielded);
+  cr2.reset();
+
+  CoroutinePtr cr3(state_->createCoroutine());
+  EXPECT_NE(thread1, cr3->luaState());
+  TestObject* object3 = TestObject::create(cr3->luaState()).first;
+  EXPECT_CALL(*object3, doTestCall(_));
+  cr3->start(state_->getGlobalRef(0), 1, yield_callback_);
+  EXPECT_EQ(cr3->state(), Coroutine::State::Finished);
+
+  EXPECT_CALL(*object1, onDestroy());
+  EXPECT_CALL(*object3, onDestroy());
+  lua_gc(cr3->luaState(), LUA_GCCOLLECT, 0);
+}
+
 // Mark dead/live and ref counting across coroutines.
 TEST_F(LuaTest, MarkDead) {
   const std::string SCRIPT{R"EOF(
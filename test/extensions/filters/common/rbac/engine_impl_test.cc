@@ -453,6 +453,54 @@ TEST(RoleBasedAccessControlEngineImpl, LogIfMatched) {
   checkEngine(engine, true, RBAC::LogResult::No, info, conn, headers);
 }
 
+// The policies whose principals are only IP ranges are checked with the principal tries, and the
+// first matching policy in the order of their names is still the effective one.
+TEST(RoleBasedAccessControlEngineImpl, IpPrincipals) {
+  envoy::config::rbac::v3::RBAC rbac;
+  rbac.set_action(envoy::config::rbac::v3::RBAC::ALLOW);
+  envoy::config::rbac::v3::Policy& a = (*rbac.mutable_policies())["a"];
+  a.add_permissions()->set_destination_port(123);
+  a.add_principals()->mutable_direct_remote_ip()->set_address_prefix("10.0.0.0");
+  a.mutable_principals(0)->mutable_direct_remote_ip()->mutable_prefix_len()->set_value(8);
+  a.add_principals()->mutable_remote_ip()->set_address_prefix("192.168.0.0");
+  a.mutable_principals(1)->mutable_remote_ip()->mutable_prefix_len()->set_value(16);
+  envoy::config::rbac::v3::Policy& b = (*rbac.mutable_policies())["b"];
+  b.add_permissions()->set_any(true);
+  b.add_principals()->mutable_direct_remote_ip()->set_address_prefix("10.1.0.0");
+  b.mutable_principals(0)->mutable_direct_remote_ip()->mutable_prefix_len()->set_value(16);
+  // A policy with other principals is checked in between.
+  envoy::config::rbac::v3::Policy& ab = (*rbac.mutable_policies())["ab"];
+  ab.add_permissions()->set_any(true);
+  ab.add_principals()->mutable_direct_remote_ip()->set_address_prefix("10.2.0.0");
+  ab.mutable_principals(0)->mutable_direct_remote_ip()->mutable_prefix_len()->set_value(16);
+  ab.add_principals()->mutable_authenticated();
+  RBAC::RoleBasedAccessControlEngineImpl engine(rbac);
+
+  NiceMock<Envoy::Network::MockConnection> conn;
+  Envoy::Http::TestRequestHeaderMapImpl headers;
+  NiceMock<StreamInfo::MockStreamInfo> info;
+  auto check = [&](const std::string& direct_remote, const std::string& remote, uint32_t port,
+                   const std::string& expected_policy) {
+    info.downstream_address_provider_->setDirectRemoteAddressForTest(
+        Envoy::Network::Utility::parseInternetAddress(direct_remote, 1000, false));
+    info.downstream_address_provider_->setRemoteAddress(
+        Envoy::Network::Utility::parseInternetAddress(remote, 1000, false));
+    info.downstream_address_provider_->setLocalAddress(
+        Envoy::Network::Utility::parseInternetAddress("1.2.3.4", port, false));
+    std::string effective_policy_id;
+    EXPECT_EQ(!expected_policy.empty(),
+              engine.handleAction(conn, headers, info, &effective_policy_id));
+    EXPECT_EQ(expected_policy, effective_policy_id);
+  };
+
+  check("10.1.2.3", "1.1.1.1", 123, "a");
+  check("1.1.1.1", "192.168.1.1", 123, "a");
+  check("10.1.2.3", "1.1.1.1", 456, "b");
+  check("10.2.2.3", "1.1.1.1", 456, "ab");
+  check("10.3.2.3", "192.168.1.1", 456, "");
+  check("11.1.2.3", "1.1.1.1", 123, "");
+}
+
 } // namespace
 } // namespace RBAC
 } // namespace Common
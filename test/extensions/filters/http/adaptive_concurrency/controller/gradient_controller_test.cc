@@ -15,6 +15,7 @@
 #include "test/mocks/common.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -54,8 +55,9 @@ public:
 
   GradientControllerSharedPtr makeController(const std::string& yaml_config) {
     const auto config = std::make_shared<GradientController>(makeConfig(yaml_config, runtime_),
-                                                             *dispatcher_, runtime_, "test_prefix.",
-                                                             stats_, random_, time_system_);
+                                                             *dispatcher_, tls_, runtime_,
+                                                             "test_prefix.", stats_, random_,
+                                                             time_system_);
 
     // Advance time so that the latency sample calculations don't underflow if monotonic time is 0.
     time_system_.advanceTimeAndRun(std::chrono::hours(42), *dispatcher_,
@@ -115,6 +117,7 @@ protected:
   Api::ApiPtr api_;
   Event::DispatcherPtr dispatcher_;
   NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
 };
 
 TEST_F(GradientControllerConfigTest, BasicTest) {
@@ -669,8 +672,8 @@ min_rtt_calc_params:
       .WillOnce(Return(sample_timer));
   EXPECT_CALL(*sample_timer, enableTimer(std::chrono::milliseconds(123), _));
   auto controller =
-      std::make_shared<GradientController>(makeConfig(yaml, runtime_), fake_dispatcher, runtime_,
-                                           "test_prefix.", stats_, random_, time_system_);
+      std::make_shared<GradientController>(makeConfig(yaml, runtime_), fake_dispatcher, tls_,
+                                           runtime_, "test_prefix.", stats_, random_, time_system_);
 
   // Set the minRTT- this will trigger the timer for the next minRTT calculation.
 
@@ -714,8 +717,8 @@ min_rtt_calc_params:
       .WillOnce(Return(sample_timer));
   EXPECT_CALL(*sample_timer, enableTimer(std::chrono::milliseconds(123), _));
   auto controller =
-      std::make_shared<GradientController>(makeConfig(yaml, runtime_), fake_dispatcher, runtime_,
-                                           "test_prefix.", stats_, random_, time_system_);
+      std::make_shared<GradientController>(makeConfig(yaml, runtime_), fake_dispatcher, tls_,
+                                           runtime_, "test_prefix.", stats_, random_, time_system_);
 
   // Set the minRTT- this will trigger the timer for the next minRTT calculation.
   EXPECT_CALL(*rtt_timer, enableTimer(std::chrono::milliseconds(45000), _));
@@ -100,6 +100,39 @@ TEST_F(ThreadLocalControllerTest, VerifyMemoryUsage) {
   EXPECT_EQ(RequestData(3, 3), tlc_.requestCounts());
 }
 
+// Verify that the controllers sharing their request counts add the counts of the others, as of
+// their last move to a new bucket.
+TEST_F(ThreadLocalControllerTest, AggregateAcrossWorkers) {
+  auto shared_counts = std::make_shared<SharedRequestCounts>(2);
+  ThreadLocalControllerImpl first(time_system_, window_, shared_counts);
+  ThreadLocalControllerImpl second(time_system_, window_, shared_counts);
+  // All the slots are taken, this controller only counts its own requests.
+  ThreadLocalControllerImpl third(time_system_, window_, shared_counts);
+
+  first.recordSuccess();
+  first.recordFailure();
+  EXPECT_EQ(RequestData(0, 0), second.requestCounts());
+
+  // The counts are published once the controllers move to the next bucket.
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(RequestData(2, 1), first.requestCounts());
+  second.recordFailure();
+  EXPECT_EQ(RequestData(3, 1), second.requestCounts());
+  third.recordSuccess();
+  EXPECT_EQ(RequestData(1, 1), third.requestCounts());
+
+  // The request of the second controller is published when it moves to the next bucket.
+  EXPECT_EQ(RequestData(2, 1), first.requestCounts());
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_EQ(RequestData(3, 1), second.requestCounts());
+  EXPECT_EQ(RequestData(3, 1), first.requestCounts());
+
+  // The published counts go stale with the window.
+  time_system_.advanceTimeWait(window_);
+  EXPECT_EQ(RequestData(0, 0), first.requestCounts());
+  EXPECT_EQ(RequestData(0, 0), second.requestCounts());
+}
+
 } // namespace
 } // namespace AdmissionControl
 } // namespace HttpFilters
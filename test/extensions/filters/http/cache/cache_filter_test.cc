@@ -24,7 +24,8 @@ protected:
   // cache callbacks.
   CacheFilterSharedPtr makeFilter(HttpCache& cache) {
     auto filter = std::make_shared<CacheFilter>(config_, /*stats_prefix=*/"", context_.scope(),
-                                                context_.timeSource(), cache);
+                                                context_.timeSource(), cache, collapser_,
+                                                early_hints_);
     filter->setDecoderFilterCallbacks(decoder_callbacks_);
     filter->setEncoderFilterCallbacks(encoder_callbacks_);
     return filter;
@@ -119,6 +120,8 @@ protected:
   void waitBeforeSecondRequest() { time_source_.advanceTimeWait(delay_); }
 
   SimpleHttpCache simple_cache_;
+  RequestCollapserSharedPtr collapser_;
+  EarlyHintsStoreSharedPtr early_hints_;
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config_;
   NiceMock<Server::Configuration::MockFactoryContext> context_;
   Event::SimulatedTimeSystem time_source_;
@@ -613,6 +616,166 @@ TEST_F(CacheFilterTest, FilterDeletedBeforePostedCallbackExecuted) {
   }
 }
 
+TEST_F(CacheFilterTest, CollapsedMissWaitsForFill) {
+  request_headers_.setHost("CollapsedMissWaitsForFill");
+  collapser_ = std::make_shared<RequestCollapser>();
+
+  // The first request misses and is sent upstream to fill the cache.
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_);
+  testDecodeRequestMiss(filler);
+
+  // The second request misses too, but waits for the first one instead of going upstream.
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  // Once the filler's response has been inserted, the waiter is served from the cache.
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_(IsSupersetOfHeaders(response_headers_), true));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding).Times(0);
+  EXPECT_EQ(filler->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  filler->onDestroy();
+  waiter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, CollapsedMissGoesUpstreamIfFillIsNotCached) {
+  request_headers_.setHost("CollapsedMissGoesUpstreamIfFillIsNotCached");
+  collapser_ = std::make_shared<RequestCollapser>();
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_);
+  testDecodeRequestMiss(filler);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // The filler's response isn't cacheable, so the waiter misses again and is sent upstream.
+  EXPECT_CALL(decoder_callbacks_, encodeHeaders_).Times(0);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding);
+  EXPECT_EQ(filler->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  filler->onDestroy();
+  waiter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, DestroyedFillerReleasesWaiters) {
+  request_headers_.setHost("DestroyedFillerReleasesWaiters");
+  collapser_ = std::make_shared<RequestCollapser>();
+
+  CacheFilterSharedPtr filler = makeFilter(simple_cache_);
+  testDecodeRequestMiss(filler);
+
+  CacheFilterSharedPtr waiter = makeFilter(simple_cache_);
+  EXPECT_EQ(waiter->decodeHeaders(request_headers_, true),
+            Http::FilterHeadersStatus::StopAllIterationAndWatermark);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  // The filler's stream is reset before its response arrives.
+  EXPECT_CALL(decoder_callbacks_, continueDecoding);
+  filler->onDestroy();
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  ::testing::Mock::VerifyAndClearExpectations(&decoder_callbacks_);
+
+  waiter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, EarlyHintsSentToMiss) {
+  request_headers_.setHost("EarlyHintsSentToMiss");
+  early_hints_ = std::make_shared<EarlyHintsStore>(16);
+  response_headers_.setReferenceKey(Http::CustomHeaders::get().CacheControl, "no-store");
+  response_headers_.addCopy(EarlyHintsStore::linkHeader(),
+                            "</style.css>; rel=preload; as=style, </next>; rel=next");
+
+  // Nothing is known about the first request yet.
+  CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, encodeEarlyHintsHeaders_).Times(0);
+  testDecodeRequestMiss(filter);
+  EXPECT_EQ(filter->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  filter->onDestroy();
+
+  // The second request is sent the preload link of the first response before going upstream.
+  filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_,
+              encodeEarlyHintsHeaders_(IsSupersetOfHeaders(Http::TestResponseHeaderMapImpl{
+                  {":status", "103"}, {"link", "</style.css>; rel=preload; as=style"}})));
+  testDecodeRequestMiss(filter);
+
+  // A response without early hints makes the next requests forget them.
+  Http::TestResponseHeaderMapImpl response_headers{{":status", "200"},
+                                                   {"cache-control", "no-store"}};
+  EXPECT_EQ(filter->encodeHeaders(response_headers, true), Http::FilterHeadersStatus::Continue);
+  filter->onDestroy();
+
+  filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, encodeEarlyHintsHeaders_).Times(0);
+  testDecodeRequestMiss(filter);
+  filter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, EarlyHintsNotSentToHit) {
+  request_headers_.setHost("EarlyHintsNotSentToHit");
+  early_hints_ = std::make_shared<EarlyHintsStore>(16);
+  response_headers_.addCopy(EarlyHintsStore::linkHeader(), "</style.css>; rel=preload");
+
+  CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+  testDecodeRequestMiss(filter);
+  EXPECT_EQ(filter->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+  filter->onDestroy();
+  waitBeforeSecondRequest();
+
+  // The cached response is served right away, so no hints are needed.
+  filter = makeFilter(simple_cache_);
+  EXPECT_CALL(decoder_callbacks_, encodeEarlyHintsHeaders_).Times(0);
+  testDecodeRequestHitNoBody(filter);
+  filter->onDestroy();
+}
+
+TEST_F(CacheFilterTest, AcceptEncodingVariants) {
+  request_headers_.setHost("AcceptEncodingVariants");
+  config_.add_accept_encoding_variants("br");
+  config_.add_accept_encoding_variants("gzip");
+  config_.add_allowed_vary_headers()->set_exact("accept-encoding");
+  response_headers_.setCopy(Http::CustomHeaders::get().Vary, "accept-encoding");
+  response_headers_.setCopy(Http::CustomHeaders::get().ContentEncoding, "gzip");
+
+  {
+    // The request is stored as the gzip variant.
+    request_headers_.setCopy(Http::CustomHeaders::get().AcceptEncoding, "gzip, deflate");
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    EXPECT_THAT(request_headers_,
+                HeaderHasValueRef(Http::CustomHeaders::get().AcceptEncoding, "gzip"));
+    EXPECT_EQ(filter->encodeHeaders(response_headers_, true), Http::FilterHeadersStatus::Continue);
+    filter->onDestroy();
+  }
+  waitBeforeSecondRequest();
+  {
+    // Another request negotiating gzip is served the gzip variant.
+    request_headers_.setCopy(Http::CustomHeaders::get().AcceptEncoding, "br;q=0, gzip;q=0.5, *");
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestHitNoBody(filter);
+    filter->onDestroy();
+  }
+  {
+    // A request negotiating br misses.
+    request_headers_.setCopy(Http::CustomHeaders::get().AcceptEncoding, "gzip, br");
+    CacheFilterSharedPtr filter = makeFilter(simple_cache_);
+    testDecodeRequestMiss(filter);
+    EXPECT_THAT(request_headers_,
+                HeaderHasValueRef(Http::CustomHeaders::get().AcceptEncoding, "br"));
+    filter->onDestroy();
+  }
+}
+
 // A new type alias for a different type of tests that use the exact same class
 using ValidationHeadersTest = CacheFilterTest;
 
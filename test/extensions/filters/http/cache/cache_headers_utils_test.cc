@@ -565,6 +565,24 @@ TEST_P(ParseCommaDelimitedListMultipleTest, MultipleValuesMixedSpaces) {
   EXPECT_EQ(result[1], "accept-language");
 }
 
+TEST(NegotiateContentCoding, NoAcceptedCoding) {
+  const std::vector<std::string> codings = {"br", "gzip"};
+  EXPECT_EQ("identity", CacheHeadersUtils::negotiateContentCoding("", codings));
+  EXPECT_EQ("identity", CacheHeadersUtils::negotiateContentCoding("deflate", codings));
+  EXPECT_EQ("identity", CacheHeadersUtils::negotiateContentCoding("br;q=0, gzip;q=0.000", codings));
+  EXPECT_EQ("identity", CacheHeadersUtils::negotiateContentCoding("*;q=0", codings));
+  EXPECT_EQ("identity", CacheHeadersUtils::negotiateContentCoding("gzip;q=invalid", codings));
+}
+
+TEST(NegotiateContentCoding, PreferredCoding) {
+  const std::vector<std::string> codings = {"br", "gzip"};
+  EXPECT_EQ("gzip", CacheHeadersUtils::negotiateContentCoding("gzip, deflate", codings));
+  EXPECT_EQ("br", CacheHeadersUtils::negotiateContentCoding("gzip, deflate, br", codings));
+  EXPECT_EQ("br", CacheHeadersUtils::negotiateContentCoding(" GZIP ; q=1 ,Br;q=0.1", codings));
+  EXPECT_EQ("gzip", CacheHeadersUtils::negotiateContentCoding("br;q=0, *", codings));
+  EXPECT_EQ("br", CacheHeadersUtils::negotiateContentCoding("*", codings));
+}
+
 TEST(HasVary, Null) {
   Http::TestResponseHeaderMapImpl headers;
   ASSERT_FALSE(VaryHeader::hasVary(headers));
@@ -0,0 +1,62 @@
+#include "extensions/filters/http/cache/early_hints_store.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+TEST(EarlyHintsStoreTest, EarlyHints) {
+  EXPECT_THAT(EarlyHintsStore::earlyHints("</a.css>; rel=preload; as=style"),
+              ElementsAre("</a.css>; rel=preload; as=style"));
+  EXPECT_THAT(EarlyHintsStore::earlyHints("<https://a.com>; REL=\"dns-prefetch preconnect\""),
+              ElementsAre("<https://a.com>; REL=\"dns-prefetch preconnect\""));
+  // Only the preload and preconnect links are early hints, and the commas within the URIs and the
+  // quoted values don't separate links.
+  EXPECT_THAT(EarlyHintsStore::earlyHints(
+                  "</a,b.js>; rel=preload; as=script , </next>; rel=next; title=\"a, b\", "
+                  "</c.js>;rel=preload"),
+              ElementsAre("</a,b.js>; rel=preload; as=script", "</c.js>;rel=preload"));
+  EXPECT_THAT(EarlyHintsStore::earlyHints("</preload>"), IsEmpty());
+  EXPECT_THAT(EarlyHintsStore::earlyHints("</a.css>; rel=stylesheet"), IsEmpty());
+  EXPECT_THAT(EarlyHintsStore::earlyHints(""), IsEmpty());
+}
+
+TEST(EarlyHintsStoreTest, Update) {
+  EarlyHintsStore store(1);
+  Key key1;
+  key1.set_host("host1");
+  Key key2;
+  key2.set_host("host2");
+  EXPECT_EQ(nullptr, store.find(key1));
+
+  store.update(key1, Http::TestResponseHeaderMapImpl{{":status", "200"},
+                                                     {"link", "</a.css>; rel=preload"},
+                                                     {"link", "</b.js>; rel=preload"}});
+  ASSERT_NE(nullptr, store.find(key1));
+  EXPECT_THAT(*store.find(key1), ElementsAre("</a.css>; rel=preload", "</b.js>; rel=preload"));
+
+  // The store is full, so the hints of key1 are forgotten for those of key2.
+  store.update(key2, Http::TestResponseHeaderMapImpl{{":status", "200"},
+                                                     {"link", "</c.css>; rel=preload"}});
+  EXPECT_EQ(nullptr, store.find(key1));
+  ASSERT_NE(nullptr, store.find(key2));
+  EXPECT_THAT(*store.find(key2), ElementsAre("</c.css>; rel=preload"));
+
+  // A response without early hints forgets them.
+  store.update(key2, Http::TestResponseHeaderMapImpl{{":status", "200"}});
+  EXPECT_EQ(nullptr, store.find(key2));
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
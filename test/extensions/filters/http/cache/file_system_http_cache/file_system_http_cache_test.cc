@@ -0,0 +1,200 @@
+#include "envoy/registry/registry.h"
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/cache/cache_headers_utils.h"
+#include "extensions/filters/http/cache/file_system_http_cache/file_system_http_cache.h"
+
+#include "source/extensions/filters/http/cache/file_system_http_cache/config.pb.h"
+
+#include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Cache {
+namespace {
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+class FileSystemHttpCacheTest : public testing::Test {
+protected:
+  FileSystemHttpCacheTest()
+      : cache_path_(TestEnvironment::temporaryPath(
+            testing::UnitTest::GetInstance()->current_test_info()->name())) {
+    TestEnvironment::removePath(cache_path_);
+    TestEnvironment::createPath(cache_path_);
+    cache_ = std::make_unique<FileSystemHttpCache>(cache_path_, Thread::threadFactoryForTest());
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setForwardedProto("https");
+    request_headers_.setCopy(Http::CustomHeaders::get().CacheControl, "max-age=3600");
+  }
+
+  ~FileSystemHttpCacheTest() override {
+    cache_.reset();
+    TestEnvironment::removePath(cache_path_);
+  }
+
+  // Waits for the work already posted to the I/O thread to complete.
+  void drain() {
+    absl::Notification done;
+    cache_->post([&done]() { done.Notify(); });
+    done.WaitForNotification();
+  }
+
+  // Performs a cache lookup and waits for its result.
+  LookupContextPtr lookup(absl::string_view request_path) {
+    request_headers_.setPath(request_path);
+    LookupContextPtr context = cache_->makeLookupContext(
+        LookupRequest(request_headers_, current_time_, vary_allow_list_));
+    context->getHeaders([this](LookupResult&& result) { lookup_result_ = std::move(result); });
+    drain();
+    return context;
+  }
+
+  // Inserts a response and waits for it to be written.
+  void insert(absl::string_view request_path,
+              const Http::TestResponseHeaderMapImpl& response_headers,
+              absl::string_view response_body) {
+    InsertContextPtr inserter = cache_->makeInsertContext(lookup(request_path));
+    inserter->insertHeaders(response_headers, ResponseMetadata{current_time_}, false);
+    inserter->insertBody(Buffer::OwnedImpl(response_body), nullptr, true);
+    inserter->onDestroy();
+    drain();
+  }
+
+  std::string getBody(LookupContext& context, uint64_t start, uint64_t end) {
+    std::string body;
+    context.getBody(AdjustedByteRange(start, end),
+                    [&body](Buffer::InstancePtr&& data) { body = data->toString(); });
+    return body;
+  }
+
+  const std::string cache_path_;
+  std::unique_ptr<FileSystemHttpCache> cache_;
+  LookupResult lookup_result_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Event::SimulatedTimeSystem time_source_;
+  SystemTime current_time_ = time_source_.systemTime();
+  DateFormatter formatter_{"%a, %d %b %Y %H:%M:%S GMT"};
+  VaryHeader vary_allow_list_{
+      envoy::extensions::filters::http::cache::v3alpha::CacheConfig().allowed_vary_headers()};
+};
+
+TEST_F(FileSystemHttpCacheTest, PutGet) {
+  lookup("/name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  insert("/name", response_headers, "Value");
+  LookupContextPtr context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_EQ(5, lookup_result_.content_length_);
+  EXPECT_THAT(*lookup_result_.headers_, HeaderMapEqualIgnoreOrder(&response_headers));
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+  EXPECT_EQ("alu", getBody(*context, 1, 4));
+  context->onDestroy();
+
+  lookup("/other");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+
+  // Replacing an entry doesn't invalidate bodies served from the old one.
+  context = lookup("/name");
+  insert("/name", response_headers, "NewValue");
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+  context->onDestroy();
+  context = lookup("/name");
+  EXPECT_EQ("NewValue", getBody(*context, 0, 8));
+  context->onDestroy();
+}
+
+TEST_F(FileSystemHttpCacheTest, EntriesSurviveRestart) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  insert("/name", response_headers, "Value");
+
+  cache_ = std::make_unique<FileSystemHttpCache>(cache_path_, Thread::threadFactoryForTest());
+  LookupContextPtr context = lookup("/name");
+  ASSERT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  EXPECT_EQ("Value", getBody(*context, 0, 5));
+  context->onDestroy();
+}
+
+TEST_F(FileSystemHttpCacheTest, CorruptEntryIsAMiss) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  insert("/name", response_headers, "Value");
+
+  request_headers_.setPath("/name");
+  const LookupRequest request(request_headers_, current_time_, vary_allow_list_);
+  TestEnvironment::writeStringToFileForTest(cache_->entryPath(localHashKey(request.key())),
+                                            "garbage", true);
+  lookup("/name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+TEST_F(FileSystemHttpCacheTest, VaryResponseIsNotCached) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)},
+      {"cache-control", "public,max-age=3600"},
+      {"vary", "accept"}};
+  insert("/name", response_headers, "Value");
+  lookup("/name");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+}
+
+TEST_F(FileSystemHttpCacheTest, DestroyedLookupIsNotCalledBack) {
+  const Http::TestResponseHeaderMapImpl response_headers{
+      {"date", formatter_.fromTime(current_time_)}, {"cache-control", "public,max-age=3600"}};
+  insert("/name", response_headers, "Value");
+
+  // Hold the I/O thread so that the lookup is still queued when it is destroyed.
+  absl::Notification release;
+  cache_->post([&release]() { release.WaitForNotification(); });
+  request_headers_.setPath("/name");
+  LookupContextPtr context = cache_->makeLookupContext(
+      LookupRequest(request_headers_, current_time_, vary_allow_list_));
+  context->getHeaders([](LookupResult&&) { FAIL() << "destroyed lookup was called back"; });
+  context->onDestroy();
+  context.reset();
+  release.Notify();
+  drain();
+}
+
+TEST(Registration, GetFactory) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.source.extensions.filters.http.cache.FileSystemHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+
+  envoy::source::extensions::filters::http::cache::FileSystemHttpCacheConfig cache_config;
+  cache_config.set_cache_path(TestEnvironment::temporaryDirectory());
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(cache_config);
+  HttpCache& cache = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache.cacheInfo().name_, "envoy.extensions.http.cache.file_system");
+  EXPECT_EQ(&cache, &factory->getCache(config, factory_context));
+
+  cache_config.set_cache_path(TestEnvironment::temporaryPath("does_not_exist"));
+  config.mutable_typed_config()->PackFrom(cache_config);
+  EXPECT_THROW_WITH_REGEX(factory->getCache(config, factory_context), EnvoyException,
+                          "is not an existing directory");
+}
+
+} // namespace
+} // namespace Cache
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -6,7 +6,10 @@
 #include "extensions/filters/http/cache/cache_headers_utils.h"
 #include "extensions/filters/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include "source/extensions/filters/http/cache/simple_http_cache/config.pb.h"
+
 #include "test/extensions/filters/http/cache/common.h"
+#include "test/mocks/server/factory_context.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
@@ -18,6 +21,8 @@ namespace HttpFilters {
 namespace Cache {
 namespace {
 
+using testing::NiceMock;
+
 const std::string EpochDate = "Thu, 01 Jan 1970 00:00:00 GMT";
 
 envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
@@ -30,7 +35,8 @@ envoy::extensions::filters::http::cache::v3alpha::CacheConfig getConfig() {
 
 class SimpleHttpCacheTest : public testing::Test {
 protected:
-  SimpleHttpCacheTest() : vary_allow_list_(getConfig().allowed_vary_headers()) {
+  explicit SimpleHttpCacheTest(uint64_t max_cache_bytes = 0)
+      : cache_(max_cache_bytes), vary_allow_list_(getConfig().allowed_vary_headers()) {
     request_headers_.setMethod("GET");
     request_headers_.setHost("example.com");
     request_headers_.setForwardedProto("https");
@@ -218,13 +224,82 @@ TEST_F(SimpleHttpCacheTest, StreamingPut) {
   EXPECT_EQ("Hello, World!", getBody(*name_lookup_context, 0, 13));
 }
 
+// The body handed out by a lookup stays valid after the entry is replaced.
+TEST_F(SimpleHttpCacheTest, BodyOutlivesReplacedEntry) {
+  Http::TestResponseHeaderMapImpl response_headers{{"date", formatter_.fromTime(current_time_)},
+                                                   {"cache-control", "public,max-age=3600"}};
+  insert("/", response_headers, "old");
+
+  LookupContextPtr lookup_context = lookup("/");
+  EXPECT_EQ(CacheEntryStatus::Ok, lookup_result_.cache_entry_status_);
+  Buffer::InstancePtr old_body;
+  lookup_context->getBody(AdjustedByteRange(0, 3), [&old_body](Buffer::InstancePtr&& data) {
+    old_body = std::move(data);
+  });
+  lookup_context.reset();
+
+  insert("/", response_headers, "new");
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/").get(), "new"));
+  ASSERT_NE(nullptr, old_body);
+  EXPECT_EQ("old", old_body->toString());
+}
+
+class SimpleHttpCacheBoundedTest : public SimpleHttpCacheTest {
+protected:
+  static constexpr uint64_t MaxCacheBytes = SimpleHttpCache::NumShards * 3000;
+
+  SimpleHttpCacheBoundedTest() : SimpleHttpCacheTest(MaxCacheBytes) {}
+
+  Http::TestResponseHeaderMapImpl response_headers_{{"date", formatter_.fromTime(current_time_)},
+                                                    {"cache-control", "public,max-age=3600"}};
+};
+
+TEST_F(SimpleHttpCacheBoundedTest, EvictsToStayWithinBudget) {
+  const std::string body(1000, 'a');
+  const int num_entries = 100;
+  for (int i = 0; i < num_entries; i++) {
+    insert(absl::StrCat("/", i), response_headers_, body);
+    EXPECT_LE(cache_.byteSize(), MaxCacheBytes);
+    // The most recently inserted entry is never the one evicted.
+    EXPECT_TRUE(expectLookupSuccessWithBody(lookup(absl::StrCat("/", i)).get(), body));
+  }
+
+  int misses = 0;
+  for (int i = 0; i < num_entries; i++) {
+    lookup(absl::StrCat("/", i));
+    if (lookup_result_.cache_entry_status_ == CacheEntryStatus::Unusable) {
+      misses++;
+    }
+  }
+  EXPECT_GT(misses, 0);
+}
+
+TEST_F(SimpleHttpCacheBoundedTest, EntryLargerThanShardBudgetIsNotCached) {
+  insert("/small", response_headers_, "small");
+  insert("/large", response_headers_, std::string(MaxCacheBytes / SimpleHttpCache::NumShards, 'a'));
+
+  lookup("/large");
+  EXPECT_EQ(CacheEntryStatus::Unusable, lookup_result_.cache_entry_status_);
+  EXPECT_TRUE(expectLookupSuccessWithBody(lookup("/small").get(), "small"));
+}
+
 TEST(Registration, GetFactory) {
   HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
       "envoy.source.extensions.filters.http.cache.SimpleHttpCacheConfig");
   ASSERT_NE(factory, nullptr);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
   envoy::extensions::filters::http::cache::v3alpha::CacheConfig config;
   config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
-  EXPECT_EQ(factory->getCache(config).cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  HttpCache& cache = factory->getCache(config, factory_context);
+  EXPECT_EQ(cache.cacheInfo().name_, "envoy.extensions.http.cache.simple");
+  EXPECT_EQ(&cache, &factory->getCache(config, factory_context));
+
+  // A different budget gets its own cache.
+  envoy::source::extensions::filters::http::cache::SimpleHttpCacheConfig bounded_config;
+  bounded_config.set_max_cache_bytes(1024);
+  envoy::extensions::filters::http::cache::v3alpha::CacheConfig other_config;
+  other_config.mutable_typed_config()->PackFrom(bounded_config);
+  EXPECT_NE(&cache, &factory->getCache(other_config, factory_context));
 }
 
 TEST_F(SimpleHttpCacheTest, VaryResponses) {
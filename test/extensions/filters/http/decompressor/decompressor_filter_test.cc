@@ -232,6 +232,60 @@ TEST_P(DecompressorFilterTest, DecompressionActiveEndWithTrailers) {
                       absl::nullopt /* expected_content_encoding */);
 }
 
+// A stream which decompresses to more than the maximum ratio of its compressed bytes is rejected on
+// the request direction, and reset on the response direction.
+TEST_P(DecompressorFilterTest, DecompressionRatioLimitExceeded) {
+  setUpFilter(R"EOF(
+decompressor_library:
+  name: testlib
+  typed_config:
+    "@type": "type.googleapis.com/envoy.extensions.compression.gzip.decompressor.v3.Gzip"
+request_direction_config:
+  common_config:
+    max_decompression_ratio: 3
+response_direction_config:
+  common_config:
+    max_decompression_ratio: 3
+)EOF");
+  auto decompressor = std::make_unique<Compression::Decompressor::MockDecompressor>();
+  auto* decompressor_ptr = decompressor.get();
+  EXPECT_CALL(*decompressor_factory_, createDecompressor(_))
+      .WillOnce(Return(ByMove(std::move(decompressor))));
+  Http::TestRequestHeaderMapImpl headers_before_filter{{"content-encoding", "mock"}};
+  doHeaders(headers_before_filter, false /* end_stream */);
+
+  uint64_t ratio = 3;
+  EXPECT_CALL(*decompressor_ptr, decompress(_, _))
+      .Times(2)
+      .WillRepeatedly(
+          Invoke([&](const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) {
+            TestUtility::feedBufferWithRandomCharacters(output_buffer,
+                                                        ratio * input_buffer.length());
+          }));
+
+  // Reaching the ratio is allowed.
+  Buffer::OwnedImpl buffer;
+  TestUtility::feedBufferWithRandomCharacters(buffer, 10);
+  doData(buffer, false /* end_stream */, true /* expect_decompression */);
+  EXPECT_EQ(30, buffer.length());
+
+  ratio = 4;
+  buffer.drain(buffer.length());
+  TestUtility::feedBufferWithRandomCharacters(buffer, 10);
+  if (isRequestDirection()) {
+    EXPECT_CALL(decoder_callbacks_,
+                sendLocalReply(Http::Code::PayloadTooLarge, "", _, _,
+                               "decompressor.ratio_limit_exceeded"));
+    EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(buffer, false));
+    EXPECT_EQ(1, config_->requestDirectionConfig().stats().ratio_limit_exceeded_.value());
+  } else {
+    EXPECT_CALL(encoder_callbacks_, resetStream());
+    EXPECT_EQ(Http::FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(buffer, false));
+    EXPECT_EQ(1, config_->responseDirectionConfig().stats().ratio_limit_exceeded_.value());
+  }
+  EXPECT_EQ(0, buffer.length());
+}
+
 TEST_P(DecompressorFilterTest, DecompressionActiveContentEncodingSpacing) {
   // Additional spacing should still match.
   Http::TestRequestHeaderMapImpl headers_before_filter{{"content-encoding", " mock "},
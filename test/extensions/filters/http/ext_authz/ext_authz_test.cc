@@ -25,9 +25,11 @@
 #include "test/mocks/network/mocks.h"
 #include "test/mocks/router/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -56,8 +58,13 @@ public:
     if (!yaml.empty()) {
       TestUtility::loadFromYaml(yaml, proto_config);
     }
-    config_.reset(
-        new FilterConfig(proto_config, stats_store_, runtime_, http_context_, "ext_authz_prefix"));
+    config_.reset(new FilterConfig(proto_config, stats_store_, runtime_, http_context_, tls_,
+                                   time_system_, "ext_authz_prefix"));
+    newFilter();
+  }
+
+  // Replaces the filter by a new one for the next request, with the same configuration.
+  void newFilter() {
     client_ = new Filters::Common::ExtAuthz::MockClient();
     filter_ = std::make_unique<Filter>(config_, Filters::Common::ExtAuthz::ClientPtr{client_});
     filter_->setDecoderFilterCallbacks(filter_callbacks_);
@@ -72,6 +79,8 @@ public:
   }
 
   NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  Event::SimulatedTimeSystem time_system_;
   FilterConfigSharedPtr config_;
   Filters::Common::ExtAuthz::MockClient* client_;
   std::unique_ptr<Filter> filter_;
@@ -97,6 +106,23 @@ public:
     (*fields)["foo"] = ValueUtil::stringValue("cool");
     (*fields)["bar"] = ValueUtil::numberValue(1);
   }
+
+  // Decodes the request headers with a new filter, whose authorization server answers with the
+  // response if it is called.
+  Http::FilterHeadersStatus
+  decodeHeadersWithDecision(const Filters::Common::ExtAuthz::Response& response,
+                            bool expect_check) {
+    newFilter();
+    prepareCheck();
+    EXPECT_CALL(*client_, check(_, _, testing::A<Tracing::Span&>(), _))
+        .Times(expect_check ? 1 : 0)
+        .WillRepeatedly(Invoke([&](Filters::Common::ExtAuthz::RequestCallbacks& callbacks,
+                                   const envoy::service::auth::v3::CheckRequest&, Tracing::Span&,
+                                   const StreamInfo::StreamInfo&) -> void {
+          callbacks.onComplete(std::make_unique<Filters::Common::ExtAuthz::Response>(response));
+        }));
+    return filter_->decodeHeaders(request_headers_, false);
+  }
 };
 
 using CreateFilterConfigFunc = envoy::extensions::filters::http::ext_authz::v3::ExtAuthz();
@@ -1088,6 +1114,110 @@ TEST_F(HttpFilterTest, NoClearCacheRouteDeniedResponse) {
   EXPECT_EQ("ext_authz_denied", filter_callbacks_.details());
 }
 
+// The decisions are cached by the values of the key headers.
+TEST_F(HttpFilterTest, DecisionCacheHit) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: [":path", "authorization"]
+    default_ttl: 10s
+  )EOF");
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  response.headers_to_set = Http::HeaderVector{{Http::LowerCaseString{"x-user"}, "alice"}};
+
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}, {"authorization", "a"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, decodeHeadersWithDecision(response, true));
+  EXPECT_EQ(1U, config_->stats().decision_cache_miss_.value());
+
+  // The cached decision still modifies the request.
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}, {"authorization", "a"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, decodeHeadersWithDecision(response, false));
+  EXPECT_EQ("alice", request_headers_.get_("x-user"));
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+  EXPECT_EQ(2U, config_->stats().ok_.value());
+
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}, {"authorization", "b"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, decodeHeadersWithDecision(response, true));
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, decodeHeadersWithDecision(response, true));
+  EXPECT_EQ(3U, config_->stats().decision_cache_miss_.value());
+
+  // The decision expires.
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}, {"authorization", "a"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, decodeHeadersWithDecision(response, true));
+  EXPECT_EQ(4U, config_->stats().decision_cache_miss_.value());
+}
+
+// The authorization server sets the TTL of its decisions in the dynamic metadata.
+TEST_F(HttpFilterTest, DecisionCacheTtlFromMetadata) {
+  initialize(R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: [":path"]
+    ttl_metadata_key: "ttl"
+  )EOF");
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::OK;
+  (*response.dynamic_metadata.mutable_fields())["ttl"] = ValueUtil::numberValue(5);
+
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}};
+  decodeHeadersWithDecision(response, true);
+  time_system_.advanceTimeWait(std::chrono::seconds(4));
+  decodeHeadersWithDecision(response, false);
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  decodeHeadersWithDecision(response, true);
+
+  // Without a TTL or a default one, the decision isn't cached.
+  response.dynamic_metadata.clear_fields();
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/bar"}};
+  decodeHeadersWithDecision(response, true);
+  decodeHeadersWithDecision(response, true);
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+}
+
+// The denied requests are only cached if configured, and the errors never are.
+TEST_F(HttpFilterTest, DecisionCacheDeniedAndErrors) {
+  const std::string config = R"EOF(
+  transport_api_version: V3
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_authz_server"
+  decision_cache:
+    key_headers: [":path"]
+    default_ttl: 10s
+  )EOF";
+  initialize(std::string(config));
+
+  Filters::Common::ExtAuthz::Response response{};
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Denied;
+  response.status_code = Http::Code::Forbidden;
+  request_headers_ = Http::TestRequestHeaderMapImpl{{":path", "/foo"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            decodeHeadersWithDecision(response, true));
+  decodeHeadersWithDecision(response, true);
+
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Error;
+  decodeHeadersWithDecision(response, true);
+  decodeHeadersWithDecision(response, true);
+
+  initialize(config + "    cache_denied: true\n");
+  response.status = Filters::Common::ExtAuthz::CheckStatus::Denied;
+  decodeHeadersWithDecision(response, true);
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            decodeHeadersWithDecision(response, false));
+  EXPECT_EQ(1U, config_->stats().decision_cache_hit_.value());
+}
+
 // Verifies that specified metadata is passed along in the check request
 TEST_F(HttpFilterTest, MetadataContext) {
   initialize(R"EOF(
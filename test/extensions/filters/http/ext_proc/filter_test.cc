@@ -3,6 +3,7 @@
 #include "test/common/http/common.h"
 #include "test/extensions/filters/http/ext_proc/mock_server.h"
 #include "test/extensions/filters/http/ext_proc/utils.h"
+#include "test/mocks/buffer/mocks.h"
 #include "test/mocks/event/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/network/mocks.h"
@@ -37,6 +38,7 @@ using Http::LowerCaseString;
 
 using testing::Eq;
 using testing::Invoke;
+using testing::NiceMock;
 using testing::ReturnRef;
 using testing::Unused;
 
@@ -82,6 +84,13 @@ protected:
 
   bool doSendClose() { return !server_closed_stream_; }
 
+  // A response to a streamed request body chunk that leaves it unchanged.
+  std::unique_ptr<ProcessingResponse> requestBodyResponse() {
+    auto response = std::make_unique<ProcessingResponse>();
+    response->mutable_request_body();
+    return response;
+  }
+
   void setUpDecodingBuffering(Buffer::Instance& buf) {
     EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillRepeatedly(Return(&buf));
     EXPECT_CALL(decoder_callbacks_, addDecodedData(_, false))
@@ -683,55 +692,172 @@ TEST_F(HttpFilterTest, PostAndChangeBothBodiesBufferedMultiChunk) {
   EXPECT_EQ(1, config_->stats().streams_closed_.value());
 }
 
-// Using a configuration with streaming set for the request and
-// response bodies, we should ignore a "buffered" body mode for now
-// because it is not implemented.
-TEST_F(HttpFilterTest, PostAndIgnoreStreamedBodiesUntilImplemented) {
+// Using a configuration with streaming set for the request and response
+// bodies, test that each chunk is held until the processor answers it,
+// while the next chunks keep being sent.
+TEST_F(HttpFilterTest, PostAndChangeStreamedBodies) {
   initialize(R"EOF(
   grpc_service:
     envoy_grpc:
       cluster_name: "ext_proc_server"
   processing_mode:
     request_header_mode: "SEND"
-    response_header_mode: "SEND"
+    response_header_mode: "SKIP"
     request_body_mode: "STREAMED"
     response_body_mode: "STREAMED"
     request_trailer_mode: "SKIP"
     response_trailer_mode: "SKIP"
   )EOF");
 
-  // Create synthetic HTTP request
   HttpTestUtility::addDefaultHeaders(request_headers_, "POST");
-  request_headers_.addCopy(LowerCaseString("content-type"), "text/plain");
-  request_headers_.addCopy(LowerCaseString("content-length"), 100);
-
   EXPECT_EQ(FilterHeadersStatus::StopAllIterationAndWatermark,
             filter_->decodeHeaders(request_headers_, false));
   processRequestHeaders(absl::nullopt);
 
-  TestUtility::feedBufferWithRandomCharacters(data_, 100);
-  EXPECT_EQ(FilterDataStatus::Continue, filter_->decodeData(data_, true));
-  EXPECT_EQ(FilterTrailersStatus::Continue, filter_->decodeTrailers(request_trailers_));
+  Buffer::OwnedImpl chunk_1("hello");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_1, false));
+  ASSERT_TRUE(last_request_.has_request_body());
+  EXPECT_EQ("hello", last_request_.request_body().body());
+  EXPECT_FALSE(last_request_.request_body().end_of_stream());
+  // The second chunk is sent before the first one is answered.
+  last_request_processed_ = true;
+  Buffer::OwnedImpl chunk_2("world");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_2, false));
+  EXPECT_EQ("world", last_request_.request_body().body());
+  last_request_processed_ = true;
+  // The trailers wait for the body.
+  EXPECT_EQ(FilterTrailersStatus::StopIteration, filter_->decodeTrailers(request_trailers_));
+
+  std::string injected;
+  EXPECT_CALL(decoder_callbacks_, injectDecodedDataToFilterChain(_, false))
+      .Times(2)
+      .WillRepeatedly(Invoke([&injected](Buffer::Instance& data, Unused) {
+        injected.append(data.toString());
+        data.drain(data.length());
+      }));
+  auto response = std::make_unique<ProcessingResponse>();
+  response->mutable_request_body()->mutable_response()->mutable_body_mutation()->set_body("HELLO");
+  stream_callbacks_->onReceiveMessage(std::move(response));
+  EXPECT_EQ("HELLO", injected);
 
-  response_headers_.addCopy(LowerCaseString(":status"), "200");
-  response_headers_.addCopy(LowerCaseString("content-type"), "text/plain");
-  response_headers_.addCopy(LowerCaseString("content-length"), "100");
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  stream_callbacks_->onReceiveMessage(requestBodyResponse());
+  EXPECT_EQ("HELLOworld", injected);
 
-  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encode100ContinueHeaders(response_headers_));
-  EXPECT_EQ(FilterHeadersStatus::StopAllIterationAndWatermark,
-            filter_->encodeHeaders(response_headers_, false));
-  processResponseHeaders(absl::nullopt);
+  // The response body ends in a single chunk.
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers_, false));
+  Buffer::OwnedImpl resp_chunk("done");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->encodeData(resp_chunk, true));
+  ASSERT_TRUE(last_request_.has_response_body());
+  EXPECT_TRUE(last_request_.response_body().end_of_stream());
+  last_request_processed_ = true;
+  EXPECT_CALL(encoder_callbacks_, injectEncodedDataToFilterChain(BufferStringEqual("done"), true));
+  response = std::make_unique<ProcessingResponse>();
+  response->mutable_response_body();
+  stream_callbacks_->onReceiveMessage(std::move(response));
+  filter_->onDestroy();
 
-  TestUtility::feedBufferWithRandomCharacters(data_, 100);
-  EXPECT_EQ(FilterDataStatus::Continue, filter_->encodeData(data_, true));
+  EXPECT_EQ(1, config_->stats().streams_started_.value());
+  EXPECT_EQ(4, config_->stats().stream_msgs_sent_.value());
+  EXPECT_EQ(4, config_->stats().stream_msgs_received_.value());
+  EXPECT_EQ(1, config_->stats().streams_closed_.value());
+}
 
-  EXPECT_EQ(FilterTrailersStatus::Continue, filter_->encodeTrailers(response_trailers_));
-  filter_->onDestroy();
+// The streamed body data is coalesced until there is enough of it, or until it
+// was held for too long.
+TEST_F(HttpFilterTest, CoalesceStreamedBody) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+  streamed_body_options:
+    min_chunk_size: 10
+    max_chunk_delay: 0.05s
+  )EOF");
 
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  auto* flush_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*flush_timer, enableTimer(std::chrono::milliseconds(50), _));
+  Buffer::OwnedImpl chunk_1("abc");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_1, false));
+  Buffer::OwnedImpl chunk_2("defgh");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_2, false));
+  EXPECT_TRUE(last_request_processed_);
   EXPECT_EQ(1, config_->stats().streams_started_.value());
+  EXPECT_EQ(0, config_->stats().stream_msgs_sent_.value());
+
+  flush_timer->invokeCallback();
+  ASSERT_TRUE(last_request_.has_request_body());
+  EXPECT_EQ("abcdefgh", last_request_.request_body().body());
+  last_request_processed_ = true;
+
+  // Enough data is sent right away.
+  Buffer::OwnedImpl chunk_3("0123456789");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_3, false));
+  EXPECT_EQ("0123456789", last_request_.request_body().body());
+  last_request_processed_ = true;
+
+  EXPECT_CALL(decoder_callbacks_,
+              injectDecodedDataToFilterChain(BufferStringEqual("abcdefgh"), false));
+  stream_callbacks_->onReceiveMessage(requestBodyResponse());
+  EXPECT_CALL(decoder_callbacks_,
+              injectDecodedDataToFilterChain(BufferStringEqual("0123456789"), false));
+  stream_callbacks_->onReceiveMessage(requestBodyResponse());
+
+  filter_->onDestroy();
+  EXPECT_EQ(2, config_->stats().stream_msgs_sent_.value());
+  EXPECT_EQ(2, config_->stats().stream_msgs_received_.value());
+}
+
+// The held chunks raise the watermark when they exceed the buffer limit, and a
+// processor that stops the streaming sees no more chunks, while the rest of the
+// body still follows the chunks it was sent.
+TEST_F(HttpFilterTest, StreamedBodyWatermarkAndModeOverride) {
+  initialize(R"EOF(
+  grpc_service:
+    envoy_grpc:
+      cluster_name: "ext_proc_server"
+  processing_mode:
+    request_header_mode: "SKIP"
+    request_body_mode: "STREAMED"
+  )EOF");
+
+  EXPECT_CALL(decoder_callbacks_, decoderBufferLimit()).WillRepeatedly(Return(10));
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterAboveWriteBufferHighWatermark());
+  Buffer::OwnedImpl chunk_1("twelve bytes");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_1, false));
+  last_request_processed_ = true;
+  Buffer::OwnedImpl chunk_2("later");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_2, false));
+  last_request_processed_ = true;
+
+  EXPECT_CALL(decoder_callbacks_,
+              injectDecodedDataToFilterChain(BufferStringEqual("twelve bytes"), false));
+  EXPECT_CALL(decoder_callbacks_, onDecoderFilterBelowWriteBufferLowWatermark());
+  auto response = requestBodyResponse();
+  response->mutable_mode_override()->set_request_body_mode(ProcessingMode::NONE);
+  response->mutable_mode_override()->set_response_header_mode(ProcessingMode::SKIP);
+  stream_callbacks_->onReceiveMessage(std::move(response));
+
+  // The rest of the body isn't sent, but waits for the chunk the processor was sent.
+  Buffer::OwnedImpl chunk_3("rest");
+  EXPECT_EQ(FilterDataStatus::StopIterationNoBuffer, filter_->decodeData(chunk_3, true));
+  EXPECT_TRUE(last_request_processed_);
+
+  EXPECT_CALL(decoder_callbacks_,
+              injectDecodedDataToFilterChain(BufferStringEqual("later"), false));
+  EXPECT_CALL(decoder_callbacks_, injectDecodedDataToFilterChain(BufferStringEqual("rest"), true));
+  stream_callbacks_->onReceiveMessage(requestBodyResponse());
+
+  EXPECT_EQ(FilterHeadersStatus::Continue, filter_->encodeHeaders(response_headers_, true));
+  filter_->onDestroy();
   EXPECT_EQ(2, config_->stats().stream_msgs_sent_.value());
   EXPECT_EQ(2, config_->stats().stream_msgs_received_.value());
-  EXPECT_EQ(1, config_->stats().streams_closed_.value());
 }
 
 // Using the default configuration, test the filter with a processor that
@@ -1211,6 +1211,28 @@ TEST_F(FaultFilterTest, RouteFaultOverridesListenerFault) {
   }
 }
 
+// A route which overrides the faults of the filter with empty settings skips the filter without
+// evaluating the request.
+TEST_F(FaultFilterTest, RouteWithoutFaultsSkipsFilter) {
+  Fault::FaultSettings empty_fault(convertYamlStrToProtoConfig(v2_empty_fault_config_yaml));
+  setUpTest(fixed_delay_and_abort_yaml);
+  ON_CALL(decoder_filter_callbacks_.route_->route_entry_,
+          perFilterConfig(Extensions::HttpFilters::HttpFilterNames::get().Fault))
+      .WillByDefault(Return(&empty_fault));
+
+  request_headers_.addCopy("x-envoy-downstream-service-cluster", "cluster");
+  EXPECT_CALL(runtime_.snapshot_,
+              featureEnabled(_, testing::Matcher<const envoy::type::v3::FractionalPercent&>(_)))
+      .Times(0);
+  EXPECT_CALL(runtime_.snapshot_, getInteger(_, _)).Times(0);
+  EXPECT_CALL(decoder_filter_callbacks_.dispatcher_, createTimer_(_)).Times(0);
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers_, false));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data_, false));
+  EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_trailers_));
+  EXPECT_EQ(0UL, config_->stats().active_faults_.value());
+}
+
 class FaultFilterRateLimitTest : public FaultFilterTest {
 public:
   void setupRateLimitTest(bool enable_runtime) {
@@ -0,0 +1,74 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the cost of transcoding unary requests and responses with MB-sized messages.
+
+#include "envoy/extensions/filters/http/grpc_json_transcoder/v3/transcoder.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/grpc/common.h"
+
+#include "extensions/filters/http/grpc_json_transcoder/json_transcoder_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/proto/bookstore.pb.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace GrpcJsonTranscoder {
+namespace {
+
+// Argument is the size of the string field of the messages, in KiB.
+static void bmTranscodeUnary(benchmark::State& state) {
+  const std::string theme(state.range(0) * 1024, 'a');
+  const std::string request_json = absl::StrCat("{\"theme\": \"", theme, "\"}");
+  bookstore::Shelf response;
+  response.set_id(20);
+  response.set_theme(theme);
+
+  Api::ApiPtr api = Api::createApiForTest();
+  envoy::extensions::filters::http::grpc_json_transcoder::v3::GrpcJsonTranscoder proto_config;
+  proto_config.set_proto_descriptor(
+      TestEnvironment::runfilesPath("test/proto/bookstore.descriptor"));
+  proto_config.add_services("bookstore.Bookstore");
+  JsonTranscoderConfig config(proto_config, *api);
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+  ON_CALL(decoder_callbacks, decoderBufferLimit()).WillByDefault(Return(64 << 20));
+  ON_CALL(encoder_callbacks, encoderBufferLimit()).WillByDefault(Return(64 << 20));
+
+  for (auto _ : state) { // NOLINT
+    JsonTranscoderFilter filter(config);
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+
+    Http::TestRequestHeaderMapImpl request_headers{
+        {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
+    filter.decodeHeaders(request_headers, false);
+    Buffer::OwnedImpl request_data(request_json);
+    filter.decodeData(request_data, true);
+
+    Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                     {":status", "200"}};
+    filter.encodeHeaders(response_headers, false);
+    Buffer::InstancePtr response_data = Grpc::Common::serializeToGrpcFrame(response);
+    filter.encodeData(*response_data, false);
+    benchmark::DoNotOptimize(request_data.length() + response_data->length());
+  }
+}
+BENCHMARK(bmTranscodeUnary)->Arg(1)->Arg(64)->Arg(1024)->Arg(4096)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace GrpcJsonTranscoder
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
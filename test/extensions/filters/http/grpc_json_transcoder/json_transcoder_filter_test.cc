@@ -32,8 +32,6 @@ using Envoy::Protobuf::FileDescriptorSet;
 using Envoy::Protobuf::util::MessageDifferencer;
 using Envoy::ProtobufUtil::error::Code;
 using google::api::HttpRule;
-using google::grpc::transcoding::Transcoder;
-using TranscoderPtr = std::unique_ptr<Transcoder>;
 
 namespace Envoy {
 namespace Extensions {
@@ -225,7 +223,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, CreateTranscoder) {
   Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves"}};
 
   TranscoderInputStreamImpl request_in, response_in;
-  TranscoderPtr transcoder;
+  MessageTranscoderPtr transcoder;
   MethodInfoSharedPtr method_info;
   const auto status =
       config.createTranscoder(headers, request_in, response_in, transcoder, method_info);
@@ -246,7 +244,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, CreateTranscoderAutoMap) {
                                          {":path", "/bookstore.Bookstore/DeleteShelf"}};
 
   TranscoderInputStreamImpl request_in, response_in;
-  TranscoderPtr transcoder;
+  MessageTranscoderPtr transcoder;
   MethodInfoSharedPtr method_info;
   const auto status =
       config.createTranscoder(headers, request_in, response_in, transcoder, method_info);
@@ -265,7 +263,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, InvalidQueryParameter) {
   Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves?foo=bar"}};
 
   TranscoderInputStreamImpl request_in, response_in;
-  TranscoderPtr transcoder;
+  MessageTranscoderPtr transcoder;
   MethodInfoSharedPtr method_info;
   const auto status =
       config.createTranscoder(headers, request_in, response_in, transcoder, method_info);
@@ -285,7 +283,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, UnknownQueryParameterIsIgnored) {
   Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves?foo=bar"}};
 
   TranscoderInputStreamImpl request_in, response_in;
-  TranscoderPtr transcoder;
+  MessageTranscoderPtr transcoder;
   MethodInfoSharedPtr method_info;
   const auto status =
       config.createTranscoder(headers, request_in, response_in, transcoder, method_info);
@@ -304,7 +302,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, IgnoredQueryParameter) {
   Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/shelves?key=API_KEY"}};
 
   TranscoderInputStreamImpl request_in, response_in;
-  TranscoderPtr transcoder;
+  MessageTranscoderPtr transcoder;
   MethodInfoSharedPtr method_info;
   const auto status =
       config.createTranscoder(headers, request_in, response_in, transcoder, method_info);
@@ -326,7 +324,7 @@ TEST_F(GrpcJsonTranscoderConfigTest, InvalidVariableBinding) {
   Http::TestRequestHeaderMapImpl headers{{":method", "GET"}, {":path", "/book/1"}};
 
   TranscoderInputStreamImpl request_in, response_in;
-  TranscoderPtr transcoder;
+  MessageTranscoderPtr transcoder;
   MethodInfoSharedPtr method_info;
   const auto status =
       config.createTranscoder(headers, request_in, response_in, transcoder, method_info);
@@ -527,6 +525,41 @@ TEST_F(GrpcJsonTranscoderFilterTest, TranscodingUnaryPost) {
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_.decodeTrailers(request_trailers));
 }
 
+// Large transcoded messages are moved into the buffer as a single slice rather than copied.
+TEST_F(GrpcJsonTranscoderFilterTest, TranscodingLargeMessages) {
+  const std::string theme(256 * 1024, 'a');
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"content-type", "application/json"}, {":method", "POST"}, {":path", "/shelf"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_.decodeHeaders(request_headers, false));
+
+  Buffer::OwnedImpl request_data{absl::StrCat("{\"theme\": \"", theme, "\"}")};
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_.decodeData(request_data, true));
+  EXPECT_EQ(1, request_data.getRawSlices().size());
+
+  Grpc::Decoder decoder;
+  std::vector<Grpc::Frame> frames;
+  decoder.decode(request_data, frames);
+  ASSERT_EQ(1, frames.size());
+  bookstore::CreateShelfRequest request;
+  request.ParseFromString(frames[0].data_->toString());
+  EXPECT_EQ(theme, request.shelf().theme());
+
+  Http::TestResponseHeaderMapImpl response_headers{{"content-type", "application/grpc"},
+                                                   {":status", "200"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::StopIteration,
+            filter_.encodeHeaders(response_headers, false));
+
+  bookstore::Shelf response;
+  response.set_id(20);
+  response.set_theme(theme);
+  auto response_data = Grpc::Common::serializeToGrpcFrame(response);
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndBuffer,
+            filter_.encodeData(*response_data, false));
+  EXPECT_EQ(1, response_data->getRawSlices().size());
+  EXPECT_EQ(absl::StrCat("{\"id\":\"20\",\"theme\":\"", theme, "\"}"),
+            response_data->toString());
+}
+
 TEST_F(GrpcJsonTranscoderFilterTest, TranscodingUnaryPostWithPackageServiceMethodPath) {
   Http::TestRequestHeaderMapImpl request_headers{
       {"content-type", "application/json"},
@@ -213,17 +213,47 @@ ip_tags:
 
   EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
 
-  // There is no guarantee for the order tags are returned by the LC-Trie.
-  const std::string header_tag_data = request_headers.get_(Http::Headers::get().EnvoyIpTags.get());
-  EXPECT_NE(std::string::npos, header_tag_data.find("test"));
-  EXPECT_NE(std::string::npos, header_tag_data.find("internal_request"));
-  EXPECT_NE(std::string::npos, header_tag_data.find("duplicate_request"));
+  // The tags are in the order of the configuration.
+  EXPECT_EQ("test,duplicate_request,internal_request",
+            request_headers.get_(Http::Headers::get().EnvoyIpTags.get()));
 
   EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(data_, false));
   Http::TestRequestTrailerMapImpl request_trailers;
   EXPECT_EQ(Http::FilterTrailersStatus::Continue, filter_->decodeTrailers(request_trailers));
 }
 
+// A tag listed several times is only added and counted once.
+TEST_F(IpTaggingFilterTest, SameTagListedTwice) {
+  const std::string same_tag_yaml = R"EOF(
+request_type: both
+ip_tags:
+  - ip_tag_name: internal_request
+    ip_list:
+      - {address_prefix: 1.2.3.0, prefix_len: 24}
+  - ip_tag_name: other_request
+    ip_list:
+      - {address_prefix: 1.2.0.0, prefix_len: 16}
+  - ip_tag_name: internal_request
+    ip_list:
+      - {address_prefix: 1.2.3.4, prefix_len: 32}
+)EOF";
+
+  initializeFilter(same_tag_yaml);
+  Http::TestRequestHeaderMapImpl request_headers;
+
+  Network::Address::InstanceConstSharedPtr remote_address =
+      Network::Utility::parseInternetAddress("1.2.3.4");
+  filter_callbacks_.stream_info_.downstream_address_provider_->setRemoteAddress(remote_address);
+
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.total"));
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.internal_request.hit"));
+  EXPECT_CALL(stats_, counter("prefix.ip_tagging.other_request.hit"));
+
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(request_headers, false));
+  EXPECT_EQ("internal_request,other_request",
+            request_headers.get_(Http::Headers::get().EnvoyIpTags.get()));
+}
+
 TEST_F(IpTaggingFilterTest, Ipv6Address) {
   const std::string ipv6_addresses_yaml = R"EOF(
 ip_tags:
@@ -111,6 +111,33 @@ TEST_F(AuthenticatorTest, TestOkJWTandCache) {
   }
 }
 
+// This test verifies the verified tokens are cached when jwt_cache_config is set.
+TEST_F(AuthenticatorTest, TestJwtCache) {
+  (*proto_config_.mutable_providers())[std::string(ProviderName)].mutable_jwt_cache_config();
+  createAuthenticator();
+  EXPECT_CALL(*raw_fetcher_, fetch(_, _, _))
+      .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                              JwksFetcher::JwksReceiver& receiver) {
+        receiver.onJwksSuccess(std::move(jwks_));
+      }));
+
+  auto* jwks_data = filter_config_->getCache().getJwksCache().findByProvider(ProviderName);
+  EXPECT_FALSE(jwks_data->isTokenVerified(GoodToken));
+  for (int i = 0; i < 2; i++) {
+    Http::TestRequestHeaderMapImpl headers{{"Authorization", "Bearer " + std::string(GoodToken)}};
+    expectVerifyStatus(Status::Ok, headers);
+    EXPECT_TRUE(jwks_data->isTokenVerified(GoodToken));
+    // The payload of a cached token is still forwarded.
+    EXPECT_EQ(headers.get_("sec-istio-auth-userinfo"), ExpectedPayloadValue);
+  }
+
+  // A token whose claims are rejected isn't cached.
+  Http::TestRequestHeaderMapImpl headers{
+      {"Authorization", "Bearer " + std::string(InvalidAudToken)}};
+  expectVerifyStatus(Status::JwtAudienceNotAllowed, headers);
+  EXPECT_FALSE(jwks_data->isTokenVerified(InvalidAudToken));
+}
+
 // This test verifies the Jwt is forwarded if "forward" flag is set.
 TEST_F(AuthenticatorTest, TestForwardJwt) {
   // Config forward_jwt flag
@@ -0,0 +1,126 @@
+#include "envoy/extensions/filters/http/jwt_authn/v3/config.pb.h"
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/http/jwt_authn/jwks_async_fetcher.h"
+
+#include "test/extensions/filters/http/common/mock.h"
+#include "test/extensions/filters/http/jwt_authn/test_common.h"
+#include "test/mocks/init/mocks.h"
+#include "test/mocks/server/factory_context.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using envoy::extensions::filters::http::jwt_authn::v3::RemoteJwks;
+using Envoy::Extensions::HttpFilters::Common::JwksFetcher;
+using Envoy::Extensions::HttpFilters::Common::MockJwksFetcher;
+using ::google::jwt_verify::Jwks;
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace JwtAuthn {
+namespace {
+
+const char RemoteJwksConfig[] = R"(
+http_uri:
+  uri: https://pubkey_server/pubkey_path
+  cluster: pubkey_cluster
+  timeout:
+    seconds: 5
+cache_duration:
+  seconds: 60
+async_fetch:
+  failed_refetch_duration:
+    seconds: 2
+)";
+
+class JwksAsyncFetcherTest : public testing::Test {
+public:
+  JwksAsyncFetcherTest()
+      : stats_{ALL_JWT_AUTHN_FILTER_STATS(POOL_COUNTER_PREFIX(store_, "jwt_authn."))} {
+    TestUtility::loadFromYaml(RemoteJwksConfig, remote_jwks_);
+  }
+
+  void createFetcher() {
+    timer_ = new NiceMock<Event::MockTimer>(&context_.dispatcher_);
+    fetcher_ = std::make_unique<JwksAsyncFetcher>(
+        remote_jwks_, context_,
+        [this](Upstream::ClusterManager&) {
+          auto fetcher = std::make_unique<NiceMock<MockJwksFetcher>>();
+          EXPECT_CALL(*fetcher, fetch(_, _, _))
+              .WillOnce(Invoke([this](const envoy::config::core::v3::HttpUri&, Tracing::Span&,
+                                      JwksFetcher::JwksReceiver& receiver) {
+                fetch_count_++;
+                receiver_ = &receiver;
+              }));
+          return fetcher;
+        },
+        stats_, [this](::google::jwt_verify::JwksPtr&& jwks) { fetched_jwks_ = std::move(jwks); });
+  }
+
+  Stats::IsolatedStoreImpl store_;
+  JwtAuthnFilterStats stats_;
+  RemoteJwks remote_jwks_;
+  NiceMock<Server::Configuration::MockFactoryContext> context_;
+  Event::MockTimer* timer_{};
+  JwksAsyncFetcherPtr fetcher_;
+  JwksFetcher::JwksReceiver* receiver_{};
+  uint32_t fetch_count_{};
+  ::google::jwt_verify::JwksPtr fetched_jwks_;
+};
+
+// The listener waits for the first fetch, which is retried after a failure.
+TEST_F(JwksAsyncFetcherTest, WaitsForFirstFetch) {
+  Init::TargetHandlePtr init_target_handle;
+  EXPECT_CALL(context_.init_manager_, add(_)).WillOnce(Invoke([&](const Init::Target& target) {
+    init_target_handle = target.createHandle("test");
+  }));
+  createFetcher();
+  EXPECT_EQ(0U, fetch_count_);
+
+  Init::ExpectableWatcherImpl init_watcher;
+  init_target_handle->initialize(init_watcher);
+  EXPECT_EQ(1U, fetch_count_);
+
+  EXPECT_CALL(init_watcher, ready());
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(2000), _));
+  receiver_->onJwksError(JwksFetcher::JwksReceiver::Failure::Network);
+  EXPECT_EQ(1UL, stats_.jwks_fetch_failed_.value());
+  EXPECT_EQ(nullptr, fetched_jwks_);
+
+  timer_->invokeCallback();
+  EXPECT_EQ(2U, fetch_count_);
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(60000), _));
+  receiver_->onJwksSuccess(Jwks::createFrom(PublicKey, Jwks::JWKS));
+  EXPECT_EQ(1UL, stats_.jwks_fetch_success_.value());
+  EXPECT_NE(nullptr, fetched_jwks_);
+}
+
+// With fast_listener, the JWKS is fetched right away and then every cache_duration.
+TEST_F(JwksAsyncFetcherTest, FastListener) {
+  remote_jwks_.mutable_async_fetch()->set_fast_listener(true);
+  EXPECT_CALL(context_.init_manager_, add(_)).Times(0);
+  createFetcher();
+  EXPECT_EQ(1U, fetch_count_);
+
+  for (int i = 0; i < 2; i++) {
+    EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds(60000), _));
+    receiver_->onJwksSuccess(Jwks::createFrom(PublicKey, Jwks::JWKS));
+    EXPECT_NE(nullptr, fetched_jwks_);
+    fetched_jwks_.reset();
+    timer_->invokeCallback();
+  }
+  EXPECT_EQ(3U, fetch_count_);
+  EXPECT_EQ(2UL, stats_.jwks_fetch_success_.value());
+}
+
+} // namespace
+} // namespace JwtAuthn
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
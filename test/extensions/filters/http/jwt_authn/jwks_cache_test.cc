@@ -111,6 +111,18 @@ TEST_F(JwksCacheTest, TestSetRemoteJwksWithDefaultCacheDuration) {
   EXPECT_FALSE(jwks->isExpired());
 }
 
+// Test setFetchedJwks: the Jwks doesn't expire.
+TEST_F(JwksCacheTest, TestSetFetchedJwks) {
+  auto jwks = cache_->findByIssuer("https://example.com");
+  EXPECT_TRUE(jwks->getJwksObj() == nullptr);
+
+  JwksConstSharedPtr fetched_jwks = std::move(jwks_);
+  jwks->setFetchedJwks(fetched_jwks);
+  EXPECT_EQ(jwks->getJwksObj(), fetched_jwks.get());
+  time_system_.advanceTimeWait(std::chrono::seconds(3600));
+  EXPECT_FALSE(jwks->isExpired());
+}
+
 // Test a good local jwks
 TEST_F(JwksCacheTest, TestGoodInlineJwks) {
   auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
@@ -138,6 +150,40 @@ TEST_F(JwksCacheTest, TestBadInlineJwks) {
   EXPECT_TRUE(jwks->getJwksObj() == nullptr);
 }
 
+// Test the cache of the verified tokens.
+TEST_F(JwksCacheTest, TestVerifiedTokens) {
+  auto jwks = cache_->findByIssuer("https://example.com");
+  // The tokens aren't cached without jwt_cache_config.
+  jwks->addVerifiedToken("token1", 0);
+  EXPECT_FALSE(jwks->isTokenVerified("token1"));
+
+  auto& provider0 = (*config_.mutable_providers())[std::string(ProviderName)];
+  provider0.mutable_jwt_cache_config()->set_jwt_cache_size(2);
+  cache_ = JwksCache::create(config_, time_system_, *api_);
+  jwks = cache_->findByIssuer("https://example.com");
+  EXPECT_EQ(jwks->setRemoteJwks(std::move(jwks_))->getStatus(), Status::Ok);
+
+  // The expired token is forgotten first when the cache is full.
+  const uint64_t now = DateUtil::nowToSeconds(time_system_);
+  jwks->addVerifiedToken("token1", now - 1);
+  jwks->addVerifiedToken("token2", 0);
+  jwks->addVerifiedToken("token3", now + 10);
+  EXPECT_FALSE(jwks->isTokenVerified("token1"));
+  EXPECT_TRUE(jwks->isTokenVerified("token2"));
+  EXPECT_TRUE(jwks->isTokenVerified("token3"));
+  EXPECT_FALSE(jwks->isTokenVerified("token4"));
+
+  // The cache is bounded.
+  jwks->addVerifiedToken("token4", 0);
+  EXPECT_TRUE(jwks->isTokenVerified("token4"));
+  EXPECT_FALSE(jwks->isTokenVerified("token2") && jwks->isTokenVerified("token3"));
+
+  // A new Jwks clears the cache.
+  jwks->setRemoteJwks(
+      google::jwt_verify::Jwks::createFrom(PublicKey, google::jwt_verify::Jwks::JWKS));
+  EXPECT_FALSE(jwks->isTokenVerified("token4"));
+}
+
 // Test audiences with different formats
 TEST_F(JwksCacheTest, TestAudiences) {
   auto jwks = cache_->findByIssuer("https://example.com");
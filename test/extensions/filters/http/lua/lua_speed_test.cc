@@ -0,0 +1,84 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+
+#include "common/common/fmt.h"
+
+#include "extensions/filters/common/lua/lua.h"
+#include "extensions/filters/http/lua/wrappers.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Lua {
+
+// Runs a script that reads the request headers one by one or all at once, in a new coroutine per
+// request, as the filter does.
+class LuaSpeedTest {
+public:
+  LuaSpeedTest(const std::string& function) : state_(Script, tls_) {
+    state_.registerType<HeaderMapWrapper>();
+    state_.registerType<HeaderMapIterator>();
+    slot_ = state_.registerGlobal(function, {});
+    for (size_t i = 0; i < NumHeaders; ++i) {
+      headers_.addCopy(Http::LowerCaseString(fmt::format("x-header-{}", i)), "value");
+    }
+  }
+
+  void runRequest() {
+    Filters::Common::Lua::CoroutinePtr coroutine = state_.createCoroutine();
+    Filters::Common::Lua::LuaDeathRef<HeaderMapWrapper> wrapper(
+        HeaderMapWrapper::create(coroutine->luaState(), headers_, []() { return false; }), true);
+    coroutine->start(state_.getGlobalRef(slot_), 1, []() {});
+    wrapper.markDead();
+  }
+
+  static constexpr size_t NumHeaders = 20;
+  static constexpr const char* Script = R"EOF(
+    function get_each(headers)
+      local count = 0
+      for i = 0, 19 do
+        if headers:get("x-header-" .. i) ~= nil then
+          count = count + 1
+        end
+      end
+      return count
+    end
+
+    function get_all(headers)
+      local count = 0
+      local all = headers:toTable()
+      for i = 0, 19 do
+        if all["x-header-" .. i] ~= nil then
+          count = count + 1
+        end
+      end
+      return count
+    end
+  )EOF";
+
+  testing::NiceMock<ThreadLocal::MockInstance> tls_;
+  Filters::Common::Lua::ThreadLocalState state_;
+  uint64_t slot_;
+  Http::TestRequestHeaderMapImpl headers_;
+};
+
+} // namespace Lua
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
+
+static void bmLuaHeaderAccess(benchmark::State& state) {
+  Envoy::Extensions::HttpFilters::Lua::LuaSpeedTest speed_test(state.range(0) ? "get_all"
+                                                                              : "get_each");
+  for (auto _ : state) {
+    speed_test.runRequest();
+  }
+}
+BENCHMARK(bmLuaHeaderAccess)->Arg(false)->Arg(true);
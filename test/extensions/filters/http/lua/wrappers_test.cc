@@ -69,6 +69,29 @@ TEST_F(LuaHeaderMapWrapperTest, Methods) {
   start("callMe");
 }
 
+// Get all the headers at once.
+TEST_F(LuaHeaderMapWrapperTest, ToTable) {
+  const std::string SCRIPT{R"EOF(
+    function callMe(object)
+      local headers = object:toTable()
+      testPrint(headers["hello"])
+      testPrint(headers["header1"])
+      testPrint(tostring(headers["header2"]))
+    end
+  )EOF"};
+
+  InSequence s;
+  setup(SCRIPT);
+
+  Http::TestRequestHeaderMapImpl headers{
+      {"hello", "world"}, {"header1", "foo"}, {"header1", "bar"}};
+  HeaderMapWrapper::create(coroutine_->luaState(), headers, []() { return true; });
+  EXPECT_CALL(printer_, testPrint("world"));
+  EXPECT_CALL(printer_, testPrint("foo,bar"));
+  EXPECT_CALL(printer_, testPrint("nil"));
+  start("callMe");
+}
+
 // Test modifiable methods.
 TEST_F(LuaHeaderMapWrapperTest, ModifiableMethods) {
   const std::string SCRIPT{R"EOF(
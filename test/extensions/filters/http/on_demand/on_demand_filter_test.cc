@@ -5,12 +5,17 @@
 #include "extensions/filters/http/on_demand/on_demand_update.h"
 
 #include "test/mocks/http/mocks.h"
+#include "test/mocks/protobuf/mocks.h"
 #include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+#include "test/mocks/upstream/od_cds_api_handle.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
+using testing::Eq;
 using testing::Return;
 
 namespace Envoy {
@@ -21,10 +26,36 @@ namespace OnDemand {
 class OnDemandFilterTest : public testing::Test {
 public:
   void SetUp() override {
-    filter_ = std::make_unique<OnDemandRouteUpdate>();
+    setupFilter(envoy::extensions::filters::http::on_demand::v3::OnDemand());
+  }
+
+  void setupFilter(const envoy::extensions::filters::http::on_demand::v3::OnDemand& proto_config) {
+    auto config = std::make_shared<const OnDemandFilterConfig>(proto_config, cm_, visitor_);
+    filter_ = std::make_unique<OnDemandRouteUpdate>(config);
     filter_->setDecoderFilterCallbacks(decoder_callbacks_);
   }
 
+  // Configures on-demand cluster discovery and requests the cluster of a route that the cluster
+  // manager doesn't know yet.
+  void requestClusterDiscovery() {
+    envoy::extensions::filters::http::on_demand::v3::OnDemand proto_config;
+    proto_config.mutable_odcds()->mutable_source()->mutable_ads();
+    EXPECT_CALL(cm_, allocateOdCdsApi(_, std::chrono::milliseconds(0), _))
+        .WillOnce(Return(odcds_));
+    setupFilter(proto_config);
+
+    Http::TestRequestHeaderMapImpl headers;
+    EXPECT_CALL(decoder_callbacks_, clusterInfo()).WillOnce(Return(nullptr));
+    EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery_(Eq("fake_cluster"), _,
+                                                          std::chrono::milliseconds(5000)))
+        .WillOnce(Return(new NiceMock<Upstream::MockClusterDiscoveryCallbackHandle>()));
+    EXPECT_EQ(Http::FilterHeadersStatus::StopIteration, filter_->decodeHeaders(headers, true));
+  }
+
+  NiceMock<Upstream::MockClusterManager> cm_;
+  NiceMock<ProtobufMessage::MockValidationVisitor> visitor_;
+  std::shared_ptr<Upstream::MockOdCdsApiHandle> odcds_{
+      std::make_shared<NiceMock<Upstream::MockOdCdsApiHandle>>()};
   std::unique_ptr<OnDemandRouteUpdate> filter_;
   NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
 };
@@ -102,6 +133,88 @@ TEST_F(OnDemandFilterTest, OnRouteConfigUpdateCompletionRestartsActiveStream) {
   filter_->onRouteConfigUpdateCompletion(true);
 }
 
+// tests decodeHeaders() when the cluster of the route is known and odcds is configured
+TEST_F(OnDemandFilterTest, TestDecodeHeadersWhenClusterAvailable) {
+  envoy::extensions::filters::http::on_demand::v3::OnDemand proto_config;
+  proto_config.mutable_odcds()->mutable_source()->mutable_ads();
+  EXPECT_CALL(cm_, allocateOdCdsApi(_, _, _)).WillOnce(Return(odcds_));
+  setupFilter(proto_config);
+
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_CALL(*odcds_, requestOnDemandClusterDiscovery_(_, _, _)).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, true));
+}
+
+// tests decodeHeaders() when the cluster of the route is unknown and odcds isn't configured
+TEST_F(OnDemandFilterTest, TestDecodeHeadersWhenClusterMissingWithoutOdCds) {
+  Http::TestRequestHeaderMapImpl headers;
+  EXPECT_CALL(decoder_callbacks_, clusterInfo()).Times(0);
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, true));
+}
+
+// tests decodeHeaders() when the cluster of the route is unknown and odcds is configured
+TEST_F(OnDemandFilterTest, TestDecodeHeadersRequestsClusterDiscovery) {
+  requestClusterDiscovery();
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(Http::FilterDataStatus::StopIterationAndWatermark, filter_->decodeData(buffer, false));
+}
+
+// tests onClusterDiscoveryCompletion() when the cluster was discovered
+TEST_F(OnDemandFilterTest, OnClusterDiscoveryCompletionRestartsActiveStream) {
+  requestClusterDiscovery();
+
+  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillOnce(Return(nullptr));
+  EXPECT_CALL(decoder_callbacks_, recreateStream(_)).WillOnce(Return(true));
+  EXPECT_CALL(decoder_callbacks_, continueDecoding()).Times(0);
+  filter_->onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus::Available);
+}
+
+// tests onClusterDiscoveryCompletion() when the cluster was discovered and the request has a body
+TEST_F(OnDemandFilterTest, OnClusterDiscoveryCompletionContinuesDecodingWithBody) {
+  requestClusterDiscovery();
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_CALL(decoder_callbacks_, decodingBuffer()).WillOnce(Return(&buffer));
+  EXPECT_CALL(decoder_callbacks_, clearRouteCache());
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  filter_->onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus::Available);
+}
+
+// tests onClusterDiscoveryCompletion() when the discovery service doesn't know the cluster
+TEST_F(OnDemandFilterTest, OnClusterDiscoveryCompletionContinuesDecodingWhenClusterMissing) {
+  requestClusterDiscovery();
+
+  EXPECT_CALL(decoder_callbacks_, recreateStream(_)).Times(0);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  filter_->onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus::Missing);
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->decodeData(buffer, false));
+}
+
+// tests onClusterDiscoveryCompletion() when the discovery timed out
+TEST_F(OnDemandFilterTest, OnClusterDiscoveryCompletionContinuesDecodingOnTimeout) {
+  requestClusterDiscovery();
+
+  EXPECT_CALL(decoder_callbacks_, recreateStream(_)).Times(0);
+  EXPECT_CALL(decoder_callbacks_, continueDecoding());
+  filter_->onClusterDiscoveryCompletion(Upstream::ClusterDiscoveryStatus::Timeout);
+}
+
+// tests the idle and discovery timeouts of the odcds configuration
+TEST_F(OnDemandFilterTest, OdCdsTimeouts) {
+  envoy::extensions::filters::http::on_demand::v3::OnDemand proto_config;
+  proto_config.mutable_odcds()->mutable_source()->mutable_ads();
+  proto_config.mutable_odcds()->mutable_timeout()->set_seconds(1);
+  proto_config.mutable_odcds()->mutable_idle_timeout()->set_seconds(60);
+  EXPECT_CALL(cm_, allocateOdCdsApi(_, std::chrono::milliseconds(60000), _))
+      .WillOnce(Return(odcds_));
+  const OnDemandFilterConfig config(proto_config, cm_, visitor_);
+  EXPECT_EQ(odcds_, config.odcds());
+  EXPECT_EQ(std::chrono::milliseconds(1000), config.odcdsTimeout());
+}
+
 } // namespace OnDemand
 } // namespace HttpFilters
 } // namespace Extensions
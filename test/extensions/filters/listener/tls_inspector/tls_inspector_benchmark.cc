@@ -69,10 +69,9 @@ public:
   const std::vector<uint8_t> client_hello_;
 };
 
-static void BM_TlsInspector(benchmark::State& state) {
-  NiceMock<FastMockOsSysCalls> os_sys_calls(Tls::Test::generateClientHello(
-      Config::TLS_MIN_SUPPORTED_VERSION, Config::TLS_MAX_SUPPORTED_VERSION, "example.com",
-      "\x02h2\x08http/1.1"));
+static void benchmarkTlsInspector(benchmark::State& state,
+                                  const std::vector<uint8_t>& client_hello) {
+  NiceMock<FastMockOsSysCalls> os_sys_calls(client_hello);
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls{&os_sys_calls};
   NiceMock<Stats::MockStore> store;
   ConfigSharedPtr cfg(std::make_shared<Config>(store));
@@ -97,8 +96,25 @@ static void BM_TlsInspector(benchmark::State& state) {
   }
 }
 
+static std::vector<uint8_t> clientHello() {
+  return Tls::Test::generateClientHello(Config::TLS_MIN_SUPPORTED_VERSION,
+                                        Config::TLS_MAX_SUPPORTED_VERSION, "example.com",
+                                        "\x02h2\x08http/1.1");
+}
+
+static void BM_TlsInspector(benchmark::State& state) {
+  benchmarkTlsInspector(state, clientHello());
+}
+
 BENCHMARK(BM_TlsInspector)->Unit(benchmark::kMicrosecond);
 
+// The fragmented ClientHellos are parsed by BoringSSL.
+static void BM_TlsInspectorBoringSsl(benchmark::State& state) {
+  benchmarkTlsInspector(state, Tls::Test::fragmentClientHello(clientHello(), 64));
+}
+
+BENCHMARK(BM_TlsInspectorBoringSsl)->Unit(benchmark::kMicrosecond);
+
 } // namespace TlsInspector
 } // namespace ListenerFilters
 } // namespace Extensions
@@ -1,5 +1,7 @@
 #include "test/extensions/filters/listener/tls_inspector/tls_utility.h"
 
+#include <algorithm>
+
 #include "common/common/assert.h"
 
 #include "openssl/ssl.h"
@@ -40,6 +42,22 @@ std::vector<uint8_t> generateClientHello(uint16_t tls_min_version, uint16_t tls_
   return buf;
 }
 
+std::vector<uint8_t> fragmentClientHello(const std::vector<uint8_t>& client_hello,
+                                         size_t fragment_size) {
+  ASSERT(client_hello.size() > SSL3_RT_HEADER_LENGTH);
+  std::vector<uint8_t> buf;
+  for (size_t offset = SSL3_RT_HEADER_LENGTH; offset < client_hello.size();
+       offset += fragment_size) {
+    const size_t length = std::min(fragment_size, client_hello.size() - offset);
+    // The content type and the version of the record.
+    buf.insert(buf.end(), client_hello.begin(), client_hello.begin() + 3);
+    buf.push_back(length >> 8);
+    buf.push_back(length & 0xff);
+    buf.insert(buf.end(), client_hello.begin() + offset, client_hello.begin() + offset + length);
+  }
+  return buf;
+}
+
 } // namespace Test
 } // namespace Tls
 } // namespace Envoy
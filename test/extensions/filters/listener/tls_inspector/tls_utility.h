@@ -19,6 +19,14 @@ namespace Test {
 std::vector<uint8_t> generateClientHello(uint16_t tls_min_version, uint16_t tls_max_version,
                                          const std::string& sni_name, const std::string& alpn);
 
+/**
+ * Fragment a ClientHello generated by generateClientHello() over several TLS records.
+ * @param client_hello The ClientHello, in a single record.
+ * @param fragment_size The maximum size of the fragment of the handshake message in each record.
+ */
+std::vector<uint8_t> fragmentClientHello(const std::vector<uint8_t>& client_hello,
+                                         size_t fragment_size);
+
 } // namespace Test
 } // namespace Tls
 } // namespace Envoy
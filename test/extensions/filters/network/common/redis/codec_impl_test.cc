@@ -397,6 +397,38 @@ TEST_F(RedisEncoderDecoderImplTest, NestedArray) {
   EXPECT_EQ(value, *decoded_values_[0]);
 }
 
+TEST_F(RedisEncoderDecoderImplTest, SplitSimpleStrings) {
+  // Each value spans slices, and the second slice ends one value and starts the next.
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("+simple ");
+  buffer.appendSliceForTest("string\r\n-err");
+  buffer.appendSliceForTest("or\r");
+  buffer.appendSliceForTest("\n");
+  decoder_.decode(buffer);
+  EXPECT_EQ(0UL, buffer.length());
+
+  ASSERT_EQ(2UL, decoded_values_.size());
+  EXPECT_EQ(RespType::SimpleString, decoded_values_[0]->type());
+  EXPECT_EQ("simple string", decoded_values_[0]->asString());
+  EXPECT_EQ(RespType::Error, decoded_values_[1]->type());
+  EXPECT_EQ("error", decoded_values_[1]->asString());
+}
+
+TEST_F(RedisEncoderDecoderImplTest, SplitBulkStringArrays) {
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest("*2\r\n$3\r\nget\r\n$5\r\nhe");
+  buffer.appendSliceForTest("llo\r\n*1\r\n$4\r\nping\r\n");
+  decoder_.decode(buffer);
+  EXPECT_EQ(0UL, buffer.length());
+
+  ASSERT_EQ(2UL, decoded_values_.size());
+  ASSERT_EQ(2UL, decoded_values_[0]->asArray().size());
+  EXPECT_EQ("get", decoded_values_[0]->asArray()[0].asString());
+  EXPECT_EQ("hello", decoded_values_[0]->asArray()[1].asString());
+  ASSERT_EQ(1UL, decoded_values_[1]->asArray().size());
+  EXPECT_EQ("ping", decoded_values_[1]->asArray()[0].asString());
+}
+
 TEST_F(RedisEncoderDecoderImplTest, NullArray) {
   buffer_.add("*-1\r\n");
   decoder_.decode(buffer_);
@@ -88,9 +88,11 @@ public:
   MOCK_METHOD(PoolRequest*, makeRequest_,
               (const Common::Redis::RespValue& request, ClientCallbacks& callbacks));
   MOCK_METHOD(void, initialize, (const std::string& username, const std::string& password));
+  void setPushCallbacks(PushCallbacks& callbacks) override { push_callbacks_ = &callbacks; }
 
   std::list<Network::ConnectionCallbacks*> callbacks_;
   std::list<ClientCallbacks*> client_callbacks_;
+  PushCallbacks* push_callbacks_{};
 };
 
 class MockClientCallbacks : public ClientCallbacks {
@@ -78,6 +78,28 @@ TEST(RpcInvocationImplAttachmentTest, RpcInvocationImplAttachmentTest) {
   EXPECT_EQ(23333, attachment.attachmentOffset());
 }
 
+// The header map of the attachment is only built once it's needed, and reflects the updates made
+// before.
+TEST(RpcInvocationImplAttachmentTest, LazyHeaders) {
+  auto map = std::make_unique<RpcInvocationImpl::Attachment::Map>();
+  map->toMutableUntypedMap()->emplace(std::make_unique<Hessian2::StringObject>("group"),
+                                      std::make_unique<Hessian2::StringObject>("fake_group"));
+  map->toMutableUntypedMap()->emplace(std::make_unique<Hessian2::StringObject>("fake_key"),
+                                      std::make_unique<Hessian2::StringObject>("fake_value"));
+
+  RpcInvocationImpl::Attachment attachment(std::move(map), 0);
+  EXPECT_EQ("fake_group", *attachment.lookup("group"));
+  attachment.remove("fake_key");
+  attachment.insert("test", "test_value");
+  EXPECT_FALSE(attachment.hasHeaders());
+
+  EXPECT_EQ(2, attachment.headers().size());
+  EXPECT_TRUE(attachment.hasHeaders());
+  EXPECT_EQ("test_value",
+            attachment.headers().get(Http::LowerCaseString("test"))[0]->value().getStringView());
+  EXPECT_TRUE(attachment.headers().get(Http::LowerCaseString("fake_key")).empty());
+}
+
 TEST(RpcInvocationImplTest, RpcInvocationImplTest) {
   RpcInvocationImpl invo;
 
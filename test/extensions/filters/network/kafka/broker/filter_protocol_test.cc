@@ -35,7 +35,7 @@ class KafkaBrokerFilterProtocolTest : public testing::Test,
 protected:
   Stats::TestUtil::TestStore scope_;
   Event::TestRealTimeSystem time_source_;
-  KafkaBrokerFilter testee_{scope_, time_source_, "prefix"};
+  KafkaBrokerFilter testee_{scope_, time_source_, "prefix", false};
 
   Network::FilterStatus consumeRequestFromBuffer() {
     return testee_.onData(RequestB::buffer_, false);
@@ -154,6 +154,40 @@ TEST_F(KafkaBrokerFilterProtocolTest, ShouldProcessMessages) {
   }
 }
 
+class KafkaBrokerFilterHeaderOnlyProtocolTest : public KafkaBrokerFilterProtocolTest {
+protected:
+  Stats::TestUtil::TestStore header_only_scope_;
+  KafkaBrokerFilter header_only_testee_{header_only_scope_, time_source_, "prefix", true};
+};
+
+TEST_F(KafkaBrokerFilterHeaderOnlyProtocolTest, ShouldProcessMessagesWithoutParsingPayloads) {
+  // given
+  for (const AbstractRequestSharedPtr& message : MessageUtilities::makeAllRequests()) {
+    RequestB::putMessageIntoBuffer(*message);
+  }
+  for (const AbstractResponseSharedPtr& message : MessageUtilities::makeAllResponses()) {
+    ResponseB::putMessageIntoBuffer(*message);
+  }
+
+  // when
+  const Network::FilterStatus result1 = header_only_testee_.onData(RequestB::buffer_, false);
+  const Network::FilterStatus result2 = header_only_testee_.onWrite(ResponseB::buffer_, false);
+
+  // then
+  ASSERT_EQ(result1, Network::FilterStatus::Continue);
+  ASSERT_EQ(result2, Network::FilterStatus::Continue);
+
+  // Message types are still recognized from headers alone.
+  for (int16_t i = 0; i < MessageUtilities::apiKeys(); ++i) {
+    const Stats::Counter& request_counter =
+        header_only_scope_.counter(MessageUtilities::requestMetric(i));
+    ASSERT_EQ(request_counter.value(), MessageUtilities::requestApiVersions(i));
+    const Stats::Counter& response_counter =
+        header_only_scope_.counter(MessageUtilities::responseMetric(i));
+    ASSERT_EQ(response_counter.value(), MessageUtilities::responseApiVersions(i));
+  }
+}
+
 } // namespace Broker
 } // namespace Kafka
 } // namespace NetworkFilters
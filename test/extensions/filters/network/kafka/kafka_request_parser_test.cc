@@ -192,6 +192,53 @@ TEST_F(KafkaRequestParserTest, SentinelParserShouldConsumeDataUntilEndOfRequest)
   assertStringViewIncrement(data, orig_data, request_len);
 }
 
+TEST_F(KafkaRequestParserTest, PayloadSkippingParserShouldConsumeDataAndReturnHeader) {
+  // given
+  const int32_t request_len = 1000;
+  const RequestHeader header = {0, 0, 42, "client-id"};
+  RequestContextSharedPtr context{new RequestContext{request_len, header}};
+  PayloadSkippingParser testee{context};
+
+  const absl::string_view orig_data = putGarbageIntoBuffer(request_len * 2);
+  absl::string_view data = {orig_data.data(), request_len / 2};
+
+  // when - the payload arrives in two parts
+  const RequestParseResponse result1 = testee.parse(data);
+  data = {orig_data.data() + request_len / 2, orig_data.size() - request_len / 2};
+  const RequestParseResponse result2 = testee.parse(data);
+
+  // then
+  ASSERT_EQ(result1.hasData(), false);
+  ASSERT_EQ(result2.hasData(), true);
+  ASSERT_EQ(result2.next_parser_, nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<HeaderOnlyRequest>(result2.message_), nullptr);
+  ASSERT_EQ(result2.message_->request_header_, header);
+  ASSERT_EQ(result2.failure_data_, nullptr);
+
+  ASSERT_EQ(testee.contextForTest()->remaining_request_size_, 0);
+
+  assertStringViewIncrement(data, orig_data, request_len);
+
+  // The header-only request cannot be encoded.
+  Buffer::OwnedImpl buffer;
+  EXPECT_THROW(result2.message_->encode(buffer), EnvoyException);
+}
+
+TEST_F(KafkaRequestParserTest, HeaderOnlyRequestParserResolverShouldSkipOnlyKnownRequests) {
+  // given
+  const HeaderOnlyRequestParserResolver& testee = HeaderOnlyRequestParserResolver::getInstance();
+  RequestContextSharedPtr context{new RequestContext()};
+
+  // when
+  const RequestParserSharedPtr known = testee.createParser(0, 0, context);
+  const RequestParserSharedPtr unknown =
+      testee.createParser(std::numeric_limits<int16_t>::max(), 0, context);
+
+  // then
+  ASSERT_NE(std::dynamic_pointer_cast<PayloadSkippingParser>(known), nullptr);
+  ASSERT_NE(std::dynamic_pointer_cast<SentinelParser>(unknown), nullptr);
+}
+
 } // namespace KafkaRequestParserTest
 } // namespace Kafka
 } // namespace NetworkFilters
@@ -0,0 +1,72 @@
+#include "extensions/filters/network/kafka/mesh/config.h"
+
+#include "test/mocks/server/factory_context.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+TEST(KafkaMeshConfigFactoryUnitTest, shouldCreateFilter) {
+  // given
+  const std::string yaml = R"EOF(
+advertised_host: "127.0.0.1"
+advertised_port: 19092
+upstream_clusters:
+- cluster: kafka_c1
+  partition_count: 3
+forwarding_rules:
+- target_cluster: kafka_c1
+  topic_prefix: apples
+  )EOF";
+
+  KafkaMeshProtoConfig proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+
+  testing::NiceMock<Server::Configuration::MockFactoryContext> context;
+  KafkaMeshConfigFactory factory;
+
+  Network::FilterFactoryCb cb = factory.createFilterFactoryFromProto(proto_config, context);
+  Network::MockConnection connection;
+  EXPECT_CALL(connection, addReadFilter(_));
+
+  // when
+  cb(connection);
+
+  // then - connection had `addReadFilter` invoked
+}
+
+TEST(KafkaMeshConfigFactoryUnitTest, shouldBeTerminalFilter) {
+  // given
+  KafkaMeshConfigFactory factory;
+
+  // when
+  // then
+  EXPECT_TRUE(factory.isTerminalFilter());
+}
+
+TEST(KafkaMeshConfigFactoryUnitTest, shouldThrowOnMissingUpstreamClusters) {
+  // given
+  const std::string yaml = R"EOF(
+advertised_host: "127.0.0.1"
+advertised_port: 19092
+  )EOF";
+
+  KafkaMeshProtoConfig proto_config;
+
+  // when
+  // then - exception gets thrown
+  EXPECT_THROW(TestUtility::loadFromYamlAndValidate(yaml, proto_config), ProtoValidationException);
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
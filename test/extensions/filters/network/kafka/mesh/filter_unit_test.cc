@@ -0,0 +1,270 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/kafka/external/requests.h"
+#include "extensions/filters/network/kafka/external/responses.h"
+#include "extensions/filters/network/kafka/mesh/filter.h"
+#include "extensions/filters/network/kafka/request_codec.h"
+#include "extensions/filters/network/kafka/response_codec.h"
+
+#include "test/mocks/network/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+// Mocks.
+
+class MockUpstreamKafkaConfiguration : public UpstreamKafkaConfiguration {
+public:
+  MOCK_METHOD(absl::optional<ClusterConfig>, computeClusterConfigForTopic, (const std::string&),
+              (const));
+  MOCK_METHOD((std::pair<std::string, int32_t>), getAdvertisedAddress, (), (const));
+};
+
+class MockKafkaProducer : public KafkaProducer {
+public:
+  MOCK_METHOD(void, send,
+              (const ProduceFinishCbSharedPtr&, const ProduceSpec&, const std::string&, int32_t,
+               const NullableBytes&));
+};
+
+class MockUpstreamKafkaFacade : public UpstreamKafkaFacade {
+public:
+  MOCK_METHOD(KafkaProducer&, getProducerForCluster, (const ClusterConfig&));
+};
+
+// Captures the responses written downstream.
+class CapturingResponseCallback : public ResponseCallback {
+public:
+  void onMessage(AbstractResponseSharedPtr response) override { responses_.push_back(response); }
+  void onFailedParse(ResponseMetadataSharedPtr) override { FAIL(); }
+
+  std::vector<AbstractResponseSharedPtr> responses_;
+};
+
+class KafkaMeshFilterUnitTest : public testing::Test {
+protected:
+  KafkaMeshFilterUnitTest() {
+    ON_CALL(configuration_, computeClusterConfigForTopic("topic"))
+        .WillByDefault(Return(cluster_config_));
+    ON_CALL(configuration_, computeClusterConfigForTopic("unknown"))
+        .WillByDefault(Return(absl::nullopt));
+    ON_CALL(configuration_, getAdvertisedAddress())
+        .WillByDefault(Return(std::pair<std::string, int32_t>{"mesh.local", 19092}));
+    ON_CALL(facade_, getProducerForCluster(_)).WillByDefault(ReturnRef(producer_));
+    ON_CALL(filter_callbacks_.connection_, write(_, false))
+        .WillByDefault(Invoke(
+            [this](Buffer::Instance& data, bool) -> void { written_.move(data); }));
+    filter_.initializeReadFilterCallbacks(filter_callbacks_);
+  }
+
+  template <typename T> void sendRequest(const int16_t api_key, const int16_t api_version,
+                                         const int32_t correlation_id, const T& data) {
+    const Request<T> request{{api_key, api_version, correlation_id, "client"}, data};
+    Buffer::OwnedImpl buffer;
+    RequestEncoder{buffer}.encode(request);
+    EXPECT_EQ(Network::FilterStatus::StopIteration, filter_.onData(buffer, false));
+    EXPECT_EQ(0, buffer.length());
+  }
+
+  // Decodes the responses written downstream, which were sent for given requests.
+  template <typename T>
+  std::vector<std::shared_ptr<Response<T>>>
+  writtenResponses(const std::vector<std::tuple<int32_t, int16_t, int16_t>>& expected) {
+    const auto capture = std::make_shared<CapturingResponseCallback>();
+    ResponseDecoder decoder{{capture}};
+    for (const auto& response : expected) {
+      decoder.expectResponse(std::get<0>(response), std::get<1>(response), std::get<2>(response));
+    }
+    decoder.onData(written_);
+    std::vector<std::shared_ptr<Response<T>>> result;
+    for (const AbstractResponseSharedPtr& response : capture->responses_) {
+      result.push_back(std::dynamic_pointer_cast<Response<T>>(response));
+    }
+    return result;
+  }
+
+  static ProduceRequest produceRequest(const int16_t acks, const std::string& topic,
+                                       const std::vector<int32_t>& partitions) {
+    std::vector<PartitionProduceData> partition_data;
+    for (const int32_t partition : partitions) {
+      partition_data.emplace_back(partition, NullableBytes{Bytes(10, 'r')});
+    }
+    return {absl::nullopt, acks, 1000, {{topic, partition_data}}};
+  }
+
+  const ClusterConfig cluster_config_{"cluster", 2, std::chrono::milliseconds{5}, 1000};
+  NiceMock<MockUpstreamKafkaConfiguration> configuration_;
+  NiceMock<MockKafkaProducer> producer_;
+  NiceMock<MockUpstreamKafkaFacade> facade_;
+  NiceMock<Network::MockReadFilterCallbacks> filter_callbacks_;
+  KafkaMeshFilter filter_{configuration_, facade_};
+  Buffer::OwnedImpl written_;
+};
+
+TEST_F(KafkaMeshFilterUnitTest, shouldAnswerApiVersionsRequest) {
+  // given
+  const ApiVersionsRequest data{};
+
+  // when
+  sendRequest(ApiVersionsRequestApiKey, 0, 42, data);
+
+  // then
+  const auto responses = writtenResponses<ApiVersionsResponse>({{42, ApiVersionsRequestApiKey, 0}});
+  ASSERT_EQ(1, responses.size());
+  ASSERT_NE(nullptr, responses[0]);
+  EXPECT_EQ(0, responses[0]->data_.error_code_);
+  EXPECT_EQ(3, responses[0]->data_.api_keys_.size());
+  EXPECT_TRUE(filter_.getRequestsWaitingForAnswer().empty());
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldAdvertiseItselfAsLeaderOfAllPartitions) {
+  // given
+  const MetadataRequest data{std::vector<MetadataRequestTopic>{{"topic"}, {"unknown"}}};
+
+  // when
+  sendRequest(MetadataRequestApiKey, 1, 42, data);
+
+  // then
+  const auto responses = writtenResponses<MetadataResponse>({{42, MetadataRequestApiKey, 1}});
+  ASSERT_EQ(1, responses.size());
+  ASSERT_NE(nullptr, responses[0]);
+  const MetadataResponse& response = responses[0]->data_;
+  ASSERT_EQ(1, response.brokers_.size());
+  EXPECT_EQ("mesh.local", response.brokers_[0].host_);
+  EXPECT_EQ(19092, response.brokers_[0].port_);
+  ASSERT_EQ(2, response.topics_.size());
+  EXPECT_EQ(0, response.topics_[0].error_code_);
+  ASSERT_EQ(2, response.topics_[0].partitions_.size());
+  EXPECT_EQ(response.brokers_[0].node_id_, response.topics_[0].partitions_[1].leader_id_);
+  EXPECT_EQ(UnknownTopicOrPartition, response.topics_[1].error_code_);
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldAnswerProduceRequestOnceAllPartitionsFinish) {
+  // given
+  std::vector<ProduceFinishCbSharedPtr> callbacks;
+  EXPECT_CALL(producer_, send(_, _, "topic", _, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&callbacks](const ProduceFinishCbSharedPtr& callback,
+                                          const ProduceSpec& spec, const std::string&, int32_t,
+                                          const NullableBytes&) -> void {
+        EXPECT_EQ(-1, spec.acks_);
+        callbacks.push_back(callback);
+      }));
+  sendRequest(ProduceRequestApiKey, 7, 42, produceRequest(-1, "topic", {0, 1}));
+  EXPECT_EQ(1, filter_.getRequestsWaitingForAnswer().size());
+
+  // when - the first partition finishes
+  callbacks[0]->onPartitionResult("topic", {0, 0, 100});
+
+  // then - nothing is written
+  EXPECT_EQ(0, written_.length());
+
+  // when - the second partition finishes
+  callbacks[1]->onPartitionResult("topic", {1, 0, 200});
+
+  // then - the response is written
+  const auto responses = writtenResponses<ProduceResponse>({{42, ProduceRequestApiKey, 7}});
+  ASSERT_EQ(1, responses.size());
+  ASSERT_NE(nullptr, responses[0]);
+  ASSERT_EQ(1, responses[0]->data_.responses_.size());
+  EXPECT_EQ(2, responses[0]->data_.responses_[0].partitions_.size());
+  EXPECT_TRUE(filter_.getRequestsWaitingForAnswer().empty());
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldAnswerInOrderOfRequests) {
+  // given
+  ProduceFinishCbSharedPtr callback;
+  EXPECT_CALL(producer_, send(_, _, _, _, _))
+      .WillOnce(Invoke([&callback](const ProduceFinishCbSharedPtr& cb, const ProduceSpec&,
+                                   const std::string&, int32_t,
+                                   const NullableBytes&) -> void { callback = cb; }));
+  sendRequest(ProduceRequestApiKey, 7, 1, produceRequest(-1, "topic", {0}));
+
+  // when - a later request finishes right away
+  sendRequest(ApiVersionsRequestApiKey, 0, 2, ApiVersionsRequest{});
+
+  // then - its response waits for the response of the earlier request
+  EXPECT_EQ(0, written_.length());
+  EXPECT_EQ(2, filter_.getRequestsWaitingForAnswer().size());
+
+  // when
+  callback->onPartitionResult("topic", {0, 0, 100});
+
+  // then - both responses are written, in order
+  EXPECT_NE(0, written_.length());
+  EXPECT_TRUE(filter_.getRequestsWaitingForAnswer().empty());
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldFailUnknownPartitionsRightAway) {
+  // given
+  EXPECT_CALL(producer_, send(_, _, _, _, _)).Times(0);
+
+  // when - the topic is unknown, or the partition isn't in the cluster
+  sendRequest(ProduceRequestApiKey, 7, 42, produceRequest(-1, "unknown", {0}));
+  sendRequest(ProduceRequestApiKey, 7, 43, produceRequest(-1, "topic", {2}));
+
+  // then
+  const auto responses = writtenResponses<ProduceResponse>(
+      {{42, ProduceRequestApiKey, 7}, {43, ProduceRequestApiKey, 7}});
+  ASSERT_EQ(2, responses.size());
+  for (const auto& response : responses) {
+    ASSERT_NE(nullptr, response);
+    ASSERT_EQ(1, response->data_.responses_.size());
+    ASSERT_EQ(1, response->data_.responses_[0].partitions_.size());
+    EXPECT_EQ(UnknownTopicOrPartition, response->data_.responses_[0].partitions_[0].error_code_);
+  }
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldNotAnswerProduceRequestWithAcksZero) {
+  // given
+  EXPECT_CALL(producer_, send(_, _, _, _, _));
+
+  // when
+  sendRequest(ProduceRequestApiKey, 7, 42, produceRequest(0, "topic", {0}));
+
+  // then
+  EXPECT_EQ(0, written_.length());
+  EXPECT_TRUE(filter_.getRequestsWaitingForAnswer().empty());
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldCloseConnectionOnUnsupportedRequest) {
+  // given
+  const ListGroupsRequest data{};
+
+  // when
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  sendRequest(16, 0, 42, data);
+
+  // then
+  EXPECT_TRUE(filter_.getRequestsWaitingForAnswer().empty());
+}
+
+TEST_F(KafkaMeshFilterUnitTest, shouldAbandonRequestsOnConnectionClose) {
+  // given
+  EXPECT_CALL(producer_, send(_, _, _, _, _));
+  sendRequest(ProduceRequestApiKey, 7, 42, produceRequest(-1, "topic", {0}));
+
+  // when
+  filter_.onEvent(Network::ConnectionEvent::RemoteClose);
+
+  // then
+  EXPECT_TRUE(filter_.getRequestsWaitingForAnswer().empty());
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,95 @@
+#include "envoy/common/exception.h"
+
+#include "extensions/filters/network/kafka/mesh/upstream_config.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+TEST(UpstreamKafkaConfigurationTest, shouldMatchTopicsByPrefix) {
+  // given
+  const std::string yaml = R"EOF(
+advertised_host: "mesh.local"
+advertised_port: 19092
+upstream_clusters:
+- cluster: kafka_c1
+  partition_count: 1
+- cluster: kafka_c2
+  partition_count: 2
+  linger: 0.010s
+  max_batch_size_bytes: 2048
+forwarding_rules:
+- target_cluster: kafka_c1
+  topic_prefix: apples
+- target_cluster: kafka_c2
+  topic_prefix: apple
+  )EOF";
+  KafkaMeshProtoConfig proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+
+  // when
+  const UpstreamKafkaConfigurationImpl testee{proto_config};
+
+  // then - the first matching rule wins, and the defaults apply to unset fields
+  const ClusterConfig cluster1{"kafka_c1", 1, UpstreamKafkaConfigurationImpl::DefaultLinger,
+                               UpstreamKafkaConfigurationImpl::DefaultMaxBatchSizeBytes};
+  const ClusterConfig cluster2{"kafka_c2", 2, std::chrono::milliseconds{10}, 2048};
+  EXPECT_EQ(cluster1, testee.computeClusterConfigForTopic("apples-topic"));
+  EXPECT_EQ(cluster2, testee.computeClusterConfigForTopic("apple-topic"));
+  EXPECT_EQ(absl::nullopt, testee.computeClusterConfigForTopic("orange-topic"));
+  EXPECT_EQ((std::pair<std::string, int32_t>{"mesh.local", 19092}),
+            testee.getAdvertisedAddress());
+}
+
+TEST(UpstreamKafkaConfigurationTest, shouldThrowOnUndefinedTargetCluster) {
+  // given
+  const std::string yaml = R"EOF(
+advertised_host: "mesh.local"
+advertised_port: 19092
+upstream_clusters:
+- cluster: kafka_c1
+  partition_count: 1
+forwarding_rules:
+- target_cluster: kafka_c2
+  topic_prefix: apples
+  )EOF";
+  KafkaMeshProtoConfig proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+
+  // when
+  // then - exception gets thrown
+  EXPECT_THROW_WITH_MESSAGE(UpstreamKafkaConfigurationImpl{proto_config}, EnvoyException,
+                            "kafka mesh: forwarding rule targets undefined cluster kafka_c2");
+}
+
+TEST(UpstreamKafkaConfigurationTest, shouldThrowOnDuplicateCluster) {
+  // given
+  const std::string yaml = R"EOF(
+advertised_host: "mesh.local"
+advertised_port: 19092
+upstream_clusters:
+- cluster: kafka_c1
+  partition_count: 1
+- cluster: kafka_c1
+  partition_count: 2
+  )EOF";
+  KafkaMeshProtoConfig proto_config;
+  TestUtility::loadFromYamlAndValidate(yaml, proto_config);
+
+  // when
+  // then - exception gets thrown
+  EXPECT_THROW_WITH_MESSAGE(UpstreamKafkaConfigurationImpl{proto_config}, EnvoyException,
+                            "kafka mesh: cluster kafka_c1 is defined twice");
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
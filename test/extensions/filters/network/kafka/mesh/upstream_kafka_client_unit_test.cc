@@ -0,0 +1,287 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/kafka/external/requests.h"
+#include "extensions/filters/network/kafka/external/responses.h"
+#include "extensions/filters/network/kafka/mesh/upstream_kafka_client.h"
+#include "extensions/filters/network/kafka/request_codec.h"
+#include "extensions/filters/network/kafka/response_codec.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace Kafka {
+namespace Mesh {
+
+class MockProduceFinishCb : public ProduceFinishCb {
+public:
+  MOCK_METHOD(void, onPartitionResult, (const std::string&, const PartitionProduceResponse&));
+};
+
+// Captures the requests written upstream.
+class CapturingRequestCallback : public RequestCallback {
+public:
+  void onMessage(AbstractRequestSharedPtr request) override { requests_.push_back(request); }
+  void onFailedParse(RequestParseFailureSharedPtr) override { FAIL(); }
+
+  std::vector<AbstractRequestSharedPtr> requests_;
+};
+
+class UpstreamKafkaProducerTest : public testing::Test {
+protected:
+  void initialize(uint32_t max_batch_size_bytes = 1000) {
+    cluster_manager_.initializeThreadLocalClusters({"cluster"});
+    timer_ = new NiceMock<Event::MockTimer>(&dispatcher_);
+    const ClusterConfig config{"cluster", 3, std::chrono::milliseconds{5}, max_batch_size_bytes};
+    producer_ = std::make_unique<UpstreamKafkaProducer>(config, cluster_manager_, dispatcher_);
+  }
+
+  Tcp::ConnectionPool::MockInstance& pool() {
+    return cluster_manager_.thread_local_cluster_.tcp_conn_pool_;
+  }
+
+  // Makes the pending connection ready, returning what's written to it.
+  std::vector<std::shared_ptr<Request<ProduceRequest>>> readyConnection() {
+    EXPECT_CALL(*pool().connection_data_, addUpstreamCallbacks(_))
+        .WillOnce(Invoke([this](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+    Buffer::OwnedImpl written;
+    EXPECT_CALL(connection_, write(_, false))
+        .WillOnce(Invoke([&written](Buffer::Instance& data, bool) -> void { written.move(data); }));
+    pool().poolReady(connection_);
+
+    const auto capture = std::make_shared<CapturingRequestCallback>();
+    RequestDecoder decoder{{capture}};
+    decoder.onData(written);
+    std::vector<std::shared_ptr<Request<ProduceRequest>>> result;
+    for (const AbstractRequestSharedPtr& request : capture->requests_) {
+      result.push_back(std::dynamic_pointer_cast<Request<ProduceRequest>>(request));
+    }
+    return result;
+  }
+
+  static void addResponse(Buffer::Instance& buffer, int16_t api_version, int32_t correlation_id,
+                          const std::vector<TopicProduceResponse>& responses) {
+    const Response<ProduceResponse> response{{ProduceRequestApiKey, api_version, correlation_id},
+                                             {responses, 0}};
+    ResponseEncoder{buffer}.encode(response);
+  }
+
+  NiceMock<Upstream::MockClusterManager> cluster_manager_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  NiceMock<Network::MockClientConnection> connection_;
+  Event::MockTimer* timer_{};
+  std::unique_ptr<UpstreamKafkaProducer> producer_;
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+  const ProduceSpec spec_{7, -1, absl::nullopt, 1000};
+  const NullableBytes records_{Bytes(10, 'r')};
+};
+
+TEST_F(UpstreamKafkaProducerTest, shouldBatchRecordsUntilLingerElapses) {
+  // given
+  initialize();
+  const auto callback1 = std::make_shared<MockProduceFinishCb>();
+  const auto callback2 = std::make_shared<MockProduceFinishCb>();
+
+  EXPECT_CALL(*timer_, enableTimer(std::chrono::milliseconds{5}, _));
+  EXPECT_CALL(pool(), newConnection(_)).Times(0);
+  producer_->send(callback1, spec_, "topic", 0, records_);
+  producer_->send(callback2, spec_, "topic", 1, records_);
+
+  // when - the linger time elapses
+  EXPECT_CALL(pool(), newConnection(_));
+  timer_->invokeCallback();
+
+  // then - the records of both requests are sent together
+  const auto requests = readyConnection();
+  ASSERT_EQ(1, requests.size());
+  ASSERT_NE(nullptr, requests[0]);
+  EXPECT_EQ(7, requests[0]->request_header_.api_version_);
+  ASSERT_EQ(1, requests[0]->data_.topics_.size());
+  EXPECT_EQ(2, requests[0]->data_.topics_[0].partitions_.size());
+
+  // when - upstream answers
+  EXPECT_CALL(*callback1, onPartitionResult("topic", _))
+      .WillOnce(Invoke([](const std::string&, const PartitionProduceResponse& result) -> void {
+        EXPECT_EQ(0, result.partition_index_);
+        EXPECT_EQ(100, result.base_offset_);
+      }));
+  EXPECT_CALL(*callback2, onPartitionResult("topic", _))
+      .WillOnce(Invoke([](const std::string&, const PartitionProduceResponse& result) -> void {
+        EXPECT_EQ(1, result.partition_index_);
+        EXPECT_EQ(200, result.base_offset_);
+      }));
+  EXPECT_CALL(pool(), released(_));
+  Buffer::OwnedImpl response;
+  addResponse(response, 7, requests[0]->request_header_.correlation_id_,
+              {{"topic", {{0, 0, 100}, {1, 0, 200}}}});
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  // then - the connection is released and the results are passed to the callbacks
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldSendBatchBeforeAddingRecordsOfSamePartition) {
+  // given
+  initialize();
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+
+  // when
+  EXPECT_CALL(pool(), newConnection(_));
+  producer_->send(callback, spec_, "topic", 0, records_);
+
+  // then - the first batch is sent right away, and the second one waits for the linger time
+  EXPECT_EQ(1, readyConnection().size());
+  EXPECT_TRUE(timer_->enabled_);
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldNotBatchRecordsOfDifferentRequestAttributes) {
+  // given
+  initialize();
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+  producer_->send(callback, {spec_.api_version_, 1, absl::nullopt, 1000}, "topic", 1, records_);
+
+  // when
+  EXPECT_CALL(pool(), newConnection(_)).Times(2);
+  timer_->invokeCallback();
+
+  // then - two upstream requests are made
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldSendBatchExceedingMaxSize) {
+  // given
+  initialize(15);
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+
+  // when
+  EXPECT_CALL(pool(), newConnection(_));
+  producer_->send(callback, spec_, "topic", 1, records_);
+
+  // then - the batch is sent without waiting for the linger time
+  const auto requests = readyConnection();
+  ASSERT_EQ(1, requests.size());
+  EXPECT_EQ(2, requests[0]->data_.topics_[0].partitions_.size());
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldReleaseConnectionRightAwayForAcksZero) {
+  // given
+  initialize();
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, {spec_.api_version_, 0, absl::nullopt, 1000}, "topic", 0, records_);
+  timer_->invokeCallback();
+
+  // when
+  EXPECT_CALL(pool(), released(_));
+  EXPECT_CALL(*callback, onPartitionResult(_, _)).Times(0);
+  EXPECT_EQ(1, readyConnection().size());
+
+  // then - the connection is returned to the pool without waiting for a response
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldFailRecordsOnPoolFailure) {
+  // given
+  initialize();
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 2, records_);
+  timer_->invokeCallback();
+
+  // when
+  EXPECT_CALL(*callback, onPartitionResult("topic", _))
+      .WillOnce(Invoke([](const std::string&, const PartitionProduceResponse& result) -> void {
+        EXPECT_EQ(2, result.partition_index_);
+        EXPECT_EQ(NetworkException, result.error_code_);
+      }));
+  pool().poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+
+  // then - the callback is notified about the failure
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldFailRecordsOnConnectionClose) {
+  // given
+  initialize();
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+  timer_->invokeCallback();
+  readyConnection();
+
+  // when
+  EXPECT_CALL(*callback, onPartitionResult("topic", _))
+      .WillOnce(Invoke([](const std::string&, const PartitionProduceResponse& result) -> void {
+        EXPECT_EQ(NetworkException, result.error_code_);
+      }));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+
+  // then - the callback is notified about the failure
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldFailPartitionsMissingFromResponse) {
+  // given
+  initialize();
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+  timer_->invokeCallback();
+  const auto requests = readyConnection();
+
+  // when
+  EXPECT_CALL(*callback, onPartitionResult("topic", _))
+      .WillOnce(Invoke([](const std::string&, const PartitionProduceResponse& result) -> void {
+        EXPECT_EQ(UnknownServerError, result.error_code_);
+      }));
+  Buffer::OwnedImpl response;
+  addResponse(response, 7, requests[0]->request_header_.correlation_id_, {});
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  // then - the callback is notified about the failure
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldDropResultsOfDestroyedCallbacks) {
+  // given
+  initialize();
+  auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+  timer_->invokeCallback();
+
+  // when
+  callback.reset();
+  pool().poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+
+  // then - nothing happens
+}
+
+TEST_F(UpstreamKafkaProducerTest, shouldFailRecordsOfUnknownCluster) {
+  // given
+  initialize();
+  ON_CALL(cluster_manager_, getThreadLocalCluster("cluster")).WillByDefault(Return(nullptr));
+  const auto callback = std::make_shared<MockProduceFinishCb>();
+  producer_->send(callback, spec_, "topic", 0, records_);
+
+  // when
+  EXPECT_CALL(*callback, onPartitionResult("topic", _))
+      .WillOnce(Invoke([](const std::string&, const PartitionProduceResponse& result) -> void {
+        EXPECT_EQ(NetworkException, result.error_code_);
+      }));
+  timer_->invokeCallback();
+
+  // then - the callback is notified about the failure
+}
+
+} // namespace Mesh
+} // namespace Kafka
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -5,6 +5,7 @@
 #include "extensions/filters/network/mongo_proxy/bson_impl.h"
 
 #include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
 
@@ -52,6 +53,95 @@ TEST(BsonImplTest, InvalodDocumentTermination) {
   EXPECT_THROW(DocumentImpl::create(buffer), EnvoyException);
 }
 
+TEST(BsonImplTest, Sparse) {
+  DocumentSharedPtr doc =
+      DocumentImpl::create()
+          ->addString("find", "collection")
+          ->addDouble("double", 2.1)
+          ->addDocument("filter", DocumentImpl::create()
+                                      ->addString("name", "value")
+                                      ->addInt32("_id", 1)
+                                      ->addRegex("regex", {"hello", ""}))
+          ->addDocument("document", DocumentImpl::create()->addString("comment", "nested"))
+          ->addArray("array", DocumentImpl::create()->addString("0", "foo"))
+          ->addBinary("binary", "binary_value")
+          ->addObjectId("object_id", Field::ObjectId())
+          ->addBoolean("true", true)
+          ->addDatetime("datetime", 1)
+          ->addNull("null")
+          ->addTimestamp("timestamp", 1000)
+          ->addInt64("int64", 2)
+          ->addSymbol("symbol", "symbol")
+          ->addString("comment", "callsite");
+
+  Buffer::OwnedImpl buffer;
+  doc->encode(buffer);
+  BufferHelper::writeInt32(buffer, 1);
+  DocumentSharedPtr sparse = DocumentImpl::createSparse(buffer, {"filter", "_id", "comment"});
+
+  // The trailing bytes are left in the buffer.
+  EXPECT_EQ(4UL, buffer.length());
+  EXPECT_EQ(doc->byteSize(), sparse->byteSize());
+  EXPECT_EQ(3UL, sparse->values().size());
+  EXPECT_EQ("collection", sparse->values().front()->asString());
+  EXPECT_EQ("callsite", sparse->find("comment", Field::Type::String)->asString());
+  EXPECT_EQ(nullptr, sparse->find("document"));
+
+  // "name" is kept as the first field of the filter.
+  const Document& filter = sparse->find("filter", Field::Type::Document)->asDocument();
+  EXPECT_EQ(2UL, filter.values().size());
+  EXPECT_EQ("value", filter.find("name")->asString());
+  EXPECT_EQ(1, filter.find("_id")->asInt32());
+  EXPECT_EQ(nullptr, filter.find("regex"));
+}
+
+TEST(BsonImplTest, SparseInvalidSkippedField) {
+  {
+    Buffer::OwnedImpl fields;
+    fields.writeByte(static_cast<uint8_t>(Field::Type::String));
+    BufferHelper::writeCString(fields, "first");
+    BufferHelper::writeString(fields, "value");
+    fields.writeByte(0x06);
+    BufferHelper::writeCString(fields, "skipped");
+    fields.writeByte(0);
+
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, sizeof(int32_t) + fields.length());
+    buffer.move(fields);
+    EXPECT_THROW_WITH_MESSAGE(DocumentImpl::createSparse(buffer, {}), EnvoyException,
+                              "invalid BSON element type: 0x6");
+  }
+
+  {
+    Buffer::OwnedImpl fields;
+    fields.writeByte(static_cast<uint8_t>(Field::Type::String));
+    BufferHelper::writeCString(fields, "first");
+    BufferHelper::writeString(fields, "value");
+    fields.writeByte(static_cast<uint8_t>(Field::Type::String));
+    BufferHelper::writeCString(fields, "skipped");
+    BufferHelper::writeInt32(fields, 100);
+    fields.writeByte(0);
+
+    Buffer::OwnedImpl buffer;
+    BufferHelper::writeInt32(buffer, sizeof(int32_t) + fields.length());
+    buffer.move(fields);
+    EXPECT_THROW_WITH_MESSAGE(DocumentImpl::createSparse(buffer, {}), EnvoyException,
+                              "invalid buffer size");
+  }
+}
+
+TEST(BsonImplTest, Skip) {
+  DocumentSharedPtr doc = DocumentImpl::create()->addString("hello", "world");
+  Buffer::OwnedImpl buffer;
+  doc->encode(buffer);
+  EXPECT_EQ(doc->byteSize(), DocumentImpl::skip(buffer));
+  EXPECT_EQ(0UL, buffer.length());
+
+  BufferHelper::writeInt32(buffer, 100);
+  EXPECT_THROW_WITH_MESSAGE(DocumentImpl::skip(buffer), EnvoyException,
+                            "invalid BSON message length");
+}
+
 TEST(BufferHelperTest, InvalidSize) {
   {
     Buffer::OwnedImpl buffer;
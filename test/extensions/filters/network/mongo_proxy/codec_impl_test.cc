@@ -11,7 +11,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::Eq;
+using testing::Invoke;
 using testing::NiceMock;
 using testing::Pointee;
 
@@ -166,6 +168,57 @@ TEST_F(MongoCodecImplTest, Reply) {
   decoder_.onData(output_);
 }
 
+TEST_F(MongoCodecImplTest, StatsOnly) {
+  DecoderImpl decoder(callbacks_, true);
+
+  QueryMessageImpl query(1, 1);
+  query.fullCollectionName("db.$cmd");
+  query.query(Bson::DocumentImpl::create()
+                  ->addString("find", "collection")
+                  ->addDocument("filter", Bson::DocumentImpl::create()
+                                              ->addString("name", "value")
+                                              ->addString("hello", "world"))
+                  ->addString("comment", "callsite")
+                  ->addInt32("maxTimeMS", 100)
+                  ->addString("projection", "skipped"));
+  query.returnFieldsSelector(Bson::DocumentImpl::create()->addDouble("double", -2.3));
+  encoder_.encodeQuery(query);
+
+  ReplyMessageImpl reply(2, 1);
+  reply.numberReturned(2);
+  reply.documents().push_back(Bson::DocumentImpl::create()->addString("hello", "world"));
+  reply.documents().push_back(Bson::DocumentImpl::create());
+  encoder_.encodeReply(reply);
+
+  InsertMessageImpl insert(3, 3);
+  insert.fullCollectionName("db.collection");
+  insert.documents().push_back(Bson::DocumentImpl::create()->addString("hello", "world"));
+  encoder_.encodeInsert(insert);
+
+  EXPECT_CALL(callbacks_, decodeQuery_(_)).WillOnce(Invoke([](QueryMessagePtr& message) -> void {
+    EXPECT_EQ("db.$cmd", message->fullCollectionName());
+    EXPECT_EQ(nullptr, message->returnFieldsSelector());
+    const Bson::Document& query = *message->query();
+    EXPECT_EQ(4UL, query.values().size());
+    EXPECT_EQ(nullptr, query.find("projection"));
+    EXPECT_EQ("callsite", query.find("comment")->asString());
+    EXPECT_EQ(100, query.find("maxTimeMS")->asInt32());
+    EXPECT_EQ(1UL, query.find("filter")->asDocument().values().size());
+  }));
+  EXPECT_CALL(callbacks_, decodeReply_(_)).WillOnce(Invoke([&](ReplyMessagePtr& message) -> void {
+    EXPECT_TRUE(message->documents().empty());
+    EXPECT_EQ(2UL, message->documentCount());
+    EXPECT_EQ(reply.documentsByteSize(), message->documentsByteSize());
+  }));
+  EXPECT_CALL(callbacks_, decodeInsert_(_))
+      .WillOnce(Invoke([](InsertMessagePtr& message) -> void {
+        EXPECT_EQ("db.collection", message->fullCollectionName());
+        EXPECT_TRUE(message->documents().empty());
+      }));
+  decoder.onData(output_);
+  EXPECT_EQ(0UL, output_.length());
+}
+
 TEST_F(MongoCodecImplTest, GetMoreEqual) {
   {
     GetMoreMessageImpl g1(0, 0);
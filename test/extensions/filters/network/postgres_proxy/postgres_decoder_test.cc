@@ -25,6 +25,7 @@ public:
   MOCK_METHOD(void, incErrors, (ErrorType), (override));
   MOCK_METHOD(void, processQuery, (const std::string&), (override));
   MOCK_METHOD(bool, onSSLRequest, (), (override));
+  MOCK_METHOD(void, onReadyForQuery, (char), (override));
 };
 
 // Define fixture class with decoder and mock callbacks.
@@ -427,6 +428,20 @@ TEST_F(PostgresProxyBackendDecoderTest, AuthenticationMsg) {
   data_.drain(data_.length());
 }
 
+// Test checks that the transaction status carried by
+// the ReadyForQuery message is passed to the callbacks.
+TEST_F(PostgresProxyBackendDecoderTest, ReadyForQueryMsg) {
+  EXPECT_CALL(callbacks_, onReadyForQuery('T'));
+  createPostgresMsg(data_, "Z", "T");
+  decoder_->onData(data_, false);
+  ASSERT_THAT(data_.length(), 0);
+
+  // Message without the status byte is ignored.
+  EXPECT_CALL(callbacks_, onReadyForQuery(::testing::_)).Times(0);
+  createPostgresMsg(data_, "Z");
+  decoder_->onData(data_, false);
+}
+
 // Test check parsing of E message. The message
 // indicates error.
 TEST_P(PostgresProxyErrorTest, ParseErrorMsgs) {
@@ -537,6 +552,7 @@ TEST_F(PostgresProxyDecoderTest, TerminateSSL) {
 class FakeBuffer : public Buffer::Instance {
 public:
   MOCK_METHOD(void, addDrainTracker, (std::function<void()>), (override));
+  MOCK_METHOD(void, bindAccount, (Buffer::BufferMemoryAccountSharedPtr), (override));
   MOCK_METHOD(void, add, (const void*, uint64_t), (override));
   MOCK_METHOD(void, addBufferFragment, (Buffer::BufferFragment&), (override));
   MOCK_METHOD(void, add, (absl::string_view), (override));
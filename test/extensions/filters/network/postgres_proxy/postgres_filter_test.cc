@@ -32,7 +32,8 @@ class PostgresFilterTest
 public:
   PostgresFilterTest() {
 
-    PostgresFilterConfig::PostgresFilterConfigOptions config_options{stat_prefix_, true, false};
+    PostgresFilterConfig::PostgresFilterConfigOptions config_options{stat_prefix_, true, false,
+                                                                  nullptr};
 
     config_ = std::make_shared<PostgresFilterConfig>(config_options, scope_);
     filter_ = std::make_unique<PostgresFilter>(config_);
@@ -0,0 +1,243 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "common/stats/isolated_store_impl.h"
+
+#include "extensions/filters/network/postgres_proxy/postgres_filter.h"
+#include "extensions/filters/network/postgres_proxy/postgres_pooling.h"
+
+#include "test/extensions/filters/network/postgres_proxy/postgres_test_utils.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+#include "test/mocks/upstream/cluster_manager.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace PostgresProxy {
+
+using ::testing::_;
+using ::testing::HasSubstr;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+class PostgresPooledSessionTest : public ::testing::Test {
+public:
+  PostgresPooledSessionTest()
+      : config_(cm_, "postgres", "app", "", "secret"),
+        stats_{ALL_POSTGRES_PROXY_STATS(POOL_COUNTER_PREFIX(scope_, "test."))} {
+    ON_CALL(read_callbacks_.connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) -> void {
+          client_written_.append(data.toString());
+          data.drain(data.length());
+        }));
+    ON_CALL(upstream_connection_, write(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool) -> void {
+          upstream_written_.append(data.toString());
+          data.drain(data.length());
+        }));
+    ON_CALL(*pool_.connection_data_, setConnectionState_(_))
+        .WillByDefault(Invoke([this](Tcp::ConnectionPool::ConnectionStatePtr& state) -> void {
+          connection_state_ = std::move(state);
+        }));
+    session_ = std::make_unique<PooledSession>(config_, stats_, read_callbacks_);
+  }
+
+  void startup(uint32_t code = PooledSession::ProtocolVersion) {
+    Buffer::OwnedImpl body;
+    body.writeBEInt<uint32_t>(code);
+    body.add(std::string("user\0bob\0\0", 10));
+    Buffer::OwnedImpl data;
+    data.writeBEInt<uint32_t>(sizeof(uint32_t) + body.length());
+    data.move(body);
+    session_->onClientData(data);
+  }
+
+  void clientMessage(const std::string& type, const std::string& payload = "") {
+    Buffer::OwnedImpl data;
+    createPostgresMsg(data, type, payload);
+    session_->onClientData(data);
+  }
+
+  void upstreamMessage(const std::string& type, const std::string& payload = "") {
+    Buffer::OwnedImpl data;
+    createPostgresMsg(data, type, payload);
+    upstream_callbacks_->onUpstreamData(data, false);
+  }
+
+  void readyConnection() {
+    EXPECT_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillOnce(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+    pool_.poolReady(upstream_connection_);
+  }
+
+  // Logs in a new upstream connection for the client.
+  void login() {
+    EXPECT_CALL(pool_, newConnection(_));
+    startup();
+    readyConnection();
+    EXPECT_THAT(upstream_written_, HasSubstr(std::string("user\0app\0database\0app\0\0", 23)));
+    upstream_written_.clear();
+
+    upstreamMessage("R", std::string("\0\0\0\3", 4));
+    EXPECT_EQ(std::string("p\0\0\0\x0bsecret\0", 12), upstream_written_);
+    upstream_written_.clear();
+
+    upstreamMessage("R", std::string("\0\0\0\0", 4));
+    upstreamMessage("S", std::string("server_version\0" "13.1\0", 20));
+    upstreamMessage("K", std::string(8, '\1'));
+    EXPECT_EQ("", client_written_);
+    upstreamMessage("Z", "I");
+    EXPECT_NE(nullptr, connection_state_);
+    EXPECT_EQ(1UL, stats_.pool_logins_.value());
+
+    // The client receives the parameters of the server, but not its key data.
+    Buffer::OwnedImpl expected;
+    Buffer::OwnedImpl message;
+    createPostgresMsg(message, "R", std::string("\0\0\0\0", 4));
+    expected.move(message);
+    createPostgresMsg(message, "S", std::string("server_version\0" "13.1\0", 20));
+    expected.move(message);
+    createPostgresMsg(message, "Z", "I");
+    expected.move(message);
+    EXPECT_EQ(expected.toString(), client_written_);
+    client_written_.clear();
+  }
+
+  Stats::IsolatedStoreImpl scope_;
+  NiceMock<Upstream::MockClusterManager> cm_;
+  Tcp::ConnectionPool::MockInstance& pool_{cm_.thread_local_cluster_.tcp_conn_pool_};
+  TransactionPoolingConfig config_;
+  PostgresProxyStats stats_;
+  NiceMock<Network::MockReadFilterCallbacks> read_callbacks_;
+  NiceMock<Network::MockClientConnection> upstream_connection_;
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+  Tcp::ConnectionPool::ConnectionStatePtr connection_state_;
+  std::string client_written_;
+  std::string upstream_written_;
+  std::unique_ptr<PooledSession> session_;
+};
+
+// The upstream connection logs in once, and returns to the pool when the client is idle.
+TEST_F(PostgresPooledSessionTest, LoginAndRelease) {
+  login();
+  EXPECT_EQ(1UL, stats_.pool_checkouts_.value());
+
+  EXPECT_CALL(pool_, released(_));
+  session_->onReadyForQuery('I');
+}
+
+// The upstream connection is kept until the transaction of the client is over.
+TEST_F(PostgresPooledSessionTest, TransactionKeepsConnection) {
+  login();
+  EXPECT_CALL(pool_, released(_));
+  session_->onReadyForQuery('I');
+
+  // The next query takes a connection that already logged in.
+  ON_CALL(*pool_.connection_data_, connectionState())
+      .WillByDefault(Return(connection_state_.get()));
+  EXPECT_CALL(pool_, newConnection(_));
+  clientMessage("Q", std::string("BEGIN\0", 6));
+  readyConnection();
+  EXPECT_EQ(2UL, stats_.pool_checkouts_.value());
+  EXPECT_EQ(1UL, stats_.pool_logins_.value());
+  EXPECT_EQ(std::string("Q\0\0\0\x0a" "BEGIN\0", 11), upstream_written_);
+
+  upstreamMessage("C", std::string("BEGIN\0", 6));
+  EXPECT_THAT(client_written_, HasSubstr("BEGIN"));
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  session_->onReadyForQuery('T');
+
+  EXPECT_CALL(pool_, newConnection(_)).Times(0);
+  clientMessage("Q", std::string("COMMIT\0", 7));
+  EXPECT_THAT(upstream_written_, HasSubstr("COMMIT"));
+
+  EXPECT_CALL(pool_, released(_));
+  session_->onReadyForQuery('I');
+}
+
+// The connection isn't released in the middle of an extended query.
+TEST_F(PostgresPooledSessionTest, ExtendedQueryKeepsConnection) {
+  login();
+  EXPECT_CALL(pool_, released(_)).Times(0);
+  clientMessage("P", std::string("\0SELECT 1\0\0\0", 12));
+  session_->onReadyForQuery('I');
+
+  clientMessage("S");
+  EXPECT_CALL(pool_, released(_));
+  session_->onReadyForQuery('I');
+}
+
+// Closing the client in a transaction closes the upstream connection.
+TEST_F(PostgresPooledSessionTest, CloseInTransaction) {
+  login();
+  session_->onReadyForQuery('T');
+
+  EXPECT_CALL(upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  session_.reset();
+}
+
+// Terminate doesn't close the upstream connection.
+TEST_F(PostgresPooledSessionTest, Terminate) {
+  login();
+  EXPECT_CALL(upstream_connection_, close(_)).Times(0);
+  EXPECT_CALL(read_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  clientMessage("X");
+  EXPECT_EQ("", upstream_written_);
+}
+
+TEST_F(PostgresPooledSessionTest, PoolFailure) {
+  EXPECT_CALL(pool_, newConnection(_));
+  startup();
+
+  EXPECT_CALL(read_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  pool_.poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+  EXPECT_THAT(client_written_, HasSubstr(std::string("SFATAL\0", 7)));
+  EXPECT_THAT(client_written_, HasSubstr(std::string("C08006\0", 7)));
+  EXPECT_EQ(1UL, stats_.pool_errors_.value());
+}
+
+TEST_F(PostgresPooledSessionTest, LoginRefused) {
+  EXPECT_CALL(pool_, newConnection(_));
+  startup();
+  readyConnection();
+
+  EXPECT_CALL(upstream_connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(read_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  // AuthenticationMD5Password isn't supported.
+  upstreamMessage("R", std::string("\0\0\0\5salt", 8));
+  EXPECT_THAT(client_written_, HasSubstr("unsupported authentication request 5"));
+  EXPECT_EQ(0UL, stats_.pool_logins_.value());
+}
+
+TEST_F(PostgresPooledSessionTest, ServerClose) {
+  login();
+  clientMessage("Q", std::string("SELECT 1\0", 9));
+
+  EXPECT_CALL(read_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_THAT(client_written_, HasSubstr("server closed the connection unexpectedly"));
+}
+
+TEST_F(PostgresPooledSessionTest, UnsupportedStartup) {
+  EXPECT_CALL(pool_, newConnection(_)).Times(0);
+  EXPECT_CALL(read_callbacks_.connection_, close(Network::ConnectionCloseType::FlushWrite));
+  startup(0x00020000);
+  EXPECT_THAT(client_written_, HasSubstr("unsupported startup request 0x20000"));
+}
+
+TEST_F(PostgresPooledSessionTest, GssEncRequest) {
+  Buffer::OwnedImpl data;
+  data.writeBEInt<uint32_t>(PooledSession::GssEncRequestLength);
+  EXPECT_FALSE(PooledSession::isGssEncRequest(data));
+  data.writeBEInt<uint32_t>(PooledSession::GssEncRequestCode);
+  EXPECT_TRUE(PooledSession::isGssEncRequest(data));
+}
+
+} // namespace PostgresProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
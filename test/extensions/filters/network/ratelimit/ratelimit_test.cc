@@ -104,7 +104,7 @@ TEST_F(RateLimitFilterTest, OK) {
   EXPECT_CALL(*client_, limit(_, "foo",
                               testing::ContainerEq(std::vector<RateLimit::Descriptor>{
                                   {{{"hello", "world"}, {"foo", "bar"}}}, {{{"foo2", "bar2"}}}}),
-                              testing::A<Tracing::Span&>(), _))
+                              testing::A<Tracing::Span&>(), _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
@@ -132,7 +132,7 @@ TEST_F(RateLimitFilterTest, OverLimit) {
   InSequence s;
   SetUpTest(filter_config_);
 
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
@@ -158,7 +158,7 @@ TEST_F(RateLimitFilterTest, OverLimitWithDynamicMetadata) {
   InSequence s;
   SetUpTest(filter_config_);
 
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
@@ -198,7 +198,7 @@ TEST_F(RateLimitFilterTest, OverLimitNotEnforcing) {
   InSequence s;
   SetUpTest(filter_config_);
 
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
@@ -227,7 +227,7 @@ TEST_F(RateLimitFilterTest, Error) {
   InSequence s;
   SetUpTest(filter_config_);
 
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
@@ -255,7 +255,7 @@ TEST_F(RateLimitFilterTest, Disconnect) {
   InSequence s;
   SetUpTest(filter_config_);
 
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
@@ -276,7 +276,7 @@ TEST_F(RateLimitFilterTest, ImmediateOK) {
   SetUpTest(filter_config_);
 
   EXPECT_CALL(filter_callbacks_, continueReading()).Times(0);
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             callbacks.complete(Filters::Common::RateLimit::LimitStatus::OK, nullptr, nullptr,
@@ -300,7 +300,7 @@ TEST_F(RateLimitFilterTest, ImmediateError) {
   SetUpTest(filter_config_);
 
   EXPECT_CALL(filter_callbacks_, continueReading()).Times(0);
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             callbacks.complete(Filters::Common::RateLimit::LimitStatus::Error, nullptr, nullptr,
@@ -326,7 +326,7 @@ TEST_F(RateLimitFilterTest, RuntimeDisable) {
 
   EXPECT_CALL(runtime_.snapshot_, featureEnabled("ratelimit.tcp_filter_enabled", 100))
       .WillOnce(Return(false));
-  EXPECT_CALL(*client_, limit(_, _, _, _, _)).Times(0);
+  EXPECT_CALL(*client_, limit(_, _, _, _, _, _)).Times(0);
 
   EXPECT_EQ(Network::FilterStatus::Continue, filter_->onNewConnection());
   Buffer::OwnedImpl data("hello");
@@ -337,7 +337,7 @@ TEST_F(RateLimitFilterTest, ErrorResponseWithFailureModeAllowOff) {
   InSequence s;
   SetUpTest(fail_close_config_);
 
-  EXPECT_CALL(*client_, limit(_, "foo", _, _, _))
+  EXPECT_CALL(*client_, limit(_, "foo", _, _, _, _))
       .WillOnce(
           WithArgs<0>(Invoke([&](Filters::Common::RateLimit::RequestCallbacks& callbacks) -> void {
             request_callbacks_ = &callbacks;
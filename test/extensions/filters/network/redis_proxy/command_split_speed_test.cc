@@ -5,10 +5,12 @@
 #include <string>
 #include <vector>
 
+#include "common/buffer/buffer_impl.h"
 #include "common/common/fmt.h"
 #include "common/stats/isolated_store_impl.h"
 
 #include "extensions/filters/network/common/redis/client_impl.h"
+#include "extensions/filters/network/common/redis/codec_impl.h"
 #include "extensions/filters/network/common/redis/supported_commands.h"
 #include "extensions/filters/network/redis_proxy/command_splitter_impl.h"
 #include "extensions/filters/network/redis_proxy/router_impl.h"
@@ -84,6 +86,40 @@ public:
     }
   }
 };
+
+// Decodes and re-encodes simple single key commands and their responses, as the proxy does when
+// forwarding them.
+class SimpleCommandForwardSpeedTest : public Common::Redis::DecoderCallbacks {
+public:
+  SimpleCommandForwardSpeedTest(uint64_t value_size) {
+    request_ = fmt::format("*2\r\n$3\r\nget\r\n$36\r\n{}\r\n", std::string(36, 'k'));
+    response_ = fmt::format("${}\r\n{}\r\n", value_size, std::string(value_size, 'v'));
+  }
+
+  // Common::Redis::DecoderCallbacks
+  void onRespValue(Common::Redis::RespValuePtr&& value) override {
+    encoder_.encode(*value, output_);
+  }
+
+  void forward(uint64_t batch_size) {
+    Buffer::OwnedImpl requests;
+    Buffer::OwnedImpl responses;
+    for (uint64_t i = 0; i < batch_size; i++) {
+      requests.add(request_);
+      responses.add(response_);
+    }
+    decoder_.decode(requests);
+    decoder_.decode(responses);
+    output_.drain(output_.length());
+  }
+
+private:
+  std::string request_;
+  std::string response_;
+  Common::Redis::EncoderImpl encoder_;
+  Common::Redis::DecoderImpl decoder_{*this};
+  Buffer::OwnedImpl output_;
+};
 } // namespace RedisProxy
 } // namespace NetworkFilters
 } // namespace Extensions
@@ -130,3 +166,12 @@ static void BM_Split_CreateVariant(benchmark::State& state) {
   state.counters["use_count"] = request.use_count();
 }
 BENCHMARK(BM_Split_CreateVariant)->Ranges({{1, 100}, {64, 8 << 14}});
+
+static void BM_Forward_SimpleCommand(benchmark::State& state) {
+  Envoy::Extensions::NetworkFilters::RedisProxy::SimpleCommandForwardSpeedTest context(
+      state.range(1));
+  for (auto _ : state) {
+    context.forward(state.range(0));
+  }
+}
+BENCHMARK(BM_Forward_SimpleCommand)->Ranges({{1, 100}, {64, 8 << 14}});
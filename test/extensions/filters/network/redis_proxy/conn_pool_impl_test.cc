@@ -18,6 +18,7 @@
 #include "test/extensions/filters/network/common/redis/test_utils.h"
 #include "test/extensions/filters/network/redis_proxy/mocks.h"
 #include "test/mocks/api/mocks.h"
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/thread_local/mocks.h"
 #include "test/mocks/upstream/cluster.h"
 #include "test/mocks/upstream/cluster_manager.h"
@@ -25,6 +26,7 @@
 #include "test/mocks/upstream/cluster_update_callbacks_handle.h"
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/host_set.h"
+#include "test/mocks/upstream/load_balancer.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
 
 #include "gmock/gmock.h"
@@ -85,11 +87,17 @@ public:
         std::make_shared<NiceMock<Extensions::Common::Redis::MockClusterRefreshManager>>();
     auto redis_command_stats =
         Common::Redis::RedisCommandStats::createRedisCommandStats(store->symbolTable());
+    auto settings = Common::Redis::Client::createConnPoolSettings(20, hashtagging, true,
+                                                                  max_unknown_conns, read_policy_);
+    if (get_coalescing_.has_value()) {
+      *settings.mutable_get_coalescing() = get_coalescing_.value();
+    }
+    if (near_cache_max_bytes_ > 0) {
+      settings.mutable_near_cache()->set_max_bytes(near_cache_max_bytes_);
+    }
     std::shared_ptr<InstanceImpl> conn_pool_impl = std::make_shared<InstanceImpl>(
-        cluster_name_, cm_, *this, tls_,
-        Common::Redis::Client::createConnPoolSettings(20, hashtagging, true, max_unknown_conns,
-                                                      read_policy_),
-        api_, std::move(store), redis_command_stats, cluster_refresh_manager_);
+        cluster_name_, cm_, *this, tls_, settings, api_, std::move(store), redis_command_stats,
+        cluster_refresh_manager_);
     conn_pool_impl->init();
     // Set the authentication password for this connection pool.
     conn_pool_impl->tls_->getTyped<InstanceImpl::ThreadLocalPool>().auth_username_ = auth_username_;
@@ -276,6 +284,31 @@ public:
               conn_pool_->tls_->getTyped<InstanceImpl::ThreadLocalPool>().pending_requests_.size());
   }
 
+  void setupGetCoalescing(uint32_t max_keys) {
+    get_coalescing_.emplace();
+    get_coalescing_->mutable_window()->set_nanos(500000);
+    get_coalescing_->mutable_max_keys()->set_value(max_keys);
+    setup();
+    EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+        .WillRepeatedly(Return(cm_.thread_local_cluster_.lb_.host_));
+  }
+
+  Common::Redis::RespValuePtr makeBulkStringArray(const std::vector<std::string>& strings) {
+    Common::Redis::RespValuePtr value = std::make_unique<Common::Redis::RespValue>();
+    std::vector<Common::Redis::RespValue> values(strings.size());
+    for (uint64_t i = 0; i < strings.size(); i++) {
+      values[i].type(Common::Redis::RespType::BulkString);
+      values[i].asString() = strings[i];
+    }
+    value->type(Common::Redis::RespType::Array);
+    value->asArray().swap(values);
+    return value;
+  }
+
+  Common::Redis::RespValuePtr makeGet(const std::string& key) {
+    return makeBulkStringArray({"get", key});
+  }
+
   void verifyInvalidMoveResponse(Common::Redis::Client::MockClient* client,
                                  const std::string& host_address, bool create_client) {
     Common::Redis::RespValueSharedPtr request_value = std::make_shared<Common::Redis::RespValue>();
@@ -305,6 +338,10 @@ public:
   envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::ConnPoolSettings::ReadPolicy
       read_policy_ = envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::
           ConnPoolSettings::MASTER;
+  absl::optional<envoy::extensions::filters::network::redis_proxy::v3::RedisProxy::
+                     ConnPoolSettings::GetCoalescing>
+      get_coalescing_;
+  uint64_t near_cache_max_bytes_{};
   NiceMock<Stats::MockCounter> upstream_cx_drained_;
   NiceMock<Stats::MockCounter> max_upstream_unknown_connections_reached_;
   std::shared_ptr<NiceMock<Extensions::Common::Redis::MockClusterRefreshManager>>
@@ -1094,6 +1131,45 @@ TEST_F(RedisConnPoolImplTest, MovedRedirectionSuccess) {
   tls_.shutdownThread();
 }
 
+class MockMovedRedirectionLoadBalancer : public Upstream::MockLoadBalancer,
+                                         public Clusters::Redis::MovedRedirectionHandler {
+public:
+  MOCK_METHOD(bool, onMovedRedirection, (uint64_t slot, const std::string& primary_address));
+};
+
+// The load balancer of Redis Cluster moves the slot of a MOVED redirection, which then doesn't
+// count towards a refresh of the topology.
+TEST_F(RedisConnPoolImplTest, MovedRedirectionMovesSlot) {
+  setup();
+
+  Common::Redis::RespValueSharedPtr request_value = std::make_shared<Common::Redis::RespValue>();
+  Common::Redis::Client::MockPoolRequest active_request;
+  MockPoolCallbacks callbacks;
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  makeRequest(client, request_value, callbacks, active_request);
+
+  threadLocalPool().is_redis_cluster_ = true;
+  NiceMock<MockMovedRedirectionLoadBalancer> lb;
+  ON_CALL(cm_.thread_local_cluster_, loadBalancer()).WillByDefault(ReturnRef(lb));
+
+  Common::Redis::Client::MockPoolRequest active_request2;
+  Common::Redis::Client::MockClient* client2 = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::RespValuePtr moved_response{new Common::Redis::RespValue()};
+  moved_response->type(Common::Redis::RespType::Error);
+  moved_response->asString() = "MOVED 1111 10.1.2.3:4000";
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client2));
+  EXPECT_CALL(*client2, makeRequest_(Ref(*request_value), _)).WillOnce(Return(&active_request2));
+  EXPECT_CALL(lb, onMovedRedirection(1111, "10.1.2.3:4000")).WillOnce(Return(true));
+  EXPECT_CALL(*cluster_refresh_manager_, onRedirection(_)).Times(0);
+  EXPECT_TRUE(client->client_callbacks_.back()->onRedirection(std::move(moved_response),
+                                                              "10.1.2.3:4000", false));
+
+  respond(callbacks, client2);
+
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+}
+
 TEST_F(RedisConnPoolImplTest, MovedRedirectionFailure) {
   InSequence s;
 
@@ -1276,6 +1352,185 @@ TEST_F(RedisConnPoolImplTest, MakeRequestAndRedirectFollowedByDelete) {
   tls_.shutdownThread();
 }
 
+// GETs to the same host within the window are sent as one MGET, and its values are fanned out.
+TEST_F(RedisConnPoolImplTest, CoalesceGets) {
+  setupGetCoalescing(100);
+
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Event::MockTimer* window_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  MockPoolCallbacks callbacks1, callbacks2;
+  EXPECT_CALL(*this, create_(_)).Times(0);
+  EXPECT_CALL(*window_timer, enableHRTimer(std::chrono::microseconds(500), _));
+  // Commands are matched case insensitively.
+  EXPECT_NE(nullptr, conn_pool_->makeRequest(
+                         "foo", ConnPool::RespVariant(*makeBulkStringArray({"GET", "foo"})),
+                         callbacks1));
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("bar", ConnPool::RespVariant(*makeGet("bar")), callbacks2));
+
+  Common::Redis::Client::MockPoolRequest active_request;
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client));
+  EXPECT_CALL(*client, makeRequest_(Eq(*makeBulkStringArray({"mget", "foo", "bar"})), _))
+      .WillOnce(Return(&active_request));
+  window_timer->invokeCallback();
+
+  Common::Redis::RespValuePtr response = makeBulkStringArray({"foo_value", "bar_value"});
+  response->asArray()[1].type(Common::Redis::RespType::Null);
+  EXPECT_CALL(callbacks1, onResponse_(_))
+      .WillOnce(Invoke([](Common::Redis::RespValuePtr& value) {
+        EXPECT_EQ(Common::Redis::RespType::BulkString, value->type());
+        EXPECT_EQ("foo_value", value->asString());
+      }));
+  EXPECT_CALL(callbacks2, onResponse_(_)).WillOnce(Invoke([](Common::Redis::RespValuePtr& value) {
+    EXPECT_EQ(Common::Redis::RespType::Null, value->type());
+  }));
+  client->client_callbacks_.back()->onResponse(std::move(response));
+
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+}
+
+// A full batch is sent without waiting for the window, cancelled GETs aren't called back, and an
+// error response to the MGET is the response to each GET.
+TEST_F(RedisConnPoolImplTest, CoalesceGetsFullBatch) {
+  setupGetCoalescing(2);
+
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Event::MockTimer* window_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  MockPoolCallbacks callbacks1, callbacks2;
+  EXPECT_CALL(*window_timer, enableHRTimer(_, _));
+  Common::Redis::Client::PoolRequest* request1 =
+      conn_pool_->makeRequest("foo", ConnPool::RespVariant(*makeGet("foo")), callbacks1);
+  EXPECT_CALL(*window_timer, enableTimer(std::chrono::milliseconds(0), _));
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("bar", ConnPool::RespVariant(*makeGet("bar")), callbacks2));
+  request1->cancel();
+
+  // The GETs that follow a full batch are coalesced into a new one.
+  Event::MockTimer* window_timer2 = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  MockPoolCallbacks callbacks3;
+  EXPECT_CALL(*window_timer2, enableHRTimer(_, _));
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("baz", ConnPool::RespVariant(*makeGet("baz")), callbacks3));
+
+  Common::Redis::Client::MockPoolRequest active_request;
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client));
+  EXPECT_CALL(*client, makeRequest_(Eq(*makeBulkStringArray({"mget", "foo", "bar"})), _))
+      .WillOnce(Return(&active_request));
+  window_timer->invokeCallback();
+
+  Common::Redis::RespValuePtr error = std::make_unique<Common::Redis::RespValue>();
+  error->type(Common::Redis::RespType::Error);
+  error->asString() = "ERR error";
+  EXPECT_CALL(callbacks1, onResponse_(_)).Times(0);
+  EXPECT_CALL(callbacks2, onResponse_(_)).WillOnce(Invoke([](Common::Redis::RespValuePtr& value) {
+    EXPECT_EQ(Common::Redis::RespType::Error, value->type());
+    EXPECT_EQ("ERR error", value->asString());
+  }));
+  client->client_callbacks_.back()->onResponse(std::move(error));
+
+  // The GET of the batch that was never sent fails when the pool is destroyed.
+  EXPECT_CALL(callbacks3, onFailure_());
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+}
+
+// GETs to Redis Cluster aren't coalesced.
+TEST_F(RedisConnPoolImplTest, CoalesceGetsNotAppliedToRedisCluster) {
+  setupGetCoalescing(100);
+  threadLocalPool().is_redis_cluster_ = true;
+
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::RespValueSharedPtr value = makeGet("foo");
+  Common::Redis::Client::MockPoolRequest active_request;
+  MockPoolCallbacks callbacks;
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client));
+  EXPECT_CALL(*client, makeRequest_(Ref(*value), _)).WillOnce(Return(&active_request));
+  EXPECT_NE(nullptr, conn_pool_->makeRequest("foo", value, callbacks));
+
+  EXPECT_CALL(active_request, cancel());
+  EXPECT_CALL(callbacks, onFailure_());
+  EXPECT_CALL(*client, close());
+  tls_.shutdownThread();
+}
+
+// GET responses are cached once tracking is enabled on the connection, cache hits are answered
+// on the next dispatcher iteration, and invalidations drop the cached values.
+TEST_F(RedisConnPoolImplTest, NearCache) {
+  near_cache_max_bytes_ = 1024;
+  Event::MockTimer* hit_timer = new NiceMock<Event::MockTimer>(&tls_.dispatcher_);
+  setup();
+  EXPECT_CALL(cm_.thread_local_cluster_.lb_, chooseHost(_))
+      .WillRepeatedly(Return(cm_.thread_local_cluster_.lb_.host_));
+
+  Common::Redis::Client::MockClient* client = new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockClient* invalidation_client =
+      new NiceMock<Common::Redis::Client::MockClient>();
+  Common::Redis::Client::MockPoolRequest active_request;
+  EXPECT_CALL(*this, create_(_)).WillOnce(Return(client)).WillOnce(Return(invalidation_client));
+  EXPECT_CALL(*invalidation_client,
+              makeRequest_(Eq(Common::Redis::Utility::ClientIdRequest::instance()), _));
+  EXPECT_CALL(
+      *invalidation_client,
+      makeRequest_(Eq(Common::Redis::Utility::SubscribeInvalidationsRequest::instance()), _));
+  EXPECT_CALL(*client, makeRequest_(_, _)).WillRepeatedly(Return(&active_request));
+
+  // A response that arrives before tracking is enabled isn't cached.
+  MockPoolCallbacks callbacks1;
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("foo", ConnPool::RespVariant(*makeGet("foo")), callbacks1));
+  respond(callbacks1, client);
+
+  Common::Redis::RespValuePtr client_id = std::make_unique<Common::Redis::RespValue>();
+  client_id->type(Common::Redis::RespType::Integer);
+  client_id->asInteger() = 7;
+  invalidation_client->client_callbacks_.front()->onResponse(std::move(client_id));
+  EXPECT_CALL(*client, makeRequest_(Eq(Common::Redis::Utility::ClientTrackingRequest(7)), _));
+  invalidation_client->client_callbacks_.back()->onResponse(
+      makeBulkStringArray({"subscribe", "__redis__:invalidate"}));
+  Common::Redis::RespValuePtr ok = std::make_unique<Common::Redis::RespValue>();
+  ok->type(Common::Redis::RespType::SimpleString);
+  ok->asString() = "OK";
+  client->client_callbacks_.back()->onResponse(std::move(ok));
+
+  MockPoolCallbacks callbacks2;
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("foo", ConnPool::RespVariant(*makeGet("foo")), callbacks2));
+  Common::Redis::RespValuePtr value = std::make_unique<Common::Redis::RespValue>();
+  value->type(Common::Redis::RespType::BulkString);
+  value->asString() = "bar";
+  EXPECT_CALL(callbacks2, onResponse_(_));
+  client->client_callbacks_.back()->onResponse(std::move(value));
+
+  // The cached value is the response to the next GET, without a request to the host.
+  MockPoolCallbacks callbacks3;
+  const uint64_t requests = client->client_callbacks_.size();
+  EXPECT_CALL(*hit_timer, enableTimer(std::chrono::milliseconds(0), _));
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("foo", ConnPool::RespVariant(*makeGet("foo")), callbacks3));
+  EXPECT_EQ(requests, client->client_callbacks_.size());
+  EXPECT_CALL(callbacks3, onResponse_(_)).WillOnce(Invoke([](Common::Redis::RespValuePtr& value) {
+    EXPECT_EQ(Common::Redis::RespType::BulkString, value->type());
+    EXPECT_EQ("bar", value->asString());
+  }));
+  hit_timer->invokeCallback();
+
+  // Once the key is invalidated, GETs are sent to the host again.
+  Common::Redis::RespValuePtr invalidation =
+      makeBulkStringArray({"message", "__redis__:invalidate"});
+  invalidation->asArray().push_back(*makeBulkStringArray({"foo"}));
+  invalidation_client->push_callbacks_->onPush(std::move(invalidation));
+  MockPoolCallbacks callbacks4;
+  EXPECT_NE(nullptr,
+            conn_pool_->makeRequest("foo", ConnPool::RespVariant(*makeGet("foo")), callbacks4));
+  EXPECT_EQ(requests + 1, client->client_callbacks_.size());
+  respond(callbacks4, client);
+
+  EXPECT_CALL(*client, close());
+  EXPECT_CALL(*invalidation_client, close());
+  tls_.shutdownThread();
+}
+
 } // namespace ConnPool
 } // namespace RedisProxy
 } // namespace NetworkFilters
@@ -0,0 +1,143 @@
+#include <string>
+
+#include "extensions/filters/network/redis_proxy/near_cache_impl.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace RedisProxy {
+namespace ConnPool {
+
+class RedisNearCacheTest : public testing::Test {
+public:
+  // Each entry of a one character key and a three character value takes 69 bytes.
+  RedisNearCacheTest() : stats_(generateNearCacheStats(store_)), cache_(150, stats_) {}
+
+  static Common::Redis::RespValue makeBulkString(const std::string& str) {
+    Common::Redis::RespValue value;
+    value.type(Common::Redis::RespType::BulkString);
+    value.asString() = str;
+    return value;
+  }
+
+  void fill(const std::string& key, const std::string& str) {
+    Common::Redis::RespValue value = makeBulkString(str);
+    cache_.startFill(key);
+    cache_.finishFill(key, &value);
+  }
+
+  uint64_t counter(const std::string& name) {
+    return store_.counter("near_cache." + name).value();
+  }
+
+  uint64_t bytes() {
+    return store_.gauge("near_cache.bytes", Stats::Gauge::ImportMode::Accumulate).value();
+  }
+
+  Stats::TestUtil::TestStore store_;
+  NearCacheStats stats_;
+  NearCache cache_;
+};
+
+TEST_F(RedisNearCacheTest, FillAndLookup) {
+  EXPECT_EQ(nullptr, cache_.lookup("a"));
+  EXPECT_EQ(1UL, counter("miss"));
+
+  fill("a", "foo");
+  const Common::Redis::RespValue* value = cache_.lookup("a");
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ(makeBulkString("foo"), *value);
+  EXPECT_EQ(1UL, counter("hit"));
+  EXPECT_EQ(69UL, bytes());
+
+  // Nulls are cached, errors and failed fills aren't.
+  Common::Redis::RespValue null;
+  cache_.startFill("b");
+  cache_.finishFill("b", &null);
+  ASSERT_NE(nullptr, cache_.lookup("b"));
+  EXPECT_EQ(Common::Redis::RespType::Null, cache_.lookup("b")->type());
+
+  Common::Redis::RespValue error;
+  error.type(Common::Redis::RespType::Error);
+  cache_.startFill("c");
+  cache_.finishFill("c", &error);
+  EXPECT_EQ(nullptr, cache_.lookup("c"));
+
+  cache_.startFill("d");
+  cache_.finishFill("d", nullptr);
+  EXPECT_EQ(nullptr, cache_.lookup("d"));
+}
+
+TEST_F(RedisNearCacheTest, Invalidate) {
+  fill("a", "foo");
+  cache_.invalidate("a");
+  EXPECT_EQ(nullptr, cache_.lookup("a"));
+  EXPECT_EQ(1UL, counter("invalidation"));
+  EXPECT_EQ(0UL, bytes());
+
+  // Invalidating a key that isn't cached is a no-op.
+  cache_.invalidate("b");
+  EXPECT_EQ(1UL, counter("invalidation"));
+}
+
+TEST_F(RedisNearCacheTest, InvalidateDuringFill) {
+  Common::Redis::RespValue value = makeBulkString("foo");
+  cache_.startFill("a");
+  cache_.startFill("a");
+  cache_.invalidate("a");
+  cache_.finishFill("a", &value);
+  cache_.finishFill("a", &value);
+  EXPECT_EQ(nullptr, cache_.lookup("a"));
+
+  // A fill started after the others finished isn't affected by the invalidation.
+  fill("a", "foo");
+  EXPECT_NE(nullptr, cache_.lookup("a"));
+}
+
+TEST_F(RedisNearCacheTest, EvictLeastRecentlyUsed) {
+  fill("a", "foo");
+  fill("b", "bar");
+  EXPECT_NE(nullptr, cache_.lookup("a"));
+
+  fill("c", "baz");
+  EXPECT_EQ(1UL, counter("eviction"));
+  EXPECT_EQ(nullptr, cache_.lookup("b"));
+  EXPECT_NE(nullptr, cache_.lookup("a"));
+  EXPECT_NE(nullptr, cache_.lookup("c"));
+  EXPECT_EQ(138UL, bytes());
+
+  // Replacing a value doesn't evict other entries.
+  fill("a", "qux");
+  EXPECT_EQ(1UL, counter("eviction"));
+  EXPECT_EQ(makeBulkString("qux"), *cache_.lookup("a"));
+
+  // A value larger than the cache isn't cached.
+  fill("d", std::string(100, 'x'));
+  EXPECT_EQ(nullptr, cache_.lookup("d"));
+  EXPECT_EQ(1UL, counter("eviction"));
+}
+
+TEST_F(RedisNearCacheTest, Clear) {
+  fill("a", "foo");
+  fill("b", "bar");
+  Common::Redis::RespValue value = makeBulkString("baz");
+  cache_.startFill("c");
+
+  cache_.clear();
+  cache_.finishFill("c", &value);
+  EXPECT_EQ(nullptr, cache_.lookup("a"));
+  EXPECT_EQ(nullptr, cache_.lookup("b"));
+  EXPECT_EQ(nullptr, cache_.lookup("c"));
+  EXPECT_EQ(2UL, counter("invalidation"));
+  EXPECT_EQ(0UL, bytes());
+}
+
+} // namespace ConnPool
+} // namespace RedisProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
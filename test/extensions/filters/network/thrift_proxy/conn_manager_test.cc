@@ -1644,6 +1644,28 @@ payload_passthrough: true
   EXPECT_EQ(0U, store_.counter("test.response").value());
 }
 
+TEST_F(ThriftConnectionManagerTest, PayloadPassthroughOnDataHandlesHeaderTransport) {
+  const std::string yaml = R"EOF(
+transport: HEADER
+protocol: BINARY
+stat_prefix: test
+payload_passthrough: true
+)EOF";
+
+  initializeFilter(yaml);
+  writeMessage(buffer_, TransportType::Header, ProtocolType::Binary, MessageType::Call, 0x0F);
+
+  EXPECT_CALL(*decoder_filter_, passthroughSupported()).WillRepeatedly(Return(true));
+  EXPECT_CALL(*decoder_filter_, passthroughData(_));
+
+  EXPECT_EQ(filter_->onData(buffer_, false), Network::FilterStatus::StopIteration);
+  EXPECT_EQ(0, buffer_.length());
+
+  EXPECT_EQ(1U, store_.counter("test.request_call").value());
+  EXPECT_EQ(0U, store_.counter("test.request_decoding_error").value());
+  EXPECT_EQ(1U, stats_.request_active_.value());
+}
+
 TEST_F(ThriftConnectionManagerTest, PayloadPassthroughOnDataHandlesThriftOneWay) {
   const std::string yaml = R"EOF(
 stat_prefix: test
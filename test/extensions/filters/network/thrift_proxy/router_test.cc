@@ -410,9 +410,11 @@ static std::string downstreamUpstreamTypesToString(
 }
 
 INSTANTIATE_TEST_SUITE_P(DownstreamUpstreamTypes, ThriftRouterPassthroughTest,
-                         Combine(Values(TransportType::Framed, TransportType::Unframed),
+                         Combine(Values(TransportType::Framed, TransportType::Unframed,
+                                        TransportType::Header),
                                  Values(ProtocolType::Binary, ProtocolType::Twitter),
-                                 Values(TransportType::Framed, TransportType::Unframed),
+                                 Values(TransportType::Framed, TransportType::Unframed,
+                                        TransportType::Header),
                                  Values(ProtocolType::Binary, ProtocolType::Twitter)),
                          downstreamUpstreamTypesToString);
 
@@ -1219,7 +1221,8 @@ TEST_P(ThriftRouterPassthroughTest, PassthroughEnable) {
 
   bool passthroughSupported = false;
   if (downstream_transport_type == upstream_transport_type &&
-      downstream_transport_type == TransportType::Framed &&
+      (downstream_transport_type == TransportType::Framed ||
+       downstream_transport_type == TransportType::Header) &&
       downstream_protocol_type == upstream_protocol_type &&
       downstream_protocol_type != ProtocolType::Twitter) {
     passthroughSupported = true;
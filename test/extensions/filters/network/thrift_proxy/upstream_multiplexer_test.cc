@@ -0,0 +1,228 @@
+#include <memory>
+
+#include "envoy/tcp/conn_pool.h"
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/network/thrift_proxy/binary_protocol_impl.h"
+#include "extensions/filters/network/thrift_proxy/framed_transport_impl.h"
+#include "extensions/filters/network/thrift_proxy/router/upstream_multiplexer.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/tcp/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/printers.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::InSequence;
+using testing::NiceMock;
+using testing::Ref;
+
+namespace Envoy {
+namespace Extensions {
+namespace NetworkFilters {
+namespace ThriftProxy {
+namespace Router {
+
+class MockMultiplexedRequestCallbacks : public MultiplexedRequestCallbacks {
+public:
+  MOCK_METHOD(void, onMultiplexedConnectionReady,
+              (Network::Connection&, Upstream::HostDescriptionConstSharedPtr, int32_t));
+  MOCK_METHOD(void, onMultiplexedConnectionFailure,
+              (ConnectionPool::PoolFailureReason, Upstream::HostDescriptionConstSharedPtr));
+  MOCK_METHOD(void, onMultiplexedResponse, (Buffer::Instance&));
+  MOCK_METHOD(void, onMultiplexedConnectionClose, (Network::ConnectionEvent));
+};
+
+class ThriftUpstreamMultiplexerTest : public testing::Test {
+public:
+  void initialize(uint32_t max_concurrent_requests = 100) {
+    multiplexer_ = std::make_unique<UpstreamMultiplexer>(tls_, max_concurrent_requests);
+  }
+
+  void readyConnection() {
+    EXPECT_CALL(*pool_.connection_data_, addUpstreamCallbacks(_))
+        .WillOnce(Invoke([&](Tcp::ConnectionPool::UpstreamCallbacks& callbacks) -> void {
+          upstream_callbacks_ = &callbacks;
+        }));
+    pool_.poolReady(connection_);
+  }
+
+  static void addResponse(Buffer::Instance& buffer, int32_t sequence_id) {
+    MessageMetadata metadata;
+    metadata.setMethodName("method");
+    metadata.setMessageType(MessageType::Reply);
+    metadata.setSequenceId(sequence_id);
+
+    BinaryProtocolImpl protocol;
+    Buffer::OwnedImpl message;
+    protocol.writeMessageBegin(message, metadata);
+    protocol.writeStructBegin(message, "");
+    protocol.writeFieldBegin(message, "", FieldType::Stop, 0);
+    protocol.writeStructEnd(message);
+    protocol.writeMessageEnd(message);
+
+    FramedTransportImpl transport;
+    transport.encodeFrame(buffer, metadata, message);
+  }
+
+  NiceMock<Tcp::ConnectionPool::MockInstance> pool_;
+  NiceMock<Network::MockClientConnection> connection_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::unique_ptr<UpstreamMultiplexer> multiplexer_;
+  Tcp::ConnectionPool::UpstreamCallbacks* upstream_callbacks_{};
+  MockMultiplexedRequestCallbacks callbacks1_;
+  MockMultiplexedRequestCallbacks callbacks2_;
+  MockMultiplexedRequestCallbacks callbacks3_;
+};
+
+TEST_F(ThriftUpstreamMultiplexerTest, SharesConnection) {
+  initialize();
+
+  EXPECT_CALL(pool_, newConnection(_));
+  MultiplexedRequestPtr request1 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks1_);
+  MultiplexedRequestPtr request2 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks2_);
+
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionReady(Ref(connection_), _, 0));
+  EXPECT_CALL(callbacks2_, onMultiplexedConnectionReady(Ref(connection_), _, 1));
+  readyConnection();
+
+  // A request attached to the connection once it's ready doesn't wait.
+  EXPECT_CALL(callbacks3_, onMultiplexedConnectionReady(Ref(connection_), _, 2));
+  MultiplexedRequestPtr request3 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks3_);
+
+  // Responses arrive out of order, and split across reads.
+  Buffer::OwnedImpl responses;
+  addResponse(responses, 1);
+  addResponse(responses, 0);
+  const uint64_t frame_size = responses.length() / 2;
+  Buffer::OwnedImpl partial;
+  partial.move(responses, frame_size + 2);
+
+  {
+    InSequence s;
+    EXPECT_CALL(callbacks2_, onMultiplexedResponse(_))
+        .WillOnce(Invoke([&](Buffer::Instance& frame) -> void {
+          EXPECT_EQ(frame_size, frame.length());
+          request2->release(false);
+        }));
+    EXPECT_CALL(callbacks1_, onMultiplexedResponse(_))
+        .WillOnce(Invoke([&](Buffer::Instance& frame) -> void {
+          EXPECT_EQ(frame_size, frame.length());
+          request1->release(false);
+        }));
+  }
+  upstream_callbacks_->onUpstreamData(partial, false);
+  upstream_callbacks_->onUpstreamData(responses, false);
+
+  // The connection returns to the pool once its last request is done.
+  EXPECT_CALL(connection_, close(_)).Times(0);
+  EXPECT_CALL(pool_, released(Ref(connection_)));
+  request3->release(false);
+  tls_.dispatcher_.to_delete_.clear();
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, MaxConcurrentRequests) {
+  initialize(1);
+
+  EXPECT_CALL(pool_, newConnection(_)).Times(2);
+  MultiplexedRequestPtr request1 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks1_);
+  MultiplexedRequestPtr request2 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks2_);
+  EXPECT_EQ(2UL, pool_.callbacks_.size());
+
+  // A request of another protocol doesn't share the connections either.
+  EXPECT_CALL(pool_, newConnection(_));
+  MultiplexedRequestPtr request3 = multiplexer_->attach(pool_, ProtocolType::Compact, callbacks3_);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, AbandonedRequestDrainsConnection) {
+  initialize();
+
+  EXPECT_CALL(pool_, newConnection(_));
+  MultiplexedRequestPtr request1 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks1_);
+  MultiplexedRequestPtr request2 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks2_);
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionReady(_, _, 0));
+  EXPECT_CALL(callbacks2_, onMultiplexedConnectionReady(_, _, 1));
+  readyConnection();
+
+  // The response to the abandoned request is dropped, and later requests use a new connection.
+  request1->release(true);
+  EXPECT_CALL(pool_, newConnection(_));
+  MultiplexedRequestPtr request3 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks3_);
+
+  Buffer::OwnedImpl response;
+  addResponse(response, 0);
+  EXPECT_CALL(callbacks1_, onMultiplexedResponse(_)).Times(0);
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush));
+  request2->release(false);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, PoolFailure) {
+  initialize();
+
+  MultiplexedRequestPtr request1 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks1_);
+  MultiplexedRequestPtr request2 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks2_);
+
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionFailure(
+                               ConnectionPool::PoolFailureReason::RemoteConnectionFailure, _));
+  EXPECT_CALL(callbacks2_, onMultiplexedConnectionFailure(
+                               ConnectionPool::PoolFailureReason::RemoteConnectionFailure, _));
+  pool_.poolFailure(ConnectionPool::PoolFailureReason::RemoteConnectionFailure);
+
+  // Releasing a failed request is a no-op.
+  request1->release(false);
+  tls_.dispatcher_.to_delete_.clear();
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, ConnectionClose) {
+  initialize();
+
+  MultiplexedRequestPtr request1 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks1_);
+  MultiplexedRequestPtr request2 = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks2_);
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionReady(_, _, 0));
+  EXPECT_CALL(callbacks2_, onMultiplexedConnectionReady(_, _, 1));
+  readyConnection();
+
+  Buffer::OwnedImpl response;
+  addResponse(response, 0);
+  EXPECT_CALL(callbacks1_, onMultiplexedResponse(_));
+  upstream_callbacks_->onUpstreamData(response, false);
+
+  // Only the requests still in flight learn about the close.
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionClose(_)).Times(0);
+  EXPECT_CALL(callbacks2_, onMultiplexedConnectionClose(Network::ConnectionEvent::RemoteClose));
+  upstream_callbacks_->onEvent(Network::ConnectionEvent::RemoteClose);
+
+  request1->release(false);
+  request2->release(false);
+}
+
+TEST_F(ThriftUpstreamMultiplexerTest, InvalidFrameClosesConnection) {
+  initialize();
+
+  MultiplexedRequestPtr request = multiplexer_->attach(pool_, ProtocolType::Binary, callbacks1_);
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionReady(_, _, 0));
+  readyConnection();
+
+  Buffer::OwnedImpl response;
+  response.writeBEInt<int32_t>(0);
+  EXPECT_CALL(callbacks1_, onMultiplexedResponse(_)).Times(0);
+  EXPECT_CALL(connection_, close(Network::ConnectionCloseType::NoFlush))
+      .WillOnce(Invoke([&](Network::ConnectionCloseType) -> void {
+        upstream_callbacks_->onEvent(Network::ConnectionEvent::LocalClose);
+      }));
+  EXPECT_CALL(callbacks1_, onMultiplexedConnectionClose(Network::ConnectionEvent::LocalClose));
+  upstream_callbacks_->onUpstreamData(response, false);
+}
+
+} // namespace Router
+} // namespace ThriftProxy
+} // namespace NetworkFilters
+} // namespace Extensions
+} // namespace Envoy
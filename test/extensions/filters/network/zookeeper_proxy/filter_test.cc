@@ -529,6 +529,16 @@ TEST_F(ZooKeeperFilterTest, Connect) {
   EXPECT_NE(absl::nullopt, findHistogram("test.zookeeper.connect_response_latency"));
 }
 
+// The latency histograms are created with the config, before any response.
+TEST_F(ZooKeeperFilterTest, LatencyHistogramsCreatedWithConfig) {
+  initialize();
+
+  EXPECT_NE(absl::nullopt, findHistogram("test.zookeeper.connect_response_latency"));
+  EXPECT_NE(absl::nullopt, findHistogram("test.zookeeper.unknown_opcode_latency"));
+  EXPECT_NE(absl::nullopt, findHistogram("test.zookeeper.getdata_resp_latency"));
+  EXPECT_NE(absl::nullopt, findHistogram("test.zookeeper.getallchildrennumber_resp_latency"));
+}
+
 TEST_F(ZooKeeperFilterTest, ConnectReadonly) {
   initialize();
 
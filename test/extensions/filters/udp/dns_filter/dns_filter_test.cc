@@ -205,6 +205,23 @@ server_config:
             - "10.0.0.1"
 )EOF";
 
+  const std::string forward_query_cached_config = R"EOF(
+stat_prefix: "my_prefix"
+client_config:
+  resolver_timeout: 1s
+  upstream_resolvers:
+  - socket_address:
+      address: "1.1.1.1"
+      port_value: 53
+  max_pending_lookups: 16
+  max_cached_answers: 16
+server_config:
+  inline_dns_table:
+    external_retry_count: 0
+    known_suffixes:
+    - suffix: foo1.com
+)EOF";
+
   const std::string external_dns_table_config = R"EOF(
 stat_prefix: "my_prefix"
 client_config:
@@ -687,6 +704,62 @@ TEST_F(DnsFilterTest, ExternalResolutionReturnSingleAddress) {
   EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
 }
 
+TEST_F(DnsFilterTest, ExternalResolutionCachedAnswers) {
+  InSequence s;
+
+  auto timeout_timer = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timeout_timer, enableTimer(_, _));
+
+  const std::string expected_address("130.207.244.251");
+  const std::string domain("www.foobaz.com");
+  setup(forward_query_cached_config);
+
+  const std::string query =
+      Utils::buildQueryForDomain(domain, DNS_RECORD_TYPE_A, DNS_RECORD_CLASS_IN);
+  ASSERT_FALSE(query.empty());
+
+  Network::DnsResolver::ResolveCb resolve_cb;
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  EXPECT_CALL(*timeout_timer, disableTimer()).Times(AnyNumber());
+  resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+             TestUtility::makeDnsResponse({expected_address}));
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  // The same query is answered from the cache, with the remainder of the TTL.
+  simTime().advanceTimeWait(std::chrono::seconds(100));
+  EXPECT_CALL(*resolver_, resolve(_, _, _)).Times(0);
+  sendQueryFromClient("10.0.0.1:1000", query);
+
+  query_ctx_ = response_parser_->createQueryContext(udp_response_, counters_);
+  EXPECT_TRUE(query_ctx_->parse_status_);
+  EXPECT_EQ(DNS_RESPONSE_CODE_NO_ERROR, query_ctx_->getQueryResponseCode());
+  ASSERT_EQ(1, query_ctx_->answers_.size());
+  std::list<std::string> expected{expected_address};
+  for (const auto& answer : query_ctx_->answers_) {
+    EXPECT_EQ(answer.first, domain);
+    EXPECT_EQ(std::chrono::seconds(200), answer.second->ttl_);
+    Utils::verifyAddress(expected, answer.second);
+  }
+
+  EXPECT_EQ(2, config_->stats().downstream_rx_queries_.value());
+  EXPECT_EQ(1, config_->stats().external_a_record_queries_.value());
+  EXPECT_EQ(1, config_->stats().external_cache_hits_.value());
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+
+  // Once the TTL elapsed, the name is resolved externally again.
+  simTime().advanceTimeWait(std::chrono::seconds(200));
+  auto timeout_timer2 = new NiceMock<Event::MockTimer>(&dispatcher_);
+  EXPECT_CALL(*timeout_timer2, enableTimer(_, _));
+  EXPECT_CALL(*resolver_, resolve(domain, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  sendQueryFromClient("10.0.0.1:1000", query);
+  EXPECT_EQ(1, config_->stats().external_cache_hits_.value());
+  EXPECT_TRUE(Mock::VerifyAndClearExpectations(resolver_.get()));
+}
+
 TEST_F(DnsFilterTest, ExternalResolutionIpv6SingleAddress) {
   InSequence s;
 
@@ -41,6 +41,11 @@ public:
   MOCK_METHOD(Network::SocketPtr, createSocket, (const Upstream::HostConstSharedPtr& host));
 };
 
+class MockOsSysCallsWithGso : public Api::MockOsSysCalls {
+public:
+  MOCK_METHOD(bool, supportsUdpGso, (), (const));
+};
+
 Api::IoCallUint64Result makeNoError(uint64_t rc) {
   auto no_error = Api::ioCallUint64ResultNoError();
   no_error.rc_ = rc;
@@ -277,7 +282,7 @@ use_original_src_ip: true
     return true;
   }
 
-  Api::MockOsSysCalls os_sys_calls_;
+  MockOsSysCallsWithGso os_sys_calls_;
   TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls_;
   Upstream::MockClusterManager cluster_manager_;
   NiceMock<MockTimeSystem> time_system_;
@@ -773,6 +778,66 @@ hash_policies:
   test_sessions_[0].recvDataFromUpstream("world");
 }
 
+#ifdef UDP_SEGMENT
+// Datagrams written upstream during an event loop iteration are sent with a single GSO sendmsg.
+TEST_F(UdpProxyFilterTest, GsoBatchesUpstreamWrites) {
+  EXPECT_CALL(os_sys_calls_, supportsUdpGso()).WillRepeatedly(Return(true));
+  auto* flush_cb = new Event::MockSchedulableCallback(&callbacks_.udp_listener_.dispatcher_);
+  setup(R"EOF(
+stat_prefix: foo
+cluster: fake_cluster
+upstream_socket_config:
+  prefer_gso: true
+  )EOF");
+
+  expectSessionCreate(upstream_address_);
+  EXPECT_CALL(*test_sessions_[0].idle_timer_, enableTimer(config_->sessionTimeout(), nullptr))
+      .Times(5);
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration()).Times(3);
+  for (int i = 0; i < 3; ++i) {
+    recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  }
+  checkTransferStats(15 /*rx_bytes*/, 3 /*rx_datagrams*/, 0 /*tx_bytes*/, 0 /*tx_datagrams*/);
+
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, 0))
+      .WillOnce(Invoke([](os_fd_t, const msghdr* message, int) -> Api::SysCallSizeResult {
+        EXPECT_EQ(1, message->msg_iovlen);
+        EXPECT_EQ("hellohellohello",
+                  absl::string_view(static_cast<const char*>(message->msg_iov[0].iov_base),
+                                    message->msg_iov[0].iov_len));
+        const cmsghdr* cmsg = CMSG_FIRSTHDR(message);
+        EXPECT_EQ(SOL_UDP, cmsg->cmsg_level);
+        EXPECT_EQ(UDP_SEGMENT, cmsg->cmsg_type);
+        EXPECT_EQ(5, *reinterpret_cast<const uint16_t*>(CMSG_DATA(cmsg)));
+        return {15, 0};
+      }));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(3, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_datagrams")
+                   ->value());
+
+  // Failed flushes are counted as upstream send errors.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, 0))
+      .WillOnce(Return(Api::SysCallSizeResult{-1, SOCKET_ERROR_AGAIN}));
+  flush_cb->invokeCallback();
+  EXPECT_EQ(1, TestUtility::findCounter(
+                   cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_,
+                   "udp.sess_tx_errors")
+                   ->value());
+
+  // The writer is retried on the next datagram, and still buffered datagrams are sent when the
+  // session goes away.
+  EXPECT_CALL(*flush_cb, scheduleCallbackCurrentIteration());
+  recvDataFromDownstream("10.0.0.1:1000", "10.0.0.2:80", "hello");
+  EXPECT_CALL(os_sys_calls_, sendmsg(_, _, 0)).WillOnce(Return(Api::SysCallSizeResult{5, 0}));
+  test_sessions_[0].idle_timer_->invokeCallback();
+  EXPECT_EQ(0, config_->stats().downstream_sess_active_.value());
+}
+#endif
+
 // Expect null hash value if hash_policy is not mentioned.
 TEST_F(UdpProxyFilterTest, NullHashWithoutHashPolicy) {
   InSequence s;
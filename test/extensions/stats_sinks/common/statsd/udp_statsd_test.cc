@@ -16,10 +16,12 @@
 #include "test/test_common/network_utility.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "spdlog/spdlog.h"
 
+using testing::InSequence;
 using testing::NiceMock;
 
 namespace Envoy {
@@ -33,6 +35,8 @@ class MockWriter : public UdpStatsdSink::Writer {
 public:
   MOCK_METHOD(void, write, (const std::string& message));
   MOCK_METHOD(void, writeBuffer, (Buffer::Instance & buffer));
+  MOCK_METHOD(void, beginBatch, ());
+  MOCK_METHOD(void, endBatch, ());
 
   void delegateBufferFake() {
     ON_CALL(*this, writeBuffer).WillByDefault([this](Buffer::Instance& buffer) {
@@ -116,6 +120,32 @@ TEST_P(UdpStatsdSinkTest, InitWithIpAddress) {
   tls_.shutdownThread();
 }
 
+// The datagrams of a flush are sent in batches.
+TEST_P(UdpStatsdSinkTest, BatchedDatagrams) {
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  Network::Test::UdpSyncPeer server(GetParam());
+  UdpStatsdSink sink(tls_, server.localAddress(), false);
+
+  std::vector<std::unique_ptr<NiceMock<Stats::MockCounter>>> counters;
+  for (uint32_t i = 0; i < 100; ++i) {
+    counters.push_back(std::make_unique<NiceMock<Stats::MockCounter>>());
+    counters.back()->name_ = absl::StrCat("test_counter_", i);
+    counters.back()->used_ = true;
+    counters.back()->latch_ = i;
+    snapshot.counters_.push_back({i, *counters.back()});
+  }
+
+  sink.flush(snapshot);
+  for (uint32_t i = 0; i < 100; ++i) {
+    Network::UdpRecvData data;
+    server.recv(data);
+    EXPECT_EQ(absl::StrCat("envoy.test_counter_", i, ":", i, "|c"), data.buffer_->toString());
+  }
+
+  tls_.shutdownThread();
+}
+
 class UdpStatsdSinkWithTagsTest : public testing::TestWithParam<Network::Address::IpVersion> {};
 INSTANTIATE_TEST_SUITE_P(IpVersions, UdpStatsdSinkWithTagsTest,
                          testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
@@ -200,6 +230,43 @@ TEST(UdpStatsdSinkTest, CheckActualStats) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, CheckFlushIsBatched) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false, getDefaultPrefix(), 32);
+
+  NiceMock<Stats::MockCounter> counter;
+  counter.name_ = "test_counter";
+  counter.used_ = true;
+  counter.latch_ = 1;
+  snapshot.counters_.push_back({1, counter});
+
+  NiceMock<Stats::MockGauge> gauge;
+  gauge.name_ = "test_gauge";
+  gauge.value_ = 1;
+  gauge.used_ = true;
+  snapshot.gauges_.push_back(gauge);
+
+  // All the datagrams of the flush are written within a single batch.
+  {
+    InSequence s;
+    EXPECT_CALL(*writer_ptr, beginBatch());
+    EXPECT_CALL(*writer_ptr, writeBuffer(_)).Times(2);
+    EXPECT_CALL(*writer_ptr, endBatch());
+  }
+  sink.flush(snapshot);
+
+  // The histograms aren't.
+  NiceMock<Stats::MockHistogram> timer;
+  timer.name_ = "test_timer";
+  EXPECT_CALL(*writer_ptr, beginBatch()).Times(0);
+  EXPECT_CALL(*writer_ptr, write("envoy.test_timer:5|ms"));
+  sink.onHistogramComplete(timer, 5);
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, CheckMetricLargerThanBuffer) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
@@ -458,6 +458,39 @@ TEST_F(HystrixSinkTest, AddAndRemoveClusters) {
   validateResults(cluster_message_map[cluster2_name_], 0, 0, 0, 0, 0, window_size_);
 }
 
+// A connection registered with clusters is only streamed their events, while the others still get
+// the events of all the clusters.
+TEST_F(HystrixSinkTest, ClusterFilter) {
+  createClusterAndCallbacks();
+  addSecondClusterHelper(cluster_stats_buffer_);
+  sink_->registerConnection(&callbacks_);
+
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> filtered_callbacks;
+  ON_CALL(filtered_callbacks, streamId()).WillByDefault(Return(1));
+  Buffer::OwnedImpl filtered_buffer;
+  ON_CALL(filtered_callbacks, encodeData(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) { filtered_buffer.add(data); }));
+  sink_->registerConnection(&filtered_callbacks, {cluster2_name_, "unknown_cluster"});
+
+  sink_->flush(snapshot_);
+  absl::node_hash_map<std::string, std::string> cluster_message_map =
+      buildClusterMap(cluster_stats_buffer_.toString());
+  EXPECT_EQ(2, cluster_message_map.size());
+  cluster_message_map = buildClusterMap(filtered_buffer.toString());
+  ASSERT_EQ(1, cluster_message_map.size());
+  validateResults(cluster_message_map[cluster2_name_], 0, 0, 0, 0, 0, window_size_);
+
+  // Once the unfiltered connection is gone, only the filtered clusters are streamed.
+  cluster_stats_buffer_.drain(cluster_stats_buffer_.length());
+  filtered_buffer.drain(filtered_buffer.length());
+  sink_->unregisterConnection(&callbacks_);
+  sink_->flush(snapshot_);
+  EXPECT_EQ(0, cluster_stats_buffer_.length());
+  cluster_message_map = buildClusterMap(filtered_buffer.toString());
+  ASSERT_EQ(1, cluster_message_map.size());
+  EXPECT_NE(cluster_message_map.end(), cluster_message_map.find(cluster2_name_));
+}
+
 TEST_F(HystrixSinkTest, HistogramTest) {
   InSequence s;
 
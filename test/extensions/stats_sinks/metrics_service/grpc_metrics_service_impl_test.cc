@@ -70,6 +70,39 @@ TEST_F(GrpcMetricsStreamerImplTest, BasicFlow) {
       std::make_unique<envoy::service::metrics::v3::StreamMetricsResponse>());
 }
 
+// Test that the metric families are all sent, along with the identifier on the first message only.
+TEST_F(GrpcMetricsStreamerImplTest, SendsMetricFamilies) {
+  InSequence s;
+
+  MockMetricsStream stream;
+  MetricsServiceCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  auto expect_sent = [&stream](bool has_identifier) {
+    EXPECT_CALL(stream, sendMessageRaw_(_, false))
+        .WillOnce(Invoke([has_identifier](Buffer::InstancePtr& request, bool) {
+          envoy::service::metrics::v3::StreamMetricsMessage message;
+          EXPECT_TRUE(message.ParseFromString(request->toString()));
+          EXPECT_EQ(has_identifier, message.has_identifier());
+          ASSERT_EQ(2, message.envoy_metrics_size());
+          EXPECT_EQ("test_counter", message.envoy_metrics(0).name());
+          EXPECT_EQ("test_gauge", message.envoy_metrics(1).name());
+        }));
+  };
+  auto make_metrics = [] {
+    auto metrics = std::make_unique<
+        Envoy::Protobuf::RepeatedPtrField<io::prometheus::client::MetricFamily>>();
+    metrics->Add()->set_name("test_counter");
+    metrics->Add()->set_name("test_gauge");
+    return metrics;
+  };
+
+  expect_sent(true);
+  streamer_->send(make_metrics());
+  expect_sent(false);
+  streamer_->send(make_metrics());
+}
+
 // Test that stream failure is handled correctly.
 TEST_F(GrpcMetricsStreamerImplTest, StreamFailure) {
   InSequence s;
@@ -164,6 +197,27 @@ TEST_F(MetricsServiceSinkTest, CheckStatsCount) {
   sink.flush(snapshot_);
 }
 
+// Test that histograms are reported as both a summary and a histogram family.
+TEST_F(MetricsServiceSinkTest, ReportHistograms) {
+  MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
+                     envoy::service::metrics::v3::StreamMetricsResponse>
+      sink(streamer_, false);
+
+  auto histogram = std::make_shared<NiceMock<Stats::MockParentHistogram>>();
+  histogram->name_ = "test_histogram";
+  histogram->used_ = true;
+  snapshot_.histograms_.push_back(*histogram);
+
+  EXPECT_CALL(*streamer_, send(_)).WillOnce(Invoke([](MetricsPtr&& metrics) {
+    ASSERT_EQ(2, metrics->size());
+    EXPECT_EQ(io::prometheus::client::MetricType::SUMMARY, (*metrics)[0].type());
+    EXPECT_EQ("test_histogram", (*metrics)[0].name());
+    EXPECT_EQ(io::prometheus::client::MetricType::HISTOGRAM, (*metrics)[1].type());
+    EXPECT_EQ("test_histogram", (*metrics)[1].name());
+  }));
+  sink.flush(snapshot_);
+}
+
 // Test that verifies counters are correctly reported as current value when configured to do so.
 TEST_F(MetricsServiceSinkTest, ReportCountersValues) {
   MetricsServiceSink<envoy::service::metrics::v3::StreamMetricsMessage,
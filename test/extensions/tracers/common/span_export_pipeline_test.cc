@@ -0,0 +1,162 @@
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "extensions/tracers/common/span_export_pipeline.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_join.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Common {
+namespace {
+
+TEST(SpanRingTest, PushAndPop) {
+  SpanRing<std::string> ring(3);
+  EXPECT_EQ(4U, ring.capacity());
+  EXPECT_FALSE(ring.pop().has_value());
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(ring.push(std::to_string(i)));
+  }
+  EXPECT_FALSE(ring.push("4"));
+  EXPECT_EQ(4U, ring.size());
+
+  EXPECT_EQ("0", ring.pop().value());
+  EXPECT_TRUE(ring.push("5"));
+  for (const char* expected : {"1", "2", "3", "5"}) {
+    EXPECT_EQ(expected, ring.pop().value());
+  }
+  EXPECT_EQ(0U, ring.size());
+}
+
+class TestExporter : public BatchExporter {
+public:
+  void exportBatch(std::string&& payload, uint64_t num_spans,
+                   std::function<void()> done) override {
+    payloads_.push_back(payload);
+    num_spans_ += num_spans;
+    dones_.push_back(std::move(done));
+  }
+
+  std::vector<std::string> payloads_;
+  uint64_t num_spans_{};
+  std::vector<std::function<void()>> dones_;
+};
+
+class SpanExportPipelineTest : public testing::Test {
+public:
+  SpanExportPipelineTest() {
+    // The export thread is kept idle, the tests flush themselves.
+    options_.flush_interval_ = std::chrono::hours(1);
+    options_.ring_capacity_ = 4;
+    options_.max_batch_spans_ = 3;
+    options_.max_pending_batches_ = 2;
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      posted_.push_back(std::move(cb));
+    }));
+  }
+
+  void initialize() {
+    pipeline_ = std::make_unique<SpanExportPipeline<std::string>>(
+        options_, store_, "tracing.test.", dispatcher_, Thread::threadFactoryForTest(), exporter_,
+        [](const std::vector<std::string>& spans) { return absl::StrJoin(spans, ","); });
+  }
+
+  void runPosted() {
+    std::vector<Event::PostCb> posted;
+    posted.swap(posted_);
+    for (auto& cb : posted) {
+      cb();
+    }
+  }
+
+  Stats::TestUtil::TestStore store_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  std::vector<Event::PostCb> posted_;
+  TestExporter exporter_;
+  SpanExportOptions options_;
+  std::unique_ptr<SpanExportPipeline<std::string>> pipeline_;
+};
+
+// The spans of all the rings are exported in batches from the main thread.
+TEST_F(SpanExportPipelineTest, ExportBatches) {
+  initialize();
+  auto ring_1 = pipeline_->createRing();
+  auto ring_2 = pipeline_->createRing();
+  pipeline_->reportSpan(*ring_1, "a");
+  pipeline_->reportSpan(*ring_1, "b");
+  pipeline_->reportSpan(*ring_2, "c");
+  pipeline_->reportSpan(*ring_2, "d");
+
+  pipeline_->flushForTest();
+  EXPECT_EQ(2U, posted_.size());
+  EXPECT_TRUE(exporter_.payloads_.empty());
+
+  runPosted();
+  EXPECT_THAT(exporter_.payloads_, testing::ElementsAre("a,b,c", "d"));
+  EXPECT_EQ(4U, exporter_.num_spans_);
+  EXPECT_EQ(4U, store_.counter("tracing.test.spans_exported").value());
+  EXPECT_EQ(2U, store_.counter("tracing.test.batches_exported").value());
+  EXPECT_EQ(0U, store_.counter("tracing.test.spans_dropped").value());
+}
+
+// The spans stay in the rings while the collector is slow, and the workers drop the spans once
+// their ring is full.
+TEST_F(SpanExportPipelineTest, Backpressure) {
+  options_.max_pending_batches_ = 1;
+  initialize();
+  auto ring = pipeline_->createRing();
+  for (const char* span : {"a", "b", "c", "d"}) {
+    pipeline_->reportSpan(*ring, span);
+  }
+
+  pipeline_->flushForTest();
+  runPosted();
+  EXPECT_THAT(exporter_.payloads_, testing::ElementsAre("a,b,c"));
+
+  for (const char* span : {"e", "f", "g", "h"}) {
+    pipeline_->reportSpan(*ring, span);
+  }
+  EXPECT_EQ(1U, store_.counter("tracing.test.spans_dropped").value());
+
+  // The batch isn't sent yet.
+  pipeline_->flushForTest();
+  EXPECT_TRUE(posted_.empty());
+
+  exporter_.dones_[0]();
+  pipeline_->flushForTest();
+  runPosted();
+  EXPECT_THAT(exporter_.payloads_, testing::ElementsAre("a,b,c", "d,e,f"));
+}
+
+// The callbacks of the main thread don't outlive the pipeline.
+TEST_F(SpanExportPipelineTest, DestroyedBeforePost) {
+  initialize();
+  auto ring = pipeline_->createRing();
+  pipeline_->reportSpan(*ring, "a");
+  pipeline_->flushForTest();
+  pipeline_.reset();
+
+  runPosted();
+  EXPECT_TRUE(exporter_.payloads_.empty());
+}
+
+} // namespace
+} // namespace Common
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -14,6 +14,7 @@
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_tracer_impl.h"
 
+#include "test/mocks/event/mocks.h"
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_info/mocks.h"
 #include "test/mocks/runtime/mocks.h"
@@ -22,6 +23,8 @@
 #include "test/mocks/tracing/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/thread_local_cluster.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -34,6 +37,7 @@ using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 using testing::StrictMock;
 using testing::WithArg;
 
@@ -59,7 +63,8 @@ public:
     }
 
     driver_ = std::make_unique<Driver>(zipkin_config, cm_, stats_, tls_, runtime_, local_info_,
-                                       random_, time_source_);
+                                       random_, time_source_, main_dispatcher_,
+                                       Thread::threadFactoryForTest());
   }
 
   void setupValidDriverWithHostname(const std::string& version, const std::string& hostname) {
@@ -164,6 +169,7 @@ public:
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<LocalInfo::MockLocalInfo> local_info_;
   NiceMock<Random::MockRandomGenerator> random_;
+  NiceMock<Event::MockDispatcher> main_dispatcher_;
 
   NiceMock<Tracing::MockConfig> config_;
   Event::SimulatedTimeSystem test_time_;
@@ -230,6 +236,60 @@ TEST_F(ZipkinDriverTest, FlushSeveralSpansHttpProto) {
   expectValidFlushSeveralSpans("HTTP_PROTO", "application/x-protobuf");
 }
 
+// With the background export, the spans of the workers are serialized by the export thread and
+// sent from the main thread.
+TEST_F(ZipkinDriverTest, BackgroundSpanExport) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.zipkin_background_span_export", "true"}});
+  cm_.initializeClusters({"fake_cluster"}, {});
+  const std::string yaml_string = R"EOF(
+  collector_cluster: fake_cluster
+  collector_endpoint: /api/v2/spans
+  collector_endpoint_version: HTTP_JSON
+  )EOF";
+  envoy::config::trace::v3::ZipkinConfig zipkin_config;
+  TestUtility::loadFromYaml(yaml_string, zipkin_config);
+  setup(zipkin_config, false);
+  ASSERT_NE(nullptr, driver_->exportPipeline());
+
+  // Finishing the span doesn't send it.
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, send_(_, _, _)).Times(0);
+  Tracing::SpanPtr span = driver_->startSpan(config_, request_headers_, operation_name_,
+                                             start_time_, {Tracing::Reason::Sampling, true});
+  span->finishSpan();
+
+  std::function<void()> post_cb;
+  EXPECT_CALL(main_dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  driver_->exportPipeline()->flushForTest();
+  ASSERT_NE(nullptr, post_cb);
+
+  Http::MockAsyncClientRequest request(&cm_.thread_local_cluster_.async_client_);
+  Http::AsyncClient::Callbacks* callback;
+  EXPECT_CALL(cm_.thread_local_cluster_.async_client_, send_(_, _, _))
+      .WillOnce(
+          Invoke([&](Http::RequestMessagePtr& message, Http::AsyncClient::Callbacks& callbacks,
+                     const Http::AsyncClient::RequestOptions&) -> Http::AsyncClient::Request* {
+            callback = &callbacks;
+            EXPECT_EQ("/api/v2/spans", message->headers().getPathValue());
+            EXPECT_EQ("application/json", message->headers().getContentTypeValue());
+            EXPECT_THAT(message->bodyAsString(), testing::HasSubstr("api.lyft.com"));
+            return &request;
+          }));
+  post_cb();
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.spans_sent").value());
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.export.spans_exported").value());
+
+  Http::ResponseMessagePtr msg(new Http::ResponseMessageImpl(
+      Http::ResponseHeaderMapPtr{new Http::TestResponseHeaderMapImpl{{":status", "202"}}}));
+  callback->onSuccess(request, std::move(msg));
+  EXPECT_EQ(1U, stats_.counter("tracing.zipkin.reports_sent").value());
+
+  // Nothing is left to export.
+  EXPECT_CALL(main_dispatcher_, post(_)).Times(0);
+  driver_->exportPipeline()->flushForTest();
+}
+
 TEST_F(ZipkinDriverTest, FlushOneSpanReportFailure) {
   setupValidDriver("HTTP_JSON");
 
@@ -1,16 +1,28 @@
 #include <string>
 #include <vector>
 
+#include "common/network/transport_socket_options_impl.h"
+
 #include "extensions/transport_sockets/tls/cert_validator/default_validator.h"
+#include "extensions/transport_sockets/tls/utility.h"
 
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/transport_sockets/tls/cert_validator/test_common.h"
 #include "test/extensions/transport_sockets/tls/ssl_test_utility.h"
+#include "test/mocks/ssl/mocks.h"
 #include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "openssl/x509v3.h"
 
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
 namespace Envoy {
 namespace Extensions {
 namespace TransportSockets {
@@ -116,6 +128,78 @@ TEST(DefaultCertValidatorTest, TestMatchSubjectAltNameNotMatched) {
   EXPECT_FALSE(DefaultCertValidator::matchSubjectAltName(cert.get(), subject_alt_name_matchers));
 }
 
+TEST(DefaultCertValidatorTest, TestVerificationCache) {
+  Stats::TestUtil::TestStore store;
+  SslStats stats = generateSslStats(store);
+  Event::SimulatedTimeSystem time_system;
+
+  const std::string empty_string;
+  const std::vector<std::string> empty_list;
+  const std::vector<std::string> verify_subject_alt_name_list = {"server1.example.com"};
+  const std::vector<envoy::type::matcher::v3::StringMatcher> empty_matchers;
+  NiceMock<Ssl::MockCertificateValidationContextConfig> config;
+  ON_CALL(config, caCert()).WillByDefault(ReturnRef(empty_string));
+  ON_CALL(config, certificateRevocationList()).WillByDefault(ReturnRef(empty_string));
+  ON_CALL(config, verifySubjectAltNameList())
+      .WillByDefault(ReturnRef(verify_subject_alt_name_list));
+  ON_CALL(config, subjectAltNameMatchers()).WillByDefault(ReturnRef(empty_matchers));
+  ON_CALL(config, verifyCertificateHashList()).WillByDefault(ReturnRef(empty_list));
+  ON_CALL(config, verifyCertificateSpkiList()).WillByDefault(ReturnRef(empty_list));
+  ON_CALL(config, verificationCacheSize()).WillByDefault(Return(1));
+  DefaultCertValidator validator(&config, stats, time_system);
+  validator.initializeSslContexts({}, false);
+
+  bssl::UniquePtr<X509> cert = readCertFromFile(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem"));
+  bssl::UniquePtr<X509> other_cert = readCertFromFile(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns2_cert.pem"));
+  bssl::UniquePtr<X509_STORE> ssl_store(X509_STORE_new());
+  const auto verify = [&](X509* leaf_cert, const Network::TransportSocketOptions* options) {
+    bssl::UniquePtr<X509_STORE_CTX> store_ctx(X509_STORE_CTX_new());
+    EXPECT_EQ(1, X509_STORE_CTX_init(store_ctx.get(), ssl_store.get(), leaf_cert, nullptr));
+    TestSslExtendedSocketInfo extended_socket_info;
+    extended_socket_info.setCertificateValidationStatus(
+        Envoy::Ssl::ClientValidationStatus::NotValidated);
+    const int ret =
+        validator.doVerifyCertChain(store_ctx.get(), &extended_socket_info, *leaf_cert, options);
+    if (ret == 1) {
+      EXPECT_EQ(Envoy::Ssl::ClientValidationStatus::Validated,
+                extended_socket_info.certificateValidationStatus());
+    }
+    return ret;
+  };
+  time_system.setSystemTime(Utility::getExpirationTime(*cert) - std::chrono::hours(1));
+
+  EXPECT_EQ(1, verify(cert.get(), nullptr));
+  EXPECT_EQ(0, stats.cert_verification_cache_hit_.value());
+  EXPECT_EQ(1, stats.cert_verification_cache_miss_.value());
+  EXPECT_EQ(1, verify(cert.get(), nullptr));
+  EXPECT_EQ(1, stats.cert_verification_cache_hit_.value());
+  EXPECT_EQ(1, stats.cert_verification_cache_miss_.value());
+
+  // The subject alt names to verify are part of the key, and failures aren't cached.
+  Network::TransportSocketOptionsImpl options("", {"foo.example.com"});
+  EXPECT_EQ(0, verify(cert.get(), &options));
+  EXPECT_EQ(0, verify(cert.get(), &options));
+  EXPECT_EQ(1, stats.cert_verification_cache_hit_.value());
+  EXPECT_EQ(3, stats.cert_verification_cache_miss_.value());
+  EXPECT_EQ(2, stats.fail_verify_san_.value());
+
+  // Caching another chain evicts the least recently used entry.
+  EXPECT_EQ(1, verify(other_cert.get(), nullptr));
+  EXPECT_EQ(1, verify(cert.get(), nullptr));
+  EXPECT_EQ(1, stats.cert_verification_cache_hit_.value());
+  EXPECT_EQ(5, stats.cert_verification_cache_miss_.value());
+  EXPECT_EQ(1, verify(cert.get(), nullptr));
+  EXPECT_EQ(2, stats.cert_verification_cache_hit_.value());
+
+  // Entries expire with the certificate.
+  time_system.setSystemTime(Utility::getExpirationTime(*cert));
+  EXPECT_EQ(1, verify(cert.get(), nullptr));
+  EXPECT_EQ(2, stats.cert_verification_cache_hit_.value());
+  EXPECT_EQ(6, stats.cert_verification_cache_miss_.value());
+}
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -74,6 +74,8 @@ public:
     return custom_validator_config_;
   }
 
+  uint32_t verificationCacheSize() const override { return 0; }
+
   Api::Api& api() const override { return *api_; }
 
 private:
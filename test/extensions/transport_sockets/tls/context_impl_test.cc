@@ -882,6 +882,63 @@ session_ticket_keys:
   ASSERT_EQ(server_context_config.sessionTicketKeys().size(), 2);
 }
 
+// Validate that the session ticket keys rotated out of a key ring are accepted for decryption
+// until their grace period ends.
+TEST(SessionTicketKeyRingImplTest, GracePeriod) {
+  Event::SimulatedTimeSystem time_system;
+  SessionTicketKeyRingImpl key_ring(time_system, std::chrono::seconds(10));
+  Ssl::ServerContextConfig::SessionTicketKey key_a{};
+  key_a.name_.fill('a');
+  Ssl::ServerContextConfig::SessionTicketKey key_b{};
+  key_b.name_.fill('b');
+  Ssl::ServerContextConfig::SessionTicketKey key_c{};
+  key_c.name_.fill('c');
+
+  key_ring.update({key_a});
+  key_ring.update({key_b, key_a});
+  const auto keys = key_ring.keys();
+  ASSERT_EQ(2, keys->keys_.size());
+  EXPECT_EQ(key_b.name_, keys->keys_[0].name_);
+  EXPECT_TRUE(keys->retired_keys_.empty());
+
+  time_system.advanceTimeWait(std::chrono::seconds(5));
+  key_ring.update({key_c});
+  const auto rotated_keys = key_ring.keys();
+  ASSERT_EQ(1, rotated_keys->keys_.size());
+  EXPECT_EQ(key_c.name_, rotated_keys->keys_[0].name_);
+  ASSERT_EQ(2, rotated_keys->retired_keys_.size());
+  EXPECT_EQ(key_b.name_, rotated_keys->retired_keys_[0].first.name_);
+  EXPECT_EQ(key_a.name_, rotated_keys->retired_keys_[1].first.name_);
+  EXPECT_EQ(time_system.monotonicTime() + std::chrono::seconds(10),
+            rotated_keys->retired_keys_[0].second);
+  // Keys obtained before the rotation don't change.
+  EXPECT_EQ(2, keys->keys_.size());
+
+  // Keys that are current again are no longer retired, and expired keys are dropped.
+  key_ring.update({key_c, key_b});
+  EXPECT_EQ(1, key_ring.keys()->retired_keys_.size());
+  time_system.advanceTimeWait(std::chrono::seconds(11));
+  key_ring.update({key_c});
+  ASSERT_EQ(1, key_ring.keys()->retired_keys_.size());
+  EXPECT_EQ(key_b.name_, key_ring.keys()->retired_keys_[0].first.name_);
+}
+
+// Validate that rotated session ticket keys are dropped right away without a grace period.
+TEST(SessionTicketKeyRingImplTest, NoGracePeriod) {
+  Event::SimulatedTimeSystem time_system;
+  SessionTicketKeyRingImpl key_ring(time_system, std::chrono::milliseconds(0));
+  Ssl::ServerContextConfig::SessionTicketKey key_a{};
+  key_a.name_.fill('a');
+  Ssl::ServerContextConfig::SessionTicketKey key_b{};
+  key_b.name_.fill('b');
+
+  key_ring.update({key_a});
+  key_ring.update({key_b});
+  ASSERT_EQ(1, key_ring.keys()->keys_.size());
+  EXPECT_EQ(key_b.name_, key_ring.keys()->keys_[0].name_);
+  EXPECT_TRUE(key_ring.keys()->retired_keys_.empty());
+}
+
 TEST_F(SslServerContextImplTicketTest, CRLSuccess) {
   const std::string yaml = R"EOF(
   common_tls_context:
@@ -0,0 +1,82 @@
+#include "extensions/transport_sockets/tls/ocsp/ocsp_fetcher.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/extensions/transport_sockets/tls/ssl_test_utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace Ocsp {
+
+namespace {
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+std::string fullPath(std::string filename) {
+  return TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/ocsp/test_data/" + filename);
+}
+
+TEST(OcspRequestTest, MatchesOpensslRequest) {
+  auto cert = readCertFromFile(fullPath("good_cert.pem"));
+  auto issuer = readCertFromFile(fullPath("ca_cert.pem"));
+  // The request was generated by `openssl ocsp`, which also adds a nonce extension that the
+  // built request doesn't have, so only the request list is compared.
+  const std::string openssl_request =
+      TestEnvironment::readFileToStringForTest(fullPath("good_ocsp_req.der"));
+  const std::string request_list = openssl_request.substr(4, 65);
+  EXPECT_EQ(std::string("\x30\x43\x30\x41", 4) + request_list, buildOcspRequest(*cert, *issuer));
+}
+
+TEST(OcspResponseSlotTest, SetResponse) {
+  OcspResponseSlotImpl slot;
+  EXPECT_EQ(nullptr, slot.response());
+
+  auto response = std::make_shared<Ssl::FetchedOcspResponse>();
+  response->der_ = {1, 2, 3};
+  slot.setResponse(response);
+  EXPECT_EQ(response, slot.response());
+}
+
+class OcspFetcherTest : public testing::Test {
+public:
+  OcspFetcherTest() {
+    ON_CALL(factory_context_, scope()).WillByDefault(ReturnRef(store_));
+    ON_CALL(factory_context_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+    config_.set_cluster("ocsp");
+    fetcher_ = std::make_unique<OcspFetcherImpl>(config_, factory_context_);
+  }
+
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  Stats::TestUtil::TestStore store_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext::OcspFetch config_;
+  std::unique_ptr<OcspFetcherImpl> fetcher_;
+};
+
+TEST_F(OcspFetcherTest, NoIssuer) {
+  auto cert = readCertFromFile(fullPath("good_cert.pem"));
+  EXPECT_EQ(nullptr, fetcher_->fetch(*cert, nullptr));
+}
+
+TEST_F(OcspFetcherTest, NoResponderUrl) {
+  auto cert = readCertFromFile(fullPath("good_cert.pem"));
+  auto issuer = readCertFromFile(fullPath("ca_cert.pem"));
+  EXPECT_EQ(nullptr, fetcher_->fetch(*cert, issuer.get()));
+}
+
+} // namespace
+
+} // namespace Ocsp
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,250 @@
+#include <string>
+#include <vector>
+
+#include "envoy/extensions/transport_sockets/tls/v3/tls_batched_private_key_provider_config.pb.h"
+
+#include "extensions/transport_sockets/tls/private_key/batched/batched_private_key_provider.h"
+#include "extensions/transport_sockets/tls/private_key/batched/config.h"
+
+#include "test/common/stats/stat_test_utility.h"
+#include "test/mocks/server/transport_socket_factory_context.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Extensions {
+namespace PrivateKeyMethodProvider {
+namespace Batched {
+namespace {
+
+// Exits the dispatcher loop when an operation completes, so that tests can wait for it.
+class TestCallbacks : public Ssl::PrivateKeyConnectionCallbacks {
+public:
+  explicit TestCallbacks(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  // Ssl::PrivateKeyConnectionCallbacks
+  void onPrivateKeyMethodComplete() override {
+    ++completions_;
+    dispatcher_.exit();
+  }
+
+  uint32_t completions_{};
+
+private:
+  Event::Dispatcher& dispatcher_;
+};
+
+class BatchedPrivateKeyProviderTest : public testing::Test {
+protected:
+  BatchedPrivateKeyProviderTest()
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher("test_thread")),
+        callbacks_(*dispatcher_), ssl_ctx_(SSL_CTX_new(TLS_method())),
+        ssl_(SSL_new(ssl_ctx_.get())) {
+    ON_CALL(factory_context_, api()).WillByDefault(ReturnRef(*api_));
+    ON_CALL(factory_context_, scope()).WillByDefault(ReturnRef(store_));
+  }
+
+  Ssl::PrivateKeyMethodProviderSharedPtr createProvider(const std::string& key_file) {
+    envoy::extensions::transport_sockets::tls::v3::BatchedPrivateKeyProviderConfig config;
+    config.mutable_private_key()->set_filename(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key_file));
+    config.mutable_max_batch_size()->set_value(4);
+    envoy::extensions::transport_sockets::tls::v3::PrivateKeyProvider provider_config;
+    provider_config.set_provider_name("envoy.tls.key_providers.batched");
+    provider_config.mutable_typed_config()->PackFrom(config);
+    return factory_.createPrivateKeyMethodProviderInstance(provider_config, factory_context_);
+  }
+
+  bssl::UniquePtr<EVP_PKEY> readKey(const std::string& key_file) {
+    const std::string key = TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + key_file));
+    bssl::UniquePtr<BIO> bio(BIO_new_mem_buf(key.data(), key.size()));
+    return bssl::UniquePtr<EVP_PKEY>(PEM_read_bio_PrivateKey(bio.get(), nullptr, nullptr, nullptr));
+  }
+
+  // Signs the input through the provider and waits for the signature.
+  ssl_private_key_result_t sign(Ssl::PrivateKeyMethodProvider& provider,
+                                uint16_t signature_algorithm, const std::string& in,
+                                std::vector<uint8_t>& out) {
+    auto method = provider.getBoringSslPrivateKeyMethod();
+    out.resize(1024);
+    size_t out_len = 0;
+    const auto* in_data = reinterpret_cast<const uint8_t*>(in.data());
+    ssl_private_key_result_t result = method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                   signature_algorithm, in_data, in.size());
+    if (result != ssl_private_key_retry) {
+      return result;
+    }
+    EXPECT_EQ(ssl_private_key_retry,
+              method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    result = method->complete(ssl_.get(), out.data(), &out_len, out.size());
+    out.resize(out_len);
+    return result;
+  }
+
+  bool verify(EVP_PKEY* pkey, uint16_t signature_algorithm, const std::string& in,
+              const std::vector<uint8_t>& signature) {
+    bssl::ScopedEVP_MD_CTX ctx;
+    EVP_PKEY_CTX* pkey_ctx;
+    if (!EVP_DigestVerifyInit(ctx.get(), &pkey_ctx,
+                              SSL_get_signature_algorithm_digest(signature_algorithm), nullptr,
+                              pkey)) {
+      return false;
+    }
+    if (SSL_is_signature_algorithm_rsa_pss(signature_algorithm) &&
+        (!EVP_PKEY_CTX_set_rsa_padding(pkey_ctx, RSA_PKCS1_PSS_PADDING) ||
+         !EVP_PKEY_CTX_set_rsa_pss_saltlen(pkey_ctx, -1))) {
+      return false;
+    }
+    return EVP_DigestVerify(ctx.get(), signature.data(), signature.size(),
+                            reinterpret_cast<const uint8_t*>(in.data()), in.size());
+  }
+
+  Stats::TestUtil::TestStore store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  TestCallbacks callbacks_;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context_;
+  BatchedPrivateKeyMethodFactory factory_;
+  bssl::UniquePtr<SSL_CTX> ssl_ctx_;
+  bssl::UniquePtr<SSL> ssl_;
+};
+
+TEST_F(BatchedPrivateKeyProviderTest, RsaSign) {
+  auto provider = createProvider("unittest_key.pem");
+  bssl::UniquePtr<EVP_PKEY> pkey = readKey("unittest_key.pem");
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  std::vector<uint8_t> signature;
+  for (uint16_t signature_algorithm : {SSL_SIGN_RSA_PKCS1_SHA256, SSL_SIGN_RSA_PSS_RSAE_SHA256}) {
+    EXPECT_EQ(ssl_private_key_success, sign(*provider, signature_algorithm, "hello", signature));
+    EXPECT_TRUE(verify(pkey.get(), signature_algorithm, "hello", signature));
+  }
+  EXPECT_EQ(2U, callbacks_.completions_);
+  EXPECT_EQ(2, store_.counter("private_key_provider.batched.operations").value());
+  EXPECT_EQ(0, store_.counter("private_key_provider.batched.failures").value());
+  EXPECT_EQ(2, store_.counter("private_key_provider.batched.batches").value());
+  EXPECT_EQ(0, store_.gauge("private_key_provider.batched.queue_size",
+                            Stats::Gauge::ImportMode::Accumulate)
+                   .value());
+
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(BatchedPrivateKeyProviderTest, RsaDecrypt) {
+  auto provider = createProvider("unittest_key.pem");
+  bssl::UniquePtr<EVP_PKEY> pkey = readKey("unittest_key.pem");
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  RSA* rsa = EVP_PKEY_get0_RSA(pkey.get());
+  std::vector<uint8_t> plaintext(RSA_size(rsa), 'a');
+  std::vector<uint8_t> ciphertext(RSA_size(rsa));
+  size_t ciphertext_len;
+  ASSERT_TRUE(RSA_encrypt(rsa, &ciphertext_len, ciphertext.data(), ciphertext.size(),
+                          plaintext.data(), plaintext.size(), RSA_NO_PADDING));
+
+  auto method = provider->getBoringSslPrivateKeyMethod();
+  std::vector<uint8_t> out(RSA_size(rsa));
+  size_t out_len = 0;
+  EXPECT_EQ(ssl_private_key_retry, method->decrypt(ssl_.get(), out.data(), &out_len, out.size(),
+                                                   ciphertext.data(), ciphertext_len));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(ssl_private_key_success,
+            method->complete(ssl_.get(), out.data(), &out_len, out.size()));
+  out.resize(out_len);
+  EXPECT_EQ(plaintext, out);
+
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+// An RSA and an ECDSA provider can be registered for the same connection, as they are for a
+// context with both an RSA and an ECDSA certificate.
+TEST_F(BatchedPrivateKeyProviderTest, RsaAndEcdsaSign) {
+  auto rsa_provider = createProvider("unittest_key.pem");
+  auto ecdsa_provider = createProvider("selfsigned_ecdsa_p256_key.pem");
+  bssl::UniquePtr<EVP_PKEY> ecdsa_pkey = readKey("selfsigned_ecdsa_p256_key.pem");
+  rsa_provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  ecdsa_provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+
+  std::vector<uint8_t> signature;
+  EXPECT_EQ(ssl_private_key_success,
+            sign(*ecdsa_provider, SSL_SIGN_ECDSA_SECP256R1_SHA256, "hello", signature));
+  EXPECT_TRUE(verify(ecdsa_pkey.get(), SSL_SIGN_ECDSA_SECP256R1_SHA256, "hello", signature));
+
+  EXPECT_THROW_WITH_MESSAGE(
+      createProvider("unittest_key.pem")
+          ->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_),
+      EnvoyException,
+      "Can't register two batched private key providers with the same key type for the same SSL "
+      "object.");
+
+  rsa_provider->unregisterPrivateKeyMethod(ssl_.get());
+  ecdsa_provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(BatchedPrivateKeyProviderTest, Failures) {
+  auto provider = createProvider("unittest_key.pem");
+  auto method = provider->getBoringSslPrivateKeyMethod();
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  const uint8_t in[] = {1, 2, 3};
+
+  // Not registered.
+  EXPECT_EQ(ssl_private_key_failure, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                  SSL_SIGN_RSA_PKCS1_SHA256, in, sizeof(in)));
+  EXPECT_EQ(ssl_private_key_failure, method->complete(ssl_.get(), out.data(), &out_len, 1024));
+
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  // No provider for the key type of the algorithm.
+  EXPECT_EQ(ssl_private_key_failure,
+            method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                         SSL_SIGN_ECDSA_SECP256R1_SHA256, in, sizeof(in)));
+  // Only one operation at a time.
+  EXPECT_EQ(ssl_private_key_retry, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                SSL_SIGN_RSA_PKCS1_SHA256, in, sizeof(in)));
+  EXPECT_EQ(ssl_private_key_failure, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                  SSL_SIGN_RSA_PKCS1_SHA256, in, sizeof(in)));
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  // The signature doesn't fit.
+  EXPECT_EQ(ssl_private_key_failure, method->complete(ssl_.get(), out.data(), &out_len, 16));
+
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+}
+
+TEST_F(BatchedPrivateKeyProviderTest, UnregisterCancelsOperation) {
+  auto provider = createProvider("unittest_key.pem");
+  auto method = provider->getBoringSslPrivateKeyMethod();
+  provider->registerPrivateKeyMethod(ssl_.get(), callbacks_, *dispatcher_);
+  std::vector<uint8_t> out(1024);
+  size_t out_len = 0;
+  const uint8_t in[] = {1, 2, 3};
+  EXPECT_EQ(ssl_private_key_retry, method->sign(ssl_.get(), out.data(), &out_len, out.size(),
+                                                SSL_SIGN_RSA_PKCS1_SHA256, in, sizeof(in)));
+  provider->unregisterPrivateKeyMethod(ssl_.get());
+
+  // Destroying the provider waits for the signing threads, so the operation has been executed,
+  // and its completion, if it was posted, is run here.
+  provider.reset();
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(0U, callbacks_.completions_);
+}
+
+TEST_F(BatchedPrivateKeyProviderTest, BadKey) {
+  EXPECT_THROW_WITH_MESSAGE(
+      createProvider("unittest_cert.pem"), EnvoyException,
+      "Failed to load the private key of the batched private key provider.");
+}
+
+} // namespace
+} // namespace Batched
+} // namespace PrivateKeyMethodProvider
+} // namespace Extensions
+} // namespace Envoy
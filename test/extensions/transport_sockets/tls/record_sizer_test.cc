@@ -0,0 +1,132 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/transport_sockets/tls/record_sizer.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Writes the records picked by the sizer until buffer is empty, and returns their sizes.
+std::vector<uint64_t> writeRecords(RecordSizer& sizer, Buffer::Instance& buffer) {
+  std::vector<uint64_t> sizes;
+  while (buffer.length() > 0) {
+    const uint64_t size = sizer.nextRecordSize(buffer);
+    buffer.drain(size);
+    sizer.onRecordWritten(size);
+    sizes.push_back(size);
+  }
+  return sizes;
+}
+
+// Writes enough to the sizer for all its following records to be full sized.
+void boost(RecordSizer& sizer, const Ssl::RecordSizing& sizing) {
+  Buffer::OwnedImpl buffer(std::string(sizing.boost_threshold_, 'a'));
+  writeRecords(sizer, buffer);
+}
+
+TEST(RecordSizerTest, RecordsGrowUntilBoostThreshold) {
+  const Ssl::RecordSizing sizing;
+  RecordSizer sizer(sizing);
+  Buffer::OwnedImpl buffer(std::string(sizing.boost_threshold_ + 2 * 16384, 'a'));
+  buffer.linearize(buffer.length());
+
+  const std::vector<uint64_t> sizes = writeRecords(sizer, buffer);
+  ASSERT_GE(sizes.size(), 3U);
+  EXPECT_EQ(sizing.initial_record_size_, sizes[0]);
+  EXPECT_EQ(2 * sizing.initial_record_size_, sizes[1]);
+  EXPECT_EQ(3 * sizing.initial_record_size_, sizes[2]);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizes[sizes.size() - 2]);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizes[sizes.size() - 3]);
+}
+
+TEST(RecordSizerTest, FullSizedRecords) {
+  Ssl::RecordSizing sizing;
+  sizing.initial_record_size_ = RecordSizer::MaxRecordSize;
+  RecordSizer sizer(sizing);
+  Buffer::OwnedImpl buffer(std::string(2 * RecordSizer::MaxRecordSize, 'a'));
+  buffer.linearize(buffer.length());
+  EXPECT_EQ(std::vector<uint64_t>({RecordSizer::MaxRecordSize, RecordSizer::MaxRecordSize}),
+            writeRecords(sizer, buffer));
+}
+
+TEST(RecordSizerTest, ShortBuffer) {
+  RecordSizer sizer{Ssl::RecordSizing{}};
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_EQ(5UL, sizer.nextRecordSize(buffer));
+}
+
+TEST(RecordSizerTest, RecordsEndAtLargeFrontSlice) {
+  const Ssl::RecordSizing sizing;
+  RecordSizer sizer(sizing);
+  boost(sizer, sizing);
+
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(std::string(RecordSizer::MinSliceRecordSize, 'a'));
+  buffer.appendSliceForTest(std::string(16384, 'b'));
+  // The front slice is large enough to be encrypted in place.
+  EXPECT_EQ(RecordSizer::MinSliceRecordSize, sizer.nextRecordSize(buffer));
+  buffer.drain(RecordSizer::MinSliceRecordSize);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer.nextRecordSize(buffer));
+}
+
+TEST(RecordSizerTest, SmallFrontSliceIsLinearized) {
+  const Ssl::RecordSizing sizing;
+  RecordSizer sizer(sizing);
+  boost(sizer, sizing);
+
+  Buffer::OwnedImpl buffer;
+  buffer.appendSliceForTest(std::string(RecordSizer::MinSliceRecordSize - 1, 'a'));
+  buffer.appendSliceForTest(std::string(16384, 'b'));
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer.nextRecordSize(buffer));
+}
+
+TEST(RecordSizerTest, RecordsShrinkAfterIdleTimeout) {
+  Event::SimulatedTimeSystem time_system;
+  Ssl::RecordSizing sizing;
+  sizing.idle_timeout_ = std::chrono::seconds(1);
+  RecordSizer sizer(sizing);
+  Buffer::OwnedImpl buffer(std::string(RecordSizer::MaxRecordSize, 'a'));
+  buffer.linearize(buffer.length());
+
+  sizer.onWrite(time_system);
+  boost(sizer, sizing);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer.nextRecordSize(buffer));
+
+  time_system.advanceTimeWait(std::chrono::milliseconds(999));
+  sizer.onWrite(time_system);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer.nextRecordSize(buffer));
+
+  time_system.advanceTimeWait(std::chrono::seconds(1));
+  sizer.onWrite(time_system);
+  EXPECT_EQ(sizing.initial_record_size_, sizer.nextRecordSize(buffer));
+}
+
+TEST(RecordSizerTest, RecordsNeverShrinkWithoutIdleTimeout) {
+  Event::SimulatedTimeSystem time_system;
+  const Ssl::RecordSizing sizing;
+  RecordSizer sizer(sizing);
+  Buffer::OwnedImpl buffer(std::string(RecordSizer::MaxRecordSize, 'a'));
+  buffer.linearize(buffer.length());
+
+  sizer.onWrite(time_system);
+  boost(sizer, sizing);
+  time_system.advanceTimeWait(std::chrono::hours(1));
+  sizer.onWrite(time_system);
+  EXPECT_EQ(RecordSizer::MaxRecordSize, sizer.nextRecordSize(buffer));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -6,6 +6,7 @@
 #include "envoy/config/listener/v3/listener_components.pb.h"
 #include "envoy/extensions/transport_sockets/tls/v3/cert.pb.h"
 #include "envoy/network/transport_socket.h"
+#include "envoy/ssl/session_cache.h"
 
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
@@ -49,6 +50,7 @@
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_replace.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -287,6 +289,7 @@ void testUtil(const TestUtilOptions& options) {
   testing::NiceMock<Server::Configuration::MockTransportSocketFactoryContext>
       server_factory_context;
   ON_CALL(server_factory_context, api()).WillByDefault(ReturnRef(*server_api));
+  ON_CALL(server_factory_context, scope()).WillByDefault(ReturnRef(server_stats_store));
 
   // For private key method testing.
   NiceMock<Ssl::MockContextManager> context_manager;
@@ -862,6 +865,57 @@ TEST_P(SslSocketTest, GetCertDigest) {
                .setExpectedSerialNumber(TEST_NO_SAN_CERT_SERIAL));
 }
 
+TEST_P(SslSocketTest, HandshakeOffload) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+    validation_context:
+      trusted_ca:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ca_cert.pem"
+  handshake_offload:
+    thread_count: 2
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options.setExpectedSha256Digest(TEST_NO_SAN_CERT_256_HASH));
+}
+
+// TLS 1.3 connections keep being encrypted in userspace when kernel TLS is enabled.
+TEST_P(SslSocketTest, KernelTlsTxUnsupportedProtocolVersion) {
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+      tls_maximum_protocol_version: TLSv1_3
+)EOF";
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/no_san_key.pem"
+  enable_kernel_tls_tx: true
+)EOF";
+
+  TestUtilOptions test_options(client_ctx_yaml, server_ctx_yaml, true, GetParam());
+  testUtil(test_options.setExpectedServerStats("ssl.kernel_tls_tx_unsupported"));
+}
+
 TEST_P(SslSocketTest, GetCertDigestInvalidFiles) {
   const std::string client_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3381,6 +3435,105 @@ TEST_P(SslSocketTest, StatelessSessionResumptionEnabledByDefault) {
   testSupportForStatelessSessionResumption(server_ctx_yaml, client_ctx_yaml, true, GetParam());
 }
 
+namespace {
+
+class TestSessionCacheLookup : public Ssl::SessionCacheLookup {
+public:
+  // Ssl::SessionCacheLookup
+  void cancel() override { *cancelled_ = true; }
+
+  const std::shared_ptr<bool> cancelled_{std::make_shared<bool>(false)};
+};
+
+// An in-memory session cache, which completes lookups inline, or on the next dispatcher iteration
+// if async_ is set.
+class TestSessionCache : public Ssl::SessionCache {
+public:
+  // Ssl::SessionCache
+  void insert(absl::string_view session_id, std::string&& session, std::chrono::seconds) override {
+    sessions_[std::string(session_id)] = std::move(session);
+  }
+  Ssl::SessionCacheLookupPtr lookup(absl::string_view session_id, Event::Dispatcher& dispatcher,
+                                    Ssl::SessionCacheLookupCb callback) override {
+    ++lookups_;
+    absl::optional<std::string> session;
+    auto it = sessions_.find(std::string(session_id));
+    if (it != sessions_.end()) {
+      session = it->second;
+    }
+    if (!async_) {
+      callback(std::move(session));
+      return nullptr;
+    }
+    auto lookup = std::make_unique<TestSessionCacheLookup>();
+    dispatcher.post([cancelled = lookup->cancelled_, callback, session]() mutable {
+      if (!*cancelled) {
+        callback(std::move(session));
+      }
+    });
+    return lookup;
+  }
+
+  bool async_{};
+  uint32_t lookups_{};
+  absl::flat_hash_map<std::string, std::string> sessions_;
+};
+
+class TestSessionCacheFactory : public Ssl::SessionCacheFactory {
+public:
+  // Ssl::SessionCacheFactory
+  Ssl::SessionCacheSharedPtr
+  createSessionCache(const Protobuf::Message&,
+                     Server::Configuration::TransportSocketFactoryContext&) override {
+    return cache_;
+  }
+  ProtobufTypes::MessagePtr createEmptyConfigProto() override {
+    return std::make_unique<ProtobufWkt::Struct>();
+  }
+  std::string name() const override { return "envoy.tls.session_caches.test"; }
+
+  const std::shared_ptr<TestSessionCache> cache_{std::make_shared<TestSessionCache>()};
+};
+
+// Test that a session established with one listener is resumed by its session ID on another
+// listener, which doesn't have it in its in-memory session cache, via the external session cache.
+void testSessionCacheResumption(bool async, const Network::Address::IpVersion ip_version) {
+  TestSessionCacheFactory factory;
+  Registry::InjectFactory<Ssl::SessionCacheFactory> registered_factory(factory);
+  factory.cache_->async_ = async;
+
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+  session_cache:
+    name: envoy.tls.session_caches.test
+    typed_config:
+      "@type": type.googleapis.com/google.protobuf.Struct
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+)EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              ip_version);
+  EXPECT_EQ(1, factory.cache_->sessions_.size());
+  EXPECT_EQ(1, factory.cache_->lookups_);
+}
+
+} // namespace
+
+TEST_P(SslSocketTest, SessionCacheResumption) { testSessionCacheResumption(false, GetParam()); }
+
+TEST_P(SslSocketTest, SessionCacheResumptionAsync) { testSessionCacheResumption(true, GetParam()); }
+
 // Test that if two listeners use the same cert and session ticket key, but
 // different client CA, that sessions cannot be resumed.
 TEST_P(SslSocketTest, ClientAuthCrossListenerSessionResumption) {
@@ -0,0 +1,83 @@
+#include <string>
+
+#include "envoy/common/exception.h"
+
+#include "extensions/transport_sockets/tls/tls_material_cache.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+std::string readTestData(const std::string& name) {
+  return TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+      "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + name));
+}
+
+// The same certificate chain is only parsed once while it's in use.
+TEST(TlsMaterialCacheTest, CertificateChainShared) {
+  TlsMaterialCache cache;
+  const std::string pem = readTestData("san_dns_cert.pem") + readTestData("ca_cert.pem");
+  auto chain = cache.certificateChain(pem);
+  ASSERT_NE(nullptr, chain);
+  EXPECT_NE(nullptr, chain->leaf_);
+  EXPECT_EQ(1, chain->intermediates_.size());
+  EXPECT_EQ(chain, cache.certificateChain(pem));
+  EXPECT_NE(chain, cache.certificateChain(readTestData("san_dns_cert.pem")));
+
+  // Once released, the chain is parsed again.
+  chain.reset();
+  auto reparsed = cache.certificateChain(pem);
+  ASSERT_NE(nullptr, reparsed);
+  EXPECT_EQ(1, reparsed->intermediates_.size());
+}
+
+TEST(TlsMaterialCacheTest, InvalidCertificateChain) {
+  TlsMaterialCache cache;
+  EXPECT_EQ(nullptr, cache.certificateChain("invalid"));
+  const std::string pem = readTestData("san_dns_cert.pem");
+  EXPECT_EQ(nullptr, cache.certificateChain(pem.substr(0, pem.size() / 2)));
+}
+
+// The private keys are shared by their content and password.
+TEST(TlsMaterialCacheTest, PrivateKeyShared) {
+  TlsMaterialCache cache;
+  const std::string pem = readTestData("san_dns_key.pem");
+  auto key = cache.privateKey(pem, "");
+  ASSERT_NE(nullptr, key);
+  EXPECT_EQ(key, cache.privateKey(pem, ""));
+  EXPECT_EQ(nullptr, cache.privateKey("invalid", ""));
+
+  const std::string encrypted_pem = readTestData("password_protected_key.pem");
+  EXPECT_EQ(nullptr, cache.privateKey(encrypted_pem, "bad_password"));
+  EXPECT_NE(nullptr,
+            cache.privateKey(encrypted_pem, readTestData("password_protected_password.txt")));
+}
+
+TEST(TlsMaterialCacheTest, TrustStoreShared) {
+  TlsMaterialCache cache;
+  const std::string ca_pem = readTestData("ca_cert.pem");
+  auto store = cache.trustStore(ca_pem, "ca_cert.pem", "", "", nullptr);
+  ASSERT_NE(nullptr, store);
+  EXPECT_NE(nullptr, store->ca_cert_);
+  EXPECT_EQ(store, cache.trustStore(ca_pem, "ca_cert.pem", "", "", nullptr));
+  // The revocation lists are part of the store.
+  EXPECT_NE(store, cache.trustStore(ca_pem, "ca_cert.pem", readTestData("ca_cert.crl"),
+                                    "ca_cert.crl", nullptr));
+
+  EXPECT_THROW_WITH_MESSAGE(cache.trustStore("invalid", "invalid.pem", "", "", nullptr),
+                            EnvoyException,
+                            "Failed to load trusted CA certificates from invalid.pem");
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
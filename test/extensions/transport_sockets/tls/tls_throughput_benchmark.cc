@@ -1,5 +1,7 @@
 #include "common/buffer/buffer_impl.h"
 
+#include "extensions/transport_sockets/tls/record_sizer.h"
+
 #include "test/test_common/environment.h"
 
 #include "benchmark/benchmark.h"
@@ -113,7 +115,10 @@ static void testThroughput(benchmark::State& state) {
   unsigned num_short_slices = state.range(1);
   unsigned align_to_16kb = state.range(2);
   unsigned move_slices = state.range(3);
+  unsigned use_record_sizer = state.range(4);
 
+  // Shared by the iterations, so that only the first one writes the small initial records.
+  RecordSizer record_sizer{Ssl::RecordSizing{}};
   uint64_t bytes_written = 0;
   for (auto _ : state) {
     UNREFERENCED_PARAMETER(_);
@@ -152,7 +157,8 @@ static void testThroughput(benchmark::State& state) {
     while (write_buf.length() > 0) {
       const Buffer::RawSlice initial = write_buf.frontSlice();
       void* mem;
-      size_t len = std::min<uint64_t>(write_buf.length(), 16384);
+      size_t len = use_record_sizer ? record_sizer.nextRecordSize(write_buf)
+                                    : std::min<uint64_t>(write_buf.length(), 16384);
       mem = write_buf.linearize(len);
       if (write_buf.frontSlice() != initial) {
         ++num_times_linearize_did_something;
@@ -162,6 +168,7 @@ static void testThroughput(benchmark::State& state) {
       RELEASE_ASSERT(err == static_cast<int>(len),
                      absl::StrCat("SSL_write got: ", err, " expected: ", len));
       write_buf.drain(len);
+      record_sizer.onRecordWritten(len);
       num_writes++;
     }
 
@@ -175,15 +182,18 @@ static void testThroughput(benchmark::State& state) {
 }
 
 static void testParams(benchmark::internal::Benchmark* b) {
-  for (auto move_slices : {false, true}) {
-    for (auto align_to_16kb : {false, true}) {
-      // Add a single case of no short slices; don't iterate over the sizes
-      // which duplicates test cases when count is zero.
-      b->Args({0, 0, align_to_16kb, move_slices});
-
-      for (auto short_slice_size : {1, 128, 4095, 4096, 4097}) {
-        for (auto num_short_slices : {1, 2, 3}) {
-          b->Args({short_slice_size, num_short_slices, align_to_16kb, move_slices});
+  for (auto use_record_sizer : {false, true}) {
+    for (auto move_slices : {false, true}) {
+      for (auto align_to_16kb : {false, true}) {
+        // Add a single case of no short slices; don't iterate over the sizes
+        // which duplicates test cases when count is zero.
+        b->Args({0, 0, align_to_16kb, move_slices, use_record_sizer});
+
+        for (auto short_slice_size : {1, 128, 4095, 4096, 4097}) {
+          for (auto num_short_slices : {1, 2, 3}) {
+            b->Args(
+                {short_slice_size, num_short_slices, align_to_16kb, move_slices, use_record_sizer});
+          }
         }
       }
     }
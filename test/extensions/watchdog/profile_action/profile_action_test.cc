@@ -11,6 +11,7 @@
 #include "common/common/assert.h"
 #include "common/filesystem/directory.h"
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 
 #include "extensions/watchdog/profile_action/config.h"
 #include "extensions/watchdog/profile_action/profile_action.h"
@@ -421,6 +422,26 @@ TEST_F(ProfileActionTest, ShouldUpdateCountersCorrectly) {
   thread->join();
 }
 
+#ifdef SAMPLING_PROFILER_AVAILABLE
+// The recent samples of the sampling profiler are written at once instead of starting a profile.
+TEST_F(ProfileActionTest, WritesSamplingProfile) {
+  envoy::extensions::watchdog::profile_action::v3alpha::ProfileActionConfig config;
+  config.set_profile_path(test_path_);
+  action_ = std::make_unique<ProfileAction>(config, context_);
+
+  ASSERT_TRUE(Profiler::Sampling::startProfiler(19));
+  const auto now = api_->timeSource().monotonicTime();
+  action_->run(envoy::config::bootstrap::v3::Watchdog::WatchdogAction::MISS,
+               {{Thread::ThreadId(10), now}}, now);
+  Profiler::Sampling::stopProfiler();
+
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+  EXPECT_EQ(countNumberOfProfileInPath(test_path_), 1);
+  EXPECT_EQ(TestUtility::findCounter(stats_, "test.profile_action.successfully_captured")->value(),
+            1);
+}
+#endif
+
 } // namespace
 } // namespace ProfileAction
 } // namespace Watchdog
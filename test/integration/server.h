@@ -371,6 +371,8 @@ public:
   void setTagProducer(TagProducerPtr&&) override {}
   void setStatsMatcher(StatsMatcherPtr&&) override {}
   void setHistogramSettings(HistogramSettingsConstPtr&&) override {}
+  void setShardedCounters(std::vector<Matchers::StringMatcherPtr>&&) override {}
+  void setBucketedHistograms(std::vector<Matchers::StringMatcherPtr>&&) override {}
   void initializeThreading(Event::Dispatcher&, ThreadLocal::Instance&) override {}
   void shutdownThreading() override {}
   void mergeHistograms(PostMergeCb) override {}
@@ -47,6 +47,11 @@ public:
   Buffer::InstancePtr create(std::function<void()> below_low_watermark,
                              std::function<void()> above_high_watermark,
                              std::function<void()> above_overflow_watermark) override;
+  // The memory of the streams isn't tracked.
+  Buffer::BufferMemoryAccountSharedPtr createAccount(Http::StreamResetHandler&) override {
+    return nullptr;
+  }
+  uint64_t resetAccountsGivenPressure(float) override { return 0; }
 
   // Number of buffers created.
   uint64_t numBuffersCreated() const;
@@ -9,6 +9,7 @@
 #include "envoy/event/timer.h"
 
 #include "common/api/os_sys_calls_impl.h"
+#include "common/event/slow_callback_log_impl.h"
 
 #if defined(__linux__)
 #include "common/api/os_sys_calls_impl_linux.h"
@@ -37,6 +38,7 @@ public:
   Event::DispatcherPtr allocateDispatcher(const std::string& name,
                                           Buffer::WatermarkFactoryPtr&& watermark_factory) override;
   TimeSource& timeSource() override { return time_system_; }
+  Event::SlowCallbackLog& slowCallbackLog() override { return slow_callback_log_; }
 
   MOCK_METHOD(Event::Dispatcher*, allocateDispatcher_, (const std::string&, Event::TimeSystem&));
   MOCK_METHOD(Event::Dispatcher*, allocateDispatcher_,
@@ -53,6 +55,7 @@ public:
   Event::GlobalTimeSystem time_system_;
   testing::NiceMock<Stats::MockIsolatedStatsStore> stats_store_;
   testing::NiceMock<Random::MockRandomGenerator> random_;
+  Event::SlowCallbackLogImpl slow_callback_log_;
 };
 
 class MockOsSysCalls : public OsSysCallsImpl {
@@ -82,6 +85,8 @@ public:
   MOCK_METHOD(SysCallIntResult, recvmmsg,
               (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags,
                struct timespec* timeout));
+  MOCK_METHOD(SysCallIntResult, sendmmsg,
+              (os_fd_t socket, struct mmsghdr* msgvec, unsigned int vlen, int flags));
   MOCK_METHOD(SysCallIntResult, ftruncate, (int fd, off_t length));
   MOCK_METHOD(SysCallPtrResult, mmap,
               (void* addr, size_t length, int prot, int flags, int fd, off_t offset));
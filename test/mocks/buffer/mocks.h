@@ -84,6 +84,9 @@ public:
   MOCK_METHOD(Buffer::Instance*, create_,
               (std::function<void()> below_low, std::function<void()> above_high,
                std::function<void()> above_overflow));
+  MOCK_METHOD(Buffer::BufferMemoryAccountSharedPtr, createAccount,
+              (Http::StreamResetHandler & reset_handler), (override));
+  MOCK_METHOD(uint64_t, resetAccountsGivenPressure, (float pressure), (override));
 };
 
 MATCHER_P(BufferEqual, rhs, testing::PrintToString(*rhs)) {
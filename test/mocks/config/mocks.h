@@ -41,6 +41,11 @@ public:
   ~MockOpaqueResourceDecoder() override;
 
   MOCK_METHOD(ProtobufTypes::MessagePtr, decodeResource, (const ProtobufWkt::Any& resource));
+  MOCK_METHOD(ProtobufTypes::MessagePtr, parseResource,
+              (const ProtobufWkt::Any& resource, std::string& error));
+  MOCK_METHOD(void, checkResource,
+              (const ProtobufWkt::Any& resource, const Protobuf::Message& message,
+               const std::string& error));
   MOCK_METHOD(std::string, resourceName, (const Protobuf::Message& resource));
 };
 
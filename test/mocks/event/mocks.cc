@@ -28,6 +28,11 @@ MockDispatcher::MockDispatcher(const std::string& name) : name_(name) {
   ON_CALL(*this, createScaledTypedTimer_(_, _))
       .WillByDefault(ReturnNew<NiceMock<Event::MockTimer>>());
   ON_CALL(*this, post(_)).WillByDefault(Invoke([](PostCb cb) -> void { cb(); }));
+  ON_CALL(*this, postBatch(_)).WillByDefault(Invoke([](std::list<PostCb> callbacks) -> void {
+    for (auto& cb : callbacks) {
+      cb();
+    }
+  }));
 
   ON_CALL(buffer_factory_, create_(_, _, _))
       .WillByDefault(Invoke([](std::function<void()> below_low, std::function<void()> above_high,
@@ -85,6 +85,11 @@ public:
     return timer;
   }
 
+  // The wheel timers behave like the other timers, so the tests expect them from createTimer_().
+  Event::TimerPtr createWheelTimer(Event::TimerCb cb) override {
+    return createTimer(std::move(cb));
+  }
+
   Event::TimerPtr createScaledTimer(ScaledTimerMinimum minimum, Event::TimerCb cb) override {
     auto timer = Event::TimerPtr{createScaledTimer_(minimum, cb)};
     // Assert that the timer is not null to avoid confusing test failures down the line.
@@ -123,6 +128,7 @@ public:
   MOCK_METHOD(void, registerWatchdog,
               (const Server::WatchDogSharedPtr&, std::chrono::milliseconds));
   MOCK_METHOD(void, initializeStats, (Stats::Scope&, const absl::optional<std::string>&));
+  MOCK_METHOD(absl::optional<double>, loopUtilization, (), (const));
   MOCK_METHOD(void, clearDeferredDeleteList, ());
   MOCK_METHOD(Network::ServerConnection*, createServerConnection_, ());
   MOCK_METHOD(Network::ClientConnection*, createClientConnection_,
@@ -150,6 +156,7 @@ public:
   MOCK_METHOD(void, exit, ());
   MOCK_METHOD(SignalEvent*, listenForSignal_, (signal_t signal_num, SignalCb cb));
   MOCK_METHOD(void, post, (std::function<void()> callback));
+  MOCK_METHOD(void, postBatch, (std::list<std::function<void()>> callbacks));
   MOCK_METHOD(void, deleteInDispatcherThread, (DispatcherThreadDeletableConstPtr deletable));
   MOCK_METHOD(void, run, (RunType type));
   MOCK_METHOD(void, pushTrackedObject, (const ScopeTrackedObject* object));
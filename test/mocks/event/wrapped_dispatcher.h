@@ -31,6 +31,8 @@ public:
     impl_.initializeStats(scope, prefix);
   }
 
+  absl::optional<double> loopUtilization() const override { return impl_.loopUtilization(); }
+
   void clearDeferredDeleteList() override { impl_.clearDeferredDeleteList(); }
 
   Network::ServerConnectionPtr
@@ -78,6 +80,7 @@ public:
   }
 
   TimerPtr createTimer(TimerCb cb) override { return impl_.createTimer(std::move(cb)); }
+  TimerPtr createWheelTimer(TimerCb cb) override { return impl_.createWheelTimer(std::move(cb)); }
   TimerPtr createScaledTimer(ScaledTimerMinimum minimum, TimerCb cb) override {
     return impl_.createScaledTimer(minimum, std::move(cb));
   }
@@ -102,6 +105,10 @@ public:
 
   void post(std::function<void()> callback) override { impl_.post(std::move(callback)); }
 
+  void postBatch(std::list<std::function<void()>> callbacks) override {
+    impl_.postBatch(std::move(callbacks));
+  }
+
   void deleteInDispatcherThread(DispatcherThreadDeletableConstPtr deletable) override {
     impl_.deleteInDispatcherThread(std::move(deletable));
   }
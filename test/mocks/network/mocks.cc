@@ -208,7 +208,11 @@ MockUdpListenerReadFilter::~MockUdpListenerReadFilter() = default;
 MockUdpListenerFilterManager::MockUdpListenerFilterManager() = default;
 MockUdpListenerFilterManager::~MockUdpListenerFilterManager() = default;
 
-MockConnectionBalancer::MockConnectionBalancer() = default;
+MockConnectionBalancer::MockConnectionBalancer() {
+  ON_CALL(*this, pickQueuedTargetHandler(_))
+      .WillByDefault(Invoke([](BalancedConnectionHandler& current_handler)
+                                -> BalancedConnectionHandler& { return current_handler; }));
+}
 MockConnectionBalancer::~MockConnectionBalancer() = default;
 
 MockListenerFilterMatcher::MockListenerFilterMatcher() = default;
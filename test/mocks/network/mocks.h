@@ -86,6 +86,7 @@ public:
   MOCK_METHOD(FilterStatus, onData, (Buffer::Instance & data, bool end_stream));
   MOCK_METHOD(FilterStatus, onNewConnection, ());
   MOCK_METHOD(void, initializeReadFilterCallbacks, (ReadFilterCallbacks & callbacks));
+  MOCK_METHOD(bool, canHandOverConnection, (), (const));
 
   ReadFilterCallbacks* callbacks_{};
 };
@@ -441,6 +442,8 @@ public:
   MOCK_METHOD(void, enableListeners, ());
   MOCK_METHOD(void, setListenerRejectFraction, (UnitFloat), (override));
   MOCK_METHOD(const std::string&, statPrefix, (), (const));
+  MOCK_METHOD(std::vector<ConnectionSocketPtr>, handOverConnections, ());
+  MOCK_METHOD(void, adoptConnection, (ConnectionSocketPtr && socket));
 };
 
 class MockIp : public Address::Ip {
@@ -576,6 +579,8 @@ public:
   MOCK_METHOD(void, unregisterHandler, (BalancedConnectionHandler & handler));
   MOCK_METHOD(BalancedConnectionHandler&, pickTargetHandler,
               (BalancedConnectionHandler & current_handler));
+  MOCK_METHOD(BalancedConnectionHandler&, pickQueuedTargetHandler,
+              (BalancedConnectionHandler & current_handler));
 };
 
 class MockListenerFilterMatcher : public ListenerFilterMatcher {
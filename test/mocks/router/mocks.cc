@@ -62,6 +62,9 @@ MockRateLimitPolicy::~MockRateLimitPolicy() = default;
 MockShadowWriter::MockShadowWriter() = default;
 MockShadowWriter::~MockShadowWriter() = default;
 
+MockShadowStream::MockShadowStream() = default;
+MockShadowStream::~MockShadowStream() = default;
+
 MockVirtualHost::MockVirtualHost() {
   ON_CALL(*this, name()).WillByDefault(ReturnRef(name_));
   ON_CALL(*this, rateLimitPolicy()).WillByDefault(ReturnRef(rate_limit_policy_));
@@ -91,10 +91,12 @@ public:
     return additional_request_chance_;
   }
   bool hedgeOnPerTryTimeout() const override { return hedge_on_per_try_timeout_; }
+  LatencyHedging* latencyHedging() const override { return latency_hedging_; }
 
   uint32_t initial_requests_{};
   envoy::type::v3::FractionalPercent additional_request_chance_{};
   bool hedge_on_per_try_timeout_{};
+  LatencyHedging* latency_hedging_{};
 };
 
 class TestRetryPolicy : public RetryPolicy {
@@ -248,9 +250,28 @@ public:
     shadow_(cluster, request, options);
   }
 
+  ShadowStreamPtr streamingShadow(const std::string& cluster, Http::RequestHeaderMapPtr&& headers,
+                                  const Http::AsyncClient::RequestOptions& options,
+                                  bool end_stream) override {
+    return ShadowStreamPtr{streamingShadow_(cluster, headers, options, end_stream)};
+  }
+
   MOCK_METHOD(void, shadow_,
               (const std::string& cluster, Http::RequestMessagePtr& request,
                const Http::AsyncClient::RequestOptions& options));
+  MOCK_METHOD(ShadowStream*, streamingShadow_,
+              (const std::string& cluster, Http::RequestHeaderMapPtr& headers,
+               const Http::AsyncClient::RequestOptions& options, bool end_stream));
+};
+
+class MockShadowStream : public ShadowStream {
+public:
+  MockShadowStream();
+  ~MockShadowStream() override;
+
+  // Router::ShadowStream
+  MOCK_METHOD(void, sendData, (const Buffer::Instance& data, bool end_stream));
+  MOCK_METHOD(void, sendTrailers, (const Http::RequestTrailerMap& trailers));
 };
 
 class TestVirtualCluster : public VirtualCluster {
@@ -275,7 +296,7 @@ public:
   MOCK_METHOD(const std::string&, name, (), (const));
   MOCK_METHOD(const RateLimitPolicy&, rateLimitPolicy, (), (const));
   MOCK_METHOD(const CorsPolicy*, corsPolicy, (), (const));
-  MOCK_METHOD(const Config&, routeConfig, (), (const));
+  MOCK_METHOD(const CommonConfig&, routeConfig, (), (const));
   MOCK_METHOD(const RouteSpecificFilterConfig*, perFilterConfig, (const std::string&), (const));
   MOCK_METHOD(bool, includeAttemptCountInRequest, (), (const));
   MOCK_METHOD(bool, includeAttemptCountInResponse, (), (const));
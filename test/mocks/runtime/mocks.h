@@ -35,6 +35,7 @@ public:
   MOCK_METHOD(bool, deprecatedFeatureEnabled, (absl::string_view key, bool default_enabled),
               (const));
   MOCK_METHOD(bool, runtimeFeatureEnabled, (absl::string_view key), (const));
+  MOCK_METHOD(bool, runtimeFeatureEnabled, (uint32_t feature_index), (const));
   MOCK_METHOD(bool, featureEnabled, (absl::string_view key, uint64_t default_value), (const));
   MOCK_METHOD(bool, featureEnabled,
               (absl::string_view key, uint64_t default_value, uint64_t random_value), (const));
@@ -8,7 +8,18 @@
 namespace Envoy {
 namespace Server {
 
-MockListenerManager::MockListenerManager() = default;
+using ::testing::_;
+using ::testing::Invoke;
+
+MockListenerManager::MockListenerManager() {
+  // The listeners added with their hash are expected like the other ones by default.
+  ON_CALL(*this, addOrUpdateListener(_, _, _, _))
+      .WillByDefault(Invoke([this](const envoy::config::listener::v3::Listener& config,
+                                   const std::string& version_info, bool modifiable,
+                                   uint64_t) -> bool {
+        return addOrUpdateListener(config, version_info, modifiable);
+      }));
+}
 
 MockListenerManager::~MockListenerManager() = default;
 
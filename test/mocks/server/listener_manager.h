@@ -14,6 +14,9 @@ public:
   MOCK_METHOD(bool, addOrUpdateListener,
               (const envoy::config::listener::v3::Listener& config, const std::string& version_info,
                bool modifiable));
+  MOCK_METHOD(bool, addOrUpdateListener,
+              (const envoy::config::listener::v3::Listener& config, const std::string& version_info,
+               bool modifiable, uint64_t config_hash));
   MOCK_METHOD(void, createLdsApi,
               (const envoy::config::core::v3::ConfigSource& lds_config,
                const xds::core::v3::ResourceLocator*));
@@ -24,6 +27,8 @@ public:
   MOCK_METHOD(void, startWorkers, (GuardDog & guard_dog, std::function<void()> callback));
   MOCK_METHOD(void, stopListeners, (StopListenersType listeners_type));
   MOCK_METHOD(void, stopWorkers, ());
+  MOCK_METHOD(void, handOverConnections, (HandOverConnectionsCallback callback));
+  MOCK_METHOD(void, adoptConnection, (Network::ConnectionSocketPtr && socket));
   MOCK_METHOD(void, beginListenerUpdate, ());
   MOCK_METHOD(void, endListenerUpdate, (ListenerManager::FailureStates &&));
   MOCK_METHOD(ApiListenerOptRef, apiListener, ());
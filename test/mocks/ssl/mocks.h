@@ -94,6 +94,7 @@ public:
   MOCK_METHOD(Ssl::HandshakerFactoryCb, createHandshaker, (), (const, override));
   MOCK_METHOD(Ssl::HandshakerCapabilities, capabilities, (), (const, override));
   MOCK_METHOD(Ssl::SslCtxCb, sslctxCb, (), (const, override));
+  MOCK_METHOD(RecordSizing, recordSizing, (), (const));
 
   MOCK_METHOD(const std::string&, serverNameIndication, (), (const));
   MOCK_METHOD(bool, allowRenegotiation, (), (const));
@@ -127,11 +128,17 @@ public:
   MOCK_METHOD(Ssl::HandshakerFactoryCb, createHandshaker, (), (const, override));
   MOCK_METHOD(Ssl::HandshakerCapabilities, capabilities, (), (const, override));
   MOCK_METHOD(Ssl::SslCtxCb, sslctxCb, (), (const, override));
+  MOCK_METHOD(RecordSizing, recordSizing, (), (const));
 
   MOCK_METHOD(bool, requireClientCertificate, (), (const));
   MOCK_METHOD(OcspStaplePolicy, ocspStaplePolicy, (), (const));
   MOCK_METHOD(const std::vector<SessionTicketKey>&, sessionTicketKeys, (), (const));
+  MOCK_METHOD(SessionTicketKeyRingSharedPtr, sessionTicketKeyRing, (), (const));
   MOCK_METHOD(bool, disableStatelessSessionResumption, (), (const));
+  MOCK_METHOD(SessionCacheSharedPtr, sessionCache, (), (const));
+  MOCK_METHOD(HandshakeOffloadPoolSharedPtr, handshakeOffloadPool, (), (const));
+  MOCK_METHOD(bool, enableKernelTlsTx, (), (const));
+  MOCK_METHOD(OcspFetcherSharedPtr, ocspFetcher, (), (const));
 };
 
 class MockTlsCertificateConfig : public TlsCertificateConfig {
@@ -164,6 +171,7 @@ public:
   MOCK_METHOD(bool, allowExpiredCertificate, (), (const));
   MOCK_METHOD(const absl::optional<envoy::config::core::v3::TypedExtensionConfig>&,
               customValidatorConfig, (), (const));
+  MOCK_METHOD(uint32_t, verificationCacheSize, (), (const));
   MOCK_METHOD(Api::Api&, api, (), (const));
   MOCK_METHOD(envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
                   TrustChainVerification,
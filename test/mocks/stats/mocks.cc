@@ -72,6 +72,7 @@ MockSink::~MockSink() = default;
 
 MockStore::MockStore() {
   ON_CALL(*this, counter(_)).WillByDefault(ReturnRef(counter_));
+  ON_CALL(*this, gauge(_, _)).WillByDefault(ReturnRef(gauge_));
   ON_CALL(*this, histogram(_, _))
       .WillByDefault(Invoke([this](const std::string& name, Histogram::Unit unit) -> Histogram& {
         auto* histogram = new NiceMock<MockHistogram>(); // symbol_table_);
@@ -63,6 +63,10 @@ public:
       EXPECT_TRUE(was_set_);
       return parent_.data_[index_];
     }
+    ThreadLocalObject* getPtr() override {
+      EXPECT_TRUE(was_set_);
+      return parent_.data_[index_].get();
+    }
     bool currentThreadRegistered() override { return parent_.registered_; }
     void runOnAllThreads(const UpdateCb& cb) override {
       EXPECT_TRUE(was_set_);
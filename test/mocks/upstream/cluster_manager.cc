@@ -11,6 +11,7 @@ namespace Upstream {
 
 using ::testing::_;
 using ::testing::Eq;
+using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::ReturnRef;
 
@@ -26,6 +27,12 @@ MockClusterManager::MockClusterManager()
   ON_CALL(*this, grpcAsyncClientManager()).WillByDefault(ReturnRef(async_client_manager_));
   ON_CALL(*this, localClusterName()).WillByDefault((ReturnRef(local_cluster_name_)));
   ON_CALL(*this, subscriptionFactory()).WillByDefault(ReturnRef(subscription_factory_));
+  // The clusters added with their hash are expected like the other ones by default.
+  ON_CALL(*this, addOrUpdateCluster(_, _, _))
+      .WillByDefault(Invoke([this](const envoy::config::cluster::v3::Cluster& cluster,
+                                   const std::string& version_info, uint64_t) -> bool {
+        return addOrUpdateCluster(cluster, version_info);
+      }));
 }
 
 MockClusterManager::~MockClusterManager() = default;
@@ -37,6 +37,9 @@ public:
   MOCK_METHOD(bool, addOrUpdateCluster,
               (const envoy::config::cluster::v3::Cluster& cluster,
                const std::string& version_info));
+  MOCK_METHOD(bool, addOrUpdateCluster,
+              (const envoy::config::cluster::v3::Cluster& cluster, const std::string& version_info,
+               uint64_t config_hash));
   MOCK_METHOD(void, setPrimaryClustersInitializedCb, (PrimaryClustersReadyCallback));
   MOCK_METHOD(void, setInitializedCb, (InitializationCompleteCallback));
   MOCK_METHOD(void, initializeSecondaryClusters,
@@ -68,6 +71,12 @@ public:
   const ClusterTimeoutBudgetStatNames& clusterTimeoutBudgetStatNames() const override {
     return cluster_timeout_budget_stat_names_;
   }
+  bool deferredClusterStats() const override { return deferred_cluster_stats_; }
+  MOCK_METHOD(ClusterUpdateBatch, batchClusterUpdates, ());
+  MOCK_METHOD(OdCdsApiHandleSharedPtr, allocateOdCdsApi,
+              (const envoy::config::core::v3::ConfigSource& odcds_config,
+               std::chrono::milliseconds idle_timeout,
+               ProtobufMessage::ValidationVisitor& validation_visitor));
 
   NiceMock<MockThreadLocalCluster> thread_local_cluster_;
   envoy::config::core::v3::BindConfig bind_config_;
@@ -84,6 +93,7 @@ public:
   ClusterCircuitBreakersStatNames cluster_circuit_breakers_stat_names_;
   ClusterRequestResponseSizeStatNames cluster_request_response_size_stat_names_;
   ClusterTimeoutBudgetStatNames cluster_timeout_budget_stat_names_;
+  bool deferred_cluster_stats_{};
 };
 } // namespace Upstream
 
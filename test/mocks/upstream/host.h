@@ -35,6 +35,7 @@ public:
   MOCK_METHOD(double, successRate, (DetectorHostMonitor::SuccessRateMonitorType type), (const));
   MOCK_METHOD(void, successRate,
               (DetectorHostMonitor::SuccessRateMonitorType type, double new_success_rate));
+  MOCK_METHOD(double, latencyMs, (), (const));
 };
 
 class MockEventLogger : public EventLogger {
@@ -63,6 +64,7 @@ public:
   MOCK_METHOD(double, successRateAverage, (DetectorHostMonitor::SuccessRateMonitorType), (const));
   MOCK_METHOD(double, successRateEjectionThreshold, (DetectorHostMonitor::SuccessRateMonitorType),
               (const));
+  MOCK_METHOD(double, latencyMedianMs, (), (const));
 
   std::list<ChangeStateCb> callbacks_;
 };
@@ -77,6 +79,15 @@ public:
   MOCK_METHOD(void, setUnhealthy, (UnhealthyType));
 };
 
+class MockLatencyEstimate : public LatencyEstimate {
+public:
+  MockLatencyEstimate();
+  ~MockLatencyEstimate() override;
+
+  MOCK_METHOD(void, observe, (std::chrono::microseconds latency, MonotonicTime now));
+  MOCK_METHOD(double, value, (), (const));
+};
+
 class MockHostDescription : public HostDescription {
 public:
   MockHostDescription();
@@ -99,6 +110,7 @@ public:
   MOCK_METHOD(uint32_t, priority, (), (const));
   MOCK_METHOD(void, priority, (uint32_t));
   MOCK_METHOD(MonotonicTime, creationTime, (), (const));
+  MOCK_METHOD(LatencyEstimate&, latencyEstimate, (), (const));
   Stats::StatName localityZoneStatName() const override {
     Stats::SymbolTable& symbol_table = *symbol_table_;
     locality_zone_stat_name_ =
@@ -110,6 +122,7 @@ public:
   Network::Address::InstanceConstSharedPtr address_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
   testing::NiceMock<MockHealthCheckHostMonitor> health_checker_;
+  testing::NiceMock<MockLatencyEstimate> latency_estimate_;
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<MockClusterInfo> cluster_;
   HostStats stats_;
@@ -193,10 +206,12 @@ public:
   MOCK_METHOD(void, priority, (uint32_t));
   MOCK_METHOD(bool, warmed, (), (const));
   MOCK_METHOD(MonotonicTime, creationTime, (), (const));
+  MOCK_METHOD(LatencyEstimate&, latencyEstimate, (), (const));
 
   testing::NiceMock<MockClusterInfo> cluster_;
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
+  testing::NiceMock<MockLatencyEstimate> latency_estimate_;
   HostStats stats_;
   mutable Stats::TestUtil::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
@@ -0,0 +1,13 @@
+#include "od_cds_api_handle.h"
+
+namespace Envoy {
+namespace Upstream {
+MockOdCdsApiHandle::MockOdCdsApiHandle() = default;
+
+MockOdCdsApiHandle::~MockOdCdsApiHandle() = default;
+
+MockClusterDiscoveryCallbackHandle::MockClusterDiscoveryCallbackHandle() = default;
+
+MockClusterDiscoveryCallbackHandle::~MockClusterDiscoveryCallbackHandle() = default;
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "envoy/upstream/cluster_manager.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+class MockOdCdsApiHandle : public OdCdsApiHandle {
+public:
+  MockOdCdsApiHandle();
+  ~MockOdCdsApiHandle() override;
+
+  ClusterDiscoveryCallbackHandlePtr
+  requestOnDemandClusterDiscovery(const std::string& name, ClusterDiscoveryCallbackPtr callback,
+                                  std::chrono::milliseconds timeout) override {
+    return ClusterDiscoveryCallbackHandlePtr{
+        requestOnDemandClusterDiscovery_(name, callback, timeout)};
+  }
+
+  MOCK_METHOD(ClusterDiscoveryCallbackHandle*, requestOnDemandClusterDiscovery_,
+              (const std::string& name, ClusterDiscoveryCallbackPtr& callback,
+               std::chrono::milliseconds timeout));
+};
+
+class MockClusterDiscoveryCallbackHandle : public ClusterDiscoveryCallbackHandle {
+public:
+  MockClusterDiscoveryCallbackHandle();
+  ~MockClusterDiscoveryCallbackHandle() override;
+};
+} // namespace Upstream
+} // namespace Envoy
@@ -1,5 +1,8 @@
 #include "test/server/admin/admin_instance.h"
 
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
 using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
@@ -611,5 +614,107 @@ TEST_P(AdminInstanceTest, ConfigDumpResourceNotRepeated) {
             getCallback("/config_dump?resource=version_info", header_map, response));
 }
 
+// Test that the name_regex query parameter filters the resources by name, looking into the packed
+// resource of a static listener.
+TEST_P(AdminInstanceTest, ConfigDumpFiltersByResourceAndNameRegex) {
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  auto listeners = admin_.getConfigTracker().add("listeners", [] {
+    auto msg = std::make_unique<envoy::admin::v3::ListenersConfigDump>();
+    for (const char* name : {"bar", "baz", "foobar"}) {
+      envoy::config::listener::v3::Listener listener;
+      listener.set_name(name);
+      msg->add_static_listeners()->mutable_listener()->PackFrom(listener);
+    }
+    return msg;
+  });
+  const std::string expected_json = R"EOF({
+ "configs": [
+  {
+   "@type": "type.googleapis.com/envoy.admin.v3.ListenersConfigDump.StaticListener",
+   "listener": {
+    "@type": "type.googleapis.com/envoy.config.listener.v3.Listener",
+    "name": "bar"
+   }
+  },
+  {
+   "@type": "type.googleapis.com/envoy.admin.v3.ListenersConfigDump.StaticListener",
+   "listener": {
+    "@type": "type.googleapis.com/envoy.config.listener.v3.Listener",
+    "name": "foobar"
+   }
+  }
+ ]
+}
+)EOF";
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump?resource=static_listeners&name_regex=bar$",
+                                        header_map, response));
+  EXPECT_EQ(expected_json, response.toString());
+}
+
+// Test that a 400 Bad Request is returned for an invalid name_regex, and for a name_regex without
+// a resource.
+TEST_P(AdminInstanceTest, ConfigDumpBadNameRegex) {
+  Http::TestResponseHeaderMapImpl header_map;
+  auto listeners = admin_.getConfigTracker().add("listeners", [] {
+    return std::make_unique<envoy::admin::v3::ListenersConfigDump>();
+  });
+  {
+    Buffer::OwnedImpl response;
+    EXPECT_EQ(
+        Http::Code::BadRequest,
+        getCallback("/config_dump?resource=static_listeners&name_regex=*", header_map, response));
+    EXPECT_THAT(response.toString(), testing::StartsWith("Invalid name_regex: \""));
+  }
+  {
+    Buffer::OwnedImpl response;
+    EXPECT_EQ(Http::Code::BadRequest,
+              getCallback("/config_dump?name_regex=foo", header_map, response));
+    EXPECT_EQ("name_regex can only be used with resource\n", response.toString());
+  }
+}
+
+// Test that a config dump larger than a chunk is streamed over several dispatcher iterations,
+// with the same output as if it had been sent at once.
+TEST_P(AdminInstanceTest, ConfigDumpStreamsLargeDump) {
+  const std::string value(ChunkedResponse::DefaultChunkSize, 'a');
+  auto make_config = [&value] {
+    auto msg = std::make_unique<ProtobufWkt::StringValue>();
+    msg->set_value(value);
+    return msg;
+  };
+  auto bar = admin_.getConfigTracker().add("bar", make_config);
+  auto foo = admin_.getConfigTracker().add("foo", make_config);
+  const std::string config = absl::StrCat(R"EOF(  {
+   "@type": "type.googleapis.com/google.protobuf.StringValue",
+   "value": ")EOF",
+                                          value, R"EOF("
+  })EOF");
+  const std::string expected_json =
+      absl::StrCat("{\n \"configs\": [\n", config, ",\n", config, "\n ]\n}\n");
+
+  auto* next_chunk_cb = new NiceMock<Event::MockSchedulableCallback>(&callbacks_.dispatcher_);
+  Buffer::OwnedImpl response;
+  Http::TestResponseHeaderMapImpl header_map;
+  EXPECT_EQ(Http::Code::OK, getCallback("/config_dump", header_map, response));
+  std::string output = response.toString();
+  EXPECT_LT(output.size(), expected_json.size());
+
+  bool end_stream = false;
+  EXPECT_CALL(callbacks_, encodeData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool end) {
+        EXPECT_FALSE(end_stream);
+        output += data.toString();
+        end_stream = end;
+      }));
+  while (next_chunk_cb->enabled_) {
+    next_chunk_cb->invokeCallback();
+  }
+  EXPECT_TRUE(end_stream);
+  EXPECT_EQ(expected_json, output);
+  // Detach from the stream callbacks, which are destroyed before the filter.
+  admin_filter_.onDestroy();
+}
+
 } // namespace Server
 } // namespace Envoy
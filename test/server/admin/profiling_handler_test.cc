@@ -1,4 +1,7 @@
+#include <ctime>
+
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 
 #include "test/server/admin/admin_instance.h"
 #include "test/test_common/logging.h"
@@ -78,5 +81,60 @@ TEST_P(AdminInstanceTest, AdminBadProfiler) {
   EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
 }
 
+TEST_P(AdminInstanceTest, AdminSamplingProfiler) {
+  Buffer::OwnedImpl data;
+  Http::TestResponseHeaderMapImpl header_map;
+
+#ifdef SAMPLING_PROFILER_AVAILABLE
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sampling?enable=x", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency_hz=abc", header_map, data));
+  EXPECT_EQ(Http::Code::InternalServerError,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency_hz=0", header_map, data));
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency_hz=1000", header_map, data));
+  EXPECT_TRUE(Profiler::Sampling::isProfilerStarted());
+  // Both profilers use the same timer.
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+
+  // Burn some CPU to take samples.
+  const std::clock_t end = std::clock() + CLOCKS_PER_SEC / 5;
+  while (std::clock() < end) {
+  }
+  EXPECT_EQ(Http::Code::OK, postCallback("/cpuprofiler/sampling?enable=n", header_map, data));
+  EXPECT_FALSE(Profiler::Sampling::isProfilerStarted());
+
+  // The header is followed by the first sample, with a count, or by the trailer, with a zero.
+  const auto profileWord = [](const Buffer::Instance& profile, uint32_t index) {
+    uintptr_t word;
+    profile.copyOut(index * sizeof(word), sizeof(word), &word);
+    return word;
+  };
+  Buffer::OwnedImpl profile;
+  EXPECT_EQ(Http::Code::OK, getCallback("/cpuprofiler/sampling/profile", header_map, profile));
+  EXPECT_EQ("application/octet-stream", header_map.getContentTypeValue());
+  EXPECT_EQ(3, profileWord(profile, 1));
+  EXPECT_EQ(1000, profileWord(profile, 3));
+  EXPECT_NE(0, profileWord(profile, 5));
+
+  // No thread has the id 0.
+  profile.drain(profile.length());
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/cpuprofiler/sampling/profile?thread_id=0", header_map, profile));
+  EXPECT_EQ(0, profileWord(profile, 5));
+  EXPECT_EQ(1, profileWord(profile, 6));
+
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/cpuprofiler/sampling/profile?thread_id=abc", header_map, profile));
+#else
+  EXPECT_EQ(Http::Code::NotImplemented,
+            postCallback("/cpuprofiler/sampling?enable=y", header_map, data));
+  EXPECT_EQ(Http::Code::NotFound,
+            getCallback("/cpuprofiler/sampling/profile", header_map, data));
+#endif
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -701,5 +701,35 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+// Test that rendering in small chunks produces the same output as rendering all at once.
+TEST_F(PrometheusStatsFormatterTest, RenderInChunks) {
+  for (const char* cluster : {"ccc", "aaa", "bbb"}) {
+    const Stats::StatNameTagVector tags{{makeStat("cluster"), makeStat(cluster)}};
+    addCounter("cluster.upstream_cx_total", tags);
+    addCounter("cluster.upstream_cx_connect_fail", tags);
+    addGauge("cluster.upstream_cx_active", tags);
+  }
+
+  Buffer::OwnedImpl expected;
+  EXPECT_EQ(3UL, PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                             expected, false, absl::nullopt));
+
+  PrometheusStatsRenderer renderer(counters_, gauges_, histograms_, false, absl::nullopt);
+  EXPECT_EQ(3UL, renderer.metricNameCount());
+  Buffer::OwnedImpl response;
+  // Each chunk holds a single family, as any family exceeds one byte.
+  EXPECT_TRUE(renderer.nextChunk(response, 1));
+  const uint64_t first_chunk_length = response.length();
+  EXPECT_GT(first_chunk_length, 0);
+  EXPECT_LT(first_chunk_length, expected.length());
+  EXPECT_TRUE(renderer.nextChunk(response, 1));
+  EXPECT_FALSE(renderer.nextChunk(response, 1));
+  EXPECT_EQ(expected.toString(), response.toString());
+
+  // Nothing is left to render.
+  EXPECT_FALSE(renderer.nextChunk(response, 1));
+  EXPECT_EQ(expected.length(), response.length());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -61,6 +61,29 @@ TEST_P(AdminInstanceTest, Memory) {
                                   Property(&envoy::admin::v3::Memory::total_thread_cache, Ge(0))));
 }
 
+TEST_P(AdminInstanceTest, SlowCallbacks) {
+  Http::TestResponseHeaderMapImpl header_map;
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/slow_callbacks/threshold?threshold_us=abc", header_map, response));
+  EXPECT_THAT(response.toString(), HasSubstr("usage:"));
+  response.drain(response.length());
+
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/slow_callbacks/threshold?threshold_us=5000", header_map, response));
+  EXPECT_EQ(std::chrono::milliseconds(5), server_.api_.slow_callback_log_.threshold());
+  response.drain(response.length());
+
+  server_.api_.slow_callback_log_.record({"worker_0", Event::SlowCallback::Type::Timer,
+                                          SystemTime(), std::chrono::microseconds(7000),
+                                          "ActiveStream@0x1\n  stream_id_: 1\n"});
+  EXPECT_EQ(Http::Code::OK, getCallback("/slow_callbacks", header_map, response));
+  EXPECT_THAT(response.toString(), HasSubstr("threshold_us: 5000\n"));
+  EXPECT_THAT(response.toString(), HasSubstr(" worker_0 timer 7000us\n"
+                                             "  ActiveStream@0x1\n"
+                                             "    stream_id_: 1\n"));
+}
+
 TEST_P(AdminInstanceTest, GetReadyRequest) {
   NiceMock<Init::MockManager> initManager;
   ON_CALL(server_, initManager()).WillByDefault(ReturnRef(initManager));
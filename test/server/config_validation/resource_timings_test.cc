@@ -0,0 +1,37 @@
+#include "server/config_validation/resource_timings.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+// The slowest resources are returned first, at most the given number of them.
+TEST(ValidationResourceTimingsTest, Slowest) {
+  Event::SimulatedTimeSystem time_system;
+  ValidationResourceTimings timings(time_system);
+  EXPECT_TRUE(timings.slowest(2).empty());
+
+  const std::vector<std::pair<std::string, int>> resources = {
+      {"fast", 1}, {"slow", 30}, {"medium", 5}};
+  for (const auto& [name, time_ms] : resources) {
+    const MonotonicTime start = timings.start();
+    time_system.advanceTimeWait(std::chrono::milliseconds(time_ms));
+    timings.record("cluster", name, start);
+  }
+
+  const std::vector<ValidationResourceTimings::Timing> slowest = timings.slowest(2);
+  ASSERT_EQ(2, slowest.size());
+  EXPECT_EQ("cluster", slowest[0].type_);
+  EXPECT_EQ("slow", slowest[0].name_);
+  EXPECT_EQ(std::chrono::milliseconds(30), slowest[0].time_);
+  EXPECT_EQ("medium", slowest[1].name_);
+  EXPECT_EQ(std::chrono::milliseconds(5), slowest[1].time_);
+  EXPECT_EQ(3, timings.slowest(10).size());
+}
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
@@ -89,6 +89,7 @@ TEST_F(ConfigurationImplTest, DefaultStatsFlushInterval) {
 
   EXPECT_EQ(std::chrono::milliseconds(5000), config.statsConfig().flushInterval());
   EXPECT_FALSE(config.statsConfig().flushOnAdmin());
+  EXPECT_FALSE(config.statsConfig().flushChangedOnly());
 }
 
 TEST_F(ConfigurationImplTest, CustomStatsFlushInterval) {
@@ -15,6 +15,7 @@
 #include "common/network/utility.h"
 
 #include "server/active_raw_udp_listener_config.h"
+#include "server/active_udp_listener.h"
 #include "server/connection_handler_impl.h"
 
 #include "test/mocks/access_log/mocks.h"
@@ -28,6 +29,7 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::ByMove;
 using testing::HasSubstr;
 using testing::InSequence;
 using testing::Invoke;
@@ -629,6 +631,63 @@ TEST_F(ConnectionHandlerTest, CloseConnectionOnEmptyFilterChain) {
   EXPECT_CALL(*listener, onDestroy());
 }
 
+// Only the connections that can continue in another process are handed over and closed. The
+// adopted connections skip the listener filters, which already ran in the other process.
+TEST_F(ConnectionHandlerTest, HandOverAndAdoptConnections) {
+  Network::TcpListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(local_address_));
+  handler_->addListener(absl::nullopt, *test_listener);
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillRepeatedly(Return(filter_chain_.get()));
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+  auto* idle_connection = new NiceMock<Network::MockServerConnection>();
+  auto* busy_connection = new NiceMock<Network::MockServerConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_())
+      .WillOnce(Return(idle_connection))
+      .WillOnce(Return(busy_connection));
+  listener_callbacks->onAccept(std::make_unique<NiceMock<Network::MockConnectionSocket>>());
+  listener_callbacks->onAccept(std::make_unique<NiceMock<Network::MockConnectionSocket>>());
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  auto* handed_over_socket = new NiceMock<Network::MockConnectionSocket>();
+  EXPECT_CALL(*idle_connection, handOver())
+      .WillOnce(Return(ByMove(Network::ConnectionSocketPtr{handed_over_socket})));
+  EXPECT_CALL(*idle_connection, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*busy_connection, handOver()).WillOnce(Return(ByMove(nullptr)));
+  EXPECT_CALL(*access_log_, log(_, _, _, _));
+  std::vector<Network::ConnectionSocketPtr> sockets = handler_->handOverConnections();
+  ASSERT_EQ(1U, sockets.size());
+  EXPECT_EQ(handed_over_socket, sockets[0].get());
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(factory_, createListenerFilterChain(_)).Times(0);
+  auto* adopted_connection = new NiceMock<Network::MockServerConnection>();
+  EXPECT_CALL(dispatcher_, createServerConnection_()).WillOnce(Return(adopted_connection));
+  sockets[0]->addressProvider().setLocalAddress(local_address_);
+  handler_->adoptConnection(std::move(sockets[0]));
+  EXPECT_EQ(2UL, handler_->numConnections());
+  EXPECT_EQ(2UL, TestUtility::findGauge(stats_store_, "downstream_cx_active")->value());
+
+  // A connection without a listener for its address is closed.
+  auto* unknown_socket = new NiceMock<Network::MockConnectionSocket>();
+  unknown_socket->addressProvider().setLocalAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.2", 10001));
+  EXPECT_CALL(*unknown_socket, close());
+  handler_->adoptConnection(Network::ConnectionSocketPtr{unknown_socket});
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  EXPECT_CALL(*access_log_, log(_, _, _, _)).Times(2);
+  busy_connection->close(Network::ConnectionCloseType::NoFlush);
+  adopted_connection->close(Network::ConnectionCloseType::NoFlush);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(0UL, handler_->numConnections());
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, NormalRedirect) {
   Network::TcpListenerCallbacks* listener_callbacks1;
   auto listener1 = new NiceMock<Network::MockListener>();
@@ -1076,6 +1135,24 @@ TEST_F(ConnectionHandlerTest, UdpListenerNoFilterThrowsException) {
   }
 }
 
+// The hash must match what the BPF steering program computes from the packet headers.
+TEST(ActiveRawUdpListenerTest, SourceAddressHash) {
+  const Network::Address::InstanceConstSharedPtr v4 =
+      Network::Utility::parseInternetAddressAndPort("10.0.0.1:1000");
+  EXPECT_EQ(0x90ea45f3, ActiveRawUdpListener::sourceAddressHash(*v4));
+
+  // IPv6 addresses are folded into 32 bits by XOR-ing their words.
+  const Network::Address::InstanceConstSharedPtr v6 =
+      Network::Utility::parseInternetAddressAndPort("[::a00:1]:1000");
+  EXPECT_EQ(ActiveRawUdpListener::sourceAddressHash(*v4),
+            ActiveRawUdpListener::sourceAddressHash(*v6));
+
+  const Network::Address::InstanceConstSharedPtr other_port =
+      Network::Utility::parseInternetAddressAndPort("10.0.0.1:1001");
+  EXPECT_NE(ActiveRawUdpListener::sourceAddressHash(*v4),
+            ActiveRawUdpListener::sourceAddressHash(*other_port));
+}
+
 TEST_F(ConnectionHandlerTest, TcpListenerInplaceUpdate) {
   InSequence s;
   uint64_t old_listener_tag = 1;
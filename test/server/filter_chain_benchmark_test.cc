@@ -7,6 +7,7 @@
 #include "envoy/network/listen_socket.h"
 #include "envoy/protobuf/message_validator.h"
 
+#include "common/memory/stats.h"
 #include "common/network/socket_impl.h"
 
 #include "server/filter_chain_manager_impl.h"
@@ -182,6 +183,13 @@ const char YamlSingleDstPortBottom[] = R"EOF(
           session_ticket_keys:
             keys:
             - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ticket_key_a")EOF";
+// The SNI chains of a listener fronting many tenants. They share the destination and source
+// matchers, and are only told apart by their server name.
+const char YamlSingleSniTop[] = R"EOF(
+    - filter_chain_match:
+        server_names: "tenant)EOF";
+const char YamlSingleSniBottom[] = R"EOF(.example.com"
+        transport_protocol: "tls")EOF";
 } // namespace
 
 class FilterChainBenchmarkFixture : public ::benchmark::Fixture {
@@ -200,6 +208,19 @@ public:
     filter_chains_ = listener_config_.filter_chains();
   }
 
+  void initializeSni(::benchmark::State& state) {
+    int64_t input_size = state.range(0);
+    std::vector<std::string> sni_chains;
+    sni_chains.reserve(input_size);
+    for (int i = 0; i < input_size; i++) {
+      sni_chains.push_back(absl::StrCat(YamlSingleSniTop, i, YamlSingleSniBottom));
+    }
+    listener_yaml_config_ = TestEnvironment::substitute(
+        absl::StrCat(YamlHeader, absl::StrJoin(sni_chains, "")), Network::Address::IpVersion::v4);
+    TestUtility::loadFromYaml(listener_yaml_config_, listener_config_);
+    filter_chains_ = listener_config_.filter_chains();
+  }
+
   Envoy::Thread::MutexBasicLockable lock_;
   Logger::Context logging_state_{spdlog::level::warn, Logger::Logger::DEFAULT_LOG_FORMAT, lock_,
                                  false};
@@ -257,6 +278,63 @@ BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainFindTest)
     }
   }
 }
+// NOLINTNEXTLINE(readability-redundant-member-init)
+BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainManagerBuildSniTest)
+(::benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 64) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  initializeSni(state);
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  uint64_t memory_used = 0;
+  for (auto _ : state) {
+    const uint64_t memory_before = Memory::Stats::totalCurrentlyAllocated();
+    FilterChainManagerImpl filter_chain_manager{
+        std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context,
+        init_manager_};
+    filter_chain_manager.addFilterChains(filter_chains_, nullptr, dummy_builder_,
+                                         filter_chain_manager);
+    memory_used = Memory::Stats::totalCurrentlyAllocated() - memory_before;
+  }
+  // The memory held by the manager, filter chains included. Only reported with tcmalloc.
+  state.counters["memory_used"] = memory_used;
+}
+
+BENCHMARK_DEFINE_F(FilterChainBenchmarkFixture, FilterChainFindSniTest)
+(::benchmark::State& state) {
+  if (benchmark::skipExpensiveBenchmarks() && state.range(0) > 64) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  initializeSni(state);
+  std::vector<MockConnectionSocket> sockets;
+  sockets.reserve(state.range(0));
+  for (int i = 0; i < state.range(0); i++) {
+    // Half of the connections miss, and fall back to the catch-all chain after looking up each
+    // wildcard suffix of their server name.
+    const std::string server_name = i % 2 == 0 ? absl::StrCat("tenant", i, ".example.com")
+                                               : absl::StrCat("www.tenant", i, ".example.com");
+    sockets.push_back(std::move(*MockConnectionSocket::createMockConnectionSocket(
+        1234, "127.0.0.1", server_name, "tls", {}, "8.8.8.8", 111)));
+  }
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  FilterChainManagerImpl filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context,
+      init_manager_};
+
+  filter_chain_manager.addFilterChains(filter_chains_, nullptr, dummy_builder_,
+                                       filter_chain_manager);
+  for (auto _ : state) {
+    UNREFERENCED_PARAMETER(_);
+    for (int i = 0; i < state.range(0); i++) {
+      filter_chain_manager.findFilterChain(sockets[i]);
+    }
+  }
+}
+
 BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainManagerBuildTest)
     ->Ranges({
         // scale of the chains
@@ -269,6 +347,18 @@ BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainFindTest)
         {1, 4096},
     })
     ->Unit(::benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainManagerBuildSniTest)
+    ->Ranges({
+        // scale of the chains
+        {1, 16384},
+    })
+    ->Unit(::benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainFindSniTest)
+    ->Ranges({
+        // scale of the chains
+        {1, 16384},
+    })
+    ->Unit(::benchmark::kMillisecond);
 
 /*
 clang-format off
@@ -227,6 +227,44 @@ TEST_F(FilterChainManagerImplTest, DuplicateContextsAreNotBuilt) {
       nullptr, filter_chain_factory_builder_, new_filter_chain_manager);
 }
 
+// The filter chains are reused by the next generation of the listener from equal messages of its
+// own config, and only the changed ones are built again.
+TEST_F(FilterChainManagerImplTest, EqualMessagesAreReused) {
+  std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages;
+  for (int i = 0; i < 2; i++) {
+    envoy::config::listener::v3::FilterChain new_filter_chain = filter_chain_template_;
+    new_filter_chain.set_name(absl::StrCat("filter_chain_", i));
+    new_filter_chain.mutable_filter_chain_match()->mutable_destination_port()->set_value(10000 + i);
+    filter_chain_messages.push_back(std::move(new_filter_chain));
+  }
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _)).Times(2);
+  filter_chain_manager_.addFilterChains(
+      std::vector<const envoy::config::listener::v3::FilterChain*>{&filter_chain_messages[0],
+                                                                   &filter_chain_messages[1]},
+      nullptr, filter_chain_factory_builder_, filter_chain_manager_);
+
+  // The config of the next generation holds copies of the messages, one of them changed.
+  std::vector<envoy::config::listener::v3::FilterChain> new_filter_chain_messages =
+      filter_chain_messages;
+  new_filter_chain_messages[1].mutable_filter_chain_match()->add_server_names("example.com");
+  FilterChainManagerImpl new_filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), parent_context_,
+      init_manager_, filter_chain_manager_};
+  EXPECT_CALL(filter_chain_factory_builder_, buildFilterChain(_, _));
+  new_filter_chain_manager.addFilterChains(
+      std::vector<const envoy::config::listener::v3::FilterChain*>{&new_filter_chain_messages[0],
+                                                                   &new_filter_chain_messages[1]},
+      nullptr, filter_chain_factory_builder_, new_filter_chain_manager);
+
+  const auto& old_filter_chains = filter_chain_manager_.filterChainsByMessage();
+  const auto& new_filter_chains = new_filter_chain_manager.filterChainsByMessage();
+  ASSERT_EQ(2, new_filter_chains.size());
+  EXPECT_EQ(old_filter_chains.at(filter_chain_messages[0]),
+            new_filter_chains.at(new_filter_chain_messages[0]));
+  EXPECT_NE(new_filter_chains.end(), new_filter_chains.find(new_filter_chain_messages[1]));
+  EXPECT_EQ(new_filter_chains.end(), new_filter_chains.find(filter_chain_messages[1]));
+}
+
 TEST_F(FilterChainManagerImplTest, CreatedFilterChainFactoryContextHasIndependentDrainClose) {
   std::vector<envoy::config::listener::v3::FilterChain> filter_chain_messages;
   for (int i = 0; i < 3; i++) {
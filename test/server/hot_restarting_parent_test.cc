@@ -1,4 +1,6 @@
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "server/hot_restarting_child.h"
 #include "server/hot_restarting_parent.h"
@@ -7,6 +9,7 @@
 #include "test/mocks/server/instance.h"
 #include "test/mocks/server/listener_manager.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "gtest/gtest.h"
 
 using testing::InSequence;
@@ -114,6 +117,103 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportStatsByIdToChild) {
+  Stats::TestUtil::TestStore store;
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(7));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+  // Destroyed before the store, as it references the stats it exported.
+  HotRestartingParent::Internal hot_restarting_parent(&server_);
+
+  store.counter("c1").inc();
+  store.counter("c2").add(2);
+  store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  store.gauge("g2", Stats::Gauge::ImportMode::Accumulate).set(0);
+  store.counter("unused_counter");
+
+  // The 4 used stats are split in replies of at most 3 stats, each named once.
+  std::vector<HotRestartMessage> replies = hot_restarting_parent.exportStatsByIdToChild(3);
+  ASSERT_EQ(2U, replies.size());
+  EXPECT_TRUE(replies[0].reply().stats().more());
+  EXPECT_FALSE(replies[1].reply().stats().more());
+  EXPECT_EQ(0, replies[0].reply().stats().num_connections());
+  EXPECT_EQ(7, replies[1].reply().stats().num_connections());
+  absl::flat_hash_map<std::string, uint32_t> ids;
+  absl::flat_hash_map<uint32_t, uint64_t> counter_deltas;
+  absl::flat_hash_map<uint32_t, uint64_t> gauges;
+  for (const HotRestartMessage& reply : replies) {
+    const HotRestartMessage::Reply::Stats& stats = reply.reply().stats();
+    EXPECT_TRUE(stats.counter_deltas().empty());
+    EXPECT_TRUE(stats.gauges().empty());
+    EXPECT_LE(stats.counter_deltas_by_id_size() + stats.gauges_by_id_size(), 3);
+    for (const auto& stat_name : stats.stat_names()) {
+      EXPECT_TRUE(ids.emplace(stat_name.second, stat_name.first).second);
+    }
+    counter_deltas.insert(stats.counter_deltas_by_id().begin(), stats.counter_deltas_by_id().end());
+    gauges.insert(stats.gauges_by_id().begin(), stats.gauges_by_id().end());
+  }
+  EXPECT_EQ(4U, ids.size());
+  EXPECT_EQ(1, counter_deltas.at(ids.at("c1")));
+  EXPECT_EQ(2, counter_deltas.at(ids.at("c2")));
+  EXPECT_EQ(123, gauges.at(ids.at("g1")));
+  EXPECT_EQ(0, gauges.at(ids.at("g2")));
+
+  // Only the stats that changed are exported again, by the same ids and without their names.
+  store.counter("c2").add(2);
+  store.gauge("g2", Stats::Gauge::ImportMode::Accumulate).add(1);
+  replies = hot_restarting_parent.exportStatsByIdToChild(3);
+  ASSERT_EQ(1U, replies.size());
+  const HotRestartMessage::Reply::Stats& stats = replies[0].reply().stats();
+  EXPECT_FALSE(stats.more());
+  EXPECT_TRUE(stats.stat_names().empty());
+  EXPECT_EQ(1, stats.counter_deltas_by_id_size());
+  EXPECT_EQ(2, stats.counter_deltas_by_id().at(ids.at("c2")));
+  EXPECT_EQ(1, stats.gauges_by_id_size());
+  EXPECT_EQ(1, stats.gauges_by_id().at(ids.at("g2")));
+
+  // Nothing changed, but the last reply still has the server stats.
+  replies = hot_restarting_parent.exportStatsByIdToChild(3);
+  ASSERT_EQ(1U, replies.size());
+  EXPECT_EQ(0, replies[0].reply().stats().counter_deltas_by_id_size());
+  EXPECT_EQ(0, replies[0].reply().stats().gauges_by_id_size());
+  EXPECT_EQ(7, replies[0].reply().stats().num_connections());
+}
+
+TEST_F(HotRestartingParentTest, RetainDynamicStatsById) {
+  MockListenerManager listener_manager;
+  Stats::SymbolTableImpl parent_symbol_table;
+  Stats::TestUtil::TestStore parent_store(parent_symbol_table);
+
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(0));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(parent_store));
+  HotRestartingParent::Internal hot_restarting_parent(&server_);
+
+  std::vector<HotRestartMessage> replies;
+  {
+    Stats::StatNameDynamicPool dynamic(parent_store.symbolTable());
+    parent_store.counterFromStatName(dynamic.add("c1")).inc();
+    parent_store.gaugeFromStatName(dynamic.add("g1"), Stats::Gauge::ImportMode::Accumulate).set(42);
+    replies = hot_restarting_parent.exportStatsByIdToChild(1);
+  }
+
+  Stats::SymbolTableImpl child_symbol_table;
+  Stats::TestUtil::TestStore child_store(child_symbol_table);
+  Stats::StatNameDynamicPool dynamic(child_store.symbolTable());
+  Stats::Counter& c1 = child_store.counterFromStatName(dynamic.add("c1"));
+  Stats::Gauge& g1 =
+      child_store.gaugeFromStatName(dynamic.add("g1"), Stats::Gauge::ImportMode::Accumulate);
+
+  HotRestartingChild hot_restarting_child(0, 0, "@envoy_domain_socket", 0);
+  ASSERT_EQ(2U, replies.size());
+  for (const HotRestartMessage& reply : replies) {
+    hot_restarting_child.mergeParentStats(child_store, reply.reply().stats());
+  }
+  EXPECT_EQ(1, c1.value());
+  EXPECT_EQ(42, g1.value());
+}
+
 TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   MockListenerManager listener_manager;
   Stats::SymbolTableImpl parent_symbol_table;
@@ -693,6 +693,83 @@ TEST_F(OverloadManagerImplTest, DuplicateTrigger) {
   EXPECT_THROW_WITH_REGEX(createOverloadManager(config), EnvoyException, "Duplicate trigger .*");
 }
 
+// The triggers of the worker resources are evaluated by each worker, along with the state computed
+// by the overload manager.
+TEST_F(OverloadManagerImplTest, WorkerResourceTrigger) {
+  const std::string config = R"EOF(
+    worker_refresh_interval: 0.02s
+    resource_monitors:
+      - name: "envoy.resource_monitors.fake_resource1"
+    actions:
+      - name: "envoy.overload_actions.stop_accepting_requests"
+        triggers:
+          - name: "envoy.resource_monitors.fake_resource1"
+            threshold:
+              value: 0.9
+          - name: "envoy.worker_resources.loop_utilization"
+            scaled:
+              scaling_threshold: 0.5
+              saturation_threshold: 0.9
+  )EOF";
+
+  setDispatcherExpectation();
+  auto* worker_timer = new NiceMock<Event::MockTimer>();
+  Event::TimerCb worker_timer_cb;
+  EXPECT_CALL(thread_local_.dispatcher_, createTimer_(_))
+      .WillOnce(Invoke([&](Event::TimerCb cb) {
+        worker_timer_cb = cb;
+        return worker_timer;
+      }));
+  EXPECT_CALL(*worker_timer, enableTimer(std::chrono::milliseconds(20), _)).Times(5);
+  auto manager(createOverloadManager(config));
+  manager->start();
+  const auto& action_state = manager->getThreadLocalOverloadState().getState(
+      "envoy.overload_actions.stop_accepting_requests");
+
+  // The loop utilization isn't known yet.
+  EXPECT_CALL(thread_local_.dispatcher_, loopUtilization()).WillOnce(Return(absl::nullopt));
+  worker_timer_cb();
+  EXPECT_EQ(UnitFloat::min(), action_state.value());
+
+  EXPECT_CALL(thread_local_.dispatcher_, loopUtilization()).WillOnce(Return(0.7));
+  worker_timer_cb();
+  EXPECT_EQ(UnitFloat(0.5), action_state.value());
+
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  factory1_.monitor_->setPressure(0.5);
+  timer_cb_();
+  EXPECT_EQ(UnitFloat(0.5), action_state.value());
+
+  EXPECT_CALL(thread_local_.dispatcher_, loopUtilization()).WillOnce(Return(0.95));
+  worker_timer_cb();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  EXPECT_CALL(thread_local_.dispatcher_, loopUtilization()).WillOnce(Return(0.4));
+  worker_timer_cb();
+  EXPECT_EQ(UnitFloat::min(), action_state.value());
+
+  manager->stop();
+}
+
+TEST_F(OverloadManagerImplTest, WorkerResourceTriggerForManagerAction) {
+  const std::string config = R"EOF(
+    resource_monitors:
+      - name: "envoy.resource_monitors.fake_resource1"
+    actions:
+      - name: "envoy.overload_actions.shrink_heap"
+        triggers:
+          - name: "envoy.worker_resources.loop_utilization"
+            threshold:
+              value: 0.9
+  )EOF";
+
+  EXPECT_THROW_WITH_REGEX(createOverloadManager(config), EnvoyException,
+                          "Worker resource .* can't trigger overload action .*");
+}
+
 TEST_F(OverloadManagerImplTest, Shutdown) {
   setDispatcherExpectation();
 
@@ -100,6 +100,48 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store, time_system);
 }
 
+// Only the metrics that changed since the previous flush are flushed.
+TEST(ServerInstanceUtil, FlushChangedOnly) {
+  Stats::TestUtil::TestStore store;
+  Event::SimulatedTimeSystem time_system;
+  Stats::Counter& counter = store.counter("counter");
+  Stats::Counter& idle_counter = store.counter("idle_counter");
+  Stats::Gauge& gauge = store.gauge("gauge", Stats::Gauge::ImportMode::Accumulate);
+  store.gauge("idle_gauge", Stats::Gauge::ImportMode::Accumulate);
+  Stats::TextReadout& text_readout = store.textReadout("text");
+  counter.inc();
+  gauge.set(5);
+  text_readout.set("is important");
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "counter");
+    EXPECT_EQ(snapshot.counters()[0].delta_, 1);
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "gauge");
+    ASSERT_EQ(snapshot.textReadouts().size(), 1);
+    EXPECT_EQ(snapshot.textReadouts()[0].get().name(), "text");
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system, true);
+
+  // The counters are latched all the same.
+  idle_counter.inc();
+  gauge.set(5);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].counter_.get().name(), "idle_counter");
+    ASSERT_EQ(snapshot.gauges().size(), 1);
+    EXPECT_EQ(snapshot.gauges()[0].get().name(), "gauge");
+    EXPECT_TRUE(snapshot.textReadouts().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store, time_system, true);
+  EXPECT_EQ(0, counter.latch());
+  EXPECT_EQ(0, idle_counter.latch());
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {